@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include "boost/format.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "Benchmark.h"
+
+using namespace IECoreBenchmark;
+
+//////////////////////////////////////////////////////////////////////////
+// Results
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+std::string escape( const std::string &s )
+{
+	std::string result;
+	for( std::string::const_iterator it = s.begin(); it != s.end(); ++it )
+	{
+		if( *it == '"' || *it == '\\' )
+		{
+			result += '\\';
+		}
+		result += *it;
+	}
+	return result;
+}
+
+} // namespace
+
+Results::Results( double minTime )
+	:	m_minTime( minTime )
+{
+}
+
+void Results::writeJSON( std::ostream &o ) const
+{
+	o << "{\n\t\"benchmarks\" : [\n";
+	for( std::vector<Result>::const_iterator it = m_results.begin(); it != m_results.end(); ++it )
+	{
+		o << boost::format( "\t\t{ \"name\" : \"%s\", \"calls\" : %d, \"meanTime\" : %.9g, \"minTime\" : %.9g, \"itemsPerSecond\" : %.9g }" ) %
+			escape( it->name ) % it->calls % it->meanTime % it->minTime % it->itemsPerSecond;
+		o << ( it + 1 != m_results.end() ? ",\n" : "\n" );
+	}
+	o << "\t]\n}\n";
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Registration
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef std::map<std::string, BenchmarkFunction> Registry;
+
+Registry &registry()
+{
+	static Registry r;
+	return r;
+}
+
+} // namespace
+
+Registration::Registration( const std::string &name, BenchmarkFunction function )
+{
+	registry()[name] = function;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Main
+//////////////////////////////////////////////////////////////////////////
+
+/// Usage : IECoreBenchmark [-minTime seconds] [-output file.json] [nameFilter ...]
+///
+/// Runs the registered benchmarks whose names contain any of the filters,
+/// or all of them if no filters are given, and writes the results as JSON
+/// to the output file or to stdout.
+int main( int argc, char **argv )
+{
+	double minTime = 0.5;
+	std::string outputFileName;
+	std::vector<std::string> filters;
+
+	for( int i = 1; i < argc; ++i )
+	{
+		const std::string arg = argv[i];
+		if( arg == "-minTime" && i + 1 < argc )
+		{
+			minTime = boost::lexical_cast<double>( argv[++i] );
+		}
+		else if( arg == "-output" && i + 1 < argc )
+		{
+			outputFileName = argv[++i];
+		}
+		else
+		{
+			filters.push_back( arg );
+		}
+	}
+
+	Results results( minTime );
+	for( Registry::const_iterator it = registry().begin(); it != registry().end(); ++it )
+	{
+		bool run = filters.empty();
+		for( std::vector<std::string>::const_iterator fIt = filters.begin(); fIt != filters.end() && !run; ++fIt )
+		{
+			run = it->first.find( *fIt ) != std::string::npos;
+		}
+
+		if( run )
+		{
+			std::cerr << "Running " << it->first << std::endl;
+			try
+			{
+				it->second( results );
+			}
+			catch( const std::exception &e )
+			{
+				std::cerr << "Error in " << it->first << " : " << e.what() << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	if( outputFileName.size() )
+	{
+		std::ofstream file( outputFileName.c_str() );
+		results.writeJSON( file );
+	}
+	else
+	{
+		results.writeJSON( std::cout );
+	}
+
+	return 0;
+}
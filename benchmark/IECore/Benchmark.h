@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECOREBENCHMARK_BENCHMARK_H
+#define IECOREBENCHMARK_BENCHMARK_H
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "tbb/tick_count.h"
+
+namespace IECoreBenchmark
+{
+
+/// Collects the timings made by the benchmarks, and writes them out as
+/// JSON so that they can be compared between releases.
+class Results
+{
+
+	public :
+
+		/// Measurements run for at least minTime seconds each.
+		Results( double minTime );
+
+		/// Times f(), calling it repeatedly until at least minTime seconds
+		/// have elapsed, and at least three times. The itemsPerCall are used
+		/// to report a throughput in addition to the time per call.
+		template<typename F>
+		void measure( const std::string &name, F &f, size_t itemsPerCall = 1 );
+
+		void writeJSON( std::ostream &o ) const;
+
+	private :
+
+		struct Result
+		{
+			std::string name;
+			size_t calls;
+			double meanTime;
+			double minTime;
+			double itemsPerSecond;
+		};
+
+		std::vector<Result> m_results;
+		double m_minTime;
+
+};
+
+typedef void (*BenchmarkFunction)( Results &results );
+
+/// Registers a benchmark to be run by the IECoreBenchmark program. Each
+/// benchmark file registers its functions with a static instance.
+struct Registration
+{
+	Registration( const std::string &name, BenchmarkFunction function );
+};
+
+template<typename F>
+void Results::measure( const std::string &name, F &f, size_t itemsPerCall )
+{
+	Result result;
+	result.name = name;
+	result.calls = 0;
+	result.minTime = 0;
+
+	double totalTime = 0;
+	while( totalTime < m_minTime || result.calls < 3 )
+	{
+		const tbb::tick_count start = tbb::tick_count::now();
+		f();
+		const double t = ( tbb::tick_count::now() - start ).seconds();
+		result.minTime = result.calls ? std::min( result.minTime, t ) : t;
+		totalTime += t;
+		result.calls++;
+	}
+
+	result.meanTime = totalTime / result.calls;
+	result.itemsPerSecond = result.minTime > 0 ? itemsPerCall / result.minTime : 0;
+	m_results.push_back( result );
+}
+
+} // namespace IECoreBenchmark
+
+#endif // IECOREBENCHMARK_BENCHMARK_H
@@ -0,0 +1,161 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "IECore/LRUCache.h"
+#include "IECore/ObjectPool.h"
+#include "IECore/SimpleTypedData.h"
+
+#include "Benchmark.h"
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+const size_t g_numLookups = 1000000;
+const size_t g_numKeys = 10000;
+
+//////////////////////////////////////////////////////////////////////////
+// LRUCache
+//////////////////////////////////////////////////////////////////////////
+
+IntDataPtr getter( const size_t &key, size_t &cost )
+{
+	cost = 1;
+	return new IntData( key );
+}
+
+template<typename Cache>
+struct CacheLookups
+{
+	CacheLookups( Cache &cache )
+		:	m_cache( cache )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			m_cache.get( ( i * 7919 ) % g_numKeys );
+		}
+	}
+
+	Cache &m_cache;
+};
+
+template<typename Cache>
+struct ParallelCacheLookups
+{
+	// maxCost less than the number of keys, so that lookups both hit and miss.
+	ParallelCacheLookups()
+		:	m_cache( getter, g_numKeys / 2 )
+	{
+	}
+
+	void operator()()
+	{
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, g_numLookups ), CacheLookups<Cache>( m_cache ) );
+	}
+
+	Cache m_cache;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// ObjectPool
+//////////////////////////////////////////////////////////////////////////
+
+struct PoolLookups
+{
+	PoolLookups( ObjectPool *pool, const std::vector<ConstObjectPtr> &objects )
+		:	m_pool( pool ), m_objects( objects )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			const Object *object = m_objects[( i * 7919 ) % m_objects.size()].get();
+			if( !m_pool->retrieve( object->hash() ) )
+			{
+				m_pool->store( object, ObjectPool::StoreReference );
+			}
+		}
+	}
+
+	ObjectPool *m_pool;
+	const std::vector<ConstObjectPtr> &m_objects;
+};
+
+struct ParallelPoolLookups
+{
+	ParallelPoolLookups()
+	{
+		for( size_t i = 0; i < g_numKeys; ++i )
+		{
+			m_objects.push_back( new IntData( i ) );
+		}
+		// limited so that lookups both hit and miss.
+		m_pool = new ObjectPool( m_objects[0]->memoryUsage() * g_numKeys / 2 );
+	}
+
+	void operator()()
+	{
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, g_numLookups ), PoolLookups( m_pool.get(), m_objects ) );
+	}
+
+	ObjectPoolPtr m_pool;
+	std::vector<ConstObjectPtr> m_objects;
+};
+
+void cacheBenchmarks( Results &results )
+{
+	ParallelCacheLookups<LRUCache<size_t, IntDataPtr, LRUCachePolicy::Exact> > exact;
+	results.measure( "LRUCache.exactPolicy", exact, g_numLookups );
+	ParallelCacheLookups<LRUCache<size_t, IntDataPtr, LRUCachePolicy::Sharded> > sharded;
+	results.measure( "LRUCache.shardedPolicy", sharded, g_numLookups );
+	ParallelCacheLookups<LRUCache<size_t, IntDataPtr, LRUCachePolicy::TwoQueue> > twoQueue;
+	results.measure( "LRUCache.twoQueuePolicy", twoQueue, g_numLookups );
+	ParallelPoolLookups pool;
+	results.measure( "ObjectPool.lookups", pool, g_numLookups );
+}
+
+Registration g_registration( "Cache", cacheBenchmarks );
+
+} // namespace
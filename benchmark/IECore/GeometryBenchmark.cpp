@@ -0,0 +1,232 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "OpenEXR/ImathRandom.h"
+
+#include "IECore/KDTree.h"
+#include "IECore/BoundedKDTree.h"
+#include "IECore/MeshPrimitive.h"
+#include "IECore/MeshPrimitiveEvaluator.h"
+#include "IECore/TriangulateOp.h"
+
+#include "Benchmark.h"
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+const size_t g_numPoints = 100000;
+const size_t g_numQueries = 100000;
+
+std::vector<V3f> randomPoints( size_t n, unsigned long seed )
+{
+	Rand32 r( seed );
+	std::vector<V3f> result;
+	result.reserve( n );
+	for( size_t i = 0; i < n; ++i )
+	{
+		result.push_back( V3f( r.nextf(), r.nextf(), r.nextf() ) );
+	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// KDTree
+//////////////////////////////////////////////////////////////////////////
+
+struct BuildKDTree
+{
+	BuildKDTree()
+		:	m_points( randomPoints( g_numPoints, 1 ) )
+	{
+	}
+
+	void operator()()
+	{
+		V3fTree tree( m_points.begin(), m_points.end() );
+	}
+
+	std::vector<V3f> m_points;
+};
+
+struct QueryKDTree
+{
+	QueryKDTree()
+		:	m_points( randomPoints( g_numPoints, 1 ) ), m_queries( randomPoints( g_numQueries, 2 ) ), m_tree( m_points.begin(), m_points.end() )
+	{
+	}
+
+	void operator()()
+	{
+		for( std::vector<V3f>::const_iterator it = m_queries.begin(); it != m_queries.end(); ++it )
+		{
+			m_tree.nearestNeighbour( *it );
+		}
+	}
+
+	std::vector<V3f> m_points;
+	std::vector<V3f> m_queries;
+	V3fTree m_tree;
+};
+
+struct QueryBoundedKDTree
+{
+	QueryBoundedKDTree()
+		:	m_queries( randomPoints( g_numQueries, 2 ) )
+	{
+		const std::vector<V3f> points = randomPoints( g_numPoints, 1 );
+		for( std::vector<V3f>::const_iterator it = points.begin(); it != points.end(); ++it )
+		{
+			m_bounds.push_back( Box3f( *it - V3f( 0.01 ), *it + V3f( 0.01 ) ) );
+		}
+		m_tree.init( m_bounds.begin(), m_bounds.end() );
+	}
+
+	void operator()()
+	{
+		std::vector<Box3fTree::Iterator> intersecting;
+		for( std::vector<V3f>::const_iterator it = m_queries.begin(); it != m_queries.end(); ++it )
+		{
+			intersecting.clear();
+			m_tree.intersectingBounds( Box3f( *it - V3f( 0.01 ), *it + V3f( 0.01 ) ), intersecting );
+		}
+	}
+
+	std::vector<Box3f> m_bounds;
+	std::vector<V3f> m_queries;
+	Box3fTree m_tree;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// MeshPrimitiveEvaluator
+//////////////////////////////////////////////////////////////////////////
+
+struct MeshClosestPoint
+{
+	MeshClosestPoint()
+		:	m_queries( randomPoints( g_numQueries, 3 ) )
+	{
+		MeshPrimitivePtr mesh = MeshPrimitive::createSphere( 0.5, -1, 1, 360, V2i( 100, 200 ) );
+		TriangulateOpPtr op = new TriangulateOp;
+		op->inputParameter()->setValue( mesh );
+		op->copyParameter()->setTypedValue( false );
+		op->operate();
+		m_evaluator = new MeshPrimitiveEvaluator( mesh );
+		m_result = m_evaluator->createResult();
+	}
+
+	void operator()()
+	{
+		for( std::vector<V3f>::const_iterator it = m_queries.begin(); it != m_queries.end(); ++it )
+		{
+			m_evaluator->closestPoint( *it - V3f( 0.5 ), m_result.get() );
+		}
+	}
+
+	std::vector<V3f> m_queries;
+	MeshPrimitiveEvaluatorPtr m_evaluator;
+	PrimitiveEvaluator::ResultPtr m_result;
+};
+
+struct MeshIntersectionPoint
+{
+	MeshIntersectionPoint()
+		:	m_queries( randomPoints( g_numQueries, 4 ) )
+	{
+		MeshPrimitivePtr mesh = MeshPrimitive::createSphere( 0.5, -1, 1, 360, V2i( 100, 200 ) );
+		TriangulateOpPtr op = new TriangulateOp;
+		op->inputParameter()->setValue( mesh );
+		op->copyParameter()->setTypedValue( false );
+		op->operate();
+		m_evaluator = new MeshPrimitiveEvaluator( mesh );
+		m_result = m_evaluator->createResult();
+	}
+
+	void operator()()
+	{
+		for( std::vector<V3f>::const_iterator it = m_queries.begin(); it != m_queries.end(); ++it )
+		{
+			// rays from outside the sphere towards random points within its bound
+			m_evaluator->intersectionPoint( V3f( 0, 0, 2 ), *it - V3f( 0.5, 0.5, 2.5 ), m_result.get() );
+		}
+	}
+
+	std::vector<V3f> m_queries;
+	MeshPrimitiveEvaluatorPtr m_evaluator;
+	PrimitiveEvaluator::ResultPtr m_result;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// TriangulateOp
+//////////////////////////////////////////////////////////////////////////
+
+struct Triangulate
+{
+	Triangulate()
+		:	m_mesh( MeshPrimitive::createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( 500 ) ) ), m_op( new TriangulateOp )
+	{
+		m_op->inputParameter()->setValue( m_mesh );
+	}
+
+	void operator()()
+	{
+		m_op->operate();
+	}
+
+	MeshPrimitivePtr m_mesh;
+	TriangulateOpPtr m_op;
+};
+
+void geometryBenchmarks( Results &results )
+{
+	BuildKDTree buildKDTree;
+	results.measure( "KDTree.build", buildKDTree, g_numPoints );
+	QueryKDTree queryKDTree;
+	results.measure( "KDTree.nearestNeighbour", queryKDTree, g_numQueries );
+	QueryBoundedKDTree queryBoundedKDTree;
+	results.measure( "BoundedKDTree.intersectingBounds", queryBoundedKDTree, g_numQueries );
+	MeshClosestPoint meshClosestPoint;
+	results.measure( "MeshPrimitiveEvaluator.closestPoint", meshClosestPoint, g_numQueries );
+	MeshIntersectionPoint meshIntersectionPoint;
+	results.measure( "MeshPrimitiveEvaluator.intersectionPoint", meshIntersectionPoint, g_numQueries );
+	Triangulate triangulate;
+	results.measure( "TriangulateOp.plane", triangulate, 500 * 500 );
+}
+
+Registration g_registration( "Geometry", geometryBenchmarks );
+
+} // namespace
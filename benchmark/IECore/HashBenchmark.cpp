@@ -0,0 +1,143 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/lexical_cast.hpp"
+
+#include "IECore/MurmurHash.h"
+#include "IECore/InternedString.h"
+#include "IECore/VectorTypedData.h"
+
+#include "Benchmark.h"
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+const size_t g_numElements = 1000000;
+const size_t g_numStrings = 100000;
+
+struct HashVector
+{
+	HashVector()
+		:	m_data( new V3fVectorData( std::vector<V3f>( g_numElements, V3f( 1, 2, 3 ) ) ) )
+	{
+	}
+
+	void operator()()
+	{
+		MurmurHash h;
+		h.append( &m_data->readable()[0], m_data->readable().size() );
+	}
+
+	V3fVectorDataPtr m_data;
+};
+
+struct HashData
+{
+	HashData()
+		:	m_data( new V3fVectorData( std::vector<V3f>( g_numElements, V3f( 1, 2, 3 ) ) ) )
+	{
+	}
+
+	void operator()()
+	{
+		MurmurHash h;
+		m_data->hash( h );
+	}
+
+	V3fVectorDataPtr m_data;
+};
+
+struct HashStrings
+{
+	HashStrings()
+	{
+		for( size_t i = 0; i < g_numStrings; ++i )
+		{
+			m_strings.push_back( "/a/fairly/typical/location/" + boost::lexical_cast<std::string>( i ) );
+		}
+	}
+
+	void operator()()
+	{
+		MurmurHash h;
+		for( std::vector<std::string>::const_iterator it = m_strings.begin(); it != m_strings.end(); ++it )
+		{
+			h.append( *it );
+		}
+	}
+
+	std::vector<std::string> m_strings;
+};
+
+struct InternStrings
+{
+	InternStrings( const std::vector<std::string> &strings )
+		:	m_strings( strings )
+	{
+	}
+
+	void operator()()
+	{
+		for( std::vector<std::string>::const_iterator it = m_strings.begin(); it != m_strings.end(); ++it )
+		{
+			InternedString s( *it );
+		}
+	}
+
+	const std::vector<std::string> &m_strings;
+};
+
+void hashBenchmarks( Results &results )
+{
+	HashVector hashVector;
+	results.measure( "MurmurHash.vector", hashVector, g_numElements );
+	// TypedData caches its hash, so this measures the cost of retrieving it.
+	HashData hashData;
+	results.measure( "TypedData.cachedHash", hashData );
+	HashStrings hashStrings;
+	results.measure( "MurmurHash.strings", hashStrings, g_numStrings );
+
+	// the strings are all interned by the first call, so subsequent
+	// calls measure the cost of looking up existing strings.
+	InternStrings internStrings( hashStrings.m_strings );
+	results.measure( "InternedString.construct", internStrings, g_numStrings );
+}
+
+Registration g_registration( "Hash", hashBenchmarks );
+
+} // namespace
@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "IECore/Reader.h"
+#include "IECore/Exception.h"
+
+#include "Benchmark.h"
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+struct ReadImage
+{
+	ReadImage( ReaderPtr reader )
+		:	m_reader( reader )
+	{
+	}
+
+	void operator()()
+	{
+		m_reader->read();
+	}
+
+	ReaderPtr m_reader;
+};
+
+void imageReaderBenchmarks( Results &results )
+{
+	// paths are relative to the root of the source tree, as for the tests.
+	const char *fileNames[] = {
+		"test/IECore/data/exrFiles/carPark.exr",
+		"test/IECore/data/dpx/uvMap.512x256.dpx",
+		"test/IECore/data/cinFiles/bluegreen_noise.cin",
+		"test/IECore/data/tgaFiles/uvMap.512x256.tga",
+		"test/IECore/data/tiff/bluegreen_noise.400x300.tif",
+		"test/IECore/data/jpg/bluegreen_noise.400x300.jpg",
+		0
+	};
+
+	for( const char **fileName = fileNames; *fileName; ++fileName )
+	{
+		ReaderPtr reader;
+		try
+		{
+			reader = Reader::create( *fileName );
+		}
+		catch( const Exception &e )
+		{
+			// the optional formats may not have been built.
+			std::cerr << "Skipping " << *fileName << " : " << e.what() << std::endl;
+			continue;
+		}
+
+		ReadImage readImage( reader );
+		results.measure( std::string( "ImageReader." ) + reader->typeName(), readImage );
+	}
+}
+
+Registration g_registration( "ImageReader", imageReaderBenchmarks );
+
+} // namespace
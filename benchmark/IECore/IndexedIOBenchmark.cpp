@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/lexical_cast.hpp"
+
+#include "IECore/FileIndexedIO.h"
+
+#include "Benchmark.h"
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+const char *g_fileName = "/tmp/IECoreBenchmark.fio";
+const size_t g_numEntries = 1000;
+const size_t g_entrySize = 1000;
+
+struct WriteIndexedIO
+{
+	void operator()()
+	{
+		std::vector<float> data( g_entrySize, 1.0f );
+		IndexedIOPtr io = new FileIndexedIO( g_fileName, IndexedIO::rootPath, IndexedIO::Write );
+		for( size_t i = 0; i < g_numEntries; ++i )
+		{
+			IndexedIOPtr d = io->subdirectory( boost::lexical_cast<std::string>( i ), IndexedIO::CreateIfMissing );
+			d->write( "data", &data[0], data.size() );
+		}
+	}
+};
+
+struct OpenIndexedIO
+{
+	void operator()()
+	{
+		IndexedIOPtr io = new FileIndexedIO( g_fileName, IndexedIO::rootPath, IndexedIO::Read );
+	}
+};
+
+struct ReadIndexedIO
+{
+	void operator()()
+	{
+		std::vector<float> data( g_entrySize );
+		float *dataPtr = &data[0];
+		IndexedIOPtr io = new FileIndexedIO( g_fileName, IndexedIO::rootPath, IndexedIO::Read );
+		IndexedIO::EntryIDList entries;
+		io->entryIds( entries );
+		for( IndexedIO::EntryIDList::const_iterator it = entries.begin(); it != entries.end(); ++it )
+		{
+			io->subdirectory( *it )->read( "data", dataPtr, data.size() );
+		}
+	}
+};
+
+void indexedIOBenchmarks( Results &results )
+{
+	WriteIndexedIO write;
+	results.measure( "IndexedIO.write", write, g_numEntries );
+	OpenIndexedIO open;
+	results.measure( "IndexedIO.open", open );
+	ReadIndexedIO read;
+	results.measure( "IndexedIO.read", read, g_numEntries );
+}
+
+Registration g_registration( "IndexedIO", indexedIOBenchmarks );
+
+} // namespace
@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/lexical_cast.hpp"
+
+#include "IECore/SceneCache.h"
+#include "IECore/MeshPrimitive.h"
+#include "IECore/SimpleTypedData.h"
+
+#include "Benchmark.h"
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+const char *g_fileName = "/tmp/IECoreBenchmark.scc";
+// 10 groups of 100 locations, plus the groups and the root.
+const size_t g_numLocations = 1011;
+
+void writeSceneCache()
+{
+	MeshPrimitivePtr mesh = MeshPrimitive::createSphere( 1 );
+	SceneInterfacePtr root = new SceneCache( g_fileName, IndexedIO::Write );
+	for( int i = 0; i < 10; ++i )
+	{
+		SceneInterfacePtr group = root->createChild( boost::lexical_cast<std::string>( i ) );
+		for( int j = 0; j < 100; ++j )
+		{
+			SceneInterfacePtr location = group->createChild( boost::lexical_cast<std::string>( j ) );
+			for( int frame = 0; frame < 5; ++frame )
+			{
+				M44dDataPtr transform = new M44dData( M44d().setTranslation( V3d( i, j, frame ) ) );
+				location->writeTransform( transform.get(), frame );
+			}
+			location->writeObject( mesh.get(), 0 );
+		}
+	}
+}
+
+struct TraverseSceneCache
+{
+	TraverseSceneCache( bool readObjects )
+		:	m_readObjects( readObjects )
+	{
+	}
+
+	void operator()()
+	{
+		SceneCache::clearCache();
+		ConstSceneInterfacePtr root = new SceneCache( g_fileName, IndexedIO::Read );
+		traverse( root.get() );
+	}
+
+	void traverse( const SceneInterface *scene )
+	{
+		scene->readBound( 2.5 );
+		scene->readTransformAsMatrix( 2.5 );
+		if( m_readObjects && scene->hasObject() )
+		{
+			scene->readObject( 0 );
+		}
+
+		SceneInterface::NameList childNames;
+		scene->childNames( childNames );
+		for( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+		{
+			traverse( scene->child( *it ).get() );
+		}
+	}
+
+	bool m_readObjects;
+};
+
+void sceneCacheBenchmarks( Results &results )
+{
+	writeSceneCache();
+	TraverseSceneCache traverseHierarchy( false );
+	results.measure( "SceneCache.traverse", traverseHierarchy, g_numLocations );
+	TraverseSceneCache traverseObjects( true );
+	results.measure( "SceneCache.traverseObjects", traverseObjects, g_numLocations );
+}
+
+Registration g_registration( "SceneCache", sceneCacheBenchmarks );
+
+} // namespace
@@ -142,6 +142,9 @@ class IECOREALEMBIC_API AlembicInput : public IECore::RefCounted
 		//@}
 		
 		//! @name Child access
+		/// Children are created on demand and then cached, so that
+		/// subsequent calls return the same instance. All methods
+		/// may be called concurrently from multiple threads.
 		////////////////////////////////////////////////////////////
 		//@{
 		size_t numChildren() const;
@@ -155,6 +158,8 @@ class IECOREALEMBIC_API AlembicInput : public IECore::RefCounted
 		AlembicInput();
 	
 		void ensureTimeSampling() const;
+		// Must be called with the mutex in DataMembers held.
+		AlembicInputPtr childInternal( size_t index ) const;
 	
 		struct DataMembers;
 		
@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECOREALEMBIC_ALEMBICSCENE_H
+#define IECOREALEMBIC_ALEMBICSCENE_H
+
+#include "boost/shared_ptr.hpp"
+
+#include "IECore/SceneInterface.h"
+
+#include "IECoreAlembic/Export.h"
+#include "IECoreAlembic/TypeIds.h"
+
+namespace IECoreAlembic
+{
+
+IE_CORE_FORWARDDECLARE( AlembicScene )
+
+/// A read-only SceneInterface implementation for Alembic archives, allowing
+/// them to be used anywhere a SceneCache can be, without an offline conversion.
+/// Alembic transforms map to scene locations, and a shape which is the only
+/// shape below its transform becomes the object at that location (as is the
+/// case for files exported from Maya). Any other shapes are presented as child
+/// locations with an identity transform.
+///
+/// Locations are built on demand from AlembicInputs and then shared between
+/// all AlembicScene instances for the same archive, and all methods may be
+/// called concurrently from multiple threads. Attributes and tags are not
+/// currently supported, and all write methods throw.
+class IECOREALEMBIC_API AlembicScene : public IECore::SceneInterface
+{
+
+	public :
+
+		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( AlembicScene, AlembicSceneTypeId, IECore::SceneInterface );
+
+		/// Opens the specified file. Only IndexedIO::Read is supported.
+		AlembicScene( const std::string &fileName, IECore::IndexedIO::OpenMode mode );
+		virtual ~AlembicScene();
+
+		virtual std::string fileName() const;
+
+		virtual Name name() const;
+		virtual void path( Path &p ) const;
+
+		/*
+		 * Bounding box
+		 */
+
+		virtual Imath::Box3d readBound( double time ) const;
+		/// Throws an exception.
+		virtual void writeBound( const Imath::Box3d &bound, double time );
+
+		/*
+		 * Transform
+		 */
+
+		/// Returns the transform as M44dData.
+		virtual IECore::ConstDataPtr readTransform( double time ) const;
+		virtual Imath::M44d readTransformAsMatrix( double time ) const;
+		/// Throws an exception.
+		virtual void writeTransform( const IECore::Data *transform, double time );
+
+		/*
+		 * Attributes
+		 */
+
+		virtual bool hasAttribute( const Name &name ) const;
+		virtual void attributeNames( NameList &attrs ) const;
+		virtual IECore::ConstObjectPtr readAttribute( const Name &name, double time ) const;
+		/// Throws an exception.
+		virtual void writeAttribute( const Name &name, const IECore::Object *attribute, double time );
+
+		/*
+		 * Tags
+		 */
+
+		virtual bool hasTag( const Name &name, int filter = SceneInterface::LocalTag ) const;
+		virtual void readTags( NameList &tags, int filter = SceneInterface::LocalTag ) const;
+		/// Throws an exception.
+		virtual void writeTags( const NameList &tags );
+
+		/*
+		 * Object
+		 */
+
+		virtual bool hasObject() const;
+		virtual IECore::ConstObjectPtr readObject( double time ) const;
+		virtual IECore::PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<IECore::InternedString> &primVarNames, double time ) const;
+		/// Throws an exception.
+		virtual void writeObject( const IECore::Object *object, double time );
+
+		/*
+		 * Hierarchy
+		 */
+
+		virtual bool hasChild( const Name &name ) const;
+		virtual void childNames( NameList &childNames ) const;
+		virtual IECore::SceneInterfacePtr child( const Name &name, MissingBehaviour missingBehaviour = SceneInterface::ThrowIfMissing );
+		virtual IECore::ConstSceneInterfacePtr child( const Name &name, MissingBehaviour missingBehaviour = SceneInterface::ThrowIfMissing ) const;
+		/// Throws an exception.
+		virtual IECore::SceneInterfacePtr createChild( const Name &name );
+		virtual IECore::SceneInterfacePtr scene( const Path &path, MissingBehaviour missingBehaviour = SceneInterface::ThrowIfMissing );
+		virtual IECore::ConstSceneInterfacePtr scene( const Path &path, MissingBehaviour missingBehaviour = SceneInterface::ThrowIfMissing ) const;
+
+		/*
+		 * Batch reading
+		 */
+
+		/// Reads the objects in parallel.
+		virtual void readObjects( const std::vector<Path> &paths, double time, std::vector<IECore::ConstObjectPtr> &objects ) const;
+
+		/*
+		 * Hash
+		 */
+
+		/// Hashes the file name and location, adding the time only when
+		/// the queried data is animated.
+		virtual void hash( HashType hashType, double time, IECore::MurmurHash &h ) const;
+
+	private :
+
+		class Location;
+		typedef boost::shared_ptr<Location> LocationPtr;
+
+		AlembicScene( const std::string &fileName, LocationPtr root, LocationPtr location, const Path &path );
+
+		AlembicScenePtr retrieveChild( const Name &name, MissingBehaviour missingBehaviour ) const;
+		AlembicScenePtr retrieveScene( const Path &path, MissingBehaviour missingBehaviour ) const;
+		void throwReadOnly( const char *method ) const;
+
+		std::string m_fileName;
+		LocationPtr m_root;
+		LocationPtr m_location;
+		Path m_path;
+
+};
+
+} // namespace IECoreAlembic
+
+#endif // IECOREALEMBIC_ALEMBICSCENE_H
@@ -32,6 +32,13 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <map>
+
+#include "boost/weak_ptr.hpp"
+
+#include "tbb/mutex.h"
+#include "tbb/task_scheduler_init.h"
+
 #include "OpenEXR/ImathBoxAlgo.h"
 
 #include "Alembic/AbcCoreHDF5/ReadWrite.h"
@@ -58,36 +65,117 @@ using namespace Alembic::AbcGeom;
 using namespace IECoreAlembic;
 using namespace IECore;
 
+//////////////////////////////////////////////////////////////////////////
+// Archive cache. Many AlembicInputs (from several procedurals for instance)
+// may open the same file, so we share archives between them for as long as
+// any of them remains alive.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef std::map<std::string, boost::weak_ptr<IArchive> > ArchiveCache;
+
+ArchiveCache &archiveCache()
+{
+	static ArchiveCache c;
+	return c;
+}
+
+tbb::mutex &archiveCacheMutex()
+{
+	static tbb::mutex m;
+	return m;
+}
+
+boost::shared_ptr<IArchive> openArchive( const std::string &fileName )
+{
+#ifdef IECOREALEMBIC_WITH_OGAWA
+	Alembic::AbcCoreFactory::IFactory factory;
+	// the converters copy everything they read into Cortex data, so there's
+	// no point in Alembic holding onto a second copy in its sample cache.
+	factory.setSampleCache( Alembic::AbcCoreAbstract::ReadArraySampleCachePtr() );
+#if ALEMBIC_LIBRARY_VERSION >= 10503
+	// allow concurrent reads from several threads, as may happen when
+	// different children are converted in parallel.
+	factory.setOgawaNumStreams( tbb::task_scheduler_init::default_num_threads() );
+#endif
+	boost::shared_ptr<IArchive> result( new IArchive( factory.getArchive( fileName ) ) );
+	if( !result->valid() )
+	{
+		// even though the default policy for IFactory is kThrowPolicy, this appears not to
+		// be applied when it fails to load an archive - instead it returns an invalid archive.
+		throw IECore::Exception( boost::str( boost::format( "Unable to open file \"%s\"" ) % fileName ) );
+	}
+	return result;
+#else
+	return boost::shared_ptr<IArchive>( new IArchive( ::Alembic::AbcCoreHDF5::ReadArchive(), fileName ) );
+#endif
+}
+
+boost::shared_ptr<IArchive> sharedArchive( const std::string &fileName )
+{
+	tbb::mutex::scoped_lock lock( archiveCacheMutex() );
+
+	ArchiveCache &cache = archiveCache();
+	boost::shared_ptr<IArchive> result = cache[fileName].lock();
+	if( !result )
+	{
+		result = openArchive( fileName );
+		cache[fileName] = result;
+	}
+
+	// take the opportunity to remove any archives which are no longer in use.
+	for( ArchiveCache::iterator it = cache.begin(); it != cache.end(); )
+	{
+		if( it->second.expired() )
+		{
+			cache.erase( it++ );
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	return result;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// AlembicInput
+//////////////////////////////////////////////////////////////////////////
+
 struct AlembicInput::DataMembers
 {
 	DataMembers()
-		: numSamples( -1 )
+		: numSamples( -1 ), hasStoredBound( -1 ), childIndicesInitialised( false )
 	{
 	}
 	
 	boost::shared_ptr<IArchive> archive;
 	IObject object;
+
+	// Lazily computed state. This is protected by the mutex so
+	// that an AlembicInput may be used from several threads at once.
+	typedef tbb::mutex Mutex;
+	Mutex mutex;
 	int numSamples;
 	TimeSamplingPtr timeSampling;
+	int hasStoredBound;
+
+	// Children are created on demand and then reused, so that repeated
+	// traversals of the hierarchy share the lazily computed state above.
+	std::vector<AlembicInputPtr> children;
+	std::map<std::string, size_t> childIndices;
+	bool childIndicesInitialised;
 };
 
 AlembicInput::AlembicInput( const std::string &fileName )
 {
 	m_data = boost::shared_ptr<DataMembers>( new DataMembers );
-	
-#ifdef IECOREALEMBIC_WITH_OGAWA
-	Alembic::AbcCoreFactory::IFactory factory;
-	m_data->archive = boost::shared_ptr<IArchive>( new IArchive( factory.getArchive( fileName ) ) );
-	if( !m_data->archive->valid() )
-	{
-		// even though the default policy for IFactory is kThrowPolicy, this appears not to
-		// be applied when it fails to load an archive - instead it returns an invalid archive.
-		throw IECore::Exception( boost::str( boost::format( "Unable to open file \"%s\"" ) % fileName ) );
-	}
-#else
-	m_data->archive = boost::shared_ptr<IArchive>( new IArchive( ::Alembic::AbcCoreHDF5::ReadArchive(), fileName ) );
-#endif
-	
+	m_data->archive = sharedArchive( fileName );
 	m_data->object = m_data->archive->getTop();
 }
 
@@ -124,6 +212,7 @@ IECore::CompoundDataPtr AlembicInput::metaData() const
 
 size_t AlembicInput::numSamples() const
 {
+	DataMembers::Mutex::scoped_lock lock( m_data->mutex );
 	if( m_data->numSamples != -1 )
 	{
 		return m_data->numSamples;
@@ -207,22 +296,29 @@ double AlembicInput::sampleIntervalAtTime( double time, size_t &floorIndex, size
 
 bool AlembicInput::hasStoredBound() const
 {
+	DataMembers::Mutex::scoped_lock lock( m_data->mutex );
+	if( m_data->hasStoredBound != -1 )
+	{
+		return m_data->hasStoredBound;
+	}
+
 	const MetaData &md = m_data->object.getMetaData();
 	if( !m_data->object.getParent() )
 	{
-		return m_data->object.getProperties().getPropertyHeader( ".childBnds" ) != 0x0;
+		m_data->hasStoredBound = m_data->object.getProperties().getPropertyHeader( ".childBnds" ) != 0x0;
 	}
 	else if( IXform::matches( md ) )
 	{
 		IXform iXForm( m_data->object, kWrapExisting );
 		IXformSchema &iXFormSchema = iXForm.getSchema();
-		return iXFormSchema.getChildBoundsProperty();
+		m_data->hasStoredBound = (bool)iXFormSchema.getChildBoundsProperty();
 	}
-	else if( IGeomBase::matches( md ) )
+	else
 	{
-		return true;
+		m_data->hasStoredBound = IGeomBase::matches( md );
 	}
-	return false;
+
+	return m_data->hasStoredBound;
 }
 		
 Imath::Box3d AlembicInput::boundAtSample( size_t sampleIndex ) const
@@ -420,14 +516,8 @@ size_t AlembicInput::numChildren() const
 
 AlembicInputPtr AlembicInput::child( size_t index ) const
 {
-	AlembicInputPtr result = new AlembicInput();
-	result->m_data = boost::shared_ptr<DataMembers>( new DataMembers );
-	result->m_data->archive = this->m_data->archive;
-	/// \todo this is documented as not being the best way of doing things in
-	/// the alembic documentation. I'm not sure what would be better though,
-	/// and it appears to work fine so far.
-	result->m_data->object = this->m_data->object.getChild( index );
-	return result;
+	DataMembers::Mutex::scoped_lock lock( m_data->mutex );
+	return childInternal( index );
 }
 
 IECore::StringVectorDataPtr AlembicInput::childNames() const
@@ -444,21 +534,55 @@ IECore::StringVectorDataPtr AlembicInput::childNames() const
 
 AlembicInputPtr AlembicInput::child( const std::string &name ) const
 {
-	IObject c = m_data->object.getChild( name );
-	if( !c )
+	DataMembers::Mutex::scoped_lock lock( m_data->mutex );
+
+	if( !m_data->childIndicesInitialised )
+	{
+		for( size_t i = 0, n = m_data->object.getNumChildren(); i < n; ++i )
+		{
+			m_data->childIndices[m_data->object.getChildHeader( i ).getName()] = i;
+		}
+		m_data->childIndicesInitialised = true;
+	}
+
+	std::map<std::string, size_t>::const_iterator it = m_data->childIndices.find( name );
+	if( it == m_data->childIndices.end() )
 	{
 		throw InvalidArgumentException( name );
 	}
-	
-	AlembicInputPtr result = new AlembicInput();
-	result->m_data = boost::shared_ptr<DataMembers>( new DataMembers );
-	result->m_data->archive = m_data->archive;
-	result->m_data->object = c;
+
+	return childInternal( it->second );
+}
+
+AlembicInputPtr AlembicInput::childInternal( size_t index ) const
+{
+	if( m_data->children.empty() )
+	{
+		m_data->children.resize( m_data->object.getNumChildren() );
+	}
+
+	if( index >= m_data->children.size() )
+	{
+		throw InvalidArgumentException( "Child index out of range" );
+	}
+
+	AlembicInputPtr &result = m_data->children[index];
+	if( !result )
+	{
+		result = new AlembicInput();
+		result->m_data = boost::shared_ptr<DataMembers>( new DataMembers );
+		result->m_data->archive = m_data->archive;
+		/// \todo this is documented as not being the best way of doing things in
+		/// the alembic documentation. I'm not sure what would be better though,
+		/// and it appears to work fine so far.
+		result->m_data->object = m_data->object.getChild( index );
+	}
 	return result;
 }
 
 void AlembicInput::ensureTimeSampling() const
 {
+	DataMembers::Mutex::scoped_lock lock( m_data->mutex );
 	if( m_data->timeSampling )
 	{
 		return;
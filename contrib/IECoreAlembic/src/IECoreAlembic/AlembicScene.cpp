@@ -0,0 +1,504 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "tbb/mutex.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "IECore/Exception.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/Primitive.h"
+
+#include "IECoreAlembic/AlembicScene.h"
+#include "IECoreAlembic/AlembicInput.h"
+
+using namespace IECore;
+using namespace IECoreAlembic;
+
+IE_CORE_DEFINERUNTIMETYPED( AlembicScene );
+
+static SceneInterface::FileFormatDescription<AlembicScene> registrar( ".abc", IndexedIO::Read );
+
+//////////////////////////////////////////////////////////////////////////
+// Location. This maps the Alembic hierarchy onto the SceneInterface one,
+// and is built lazily and shared by all AlembicScenes for an archive.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+bool isTransform( const AlembicInput *input )
+{
+	ConstCompoundDataPtr metaData = input->metaData();
+	const StringData *schema = metaData->member<StringData>( "schema" );
+	return schema && schema->readable().compare( 0, 13, "AbcGeom_Xform" ) == 0;
+}
+
+} // namespace
+
+class AlembicScene::Location
+{
+
+	public :
+
+		/// The xform provides the transform for the location, and the
+		/// container provides the children. Either may be null, and the
+		/// object is determined from the container unless it is specified
+		/// explicitly.
+		Location( const Name &name, ConstAlembicInputPtr xform, ConstAlembicInputPtr container, ConstAlembicInputPtr object )
+			:	m_name( name ), m_xform( xform ), m_container( container ), m_object( object ), m_childrenInitialised( false )
+		{
+		}
+
+		const Name &name() const
+		{
+			return m_name;
+		}
+
+		const AlembicInput *xform() const
+		{
+			return m_xform.get();
+		}
+
+		const AlembicInput *object() const
+		{
+			ensureChildren();
+			return m_object.get();
+		}
+
+		/// Returns the input which provides the bound for the location.
+		const AlembicInput *boundSource() const
+		{
+			if( m_xform )
+			{
+				return m_xform.get();
+			}
+			return m_container ? m_container.get() : object();
+		}
+
+		const NameList &childNames() const
+		{
+			ensureChildren();
+			return m_childNames;
+		}
+
+		LocationPtr child( const Name &name ) const
+		{
+			ensureChildren();
+			ChildMap::const_iterator it = m_children.find( name );
+			return it != m_children.end() ? it->second : LocationPtr();
+		}
+
+	private :
+
+		void ensureChildren() const
+		{
+			tbb::mutex::scoped_lock lock( m_mutex );
+			if( m_childrenInitialised )
+			{
+				return;
+			}
+
+			if( m_container )
+			{
+				std::vector<ConstAlembicInputPtr> xforms;
+				std::vector<ConstAlembicInputPtr> shapes;
+				for( size_t i = 0, n = m_container->numChildren(); i < n; ++i )
+				{
+					ConstAlembicInputPtr c = m_container->child( i );
+					if( isTransform( c.get() ) )
+					{
+						xforms.push_back( c );
+					}
+					else if( c->converter() )
+					{
+						shapes.push_back( c );
+					}
+				}
+
+				// a lone shape below a transform becomes the object at the
+				// transform's location, and any others become locations of
+				// their own.
+				if( m_xform && shapes.size() == 1 )
+				{
+					m_object = shapes[0];
+					shapes.clear();
+				}
+
+				for( std::vector<ConstAlembicInputPtr>::const_iterator it = xforms.begin(); it != xforms.end(); ++it )
+				{
+					addChild( LocationPtr( new Location( (*it)->name(), *it, *it, 0 ) ) );
+				}
+
+				for( std::vector<ConstAlembicInputPtr>::const_iterator it = shapes.begin(); it != shapes.end(); ++it )
+				{
+					addChild( LocationPtr( new Location( (*it)->name(), 0, 0, *it ) ) );
+				}
+			}
+
+			m_childrenInitialised = true;
+		}
+
+		void addChild( LocationPtr child ) const
+		{
+			m_childNames.push_back( child->name() );
+			m_children[child->name()] = child;
+		}
+
+		typedef std::map<Name, LocationPtr> ChildMap;
+
+		Name m_name;
+		ConstAlembicInputPtr m_xform;
+		ConstAlembicInputPtr m_container;
+
+		mutable tbb::mutex m_mutex;
+		mutable ConstAlembicInputPtr m_object;
+		mutable bool m_childrenInitialised;
+		mutable NameList m_childNames;
+		mutable ChildMap m_children;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// AlembicScene
+//////////////////////////////////////////////////////////////////////////
+
+AlembicScene::AlembicScene( const std::string &fileName, IndexedIO::OpenMode mode )
+	:	m_fileName( fileName )
+{
+	if( mode & ( IndexedIO::Write | IndexedIO::Append ) )
+	{
+		throw InvalidArgumentException( "AlembicScene only supports IndexedIO::Read" );
+	}
+
+	AlembicInputPtr top = new AlembicInput( fileName );
+	m_root = LocationPtr( new Location( rootName, 0, top, 0 ) );
+	m_location = m_root;
+}
+
+AlembicScene::AlembicScene( const std::string &fileName, LocationPtr root, LocationPtr location, const Path &path )
+	:	m_fileName( fileName ), m_root( root ), m_location( location ), m_path( path )
+{
+}
+
+AlembicScene::~AlembicScene()
+{
+}
+
+std::string AlembicScene::fileName() const
+{
+	return m_fileName;
+}
+
+SceneInterface::Name AlembicScene::name() const
+{
+	return m_location->name();
+}
+
+void AlembicScene::path( Path &p ) const
+{
+	p = m_path;
+}
+
+Imath::Box3d AlembicScene::readBound( double time ) const
+{
+	const AlembicInput *source = m_location->boundSource();
+	return source ? source->boundAtTime( time ) : Imath::Box3d();
+}
+
+void AlembicScene::writeBound( const Imath::Box3d &bound, double time )
+{
+	throwReadOnly( "writeBound" );
+}
+
+ConstDataPtr AlembicScene::readTransform( double time ) const
+{
+	return new M44dData( readTransformAsMatrix( time ) );
+}
+
+Imath::M44d AlembicScene::readTransformAsMatrix( double time ) const
+{
+	const AlembicInput *xform = m_location->xform();
+	return xform ? xform->transformAtTime( time ) : Imath::M44d();
+}
+
+void AlembicScene::writeTransform( const Data *transform, double time )
+{
+	throwReadOnly( "writeTransform" );
+}
+
+bool AlembicScene::hasAttribute( const Name &name ) const
+{
+	return false;
+}
+
+void AlembicScene::attributeNames( NameList &attrs ) const
+{
+	attrs.clear();
+}
+
+ConstObjectPtr AlembicScene::readAttribute( const Name &name, double time ) const
+{
+	throw IOException( "No attribute \"" + name.string() + "\"" );
+}
+
+void AlembicScene::writeAttribute( const Name &name, const Object *attribute, double time )
+{
+	throwReadOnly( "writeAttribute" );
+}
+
+bool AlembicScene::hasTag( const Name &name, int filter ) const
+{
+	return false;
+}
+
+void AlembicScene::readTags( NameList &tags, int filter ) const
+{
+	tags.clear();
+}
+
+void AlembicScene::writeTags( const NameList &tags )
+{
+	throwReadOnly( "writeTags" );
+}
+
+bool AlembicScene::hasObject() const
+{
+	return m_location->object();
+}
+
+ConstObjectPtr AlembicScene::readObject( double time ) const
+{
+	const AlembicInput *object = m_location->object();
+	return object ? object->objectAtTime( time ) : 0;
+}
+
+PrimitiveVariableMap AlembicScene::readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const
+{
+	ConstObjectPtr object = readObject( time );
+	const Primitive *primitive = runTimeCast<const Primitive>( object.get() );
+	if( !primitive )
+	{
+		throw Exception( "Object is not a Primitive" );
+	}
+
+	PrimitiveVariableMap result;
+	for( std::vector<InternedString>::const_iterator it = primVarNames.begin(); it != primVarNames.end(); ++it )
+	{
+		PrimitiveVariableMap::const_iterator vIt = primitive->variables.find( *it );
+		if( vIt != primitive->variables.end() )
+		{
+			result.insert( *vIt );
+		}
+	}
+
+	return result;
+}
+
+void AlembicScene::writeObject( const Object *object, double time )
+{
+	throwReadOnly( "writeObject" );
+}
+
+bool AlembicScene::hasChild( const Name &name ) const
+{
+	return m_location->child( name );
+}
+
+void AlembicScene::childNames( NameList &childNames ) const
+{
+	childNames = m_location->childNames();
+}
+
+SceneInterfacePtr AlembicScene::child( const Name &name, MissingBehaviour missingBehaviour )
+{
+	return retrieveChild( name, missingBehaviour );
+}
+
+ConstSceneInterfacePtr AlembicScene::child( const Name &name, MissingBehaviour missingBehaviour ) const
+{
+	return retrieveChild( name, missingBehaviour );
+}
+
+SceneInterfacePtr AlembicScene::createChild( const Name &name )
+{
+	throwReadOnly( "createChild" );
+	return 0;
+}
+
+SceneInterfacePtr AlembicScene::scene( const Path &path, MissingBehaviour missingBehaviour )
+{
+	return retrieveScene( path, missingBehaviour );
+}
+
+ConstSceneInterfacePtr AlembicScene::scene( const Path &path, MissingBehaviour missingBehaviour ) const
+{
+	return retrieveScene( path, missingBehaviour );
+}
+
+namespace
+{
+
+// Reads the objects for a range of locations in parallel.
+class ObjectReader
+{
+
+	public :
+
+		ObjectReader( const AlembicScene *scene, const std::vector<SceneInterface::Path> &paths, double time, std::vector<ConstObjectPtr> &objects )
+			:	m_scene( scene ), m_paths( paths ), m_time( time ), m_objects( objects )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_objects[i] = m_scene->scene( m_paths[i] )->readObject( m_time );
+			}
+		}
+
+	private :
+
+		const AlembicScene *m_scene;
+		const std::vector<SceneInterface::Path> &m_paths;
+		double m_time;
+		std::vector<ConstObjectPtr> &m_objects;
+
+};
+
+} // namespace
+
+void AlembicScene::readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const
+{
+	objects.clear();
+	objects.resize( paths.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, paths.size() ), ObjectReader( this, paths, time, objects ) );
+}
+
+void AlembicScene::hash( HashType hashType, double time, MurmurHash &h ) const
+{
+	SceneInterface::hash( hashType, time, h );
+
+	h.append( m_fileName );
+	h.append( (unsigned char)hashType );
+	h.append( (uint64_t)m_path.size() );
+	for( Path::const_iterator it = m_path.begin(); it != m_path.end(); ++it )
+	{
+		h.append( *it );
+	}
+
+	bool animated = false;
+	switch( hashType )
+	{
+		case TransformHash :
+			animated = m_location->xform() && m_location->xform()->numSamples() > 1;
+			break;
+		case BoundHash :
+		{
+			// bounds which aren't stored are computed from the descendants,
+			// which may be animated even if the location itself isn't.
+			const AlembicInput *source = m_location->boundSource();
+			animated = source && ( !source->hasStoredBound() || source->numSamples() > 1 );
+			break;
+		}
+		case ObjectHash :
+			animated = m_location->object() && m_location->object()->numSamples() > 1;
+			break;
+		case AttributesHash :
+		case ChildNamesHash :
+			break;
+		case HierarchyHash :
+			animated = true;
+			break;
+	}
+
+	if( animated )
+	{
+		h.append( time );
+	}
+}
+
+AlembicScenePtr AlembicScene::retrieveChild( const Name &name, MissingBehaviour missingBehaviour ) const
+{
+	LocationPtr c = m_location->child( name );
+	if( !c )
+	{
+		if( missingBehaviour == SceneInterface::CreateIfMissing )
+		{
+			throwReadOnly( "child" );
+		}
+		else if( missingBehaviour == SceneInterface::ThrowIfMissing )
+		{
+			throw IOException( "Child \"" + name.string() + "\" does not exist" );
+		}
+		return 0;
+	}
+
+	Path childPath( m_path );
+	childPath.push_back( name );
+	return new AlembicScene( m_fileName, m_root, c, childPath );
+}
+
+AlembicScenePtr AlembicScene::retrieveScene( const Path &path, MissingBehaviour missingBehaviour ) const
+{
+	LocationPtr location = m_root;
+	for( Path::const_iterator it = path.begin(); it != path.end(); ++it )
+	{
+		location = location->child( *it );
+		if( !location )
+		{
+			if( missingBehaviour == SceneInterface::CreateIfMissing )
+			{
+				throwReadOnly( "scene" );
+			}
+			else if( missingBehaviour == SceneInterface::ThrowIfMissing )
+			{
+				std::string pathString;
+				pathToString( path, pathString );
+				throw IOException( "Location \"" + pathString + "\" does not exist" );
+			}
+			return 0;
+		}
+	}
+
+	return new AlembicScene( m_fileName, m_root, location, path );
+}
+
+void AlembicScene::throwReadOnly( const char *method ) const
+{
+	throw Exception( std::string( "AlembicScene::" ) + method + " : AlembicScene is read-only" );
+}
@@ -67,12 +67,12 @@ void FromAlembicGeomBaseConverter::convertUVs( Alembic::AbcGeom::IV2fGeomParam &
 	FloatVectorDataPtr tData = new FloatVectorData;
 	std::vector<float> &s = sData->writable();
 	std::vector<float> &t = tData->writable();
-	s.resize( size );
-	t.resize( size );
+	s.reserve( size );
+	t.reserve( size );
 	for( size_t i=0; i<size; ++i )
 	{
-		s[i] = (*sample)[i][0];
-		t[i] = (*sample)[i][1];			
+		s.push_back( (*sample)[i][0] );
+		t.push_back( (*sample)[i][1] );
 	}
 	
 	PrimitiveVariable::Interpolation interpolation = interpolationFromScope( uvs.getScope() );
@@ -209,8 +209,7 @@ void FromAlembicGeomBaseConverter::convertGeomParam( T &param, const Alembic::Ab
 	SamplePtr sample = param.getExpandedValue( sampleSelector ).getVals();
 	
 	typename DataType::Ptr data = new DataType();
-	data->writable().resize( sample->size() );
-	std::copy( sample->get(), sample->get() + sample->size(), data->writable().begin() );
+	data->writable().assign( sample->get(), sample->get() + sample->size() );
  
 	ApplyGeometricInterpretation<DataType, T>::apply( data.get() );
 	
@@ -57,22 +57,24 @@ IECore::ObjectPtr FromAlembicSubDConverter::doAlembicConversion( const Alembic::
 	ISubDSchema::Sample sample = iSubDSchema.getValue( sampleSelector );
 	
 	IntVectorDataPtr verticesPerFace = new IntVectorData();
-	verticesPerFace->writable().insert(
-		verticesPerFace->writable().begin(),
+	verticesPerFace->writable().assign(
 		sample.getFaceCounts()->get(),
 		sample.getFaceCounts()->get() + sample.getFaceCounts()->size()
 	);
 	
 	IntVectorDataPtr vertexIds = new IntVectorData();
-	vertexIds->writable().insert(
-		vertexIds->writable().begin(),
+	vertexIds->writable().assign(
 		sample.getFaceIndices()->get(),
 		sample.getFaceIndices()->get() + sample.getFaceIndices()->size()
 	);
 	
+	// assigning directly from the sample avoids initialising
+	// the memory before copying into it.
 	V3fVectorDataPtr points = new V3fVectorData();
-	points->writable().resize( sample.getPositions()->size() );
-	memcpy( &(points->writable()[0]), sample.getPositions()->get(), sample.getPositions()->size() * sizeof( Imath::V3f ) );
+	points->writable().assign(
+		sample.getPositions()->get(),
+		sample.getPositions()->get() + sample.getPositions()->size()
+	);
 	
 	std::string interpolation = sample.getSubdivisionScheme();
 	if( interpolation == "catmull-clark" )
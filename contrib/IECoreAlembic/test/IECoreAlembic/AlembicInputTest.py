@@ -462,5 +462,26 @@ class AlembicInputTest( unittest.TestCase ) :
 		self.assertEqual( m.numChildren(), 0 )
 		self.assertEqual( m.childNames(), IECore.StringVectorData() )
 
+	def testChildrenAreReused( self ) :
+
+		a = IECoreAlembic.AlembicInput( os.path.dirname( __file__ ) + "/data/cube.abc" )
+
+		g1 = a.child( 0 )
+		g2 = a.child( "group1" )
+		self.failUnless( g1.isSame( g2 ) )
+		self.failUnless( g1.isSame( a.child( 0 ) ) )
+
+		self.assertRaises( Exception, a.child, "iDontExist" )
+
+	def testSharedArchive( self ) :
+
+		a1 = IECoreAlembic.AlembicInput( os.path.dirname( __file__ ) + "/data/animatedCube.abc" )
+		a2 = IECoreAlembic.AlembicInput( os.path.dirname( __file__ ) + "/data/animatedCube.abc" )
+
+		t1 = a1.child( "pCube1" ).transformAtTime( 0.5 )
+		del a1
+
+		self.assertEqual( a2.child( "pCube1" ).transformAtTime( 0.5 ), t1 )
+
 if __name__ == "__main__":
     unittest.main()
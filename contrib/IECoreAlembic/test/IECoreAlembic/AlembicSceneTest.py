@@ -0,0 +1,121 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import os
+import unittest
+
+import IECore
+import IECoreAlembic
+
+class AlembicSceneTest( unittest.TestCase ) :
+
+	def testConstructor( self ) :
+
+		s = IECoreAlembic.AlembicScene( os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Read )
+		self.failUnless( isinstance( s, IECore.SceneInterface ) )
+
+		s = IECore.SceneInterface.create( os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Read )
+		self.failUnless( isinstance( s, IECoreAlembic.AlembicScene ) )
+
+		self.assertRaises( Exception, IECoreAlembic.AlembicScene, os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Write )
+		self.assertRaises( Exception, IECoreAlembic.AlembicScene, "iDontExist.abc", IECore.IndexedIO.OpenMode.Read )
+
+	def testHierarchy( self ) :
+
+		s = IECoreAlembic.AlembicScene( os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( s.name(), "/" )
+		self.assertEqual( s.childNames(), [ "group1" ] )
+		self.failIf( s.hasObject() )
+
+		g = s.child( "group1" )
+		self.assertEqual( g.name(), "group1" )
+		self.assertEqual( g.path(), [ "group1" ] )
+		self.assertEqual( g.childNames(), [ "pCube1" ] )
+		self.failIf( g.hasObject() )
+
+		# the shape is presented as the object on its parent transform
+		c = g.child( "pCube1" )
+		self.assertEqual( c.childNames(), [] )
+		self.failUnless( c.hasObject() )
+		self.failUnless( isinstance( c.readObject( 0 ), IECore.MeshPrimitive ) )
+
+		self.failUnless( s.hasChild( "group1" ) )
+		self.failIf( s.hasChild( "iDontExist" ) )
+		self.assertRaises( Exception, s.child, "iDontExist" )
+		self.assertEqual( s.child( "iDontExist", IECore.SceneInterface.MissingBehaviour.NullIfMissing ), None )
+
+		self.assertEqual( s.scene( [ "group1", "pCube1" ] ).path(), [ "group1", "pCube1" ] )
+		self.assertEqual( c.scene( [ "group1" ] ).childNames(), [ "pCube1" ] )
+
+	def testTransformAndBound( self ) :
+
+		s = IECoreAlembic.AlembicScene( os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( s.readTransformAsMatrix( 0 ), IECore.M44d() )
+		self.assertEqual( s.readBound( 0 ), IECore.Box3d( IECore.V3d( -2 ), IECore.V3d( 2 ) ) )
+
+		g = s.child( "group1" )
+		self.assertEqual( g.readTransformAsMatrix( 0 ), IECore.M44d.createScaled( IECore.V3d( 2 ) ) * IECore.M44d.createTranslated( IECore.V3d( 2, 0, 0 ) ) )
+
+		c = g.child( "pCube1" )
+		self.assertEqual( c.readTransformAsMatrix( 0 ), IECore.M44d.createTranslated( IECore.V3d( -1, 0, 0 ) ) )
+		self.assertEqual( c.readTransform( 0 ), IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( -1, 0, 0 ) ) ) )
+		self.assertEqual( c.readBound( 0 ), IECore.Box3d( IECore.V3d( -1 ), IECore.V3d( 1 ) ) )
+
+	def testReadOnly( self ) :
+
+		s = IECoreAlembic.AlembicScene( os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Read )
+		self.assertRaises( Exception, s.createChild, "a" )
+		self.assertRaises( Exception, s.writeTags, [ "a" ] )
+
+	def testHash( self ) :
+
+		s = IECoreAlembic.AlembicScene( os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Read )
+		c = s.scene( [ "group1", "pCube1" ] )
+
+		# nothing in the cube is animated
+		self.assertEqual( c.hash( IECore.SceneInterface.HashType.ObjectHash, 0 ), c.hash( IECore.SceneInterface.HashType.ObjectHash, 1 ) )
+		self.assertEqual( c.hash( IECore.SceneInterface.HashType.TransformHash, 0 ), c.hash( IECore.SceneInterface.HashType.TransformHash, 1 ) )
+
+		self.assertNotEqual( c.hash( IECore.SceneInterface.HashType.ObjectHash, 0 ), c.hash( IECore.SceneInterface.HashType.TransformHash, 0 ) )
+		self.assertNotEqual( c.hash( IECore.SceneInterface.HashType.ObjectHash, 0 ), s.hash( IECore.SceneInterface.HashType.ObjectHash, 0 ) )
+
+	def testReadObjects( self ) :
+
+		s = IECoreAlembic.AlembicScene( os.path.dirname( __file__ ) + "/data/cube.abc", IECore.IndexedIO.OpenMode.Read )
+		objects = s.readObjects( [ [ "group1", "pCube1" ], [ "group1" ] ], 0 )
+		self.assertEqual( objects[0], s.scene( [ "group1", "pCube1" ] ).readObject( 0 ) )
+		self.assertEqual( objects[1], None )
+
+if __name__ == "__main__":
+    unittest.main()
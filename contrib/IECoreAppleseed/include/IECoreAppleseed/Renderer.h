@@ -134,6 +134,12 @@ class Renderer : public IECore::Renderer
 		///
 		/// \li <b>"as:photon_target" BoolData</b><br>
 		/// Specifies that an object is an important target for photons.
+		///
+		/// \li <b>"as:procedural:reentrant" BoolData false</b><br>
+		/// When true, procedurals are expanded via IECore::ProceduralAlgo::render(), so
+		/// that the procedurals they emit are evaluated in parallel. Motion blocks and
+		/// other calls not supported by IECore::CapturingRenderer are not available to
+		/// such procedurals.
 		virtual void setAttribute( const std::string &name, IECore::ConstDataPtr value );
 		virtual IECore::ConstDataPtr getAttribute( const std::string &name ) const;
 
@@ -35,27 +35,41 @@
 #ifndef IECOREAPPLESEED_BATCHPRIMITIVECONVERTER_H
 #define IECOREAPPLESEED_BATCHPRIMITIVECONVERTER_H
 
+#include <set>
+
 #include "boost/filesystem/path.hpp"
 
+#include "tbb/task_group.h"
+
 #include "IECoreAppleseed/private/PrimitiveConverter.h"
 
 namespace IECoreAppleseed
 {
 
 /// A PrimitiveConverter subclass that writes primitives to geometry files.
+/// The conversion and writing of the files is performed in parallel in the
+/// background, and each unique primitive is written only once.
 class BatchPrimitiveConverter : public PrimitiveConverter
 {
 	public :
 
 		BatchPrimitiveConverter( const boost::filesystem::path &projectPath, const foundation::SearchPaths &searchPaths );
+		virtual ~BatchPrimitiveConverter();
 
 		virtual void setOption( const std::string &name, IECore::ConstDataPtr value );
 
+		virtual void waitForConversions();
+
 	private :
 
 		boost::filesystem::path m_projectPath;
 		std::string m_meshGeomExtension;
 
+		// The hashes of the meshes which have already been written
+		// or are being written by m_writeTasks.
+		std::set<IECore::MurmurHash> m_meshFiles;
+		tbb::task_group m_writeTasks;
+
 		virtual foundation::auto_release_ptr<renderer::Object> doConvertPrimitive( IECore::PrimitivePtr primitive,
 			const std::string &name );
 
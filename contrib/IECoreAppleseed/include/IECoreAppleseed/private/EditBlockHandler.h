@@ -52,7 +52,10 @@ namespace IECoreAppleseed
 
 /// The EditBlockHandler class manages an interactive appleseed
 /// rendering session, starting, stopping and pausing rendering
-/// when edits are being made.
+/// when edits are being made. Restarts are deferred for a short
+/// settling period, so that a rapid sequence of edits (such as those
+/// made while dragging a light or a camera) is coalesced into a single
+/// render restart, rather than one restart per edit.
 class EditBlockHandler : boost::noncopyable
 {
 
@@ -78,6 +81,7 @@ class EditBlockHandler : boost::noncopyable
 		boost::thread m_renderingThread;
 		int m_editDepth;
 		std::string m_exactScopeName;
+		bool m_rendering;
 
 		static void renderThreadFunc( EditBlockHandler *self );
 
@@ -73,6 +73,11 @@ class PrimitiveConverter : boost::noncopyable
 			const std::vector<IECore::PrimitivePtr> &primitives, const AttributeState &attrState,
 			const std::string &materialName, renderer::Assembly &parentAssembly );
 
+		/// Waits for any conversions which are being performed in the background
+		/// to complete. This must be called before the project is written or rendered.
+		/// The default implementation does nothing.
+		virtual void waitForConversions();
+
 	private :
 
 		virtual foundation::auto_release_ptr<renderer::Object> doConvertPrimitive( IECore::PrimitivePtr primitive,
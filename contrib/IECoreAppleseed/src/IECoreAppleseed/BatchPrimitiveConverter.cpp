@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/filesystem/convenience.hpp"
+#include "boost/format.hpp"
 #include "boost/lexical_cast.hpp"
 
 #include "foundation/math/scalar.h"
@@ -52,12 +53,62 @@ using namespace IECore;
 namespace asf = foundation;
 namespace asr = renderer;
 
+namespace
+{
+
+// Converts a primitive and writes it to a geometry file.
+// Used to write the files in parallel in the background.
+class MeshWriter
+{
+
+	public :
+
+		MeshWriter( ConstPrimitivePtr primitive, const string &name, const filesystem::path &path )
+			:	m_primitive( primitive ), m_name( name ), m_path( path )
+		{
+		}
+
+		void operator()() const
+		{
+			asf::auto_release_ptr<asr::MeshObject> entity( IECoreAppleseed::MeshAlgo::convert( m_primitive.get() ) );
+			if( entity.get() == 0 )
+			{
+				msg( Msg::Warning, "IECoreAppleseed::BatchPrimitiveConverter", format( "Couldn't convert primitive \"%s\"." ) % m_name );
+				return;
+			}
+
+			if( !asr::MeshObjectWriter::write( *entity, m_name.c_str(), m_path.string().c_str() ) )
+			{
+				msg( Msg::Warning, "IECoreAppleseed::BatchPrimitiveConverter", format( "Couldn't save mesh primitive \"%s\"." ) % m_name );
+			}
+		}
+
+	private :
+
+		ConstPrimitivePtr m_primitive;
+		string m_name;
+		filesystem::path m_path;
+
+};
+
+} // namespace
+
 IECoreAppleseed::BatchPrimitiveConverter::BatchPrimitiveConverter( const filesystem::path &projectPath, const asf::SearchPaths &searchPaths ) : PrimitiveConverter( searchPaths )
 {
 	m_projectPath = projectPath;
 	m_meshGeomExtension = ".binarymesh";
 }
 
+IECoreAppleseed::BatchPrimitiveConverter::~BatchPrimitiveConverter()
+{
+	waitForConversions();
+}
+
+void IECoreAppleseed::BatchPrimitiveConverter::waitForConversions()
+{
+	m_writeTasks.wait();
+}
+
 void IECoreAppleseed::BatchPrimitiveConverter::setOption( const string &name, ConstDataPtr value )
 {
 	if( name == "as:mesh_file_format" )
@@ -94,25 +145,17 @@ asf::auto_release_ptr<asr::Object> IECoreAppleseed::BatchPrimitiveConverter::doC
 
 	if( primitive->typeId() == MeshPrimitiveTypeId )
 	{
-		// Check if we already have a mesh saved for this object.
+		// Check if we already have a mesh saved, or being saved, for this object.
+		// If not, the mesh is converted and written in the background, and
+		// waitForConversions() must be called before the project is written.
 		string fileName = string( "_geometry/" ) + primitiveHash.toString() + m_meshGeomExtension;
-		filesystem::path p = m_projectPath / fileName;
 
-		if( !filesystem::exists( p ) )
+		if( m_meshFiles.insert( primitiveHash ).second )
 		{
-			asf::auto_release_ptr<asr::MeshObject> entity( MeshAlgo::convert( primitive.get() ) );
-			if( entity.get() == 0 )
-			{
-				msg( Msg::Warning, "IECoreAppleseed::BatchPrimitiveConverter", "Couldn't convert primitive." );
-				return asf::auto_release_ptr<asr::Object>();
-			}
-
-			// Write the mesh to a file.
-			p = m_projectPath / fileName;
-			if( !asr::MeshObjectWriter::write( *entity, name.c_str(), p.string().c_str() ) )
+			filesystem::path p = m_projectPath / fileName;
+			if( !filesystem::exists( p ) )
 			{
-				msg( Msg::Warning, "IECoreAppleseed::BatchPrimitiveConverter", "Couldn't save mesh primitive." );
-				return asf::auto_release_ptr<asr::Object>();
+				m_writeTasks.run( MeshWriter( primitive, name, p ) );
 			}
 		}
 
@@ -46,10 +46,22 @@ using namespace std;
 namespace asf = foundation;
 namespace asr = renderer;
 
+namespace
+{
+
+// The time we wait for further edits before restarting the render.
+// Starting a render is expensive and can't be aborted while the scene
+// is being prepared, so it is cheaper to wait for a few milliseconds
+// than to restart for every edit in an interactive session.
+const int g_settleMilliseconds = 30;
+
+} // namespace
+
 IECoreAppleseed::EditBlockHandler::EditBlockHandler( asr::Project &project )
 	: m_project( project )
 {
 	m_editDepth = 0;
+	m_rendering = false;
 	m_rendererController.reset( new RendererController() );
 }
 
@@ -60,6 +72,18 @@ IECoreAppleseed::EditBlockHandler::~EditBlockHandler()
 
 void IECoreAppleseed::EditBlockHandler::renderThreadFunc( EditBlockHandler *self )
 {
+	// Wait for further edits before starting. If one arrives, the render
+	// is aborted before it has started, and the next editEnd() will start
+	// a new one.
+	for( int i = 0; i < g_settleMilliseconds; ++i )
+	{
+		if( self->m_rendererController->get_status() == asr::IRendererController::AbortRendering )
+		{
+			return;
+		}
+		boost::this_thread::sleep( boost::posix_time::milliseconds( 1 ) );
+	}
+
 	try
 	{
 		self->m_renderer->render();
@@ -92,6 +116,7 @@ void IECoreAppleseed::EditBlockHandler::startRendering()
 
 		m_rendererController->set_status( asr::IRendererController::ContinueRendering );
 		m_renderingThread = boost::thread( &IECoreAppleseed::EditBlockHandler::renderThreadFunc, this );
+		m_rendering = true;
 	}
 }
 
@@ -102,8 +127,14 @@ void IECoreAppleseed::EditBlockHandler::pauseRendering()
 
 void IECoreAppleseed::EditBlockHandler::stopRendering()
 {
+	if( !m_rendering )
+	{
+		return;
+	}
+
 	m_rendererController->set_status( asr::IRendererController::AbortRendering );
 	m_renderingThread.join();
+	m_rendering = false;
 }
 
 bool IECoreAppleseed::EditBlockHandler::insideEditBlock() const
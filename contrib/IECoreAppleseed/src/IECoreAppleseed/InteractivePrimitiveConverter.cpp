@@ -95,7 +95,11 @@ asf::auto_release_ptr<asr::Object> IECoreAppleseed::InteractivePrimitiveConverte
 		for( size_t i = 1, e = primitives.size(); i < e; ++i )
 		{
 			const MeshPrimitive *m = static_cast<const MeshPrimitive*>( primitives[i].get() );
-			const V3fVectorData *p = m->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+			ConstV3fVectorDataPtr p;
+			if( m->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex ) )
+			{
+				p = runTimeCast<const V3fVectorData>( m->variables.find( "P" )->second.expandedData() );
+			}
 
 			if( !p )
 			{
@@ -118,7 +122,7 @@ asf::auto_release_ptr<asr::Object> IECoreAppleseed::InteractivePrimitiveConverte
 						throw Exception( "MeshPrimitive missing normals in motion sample." );
 					}
 
-					const V3fVectorData *n = runTimeCast<const V3fVectorData>( nIt->second.data.get() );
+					ConstV3fVectorDataPtr n = runTimeCast<const V3fVectorData>( nIt->second.expandedData() );
 					if( !n )
 					{
 						throw Exception( ( boost::format( "MeshPrimitive \"N\" primitive variable has unsupported type \"%s\" (expected V3fVectorData)." ) % nIt->second.data->typeName() ).str() );
@@ -146,7 +150,7 @@ asf::auto_release_ptr<asr::Object> IECoreAppleseed::InteractivePrimitiveConverte
 						throw Exception( "MeshPrimitive missing tangents in motion sample." );
 					}
 
-					const V3fVectorData *t = runTimeCast<const V3fVectorData>( tIt->second.data.get() );
+					ConstV3fVectorDataPtr t = runTimeCast<const V3fVectorData>( tIt->second.expandedData() );
 					if( !t )
 					{
 						throw Exception( ( boost::format( "MeshPrimitive \"uTangent\" primitive variable has unsupported type \"%s\" (expected V3fVectorData)." ) % tIt->second.data->typeName() ).str() );
@@ -54,10 +54,34 @@ namespace asr = renderer;
 namespace
 {
 
+// Returns the data for the named variable, expanded through its indices
+// if it has any, or NULL if it doesn't exist or isn't of type T.
+template<typename T>
+typename T::ConstPtr expandedVariableData( const Primitive *primitive, const std::string &name, PrimitiveVariable::Interpolation requiredInterpolation = PrimitiveVariable::Invalid )
+{
+	PrimitiveVariableMap::const_iterator it = primitive->variables.find( name );
+	if( it == primitive->variables.end() )
+	{
+		return NULL;
+	}
+
+	if( requiredInterpolation != PrimitiveVariable::Invalid && it->second.interpolation != requiredInterpolation )
+	{
+		return NULL;
+	}
+
+	if( !runTimeCast<const T>( it->second.data.get() ) )
+	{
+		return NULL;
+	}
+
+	return runTimeCast<const T>( it->second.expandedData() );
+}
+
 void setMeshKey( renderer::MeshObject *mesh, size_t keyIndex, const Object *object )
 {
 	const MeshPrimitive *m = static_cast<const MeshPrimitive*>( object );
-	const V3fVectorData *p = m->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+	ConstV3fVectorDataPtr p = expandedVariableData<V3fVectorData>( m, "P", PrimitiveVariable::Vertex );
 
 	if( !p )
 	{
@@ -78,7 +102,7 @@ void setMeshKey( renderer::MeshObject *mesh, size_t keyIndex, const Object *obje
 			throw Exception( "MeshPrimitive missing normals in motion sample." );
 		}
 
-		const V3fVectorData *n = runTimeCast<const V3fVectorData>( nIt->second.data.get() );
+		ConstV3fVectorDataPtr n = runTimeCast<const V3fVectorData>( nIt->second.expandedData() );
 		if( !n )
 		{
 			throw Exception( ( boost::format( "MeshPrimitive \"N\" primitive variable has unsupported type \"%s\" (expected V3fVectorData)." ) % nIt->second.data->typeName() ).str() );
@@ -106,7 +130,7 @@ void setMeshKey( renderer::MeshObject *mesh, size_t keyIndex, const Object *obje
 			throw Exception( "MeshPrimitive missing tangents in motion sample." );
 		}
 
-		const V3fVectorData *t = runTimeCast<const V3fVectorData>( tIt->second.data.get() );
+		ConstV3fVectorDataPtr t = runTimeCast<const V3fVectorData>( tIt->second.expandedData() );
 		if( !t )
 		{
 			throw Exception( ( boost::format( "MeshPrimitive \"uTangent\" primitive variable has unsupported type \"%s\" (expected V3fVectorData)." ) % tIt->second.data->typeName() ).str() );
@@ -144,7 +168,7 @@ renderer::MeshObject *convert( const IECore::Object *primitive )
 	assert( primitive->typeId() == IECore::MeshPrimitiveTypeId );
 	const IECore::MeshPrimitive *mesh = static_cast<const IECore::MeshPrimitive *>( primitive );
 
-	const V3fVectorData *p = mesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+	ConstV3fVectorDataPtr p = expandedVariableData<V3fVectorData>( mesh, "P", PrimitiveVariable::Vertex );
 	if( !p )
 	{
 		throw Exception( "MeshPrimitive does not have \"P\" primitive variable of interpolation type Vertex." );
@@ -186,16 +210,36 @@ renderer::MeshObject *convert( const IECore::Object *primitive )
 
 	// texture coords
 	{
-		const FloatVectorData *s = triangulatedMeshPrimPtr->variableData<FloatVectorData>( "s" );
-		const FloatVectorData *t = triangulatedMeshPrimPtr->variableData<FloatVectorData>( "t" );
+		ConstFloatVectorDataPtr s = triangulatedMeshPrimPtr->variableData<FloatVectorData>( "s" );
+		ConstFloatVectorDataPtr t = triangulatedMeshPrimPtr->variableData<FloatVectorData>( "t" );
 		if( s && t )
 		{
-			PrimitiveVariable::Interpolation sInterpolation = triangulatedMeshPrimPtr->variables.find( "s" )->second.interpolation;
-			PrimitiveVariable::Interpolation tInterpolation = triangulatedMeshPrimPtr->variables.find( "t" )->second.interpolation;
+			const PrimitiveVariable &sVariable = triangulatedMeshPrimPtr->variables.find( "s" )->second;
+			const PrimitiveVariable &tVariable = triangulatedMeshPrimPtr->variables.find( "t" )->second;
+			PrimitiveVariable::Interpolation sInterpolation = sVariable.interpolation;
+			PrimitiveVariable::Interpolation tInterpolation = tVariable.interpolation;
 			if( sInterpolation == tInterpolation )
 			{
 				if( sInterpolation == PrimitiveVariable::Varying || sInterpolation == PrimitiveVariable::Vertex || sInterpolation == PrimitiveVariable::FaceVarying )
 				{
+					// Triangles carry their own texture coordinate indices, so
+					// FaceVarying s and t sharing the same indices can be passed
+					// through unexpanded. Anything else is expanded.
+					const IntVectorData *stIndices = NULL;
+					if(
+						sInterpolation == PrimitiveVariable::FaceVarying &&
+						sVariable.indices && tVariable.indices && *sVariable.indices == *tVariable.indices &&
+						s->readable().size() == t->readable().size()
+					)
+					{
+						stIndices = sVariable.indices.get();
+					}
+					else
+					{
+						s = runTimeCast<const FloatVectorData>( sVariable.expandedData() );
+						t = runTimeCast<const FloatVectorData>( tVariable.expandedData() );
+					}
+
 					size_t numSTs = s->readable().size();
 					meshEntity->reserve_tex_coords( numSTs );
 					const std::vector<float> &svec = s->readable();
@@ -206,7 +250,18 @@ renderer::MeshObject *convert( const IECore::Object *primitive )
 						meshEntity->push_tex_coords( asr::GVector2( svec[i], 1.0f - tvec[i] ) );
 					}
 
-					if( sInterpolation == PrimitiveVariable::FaceVarying )
+					if( stIndices )
+					{
+						const std::vector<int> &stIds = stIndices->readable();
+						for( size_t i = 0, j = 0; i < numTriangles; ++i)
+						{
+							asr::Triangle& tri = triangles[i];
+							tri.m_a0 = stIds[j++];
+							tri.m_a1 = stIds[j++];
+							tri.m_a2 = stIds[j++];
+						}
+					}
+					else if( sInterpolation == PrimitiveVariable::FaceVarying )
 					{
 						for( size_t i = 0, j = 0; i < numTriangles; ++i)
 						{
@@ -248,7 +303,7 @@ renderer::MeshObject *convert( const IECore::Object *primitive )
 		PrimitiveVariableMap::const_iterator nIt = triangulatedMeshPrimPtr->variables.find( "N" );
 		if( nIt != triangulatedMeshPrimPtr->variables.end() )
 		{
-			const V3fVectorData *n = runTimeCast<const V3fVectorData>( nIt->second.data.get() );
+			ConstV3fVectorDataPtr n = runTimeCast<const V3fVectorData>( nIt->second.expandedData() );
 			if( n )
 			{
 				PrimitiveVariable::Interpolation nInterpolation = nIt->second.interpolation;
@@ -301,7 +356,7 @@ renderer::MeshObject *convert( const IECore::Object *primitive )
 		PrimitiveVariableMap::const_iterator tIt = triangulatedMeshPrimPtr->variables.find( "uTangent" );
 		if( tIt != triangulatedMeshPrimPtr->variables.end() )
 		{
-			const V3fVectorData *t = runTimeCast<const V3fVectorData>( tIt->second.data.get() );
+			ConstV3fVectorDataPtr t = runTimeCast<const V3fVectorData>( tIt->second.expandedData() );
 			if( t )
 			{
 				PrimitiveVariable::Interpolation tInterpolation = tIt->second.interpolation;
@@ -222,6 +222,10 @@ const asr::Assembly *IECoreAppleseed::PrimitiveConverter::convertPrimitive( cons
 	return addObjectToScene( obj, primitiveHash, attrState, materialName, parentAssembly );
 }
 
+void IECoreAppleseed::PrimitiveConverter::waitForConversions()
+{
+}
+
 const asr::Assembly *IECoreAppleseed::PrimitiveConverter::addObjectToScene( asf::auto_release_ptr<asr::Object> &obj,
 	const MurmurHash &primitiveHash, const AttributeState &attrState,
 	const string &materialName, asr::Assembly &parentAssembly )
@@ -57,6 +57,7 @@
 
 #include "IECore/MessageHandler.h"
 #include "IECore/MeshPrimitive.h"
+#include "IECore/ProceduralAlgo.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/Transform.h"
 
@@ -495,6 +496,9 @@ void IECoreAppleseed::RendererImplementation::worldEnd()
 	asf::auto_release_ptr<asr::AssemblyInstance> assemblyInstance = asr::AssemblyInstanceFactory::create( "assembly_inst", asr::ParamArray(), "assembly" );
 	m_project->get_scene()->assembly_instances().insert( assemblyInstance );
 
+	// make sure that all the geometry files have been written
+	m_primitiveConverter->waitForConversions();
+
 	// render or export the project
 	if( isEditable() )
 	{
@@ -822,7 +826,17 @@ void IECoreAppleseed::RendererImplementation::geometry( const string &type, cons
 void IECoreAppleseed::RendererImplementation::procedural( Renderer::ProceduralPtr proc )
 {
 	// appleseed does not support procedurals yet, so we expand them immediately.
-	proc->render( this );
+	// reentrant procedurals are captured first so that any procedurals they emit in
+	// turn may be expanded in parallel, and the result is then output from this thread.
+	ConstBoolDataPtr reentrant = runTimeCast<const BoolData>( getAttribute( "as:procedural:reentrant" ) );
+	if( reentrant && reentrant->readable() )
+	{
+		ProceduralAlgo::render( proc, this );
+	}
+	else
+	{
+		proc->render( this );
+	}
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////
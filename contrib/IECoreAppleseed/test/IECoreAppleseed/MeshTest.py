@@ -63,5 +63,29 @@ class MeshTest( AppleseedTest.TestCase ):
 			self.assertEqual( uv[0], s[j] )
 			self.assertEqual( uv[1], 1.0 - t[j] )
 
+	def testIndexedUVs( self ) :
+
+		r = IECoreAppleseed.Renderer()
+		r.worldBegin()
+		r.setAttribute( "name", IECore.StringData( "plane" ) )
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -6 ), IECore.V2f( 6 ) ) )
+		indices = IECore.IntVectorData( [ 0, 1, 1, 0 ] )
+		m["s"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ 0, 1 ] ), indices )
+		m["t"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ 0, 0.5 ] ), indices )
+		m.render( r )
+
+		mainAss = self._getMainAssembly( r )
+		objAss = mainAss.assemblies().get_by_name( "plane_assembly" )
+		obj = objAss.objects().get_by_name( "plane" )
+		self.assertEqual( obj.get_tex_coords_count(), 2 )
+
+		uv = obj.get_tex_coords( 0 )
+		self.assertEqual( uv[0], 0 )
+		self.assertEqual( uv[1], 1 )
+
+		uv = obj.get_tex_coords( 1 )
+		self.assertEqual( uv[0], 1 )
+		self.assertEqual( uv[1], 0.5 )
+
 if __name__ == "__main__":
 	unittest.main()
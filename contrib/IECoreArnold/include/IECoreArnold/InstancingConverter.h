@@ -38,6 +38,7 @@
 #include "ai.h"
 
 #include "IECore/Primitive.h"
+#include "IECore/CompoundData.h"
 
 #include "IECoreArnold/Export.h"
 
@@ -75,8 +76,40 @@ class IECOREARNOLD_API InstancingConverter : public IECore::RefCounted
 		AtNode *convert( const std::vector<const IECore::Primitive *> &samples, const std::vector<float> &sampleTimes );
 		AtNode *convert( const std::vector<const IECore::Primitive *> &samples, const std::vector<float> &sampleTimes, const IECore::MurmurHash &additionalHash );
 
+		/// Returns a converter shared by everything rendering into the current
+		/// Arnold universe, so that instancing works across procedurals. A new
+		/// converter is returned once the universe has been restarted.
+		static Ptr universeConverter();
+		/// Discards the converter returned by universeConverter(). This is
+		/// called automatically by writable UniverseBlocks as they end the
+		/// universe, so should rarely need to be called directly.
+		static void resetUniverseConverter();
+
+		/// Primitives are held by the converter so that hash collisions can be
+		/// detected by comparing them for equality. Once their total memory
+		/// usage exceeds this limit, new primitives are converted without being
+		/// cached. Defaults to the value of the IECOREARNOLD_INSTANCINGCONVERTER_MEMORY
+		/// environment variable, in megabytes, or 1024 megabytes if that is not set.
+		void setMaxMemory( size_t bytes );
+		size_t getMaxMemory() const;
+
+		/// When on, constant primitive variables on MeshPrimitives are excluded
+		/// from the instancing hash, and are instead applied to each ginstance
+		/// as user parameters. This allows meshes which differ only in their
+		/// constant primitive variables to be instanced. Defaults to off.
+		void setConstantPrimitiveVariablesOnInstances( bool on );
+		bool getConstantPrimitiveVariablesOnInstances() const;
+
+		/// Returns statistics about the conversions made so far, comprising
+		/// "hits" (ginstances created), "misses" (primitives converted and cached),
+		/// "uncached" (primitives converted after exceeding the memory limit),
+		/// "collisions" (hashes matching unequal primitives) and "memoryUsage".
+		IECore::CompoundDataPtr statistics() const;
+
 	private :
 
+		AtNode *convertInternal( const std::vector<const IECore::Primitive *> &samples, const std::vector<float> *sampleTimes, const IECore::MurmurHash &additionalHash );
+
 		struct MemberData;
 		MemberData *m_data;
 
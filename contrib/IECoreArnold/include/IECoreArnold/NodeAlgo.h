@@ -54,6 +54,11 @@ AtNode *convert( const IECore::Object *object );
 /// is available, then returns a standard conversion of the
 /// first sample.
 AtNode *convert( const std::vector<const IECore::Object *> &samples, const std::vector<float> &sampleTimes );
+/// Converts a batch of independent IECore::Objects concurrently,
+/// filling nodes with the result of convert() for each in turn.
+/// Prefer this to repeated calls to convert() when many objects
+/// are available up front.
+void convertBatch( const std::vector<const IECore::Object *> &objects, std::vector<AtNode *> &nodes );
 
 /// Signature of a function which can convert an IECore::Object
 /// into an Arnold object.
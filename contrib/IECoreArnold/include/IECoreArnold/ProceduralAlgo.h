@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECOREARNOLD_PROCEDURALALGO_H
+#define IECOREARNOLD_PROCEDURALALGO_H
+
+#include <string>
+#include <vector>
+
+#include "IECore/Renderer.h"
+
+#include "IECoreArnold/Export.h"
+
+namespace IECoreArnold
+{
+
+/// Provides a registry of procedurals implemented purely in C++, which
+/// the ieProcedural Arnold DSO checks before loading a Python
+/// ParameterisedProcedural via the ClassLoader. Registered procedurals
+/// never touch the Python GIL, so Arnold is free to expand many of them
+/// in parallel. The following are registered by default :
+///
+/// "SceneCache" renders a location from an IECore::SceneInterface file,
+/// expanding each child location as a separate procedural. It accepts
+/// "-fileName", "-path" and "-time" arguments, with the path defaulting
+/// to the root and the time defaulting to 0. The transform of the location
+/// at the path itself is not applied.
+namespace ProceduralAlgo
+{
+
+/// Signature of a function which creates a procedural from the
+/// arguments in the "parameterValues" array of an ieProcedural node.
+/// Arguments come in the same "-name value" pairs used by IECore.ParameterParser
+/// for Python procedurals. Creators should throw a descriptive exception if the
+/// arguments are invalid.
+typedef IECore::Renderer::ProceduralPtr (*Creator)( const std::vector<std::string> &arguments );
+
+/// Registers a procedural under the specified class name.
+IECOREARNOLD_API void registerProcedural( const std::string &className, Creator creator );
+
+/// Creates the procedural registered under the specified class name, returning
+/// NULL if there is none. May be called concurrently from multiple threads.
+IECOREARNOLD_API IECore::Renderer::ProceduralPtr create( const std::string &className, const std::vector<std::string> &arguments );
+
+/// Class which registers a procedural automatically when instantiated.
+class ProceduralDescription
+{
+
+	public :
+
+		ProceduralDescription( const std::string &className, Creator creator )
+		{
+			registerProcedural( className, creator );
+		}
+
+};
+
+} // namespace ProceduralAlgo
+
+} // namespace IECoreArnold
+
+#endif // IECOREARNOLD_PROCEDURALALGO_H
@@ -45,12 +45,19 @@ namespace IECoreArnold
 namespace ShapeAlgo
 {
 
+/// Returns the data for the named primitive variable, with any indices expanded so that
+/// there is one value per element. Returns NULL if the variable doesn't exist or doesn't
+/// have the required interpolation.
+IECore::ConstDataPtr expandedVariableData( const IECore::Primitive *primitive, const std::string &name, IECore::PrimitiveVariable::Interpolation requiredInterpolation = IECore::PrimitiveVariable::Invalid );
+
 void convertP( const IECore::Primitive *primitive, AtNode *shape, const char *name );
 void convertP( const std::vector<const IECore::Primitive *> &samples, AtNode *shape, const char *name );
 
 void convertRadius( const IECore::Primitive *primitive, AtNode *shape );
 void convertRadius( const std::vector<const IECore::Primitive *> &samples, AtNode *shape );
 
+/// Indexed FaceVarying variables on meshes are output with their indices as the corresponding
+/// "idxs" array. Indices on all other variables are expanded.
 void convertPrimitiveVariable( const IECore::Primitive *primitive, const IECore::PrimitiveVariable &primitiveVariable, AtNode *shape, const char *name );
 /// Converts primitive variables from primitive into user parameters on shape, ignoring any variables
 /// whose names are present in the ignore array.
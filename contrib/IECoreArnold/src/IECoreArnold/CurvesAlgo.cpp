@@ -62,11 +62,10 @@ AtNode *convertCommon( const IECore::CurvesPrimitive *curves )
 
 	AtNode *result = AiNode( "curves" );
 
-	const std::vector<int> verticesPerCurve = curves->verticesPerCurve()->readable();
 	AiNodeSetArray(
 		result,
 		"num_points",
-		AiArrayConvert( verticesPerCurve.size(), 1, AI_TYPE_INT, (void *)&( verticesPerCurve[0] ) )
+		ParameterAlgo::dataToArray( curves->verticesPerCurve(), AI_TYPE_INT )
 	);
 
 	// set basis
@@ -111,13 +110,13 @@ AtNode *CurvesAlgo::convert( const IECore::CurvesPrimitive *curves )
 
 	// Convert "N" to orientations
 
-	if( const V3fVectorData *n = curves->variableData<V3fVectorData>( "N", PrimitiveVariable::Vertex ) )
+	if( ConstV3fVectorDataPtr n = runTimeCast<const V3fVectorData>( ShapeAlgo::expandedVariableData( curves, "N", PrimitiveVariable::Vertex ) ) )
 	{
 		AiNodeSetStr( result, "mode", "oriented" );
 		AiNodeSetArray(
 			result,
 			"orientations",
-			AiArrayConvert( n->readable().size(), 1, AI_TYPE_VECTOR, (void *)&( n->readable()[0] ) )
+			ParameterAlgo::dataToArray( n.get(), AI_TYPE_VECTOR )
 		);
 	}
 
@@ -134,13 +133,16 @@ AtNode *CurvesAlgo::convert( const std::vector<const IECore::CurvesPrimitive *>
 
 	// Convert "N" to orientations
 
-	vector<const Data *> nSamples;
+	vector<ConstDataPtr> nSamplesOwner; // for ownership
+	vector<const Data *> nSamples; // for passing to dataToArray()
+	nSamplesOwner.reserve( samples.size() );
 	nSamples.reserve( samples.size() );
 	for( vector<const CurvesPrimitive *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
 	{
-		if( const V3fVectorData *n = (*it)->variableData<V3fVectorData>( "N", PrimitiveVariable::Vertex ) )
+		if( ConstV3fVectorDataPtr n = runTimeCast<const V3fVectorData>( ShapeAlgo::expandedVariableData( *it, "N", PrimitiveVariable::Vertex ) ) )
 		{
-			nSamples.push_back( n );
+			nSamplesOwner.push_back( n );
+			nSamples.push_back( n.get() );
 		}
 	}
 
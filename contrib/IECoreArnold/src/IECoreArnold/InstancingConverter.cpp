@@ -37,16 +37,141 @@
 #include "ai.h"
 
 #include "tbb/concurrent_hash_map.h"
+#include "tbb/atomic.h"
+#include "tbb/mutex.h"
+
+#include <cstdlib>
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "IECore/MeshPrimitive.h"
+#include "IECore/SimpleTypedData.h"
 
 #include "IECoreArnold/InstancingConverter.h"
 #include "IECoreArnold/NodeAlgo.h"
+#include "IECoreArnold/ShapeAlgo.h"
 
+using namespace IECore;
 using namespace IECoreArnold;
 
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+size_t defaultMaxMemory()
+{
+	const char *m = getenv( "IECOREARNOLD_INSTANCINGCONVERTER_MEMORY" );
+	return size_t( m ? boost::lexical_cast<size_t>( m ) : 1024 ) * 1024 * 1024;
+}
+
+bool isUVVariable( const std::string &name )
+{
+	return
+		name == "s" || name == "t" ||
+		boost::ends_with( name, "_s" ) || boost::ends_with( name, "_t" ) ||
+		boost::ends_with( name, "Indices" )
+	;
+}
+
+bool hasInstanceableConstants( const Primitive *primitive )
+{
+	if( !runTimeCast<const MeshPrimitive>( primitive ) )
+	{
+		return false;
+	}
+	for( PrimitiveVariableMap::const_iterator it = primitive->variables.begin(), eIt = primitive->variables.end(); it != eIt; ++it )
+	{
+		if( it->second.interpolation == PrimitiveVariable::Constant && !isUVVariable( it->first ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Returns a copy of the primitive without the constant primitive variables
+// that are to be applied to instances. The copy is cheap because
+// Cortex data is shared until written to.
+ConstPrimitivePtr removeConstants( const Primitive *primitive )
+{
+	PrimitivePtr result = primitive->copy();
+	for( PrimitiveVariableMap::iterator it = result->variables.begin(); it != result->variables.end(); )
+	{
+		if( it->second.interpolation == PrimitiveVariable::Constant && !isUVVariable( it->first ) )
+		{
+			result->variables.erase( it++ );
+		}
+		else
+		{
+			++it;
+		}
+	}
+	return result;
+}
+
+void applyConstants( const Primitive *primitive, AtNode *node )
+{
+	for( PrimitiveVariableMap::const_iterator it = primitive->variables.begin(), eIt = primitive->variables.end(); it != eIt; ++it )
+	{
+		if( it->second.interpolation == PrimitiveVariable::Constant && !isUVVariable( it->first ) )
+		{
+			ShapeAlgo::convertPrimitiveVariable( primitive, it->second, node, it->first.c_str() );
+		}
+	}
+}
+
+tbb::mutex g_universeMutex;
+InstancingConverterPtr g_universeConverter;
+const AtNode *g_universeOptions = NULL;
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// InstancingConverter
+//////////////////////////////////////////////////////////////////////////
+
 struct InstancingConverter::MemberData
 {
-	typedef tbb::concurrent_hash_map<IECore::MurmurHash, AtNode *> Cache;
+
+	MemberData()
+		:	maxMemory( defaultMaxMemory() ), constantPrimitiveVariablesOnInstances( false )
+	{
+		hits = 0;
+		misses = 0;
+		uncached = 0;
+		collisions = 0;
+		memoryUsage = 0;
+	}
+
+	struct CacheEntry
+	{
+		CacheEntry()
+			:	node( NULL )
+		{
+		}
+
+		AtNode *node;
+		// Held for comparison when the hashes match,
+		// to protect against hash collisions.
+		std::vector<ConstPrimitivePtr> samples;
+	};
+
+	typedef tbb::concurrent_hash_map<IECore::MurmurHash, CacheEntry> Cache;
 	Cache cache;
+
+	size_t maxMemory;
+	bool constantPrimitiveVariablesOnInstances;
+
+	tbb::atomic<size_t> hits;
+	tbb::atomic<size_t> misses;
+	tbb::atomic<size_t> uncached;
+	tbb::atomic<size_t> collisions;
+	tbb::atomic<size_t> memoryUsage;
+
 };
 
 InstancingConverter::InstancingConverter()
@@ -66,26 +191,8 @@ AtNode *InstancingConverter::convert( const IECore::Primitive *primitive )
 
 AtNode *InstancingConverter::convert( const IECore::Primitive *primitive, const IECore::MurmurHash &additionalHash )
 {
-	IECore::MurmurHash h = primitive->::IECore::Object::hash();
-	h.append( additionalHash );
-
-	MemberData::Cache::accessor a;
-	if( m_data->cache.insert( a, h ) )
-	{
-		a->second = NodeAlgo::convert( primitive );
-		return a->second;
-	}
-	else
-	{
-		if( a->second )
-		{
-			AtNode *instance = AiNode( "ginstance" );
-			AiNodeSetPtr( instance, "node", a->second );
-			return instance;
-		}
-	}
-
-	return NULL;
+	std::vector<const IECore::Primitive *> samples( 1, primitive );
+	return convertInternal( samples, NULL, additionalHash );
 }
 
 AtNode *InstancingConverter::convert( const std::vector<const IECore::Primitive *> &samples, const std::vector<float> &sampleTimes )
@@ -95,29 +202,178 @@ AtNode *InstancingConverter::convert( const std::vector<const IECore::Primitive
 
 AtNode *InstancingConverter::convert( const std::vector<const IECore::Primitive *> &samples, const std::vector<float> &sampleTimes, const IECore::MurmurHash &additionalHash )
 {
+	return convertInternal( samples, &sampleTimes, additionalHash );
+}
+
+AtNode *InstancingConverter::convertInternal( const std::vector<const IECore::Primitive *> &samples, const std::vector<float> *sampleTimes, const IECore::MurmurHash &additionalHash )
+{
+	// Strip any constant primitive variables destined for instances,
+	// so they don't contribute to the hash or the converted node.
+
+	const Primitive *constantsSource = NULL;
+	std::vector<ConstPrimitivePtr> strippedSamples;
+	std::vector<const Primitive *> convertSamples = samples;
+	if( m_data->constantPrimitiveVariablesOnInstances && hasInstanceableConstants( samples.front() ) )
+	{
+		constantsSource = samples.front();
+		for( std::vector<const Primitive *>::iterator it = convertSamples.begin(), eIt = convertSamples.end(); it != eIt; ++it )
+		{
+			strippedSamples.push_back( removeConstants( *it ) );
+			*it = strippedSamples.back().get();
+		}
+	}
+
 	IECore::MurmurHash h;
-	for( std::vector<const IECore::Primitive *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
+	if( !sampleTimes )
 	{
-		(*it)->hash( h );
+		h = convertSamples.front()->::IECore::Object::hash();
+	}
+	else
+	{
+		for( std::vector<const IECore::Primitive *>::const_iterator it = convertSamples.begin(), eIt = convertSamples.end(); it != eIt; ++it )
+		{
+			(*it)->hash( h );
+		}
+		if( sampleTimes->size() )
+		{
+			h.append( &sampleTimes->front(), sampleTimes->size() );
+		}
 	}
 	h.append( additionalHash );
 
-	MemberData::Cache::accessor a;
-	if( m_data->cache.insert( a, h ) )
+	AtNode *result = NULL;
+	bool collision = false;
 	{
-		std::vector<const IECore::Object *> objectSamples( samples.begin(), samples.end() );
-		a->second = NodeAlgo::convert( objectSamples, sampleTimes );
-		return a->second;
+		MemberData::Cache::accessor a;
+		if( m_data->cache.insert( a, h ) )
+		{
+			if( sampleTimes )
+			{
+				std::vector<const IECore::Object *> objectSamples( convertSamples.begin(), convertSamples.end() );
+				a->second.node = NodeAlgo::convert( objectSamples, *sampleTimes );
+			}
+			else
+			{
+				a->second.node = NodeAlgo::convert( convertSamples.front() );
+			}
+			result = a->second.node;
+
+			size_t memory = 0;
+			for( std::vector<const Primitive *>::const_iterator it = convertSamples.begin(), eIt = convertSamples.end(); it != eIt; ++it )
+			{
+				memory += (*it)->memoryUsage();
+			}
+
+			if( m_data->memoryUsage + memory > m_data->maxMemory )
+			{
+				m_data->cache.erase( a );
+				m_data->uncached++;
+			}
+			else
+			{
+				for( std::vector<const Primitive *>::const_iterator it = convertSamples.begin(), eIt = convertSamples.end(); it != eIt; ++it )
+				{
+					a->second.samples.push_back( *it );
+				}
+				m_data->memoryUsage += memory;
+				m_data->misses++;
+			}
+		}
+		else
+		{
+			if( !a->second.node )
+			{
+				return NULL;
+			}
+
+			bool equal = a->second.samples.size() == convertSamples.size();
+			for( size_t i = 0; equal && i < convertSamples.size(); ++i )
+			{
+				equal = a->second.samples[i]->isEqualTo( convertSamples[i] );
+			}
+
+			if( equal )
+			{
+				result = AiNode( "ginstance" );
+				AiNodeSetPtr( result, "node", a->second.node );
+				m_data->hits++;
+			}
+			else
+			{
+				m_data->collisions++;
+				collision = true;
+			}
+		}
 	}
-	else
+
+	if( collision )
 	{
-		if( a->second )
+		// Hash collision - convert without touching the cache.
+		if( sampleTimes )
+		{
+			std::vector<const IECore::Object *> objectSamples( convertSamples.begin(), convertSamples.end() );
+			result = NodeAlgo::convert( objectSamples, *sampleTimes );
+		}
+		else
 		{
-			AtNode *instance = AiNode( "ginstance" );
-			AiNodeSetPtr( instance, "node", a->second );
-			return instance;
+			result = NodeAlgo::convert( convertSamples.front() );
 		}
 	}
 
-	return NULL;
+	if( result && constantsSource )
+	{
+		applyConstants( constantsSource, result );
+	}
+
+	return result;
+}
+
+InstancingConverterPtr InstancingConverter::universeConverter()
+{
+	tbb::mutex::scoped_lock lock( g_universeMutex );
+	const AtNode *options = AiUniverseGetOptions();
+	if( !g_universeConverter || options != g_universeOptions )
+	{
+		g_universeConverter = new InstancingConverter;
+		g_universeOptions = options;
+	}
+	return g_universeConverter;
+}
+
+void InstancingConverter::resetUniverseConverter()
+{
+	tbb::mutex::scoped_lock lock( g_universeMutex );
+	g_universeConverter = NULL;
+	g_universeOptions = NULL;
+}
+
+void InstancingConverter::setMaxMemory( size_t bytes )
+{
+	m_data->maxMemory = bytes;
+}
+
+size_t InstancingConverter::getMaxMemory() const
+{
+	return m_data->maxMemory;
+}
+
+void InstancingConverter::setConstantPrimitiveVariablesOnInstances( bool on )
+{
+	m_data->constantPrimitiveVariablesOnInstances = on;
+}
+
+bool InstancingConverter::getConstantPrimitiveVariablesOnInstances() const
+{
+	return m_data->constantPrimitiveVariablesOnInstances;
+}
+
+IECore::CompoundDataPtr InstancingConverter::statistics() const
+{
+	CompoundDataPtr result = new CompoundData;
+	result->writable()["hits"] = new UInt64Data( m_data->hits );
+	result->writable()["misses"] = new UInt64Data( m_data->misses );
+	result->writable()["uncached"] = new UInt64Data( m_data->uncached );
+	result->writable()["collisions"] = new UInt64Data( m_data->collisions );
+	result->writable()["memoryUsage"] = new UInt64Data( m_data->memoryUsage );
+	return result;
 }
@@ -69,8 +69,20 @@ AtArray *identityIndices( size_t size )
 	return result;
 }
 
+AtArray *indicesArray( const IntVectorData *indices )
+{
+	const vector<int> &readable = indices->readable();
+	AtArray *result = AiArrayAllocate( readable.size(), 1, AI_TYPE_UINT );
+	for( size_t i=0; i < readable.size(); ++i )
+	{
+		AiArraySetUInt( result, i, readable[i] );
+	}
+	return result;
+}
+
+// Returns the data for a variable with any indices expanded.
 template<typename T>
-const T *variableData( const PrimitiveVariableMap &variables, const std::string &name, PrimitiveVariable::Interpolation interpolation = PrimitiveVariable::Invalid )
+typename T::ConstPtr variableData( const PrimitiveVariableMap &variables, const std::string &name, PrimitiveVariable::Interpolation interpolation = PrimitiveVariable::Invalid )
 {
 	PrimitiveVariableMap::const_iterator it = variables.find( name );
 	if( it==variables.end() )
@@ -81,7 +93,11 @@ const T *variableData( const PrimitiveVariableMap &variables, const std::string
 	{
 		return NULL;
 	}
-	return runTimeCast<T>( it->second.data.get() );
+	if( !runTimeCast<const T>( it->second.data.get() ) )
+	{
+		return NULL;
+	}
+	return runTimeCast<const T>( it->second.expandedData() );
 }
 
 // Cortex represents UV sets horribly, with the u and v stored as separate primitive variables.
@@ -112,9 +128,9 @@ void convertIndexedUVSet( const std::string &setName, PrimitiveVariableMap &vari
 	const std::string tName = setName == "" ? "t" : setName + "_t";
 	const std::string indicesName = setName == "" ? "stIndices" : setName + "Indices";
 
-	const FloatVectorData *sData = variableData<FloatVectorData>( variables, sName, PrimitiveVariable::FaceVarying );
-	const FloatVectorData *tData = variableData<FloatVectorData>( variables, tName, PrimitiveVariable::FaceVarying );
-	const IntVectorData *indicesData = variableData<IntVectorData>( variables, indicesName, PrimitiveVariable::FaceVarying );
+	ConstFloatVectorDataPtr sData = variableData<FloatVectorData>( variables, sName, PrimitiveVariable::FaceVarying );
+	ConstFloatVectorDataPtr tData = variableData<FloatVectorData>( variables, tName, PrimitiveVariable::FaceVarying );
+	ConstIntVectorDataPtr indicesData = variableData<IntVectorData>( variables, indicesName, PrimitiveVariable::FaceVarying );
 
 	if( !( sData && tData && indicesData ) )
 	{
@@ -153,22 +169,29 @@ void convertIndexedUVSet( const std::string &setName, PrimitiveVariableMap &vari
 	variables.erase( indicesName );
 }
 
-// Version of the above for when we have no indices available.
+// Version of the above for when we have no "Indices" variable. FaceVarying variables
+// sharing the same PrimitiveVariable::indices are output directly as Arnold's indices.
 void convertUVSet( const std::string &setName, PrimitiveVariableMap &variables, const vector<int> &vertexIds, AtNode *node )
 {
 	const std::string sName = setName == "" ? "s" : setName + "_s";
 	const std::string tName = setName == "" ? "t" : setName + "_t";
 
-	const FloatVectorData *sData = variableData<FloatVectorData>( variables, sName );
-	const FloatVectorData *tData = variableData<FloatVectorData>( variables, tName );
+	PrimitiveVariableMap::const_iterator sIt = variables.find( sName );
+	PrimitiveVariableMap::const_iterator tIt = variables.find( tName );
+	if( sIt == variables.end() || tIt == variables.end() )
+	{
+		return;
+	}
 
-	if( !( sData && tData ) )
+	const PrimitiveVariable &sVariable = sIt->second;
+	const PrimitiveVariable &tVariable = tIt->second;
+	if( !runTimeCast<const FloatVectorData>( sVariable.data.get() ) || !runTimeCast<const FloatVectorData>( tVariable.data.get() ) )
 	{
 		return;
 	}
 
-	PrimitiveVariable::Interpolation sInterpolation = variables.find( "s" )->second.interpolation;
-	PrimitiveVariable::Interpolation tInterpolation = variables.find( "t" )->second.interpolation;
+	PrimitiveVariable::Interpolation sInterpolation = sVariable.interpolation;
+	PrimitiveVariable::Interpolation tInterpolation = tVariable.interpolation;
 	if( sInterpolation != tInterpolation )
 	{
 		msg(
@@ -187,6 +210,25 @@ void convertUVSet( const std::string &setName, PrimitiveVariableMap &variables,
 		return;
 	}
 
+	ConstFloatVectorDataPtr sData;
+	ConstFloatVectorDataPtr tData;
+	const IntVectorData *uvIndices = NULL;
+	if(
+		sInterpolation == PrimitiveVariable::FaceVarying &&
+		sVariable.indices && tVariable.indices && *sVariable.indices == *tVariable.indices &&
+		static_cast<const FloatVectorData *>( sVariable.data.get() )->readable().size() == static_cast<const FloatVectorData *>( tVariable.data.get() )->readable().size()
+	)
+	{
+		sData = static_cast<const FloatVectorData *>( sVariable.data.get() );
+		tData = static_cast<const FloatVectorData *>( tVariable.data.get() );
+		uvIndices = sVariable.indices.get();
+	}
+	else
+	{
+		sData = runTimeCast<const FloatVectorData>( sVariable.expandedData() );
+		tData = runTimeCast<const FloatVectorData>( tVariable.expandedData() );
+	}
+
 	const vector<float> &s = sData->readable();
 	const vector<float> &t = tData->readable();
 
@@ -197,30 +239,34 @@ void convertUVSet( const std::string &setName, PrimitiveVariableMap &variables,
 		AiArraySetPnt2( uvsArray, i, uv );
 	}
 
-	AtArray *indicesArray = NULL;
-	if( sInterpolation == PrimitiveVariable::FaceVarying )
+	AtArray *uvIndicesArray = NULL;
+	if( uvIndices )
+	{
+		uvIndicesArray = indicesArray( uvIndices );
+	}
+	else if( sInterpolation == PrimitiveVariable::FaceVarying )
 	{
-		indicesArray = identityIndices( vertexIds.size() );
+		uvIndicesArray = identityIndices( vertexIds.size() );
 	}
 	else
 	{
-		indicesArray = AiArrayAllocate( vertexIds.size(), 1, AI_TYPE_UINT );
+		uvIndicesArray = AiArrayAllocate( vertexIds.size(), 1, AI_TYPE_UINT );
 		for( size_t i = 0, e = vertexIds.size(); i < e; ++i )
 		{
-			AiArraySetUInt( indicesArray, i, vertexIds[i] );
+			AiArraySetUInt( uvIndicesArray, i, vertexIds[i] );
 		}
 	}
 
 	if( setName == "" )
 	{
 		AiNodeSetArray( node, "uvlist", uvsArray );
-		AiNodeSetArray( node, "uvidxs", indicesArray );
+		AiNodeSetArray( node, "uvidxs", uvIndicesArray );
 	}
 	else
 	{
 		AiNodeDeclare( node, setName.c_str(), "indexed POINT2" );
 		AiNodeSetArray( node, setName.c_str(), uvsArray );
-		AiNodeSetArray( node, (setName + "idxs").c_str(), indicesArray );
+		AiNodeSetArray( node, (setName + "idxs").c_str(), uvIndicesArray );
 	}
 
 	variables.erase( sName );
@@ -234,18 +280,16 @@ AtNode *convertCommon( const IECore::MeshPrimitive *mesh )
 
 	AtNode *result = AiNode( "polymesh" );
 
-	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
 	AiNodeSetArray(
 		result,
 		"nsides",
-		AiArrayConvert( verticesPerFace.size(), 1, AI_TYPE_INT, (void *)&( verticesPerFace[0] ) )
+		ParameterAlgo::dataToArray( mesh->verticesPerFace(), AI_TYPE_INT )
 	);
 
-	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
 	AiNodeSetArray(
 		result,
 		"vidxs",
-		AiArrayConvert( vertexIds.size(), 1, AI_TYPE_INT, (void *)&( vertexIds[0] ) )
+		ParameterAlgo::dataToArray( mesh->vertexIds(), AI_TYPE_INT )
 	);
 
 	// Set subdivision
@@ -295,7 +339,7 @@ AtNode *convertCommon( const IECore::MeshPrimitive *mesh )
 	}
 	for( vector<string>::const_iterator it = uvSetNames.begin(), eIt = uvSetNames.end(); it != eIt; ++it )
 	{
-		convertUVSet( *it, variablesToConvert, vertexIds, result );
+		convertUVSet( *it, variablesToConvert, mesh->vertexIds()->readable(), result );
 	}
 
 	// Finally, do a generic conversion of anything that remains.
@@ -307,7 +351,9 @@ AtNode *convertCommon( const IECore::MeshPrimitive *mesh )
 	return result;
 }
 
-const V3fVectorData *normal( const IECore::MeshPrimitive *mesh, PrimitiveVariable::Interpolation &interpolation )
+// If indices is non-NULL, FaceVarying normals are returned unexpanded, with their indices
+// (if any) placed in indices. Otherwise the normals are always expanded.
+ConstV3fVectorDataPtr normal( const IECore::MeshPrimitive *mesh, PrimitiveVariable::Interpolation &interpolation, ConstIntVectorDataPtr *indices = NULL )
 {
 	PrimitiveVariableMap::const_iterator it = mesh->variables.find( "N" );
 	if( it == mesh->variables.end() )
@@ -336,12 +382,27 @@ const V3fVectorData *normal( const IECore::MeshPrimitive *mesh, PrimitiveVariabl
 	}
 
 	interpolation = thisInterpolation;
-	return n;
+	if( !it->second.indices )
+	{
+		return n;
+	}
+
+	if( indices && thisInterpolation == PrimitiveVariable::FaceVarying )
+	{
+		*indices = it->second.indices;
+		return n;
+	}
+
+	return runTimeCast<const V3fVectorData>( it->second.expandedData() );
 }
 
-void convertNormalIndices( const IECore::MeshPrimitive *mesh, AtNode *node, PrimitiveVariable::Interpolation interpolation )
+void convertNormalIndices( const IECore::MeshPrimitive *mesh, AtNode *node, PrimitiveVariable::Interpolation interpolation, const IntVectorData *indices = NULL )
 {
-	if( interpolation == PrimitiveVariable::FaceVarying )
+	if( indices )
+	{
+		AiNodeSetArray( node, "nidxs", indicesArray( indices ) );
+	}
+	else if( interpolation == PrimitiveVariable::FaceVarying )
 	{
 		AiNodeSetArray(
 			node,
@@ -351,11 +412,10 @@ void convertNormalIndices( const IECore::MeshPrimitive *mesh, AtNode *node, Prim
 	}
 	else
 	{
-		const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
 		AiNodeSetArray(
 			node,
 			"nidxs",
-			AiArrayConvert( vertexIds.size(), 1, AI_TYPE_INT, (void *)&( vertexIds[0] ) )
+			ParameterAlgo::dataToArray( mesh->vertexIds(), AI_TYPE_INT )
 		);
 	}
 }
@@ -377,14 +437,15 @@ AtNode *MeshAlgo::convert( const IECore::MeshPrimitive *mesh )
 	// add normals
 
 	PrimitiveVariable::Interpolation nInterpolation = PrimitiveVariable::Invalid;
-	if( const V3fVectorData *n = normal( mesh, nInterpolation ) )
+	ConstIntVectorDataPtr nIndices;
+	if( ConstV3fVectorDataPtr n = normal( mesh, nInterpolation, &nIndices ) )
 	{
 		AiNodeSetArray(
 			result,
 			"nlist",
-			AiArrayConvert( n->readable().size(), 1, AI_TYPE_VECTOR, &n->readable().front() )
+			ParameterAlgo::dataToArray( n.get(), AI_TYPE_VECTOR )
 		);
-		convertNormalIndices( mesh, result, nInterpolation );
+		convertNormalIndices( mesh, result, nInterpolation, nIndices.get() );
 		AiNodeSetBool( result, "smoothing", true );
 	}
 
@@ -400,14 +461,18 @@ AtNode *MeshAlgo::convert( const std::vector<const IECore::MeshPrimitive *> &sam
 
 	// add normals
 
-	vector<const Data *> nSamples;
+	// The samples may have differing indices, so we always expand them.
+	vector<ConstDataPtr> nSamplesOwner; // for ownership
+	vector<const Data *> nSamples; // for passing to dataToArray()
+	nSamplesOwner.reserve( samples.size() );
 	nSamples.reserve( samples.size() );
 	PrimitiveVariable::Interpolation nInterpolation = PrimitiveVariable::Invalid;
 	for( vector<const MeshPrimitive *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
 	{
-		if( const V3fVectorData *n = normal( *it, nInterpolation ) )
+		if( ConstV3fVectorDataPtr n = normal( *it, nInterpolation ) )
 		{
-			nSamples.push_back( n );
+			nSamplesOwner.push_back( n );
+			nSamples.push_back( n.get() );
 		}
 		else
 		{
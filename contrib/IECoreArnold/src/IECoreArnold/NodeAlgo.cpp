@@ -34,6 +34,9 @@
 
 #include "boost/unordered_map.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECoreArnold/NodeAlgo.h"
 
 //////////////////////////////////////////////////////////////////////////
@@ -66,6 +69,29 @@ Registry &registry()
 	return g_registry;
 }
 
+struct BatchConverter
+{
+
+	BatchConverter( const std::vector<const IECore::Object *> &objects, std::vector<AtNode *> &nodes )
+		:	m_objects( objects ), m_nodes( nodes )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			m_nodes[i] = NodeAlgo::convert( m_objects[i] );
+		}
+	}
+
+	private :
+
+		const std::vector<const IECore::Object *> &m_objects;
+		std::vector<AtNode *> &m_nodes;
+
+};
+
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -123,6 +149,12 @@ AtNode *convert( const std::vector<const IECore::Object *> &samples, const std::
 	}
 }
 
+void convertBatch( const std::vector<const IECore::Object *> &objects, std::vector<AtNode *> &nodes )
+{
+	nodes.resize( objects.size(), NULL );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, objects.size(), 1 ), BatchConverter( objects, nodes ) );
+}
+
 void registerConverter( IECore::TypeId fromType, Converter converter, MotionConverter motionConverter )
 {
 	registry().insert( Registry::value_type( fromType, Converters( converter, motionConverter ) ) );
@@ -34,6 +34,9 @@
 
 #include "boost/interprocess/smart_ptr/unique_ptr.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/MessageHandler.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/DespatchTypedData.h"
@@ -53,6 +56,29 @@ namespace
 
 typedef boost::interprocess::unique_ptr<AtArray, void (*)( AtArray *)> ArrayPtr;
 
+struct SetKeys
+{
+
+	SetKeys( AtArray *array, const vector<const void *> &sampleAddresses )
+		:	m_array( array ), m_sampleAddresses( sampleAddresses )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			AiArraySetKey( m_array, /* key = */ i, m_sampleAddresses[i] );
+		}
+	}
+
+	private :
+
+		AtArray *m_array;
+		const vector<const void *> &m_sampleAddresses;
+
+};
+
 template<typename T>
 inline const T *dataCast( const char *name, const IECore::Data *data )
 {
@@ -513,9 +539,16 @@ AtArray *dataToArray( const IECore::Data *data, int aiType )
 		return array;
 	}
 
+	// AiArraySetKey() is a straight copy of the whole key, whereas
+	// AiArrayConvert() converts element by element.
 	const void *dataAddress = despatchTypedData<TypedDataAddress, TypeTraits::IsTypedData, DespatchTypedDataIgnoreError>( const_cast<Data *>( data ) );
 	size_t dataSize = despatchTypedData<TypedDataSize, TypeTraits::IsTypedData, DespatchTypedDataIgnoreError>( const_cast<Data *>( data ) );
-	return AiArrayConvert( dataSize, 1, aiType, dataAddress );
+	AtArray *array = AiArrayAllocate( dataSize, 1, aiType );
+	if( dataSize )
+	{
+		AiArraySetKey( array, 0, dataAddress );
+	}
+	return array;
 }
 
 IECOREARNOLD_API AtArray *dataToArray( const std::vector<const IECore::Data *> &samples, int aiType )
@@ -536,6 +569,8 @@ IECOREARNOLD_API AtArray *dataToArray( const std::vector<const IECore::Data *> &
 		AiArrayDestroy
 	);
 
+	vector<const void *> sampleAddresses;
+	sampleAddresses.reserve( samples.size() );
 	for( vector<const IECore::Data *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
 	{
 		if( (*it)->typeId() != samples.front()->typeId() )
@@ -547,8 +582,14 @@ IECOREARNOLD_API AtArray *dataToArray( const std::vector<const IECore::Data *> &
 		{
 			throw IECore::Exception( "ParameterAlgo::dataToArray() : Mismatched sample lengths." );
 		}
-		const void *dataAddress = despatchTypedData<TypedDataAddress, TypeTraits::IsTypedData, DespatchTypedDataIgnoreError>( const_cast<Data *>( *it ) );
-		AiArraySetKey( array.get(), /* key = */ it - samples.begin(), dataAddress );
+		sampleAddresses.push_back( despatchTypedData<TypedDataAddress, TypeTraits::IsTypedData, DespatchTypedDataIgnoreError>( const_cast<Data *>( *it ) ) );
+	}
+
+	// Each key occupies its own region of the array, so they can be
+	// filled concurrently.
+	if( arraySize )
+	{
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, sampleAddresses.size() ), SetKeys( array.get(), sampleAddresses ) );
 	}
 
 	return array.release();
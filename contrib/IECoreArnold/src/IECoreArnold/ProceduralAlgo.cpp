@@ -0,0 +1,210 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/lexical_cast.hpp"
+#include "boost/format.hpp"
+#include "boost/unordered_map.hpp"
+
+#include "IECore/SharedSceneInterfaces.h"
+#include "IECore/VisibleRenderable.h"
+#include "IECore/AttributeBlock.h"
+#include "IECore/Exception.h"
+
+#include "IECoreArnold/ProceduralAlgo.h"
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreArnold;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef boost::unordered_map<std::string, ProceduralAlgo::Creator> Registry;
+
+Registry &registry()
+{
+	static Registry g_registry;
+	return g_registry;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Public implementation
+//////////////////////////////////////////////////////////////////////////
+
+namespace IECoreArnold
+{
+
+namespace ProceduralAlgo
+{
+
+void registerProcedural( const std::string &className, Creator creator )
+{
+	registry()[className] = creator;
+}
+
+IECore::Renderer::ProceduralPtr create( const std::string &className, const std::vector<std::string> &arguments )
+{
+	const Registry &r = registry();
+	Registry::const_iterator it = r.find( className );
+	if( it == r.end() )
+	{
+		return NULL;
+	}
+	return it->second( arguments );
+}
+
+} // namespace ProceduralAlgo
+
+} // namespace IECoreArnold
+
+//////////////////////////////////////////////////////////////////////////
+// SceneCache procedural
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+class SceneCacheProcedural : public IECore::Renderer::Procedural
+{
+
+	public :
+
+		SceneCacheProcedural( ConstSceneInterfacePtr scene, double time )
+			:	m_scene( scene ), m_time( time )
+		{
+		}
+
+		virtual Imath::Box3f bound() const
+		{
+			const Box3d b = m_scene->readBound( m_time );
+			if( b.isEmpty() )
+			{
+				return Box3f();
+			}
+			return Box3f( V3f( b.min ), V3f( b.max ) );
+		}
+
+		virtual void render( IECore::Renderer *renderer ) const
+		{
+			if( m_scene->hasObject() )
+			{
+				ConstVisibleRenderablePtr renderable = runTimeCast<const VisibleRenderable>( m_scene->readObject( m_time ) );
+				if( renderable )
+				{
+					renderable->render( renderer );
+				}
+			}
+
+			// Each child is a procedural of its own, so Arnold
+			// can expand them lazily, and in parallel.
+			SceneInterface::NameList childNames;
+			m_scene->childNames( childNames );
+			for( SceneInterface::NameList::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
+			{
+				ConstSceneInterfacePtr child = m_scene->child( *it );
+				AttributeBlock attributeBlock( renderer );
+				renderer->concatTransform( M44f( child->readTransformAsMatrix( m_time ) ) );
+				renderer->procedural( new SceneCacheProcedural( child, m_time ) );
+			}
+		}
+
+		virtual MurmurHash hash() const
+		{
+			MurmurHash h;
+			m_scene->hash( SceneInterface::HierarchyHash, m_time, h );
+			return h;
+		}
+
+		static IECore::Renderer::ProceduralPtr creator( const std::vector<std::string> &arguments )
+		{
+			std::string fileName;
+			std::string path = "/";
+			double time = 0;
+
+			for( size_t i = 0; i < arguments.size(); i += 2 )
+			{
+				if( i + 1 >= arguments.size() )
+				{
+					throw IECore::Exception( boost::str( boost::format( "No value given for argument \"%s\"" ) % arguments[i] ) );
+				}
+
+				const std::string &name = arguments[i];
+				const std::string &value = arguments[i+1];
+				if( name == "-fileName" )
+				{
+					fileName = value;
+				}
+				else if( name == "-path" )
+				{
+					path = value;
+				}
+				else if( name == "-time" )
+				{
+					time = boost::lexical_cast<double>( value );
+				}
+				else
+				{
+					throw IECore::Exception( boost::str( boost::format( "Unknown argument \"%s\"" ) % name ) );
+				}
+			}
+
+			if( fileName.empty() )
+			{
+				throw IECore::Exception( "No -fileName argument given" );
+			}
+
+			SceneInterface::Path scenePath;
+			SceneInterface::stringToPath( path, scenePath );
+			ConstSceneInterfacePtr scene = SharedSceneInterfaces::get( fileName )->scene( scenePath );
+			return new SceneCacheProcedural( scene, time );
+		}
+
+	private :
+
+		ConstSceneInterfacePtr m_scene;
+		double m_time;
+
+		static ProceduralAlgo::ProceduralDescription g_description;
+
+};
+
+ProceduralAlgo::ProceduralDescription SceneCacheProcedural::g_description( "SceneCache", SceneCacheProcedural::creator );
+
+} // namespace
@@ -125,7 +125,8 @@ IECoreArnold::RendererImplementation::RendererImplementation( const RendererImpl
 IECoreArnold::RendererImplementation::RendererImplementation( const AtNode *proceduralNode )
 {
 	constructCommon( Procedural );
-	m_instancingConverter = new InstancingConverter;
+	// Share instances with all other procedurals in the universe.
+	m_instancingConverter = InstancingConverter::universeConverter();
 	/// \todo Initialise stacks properly!!
 	m_attributeStack.push( AttributeState() );
 	// the AttributeState constructor makes a surface shader node, and
@@ -140,7 +141,7 @@ void IECoreArnold::RendererImplementation::constructCommon( Mode mode )
 	if( mode != Procedural )
 	{
 		m_universe = boost::shared_ptr<UniverseBlock>( new UniverseBlock( /* writable = */ true ) );
-		m_instancingConverter = new InstancingConverter;
+		m_instancingConverter = InstancingConverter::universeConverter();
 
 		/// \todo Control with an option
 		AiMsgSetConsoleFlags( AI_LOG_ALL );
@@ -157,6 +158,7 @@ IECoreArnold::RendererImplementation::~RendererImplementation()
 {
 	if( m_mode != Procedural )
 	{
+		InstancingConverter::resetUniverseConverter();
 		AiEnd();
 	}
 }
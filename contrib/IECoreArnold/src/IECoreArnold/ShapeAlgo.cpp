@@ -63,9 +63,20 @@ AtArray *identityIndices( size_t size )
 	return result;
 }
 
+AtArray *indicesArray( const IntVectorData *indices )
+{
+	const vector<int> &readable = indices->readable();
+	AtArray *result = AiArrayAllocate( readable.size(), 1, AI_TYPE_UINT );
+	for( size_t i=0; i < readable.size(); ++i )
+	{
+		AiArraySetUInt( result, i, readable[i] );
+	}
+	return result;
+}
+
 ConstFloatVectorDataPtr radius( const Primitive *primitive )
 {
-	if( ConstFloatVectorDataPtr radius = primitive->variableData<FloatVectorData>( "radius" ) )
+	if( ConstFloatVectorDataPtr radius = runTimeCast<const FloatVectorData>( ShapeAlgo::expandedVariableData( primitive, "radius" ) ) )
 	{
 		return radius;
 	}
@@ -75,7 +86,7 @@ ConstFloatVectorDataPtr radius( const Primitive *primitive )
 	{
 		calculatedRadius->writable().push_back( constantRadius->readable() );
 	}
-	else if( const FloatVectorData *width = primitive->variableData<FloatVectorData>( "width" ) )
+	else if( ConstFloatVectorDataPtr width = runTimeCast<const FloatVectorData>( ShapeAlgo::expandedVariableData( primitive, "width" ) ) )
 	{
 		calculatedRadius->writable().resize( width->readable().size() );
 		const std::vector<float>::iterator end = calculatedRadius->writable().end();
@@ -110,9 +121,23 @@ namespace IECoreArnold
 namespace ShapeAlgo
 {
 
+ConstDataPtr expandedVariableData( const IECore::Primitive *primitive, const std::string &name, IECore::PrimitiveVariable::Interpolation requiredInterpolation )
+{
+	PrimitiveVariableMap::const_iterator it = primitive->variables.find( name );
+	if( it == primitive->variables.end() )
+	{
+		return NULL;
+	}
+	if( requiredInterpolation != PrimitiveVariable::Invalid && it->second.interpolation != requiredInterpolation )
+	{
+		return NULL;
+	}
+	return it->second.expandedData();
+}
+
 void convertP( const IECore::Primitive *primitive, AtNode *shape, const char *name )
 {
-	const V3fVectorData *p = primitive->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+	ConstV3fVectorDataPtr p = runTimeCast<const V3fVectorData>( expandedVariableData( primitive, "P", PrimitiveVariable::Vertex ) );
 	if( !p )
 	{
 		throw Exception( "Primitive does not have \"P\" primitive variable of interpolation type Vertex." );
@@ -121,23 +146,26 @@ void convertP( const IECore::Primitive *primitive, AtNode *shape, const char *na
 	AiNodeSetArray(
 		shape,
 		name,
-		AiArrayConvert( p->readable().size(), 1, AI_TYPE_POINT, (void *)&( p->readable()[0] ) )
+		ParameterAlgo::dataToArray( p.get(), AI_TYPE_POINT )
 	);
 }
 
 void convertP( const std::vector<const IECore::Primitive *> &samples, AtNode *shape, const char *name )
 {
-	vector<const Data *> dataSamples;
+	vector<ConstDataPtr> pSamples; // for ownership
+	vector<const Data *> dataSamples; // for passing to dataToArray()
+	pSamples.reserve( samples.size() );
 	dataSamples.reserve( samples.size() );
 
 	for( vector<const Primitive *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
 	{
-		const V3fVectorData *p = (*it)->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+		ConstV3fVectorDataPtr p = runTimeCast<const V3fVectorData>( expandedVariableData( *it, "P", PrimitiveVariable::Vertex ) );
 		if( !p )
 		{
 			throw Exception( "Primitive does not have \"P\" primitive variable of interpolation type Vertex." );
 		}
-		dataSamples.push_back( p );
+		pSamples.push_back( p );
+		dataSamples.push_back( p.get() );
 	}
 
 	AtArray *array = ParameterAlgo::dataToArray( dataSamples, AI_TYPE_POINT );
@@ -151,7 +179,7 @@ void convertRadius( const IECore::Primitive *primitive, AtNode *shape )
 	AiNodeSetArray(
 		shape,
 		"radius",
-		AiArrayConvert( r->readable().size(), 1, AI_TYPE_FLOAT, (void *)&( r->readable()[0] ) )
+		ParameterAlgo::dataToArray( r.get(), AI_TYPE_FLOAT )
 	);
 }
 
@@ -249,31 +277,48 @@ void convertPrimitiveVariable( const IECore::Primitive *primitive, const Primiti
 		}
 	}
 
+	// Arnold's "indexed" interpolation has its own indices, so we can output
+	// ours directly. In all other cases we must expand the data.
+
+	ConstDataPtr data = primitiveVariable.data;
+	const IntVectorData *indices = NULL;
+	if( primitiveVariable.indices )
+	{
+		if( arnoldInterpolation == "indexed" )
+		{
+			indices = primitiveVariable.indices.get();
+		}
+		else
+		{
+			data = primitiveVariable.expandedData();
+		}
+	}
+
 	// Deal with the simple case of constant data.
 
 	if( arnoldInterpolation == "constant" )
 	{
-		ParameterAlgo::setParameter( shape, name, primitiveVariable.data.get() );
+		ParameterAlgo::setParameter( shape, name, data.get() );
 		return;
 	}
 
 	// Now deal with more complex cases with array data.
 
 	bool isArray = false;
-	int type = ParameterAlgo::parameterType( primitiveVariable.data.get(), isArray );
+	int type = ParameterAlgo::parameterType( data.get(), isArray );
 	if( type == AI_TYPE_NONE || !isArray )
 	{
 		msg(
 			Msg::Warning,
 			"ShapeAlgo::convertPrimitiveVariable",
-			boost::format( "Unable to create user parameter \"%s\" for primitive variable of type \"%s\"" ) % name % primitiveVariable.data->typeName()
+			boost::format( "Unable to create user parameter \"%s\" for primitive variable of type \"%s\"" ) % name % data->typeName()
 		);
 		return;
 	}
 
 	std::string typeString = arnoldInterpolation + " " + AiParamGetTypeName( type );
 	AiNodeDeclare( shape, name, typeString.c_str() );
-	AtArray *array = ParameterAlgo::dataToArray( primitiveVariable.data.get(), type );
+	AtArray *array = ParameterAlgo::dataToArray( data.get(), type );
 	if( array )
 	{
 		AiNodeSetArray( shape, name, array );
@@ -282,7 +327,7 @@ void convertPrimitiveVariable( const IECore::Primitive *primitive, const Primiti
 			AiNodeSetArray(
 				shape,
 				(name + string("idxs")).c_str(),
-				identityIndices( array->nelements )
+				indices ? indicesArray( indices ) : identityIndices( array->nelements )
 			);
 		}
 	}
@@ -291,7 +336,7 @@ void convertPrimitiveVariable( const IECore::Primitive *primitive, const Primiti
 		msg(
 			Msg::Warning,
 			"ShapeAlgo::convertPrimitiveVariable",
-			boost::format( "Failed to create array for parameter \"%s\" from data of type \"%s\"" ) % name % primitiveVariable.data->typeName()
+			boost::format( "Failed to create array for parameter \"%s\" from data of type \"%s\"" ) % name % data->typeName()
 		);
 	}
 }
@@ -43,6 +43,7 @@
 #include "IECore/MessageHandler.h"
 
 #include "IECoreArnold/UniverseBlock.h"
+#include "IECoreArnold/InstancingConverter.h"
 
 using namespace IECore;
 using namespace IECoreArnold;
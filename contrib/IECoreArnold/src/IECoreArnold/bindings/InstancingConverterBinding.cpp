@@ -115,5 +115,12 @@ void IECoreArnold::bindInstancingConverter()
 		.def( "convert", &convertWrapper2 )
 		.def( "convert", &convertWrapper3 )
 		.def( "convert", &convertWrapper4 )
+		.def( "universeConverter", &InstancingConverter::universeConverter ).staticmethod( "universeConverter" )
+		.def( "resetUniverseConverter", &InstancingConverter::resetUniverseConverter ).staticmethod( "resetUniverseConverter" )
+		.def( "setMaxMemory", &InstancingConverter::setMaxMemory )
+		.def( "getMaxMemory", &InstancingConverter::getMaxMemory )
+		.def( "setConstantPrimitiveVariablesOnInstances", &InstancingConverter::setConstantPrimitiveVariablesOnInstances )
+		.def( "getConstantPrimitiveVariablesOnInstances", &InstancingConverter::getConstantPrimitiveVariablesOnInstances )
+		.def( "statistics", &InstancingConverter::statistics )
 	;
 }
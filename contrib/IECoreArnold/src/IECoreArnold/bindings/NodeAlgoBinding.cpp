@@ -39,6 +39,8 @@
 
 #include "IECore/Object.h"
 
+#include "IECorePython/ScopedGILRelease.h"
+
 using namespace boost::python;
 using namespace IECoreArnold;
 using namespace IECoreArnoldBindings;
@@ -61,6 +63,25 @@ object convertWrapper2( object pythonSamples, object pythonSampleTimes )
 	return atNodeToPythonObject( NodeAlgo::convert( samples, sampleTimes ) );
 }
 
+list convertBatchWrapper( object pythonObjects )
+{
+	std::vector<const IECore::Object *> objects;
+	container_utils::extend_container( objects, pythonObjects );
+
+	std::vector<AtNode *> nodes;
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		NodeAlgo::convertBatch( objects, nodes );
+	}
+
+	list result;
+	for( std::vector<AtNode *>::const_iterator it = nodes.begin(), eIt = nodes.end(); it != eIt; ++it )
+	{
+		result.append( atNodeToPythonObject( *it ) );
+	}
+	return result;
+}
+
 } // namespace
 
 namespace IECoreArnoldBindings
@@ -91,6 +112,7 @@ void bindNodeAlgo()
 
 	def( "convert", &convertWrapper );
 	def( "convert", &convertWrapper2 );
+	def( "convertBatch", &convertBatchWrapper );
 
 }
 
@@ -35,6 +35,14 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+
+#include "boost/bind.hpp"
+#include "boost/scoped_ptr.hpp"
+
+#include "tbb/concurrent_queue.h"
+#include "tbb/tbb_thread.h"
+
 #include "ai_drivers.h"
 #include "ai_version.h"
 
@@ -52,21 +60,113 @@ using namespace IECoreArnold;
 namespace
 {
 
+// A bucket of interleaved pixels waiting to be
+// forwarded to the display driver.
+struct Bucket
+{
+	Box2i box;
+	std::vector<float> data;
+};
+
+// Bounds the number of buckets waiting to be forwarded, so
+// that a slow display driver applies back pressure to the
+// render rather than consuming unlimited memory.
+const size_t g_maxQueuedBuckets = 64;
+
 // Stores a Cortex DisplayDriver and the parameters
 // used to create it. This forms the private data
 // accessed via AiDriverGetLocalData.
+//
+// Buckets are handed off to a forwarding thread which
+// passes them to the display driver, so that Arnold's
+// render threads aren't blocked by drivers which perform
+// I/O, such as the ClientDisplayDriver. Buckets are
+// recycled once forwarded, so that the render threads
+// don't need to allocate a fresh buffer per bucket.
 struct LocalData
 {
 
 	LocalData()
 		:	numOutputs( 0 )
 	{
+		queue.set_capacity( g_maxQueuedBuckets );
+	}
+
+	~LocalData()
+	{
+		stopForwarding();
+		Bucket *bucket = NULL;
+		while( freeBuckets.try_pop( bucket ) )
+		{
+			delete bucket;
+		}
 	}
 
 	DisplayDriverPtr displayDriver;
 	ConstCompoundDataPtr displayDriverParameters;
 	int numOutputs;
 
+	// Buckets waiting to be forwarded, terminated by
+	// a NULL entry when forwarding is to stop.
+	tbb::concurrent_bounded_queue<Bucket *> queue;
+	tbb::concurrent_queue<Bucket *> freeBuckets;
+	boost::scoped_ptr<tbb::tbb_thread> forwardingThread;
+
+	Bucket *acquireBucket()
+	{
+		Bucket *bucket = NULL;
+		if( !freeBuckets.try_pop( bucket ) )
+		{
+			bucket = new Bucket;
+		}
+		return bucket;
+	}
+
+	void startForwarding()
+	{
+		if( !forwardingThread )
+		{
+			forwardingThread.reset( new tbb::tbb_thread( boost::bind( &LocalData::forward, this ) ) );
+		}
+	}
+
+	// Waits for all queued buckets to be forwarded.
+	void stopForwarding()
+	{
+		if( forwardingThread )
+		{
+			queue.push( NULL );
+			forwardingThread->join();
+			forwardingThread.reset();
+		}
+	}
+
+	void forward()
+	{
+		Bucket *bucket = NULL;
+		while( true )
+		{
+			queue.pop( bucket );
+			if( !bucket )
+			{
+				return;
+			}
+
+			try
+			{
+				displayDriver->imageData( bucket->box, &bucket->data[0], bucket->data.size() );
+			}
+			catch( const std::exception &e )
+			{
+				// we have to catch and report exceptions because letting them out into pure c land
+				// just causes aborts.
+				msg( Msg::Error, "ieOutputDriver:driverWriteBucket", e.what() );
+			}
+
+			freeBuckets.push( bucket );
+		}
+	}
+
 	void imageClose()
 	{
 		if( !displayDriver )
@@ -74,6 +174,10 @@ struct LocalData
 			return;
 		}
 
+		// The display driver must receive all
+		// outstanding data before being closed.
+		stopForwarding();
+
 		try
 		{
 			displayDriver->imageClose();
@@ -226,6 +330,7 @@ void driverOpen( AtNode *node, struct AtOutputIterator *iterator, AtBBox2 displa
 	{
 		localData->displayDriver = IECore::DisplayDriver::create( driverType, cortexDisplayWindow, cortexDataWindow, channelNames, parameters );
 		localData->displayDriverParameters = parameters;
+		localData->startForwarding();
 	}
 	catch( const std::exception &e )
 	{
@@ -258,21 +363,28 @@ void driverWriteBucket( AtNode *node, struct AtOutputIterator *iterator, struct
 
 	const int numOutputChannels = localData->displayDriver->channelNames().size();
 
-	const float *imageData;
-	std::vector<float> interleavedData;
+	Bucket *bucket = localData->acquireBucket();
+	bucket->box = Box2i(
+		V2i( x, y ),
+		V2i( x + sx - 1, y + sy - 1 )
+	);
+	// Doesn't reallocate once recycled buckets have
+	// reached the size of the largest bucket.
+	bucket->data.resize( sx * sy * numOutputChannels );
+
 	if( localData->numOutputs == 1 )
 	{
-		// Data already has the layout we need.
+		// Data already has the layout we need, but must be
+		// copied as it is only valid for the duration of this call.
 		const void *bucketData;
 		AiOutputIteratorGetNext( iterator, NULL, NULL, &bucketData );
-		imageData = (float *)bucketData;
+		const float *in = (const float *)bucketData;
+		std::copy( in, in + bucket->data.size(), bucket->data.begin() );
 	}
 	else
 	{
 		// We need to interleave multiple outputs
 		// into a single block for the display driver.
-		interleavedData.resize( sx * sy * numOutputChannels );
-
 		int pixelType = 0;
 		const void *bucketData;
 		int outChannelOffset = 0;
@@ -297,7 +409,7 @@ void driverWriteBucket( AtNode *node, struct AtOutputIterator *iterator, struct
 			for( int c = 0; c < numChannels; c++ )
 			{
 				float *in = (float *)(bucketData) + c;
-				float *out = &(interleavedData[0]) + outChannelOffset;
+				float *out = &(bucket->data[0]) + outChannelOffset;
 				for( int j = 0; j < sy; j++ )
 				{
 					for( int i = 0; i < sx; i++ )
@@ -310,25 +422,11 @@ void driverWriteBucket( AtNode *node, struct AtOutputIterator *iterator, struct
 				outChannelOffset += 1;
 			}
 		}
-
-		imageData = &interleavedData[0];
 	}
 
-	Box2i bucketBox(
-		V2i( x, y ),
-		V2i( x + sx - 1, y + sy - 1 )
-	);
-
-	try
-	{
-		localData->displayDriver->imageData( bucketBox, imageData, sx * sy * numOutputChannels );
-	}
-	catch( const std::exception &e )
-	{
-		// we have to catch and report exceptions because letting them out into pure c land
-		// just causes aborts.
-		msg( Msg::Error, "ieOutputDriver:driverWriteBucket", e.what() );
-	}
+	// Blocks if the forwarding thread has fallen
+	// too far behind.
+	localData->queue.push( bucket );
 }
 
 void driverClose( AtNode *node, struct AtOutputIterator *iterator )
@@ -42,8 +42,10 @@
 #include "IECorePython/ScopedGILLock.h"
 
 #include "IECoreArnold/Renderer.h"
+#include "IECoreArnold/ProceduralAlgo.h"
 
 #include <iostream>
+#include <vector>
 
 using namespace std;
 using namespace boost::python;
@@ -101,14 +103,63 @@ static void initialisePython()
 
 static int procInit( AtNode *node, void **userPtr )
 {
-	// load the class
-
-	initialisePython();
-
 	const char *className = AiNodeGetStr( node, "className" );
 	int classVersion = AiNodeGetInt( node, "classVersion" );
 	AtArray *parameterValues = AiNodeGetArray( node, "parameterValues" );
 
+	std::vector<std::string> arguments;
+	if( parameterValues )
+	{
+		for( unsigned i=0; i<parameterValues->nelements; i++ )
+		{
+			// hack to workaround ass parsing errors
+			/// \todo Remove when we get the Arnold version that fixes this
+			std::string s = AiArrayGetStr( parameterValues, i );
+			for( size_t c = 0; c<s.size(); c++ )
+			{
+				if( s[c] == '@' )
+				{
+					s[c] = '#';
+				}
+			}
+			arguments.push_back( s );
+		}
+	}
+
+	*userPtr = 0;
+
+	// if a pure C++ procedural has been registered under this name
+	// then use it directly, without initialising python or waiting on
+	// the GIL - this lets arnold expand such procedurals concurrently.
+
+	try
+	{
+		IECore::Renderer::ProceduralPtr procedural = IECoreArnold::ProceduralAlgo::create( className, arguments );
+		if( procedural )
+		{
+			IECoreArnold::RendererPtr renderer = new IECoreArnold::Renderer( node );
+			procedural->render( renderer.get() );
+
+			renderer->addRef();
+			*userPtr = renderer.get();
+			return 1;
+		}
+	}
+	catch( const std::exception &e )
+	{
+		msg( Msg::Error, "ieProcedural", e.what() );
+		return 1;
+	}
+	catch( ... )
+	{
+		msg( Msg::Error, "ieProcedural", "Caught unknown exception" );
+		return 1;
+	}
+
+	// otherwise load the python class
+
+	initialisePython();
+
 	ParameterisedProceduralPtr parameterisedProcedural = 0;
 	ScopedGILLock gilLock;
 	try
@@ -120,20 +171,9 @@ static int procInit( AtNode *node, void **userPtr )
 		if( parameterValues )
 		{
 			boost::python::list toParse;
-			for( unsigned i=0; i<parameterValues->nelements; i++ )
+			for( std::vector<std::string>::const_iterator it = arguments.begin(), eIt = arguments.end(); it != eIt; ++it )
 			{
-				// hack to workaround ass parsing errors
-				/// \todo Remove when we get the Arnold version that fixes this
-				std::string s = AiArrayGetStr( parameterValues, i );
-				for( size_t c = 0; c<s.size(); c++ )
-				{
-					if( s[c] == '@' )
-					{
-						s[c] = '#';
-					}
-				}
-
-				toParse.append( s );
+				toParse.append( *it );
 			}
 
 			object parameterParser = ieCore.attr( "ParameterParser" )();
@@ -165,10 +205,6 @@ static int procInit( AtNode *node, void **userPtr )
 		renderer->addRef();
 		*userPtr = renderer.get();
 	}
-	else
-	{
-		*userPtr = 0;
-	}
 
 	return 1;
 }
@@ -168,5 +168,91 @@ class InstancingConverterTest( unittest.TestCase ) :
 			self.assertEqual( arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( n1 ) ), "polymesh" )
 			self.assertEqual( arnold.AiNodeGetArray( n1, "vlist" ).contents.nkeys, 2 )
 
+	def testStatistics( self ) :
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			c = IECoreArnold.InstancingConverter()
+
+			m1 = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+			m2 = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -2 ), IECore.V2f( 2 ) ) )
+
+			c.convert( m1 )
+			c.convert( m1 )
+			c.convert( m1 )
+			c.convert( m2 )
+
+			s = c.statistics()
+			self.assertEqual( s["hits"].value, 2 )
+			self.assertEqual( s["misses"].value, 2 )
+			self.assertEqual( s["uncached"].value, 0 )
+			self.assertEqual( s["collisions"].value, 0 )
+			self.assertTrue( s["memoryUsage"].value > 0 )
+
+	def testMaxMemory( self ) :
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			c = IECoreArnold.InstancingConverter()
+			c.setMaxMemory( 0 )
+			self.assertEqual( c.getMaxMemory(), 0 )
+
+			m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+
+			n1 = c.convert( m )
+			n2 = c.convert( m )
+			self.assertEqual( arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( n1 ) ), "polymesh" )
+			self.assertEqual( arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( n2 ) ), "polymesh" )
+
+			s = c.statistics()
+			self.assertEqual( s["uncached"].value, 2 )
+			self.assertEqual( s["memoryUsage"].value, 0 )
+
+	def testConstantPrimitiveVariablesOnInstances( self ) :
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			c = IECoreArnold.InstancingConverter()
+			self.assertEqual( c.getConstantPrimitiveVariablesOnInstances(), False )
+
+			m1 = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+			m1["id"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.IntData( 1 ) )
+			m2 = m1.copy()
+			m2["id"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.IntData( 2 ) )
+
+			n1 = c.convert( m1 )
+			n2 = c.convert( m2 )
+			self.assertEqual( arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( n2 ) ), "polymesh" )
+
+			c.setConstantPrimitiveVariablesOnInstances( True )
+			self.assertEqual( c.getConstantPrimitiveVariablesOnInstances(), True )
+
+			m3 = m1.copy()
+			m3["id"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.IntData( 3 ) )
+			m4 = m1.copy()
+			m4["id"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.IntData( 4 ) )
+
+			n3 = c.convert( m3 )
+			self.assertEqual( arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( n3 ) ), "polymesh" )
+			self.assertEqual( arnold.AiNodeGetInt( n3, "id" ), 3 )
+
+			n4 = c.convert( m4 )
+			self.assertEqual( arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( n4 ) ), "ginstance" )
+			self.assertEqual( arnold.AiNodeGetPtr( n4, "node" ), ctypes.addressof( n3.contents ) )
+			self.assertEqual( arnold.AiNodeGetInt( n4, "id" ), 4 )
+
+	def testUniverseConverter( self ) :
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			c1 = IECoreArnold.InstancingConverter.universeConverter()
+			c2 = IECoreArnold.InstancingConverter.universeConverter()
+			self.assertTrue( c1.isSame( c2 ) )
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			c3 = IECoreArnold.InstancingConverter.universeConverter()
+			self.assertFalse( c3.isSame( c1 ) )
+
 if __name__ == "__main__":
     unittest.main()
@@ -163,6 +163,94 @@ class MeshTest( unittest.TestCase ) :
 				self.assertEqual( arnold.AiArrayGetFlt( a, i ), i )
 				self.assertEqual( arnold.AiArrayGetUInt( ia, i ), i )
 
+	def testIndexedFaceVaryingPrimitiveVariables( self ) :
+
+		m = IECore.MeshPrimitive.createPlane(
+			IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ),
+			IECore.V2i( 2 ),
+		)
+
+		indices = IECore.IntVectorData( [ i % 3 for i in range( 0, 16 ) ] )
+		m["myPrimVar"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.FaceVarying,
+			IECore.FloatVectorData( [ 10, 20, 30 ] ),
+			indices
+		)
+		self.assertTrue( m.arePrimitiveVariablesValid() )
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			n = IECoreArnold.NodeAlgo.convert( m )
+			a = arnold.AiNodeGetArray( n, "myPrimVar" )
+			ia = arnold.AiNodeGetArray( n, "myPrimVaridxs" )
+			self.assertEqual( a.contents.nelements, 3 )
+			self.assertEqual( ia.contents.nelements, 16 )
+			for i in range( 0, 3 ) :
+				self.assertEqual( arnold.AiArrayGetFlt( a, i ), ( i + 1 ) * 10 )
+			for i in range( 0, 16 ) :
+				self.assertEqual( arnold.AiArrayGetUInt( ia, i ), indices[i] )
+
+	def testIndexedVertexPrimitiveVariables( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		m["myPrimVar"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.FloatVectorData( [ 5, 6 ] ),
+			IECore.IntVectorData( [ 1, 0, 1, 0 ] )
+		)
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			n = IECoreArnold.NodeAlgo.convert( m )
+			a = arnold.AiNodeGetArray( n, "myPrimVar" )
+			self.assertEqual( a.contents.nelements, 4 )
+			for i, v in enumerate( [ 6, 5, 6, 5 ] ) :
+				self.assertEqual( arnold.AiArrayGetFlt( a, i ), v )
+
+	def testIndexedUVs( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		indices = IECore.IntVectorData( [ 0, 1, 1, 0 ] )
+		m["s"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ 0, 1 ] ), indices )
+		m["t"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ 0, 0.5 ] ), indices )
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			n = IECoreArnold.NodeAlgo.convert( m )
+
+			uvs = arnold.AiNodeGetArray( n, "uvlist" )
+			self.assertEqual( uvs.contents.nelements, 2 )
+			self.assertEqual( arnold.AiArrayGetPnt2( uvs, 0 ), arnold.AtPoint2( 0, 1 ) )
+			self.assertEqual( arnold.AiArrayGetPnt2( uvs, 1 ), arnold.AtPoint2( 1, 0.5 ) )
+
+			uvIndices = arnold.AiNodeGetArray( n, "uvidxs" )
+			self.assertEqual( uvIndices.contents.nelements, 4 )
+			for i in range( 0, 4 ) :
+				self.assertEqual( arnold.AiArrayGetUInt( uvIndices, i ), indices[i] )
+
+	def testIndexedNormals( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		indices = IECore.IntVectorData( [ 0, 0, 0, 0 ] )
+		m["N"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.FaceVarying,
+			IECore.V3fVectorData( [ IECore.V3f( 0, 0, 1 ) ] ),
+			indices
+		)
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			n = IECoreArnold.NodeAlgo.convert( m )
+
+			normals = arnold.AiNodeGetArray( n, "nlist" )
+			self.assertEqual( normals.contents.nelements, 1 )
+			self.assertEqual( arnold.AiArrayGetVec( normals, 0 ), arnold.AtVector( 0, 0, 1 ) )
+
+			normalIndices = arnold.AiNodeGetArray( n, "nidxs" )
+			self.assertEqual( normalIndices.contents.nelements, 4 )
+			for i in range( 0, 4 ) :
+				self.assertEqual( arnold.AiArrayGetUInt( normalIndices, i ), 0 )
+
 	def testMotion( self ) :
 
 		m1 = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
@@ -262,5 +350,29 @@ class MeshTest( unittest.TestCase ) :
 			self.assertEqual( arnold.AiArrayGetBool( a, 2 ), True )
 			self.assertEqual( arnold.AiArrayGetBool( a, 3 ), False )
 
+	def testConvertBatch( self ) :
+
+		meshes = []
+		for i in range( 0, 20 ) :
+			m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( i + 1 ) )
+			meshes.append( m )
+
+		with IECoreArnold.UniverseBlock( writable = True ) :
+
+			nodes = IECoreArnold.NodeAlgo.convertBatch( meshes )
+			self.assertEqual( len( nodes ), len( meshes ) )
+
+			for m, n in zip( meshes, nodes ) :
+
+				vList = arnold.AiNodeGetArray( n, "vlist" )
+				self.assertEqual( vList.contents.nelements, len( m["P"].data ) )
+				for i in range( 0, vList.contents.nelements ) :
+					self.assertEqual( arnold.AiArrayGetPnt( vList, i ), arnold.AtPoint( *m["P"].data[i] ) )
+
+				vIdxs = arnold.AiNodeGetArray( n, "vidxs" )
+				self.assertEqual( vIdxs.contents.nelements, len( m.vertexIds ) )
+				for i in range( 0, vIdxs.contents.nelements ) :
+					self.assertEqual( arnold.AiArrayGetUInt( vIdxs, i ), m.vertexIds[i] )
+
 if __name__ == "__main__":
     unittest.main()
@@ -52,9 +52,18 @@ class ProceduralDSOTest( unittest.TestCase ) :
 		evaluator.pointAtUV( IECore.V2f( 0.5, 0.5 ), result )
 		self.failUnless( result.floatPrimVar( image["A"] ) > 0.99 )
 
+	def testSceneCache( self ) :
+
+		# "SceneCache" is implemented in C++ and registered with
+		# IECoreArnold::ProceduralAlgo, so doesn't require python.
+		os.system( "kick -dw -dp contrib/IECoreArnold/test/IECoreArnold/data/assFiles/proceduralDSOSceneCache.ass" )
+
+		image = IECore.EXRImageReader( "testProceduralDSOSceneCache.exr" ).read()
+		self.failUnless( max( image["A"].data ) > 0.99 )
+
 	def tearDown( self ) :
 
-		for f in [ "testProceduralDSO.exr" ] :
+		for f in [ "testProceduralDSO.exr", "testProceduralDSOSceneCache.exr" ] :
 			if os.path.exists( f ) :
 				os.remove( f )
 
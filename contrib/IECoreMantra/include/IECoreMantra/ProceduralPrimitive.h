@@ -101,6 +101,8 @@ class ProceduralPrimitive : public VRAY_Procedural
 	
     private:
 		void applySettings(VRAY_ProceduralChildPtr child);
+		// adds a child for geometry without motion blur
+		void addStaticGeometry( VRAY_ProceduralGeo &proceduralGeo );
 		// cortex data
 		RendererImplementationPtr m_renderer;
 		IECore::Renderer::ProceduralPtr m_procedural;
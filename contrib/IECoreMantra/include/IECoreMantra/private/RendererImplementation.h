@@ -37,8 +37,13 @@
 #define IECOREMANTRA_RENDERERIMPLEMENTATION_H
 
 #include <list>
+#include <map>
 #include <stack>
 
+#include "boost/shared_ptr.hpp"
+
+#include "tbb/mutex.h"
+
 #include "IECore/Camera.h"
 #include "IECore/Group.h"
 #include "IECoreMantra/Renderer.h"
@@ -188,6 +193,10 @@ class RendererImplementation : public IECore::Renderer
 
 		IECore::GroupPtr m_world;
 		std::string m_worldFileName;
+		// Primitives in m_world, keyed by their hash. Identical primitives share
+		// a single object, so that they are written to the world file only once.
+		typedef std::map<IECore::MurmurHash, IECore::VisibleRenderablePtr> WorldPrimitiveMap;
+		WorldPrimitiveMap m_worldPrimitives;
 
         FILE *m_fpipe;
 
@@ -199,6 +208,21 @@ class RendererImplementation : public IECore::Renderer
 		// An object for creating geometry, derived from VRAY_Procedural.
 		// This is a raw pointer because mantra owns it. It is only valid in Procedural mode.
 		ProceduralPrimitive* m_vrayproc;
+
+#if UT_MAJOR_VERSION_INT >= 16
+		// Geometry converted by ProceduralPrimitive, keyed by the hash of the
+		// source primitive. It is shared with the renderers of any procedurals
+		// we expand, so that repeated primitives are converted only once and
+		// then instanced. Procedurals may be rendered concurrently by mantra,
+		// hence the mutex.
+		struct GeometryCache
+		{
+			tbb::mutex mutex;
+			std::map<IECore::MurmurHash, VRAY_ProceduralGeo> geometry;
+		};
+		typedef boost::shared_ptr<GeometryCache> GeometryCachePtr;
+		GeometryCachePtr m_geometryCache;
+#endif
 		
 		typedef std::stack<Imath::M44f> TransformStack;
 		TransformStack m_transformStack;
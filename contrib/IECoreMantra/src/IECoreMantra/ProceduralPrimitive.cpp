@@ -99,6 +99,27 @@ void IECoreMantra::ProceduralPrimitive::render()
 
 void IECoreMantra::ProceduralPrimitive::addVisibleRenderable( VisibleRenderablePtr renderable )
 {
+#if UT_MAJOR_VERSION_INT >= 16
+	// Static geometry is instanced from the cache when an identical
+	// primitive has already been converted.
+	const bool cacheable = m_renderer->m_motionType == RendererImplementation::Unknown;
+	MurmurHash hash;
+	if ( cacheable )
+	{
+		hash = renderable->hash();
+		RendererImplementation::GeometryCache &cache = *m_renderer->m_geometryCache;
+		tbb::mutex::scoped_lock lock( cache.mutex );
+		std::map<MurmurHash, VRAY_ProceduralGeo>::const_iterator it = cache.geometry.find( hash );
+		if ( it != cache.geometry.end() )
+		{
+			VRAY_ProceduralGeo proceduralGeo = it->second;
+			lock.release();
+			addStaticGeometry( proceduralGeo );
+			return;
+		}
+	}
+#endif
+
 	ToHoudiniGeometryConverterPtr converter = ToHoudiniGeometryConverter::create( renderable.get() );
 	if( !converter ) 
 	{
@@ -200,15 +221,28 @@ void IECoreMantra::ProceduralPrimitive::addVisibleRenderable( VisibleRenderableP
 	}
 	else
 	{
-		msg(Msg::Debug, "IECoreMantra::ProceduralPrimitive::addVisibleRenderable", "MotionBlur:None" );
-		VRAY_ProceduralChildPtr proceduralGeometryChild = createChild();
-		proceduralGeometryChild->addGeometry(proceduralGeo);
-		UT_Matrix4T<float> topTransform = convert< UT_Matrix4T<float> >( m_renderer->m_transformStack.top() );
-		proceduralGeometryChild->setPreTransform( UT_Matrix4T<double>( topTransform ), 0.0f);
-		applySettings(proceduralGeometryChild);
+#if UT_MAJOR_VERSION_INT >= 16
+		if ( cacheable )
+		{
+			RendererImplementation::GeometryCache &cache = *m_renderer->m_geometryCache;
+			tbb::mutex::scoped_lock lock( cache.mutex );
+			cache.geometry.insert( std::make_pair( hash, proceduralGeo ) );
+		}
+#endif
+		addStaticGeometry( proceduralGeo );
 	}
 }
 
+void IECoreMantra::ProceduralPrimitive::addStaticGeometry( VRAY_ProceduralGeo &proceduralGeo )
+{
+	msg(Msg::Debug, "IECoreMantra::ProceduralPrimitive::addVisibleRenderable", "MotionBlur:None" );
+	VRAY_ProceduralChildPtr proceduralGeometryChild = createChild();
+	proceduralGeometryChild->addGeometry(proceduralGeo);
+	UT_Matrix4T<float> topTransform = convert< UT_Matrix4T<float> >( m_renderer->m_transformStack.top() );
+	proceduralGeometryChild->setPreTransform( UT_Matrix4T<double>( topTransform ), 0.0f);
+	applySettings(proceduralGeometryChild);
+}
+
 void IECoreMantra::ProceduralPrimitive::applySettings(VRAY_ProceduralChildPtr child)
 {
 	// Shaders are hidden in the attribute stack with a ':' prefix.
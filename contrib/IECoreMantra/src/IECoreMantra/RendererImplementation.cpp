@@ -151,6 +151,9 @@ IECoreMantra::RendererImplementation::RendererImplementation( ProceduralPrimitiv
 	constructCommon( Procedural );
 	m_vrayproc->m_renderer = this; 
 	m_preWorld = false;
+#if UT_MAJOR_VERSION_INT >= 16
+	m_geometryCache.reset( new GeometryCache );
+#endif
 }
 
 IECoreMantra::RendererImplementation::RendererImplementation(RendererImplementationPtr parent)
@@ -161,7 +164,16 @@ IECoreMantra::RendererImplementation::RendererImplementation(RendererImplementat
 	{
 		m_transformStack.push( parent->m_transformStack.top() );
 		m_attributeStack.push( AttributeState( parent->m_attributeStack.top() ) );
+#if UT_MAJOR_VERSION_INT >= 16
+		m_geometryCache = parent->m_geometryCache;
+#endif
 	}
+#if UT_MAJOR_VERSION_INT >= 16
+	if ( !m_geometryCache )
+	{
+		m_geometryCache.reset( new GeometryCache );
+	}
+#endif
 	m_preWorld = false;
 }
 
@@ -872,7 +884,9 @@ void IECoreMantra::RendererImplementation::mesh( IECore::ConstIntVectorDataPtr v
 	
 	if ( m_mode != Procedural )
 	{
-		m_world->addChild( renderable );
+		// reuse an identical primitive if we have one, so it is only written once
+		WorldPrimitiveMap::const_iterator it = m_worldPrimitives.insert( WorldPrimitiveMap::value_type( mesh->hash(), renderable ) ).first;
+		m_world->addChild( it->second );
 	}
 	else 
 	{
@@ -70,6 +70,46 @@
 	\
 	IECOREGL_CURVESPRIMITIVE_DECLARE_VERTEX_PASS_THROUGH_PARAMETERS
 
+// Tessellation stages. The control shader outputs a patch for each cubic
+// segment, with a level of detail that depends on its length in raster space,
+// and the evaluation shader then generates either lines or ribbons from it.
+
+#define IECOREGL_CURVESPRIMITIVE_DECLARE_TESSELLATION_CONTROL_PARAMETERS \
+	\
+	layout( vertices = 4 ) out;\
+	\
+	uniform float segmentLength;\
+	uniform vec2 viewportSize;\
+	\
+	in vec3 geometryCs[];\
+	\
+	out vec3 tessellationCs[];
+
+#define IECOREGL_CURVESPRIMITIVE_DECLARE_TESSELLATION_VERTEX_PASS_THROUGH_PARAMETERS \
+	in vec3 tessellationCs[];\
+	\
+	out vec3 fragmentCs;
+
+#define IECOREGL_CURVESPRIMITIVE_DECLARE_CUBIC_LINES_TESSELLATION_PARAMETERS \
+	\
+	layout( isolines ) in;\
+	\
+	uniform mat4x4 basis;\
+	\
+	IECOREGL_CURVESPRIMITIVE_DECLARE_TESSELLATION_VERTEX_PASS_THROUGH_PARAMETERS
+
+#define IECOREGL_CURVESPRIMITIVE_DECLARE_CUBIC_RIBBONS_TESSELLATION_PARAMETERS \
+	\
+	layout( quads ) in;\
+	\
+	uniform mat4x4 basis;\
+	uniform float width;\
+	\
+	IECOREGL_CURVESPRIMITIVE_DECLARE_TESSELLATION_VERTEX_PASS_THROUGH_PARAMETERS
+
+#define IECOREGL_CURVESPRIMITIVE_TESSELLATION_LEVEL() \
+	ieCurvesPrimitiveTessellationLevel( segmentLength, viewportSize, float( gl_MaxTessGenLevel ) )
+
 #define IECOREGL_CURVESPRIMITIVE_COEFFICIENTS( t, c0, c1, c2, c3 ) \
 	ieCurvesPrimitiveCoefficients(\
 		basis, t, c0, c1, c2, c3\
@@ -86,6 +126,13 @@
 
 # define IECOREGL_ASSIGN_VERTEX_PASS_THROUGH \
 	fragmentCs = geometryCs[1];
+
+# define IECOREGL_ASSIGN_TESSELLATION_CONTROL_PASS_THROUGH \
+	gl_out[gl_InvocationID].gl_Position = gl_in[gl_InvocationID].gl_Position;\
+	tessellationCs[gl_InvocationID] = geometryCs[gl_InvocationID];
+
+# define IECOREGL_ASSIGN_TESSELLATION_PASS_THROUGH( t ) \
+	fragmentCs = mix( tessellationCs[1], tessellationCs[2], t );
 	
 void ieCurvesPrimitiveCoefficients( in mat4x4 basis, in float t, out float c0, out float c1, out float c2, out float c3 )
 {
@@ -202,4 +249,25 @@ void ieCurvesPrimitiveCubicFrame(
 	ieCurvesPrimitiveUTangentAndNormal( p, vTangent, uTangent, n );
 }
 
+// Returns the number of segments needed for the current patch so that
+// each spans roughly segmentLength pixels, using the length of the control
+// hull as a conservative estimate of the length of the curve.
+float ieCurvesPrimitiveTessellationLevel( in float segmentLength, in vec2 viewportSize, in float maxLevel )
+{
+	vec2 raster[4];
+	for( int i = 0; i < 4; i++ )
+	{
+		vec4 p = gl_in[i].gl_Position;
+		if( p.w <= 0.0 )
+		{
+			// behind the camera - we can't measure in raster space
+			return maxLevel;
+		}
+		raster[i] = ( p.xy / p.w ) * 0.5 * viewportSize;
+	}
+
+	float length = distance( raster[0], raster[1] ) + distance( raster[1], raster[2] ) + distance( raster[2], raster[3] );
+	return clamp( ceil( length / max( segmentLength, 1.0 ) ), 1.0, maxLevel );
+}
+
 #endif // IECOREGL_CURVESPRIMITIVE_H
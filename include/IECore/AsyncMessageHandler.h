@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_ASYNCMESSAGEHANDLER_H
+#define IECORE_ASYNCMESSAGEHANDLER_H
+
+#include "boost/scoped_ptr.hpp"
+
+#include "IECore/Export.h"
+#include "IECore/FilteredMessageHandler.h"
+
+namespace IECore
+{
+
+class AsyncMessageHandler;
+IE_CORE_DECLAREPTR( AsyncMessageHandler );
+
+/// A FilteredMessageHandler which returns from handle() immediately, leaving
+/// the output to be performed on a background thread. This makes it suitable
+/// for wrapping slow handlers such as the OStreamMessageHandler when messages
+/// may be emitted from performance critical code - for instance a procedural
+/// issuing a warning for every location it expands.
+///
+/// Messages are passed to the background thread via a bounded concurrent queue,
+/// and should it fill, further messages are discarded rather than blocking the
+/// caller. The background thread outputs only the first occurrence of any
+/// identical messages since the last flush, and limits the number of messages
+/// output per second. Summaries of any messages omitted for these reasons are
+/// output by flush().
+/// \ingroup utilityGroup
+class IECORE_API AsyncMessageHandler : public FilteredMessageHandler
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( AsyncMessageHandler );
+
+		/// Creates a handler which outputs to the specified handler on a
+		/// background thread. A maxMessagesPerSecond of 0 disables rate limiting.
+		AsyncMessageHandler( MessageHandlerPtr handler, size_t maxMessagesPerSecond = 100, size_t queueCapacity = 10000 );
+		/// Flushes any pending messages before stopping the background thread.
+		virtual ~AsyncMessageHandler();
+
+		/// Queues the message for output on the background thread.
+		/// \threading This may be called concurrently from multiple threads.
+		virtual void handle( Level level, const std::string &context, const std::string &message );
+
+		/// Blocks until all messages handled so far have been output, and then
+		/// outputs a summary of any which were omitted.
+		void flush();
+
+	private :
+
+		struct Data;
+		boost::scoped_ptr<Data> m_data;
+
+};
+
+} // namespace IECore
+
+#endif // IECORE_ASYNCMESSAGEHANDLER_H
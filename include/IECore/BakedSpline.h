@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_BAKEDSPLINE_H
+#define IECORE_BAKEDSPLINE_H
+
+#include "IECore/Spline.h"
+#include "IECore/VectorTraits.h"
+
+#include <vector>
+
+namespace IECore
+{
+
+/// A BakedSpline stores a Spline sampled at regular intervals across its
+/// domain, and evaluates it using linear interpolation between the samples.
+/// This avoids the cost of Spline::solve(), which makes it suitable for
+/// evaluating the same spline many times, as is common when generating
+/// colour ramps. The error introduced by the approximation is measured
+/// during construction and is available via the error() method.
+/// \ingroup mathGroup
+template<typename X, typename Y>
+class BakedSpline
+{
+
+	public :
+
+		typedef X XType;
+		typedef Y YType;
+		typedef Spline<X, Y> SplineType;
+		typedef typename SplineType::XInterval XInterval;
+		typedef typename VectorTraits<Y>::BaseType YBaseType;
+
+		/// Samples the spline at numSamples evenly spaced positions across
+		/// its interval. Throws if the spline interval is empty or has zero
+		/// width, or if numSamples is less than 2.
+		BakedSpline( const SplineType &spline, size_t numSamples = 256 );
+
+		/// Returns the range over which the spline was sampled. Values outside
+		/// this range are clamped to it.
+		const XInterval &interval() const;
+		size_t numSamples() const;
+
+		/// Returns the largest absolute difference between the approximation and
+		/// the original spline, taken over all components of Y. This is measured
+		/// midway between each pair of samples, where the error of the linear
+		/// interpolation is greatest for smooth splines.
+		YBaseType error() const;
+
+		/// Returns the approximate value of the spline at x.
+		inline Y operator() ( X x ) const;
+		/// Evaluates the approximation for all values in x, placing the results
+		/// in y. The evaluation is performed in parallel for large arrays.
+		void operator() ( const std::vector<X> &x, std::vector<Y> &y ) const;
+
+	private :
+
+		XInterval m_interval;
+		X m_samplesPerUnit;
+		std::vector<Y> m_samples;
+		YBaseType m_error;
+
+};
+
+typedef BakedSpline<float, float> BakedSplineff;
+typedef BakedSpline<double, double> BakedSplinedd;
+
+typedef BakedSpline<float, Imath::Color3f> BakedSplinefColor3f;
+typedef BakedSpline<float, Imath::Color4f> BakedSplinefColor4f;
+
+} // namespace IECore
+
+#include "IECore/BakedSpline.inl"
+
+#endif // IECORE_BAKEDSPLINE_H
@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_BAKEDSPLINE_INL
+#define IECORE_BAKEDSPLINE_INL
+
+#include "IECore/Exception.h"
+
+#include "OpenEXR/ImathMath.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include <algorithm>
+
+namespace IECore
+{
+
+namespace Detail
+{
+
+template<typename X, typename Y>
+class BakedSplineSampler
+{
+
+	public :
+
+		BakedSplineSampler( const Spline<X, Y> &spline, X start, X step, std::vector<Y> &samples )
+			:	m_spline( spline ), m_start( start ), m_step( step ), m_samples( samples )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				m_samples[i] = m_spline( m_start + m_step * X( i ) );
+			}
+		}
+
+	private :
+
+		const Spline<X, Y> &m_spline;
+		X m_start;
+		X m_step;
+		std::vector<Y> &m_samples;
+
+};
+
+template<typename X, typename Y>
+class BakedSplineEvaluator
+{
+
+	public :
+
+		BakedSplineEvaluator( const BakedSpline<X, Y> &spline, const std::vector<X> &x, std::vector<Y> &y )
+			:	m_spline( spline ), m_x( x ), m_y( y )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				m_y[i] = m_spline( m_x[i] );
+			}
+		}
+
+	private :
+
+		const BakedSpline<X, Y> &m_spline;
+		const std::vector<X> &m_x;
+		std::vector<Y> &m_y;
+
+};
+
+} // namespace Detail
+
+template<typename X, typename Y>
+BakedSpline<X,Y>::BakedSpline( const SplineType &spline, size_t numSamples )
+	:	m_interval( spline.interval() ), m_error( 0 )
+{
+	if( boost::numeric::empty( m_interval ) || boost::numeric::width( m_interval ) <= X( 0 ) )
+	{
+		throw InvalidArgumentException( "Spline interval is empty or has zero width." );
+	}
+	if( numSamples < 2 )
+	{
+		throw InvalidArgumentException( "BakedSpline requires at least 2 samples." );
+	}
+
+	const X step = boost::numeric::width( m_interval ) / X( numSamples - 1 );
+	m_samplesPerUnit = X( 1 ) / step;
+
+	m_samples.resize( numSamples );
+	Detail::BakedSplineSampler<X, Y> sampler( spline, m_interval.lower(), step, m_samples );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, numSamples, 64 ), sampler );
+
+	// measure the error midway between each pair of samples
+	std::vector<Y> midpoints( numSamples - 1 );
+	Detail::BakedSplineSampler<X, Y> midpointSampler( spline, m_interval.lower() + step / X( 2 ), step, midpoints );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, numSamples - 1, 64 ), midpointSampler );
+
+	typedef VectorTraits<Y> YTraits;
+	for( size_t i = 0; i < midpoints.size(); ++i )
+	{
+		const Y approximation = ( m_samples[i] + m_samples[i+1] ) / X( 2 );
+		for( unsigned c = 0; c < YTraits::dimensions(); ++c )
+		{
+			const YBaseType e = Imath::Math<YBaseType>::fabs( YTraits::get( approximation, c ) - YTraits::get( midpoints[i], c ) );
+			m_error = std::max( m_error, e );
+		}
+	}
+}
+
+template<typename X, typename Y>
+const typename BakedSpline<X,Y>::XInterval &BakedSpline<X,Y>::interval() const
+{
+	return m_interval;
+}
+
+template<typename X, typename Y>
+size_t BakedSpline<X,Y>::numSamples() const
+{
+	return m_samples.size();
+}
+
+template<typename X, typename Y>
+typename BakedSpline<X,Y>::YBaseType BakedSpline<X,Y>::error() const
+{
+	return m_error;
+}
+
+template<typename X, typename Y>
+inline Y BakedSpline<X,Y>::operator() ( X x ) const
+{
+	const X f = ( x - m_interval.lower() ) * m_samplesPerUnit;
+	if( !( f > X( 0 ) ) )
+	{
+		return m_samples.front();
+	}
+
+	if( f >= X( m_samples.size() - 1 ) )
+	{
+		return m_samples.back();
+	}
+
+	const size_t i = static_cast<size_t>( f );
+	const X t = f - X( i );
+	return m_samples[i] * ( X( 1 ) - t ) + m_samples[i+1] * t;
+}
+
+template<typename X, typename Y>
+void BakedSpline<X,Y>::operator() ( const std::vector<X> &x, std::vector<Y> &y ) const
+{
+	y.resize( x.size() );
+	Detail::BakedSplineEvaluator<X, Y> evaluator( *this, x, y );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, x.size(), 4096 ), evaluator );
+}
+
+} // namespace IECore
+
+#endif // IECORE_BAKEDSPLINE_INL
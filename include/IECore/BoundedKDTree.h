@@ -37,6 +37,8 @@
 
 #include <vector>
 
+#include "tbb/cache_aligned_allocator.h"
+
 #include "OpenEXR/ImathBox.h"
 
 #include "IECore/BoxTraits.h"
@@ -45,6 +47,9 @@ namespace IECore
 {
 
 /// Builds a KDTree of bounded volumes to permit fast intersection/overlap tests.
+/// Nodes are stored in a single cache aligned array, with the children of each
+/// node found implicitly from its index, and leaves referencing their bounds by
+/// offset rather than by pointer to keep the nodes small.
 /// \ingroup mathGroup
 template<class BoundIterator>
 class BoundedKDTree
@@ -55,7 +60,7 @@ class BoundedKDTree
 		typedef typename std::iterator_traits<BoundIterator>::value_type Bound;
 		typedef typename BoxTraits<Bound>::BaseType BaseType;
 		class Node;
-		typedef std::vector<Node> NodeVector;
+		typedef std::vector<Node, tbb::cache_aligned_allocator<Node> > NodeVector;
 		typedef typename NodeVector::size_type NodeIndex;
 
 		/// Construncts an uninitialised tree - you must call init() before
@@ -71,6 +76,8 @@ class BoundedKDTree
 		/// Builds the tree for the specified bounds - the iterator range
 		/// must remain valid and unchanged as long as the tree is in use.
 		/// This method can be called again to rebuild the tree at any time.
+		/// Large trees are built using multiple threads. The maxLeafSize is
+		/// limited to 65535.
 		/// \threading This can't be called while other threads are
 		/// making queries.
 		void init( BoundIterator first, BoundIterator last, int maxLeafSize=4 );
@@ -96,6 +103,13 @@ class BoundedKDTree
 		/// Retrieve the index of the "high" child node
 		static NodeIndex highChildIndex( NodeIndex index );
 
+		/// Returns a pointer to an iterator referencing the first
+		/// bound in the specified leaf node.
+		inline const BoundIterator *permFirst( NodeIndex index ) const;
+		/// Returns a pointer to an iterator referencing one past the
+		/// last bound in the specified leaf node.
+		inline const BoundIterator *permLast( NodeIndex index ) const;
+
 	private:
 
 		typedef std::vector<BoundIterator> Permutation;
@@ -103,10 +117,11 @@ class BoundedKDTree
 		typedef typename Permutation::const_iterator PermutationConstIterator;
 
 		class AxisSort;
+		class BuildTask;
 
-		unsigned char majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast );
+		unsigned char majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast ) const;
+		NodeIndex maxNodeIndex( NodeIndex nodeIndex, NodeIndex numBounds ) const;
 		void build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast );
-		void bound( NodeIndex nodeIndex );
 
 		template<typename S>
 		void intersectingBoundsWalk( NodeIndex nodeIndex, const S &p, std::vector<BoundIterator> &bounds ) const;
@@ -127,10 +142,6 @@ class BoundedKDTree<BoundIterator>::Node
 
 		inline bool isLeaf() const;
 
-		inline BoundIterator *permFirst() const;
-
-		inline BoundIterator *permLast() const;
-
 		inline bool isBranch() const;
 
 		inline unsigned char cutAxis() const;
@@ -141,23 +152,18 @@ class BoundedKDTree<BoundIterator>::Node
 
 		friend class BoundedKDTree<BoundIterator>;
 
-		inline void makeLeaf( PermutationIterator permFirst, PermutationIterator permLast );
+		inline void makeLeaf( unsigned int permOffset, unsigned short permSize );
 		inline void makeBranch( unsigned char cutAxis );
 
 		inline Bound &bound();
 
-		unsigned char m_cutAxisAndLeaf;
-
+		// Ordered largest first so that a Box3f node packs into 32 bytes,
+		// and two nodes fit in each cache line.
 		Bound m_bound;
-
-		struct
-		{
-			/// \todo Could this be 0 for branch nodes? This could allow us to remove m_cutAxisAndLeaf.
-			BoundIterator *first;
-			/// \todo Could we just store an offset instead of last? If we limit the maxLeafSize to 255
-			/// then this could be a single byte instead of 8 bytes.
-			BoundIterator *last;
-		} m_perm;
+		// For leaves, the range of m_perm holding our bounds.
+		unsigned int m_permOffset;
+		unsigned short m_permSize;
+		unsigned char m_cutAxisAndLeaf;
 };
 
 typedef BoundedKDTree<std::vector<Imath::Box2f>::const_iterator> Box2fTree;
@@ -35,6 +35,8 @@
 #include <algorithm>
 #include <cassert>
 
+#include "tbb/parallel_invoke.h"
+
 #include "IECore/VectorTraits.h"
 #include "IECore/VectorOps.h"
 #include "IECore/BoxOps.h"
@@ -42,6 +44,16 @@
 namespace IECore
 {
 
+namespace Detail
+{
+
+// Subtrees with more bounds than this are built in parallel.
+static const size_t g_boundedKDTreeParallelBuildThreshold = 4096;
+// Imposed by the size of Node::m_permSize.
+static const int g_boundedKDTreeMaxLeafSize = 65535;
+
+} // namespace Detail
+
 template<class BoundIterator>
 class BoundedKDTree<BoundIterator>::AxisSort
 {
@@ -60,21 +72,41 @@ class BoundedKDTree<BoundIterator>::AxisSort
 		const unsigned int m_axis;
 };
 
+template<class BoundIterator>
+class BoundedKDTree<BoundIterator>::BuildTask
+{
+	public :
+
+		BuildTask( BoundedKDTree *tree, NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
+			:	m_tree( tree ), m_nodeIndex( nodeIndex ), m_permFirst( permFirst ), m_permLast( permLast )
+		{
+		}
+
+		void operator()() const
+		{
+			m_tree->build( m_nodeIndex, m_permFirst, m_permLast );
+		}
+
+	private :
+
+		BoundedKDTree *m_tree;
+		NodeIndex m_nodeIndex;
+		PermutationIterator m_permFirst;
+		PermutationIterator m_permLast;
+};
 
 template<class BoundIterator>
-BoundedKDTree<BoundIterator>::Node::Node() : m_cutAxisAndLeaf(0)
+BoundedKDTree<BoundIterator>::Node::Node() : m_permOffset( 0 ), m_permSize( 0 ), m_cutAxisAndLeaf( 0 )
 {
 	BoxTraits<Bound>::makeEmpty( m_bound );
-	m_perm.first = 0;
-	m_perm.last = 0;
 }
 
 template<class BoundIterator>
-void BoundedKDTree<BoundIterator>::Node::makeLeaf( PermutationIterator permFirst, PermutationIterator permLast )
+void BoundedKDTree<BoundIterator>::Node::makeLeaf( unsigned int permOffset, unsigned short permSize )
 {
 	m_cutAxisAndLeaf = 255;
-	m_perm.first = &(*permFirst);
-	m_perm.last = &(*permLast);
+	m_permOffset = permOffset;
+	m_permSize = permSize;
 }
 
 template<class BoundIterator>
@@ -89,22 +121,6 @@ bool BoundedKDTree<BoundIterator>::Node::isLeaf() const
 	return m_cutAxisAndLeaf==255;
 }
 
-template<class BoundIterator>
-BoundIterator *BoundedKDTree<BoundIterator>::Node::permFirst() const
-{
-	assert( isLeaf() );
-
-	return m_perm.first;
-}
-
-template<class BoundIterator>
-BoundIterator *BoundedKDTree<BoundIterator>::Node::permLast() const
-{
-	assert( isLeaf() );
-
-	return m_perm.last;
-}
-
 template<class BoundIterator>
 bool BoundedKDTree<BoundIterator>::Node::isBranch() const
 {
@@ -132,7 +148,7 @@ const typename BoundedKDTree<BoundIterator>::Bound &BoundedKDTree<BoundIterator>
 }
 
 template<class BoundIterator>
-unsigned char BoundedKDTree<BoundIterator>::majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast )
+unsigned char BoundedKDTree<BoundIterator>::majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast ) const
 {
 	BaseType min, max;
 	vecSetAll( min, Imath::limits<typename BaseType::BaseType>::max() );
@@ -148,7 +164,7 @@ unsigned char BoundedKDTree<BoundIterator>::majorAxis( PermutationConstIterator
 			{
 				VectorTraits<BaseType>::set(min, i, VectorTraits<BaseType>::get(center, i) );
 			}
-			if( VectorTraits<BaseType>::get(center, i) > VectorTraits<BaseType>::get(min, i) )
+			if( VectorTraits<BaseType>::get(center, i) > VectorTraits<BaseType>::get(max, i) )
 			{
 				VectorTraits<BaseType>::set(max, i, VectorTraits<BaseType>::get(center, i) );
 			}
@@ -169,49 +185,28 @@ unsigned char BoundedKDTree<BoundIterator>::majorAxis( PermutationConstIterator
 }
 
 template<class BoundIterator>
-void BoundedKDTree<BoundIterator>::bound( NodeIndex nodeIndex  )
+typename BoundedKDTree<BoundIterator>::NodeIndex BoundedKDTree<BoundIterator>::maxNodeIndex( NodeIndex nodeIndex, NodeIndex numBounds ) const
 {
-	assert( nodeIndex < m_nodes.size() );
-
-	Node &node = m_nodes[nodeIndex];
-
-	assert( BoxTraits<Bound>::isEmpty( node.bound() ) );
-
-	if( node.isLeaf() )
+	// mirrors the splitting performed by build()
+	if( numBounds > (NodeIndex)m_maxLeafSize )
 	{
-		BoundIterator *permLast = node.permLast();
-		for( BoundIterator *perm = node.permFirst(); perm!=permLast; perm++ )
-		{
-			boxExtend( node.bound(), **perm );
-		}
-	}
-	else
-	{
-		assert( node.isBranch() );
-
-		assert( lowChildIndex( nodeIndex ) < m_nodes.size() );
-		assert( highChildIndex( nodeIndex ) < m_nodes.size() );
-
-		bound( lowChildIndex( nodeIndex ) );
-		bound( highChildIndex( nodeIndex ) );
-		boxExtend( node.bound(), m_nodes[lowChildIndex( nodeIndex )].bound() );
-		boxExtend( node.bound(), m_nodes[highChildIndex( nodeIndex )].bound() );
+		const NodeIndex numLow = numBounds / 2;
+		return std::max(
+			maxNodeIndex( lowChildIndex( nodeIndex ), numLow ),
+			maxNodeIndex( highChildIndex( nodeIndex ), numBounds - numLow )
+		);
 	}
+	return nodeIndex;
 }
 
-
 template<class BoundIterator>
 void BoundedKDTree<BoundIterator>::build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
 {
-	// make room for the new node
-	if( nodeIndex>=m_nodes.size() )
-	{
-		m_nodes.resize( nodeIndex+1 );
-	}
-
+	// init() has already made room for all the nodes
 	assert( nodeIndex < m_nodes.size() );
 
 	Node &node = m_nodes[nodeIndex];
+	assert( BoxTraits<Bound>::isEmpty( node.bound() ) );
 
 	if( permLast - permFirst > m_maxLeafSize )
 	{
@@ -222,13 +217,32 @@ void BoundedKDTree<BoundIterator>::build( NodeIndex nodeIndex, PermutationIterat
 		// insert node
 		node.makeBranch( cutAxis );
 
-		build( lowChildIndex( nodeIndex ), permFirst, permMid );
-		build( highChildIndex( nodeIndex ), permMid, permLast );
+		if( (size_t)( permLast - permFirst ) > Detail::g_boundedKDTreeParallelBuildThreshold )
+		{
+			// the two halves of the permutation and the two subtrees
+			// are entirely disjoint, so can be built concurrently.
+			tbb::parallel_invoke(
+				BuildTask( this, lowChildIndex( nodeIndex ), permFirst, permMid ),
+				BuildTask( this, highChildIndex( nodeIndex ), permMid, permLast )
+			);
+		}
+		else
+		{
+			build( lowChildIndex( nodeIndex ), permFirst, permMid );
+			build( highChildIndex( nodeIndex ), permMid, permLast );
+		}
+
+		boxExtend( node.bound(), m_nodes[lowChildIndex( nodeIndex )].bound() );
+		boxExtend( node.bound(), m_nodes[highChildIndex( nodeIndex )].bound() );
 	}
 	else
 	{
 		// leaf node
-		node.makeLeaf( permFirst, permLast );
+		node.makeLeaf( permFirst - m_perm.begin(), permLast - permFirst );
+		for( PermutationIterator perm = permFirst; perm != permLast; ++perm )
+		{
+			boxExtend( node.bound(), **perm );
+		}
 	}
 }
 
@@ -246,7 +260,7 @@ BoundedKDTree<BoundIterator>::BoundedKDTree( BoundIterator first, BoundIterator
 template<class BoundIterator>
 void BoundedKDTree<BoundIterator>::init( BoundIterator first, BoundIterator last, int maxLeafSize )
 {
-	m_maxLeafSize = maxLeafSize;
+	m_maxLeafSize = std::min( maxLeafSize, Detail::g_boundedKDTreeMaxLeafSize );
 	m_lastBound = last;
 	
 	m_perm.resize( last - first );
@@ -256,9 +270,11 @@ void BoundedKDTree<BoundIterator>::init( BoundIterator first, BoundIterator last
 		m_perm[i++] = it;
 	}
 
-	/// \todo Can we reserve() enough space for m_nodes before doing this?
+	// size m_nodes up front, so that subtrees can be built concurrently
+	// without reallocating the vector underneath each other.
+	m_nodes.clear();
+	m_nodes.resize( maxNodeIndex( rootIndex(), m_perm.size() ) + 1 );
 	build( rootIndex(), m_perm.begin(), m_perm.end() );
-	bound( rootIndex() );
 }
 
 template<class BoundIterator>
@@ -294,6 +310,21 @@ typename BoundedKDTree<BoundIterator>::NodeIndex BoundedKDTree<BoundIterator>::h
 	return index * 2 + 1;
 }
 
+template<class BoundIterator>
+const BoundIterator *BoundedKDTree<BoundIterator>::permFirst( NodeIndex index ) const
+{
+	assert( m_nodes[index].isLeaf() );
+
+	// avoid indexing an empty permutation
+	return m_perm.empty() ? 0 : &m_perm[0] + m_nodes[index].m_permOffset;
+}
+
+template<class BoundIterator>
+const BoundIterator *BoundedKDTree<BoundIterator>::permLast( NodeIndex index ) const
+{
+	return permFirst( index ) + m_nodes[index].m_permSize;
+}
+
 template<class BoundIterator>
 template<typename S>
 unsigned int BoundedKDTree<BoundIterator>::intersectingBounds( const S &b, std::vector<BoundIterator> &bounds ) const
@@ -312,8 +343,8 @@ void BoundedKDTree<BoundIterator>::intersectingBoundsWalk(  NodeIndex nodeIndex,
 	const Node &node = m_nodes[nodeIndex];
 	if( node.isLeaf() )
 	{
-		BoundIterator *permLast = node.permLast();
-		for( BoundIterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const BoundIterator *permLast = this->permLast( nodeIndex );
+		for( const BoundIterator *perm = permFirst( nodeIndex ); perm!=permLast; perm++ )
 		{
 			const Bound &bb = **perm;
 
@@ -0,0 +1,180 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_BOUNDINGVOLUMEHIERARCHY_H
+#define IECORE_BOUNDINGVOLUMEHIERARCHY_H
+
+#include <vector>
+
+#include "OpenEXR/ImathBox.h"
+
+#include "IECore/BoxTraits.h"
+#include "IECore/VectorTraits.h"
+
+namespace IECore
+{
+
+/// Builds a bounding volume hierarchy over a range of bounds, to permit fast
+/// intersection/overlap tests. This serves the same purpose as BoundedKDTree,
+/// but rather than always splitting at the median the splits are chosen using
+/// the surface area heuristic, which adapts the tree to the distribution of
+/// the bounds and gives significantly faster ray queries. The nodes are stored
+/// depth first in a single compact array, with the low child of a branch always
+/// immediately following it, and the build is spread across multiple threads.
+/// \ingroup mathGroup
+template<class BoundIterator>
+class BoundingVolumeHierarchy
+{
+	public:
+
+		typedef BoundIterator Iterator;
+		typedef typename std::iterator_traits<BoundIterator>::value_type Bound;
+		typedef typename BoxTraits<Bound>::BaseType BaseType;
+		class Node;
+		typedef std::vector<Node> NodeVector;
+		typedef typename NodeVector::size_type NodeIndex;
+
+		/// The maximum depth of any leaf below the root. Traversals may therefore
+		/// use a fixed size stack of maxDepth + 1 entries.
+		static const int maxDepth = 96;
+
+		/// Constructs an uninitialised hierarchy - you must call init() before
+		/// using it.
+		BoundingVolumeHierarchy();
+
+		/// Creates a hierarchy for the fast searching of bounds.
+		/// Note that the hierarchy does not own the passed bounds -
+		/// it is up to you to ensure that they remain valid and
+		/// unchanged as long as the BoundingVolumeHierarchy is in use.
+		BoundingVolumeHierarchy( BoundIterator first, BoundIterator last, int maxLeafSize=4 );
+
+		/// Builds the hierarchy for the specified bounds - the iterator range
+		/// must remain valid and unchanged as long as the hierarchy is in use.
+		/// This method can be called again to rebuild the hierarchy at any time.
+		/// \threading This can't be called while other threads are
+		/// making queries.
+		void init( BoundIterator first, BoundIterator last, int maxLeafSize=4 );
+
+		/// Populates the passed vector of iterators with the bounds which intersect "b". Returns the number of bounds found.
+		/// \threading May be called by multiple concurrent threads provided they each use a different vector for the result.
+		template<typename S>
+		unsigned int intersectingBounds( const S &b, std::vector<BoundIterator> &bounds ) const;
+
+		/// Returns the number of nodes in the hierarchy.
+		inline NodeIndex numNodes() const;
+
+		/// Retrieve the node associated with a given index.
+		inline const Node &node( NodeIndex index ) const;
+
+		/// Returns the index for the root node.
+		inline NodeIndex rootIndex() const;
+
+		/// Retrieve the index of the "low" child of a branch node.
+		inline NodeIndex lowChildIndex( NodeIndex index ) const;
+
+		/// Retrieve the index of the "high" child of a branch node.
+		inline NodeIndex highChildIndex( NodeIndex index ) const;
+
+		/// Retrieve the range of bounds held by a leaf node.
+		inline const BoundIterator *permFirst( NodeIndex index ) const;
+		inline const BoundIterator *permLast( NodeIndex index ) const;
+
+	private:
+
+		typedef std::vector<BoundIterator> Permutation;
+		typedef typename Permutation::iterator PermutationIterator;
+		typedef typename VectorTraits<BaseType>::BaseType ScalarType;
+
+		class AxisSort;
+		class BinPredicate;
+		class BuildTask;
+
+		void build( NodeVector &nodes, NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast, int depth ) const;
+		PermutationIterator split( PermutationIterator permFirst, PermutationIterator permLast, const Bound &centroidBound, int depth, unsigned char &cutAxis ) const;
+		NodeIndex countNodes( const NodeVector &nodes, NodeIndex nodeIndex ) const;
+		NodeIndex compact( const NodeVector &nodes, NodeIndex nodeIndex );
+
+		static ScalarType halfArea( const Bound &b );
+
+		template<typename S>
+		void intersectingBoundsWalk( NodeIndex nodeIndex, const S &b, std::vector<BoundIterator> &bounds ) const;
+
+		Permutation m_perm;
+		NodeVector m_nodes;
+		int m_maxLeafSize;
+
+};
+
+template<class BoundIterator>
+class BoundingVolumeHierarchy<BoundIterator>::Node
+{
+	public :
+
+		/// Must be default constructible for use as element within std::vector
+		Node();
+
+		inline bool isLeaf() const;
+
+		inline bool isBranch() const;
+
+		/// The axis along which the children of a branch were split.
+		inline unsigned char cutAxis() const;
+
+		inline const Bound &bound() const;
+
+	private :
+
+		friend class BoundingVolumeHierarchy<BoundIterator>;
+
+		Bound m_bound;
+		// The index of the high child for branches, and the
+		// index of the first permutation entry for leaves.
+		unsigned int m_offset;
+		// The number of bounds in a leaf.
+		unsigned short m_count;
+		// The cut axis for branches, or 255 for leaves.
+		unsigned char m_cutAxis;
+
+};
+
+typedef BoundingVolumeHierarchy<std::vector<Imath::Box2f>::const_iterator> Box2fBVH;
+typedef BoundingVolumeHierarchy<std::vector<Imath::Box2d>::const_iterator> Box2dBVH;
+typedef BoundingVolumeHierarchy<std::vector<Imath::Box3f>::const_iterator> Box3fBVH;
+typedef BoundingVolumeHierarchy<std::vector<Imath::Box3d>::const_iterator> Box3dBVH;
+
+} // namespace IECore
+
+#include "IECore/BoundingVolumeHierarchy.inl"
+
+#endif // IECORE_BOUNDINGVOLUMEHIERARCHY_H
@@ -0,0 +1,495 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+
+#include "tbb/parallel_invoke.h"
+
+#include "IECore/VectorOps.h"
+#include "IECore/BoxOps.h"
+
+namespace IECore
+{
+
+namespace Detail
+{
+
+// Subtrees with more bounds than this are built in parallel.
+static const size_t g_bvhParallelBuildThreshold = 4096;
+// The number of buckets used to evaluate the surface area heuristic.
+static const int g_bvhNumBins = 16;
+// Beyond this depth we split at the median rather than using the surface
+// area heuristic, to guarantee that the depth stays within maxDepth even
+// for pathological distributions of bounds.
+static const int g_bvhMaxHeuristicDepth = 64;
+
+} // namespace Detail
+
+template<class BoundIterator>
+class BoundingVolumeHierarchy<BoundIterator>::AxisSort
+{
+	public :
+
+		AxisSort( unsigned int axis ) : m_axis( axis )
+		{
+		}
+
+		bool operator() ( BoundIterator i, BoundIterator j ) const
+		{
+			return VectorTraits<BaseType>::get( boxCenter( *i ), m_axis )
+				< VectorTraits<BaseType>::get( boxCenter( *j ), m_axis );
+		}
+
+	private :
+
+		const unsigned int m_axis;
+
+};
+
+// Maps the centre of a bound to one of the buckets used for the surface area
+// heuristic, and returns true for those which belong in the low child.
+template<class BoundIterator>
+class BoundingVolumeHierarchy<BoundIterator>::BinPredicate
+{
+
+	public :
+
+		BinPredicate( unsigned int axis, ScalarType min, ScalarType scale, int splitBin = 0 )
+			:	m_axis( axis ), m_min( min ), m_scale( scale ), m_splitBin( splitBin )
+		{
+		}
+
+		int bin( BoundIterator i ) const
+		{
+			const ScalarType c = VectorTraits<BaseType>::get( boxCenter( *i ), m_axis );
+			return std::max( 0, std::min( (int)( ( c - m_min ) * m_scale ), Detail::g_bvhNumBins - 1 ) );
+		}
+
+		bool operator() ( BoundIterator i ) const
+		{
+			return bin( i ) <= m_splitBin;
+		}
+
+	private :
+
+		unsigned int m_axis;
+		ScalarType m_min;
+		ScalarType m_scale;
+		int m_splitBin;
+
+};
+
+template<class BoundIterator>
+class BoundingVolumeHierarchy<BoundIterator>::BuildTask
+{
+
+	public :
+
+		BuildTask( const BoundingVolumeHierarchy *hierarchy, NodeVector &nodes, NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast, int depth )
+			:	m_hierarchy( hierarchy ), m_nodes( nodes ), m_nodeIndex( nodeIndex ), m_permFirst( permFirst ), m_permLast( permLast ), m_depth( depth )
+		{
+		}
+
+		void operator()() const
+		{
+			m_hierarchy->build( m_nodes, m_nodeIndex, m_permFirst, m_permLast, m_depth );
+		}
+
+	private :
+
+		const BoundingVolumeHierarchy *m_hierarchy;
+		NodeVector &m_nodes;
+		NodeIndex m_nodeIndex;
+		PermutationIterator m_permFirst;
+		PermutationIterator m_permLast;
+		int m_depth;
+
+};
+
+template<class BoundIterator>
+BoundingVolumeHierarchy<BoundIterator>::Node::Node()
+	:	m_offset( 0 ), m_count( 0 ), m_cutAxis( 255 )
+{
+	BoxTraits<Bound>::makeEmpty( m_bound );
+}
+
+template<class BoundIterator>
+bool BoundingVolumeHierarchy<BoundIterator>::Node::isLeaf() const
+{
+	return m_cutAxis == 255;
+}
+
+template<class BoundIterator>
+bool BoundingVolumeHierarchy<BoundIterator>::Node::isBranch() const
+{
+	return m_cutAxis != 255;
+}
+
+template<class BoundIterator>
+unsigned char BoundingVolumeHierarchy<BoundIterator>::Node::cutAxis() const
+{
+	assert( isBranch() );
+	return m_cutAxis;
+}
+
+template<class BoundIterator>
+const typename BoundingVolumeHierarchy<BoundIterator>::Bound &BoundingVolumeHierarchy<BoundIterator>::Node::bound() const
+{
+	return m_bound;
+}
+
+template<class BoundIterator>
+BoundingVolumeHierarchy<BoundIterator>::BoundingVolumeHierarchy()
+	:	m_maxLeafSize( 4 )
+{
+}
+
+template<class BoundIterator>
+BoundingVolumeHierarchy<BoundIterator>::BoundingVolumeHierarchy( BoundIterator first, BoundIterator last, int maxLeafSize )
+{
+	init( first, last, maxLeafSize );
+}
+
+template<class BoundIterator>
+void BoundingVolumeHierarchy<BoundIterator>::init( BoundIterator first, BoundIterator last, int maxLeafSize )
+{
+	m_maxLeafSize = std::max( 1, std::min( maxLeafSize, 65535 ) );
+
+	m_perm.clear();
+	m_perm.reserve( last - first );
+	for( BoundIterator it=first; it!=last; it++ )
+	{
+		m_perm.push_back( it );
+	}
+
+	m_nodes.clear();
+	if( m_perm.empty() )
+	{
+		// a single empty leaf
+		m_nodes.resize( 1 );
+		return;
+	}
+
+	// Each split produces two non-empty children, so a subtree holding N
+	// bounds never has more than 2N - 1 nodes. We reserve exactly that many
+	// slots for each subtree in a scratch array, so that the subtrees can
+	// be built in parallel without any synchronisation, and then compact
+	// the result into depth first order.
+	NodeVector scratch( 2 * m_perm.size() - 1 );
+	build( scratch, 0, m_perm.begin(), m_perm.end(), 0 );
+
+	m_nodes.reserve( countNodes( scratch, 0 ) );
+	compact( scratch, 0 );
+}
+
+template<class BoundIterator>
+void BoundingVolumeHierarchy<BoundIterator>::build( NodeVector &nodes, NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast, int depth ) const
+{
+	assert( nodeIndex < nodes.size() );
+	assert( permLast > permFirst );
+
+	Node &node = nodes[nodeIndex];
+
+	Bound centroidBound;
+	BoxTraits<Bound>::makeEmpty( centroidBound );
+	for( PermutationIterator it = permFirst; it != permLast; ++it )
+	{
+		boxExtend( node.m_bound, **it );
+		boxExtend( centroidBound, boxCenter( **it ) );
+	}
+
+	const NodeIndex count = permLast - permFirst;
+	if( count <= (NodeIndex)m_maxLeafSize )
+	{
+		node.m_offset = permFirst - m_perm.begin();
+		node.m_count = count;
+		return;
+	}
+
+	PermutationIterator permMid = split( permFirst, permLast, centroidBound, depth, node.m_cutAxis );
+	assert( permMid > permFirst && permMid < permLast );
+
+	// the low subtree fills at most the next 2 * lowCount - 1 slots,
+	// and the high subtree follows on from those.
+	const NodeIndex lowIndex = nodeIndex + 1;
+	const NodeIndex highIndex = nodeIndex + 2 * ( permMid - permFirst );
+	node.m_offset = highIndex;
+
+	if( count > Detail::g_bvhParallelBuildThreshold )
+	{
+		tbb::parallel_invoke(
+			BuildTask( this, nodes, lowIndex, permFirst, permMid, depth + 1 ),
+			BuildTask( this, nodes, highIndex, permMid, permLast, depth + 1 )
+		);
+	}
+	else
+	{
+		build( nodes, lowIndex, permFirst, permMid, depth + 1 );
+		build( nodes, highIndex, permMid, permLast, depth + 1 );
+	}
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::PermutationIterator BoundingVolumeHierarchy<BoundIterator>::split( PermutationIterator permFirst, PermutationIterator permLast, const Bound &centroidBound, int depth, unsigned char &cutAxis ) const
+{
+	cutAxis = boxMajorAxis( centroidBound );
+	const ScalarType min = VectorTraits<BaseType>::get( centroidBound.min, cutAxis );
+	const ScalarType extent = VectorTraits<BaseType>::get( centroidBound.max, cutAxis ) - min;
+
+	if( extent <= ScalarType( 0 ) || depth >= Detail::g_bvhMaxHeuristicDepth )
+	{
+		// Either all the centres are coincident, in which case no split
+		// is better than any other, or we've gone deep enough that we need
+		// to guarantee a balanced split. Split at the median.
+		PermutationIterator permMid = permFirst + ( permLast - permFirst ) / 2;
+		std::nth_element( permFirst, permMid, permLast, AxisSort( cutAxis ) );
+		return permMid;
+	}
+
+	// Bucket the bounds according to the position of their centres
+	// along the cut axis.
+
+	const BinPredicate binner( cutAxis, min, ScalarType( Detail::g_bvhNumBins ) / extent );
+
+	size_t binCounts[Detail::g_bvhNumBins];
+	Bound binBounds[Detail::g_bvhNumBins];
+	for( int i = 0; i < Detail::g_bvhNumBins; ++i )
+	{
+		binCounts[i] = 0;
+		BoxTraits<Bound>::makeEmpty( binBounds[i] );
+	}
+
+	for( PermutationIterator it = permFirst; it != permLast; ++it )
+	{
+		const int b = binner.bin( *it );
+		binCounts[b]++;
+		boxExtend( binBounds[b], **it );
+	}
+
+	// Sweep from the high end, recording the cost of everything
+	// above each potential split, then sweep from the low end to
+	// find the split with the lowest total cost. Empty buckets are
+	// skipped when accumulating areas, because the area of an empty
+	// box is meaningless.
+
+	ScalarType highCosts[Detail::g_bvhNumBins];
+	Bound accumulatedBound;
+	BoxTraits<Bound>::makeEmpty( accumulatedBound );
+	size_t accumulatedCount = 0;
+	for( int i = Detail::g_bvhNumBins - 1; i > 0; --i )
+	{
+		if( binCounts[i] )
+		{
+			boxExtend( accumulatedBound, binBounds[i] );
+			accumulatedCount += binCounts[i];
+		}
+		highCosts[i] = accumulatedCount ? halfArea( accumulatedBound ) * accumulatedCount : ScalarType( 0 );
+	}
+
+	int splitBin = 0;
+	ScalarType bestCost = Imath::limits<ScalarType>::max();
+	BoxTraits<Bound>::makeEmpty( accumulatedBound );
+	accumulatedCount = 0;
+	for( int i = 0; i < Detail::g_bvhNumBins - 1; ++i )
+	{
+		if( binCounts[i] )
+		{
+			boxExtend( accumulatedBound, binBounds[i] );
+			accumulatedCount += binCounts[i];
+		}
+		if( !accumulatedCount || accumulatedCount == (size_t)( permLast - permFirst ) )
+		{
+			continue;
+		}
+		const ScalarType cost = halfArea( accumulatedBound ) * accumulatedCount + highCosts[i+1];
+		if( cost < bestCost )
+		{
+			bestCost = cost;
+			splitBin = i;
+		}
+	}
+
+	// The lowest and highest centres always fall in the first and last
+	// buckets, so both sides of any split are guaranteed to be non-empty.
+	return std::partition( permFirst, permLast, BinPredicate( cutAxis, min, ScalarType( Detail::g_bvhNumBins ) / extent, splitBin ) );
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::ScalarType BoundingVolumeHierarchy<BoundIterator>::halfArea( const Bound &b )
+{
+	BaseType size;
+	vecSub( b.max, b.min, size );
+
+	const unsigned int dimensions = VectorTraits<BaseType>::dimensions();
+	if( dimensions < 3 )
+	{
+		// the "area" of a 2d bound is proportional to its perimeter
+		ScalarType result( 0 );
+		for( unsigned int i = 0; i < dimensions; ++i )
+		{
+			result += VectorTraits<BaseType>::get( size, i );
+		}
+		return result;
+	}
+
+	ScalarType result( 0 );
+	for( unsigned int i = 0; i < dimensions; ++i )
+	{
+		for( unsigned int j = i + 1; j < dimensions; ++j )
+		{
+			result += VectorTraits<BaseType>::get( size, i ) * VectorTraits<BaseType>::get( size, j );
+		}
+	}
+	return result;
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::NodeIndex BoundingVolumeHierarchy<BoundIterator>::countNodes( const NodeVector &nodes, NodeIndex nodeIndex ) const
+{
+	const Node &node = nodes[nodeIndex];
+	if( node.isLeaf() )
+	{
+		return 1;
+	}
+	return 1 + countNodes( nodes, nodeIndex + 1 ) + countNodes( nodes, node.m_offset );
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::NodeIndex BoundingVolumeHierarchy<BoundIterator>::compact( const NodeVector &nodes, NodeIndex nodeIndex )
+{
+	const NodeIndex result = m_nodes.size();
+	m_nodes.push_back( nodes[nodeIndex] );
+	if( m_nodes.back().isBranch() )
+	{
+		compact( nodes, nodeIndex + 1 );
+		const NodeIndex highIndex = compact( nodes, nodes[nodeIndex].m_offset );
+		m_nodes[result].m_offset = highIndex;
+	}
+	return result;
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::NodeIndex BoundingVolumeHierarchy<BoundIterator>::numNodes() const
+{
+	return m_nodes.size();
+}
+
+template<class BoundIterator>
+const typename BoundingVolumeHierarchy<BoundIterator>::Node &BoundingVolumeHierarchy<BoundIterator>::node( NodeIndex index ) const
+{
+	assert( index < m_nodes.size() );
+	return m_nodes[index];
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::NodeIndex BoundingVolumeHierarchy<BoundIterator>::rootIndex() const
+{
+	return 0;
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::NodeIndex BoundingVolumeHierarchy<BoundIterator>::lowChildIndex( NodeIndex index ) const
+{
+	assert( m_nodes[index].isBranch() );
+	return index + 1;
+}
+
+template<class BoundIterator>
+typename BoundingVolumeHierarchy<BoundIterator>::NodeIndex BoundingVolumeHierarchy<BoundIterator>::highChildIndex( NodeIndex index ) const
+{
+	assert( m_nodes[index].isBranch() );
+	return m_nodes[index].m_offset;
+}
+
+template<class BoundIterator>
+const BoundIterator *BoundingVolumeHierarchy<BoundIterator>::permFirst( NodeIndex index ) const
+{
+	assert( m_nodes[index].isLeaf() );
+	return m_perm.empty() ? 0 : &m_perm[0] + m_nodes[index].m_offset;
+}
+
+template<class BoundIterator>
+const BoundIterator *BoundingVolumeHierarchy<BoundIterator>::permLast( NodeIndex index ) const
+{
+	assert( m_nodes[index].isLeaf() );
+	return permFirst( index ) + m_nodes[index].m_count;
+}
+
+template<class BoundIterator>
+template<typename S>
+unsigned int BoundingVolumeHierarchy<BoundIterator>::intersectingBounds( const S &b, std::vector<BoundIterator> &bounds ) const
+{
+	bounds.clear();
+
+	if( boxIntersects( m_nodes[rootIndex()].bound(), b ) )
+	{
+		intersectingBoundsWalk( rootIndex(), b, bounds );
+	}
+
+	return bounds.size();
+}
+
+template<class BoundIterator>
+template<typename S>
+void BoundingVolumeHierarchy<BoundIterator>::intersectingBoundsWalk( NodeIndex nodeIndex, const S &b, std::vector<BoundIterator> &bounds ) const
+{
+	const Node &node = m_nodes[nodeIndex];
+	if( node.isLeaf() )
+	{
+		const BoundIterator *last = permLast( nodeIndex );
+		for( const BoundIterator *perm = permFirst( nodeIndex ); perm != last; ++perm )
+		{
+			if( boxIntersects( **perm, b ) )
+			{
+				bounds.push_back( *perm );
+			}
+		}
+	}
+	else
+	{
+		const NodeIndex lowIndex = lowChildIndex( nodeIndex );
+		if( boxIntersects( m_nodes[lowIndex].bound(), b ) )
+		{
+			intersectingBoundsWalk( lowIndex, b, bounds );
+		}
+		const NodeIndex highIndex = highChildIndex( nodeIndex );
+		if( boxIntersects( m_nodes[highIndex].bound(), b ) )
+		{
+			intersectingBoundsWalk( highIndex, b, bounds );
+		}
+	}
+}
+
+} // namespace IECore
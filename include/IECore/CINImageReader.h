@@ -44,7 +44,8 @@ namespace IECore
 
 /// The CINImageReader reads Kodak Cineon (CIN) files.
 /// Currently, only the overwhelmingly popular 10-bit log-encoded pixel-interlaced
-/// 32-bit word boundary format is loaded.
+/// 32-bit word boundary format is loaded. All channels are unpacked together
+/// in a single parallel pass.
 /// \ingroup ioGroup
 class IECORE_API CINImageReader : public ImageReader
 {
@@ -69,6 +70,7 @@ class IECORE_API CINImageReader : public ImageReader
 
 
 		virtual DataPtr readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw );
+		virtual void readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data );
 
 		// filename associator
 		static const ReaderDescription<CINImageReader> m_readerDescription;
@@ -92,9 +94,6 @@ class IECORE_API CINImageReader : public ImageReader
 		struct Header;
 		Header *m_header;
 
-		template<typename V>
-		DataPtr readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow );
-
 };
 
 IE_CORE_DECLAREPTR(CINImageReader);
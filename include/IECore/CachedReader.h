@@ -62,7 +62,6 @@ IE_CORE_FORWARDDECLARE( CachedReader );
 /// \todo We probably need a way of setting parameters for the
 /// Readers, and treating reads with different parameters as different
 /// entities in the cache.
-/// \todo Stats on cache misses etc.
 /// \todo Can we do something to make sure that two paths to the same
 /// file (symlinks) result in only a single cache entry?
 /// \ingroup ioGroup
@@ -110,6 +109,13 @@ class IECORE_API CachedReader : public RefCounted
 		/// Returns the ObjectPool object used by this CachedReader.
 		ObjectPool *objectPool() const;
 
+		/// Returns statistics about the use of the cache, where the
+		/// getterTime is the total time spent loading files. Note that calls
+		/// to cached() are counted as lookups.
+		LRUCacheStatistics statistics() const;
+		/// Resets all statistics to 0.
+		void resetStatistics();
+
 		/// Returns a static CachedReader instance to be used by anything
 		/// wishing to share it's cache with others. It makes sense to use
 		/// this wherever possible to conserve memory. This initially
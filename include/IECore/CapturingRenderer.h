@@ -49,6 +49,11 @@ IE_CORE_FORWARDDECLARE( Group )
 /// Currently it doesn't support any calls before worldBegin(), as there is no IECore
 /// class to represent an entire scene. The world generated by the renderer can be retrieved
 /// as an IECore::Group using the world() method.
+///
+/// For large procedural expansions a Sink may be specified with setSink(). In this case
+/// the output of each top level procedural is passed to the sink as soon as it has been
+/// fully expanded, rather than being kept in the world, allowing very large scenes to
+/// be streamed to disk (to a SceneCache for instance) with bounded memory usage.
 /// \ingroup renderingGroup
 class IECORE_API CapturingRenderer : public Renderer
 {
@@ -73,6 +78,11 @@ class IECORE_API CapturingRenderer : public Renderer
 		/// be output. The filters also support wildcards, so you can specify things like
 		/// "/root/wheel*Rim/bolt", "/root/torso/rib*", and "/root/*", the last of which
 		/// will output "/root" and all its descendants.
+		///
+		/// \li <b>"cp:sink:maxMemory" IntData 1024</b><br>
+		/// The maximum amount of memory, in megabytes, that completed procedural output may
+		/// occupy while waiting to be written to the Sink. When this is exceeded, procedural
+		/// expansion is paused until the Sink has caught up.
 		virtual void setOption( const std::string &name, ConstDataPtr value );
 		
 		virtual ConstDataPtr getOption( const std::string &name ) const;
@@ -137,6 +147,35 @@ class IECORE_API CapturingRenderer : public Renderer
 		/// then we could have a scene() method instead.
 		ConstGroupPtr world();
 
+		/// Abstract base class for objects which receive the output of top level
+		/// procedurals as it is completed. Calls to write() are serialised, but may
+		/// be made from any thread.
+		class Sink : public RefCounted
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( Sink );
+
+				Sink();
+				virtual ~Sink();
+
+				/// Called with the output of each top level procedural. The group
+				/// holds the full world transform and state that was in effect when
+				/// the procedural was specified.
+				virtual void write( ConstGroupPtr group ) = 0;
+
+		};
+		IE_CORE_DECLAREPTR( Sink );
+
+		/// Sets the sink used to stream procedural output. This must be called before
+		/// worldBegin(). When a sink is in use, top level procedurals no longer appear in
+		/// world(), which contains only the primitives and state specified outside of them.
+		/// Procedurals with the "cp:procedural:reentrant" attribute turned off are always
+		/// captured into the world.
+		void setSink( SinkPtr sink );
+		SinkPtr getSink();
+
 	private :
 		
 		class Implementation;
@@ -61,21 +61,35 @@ class IECORE_API ChannelOp : public ImagePrimitiveOp
 
 		typedef std::vector<FloatVectorDataPtr> ChannelVector;
 
-		/// Should be implemented by derived classes to modify the data in the passes channels in place.
-		/// The base class will already have verified the following :
+		/// Modifies the data in the passed channels in place. The base class will already have verified the following :
 		///
 		///		* the channels have an appropriate interpolation value - vertex, varying or facevarying.
 		/// 	* the channels contain the appropriate number of elements for the dataWindow.
-		///		* the channels are all of type FloatVectorData.
+		///		* the channels are all of type FloatVectorData. Channels of type HalfVectorData and UCharVectorData are
+		///		  accepted too - they are converted to float for processing, and back to their original type afterwards.
 		///		* the dataWindow is not empty.
+		///
+		/// The default implementation is suitable for point operations, where each output pixel depends only
+		/// on the same pixel of the input. It divides the dataWindow into tiles and calls modifyTile() for each
+		/// of them in parallel. Operations with a larger footprint, where output pixels depend on neighbouring
+		/// input pixels, must instead reimplement this method to process the whole image. Point operations
+		/// needing some preparation before processing the tiles may also reimplement it, calling the base class
+		/// implementation once they are done.
 		/// \todo ChannelVector doesn't contain any indicator as to which channel is which, so why not just pass a single channel at a time? As
 		/// things are right now, every derived class is iterating over the channels vector - there's not much else they can do - so it would
-		/// make sense to move that step to the base class. If we pass a single channel at a time then we could also thread the computation of
-		/// the different channels.
-		virtual void modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels ) = 0;
+		/// make sense to move that step to the base class.
+		virtual void modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels );
+
+		/// Called concurrently by the default implementation of modifyChannels(), to modify a tile of the dataWindow
+		/// in place. Tiles always span whole scanlines of the dataWindow, so the data for each channel is held
+		/// contiguously, starting at the corresponding pointer in channels. Must be implemented by derived classes
+		/// which don't reimplement modifyChannels(). The default implementation throws.
+		virtual void modifyTile( const Imath::Box2i &dataWindow, const Imath::Box2i &tile, const std::vector<float *> &channels ) const;
 
 	private :
 
+		struct ModifyTiles;
+
 		/// Implemented to call modifyChannels().
 		virtual void modifyTypedPrimitive( ImagePrimitive *image, const CompoundObject *operands );
 
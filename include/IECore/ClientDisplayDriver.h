@@ -46,9 +46,18 @@ namespace IECore
 
 
 /// Connects to a DisplayDriverServer and forwards the image to the server using socket messages.
-/// This client class works synchronously.
+/// By default imageData() copies the buckets into a queue and returns immediately, leaving a separate thread
+/// to send them, so that render threads aren't held up by a slow network. The optional IntData parameter
+/// 'displaySendQueueMemory' limits the memory used by the queue, in megabytes, defaulting to 64. imageData()
+/// blocks while the queue is full, and imageClose() waits for it to be emptied. A limit of 0 sends each bucket
+/// synchronously from imageData() instead. Errors sending queued buckets are thrown by the next call to
+/// imageData() or imageClose().
 /// It forwards all parameters to the server and also includes one called "clientPID" to help grouping AOVs from the same render.
 /// You must set the parameter 'remoteDisplayType' with a registered display driver to be instantiated in the server side.
+/// The optional StringData parameter 'displayDataEncoding' requests how the image data is sent to the server :
+/// "float" (the default) sends it unchanged, "half" converts it to half precision, and "halfLZ4" additionally
+/// compresses it with LZ4. The half encodings greatly reduce the bandwidth needed for interactive renders,
+/// at the cost of precision. The server falls back to "half" if LZ4 isn't available on either side.
 /// \ingroup renderingGroup
 class IECORE_API ClientDisplayDriver : public DisplayDriver
 {
@@ -74,14 +74,27 @@ class IECORE_API ColorTransformOp : public PrimitiveOp
 		BoolParameter * premultipliedParameter();
 		const BoolParameter * premultipliedParameter() const;
 
+		/// Transforms n unpremultiplied colors in place, held in separate arrays for
+		/// each channel, using the current parameter values. This bypasses the primitive
+		/// handling of operate(), and is used by CubeColorTransformOp::bake() to sample
+		/// transforms into a lookup.
+		void transformColors( size_t n, float *r, float *g, float *b );
+
 	protected :
 
 		/// Called once per operation. This is an opportunity to perform any preprocessing
 		/// necessary before many calls to transform() are made.
 		virtual void begin( const CompoundObject * operands );
-		/// Called once per color element (pixel for ImagePrimitives).
+		/// Called once per color element (pixel for ImagePrimitives) by the default
+		/// implementation of transformSpan().
 		/// Must be implemented by subclasses to transform color in place.
 		virtual void transform( Imath::Color3f &color ) const = 0;
+		/// Called to transform n color elements in place, held in separate arrays for
+		/// each channel. Any alpha has already been divided out. The default implementation
+		/// calls transform() for each element in turn, but subclasses may override it to
+		/// process whole arrays at once, avoiding the per element call overhead and allowing
+		/// the compiler to vectorise the loops.
+		virtual void transformSpan( size_t n, float *r, float *g, float *b ) const;
 		/// Called once per operation, after all calls to transform() have been made - even if
 		// /transform() throws an exception. This is an opportunity to perform any cleanup necessary.
 		virtual void end();
@@ -41,6 +41,8 @@
 #ifndef IE_CORE_COMPOSITEALGO_H
 #define IE_CORE_COMPOSITEALGO_H
 
+#include <cstddef>
+
 namespace IECore
 {
 
@@ -60,6 +62,21 @@ inline T compositeMin( T aVal, T aAlpha, T bVal, T bAlpha );
 template<typename T>
 inline T compositeMultiply( T aVal, T aAlpha, T bVal, T bAlpha );
 
+/// Array forms of the above, compositing n values at once into result. These
+/// are simple loops which the compiler is free to vectorise, and avoid the
+/// overhead of calling the single value forms through a function pointer.
+template<typename T>
+inline void compositeOver( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result );
+
+template<typename T>
+inline void compositeMax( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result );
+
+template<typename T>
+inline void compositeMin( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result );
+
+template<typename T>
+inline void compositeMultiply( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result );
+
 } // namespace IECore
 
 #include "IECore/CompositeAlgo.inl"
@@ -36,6 +36,8 @@
 #ifndef IE_CORE_COMPOSITEALGO_INL
 #define IE_CORE_COMPOSITEALGO_INL
 
+#include <algorithm>
+
 namespace IECore
 {
 
@@ -63,6 +65,42 @@ T compositeMultiply( T aVal, T aAlpha, T bVal, T bAlpha )
 	return aVal * bVal;
 }
 
+template<typename T>
+void compositeOver( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result )
+{
+	for( size_t i = 0; i < n; ++i )
+	{
+		result[i] = compositeOver<T>( aVal[i], aAlpha[i], bVal[i], bAlpha[i] );
+	}
+}
+
+template<typename T>
+void compositeMax( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result )
+{
+	for( size_t i = 0; i < n; ++i )
+	{
+		result[i] = compositeMax<T>( aVal[i], aAlpha[i], bVal[i], bAlpha[i] );
+	}
+}
+
+template<typename T>
+void compositeMin( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result )
+{
+	for( size_t i = 0; i < n; ++i )
+	{
+		result[i] = compositeMin<T>( aVal[i], aAlpha[i], bVal[i], bAlpha[i] );
+	}
+}
+
+template<typename T>
+void compositeMultiply( size_t n, const T *aVal, const T *aAlpha, const T *bVal, const T *bAlpha, T *result )
+{
+	for( size_t i = 0; i < n; ++i )
+	{
+		result[i] = compositeMultiply<T>( aVal[i], aAlpha[i], bVal[i], bAlpha[i] );
+	}
+}
+
 
 }
 
@@ -35,15 +35,17 @@
 #ifndef IECORE_COMPOUNDDATABASE_H
 #define IECORE_COMPOUNDDATABASE_H
 
-#include <map>
-
+#include "IECore/FlatMap.h"
 #include "IECore/TypedData.h"
 
 namespace IECore
 {
 
-/// The type of Data held by the CompoundData typedef.
-typedef std::map< InternedString, DataPtr > CompoundDataMap;
+/// The type of Data held by the CompoundData typedef. This is a FlatMap
+/// rather than a std::map, because lookups in the small maps typical of
+/// CompoundData are several times faster. Note that inserting or erasing
+/// members invalidates iterators and references to other members.
+typedef FlatMap< InternedString, DataPtr > CompoundDataMap;
 /// A subclass of Data which stores a map of other named Data
 /// objects - a CompoundDataMap. This is accessible as usual
 /// via the readable() and writable() member functions. Generally you
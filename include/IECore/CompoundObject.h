@@ -36,6 +36,7 @@
 #define IE_CORE_COMPOUNDOBJECT_H
 
 #include "IECore/Export.h"
+#include "IECore/FlatMap.h"
 #include "IECore/Object.h"
 
 namespace IECore
@@ -52,7 +53,10 @@ class IECORE_API CompoundObject : public Object
 
 		IE_CORE_DECLAREOBJECT( CompoundObject, Object );
 
-		typedef std::map<InternedString, ObjectPtr> ObjectMap;
+		/// As for CompoundDataMap, this is a FlatMap for fast lookups, so
+		/// inserting or erasing members invalidates iterators and references
+		/// to other members.
+		typedef FlatMap<InternedString, ObjectPtr> ObjectMap;
 
 		/// Gives const access to the member object map.
 		const ObjectMap &members() const;
@@ -46,7 +46,9 @@ namespace IECore
 /// LRUCache for generic computation that results on Object derived classes. It uses ObjectPool for the storage and retrieval of 
 /// the computation results, and internally it only holds a map of computationHash to objectHash. The get functions will return the resulting 
 /// Object, which should be copied prior to modification. The retrieve function will only query the cache and not force computation.
-template< typename T >
+/// The Policy chooses which computations are forgotten when maxResults is exceeded - see LRUCachePolicy for the options. This is
+/// independent of the policy used by the ObjectPool, which is chosen when constructing the pool.
+template< typename T, template<typename> class Policy = LRUCachePolicy::Sharded >
 class ComputationCache : public RefCounted
 {
 	public :
@@ -101,16 +103,29 @@ class ComputationCache : public RefCounted
 		/// Returns the ObjectPool object used by this computation cache.
 		ObjectPool *objectPool() const;
 
+		/// Returns statistics about the use of the cache. Misses count all lookups
+		/// which didn't find a result, regardless of the MissingBehaviour, and the
+		/// getterTime is the time spent in the compute function. Evictions count the
+		/// computations forgotten due to the maxResults limit.
+		LRUCacheStatistics statistics() const;
+		/// Resets all statistics to 0.
+		void resetStatistics();
+
 	private :
 
 		ComputeFn m_computeFn;
 		HashFn m_hashFn;
 
-		typedef IECore::LRUCache<MurmurHash, MurmurHash> Cache;
+		typedef IECore::LRUCache<MurmurHash, MurmurHash, Policy> Cache;
 		Cache m_cache;
 
 		ObjectPoolPtr m_objectPool;
 
+		LRUCacheStatisticsCounters m_statistics;
+
+		// Calls m_computeFn, timing it for our statistics.
+		ConstObjectPtr compute( const T &args );
+
 		static MurmurHash cacheGetter( const MurmurHash &h, size_t &cost );
 };
 
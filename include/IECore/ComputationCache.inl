@@ -40,50 +40,50 @@
 namespace IECore
 {
 
-template< typename T >
-ComputationCache<T>::ComputationCache( ComputeFn computeFn, HashFn hashFn, size_t maxResults, ObjectPoolPtr objectPool ) : 
-	m_computeFn(computeFn), m_hashFn(hashFn), m_cache( &ComputationCache<T>::cacheGetter, maxResults), m_objectPool(objectPool)
+template< typename T, template<typename> class Policy >
+ComputationCache<T, Policy>::ComputationCache( ComputeFn computeFn, HashFn hashFn, size_t maxResults, ObjectPoolPtr objectPool ) : 
+	m_computeFn(computeFn), m_hashFn(hashFn), m_cache( &ComputationCache<T, Policy>::cacheGetter, maxResults), m_objectPool(objectPool)
 {
 }
 
-template< typename T >
-ComputationCache<T>::~ComputationCache()
+template< typename T, template<typename> class Policy >
+ComputationCache<T, Policy>::~ComputationCache()
 {
 }
 
-template< typename T >
-void ComputationCache<T>::clear()
+template< typename T, template<typename> class Policy >
+void ComputationCache<T, Policy>::clear()
 {
 	m_cache.clear();
 }
 
-template< typename T >
-void ComputationCache<T>::erase( const T &args )
+template< typename T, template<typename> class Policy >
+void ComputationCache<T, Policy>::erase( const T &args )
 {
 	MurmurHash computationHash = m_hashFn(args);
 	m_cache.erase( computationHash );
 }
 
-template< typename T >
-size_t ComputationCache<T>::getMaxComputations() const
+template< typename T, template<typename> class Policy >
+size_t ComputationCache<T, Policy>::getMaxComputations() const
 {
 	return m_cache.getMaxCost();
 }
 
-template< typename T >
-void ComputationCache<T>::setMaxComputations( size_t maxComputations )
+template< typename T, template<typename> class Policy >
+void ComputationCache<T, Policy>::setMaxComputations( size_t maxComputations )
 {
 	m_cache.setMaxCost(maxComputations);
 }
 
-template< typename T >
-size_t ComputationCache<T>::cachedComputations() const
+template< typename T, template<typename> class Policy >
+size_t ComputationCache<T, Policy>::cachedComputations() const
 {
 	return m_cache.currentCost();
 }
 
-template< typename T >
-ConstObjectPtr ComputationCache<T>::get( const T &args, ComputationCache::MissingBehaviour missingBehaviour )
+template< typename T, template<typename> class Policy >
+ConstObjectPtr ComputationCache<T, Policy>::get( const T &args, ComputationCache::MissingBehaviour missingBehaviour )
 {
 	ConstObjectPtr obj(0);
 	MurmurHash computationHash = m_hashFn(args);
@@ -91,6 +91,7 @@ ConstObjectPtr ComputationCache<T>::get( const T &args, ComputationCache::Missin
 
 	if ( objectHash == MurmurHash() )
 	{
+		m_statistics.miss();
 		/// don't know the computation hash... check the missing behaviour
 		if ( missingBehaviour == ThrowIfMissing )
 		{
@@ -100,7 +101,7 @@ ConstObjectPtr ComputationCache<T>::get( const T &args, ComputationCache::Missin
 		{
 			return 0;
 		}
-		obj = m_computeFn(args);
+		obj = compute( args );
 		if ( obj )
 		{
 			m_cache.set( computationHash, obj->hash(), 1 );
@@ -110,8 +111,13 @@ ConstObjectPtr ComputationCache<T>::get( const T &args, ComputationCache::Missin
 	else
 	{
 		obj = m_objectPool->retrieve(objectHash);
-		if ( !obj )
+		if ( obj )
+		{
+			m_statistics.hit();
+		}
+		else
 		{
+			m_statistics.miss();
 			/// the computation result was not in the object pool.... check the missing behavour
 			if ( missingBehaviour == ThrowIfMissing )
 			{
@@ -121,7 +127,7 @@ ConstObjectPtr ComputationCache<T>::get( const T &args, ComputationCache::Missin
 			{
 				return 0;
 			}
-			obj = m_computeFn(args);
+			obj = compute( args );
 			if ( obj )
 			{
 				obj = m_objectPool->store( obj.get(), ObjectPool::StoreReference );
@@ -138,8 +144,8 @@ ConstObjectPtr ComputationCache<T>::get( const T &args, ComputationCache::Missin
 	return obj;
 }
 
-template< typename T >
-void ComputationCache<T>::set( const T &args, const Object *obj, StoreMode storeMode )
+template< typename T, template<typename> class Policy >
+void ComputationCache<T, Policy>::set( const T &args, const Object *obj, StoreMode storeMode )
 {
 	MurmurHash computationHash = m_hashFn(args);
 	if ( obj )
@@ -149,15 +155,37 @@ void ComputationCache<T>::set( const T &args, const Object *obj, StoreMode store
 	}
 }
 
-template< typename T >
-MurmurHash ComputationCache<T>::cacheGetter( const MurmurHash &h, size_t &cost )
+template< typename T, template<typename> class Policy >
+LRUCacheStatistics ComputationCache<T, Policy>::statistics() const
+{
+	LRUCacheStatistics result = m_statistics.statistics();
+	result.evictions = m_cache.statistics().evictions;
+	return result;
+}
+
+template< typename T, template<typename> class Policy >
+void ComputationCache<T, Policy>::resetStatistics()
+{
+	m_statistics.reset();
+	m_cache.resetStatistics();
+}
+
+template< typename T, template<typename> class Policy >
+ConstObjectPtr ComputationCache<T, Policy>::compute( const T &args )
+{
+	LRUCacheStatisticsCounters::ScopedGetterTimer timer( m_statistics );
+	return m_computeFn( args );
+}
+
+template< typename T, template<typename> class Policy >
+MurmurHash ComputationCache<T, Policy>::cacheGetter( const MurmurHash &h, size_t &cost )
 {
 	cost = 1;
 	return MurmurHash();
 }
 
-template< typename T >
-ObjectPool *ComputationCache<T>::objectPool() const
+template< typename T, template<typename> class Policy >
+ObjectPool *ComputationCache<T, Policy>::objectPool() const
 {
 	return m_objectPool.get();
 }
@@ -56,7 +56,8 @@ class CubeColorLookup
 		typedef enum
 		{
 			NoInterpolation,
-			Linear
+			Linear,
+			Tetrahedral
 		} Interpolation ;
 
 		typedef T BaseType;
@@ -79,6 +80,10 @@ class CubeColorLookup
 
 		/// Performs a color lookup
 		inline ColorType operator() ( const ColorType &color ) const;
+		/// Performs color lookups in place on n colors, held in separate arrays for each
+		/// channel. This gives the same results as calling the single color form for
+		/// each element, but avoids the per color dispatch.
+		void operator() ( size_t n, T *r, T *g, T *b ) const;
 
 		/// Sets the values held by this lookup
 		void setCube( const Imath::V3i &dimension, const DataType &data, const BoxType &domain = BoxType( VecType( 0, 0, 0 ), VecType( 1, 1, 1 ) ) );
@@ -97,6 +102,11 @@ class CubeColorLookup
 		inline VecType normalizedCoordinates( const ColorType &color ) const;
 		inline int clamp( int v, int min, int max ) const;
 
+		inline const ColorType &at( int x, int y, int z ) const;
+		inline ColorType nearest( const VecType &idx ) const;
+		inline ColorType trilinear( const VecType &idx ) const;
+		inline ColorType tetrahedral( const VecType &idx ) const;
+
 		Imath::V3i m_dimension;
 		BoxType m_domain;
 		DataType m_data;
@@ -37,8 +37,6 @@
 
 #include <cassert>
 
-#include "boost/multi_array.hpp"
-
 #include "IECore/Exception.h"
 
 #include "OpenEXR/ImathLimits.h"
@@ -114,82 +112,191 @@ template<typename T>
 typename CubeColorLookup<T>::ColorType CubeColorLookup<T>::operator() ( const ColorType &color ) const
 {
 	assert( m_data.size() > 0 );
-	boost::const_multi_array_ref< ColorType, 3 > colorArray( &m_data[0], boost::extents[ m_dimension.x ][ m_dimension.y ][ m_dimension.z ] );
 
 	const ColorType clampedColor = Imath::closestPointInBox( static_cast<VecType>( color ), m_domain );
+	const VecType idx = normalizedCoordinates( clampedColor );
 
 	switch ( m_interpolation )
 	{
 		case NoInterpolation :
-			{
-				const VecType idx = normalizedCoordinates( clampedColor );
+			return nearest( idx );
+		case Linear :
+			return trilinear( idx );
+		case Tetrahedral :
+			return tetrahedral( idx );
+		default:
+			assert( false );
+	}
+
+	return color;
+}
 
-				return colorArray[ (int)( idx.x + 0.5 ) ][ (int)( idx.y + 0.5 ) ][ (int)( idx.z + 0.5 ) ];
+template<typename T>
+void CubeColorLookup<T>::operator() ( size_t n, T *r, T *g, T *b ) const
+{
+	assert( m_data.size() > 0 );
+
+	// Dispatch on the interpolation once for the whole span, rather than once
+	// per color, so that each loop is free of branches the compiler can't hoist.
+	switch ( m_interpolation )
+	{
+		case NoInterpolation :
+			for( size_t i = 0; i < n; ++i )
+			{
+				const ColorType c = nearest( normalizedCoordinates( Imath::closestPointInBox( VecType( r[i], g[i], b[i] ), m_domain ) ) );
+				r[i] = c[0]; g[i] = c[1]; b[i] = c[2];
 			}
 			break;
-
-		case Linear:
+		case Linear :
+			for( size_t i = 0; i < n; ++i )
 			{
-				LinearInterpolator<ColorType> interp;
-
-				const VecType idx = normalizedCoordinates( clampedColor );
+				const ColorType c = trilinear( normalizedCoordinates( Imath::closestPointInBox( VecType( r[i], g[i], b[i] ), m_domain ) ) );
+				r[i] = c[0]; g[i] = c[1]; b[i] = c[2];
+			}
+			break;
+		case Tetrahedral :
+			for( size_t i = 0; i < n; ++i )
+			{
+				const ColorType c = tetrahedral( normalizedCoordinates( Imath::closestPointInBox( VecType( r[i], g[i], b[i] ), m_domain ) ) );
+				r[i] = c[0]; g[i] = c[1]; b[i] = c[2];
+			}
+			break;
+		default:
+			assert( false );
+	}
+}
 
-				int ix = (int)floor( idx.x );
-				int iy = (int)floor( idx.y );
-				int iz = (int)floor( idx.z );
+template<typename T>
+inline const typename CubeColorLookup<T>::ColorType &CubeColorLookup<T>::at( int x, int y, int z ) const
+{
+	return m_data[ ( x * m_dimension.y + y ) * m_dimension.z + z ];
+}
 
-				assert( ix >= 0 );
-				assert( iy >= 0 );
-				assert( iz >= 0 );
+template<typename T>
+inline typename CubeColorLookup<T>::ColorType CubeColorLookup<T>::nearest( const VecType &idx ) const
+{
+	return at( (int)( idx.x + 0.5 ), (int)( idx.y + 0.5 ), (int)( idx.z + 0.5 ) );
+}
 
-				T fx = idx.x - (T)ix;
-				T fy = idx.y - (T)iy;
-				T fz = idx.z - (T)iz;
+template<typename T>
+inline typename CubeColorLookup<T>::ColorType CubeColorLookup<T>::trilinear( const VecType &idx ) const
+{
+	LinearInterpolator<ColorType> interp;
 
-				assert( fx >= -Imath::limits<T>::epsilon() );
-				assert( fx <= T(1.0) + Imath::limits<T>::epsilon() );
+	int ix = (int)floor( idx.x );
+	int iy = (int)floor( idx.y );
+	int iz = (int)floor( idx.z );
 
-				assert( fy >= -Imath::limits<T>::epsilon() );
-				assert( fy <= T(1.0) + Imath::limits<T>::epsilon() );
+	assert( ix >= 0 );
+	assert( iy >= 0 );
+	assert( iz >= 0 );
 
-				assert( fz >= -Imath::limits<T>::epsilon() );
-				assert( fz <= T(1.0) + Imath::limits<T>::epsilon() );
+	T fx = idx.x - (T)ix;
+	T fy = idx.y - (T)iy;
+	T fz = idx.z - (T)iz;
 
-				ColorType tmp1[2];
-				ColorType tmp2[2];
-				ColorType tmp3[2];
+	assert( fx >= -Imath::limits<T>::epsilon() );
+	assert( fx <= T(1.0) + Imath::limits<T>::epsilon() );
 
-				for ( int x = 0; x <= 1; x ++ )
-				{
-					int xidx = clamp( ix + x, 0, m_dimension.x - 1 );
+	assert( fy >= -Imath::limits<T>::epsilon() );
+	assert( fy <= T(1.0) + Imath::limits<T>::epsilon() );
 
-					for ( int y = 0; y <= 1; y ++ )
-					{
-						int yidx = clamp( iy + y, 0, m_dimension.y - 1 );
+	assert( fz >= -Imath::limits<T>::epsilon() );
+	assert( fz <= T(1.0) + Imath::limits<T>::epsilon() );
 
-						for ( int z = 0; z <= 1; z ++ )
-						{
-							int zidx = clamp( iz + z, 0, m_dimension.z - 1 );
+	ColorType tmp1[2];
+	ColorType tmp2[2];
+	ColorType tmp3[2];
 
-							tmp1[ z ] = colorArray[ xidx ][ yidx ][ zidx ];
-						}
+	for ( int x = 0; x <= 1; x ++ )
+	{
+		int xidx = clamp( ix + x, 0, m_dimension.x - 1 );
 
-						interp( tmp1[0], tmp1[1], fz, tmp2[ y ] );
-					}
+		for ( int y = 0; y <= 1; y ++ )
+		{
+			int yidx = clamp( iy + y, 0, m_dimension.y - 1 );
 
-					 interp( tmp2[ 0 ], tmp2[ 1 ], fy, tmp3[ x ] );
-				}
+			for ( int z = 0; z <= 1; z ++ )
+			{
+				int zidx = clamp( iz + z, 0, m_dimension.z - 1 );
 
-				ColorType result;
-				interp( tmp3[ 0 ], tmp3[ 1 ], fx, result );
-				return result;
+				tmp1[ z ] = at( xidx, yidx, zidx );
 			}
-			break;
-		default:
-			assert( false );
+
+			interp( tmp1[0], tmp1[1], fz, tmp2[ y ] );
+		}
+
+		 interp( tmp2[ 0 ], tmp2[ 1 ], fy, tmp3[ x ] );
 	}
 
-	return color;
+	ColorType result;
+	interp( tmp3[ 0 ], tmp3[ 1 ], fx, result );
+	return result;
+}
+
+template<typename T>
+inline typename CubeColorLookup<T>::ColorType CubeColorLookup<T>::tetrahedral( const VecType &idx ) const
+{
+	const int ix = clamp( (int)floor( idx.x ), 0, m_dimension.x - 1 );
+	const int iy = clamp( (int)floor( idx.y ), 0, m_dimension.y - 1 );
+	const int iz = clamp( (int)floor( idx.z ), 0, m_dimension.z - 1 );
+
+	const T fx = idx.x - (T)ix;
+	const T fy = idx.y - (T)iy;
+	const T fz = idx.z - (T)iz;
+
+	const int ix1 = clamp( ix + 1, 0, m_dimension.x - 1 );
+	const int iy1 = clamp( iy + 1, 0, m_dimension.y - 1 );
+	const int iz1 = clamp( iz + 1, 0, m_dimension.z - 1 );
+
+	// Split the cell into six tetrahedra along its main diagonal, and
+	// interpolate between the four corners of the one containing the point.
+	// This needs only four lookups rather than the eight for trilinear.
+	const ColorType &c000 = at( ix, iy, iz );
+	const ColorType &c111 = at( ix1, iy1, iz1 );
+
+	if( fx >= fy )
+	{
+		if( fy >= fz )
+		{
+			const ColorType &c100 = at( ix1, iy, iz );
+			const ColorType &c110 = at( ix1, iy1, iz );
+			return c000 + ( c100 - c000 ) * fx + ( c110 - c100 ) * fy + ( c111 - c110 ) * fz;
+		}
+		else if( fx >= fz )
+		{
+			const ColorType &c100 = at( ix1, iy, iz );
+			const ColorType &c101 = at( ix1, iy, iz1 );
+			return c000 + ( c100 - c000 ) * fx + ( c101 - c100 ) * fz + ( c111 - c101 ) * fy;
+		}
+		else
+		{
+			const ColorType &c001 = at( ix, iy, iz1 );
+			const ColorType &c101 = at( ix1, iy, iz1 );
+			return c000 + ( c001 - c000 ) * fz + ( c101 - c001 ) * fx + ( c111 - c101 ) * fy;
+		}
+	}
+	else
+	{
+		if( fz >= fy )
+		{
+			const ColorType &c001 = at( ix, iy, iz1 );
+			const ColorType &c011 = at( ix, iy1, iz1 );
+			return c000 + ( c001 - c000 ) * fz + ( c011 - c001 ) * fy + ( c111 - c011 ) * fx;
+		}
+		else if( fz >= fx )
+		{
+			const ColorType &c010 = at( ix, iy1, iz );
+			const ColorType &c011 = at( ix, iy1, iz1 );
+			return c000 + ( c010 - c000 ) * fy + ( c011 - c010 ) * fz + ( c111 - c011 ) * fx;
+		}
+		else
+		{
+			const ColorType &c010 = at( ix, iy1, iz );
+			const ColorType &c110 = at( ix1, iy1, iz );
+			return c000 + ( c010 - c000 ) * fy + ( c110 - c010 ) * fx + ( c111 - c110 ) * fz;
+		}
+	}
 }
 
 template<typename T>
@@ -63,11 +63,22 @@ class IECORE_API CubeColorTransformOp : public ColorTransformOp
 		CubeColorLookupfParameter * cubeParameter();
 		const CubeColorLookupfParameter * cubeParameter() const;
 
+		/// Bakes a chain of transforms into a single lookup, by applying each of them in turn
+		/// to the lattice points of a cube with the given dimension and domain. Applying the
+		/// result with a CubeColorTransformOp is typically much faster than applying the chain.
+		static CubeColorLookupfDataPtr bake(
+			const std::vector<ColorTransformOpPtr> &transforms,
+			const Imath::V3i &dimension,
+			const Imath::Box3f &domain = Imath::Box3f( Imath::V3f( 0 ), Imath::V3f( 1 ) ),
+			CubeColorLookupf::Interpolation interpolation = CubeColorLookupf::Linear
+		);
+
 	protected :
 
 		virtual void begin( const CompoundObject * operands );
 
 		virtual void transform( Imath::Color3f &color ) const ;
+		virtual void transformSpan( size_t n, float *r, float *g, float *b ) const;
 
 	private :
 
@@ -51,6 +51,7 @@ namespace IECore
 IE_CORE_FORWARDDECLARE( ObjectParameter )
 
 /// The CurveExtrudeOp lofts RiCurves into RiPatchMesh cylinders, obeying any width primvars present.
+/// Each curve is extruded independently, in parallel.
 /// \ingroup geometryProcessingGroup
 class IECORE_API CurveExtrudeOp : public Op
 {
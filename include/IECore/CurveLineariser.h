@@ -38,11 +38,17 @@
 #include "IECore/Export.h"
 #include "IECore/TypedPrimitiveOp.h"
 #include "IECore/NumericParameter.h"
+#include "IECore/SimpleTypedParameter.h"
 
 namespace IECore
 {
 
-/// An op to convert cubic curves to linear curves.
+/// An op to convert cubic curves to linear curves. Vertices may either be
+/// distributed uniformly, or placed adaptively to keep the deviation from the
+/// original curves within a maximum error, which may be measured in screen space
+/// by providing a projection. All vertex and varying primitive variables are
+/// resampled, with those of non-floating-point types taking the nearest value.
+/// Curves are processed in parallel.
 /// \ingroup geometryProcessingGroup
 class IECORE_API CurveLineariser : public CurvesPrimitiveOp
 {
@@ -56,6 +62,12 @@ class IECORE_API CurveLineariser : public CurvesPrimitiveOp
 		FloatParameter * verticesPerSegmentParameter();
 		const FloatParameter * verticesPerSegmentParameter() const;
 
+		FloatParameter * maxErrorParameter();
+		const FloatParameter * maxErrorParameter() const;
+
+		M44fParameter * errorTransformParameter();
+		const M44fParameter * errorTransformParameter() const;
+
 	protected :
 
 		virtual void modifyTypedPrimitive( CurvesPrimitive * curves, const CompoundObject * operands );
@@ -52,6 +52,14 @@ void resamplePrimitiveVariable( const CurvesPrimitive *curvesPrimitive, Primitiv
 /// create a new curves primitive deleting curves from the input curves primitive based on the curvesToDelete uniform (int|float|bool) PrimitiveVariable
 CurvesPrimitivePtr deleteCurves( const CurvesPrimitive *curvesPrimitive, const PrimitiveVariable &curvesToDelete );
 
+/// Merges any number of curves primitives into one, in a single pass. The basis and periodicity are
+/// taken from the first primitive, as are Constant primitive variables. Every other primitive variable
+/// is output at the highest interpolation (Vertex, then Varying or FaceVarying, then Uniform) found
+/// amongst the inputs, resampling any inputs which differ. Inputs lacking a variable, or holding it
+/// with a different type, contribute zeroes. Indices are kept if every input is indexed. The
+/// topology and primitive variables are merged concurrently.
+CurvesPrimitivePtr mergeCurves( const std::vector<const CurvesPrimitive *> &curvesPrimitives );
+
 } // namespace CurveAlgo
 } // namespace IECore
 
@@ -36,6 +36,9 @@
 #define IECORE_CURVESPRIMITIVEEVALUATOR_H
 
 #include "tbb/mutex.h"
+#include "tbb/atomic.h"
+
+#include "OpenEXR/ImathLine.h"
 
 #include "IECore/Export.h"
 #include "IECore/PrimitiveEvaluator.h"
@@ -47,7 +50,9 @@ namespace IECore
 IE_CORE_FORWARDDECLARE( CurvesPrimitive )
 
 /// Implements the PrimitiveEvaluator interface to allow queries of
-/// CurvesPrimitives.
+/// CurvesPrimitives. The closest point and intersection queries are accelerated
+/// by a tree of linear segments approximating the curves, which is built in
+/// parallel on first use.
 /// \ingroup geometryProcessingGroup
 class IECORE_API CurvesPrimitiveEvaluator : public PrimitiveEvaluator
 {
@@ -130,14 +135,29 @@ class IECORE_API CurvesPrimitiveEvaluator : public PrimitiveEvaluator
 		virtual bool closestPoint( const Imath::V3f &p, PrimitiveEvaluator::Result *result ) const;
 		/// Returns pointAtV( 0, uv[1], result ).
 		virtual bool pointAtUV( const Imath::V2f &uv, PrimitiveEvaluator::Result *result ) const;
-		/// Not yet implemented.	
+		/// Intersects the ray with tubes around the curves, whose diameter is given by the
+		/// "width" primitive variable, or "constantwidth" if that doesn't exist, defaulting
+		/// to 1. The result is the point on the curve closest to the ray, rather than a point
+		/// on the surface of the tube, which makes this suitable for picking and binding
+		/// hair, where curves are typically rendered as camera facing ribbons.
 		virtual bool intersectionPoint( const Imath::V3f &origin, const Imath::V3f &direction,
 			PrimitiveEvaluator::Result *result, float maxDistance = Imath::limits<float>::max() ) const;
-		/// Not yet implemented.	
+		/// As above, but returning the intersections with all curves along the ray, sorted
+		/// by distance. At most one intersection is returned per curve.
 		virtual int intersectionPoints( const Imath::V3f &origin, const Imath::V3f &direction,
 			std::vector<PrimitiveEvaluator::ResultPtr> &results, float maxDistance = Imath::limits<float>::max() ) const;
 		//@}
 
+		//! @name Batch Query Functions
+		/// These build the tree before distributing the queries across threads, so
+		/// that the build itself can use all threads rather than stalling the queries.
+		////////////////////////////////////////////////////////////////////////////////////////
+		//@{
+		virtual void batchClosestPoint( const std::vector<Imath::V3f> &points, BatchResults &results ) const;
+		virtual void batchIntersectionPoint( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions,
+			BatchResults &results, float maxDistance = Imath::limits<float>::max() ) const;
+		//@}
+
 		//! @name Curve specific query functions
 		////////////////////////////////////////////////////////////////////////////////////////
 		//@{
@@ -169,6 +189,9 @@ class IECORE_API CurvesPrimitiveEvaluator : public PrimitiveEvaluator
 		static PrimitiveEvaluatorPtr create( ConstPrimitivePtr primitive );
 		friend struct PrimitiveEvaluator::Description<CurvesPrimitiveEvaluator>;
 		static PrimitiveEvaluator::Description<CurvesPrimitiveEvaluator> g_evaluatorDescription;
+
+		/// Stores only the point and uv, as the other values aren't supported by our results.
+		virtual void storeBatchResult( const PrimitiveEvaluator::Result *result, size_t index, BatchResults &results ) const;
 		
 	private :
 
@@ -183,15 +206,19 @@ class IECORE_API CurvesPrimitiveEvaluator : public PrimitiveEvaluator
 		PrimitiveVariable m_p;
 		
 		void buildTree();
-		bool m_haveTree;
+		tbb::atomic<bool> m_haveTree;
 		typedef tbb::mutex TreeMutex;
 		TreeMutex m_treeMutex;
 		Box3fTree m_tree;
 		std::vector<Imath::Box3f> m_treeBounds;
 		struct Line;
 		std::vector<Line> m_treeLines;
-		
+		class TreeBuilder;
+
+		struct RayHit;
 		void closestPointWalk( Box3fTree::NodeIndex nodeIndex, const Imath::V3f &p, unsigned &curveIndex, float &v, float &closestDistSquared ) const;
+		void intersectionPointWalk( Box3fTree::NodeIndex nodeIndex, const Imath::Line3f &ray, RayHit &hit ) const;
+		void intersectionPointsWalk( Box3fTree::NodeIndex nodeIndex, const Imath::Line3f &ray, float maxDistance, std::vector<RayHit> &hits ) const;
 		
 };
 
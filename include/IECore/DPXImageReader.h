@@ -35,16 +35,28 @@
 #ifndef IE_CORE_DPXIMAGEREADER_H
 #define IE_CORE_DPXIMAGEREADER_H
 
+#include "boost/shared_ptr.hpp"
+
 #include "IECore/Export.h"
 #include "IECore/ImageReader.h"
 #include "IECore/VectorTypedData.h"
 
+namespace boost
+{
+namespace iostreams
+{
+class mapped_file_source;
+} // namespace iostreams
+} // namespace boost
+
 namespace IECore
 {
 
 /// The DPXImageReader reads Digital Picture eXchange (DPX) files.
 /// Currently, only the overwhelmingly popular 10-bit log-encoded pixel-interlaced
-/// format is loaded
+/// format is loaded. All channels are unpacked together in a single parallel
+/// pass, and the file may optionally be memory mapped rather than read into
+/// an intermediate buffer.
 /// \ingroup ioGroup
 class IECORE_API DPXImageReader : public ImageReader
 {
@@ -65,10 +77,17 @@ class IECORE_API DPXImageReader : public ImageReader
 		virtual Imath::Box2i displayWindow();
 		virtual std::string sourceColorSpace() const ;
 
+		/// Parameter which when true causes the file to be memory mapped
+		/// for reading, rather than the image data being copied into a buffer.
+		BoolParameter *memoryMappedParameter();
+		const BoolParameter *memoryMappedParameter() const;
+
 	private:
 
 		virtual DataPtr readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw );
+		virtual void readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data );
 
+		void constructParameters();
 
 		// filename associator
 		static const ReaderDescription<DPXImageReader> m_readerDescription;
@@ -83,9 +102,16 @@ class IECORE_API DPXImageReader : public ImageReader
 		/// format, so we will make one I/O pass and cache the image in memory while striping
 		/// off channels / planes
 		std::vector<unsigned int> m_buffer;
+		/// Used in place of m_buffer when memory mapping.
+		boost::shared_ptr<boost::iostreams::mapped_file_source> m_mappedFile;
+		/// Points to the image data, in either m_buffer or m_mappedFile.
+		const unsigned int *m_data;
+
+		BoolParameterPtr m_memoryMappedParameter;
 
-		/// the filename in effect when we filled the buffer last.
+		/// the filename and mapping mode in effect when we filled the buffer last.
 		std::string m_bufferFileName;
+		bool m_bufferMemoryMapped;
 		unsigned int m_bufferWidth, m_bufferHeight;
 		bool m_reverseBytes;
 
@@ -94,9 +120,6 @@ class IECORE_API DPXImageReader : public ImageReader
 
 		const char* descriptorStr( int descriptor ) const;
 
-		template<typename V>
-		DataPtr readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow );
-
 };
 
 IE_CORE_DECLAREPTR(DPXImageReader);
@@ -49,6 +49,14 @@ class IECORE_API Data : public Object
 
 		IE_CORE_DECLAREABSTRACTOBJECT( Data, Object );
 
+		/// Data objects are typically small and numerous - reading the
+		/// attributes for a single SceneCache location can create thousands
+		/// of them - so they are allocated using the TBB scalable allocator,
+		/// which serves small blocks from per-thread pools rather than going
+		/// to the general purpose heap each time.
+		static void *operator new( size_t size );
+		static void operator delete( void *p );
+
 	protected :
 
 		virtual ~Data();
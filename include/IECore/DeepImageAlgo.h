@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_DEEPIMAGEALGO_H
+#define IECORE_DEEPIMAGEALGO_H
+
+#include <vector>
+
+#include "IECore/Export.h"
+#include "IECore/DeepImageBlock.h"
+#include "IECore/ImagePrimitive.h"
+
+namespace IECore
+{
+
+/// Functions for deep compositing with DeepImageBlocks. These produce the same
+/// results as the equivalent DeepPixel methods, but operate on whole blocks at
+/// once, processing scanlines in parallel. Where pixels have samples which are
+/// already sorted by depth, the sort is skipped entirely.
+/// \ingroup deepCompositingGroup
+namespace DeepImageAlgo
+{
+
+/// Sorts the samples within each pixel of the block by depth. The sort is
+/// stable, so samples at equal depths retain their relative order.
+IECORE_API void sortSamples( DeepImageBlock *block );
+
+/// Composites the samples for each pixel and writes the flat results into the
+/// corresponding pixels of the image, whose dataWindow must contain the region
+/// of the block. Each channel is written to a FloatVectorData Vertex primitive
+/// variable, which is created if it doesn't exist already. The compositing
+/// matches DeepPixel::composite(), and pixels without samples are left untouched.
+IECORE_API void flatten( const DeepImageBlock *block, ImagePrimitive *image );
+/// Returns a new ImagePrimitive containing the flattened block. Both the
+/// dataWindow and displayWindow are set to the region of the block, and pixels
+/// without samples are set to 0.
+IECORE_API ImagePrimitivePtr flatten( const DeepImageBlock *block );
+
+/// Returns a new block containing the samples from all the given blocks, which
+/// must share the same region and channels, although the channels may be in
+/// a different order. The channels of the result are ordered as in the first
+/// block, and the samples within each pixel are sorted by depth. Samples at
+/// equal depths are ordered as the blocks are.
+IECORE_API DeepImageBlockPtr merge( const std::vector<const DeepImageBlock *> &blocks );
+
+} // namespace DeepImageAlgo
+
+} // namespace IECore
+
+#endif // IECORE_DEEPIMAGEALGO_H
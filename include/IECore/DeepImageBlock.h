@@ -0,0 +1,148 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_DEEPIMAGEBLOCK_H
+#define IECORE_DEEPIMAGEBLOCK_H
+
+#include <string>
+#include <vector>
+
+#include "OpenEXR/ImathBox.h"
+
+#include "IECore/Export.h"
+#include "IECore/DeepPixel.h"
+#include "IECore/RefCounted.h"
+
+namespace IECore
+{
+
+IE_CORE_FORWARDDECLARE( DeepImageBlock )
+
+/// A DeepImageBlock stores the deep samples for a rectangular region of a deep image
+/// in structure-of-arrays form. Rather than holding a DeepPixel per pixel, the samples
+/// for every pixel in the region are stored contiguously, with one plane of floats for
+/// depth and one for each channel. A table of sample offsets locates the samples for
+/// each pixel within the planes. Pixels are stored in scanline order, starting at
+/// region().min. Samples within a pixel are stored in the order they were provided,
+/// and are not necessarily sorted by depth.
+/// \ingroup deepCompositingGroup
+class IECORE_API DeepImageBlock : public RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( DeepImageBlock );
+
+		/// Constructs a block with no samples for the given region. Use setSampleCounts()
+		/// to allocate the sample planes before filling them.
+		DeepImageBlock( const Imath::Box2i &region, const std::vector<std::string> &channelNames );
+		virtual ~DeepImageBlock();
+
+		/// The region of the image covered by the block.
+		const Imath::Box2i &region() const;
+		/// The number of pixels in the region.
+		unsigned numPixels() const;
+		/// Returns the index of the pixel at the given coordinates, which must be inside
+		/// the region.
+		unsigned pixelIndex( int x, int y ) const;
+
+		//! @name Channels
+		/// As with DeepPixel, depth is not considered a channel.
+		//////////////////////////////////////////////////////////////////////////////
+		//@{
+		unsigned numChannels() const;
+		const std::vector<std::string> &channelNames() const;
+		/// Returns the index of the named channel, or -1 if it doesn't exist.
+		int channelIndex( const std::string &name ) const;
+		//@}
+
+		//! @name Samples
+		//////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Sets the number of samples in each pixel, reallocating the sample
+		/// planes to match. The counts are specified in scanline order and there
+		/// must be exactly numPixels() of them. All sample values are reset to 0.
+		void setSampleCounts( const std::vector<unsigned> &counts );
+		/// The total number of samples in the block.
+		unsigned numSamples() const;
+		/// The number of samples in the indexed pixel.
+		unsigned numSamples( unsigned pixelIndex ) const;
+		/// Returns numPixels() + 1 offsets. The samples for pixel i are those
+		/// in the range [ sampleOffsets()[i], sampleOffsets()[i+1] ) of each plane.
+		const std::vector<unsigned> &sampleOffsets() const;
+
+		/// The depth plane, containing numSamples() values. Returns 0 if the
+		/// block has no samples.
+		float *depths();
+		const float *depths() const;
+		/// The plane for the indexed channel, containing numSamples() values.
+		/// Returns 0 if the block has no samples.
+		float *channelData( unsigned channelIndex );
+		const float *channelData( unsigned channelIndex ) const;
+
+		/// Fills the planes from a buffer of numSamples() samples, each of which holds
+		/// a depth followed by a value for each channel. This is the same layout as is
+		/// used by DeepPixel, and is convenient for readers which retrieve samples one
+		/// pixel at a time.
+		void setInterleavedSamples( const float *samples );
+		//@}
+
+		//! @name Conversion
+		//////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Returns a new DeepPixel holding the samples for the given pixel, or
+		/// 0 if the pixel has no samples.
+		DeepPixelPtr pixel( int x, int y ) const;
+		/// Replaces the samples for the given pixel with those from the DeepPixel,
+		/// which must have the same number of samples as the pixel already holds,
+		/// and the same channels as the block. Samples are copied in depth order.
+		void setPixel( int x, int y, const DeepPixel *pixel );
+		//@}
+
+	private :
+
+		Imath::Box2i m_region;
+		int m_width;
+		std::vector<std::string> m_channelNames;
+		std::vector<unsigned> m_sampleOffsets;
+		// All the planes, depth first, in a single allocation.
+		std::vector<float> m_data;
+
+};
+
+IE_CORE_DECLAREPTR( DeepImageBlock );
+
+} // namespace IECore
+
+#endif // IECORE_DEEPIMAGEBLOCK_H
@@ -39,6 +39,7 @@
 #include "OpenEXR/ImathMatrix.h"
 
 #include "IECore/Export.h"
+#include "IECore/DeepImageBlock.h"
 #include "IECore/DeepPixel.h"
 #include "IECore/Reader.h"
 
@@ -85,6 +86,12 @@ class IECORE_API DeepImageReader : public Reader
 		/// It is up to the derived classes to account for that fact if necessary.
 		DeepPixelPtr readPixel( int x, int y );
 
+		/// Reads all the pixels within the specified region into a single DeepImageBlock.
+		/// This is considerably faster than calling readPixel() for each pixel, as it
+		/// avoids allocating a DeepPixel per pixel. The region must be contained within
+		/// the dataWindow. Coordinates are specified as for readPixel().
+		DeepImageBlockPtr readBlock( const Imath::Box2i &region );
+
 	protected :
 
 		/// Returns an ImagePrimitive, having composited all the DeepPixels into flat pixels
@@ -98,6 +105,12 @@ class IECORE_API DeepImageReader : public Reader
 		/// for that fact if necessary.
 		virtual DeepPixelPtr doReadPixel( int x, int y ) = 0;
 
+		/// Reads the specified region. This is called by the public readBlock() method, and
+		/// it is guaranteed that the region is within the dataWindow. The default implementation
+		/// calls doReadPixel() for every pixel in the region - derived classes are encouraged
+		/// to override it with something more efficient.
+		virtual DeepImageBlockPtr doReadBlock( const Imath::Box2i &region );
+
 };
 
 IE_CORE_DECLAREPTR( DeepImageReader );
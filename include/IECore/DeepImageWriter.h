@@ -36,6 +36,7 @@
 #define IECORE_DEEPIMAGEWRITER_H
 
 #include "IECore/Export.h"
+#include "IECore/DeepImageBlock.h"
 #include "IECore/DeepPixel.h"
 #include "IECore/Parameterised.h"
 #include "IECore/SimpleTypedParameter.h"
@@ -96,6 +97,12 @@ class IECORE_API DeepImageWriter : public Parameterised
 		/// the derived classes to account for that fact if necessary.
 		void writePixel( int x, int y, const DeepPixel *pixel );
 
+		/// Writes all the pixels in a DeepImageBlock to the file, as if writePixel() had
+		/// been called for each pixel in the block in scanline order. Pixels with no
+		/// samples are skipped. The block must have the same number of channels as
+		/// specified by channelNamesParameter().
+		void writeBlock( const DeepImageBlock *block );
+
 		/// Fills the passed vector with all the extensions for which a DeepImageWriter is
 		/// available. Extensions are of the form "exr" - ie without a preceding '.'.
 		static void supportedExtensions( std::vector<std::string> &extensions );
@@ -116,6 +123,13 @@ class IECORE_API DeepImageWriter : public Parameterised
 		/// the upper left corner of the displayWindow. It is up to the derived classes to
 		/// account for that fact if necessary.
 		virtual void doWritePixel( int x, int y, const DeepPixel *pixel ) = 0;
+
+		/// Writes a DeepImageBlock. This is called by the public writeBlock() method, and it
+		/// is guaranteed that the block is a valid pointer with the correct number of channels.
+		/// The default implementation converts each pixel with samples to a DeepPixel and calls
+		/// doWritePixel() - derived classes are encouraged to override it with something more
+		/// efficient.
+		virtual void doWriteBlock( const DeepImageBlock *block );
 		
 		/// Definition of a function which can create a DeepImageWriter when given a fileName.
 		typedef DeepImageWriterPtr (*CreatorFn)( const std::string &fileName );
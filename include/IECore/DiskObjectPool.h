@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_DISKOBJECTPOOL_H
+#define IECORE_DISKOBJECTPOOL_H
+
+#include "boost/shared_ptr.hpp"
+
+#include "IECore/Export.h"
+#include "IECore/Object.h"
+#include "IECore/MurmurHash.h"
+
+namespace IECore
+{
+
+IE_CORE_FORWARDDECLARE( DiskObjectPool );
+
+/// \addtogroup environmentGroup
+///
+/// <b>IECORE_OBJECTPOOL_DISKCACHE_PATH</b><br>
+/// <b>IECORE_OBJECTPOOL_DISKCACHE_SIZE</b><br>
+/// Used to specify a DiskObjectPool for the default ObjectPool. See
+/// ObjectPool::defaultObjectPool() for more information.
+
+/// The DiskObjectPool class stores Objects in files within a directory, indexed by
+/// their hash and limited by the total size of the files. It is intended to be used
+/// as a second level for an ObjectPool, holding objects evicted from memory on fast
+/// local storage so that they needn't be recomputed or reloaded from the network.
+/// Because objects are addressed by their content, the same directory may safely be
+/// shared by several processes at once. Files are written atomically, and when the
+/// size limit is exceeded the least recently used files are removed, regardless of
+/// which process stored them.
+/// \ingroup utilityGroup
+class IECORE_API DiskObjectPool : public RefCounted
+{
+	public:
+
+		IE_CORE_DECLAREMEMBERPTR( DiskObjectPool );
+
+		/// Creates a pool storing files in the given directory, which is
+		/// created if it doesn't exist already.
+		DiskObjectPool( const std::string &directory, size_t maxDiskUsage );
+		virtual ~DiskObjectPool();
+
+		/// Returns the directory holding the files.
+		const std::string &directory() const;
+
+		/// Writes the object to disk, unless it is held in the pool already.
+		/// Returns true if the object was written, and throws an IOException
+		/// if it couldn't be.
+		bool store( const Object *obj );
+
+		/// Loads the Object with the given hash, returning NULL if it
+		/// isn't held in the pool, or its file can't be read. Exceptions
+		/// unrelated to reading the file are propagated to the caller.
+		ObjectPtr retrieve( const MurmurHash &hash ) const;
+
+		/// Returns true if the Object with the given hash is in the pool.
+		/// Note that this may be invalidated at any time by other threads
+		/// or processes.
+		bool contains( const MurmurHash &hash ) const;
+
+		/// Removes the Object with the given hash. Returns whether any item
+		/// was removed.
+		bool erase( const MurmurHash &hash );
+
+		/// Removes all files created by the pool, except for temporary
+		/// files that other threads or processes are still writing.
+		void clear();
+
+		/// Sets the maximum size of the files held in the pool, removing files
+		/// as necessary.
+		void setMaxDiskUsage( size_t maxDiskUsage );
+
+		/// Returns the maximum size of the files held in the pool.
+		size_t getMaxDiskUsage() const;
+
+		/// Returns the total size of the files held in the pool. This is
+		/// updated as objects are stored by this process, but changes made
+		/// by other processes are only accounted for when the pool is trimmed
+		/// to meet its limit.
+		size_t diskUsage() const;
+
+	private:
+
+		struct MemberData;
+		boost::shared_ptr<MemberData> m_data;
+
+};
+
+} // namespace IECore
+
+#endif // IECORE_DISKOBJECTPOOL_H
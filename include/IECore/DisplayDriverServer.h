@@ -52,7 +52,10 @@ namespace IECore
 /// Server class that receives images from ClientDisplayDriver connections and forwards the data to local display drivers.
 /// The type of the local display drivers is defined by the 'remoteDisplayType' parameter.
 ///
-/// The server object creates a thread to control the socket connection. The thread dies when the object is destroyed.
+/// The server object creates a pool of threads to service the socket connections. The threads die when the object
+/// is destroyed. Each connection is serviced by only one thread at a time, but separate connections are serviced
+/// concurrently, so that a slow local display driver doesn't hold up the others. The data for each connection is
+/// read from the socket ahead of the calls to the local display driver, up to a limited number of buckets.
 /// \ingroup renderingGroup
 class IECORE_API DisplayDriverServer : public RunTimeTyped
 {
@@ -63,10 +66,13 @@ class IECORE_API DisplayDriverServer : public RunTimeTyped
 		/// A port number of 0 causes a free port to be chosen
 		/// automatically. Call `portNumber()` after construction
 		/// to retrieve the actual number.
-		DisplayDriverServer( int portNumber = 0 );
+		/// A numThreads of 0 uses one thread per hardware thread.
+		DisplayDriverServer( int portNumber = 0, int numThreads = 0 );
 		virtual ~DisplayDriverServer();
 
 		int portNumber();
+		/// Returns the number of threads servicing the connections.
+		int numThreads();
 
 	private:
 
@@ -70,6 +70,9 @@ class IECORE_API EXRDeepImageReader : public DeepImageReader
 	protected :
 
 		virtual DeepPixelPtr doReadPixel( int x, int y );
+		/// Copies the samples directly from the cached scanlines into the block,
+		/// without constructing any intermediate DeepPixels.
+		virtual DeepImageBlockPtr doReadBlock( const Imath::Box2i &region );
 
 	private :
 
@@ -74,6 +74,9 @@ class IECORE_API EXRDeepImageWriter : public DeepImageWriter
 	protected :
 		
 		virtual void doWritePixel( int x, int y, const DeepPixel *pixel );
+		/// Copies the samples directly from the block into the scanline buffer,
+		/// without constructing any intermediate DeepPixels.
+		virtual void doWriteBlock( const DeepImageBlock *block );
 		
 		Imf::Compression compression() const;
 
@@ -82,6 +85,9 @@ class IECORE_API EXRDeepImageWriter : public DeepImageWriter
 		void clearScanlineBuffer();
 		void appendParameters();
 		void writeScanline();
+		/// Writes any buffered scanlines preceding y, so that pixels
+		/// from scanline y may be written into the buffer.
+		void advanceToScanline( int y );
 		unsigned int numberOfChannels() const;
 		const std::string &channelName( unsigned int index ) const;
 
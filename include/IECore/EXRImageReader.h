@@ -36,6 +36,7 @@
 #define IE_CORE_EXRIMAGEREADER_H
 
 #include "OpenEXR/ImfInputFile.h"
+#include "OpenEXR/ImfTiledInputFile.h"
 #include "OpenEXR/ImfChannelList.h"
 
 #include "IECore/Export.h"
@@ -44,7 +45,9 @@
 namespace IECore
 {
 
-/// The EXRImageReader class reads OpenEXR files.
+/// The EXRImageReader class reads OpenEXR files. All requested channels are decoded
+/// together in a single pass over the file, using the number of threads specified by
+/// Imf::setGlobalThreadCount().
 /// \ingroup ioGroup
 class IECORE_API EXRImageReader : public ImageReader
 {
@@ -66,6 +69,13 @@ class IECORE_API EXRImageReader : public ImageReader
 		virtual Imath::Box2i displayWindow();
 		virtual std::string sourceColorSpace() const ;
 
+		/// Returns the smallest window containing dataWindow which can be read without
+		/// decoding any pixels outside it. For tiled files this is dataWindow expanded
+		/// to the tile boundaries, and for scanline files it spans the full width of the
+		/// file. Passing such a window to the dataWindow parameter avoids intermediate copies,
+		/// and for tiled files any other window still only decodes the tiles it touches.
+		Imath::Box2i alignedDataWindow( const Imath::Box2i &dataWindow );
+
 	protected:
 
 		// overwrites base implementation by adding blind data values from header information.
@@ -73,10 +83,12 @@ class IECORE_API EXRImageReader : public ImageReader
 
 	private:
 
-		template<class T>
-		DataPtr readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow, const Imf::Channel *channel );
-
 		virtual DataPtr readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw );
+		virtual void readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data );
+
+		struct ChannelBuffer;
+		void readScanlines( const Imath::Box2i &dataWindow, std::vector<ChannelBuffer> &buffers );
+		void readTiles( const Imath::Box2i &dataWindow, std::vector<ChannelBuffer> &buffers );
 
 		static const ReaderDescription<EXRImageReader> g_readerDescription;
 
@@ -85,6 +97,8 @@ class IECORE_API EXRImageReader : public ImageReader
 		/// Exception is thrown rather than false being returned.
 		bool open( bool throwOnFailure = false );
 		Imf::InputFile *m_inputFile;
+		/// Opened on demand by readTiles(), for tiled files only.
+		Imf::TiledInputFile *m_tiledInputFile;
 
 };
 
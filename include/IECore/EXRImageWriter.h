@@ -66,6 +66,8 @@ class IECORE_API EXRImageWriter : public ImageWriter
 		/// construct an EXRImageWriter for the given image and output filename
 		EXRImageWriter( ObjectPtr object, const std::string & fileName );
 
+		virtual ~EXRImageWriter();
+
 		virtual std::string destinationColorSpace() const ;
 
 		IntParameter * compressionParameter();
@@ -81,6 +83,16 @@ class IECORE_API EXRImageWriter : public ImageWriter
 		                        const ImagePrimitive * image,
 		                        const Imath::Box2i &dw) const;
 
+		/// Reimplemented to write each scanline to the file as soon as it has been completed, so
+		/// that only partially written scanlines are held in memory. Images which require a
+		/// colorspace conversion are written by the base class implementation instead.
+		virtual void doBeginImage( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const std::vector<std::string> &channelNames, const CompoundData *blindData );
+		virtual void doWriteBlock( const Imath::Box2i &box, const float *data );
+		virtual void doEndImage();
+
+		IE_CORE_FORWARDDECLARE( ScanlineWriter );
+		ScanlineWriterPtr m_scanlineWriter;
+
 		template<typename T>
 		void writeTypedChannel(const char *name,
 		                       const Imath::Box2i &dw, const std::vector<T> &channel,
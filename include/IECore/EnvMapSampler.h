@@ -45,7 +45,8 @@ namespace IECore
 
 /// This class uses the MedianCutSampler to calculate a distribution
 /// of light positions and orientations based on a lat-long environment
-/// map image.
+/// map image. The lights are computed in parallel, and results are cached
+/// by the hash of the image channels and parameters.
 /// \todo: use SphericalToEuclideanTransform that is based on right-hand coordinate system. Currently it is left-hand to match 3delight environment light mapping. But maya and nuke and the spherical harmonics implementation in IECore are right-handed.
 /// \ingroup renderingGroup
 /// \ingroup imageProcessingGroup
@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_FLATMAP_H
+#define IECORE_FLATMAP_H
+
+#include <vector>
+#include <utility>
+#include <functional>
+
+namespace IECore
+{
+
+/// A container with the interface of std::map, storing its elements in a
+/// vector kept sorted by key. Iteration order is the same as for a std::map
+/// with the same comparison, but lookups are binary searches over contiguous
+/// memory rather than traversals of individually allocated tree nodes, which
+/// makes them considerably faster for small maps. Insertion and erasure are
+/// linear in the size of the map, and unlike std::map they invalidate
+/// iterators and references to all elements after the point of modification.
+/// erase() therefore returns an iterator to the next element, which must be
+/// used when erasing while iterating.
+/// \ingroup utilityGroup
+template<typename Key, typename T, typename Compare = std::less<Key> >
+class FlatMap
+{
+
+	public :
+
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef std::pair<Key, T> value_type;
+		typedef Compare key_compare;
+
+		typedef std::vector<value_type> Vector;
+		typedef typename Vector::size_type size_type;
+		typedef typename Vector::difference_type difference_type;
+		typedef typename Vector::reference reference;
+		typedef typename Vector::const_reference const_reference;
+		typedef typename Vector::iterator iterator;
+		typedef typename Vector::const_iterator const_iterator;
+		typedef typename Vector::reverse_iterator reverse_iterator;
+		typedef typename Vector::const_reverse_iterator const_reverse_iterator;
+
+		FlatMap( const Compare &compare = Compare() );
+		template<typename InputIterator>
+		FlatMap( InputIterator first, InputIterator last, const Compare &compare = Compare() );
+
+		//! @name Iterators
+		//////////////////////////////////////////////////////////////
+		//@{
+		iterator begin();
+		const_iterator begin() const;
+		iterator end();
+		const_iterator end() const;
+		reverse_iterator rbegin();
+		const_reverse_iterator rbegin() const;
+		reverse_iterator rend();
+		const_reverse_iterator rend() const;
+		//@}
+
+		//! @name Capacity
+		//////////////////////////////////////////////////////////////
+		//@{
+		bool empty() const;
+		size_type size() const;
+		size_type max_size() const;
+		/// Reserves storage for n elements, so that they may be inserted
+		/// without reallocation.
+		void reserve( size_type n );
+		size_type capacity() const;
+		//@}
+
+		//! @name Modifiers
+		//////////////////////////////////////////////////////////////
+		//@{
+		T &operator[]( const Key &key );
+		std::pair<iterator, bool> insert( const value_type &value );
+		/// Inserts in constant time if the value belongs immediately
+		/// before hint, which makes it cheap to build a map from
+		/// sorted values.
+		iterator insert( iterator hint, const value_type &value );
+		template<typename InputIterator>
+		void insert( InputIterator first, InputIterator last );
+		iterator erase( iterator position );
+		iterator erase( iterator first, iterator last );
+		size_type erase( const Key &key );
+		void swap( FlatMap &other );
+		void clear();
+		//@}
+
+		//! @name Lookup
+		//////////////////////////////////////////////////////////////
+		//@{
+		size_type count( const Key &key ) const;
+		iterator find( const Key &key );
+		const_iterator find( const Key &key ) const;
+		iterator lower_bound( const Key &key );
+		const_iterator lower_bound( const Key &key ) const;
+		iterator upper_bound( const Key &key );
+		const_iterator upper_bound( const Key &key ) const;
+		std::pair<iterator, iterator> equal_range( const Key &key );
+		std::pair<const_iterator, const_iterator> equal_range( const Key &key ) const;
+		//@}
+
+		key_compare key_comp() const;
+
+		bool operator == ( const FlatMap &other ) const;
+		bool operator != ( const FlatMap &other ) const;
+		bool operator < ( const FlatMap &other ) const;
+
+	private :
+
+		// Compares elements against keys, for use with the
+		// std::lower_bound() and std::upper_bound() searches.
+		class ValueCompare
+		{
+
+			public :
+
+				ValueCompare( const Compare &compare );
+
+				bool operator()( const value_type &value, const Key &key ) const;
+				bool operator()( const Key &key, const value_type &value ) const;
+
+			private :
+
+				Compare m_compare;
+
+		};
+
+		Vector m_values;
+		ValueCompare m_valueCompare;
+		Compare m_compare;
+
+};
+
+template<typename Key, typename T, typename Compare>
+void swap( FlatMap<Key, T, Compare> &a, FlatMap<Key, T, Compare> &b );
+
+} // namespace IECore
+
+#include "IECore/FlatMap.inl"
+
+#endif // IECORE_FLATMAP_H
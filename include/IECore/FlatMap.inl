@@ -0,0 +1,342 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_FLATMAP_INL
+#define IECORE_FLATMAP_INL
+
+#include <algorithm>
+
+namespace IECore
+{
+
+template<typename Key, typename T, typename Compare>
+FlatMap<Key, T, Compare>::ValueCompare::ValueCompare( const Compare &compare )
+	:	m_compare( compare )
+{
+}
+
+template<typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::ValueCompare::operator()( const value_type &value, const Key &key ) const
+{
+	return m_compare( value.first, key );
+}
+
+template<typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::ValueCompare::operator()( const Key &key, const value_type &value ) const
+{
+	return m_compare( key, value.first );
+}
+
+template<typename Key, typename T, typename Compare>
+FlatMap<Key, T, Compare>::FlatMap( const Compare &compare )
+	:	m_valueCompare( compare ), m_compare( compare )
+{
+}
+
+template<typename Key, typename T, typename Compare>
+template<typename InputIterator>
+FlatMap<Key, T, Compare>::FlatMap( InputIterator first, InputIterator last, const Compare &compare )
+	:	m_valueCompare( compare ), m_compare( compare )
+{
+	insert( first, last );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::begin()
+{
+	return m_values.begin();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::begin() const
+{
+	return m_values.begin();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::end()
+{
+	return m_values.end();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::end() const
+{
+	return m_values.end();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::reverse_iterator FlatMap<Key, T, Compare>::rbegin()
+{
+	return m_values.rbegin();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_reverse_iterator FlatMap<Key, T, Compare>::rbegin() const
+{
+	return m_values.rbegin();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::reverse_iterator FlatMap<Key, T, Compare>::rend()
+{
+	return m_values.rend();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_reverse_iterator FlatMap<Key, T, Compare>::rend() const
+{
+	return m_values.rend();
+}
+
+template<typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::empty() const
+{
+	return m_values.empty();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::size_type FlatMap<Key, T, Compare>::size() const
+{
+	return m_values.size();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::size_type FlatMap<Key, T, Compare>::max_size() const
+{
+	return m_values.max_size();
+}
+
+template<typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::reserve( size_type n )
+{
+	m_values.reserve( n );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::size_type FlatMap<Key, T, Compare>::capacity() const
+{
+	return m_values.capacity();
+}
+
+template<typename Key, typename T, typename Compare>
+T &FlatMap<Key, T, Compare>::operator[]( const Key &key )
+{
+	iterator it = lower_bound( key );
+	if( it == m_values.end() || m_compare( key, it->first ) )
+	{
+		it = m_values.insert( it, value_type( key, T() ) );
+	}
+	return it->second;
+}
+
+template<typename Key, typename T, typename Compare>
+std::pair<typename FlatMap<Key, T, Compare>::iterator, bool> FlatMap<Key, T, Compare>::insert( const value_type &value )
+{
+	iterator it = lower_bound( value.first );
+	if( it != m_values.end() && !m_compare( value.first, it->first ) )
+	{
+		return std::pair<iterator, bool>( it, false );
+	}
+	return std::pair<iterator, bool>( m_values.insert( it, value ), true );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::insert( iterator hint, const value_type &value )
+{
+	if(
+		( hint == m_values.end() || m_compare( value.first, hint->first ) ) &&
+		( hint == m_values.begin() || m_compare( (hint - 1)->first, value.first ) )
+	)
+	{
+		return m_values.insert( hint, value );
+	}
+	return insert( value ).first;
+}
+
+template<typename Key, typename T, typename Compare>
+template<typename InputIterator>
+void FlatMap<Key, T, Compare>::insert( InputIterator first, InputIterator last )
+{
+	for( ; first != last; ++first )
+	{
+		insert( m_values.end(), *first );
+	}
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::erase( iterator position )
+{
+	return m_values.erase( position );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::erase( iterator first, iterator last )
+{
+	return m_values.erase( first, last );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::size_type FlatMap<Key, T, Compare>::erase( const Key &key )
+{
+	iterator it = find( key );
+	if( it == m_values.end() )
+	{
+		return 0;
+	}
+	m_values.erase( it );
+	return 1;
+}
+
+template<typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::swap( FlatMap &other )
+{
+	m_values.swap( other.m_values );
+	std::swap( m_valueCompare, other.m_valueCompare );
+	std::swap( m_compare, other.m_compare );
+}
+
+template<typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::clear()
+{
+	m_values.clear();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::size_type FlatMap<Key, T, Compare>::count( const Key &key ) const
+{
+	return find( key ) != m_values.end() ? 1 : 0;
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::find( const Key &key )
+{
+	iterator it = lower_bound( key );
+	if( it != m_values.end() && !m_compare( key, it->first ) )
+	{
+		return it;
+	}
+	return m_values.end();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::find( const Key &key ) const
+{
+	const_iterator it = lower_bound( key );
+	if( it != m_values.end() && !m_compare( key, it->first ) )
+	{
+		return it;
+	}
+	return m_values.end();
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::lower_bound( const Key &key )
+{
+	return std::lower_bound( m_values.begin(), m_values.end(), key, m_valueCompare );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::lower_bound( const Key &key ) const
+{
+	return std::lower_bound( m_values.begin(), m_values.end(), key, m_valueCompare );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::iterator FlatMap<Key, T, Compare>::upper_bound( const Key &key )
+{
+	return std::upper_bound( m_values.begin(), m_values.end(), key, m_valueCompare );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::const_iterator FlatMap<Key, T, Compare>::upper_bound( const Key &key ) const
+{
+	return std::upper_bound( m_values.begin(), m_values.end(), key, m_valueCompare );
+}
+
+template<typename Key, typename T, typename Compare>
+std::pair<typename FlatMap<Key, T, Compare>::iterator, typename FlatMap<Key, T, Compare>::iterator> FlatMap<Key, T, Compare>::equal_range( const Key &key )
+{
+	iterator it = lower_bound( key );
+	if( it != m_values.end() && !m_compare( key, it->first ) )
+	{
+		return std::pair<iterator, iterator>( it, it + 1 );
+	}
+	return std::pair<iterator, iterator>( it, it );
+}
+
+template<typename Key, typename T, typename Compare>
+std::pair<typename FlatMap<Key, T, Compare>::const_iterator, typename FlatMap<Key, T, Compare>::const_iterator> FlatMap<Key, T, Compare>::equal_range( const Key &key ) const
+{
+	const_iterator it = lower_bound( key );
+	if( it != m_values.end() && !m_compare( key, it->first ) )
+	{
+		return std::pair<const_iterator, const_iterator>( it, it + 1 );
+	}
+	return std::pair<const_iterator, const_iterator>( it, it );
+}
+
+template<typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::key_compare FlatMap<Key, T, Compare>::key_comp() const
+{
+	return m_compare;
+}
+
+template<typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::operator == ( const FlatMap &other ) const
+{
+	return m_values == other.m_values;
+}
+
+template<typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::operator != ( const FlatMap &other ) const
+{
+	return m_values != other.m_values;
+}
+
+template<typename Key, typename T, typename Compare>
+bool FlatMap<Key, T, Compare>::operator < ( const FlatMap &other ) const
+{
+	return m_values < other.m_values;
+}
+
+template<typename Key, typename T, typename Compare>
+void swap( FlatMap<Key, T, Compare> &a, FlatMap<Key, T, Compare> &b )
+{
+	a.swap( b );
+}
+
+} // namespace IECore
+
+#endif // IECORE_FLATMAP_INL
@@ -36,13 +36,24 @@
 #define IE_CORE_IFFFILE_H
 
 #include <vector>
-#include <fstream>
+#include <string>
+
+#include "tbb/atomic.h"
+#include "tbb/mutex.h"
 
 #include "OpenEXR/ImathVec.h"
 
 #include "IECore/Export.h"
 #include "IECore/RefCounted.h"
 
+namespace boost
+{
+namespace iostreams
+{
+class mapped_file_source;
+} // namespace iostreams
+} // namespace boost
+
 namespace IECore
 {
 
@@ -50,6 +61,10 @@ IE_CORE_FORWARDDECLARE( IFFFile );
 
 /// The IFFFile class defines a low level class for reading IFF files.
 /// For specific IFF file types use a more specific implementation (i.e. NParticleReader, IFFHairReader, IFFImageReader).
+/// The file is memory mapped, and the children of each group are indexed lazily the first
+/// time they are accessed. Chunk data is byte swapped straight from the mapped file into the
+/// destination. Once opened, an IFFFile may be read from multiple threads concurrently. Chunks
+/// are owned by the IFFFile, and must not be used after it has been destroyed.
 class IECORE_API IFFFile : public RefCounted
 {
 	public :
@@ -136,23 +151,24 @@ class IECORE_API IFFFile : public RefCounted
 			private :
 				
 				Chunk( );
-				Chunk( std::string type, unsigned int dataSize, IFFFilePtr file, std::streampos filePosition, int alignmentQuota );
+				Chunk( std::string type, unsigned int dataSize, IFFFile *file, size_t filePosition, int alignmentQuota );
 				
 				Tag m_type;
 				unsigned int m_dataSize;
 
-				IFFFilePtr m_file;
-				std::streampos m_filePosition;
+				IFFFile *m_file;
+				size_t m_filePosition;
 
 				Tag m_groupName;
 				int m_alignmentQuota;
 				std::vector<Chunk> m_children;
+				tbb::atomic<bool> m_childrenListed;
 
-				// fills m_children
+				// fills m_children, if it hasn't been done already
 				void ls();
 
 				// reads most member variables from m_file, starting at pos
-				void readHeader( std::streampos *pos );
+				void readHeader( size_t *pos );
 
 				// reads the data from m_file, storing it in dataBuffer
 				template<typename T>
@@ -168,11 +184,17 @@ class IECORE_API IFFFile : public RefCounted
 	private :
 		
 		bool open();
-		std::ifstream *m_iStream;
-		std::string m_streamFileName;
-		
+		std::string m_fileName;
+		boost::iostreams::mapped_file_source *m_mappedFile;
+
 		Chunk *m_root;
-		
+		// protects open() and Chunk::ls()
+		tbb::mutex m_mutex;
+
+		// returns a pointer to size bytes of the mapped file, starting at position,
+		// throwing if the range extends beyond the end of the file.
+		const char *data( size_t position, size_t size ) const;
+
 		// reads data from the char buffer into a more specific buffer, accounting for byte order
 		template<typename T>
 		static void readData( const char *dataBuffer, T *attrBuffer, unsigned long n );
@@ -37,6 +37,8 @@
 
 #include <vector>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
 #include "IECore/ByteOrder.h"
 #include "IECore/MessageHandler.h"
@@ -68,12 +70,10 @@ size_t IFFFile::Chunk::read( std::vector<T> &data )
 		msg( Msg::Error, "IFFFile::Chunk::read()", boost::format( "Attempting to read '%d' pieces of data of size '%d' for a Chunk '%s' with dataSize '%d'." ) % length % sizeof(T) % m_type.name() % m_dataSize );
 	}
 	
-	T dataBuffer[length];
-	readData( dataBuffer, length );
-	
-	for ( size_t i = 0; i < length; i++ )
+	length = std::min<size_t>( length, m_dataSize / sizeof(T) );
+	if ( length )
 	{
-		data[i] = dataBuffer[i];
+		readData( &data[0], length );
 	}
 	
 	return data.size();
@@ -89,14 +89,11 @@ size_t IFFFile::Chunk::read( std::vector<Imath::Vec3<T> > &data )
 		msg( Msg::Error, "IFFFile::Chunk::read()", boost::format( "Attempting to read %d pieces of IMath::Vec3 data of size %d for a Chunk '%s' with dataSize %d." ) % length % sizeof(T) % m_type.name() % m_dataSize );
 	}
 	
-	T dataBuffer[length * 3];
-	readData( dataBuffer, length * 3 );
-	
-	for ( size_t i = 0; i < length ; i++ )
+	length = std::min<size_t>( length, m_dataSize / ( sizeof(T) * 3 ) );
+	if ( length )
 	{
-		data[ i ][0] = dataBuffer[ 3*i ];
-		data[ i ][1] = dataBuffer[ 3*i + 1 ];
-		data[ i ][2] = dataBuffer[ 3*i + 2 ];
+		// Vec3 is laid out as three contiguous components, so we can read straight into it
+		readData( data[0].getValue(), length * 3 );
 	}
 	
 	return data.size();
@@ -105,24 +102,21 @@ size_t IFFFile::Chunk::read( std::vector<Imath::Vec3<T> > &data )
 template<typename T>
 void IFFFile::Chunk::readData( T *dataBuffer, unsigned long n )
 {
-	m_file->m_iStream->seekg( m_filePosition, std::ios_base::beg );
-	
-	char buffer[m_dataSize];
-	m_file->m_iStream->read( buffer, m_dataSize );
-	
-	IFFFile::readData( buffer, dataBuffer, n );
+	IFFFile::readData( m_file->data( m_filePosition, n * sizeof( T ) ), dataBuffer, n );
 }
 
 template<typename T>
 void IFFFile::readData( const char *dataBuffer, T *attrBuffer, unsigned long n )
 {
-	for( unsigned long i=0; i < n; i++ )
+	// copy first and then swap in place - the simple loop over aligned
+	// values is much friendlier to the compiler's vectoriser.
+	memcpy( attrBuffer, dataBuffer, n * sizeof( T ) );
+	if ( littleEndian() )
 	{
-		T *data = (T*)dataBuffer;
-		dataBuffer += sizeof( T );
-		
-		*attrBuffer = asBigEndian( *data );
-		attrBuffer++;
+		for( unsigned long i=0; i < n; i++ )
+		{
+			attrBuffer[i] = reverseBytes( attrBuffer[i] );
+		}
 	}
 }
 
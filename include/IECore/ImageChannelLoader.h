@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_IMAGECHANNELLOADER_H
+#define IECORE_IMAGECHANNELLOADER_H
+
+#include "boost/shared_ptr.hpp"
+
+#include "IECore/Export.h"
+#include "IECore/ObjectPool.h"
+#include "IECore/ImageReader.h"
+
+namespace IECore
+{
+
+IE_CORE_FORWARDDECLARE( ImageChannelLoader );
+
+/// The ImageChannelLoader class provides lazy access to the channels of an image
+/// file. Where ImageReader::read() loads every requested channel up front, the
+/// ImageChannelLoader only reads a channel from the file the first time it is asked
+/// for, so a tool touching just "R", "G" and "B" of a file with many AOVs need never
+/// decode the rest. Loaded channels are stored in an ObjectPool, where they are
+/// shared between all loaders reading the same file with the same settings.
+///
+/// The dataWindow, displayWindow, channels, colorSpace and rawChannels parameters of
+/// the reader are captured at construction, and subsequent changes to them are ignored.
+/// When a colorspace conversion is required it is applied to each channel separately,
+/// premultiplied by "A" if the file has one. This matches ImageReader::read() for
+/// conversions implemented by ChannelOps, which covers all the standard colorspaces,
+/// but conversions registered as ColorTransformOps need all three colour channels
+/// together and are not applied - ImageReader::read() should be used in that case.
+/// \ingroup ioGroup
+class IECORE_API ImageChannelLoader : public RefCounted
+{
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( ImageChannelLoader );
+
+		/// Creates a loader for the file the reader is set to read. The reader is
+		/// owned by the loader from then on and should not be used elsewhere.
+		ImageChannelLoader( ImageReaderPtr reader, ObjectPoolPtr objectPool = ObjectPool::defaultObjectPool() );
+		virtual ~ImageChannelLoader();
+
+		/// Returns the name of the file being loaded.
+		const std::string &fileName() const;
+		/// Returns the dataWindow of the loaded channels.
+		const Imath::Box2i &dataWindow() const;
+		/// Returns the displayWindow of the loaded image.
+		const Imath::Box2i &displayWindow() const;
+		/// Returns the names of all the channels which may be loaded. This takes into
+		/// account the channels parameter of the reader.
+		const std::vector<std::string> &channelNames() const;
+
+		/// Returns the named channel, reading it from the file if it isn't already
+		/// held in the ObjectPool. Throws if the channel doesn't exist. The data is
+		/// returned with only const access as it actually refers to an object within
+		/// the pool - you must call copy() on it if you wish to modify it.
+		/// \threading It is safe to call this method from multiple concurrent threads.
+		ConstDataPtr channel( const std::string &name );
+		/// Returns true if the named channel is held in the ObjectPool, and therefore
+		/// won't need reading from the file.
+		bool cached( const std::string &name ) const;
+
+		/// Returns an ImagePrimitive with the windows of the file but no channels, ready
+		/// to be populated by load().
+		ImagePrimitivePtr image() const;
+		/// Adds copies of the named channels to the image, skipping any the image
+		/// already has, so that only the channels actually used need ever be read.
+		void load( ImagePrimitive *image, const std::vector<std::string> &names );
+
+		/// Returns the ObjectPool used to store the channels.
+		ObjectPool *objectPool() const;
+
+	private :
+
+		struct MemberData;
+		boost::shared_ptr<MemberData> m_data;
+
+};
+
+IE_CORE_DECLAREPTR( ImageChannelLoader )
+
+} // namespace IECore
+
+#endif // IECORE_IMAGECHANNELLOADER_H
@@ -97,7 +97,7 @@ class IECORE_API ImageCompositeOp : public ImagePrimitiveOp
 			Intersection
 		} DataWindowResult;
 
-		typedef float (*CompositeFn)( float, float, float, float );
+		typedef void (*CompositeFn)( size_t, const float *, const float *, const float *, const float *, float * );
 
 		void composite( CompositeFn fn, DataWindowResult dwr, ImagePrimitive * imageB, const CompoundObject * operands );
 
@@ -111,9 +111,9 @@ class IECORE_API ImageCompositeOp : public ImagePrimitiveOp
 
 	private :
 		struct ChannelConverter;
+		class CompositeRows;
 
 		FloatVectorDataPtr getChannelData( ImagePrimitive * image, const std::string &channelName, bool mustExist = true );
-		float readChannelData( const ImagePrimitive * image, const FloatVectorData * data, const Imath::V2i &pixel );
 
 };
 
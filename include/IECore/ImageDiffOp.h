@@ -88,7 +88,7 @@ class IECORE_API ImageDiffOp : public Op
 		BoolParameterPtr m_skipMissingChannelsParameter;
 		BoolParameterPtr m_alignDisplayWindowsParameter;
 
-		struct FloatConverter;
+		struct SquaredError;
 
 };
 
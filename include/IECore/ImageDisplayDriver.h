@@ -38,6 +38,8 @@
 #ifndef IE_CORE_IMAGEDISPLAYDRIVER
 #define IE_CORE_IMAGEDISPLAYDRIVER
 
+#include "tbb/spin_mutex.h"
+
 #include "IECore/Export.h"
 #include "IECore/DisplayDriver.h"
 #include "IECore/ImagePrimitive.h"
@@ -61,6 +63,8 @@ class IECORE_API ImageDisplayDriver : public DisplayDriver
 
 		virtual bool scanLineOrderOnly() const;
 		virtual bool acceptsRepeatedData() const;
+		/// \threading May be called concurrently from multiple threads, provided
+		/// that the boxes don't overlap.
 		virtual void imageData( const Imath::Box2i &box, const float *data, size_t dataSize );
 		virtual void imageClose();
 
@@ -89,6 +93,11 @@ class IECORE_API ImageDisplayDriver : public DisplayDriver
 		static const DisplayDriverDescription<ImageDisplayDriver> g_description;
 
 		ImagePrimitivePtr m_image;
+		// The channels of m_image, in the order of channelNames().
+		std::vector<FloatVectorData *> m_channels;
+		// Protects the calls to writable() on m_channels, which
+		// would otherwise race if they need to copy the data.
+		tbb::spin_mutex m_writableMutex;
 
 };
 
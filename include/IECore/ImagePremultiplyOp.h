@@ -58,12 +58,17 @@ class IECORE_API ImagePremultiplyOp : public ChannelOp
 	protected :
 
 		virtual void modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels );
+		virtual void modifyTile( const Imath::Box2i &dataWindow, const Imath::Box2i &tile, const std::vector<float *> &channels ) const;
 
 		struct ToFloatVectorData;
-		struct PremultFn;
 
 		StringParameterPtr m_alphaChannelNameParameter;
 
+	private :
+
+		// Only valid during modifyChannels().
+		ConstFloatVectorDataPtr m_alphaData;
+
 };
 
 IE_CORE_DECLAREPTR( ImagePremultiplyOp );
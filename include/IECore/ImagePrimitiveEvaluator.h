@@ -119,6 +119,15 @@ class IECORE_API ImagePrimitiveEvaluator : public PrimitiveEvaluator
 		/// Returns the object-space point at the center of the specified pixel
 		virtual bool pointAtPixel( const Imath::V2i &pixel, PrimitiveEvaluator::Result *result ) const;
 
+		/// Samples the named channels at many uv positions at once, filling values with
+		/// channelNames.size() values for each uv, in the order of channelNames. The filtering
+		/// matches that of floatPrimVar() following pointAtUV(), and uvs outside the 0-1 range
+		/// give 0. The channel lookups are made once per call rather than once per sample,
+		/// and the samples are computed in parallel, making this much faster than sampling
+		/// via the Result interface. Throws if any channel is not FloatVectorData with one
+		/// value per pixel.
+		void channelsAtUVs( const std::vector<Imath::V2f> &uvs, const std::vector<std::string> &channelNames, std::vector<float> &values ) const;
+
 		virtual bool intersectionPoint( const Imath::V3f &origin, const Imath::V3f &direction,
 			PrimitiveEvaluator::Result *result, float maxDistance = Imath::limits<float>::max() ) const;
 
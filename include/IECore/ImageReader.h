@@ -140,6 +140,12 @@ class IECORE_API ImageReader : public Reader
 		/// in all derived classes. It is guaranteed that this function will not be called with 
 		/// invalid names or dataWindows which are not wholly within the dataWindow in the file.
 		virtual DataPtr readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw ) = 0;
+		/// Reads the specified area from several channels at once, placing the results in data in the
+		/// same order as names. This is called by doOperation(), and the same guarantees apply as for
+		/// readChannel(). The default implementation simply calls readChannel() for each channel in
+		/// turn, but derived classes may reimplement it for formats where reading interleaved channels
+		/// separately would mean decoding the same parts of the file repeatedly.
+		virtual void readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data );
 
 	private :
 
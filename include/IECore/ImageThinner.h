@@ -56,6 +56,11 @@ namespace IECore
 /// And this page indicates that it can be used without restriction :
 ///
 /// http://tog.acm.org/resources/GraphicsGems/
+///
+/// The thresholding is performed in parallel tiles, and each thinning
+/// subpass is double buffered so that scanlines can be processed in
+/// parallel while producing exactly the same results as the original
+/// serial scan.
 /// \ingroup imageProcessingGroup
 class IECORE_API ImageThinner : public ChannelOp
 {
@@ -75,7 +80,11 @@ class IECORE_API ImageThinner : public ChannelOp
 
 	protected :
 
+		/// Thresholds the channels using the tiled base class implementation,
+		/// and then thins each of them in turn.
 		virtual void modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels );
+		/// Performs the thresholding.
+		virtual void modifyTile( const Imath::Box2i &dataWindow, const Imath::Box2i &tile, const std::vector<float *> &channels ) const;
 
 };
 
@@ -47,6 +47,7 @@ namespace IECore
 {
 
 IE_CORE_FORWARDDECLARE( ImagePrimitive );
+IE_CORE_FORWARDDECLARE( CompoundData );
 
 /// Abstract base class for serializing images
 /// \ingroup ioGroup
@@ -82,6 +83,29 @@ class IECORE_API ImageWriter : public Writer
 		/// The base class is responsible for making sure it will happen.
 		virtual std::string destinationColorSpace() const = 0;
 
+		//! @name Incremental writing
+		/// As an alternative to write(), images may be written a block at a time,
+		/// for cases where holding the whole image in memory is impractical. The
+		/// fileName, channels, colorSpace and rawChannels parameters are used just
+		/// as they are by write(), but the object parameter is ignored. Block data
+		/// is laid out as for DisplayDriver::imageData(), with the values for all
+		/// channels interleaved for each pixel.
+		////////////////////////////////////////////////////////////
+		//@{
+		/// Starts writing an image. The blocks will contain data for the specified
+		/// channels, of which only those selected by the channels parameter are written.
+		/// The blindData is written as for ImagePrimitive::blindData().
+		void beginImage( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const std::vector<std::string> &channelNames, const CompoundData *blindData = 0 );
+		/// Writes a block of pixels, which must lie within the data window passed
+		/// to beginImage(). Blocks may be written in any order, but every pixel should
+		/// be written exactly once.
+		void writeBlock( const Imath::Box2i &box, const float *data, size_t dataSize );
+		/// Finishes writing the image started by beginImage().
+		void endImage();
+		//@}
+
+		virtual ~ImageWriter();
+
 	protected:
 
 		ImageWriter( const std::string &description );
@@ -94,15 +118,38 @@ class IECORE_API ImageWriter : public Writer
 		                         const ImagePrimitive * image,
 		                         const Imath::Box2i &dataWindow	) const = 0;
 
+		/// Called by beginImage(), writeBlock() and endImage() once they have validated their
+		/// arguments. The channels passed to doBeginImage() are only those to be written, and the
+		/// data passed to doWriteBlock() is interleaved to match. The default implementations
+		/// accumulate the blocks into an ImagePrimitive, which is written by writeImage() when the
+		/// image is finished. Derived classes may reimplement all three to write blocks directly to
+		/// the file as they arrive, calling the base class implementations for any images they can't
+		/// write that way.
+		virtual void doBeginImage( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const std::vector<std::string> &channelNames, const CompoundData *blindData );
+		virtual void doWriteBlock( const Imath::Box2i &box, const float *data );
+		virtual void doEndImage();
+
 	private :
 
 		/// Implementation of Writer::doWrite(). Calls through to writeImage()
 		virtual void doWrite( const CompoundObject *operands );
 
+		/// Performs the colorspace conversion requested in operands and calls writeImage().
+		void writeImagePrimitive( ConstImagePrimitivePtr image, const std::vector<std::string> &channels, const CompoundObject *operands );
+
 		StringVectorParameterPtr m_channelsParameter;
 		BoolParameterPtr m_rawChannelsParameter;
 		StringParameterPtr m_colorspaceParameter;
 
+		// State for the incremental writing methods.
+		bool m_writingBlocks;
+		Imath::Box2i m_blockDataWindow;
+		size_t m_blockNumChannels;
+		std::vector<size_t> m_blockChannelIndices;
+		std::vector<std::string> m_blockChannelNames;
+		std::vector<float> m_blockScratch;
+		ImagePrimitivePtr m_blockImage;
+
 };
 
 IE_CORE_DECLAREPTR(ImageWriter);
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IE_CORE_IMAGEWRITERDISPLAYDRIVER
+#define IE_CORE_IMAGEWRITERDISPLAYDRIVER
+
+#include "IECore/Export.h"
+#include "IECore/DisplayDriver.h"
+#include "IECore/ImageWriter.h"
+
+namespace IECore
+{
+
+/// Display driver that streams the image to disk using an ImageWriter, without
+/// holding the whole image in memory. The file is specified by a StringData
+/// "fileName" parameter, and the writer is chosen according to its extension.
+/// Parameters following the "header:" convention used by ImageDisplayDriver are
+/// written to the file header, for formats which support it.
+/// \ingroup renderingGroup
+class IECORE_API ImageWriterDisplayDriver : public DisplayDriver
+{
+	public:
+
+		IE_CORE_DECLARERUNTIMETYPED( ImageWriterDisplayDriver, DisplayDriver );
+
+		ImageWriterDisplayDriver( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const std::vector<std::string> &channelNames, ConstCompoundDataPtr parameters );
+		virtual ~ImageWriterDisplayDriver();
+
+		virtual bool scanLineOrderOnly() const;
+		virtual bool acceptsRepeatedData() const;
+		virtual void imageData( const Imath::Box2i &box, const float *data, size_t dataSize );
+		virtual void imageClose();
+
+		/// Returns the writer being used to write the image.
+		ConstImageWriterPtr writer() const;
+
+	private:
+
+		static const DisplayDriverDescription<ImageWriterDisplayDriver> g_description;
+
+		ImageWriterPtr m_writer;
+		bool m_open;
+
+};
+
+IE_CORE_DECLAREPTR( ImageWriterDisplayDriver )
+
+} // namespace IECore
+
+#endif // IE_CORE_IMAGEWRITERDISPLAYDRIVER
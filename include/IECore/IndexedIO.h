@@ -69,6 +69,18 @@ class IECORE_API IndexedIO : public RunTimeTyped
 
 			Shared    = 1L << 3,
 			Exclusive = 1L << 4,
+
+			/// May be combined with Read to request that implementations map the
+			/// file into memory rather than reading it through a stream. This allows
+			/// concurrent reads without locking, and is ignored by implementations
+			/// which don't support it.
+			MemoryMapped = 1L << 5,
+
+			/// May be combined with Read to request that implementations load the
+			/// contents of directories on demand, when they are first accessed, rather
+			/// than loading the whole index when the file is opened. Ignored by
+			/// implementations which don't support it.
+			LazyIndex = 1L << 6,
 		} ;
 
 		typedef unsigned OpenMode;
@@ -488,6 +500,41 @@ class IECORE_API IndexedIO : public RunTimeTyped
 		/// \param x Returns the data read.
 		virtual void read(const IndexedIO::EntryID &name, unsigned short &x) const  = 0;
 
+		/// Describes a single array entry for use with writeArrays() and readArrays().
+		/// Only arrays of the numeric types are supported.
+		struct IECORE_API Array
+		{
+			Array();
+			/// For writeArrays(), data should point to the arrayLength elements to
+			/// be written. For readArrays(), it should point to a buffer with room
+			/// for arrayLength elements, which will be filled by the read.
+			template<typename T>
+			Array( const IndexedIO::EntryID &name, const T *data, unsigned long arrayLength );
+
+			IndexedIO::EntryID name;
+			IndexedIO::DataType dataType;
+			void *data;
+			unsigned long arrayLength;
+			size_t elementSize;
+		};
+		typedef std::vector<Array> ArrayList;
+
+		/// Creates a file for each of the arrays. This is equivalent to calling write() for
+		/// each array in turn, which is what the default implementation does, but derived
+		/// classes may implement it with fewer separate I/O operations.
+		virtual void writeArrays( const ArrayList &arrays );
+
+		/// Fills the buffers of each of the arrays from existing files. This is equivalent to
+		/// calling read() for each array in turn, which is what the default implementation
+		/// does, but derived classes may coalesce the reads of entries stored together.
+		virtual void readArrays( const ArrayList &arrays ) const;
+
+		/// Fills the buffer of the array with arrayLength elements of an existing array file,
+		/// starting from element begin. Throws if the file has a different data type or is too
+		/// short. The default implementation reads the whole file and copies out the range, but
+		/// derived classes may read just the part required.
+		virtual void readArrayRange( const Array &array, unsigned long begin ) const;
+
 		/// A representation of a single file/directory
 		class IECORE_API Entry
 		{
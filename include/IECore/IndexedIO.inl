@@ -547,4 +547,10 @@ struct IndexedIO::DataFlattenTraits<std::string*>
 	}
 };
 
+template<typename T>
+IndexedIO::Array::Array( const IndexedIO::EntryID &name, const T *data, unsigned long arrayLength )
+	:	name( name ), dataType( IndexedIO::DataTypeTraits<T*>::type() ), data( const_cast<T *>( data ) ), arrayLength( arrayLength ), elementSize( sizeof( T ) )
+{
+}
+
 } // namespace IECore
@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_INSTANCERALGO_H
+#define IECORE_INSTANCERALGO_H
+
+#include <vector>
+
+#include "OpenEXR/ImathMatrix.h"
+
+#include "IECore/Renderer.h"
+
+namespace IECore
+{
+
+/// Utilities for Renderer implementations supporting the "instancer" geometry
+/// type. See Renderer::geometry() for a description of its arguments.
+namespace InstancerAlgo
+{
+
+/// Returns the names of the prototypes, throwing an InvalidArgumentException
+/// if the "prototypes" topology is missing or of the wrong type.
+IECORE_API const std::vector<std::string> &prototypes( const CompoundDataMap &topology );
+
+/// Fills indices with the index of the prototype used by each point, throwing
+/// an InvalidArgumentException if any is out of range.
+IECORE_API void prototypeIndices( const PrimitiveVariableMap &primVars, size_t numPrototypes, std::vector<int> &indices );
+
+/// Fills transforms with the transform of each point. These are computed
+/// concurrently, and an InvalidArgumentException is thrown if the primitive
+/// variables are missing or have mismatched lengths.
+IECORE_API void transforms( const PrimitiveVariableMap &primVars, std::vector<Imath::M44f> &transforms );
+
+/// Renders the instancer as a call to Renderer::instance() for each point.
+/// This is intended for use by Renderer implementations which have no
+/// more efficient representation of their own.
+IECORE_API void render( const CompoundDataMap &topology, const PrimitiveVariableMap &primVars, Renderer *renderer );
+
+} // namespace InstancerAlgo
+
+} // namespace IECore
+
+#endif // IECORE_INSTANCERALGO_H
@@ -36,6 +36,9 @@
 #define IECORE_INTERNEDSTRING_H
 
 #include <string>
+#include <vector>
+
+#include "boost/functional/hash.hpp"
 
 #include "IECore/Export.h"
 
@@ -84,6 +87,15 @@ class IECORE_API InternedString
 		inline const std::string &string() const;
 		inline const char *c_str() const;
 
+		/// Interns a batch of strings, each specified by a pointer to its
+		/// characters and a length, placing the results in the result array,
+		/// which must already hold count elements. This is more efficient than
+		/// constructing InternedStrings individually when many are needed at
+		/// once, such as when reading the names from a file.
+		static void intern( size_t count, const char * const *values, const size_t *lengths, InternedString *result );
+		/// As above, but for a vector of strings. The result is resized to match.
+		static void intern( const std::vector<std::string> &values, std::vector<InternedString> &result );
+
 		static size_t numUniqueStrings();
 
 	private :
@@ -100,6 +112,11 @@ class IECORE_API InternedString
 
 IECORE_API std::ostream &operator << ( std::ostream &o, const InternedString &str );
 
+/// Implementation of hash_value for InternedString, allowing it to be used with boost::hash,
+/// and therefore as a key in boost::unordered_map. Like the comparison operators it only
+/// uses the address of the internal unique string, so it is extremely fast.
+inline size_t hash_value( const InternedString &str );
+
 } // namespace IECore
 
 #include "IECore/InternedString.inl"
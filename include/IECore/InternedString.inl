@@ -107,6 +107,11 @@ inline const char *InternedString::c_str() const
 	return m_value->c_str();
 }
 
+inline size_t hash_value( const InternedString &str )
+{
+	return boost::hash<const std::string *>()( &str.string() );
+}
+
 } // namespace IECore
 
 #endif // IECORE_INTERNEDSTRING_INL
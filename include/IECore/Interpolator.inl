@@ -34,9 +34,80 @@
 
 #include "IECore/TypedData.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 namespace IECore
 {
 
+namespace Detail
+{
+
+template<typename T>
+class VectorLinearInterpolator
+{
+
+	public :
+
+		VectorLinearInterpolator( const std::vector<T> &y0, const std::vector<T> &y1, double x, std::vector<T> &result )
+			:	m_y0( y0 ), m_y1( y1 ), m_x( x ), m_result( result )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			LinearInterpolator<T> interp;
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				interp( m_y0[i], m_y1[i], m_x, m_result[i] );
+			}
+		}
+
+	private :
+
+		const std::vector<T> &m_y0;
+		const std::vector<T> &m_y1;
+		double m_x;
+		std::vector<T> &m_result;
+
+};
+
+template<typename T>
+class VectorCubicInterpolator
+{
+
+	public :
+
+		VectorCubicInterpolator( const std::vector<T> &y0, const std::vector<T> &y1, const std::vector<T> &y2, const std::vector<T> &y3, double x, std::vector<T> &result )
+			:	m_y0( y0 ), m_y1( y1 ), m_y2( y2 ), m_y3( y3 ), m_x( x ), m_result( result )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			CubicInterpolator<T> interp;
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				interp( m_y0[i], m_y1[i], m_y2[i], m_y3[i], m_x, m_result[i] );
+			}
+		}
+
+	private :
+
+		const std::vector<T> &m_y0;
+		const std::vector<T> &m_y1;
+		const std::vector<T> &m_y2;
+		const std::vector<T> &m_y3;
+		double m_x;
+		std::vector<T> &m_result;
+
+};
+
+// Vectors smaller than this are interpolated serially.
+static const size_t g_vectorInterpolationGrainSize = 4096;
+
+} // namespace Detail
+
 template<typename T>
 void LinearInterpolator<T>::operator()(const T &y0, const T & y1, double x, T &result) const
 {
@@ -74,10 +145,14 @@ struct LinearInterpolator< std::vector<T> >
 
 		result.resize( size );
 
-		LinearInterpolator<T> interp;
-		for (unsigned i = 0; i < size; i++)
+		Detail::VectorLinearInterpolator<T> interp( y0, y1, x, result );
+		if( size < Detail::g_vectorInterpolationGrainSize )
 		{
-			interp( y0[i], y1[i], x, result[i]);
+			interp( tbb::blocked_range<size_t>( 0, size ) );
+		}
+		else
+		{
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, size, Detail::g_vectorInterpolationGrainSize ), interp );
 		}
 
 		assert(result.size() == size);
@@ -103,10 +178,14 @@ struct CubicInterpolator< std::vector<T> >
 
 		result.resize( size );
 
-		CubicInterpolator<T> interp;
-		for (unsigned i = 0; i < size; i++)
+		Detail::VectorCubicInterpolator<T> interp( y0, y1, y2, y3, x, result );
+		if( size < Detail::g_vectorInterpolationGrainSize )
+		{
+			interp( tbb::blocked_range<size_t>( 0, size ) );
+		}
+		else
 		{
-			interp( y0[i], y1[i], y2[i], y3[i], x, result[i]);
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, size, Detail::g_vectorInterpolationGrainSize ), interp );
 		}
 
 		assert(result.size() == size);
@@ -87,9 +87,47 @@ class InverseDistanceWeightedInterpolation
 		/// has to allocate a NeighbourVector each time.
 		Value operator()( const Point &p, NeighbourVector &neighbours ) const;
 
+		/// Stores the normalised weights computed for a batch of query points, so that
+		/// they may be reused to interpolate several sets of values without repeating
+		/// the neighbour searches.
+		struct Weights
+		{
+			/// The number of entries stored per query point.
+			unsigned int numNeighbours;
+			/// The indices of the points contributing to each query, with the entries
+			/// for the ith query starting at indices[i * numNeighbours].
+			std::vector<size_t> indices;
+			/// The weights corresponding to indices. Surplus entries have a weight of 0.
+			std::vector<PointBaseType> weights;
+		};
+
+		/// Computes the weights for every point in the range [first, last), distributing
+		/// the queries across multiple threads. QueryIterator must be a random access iterator.
+		template<typename QueryIterator>
+		void weights( QueryIterator first, QueryIterator last, Weights &weights ) const;
+		/// Evaluates the interpolated values for previously computed weights, distributing
+		/// the work across multiple threads. firstValue is the first of the values
+		/// corresponding to the points passed to the constructor - these needn't be the values
+		/// passed to the constructor, so that several attributes may be transferred using the
+		/// same weights. ResultIterator must be a random access iterator to a range with
+		/// room for a value per query.
+		template<typename ValueIterator2, typename ResultIterator>
+		static void interpolate( const Weights &weights, ValueIterator2 firstValue, ResultIterator result );
+		/// Evaluates the interpolated value for every point in the range [first, last),
+		/// distributing the queries across multiple threads.
+		template<typename QueryIterator, typename ResultIterator>
+		void operator()( QueryIterator first, QueryIterator last, ResultIterator result ) const;
 
 	private :
 
+		template<typename QueryIterator>
+		class WeightsTask;
+
+		template<typename ValueIterator2, typename ResultIterator>
+		class InterpolateTask;
+
+		static PointBaseType neighbourWeight( PointBaseType distanceToFurthest, PointBaseType distSquared );
+
 		Tree *m_tree;
 		PointIterator m_firstPoint;
 		ValueIterator m_firstValue;
@@ -33,12 +33,111 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include "IECore/VectorOps.h"
 #include "OpenEXR/ImathLimits.h"
 
 namespace IECore
 {
 
+template<typename PointIterator, typename ValueIterator>
+template<typename QueryIterator>
+class InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::WeightsTask
+{
+	public :
+
+		WeightsTask( const Tree *tree, PointIterator firstPoint, QueryIterator first, Weights &weights )
+			:	m_tree( tree ), m_firstPoint( firstPoint ), m_first( first ), m_weights( weights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			const unsigned int numNeighbours = m_weights.numNeighbours;
+
+			NeighbourVector neighbours;
+			neighbours.reserve( numNeighbours );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				neighbours.clear();
+				m_tree->nearestNNeighbours( *(m_first + i), numNeighbours, neighbours );
+				if( neighbours.empty() )
+				{
+					continue;
+				}
+
+				size_t *indices = &m_weights.indices[i * numNeighbours];
+				PointBaseType *weights = &m_weights.weights[i * numNeighbours];
+
+				const PointBaseType distanceToFurthest = std::max<PointBaseType>( Imath::Math<PointBaseType>::sqrt( neighbours.rbegin()->distSquared ), 1.e-6 );
+				PointBaseType totalNeighbourWeight = 0.0;
+				for( size_t j = 0, e = neighbours.size(); j < e; ++j )
+				{
+					indices[j] = neighbours[j].point - m_firstPoint;
+					weights[j] = neighbourWeight( distanceToFurthest, neighbours[j].distSquared );
+					totalNeighbourWeight += weights[j];
+				}
+
+				const PointBaseType normaliser = 1.0 / totalNeighbourWeight;
+				for( size_t j = 0, e = neighbours.size(); j < e; ++j )
+				{
+					weights[j] *= normaliser;
+				}
+			}
+		}
+
+	private :
+
+		const Tree *m_tree;
+		PointIterator m_firstPoint;
+		QueryIterator m_first;
+		Weights &m_weights;
+};
+
+template<typename PointIterator, typename ValueIterator>
+template<typename ValueIterator2, typename ResultIterator>
+class InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::InterpolateTask
+{
+	public :
+
+		InterpolateTask( const Weights &weights, ValueIterator2 firstValue, ResultIterator result )
+			:	m_weights( weights ), m_firstValue( firstValue ), m_result( result )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			typedef typename std::iterator_traits<ValueIterator2>::value_type Value2;
+
+			const unsigned int numNeighbours = m_weights.numNeighbours;
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const size_t *indices = &m_weights.indices[i * numNeighbours];
+				const PointBaseType *weights = &m_weights.weights[i * numNeighbours];
+
+				Value2 result;
+				vecSetAll( result, 0 );
+				for( unsigned int j = 0; j < numNeighbours; ++j )
+				{
+					if( weights[j] != 0 )
+					{
+						result = result + ( *(m_firstValue + indices[j]) * weights[j] );
+					}
+				}
+				*(m_result + i) = result;
+			}
+		}
+
+	private :
+
+		const Weights &m_weights;
+		ValueIterator2 m_firstValue;
+		ResultIterator m_result;
+};
+
 template<typename PointIterator, typename ValueIterator>
 InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::InverseDistanceWeightedInterpolation(
 	PointIterator firstPoint,
@@ -91,18 +190,11 @@ typename InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::Val
 
 			const Value &neighbourValue = *(m_firstValue + (neighbourPointIt - m_firstPoint));
 
-			PointBaseType distanceToNeighbour = std::max<PointBaseType>( Imath::Math<PointBaseType>::sqrt( it->distSquared ), 1.e-6 );
-			assert( distanceToNeighbour <= distanceToFurthest );
-
-			// Franke & Nielson's (1980) improvement on Shephard's original weight function
-			PointBaseType neighbourWeight = ( distanceToFurthest - distanceToNeighbour ) / ( distanceToFurthest * distanceToNeighbour );
-			assert( neighbourWeight >= -Imath::limits<PointBaseType>::epsilon() );
-
-			neighbourWeight = std::max<PointBaseType>(neighbourWeight * neighbourWeight, 1.e-6 );
+			const PointBaseType weight = neighbourWeight( distanceToFurthest, it->distSquared );
 
-			result = result + ( neighbourValue * neighbourWeight );
+			result = result + ( neighbourValue * weight );
 
-			totalNeighbourWeight += neighbourWeight;
+			totalNeighbourWeight += weight;
 		}
 
 		result = result * ( 1.0 / totalNeighbourWeight );
@@ -111,5 +203,67 @@ typename InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::Val
 	return result;
 }
 
+template<typename PointIterator, typename ValueIterator>
+template<typename QueryIterator>
+void InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::weights( QueryIterator first, QueryIterator last, Weights &weights ) const
+{
+	assert( m_tree );
+
+	const size_t numQueries = last - first;
+	weights.numNeighbours = m_numNeighbours;
+	weights.indices.assign( numQueries * m_numNeighbours, 0 );
+	weights.weights.assign( numQueries * m_numNeighbours, 0 );
+	if( !m_numNeighbours )
+	{
+		return;
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numQueries ),
+		WeightsTask<QueryIterator>( m_tree, m_firstPoint, first, weights )
+	);
+}
+
+template<typename PointIterator, typename ValueIterator>
+template<typename ValueIterator2, typename ResultIterator>
+void InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::interpolate( const Weights &weights, ValueIterator2 firstValue, ResultIterator result )
+{
+	const size_t numQueries = weights.numNeighbours ? weights.weights.size() / weights.numNeighbours : 0;
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numQueries ),
+		InterpolateTask<ValueIterator2, ResultIterator>( weights, firstValue, result )
+	);
+}
+
+template<typename PointIterator, typename ValueIterator>
+template<typename QueryIterator, typename ResultIterator>
+void InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::operator()( QueryIterator first, QueryIterator last, ResultIterator result ) const
+{
+	Weights w;
+	weights( first, last, w );
+	if( !w.numNeighbours )
+	{
+		// no neighbours contribute, so match the zero
+		// result of the single point query.
+		Value zero;
+		vecSetAll( zero, 0 );
+		std::fill( result, result + ( last - first ), zero );
+		return;
+	}
+	interpolate( w, m_firstValue, result );
+}
+
+template<typename PointIterator, typename ValueIterator>
+typename InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::PointBaseType InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::neighbourWeight( PointBaseType distanceToFurthest, PointBaseType distSquared )
+{
+	const PointBaseType distanceToNeighbour = std::max<PointBaseType>( Imath::Math<PointBaseType>::sqrt( distSquared ), 1.e-6 );
+	assert( distanceToNeighbour <= distanceToFurthest );
+
+	// Franke & Nielson's (1980) improvement on Shephard's original weight function
+	PointBaseType weight = ( distanceToFurthest - distanceToNeighbour ) / ( distanceToFurthest * distanceToNeighbour );
+	assert( weight >= -Imath::limits<PointBaseType>::epsilon() );
+
+	return std::max<PointBaseType>( weight * weight, 1.e-6 );
+}
 
 } // namespace IECore
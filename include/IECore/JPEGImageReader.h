@@ -37,11 +37,15 @@
 
 #include "IECore/Export.h"
 #include "IECore/ImageReader.h"
+#include "IECore/NumericParameter.h"
 
 namespace IECore
 {
 
-/// The JPEGImageReader reads Joint Photographic Experts Group (JPEG) files
+/// The JPEGImageReader reads Joint Photographic Experts Group (JPEG) files.
+/// Images may be decoded at a reduced resolution, which is much faster
+/// than decoding in full and resizing afterwards, and is ideal for generating
+/// thumbnails and proxies.
 /// \ingroup ioGroup
 class IECORE_API JPEGImageReader : public ImageReader
 {
@@ -56,6 +60,11 @@ class IECORE_API JPEGImageReader : public ImageReader
 
 		static bool canRead( const std::string &filename );
 
+		/// The factor by which the image is reduced in size as it is decoded.
+		/// One of 1, 2, 4 or 8. The data and display windows are reduced accordingly.
+		IntParameter *reductionParameter();
+		const IntParameter *reductionParameter() const;
+
 		//! @name Image specific reading functions
 		///////////////////////////////////////////////////////////////
 		//@{
@@ -83,6 +92,7 @@ class IECORE_API JPEGImageReader : public ImageReader
 	private:
 
 		virtual DataPtr readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw );
+		virtual void readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data );
 
 		/// Registers this reader with system
 		static const ReaderDescription<JPEGImageReader> m_readerDescription;
@@ -93,8 +103,9 @@ class IECORE_API JPEGImageReader : public ImageReader
 		/// If throwOnFailure is true then a descriptive Exception is thrown rather than false being returned.
 		bool open( bool throwOnFailure = false );
 
-		/// The filename we filled the buffer from
+		/// The filename and reduction we filled the buffer from
 		std::string m_bufferFileName;
+		int m_bufferReduction;
 
 		/// Decompressed image data buffer
 		std::vector<unsigned char> m_buffer;
@@ -104,8 +115,16 @@ class IECORE_API JPEGImageReader : public ImageReader
 		int m_bufferHeight;
 		int m_numChannels;
 
+		IntParameterPtr m_reductionParameter;
+
+		void constructParameters();
+
+		/// Returns the offset of the named channel within each pixel of the buffer.
+		int channelOffset( const std::string &name ) const;
+
+		/// Extracts several channels from the buffer in a single pass.
 		template<typename V>
-		DataPtr readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow, int channelOffset );
+		void readTypedChannels( const std::vector<int> &channelOffsets, const Imath::Box2i &dataWindow, std::vector<DataPtr> &data );
 
 };
 
@@ -74,6 +74,7 @@ class KDTree
 		/// Builds the tree for the specified points - the iterator range
 		/// must remain valid and unchanged as long as the tree is in use.
 		/// This method can be called again to rebuild the tree at any time.
+		/// Large trees are built using multiple threads.
 		/// \threading This can't be called while other threads are
 		/// making queries.
 		void init( PointIterator first, PointIterator last, int maxLeafSize=4  );
@@ -100,6 +101,15 @@ class KDTree
 		/// Populates the passed vector with the N closest neighbours to p, sorted with the closest first. Returns the number found.
 		/// \threading May be called by multiple concurrent threads provided they are each using a different vector for the result.
 		unsigned int nearestNNeighbours( const Point &p, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours ) const;
+		/// Performs nearestNNeighbours() for every point in the range [first, last), distributing the
+		/// queries across multiple threads. QueryIterator must be a random access iterator. On return
+		/// nearNeighbours holds numNeighbours entries per query point, sorted with the closest first, with
+		/// the results for the ith query starting at nearNeighbours[i * numNeighbours]. Should the tree
+		/// contain fewer than numNeighbours points, the surplus entries have a point equal to the end of
+		/// the points passed to init(), and a distSquared of limits<BaseType>::max().
+		/// \threading May be called by multiple concurrent threads provided they are each using a different vector for the result.
+		template<typename QueryIterator>
+		void nearestNNeighbours( QueryIterator first, QueryIterator last, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours ) const;
 
 		/// Finds all the points contained by the specified bound, outputting them to the specified iterator.
 		/// \threading May be called by multiple concurrent threads.
@@ -128,8 +138,12 @@ class KDTree
 		typedef typename Permutation::const_iterator PermutationConstIterator;
 
 		class AxisSort;
+		class BuildTask;
+		template<typename QueryIterator>
+		class NearestNNeighboursTask;
 
 		unsigned char majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast );
+		NodeIndex maxNodeIndex( NodeIndex nodeIndex, NodeIndex numPoints ) const;
 		void build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast );
 
 		void nearestNeighbourWalk( NodeIndex nodeIndex, const Point &p, PointIterator &closestPoint, BaseType &distSquared ) const;
@@ -33,6 +33,11 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+
 #include "OpenEXR/ImathLimits.h"
 #include "IECore/VectorOps.h"
 #include "IECore/BoxOps.h"
@@ -40,6 +45,14 @@
 namespace IECore
 {
 
+namespace Detail
+{
+
+// Subtrees with more points than this are built in parallel.
+static const size_t g_kdTreeParallelBuildThreshold = 4096;
+
+} // namespace Detail
+
 template<class PointIterator>
 inline bool KDTree<PointIterator>::Node::isLeaf() const
 {
@@ -108,6 +121,59 @@ class KDTree<PointIterator>::AxisSort
 		const unsigned int m_axis;
 };
 
+template<class PointIterator>
+class KDTree<PointIterator>::BuildTask
+{
+	public :
+
+		BuildTask( KDTree *tree, NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
+			:	m_tree( tree ), m_nodeIndex( nodeIndex ), m_permFirst( permFirst ), m_permLast( permLast )
+		{
+		}
+
+		void operator()() const
+		{
+			m_tree->build( m_nodeIndex, m_permFirst, m_permLast );
+		}
+
+	private :
+
+		KDTree *m_tree;
+		NodeIndex m_nodeIndex;
+		PermutationIterator m_permFirst;
+		PermutationIterator m_permLast;
+};
+
+template<class PointIterator>
+template<typename QueryIterator>
+class KDTree<PointIterator>::NearestNNeighboursTask
+{
+	public :
+
+		NearestNNeighboursTask( const KDTree *tree, QueryIterator first, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours )
+			:	m_tree( tree ), m_first( first ), m_numNeighbours( numNeighbours ), m_nearNeighbours( nearNeighbours )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			std::vector<Neighbour> neighbours;
+			neighbours.reserve( m_numNeighbours );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_tree->nearestNNeighbours( *(m_first + i), m_numNeighbours, neighbours );
+				std::copy( neighbours.begin(), neighbours.end(), m_nearNeighbours.begin() + i * m_numNeighbours );
+			}
+		}
+
+	private :
+
+		const KDTree *m_tree;
+		QueryIterator m_first;
+		unsigned int m_numNeighbours;
+		std::vector<Neighbour> &m_nearNeighbours;
+};
+
 // initialisation
 
 template<class PointIterator>
@@ -133,10 +199,28 @@ void KDTree<PointIterator>::init( PointIterator first, PointIterator last, int m
 		m_perm[i++] = it;
 	}
 
-	/// \todo Can we reserve() enough space for m_nodes before doing this?
+	// size m_nodes up front, so that subtrees can be built concurrently
+	// without reallocating the vector underneath each other.
+	m_nodes.clear();
+	m_nodes.resize( maxNodeIndex( rootIndex(), m_perm.size() ) + 1 );
 	build( rootIndex(), m_perm.begin(), m_perm.end() );
 }
 
+template<class PointIterator>
+typename KDTree<PointIterator>::NodeIndex KDTree<PointIterator>::maxNodeIndex( NodeIndex nodeIndex, NodeIndex numPoints ) const
+{
+	// mirrors the splitting performed by build()
+	if( numPoints > (NodeIndex)m_maxLeafSize )
+	{
+		const NodeIndex numLow = numPoints / 2;
+		return std::max(
+			maxNodeIndex( lowChildIndex( nodeIndex ), numLow ),
+			maxNodeIndex( highChildIndex( nodeIndex ), numPoints - numLow )
+		);
+	}
+	return nodeIndex;
+}
+
 template<class PointIterator>
 unsigned char KDTree<PointIterator>::majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast )
 {
@@ -174,11 +258,8 @@ unsigned char KDTree<PointIterator>::majorAxis( PermutationConstIterator permFir
 template<class PointIterator>
 void KDTree<PointIterator>::build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
 {
-	// make room for the new node
-	if( nodeIndex>=m_nodes.size() )
-	{
-		m_nodes.resize( nodeIndex+1 );
-	}
+	// init() has already made room for all the nodes
+	assert( nodeIndex < m_nodes.size() );
 
 	if( permLast - permFirst > m_maxLeafSize )
 	{
@@ -189,8 +270,20 @@ void KDTree<PointIterator>::build( NodeIndex nodeIndex, PermutationIterator perm
 		// insert node
 		m_nodes[nodeIndex].makeBranch( cutAxis, cutValue );
 
-		build( lowChildIndex( nodeIndex ), permFirst, permMid );
-		build( highChildIndex( nodeIndex ), permMid, permLast );
+		if( (size_t)( permLast - permFirst ) > Detail::g_kdTreeParallelBuildThreshold )
+		{
+			// the two halves of the permutation and the two subtrees
+			// are entirely disjoint, so can be built concurrently.
+			tbb::parallel_invoke(
+				BuildTask( this, lowChildIndex( nodeIndex ), permFirst, permMid ),
+				BuildTask( this, highChildIndex( nodeIndex ), permMid, permLast )
+			);
+		}
+		else
+		{
+			build( lowChildIndex( nodeIndex ), permFirst, permMid );
+			build( highChildIndex( nodeIndex ), permMid, permLast );
+		}
 	}
 	else
 	{
@@ -250,6 +343,23 @@ unsigned int KDTree<PointIterator>::nearestNNeighbours( const Point &p, unsigned
 	return nearNeighbours.size();
 }
 
+template<class PointIterator>
+template<typename QueryIterator>
+void KDTree<PointIterator>::nearestNNeighbours( QueryIterator first, QueryIterator last, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours ) const
+{
+	const size_t numQueries = last - first;
+	nearNeighbours.assign( numQueries * numNeighbours, Neighbour( m_lastPoint, Imath::limits<BaseType>::max() ) );
+	if( !numNeighbours )
+	{
+		return;
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numQueries ),
+		NearestNNeighboursTask<QueryIterator>( this, first, numNeighbours, nearNeighbours )
+	);
+}
+
 template<class PointIterator>
 void KDTree<PointIterator>::nearestNeighbourWalk( NodeIndex nodeIndex, const Point &p, PointIterator &closestPoint, BaseType &distSquared ) const
 {
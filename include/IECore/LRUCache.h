@@ -36,14 +36,291 @@
 #define IECORE_LRUCACHE_H
 
 #include "tbb/spin_mutex.h"
+#include "tbb/atomic.h"
 #include "tbb/concurrent_unordered_map.h"
+#include "tbb/tick_count.h"
+
+#include <map>
 
 #include "boost/noncopyable.hpp"
 #include "boost/function.hpp"
+#include "boost/cstdint.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/condition_variable.hpp"
+
+/// Cache statistics are gathered unless IECORE_LRUCACHE_STATISTICS is
+/// defined to be 0, in which case the counters are never updated.
+#ifndef IECORE_LRUCACHE_STATISTICS
+#define IECORE_LRUCACHE_STATISTICS 1
+#endif
 
 namespace IECore
 {
 
+/// Statistics describing the use of a cache since it was constructed, or
+/// since its statistics were last reset.
+struct LRUCacheStatistics
+{
+	LRUCacheStatistics();
+
+	/// Number of lookups which found a cached value.
+	size_t hits;
+	/// Number of lookups which had to compute a value.
+	size_t misses;
+	/// Number of values removed to meet the cost limit.
+	size_t evictions;
+	/// Total time in seconds spent computing values.
+	double getterTime;
+};
+
+/// Threadsafe counters for accumulating LRUCacheStatistics. These are
+/// used by LRUCache, ObjectPool and ComputationCache, and do nothing if
+/// IECORE_LRUCACHE_STATISTICS is 0.
+class LRUCacheStatisticsCounters : private boost::noncopyable
+{
+
+	public :
+
+		LRUCacheStatisticsCounters();
+
+		void hit();
+		void miss();
+		void eviction();
+
+		/// Adds the time elapsed during its lifetime to the getterTime.
+		class ScopedGetterTimer : private boost::noncopyable
+		{
+
+			public :
+
+				ScopedGetterTimer( LRUCacheStatisticsCounters &counters );
+				~ScopedGetterTimer();
+
+			private :
+
+#if IECORE_LRUCACHE_STATISTICS
+				LRUCacheStatisticsCounters &m_counters;
+				tbb::tick_count m_start;
+#endif
+
+		};
+
+		LRUCacheStatistics statistics() const;
+		void reset();
+
+	private :
+
+		friend class ScopedGetterTimer;
+
+		tbb::atomic<size_t> m_hits;
+		tbb::atomic<size_t> m_misses;
+		tbb::atomic<size_t> m_evictions;
+		tbb::atomic<boost::uint64_t> m_getterNanoseconds;
+
+};
+
+/// Policies determining which items an LRUCache removes when it needs to
+/// reduce its cost. A policy is a class template instantiated on the
+/// (internal) item type of the cache. Each item stores an instance of the
+/// policy's ItemData, and the cache calls touch() with the cost of the item
+/// whenever it is stored or retrieved, and pop() whenever it needs to choose
+/// an item to remove. Both may be called concurrently, and without the cache
+/// holding any locks. The cache tolerates items which are tracked by the policy after they have been
+/// erased, discarding them when they are popped, so policies don't need to be
+/// notified of removals.
+namespace LRUCachePolicy
+{
+
+namespace Detail
+{
+
+/// Doubly linked list threaded through the ItemData of the items, which
+/// must provide previous and next pointers. Not threadsafe.
+template<typename Item>
+struct List
+{
+	List();
+
+	void unlink( Item *item );
+	void append( Item *item );
+
+	Item *head;
+	Item *tail;
+	size_t size;
+};
+
+} // namespace Detail
+
+/// Removes items in exact least recently used order. A single mutex protects
+/// the recency list and is taken for every lookup, so heavily threaded use may
+/// contend on it.
+template<typename Item>
+class Exact
+{
+
+	public :
+
+		struct ItemData
+		{
+			ItemData();
+			// Copies start out untracked.
+			ItemData( const ItemData &other );
+
+			Item *previous;
+			Item *next;
+			bool linked;
+		};
+
+		Exact();
+
+		void touch( Item *item, size_t cost );
+		Item *pop();
+
+	private :
+
+		typedef tbb::spin_mutex Mutex;
+		Mutex m_mutex;
+		Detail::List<Item> m_list;
+
+};
+
+/// Approximates least recently used order using the "second chance" (CLOCK)
+/// algorithm. Items are distributed between several shards, each with its own
+/// list and mutex. Cache hits on items which are already tracked don't take any
+/// lock, and simply mark the item as referenced. When an item is needed for
+/// removal, the oldest head of all the shards is chosen, and referenced items
+/// are given a second chance by being moved to the end of their list.
+template<typename Item>
+class Sharded
+{
+
+	public :
+
+		struct ItemData
+		{
+			ItemData();
+			// Copies start out untracked.
+			ItemData( const ItemData &other );
+
+			Item *previous;
+			Item *next;
+			size_t tick;
+			tbb::atomic<bool> linked;
+			tbb::atomic<bool> referenced;
+		};
+
+		Sharded();
+
+		void touch( Item *item, size_t cost );
+		Item *pop();
+
+	private :
+
+		struct Shard
+		{
+			typedef tbb::spin_mutex Mutex;
+			Mutex mutex;
+			Detail::List<Item> list;
+		};
+
+		enum { NumShards = 16 };
+
+		Shard &shard( const Item *item );
+		// Caller must hold the mutex for the shard.
+		void append( Shard &shard, Item *item );
+
+		Shard m_shards[NumShards];
+		tbb::atomic<size_t> m_tick;
+
+};
+
+/// A scan resistant policy, implementing the simplified form of the "2Q" algorithm.
+/// Newly stored items enter a FIFO queue, and are only promoted to the main LRU
+/// queue when they are accessed again. Items are removed from the FIFO queue
+/// while it holds more than a quarter of the items, so that a long sequence of
+/// one-off lookups doesn't flush a frequently used working set from the cache.
+template<typename Item>
+class TwoQueue
+{
+
+	public :
+
+		struct ItemData
+		{
+			ItemData();
+			// Copies start out untracked.
+			ItemData( const ItemData &other );
+
+			Item *previous;
+			Item *next;
+			char queue;
+		};
+
+		TwoQueue();
+
+		void touch( Item *item, size_t cost );
+		Item *pop();
+
+	private :
+
+		enum Queue
+		{
+			None,
+			In,
+			Main
+		};
+
+		typedef tbb::spin_mutex Mutex;
+		Mutex m_mutex;
+		Detail::List<Item> m_in;
+		Detail::List<Item> m_main;
+
+};
+
+/// A cost aware policy implementing the "GreedyDual-Size-Frequency" algorithm.
+/// Each item is given a priority which increases with the number of times it
+/// has been accessed and decreases with its cost, and the item with the lowest
+/// priority is removed first. An inflation value, raised to the priority of each
+/// removed item, ages items which are no longer being accessed. This favours
+/// keeping many cheap items over a few costly ones, maximising the number of
+/// hits for a given total cost.
+template<typename Item>
+class CostWeighted
+{
+
+	private :
+
+		typedef std::multimap<double, Item *> PriorityQueue;
+
+	public :
+
+		struct ItemData
+		{
+			ItemData();
+			// Copies start out untracked.
+			ItemData( const ItemData &other );
+
+			bool linked;
+			size_t frequency;
+			typename PriorityQueue::iterator position;
+		};
+
+		CostWeighted();
+
+		void touch( Item *item, size_t cost );
+		Item *pop();
+
+	private :
+
+		typedef tbb::spin_mutex Mutex;
+		Mutex m_mutex;
+		PriorityQueue m_queue;
+		double m_inflation;
+
+};
+
+} // namespace LRUCachePolicy
+
 /// A mapping from keys to values, where values are computed from keys using a user
 /// supplied function. Recently computed values are stored in the cache to accelerate
 /// subsequent lookups. Each value has a cost associated with it, and the cache has
@@ -55,9 +332,12 @@ namespace IECore
 /// Note that Values are returned by value, and erased by assigning a default constructed
 /// value. In practice this means that a smart pointer is the best choice of Value.
 ///
+/// The Policy determines which items are removed to meet the cost limit - see the
+/// LRUCachePolicy namespace for the available choices.
+///
 /// \threading It is safe to call the methods of LRUCache from concurrent threads.
 /// \ingroup utilityGroup
-template<typename Key, typename Value>
+template<typename Key, typename Value, template<typename> class Policy = LRUCachePolicy::Exact>
 class LRUCache : private boost::noncopyable
 {
 	public:
@@ -71,17 +351,25 @@ class LRUCache : private boost::noncopyable
 		/// The optional RemovalCallback is called whenever an item is discarded from the cache.
 		///  It is unsafe to access the LRUCache itself from the RemovalCallback.
 		typedef boost::function<void ( const Key &key, const Value &data )> RemovalCallback;
+		/// The optional EvictionCallback is called after an item has been discarded to meet
+		/// the cost limit, in addition to the RemovalCallback. It is not called for items
+		/// removed by erase(), clear() or set(). Unlike the RemovalCallback it is called
+		/// without any locks held, so is suitable for expensive operations such as writing
+		/// the item to a secondary cache.
+		typedef boost::function<void ( const Key &key, const Value &data )> EvictionCallback;
 
 		LRUCache( GetterFunction getter );
 		LRUCache( GetterFunction getter, Cost maxCost );
-		LRUCache( GetterFunction getter, RemovalCallback removalCallback, Cost maxCost );
+		LRUCache( GetterFunction getter, RemovalCallback removalCallback, Cost maxCost, EvictionCallback evictionCallback = EvictionCallback() );
 		virtual ~LRUCache();
 
 		/// Retrieves an item from the cache, computing it if necessary.
 		/// The item is returned by value, as it may be removed from the
 		/// cache at any time by operations on another thread, or may not
 		/// even be stored in the cache if it exceeds the maximum cost.
-		/// Throws if the item can not be computed.
+		/// Throws if the item can not be computed. If another thread is
+		/// already computing the item, this blocks until it is done rather
+		/// than computing it again.
 		Value get( const Key &key );
 
 		/// Adds an item to the cache directly, bypassing the GetterFunction.
@@ -115,6 +403,13 @@ class LRUCache : private boost::noncopyable
 		/// Returns the current cost of all cached items.
 		Cost currentCost() const;
 
+		/// Returns statistics about the use of the cache. Note that
+		/// the values are updated independently, so may not be mutually
+		/// consistent while other threads are using the cache.
+		LRUCacheStatistics statistics() const;
+		/// Resets all statistics to 0.
+		void resetStatistics();
+
 	private :
 		
 		// Data
@@ -123,6 +418,7 @@ class LRUCache : private boost::noncopyable
 		// A function for computing values, and one for notifying of removals.
 		GetterFunction m_getter;
 		RemovalCallback m_removalCallback;
+		EvictionCallback m_evictionCallback;
 
 		// Status of each item in the cache.
 		enum Status
@@ -131,7 +427,8 @@ class LRUCache : private boost::noncopyable
 			Cached, // entry complete with value
 			Erased, // entry once had value but it was removed to meet cost limits
 			TooCostly, // entry cost exceeds m_maxCost and therefore isn't stored
-			Failed // m_getter failed when computing entry
+			Failed, // m_getter failed when computing entry
+			Computing // m_getter is being called by another thread
 		};
 		
 		// The type used to store a single cached item.
@@ -151,63 +448,61 @@ class LRUCache : private boost::noncopyable
 		typedef typename Map::value_type MapValue;
 		Map m_map;
 
+		typedef Policy<MapValue> PolicyType;
+
 		// CacheEntry implementation - a single item of the cache.
 		struct CacheEntry
 		{
-			CacheEntry(); // status == New, previous == next == NULL
+			CacheEntry(); // status == New
 			CacheEntry( const CacheEntry &other );
 			
 			Value value; // value for this item
 			Cost cost; // the cost for this item
 			
-			// Pointers to previous and next items
-			// in the LRU list. We use the CacheEntries
-			// themselves to store the list because it is
-			// quicker than using an external structure
-			// like a std::list. Note that although the
-			// purpose of the list is to track items where
-			// status==Cached, the two are not updated
-			// atomically, so it may _not_ be assumed
-			// that status==Cached implies previous!=NULL
-			// or status!=Cached implies previous==NULL
-			// at any given moment.
-			MapValue *previous;
-			MapValue *next;
+			// Data used by the policy to track the
+			// recency of this item. Note that although
+			// the purpose of the policy is to track items
+			// where status==Cached, the two are not updated
+			// atomically, so it may _not_ be assumed that
+			// an item tracked by the policy is cached, or
+			// vice versa, at any given moment.
+			typedef typename PolicyType::ItemData PolicyData;
+			PolicyData policyData;
 			
 			char status; // status of this item
 			// Mutex - must be held before accessing any
-			// fields other than the list fields (previous
-			// and next). To access the list fields, m_listMutex
-			// must be held instead.
+			// fields other than policyData, which is
+			// managed by the policy itself.
 			tbb::spin_mutex mutex;
 		};
 
-		// Dummy MapValues to represent the start and end of our LRU list.
-		// Items are moved to the end when they are accessed, and removed
-		// from the start when we need to reduce costs.
-		MapValue m_listStart;
-		MapValue m_listEnd;
-	
-		// The list is inherently a serial data structure, so we must
-		// protect all accesses with this mutex. The mutex _must_ be held
-		// before the list fields of _any_ MapValue may be accessed.
-		typedef tbb::spin_mutex ListMutex;
-		ListMutex m_listMutex;
+		// Decides which items to remove when we need to reduce costs.
+		PolicyType m_policy;
 		
 		// Total cost. We store the current cost atomically so it can be updated
-		// concurrently by multiple threads.
+		// concurrently by multiple threads. The maximum cost is atomic too, so
+		// that setMaxCost() may be called while other threads are using the cache.
 		typedef tbb::atomic<Cost> AtomicCost;
 		AtomicCost m_currentCost;
-		Cost m_maxCost;
+		AtomicCost m_maxCost;
+
+		LRUCacheStatisticsCounters m_statistics;
+
+		// Used to block threads waiting for the value of an entry
+		// being computed by another thread, so that only one thread
+		// calls m_getter for an entry and the others don't spin while
+		// they wait. A single condition is shared by all entries, as
+		// it is only used on cache misses, where the cost of the getter
+		// dominates.
+		boost::mutex m_computingMutex;
+		boost::condition_variable m_computingCondition;
 
 		// Methods
 		//
-		// Note that great care must be taken to properly handle the
-		// CacheEntry and list mutexes to avoid deadlock. If both m_listMutex
-		// and a CacheEntry::mutex must be held, the list mutex must be acquired
-		// _first_, and the CacheEntry::mutex _second_. Pay attention to the
-		// documentation for each method, to ensure that the right locks are held
-		// at the right times.
+		// Note that the policy is only ever called while no CacheEntry::mutex
+		// is held, so that policies are free to take their own locks without
+		// risking deadlock. Pay attention to the documentation for each method,
+		// to ensure that the right locks are held at the right times.
 		//////////////////////////////////////////////////////////////////////////
 
 		// Updates the cache entry with the new value and updates m_currentCost
@@ -217,26 +512,20 @@ class LRUCache : private boost::noncopyable
 		bool setInternal( MapValue *mapValue, const Value &value, Cost cost );
 		
 		// Sets the status for the cache entry to Erased, removes any
-		// previously Cached value, updates m_currentCost and removes
-		// the entry from the LRU list. The caller must hold m_listMutex, and
-		// must _not_ hold the mutex for the cache entry.
-		bool eraseInternal( MapValue *mapValue );
+		// previously Cached value and updates m_currentCost. If erasedValue
+		// is specified, it receives the removed value. The caller must _not_
+		// hold the mutex for the cache entry.
+		bool eraseInternal( MapValue *mapValue, Value *erasedValue = 0 );
 
 		// Caller must not hold any locks.
 		void limitCost();
 
-		// Either erases the item from the list, or moves it to
-		// the end, depending on whether or not it is cached.
-		// Caller must not hold any locks.
-		void updateListPosition( MapValue *mapValue );
-
-		// If the item is in the list, erases it, otherwise
-		// does nothing. Caller must hold m_listMutex.
-		void listErase( MapValue *mapValue );
-		// Inserts the item at the end of the list - the
-		// item must _not_ already be in the list.
-		// Caller must hold m_listMutex.
-		void listInsertAtEnd( MapValue *mapValue );
+		// Blocks until the entry is no longer being computed by another
+		// thread. The caller must _not_ hold the mutex for the entry.
+		void waitForComputation( CacheEntry &cacheEntry );
+		// Wakes the threads in waitForComputation(). The caller must not
+		// hold the mutex for any entry.
+		void notifyComputed();
 
 		static void nullRemovalCallback( const Key &key, const Value &value );
 
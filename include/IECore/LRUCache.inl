@@ -32,142 +32,594 @@
 //  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 //////////////////////////////////////////////////////////////////////////
-
 #ifndef IECORE_LRUCACHE_INL
 #define IECORE_LRUCACHE_INL
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
 #include "IECore/Exception.h"
+#include "IECore/Profiling.h"
 
 namespace IECore
 {
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::CacheEntry::CacheEntry()
-	:	value(), cost( 0 ), previous( NULL ), next( NULL ), status( New ), mutex()
+//////////////////////////////////////////////////////////////////////////
+// LRUCacheStatistics
+//////////////////////////////////////////////////////////////////////////
+
+inline LRUCacheStatistics::LRUCacheStatistics()
+	:	hits( 0 ), misses( 0 ), evictions( 0 ), getterTime( 0 )
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+// LRUCacheStatisticsCounters
+//////////////////////////////////////////////////////////////////////////
+
+inline LRUCacheStatisticsCounters::LRUCacheStatisticsCounters()
+{
+	reset();
+}
+
+inline void LRUCacheStatisticsCounters::hit()
+{
+#if IECORE_LRUCACHE_STATISTICS
+	++m_hits;
+#endif
+}
+
+inline void LRUCacheStatisticsCounters::miss()
+{
+#if IECORE_LRUCACHE_STATISTICS
+	++m_misses;
+#endif
+}
+
+inline void LRUCacheStatisticsCounters::eviction()
+{
+#if IECORE_LRUCACHE_STATISTICS
+	++m_evictions;
+#endif
+}
+
+inline LRUCacheStatistics LRUCacheStatisticsCounters::statistics() const
+{
+	LRUCacheStatistics result;
+	result.hits = m_hits;
+	result.misses = m_misses;
+	result.evictions = m_evictions;
+	result.getterTime = (double)m_getterNanoseconds / 1e9;
+	return result;
+}
+
+inline void LRUCacheStatisticsCounters::reset()
+{
+	m_hits = 0;
+	m_misses = 0;
+	m_evictions = 0;
+	m_getterNanoseconds = 0;
+}
+
+#if IECORE_LRUCACHE_STATISTICS
+
+inline LRUCacheStatisticsCounters::ScopedGetterTimer::ScopedGetterTimer( LRUCacheStatisticsCounters &counters )
+	:	m_counters( counters ), m_start( tbb::tick_count::now() )
+{
+}
+
+inline LRUCacheStatisticsCounters::ScopedGetterTimer::~ScopedGetterTimer()
+{
+	const double seconds = ( tbb::tick_count::now() - m_start ).seconds();
+	m_counters.m_getterNanoseconds += (boost::uint64_t)( seconds * 1e9 );
+}
+
+#else
+
+inline LRUCacheStatisticsCounters::ScopedGetterTimer::ScopedGetterTimer( LRUCacheStatisticsCounters &counters )
+{
+}
+
+inline LRUCacheStatisticsCounters::ScopedGetterTimer::~ScopedGetterTimer()
+{
+}
+
+#endif // IECORE_LRUCACHE_STATISTICS
+
+namespace LRUCachePolicy
+{
+
+//////////////////////////////////////////////////////////////////////////
+// List
+//////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+
+template<typename Item>
+List<Item>::List()
+	:	head( NULL ), tail( NULL ), size( 0 )
+{
+}
+
+template<typename Item>
+void List<Item>::unlink( Item *item )
+{
+	typename Item::second_type::PolicyData &data = item->second.policyData;
+	if( data.previous )
+	{
+		data.previous->second.policyData.next = data.next;
+	}
+	else
+	{
+		head = data.next;
+	}
+	if( data.next )
+	{
+		data.next->second.policyData.previous = data.previous;
+	}
+	else
+	{
+		tail = data.previous;
+	}
+	data.previous = data.next = NULL;
+	size--;
+}
+
+template<typename Item>
+void List<Item>::append( Item *item )
+{
+	typename Item::second_type::PolicyData &data = item->second.policyData;
+	data.previous = tail;
+	data.next = NULL;
+	if( tail )
+	{
+		tail->second.policyData.next = item;
+	}
+	else
+	{
+		head = item;
+	}
+	tail = item;
+	size++;
+}
+
+} // namespace Detail
+
+//////////////////////////////////////////////////////////////////////////
+// Exact
+//////////////////////////////////////////////////////////////////////////
+
+template<typename Item>
+Exact<Item>::ItemData::ItemData()
+	:	previous( NULL ), next( NULL ), linked( false )
+{
+}
+
+template<typename Item>
+Exact<Item>::ItemData::ItemData( const ItemData &other )
+	:	previous( NULL ), next( NULL ), linked( false )
+{
+}
+
+template<typename Item>
+Exact<Item>::Exact()
+{
+}
+
+template<typename Item>
+void Exact<Item>::touch( Item *item, size_t cost )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	ItemData &data = item->second.policyData;
+	if( data.linked )
+	{
+		m_list.unlink( item );
+	}
+	m_list.append( item );
+	data.linked = true;
+}
+
+template<typename Item>
+Item *Exact<Item>::pop()
+{
+	Mutex::scoped_lock lock( m_mutex );
+	Item *result = m_list.head;
+	if( result )
+	{
+		m_list.unlink( result );
+		result->second.policyData.linked = false;
+	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Sharded
+//////////////////////////////////////////////////////////////////////////
+
+template<typename Item>
+Sharded<Item>::ItemData::ItemData()
+	:	previous( NULL ), next( NULL ), tick( 0 )
+{
+	linked = false;
+	referenced = false;
+}
+
+template<typename Item>
+Sharded<Item>::ItemData::ItemData( const ItemData &other )
+	:	previous( NULL ), next( NULL ), tick( 0 )
+{
+	linked = false;
+	referenced = false;
+}
+
+template<typename Item>
+Sharded<Item>::Sharded()
+{
+	m_tick = 0;
+}
+
+template<typename Item>
+void Sharded<Item>::touch( Item *item, size_t cost )
+{
+	ItemData &data = item->second.policyData;
+	if( data.linked )
+	{
+		// Fast path for hits - avoid writing to the item
+		// unless we need to, so we don't contend for it.
+		if( !data.referenced )
+		{
+			data.referenced = true;
+		}
+		return;
+	}
+
+	Shard &s = shard( item );
+	typename Shard::Mutex::scoped_lock lock( s.mutex );
+	if( data.linked )
+	{
+		data.referenced = true;
+		return;
+	}
+	data.referenced = false;
+	append( s, item );
+}
+
+template<typename Item>
+Item *Sharded<Item>::pop()
+{
+	while( true )
+	{
+		// Find the shard whose head has been waiting longest.
+		Shard *oldest = NULL;
+		size_t oldestTick = 0;
+		for( int i = 0; i < NumShards; ++i )
+		{
+			Shard &s = m_shards[i];
+			typename Shard::Mutex::scoped_lock lock( s.mutex );
+			if( s.list.head && ( !oldest || s.list.head->second.policyData.tick < oldestTick ) )
+			{
+				oldest = &s;
+				oldestTick = s.list.head->second.policyData.tick;
+			}
+		}
+
+		if( !oldest )
+		{
+			return NULL;
+		}
+
+		typename Shard::Mutex::scoped_lock lock( oldest->mutex );
+		Item *item = oldest->list.head;
+		if( !item )
+		{
+			// emptied by another thread since we looked
+			continue;
+		}
+
+		oldest->list.unlink( item );
+		ItemData &data = item->second.policyData;
+		data.linked = false;
+		if( data.referenced )
+		{
+			// give it a second chance
+			data.referenced = false;
+			append( *oldest, item );
+			continue;
+		}
+
+		return item;
+	}
+}
+
+template<typename Item>
+typename Sharded<Item>::Shard &Sharded<Item>::shard( const Item *item )
+{
+	size_t h = reinterpret_cast<size_t>( item );
+	h ^= ( h >> 4 ) ^ ( h >> 9 ) ^ ( h >> 15 );
+	return m_shards[h % NumShards];
+}
+
+template<typename Item>
+void Sharded<Item>::append( Shard &shard, Item *item )
+{
+	ItemData &data = item->second.policyData;
+	assert( !data.linked );
+	data.tick = ++m_tick;
+	shard.list.append( item );
+	data.linked = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TwoQueue
+//////////////////////////////////////////////////////////////////////////
+
+template<typename Item>
+TwoQueue<Item>::ItemData::ItemData()
+	:	previous( NULL ), next( NULL ), queue( None )
+{
+}
+
+template<typename Item>
+TwoQueue<Item>::ItemData::ItemData( const ItemData &other )
+	:	previous( NULL ), next( NULL ), queue( None )
 {
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::CacheEntry::CacheEntry( const CacheEntry &other )
-	:	value( other.value ), cost( other.cost ), previous( other.previous ), next( other.next ), status( other.status ), mutex()
+template<typename Item>
+TwoQueue<Item>::TwoQueue()
+{
+}
+
+template<typename Item>
+void TwoQueue<Item>::touch( Item *item, size_t cost )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	ItemData &data = item->second.policyData;
+	switch( data.queue )
+	{
+		case None :
+			m_in.append( item );
+			data.queue = In;
+			return;
+		case In :
+			m_in.unlink( item );
+			break;
+		case Main :
+			m_main.unlink( item );
+			break;
+	}
+	m_main.append( item );
+	data.queue = Main;
+}
+
+template<typename Item>
+Item *TwoQueue<Item>::pop()
+{
+	Mutex::scoped_lock lock( m_mutex );
+
+	Detail::List<Item> *list = &m_main;
+	if( m_in.head && ( !m_main.head || m_in.size * 4 > m_in.size + m_main.size ) )
+	{
+		list = &m_in;
+	}
+
+	Item *result = list->head;
+	if( result )
+	{
+		list->unlink( result );
+		result->second.policyData.queue = None;
+	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// CostWeighted
+//////////////////////////////////////////////////////////////////////////
+
+template<typename Item>
+CostWeighted<Item>::ItemData::ItemData()
+	:	linked( false ), frequency( 0 ), position()
 {
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::LRUCache( GetterFunction getter )
-	:	m_getter( getter ), m_removalCallback( nullRemovalCallback ), m_maxCost( 500 )
+template<typename Item>
+CostWeighted<Item>::ItemData::ItemData( const ItemData &other )
+	:	linked( false ), frequency( 0 ), position()
+{
+}
+
+template<typename Item>
+CostWeighted<Item>::CostWeighted()
+	:	m_inflation( 0 )
+{
+}
+
+template<typename Item>
+void CostWeighted<Item>::touch( Item *item, size_t cost )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	ItemData &data = item->second.policyData;
+	if( data.linked )
+	{
+		m_queue.erase( data.position );
+		data.frequency++;
+	}
+	else
+	{
+		data.frequency = 1;
+		data.linked = true;
+	}
+
+	const double priority = m_inflation + (double)data.frequency / (double)std::max( cost, (size_t)1 );
+	data.position = m_queue.insert( typename PriorityQueue::value_type( priority, item ) );
+}
+
+template<typename Item>
+Item *CostWeighted<Item>::pop()
+{
+	Mutex::scoped_lock lock( m_mutex );
+	if( m_queue.empty() )
+	{
+		return NULL;
+	}
+
+	typename PriorityQueue::iterator it = m_queue.begin();
+	Item *result = it->second;
+	m_inflation = it->first;
+	m_queue.erase( it );
+	result->second.policyData.linked = false;
+	return result;
+}
+
+} // namespace LRUCachePolicy
+
+//////////////////////////////////////////////////////////////////////////
+// LRUCache
+//////////////////////////////////////////////////////////////////////////
+
+template<typename Key, typename Value, template<typename> class Policy>
+LRUCache<Key, Value, Policy>::CacheEntry::CacheEntry()
+	:	value(), cost( 0 ), policyData(), status( New ), mutex()
+{
+}
+
+template<typename Key, typename Value, template<typename> class Policy>
+LRUCache<Key, Value, Policy>::CacheEntry::CacheEntry( const CacheEntry &other )
+	:	value( other.value ), cost( other.cost ), policyData( other.policyData ), status( other.status ), mutex()
+{
+}
+
+template<typename Key, typename Value, template<typename> class Policy>
+LRUCache<Key, Value, Policy>::LRUCache( GetterFunction getter )
+	:	m_getter( getter ), m_removalCallback( nullRemovalCallback )
 {
 	m_currentCost = 0;
-	
-	m_listStart.second.previous = NULL;
-	m_listStart.second.next = &m_listEnd;
-	
-	m_listEnd.second.previous = &m_listStart;
-	m_listEnd.second.next = NULL;
+	m_maxCost = 500;
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::LRUCache( GetterFunction getter, Cost maxCost )
-	:	m_getter( getter ), m_removalCallback( nullRemovalCallback ), m_maxCost( maxCost )
+template<typename Key, typename Value, template<typename> class Policy>
+LRUCache<Key, Value, Policy>::LRUCache( GetterFunction getter, Cost maxCost )
+	:	m_getter( getter ), m_removalCallback( nullRemovalCallback )
 {
 	m_currentCost = 0;
-	
-	m_listStart.second.previous = NULL;
-	m_listStart.second.next = &m_listEnd;
-		
-	m_listEnd.second.previous = &m_listStart;
-	m_listEnd.second.next = NULL;
+	m_maxCost = maxCost;
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::LRUCache( GetterFunction getter, RemovalCallback removalCallback, Cost maxCost )
-	:	m_getter( getter ), m_removalCallback( removalCallback ), m_maxCost( maxCost )
+template<typename Key, typename Value, template<typename> class Policy>
+LRUCache<Key, Value, Policy>::LRUCache( GetterFunction getter, RemovalCallback removalCallback, Cost maxCost, EvictionCallback evictionCallback )
+	:	m_getter( getter ), m_removalCallback( removalCallback ), m_evictionCallback( evictionCallback )
 {
 	m_currentCost = 0;
-	
-	m_listStart.second.previous = NULL;
-	m_listStart.second.next = &m_listEnd;
-	
-	m_listEnd.second.previous = &m_listStart;
-	m_listEnd.second.next = NULL;
+	m_maxCost = maxCost;
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::~LRUCache()
+template<typename Key, typename Value, template<typename> class Policy>
+LRUCache<Key, Value, Policy>::~LRUCache()
 {
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::clear()
+template<typename Key, typename Value, template<typename> class Policy>
+void LRUCache<Key, Value, Policy>::clear()
 {
-	ListMutex::scoped_lock listLock( m_listMutex );	
 	for( typename Map::iterator it = m_map.begin(); it != m_map.end(); ++it )
 	{
 		eraseInternal( &*it );
 	}
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::setMaxCost( Cost maxCost )
+template<typename Key, typename Value, template<typename> class Policy>
+void LRUCache<Key, Value, Policy>::setMaxCost( Cost maxCost )
 {
 	m_maxCost = maxCost;
 	limitCost();
 }
 
-template<typename Key, typename Value>
-typename LRUCache<Key, Value>::Cost LRUCache<Key, Value>::getMaxCost() const
+template<typename Key, typename Value, template<typename> class Policy>
+typename LRUCache<Key, Value, Policy>::Cost LRUCache<Key, Value, Policy>::getMaxCost() const
 {
 	return m_maxCost;
 }
 
-template<typename Key, typename Value>
-typename LRUCache<Key, Value>::Cost LRUCache<Key, Value>::currentCost() const
+template<typename Key, typename Value, template<typename> class Policy>
+typename LRUCache<Key, Value, Policy>::Cost LRUCache<Key, Value, Policy>::currentCost() const
 {
 	return m_currentCost;
 }
 
-template<typename Key, typename Value>
-Value LRUCache<Key, Value>::get( const Key& key )
+template<typename Key, typename Value, template<typename> class Policy>
+LRUCacheStatistics LRUCache<Key, Value, Policy>::statistics() const
+{
+	return m_statistics.statistics();
+}
+
+template<typename Key, typename Value, template<typename> class Policy>
+void LRUCache<Key, Value, Policy>::resetStatistics()
+{
+	m_statistics.reset();
+}
+
+template<typename Key, typename Value, template<typename> class Policy>
+Value LRUCache<Key, Value, Policy>::get( const Key& key )
 {
 
 	MapIterator it = m_map.insert( MapValue( key, CacheEntry() ) ).first;
 	CacheEntry &cacheEntry = it->second;
 	tbb::spin_mutex::scoped_lock lock( cacheEntry.mutex );
-		
+
+	// Wait for any other thread which is already computing
+	// the value, rather than spinning on the entry mutex.
+	while( cacheEntry.status==Computing )
+	{
+		lock.release();
+		waitForComputation( cacheEntry );
+		lock.acquire( cacheEntry.mutex );
+	}
+
 	if( cacheEntry.status==New || cacheEntry.status==Erased || cacheEntry.status==TooCostly )
 	{
 		assert( cacheEntry.value==Value() );
-		assert( cacheEntry.next == NULL && cacheEntry.previous == NULL );
 		
+		m_statistics.miss();
+
+		// Mark the entry as being computed, and release the lock so that
+		// other threads can wait for us efficiently, and so that cached()
+		// and erase() aren't held up by a slow getter.
+		cacheEntry.status = Computing;
+		lock.release();
+
 		Value value = Value();
 		Cost cost = 0;
 		try
 		{
+			LRUCacheStatisticsCounters::ScopedGetterTimer timer( m_statistics );
+			IECORE_PROFILE_ZONE( "LRUCache::getter" );
 			value = m_getter( key, cost );
 		}
 		catch( ... )
 		{
+			lock.acquire( cacheEntry.mutex );
 			cacheEntry.status = Failed;
+			lock.release();
+			notifyComputed();
 			throw;
 		}
-		
-		assert( cacheEntry.status != Cached ); // this would indicate that another thread somehow
-		assert( cacheEntry.status != Failed ); // loaded the same thing as us, which is not the intention.
-		
-		setInternal( &*it, value, cost );
+
+		lock.acquire( cacheEntry.mutex );
+		assert( cacheEntry.status != Failed ); // this would indicate that another thread somehow
+		                                       // loaded the same thing as us, which is not the intention.
+		const bool stored = setInternal( &*it, value, cost );
 		
 		assert( cacheEntry.status == Cached || cacheEntry.status == TooCostly );
 	
 		lock.release();
+		notifyComputed();
 		
-		/// \todo We might want to consider ways of avoiding having to manipulate the
-		/// list for cache hits, because we want this to be our fastest code path.
-		/// Adopting an approximate LRU heuristic like Second Chance would be one way
-		/// of doing this.
-		updateListPosition( &*it );
+		if( stored )
+		{
+			m_policy.touch( &*it, cost );
+		}
 		limitCost();
 	
 		return value;
@@ -175,8 +627,10 @@ Value LRUCache<Key, Value>::get( const Key& key )
 	else if( cacheEntry.status==Cached )
 	{
 		Value result = cacheEntry.value;
+		const Cost cost = cacheEntry.cost;
 		lock.release();
-		updateListPosition( &*it );
+		m_statistics.hit();
+		m_policy.touch( &*it, cost );
 		return result;
 	}
 	else
@@ -186,8 +640,35 @@ Value LRUCache<Key, Value>::get( const Key& key )
 	}
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::set( const Key &key, const Value &value, Cost cost )
+template<typename Key, typename Value, template<typename> class Policy>
+void LRUCache<Key, Value, Policy>::waitForComputation( CacheEntry &cacheEntry )
+{
+	boost::unique_lock<boost::mutex> computingLock( m_computingMutex );
+	while( true )
+	{
+		{
+			tbb::spin_mutex::scoped_lock lock( cacheEntry.mutex );
+			if( cacheEntry.status != Computing )
+			{
+				return;
+			}
+		}
+		m_computingCondition.wait( computingLock );
+	}
+}
+
+template<typename Key, typename Value, template<typename> class Policy>
+void LRUCache<Key, Value, Policy>::notifyComputed()
+{
+	// Taking the mutex guarantees that any thread in waitForComputation()
+	// is either waiting on the condition already, or has yet to check the
+	// status of its entry.
+	boost::lock_guard<boost::mutex> computingLock( m_computingMutex );
+	m_computingCondition.notify_all();
+}
+
+template<typename Key, typename Value, template<typename> class Policy>
+bool LRUCache<Key, Value, Policy>::set( const Key &key, const Value &value, Cost cost )
 {
 	MapIterator it = m_map.insert( MapValue( key, CacheEntry() ) ).first;
 	CacheEntry &cacheEntry = it->second;
@@ -196,14 +677,17 @@ bool LRUCache<Key, Value>::set( const Key &key, const Value &value, Cost cost )
 	const bool result = setInternal( &*it, value, cost );
 	
 	lock.release();
-	updateListPosition( &*it );
+	if( result )
+	{
+		m_policy.touch( &*it, cost );
+	}
 	limitCost();
 	
 	return result;
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::setInternal( MapValue *mapValue, const Value &value, Cost cost )
+template<typename Key, typename Value, template<typename> class Policy>
+bool LRUCache<Key, Value, Policy>::setInternal( MapValue *mapValue, const Value &value, Cost cost )
 {
 	CacheEntry &cacheEntry = mapValue->second;
 	if( cacheEntry.status==Cached )
@@ -230,8 +714,8 @@ bool LRUCache<Key, Value>::setInternal( MapValue *mapValue, const Value &value,
 	return result;
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::cached( const Key &key ) const
+template<typename Key, typename Value, template<typename> class Policy>
+bool LRUCache<Key, Value, Policy>::cached( const Key &key ) const
 {
 	ConstMapIterator it = m_map.find( key );
 	if( it == m_map.end() )
@@ -242,8 +726,8 @@ bool LRUCache<Key, Value>::cached( const Key &key ) const
 	return it->second.status==Cached;
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::erase( const Key &key )
+template<typename Key, typename Value, template<typename> class Policy>
+bool LRUCache<Key, Value, Policy>::erase( const Key &key )
 {
 	MapIterator it = m_map.find( key );
 	if( it == m_map.end() )
@@ -251,19 +735,23 @@ bool LRUCache<Key, Value>::erase( const Key &key )
 		return false;
 	}
 
-	ListMutex::scoped_lock listLock( m_listMutex );	
 	return eraseInternal( &*it );
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::eraseInternal( MapValue *mapValue )
+template<typename Key, typename Value, template<typename> class Policy>
+bool LRUCache<Key, Value, Policy>::eraseInternal( MapValue *mapValue, Value *erasedValue )
 {	
 	CacheEntry &cacheEntry = mapValue->second;
 	tbb::spin_mutex::scoped_lock lock( cacheEntry.mutex );
 		
 	const Status originalStatus = (Status)cacheEntry.status;
+	if( originalStatus == Computing )
+	{
+		// Another thread is in get(), and will store the value
+		// when it has been computed.
+		return false;
+	}
 
-	listErase( mapValue );
 	cacheEntry.status = Erased;
 	
 	if( originalStatus != Cached ) 
@@ -273,72 +761,52 @@ bool LRUCache<Key, Value>::eraseInternal( MapValue *mapValue )
 	
 	m_removalCallback( mapValue->first, cacheEntry.value );
 	m_currentCost -= cacheEntry.cost;
+	if( erasedValue )
+	{
+		*erasedValue = cacheEntry.value;
+	}
 	cacheEntry.value = Value();
 	
 	return true;
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::limitCost()
+template<typename Key, typename Value, template<typename> class Policy>
+void LRUCache<Key, Value, Policy>::limitCost()
 {
-	ListMutex::scoped_lock lock( m_listMutex );
-
-	// While we're above the cost limit, and there are still things
-	// in the list, erase the first item in the list. Note that it _is_
-	// possible for the list to become empty before we meet the cost limit,
-	// because another thread may have cached an item and incremented
-	// m_currentCost, but still be waiting to add the item to the list,
-	// because we hold m_listMutex.
-	while( m_currentCost > m_maxCost && m_listStart.second.next != &m_listEnd )
-	{
-		eraseInternal( m_listStart.second.next );
-	}
-}
-
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::updateListPosition( MapValue *mapValue )
-{
-	ListMutex::scoped_lock lock( m_listMutex );
-	
-	listErase( mapValue );
-	
-	tbb::spin_mutex::scoped_lock mapValueMutex( mapValue->second.mutex );
-	if( mapValue->second.status == Cached )
-	{
-		listInsertAtEnd( mapValue );
-	}
-}
-
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::listErase( MapValue *mapValue )
-{	
-	MapValue *previous = mapValue->second.previous;	
-	if( !previous )
+	// While we're above the cost limit, and the policy is still tracking
+	// items, erase the item it chooses. Items may have been erased already
+	// (in which case eraseInternal() just discards them), and it _is_
+	// possible for the policy to run out of items before we meet the cost
+	// limit, because another thread may have cached an item and incremented
+	// m_currentCost, but not yet passed it to the policy.
+	while( m_currentCost > m_maxCost )
 	{
-		return;
+		MapValue *mapValue = m_policy.pop();
+		if( !mapValue )
+		{
+			break;
+		}
+		if( !m_evictionCallback )
+		{
+			if( eraseInternal( mapValue ) )
+			{
+				m_statistics.eviction();
+			}
+		}
+		else
+		{
+			Value evictedValue;
+			if( eraseInternal( mapValue, &evictedValue ) )
+			{
+				m_statistics.eviction();
+				m_evictionCallback( mapValue->first, evictedValue );
+			}
+		}
 	}
-
-	previous->second.next = mapValue->second.next;
-	mapValue->second.next->second.previous = previous;
-	mapValue->second.next = mapValue->second.previous = NULL;
-}
-
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::listInsertAtEnd( MapValue *mapValue )
-{
-	assert( mapValue->second.previous == NULL );
-	assert( mapValue->second.next == NULL );
-
-	MapValue *previous = m_listEnd.second.previous;
-	previous->second.next = mapValue;
-	mapValue->second.previous = previous;
-	
-	mapValue->second.next = &m_listEnd;
-	m_listEnd.second.previous = mapValue;
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::nullRemovalCallback( const Key &key, const Value &value )
+template<typename Key, typename Value, template<typename> class Policy>
+void LRUCache<Key, Value, Policy>::nullRemovalCallback( const Key &key, const Value &value )
 {
 }
 
@@ -76,11 +76,10 @@ class IECORE_API LensDistortOp : public IECore::WarpOp
 		};
 
 		int m_mode;
-		IECore::LensModelPtr m_lensModel;
 		IECore::ObjectParameterPtr m_lensParameter;
 		IECore::IntParameterPtr m_modeParameter;
 		Imath::Box2i m_distortedDataWindow;
-		IECore::FloatVectorDataPtr m_cachePtr;
+		IECore::ConstFloatVectorDataPtr m_cachePtr;
 };
 
 IE_CORE_DECLAREPTR( LensDistortOp );
@@ -105,6 +105,8 @@ class IECORE_API LensModel : public Parameterised
 
 		/// Distorts a point in UV space of the range (0-1) where the lower left corner is 0,0.
 		/// Should be implemented by derived classes to return the distorted UV coordinate.
+		/// Both distort() and undistort() may be called concurrently from multiple threads
+		/// once validate() has returned, so implementations must not modify internal state.
 		//! @param uv The undistorted point that will be distorted. Should be a 2D vector in pixel space.
 		virtual Imath::V2d distort( Imath::V2d p ) = 0;
 
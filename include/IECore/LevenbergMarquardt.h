@@ -37,6 +37,7 @@
 #define IE_CORE_LEVENBERGMARQUARDT_H
 
 #include "boost/static_assert.hpp"
+#include "boost/type_traits/integral_constant.hpp"
 
 #include "IECore/TypeTraits.h"
 #include "IECore/VectorTypedData.h"
@@ -128,6 +129,12 @@ class LevenbergMarquardt : public boost::noncopyable
 
 		/// Updates parameters in place. Returns true on success.
 		Status solve( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn );
+		/// As solve(), but evaluates the columns of the Jacobian in parallel, and parallelises
+		/// its QR factorisation. This is worthwhile for problems with many parameters and errors.
+		/// Each thread evaluates errors with its own copy of fn, made at the start of each
+		/// evaluation of the Jacobian, so ErrorFn must be copy constructible and the copies must
+		/// be safe to call concurrently. The result is identical to that of solve().
+		Status solveParallel( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn );
 
 	protected :
 
@@ -150,7 +157,16 @@ class LevenbergMarquardt : public boost::noncopyable
 			return x * x;
 		}
 
-		void qrFactorize();
+		template<bool Parallel>
+		Status solveInternal( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn );
+
+		void computeJacobian( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn, T eps, boost::false_type parallel );
+		void computeJacobian( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn, T eps, boost::true_type parallel );
+		class JacobianColumns;
+
+		void qrFactorize( bool parallel );
+		void qrUpdateColumn( unsigned j, unsigned k );
+		class QRColumnUpdater;
 		T computeLMParameter( std::vector<T> &x, std::vector<T> &sdiag, T delta );
 
 		void qrSolve( std::vector<T> &r, std::vector<T> &diag,
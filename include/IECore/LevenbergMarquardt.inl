@@ -37,6 +37,10 @@
 
 #include <cassert>
 
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+
 #include "OpenEXR/ImathMath.h"
 
 #include "IECore/Exception.h"
@@ -137,6 +141,19 @@ unsigned LevenbergMarquardt<T, ErrorFn, Traits>::getMaxCalls() const
 
 template<typename T, typename ErrorFn, template<typename> class Traits>
 typename LevenbergMarquardt<T, ErrorFn, Traits>::Status LevenbergMarquardt<T, ErrorFn, Traits>::solve( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn )
+{
+	return solveInternal<false>( parameters, fn );
+}
+
+template<typename T, typename ErrorFn, template<typename> class Traits>
+typename LevenbergMarquardt<T, ErrorFn, Traits>::Status LevenbergMarquardt<T, ErrorFn, Traits>::solveParallel( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn )
+{
+	return solveInternal<true>( parameters, fn );
+}
+
+template<typename T, typename ErrorFn, template<typename> class Traits>
+template<bool Parallel>
+typename LevenbergMarquardt<T, ErrorFn, Traits>::Status LevenbergMarquardt<T, ErrorFn, Traits>::solveInternal( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn )
 {
 	assert( parameters );
 	m_n = parameters->readable().size();
@@ -162,7 +179,7 @@ typename LevenbergMarquardt<T, ErrorFn, Traits>::Status LevenbergMarquardt<T, Er
 	typename std::vector<T> &wa2 = m_wa2->writable();
 	typename std::vector<T> &wa4 = m_wa4->writable();
 
-	T actred, dirder,  fnorm, fnorm1, gnorm, pnorm,	prered, ratio, step, sum, temp, temp1, temp2, temp3;
+	T actred, dirder,  fnorm, fnorm1, gnorm, pnorm,	prered, ratio, sum, temp, temp1, temp2, temp3;
 
 	unsigned iter = 1;
 
@@ -183,27 +200,10 @@ typename LevenbergMarquardt<T, ErrorFn, Traits>::Status LevenbergMarquardt<T, Er
 
 	do
 	{
-		for ( unsigned j = 0; j < m_n; j++ )
-		{
-			T temp = x[j];
-			step = eps * Imath::Math<T>::fabs( temp );
-			if ( step == 0. )
-			{
-				step = eps;
-			}
-			x[j] = temp + step;
-
-			fn( parameters, m_wa4 );
-			m_numCalls++;
+		computeJacobian( parameters, fn, eps, boost::integral_constant<bool, Parallel>() );
+		m_numCalls += m_n;
 
-			for ( unsigned i = 0; i < m_m; i++ )
-			{
-				m_fjac[j * m_m + i] = ( wa4[i] - fvec[i] ) / ( x[j] - temp );
-			}
-			x[j] = temp;
-		}
-
-		qrFactorize();
+		qrFactorize( Parallel );
 
 		if ( iter == 1 )
 		{
@@ -419,10 +419,162 @@ typename LevenbergMarquardt<T, ErrorFn, Traits>::Status LevenbergMarquardt<T, Er
 }
 
 template<typename T, typename ErrorFn, template<typename> class Traits>
-void LevenbergMarquardt<T, ErrorFn, Traits>::qrFactorize()
+void LevenbergMarquardt<T, ErrorFn, Traits>::computeJacobian( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn, T eps, boost::false_type )
+{
+	std::vector<T> &x = parameters->writable();
+	const std::vector<T> &fvec = m_fvec->readable();
+	const std::vector<T> &wa4 = m_wa4->readable();
+
+	for ( unsigned j = 0; j < m_n; j++ )
+	{
+		T temp = x[j];
+		T step = eps * Imath::Math<T>::fabs( temp );
+		if ( step == 0. )
+		{
+			step = eps;
+		}
+		x[j] = temp + step;
+
+		fn( parameters, m_wa4 );
+
+		for ( unsigned i = 0; i < m_m; i++ )
+		{
+			m_fjac[j * m_m + i] = ( wa4[i] - fvec[i] ) / ( x[j] - temp );
+		}
+		x[j] = temp;
+	}
+}
+
+/// Computes a range of the columns of the Jacobian, using a copy of the
+/// parameters and a copy of the error function for each thread.
+template<typename T, typename ErrorFn, template<typename> class Traits>
+class LevenbergMarquardt<T, ErrorFn, Traits>::JacobianColumns
+{
+
+	public :
+
+		typedef tbb::enumerable_thread_specific<ErrorFn> ErrorFns;
+
+		JacobianColumns( LevenbergMarquardt *lm, const std::vector<T> &x, ErrorFns &fns, T eps )
+			:	m_lm( lm ), m_x( x ), m_fns( fns ), m_eps( eps )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<unsigned> &range ) const
+		{
+			const unsigned m = m_lm->m_m;
+			const std::vector<T> &fvec = m_lm->m_fvec->readable();
+
+			typename TypedData< std::vector<T> >::Ptr parameters = new TypedData< std::vector<T> >( m_x );
+			typename TypedData< std::vector<T> >::Ptr errors = new TypedData< std::vector<T> >();
+			errors->writable().resize( m );
+
+			std::vector<T> &x = parameters->writable();
+			const std::vector<T> &e = errors->readable();
+			ErrorFn &fn = m_fns.local();
+
+			for ( unsigned j = range.begin(); j != range.end(); j++ )
+			{
+				T temp = x[j];
+				T step = m_eps * Imath::Math<T>::fabs( temp );
+				if ( step == 0. )
+				{
+					step = m_eps;
+				}
+				x[j] = temp + step;
+
+				fn( parameters, errors );
+
+				T *column = &(m_lm->m_fjac[j * m]);
+				for ( unsigned i = 0; i < m; i++ )
+				{
+					column[i] = ( e[i] - fvec[i] ) / ( x[j] - temp );
+				}
+				x[j] = temp;
+			}
+		}
+
+	private :
+
+		LevenbergMarquardt *m_lm;
+		const std::vector<T> &m_x;
+		ErrorFns &m_fns;
+		T m_eps;
+
+};
+
+template<typename T, typename ErrorFn, template<typename> class Traits>
+void LevenbergMarquardt<T, ErrorFn, Traits>::computeJacobian( typename TypedData< std::vector<T> >::Ptr parameters, ErrorFn &fn, T eps, boost::true_type )
+{
+	typename JacobianColumns::ErrorFns fns( fn );
+	JacobianColumns jacobianColumns( this, parameters->readable(), fns, eps );
+	tbb::parallel_for( tbb::blocked_range<unsigned>( 0, m_n ), jacobianColumns );
+}
+
+/// Applies the Householder transformation of column j to a range of the later columns.
+template<typename T, typename ErrorFn, template<typename> class Traits>
+class LevenbergMarquardt<T, ErrorFn, Traits>::QRColumnUpdater
+{
+
+	public :
+
+		QRColumnUpdater( LevenbergMarquardt *lm, unsigned j )
+			:	m_lm( lm ), m_j( j )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<unsigned> &range ) const
+		{
+			for ( unsigned k = range.begin(); k != range.end(); k++ )
+			{
+				m_lm->qrUpdateColumn( m_j, k );
+			}
+		}
+
+	private :
+
+		LevenbergMarquardt *m_lm;
+		unsigned m_j;
+
+};
+
+template<typename T, typename ErrorFn, template<typename> class Traits>
+void LevenbergMarquardt<T, ErrorFn, Traits>::qrUpdateColumn( unsigned j, unsigned k )
+{
+	std::vector<T> &rdiag = m_wa1;
+
+	T sum = 0;
+	for ( unsigned i = j; i < m_m; i++ )
+	{
+		sum += m_fjac[j * m_m + i] * m_fjac[k * m_m + i];
+	}
+
+	T temp = sum / m_fjac[j + m_m * j];
+
+	for ( unsigned i = j; i < m_m; i++ )
+	{
+		m_fjac[k * m_m + i] -= temp * m_fjac[j * m_m + i];
+	}
+
+	if ( rdiag[k] != 0. )
+	{
+		temp = m_fjac[m_m * k + j] / rdiag[k];
+		temp = std::max<T>( 0., 1 - temp * temp );
+		rdiag[k] *= Imath::Math<T>::sqrt( temp );
+		temp = rdiag[k] / m_wa3[k];
+		if ( T( 0.05 ) * sqr( temp ) <= Traits<T>::machinePrecision() )
+		{
+			rdiag[k] = euclideanNorm( m_fjac.begin()+m_m * k + j + 1, m_fjac.begin()+m_m * k  + m_m );
+			m_wa3[k] = rdiag[k];
+		}
+	}
+}
+
+template<typename T, typename ErrorFn, template<typename> class Traits>
+void LevenbergMarquardt<T, ErrorFn, Traits>::qrFactorize( bool parallel )
 {
 	unsigned int i, j, k, kmax, minmn;
-	T ajnorm, sum, temp;
+	T ajnorm, temp;
 
 	std::vector<T> &rdiag = m_wa1;
 	std::vector<T> &acnorm = m_wa2->writable();
@@ -483,33 +635,16 @@ void LevenbergMarquardt<T, ErrorFn, Traits>::qrFactorize()
 
 		m_fjac[j * m_m + j] += 1;
 
-		for ( k = j + 1; k < m_n; k++ )
+		/// the remaining columns are updated independently of each other
+		if ( parallel )
 		{
-			sum = 0;
-
-			for ( i = j; i < m_m; i++ )
-			{
-				sum += m_fjac[j * m_m + i] * m_fjac[k * m_m + i];
-			}
-
-			temp = sum / m_fjac[j + m_m * j];
-
-			for ( i = j; i < m_m; i++ )
-			{
-				m_fjac[k * m_m + i] -= temp * m_fjac[j * m_m + i];
-			}
-
-			if ( rdiag[k] != 0. )
+			tbb::parallel_for( tbb::blocked_range<unsigned>( j + 1, m_n ), QRColumnUpdater( this, j ) );
+		}
+		else
+		{
+			for ( k = j + 1; k < m_n; k++ )
 			{
-				temp = m_fjac[m_m * k + j] / rdiag[k];
-				temp = std::max<T>( 0., 1 - temp * temp );
-				rdiag[k] *= Imath::Math<T>::sqrt( temp );
-				temp = rdiag[k] / m_wa3[k];
-				if ( T( 0.05 ) * sqr( temp ) <= Traits<T>::machinePrecision() )
-				{
-					rdiag[k] = euclideanNorm( m_fjac.begin()+m_m * k + j + 1, m_fjac.begin()+m_m * k  + m_m );
-					m_wa3[k] = rdiag[k];
-				}
+				qrUpdateColumn( j, k );
 			}
 		}
 
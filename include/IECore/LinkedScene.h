@@ -35,6 +35,8 @@
 #ifndef IECORE_LINKEDSCENE_H
 #define IECORE_LINKEDSCENE_H
 
+#include "boost/shared_ptr.hpp"
+
 #include "IECore/Export.h"
 #include "IECore/SampledSceneInterface.h"
 #include "IECore/SimpleTypedData.h"
@@ -143,6 +145,7 @@ class IECORE_API LinkedScene : public  SampledSceneInterface
 		virtual ConstObjectPtr readObjectAtSample( size_t sampleIndex ) const;
 		virtual ConstObjectPtr readObject( double time ) const;
 		virtual PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const;
+		virtual PrimitiveVariableMap readObjectPrimitiveVariableRange( const std::vector<InternedString> &primVarNames, double time, size_t begin, size_t end ) const;
 		virtual void writeObject( const Object *object, double time );
 
 		virtual bool hasChild( const Name &name ) const;
@@ -153,11 +156,19 @@ class IECORE_API LinkedScene : public  SampledSceneInterface
 		virtual SceneInterfacePtr scene( const Path &path, MissingBehaviour missingBehaviour = ThrowIfMissing );
 		virtual ConstSceneInterfacePtr scene( const Path &path, SceneInterface::MissingBehaviour missingBehaviour = ThrowIfMissing ) const;				
 
+		/// Reads the locations in parallel, resolving links at each of them.
+		virtual void readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const;
+		virtual void readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const;
+		virtual void readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const;
+
 		virtual void hash( HashType hashType, double time, MurmurHash &h ) const;
 
 	private :
 
-		LinkedScene( SceneInterface *mainScene, const SceneInterface *linkedScene, int rootLinkDepth, bool readOnly, bool atLink, bool timeRemapped );
+		class LinkCache;
+		typedef boost::shared_ptr<LinkCache> LinkCachePtr;
+
+		LinkedScene( SceneInterface *mainScene, const SceneInterface *linkedScene, LinkCachePtr linkCache, int rootLinkDepth, bool readOnly, bool atLink, bool timeRemapped );
 
 		ConstSceneInterfacePtr expandLink( const StringData *fileName, const InternedStringVectorData *root, int &linkDepth );
 
@@ -174,6 +185,11 @@ class IECORE_API LinkedScene : public  SampledSceneInterface
 		bool m_atLink;
 		bool m_sampled;
 		bool m_timeRemapped;
+		// Links which have already been expanded, shared by all the locations
+		// of a scene, so that a link referenced by many locations is only
+		// resolved once. Guarded by a mutex so that locations may be traversed
+		// concurrently.
+		LinkCachePtr m_linkCache;
 		// \todo: std::map< Path, LinkedScenes > for quick scene calls... built by scene... dies with the instance (usually only root uses it).
 
 		static const InternedString g_fileName;
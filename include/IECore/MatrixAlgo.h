@@ -39,6 +39,8 @@
 #ifndef IE_CORE_MATRIXALGO_H
 #define IE_CORE_MATRIXALGO_H
 
+#include <vector>
+
 #include "OpenEXR/ImathMatrix.h"
 
 #include "IECore/Export.h"
@@ -58,6 +60,21 @@ float determinant( const Imath::Matrix33<T> &m );
 template<class T>
 float determinant( const Imath::Matrix44<T> &m );
 
+/// Transforms an array of points in place by a Matrix33 or Matrix44. Large arrays are
+/// transformed in parallel, and affine matrices are applied without the per-point
+/// division by w, allowing the compiler to vectorise the loop. Instantiated for V3f
+/// and V3d with the float and double matrix types.
+template<typename V, typename M>
+void transformPoints( std::vector<V> &points, const M &matrix );
+
+/// As above, but ignoring any translation, as is appropriate for direction vectors.
+template<typename V, typename M>
+void transformVectors( std::vector<V> &vectors, const M &matrix );
+
+/// As above, but using the inverse transpose of the matrix, as is appropriate for normals.
+template<typename V, typename M>
+void transformNormals( std::vector<V> &normals, const M &matrix );
+
 // provide function for convertion between float to double matrix (not available in OpenEXR)
 template<> IECORE_API Imath::M44d convert( const Imath::M44f &in );
 // provide function for convertion between double to float matrix (not available in OpenEXR)
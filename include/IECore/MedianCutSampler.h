@@ -50,7 +50,9 @@ namespace IECore
 /// calculations, and leaves it to a caller to interpret them as
 /// light directions and positions. This allows the use of the class
 /// as a simple 2d point distribution algorithm in addition to
-/// a light probe sampler.
+/// a light probe sampler. Independent regions are subdivided in parallel,
+/// and results are cached by the hash of the input channel and parameters,
+/// so repeated sampling of the same image is cheap.
 /// \ingroup imageProcessingGroup
 class IECORE_API MedianCutSampler : public Op
 {
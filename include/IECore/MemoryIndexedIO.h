@@ -50,11 +50,21 @@ class IECORE_API MemoryIndexedIO : public StreamIndexedIO
 
 		IE_CORE_DECLARERUNTIMETYPED( MemoryIndexedIO, StreamIndexedIO );
 
-		MemoryIndexedIO( ConstCharVectorDataPtr buf, const IndexedIO::EntryIDList &root, IndexedIO::OpenMode mode);
+		/// Opens the file held in buf. No copy of buf is made in Read mode. When
+		/// writing, reserveSize may be used to preallocate space for the expected
+		/// size of the file, avoiding reallocation as it grows.
+		MemoryIndexedIO( ConstCharVectorDataPtr buf, const IndexedIO::EntryIDList &root, IndexedIO::OpenMode mode, size_t reserveSize = 0 );
+		/// Opens the file held in memory owned by the caller, which must remain
+		/// valid and unmodified for the lifetime of the MemoryIndexedIO and any
+		/// IndexedIOs derived from it. Only Read mode is supported.
+		MemoryIndexedIO( const char *buf, size_t size, const IndexedIO::EntryIDList &root, IndexedIO::OpenMode mode );
 
 		virtual ~MemoryIndexedIO();
 
-		/// Returns a copy of the internal buffer representing the entire file.
+		/// Returns the buffer representing the entire file. This shares the
+		/// internal buffer using the copy-on-write semantics of CharVectorData,
+		/// so it is cheap to call even for large files, and the internal buffer
+		/// is only duplicated if either is subsequently modified.
 		CharVectorDataPtr buffer();
 
 	protected:
@@ -40,6 +40,7 @@
 
 #include "IECore/PrimitiveVariable.h"
 #include "IECore/MeshPrimitive.h"
+#include "IECore/CompoundData.h"
 
 namespace IECore
 {
@@ -54,11 +55,41 @@ std::pair<PrimitiveVariable, PrimitiveVariable> calculateTangents( const MeshPri
 	const std::string &position = "P"
 );
 
+/// Calculates normals for a mesh primitive, returning a Vertex primitive variable holding smooth normals,
+/// or a Uniform primitive variable holding face normals. The mesh itself is not modified.
+PrimitiveVariable calculateNormals( const MeshPrimitive *mesh, PrimitiveVariable::Interpolation interpolation = PrimitiveVariable::Vertex, const std::string &position = "P" );
+
+/// Returns tables describing the connectivity of a mesh. These are built in parallel the
+/// first time they are requested, and cached by MeshPrimitive::topologyHash() so that subsequent operations
+/// on meshes sharing the same topology, such as a chain of Ops, may reuse them. The result
+/// is shared and must not be modified. Adjacency is stored in compressed tables, where the
+/// entries for element i run from offsets[i] to offsets[i+1]-1. The members are :
+///
+/// - "faceOffsets" : IntVectorData holding the index of the first face-vertex of each face.
+/// - "vertexFaceOffsets", "vertexFaces" : UIntVectorData tabulating the faces adjacent to
+///   each vertex, in ascending order, and once for each time the face references the vertex.
+/// - "edges" : V2iVectorData holding the unique edges, smallest vertex id first, in ascending order.
+/// - "faceVertexEdges" : IntVectorData holding the index of the edge from each face-vertex to the
+///   next one in its face.
+/// - "edgeFaceOffsets", "edgeFaces" : UIntVectorData tabulating the faces adjacent to each edge,
+///   in ascending order.
+/// - "vertexNeighbourOffsets", "vertexNeighbours" : UIntVectorData tabulating the vertices
+///   connected to each vertex by an edge, in ascending order.
+ConstCompoundDataPtr topology( const MeshPrimitive *mesh );
+
 void resamplePrimitiveVariable( const MeshPrimitive *mesh, PrimitiveVariable& primitiveVariable, PrimitiveVariable::Interpolation interpolation );
 
 /// create a new MeshPrimitive deleting faces from the input MeshPrimitive based on the facesToDelete uniform (int|float|bool) PrimitiveVariable
 MeshPrimitivePtr deleteFaces( const MeshPrimitive *meshPrimitive, const PrimitiveVariable &facesToDelete );
 
+/// Merges any number of meshes into one, in a single pass. The subdivision interpolation is
+/// taken from the first mesh, as are Constant primitive variables. Every other primitive variable
+/// is output at the highest interpolation (FaceVarying, then Vertex or Varying, then Uniform) found
+/// amongst the inputs, resampling any inputs which differ. Inputs lacking a variable, or holding it
+/// with a different type, contribute zeroes. Indices are kept if every input is indexed. The
+/// topology and primitive variables are merged concurrently.
+MeshPrimitivePtr mergeMeshes( const std::vector<const MeshPrimitive *> &meshes );
+
 } // namespace MeshAlgo
 } // namespace IECore
 
@@ -66,11 +66,6 @@ class IECORE_API MeshNormalsOp : public MeshPrimitiveOp
 
 		virtual void modifyTypedPrimitive( MeshPrimitive * mesh, const CompoundObject * operands );
 
-	private :
-
-		struct CalculateNormals;
-		struct HandleErrors;
-
 };
 
 IE_CORE_DECLAREPTR( MeshNormalsOp );
@@ -37,12 +37,15 @@
 
 #include <vector>
 
+#include "tbb/atomic.h"
+#include "tbb/blocked_range.h"
 #include "tbb/mutex.h"
 
 #include "IECore/Export.h"
 #include "IECore/PrimitiveEvaluator.h"
 #include "IECore/MeshPrimitive.h"
 #include "IECore/BoundedKDTree.h"
+#include "IECore/BoundingVolumeHierarchy.h"
 
 namespace IECore
 {
@@ -102,9 +105,23 @@ class IECORE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		};
 		IE_CORE_DECLAREPTR( Result );
 
+		/// The structure used to accelerate closestPoint(), intersectionPoint()
+		/// and intersectionPoints() queries.
+		enum AccelerationStructure
+		{
+			/// A BoundedKDTree, split at the median. This is available via
+			/// triangleBoundTree().
+			KDTreeAcceleration = 0,
+			/// A BoundingVolumeHierarchy built using the surface area heuristic.
+			/// This is generally faster to query, particularly for rays and
+			/// unevenly distributed triangles, and is built in parallel. It is
+			/// available via triangleBVH().
+			BVHAcceleration = 1
+		};
+
 		static PrimitiveEvaluatorPtr create( ConstPrimitivePtr primitive );
 
-		MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh );
+		MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh, AccelerationStructure accelerationStructure = KDTreeAcceleration );
 
 		virtual ~MeshPrimitiveEvaluator();
 
@@ -156,7 +173,14 @@ class IECORE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		const TriangleBoundVector *triangleBounds() const;
 		/// Returns a pointer to a tree that can be used for performing fast spacial queries.
 		///  The iterators in this tree point to elements in the vector returned by triangleBounds().
+		/// Returns 0 if the evaluator was constructed with BVHAcceleration.
 		const TriangleBoundTree *triangleBoundTree() const;
+		/// A BoundingVolumeHierarchy providing accelerated lookups of triangles using their bounding boxes.
+		typedef BoundingVolumeHierarchy<TriangleBoundVector::iterator> TriangleBVH;
+		/// Returns a pointer to a hierarchy that can be used for performing fast spatial queries.
+		/// The iterators in this hierarchy point to elements in the vector returned by triangleBounds().
+		/// Returns 0 unless the evaluator was constructed with BVHAcceleration.
+		const TriangleBVH *triangleBVH() const;
 		
 		/// A type for storing the uv bounding box for a triangle.
 		typedef Imath::Box2f UVBound;
@@ -181,6 +205,7 @@ class IECORE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 
 		TriangleBoundVector m_triangles;
 		TriangleBoundTree *m_tree;
+		TriangleBVH *m_bvh;
 
 		UVBoundVector m_uvTriangles;		
 		UVBoundTree *m_uvTree;
@@ -190,8 +215,19 @@ class IECORE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		bool intersectionPointWalk( TriangleBoundTree::NodeIndex nodeIndex, const Imath::Line3f &ray, float &maxDistSqrd, Result *result, bool &hit ) const;
 		void intersectionPointsWalk( TriangleBoundTree::NodeIndex nodeIndex, const Imath::Line3f &ray, float maxDistSqrd, std::vector<PrimitiveEvaluator::ResultPtr> &results ) const;
 
+		void closestPointBVHWalk( const Imath::V3f &p, float &closestDistanceSqrd, Result *result ) const;
+		bool intersectionPointBVHWalk( const Imath::Line3f &ray, float &maxDistSqrd, Result *result ) const;
+		void intersectionPointsBVHWalk( const Imath::Line3f &ray, float maxDistSqrd, std::vector<PrimitiveEvaluator::ResultPtr> &results ) const;
+		Imath::V3i triangleVertexIds( size_t triangleIndex ) const;
+		void setResult( Result *result, size_t triangleIndex, const Imath::V3i &vertexIds, const Imath::V3f &barycentricCoordinates, const Imath::V3f &p ) const;
+
+		void calculateTriangleBounds( const tbb::blocked_range<size_t> &range );
+		void buildTriangleTree( AccelerationStructure accelerationStructure );
+		void buildUVTree();
+
 		void calculateMassProperties() const;
 		void calculateAverageNormals() const;
+		void calculateVertexNormals( const tbb::blocked_range<size_t> &range, const std::vector<int> &vertexTriangleOffsets, const std::vector<int> &vertexTriangles, std::vector<Imath::V3f> &normals ) const;
 		
 		void triangleUVs( size_t triangleIndex, const Imath::V3i &vertexIds, Imath::V2f uv[3] ) const;
 		PrimitiveVariable m_u;
@@ -207,7 +243,7 @@ class IECORE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 
 		typedef tbb::mutex NormalsMutex;
 		mutable NormalsMutex m_normalsMutex;
-		mutable bool m_haveAverageNormals;
+		mutable tbb::atomic<bool> m_haveAverageNormals;
 		typedef int VertexIndex;
 		typedef int TriangleIndex;
 		typedef std::pair<VertexIndex, VertexIndex> Edge;
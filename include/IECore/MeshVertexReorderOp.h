@@ -46,7 +46,11 @@
 namespace IECore
 {
 
-/// A MeshPrimitiveOp to reorder the vertices of a mesh based on an initial selection of 3 vertices
+/// A MeshPrimitiveOp to reorder the vertices and faces of a mesh. In Topological mode the mesh is
+/// traversed from an initial selection of 3 vertices, giving a consistent ordering for meshes which
+/// share topology. In VertexCache mode the faces are reordered to maximise reuse of recently processed
+/// vertices by the GPU post-transform vertex cache, and the vertices are then numbered in the order
+/// the faces first use them, for locality of vertex data.
 /// \ingroup geometryProcessingGroup
 class IECORE_API MeshVertexReorderOp : public MeshPrimitiveOp
 {
@@ -57,6 +61,15 @@ class IECORE_API MeshVertexReorderOp : public MeshPrimitiveOp
 
 		IE_CORE_DECLARERUNTIMETYPED( MeshVertexReorderOp, MeshPrimitiveOp );
 
+		enum Mode
+		{
+			Topological = 0,
+			VertexCache
+		};
+
+		IntParameter * modeParameter();
+		const IntParameter * modeParameter() const;
+
 		V3iParameter * startingVerticesParameter();
 		const V3iParameter * startingVerticesParameter() const;
 
@@ -66,6 +79,7 @@ class IECORE_API MeshVertexReorderOp : public MeshPrimitiveOp
 
 	private :
 
+		IntParameterPtr m_modeParameter;
 		V3iParameterPtr m_startingVerticesParameter;
 
 		struct ReorderFn;
@@ -97,6 +111,10 @@ class IECORE_API MeshVertexReorderOp : public MeshPrimitiveOp
 
 		void buildInternalTopology( const MeshPrimitive * mesh );
 
+		void reorderTopological( MeshPrimitive * mesh );
+		void reorderForVertexCache( MeshPrimitive * mesh );
+		void reorderPrimitiveVariables( MeshPrimitive * mesh, const std::vector<int> &vertexRemap, const std::vector<int> &faceVaryingRemap, const std::vector<int> &uniformRemap );
+
 		int faceDirection( FaceId face, Edge edge );
 
 		void visitFace(
@@ -49,6 +49,13 @@ namespace IECore
 /// and a parameter to disable the operation completely. It's a little
 /// bit naughty to modify it in place but it'll probably be quite handy
 /// at times.
+///
+/// Even when copying is requested, the copy is skipped if nothing but
+/// the Op itself references the input, as nobody could observe the
+/// modification. So code which hands its only reference to an input over
+/// to the Op, for instance by setting the parameter value from a temporary
+/// or by releasing its own pointer before calling operate(), gets in place
+/// modification without having to turn the copy parameter off.
 class IECORE_API ModifyOp : public Op
 {
 	public :
@@ -76,8 +83,15 @@ class IECORE_API ModifyOp : public Op
 		/// This won't be called if the Op is not enabled.
 		virtual void modify( Object *object, const CompoundObject *operands ) = 0;
 
+		/// Returns false when the input is modified in place, as a cached
+		/// result wouldn't modify it.
+		virtual bool resultCacheable( const CompoundObject *operands ) const;
+
 	private :
 
+		// Returns true if object is referenced only by this Op and doOperation().
+		bool uniquelyReferenced( const Object *object, const CompoundObject *operands ) const;
+
 		ParameterPtr m_inputParameter;
 		BoolParameterPtr m_copyParameter;
 		BoolParameterPtr m_enableParameter;
@@ -49,6 +49,10 @@
 #include "IECore/Export.h"
 #include "IECore/InternedString.h"
 
+/// Incremented whenever a change is made which causes append() to
+/// produce different hashes for the same data.
+#define IECORE_MURMURHASH_VERSION 2
+
 namespace IECore
 {
 
@@ -60,6 +64,13 @@ namespace IECore
 /// "All MurmurHash versions are public domain software, and the
 /// author disclaims all copyright to their code."
 ///
+/// Contiguous blocks of at least 64k (as appended for large vector
+/// data) are hashed by a multi-lane variant of the same algorithm,
+/// which keeps several independent hashes in flight to make better use
+/// of the processor. This produces different results for such data than
+/// versions prior to IECORE_MURMURHASH_VERSION 2, so anything caching on
+/// disk by hash should take the version into account.
+///
 /// \todo Deal with endian-ness.
 class IECORE_API MurmurHash
 {
@@ -155,6 +166,9 @@ class IECORE_API MurmurHash
 	private :
 
 		inline void append( const void *data, size_t bytes, int elementSize );
+		// Appends of at least this many bytes are passed to appendBulk().
+		static const size_t bulkThreshold = 65536;
+		void appendBulk( const void *data, size_t bytes );
 	
 		uint64_t m_h1;
 		uint64_t m_h2;
@@ -35,12 +35,9 @@
 #ifndef IE_CORE_OBJREADER_H
 #define IE_CORE_OBJREADER_H
 
-#include <vector>
-
-#include "OpenEXR/ImathVec.h"
-
 #include "IECore/Export.h"
 #include "IECore/Reader.h"
+#include "IECore/SimpleTypedParameter.h"
 
 namespace IECore
 {
@@ -49,6 +46,10 @@ IE_CORE_FORWARDDECLARE(MeshPrimitive);
 
 /// The OBJReader class defines a class for reading OBJ mesh data.
 /// This is a subset of the full setup of objects encodable in OBJ.
+/// The file is memory mapped and split into chunks of lines which are
+/// tokenised in parallel, with the results merged at the end. Negative
+/// (relative) indices are resolved during the merge, so they may safely
+/// refer to elements defined in earlier chunks.
 /// \ingroup ioGroup
 class IECORE_API OBJReader : public Reader
 {
@@ -60,6 +61,13 @@ class IECORE_API OBJReader : public Reader
 
 		static bool canRead( const std::string &filename );
 
+		/// Parameter which when true causes the texture coordinates and
+		/// normals to be output as indexed FaceVarying primitive variables
+		/// referencing the values in the file directly, rather than being
+		/// expanded to one value per face-vertex.
+		BoolParameter *indexedFaceVaryingParameter();
+		const BoolParameter *indexedFaceVaryingParameter() const;
+
 	protected:
 
 		ObjectPtr doOperation( const CompoundObject * operands);
@@ -68,27 +76,8 @@ class IECORE_API OBJReader : public Reader
 
 		static const ReaderDescription<OBJReader> m_readerDescription;
 
-		// top-level parse method
-		void parseOBJ();
-
-		// statement-level parse methods
-		void parseVertex(const char *, const char *);
-		void parseTextureCoordinate(const char *, const char *);
-		void parseNormal(const char *, const char *);
-
-		// elements
-		void parseFace(const char *, const char *);
-
-		// grouping
-		void parseGroup(const char *, const char *);
-
-		// pointers to mesh data
-		std::vector<int> *m_vpf, *m_vids;
-		std::vector<Imath::V3f> *m_vertices, *m_normals;
-		std::vector<float> *m_sTextureCoordinates, *m_tTextureCoordinates;
+		BoolParameterPtr m_indexedFaceVaryingParameter;
 
-		// local data for assembling mesh
-		std::vector<Imath::V3f> m_introducedNormals, m_introducedTextureCoordinates;
 };
 
 IE_CORE_DECLAREPTR(OBJReader);
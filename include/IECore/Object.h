@@ -38,6 +38,7 @@
 #include <set>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "boost/shared_ptr.hpp"
 #include "IECore/Export.h"
@@ -182,8 +183,9 @@ class IECORE_API Object : public RunTimeTyped
 		/// Throws an Exception if typeName is not a valid type.
 		static ObjectPtr create( const std::string &typeName );
 		/// Loads an object previously saved with the given name in the current directory
-		/// of ioInterface.
-		static ObjectPtr load( ConstIndexedIOPtr ioInterface, const IndexedIO::EntryID &name );
+		/// of ioInterface. If parallel is true, the children of compound objects such as
+		/// CompoundObject, CompoundData, ObjectVector and Group are loaded concurrently.
+		static ObjectPtr load( ConstIndexedIOPtr ioInterface, const IndexedIO::EntryID &name, bool parallel = false );
 		//@}
 
 		typedef ObjectPtr (*CreatorFn)( void *data );
@@ -286,7 +288,9 @@ class IECORE_API Object : public RunTimeTyped
 		class IECORE_API LoadContext : public RefCounted
 		{
 			public :
-				LoadContext( ConstIndexedIOPtr ioInterface );
+				/// If parallel is true, then the load() overload taking multiple
+				/// names loads the objects concurrently.
+				LoadContext( ConstIndexedIOPtr ioInterface, bool parallel = false );
 				/// Returns an interface to the container created by SaveContext::container().
 				/// @param typeName The typename of your class.
 				/// @param ioVersion On entry this should contain the current file format version
@@ -298,20 +302,29 @@ class IECORE_API Object : public RunTimeTyped
 				template<class T>
 				/// Load an Object instance previously saved by SaveContext::save().
 				typename T::Ptr load( const IndexedIO *container, const IndexedIO::EntryID &name );
+				/// Loads several Object instances previously saved by SaveContext::save(), filling
+				/// objects with the results in the same order as names. This is equivalent to calling
+				/// the function above for each name, but the objects may be loaded concurrently.
+				/// Derived classes with many children should prefer this method to benefit from that.
+				template<class T>
+				void load( const IndexedIO *container, const IndexedIO::EntryIDList &names, std::vector<typename T::Ptr> &objects );
 				/// Returns an interface to a raw container created by SaveContext::rawContainer() - please see
 				/// documentation and cautionary notes for that function.
 				const IndexedIO *rawContainer();
 
 			private :
-				typedef std::map< IndexedIO::EntryIDList, ObjectPtr> LoadedObjectMap;
+				// Shared between all the LoadContexts used to load a single
+				// object, and defined in Object.cpp.
+				class LoadedObjects;
 
-				LoadContext( ConstIndexedIOPtr ioInterface, boost::shared_ptr<LoadedObjectMap> loadedObjects );
+				LoadContext( ConstIndexedIOPtr ioInterface, boost::shared_ptr<LoadedObjects> loadedObjects );
 
 				ObjectPtr loadObjectOrReference( const IndexedIO *container, const IndexedIO::EntryID &name );
+				void loadObjectsOrReferences( const IndexedIO *container, const IndexedIO::EntryIDList &names, std::vector<ObjectPtr> &objects );
 				ObjectPtr loadObject( const IndexedIO *container );
 
 				ConstIndexedIOPtr m_ioInterface;
-				boost::shared_ptr<LoadedObjectMap> m_loadedObjects;
+				boost::shared_ptr<LoadedObjects> m_loadedObjects;
 		};
 		IE_CORE_DECLAREPTR( LoadContext );
 
@@ -333,7 +346,14 @@ class IECORE_API Object : public RunTimeTyped
 		class IECORE_API MemoryAccumulator
 		{
 			public :
+				/// Maps from the address of a block of memory to its size in bytes.
+				typedef std::map<const void *, size_t> SharedBlocks;
 				MemoryAccumulator();
+				/// Creates an accumulator which records blocks of memory which may be
+				/// shared between objects in sharedBlocks, rather than adding them
+				/// to the total. This allows the owner of many objects to count each
+				/// shared block exactly once.
+				MemoryAccumulator( SharedBlocks *sharedBlocks );
 				/// Adds the specified number of bytes to the total.
 				void accumulate( size_t bytes );
 				/// Adds object->memoryUsage() to the total, but only
@@ -347,6 +367,7 @@ class IECORE_API Object : public RunTimeTyped
 			private :
 				std::set<const void *> m_accumulated;
 				size_t m_total;
+				SharedBlocks *m_sharedBlocks;
 		};
 
 		/// Must be implemented in all derived classes to specify the amount of memory they are
@@ -86,6 +86,18 @@ typename T::Ptr Object::LoadContext::load( const IndexedIO *i, const IndexedIO::
 	return runTimeCast<T>( loadObjectOrReference( i, name ) );
 }
 
+template<class T>
+void Object::LoadContext::load( const IndexedIO *i, const IndexedIO::EntryIDList &names, std::vector<typename T::Ptr> &objects )
+{
+	std::vector<ObjectPtr> loaded;
+	loadObjectsOrReferences( i, names, loaded );
+	objects.resize( loaded.size() );
+	for( size_t j = 0; j < loaded.size(); ++j )
+	{
+		objects[j] = runTimeCast<T>( loaded[j] );
+	}
+}
+
 } // namespace IECore
 
 #endif // IE_CORE_OBJECT_INL
@@ -40,6 +40,8 @@
 #include "IECore/Export.h"
 #include "IECore/Object.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/LRUCache.h"
+#include "IECore/DiskObjectPool.h"
 
 namespace IECore
 {
@@ -55,6 +57,9 @@ IE_CORE_FORWARDDECLARE( ObjectPool );
 /// The ObjectPool class implements a cache of Object instances indexed by their own hash and limited by the memory consumption.
 /// The function defaultObjectPool() returns a singleton object that should be used by most of the operations, 
 /// so there will be one single place where the total memory used by IECore objects is defined. 
+///
+/// Blocks of data shared between the objects in the pool, for instance by the lazy-copy-on-write of
+/// TypedData, are counted once only, for as long as any object holding them remains in the pool.
 /// 
 /// \ingroup utilityGroup
 class IECORE_API ObjectPool : public RefCounted
@@ -63,9 +68,33 @@ class IECORE_API ObjectPool : public RefCounted
 
 		IE_CORE_DECLAREMEMBERPTR( ObjectPool );
 
-		ObjectPool( size_t maxMemory );
+		/// Enum used to choose how objects are discarded when the pool exceeds
+		/// its memory limit. These correspond to the policies in the LRUCachePolicy
+		/// namespace, which documents them in more detail.
+		enum EvictionPolicy
+		{
+			/// Strict least recently used order.
+			ExactLRU = 0,
+			/// Approximate least recently used order, without any locking for hits.
+			ShardedLRU,
+			/// Protects objects used more than once from being discarded by scans.
+			TwoQueue,
+			/// Prefers discarding large objects which are rarely used.
+			CostWeighted
+		};
+
+		/// If a DiskObjectPool is specified, it is used as a second level cache - objects
+		/// evicted to meet the memory limit are written to it, and retrieve() reloads them
+		/// from it when they are not held in memory.
+		ObjectPool( size_t maxMemory, EvictionPolicy evictionPolicy = ShardedLRU, DiskObjectPoolPtr diskObjectPool = 0 );
 		virtual ~ObjectPool();
 
+		/// Returns the policy chosen at construction.
+		EvictionPolicy evictionPolicy() const;
+
+		/// Returns the DiskObjectPool chosen at construction, which may be NULL.
+		DiskObjectPool *diskObjectPool() const;
+
 		// Clears all the objects in the pool
 		void clear();
 
@@ -78,14 +107,17 @@ class IECORE_API ObjectPool : public RefCounted
 		/// Get the maximum possible memory cost of all items held in the pool
 		size_t getMaxMemoryUsage() const;
 
-		/// Returns the current memory cost of items held in the pool
+		/// Returns the current memory cost of items held in the pool, including
+		/// the shared data they hold.
 		size_t memoryUsage() const;
 
-		/// Returns true if the object with the given hash is in the pool.
+		/// Returns true if the object with the given hash is held in memory by the pool. The
+		/// DiskObjectPool is not considered.
 		/// Note: this function doesn't garantee that retrieve() will return an object in a multi-threaded application.
 		bool contains( const MurmurHash &hash ) const;
 
-		/// Retrieves the Object with the given hash, or NULL if not held in the pool.
+		/// Retrieves the Object with the given hash, or NULL if not held in the pool. Objects
+		/// which are not in memory are loaded from the DiskObjectPool if there is one.
 		ConstObjectPtr retrieve( const MurmurHash &hash ) const;
 
 		/// Enum used to specify how to store the pointer passed to the store() function.
@@ -101,11 +133,22 @@ class IECORE_API ObjectPool : public RefCounted
 		/// prevent affecting the contents of the pool and it's memoryUsage count.
 		ConstObjectPtr store( const Object *obj, StoreMode mode );
 
+		/// Returns statistics about the use of the pool, which are useful when choosing
+		/// a memory limit. Both retrieve() and store() count as lookups - a store() of an
+		/// object which is already held in the pool is a hit. The getterTime is the time
+		/// spent loading objects from the DiskObjectPool.
+		LRUCacheStatistics statistics() const;
+		/// Resets all statistics to 0.
+		void resetStatistics();
+
 		/// Returns a static ObjectPool instance to be used by anything
 		/// wishing to share IECore::Object instances. 
 		/// It makes sense to use this wherever possible to conserve memory. This initially
 		/// has a memory limit specified in megabytes by the IECORE_OBJECTPOOL_MEMORY
-		/// environment variable. If it needs changing it's recommended to do 
+		/// environment variable. If the IECORE_OBJECTPOOL_DISKCACHE_PATH environment variable
+		/// is set, the pool uses a DiskObjectPool in that directory, with a limit specified
+		/// in megabytes by IECORE_OBJECTPOOL_DISKCACHE_SIZE (defaulting to 10000).
+		/// If it needs changing it's recommended to do 
 		/// that from a config file loaded by the ConfigLoader, to avoid multiple 
 		/// clients fighting over the same set of settings.
 		static ObjectPool *defaultObjectPool();
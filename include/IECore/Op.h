@@ -37,6 +37,7 @@
 
 #include "IECore/Export.h"
 #include "IECore/Parameterised.h"
+#include "IECore/MurmurHash.h"
 
 namespace IECore
 {
@@ -79,6 +80,17 @@ class IECORE_API Op : public Parameterised
 		/// value of this parameter is always the value last returned by operate.
 		const Parameter *resultParameter() const;
 
+		/// Enables caching of the results of operate(), so that repeating an
+		/// operation with identical operands returns a copy of the earlier result
+		/// rather than computing it again. Results are shared between all Ops,
+		/// keyed by hash(), and held in ObjectPool::defaultObjectPool(). Off by
+		/// default.
+		void setResultCaching( bool enabled );
+		bool getResultCaching() const;
+
+		/// Removes all the results stored by the Ops using result caching.
+		static void clearResultCache();
+
 	protected :
 
 		/// Called by operate() to actually perform the operation. operands
@@ -88,9 +100,24 @@ class IECORE_API Op : public Parameterised
 		/// \todo This should be const.
 		virtual ObjectPtr doOperation( const CompoundObject *operands ) = 0;
 
+		/// Appends to h a hash uniquely identifying the result of doOperation()
+		/// for the given operands, for use by the result cache. The default
+		/// implementation hashes the type of the Op and the operands, which is
+		/// sufficient for any Op whose result depends only on its operands.
+		virtual void hash( const CompoundObject *operands, MurmurHash &h ) const;
+		/// Returns true if the result of doOperation() for the given operands
+		/// may be cached. The default implementation returns true, and Ops with
+		/// side effects should override it to return false.
+		virtual bool resultCacheable( const CompoundObject *operands ) const;
+
 	private :
 
+		struct ResultCacheKey;
+		static ConstObjectPtr cachedOperation( const ResultCacheKey &key );
+		static MurmurHash resultCacheKeyHash( const ResultCacheKey &key );
+
 		ParameterPtr m_resultParameter;
+		bool m_resultCaching;
 
 };
 
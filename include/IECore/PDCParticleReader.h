@@ -35,10 +35,20 @@
 #ifndef IE_CORE_PDCPARTICLEREADER_H
 #define IE_CORE_PDCPARTICLEREADER_H
 
+#include "boost/shared_ptr.hpp"
+
 #include "IECore/Export.h"
 #include "IECore/ParticleReader.h"
 #include "IECore/VectorTypedData.h"
 
+namespace boost
+{
+namespace iostreams
+{
+class mapped_file_source;
+} // namespace iostreams
+} // namespace boost
+
 namespace IECore
 {
 
@@ -46,6 +56,13 @@ namespace IECore
 /// interface for Maya .pdc format particle caches. Percentage filtering
 /// of loaded particles is seeded using the particleId attribute, so
 /// is not only repeatable but also consistent from frame to frame.
+///
+/// Attributes are decoded straight from the file data into the
+/// requested type, and percentage filtering is applied as part of the
+/// decoding, so only the particles being kept are ever converted or
+/// allocated. When the memoryMapped parameter is on, the file is mapped
+/// into memory rather than the raw attribute data being read into a
+/// temporary buffer.
 /// \ingroup ioGroup
 class IECORE_API PDCParticleReader : public ParticleReader
 {
@@ -63,6 +80,13 @@ class IECORE_API PDCParticleReader : public ParticleReader
 		virtual unsigned long numParticles();
 		virtual void attributeNames( std::vector<std::string> &names );
 		virtual DataPtr readAttribute( const std::string &name );
+		/// Reads only the data for the requested range from the file.
+		virtual DataPtr readAttributeRange( const std::string &name, size_t begin, size_t end );
+
+		/// Parameter which when true causes the file to be memory mapped
+		/// for reading, rather than being read through a stream.
+		BoolParameter *memoryMappedParameter();
+		const BoolParameter *memoryMappedParameter() const;
 
 	protected:
 		
@@ -106,9 +130,28 @@ class IECORE_API PDCParticleReader : public ParticleReader
 		template<typename T>
 		void readElements( T *buffer, std::streampos pos, unsigned long n ) const;
 
-		// loads particleId in a completely unfiltered state
-		const Data * idAttribute();
-		DataPtr m_idAttribute;
+		// Returns size bytes of raw data starting at offset bytes into an attribute,
+		// either directly from the memory mapped file, or having read it into buffer.
+		const char *attributeData( const Record &record, size_t offset, size_t size, std::vector<char> &buffer );
+		// Decodes the particles in the range [begin, end) of an array attribute into
+		// a new T, filtered by the current selection.
+		template<typename T, typename F>
+		typename T::Ptr readArray( const Record &record, size_t numComponents, size_t begin, size_t end );
+
+		// Returns the record for the particleId attribute, or 0 if there isn't one.
+		const Record *idRecord() const;
+		// Returns the indices of the particles passing percentage filtering, or 0 if
+		// no filtering is required. The result is cached until the file or the
+		// percentage parameters change.
+		const std::vector<unsigned> *selection();
+
+		BoolParameterPtr m_memoryMappedParameter;
+		boost::shared_ptr<boost::iostreams::mapped_file_source> m_mappedFile;
+
+		bool m_selectionValid;
+		float m_selectionPercentage;
+		int m_selectionSeed;
+		std::vector<unsigned> m_selection;
 
 };
 
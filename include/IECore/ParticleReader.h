@@ -44,6 +44,8 @@
 namespace IECore
 {
 
+IE_CORE_FORWARDDECLARE( PointsPrimitive );
+
 /// The ParticleReader class defines an abstract base class
 /// for classes able to read particle cache file formats.
 /// Its main purpose is to define a standard set of parameters
@@ -102,6 +104,22 @@ class IECORE_API ParticleReader : public Reader
 		/// exist. The type of Data is chosen automatically to best represent the
 		/// particle data.
 		virtual DataPtr readAttribute( const std::string &name ) = 0;
+		/// Reads the specified attribute for the particles with indices in the
+		/// range [begin, end), filtered by the percentage specified in parameters().
+		/// The range refers to particle indices in the file prior to filtering,
+		/// and is clamped to numParticles(). Filtering is consistent with
+		/// readAttribute(), so concatenating the results for consecutive ranges
+		/// gives the same result as reading the whole attribute at once. Non
+		/// varying attributes are returned whole. The default implementation
+		/// reads the whole attribute and copies the range from it, and throws
+		/// if percentage filtering is enabled - derived classes should
+		/// reimplement it to read only the data required.
+		virtual DataPtr readAttributeRange( const std::string &name, size_t begin, size_t end );
+		/// Returns a PointsPrimitive containing the requested attributes for the
+		/// particles in the range [begin, end), as described for readAttributeRange().
+		/// This allows large caches to be converted in chunks, without ever holding
+		/// all the particles in memory at once.
+		PointsPrimitivePtr readRange( size_t begin, size_t end );
 		//@}
 
 	protected :
@@ -139,6 +157,10 @@ class IECORE_API ParticleReader : public Reader
 
 	private :
 
+		// Implements doOperation() and readRange(), reading whole attributes
+		// when range is false.
+		PointsPrimitivePtr readPoints( bool range, size_t begin, size_t end );
+
 		template<typename T, typename F, typename U >
 		typename T::Ptr filterAttr( const F * attr, float percentage, const std::vector< U > &ids ) const;
 
@@ -115,9 +115,20 @@ class PerlinNoise
 		/// As above but performs antialiasing using frequency clamping.
 		inline Value operator()( const Point &p, PointBaseType filterWidth ) const;
 
+		/// Computes the noise values for many points at once, resizing values
+		/// to match. The results are identical to calling noise() for each point,
+		/// but are computed in parallel.
+		void noise( const std::vector<Point> &points, std::vector<Value> &values ) const;
+		/// As above but performs antialiasing using frequency clamping.
+		void noise( const std::vector<Point> &points, PointBaseType filterWidth, std::vector<Value> &values ) const;
+
 	private :
 
 		inline Value noiseWalk( int *pi, const Point &pf, int d ) const;
+		/// Specialised equivalent of noiseWalk() for three dimensional
+		/// points, which is used by noise() for the common V3f case.
+		inline Value noise3( const Point &p ) const;
+		inline Value gradient3( unsigned int perm, PointBaseType dx, PointBaseType dy, PointBaseType dz ) const;
 
 		static const unsigned int m_maxPointDimensions = 4;
 		static const unsigned int m_permSize = 256;
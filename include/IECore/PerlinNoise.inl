@@ -43,6 +43,9 @@
 #include "OpenEXR/ImathFun.h"
 #include "OpenEXR/ImathRandom.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include <vector>
 #include <algorithm>
 
@@ -51,6 +54,72 @@
 namespace IECore
 {
 
+namespace Detail
+{
+
+// Evaluates a noise or turbulence functor for a range of points.
+template<typename Point, typename Value, typename Evaluator>
+class NoiseArrayEvaluator
+{
+
+	public :
+
+		NoiseArrayEvaluator( const Evaluator &evaluator, const std::vector<Point> &points, std::vector<Value> &values )
+			:	m_evaluator( evaluator ), m_points( points ), m_values( values )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				m_values[i] = m_evaluator( m_points[i] );
+			}
+		}
+
+	private :
+
+		const Evaluator &m_evaluator;
+		const std::vector<Point> &m_points;
+		std::vector<Value> &m_values;
+
+};
+
+// Adapts a noise or turbulence object and a filter width for use
+// with NoiseArrayEvaluator.
+template<typename N>
+class FilteredNoise
+{
+
+	public :
+
+		FilteredNoise( const N &noise, typename N::PointBaseType filterWidth )
+			:	m_noise( noise ), m_filterWidth( filterWidth )
+		{
+		}
+
+		typename N::Value operator()( const typename N::Point &p ) const
+		{
+			return m_noise( p, m_filterWidth );
+		}
+
+	private :
+
+		const N &m_noise;
+		typename N::PointBaseType m_filterWidth;
+
+};
+
+template<typename Point, typename Value, typename Evaluator>
+void evaluateNoiseArray( const Evaluator &evaluator, const std::vector<Point> &points, std::vector<Value> &values )
+{
+	values.resize( points.size() );
+	NoiseArrayEvaluator<Point, Value, Evaluator> arrayEvaluator( evaluator, points, values );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, points.size(), 1024 ), arrayEvaluator );
+}
+
+} // namespace Detail
+
 template<typename P, typename V, typename F>
 PerlinNoise<P, V, F>::PerlinNoise( unsigned long int seed )
 {
@@ -113,6 +182,11 @@ void PerlinNoise<P, V, F>::initGradients( unsigned long int seed )
 template<typename P, typename V, typename F>
 inline typename PerlinNoise<P, V, F>::Value PerlinNoise<P, V, F>::noise( const Point &p ) const
 {
+	if( PointTraits::dimensions() == 3 )
+	{
+		return noise3( p );
+	}
+
 	int pi[m_maxPointDimensions];
 	for( unsigned int i=0; i<PointTraits::dimensions(); i++ )
 	{
@@ -147,6 +221,83 @@ inline typename PerlinNoise<P, V, F>::Value PerlinNoise<P, V, F>::operator()( co
 	return noise( p, filterWidth );
 }
 
+template<typename P, typename V, typename F>
+void PerlinNoise<P, V, F>::noise( const std::vector<Point> &points, std::vector<Value> &values ) const
+{
+	Detail::evaluateNoiseArray( *this, points, values );
+}
+
+template<typename P, typename V, typename F>
+void PerlinNoise<P, V, F>::noise( const std::vector<Point> &points, PointBaseType filterWidth, std::vector<Value> &values ) const
+{
+	Detail::evaluateNoiseArray( Detail::FilteredNoise<PerlinNoise>( *this, filterWidth ), points, values );
+}
+
+template<typename P, typename V, typename F>
+inline typename PerlinNoise<P, V, F>::Value PerlinNoise<P, V, F>::noise3( const P &p ) const
+{
+	// This performs exactly the same arithmetic as noiseWalk(), so gives
+	// identical results, but avoids the recursion, computes the permutations
+	// for the eight corners of the cell with shared lookups, and evaluates
+	// each falloff only once.
+
+	const int x0 = fastFloatFloor( vecGet( p, 0 ) );
+	const int y0 = fastFloatFloor( vecGet( p, 1 ) );
+	const int z0 = fastFloatFloor( vecGet( p, 2 ) );
+	const int x1 = x0 + 1;
+	const int y1 = y0 + 1;
+	const int z1 = z0 + 1;
+
+	const PointBaseType dx0 = vecGet( p, 0 ) - x0;
+	const PointBaseType dy0 = vecGet( p, 1 ) - y0;
+	const PointBaseType dz0 = vecGet( p, 2 ) - z0;
+	const PointBaseType dx1 = vecGet( p, 0 ) - x1;
+	const PointBaseType dy1 = vecGet( p, 1 ) - y1;
+	const PointBaseType dz1 = vecGet( p, 2 ) - z1;
+
+	const unsigned int mask = m_permSize - 1;
+	const unsigned int *perm = &m_perm[0];
+	const unsigned int px0 = perm[x0 & mask];
+	const unsigned int px1 = perm[x1 & mask];
+	const unsigned int px0y0 = perm[px0 + ( y0 & mask )];
+	const unsigned int px0y1 = perm[px0 + ( y1 & mask )];
+	const unsigned int px1y0 = perm[px1 + ( y0 & mask )];
+	const unsigned int px1y1 = perm[px1 + ( y1 & mask )];
+
+	const unsigned int z0m = z0 & mask;
+	const unsigned int z1m = z1 & mask;
+
+	const Value v000 = gradient3( perm[px0y0 + z0m], dx0, dy0, dz0 );
+	const Value v100 = gradient3( perm[px1y0 + z0m], dx1, dy0, dz0 );
+	const Value v010 = gradient3( perm[px0y1 + z0m], dx0, dy1, dz0 );
+	const Value v110 = gradient3( perm[px1y1 + z0m], dx1, dy1, dz0 );
+	const Value v001 = gradient3( perm[px0y0 + z1m], dx0, dy0, dz1 );
+	const Value v101 = gradient3( perm[px1y0 + z1m], dx1, dy0, dz1 );
+	const Value v011 = gradient3( perm[px0y1 + z1m], dx0, dy1, dz1 );
+	const Value v111 = gradient3( perm[px1y1 + z1m], dx1, dy1, dz1 );
+
+	const PointBaseType fx = m_falloff( dx0 );
+	const PointBaseType fy = m_falloff( dy0 );
+	const PointBaseType fz = m_falloff( dz0 );
+
+	return Imath::lerp(
+		Imath::lerp( Imath::lerp( v000, v100, fx ), Imath::lerp( v010, v110, fx ), fy ),
+		Imath::lerp( Imath::lerp( v001, v101, fx ), Imath::lerp( v011, v111, fx ), fy ),
+		fz
+	);
+}
+
+template<typename P, typename V, typename F>
+inline typename PerlinNoise<P, V, F>::Value PerlinNoise<P, V, F>::gradient3( unsigned int perm, PointBaseType dx, PointBaseType dy, PointBaseType dz ) const
+{
+	const Value *grad = &m_grad[perm*3];
+	V g( 0 );
+	g += grad[0] * dx;
+	g += grad[1] * dy;
+	g += grad[2] * dz;
+	return g;
+}
+
 template<typename P, typename V, typename F>
 inline typename PerlinNoise<P, V, F>::Value PerlinNoise<P, V, F>::noiseWalk( int *pi, const P &p, int d ) const
 {
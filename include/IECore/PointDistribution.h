@@ -39,6 +39,8 @@
 #include "OpenEXR/ImathBox.h"
 
 #include "boost/noncopyable.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/scoped_ptr.hpp"
 
 #include "IECore/Export.h"
 
@@ -51,6 +53,10 @@ namespace IECore
 ///
 /// <b>CORTEX_POINTDISTRIBUTION_TILESET</b><br>
 /// Defines the location of the tileset used by IECore::PointDistribution::defaultInstance().
+///
+/// <b>IECORE_POINTDISTRIBUTION_MEMORY</b><br>
+/// The amount of memory in megabytes used by each PointDistribution to cache the
+/// points it has generated, defaulting to 100.
 
 /// An implementation of the following paper for producing nice 2d point
 /// distributions with varying density.
@@ -58,6 +64,16 @@ namespace IECore
 ///	Recursive Wang Tiles for Real-Time Blue Noise
 ///	Johannes Kopf, Daniel Cohen-Or, Oliver Deussen, Dani Lischinski
 ///	In ACM Transactions on Graphics 25, 3 (Proc. SIGGRAPH 2006)
+///
+/// The candidate points for a given bounds and density are generated in
+/// parallel across tiles, and are cached so that repeated distributions
+/// over the same region - for instance when scattering onto a deforming
+/// mesh with fixed UVs on every frame - don't need to regenerate them. The
+/// density function and point emitter are still called serially, in the
+/// same order as if the points were generated on the fly.
+///
+/// \threading It is safe to call the distribution operators from concurrent threads,
+/// provided the density function and point emitter passed to each call are not shared.
 /// \ingroup mathGroup
 class IECORE_API PointDistribution : public boost::noncopyable
 {
@@ -67,6 +83,7 @@ class IECORE_API PointDistribution : public boost::noncopyable
 		/// Constructor takes the filename of a tile set. We use the set
 		/// found at http://johanneskopf.de/publications/blue_noise/tilesets/tileset_2048.dat
 		PointDistribution( const std::string &tileSet );
+		~PointDistribution();
 	
 		/// Returns points in the box specified by bounds.
 		///
@@ -98,12 +115,29 @@ class IECORE_API PointDistribution : public boost::noncopyable
 		
 		template<typename DensityFunction, typename PointFunction>
 		struct DensityThresholdedEmitter;
-		
-		template<typename PointFunction>
-		void processTile( const Tile &tile, const Imath::V2f &bottomLeft, const Imath::Box2f &bounds, float density, PointFunction &pointEmitter ) const;
 
-		template<typename PointFunction>
-		void recurseTile( const Tile &tile, const Imath::V2f &bottomLeft, unsigned level, const Imath::Box2f &bounds, float density, PointFunction &pointEmitter ) const;
+		// The points to be emitted for a particular bounds and density,
+		// along with their density thresholds.
+		struct Candidates
+		{
+			std::vector<Imath::V2f> points;
+			std::vector<float> densityThresholds;
+		};
+		typedef boost::shared_ptr<const Candidates> ConstCandidatesPtr;
+
+		// Returns the candidates from the cache, generating them if necessary.
+		ConstCandidatesPtr candidates( const Imath::Box2f &bounds, float density ) const;
+
+		struct CandidatesKey;
+		ConstCandidatesPtr generateCandidates( const CandidatesKey &key, size_t &cost ) const;
+
+		struct Job;
+		class JobRunner;
+
+		void processTile( const Tile &tile, const Imath::V2f &bottomLeft, const Imath::Box2f &bounds, float density, Candidates &candidates ) const;
+		void recurseTile( const Tile &tile, const Imath::V2f &bottomLeft, unsigned level, const Imath::Box2f &bounds, float density, bool recurse, Candidates &candidates ) const;
+		bool subdivides( const Tile &tile, const Imath::V2f &bottomLeft, unsigned level, const Imath::Box2f &bounds, float density ) const;
+		float tileSize( unsigned level ) const;
 	
 		typedef std::vector<Tile> TileVector;
 		TileVector m_tiles;
@@ -113,6 +147,9 @@ class IECORE_API PointDistribution : public boost::noncopyable
 		inline unsigned int hash( int x, int y ) const;
 		static const unsigned int m_permSize = 256;
 		std::vector<unsigned int> m_perm;
+
+		class Cache;
+		boost::scoped_ptr<Cache> m_cache;
 		
 };
 
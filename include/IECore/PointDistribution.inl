@@ -35,8 +35,6 @@
 #ifndef IECORE_POINTDISTRIBUTION_INL
 #define IECORE_POINTDISTRIBUTION_INL
 
-#include "IECore/FastFloat.h"
-
 #include <cassert>
 
 namespace IECore
@@ -85,93 +83,12 @@ void PointDistribution::operator () ( const Imath::Box2f &bounds, float density,
 template<typename PointFunction>
 void PointDistribution::operator () ( const Imath::Box2f &bounds, float density, PointFunction &pointEmitter ) const
 {
-	Imath::Box2i bi;
-	bi.min.x = fastFloatFloor( bounds.min.x );
-	bi.max.x = fastFloatFloor( bounds.max.x );
-	bi.min.y = fastFloatFloor( bounds.min.y );
-	bi.max.y = fastFloatFloor( bounds.max.y );
-
-	for( int x=bi.min.x; x<=bi.max.x; x++ )
-	{
-		for( int y=bi.min.y; y<=bi.max.y; y++ )
-		{
-			unsigned sw = hash( x, y );
-			unsigned nw = hash( x, y+1 );
-			unsigned ne = hash( x+1, y+1 );
-			unsigned se = hash( x+1, y );
-			int w = (sw + nw) % 2;
-			int n = (nw + ne) % 2;
-			int e = (ne + se) % 2;
-			for( unsigned i=0; i<m_tiles.size(); i++ )
-			{
-				const Tile *tile = &m_tiles[i];
-				if( tile->w==w && tile->n==n && tile->e==e )
-				{
-					processTile( *tile, Imath::V2f( x, y ), bounds, density, pointEmitter );
-					break;
-				}
-			}
-		}
-	}
-}
-		
-template<typename PointFunction>
-void PointDistribution::processTile( const Tile &tile, const Imath::V2f &bottomLeft, const Imath::Box2f &bounds, float density, PointFunction &pointEmitter ) const
-{
-	unsigned potentialPoints = std::min( tile.points.size(), (size_t)density );
-	float factor = 1.0f / density;
-	for( unsigned i=0; i<potentialPoints; i++ )
-	{
-		const Imath::V2f p = bottomLeft + tile.points[i];
-		if( !bounds.intersects( p ) )
-		{
-			continue;
-		}
-		
-		pointEmitter( p, i * factor );
-	}
-
-	recurseTile( tile, bottomLeft, 0, bounds, density, pointEmitter );
-}
-
-template<typename PointFunction>
-void PointDistribution::recurseTile( const Tile &tile, const Imath::V2f &bottomLeft, unsigned level, const Imath::Box2f &bounds, float density, PointFunction &pointEmitter ) const
-{
-	float tileSize = 1.0f / powf( (float)m_numSubTiles, (float)level );
-	
-	Imath::Box2f tileBound( bottomLeft, bottomLeft + Imath::V2f( tileSize ) );
-	if( !tileBound.intersects( bounds ) )
-	{
-		return;
-	}
-	
-	float tileArea = tileSize * tileSize;
-	float numPointsInTile = density * tileArea;
-	int potentialPoints = std::min( (int)tile.subPoints.size(), (int)numPointsInTile - (int)tile.points.size() );
-	
-	float factor = 1.0f / ( numPointsInTile );
-	
-	for( int i=0; i<potentialPoints; i++ )
+	ConstCandidatesPtr c = candidates( bounds, density );
+	const std::vector<Imath::V2f> &points = c->points;
+	const std::vector<float> &densityThresholds = c->densityThresholds;
+	for( size_t i=0, e=points.size(); i<e; i++ )
 	{
-		const Imath::V2f p = bottomLeft + tile.subPoints[i] * tileSize;
-		if( !bounds.intersects( p ) )
-		{
-			continue;
-		}
-		
-		pointEmitter( p, ( i + tile.points.size() ) * factor );
-	}
-	
-	if( numPointsInTile - tile.points.size() > tile.subPoints.size() )
-	{
-		for( int y=0; y<m_numSubTiles; y++ )
-		{
-			for( int x=0; x<m_numSubTiles; x++ )
-			{
-				Imath::V2f newBottomLeft = bottomLeft + Imath::V2f( x, y ) * tileSize / m_numSubTiles;
-				recurseTile( *(tile.subTiles[y*m_numSubTiles + x]), newBottomLeft, level + 1, bounds, density, pointEmitter );
-			}
-		}
+		pointEmitter( points[i], densityThresholds[i] );
 	}
 }
 
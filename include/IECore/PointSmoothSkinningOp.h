@@ -70,7 +70,10 @@ class IECORE_API PointSmoothSkinningOp : public ModifyOp
 		typedef enum
 		{
 			Linear = 0,
-			// todo: DualQuaternion = 1
+			/// Blends rigid transformations using dual quaternions, avoiding the
+			/// volume loss of linear blending. Scaling and shearing in the skinning
+			/// matrices are ignored.
+			DualQuaternion = 1,
 			// todo: LinearDualQuaternionMix = 2
 		} Blend;
 
@@ -123,9 +126,27 @@ class IECORE_API PointSmoothSkinningOp : public ModifyOp
 		IntVectorParameterPtr m_refIndicesParameter;
 
 		ConstSmoothSkinningDataPtr m_prevSmoothSkinningData;
-		
+
+		// The influences from m_prevSmoothSkinningData, compiled into a form more
+		// suitable for deformation. The influences for each point are packed
+		// together with their weights, and influences with zero weight are removed.
+		// The influences for point i are in the range
+		// [ m_influenceOffsets[i], m_influenceOffsets[i+1] ).
+		struct Influence
+		{
+			int index;
+			float weight;
+		};
+		std::vector<int> m_influenceOffsets;
+		std::vector<Influence> m_influences;
+		void compileInfluences( const SmoothSkinningData *ssd );
+
+		template<typename Skinner>
 		struct DeformPositions;
+		template<typename Skinner>
 		struct DeformNormals;
+		template<typename Skinner>
+		void deform( const Skinner &skinner, Primitive *primitive, std::vector<Imath::V3f> &p, const std::vector<int> &refIds, bool deformNormals, const std::string &normalVar ) const;
 };
 
 IE_CORE_DECLAREPTR( PointSmoothSkinningOp );
@@ -35,11 +35,15 @@
 #ifndef IECORE_POINTSPRIMITIVEEVALUATOR_H
 #define IECORE_POINTSPRIMITIVEEVALUATOR_H
 
+#include "tbb/atomic.h"
 #include "tbb/mutex.h"
 
+#include "OpenEXR/ImathLine.h"
+
 #include "IECore/Export.h"
 #include "IECore/PrimitiveEvaluator.h"
 #include "IECore/KDTree.h"
+#include "IECore/BoundingVolumeHierarchy.h"
 
 namespace IECore
 {
@@ -47,7 +51,9 @@ namespace IECore
 IE_CORE_FORWARDDECLARE( PointsPrimitive )
 
 /// The PointsPrimitiveEvaluator implements the PrimitiveEvaluator interface for
-/// PointsPrimitives.
+/// PointsPrimitives. For the purposes of ray intersection, each point is treated
+/// as a sphere whose diameter is given by the "width" and "constantwidth" primitive
+/// variables, in the same way as PointsPrimitive::bound().
 /// \ingroup geometryProcessingGroup
 class IECORE_API PointsPrimitiveEvaluator : public PrimitiveEvaluator
 {
@@ -64,8 +70,11 @@ class IECORE_API PointsPrimitiveEvaluator : public PrimitiveEvaluator
 
 				IE_CORE_DECLAREMEMBERPTR( Result );
 
+				/// Returns the position of the point for closestPoint() queries,
+				/// and the position on the surface of its sphere for intersection queries.
 				virtual Imath::V3f point() const;
-				/// Not yet implemented.
+				/// Returns the normal of the sphere at the intersection point. Not
+				/// available for closestPoint() queries.
 				virtual Imath::V3f normal() const;
 				/// Not yet implemented.
 				virtual Imath::V2f uv() const;
@@ -92,6 +101,9 @@ class IECORE_API PointsPrimitiveEvaluator : public PrimitiveEvaluator
 				const T &primVar( const PrimitiveVariable &pv ) const;
 				
 				size_t m_pointIndex;
+				bool m_intersection;
+				Imath::V3f m_point;
+				Imath::V3f m_normal;
 				PointsPrimitiveEvaluator::ConstPtr m_evaluator;
 				
 		};
@@ -118,14 +130,35 @@ class IECORE_API PointsPrimitiveEvaluator : public PrimitiveEvaluator
 		virtual bool closestPoint( const Imath::V3f &p, PrimitiveEvaluator::Result *result ) const;
 		/// Not yet implemented.
 		virtual bool pointAtUV( const Imath::V2f &uv, PrimitiveEvaluator::Result *result ) const;
-		/// Not yet implemented.	
+		/// Intersects the ray with the spheres defined by the point widths.
 		virtual bool intersectionPoint( const Imath::V3f &origin, const Imath::V3f &direction,
 			PrimitiveEvaluator::Result *result, float maxDistance = Imath::limits<float>::max() ) const;
-		/// Not yet implemented.	
+		/// Intersects the ray with the spheres defined by the point widths, returning
+		/// the results sorted with the closest first.
 		virtual int intersectionPoints( const Imath::V3f &origin, const Imath::V3f &direction,
 			std::vector<PrimitiveEvaluator::ResultPtr> &results, float maxDistance = Imath::limits<float>::max() ) const;
 		//@}
 
+		//! @name Batch Query Functions
+		////////////////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Reimplemented to query the tree directly, without the overhead of
+		/// creating Results.
+		virtual void batchClosestPoint( const std::vector<Imath::V3f> &points, BatchResults &results ) const;
+		//@}
+
+		//! @name Radius Queries
+		/// These operate only on the point centres, without taking into account their width.
+		////////////////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Fills indices with the indices of all points within radius of p, returning
+		/// the number found.
+		size_t pointsInRadius( const Imath::V3f &p, float radius, std::vector<size_t> &indices ) const;
+		/// Performs pointsInRadius() for every query point, distributing the queries
+		/// across multiple threads. On return indices[i] holds the points found for points[i].
+		void batchPointsInRadius( const std::vector<Imath::V3f> &points, float radius, std::vector<std::vector<size_t> > &indices ) const;
+		//@}
+
 	protected :
 		
 		/// \todo It would be much better if PrimitiveEvaluator::Description didn't require these create()
@@ -134,21 +167,38 @@ class IECORE_API PointsPrimitiveEvaluator : public PrimitiveEvaluator
 		friend struct PrimitiveEvaluator::Description<PointsPrimitiveEvaluator>;
 		static PrimitiveEvaluator::Description<PointsPrimitiveEvaluator> g_evaluatorDescription;
 
-	private :
+		/// Stores the point, and the normal for intersection queries.
+		virtual void storeBatchResult( const PrimitiveEvaluator::Result *result, size_t index, BatchResults &results ) const;
 
+	private :
 
 		friend class Result;
 
+		class BatchClosestPoint;
+		class BatchPointsInRadius;
+
 		PointsPrimitivePtr m_pointsPrimitive;
 		PrimitiveVariable m_p;
 		const std::vector<Imath::V3f> *m_pVector;
-		
+
+		float radius( size_t pointIndex ) const;
+		const std::vector<float> *m_widthVector;
+		float m_constantWidth;
+
 		void buildTree();
-		bool m_haveTree;
+		tbb::atomic<bool> m_haveTree;
 		typedef tbb::mutex TreeMutex;
 		TreeMutex m_treeMutex;
-		V3fTree m_tree;		
-		
+		V3fTree m_tree;
+
+		void buildBVH();
+		bool intersectsSphere( size_t pointIndex, const Imath::Line3f &ray, float maxDistance, float &distance ) const;
+		void setIntersectionResult( Result *result, size_t pointIndex, const Imath::Line3f &ray, float distance ) const;
+		tbb::atomic<bool> m_haveBVH;
+		TreeMutex m_bvhMutex;
+		std::vector<Imath::Box3f> m_bounds;
+		Box3fBVH m_bvh;
+
 };
 
 IE_CORE_DECLAREPTR( PointsPrimitiveEvaluator );
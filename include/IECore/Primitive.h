@@ -110,9 +110,18 @@ class IECORE_API Primitive : public VisibleRenderable
 		/// \param name Name of the entry where the Primitive is stored under the file location.
 		/// \param primVarNames List of primitive variable names that will be attempted to be loaded.
 		static PrimitiveVariableMap loadPrimitiveVariables( const IndexedIO *ioInterface, const IndexedIO::EntryID &name, const IndexedIO::EntryIDList &primVarNames );
+		/// As loadPrimitiveVariables(), but loads only the elements in the range [begin, end) of Vertex, Varying
+		/// and FaceVarying variables, clamped to the size of each variable. For indexed variables the range applies
+		/// to the indices, and the data is loaded whole, as are Constant and Uniform variables. Only vector data of
+		/// the numeric types can be loaded partially, and the names of any other ranged variables are appended to
+		/// unsupportedNames instead of being loaded.
+		static PrimitiveVariableMap loadPrimitiveVariableRange( const IndexedIO *ioInterface, const IndexedIO::EntryID &name, const IndexedIO::EntryIDList &primVarNames, size_t begin, size_t end, IndexedIO::EntryIDList &unsupportedNames );
 
 	private:
 
+		static ConstIndexedIOPtr loadVariablesContainer( const IndexedIO *ioInterface, const IndexedIO::EntryID &name, IECore::Object::LoadContextPtr &context );
+		static PrimitiveVariable loadPrimitiveVariable( IECore::Object::LoadContext *context, const IndexedIO *ioPrimVar );
+
 		static const unsigned int m_ioVersion;
 
 };
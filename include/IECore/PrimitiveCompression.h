@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_PRIMITIVECOMPRESSION_H
+#define IECORE_PRIMITIVECOMPRESSION_H
+
+#include "IECore/Primitive.h"
+
+namespace IECore
+{
+
+/// Functions for a lossy but bounded encoding of the bulkiest primitive
+/// variables, used by SceneCache to reduce the size of geometry caches.
+/// The encoded variables hold CompoundData, and are not valid for use until
+/// they have been decompressed again.
+///
+/// - V3fVectorData with Point interpretation (or named "P" and with no
+///   interpretation) is quantised to 16 bits per component, relative to
+///   its bounding box. The error in each component is at most 1/131070 of
+///   the size of the box in that axis.
+/// - V3fVectorData with Normal interpretation (or named "N" and with no
+///   interpretation) is octahedrally encoded with 16 bits per component,
+///   provided all the normals have unit length. The angular error is at
+///   most a few thousandths of a degree.
+/// - V2fVectorData and FloatVectorData texture coordinate variables, named
+///   "s", "t", "uv" or "st" optionally with a prefix such as "map1_", are
+///   quantised to 16 bits per component relative to their range.
+///
+/// All other variables are left as they are.
+namespace PrimitiveCompression
+{
+
+/// Returns a copy of the primitive with the above encodings applied. The
+/// copy shares the data of all the variables which aren't encoded.
+IECORE_API PrimitivePtr compress( const Primitive *primitive );
+/// Decodes any variables encoded by compress(), returning true if there
+/// were any. The results have the same types and interpretations as the
+/// originals.
+IECORE_API bool decompress( PrimitiveVariableMap &variables );
+/// Returns true if the variable was encoded by compress().
+IECORE_API bool isCompressed( const PrimitiveVariable &variable );
+
+} // namespace PrimitiveCompression
+
+} // namespace IECore
+
+#endif // IECORE_PRIMITIVECOMPRESSION_H
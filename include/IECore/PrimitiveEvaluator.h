@@ -36,6 +36,7 @@
 #define IE_CORE_PRIMITIVEEVALUATOR_H
 
 #include <string>
+#include <vector>
 
 #include "OpenEXR/ImathVec.h"
 #include "OpenEXR/ImathColor.h"
@@ -159,6 +160,43 @@ class IECORE_API PrimitiveEvaluator : public RunTimeTyped
 
 		//@}
 
+		/// Stores the results of a batch of queries as a structure of arrays, with one
+		/// element per query. Values for failed queries, and for any values not
+		/// supported by a particular evaluator, are set to zero.
+		struct IECORE_API BatchResults
+		{
+			void resize( size_t size );
+
+			/// Nonzero for successful queries. This isn't a vector<bool> so that
+			/// separate elements may be written concurrently.
+			std::vector<char> success;
+			std::vector<Imath::V3f> point;
+			std::vector<Imath::V3f> normal;
+			std::vector<Imath::V2f> uv;
+		};
+
+		//! @name Batch Query Functions
+		/// Perform many queries at once, resizing results to match the number of queries.
+		/// The default implementations distribute the queries across threads using TBB,
+		/// calling the single query functions above with one Result per task. Derived
+		/// classes are therefore not required to implement them, but may do so if they
+		/// can amortise work across queries.
+		////////////////////////////////////////////////////////////////////////////////////////
+		//@{
+
+		/// Batched equivalent of closestPoint().
+		virtual void batchClosestPoint( const std::vector<Imath::V3f> &points, BatchResults &results ) const;
+
+		/// Batched equivalent of pointAtUV().
+		virtual void batchPointAtUV( const std::vector<Imath::V2f> &uvs, BatchResults &results ) const;
+
+		/// Batched equivalent of intersectionPoint(). Throws if origins and directions
+		/// differ in length.
+		virtual void batchIntersectionPoint( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions,
+			BatchResults &results, float maxDistance = Imath::limits<float>::max() ) const;
+
+		//@}
+
 		/// Throws an exception if the passed result type is not compatible with the current evaluator
 		virtual void validateResult( Result *result ) const =0;
 
@@ -173,8 +211,21 @@ class IECORE_API PrimitiveEvaluator : public RunTimeTyped
 			}
 		};
 
+	protected :
+
+		/// Called by the default batch query implementations to copy a successful query
+		/// result into element index of results, which has already been sized appropriately.
+		/// The default implementation stores point, normal and uv - derived classes whose
+		/// results don't support all of these should override it to store only those which
+		/// they do, leaving the others untouched.
+		virtual void storeBatchResult( const Result *result, size_t index, BatchResults &results ) const;
+
 	private:
 
+		class BatchClosestPoint;
+		class BatchPointAtUV;
+		class BatchIntersectionPoint;
+
 		static void registerCreator( TypeId id, CreatorFn f );
 
 		typedef std::map< TypeId, CreatorFn > CreatorMap;
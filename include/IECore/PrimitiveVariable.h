@@ -37,6 +37,7 @@
 
 #include "IECore/Export.h"
 #include "IECore/Data.h"
+#include "IECore/VectorTypedData.h"
 
 namespace IECore
 {
@@ -67,6 +68,9 @@ struct IECORE_API PrimitiveVariable {
 	PrimitiveVariable();
 	/// Constructor - Data is not copied but referenced directly.
 	PrimitiveVariable( Interpolation i, DataPtr d );
+	/// Constructor for an indexed PrimitiveVariable - neither data
+	/// nor indices are copied but referenced directly.
+	PrimitiveVariable( Interpolation i, DataPtr d, IntVectorDataPtr indices );
 	/// Shallow copy constructor - data is not copied just rereferenced
 	PrimitiveVariable( const PrimitiveVariable &other );
 	/// Copy constructor which optionally allows a deep copy of data
@@ -80,9 +84,21 @@ struct IECORE_API PrimitiveVariable {
 	/// Variable data is expected to be one of the types defined in VectorTypedData.h.
 	/// Constant interpolated data can be represented by any type of Data.
 	DataPtr data;
+	/// Optional indices into data, allowing values to be shared between
+	/// elements. When present, there must be one index per element of the
+	/// Primitive (as specified by the interpolation), and data may be of
+	/// any length. When null, data must hold one value per element.
+	IntVectorDataPtr indices;
+	/// Returns data with the indices applied, so that there is one
+	/// value per element. When there are no indices, data is returned
+	/// directly rather than copied.
+	DataPtr expandedData() const;
 };
 
-/// A simple type to hold named PrimitiveVariables.
+/// A simple type to hold named PrimitiveVariables. Unlike CompoundDataMap,
+/// which is ordered by the addresses of its InternedString keys, this is
+/// keyed by std::string so that iteration is in a stable alphabetical order.
+/// Primitive::hash(), Primitive::save() and the renderers all rely on that.
 typedef std::map<std::string, PrimitiveVariable> PrimitiveVariableMap;
 
 } // namespace IECore
@@ -0,0 +1,63 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_PROCEDURALALGO_H
+#define IECORE_PROCEDURALALGO_H
+
+#include "IECore/Renderer.h"
+#include "IECore/Group.h"
+
+namespace IECore
+{
+
+namespace ProceduralAlgo
+{
+
+/// Expands a procedural into a Group, using a CapturingRenderer to evaluate
+/// any procedurals it emits in parallel. The procedural sees an identity
+/// transform and an empty attribute state. Python procedurals may only be
+/// expanded in parallel if the GIL has been released by the caller.
+IECORE_API GroupPtr expand( Renderer::ProceduralPtr procedural );
+
+/// Expands a procedural using expand(), and then renders the result into
+/// the renderer from the calling thread. This is intended for use by Renderer
+/// implementations which can't themselves defer procedurals or accept calls
+/// from multiple threads, and would otherwise have to expand them serially.
+IECORE_API void render( Renderer::ProceduralPtr procedural, Renderer *renderer );
+
+} // namespace ProceduralAlgo
+
+} // namespace IECore
+
+#endif // IECORE_PROCEDURALALGO_H
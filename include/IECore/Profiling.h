@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_PROFILING_H
+#define IECORE_PROFILING_H
+
+#include <iosfwd>
+#include <string>
+
+#include "boost/noncopyable.hpp"
+
+#include "tbb/tick_count.h"
+
+#include "IECore/Export.h"
+
+namespace IECore
+{
+
+/// Lightweight scoped profiling, intended to make it possible to see where
+/// time goes in a render without resorting to an external profiler. Zones
+/// are placed in code using the IECORE_PROFILE_ZONE macro, which compiles
+/// to nothing unless IECORE_WITH_PROFILING is defined (use the WITH_PROFILING
+/// build option). When compiled in, zones are only recorded while profiling is
+/// enabled, and otherwise cost a single check of a flag.
+namespace Profiling
+{
+
+/// Returns true if the library was built with IECORE_WITH_PROFILING, and
+/// therefore contains zones which may be recorded.
+IECORE_API bool available();
+
+/// Enables or disables the recording of zones. Disabled by default.
+IECORE_API void setEnabled( bool enabled );
+IECORE_API bool getEnabled();
+
+/// Discards all recorded zones. Must not be called while zones are being
+/// recorded on other threads.
+IECORE_API void clear();
+
+/// Writes all recorded zones in the Chrome trace event format, suitable
+/// for viewing with chrome://tracing. Must not be called while zones are
+/// being recorded on other threads.
+IECORE_API void writeChromeTrace( std::ostream &stream );
+IECORE_API void writeChromeTrace( const std::string &fileName );
+
+/// Records the time spent between construction and destruction, tagged
+/// with the calling thread. The name must remain valid for the lifetime
+/// of the program - typically it is a string literal or the value of an
+/// InternedString. Use the IECORE_PROFILE_ZONE macro rather than using
+/// this class directly.
+class IECORE_API Zone : boost::noncopyable
+{
+
+	public :
+
+		Zone( const char *name );
+		~Zone();
+
+	private :
+
+		const char *m_name;
+		bool m_enabled;
+		tbb::tick_count m_start;
+
+};
+
+} // namespace Profiling
+
+} // namespace IECore
+
+#define IECORE_PROFILE_CONCAT_WALK( A, B ) A##B
+#define IECORE_PROFILE_CONCAT( A, B ) IECORE_PROFILE_CONCAT_WALK( A, B )
+
+#ifdef IECORE_WITH_PROFILING
+#define IECORE_PROFILE_ZONE( NAME ) IECore::Profiling::Zone IECORE_PROFILE_CONCAT( iecoreProfileZone, __LINE__ )( NAME )
+#else
+#define IECORE_PROFILE_ZONE( NAME )
+#endif
+
+#endif // IECORE_PROFILING_H
@@ -47,7 +47,8 @@ namespace IECore
 
 /// A RadixSort implementation derived from Pierre Terdiman's OPCODE library, which has as "free for use in any commercial
 /// or non-commercial program" licence. The RadixSort class maintains state so that successive calls to it are able to exploit any coherence
-/// in the source data. Sorting is done in ascending order.
+/// in the source data. Sorting is done in ascending order, and is stable. Large inputs are sorted in parallel, with each
+/// pass scattering blocks of the input concurrently using offsets derived from shared histograms.
 /// \ingroup mathGroup
 class IECORE_API RadixSort
 {
@@ -56,6 +57,7 @@ class IECORE_API RadixSort
 		BOOST_STATIC_ASSERT( sizeof( int ) == 4 );
 		BOOST_STATIC_ASSERT( sizeof( unsigned int ) == 4 );
 		BOOST_STATIC_ASSERT( sizeof( float ) == 4 );
+		BOOST_STATIC_ASSERT( sizeof( double ) == 8 );
 
 		RadixSort();
 		virtual ~RadixSort();
@@ -75,22 +77,39 @@ class IECORE_API RadixSort
 		/// found in indices[3].
 		const std::vector<unsigned int> &operator()( const std::vector<int> &input );
 
+		/// As above, but for 64 bit keys.
+		const std::vector<unsigned int> &operator()( const std::vector<double> &input );
+		const std::vector<unsigned int> &operator()( const std::vector<uint64_t> &input );
+		const std::vector<unsigned int> &operator()( const std::vector<int64_t> &input );
+
+		/// Sorts keys in place, applying the same permutation to values. This is
+		/// suited to sorting primitive indices by Morton code. Throws an
+		/// InvalidArgumentException if keys and values differ in length. Subsequent
+		/// calls exploit coherence between the keys as they are left by one call and
+		/// the keys passed to the next.
+		void sortPairs( std::vector<unsigned int> &keys, std::vector<unsigned int> &values );
+		void sortPairs( std::vector<uint64_t> &keys, std::vector<unsigned int> &values );
+
 	private:
 
+		/// Fills m_ranks with the sorted order of the input.
+		template<typename T>
+		void sortIndices( const std::vector<T> &input );
+
 		template<typename T>
-		bool createHistograms( const std::vector<T> &input );
+		void sortPairsInternal( std::vector<T> &keys, std::vector<unsigned int> &values );
 
 		unsigned int m_currentSize;
 
-		unsigned int m_histogram[1024];
-		unsigned int *m_link[256];
+		/// Per-block histograms for every pass, laid out
+		/// as [block][pass][digit].
+		std::vector<unsigned int> m_blockHistograms;
+		/// Per-block write offsets for the current pass.
+		std::vector<unsigned int> m_blockOffsets;
 
 		UIntVectorDataPtr m_ranks;
 		UIntVectorDataPtr m_ranks2;
 
-		template<typename T>
-		bool checkPassValidity( const std::vector<T> &input, unsigned int j, unsigned int* &curCount, unsigned char &uniqueVal );
-
 		void resize( unsigned int s );
 		void checkResize( unsigned int s );
 };
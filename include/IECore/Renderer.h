@@ -325,7 +325,18 @@ class IECORE_API Renderer : public RunTimeTyped
 		virtual void nurbs( int uOrder, ConstFloatVectorDataPtr uKnot, float uMin, float uMax, int vOrder, ConstFloatVectorDataPtr vKnot, float vMin, float vMax, const PrimitiveVariableMap &primVars ) = 0;
 		/// Render a patch mesh.
 		virtual void patchMesh( const CubicBasisf &uBasis, const CubicBasisf &vBasis, int nu, bool uPeriodic, int nv, bool vPeriodic, const PrimitiveVariableMap &primVars ) = 0;
-		/// Generic call for specifying renderer specify geometry types.
+		/// Generic call for specifying renderer specify geometry types. The following
+		/// type is standard across Renderer implementations :
+		///
+		/// "instancer" : Places an instance of a prototype at each of a set of points,
+		/// in a single call rather than an instance() call per point. The prototypes are
+		/// instances previously described with instanceBegin() and instanceEnd(), and are
+		/// named by the StringVectorData "prototypes" topology. The points are given by the
+		/// V3fVectorData "P" primitive variable, and may also have "prototypeIndex" (IntVectorData),
+		/// "orientation" (QuatfVectorData) and "scale" (V3fVectorData or FloatVectorData)
+		/// primitive variables, or an "instanceTransform" (M44fVectorData) which overrides
+		/// all of "P", "orientation" and "scale". InstancerAlgo provides utilities for
+		/// implementing this.
 		virtual void geometry( const std::string &type, const CompoundDataMap &topology, const PrimitiveVariableMap &primVars ) = 0;
 		//@}
 
@@ -349,6 +360,13 @@ class IECORE_API Renderer : public RunTimeTyped
 				/// geometry. Any relevant methods of renderer may be called, but
 				/// the geometry generated must be contained within the
 				/// box returned by bound().
+				///
+				/// Renderers are free to expand procedurals in parallel, so render()
+				/// may be called concurrently for different procedurals, and for
+				/// the same procedural via different parents. Implementations must
+				/// therefore be thread-safe, and must only make calls on the renderer
+				/// they are passed. Python implementations are called with the GIL
+				/// held, and Renderer methods release it while they do their work.
 				virtual void render( Renderer *renderer ) const = 0;
 				/// Implement this to return a hash for procedural level instancing.
 				/// Procedurals with the same hash will be reused by renderers that
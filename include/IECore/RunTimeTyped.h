@@ -303,20 +303,11 @@ class IECORE_API RunTimeTyped : public RefCounted
 		};
 
 		typedef std::map< TypeId, TypeId > BaseTypeRegistryMap;
-		typedef std::map< TypeId, std::vector<TypeId> > BaseTypesRegistryMap;
 		typedef std::map< TypeId, std::set< TypeId > > DerivedTypesRegistryMap;
 		
-		typedef tbb::spin_rw_mutex Mutex;
-		
-		static Mutex g_baseTypeIdsMutex;
-		static Mutex g_derivedTypeIdsMutex;
-		
 		static BaseTypeRegistryMap &baseTypeRegistry();
 		static DerivedTypesRegistryMap &derivedTypesRegistry();
 
-		static BaseTypesRegistryMap &completeBaseTypesRegistry();
-		static DerivedTypesRegistryMap &completeDerivedTypesRegistry();
-
 		static void derivedTypeIdsWalk( TypeId typeId, std::set<TypeId> & );
 
 		typedef std::map<TypeId, std::string> TypeIdsToTypeNamesMap;
@@ -103,6 +103,14 @@ class IECORE_API SampledSceneInterface : public SceneInterface
 		virtual double attributeSampleInterval( const SceneInterface::Name &name, double time, size_t &floorIndex, size_t &ceilIndex ) const = 0;
 		/// Computes a sample interval suitable for use in producing interpolated objects
 		virtual double objectSampleInterval( double time, size_t &floorIndex, size_t &ceilIndex ) const = 0;
+
+		/// Fills times and transforms with the transform samples required to represent the
+		/// transform over the interval from startTime to endTime : all the samples within the
+		/// interval, plus the ones bracketing either end of it. This is convenient for motion
+		/// blur, where a shutter interval may span many samples of a densely sampled scene.
+		void readTransformSamples( double startTime, double endTime, std::vector<double> &times, std::vector<Imath::M44d> &transforms ) const;
+		/// As above, but for the object samples. The objects may be 0 if no object has been stored.
+		void readObjectSamples( double startTime, double endTime, std::vector<double> &times, std::vector<ConstObjectPtr> &objects ) const;
 };
 
 
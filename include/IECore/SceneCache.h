@@ -37,18 +37,30 @@
 
 #include "IECore/Export.h"
 #include "IECore/SampledSceneInterface.h"
+#include "IECore/ObjectPool.h"
 
 namespace IECore
 {
 
 IE_CORE_FORWARDDECLARE( SceneCache );
 
+/// \addtogroup environmentGroup
+///
+/// <b>IECORE_SCENECACHE_MEMORY</b><br>
+/// Used to specify the memory limit in megabytes for the samples cached by
+/// SceneCache readers. See SceneCache::cacheObjectPool() for more information.
+
 /// A simple means of saving and loading hierarchical descriptions of animated scene, with
 /// the ability to traverse the scene and perform partial loading on demand.
 /// When saving, it's important to keep the initial root SceneCache object alive until the very end.
 /// The destruction of the root scene will trigger the recursive computation of the bounding boxes for all the
 /// locations that no bounds were written. It will also store (without duplication) all the
 /// sample times used by objects, transforms, bounds and attributes.
+/// Locations may be written concurrently from multiple threads, provided that each
+/// location is only written by one thread at a time. Objects are serialised by
+/// background tasks, so writeObject() returns quickly. Any error saving them is
+/// thrown by the subsequent writes to the file and by close(), and is logged if
+/// the root scene is destroyed without being closed.
 /// \ingroup ioGroup
 class IECORE_API SceneCache : public SampledSceneInterface
 {
@@ -122,6 +134,9 @@ class IECORE_API SceneCache : public SampledSceneInterface
 		virtual ConstObjectPtr readObjectAtSample( size_t sampleIndex ) const;
 		virtual ConstObjectPtr readObject( double time ) const;
 		virtual PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const;
+		/// Reads just the requested range of uncompressed variables of the numeric vector types. Other
+		/// variables are read whole, and the range copied out of them.
+		virtual PrimitiveVariableMap readObjectPrimitiveVariableRange( const std::vector<InternedString> &primVarNames, double time, size_t begin, size_t end ) const;
 		virtual void writeObject( const Object *object, double time );
 
 		virtual bool hasChild( const Name &name ) const;
@@ -131,17 +146,74 @@ class IECORE_API SceneCache : public SampledSceneInterface
 		virtual SceneInterfacePtr createChild( const Name &name );
 		virtual SceneInterfacePtr scene( const Path &path, MissingBehaviour missingBehaviour = ThrowIfMissing );
 		virtual ConstSceneInterfacePtr scene( const Path &path, SceneInterface::MissingBehaviour missingBehaviour = ThrowIfMissing ) const;
+
+		/// Reads the locations in parallel.
+		virtual void readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const;
+		virtual void readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const;
+		virtual void readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const;
+		/// Loads the transform and object samples for the locations into the cache
+		/// using a background task, returning immediately.
+		virtual void prefetch( const std::vector<Path> &paths, double startTime, double endTime ) const;
+		/// Visits the locations using a single SceneCache for each level of the hierarchy,
+		/// rather than one for each location.
+		virtual void traverse( Visitor &visitor ) const;
 		
 		virtual void hash( HashType hashType, double time, MurmurHash &h ) const;
 
+		/// Fills paths with the locations at or below this one which have the given local tag.
+		/// The writer stores an index of the tagged locations at the root of the file, so this
+		/// is answered without traversing the hierarchy. Files written without the index are
+		/// traversed instead, skipping the branches which don't have the tag.
+		void taggedLocations( const Name &tag, std::vector<Path> &paths ) const;
+		/// Fills paths with the locations at or below this one whose bound intersects the
+		/// given one, which is in the space of the root of the file. The bound used for each
+		/// location contains it at every sample time, so this is suitable for culling animated
+		/// scenes, and like taggedLocations() it is answered from the index when available.
+		void locationsIntersecting( const Imath::Box3d &bound, std::vector<Path> &paths ) const;
+
 		/// tells you if this scene cache is read only or writable:
 		bool readOnly() const;
+
+		/// Enables lossy compression of the Primitives written to the file, using
+		/// the encodings described in PrimitiveCompression.h. The setting applies
+		/// to all locations in the file, and should be made before any objects are
+		/// written. Compressed objects are decoded transparently when read, so
+		/// readers need no special treatment. Off by default.
+		void setGeometryCompression( bool enabled );
+		bool getGeometryCompression() const;
+
+		/// Finishes writing the file, as the destruction of the root scene would,
+		/// but throws if any errors occurred rather than just logging them. No
+		/// further changes can be made afterwards. May only be called on the root
+		/// scene.
+		void close();
 		
 		// The attribute names used to mark animated topology and primitive variables
 		// when SceneCache objects are Primitives.
 		static const Name &animatedObjectTopologyAttribute;
 		static const Name &animatedObjectPrimVarsAttribute;
 
+		/// Returns the ObjectPool holding the transforms, attributes and objects
+		/// loaded by all the SceneCache readers in the process. Readers of the same
+		/// file share the cached samples, and the memory limit of this pool is the
+		/// single budget for all of them. It's initially specified in megabytes by
+		/// the IECORE_SCENECACHE_MEMORY environment variable, defaulting to 500.
+		static ObjectPool *cacheObjectPool();
+
+		struct CacheStatistics
+		{
+			/// Number of sample reads satisfied from the cache.
+			size_t hits;
+			/// Number of sample reads which had to be loaded from file.
+			size_t misses;
+			/// Memory used by the cached samples, in bytes.
+			size_t memoryUsage;
+		};
+
+		static CacheStatistics cacheStatistics();
+		/// Removes all the cached samples and resets the statistics.
+		static void clearCache();
+
 	protected:
 	
 		IE_CORE_FORWARDDECLARE( Implementation );
@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_SCENECACHEALGO_H
+#define IECORE_SCENECACHEALGO_H
+
+#include <vector>
+
+#include "IECore/Export.h"
+#include "IECore/CompoundData.h"
+
+namespace IECore
+{
+
+/// Functions for diagnosing the performance of SceneCache files. These are
+/// also available from the command line via the SceneCacheInspectOp.
+namespace SceneCacheAlgo
+{
+
+/// Returns statistics describing how a SceneCache file is stored. The members are :
+///
+/// - "file" : the "version", "fileSize", "indexSize", "numStrings" and "stringTableSize"
+///   of the file, as described by StreamIndexedIO::FileStorage.
+/// - "totals" : the combined statistics of all locations, along with the number of
+///   "locations", the "maxDepth" of the hierarchy, and the "uniqueStoredSize", which
+///   counts data shared by several entries only once. The global "header" and
+///   "sampleTimes" entries of the file are also included here.
+/// - "locations" : the statistics of each location, keyed by path. Only present when
+///   perLocation is true.
+///
+/// The statistics for a location hold a member for each of "bound", "transform", "object"
+/// and "attribute:<name>", and one for each of the other entries of the location, such
+/// as its tags. Each has the number of "samples" (zero for entries which aren't sampled),
+/// the number of file "entries", their "storedSize" in bytes and their "dataSize", which
+/// is larger than the storedSize when the data is compressed. The "storedSize" and
+/// "dataSize" of the location as a whole are also included. Objects which are shared
+/// between locations are counted at the first location to store them, and the others
+/// only account for the small reference they hold.
+IECORE_API CompoundDataPtr storageStatistics( const std::string &fileName, bool perLocation = true );
+
+/// Replays a complete traversal of the scene at the given time, once for each of the thread
+/// counts, measuring the latency of each call made. A thread count of zero or less uses the
+/// default number of threads. The objects cached by SceneCache are
+/// discarded before each traversal, but the file itself is likely to be cached by the
+/// operating system after the first. The result holds a member for each thread count, keyed
+/// by the count, with the "threads" used, the "wallTime" taken by the traversal and the
+/// statistics for each of "child", "readBound", "readTransformAsMatrix", "readAttribute"
+/// and "readObject". These hold the number of "calls", and the "totalTime", "meanTime",
+/// "medianTime", "p95Time" and "maxTime" of the calls, all in seconds.
+IECORE_API CompoundDataPtr readStatistics( const std::string &fileName, double time, const std::vector<int> &threadCounts );
+
+} // namespace SceneCacheAlgo
+
+} // namespace IECore
+
+#endif // IECORE_SCENECACHEALGO_H
@@ -212,6 +212,12 @@ class IECORE_API SceneInterface : public RunTimeTyped
 		/// Reads primitive variables from the object of type Primitive stored at this path in the scene at the given time. 
 		/// Raises exception if it turns out not to be a Primitive object.
 		virtual PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const = 0;
+		/// As readObjectPrimitiveVariables(), but returns only the elements in the range [begin, end)
+		/// of Vertex, Varying and FaceVarying variables, clamped to the size of each variable. The
+		/// range applies to the indices of indexed variables, whose data is returned whole, as are
+		/// Constant and Uniform variables. The base class implementation reads the whole variables
+		/// and copies out the range, but derived classes may read just the part required.
+		virtual PrimitiveVariableMap readObjectPrimitiveVariableRange( const std::vector<InternedString> &primVarNames, double time, size_t begin, size_t end ) const;
 		/// Writes a geometry to this path in the scene.
 		/// Raises an exception if you try to write an object in the root path.
 		virtual void writeObject( const Object *object, double time ) = 0;
@@ -243,6 +249,51 @@ class IECORE_API SceneInterface : public RunTimeTyped
 		/// Returns a const interface for querying the scene at the given path (full path). 
 		virtual ConstSceneInterfacePtr scene( const Path &path, MissingBehaviour missingBehaviour = ThrowIfMissing ) const = 0;
 
+		/*
+		 * Batch reading
+		 */
+
+		/// Reads the bounds of several locations at once, given as full paths, filling bounds with
+		/// one entry per path. Raises an exception if any of the locations does not exist. The base
+		/// class implementation simply visits each location in turn using scene(), but derived classes
+		/// which support concurrent reads may override it to read the locations in parallel.
+		virtual void readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const;
+		/// As readBounds(), but for the local transforms of the locations.
+		virtual void readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const;
+		/// As readBounds(), but for the objects of the locations. Entries are left null for locations
+		/// which have no object.
+		virtual void readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const;
+		/// Hints that the given locations are about to be read at times within the range from
+		/// startTime to endTime, for instance when scrubbing or rendering motion blur. Implementations
+		/// may use this to start loading the bracketing time samples in the background, but must
+		/// return without waiting for them. Missing locations are ignored. The base class implementation
+		/// does nothing.
+		virtual void prefetch( const std::vector<Path> &paths, double startTime, double endTime ) const;
+
+		/*
+		 * Traversal
+		 */
+
+		/// Interface for visiting the locations of a scene with traverse().
+		class IECORE_API Visitor
+		{
+			public :
+
+				virtual ~Visitor();
+
+				/// Called for each location in turn, with the full path to the location. The
+				/// scene and path are reused for other locations once the call returns, so
+				/// they must not be retained - use scene() to get a persistent interface if
+				/// one is needed. Returns true to visit the children of the location.
+				virtual bool visit( const SceneInterface *scene, const Path &path ) = 0;
+		};
+
+		/// Visits this location and all the locations below it in depth-first order. The
+		/// base class implementation uses child(), but reuses the same path and child name
+		/// lists throughout. Derived classes may override it to also avoid creating a new
+		/// SceneInterface for every location.
+		virtual void traverse( Visitor &visitor ) const;
+
 		/*
 		 * Hash
 		 */
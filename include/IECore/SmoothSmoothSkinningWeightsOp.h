@@ -35,8 +35,6 @@
 #ifndef IECORE_SMOOTHSMOOTHSKINNINGWEIGHTSOP_H
 #define IECORE_SMOOTHSMOOTHSKINNINGWEIGHTSOP_H
 
-#include "boost/graph/adjacency_list.hpp"
-
 #include "IECore/Export.h"
 #include "IECore/ModifyOp.h"
 #include "IECore/FrameListParameter.h"
@@ -70,12 +68,6 @@ class IECORE_API SmoothSmoothSkinningWeightsOp : public ModifyOp
 	
 	private :
 		
-		typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS > Graph;
-		typedef boost::property_map<Graph, boost::vertex_index_t>::type VertexIdMap;
-		typedef Graph::vertex_descriptor Vertex;
-		typedef Graph::adjacency_iterator NeighbourIterator;
-		typedef std::pair<NeighbourIterator, NeighbourIterator> NeighbourIteratorRange;
-		
 		MeshPrimitiveParameterPtr m_meshParameter;
 		FrameListParameterPtr m_vertexIdsParameter;
 		FloatParameterPtr m_smoothingRatioParameter;
@@ -59,8 +59,83 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 
 		IE_CORE_DECLARERUNTIMETYPED( StreamIndexedIO, IndexedIO );
 
+		/// Codecs available for compressing the index and subindex blocks
+		/// of a file. Files can always be read regardless of the codec they
+		/// were written with, provided Cortex was built with support for it.
+		enum Compression
+		{
+			Gzip = 0,
+			LZ4,
+			Zstd
+		};
+
 		virtual ~StreamIndexedIO();
 
+		/// Sets the codec used when writing the index and subindices of this file.
+		/// Files written with a codec other than Gzip can't be read by versions of
+		/// Cortex predating it. Throws if the codec is not available in this build,
+		/// or if subindices have already been written in the older format.
+		void setCompression( Compression compression );
+		Compression getCompression() const;
+
+		/// The codec used by files subsequently opened for writing. The initial
+		/// value is taken from the IECORE_INDEXEDIO_COMPRESSION environment variable,
+		/// which may be "gzip", "lz4" or "zstd", and defaults to Gzip.
+		static void setDefaultCompression( Compression compression );
+		static Compression getDefaultCompression();
+		/// Returns true if Cortex was built with support for the given codec.
+		static bool compressionAvailable( Compression compression );
+
+		/// Enables compression of the data entries subsequently written to this file. Entries
+		/// smaller than minSize bytes, and entries which don't get any smaller, are stored
+		/// uncompressed. When shuffle is true the bytes of numeric elements are regrouped by
+		/// significance before compression, which makes floating point data far more compressible.
+		/// Data compression is off by default, and files using it can't be read by versions of
+		/// Cortex predating it. Throws if the codec is not available in this build, or if
+		/// subindices have already been written in the older format.
+		void setDataCompression( bool enabled, Compression compression = Gzip, bool shuffle = true, size_t minSize = 1024 );
+		bool getDataCompression() const;
+
+		/// Returns the number of bytes of memory used by the parts of the index which are
+		/// currently resident. When the file was opened with IndexedIO::LazyIndex this grows
+		/// as directories are accessed, and includes the data retained for loading them.
+		size_t indexMemoryUsage() const;
+
+		/// Describes the storage of a File entry, for use by tools which diagnose
+		/// the layout of files.
+		struct EntryStorage
+		{
+			/// The position of the data in the file. Identical data written to several
+			/// entries is only stored once, so several entries may share an offset.
+			size_t offset;
+			/// The number of bytes occupied by the data in the file.
+			size_t storedSize;
+			/// The number of bytes of data, which is larger than storedSize when the
+			/// data is compressed.
+			size_t dataSize;
+			bool compressed;
+		};
+
+		/// Returns the storage of the named File entry, throwing if it doesn't exist.
+		EntryStorage entryStorage( const IndexedIO::EntryID &name ) const;
+
+		/// Describes the file as a whole. The version, fileSize and indexSize are
+		/// those of the file when it was opened, and are zero for new files.
+		struct FileStorage
+		{
+			/// The version of the file format.
+			int version;
+			size_t fileSize;
+			/// The number of bytes occupied by the main index, which includes
+			/// the string table but not any subindices.
+			size_t indexSize;
+			size_t numStrings;
+			/// The combined length of the strings in the string table.
+			size_t stringTableSize;
+		};
+
+		FileStorage fileStorage() const;
+
 		virtual IndexedIO::OpenMode openMode() const;
 
 		void path( IndexedIO::EntryIDList &result ) const;
@@ -147,6 +222,23 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 		void read(const IndexedIO::EntryID &name, short &x) const;
 		void read(const IndexedIO::EntryID &name, unsigned short &x) const;
 
+		/// Writes all the arrays to a single contiguous region of the file, unless data
+		/// compression is enabled.
+		void writeArrays( const IndexedIO::ArrayList &arrays );
+		/// Locks the directory once for all the arrays, and reads uncompressed entries
+		/// which are stored close together in the file with a single read.
+		void readArrays( const IndexedIO::ArrayList &arrays ) const;
+		/// Reads only the requested part of uncompressed entries. Compressed entries must
+		/// still be decompressed in their entirety.
+		void readArrayRange( const IndexedIO::Array &array, unsigned long begin ) const;
+
+		/// Returns a pointer to the raw bytes stored for the named File entry without copying them,
+		/// or 0 if the file was not opened with IndexedIO::MemoryMapped or the entry was written
+		/// with data compression enabled. The bytes are stored in little endian order and are not
+		/// guaranteed to be aligned. They remain valid for as long as any IndexedIO referring to
+		/// the same file exists.
+		const char *mappedData( const IndexedIO::EntryID &name, size_t &size ) const;
+
 	protected:
 
 		class Index;
@@ -167,6 +259,12 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 				void seekp( size_t pos, std::ios_base::seekdir dir );
 				void read( char *buffer, size_t size );
 				void write( const char *buffer, size_t size );
+
+				/// Reads size bytes starting at pos, without disturbing the stream position.
+				/// This may be called concurrently from multiple threads. The default
+				/// implementation locks mutex() around a seek and read, but derived classes
+				/// may override it so that readers never share a file cursor.
+				virtual void readAt( char *buffer, size_t size, Imf::Int64 pos );
 				Imf::Int64 tellg();
 				Imf::Int64 tellp();
 
@@ -185,6 +283,11 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 
 				static bool canRead( std::iostream &stream );
 
+				/// Returns a pointer to size bytes starting at pos when the file has been
+				/// mapped into memory, or 0 otherwise. Mapped data can be accessed
+				/// concurrently without acquiring mutex().
+				const char *mappedData( Imf::Int64 pos, size_t size ) const;
+
 			protected:
 
 				StreamFile( IndexedIO::OpenMode mode );
@@ -192,10 +295,17 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 				// This function allocates and if in read-mode also reads the Index of the file.
 				void setStream( std::iostream *stream, bool emptyFile );
 
+				/// May be called by derived classes which have mapped the whole file into memory.
+				/// The memory must remain valid for the lifetime of the StreamFile.
+				void setMappedData( const char *data, size_t size );
+
 				IndexedIO::OpenMode m_openmode;
 				std::iostream *m_stream;
 				Mutex m_mutex;
 
+				const char *m_mappedData;
+				size_t m_mappedSize;
+
 				unsigned long m_ioBufferLen;
 				char *m_ioBuffer;
 		};
@@ -52,13 +52,21 @@ class IECORE_API SummedAreaOp : public ChannelOp
 
 		IE_CORE_DECLARERUNTIMETYPED( SummedAreaOp, ChannelOp );
 
+		/// Computes a summed area table for a channel spanning the dataWindow, using double precision
+		/// accumulation so that large images don't lose precision. The table is padded with an extra
+		/// row and column of zeroes at the start, so the sum over any region can be computed from four
+		/// entries without special cases at the edges. The entry at table[y * ( width + 1 ) + x] is the
+		/// sum of all the pixels in the first y rows and x columns.
+		static void summedAreaTable( const Imath::Box2i &dataWindow, const float *channel, std::vector<double> &table );
+
 	protected :
 
 		virtual void modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels );
 
 	private :
 
-		struct SumArea;
+		class SumRows;
+		class SumColumns;
 
 };
 
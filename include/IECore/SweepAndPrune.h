@@ -38,12 +38,26 @@
 #include <vector>
 
 #include "boost/static_assert.hpp"
+#include "boost/mpl/if.hpp"
+#include "boost/type_traits/is_same.hpp"
 
 #include "IECore/RadixSort.h"
+#include "IECore/BoxTraits.h"
+#include "IECore/VectorTraits.h"
 
 namespace IECore
 {
 
+/// Finds all pairs of intersecting bounds, by sorting them along one axis and
+/// sweeping along it to find overlapping candidates, which are then tested on
+/// the remaining axes. The sweep is performed in parallel, with intersecting
+/// pairs buffered per task and then passed to the callback serially on the
+/// calling thread, so callbacks need not be threadsafe.
+///
+/// When incremental mode is on, the order from the previous call is reused as the
+/// starting point for sorting the next, which is much quicker for frame-to-frame
+/// coherent bounds. This requires that the same bounds are passed in the same
+/// positions each time.
 /// \ingroup mathGroup
 template<typename BoundIterator, template<typename> class CB>
 class SweepAndPrune
@@ -51,6 +65,11 @@ class SweepAndPrune
 	public:
 		typedef BoundIterator Iterator;
 		typedef typename std::iterator_traits<BoundIterator>::value_type Bound;
+		typedef typename BoxTraits<Bound>::BaseType Vec;
+		typedef typename VectorTraits<Vec>::BaseType BaseType;
+		/// The type used to sort the bounds. This is one which RadixSort supports,
+		/// and which can represent all values of BaseType exactly.
+		typedef typename boost::mpl::if_<boost::is_same<BaseType, float>, float, double>::type SortType;
 
 		typedef CB<BoundIterator> Callback;
 
@@ -61,7 +80,10 @@ class SweepAndPrune
 			YXZ,
 			YZX,
 			ZXY,
-			ZYX
+			ZYX,
+			/// Sweeps along the axis with the greatest spread of bound centres,
+			/// which generally yields the fewest candidate pairs.
+			Automatic
 		} AxisOrder;
 
 		SweepAndPrune();
@@ -69,11 +91,31 @@ class SweepAndPrune
 
 		void intersectingBounds( BoundIterator first, BoundIterator last, Callback &cb, AxisOrder axisOrder = XZY );
 
+		void setIncremental( bool incremental );
+		bool getIncremental() const;
+
 	protected:
 
 		inline bool axisIntersects( const Bound &b1, const Bound &b2, char axis );
 
 		RadixSort m_radixSort;
+
+	private :
+
+		class Sweep;
+
+		typedef std::pair<unsigned int, unsigned int> Pair;
+		typedef std::vector<Pair> PairVector;
+
+		void automaticAxes( const std::vector<BoundIterator> &bounds, char axes[3] ) const;
+		void sort( const std::vector<SortType> &mins );
+
+		bool m_incremental;
+		char m_sweepAxis;
+		/// Indices of the bounds, sorted by their minimum
+		/// on the sweep axis.
+		std::vector<unsigned int> m_order;
+
 };
 
 } // namespace IECore
@@ -36,20 +36,98 @@
 #define IE_CORE_SWEEPANDPRUNE_INL
 
 #include <cassert>
-#include <set>
 #include <algorithm>
+#include <limits>
 #include <limits.h>
 
 #include "boost/static_assert.hpp"
 
-#include "IECore/BoxTraits.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/VectorOps.h"
 
 namespace IECore
 {
 
+namespace Detail
+{
+
+// The number of sorted bounds swept before the buffered pairs are passed
+// to the callback, limiting the memory used by the buffers.
+static const size_t g_sweepAndPruneBatchSize = 65536;
+// The number of sorted bounds swept by each task within a batch.
+static const size_t g_sweepAndPruneChunkSize = 1024;
+
+} // namespace Detail
+
+// Sweeps a range of chunks of the sorted bounds, storing the
+// intersecting pairs found by each chunk in a separate buffer.
+template<typename BoundIterator, template<typename> class CB>
+class SweepAndPrune<BoundIterator, CB>::Sweep
+{
+	public :
+
+		Sweep( const std::vector<Bound> &sortedBounds, const char *axes, size_t batchBegin, size_t batchEnd, std::vector<PairVector> &chunkPairs )
+			:	m_sortedBounds( sortedBounds ), m_axes( axes ), m_batchBegin( batchBegin ), m_batchEnd( batchEnd ), m_chunkPairs( chunkPairs )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			const size_t numBounds = m_sortedBounds.size();
+			const unsigned int axis0 = m_axes[0];
+			const unsigned int axis1 = m_axes[1];
+			const unsigned int axis2 = m_axes[2];
+
+			for( size_t c = range.begin(); c != range.end(); ++c )
+			{
+				PairVector &pairs = m_chunkPairs[c];
+				pairs.clear();
+
+				const size_t begin = m_batchBegin + c * Detail::g_sweepAndPruneChunkSize;
+				const size_t end = std::min( begin + Detail::g_sweepAndPruneChunkSize, m_batchEnd );
+				for( size_t i = begin; i < end; ++i )
+				{
+					const Vec min0 = BoxTraits<Bound>::min( m_sortedBounds[i] );
+					const Vec max0 = BoxTraits<Bound>::max( m_sortedBounds[i] );
+					const BaseType sweepMax = vecGet( max0, axis0 );
+					for( size_t j = i + 1; j < numBounds; ++j )
+					{
+						const Vec min1 = BoxTraits<Bound>::min( m_sortedBounds[j] );
+						if( vecGet( min1, axis0 ) > sweepMax )
+						{
+							// All further bounds start after this one ends.
+							break;
+						}
+
+						const Vec max1 = BoxTraits<Bound>::max( m_sortedBounds[j] );
+						if(
+							vecGet( max0, axis1 ) >= vecGet( min1, axis1 ) && vecGet( min0, axis1 ) <= vecGet( max1, axis1 ) &&
+							vecGet( max0, axis2 ) >= vecGet( min1, axis2 ) && vecGet( min0, axis2 ) <= vecGet( max1, axis2 )
+						)
+						{
+							assert( m_sortedBounds[i].intersects( m_sortedBounds[j] ) );
+							pairs.push_back( Pair( i, j ) );
+						}
+					}
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<Bound> &m_sortedBounds;
+		const char *m_axes;
+		size_t m_batchBegin;
+		size_t m_batchEnd;
+		std::vector<PairVector> &m_chunkPairs;
+
+};
+
 template<typename BoundIterator, template<typename> class CB>
 SweepAndPrune<BoundIterator, CB>::SweepAndPrune( )
+	:	m_incremental( false ), m_sweepAxis( -1 )
 {
 }
 
@@ -58,6 +136,18 @@ SweepAndPrune<BoundIterator, CB>::~SweepAndPrune( )
 {
 }
 
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::setIncremental( bool incremental )
+{
+	m_incremental = incremental;
+}
+
+template<typename BoundIterator, template<typename> class CB>
+bool SweepAndPrune<BoundIterator, CB>::getIncremental() const
+{
+	return m_incremental;
+}
+
 template<typename BoundIterator, template<typename> class CB>
 bool SweepAndPrune<BoundIterator, CB>::axisIntersects( const Bound &b0, const Bound &b1, char axis )
 {
@@ -84,6 +174,13 @@ void SweepAndPrune<BoundIterator, CB>::intersectingBounds( BoundIterator first,
 		return;
 	}
 
+	std::vector<BoundIterator> bounds;
+	bounds.reserve( numBounds );
+	for ( BoundIterator it = first; it != last; ++it )
+	{
+		bounds.push_back( it );
+	}
+
 	char axes[3] = { 0, 1, 2 };
 
 	switch (axisOrder)
@@ -100,76 +197,133 @@ void SweepAndPrune<BoundIterator, CB>::intersectingBounds( BoundIterator first,
 			axes[0] = 2; axes[1] = 0; axes[2] = 1; break;
 		case ZYX :
 			axes[0] = 2; axes[1] = 1; axes[2] = 0; break;
+		case Automatic :
+			automaticAxes( bounds, axes ); break;
 		default:
 			assert( false );
 	}
 
 	assert( axes[0] + axes[1] + axes[2] == 3 );
 
-	typedef std::pair< bool, BoundIterator> IntervalId;
-
-	std::vector<IntervalId> intervalIds;
-	std::vector<float> boundExtents;
-	boundExtents.reserve( numBounds * 2 );
-	intervalIds.reserve( numBounds * 2 );
+	// Sort the bounds by their minimum on the sweep axis.
 
-	for ( BoundIterator it = first; it != last; ++it )
+	std::vector<SortType> mins( numBounds );
+	for ( unsigned long i = 0; i < numBounds; ++i )
 	{
-		boundExtents.push_back( vecGet( BoxTraits<Bound>::min(*it), axes[0] ) );
-		intervalIds.push_back( IntervalId( true, it  ) );
+		mins[i] = vecGet( BoxTraits<Bound>::min( *bounds[i] ), axes[0] );
+	}
 
-		boundExtents.push_back( vecGet( BoxTraits<Bound>::max(*it), axes[0] ) );
-		intervalIds.push_back( IntervalId( false, it ) );
+	if ( axes[0] != m_sweepAxis )
+	{
+		m_order.clear();
+		m_sweepAxis = axes[0];
 	}
+	sort( mins );
 
-	assert( boundExtents.size() == intervalIds.size() );
+	// Make a sorted copy of the bounds, so that the sweep
+	// reads them sequentially.
 
-	const std::vector<unsigned int> &sortedIndices = m_radixSort( boundExtents );
+	std::vector<Bound> sortedBounds( numBounds );
+	for ( unsigned long i = 0; i < numBounds; ++i )
+	{
+		sortedBounds[i] = *bounds[ m_order[i] ];
+	}
 
-	typedef std::vector<BoundIterator> ActiveSet;
-	ActiveSet activeSet;
+	// Sweep in parallel, one batch of bounds at a time, passing the pairs
+	// from each batch to the callback in the same order they would be found
+	// in serially. Pairs are ordered with the bound which appears later in
+	// the sweep first.
 
-	for ( std::vector<unsigned int>::const_iterator st = sortedIndices.begin(); st != sortedIndices.end(); ++st )
+	std::vector<PairVector> chunkPairs( Detail::g_sweepAndPruneBatchSize / Detail::g_sweepAndPruneChunkSize );
+	for ( size_t batchBegin = 0; batchBegin < numBounds; batchBegin += Detail::g_sweepAndPruneBatchSize )
 	{
-		const IntervalId &id = intervalIds[ *st ];
+		const size_t batchEnd = std::min( batchBegin + Detail::g_sweepAndPruneBatchSize, size_t( numBounds ) );
+		const size_t numChunks = ( batchEnd - batchBegin + Detail::g_sweepAndPruneChunkSize - 1 ) / Detail::g_sweepAndPruneChunkSize;
 
-		if ( id.first )
-		{
-			const Bound& bound0 = *id.second;
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, numChunks, 1 ), Sweep( sortedBounds, axes, batchBegin, batchEnd, chunkPairs ) );
 
-			for ( typename ActiveSet::const_iterator it = activeSet.begin(); it != activeSet.end(); it++ )
+		for ( size_t c = 0; c < numChunks; ++c )
+		{
+			const PairVector &pairs = chunkPairs[c];
+			for ( typename PairVector::const_iterator it = pairs.begin(); it != pairs.end(); ++it )
 			{
-				assert( id.second != *it );
+				cb( bounds[ m_order[it->second] ], bounds[ m_order[it->first] ] );
+			}
+		}
+	}
+}
 
-				if ( axisIntersects( bound0, **it, axes[1] ) )
-				{
-					if ( axisIntersects( bound0, **it, axes[2] ) )
-					{
-						assert( bound0.intersects( **it ) );
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::automaticAxes( const std::vector<BoundIterator> &bounds, char axes[3] ) const
+{
+	// Order the axes by the variance of the bound centres
+	// along them.
 
-						cb( id.second, *it );
-					}
-					else
-					{
-						assert( !bound0.intersects( **it ) );
-					}
-				}
-				else
-				{
-					assert( !bound0.intersects( **it ) );
-				}
+	double sum[3] = { 0, 0, 0 };
+	double sumSquared[3] = { 0, 0, 0 };
+	for ( typename std::vector<BoundIterator>::const_iterator it = bounds.begin(); it != bounds.end(); ++it )
+	{
+		for ( int a = 0; a < 3; ++a )
+		{
+			const double c = 0.5 * ( vecGet( BoxTraits<Bound>::min( **it ), a ) + vecGet( BoxTraits<Bound>::max( **it ), a ) );
+			sum[a] += c;
+			sumSquared[a] += c * c;
+		}
+	}
+
+	double variance[3];
+	for ( int a = 0; a < 3; ++a )
+	{
+		variance[a] = sumSquared[a] / bounds.size() - ( sum[a] * sum[a] ) / ( double( bounds.size() ) * bounds.size() );
+	}
+
+	axes[0] = 0; axes[1] = 1; axes[2] = 2;
+	for ( int i = 0; i < 2; ++i )
+	{
+		for ( int j = 2; j > i; --j )
+		{
+			if ( variance[ (int)axes[j] ] > variance[ (int)axes[j-1] ] )
+			{
+				std::swap( axes[j], axes[j-1] );
 			}
+		}
+	}
+}
 
-			activeSet.push_back( id.second );
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::sort( const std::vector<SortType> &mins )
+{
+	const size_t numBounds = mins.size();
+	if ( m_incremental && m_order.size() == numBounds )
+	{
+		// Insertion sort starting from the previous order, which is linear
+		// for coherent bounds. We give up and fall back to the radix sort if
+		// it looks like the bounds aren't coherent after all.
+		const size_t maxMoves = numBounds;
+		size_t numMoves = 0;
+		size_t i = 1;
+		for ( ; i < numBounds && numMoves <= maxMoves; ++i )
+		{
+			const unsigned int index = m_order[i];
+			const SortType min = mins[index];
+			size_t j = i;
+			while ( j > 0 && mins[ m_order[j-1] ] > min )
+			{
+				m_order[j] = m_order[j-1];
+				--j;
+			}
+			m_order[j] = index;
+			numMoves += i - j;
 		}
-		else
+
+		if ( i == numBounds )
 		{
-			assert( activeSet.size() );
-			typename ActiveSet::iterator it = std::find ( activeSet.begin(), activeSet.end(), id.second );
-			assert( it != activeSet.end() );
-			activeSet.erase( it );
+			return;
 		}
 	}
+
+	const std::vector<unsigned int> &order = m_radixSort( mins );
+	m_order.assign( order.begin(), order.end() );
 }
 
 } // namespace IECore
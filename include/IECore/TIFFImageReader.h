@@ -130,9 +130,12 @@ class IECORE_API TIFFImageReader : public ImageReader
 		bool m_haveDirectory;
 
 		std::vector<unsigned char> m_buffer;
+		// Flags the strips or tiles which have been decoded into m_buffer.
+		std::vector<bool> m_chunksRead;
 
-		// Reads the interlaced data from the current directory into the buffer
-		void readBuffer();
+		// Reads the interlaced data overlapping the region from the current directory
+		// into the buffer, decoding strips or tiles in parallel when worthwhile.
+		void readBuffer( const Imath::Box2i &region );
 
 		Imath::Box2i m_displayWindow;
 		Imath::Box2i m_dataWindow;
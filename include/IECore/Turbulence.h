@@ -94,6 +94,13 @@ class Turbulence
 		/// As above but performs antialiasing using frequency clamping.
 		Value turbulence( const Point &p, PointBaseType filterWidth ) const;
 
+		/// Computes the turbulence values for many points at once, resizing
+		/// values to match. The results are identical to calling turbulence()
+		/// for each point, but are computed in parallel.
+		void turbulence( const std::vector<Point> &points, std::vector<Value> &values ) const;
+		/// As above but performs antialiasing using frequency clamping.
+		void turbulence( const std::vector<Point> &points, PointBaseType filterWidth, std::vector<Value> &values ) const;
+
 	private :
 
 		// This calculates m_offset and m_scale so as to bring the
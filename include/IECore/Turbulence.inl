@@ -38,6 +38,35 @@
 namespace IECore
 {
 
+namespace Detail
+{
+
+// Adapts a Turbulence object for use with evaluateNoiseArray().
+template<typename T>
+class TurbulenceEvaluator
+{
+
+	public :
+
+		TurbulenceEvaluator( const T &turbulence, typename T::PointBaseType filterWidth )
+			:	m_turbulence( turbulence ), m_filterWidth( filterWidth )
+		{
+		}
+
+		typename T::Value operator()( const typename T::Point &p ) const
+		{
+			return m_turbulence.turbulence( p, m_filterWidth );
+		}
+
+	private :
+
+		const T &m_turbulence;
+		typename T::PointBaseType m_filterWidth;
+
+};
+
+} // namespace Detail
+
 template<typename N>
 Turbulence<N>::Turbulence( const unsigned int octaves, const Value &gain,
 	PointBaseType lacunarity, bool turbulent, const N &noise )
@@ -149,6 +178,18 @@ typename Turbulence<N>::Value Turbulence<N>::turbulence( const Point &p ) const
 }
 
 
+template<typename N>
+void Turbulence<N>::turbulence( const std::vector<Point> &points, std::vector<Value> &values ) const
+{
+	turbulence( points, 1.0e-6, values );
+}
+
+template<typename N>
+void Turbulence<N>::turbulence( const std::vector<Point> &points, PointBaseType filterWidth, std::vector<Value> &values ) const
+{
+	Detail::evaluateNoiseArray( Detail::TurbulenceEvaluator<Turbulence>( *this, filterWidth ), points, values );
+}
+
 template<typename N>
 typename Turbulence<N>::Value Turbulence<N>::turbulence( const Point &p, PointBaseType filterWidth ) const
 {
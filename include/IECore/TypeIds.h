@@ -439,6 +439,8 @@ enum TypeId
 	EXRDeepImageReaderTypeId = 391,
 	EXRDeepImageWriterTypeId = 392,
 	ExternalProceduralTypeId = 393,
+	ImageWriterDisplayDriverTypeId = 394,
+	BoxBlurOpTypeId = 395,
 
 	// Remember to update TypeIdBinding.cpp !!!
 
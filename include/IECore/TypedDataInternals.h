@@ -35,6 +35,9 @@
 #ifndef IECORE_TYPEDDATAINTERNALS_H
 #define IECORE_TYPEDDATAINTERNALS_H
 
+#include "tbb/atomic.h"
+#include "tbb/spin_mutex.h"
+
 #include "IECore/MurmurHash.h"
 
 namespace IECore
@@ -132,12 +135,21 @@ class SharedDataHolder
 		// lazily only after writable() has been called. Rather than modify this
 		// function, instead specialise the protected hash() method if the underlying
 		// datatype has special needs.
+		//
+		// \threading It is safe to call this concurrently from multiple
+		// threads, as permitted for readable(). The first caller computes
+		// the hash while holding a lock, and publishes it to the others via
+		// the atomic hashValid flag.
 		void hash( MurmurHash &h ) const
 		{
 			if( !m_data->hashValid )
 			{
-				m_data->hash = hash();
-				m_data->hashValid = true;
+				tbb::spin_mutex::scoped_lock lock( m_data->hashMutex );
+				if( !m_data->hashValid )
+				{
+					m_data->hash = hash();
+					m_data->hashValid = true;
+				}
 			}
 			h.append( m_data->hash );
 		}
@@ -157,12 +169,13 @@ class SharedDataHolder
 		{
 			public :
 			
-				Shareable() : data(), hashValid( false ) {}
-				Shareable( const T &initData ) : data( initData ), hashValid( false ) {}
+				Shareable() : data() { hashValid = false; }
+				Shareable( const T &initData ) : data( initData ) { hashValid = false; }
 				
 				T data;
 				MurmurHash hash;
-				volatile bool hashValid;
+				tbb::atomic<bool> hashValid;
+				tbb::spin_mutex hashMutex;
 				
 		};
 		
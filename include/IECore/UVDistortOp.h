@@ -35,6 +35,8 @@
 #ifndef IECORE_UVDISTORT_H
 #define IECORE_UVDISTORT_H
 
+#include <vector>
+
 #include "IECore/Export.h"
 #include "IECore/WarpOp.h"
 #include "ObjectParameter.h"
@@ -73,10 +75,11 @@ class IECORE_API UVDistortOp : public WarpOp
 		Imath::V2i m_imageOrigin;
 		Imath::V2i m_uvOrigin;
 		Imath::V2i m_uvSize;
-		ConstDataPtr m_u;
-		ConstDataPtr m_v;
+		// The uv map, converted to float up front so that the
+		// concurrent calls to warp() need not despatch on its type.
+		std::vector<Imath::V2f> m_uvs;
 
-		struct Lookup;
+		struct Copy;
 };
 
 IE_CORE_DECLAREPTR( UVDistortOp );
@@ -52,7 +52,7 @@ class IECORE_API WarpOp : public ImagePrimitiveOp
 {
 	public:
 
-		enum FilterType { None = 0, Bilinear = 1 };
+		enum FilterType { None = 0, Bilinear = 1, Bicubic = 2 };
 		enum BoundMode { Clamp = 0, SetToBlack = 1 };
 
 		WarpOp( const std::string &description );
@@ -76,8 +76,8 @@ class IECORE_API WarpOp : public ImagePrimitiveOp
 		/// This function is called after begin() method. The input Box2i corresponds to the input image data window.
 		/// The default implementation returns the same data window as the original image.
 		virtual Imath::Box2i warpedDataWindow( const Imath::Box2i &dataWindow ) const;
-		/// Called once per element (pixel for ImagePrimitives).
-		/// Must be implemented by subclasses to determine where the color will come from.
+		/// Called once per element (pixel for ImagePrimitives), regardless of the number of channels. Calls
+		/// may be made concurrently from multiple threads. Must be implemented by subclasses to determine where the color will come from.
 		/// The returned coordinate is on pixel space of the input image and the given V2f coordinates are on the
 		/// output image pixel space.
 		virtual Imath::V2f warp( const Imath::V2f &p ) const = 0;
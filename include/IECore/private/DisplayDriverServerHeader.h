@@ -35,6 +35,8 @@
 #ifndef IE_CORE_DISPLAYDRIVERSERVERHEADER
 #define IE_CORE_DISPLAYDRIVERSERVERHEADER
 
+#include <vector>
+
 #include "IECore/DisplayDriverServer.h"
 
 namespace IECore
@@ -46,6 +48,9 @@ namespace IECore
 * [1] - protocol version ( 1 )
 * [2] - message type ( imageOpen, imageData, imageClose )
 * [3-6] - length of following data block.
+*
+* Protocol version 3 added a third imageOpen reply from the server, holding the
+* DataEncoding it accepts for the imageData blocks, as a single byte.
 */
 class DisplayDriverServerHeader
 {
@@ -55,7 +60,26 @@ class DisplayDriverServerHeader
 
 		static const unsigned char headerLength = 7;
 		static const unsigned char magicNumber = 0x82;
-		static const unsigned char currentProtocolVersion = 2;
+		static const unsigned char currentProtocolVersion = 3;
+
+		// The encoding of the pixels in imageData blocks, which follow the Box2i. The client
+		// requests one in the "displayDataEncoding" parameter, and the server replies with
+		// the one it accepts, falling back to halfData if compression isn't available.
+		// - floatData : the floats as passed to DisplayDriver::imageData().
+		// - halfData : the floats converted to half, halving the size of the block.
+		// - halfLZ4Data : the number of values as a 4 byte integer, followed by the halfs
+		//   compressed with LZ4. The low and high bytes of all the halfs are grouped
+		//   before compression, as this greatly improves the ratio for image data.
+		enum DataEncoding { floatData = 0, halfData = 1, halfLZ4Data = 2 };
+
+		// returns true if the encoding can be used by this build.
+		static bool encodingAvailable( DataEncoding encoding );
+
+		// encodes the floats, appending them to result.
+		static void encodeData( DataEncoding encoding, const float *data, size_t dataSize, std::vector<char> &result );
+
+		// decodes an encoded block into result.
+		static void decodeData( DataEncoding encoding, const char *data, size_t size, std::vector<float> &result );
 
 		DisplayDriverServerHeader();
 		DisplayDriverServerHeader( MessageType msg, size_t dataSize );
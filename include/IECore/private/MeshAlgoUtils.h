@@ -0,0 +1,63 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_MESHALGOUTILS_H
+#define IECORE_MESHALGOUTILS_H
+
+#include <vector>
+
+namespace IECore
+{
+namespace Detail
+{
+
+/// Builds a compressed table of the faces adjacent to each element of a mesh,
+/// where the elements are referenced per face-vertex by indices. These might
+/// be the mesh's vertexIds, or the indices for an indexed facevarying primitive
+/// variable such as "stIndices". The faces adjacent to element i are then
+/// faces[offsets[i]] to faces[offsets[i+1]-1]. Faces are listed in ascending
+/// order, once for each time they reference the element, so accumulating over
+/// them gives identical results to a serial loop over the faces. All indices
+/// must be less than numElements. The table is built in parallel.
+void faceAdjacency( const std::vector<int> &verticesPerFace, const std::vector<int> &indices, size_t numElements, std::vector<unsigned int> &offsets, std::vector<unsigned int> &faces );
+
+/// Fills offsets with the index of the first face-vertex of each face. This is
+/// a serial prefix sum, but cheap in comparison to the per face work it enables
+/// to run in parallel.
+void faceOffsets( const std::vector<int> &verticesPerFace, std::vector<int> &offsets );
+
+} // namespace Detail
+} // namespace IECore
+
+#endif // IECORE_MESHALGOUTILS_H
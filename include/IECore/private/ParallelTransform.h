@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_PARALLELTRANSFORM_H
+#define IECORE_PARALLELTRANSFORM_H
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace IECore
+{
+
+namespace Detail
+{
+
+template<typename FromIterator, typename ToIterator, typename Conversion>
+class ParallelTransformTask
+{
+
+	public :
+
+		ParallelTransformTask( FromIterator from, ToIterator to, const Conversion &conversion )
+			:	m_from( from ), m_to( to ), m_conversion( conversion )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			// Plain indexed loops over each range, so the compiler is
+			// free to vectorise the simpler conversions.
+			const FromIterator from = m_from;
+			const ToIterator to = m_to;
+			for( size_t i = r.begin(), e = r.end(); i < e; ++i )
+			{
+				to[i] = m_conversion( from[i] );
+			}
+		}
+
+	private :
+
+		FromIterator m_from;
+		ToIterator m_to;
+		const Conversion &m_conversion;
+
+};
+
+/// Equivalent to std::transform( from, from + size, to, conversion ), but
+/// distributes large arrays across threads. The conversion must be safe to
+/// call concurrently, which is true of the stateless DataConversions.
+template<typename FromIterator, typename ToIterator, typename Conversion>
+void parallelTransform( FromIterator from, size_t size, ToIterator to, const Conversion &conversion )
+{
+	// Below this size the overhead of scheduling
+	// outweighs the work done in each task.
+	const size_t grainSize = 10000;
+
+	ParallelTransformTask<FromIterator, ToIterator, Conversion> task( from, to, conversion );
+	if( size <= grainSize )
+	{
+		task( tbb::blocked_range<size_t>( 0, size ) );
+	}
+	else
+	{
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, size, grainSize ), task );
+	}
+}
+
+} // namespace Detail
+
+} // namespace IECore
+
+#endif // IECORE_PARALLELTRANSFORM_H
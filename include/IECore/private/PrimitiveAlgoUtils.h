@@ -35,8 +35,27 @@
 #ifndef IECORE_PRIMITIVEALGOUTILS_H
 #define IECORE_PRIMITIVEALGOUTILS_H
 
+#include <vector>
+#include <set>
+
 #include "boost/mpl/and.hpp"
+#include "boost/format.hpp"
+
+#include "OpenEXR/ImathVec.h"
+#include "OpenEXR/ImathColor.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_scan.h"
+
 #include "IECore/TypeTraits.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/PrimitiveVariable.h"
+#include "IECore/Primitive.h"
+#include "IECore/VectorTypedData.h"
+#include "IECore/DataAlgo.h"
+#include "IECore/Exception.h"
+#include "IECore/MessageHandler.h"
 
 namespace IECore
 {
@@ -119,6 +138,767 @@ inline DataPtr createArrayData(PrimitiveVariable& primitiveVariable, const Primi
 	return NULL;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Element deletion
+//
+// The delete functions in PointsAlgo, CurvesAlgo and MeshAlgo first build
+// lists of the surviving element indices for each interpolation, and then
+// use them to compact all the primitive variables concurrently.
+//////////////////////////////////////////////////////////////////////////
+
+template<typename U>
+class SurvivingIndicesScan
+{
+
+	public :
+
+		SurvivingIndicesScan( const std::vector<U> &deleteFlags, std::vector<int> &indices )
+			:	m_deleteFlags( &deleteFlags ), m_indices( &indices ), m_count( 0 )
+		{
+		}
+
+		SurvivingIndicesScan( SurvivingIndicesScan &other, tbb::split )
+			:	m_deleteFlags( other.m_deleteFlags ), m_indices( other.m_indices ), m_count( 0 )
+		{
+		}
+
+		template<typename Tag>
+		void operator()( const tbb::blocked_range<size_t> &range, Tag )
+		{
+			const std::vector<U> &deleteFlags = *m_deleteFlags;
+			size_t count = m_count;
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				if( !deleteFlags[i] )
+				{
+					if( Tag::is_final_scan() )
+					{
+						(*m_indices)[count] = i;
+					}
+					++count;
+				}
+			}
+			m_count = count;
+		}
+
+		void reverse_join( SurvivingIndicesScan &other )
+		{
+			m_count += other.m_count;
+		}
+
+		void assign( SurvivingIndicesScan &other )
+		{
+			m_count = other.m_count;
+		}
+
+		size_t count() const
+		{
+			return m_count;
+		}
+
+	private :
+
+		const std::vector<U> *m_deleteFlags;
+		std::vector<int> *m_indices;
+		size_t m_count;
+
+};
+
+/// Fills indices with the indices of the elements whose delete flag
+/// is not set, in ascending order, using a parallel prefix scan.
+template<typename U>
+void survivingIndices( const std::vector<U> &deleteFlags, std::vector<int> &indices )
+{
+	indices.resize( deleteFlags.size() );
+	SurvivingIndicesScan<U> scan( deleteFlags, indices );
+	tbb::parallel_scan( tbb::blocked_range<size_t>( 0, deleteFlags.size() ), scan );
+	indices.resize( scan.count() );
+}
+
+// Computes offsets[i] = sum( sizes[elements[j]] ) for j < i, where no
+// elements means all of them. The total is appended as a final offset.
+class OffsetsScan
+{
+
+	public :
+
+		OffsetsScan( const std::vector<int> &sizes, const std::vector<int> *elements, std::vector<size_t> &offsets )
+			:	m_sizes( &sizes ), m_elements( elements ), m_offsets( &offsets ), m_sum( 0 )
+		{
+		}
+
+		OffsetsScan( OffsetsScan &other, tbb::split )
+			:	m_sizes( other.m_sizes ), m_elements( other.m_elements ), m_offsets( other.m_offsets ), m_sum( 0 )
+		{
+		}
+
+		template<typename Tag>
+		void operator()( const tbb::blocked_range<size_t> &range, Tag )
+		{
+			const std::vector<int> &sizes = *m_sizes;
+			size_t sum = m_sum;
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				if( Tag::is_final_scan() )
+				{
+					(*m_offsets)[i] = sum;
+				}
+				sum += sizes[m_elements ? (*m_elements)[i] : i];
+			}
+			m_sum = sum;
+		}
+
+		void reverse_join( OffsetsScan &other )
+		{
+			m_sum += other.m_sum;
+		}
+
+		void assign( OffsetsScan &other )
+		{
+			m_sum = other.m_sum;
+		}
+
+		size_t sum() const
+		{
+			return m_sum;
+		}
+
+	private :
+
+		const std::vector<int> *m_sizes;
+		const std::vector<int> *m_elements;
+		std::vector<size_t> *m_offsets;
+		size_t m_sum;
+
+};
+
+inline void offsets( const std::vector<int> &sizes, const std::vector<int> *elements, std::vector<size_t> &offsets )
+{
+	const size_t n = elements ? elements->size() : sizes.size();
+	offsets.resize( n + 1 );
+	OffsetsScan scan( sizes, elements, offsets );
+	tbb::parallel_scan( tbb::blocked_range<size_t>( 0, n ), scan );
+	offsets[n] = scan.sum();
+}
+
+class ExpandIndices
+{
+
+	public :
+
+		ExpandIndices( const std::vector<int> &elements, const std::vector<int> &sizes, const std::vector<size_t> &inputOffsets, const std::vector<size_t> &outputOffsets, std::vector<int> &indices )
+			:	m_elements( elements ), m_sizes( sizes ), m_inputOffsets( inputOffsets ), m_outputOffsets( outputOffsets ), m_indices( indices )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const int element = m_elements[i];
+				const int size = m_sizes[element];
+				const size_t inputOffset = m_inputOffsets[element];
+				int *out = &m_indices[0] + m_outputOffsets[i];
+				for( int j = 0; j < size; ++j )
+				{
+					*out++ = inputOffset + j;
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<int> &m_elements;
+		const std::vector<int> &m_sizes;
+		const std::vector<size_t> &m_inputOffsets;
+		const std::vector<size_t> &m_outputOffsets;
+		std::vector<int> &m_indices;
+
+};
+
+/// Given the surviving elements of a primitive, and the number of
+/// sub-elements (vertices, face-vertices etc) in every element, fills
+/// indices with the surviving sub-elements.
+inline void expandIndices( const std::vector<int> &elements, const std::vector<int> &sizes, std::vector<int> &indices )
+{
+	std::vector<size_t> inputOffsets;
+	offsets( sizes, 0, inputOffsets );
+	std::vector<size_t> outputOffsets;
+	offsets( sizes, &elements, outputOffsets );
+
+	indices.resize( outputOffsets.back() );
+	if( indices.empty() )
+	{
+		return;
+	}
+
+	ExpandIndices expander( elements, sizes, inputOffsets, outputOffsets, indices );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, elements.size() ), expander );
+}
+
+template<typename T>
+class Gather
+{
+
+	public :
+
+		Gather( const std::vector<T> &input, const std::vector<int> &indices, std::vector<T> &output )
+			:	m_input( input ), m_indices( indices ), m_output( output )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_output[i] = m_input[m_indices[i]];
+			}
+		}
+
+	private :
+
+		const std::vector<T> &m_input;
+		const std::vector<int> &m_indices;
+		std::vector<T> &m_output;
+
+};
+
+template<typename T>
+void gather( const std::vector<T> &input, const std::vector<int> &indices, std::vector<T> &output )
+{
+	output.resize( indices.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, indices.size() ), Gather<T>( input, indices, output ) );
+}
+
+// Elements of std::vector<bool> share storage, so can't be written concurrently.
+inline void gather( const std::vector<bool> &input, const std::vector<int> &indices, std::vector<bool> &output )
+{
+	output.resize( indices.size() );
+	for( size_t i = 0; i < indices.size(); ++i )
+	{
+		output[i] = input[indices[i]];
+	}
+}
+
+/// Returns a copy of vector data containing only the elements at the
+/// specified (ascending) indices.
+struct GatherFunctor
+{
+	typedef DataPtr ReturnType;
+
+	GatherFunctor( const std::vector<int> &indices )
+		:	m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		const typename T::ValueType &input = data->readable();
+		if( !m_indices.empty() && (size_t)m_indices.back() >= input.size() )
+		{
+			throw InvalidArgumentException( "Primitive variable has insufficient elements" );
+		}
+
+		typename T::Ptr result = new T();
+		gather( input, m_indices, result->writable() );
+		return result;
+	}
+
+	const std::vector<int> &m_indices;
+};
+
+class CompactPrimitiveVariables
+{
+
+	public :
+
+		CompactPrimitiveVariables( const std::vector<PrimitiveVariableMap::const_iterator> &inputs, const std::vector<int> * const *indices, std::vector<DataPtr> &outputs )
+			:	m_inputs( inputs ), m_indices( indices ), m_outputs( outputs )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const PrimitiveVariable &primitiveVariable = m_inputs[i]->second;
+				GatherFunctor gatherFunctor( *m_indices[primitiveVariable.interpolation] );
+				m_outputs[i] = despatchTypedData<GatherFunctor, TypeTraits::IsVectorTypedData>( const_cast<Data *>( primitiveVariable.data.get() ), gatherFunctor );
+			}
+		}
+
+	private :
+
+		const std::vector<PrimitiveVariableMap::const_iterator> &m_inputs;
+		const std::vector<int> * const *m_indices;
+		std::vector<DataPtr> &m_outputs;
+
+};
+
+/// Copies the primitive variables from input to output, keeping only the
+/// elements listed in the indices for the relevant interpolation, or the
+/// whole variable if the indices are null. Variables are compacted concurrently.
+inline void compactPrimitiveVariables(
+	const PrimitiveVariableMap &input, PrimitiveVariableMap &output,
+	const std::vector<int> *uniformIndices, const std::vector<int> *vertexIndices,
+	const std::vector<int> *varyingIndices, const std::vector<int> *faceVaryingIndices
+)
+{
+	const std::vector<int> *indices[] = { 0, 0, uniformIndices, vertexIndices, varyingIndices, faceVaryingIndices };
+
+	std::vector<PrimitiveVariableMap::const_iterator> toCompact;
+	for( PrimitiveVariableMap::const_iterator it = input.begin(), e = input.end(); it != e; ++it )
+	{
+		if( it->second.interpolation <= PrimitiveVariable::FaceVarying && indices[it->second.interpolation] )
+		{
+			toCompact.push_back( it );
+		}
+		else
+		{
+			output[it->first] = it->second;
+		}
+	}
+
+	std::vector<DataPtr> compacted( toCompact.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, toCompact.size(), 1 ), CompactPrimitiveVariables( toCompact, indices, compacted ) );
+
+	for( size_t i = 0; i < toCompact.size(); ++i )
+	{
+		output[toCompact[i]->first] = PrimitiveVariable( toCompact[i]->second.interpolation, compacted[i] );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Merging
+//
+// The merge functions in MeshAlgo and CurvesAlgo compute the offset of
+// every input up front, so that each output array is allocated once and
+// the inputs can be copied into place concurrently.
+//////////////////////////////////////////////////////////////////////////
+
+template<typename V>
+struct DefaultValue
+{
+	V operator()() const
+	{
+		return V();
+	}
+};
+
+template<>
+struct DefaultValue<half>
+{
+	half operator()() const
+	{
+		return half( 0.0f );
+	}
+};
+
+template<typename T>
+struct DefaultValue<Imath::Vec2<T> >
+{
+	Imath::Vec2<T> operator()() const
+	{
+		return Imath::Vec2<T>( 0 );
+	}
+};
+
+template<typename T>
+struct DefaultValue<Imath::Vec3<T> >
+{
+	Imath::Vec3<T> operator()() const
+	{
+		return Imath::Vec3<T>( 0 );
+	}
+};
+
+template<typename T>
+struct DefaultValue<Imath::Color3<T> >
+{
+	Imath::Color3<T> operator()() const
+	{
+		return Imath::Color3<T>( 0 );
+	}
+};
+
+template<typename T>
+struct DefaultValue<Imath::Color4<T> >
+{
+	Imath::Color4<T> operator()() const
+	{
+		return Imath::Color4<T>( 0 );
+	}
+};
+
+// Copies each of the source vectors into its own range of a merged vector,
+// filling the ranges of null sources with a default value.
+template<typename T>
+class VectorMerger
+{
+
+	public :
+
+		VectorMerger( const std::vector<const T *> &sources, const std::vector<size_t> &offsets, typename T::ValueType &result )
+			:	m_sources( sources ), m_offsets( offsets ), m_result( result )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			typedef typename T::ValueType::value_type ValueType;
+			typename T::ValueType &result = m_result;
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				if( m_sources[i] )
+				{
+					const typename T::ValueType &source = m_sources[i]->readable();
+					std::copy( source.begin(), source.end(), result.begin() + m_offsets[i] );
+				}
+				else
+				{
+					std::fill( result.begin() + m_offsets[i], result.begin() + m_offsets[i+1], DefaultValue<ValueType>()() );
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<const T *> &m_sources;
+		const std::vector<size_t> &m_offsets;
+		typename T::ValueType &m_result;
+
+};
+
+template<typename T>
+void mergeVectors( const std::vector<const T *> &sources, const std::vector<size_t> &offsets, typename T::ValueType &result )
+{
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, sources.size() ), VectorMerger<T>( sources, offsets, result ) );
+}
+
+// Elements of std::vector<bool> share storage, so can't be written concurrently.
+inline void mergeVectors( const std::vector<const BoolVectorData *> &sources, const std::vector<size_t> &offsets, std::vector<bool> &result )
+{
+	VectorMerger<BoolVectorData>( sources, offsets, result )( tbb::blocked_range<size_t>( 0, sources.size() ) );
+}
+
+/// Concatenates vector data of the same type. Null sources contribute
+/// the number of default values given in sizes.
+struct MergeVectors
+{
+	typedef DataPtr ReturnType;
+
+	MergeVectors( const std::vector<ConstDataPtr> &sources, const std::vector<size_t> &sizes )
+		:	m_sources( sources ), m_sizes( sizes )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		std::vector<const T *> sources;
+		std::vector<size_t> offsets;
+		size_t size = 0;
+		for( size_t i = 0; i < m_sources.size(); ++i )
+		{
+			const T *source = static_cast<const T *>( m_sources[i].get() );
+			sources.push_back( source );
+			offsets.push_back( size );
+			size += source ? source->readable().size() : m_sizes[i];
+		}
+		offsets.push_back( size );
+
+		typename T::Ptr result = new T;
+		setGeometricInterpretation( result.get(), getGeometricInterpretation( data ) );
+		typename T::ValueType &merged = result->writable();
+		merged.resize( size );
+		mergeVectors( sources, offsets, merged );
+		return result;
+	}
+
+	private :
+
+		const std::vector<ConstDataPtr> &m_sources;
+		const std::vector<size_t> &m_sizes;
+
+};
+
+// Concatenates index vectors, offsetting each by the position of its
+// values within the merged data.
+class IndicesMerger
+{
+
+	public :
+
+		IndicesMerger( const std::vector<const std::vector<int> *> &sources, const std::vector<size_t> &offsets, const std::vector<size_t> &dataOffsets, std::vector<int> &result )
+			:	m_sources( sources ), m_offsets( offsets ), m_dataOffsets( dataOffsets ), m_result( result )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const std::vector<int> &source = *m_sources[i];
+				const int dataOffset = m_dataOffsets[i];
+				std::vector<int>::iterator out = m_result.begin() + m_offsets[i];
+				for( std::vector<int>::const_iterator it = source.begin(), eIt = source.end(); it != eIt; ++it )
+				{
+					*out++ = *it + dataOffset;
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<const std::vector<int> *> &m_sources;
+		const std::vector<size_t> &m_offsets;
+		const std::vector<size_t> &m_dataOffsets;
+		std::vector<int> &m_result;
+
+};
+
+/// Concatenates the sources into result, adding dataOffsets[i] to every
+/// value from source i. This serves for topology (vertex ids offset by
+/// the vertices of the preceding inputs, or counts with zero offsets) as
+/// well as for the indices of indexed primitive variables.
+inline void mergeIndices( const std::vector<const std::vector<int> *> &sources, const std::vector<size_t> &dataOffsets, std::vector<int> &result )
+{
+	std::vector<size_t> offsets( sources.size() );
+	size_t size = 0;
+	for( size_t i = 0; i < sources.size(); ++i )
+	{
+		offsets[i] = size;
+		size += sources[i]->size();
+	}
+
+	result.resize( size );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, sources.size() ), IndicesMerger( sources, offsets, dataOffsets, result ) );
+}
+
+template<typename P>
+struct PrimitiveVariableMergeTraits
+{
+	typedef void (*Resampler)( const P *, PrimitiveVariable &, PrimitiveVariable::Interpolation );
+};
+
+// Merges a single primitive variable, as a task of its own.
+template<typename P>
+class PrimitiveVariableMerger
+{
+
+	public :
+
+		typedef typename PrimitiveVariableMergeTraits<P>::Resampler Resampler;
+
+		PrimitiveVariableMerger(
+			const std::vector<const P *> &primitives, Resampler resampler, const int *interpolationRanks,
+			const std::vector<std::vector<const PrimitiveVariable *> > &inputs, const std::vector<PrimitiveVariable::Interpolation> &interpolations,
+			std::vector<PrimitiveVariable> &results, std::vector<char> &mismatched
+		)
+			:	m_primitives( primitives ), m_resampler( resampler ), m_interpolationRanks( interpolationRanks ),
+				m_inputs( inputs ), m_interpolations( interpolations ), m_results( results ), m_mismatched( mismatched )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				merge( m_inputs[i], m_interpolations[i], m_results[i], m_mismatched[i] );
+			}
+		}
+
+	private :
+
+		void merge( const std::vector<const PrimitiveVariable *> &inputs, PrimitiveVariable::Interpolation interpolation, PrimitiveVariable &result, char &mismatched ) const
+		{
+			// bring every input to the output interpolation, resampling
+			// only those whose interpolation is genuinely different.
+
+			const size_t n = m_primitives.size();
+			std::vector<PrimitiveVariable> variables( n );
+			TypeId typeId = InvalidTypeId;
+			bool allIndexed = true;
+			for( size_t j = 0; j < n; ++j )
+			{
+				if( !inputs[j] )
+				{
+					allIndexed = false;
+					continue;
+				}
+
+				variables[j] = *inputs[j];
+				if( m_interpolationRanks[variables[j].interpolation] != m_interpolationRanks[interpolation] )
+				{
+					try
+					{
+						m_resampler( m_primitives[j], variables[j], interpolation );
+					}
+					catch( const std::exception & )
+					{
+						// the type doesn't support resampling
+						variables[j] = PrimitiveVariable();
+					}
+				}
+
+				if( !variables[j].data || m_interpolationRanks[variables[j].interpolation] != m_interpolationRanks[interpolation] )
+				{
+					variables[j] = PrimitiveVariable();
+				}
+				else if( typeId == InvalidTypeId )
+				{
+					typeId = variables[j].data->typeId();
+				}
+				else if( variables[j].data->typeId() != typeId )
+				{
+					variables[j] = PrimitiveVariable();
+				}
+
+				if( !variables[j].data )
+				{
+					mismatched = 1;
+					allIndexed = false;
+				}
+				else if( !variables[j].indices )
+				{
+					allIndexed = false;
+				}
+			}
+
+			if( typeId == InvalidTypeId )
+			{
+				return;
+			}
+
+			std::vector<ConstDataPtr> sources( n );
+			std::vector<size_t> sizes( n, 0 );
+			const DataPtr *reference = 0;
+			for( size_t j = 0; j < n; ++j )
+			{
+				if( !variables[j].data )
+				{
+					sizes[j] = m_primitives[j]->variableSize( interpolation );
+					continue;
+				}
+
+				sources[j] = allIndexed || !variables[j].indices ? variables[j].data : variables[j].expandedData();
+				reference = reference ? reference : &variables[j].data;
+			}
+
+			MergeVectors merger( sources, sizes );
+			DataPtr data = despatchTypedData<MergeVectors, TypeTraits::IsVectorTypedData>( const_cast<Data *>( reference->get() ), merger );
+
+			IntVectorDataPtr indices;
+			if( allIndexed )
+			{
+				std::vector<const std::vector<int> *> indexSources( n );
+				std::vector<size_t> dataOffsets( n );
+				size_t dataSize = 0;
+				for( size_t j = 0; j < n; ++j )
+				{
+					indexSources[j] = &variables[j].indices->readable();
+					dataOffsets[j] = dataSize;
+					dataSize += despatchTypedData<TypedDataSize>( const_cast<Data *>( variables[j].data.get() ) );
+				}
+
+				indices = new IntVectorData;
+				mergeIndices( indexSources, dataOffsets, indices->writable() );
+			}
+
+			result = PrimitiveVariable( interpolation, data, indices );
+		}
+
+		const std::vector<const P *> &m_primitives;
+		Resampler m_resampler;
+		const int *m_interpolationRanks;
+		const std::vector<std::vector<const PrimitiveVariable *> > &m_inputs;
+		const std::vector<PrimitiveVariable::Interpolation> &m_interpolations;
+		std::vector<PrimitiveVariable> &m_results;
+		std::vector<char> &m_mismatched;
+
+};
+
+/// Merges the primitive variables of all the primitives into result, which must
+/// already have the merged topology. Every variable present on any input is output,
+/// with the interpolation of highest rank found amongst the inputs. Inputs with another
+/// interpolation are resampled to it once, and inputs lacking the variable, or
+/// holding it with a different type, contribute default values. Indices are kept
+/// if every input is indexed, and otherwise expanded. Constant variables are taken
+/// from the first primitive that has them. The variables are merged concurrently.
+template<typename P>
+void mergePrimitiveVariables(
+	const std::vector<const P *> &primitives, typename PrimitiveVariableMergeTraits<P>::Resampler resampler,
+	const int *interpolationRanks, Primitive *result, const char *context
+)
+{
+	std::vector<std::string> names;
+	std::vector<std::vector<const PrimitiveVariable *> > inputs;
+	std::vector<PrimitiveVariable::Interpolation> interpolations;
+	std::set<std::string> visited;
+	for( size_t i = 0; i < primitives.size(); ++i )
+	{
+		for( PrimitiveVariableMap::const_iterator it = primitives[i]->variables.begin(), eIt = primitives[i]->variables.end(); it != eIt; ++it )
+		{
+			if( !visited.insert( it->first ).second )
+			{
+				continue;
+			}
+
+			std::vector<const PrimitiveVariable *> variableInputs( primitives.size(), static_cast<const PrimitiveVariable *>( 0 ) );
+			PrimitiveVariable::Interpolation interpolation = PrimitiveVariable::Constant;
+			for( size_t j = i; j < primitives.size(); ++j )
+			{
+				PrimitiveVariableMap::const_iterator oIt = primitives[j]->variables.find( it->first );
+				if( oIt == primitives[j]->variables.end() || oIt->second.interpolation == PrimitiveVariable::Invalid || oIt->second.interpolation > PrimitiveVariable::FaceVarying )
+				{
+					continue;
+				}
+				variableInputs[j] = &oIt->second;
+				if( interpolationRanks[oIt->second.interpolation] > interpolationRanks[interpolation] )
+				{
+					interpolation = oIt->second.interpolation;
+				}
+			}
+
+			if( interpolation == PrimitiveVariable::Constant )
+			{
+				if( variableInputs[i] )
+				{
+					result->variables[it->first] = *variableInputs[i];
+				}
+				continue;
+			}
+
+			names.push_back( it->first );
+			inputs.push_back( variableInputs );
+			interpolations.push_back( interpolation );
+		}
+	}
+
+	std::vector<PrimitiveVariable> primitiveVariables( names.size() );
+	std::vector<char> mismatched( names.size(), 0 );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, names.size(), 1 ),
+		PrimitiveVariableMerger<P>( primitives, resampler, interpolationRanks, inputs, interpolations, primitiveVariables, mismatched )
+	);
+
+	// messages are output here rather than from the tasks, because
+	// message handlers are installed per thread.
+	for( size_t i = 0; i < names.size(); ++i )
+	{
+		if( mismatched[i] )
+		{
+			msg( Msg::Warning, context, boost::format( "Using default values for primitive variable \"%s\" on inputs where it has a different type, or can't be resampled." ) % names[i] );
+		}
+		if( primitiveVariables[i].data )
+		{
+			result->variables[names[i]] = primitiveVariables[i];
+		}
+	}
+}
+
+
 } // namespace Detail
 } // namespace IECore
 
@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_RAYBOXINTERSECTOR_H
+#define IECORE_RAYBOXINTERSECTOR_H
+
+#include <algorithm>
+#include <limits>
+
+#include "OpenEXR/ImathBox.h"
+#include "OpenEXR/ImathLine.h"
+
+namespace IECore
+{
+
+namespace Detail
+{
+
+// Slab test for a ray against boxes, with the reciprocal of the
+// direction computed once up front rather than per box.
+struct RayBoxIntersector
+{
+
+	RayBoxIntersector( const Imath::Line3f &ray )
+		:	origin( ray.pos )
+	{
+		for( int i = 0; i < 3; ++i )
+		{
+			parallel[i] = ray.dir[i] == 0.0f;
+			inverseDir[i] = parallel[i] ? 0.0f : 1.0f / ray.dir[i];
+		}
+	}
+
+	// Returns true if the ray enters the box at a distance no greater
+	// than maxDist, setting tNear to that distance.
+	bool intersects( const Imath::Box3f &box, float maxDist, float &tNear ) const
+	{
+		float t0 = 0.0f;
+		float t1 = maxDist;
+		for( int i = 0; i < 3; ++i )
+		{
+			if( parallel[i] )
+			{
+				// Handled separately because otherwise an origin lying
+				// exactly on a slab boundary yields 0 * infinity.
+				if( origin[i] < box.min[i] || origin[i] > box.max[i] )
+				{
+					return false;
+				}
+				continue;
+			}
+
+			float tMin = ( box.min[i] - origin[i] ) * inverseDir[i];
+			float tMax = ( box.max[i] - origin[i] ) * inverseDir[i];
+			if( tMin > tMax )
+			{
+				std::swap( tMin, tMax );
+			}
+			// Pad the exit distance slightly, so that rounding error can't
+			// cause us to miss primitives lying in the faces of the box.
+			tMax *= 1.0f + 4.0f * std::numeric_limits<float>::epsilon();
+
+			t0 = std::max( t0, tMin );
+			t1 = std::min( t1, tMax );
+			if( t0 > t1 )
+			{
+				return false;
+			}
+		}
+
+		tNear = t0;
+		return true;
+	}
+
+	Imath::V3f origin;
+	Imath::V3f inverseDir;
+	bool parallel[3];
+
+};
+
+} // namespace Detail
+
+} // namespace IECore
+
+#endif // IECORE_RAYBOXINTERSECTOR_H
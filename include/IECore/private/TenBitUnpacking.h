@@ -0,0 +1,170 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_TENBITUNPACKING_H
+#define IECORE_TENBITUNPACKING_H
+
+#include <vector>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "OpenEXR/ImathBox.h"
+
+#include "IECore/ByteOrder.h"
+#include "IECore/ScaledDataConversion.h"
+#include "IECore/VectorTypedData.h"
+
+namespace IECore
+{
+namespace Detail
+{
+
+/// Unpacks channels of 10 bit values stored three to a 32 bit word, with
+/// the first channel in the most significant bits and two bits of padding
+/// at the bottom. This is the layout used by the typical DPX and Cineon
+/// file. Each code value is expanded to the full range of an unsigned short
+/// and then converted to V, matching the conversion the readers have always
+/// performed. All the requested channels are extracted in a single parallel
+/// pass over the scanlines, using a lookup table rather than per-pixel
+/// arithmetic. channelIndices specifies the position of each channel within
+/// the word, and a new V vector is appended to data for each one.
+template<typename V>
+void unpackTenBitChannels( const unsigned int *buffer, unsigned int bufferWidth, bool reverseBytes, const Imath::Box2i &region, const std::vector<int> &channelIndices, std::vector<DataPtr> &data );
+
+} // namespace Detail
+} // namespace IECore
+
+namespace IECore
+{
+namespace Detail
+{
+
+namespace TenBitUnpackingPrivate
+{
+
+template<typename V>
+class Unpacker
+{
+
+	public :
+
+		Unpacker( const unsigned int *buffer, unsigned int bufferWidth, bool reverseBytes, const Imath::Box2i &region, const std::vector<int> &shifts, const std::vector<V *> &outputs, const V *lut )
+			:	m_buffer( buffer ), m_bufferWidth( bufferWidth ), m_reverseBytes( reverseBytes ), m_region( region ), m_shifts( shifts ), m_outputs( outputs ), m_lut( lut )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			const int width = m_region.size().x + 1;
+			std::vector<unsigned int> row( width );
+			for( int y = range.begin(); y != range.end(); ++y )
+			{
+				const unsigned int *in = m_buffer + (size_t)y * m_bufferWidth + m_region.min.x;
+				if( m_reverseBytes )
+				{
+					for( int x = 0; x < width; ++x )
+					{
+						row[x] = reverseBytes( in[x] );
+					}
+					in = &row[0];
+				}
+
+				const size_t outOffset = (size_t)( y - m_region.min.y ) * width;
+				for( size_t c = 0, ce = m_shifts.size(); c < ce; ++c )
+				{
+					const int shift = m_shifts[c];
+					V *out = m_outputs[c] + outOffset;
+					for( int x = 0; x < width; ++x )
+					{
+						out[x] = m_lut[ ( in[x] >> shift ) & 0x3ff ];
+					}
+				}
+			}
+		}
+
+	private :
+
+		const unsigned int *m_buffer;
+		unsigned int m_bufferWidth;
+		bool m_reverseBytes;
+		const Imath::Box2i &m_region;
+		const std::vector<int> &m_shifts;
+		const std::vector<V *> &m_outputs;
+		const V *m_lut;
+
+};
+
+} // namespace TenBitUnpackingPrivate
+
+template<typename V>
+void unpackTenBitChannels( const unsigned int *buffer, unsigned int bufferWidth, bool reverseBytes, const Imath::Box2i &region, const std::vector<int> &channelIndices, std::vector<DataPtr> &data )
+{
+	typedef TypedData< std::vector<V> > TargetVector;
+
+	// build a table mapping each code value to its converted result
+	const int ushortShift = sizeof( unsigned short ) * 8 - 10;
+	ScaledDataConversion<unsigned short, V> converter;
+	V lut[1024];
+	for( unsigned int cv = 0; cv < 1024; ++cv )
+	{
+		lut[cv] = converter( ( cv << ushortShift ) + ( ( 1 << ushortShift ) - 1 ) );
+	}
+
+	const size_t area = (size_t)( region.size().x + 1 ) * ( region.size().y + 1 );
+
+	std::vector<int> shifts;
+	std::vector<V *> outputs;
+	for( std::vector<int>::const_iterator it = channelIndices.begin(), eIt = channelIndices.end(); it != eIt; ++it )
+	{
+		shifts.push_back( 2 + ( 2 - *it ) * 10 );
+		typename TargetVector::Ptr channelData = new TargetVector;
+		channelData->writable().resize( area );
+		outputs.push_back( area ? &channelData->writable()[0] : 0 );
+		data.push_back( channelData );
+	}
+
+	if( !area )
+	{
+		return;
+	}
+
+	TenBitUnpackingPrivate::Unpacker<V> unpacker( buffer, bufferWidth, reverseBytes, region, shifts, outputs, lut );
+	tbb::parallel_for( tbb::blocked_range<int>( region.min.y, region.max.y + 1 ), unpacker );
+}
+
+} // namespace Detail
+} // namespace IECore
+
+#endif // IECORE_TENBITUNPACKING_H
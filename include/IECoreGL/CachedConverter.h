@@ -57,6 +57,17 @@ class IECOREGL_API CachedConverter : public IECore::RefCounted
 		/// Returns the object converted to an appropriate IECoreGL type, reusing
 		/// a previous conversion where possible.
 		IECore::ConstRunTimeTypedPtr convert( const IECore::Object *object );
+		/// As for convert(), but rather than blocking while a new conversion is
+		/// made, launches it on a TBB worker thread and returns 0 immediately.
+		/// Subsequent calls return the converted object once it is ready, so
+		/// clients such as viewport draw methods may draw a placeholder (the
+		/// bound for instance) and try again on the next redraw. The object
+		/// must not be modified until the result is available. Objects whose
+		/// conversion requires a GL context (ImagePrimitives and Data) are
+		/// converted synchronously as for convert(). If a background conversion
+		/// fails, an error is reported via IECore::msg() and 0 is returned from
+		/// then on.
+		IECore::ConstRunTimeTypedPtr convertAsync( const IECore::Object *object );
 		
 		/// Returns the maximum amount of memory (in bytes) the cache will use.
 		size_t getMaxMemory() const;
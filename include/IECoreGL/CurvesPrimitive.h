@@ -80,16 +80,27 @@ class IECOREGL_API CurvesPrimitive : public Primitive
 		/// are rendered using the GL_LINE primitives.
 		typedef TypedStateComponent<float, CurvesPrimitiveGLLineWidthTypeId> GLLineWidth;
 		IE_CORE_DECLAREPTR( GLLineWidth );
+		/// When greater than zero, cubic curves are tessellated on the GPU
+		/// using tessellation shaders, with each segment subdivided so that
+		/// the generated spans are approximately this length in pixels. This
+		/// requires GLSL 4.0, and is ignored if the current shader provides
+		/// its own geometry shader.
+		typedef TypedStateComponent<float, CurvesPrimitiveTessellationSegmentLengthTypeId> TessellationSegmentLength;
+		IE_CORE_DECLAREPTR( TessellationSegmentLength );
 		//@}
 
 	private :
 
-		void renderMode( const State *state, bool &linear, bool &ribbons ) const;
+		void renderMode( const State *state, bool &linear, bool &ribbons, bool &tessellated ) const;
 
 		static const std::string &cubicLinesGeometrySource();
 		static const std::string &cubicRibbonsGeometrySource();
 		static const std::string &linearRibbonsGeometrySource();
 
+		static const std::string &tessControlSource();
+		static const std::string &cubicLinesTessEvaluationSource();
+		static const std::string &cubicRibbonsTessEvaluationSource();
+
 		void ensureVertIds() const;
 		void ensureAdjacencyVertIds() const;
 		void ensureLinearAdjacencyVertIds() const;
@@ -64,6 +64,13 @@ class IECOREGL_API Font : public IECore::RunTimeTyped
 		/// Emits a series of quads with appropriate texture coordinates,
 		/// such that if you have bound texture() you can render text.
 		void renderSprites( const std::string &text ) const;
+		/// Fills positions and texCoords with the corners of the quads emitted
+		/// by renderSprites(), four per character. The results may be stored
+		/// and passed to renderSpriteQuads(), so that text which is drawn
+		/// repeatedly needn't be laid out every time.
+		void spriteQuads( const std::string &text, std::vector<Imath::V2f> &positions, std::vector<Imath::V2f> &texCoords ) const;
+		/// Draws quads computed by spriteQuads() with a single draw call.
+		static void renderSpriteQuads( const std::vector<Imath::V2f> &positions, const std::vector<Imath::V2f> &texCoords );
 		/// Renders text as a series of meshes with the specified state.
 		void renderMeshes( const std::string &text, State *state ) const;
 
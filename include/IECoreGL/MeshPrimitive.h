@@ -35,6 +35,10 @@
 #ifndef IECOREGL_MESHPRIMITIVE_H
 #define IECOREGL_MESHPRIMITIVE_H
 
+#include <vector>
+
+#include "OpenEXR/ImathMatrix.h"
+
 #include "IECoreGL/Export.h"
 #include "IECoreGL/Primitive.h"
 
@@ -51,7 +55,17 @@ class IECOREGL_API MeshPrimitive : public Primitive
 
 		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( IECoreGL::MeshPrimitive, MeshPrimitiveTypeId, Primitive );
 
+		/// Constructs a mesh which is drawn as an unindexed triangle list, and
+		/// whose vertex attributes must therefore all be provided with
+		/// FaceVarying interpolation.
 		MeshPrimitive( unsigned numTriangles );
+		/// Constructs a mesh which is drawn as an indexed triangle list, with
+		/// vertIds specifying three vertices for each triangle. Vertex attributes
+		/// must be provided with Vertex interpolation, with one element for each
+		/// vertex referenced by vertIds. Because vertices shared by several
+		/// triangles are transformed and stored only once, this is typically
+		/// much faster to draw than the unindexed form.
+		MeshPrimitive( IECore::ConstUIntVectorDataPtr vertIds );
 		virtual ~MeshPrimitive();
 
 		virtual Imath::Box3f bound() const;
@@ -60,8 +74,20 @@ class IECOREGL_API MeshPrimitive : public Primitive
 
 		virtual void renderInstances( size_t numInstances = 1 ) const;
 
+		/// Renders a copy of the mesh for each of the transforms, each relative
+		/// to the current GL matrix. Where the state permits - solid shading
+		/// with no user-specified vertex or geometry shader, no wireframe etc,
+		/// no depth sorting and no selection - this is done with a single
+		/// instanced draw call, with the transforms passed to the default vertex
+		/// shader as a per-instance attribute. Otherwise each copy is rendered in
+		/// turn using render(). Normals are transformed by the upper 3x3 of each
+		/// transform, so are only correct for rotations and uniform scales.
+		void renderInstanced( State *currentState, const std::vector<Imath::M44f> &transforms ) const;
+
 	private :
 
+		bool instancedRenderingSupported( const State *state ) const;
+
 		IE_CORE_FORWARDDECLARE( MemberData );
 		MemberDataPtr m_memberData;
 
@@ -81,6 +81,18 @@ class IECOREGL_API PointsPrimitive : public Primitive
 		/// Specifies an attribute for defining the glPointSize of PointsPrimitives rendered as gl points.
 		typedef TypedStateComponent<float, PointsPrimitiveGLPointWidthTypeId> GLPointWidth;
 		IE_CORE_DECLAREPTR( GLPointWidth );
+		/// Specifies a width in pixels, below which disks, quads and spheres are
+		/// drawn as gl points instead. The width is that of the largest particle
+		/// as it would appear at the nearest point of the bound, so the simpler
+		/// representation is only used when every particle would be small on screen.
+		/// A value of 0 disables this.
+		typedef TypedStateComponent<float, PointsPrimitiveLODMinimumWidthTypeId> LODMinimumWidth;
+		IE_CORE_DECLAREPTR( LODMinimumWidth );
+		/// Limits the number of gl points drawn to this many per pixel covered by
+		/// the projected bound, choosing a random subset of the points to draw so
+		/// that the overall appearance is preserved. A value of 0 disables this.
+		typedef TypedStateComponent<float, PointsPrimitiveLODDensityTypeId> LODDensity;
+		IE_CORE_DECLAREPTR( LODDensity );
 		//@}
 
 	private :
@@ -91,9 +103,17 @@ class IECOREGL_API PointsPrimitive : public Primitive
 
 		Type effectiveType( const State *state ) const;
 
+		// Level of detail support.
+		float projectedPointWidth() const;
+		size_t lodPointCount( const State *state ) const;
+		void renderPoints( size_t numPoints ) const;
+
 		static std::string &instancingVertexSource();
-		
+
+		// Depth sorting for transparency. Only gl points are sorted, as
+		// instances are drawn in the order of the points themselves.
 		void depthSort() const;
+		void renderSortedPoints() const;
 
 		IE_CORE_FORWARDDECLARE( MemberData );
 
@@ -164,8 +164,13 @@ class IECOREGL_API Primitive : public Renderable
 	protected :
 
 		/// Called by derived classes to register a uniform attribute. There are no type or length checks on this call.
+		/// Attributes may be replaced by calling this again with the same name - this is a no-op if the
+		/// new data has the same hash as the old.
 		void addUniformAttribute( const std::string &name, IECore::ConstDataPtr data );
 		/// Called by derived classes to register a vertex attribute. There are no type or length checks on this call.
+		/// Attributes may be replaced by calling this again with the same name, in which case only the buffer for
+		/// that attribute will be uploaded again on the next render. This is a no-op if the new data has the same
+		/// hash as the old.
 		void addVertexAttribute( const std::string &name, IECore::ConstDataPtr data );
 
 		/// Convenience function for use in render() implementations. Returns
@@ -185,6 +190,8 @@ class IECOREGL_API Primitive : public Renderable
 		AttributeMap m_vertexAttributes;
 		AttributeMap m_uniformAttributes;
 
+		void addAttribute( AttributeMap &attributes, const std::string &name, IECore::ConstDataPtr data );
+
 };
 
 IE_CORE_DECLAREPTR( Primitive );
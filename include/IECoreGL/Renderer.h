@@ -105,6 +105,17 @@ class IECOREGL_API Renderer : public IECore::Renderer
 		/// "gl:drawCoordinateSystems" BoolData false
 		/// When this is true, coordinate systems created with the coordinateSystem() method
 		/// will be visualised.
+		///
+		/// "gl:procedural:maxPending" IntData 0
+		/// Limits the number of procedurals waiting to be expanded in parallel in deferred
+		/// mode. Beyond this, procedurals are expanded immediately by the thread creating
+		/// them, bounding the memory used by very wide expansions. A value of 0 means
+		/// no limit.
+		///
+		/// "gl:procedural:statistics" CompoundData
+		/// Read only. In deferred mode, provides the number of procedurals expanded and the
+		/// total time in seconds spent expanding them, as "count" and "time" entries in a
+		/// CompoundData for each procedural class.
 		virtual void setOption( const std::string &name, IECore::ConstDataPtr value );
 		virtual IECore::ConstDataPtr getOption( const std::string &name ) const;
 		/// \par Standard parameters supported :
@@ -226,7 +237,7 @@ class IECOREGL_API Renderer : public IECore::Renderer
 		/// primitive to be sorted in depth when the "gl:shade:transparent"
 		/// attribute is true.
 		/// This is currently supported only by the
-		/// points primitive.
+		/// points primitive, when drawn as gl points.
 		///
 		/// \par Implementation specific points primitive attributes :
 		////////////////////////////////////////////////////////////
@@ -246,6 +257,15 @@ class IECOREGL_API Renderer : public IECore::Renderer
 		/// The size of the points (in pixels) used when rendering lightweight
 		/// points.
 		///
+		/// \li <b>"gl:pointsPrimitive:lodMinimumWidth" FloatData 0.0f</b><br>
+		/// When non-zero, points primitives whose particles would all be
+		/// smaller than this many pixels on screen are drawn as lightweight
+		/// points, regardless of their type.
+		///
+		/// \li <b>"gl:pointsPrimitive:lodDensity" FloatData 0.0f</b><br>
+		/// When non-zero, lightweight points are decimated randomly so that
+		/// no more than this many are drawn per pixel of the projected bound.
+		///
 		/// \par Implementation specific curves primitive attributes :
 		////////////////////////////////////////////////////////////
 		///
@@ -260,6 +280,10 @@ class IECOREGL_API Renderer : public IECore::Renderer
 		/// \li <b>"gl:curvesPrimitive:ignoreBasis" BoolData false</b><br>
 		/// When this is true, all curves are rendered as if they were linear.
 		///
+		/// \li <b>"gl:curvesPrimitive:tessellationSegmentLength" FloatData 0.0f</b><br>
+		/// When greater than zero, cubic curves are tessellated on the GPU with
+		/// spans of approximately this length in pixels. Requires GLSL 4.0.
+		///
 		/// \par Implementation specific text primitive attributes :
 		////////////////////////////////////////////////////////////
 		///
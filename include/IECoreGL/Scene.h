@@ -87,11 +87,47 @@ class IECOREGL_API Scene : public Renderable
 		/// Returns the root node for the scene.
 		ConstGroupPtr root() const;
 
+		/// By default render() traverses the hierarchy below root(), binding
+		/// the state of every Group on the way down and reverting it on the
+		/// way back up. When the render list is enabled, the hierarchy is instead
+		/// flattened into a list of primitives with their effective state and
+		/// transform, sorted so that primitives sharing a shader and state are
+		/// drawn together with only the differences in state being bound between
+		/// them. The list is built on the first call to render() and reused until
+		/// dirtyRenderList() is called or a different root state is passed, so it
+		/// is the caller's responsibility to dirty it after editing the hierarchy.
+		/// Primitives with transparent shading are drawn after all others, in
+		/// their original order. select() always traverses the hierarchy.
+		void setRenderListEnabled( bool enabled );
+		bool getRenderListEnabled() const;
+		/// Discards the render list, so that it is rebuilt on the next
+		/// call to render().
+		void dirtyRenderList();
+
+		/// When frustum culling is enabled, primitives whose bounds lie outside
+		/// the view are not drawn. When occlusion culling is enabled, an occlusion
+		/// query is issued for everything that is drawn, and anything found to be
+		/// hidden is skipped on subsequent renders, with only its bound being drawn
+		/// (invisibly) to detect when it reappears. Query results are collected
+		/// without waiting for the GPU, so objects may appear a frame late. Both
+		/// forms of culling use the bounds computed when the render list is built,
+		/// and so only take effect when the render list is enabled.
+		void setFrustumCullingEnabled( bool enabled );
+		bool getFrustumCullingEnabled() const;
+		void setOcclusionCullingEnabled( bool enabled );
+		bool getOcclusionCullingEnabled() const;
+
 	private :
 
 		GroupPtr m_root;
 		CameraPtr m_camera;
 
+		bool m_renderListEnabled;
+		bool m_frustumCullingEnabled;
+		bool m_occlusionCullingEnabled;
+		IE_CORE_FORWARDDECLARE( RenderList );
+		mutable RenderListPtr m_renderList;
+
 };
 
 IE_CORE_DECLAREPTR( Scene );
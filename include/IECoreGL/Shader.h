@@ -69,12 +69,26 @@ class IECOREGL_API Shader : public IECore::RunTimeTyped
 		/// shader for that shader component. If geometrySource is empty then no geometry shader
 		/// will be used. Throws a descriptive Exception if the shader fails to compile.
 		Shader( const std::string &vertexSource, const std::string &geometrySource, const std::string &fragmentSource );
+		/// As above, but also accepting tessellation control and evaluation shaders. These
+		/// require GLSL 4.0, and if either is empty then no shader is used for that stage.
+		Shader( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource );
+		/// Constructs a Shader from a program binary previously retrieved with programBinary(),
+		/// avoiding the cost of compilation and linking. The source is not compiled, but is
+		/// stored for the accessors below, so it must be the source the binary was built from.
+		/// Throws if the driver rejects the binary, as it may following a driver update.
+		Shader( const std::string &vertexSource, const std::string &geometrySource, const std::string &fragmentSource, GLenum binaryFormat, const std::vector<char> &binary );
+		Shader( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource, GLenum binaryFormat, const std::vector<char> &binary );
 		virtual ~Shader();
 
 		/// Returns the GL program this shader represents. Note that this is owned by the Shader,
 		/// and will be destroyed upon destruction of the Shader - you must not call glDeleteProgram() yourself.
 		GLuint program() const;
 
+		/// Retrieves the linked program in a binary form suitable for
+		/// passing to the constructor above in a later session. Returns
+		/// false if the driver doesn't support program binaries.
+		bool programBinary( GLenum &binaryFormat, std::vector<char> &binary ) const;
+
 		//! @name Source accessors.
 		/// These functions return the shader source as passed to
 		/// the constructor. In the case of an empty string being
@@ -83,6 +97,8 @@ class IECOREGL_API Shader : public IECore::RunTimeTyped
 		///////////////////////////////////////////////////////////
 		//@{
 		const std::string &vertexSource() const;
+		const std::string &tessControlSource() const;
+		const std::string &tessEvaluationSource() const;
 		const std::string &geometrySource() const;
 		const std::string &fragmentSource() const;
 		//@}
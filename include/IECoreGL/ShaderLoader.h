@@ -75,6 +75,8 @@ class IECOREGL_API ShaderLoader : public IECore::RefCounted
 		/// and then return a new instance of the Shader class. This function will also eliminate any shader
 		/// from the cache that is not being used.
 		ShaderPtr create( const std::string &vertexSource, const std::string &geometrySource, const std::string &fragmentSource );
+		/// As above, but also accepting tessellation control and evaluation shaders.
+		ShaderPtr create( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource );
 
 		/// Loads the shader code and creates the Shader object.
 		/// This function can only be called when the OpenGL context is defined.
@@ -88,12 +90,21 @@ class IECOREGL_API ShaderLoader : public IECore::RefCounted
 		// Free all shaders - this allows us to reload shaders and pick up changes
 		void clear();
 
+		/// Specifies a directory in which compiled program binaries are stored,
+		/// so that shaders need only be compiled once across sessions rather than
+		/// once per session. Binaries are keyed by the preprocessed source and the
+		/// GL vendor, renderer and version, so a driver update simply results in
+		/// recompilation. An empty string (the default) disables the cache.
+		void setCacheDirectory( const std::string &cacheDirectory );
+		const std::string &getCacheDirectory() const;
+
 		/// Returns a static ShaderLoader instance that everyone
 		/// can use. This has searchpaths set using the
 		/// IECOREGL_SHADER_PATHS environment variable,
 		/// and preprocessor searchpaths set using the
 		/// IECOREGL_SHADER_INCLUDE_PATHS environment
-		/// variable.
+		/// variable. The cache directory is set using the
+		/// IECOREGL_SHADER_CACHE_PATH environment variable.
 		static ShaderLoader *defaultShaderLoader();
 
 	private :
@@ -108,6 +108,26 @@ class IECOREGL_API State : public Bindable
 		void remove( IECore::TypeId componentType );
 
 		bool isComplete() const;
+
+		/// Returns true if other holds the very same StateComponent instances,
+		/// with the same override flags, and equal user attributes - in which
+		/// case binding either state has an identical effect. This is a cheap
+		/// test intended for batching draws, and will return false for states
+		/// which hold distinct but equal components.
+		bool equivalent( const State &other ) const;
+
+		/// Modifies this state to reflect the effect of binding s with a
+		/// ScopedBinding while this state is the currentState - components
+		/// of s replace those in this state, except where this state has
+		/// them marked as overrides. User attributes are not affected. Returns
+		/// true if any component was changed. This allows the effective state
+		/// at any point in a hierarchy to be computed without binding anything.
+		bool compose( const State &s );
+
+		/// Binds only those components which differ from the ones held by
+		/// previous, which is assumed to be bound already. This is much cheaper
+		/// than bind() when moving between two similar complete states.
+		void bind( const State &previous ) const;
 		
 		/// Arbitrary state attributes for user manipulation.
 		IECore::CompoundData *userAttributes();
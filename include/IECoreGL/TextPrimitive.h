@@ -81,6 +81,11 @@ class IECOREGL_API TextPrimitive : public Primitive
 		FontPtr m_font;
 		std::string m_text;
 		Imath::Box3f m_bound;
+
+		// Sprite layout, computed on first use so that
+		// it isn't repeated every time we're rendered.
+		mutable std::vector<Imath::V2f> m_spritePositions;
+		mutable std::vector<Imath::V2f> m_spriteTexCoords;
 	
 		void renderMeshes( State *state ) const;
 		void renderSprites( State *state ) const;
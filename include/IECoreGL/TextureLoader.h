@@ -61,25 +61,51 @@ class IECOREGL_API TextureLoader : public IECore::RefCounted
 		IE_CORE_DECLAREMEMBERPTR( TextureLoader );
 
 		TextureLoader( const IECore::SearchPath &searchPaths );
+		virtual ~TextureLoader();
 
 		TexturePtr load( const std::string &name );
 
 		/// Removes any cached textures.
 		void clear();
 
+		/// Returns the maximum amount of memory (in bytes) the loader will
+		/// use to hold onto textures. Beyond this, the least recently used
+		/// textures are removed from the cache, and will be freed as soon as
+		/// nothing else references them. Defaults to unlimited.
+		size_t getMaxMemory() const;
+		/// Sets the maximum amount of memory the loader will use. If this
+		/// is less than the current usage then cache removals will result.
+		void setMaxMemory( size_t maxMemory );
+
+		/// Images whose width or height exceed this are repeatedly halved in
+		/// size before being converted into textures. A value of 0 (the default)
+		/// means that images are always loaded at full resolution. Changing the
+		/// value clears the cache.
+		void setMaximumResolution( int maximumResolution );
+		int getMaximumResolution() const;
+
+		/// Specifies a directory in which images downsampled as a result of
+		/// the maximum resolution above are stored, so that subsequent sessions
+		/// need neither decode the full resolution image nor downsample it again.
+		/// Cached images are keyed by file path, modification time and maximum
+		/// resolution. An empty string (the default) disables the cache.
+		void setCacheDirectory( const std::string &cacheDirectory );
+		const std::string &getCacheDirectory() const;
+
 		/// Returns a static TextureLoader instance that everyone
 		/// can use. This has searchpaths set using the
-		/// IECOREGL_TEXTURE_PATHS environment variable.
+		/// IECOREGL_TEXTURE_PATHS environment variable, a memory
+		/// limit specified in megabytes by the IECOREGL_TEXTURELOADER_MEMORY
+		/// environment variable, a maximum resolution specified by the
+		/// IECOREGL_TEXTURELOADER_MAXIMUM_RESOLUTION environment variable and
+		/// a cache directory specified by the IECOREGL_TEXTURE_CACHE_PATH
+		/// environment variable.
 		static TextureLoader *defaultTextureLoader();
 
 	private :
 
-		void freeUnusedTextures();
-
-		typedef std::map<std::string, TexturePtr> TexturesMap;
-		TexturesMap m_loadedTextures;
-
-		IECore::SearchPath m_searchPaths;
+		IE_CORE_FORWARDDECLARE( Implementation );
+		ImplementationPtr m_implementation;
 
 };
 
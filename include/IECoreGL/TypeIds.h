@@ -123,6 +123,9 @@ enum TypeId
 	PrimitiveSelectableTypeId = 105080,
 	ToGLStateConverterTypeId = 105081,
 	ToGLSphereConverterTypeId = 105082,
+	PointsPrimitiveLODMinimumWidthTypeId = 105083,
+	PointsPrimitiveLODDensityTypeId = 105084,
+	CurvesPrimitiveTessellationSegmentLengthTypeId = 105085,
 	LastCoreGLTypeId = 105999,
 };
 
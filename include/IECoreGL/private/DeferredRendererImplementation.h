@@ -39,8 +39,11 @@
 
 #include <stack>
 #include <vector>
+#include <map>
 
 #include "tbb/enumerable_thread_specific.h"
+#include "tbb/atomic.h"
+#include "tbb/spin_mutex.h"
 
 namespace IECoreGL
 {
@@ -88,6 +91,21 @@ class DeferredRendererImplementation : public RendererImplementation
 
 		ScenePtr scene();
 
+		/// Limits the number of procedurals which may be waiting to be
+		/// expanded in threaded mode. Once the limit is reached, further
+		/// procedurals are expanded immediately on the thread that created them,
+		/// which bounds the memory used by a wide expansion in exchange for less
+		/// parallelism. A value of 0 means no limit.
+		void setMaxPendingProcedurals( int maxPendingProcedurals );
+		int getMaxPendingProcedurals() const;
+
+		/// Returns statistics about procedural expansion, in the form of a
+		/// CompoundData mapping from procedural class name to a CompoundData
+		/// containing "count" (IntData) and "time" (DoubleData, in seconds)
+		/// entries. Time is measured inclusive of procedurals expanded
+		/// immediately by another procedural because of the limit above.
+		IECore::CompoundDataPtr proceduralStatistics() const;
+
 	private :
 
 		ScenePtr m_scene;
@@ -125,6 +143,24 @@ class DeferredRendererImplementation : public RendererImplementation
 		// pop method for procedural's context
 		RenderContextPtr popContext();
 
+		// creates a context for a new procedural from the current context
+		RenderContextPtr proceduralContext();
+		// renders the procedural with the context active, recording statistics
+		void expandProcedural( const IECore::Renderer::Procedural *proc, IECore::Renderer *renderer, RenderContextPtr context );
+
+		tbb::atomic<int> m_pendingProcedurals;
+		int m_maxPendingProcedurals;
+
+		struct ProceduralStatistics
+		{
+			ProceduralStatistics() : count( 0 ), time( 0 ) {}
+			int count;
+			double time;
+		};
+		typedef std::map<std::string, ProceduralStatistics> ProceduralStatisticsMap;
+		ProceduralStatisticsMap m_proceduralStatistics;
+		mutable tbb::spin_mutex m_proceduralStatisticsMutex;
+
 		class ProceduralTask;
 		struct ScopedRenderContext;
 };
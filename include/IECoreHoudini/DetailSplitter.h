@@ -48,7 +48,9 @@ namespace IECoreHoudini
 /// DetailSplitter is a convenience class for extracting select bits of geometry
 /// from a GU_Detail. It is intended to improve performance when making multiple
 /// calls to split the same detail. The default use is splitting based on the name
-/// attribute, but any primitive string attribute could be used.
+/// attribute, but any primitive string attribute could be used. All the pieces are
+/// extracted in a single pass over the detail the first time they're needed, and
+/// cached until the detail is modified.
 class DetailSplitter : public IECore::RefCounted
 {
 	
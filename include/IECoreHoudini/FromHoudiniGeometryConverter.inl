@@ -37,6 +37,8 @@
 
 #include "GEO/GEO_Vertex.h"
 
+#include "tbb/parallel_for.h"
+
 #include "IECore/DespatchTypedData.h"
 #include "IECore/VectorTraits.h"
 
@@ -101,22 +103,91 @@ struct SetInterpretation
 	}
 };
 
+/// Reads tuples from the elements at a list of offsets, in parallel. Contiguous
+/// runs of offsets are read with a single getRange() call.
+template<typename BaseType>
+struct GetTupleRanges
+{
+	GetTupleRanges( const GA_Attribute *attr, const std::vector<GA_Offset> &offsets, BaseType *dest, int elementIndex, unsigned stride )
+		:	m_attr( attr ), m_offsets( offsets ), m_dest( dest ), m_elementIndex( elementIndex ), m_stride( stride )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		const GA_AIFTuple *tuple = m_attr->getAIFTuple();
+		const GA_IndexMap &indexMap = m_attr->getIndexMap();
+
+		size_t runStart = r.begin();
+		while ( runStart != r.end() )
+		{
+			size_t runEnd = runStart + 1;
+			while ( runEnd != r.end() && m_offsets[runEnd] == m_offsets[runEnd-1] + 1 )
+			{
+				++runEnd;
+			}
+
+			GA_Range range( indexMap, m_offsets[runStart], m_offsets[runEnd-1] + 1 );
+			if ( m_elementIndex == -1 )
+			{
+				tuple->getRange( m_attr, range, m_dest + runStart * m_stride );
+			}
+			else
+			{
+				tuple->getRange( m_attr, range, m_dest + runStart * m_stride, m_elementIndex, 1 );
+			}
+
+			runStart = runEnd;
+		}
+	}
+
+	private :
+
+		const GA_Attribute *m_attr;
+		const std::vector<GA_Offset> &m_offsets;
+		BaseType *m_dest;
+		int m_elementIndex;
+		unsigned m_stride;
+};
+
 template <typename T>
 typename T::Ptr FromHoudiniGeometryConverter::extractData( const GA_Attribute *attr, const GA_Range &range, int elementIndex ) const
 {
 	typedef typename T::BaseType BaseType;
+	typedef typename T::ValueType::value_type ValueType;
 	
 	typename T::Ptr data = new T();
-	data->writable().resize( range.getEntries() );
+	GA_Size numElements = range.getEntries();
+	data->writable().resize( numElements );
 	BaseType *dest = data->baseWritable();
 	
-	if ( elementIndex == -1 )
+	if ( numElements < 4 * GA_PAGE_SIZE )
 	{
-		attr->getAIFTuple()->getRange( attr, range, dest );
+		if ( elementIndex == -1 )
+		{
+			attr->getAIFTuple()->getRange( attr, range, dest );
+		}
+		else
+		{
+			attr->getAIFTuple()->getRange( attr, range, dest, elementIndex, 1 );
+		}
 	}
 	else
 	{
-		attr->getAIFTuple()->getRange( attr, range, dest, elementIndex, 1 );
+		// large ranges are read in parallel, in runs of contiguous offsets
+		std::vector<GA_Offset> offsets;
+		offsets.reserve( numElements );
+		GA_Offset start, end;
+		for ( GA_Iterator it( range ); it.blockAdvance( start, end ); )
+		{
+			for ( GA_Offset o = start; o < end; ++o )
+			{
+				offsets.push_back( o );
+			}
+		}
+		
+		unsigned stride = ( elementIndex == -1 ) ? sizeof( ValueType ) / sizeof( BaseType ) : 1;
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, offsets.size(), GA_PAGE_SIZE ), GetTupleRanges<BaseType>( attr, offsets, dest, elementIndex, stride ) );
 	}
 	
 	// set the geometric interpretation if it exists
@@ -42,6 +42,7 @@
 
 #include "GR/GR_Primitive.h"
 
+#include "IECore/MurmurHash.h"
 #include "IECore/Renderable.h"
 
 // We can't include any IECoreGL files here, because it
@@ -95,6 +96,9 @@ class GR_CortexPrimitive : public GR_Primitive
 		GA_Index m_primId;
 		IECoreGL::ScenePtr m_scene;
 		const IECore::Renderable *m_renderable;		
+		// Hash of the renderable and display options m_scene was built from,
+		// so that update() can skip the conversion when nothing has changed.
+		IECore::MurmurHash m_sceneHash;
 		
 		IECoreGL::State *getState( GR_RenderMode mode, GR_RenderFlags flags, const GR_DisplayOption *opt );
 		
@@ -39,6 +39,7 @@
 #include "UT/UT_String.h"
 
 #include "IECore/SceneInterface.h"
+#include "IECore/VectorTypedData.h"
 
 #include "IECoreHoudini/DetailSplitter.h"
 #include "IECoreHoudini/TypeIds.h"
@@ -51,6 +52,10 @@ IE_CORE_FORWARDDECLARE( LiveScene );
 /// A read-only class for representing a live Houdini scene as an IECore::SceneInterface
 /// Note that this class treats time by SceneInterface standards, starting at Frame 0,
 /// as opposed to Houdini standards, which start at Frame 1.
+/// Bounds, transforms, objects and primitive group tags are cached per location and time,
+/// shared by all LiveScenes created from the same root. Cached results are validated
+/// against the cook counts of the Houdini nodes and the ids of their geometry, so nodes
+/// which have been dirtied but not yet re-cooked may return results from their last cook.
 class LiveScene : public IECore::SceneInterface
 {
 	public :
@@ -167,6 +172,16 @@ class LiveScene : public IECore::SceneInterface
 		void relativeContentPath( IECore::SceneInterface::Path &path ) const;
 		GU_DetailHandle contentHandle() const;
 		
+		/// Cache of results shared between a root LiveScene and all its descendants
+		class Cache;
+		IE_CORE_DECLAREPTR( Cache );
+		
+		/// Returns a key for a cached result of the given type, identifying this location,
+		/// the time, and the data ids of the node the result was computed from.
+		IECore::MurmurHash cacheKey( const char *type, double time, const OP_Node *node ) const;
+		/// Returns the sorted tags defined by primitive groups on the content geometry.
+		IECore::ConstInternedStringVectorDataPtr groupTags() const;
+		
 		/// Struct for registering readers for custom Attributes.
 		struct CustomAttributeReader
 		{
@@ -194,6 +209,8 @@ class LiveScene : public IECore::SceneInterface
 		
 		// used as the default cook time for methods that do not accept a time
 		double m_defaultTime;
+		
+		CachePtr m_cache;
 
 };
 
@@ -77,6 +77,10 @@ class OBJ_SceneCacheNode : public SceneCacheNode<BaseType>
 		virtual void pushToHierarchy() = 0;
 		/// Implemented to destroy all child nodes
 		virtual void collapseHierarchy();
+		/// Sets whether the transform at the current path is static, as determined by an
+		/// expansion prepass, so the node does not need to re-open the cache when it first cooks.
+		/// This must be called after setPath(), which resets the state.
+		void setStatic( bool isStatic );
 	
 	protected :
 		
@@ -35,6 +35,9 @@
 #ifndef IECOREHOUDINI_OBJSCENECACHETRANSFORM_H
 #define IECOREHOUDINI_OBJSCENECACHETRANSFORM_H
 
+#include <map>
+#include <vector>
+
 #include "OBJ/OBJ_SubNet.h"
 #include "UT/UT_StringMMPattern.h"
 
@@ -109,6 +112,26 @@ class OBJ_SceneCacheTransform : public OBJ_SceneCacheNode<OBJ_SubNet>
 			bool tagGroups;
 		};
 		
+		/// A summary of a location in the SceneCache. expandHierarchy() gathers these for
+		/// the entire subtree in parallel before creating any nodes, so that doExpandChildren()
+		/// and doExpandChild() can build the network without re-opening locations or re-reading
+		/// tags for every node.
+		struct Location
+		{
+			Location();
+			
+			IECore::ConstSceneInterfacePtr scene;
+			bool hasObject;
+			bool hasChildren;
+			bool tagged;
+			bool isStatic;
+			std::vector<Location> children;
+		};
+		
+		/// Returns the Location gathered for scene by the expandHierarchy() prepass,
+		/// or 0 if scene was not part of it.
+		const Location *location( const IECore::SceneInterface *scene ) const;
+		
 		/// Called by expandHierarchy() and doExpandChildren() when the SceneCache contains an object.
 		/// Implemented to expand the specific object using an OBJ_SceneCacheGeometry node.
 		virtual OBJ_Node *doExpandObject( const IECore::SceneInterface *scene, OP_Network *parent, const Parameters &params );
@@ -140,6 +163,15 @@ class OBJ_SceneCacheTransform : public OBJ_SceneCacheNode<OBJ_SubNet>
 		static bool hasTag( const OP_Node *node, const IECore::SceneInterface::Name &tag, int filter );
 		static void readTags( const OP_Node *node, IECore::SceneInterface::NameList &tags, int filter );
 		
+		static void gatherChildren( Location &parent, const UT_StringMMPattern &tagFilter, bool recurse, bool recurseUntagged );
+		static void gatherLocation( Location &location, const UT_StringMMPattern &tagFilter, bool recurse, bool recurseUntagged );
+		void indexLocations( const Location &location );
+		
+		struct GatherChildren;
+		
+		typedef std::map<const IECore::SceneInterface *, const Location *> LocationMap;
+		LocationMap m_locations;
+		
 		static int *g_indirection;
 
 };
@@ -83,21 +83,37 @@ class SOP_SceneCacheSource : public SceneCacheNode<SOP_Node>
 			UT_StringMMPattern shapeFilter;
 			UT_StringMMPattern tagFilter;
 			bool tagGroups;
+			std::map<std::string, GA_Range> namedRanges;
+		};
+		
+		// A single location to be loaded. Locations are gathered serially, their objects are
+		// read, modified and transformed in parallel, and then they are converted into the
+		// GU_Detail serially, in the order they were gathered.
+		struct Location
+		{
+			IECore::ConstSceneInterfacePtr scene;
+			Imath::M44d transform;
+			std::string name;
+			IECore::ConstObjectPtr object;
 			bool hasAnimatedTopology;
 			bool hasAnimatedPrimVars;
 			std::vector<IECore::InternedString> animatedPrimVars;
-			std::map<std::string, GA_Range> namedRanges;
 		};
 		
 		// Modify the object according the parameters, copying if neccessary.
-		IECore::ConstObjectPtr modifyObject( const IECore::Object *object, Parameters &params );
+		IECore::ConstObjectPtr modifyObject( const IECore::Object *object, const Parameters &params );
 		// Transform the object, copying if neccessary. Transforms Primitives (using IECore::TransformOp),
 		// Groups, and CoordinateSystems. Updates animatedTopology and animatedPrimVars if appropriate.
-		IECore::ConstObjectPtr transformObject( const IECore::Object *object, const Imath::M44d &transform, Parameters &params );
+		IECore::ConstObjectPtr transformObject( const IECore::Object *object, const Imath::M44d &transform, Location &location );
 		// Convert the object to Houdini, optimizing for animated primitive variables if possible.
-		bool convertObject( const IECore::Object *object, const std::string &name, const IECore::SceneInterface *scene, Parameters &params );
+		bool convertObject( const Location &location, Parameters &params );
 		
 		void loadObjects( const IECore::SceneInterface *scene, Imath::M44d transform, double time, Space space, Parameters &params, size_t rootSize );
+		// Appends the locations to be loaded below scene, returning false if interrupted.
+		bool gatherLocations( const IECore::SceneInterface *scene, Imath::M44d transform, const Parameters &params, double time, Space space, size_t rootSize, std::vector<Location> &locations );
+		// Reads the object for a location, applying any modifications and transforms.
+		// This is called concurrently for many locations, so must not modify the node.
+		void loadLocation( Location &location, const Parameters &params, double time, Space space );
 		IECore::MatrixTransformPtr matrixTransform( Imath::M44d t );
 		std::string relativePath( const IECore::SceneInterface *scene, size_t rootSize );
 		
@@ -106,6 +122,9 @@ class SOP_SceneCacheSource : public SceneCacheNode<SOP_Node>
 			bool operator() ( const IECore::SceneInterface::Name &i, const IECore::SceneInterface::Name &j );
 		};
 		
+		/// Functor for calling loadLocation() in parallel
+		struct LoadLocations;
+		
 		/// Utility for detecting geometric primitive variables that need transforming
 		struct TransformGeometricData
 		{
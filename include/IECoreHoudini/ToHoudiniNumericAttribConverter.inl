@@ -37,6 +37,8 @@
 
 #include "boost/format.hpp"
 
+#include "tbb/parallel_for.h"
+
 #include "IECore/DespatchTypedData.h"
 #include "IECore/VectorTraits.h"
 
@@ -98,6 +100,46 @@ struct GetInterpretation
 	}
 };
 
+/// Writes tuples to the elements at a list of offsets, in parallel. Contiguous runs
+/// of offsets are written with a single setRange() call, and the attribute pages must
+/// have been hardened in advance so that threads writing to the same page don't race.
+template<typename BaseType>
+struct SetTupleRanges
+{
+	SetTupleRanges( GA_Attribute *attr, const std::vector<GA_Offset> &offsets, const BaseType *src, unsigned dimensions )
+		:	m_attr( attr ), m_offsets( offsets ), m_src( src ), m_dimensions( dimensions )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		const GA_AIFTuple *tuple = m_attr->getAIFTuple();
+		const GA_IndexMap &indexMap = m_attr->getIndexMap();
+
+		size_t runStart = r.begin();
+		while ( runStart != r.end() )
+		{
+			size_t runEnd = runStart + 1;
+			while ( runEnd != r.end() && m_offsets[runEnd] == m_offsets[runEnd-1] + 1 )
+			{
+				++runEnd;
+			}
+
+			GA_Range range( indexMap, m_offsets[runStart], m_offsets[runEnd-1] + 1 );
+			tuple->setRange( m_attr, range, m_src + runStart * m_dimensions );
+
+			runStart = runEnd;
+		}
+	}
+
+	private :
+
+		GA_Attribute *m_attr;
+		const std::vector<GA_Offset> &m_offsets;
+		const BaseType *m_src;
+		unsigned m_dimensions;
+};
+
 template<typename T>
 GA_RWAttributeRef ToHoudiniNumericVectorAttribConverter<T>::doConversion( const IECore::Data *data, std::string name, GU_Detail *geo, const GA_Range &range ) const
 {
@@ -137,7 +179,29 @@ GA_RWAttributeRef ToHoudiniNumericVectorAttribConverter<T>::doConversion( const
 	const BaseType *src = dataPtr->baseReadable();
 	
 	GA_Attribute *attr = attrRef.getAttribute();
-	attr->getAIFTuple()->setRange( attr, range, src );
+	
+	GA_Size numElements = range.getEntries();
+	if ( numElements < 4 * GA_PAGE_SIZE )
+	{
+		attr->getAIFTuple()->setRange( attr, range, src );
+	}
+	else
+	{
+		// large ranges are written in parallel, in runs of contiguous offsets.
+		std::vector<GA_Offset> offsets;
+		offsets.reserve( numElements );
+		GA_Offset start, end;
+		for ( GA_Iterator it( range ); it.blockAdvance( start, end ); )
+		{
+			for ( GA_Offset o = start; o < end; ++o )
+			{
+				offsets.push_back( o );
+			}
+		}
+		
+		attr->hardenAllPages();
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, offsets.size(), GA_PAGE_SIZE ), SetTupleRanges<BaseType>( attr, offsets, src, dimensions ) );
+	}
 	
 	// set the geometric interpretation if it exists
 	GetInterpretation func = { attrRef };
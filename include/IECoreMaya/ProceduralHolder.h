@@ -94,8 +94,18 @@ class ProceduralHolder : public ParameterisedHolderComponentShape
 		/// Returns runTimeCast<ParameterisedProcedural>( getProcedural( className, classVersion ) ).
 		IECore::ParameterisedProceduralPtr getProcedural( std::string *className = 0, int *classVersion = 0 );
 
-		/// Returns an up to date scene from the procedural
+		/// Returns an up to date scene from the procedural, waiting for any expansion
+		/// started by sceneIfReady() to complete. Scenes are cached by node, procedural class,
+		/// parameter values and time, so returning to previously visited values is cheap.
 		IECoreGL::ConstScenePtr scene();
+		/// As scene(), but if the scene is not already available this starts expanding
+		/// the procedural in a background thread and returns 0, so the caller can draw
+		/// the bound instead. A viewport refresh is scheduled when the expansion completes.
+		IECoreGL::ConstScenePtr sceneIfReady();
+		
+		/// Reimplemented to wait for any background expansion, which may be reading
+		/// the current parameter values.
+		virtual MStatus setParameterisedValues();
 
 		static MObject aGLPreview;
 		static MObject aCulling;
@@ -144,6 +154,8 @@ class ProceduralHolder : public ParameterisedHolderComponentShape
 		
 	private :
 
+		using ParameterisedHolderComponentShape::setParameterisedValues;
+
 		mutable bool m_boundDirty;
 		mutable MBoundingBox m_bound;
 		
@@ -151,6 +163,22 @@ class ProceduralHolder : public ParameterisedHolderComponentShape
 		IECoreGL::ScenePtr m_scene;
 		IECoreGL::RendererPtr m_lastRenderer;
 		
+		/// Expands the procedural into an IECoreGL::Scene on a background thread
+		class SceneBuilder;
+		IE_CORE_DECLAREPTR( SceneBuilder );
+		SceneBuilderPtr m_sceneBuilder;
+		/// Incremented whenever the scene is dirtied, so that results from
+		/// SceneBuilders started before then are not used.
+		unsigned m_sceneGeneration;
+		
+		/// Returns the key used to cache the scene for the current parameter values.
+		IECore::MurmurHash sceneKey( const IECore::ParameterisedProcedural *procedural );
+		/// Waits for m_sceneBuilder if there is one, and takes its result.
+		void waitForSceneBuilder();
+		/// Takes the result of a completed m_sceneBuilder.
+		void finishSceneBuilder();
+		void setScene( IECoreGL::ScenePtr scene );
+		
 		/// \todo Use a boost::multi_index jobby to replace both. It could store a nice
 		/// struct with named fields instead of the hard to understand std::pairs.
 		typedef std::map<IECore::InternedString,  std::pair< unsigned int, IECoreGL::GroupPtr > > ComponentsMap;
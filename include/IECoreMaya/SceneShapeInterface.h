@@ -39,6 +39,7 @@
 #include "IECore/CompoundParameter.h"
 
 #include <map>
+#include "tbb/mutex.h"
 #include "OpenEXR/ImathMatrix.h"
 #include "IECoreGL/IECoreGL.h"
 #include "maya/MPxComponentShape.h"
@@ -205,8 +206,19 @@ class SceneShapeInterface: public MPxComponentShape
 		/// Uses the sceneInterface hierarchy to build a GL Scene matching the preview plug values
 		void buildScene( IECoreGL::RendererPtr renderer, IECore::ConstSceneInterfacePtr subSceneInterface );
 
-		/// Recursively parses the sceneInterface hierarchy to build a GL Scene matching the preview plug values
-		void recurseBuildScene( IECoreGL::Renderer * renderer, const IECore::SceneInterface *subSceneInterface, double time, bool drawBounds, bool drawGeometry, bool objectOnly, const IECore::SceneInterface::NameList &drawTags );
+		/// Recursively parses the sceneInterface hierarchy to build a GL Scene matching the preview plug values.
+		/// Children are emitted as procedurals, so that the renderer reads and converts them in parallel. It
+		/// is therefore called concurrently, and must not access Maya.
+		void recurseBuildScene( IECoreGL::Renderer * renderer, const IECore::SceneInterface *subSceneInterface, const IECore::SceneInterface::Path &rootPath, double time, bool drawBounds, bool drawGeometry, bool objectOnly, const IECore::SceneInterface::NameList &drawTags );
+		
+		IE_CORE_FORWARDDECLARE( LocationProcedural );
+		
+		/// Returns a hash of the scene and preview plug values, or a default hash if
+		/// the SceneInterface doesn't provide hashes we can use to detect changes.
+		IECore::MurmurHash previewSceneHash( const IECore::SceneInterface *scene );
+		/// Reads the object for a location, reusing the object read by the previous
+		/// build if the location's ObjectHash is unchanged.
+		IECore::ConstObjectPtr readPreviewObject( const IECore::SceneInterface *scene, const IECore::InternedString &name, double time );
 
 		void createInstances();
 
@@ -229,6 +241,10 @@ class SceneShapeInterface: public MPxComponentShape
 
 		MStatus computeOutputPlug( const MPlug &plug, const MPlug &topLevelPlug, MDataBlock &dataBlock, const IECore::SceneInterface *scene, int topLevelIndex, int querySpace, MTime &time );
 
+		/// Computes the results for topLevelPlug for all the given paths in a single batch, using the
+		/// SceneInterface bulk read methods, and stores them in m_queryCache for computeOutputPlug().
+		void updateQueryCache( const MPlug &topLevelPlug, const IECore::SceneInterface *scene, const std::vector<IECore::SceneInterface::Path> &paths, double time, int querySpace );
+
 		typedef std::map< IECore::InternedString,  std::pair< unsigned int, IECoreGL::GroupPtr> > NameToGroupMap;
 		typedef std::vector< IECore::InternedString > IndexToNameMap;
 		typedef std::map< IECore::MurmurHash, IECore::InternedString > HashToName;
@@ -239,6 +255,32 @@ class SceneShapeInterface: public MPxComponentShape
 		NameToGroupMap m_nameToGroupMap;
 		HashToName m_hashToName;
 		InstanceArray m_instances;
+		/// Protects m_hashToName and m_instances during recurseBuildScene()
+		tbb::mutex m_instancesMutex;
+		
+		IECore::MurmurHash m_previewSceneHash;
+		
+		/// Query results for a single scene, time and query space. Maya computes the
+		/// output plug elements one at a time in DG mode, so all the queries are
+		/// computed together the first time any one of them is requested.
+		struct QueryCache
+		{
+			QueryCache() : time( 0 ), querySpace( -1 ) {}
+			IECore::ConstSceneInterfacePtr scene;
+			double time;
+			int querySpace;
+			std::map< IECore::SceneInterface::Path, Imath::M44d > transforms;
+			std::map< IECore::SceneInterface::Path, Imath::Box3d > bounds;
+			std::map< IECore::SceneInterface::Path, IECore::ConstObjectPtr > objects;
+		};
+		QueryCache m_queryCache;
+		tbb::mutex m_queryCacheMutex;
+		
+		typedef std::map< IECore::InternedString, std::pair< IECore::MurmurHash, IECore::ConstObjectPtr > > ObjectCache;
+		/// Objects read by the current and previous builds of the preview scene
+		ObjectCache m_objectCache;
+		ObjectCache m_previousObjectCache;
+		tbb::mutex m_objectCacheMutex;
 		
 		IE_CORE_FORWARDDECLARE( PostLoadCallback );
 		PostLoadCallbackPtr m_postLoadCallback;
@@ -38,6 +38,7 @@
 #include "DDImage/Iop.h"
 
 #include "IECore/DisplayDriverServer.h"
+#include "IECore/ImagePrimitive.h"
 
 namespace IECoreNuke
 {
@@ -83,6 +84,14 @@ class DisplayIop : public DD::Image::Iop
 		// and those ops would have missed the display driver creation.
 		unsigned int m_updateCount;
 		IECoreNuke::NukeDisplayDriverPtr m_driver;
+
+		// The image being displayed and the channel data within it, set in _validate()
+		// so that engine() can read straight from the buffers the DisplayDriver writes
+		// into. Holding the image keeps the buffers alive even if the driver changes.
+		IECore::ConstImagePrimitivePtr m_image;
+		const float *m_channelData[4];
+		Imath::Box2i m_dataWindow;
+		Imath::Box2i m_displayWindow;
 		
 };
 
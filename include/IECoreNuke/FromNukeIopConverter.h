@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORENUKE_FROMNUKEIOPCONVERTER_H
+#define IECORENUKE_FROMNUKEIOPCONVERTER_H
+
+#include "DDImage/Iop.h"
+
+#include "IECoreNuke/FromNukeConverter.h"
+
+namespace IECoreNuke
+{
+
+/// The FromNukeIopConverter converts the output of a DD::Image::Iop into an
+/// IECore::ImagePrimitive. Unlike the FromNukeTileConverter it doesn't need
+/// the whole image to be fetched into a DD::Image::Tile first - instead rows
+/// for all the requested channels are fetched from the Iop in parallel, and
+/// written directly into the channels of the result.
+/// \ingroup conversionGroup.
+class FromNukeIopConverter : public FromNukeConverter
+{
+
+	public :
+
+		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( FromNukeIopConverter, FromNukeIopConverterTypeId, FromNukeConverter );
+
+		/// The caller is responsible for ensuring that iop is alive for as
+		/// long as the converter is, and that it has been validated and had
+		/// its channels requested, as it would be before constructing a Tile.
+		FromNukeIopConverter( DD::Image::Iop *iop );
+		virtual ~FromNukeIopConverter();
+
+	protected :
+
+		virtual IECore::ObjectPtr doConversion( IECore::ConstCompoundObjectPtr operands ) const;
+
+	private :
+
+		DD::Image::Iop *m_iop;
+
+};
+
+IE_CORE_DECLAREPTR( FromNukeIopConverter );
+
+} // namespace IECoreNuke
+
+#endif // IECORENUKE_FROMNUKEIOPCONVERTER_H
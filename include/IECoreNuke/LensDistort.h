@@ -148,6 +148,10 @@ class LensDistort : public DD::Image::Iop
 		/// Updates the dynamic knobs. This method should be called whenever a knob is changed or an event happens that requires
 		/// the dynamic knobs to be recreated or their enabled state changed.
 		void updateUI();
+
+		/// Rebuilds m_warpGrid if the lens parameters, mode or bounds have changed since it was last built.
+		/// The grid is computed in parallel, with each task using its own lens model.
+		void updateWarpGrid();
 		
 		/// The maximum number of threads that we are going to use in parallel.
 		const int m_nThreads;
@@ -158,6 +162,12 @@ class LensDistort : public DD::Image::Iop
 		/// locks for each LensModel object
 		DD::Image::Lock* m_locks;
 		
+		/// The distorted position of each pixel within m_warpWindow, clamped to the bounds of the input.
+		/// This is shared by all calls to engine() so that the lens model is only evaluated when the knobs change.
+		std::vector<Imath::V2f> m_warpGrid;
+		Imath::Box2i m_warpWindow;
+		DD::Image::Hash m_warpHash;
+
 		/// A list of the attributes that the plugin uses.
 		PluginAttributeList m_pluginAttributes;
 		
@@ -129,20 +129,24 @@ class SceneCacheReader : public DD::Image::SourceGeo
 		/// Updates the Enumeration_knob of available tags from the internal list of tags
 		/// and updates the currently selected tag to ensure that it is valid.
 		void updateTagFilterKnob();
-		/// Loads a primitive from the scene cache and adds it to the GeometryList.
-		void loadPrimitive( DD::Image::GeometryList &out, const std::string &path );
+		/// Loads the objects at the specified paths from the scene cache, transforming them
+		/// into the space requested by the knobs. The objects are read in parallel and the
+		/// results for each frame and selection are cached so that they can be reused when
+		/// stepping back and forth through time.
+		void loadPrimitives( const std::vector<std::string> &paths, std::vector<IECore::ConstObjectPtr> &objects );
 		/// Get the hash of the file path and root knob.
 		DD::Image::Hash sceneHash() const;
 		/// Get the hash of the SceneView knob (the default hash implementation of that knob returns a constant hash...)
 		DD::Image::Hash selectionHash( bool force = false ) const;
 		
-		Imath::M44d worldTransform( IECore::ConstSceneInterfacePtr scene, IECore::SceneInterface::Path root, double time );
+		static Imath::M44d worldTransform( IECore::ConstSceneInterfacePtr scene, IECore::SceneInterface::Path root, double time );
 
 		// uses firstOp to return the Op that has the up-to-date private data
 		SceneCacheReader *firstReader();
 		const SceneCacheReader *firstReader() const;
 
 		class SharedData;
+		class ObjectLoader;
 
 		// this function should only be called from the firstReader() object.
 		SharedData *sharedData();
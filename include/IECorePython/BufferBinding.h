@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECOREPYTHON_BUFFERBINDING_H
+#define IECOREPYTHON_BUFFERBINDING_H
+
+#include "boost/python.hpp"
+
+#include "IECore/Data.h"
+
+#include "IECorePython/Export.h"
+
+namespace IECorePython
+{
+
+/// A Python object exposing the memory of a VectorTypedData via the
+/// buffer protocol, so that it may be viewed by other modules (such as
+/// numpy) without copying. Buffers are created by the toBuffer() method
+/// of the VectorTypedData bindings, and hold a reference to the data, which
+/// is therefore kept alive for as long as the buffer is. The data must not
+/// be resized while the buffer is in use.
+class IECOREPYTHON_API Buffer
+{
+
+	public :
+
+		/// Creates a buffer of numElements elements, each made of numComponents
+		/// values of the specified format and size. If writable is true, then
+		/// address must have been obtained from data->baseWritable().
+		Buffer( IECore::ConstDataPtr data, const void *address, size_t numElements, size_t numComponents, const char *format, size_t itemSize, bool writable );
+
+		IECore::ConstDataPtr data() const;
+		bool isWritable() const;
+
+		/// Implements the buffer protocol for the python object
+		/// wrapping this buffer.
+		int getBuffer( PyObject *exporter, Py_buffer *view, int flags );
+
+	private :
+
+		IECore::ConstDataPtr m_data;
+		const void *m_address;
+		const char *m_format;
+		Py_ssize_t m_itemSize;
+		bool m_writable;
+		int m_ndim;
+		Py_ssize_t m_shape[2];
+		Py_ssize_t m_strides[2];
+
+};
+
+/// Returns true if the format of a buffer (as specified in the Py_buffer
+/// structure) is compatible with a native type of the specified format
+/// and size.
+IECOREPYTHON_API bool compatibleBufferFormat( const char *format, Py_ssize_t itemSize, const char *nativeFormat, Py_ssize_t nativeItemSize );
+
+IECOREPYTHON_API void bindBuffer();
+
+} // namespace IECorePython
+
+#endif // IECOREPYTHON_BUFFERBINDING_H
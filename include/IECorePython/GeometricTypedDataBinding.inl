@@ -108,7 +108,7 @@ class GeometricVectorTypedDataFunctions : ThisBinder
 		static ThisClassPtr
 		dataListOrSizeConstructorAndInterpretation( boost::python::object v, IECore::GeometricData::Interpretation i )
 		{
-			ThisClassPtr r = ThisBinder::dataListOrSizeConstructor( v );
+			ThisClassPtr r = ThisBinder::dataListSizeOrBufferConstructor( v );
 			r->setInterpretation( i );
 			return r;
 		}
@@ -212,6 +212,7 @@ class GeometricVectorTypedDataFunctions : ThisBinder
 			RunTimeTypedClass<TypedData< std::vector< T > > >(); \
 			\
 			BASIC_VECTOR_BINDING(GeometricTypedData< std::vector< T > >, Tname) \
+				VECTOR_BUFFER_BINDING(Tname) \
 				/* operators modified from BIND_OPERATED_VECTOR_TYPEDDATA */ \
 				.def("__getitem__", &ThisGeometricBinder::getItem, "indexing operator.\nAccept an integer index (starting from 0), slices and negative indexes too.") \
 				.def("__add__", &ThisGeometricBinder::add, "addition (s + v) : accepts another vector of the same type or a single " Tname) \
@@ -37,12 +37,40 @@
 
 #include "IECorePython/IECoreBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/BufferBinding.h"
 
+#include <cstring>
 #include <sstream>
 
 namespace IECorePython
 {
 
+/// Specifies the python buffer format used for the base types
+/// of the numeric VectorTypedData classes.
+template<typename T>
+struct BufferFormat;
+
+#define IECOREPYTHON_DEFINEBUFFERFORMAT( TYPE, FORMAT ) \
+template<> \
+struct BufferFormat<TYPE> \
+{ \
+	static const char *format() { return FORMAT; } \
+};
+
+IECOREPYTHON_DEFINEBUFFERFORMAT( half, "e" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( float, "f" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( double, "d" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( int, "i" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( unsigned int, "I" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( char, "b" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( unsigned char, "B" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( short, "h" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( unsigned short, "H" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( int64_t, "q" )
+IECOREPYTHON_DEFINEBUFFERFORMAT( uint64_t, "Q" )
+
+#undef IECOREPYTHON_DEFINEBUFFERFORMAT
+
 template<typename ThisClass>
 class VectorTypedDataFunctions
 {
@@ -82,6 +110,71 @@ class VectorTypedDataFunctions
 			}
 		}
 
+		/// constructor that accepts an object supporting the buffer protocol in
+		/// addition to the arguments accepted by dataListOrSizeConstructor(). Only
+		/// available for numeric types.
+		static ThisClassPtr
+		dataListSizeOrBufferConstructor( boost::python::object v )
+		{
+			ThisClassPtr r = dataFromBuffer( v );
+			if( r )
+			{
+				return r;
+			}
+			return dataListOrSizeConstructor( v );
+		}
+
+		/// Creates new data from an object supporting the buffer protocol,
+		/// copying the memory in one go rather than converting element by
+		/// element. Returns 0 if the object doesn't support the protocol, or
+		/// if its format doesn't match our base type, in which case the caller
+		/// must fall back to element-wise conversion. Only available for
+		/// numeric types.
+		static ThisClassPtr
+		dataFromBuffer( boost::python::object v )
+		{
+			typedef typename ThisClass::BaseType BaseType;
+
+			if( !PyObject_CheckBuffer( v.ptr() ) )
+			{
+				return 0;
+			}
+
+			Py_buffer view;
+			if( PyObject_GetBuffer( v.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT ) == -1 )
+			{
+				PyErr_Clear();
+				return 0;
+			}
+
+			ThisClassPtr r = 0;
+			if(
+				compatibleBufferFormat( view.format, view.itemsize, BufferFormat<BaseType>::format(), sizeof( BaseType ) ) &&
+				view.len % sizeof( data_type ) == 0
+			)
+			{
+				r = new ThisClass();
+				Container &data = r->writable();
+				data.resize( view.len / sizeof( data_type ) );
+				if( data.size() )
+				{
+					memcpy( &data[0], view.buf, view.len );
+				}
+			}
+
+			PyBuffer_Release( &view );
+			return r;
+		}
+
+		/// Returns a Buffer object exposing our memory via the python
+		/// buffer protocol. Only available for numeric types.
+		static Buffer toBuffer( ThisClass &x, bool writable )
+		{
+			typedef typename ThisClass::BaseType BaseType;
+			const void *address = writable ? x.baseWritable() : x.baseReadable();
+			return Buffer( &x, address, x.readable().size(), sizeof( data_type ) / sizeof( BaseType ), BufferFormat<BaseType>::format(), sizeof( BaseType ), writable );
+		}
+
 		//
 		static iterator begin( ThisClass &x )
 		{
@@ -697,6 +790,17 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 			.def("__str__", &str<ThisClass> )	\
 			.def("__repr__", &repr<ThisClass> )	\
 
+// bind the buffer protocol methods of a numeric VectorTypedData class
+#define VECTOR_BUFFER_BINDING(Tname) \
+			.def("__init__", make_constructor(&ThisBinder::dataListSizeOrBufferConstructor), \
+						 "Accepts another vector of the same class, a python list containing " Tname \
+						 "\nor any other python built-in type that is convertible to it, or an object supporting the buffer protocol\n" \
+						 "with a matching format, such as a numpy array. Alternatively accepts the size of the new vector.") \
+			.def("toBuffer", &ThisBinder::toBuffer, ( boost::python::arg( "writable" ) = false ), \
+						 "Returns an IECore.Buffer object exposing the memory of the vector via the python buffer protocol,\n" \
+						 "allowing it to be viewed without copying, for instance using numpy.asarray(). If writable is True,\n" \
+						 "the data is made unique first, so that modifications via the buffer don't affect existing copies.") \
+
 // bind a VectorTypedData class that does not support Math operators
 #define BIND_VECTOR_TYPEDDATA(T, Tname)													\
 		{																							\
@@ -709,6 +813,7 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 #define BIND_SIMPLE_OPERATED_VECTOR_TYPEDDATA(T, Tname)									\
 		{																							\
 			BASIC_VECTOR_BINDING(TypedData< std::vector< T > >, Tname)																	\
+				VECTOR_BUFFER_BINDING(Tname)																	\
 				/* operators */																			\
 				.def("__add__", &ThisBinder::add, "addition (s + v) : accepts another vector of the same type or a single " Tname)						\
 				.def("__iadd__", &ThisBinder::iadd, "inplace addition (s += v) : accepts another vector of the same type or a single " Tname)			\
@@ -725,6 +830,7 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 #define BIND_OPERATED_VECTOR_TYPEDDATA(T, Tname)											\
 		{																							\
 			BASIC_VECTOR_BINDING(TypedData< std::vector< T > >, Tname)																	\
+				VECTOR_BUFFER_BINDING(Tname)																	\
 				/* operators */																			\
 				.def("__add__", &ThisBinder::add, "addition (s + v) : accepts another vector of the same type or a single " Tname)						\
 				.def("__iadd__", &ThisBinder::iadd, "inplace addition (s += v) : accepts another vector of the same type or a single " Tname)			\
@@ -743,6 +849,7 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 #define BIND_FULL_OPERATED_VECTOR_TYPEDDATA(T, Tname)											\
 		{																							\
 			BASIC_VECTOR_BINDING(TypedData< std::vector< T > >, Tname)																	\
+				VECTOR_BUFFER_BINDING(Tname)																	\
 				/* operators */																			\
 				.def("__add__", &ThisBinder::add, "addition (s + v) : accepts another vector of the same type or a single " Tname)						\
 				.def("__iadd__", &ThisBinder::iadd, "inplace addition (s += v) : accepts another vector of the same type or a single " Tname)			\
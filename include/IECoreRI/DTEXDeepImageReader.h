@@ -35,6 +35,8 @@
 #ifndef IECORERI_DTEXDEEPIMAGEREADER_H
 #define IECORERI_DTEXDEEPIMAGEREADER_H
 
+#include "boost/shared_ptr.hpp"
+
 #include "RixDeepTexture.h"
 
 #include "IECore/CompoundObject.h"
@@ -46,6 +48,13 @@
 namespace IECoreRI
 {
 
+namespace Detail
+{
+
+class DeepTileCache;
+
+} // namespace Detail
+
 /// The DTEXDeepImageReader class reads PRMan deep texture files. Note that it will only
 /// read the first RixDeepTexture::DeepImage in the RixDeepTexture::DeepFile.
 /// \ingroup deepCompositingGroup
@@ -73,6 +82,7 @@ class IECORERI_API DTEXDeepImageReader : public IECore::DeepImageReader
 	protected :
 
 		virtual IECore::DeepPixelPtr doReadPixel( int x, int y );
+		virtual IECore::DeepImageBlockPtr doReadBlock( const Imath::Box2i &region );
 
 	private :
 
@@ -82,6 +92,11 @@ class IECORERI_API DTEXDeepImageReader : public IECore::DeepImageReader
 		/// all of the private members will be valid. If throwOnFailure is true then a descriptive
 		/// Exception is thrown rather than false being returned.
 		bool open( bool throwOnFailure = false );
+		/// Appends the samples for the specified pixel to the samples vector, each sample
+		/// being a depth followed by the channel values. Returns the number of samples appended.
+		unsigned readSamples( int x, int y, std::vector<float> &samples );
+		/// Reads a block directly from the file. Used by m_tileCache to fill its tiles.
+		IECore::DeepImageBlockPtr readTile( const Imath::Box2i &region );
 		void cleanRixInterface();
 		
 		RixDeepTexture::DeepFile *m_inputFile;
@@ -93,6 +108,7 @@ class IECORERI_API DTEXDeepImageReader : public IECore::DeepImageReader
 		Imath::M44f m_worldToNDC;
 		std::string m_inputFileName;
 		std::string m_channelNames;
+		boost::shared_ptr<Detail::DeepTileCache> m_tileCache;
 
 };
 
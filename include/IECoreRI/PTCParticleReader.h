@@ -36,7 +36,9 @@
 #define IE_CORERI_PTCPARTICLEREADER_H
 
 #include "IECore/CompoundData.h"
+#include "IECore/MurmurHash.h"
 #include "IECore/ParticleReader.h"
+#include "IECore/SimpleTypedParameter.h"
 #include "IECore/VectorTypedData.h"
 #include "IECoreRI/Export.h"
 #include "IECoreRI/TypeIds.h"
@@ -46,7 +48,10 @@ namespace IECoreRI
 {
 
 /// The PTCParticleReader class implements the ParticleReader
-/// interface for Renderman .ptc format particle caches.
+/// interface for Renderman .ptc format particle caches. Only the
+/// requested attributes are decoded, and particles rejected by the
+/// percentage and bound parameters are discarded as the file is read,
+/// so the full cache is never held in memory.
 /// \ingroup ioGroup
 class IECORERI_API PTCParticleReader : public IECore::ParticleReader
 {
@@ -60,9 +65,20 @@ class IECORERI_API PTCParticleReader : public IECore::ParticleReader
 
 		static bool canRead( const std::string &fileName );
 
+		/// Particles outside this bound are discarded while reading. The
+		/// default empty bound disables the test.
+		IECore::Box3fParameter *boundParameter();
+		const IECore::Box3fParameter *boundParameter() const;
+
 		virtual unsigned long numParticles();
 		virtual void attributeNames( std::vector<std::string> &names );
 		virtual IECore::DataPtr readAttribute( const std::string &name );
+		/// The file can only be read sequentially, so all the attributes
+		/// named by attributesParameter() are read for the range in a single
+		/// pass, and kept until a different range is requested. This makes
+		/// readRange() cost a single pass over the range, and consecutive
+		/// ranges continue from the current position in the file.
+		virtual IECore::DataPtr readAttributeRange( const std::string &name, size_t begin, size_t end );
 
 	protected :
 
@@ -79,7 +95,13 @@ class IECORERI_API PTCParticleReader : public IECore::ParticleReader
 
 		static const ReaderDescription<PTCParticleReader> m_readerDescription;
 
+		void constructParameters();
+
+		IECore::Box3fParameterPtr m_boundParameter;
+
 		void *m_ptcFile;
+		// index of the point the next call to PtcReadDataPoint() will return.
+		size_t m_nextPoint;
 
 		// makes sure that m_ptcFile is open.
 		// returns true on success and false on failure.
@@ -100,8 +122,12 @@ class IECORERI_API PTCParticleReader : public IECore::ParticleReader
 		struct PTCParticleIO::PTCHeader m_header;
 		float *m_userDataBuffer;
 
-		// reads several attributes in one operation and returns them in a CompoundData.
-		IECore::CompoundDataPtr readAttributes( const std::vector<std::string> &names );
+		// reads several attributes for the points in [begin, end) in one operation
+		// and returns them in a CompoundData.
+		IECore::CompoundDataPtr readAttributes( const std::vector<std::string> &names, size_t begin, size_t end );
+
+		IECore::MurmurHash m_rangeHash;
+		IECore::CompoundDataPtr m_rangeAttributes;
 };
 
 IE_CORE_DECLAREPTR( PTCParticleReader );
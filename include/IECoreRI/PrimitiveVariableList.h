@@ -52,13 +52,15 @@ class IECORERI_API PrimitiveVariableList
 		/// Construct a new PrimitiveVariableList given some PrimitiveVariables
 		/// in a map. Note that the PrimitiveVariableList refers to data within
 		/// the primVars object, and expects that data to exist for as long
-		/// as you still use the PrimitiveVariableList (it doesn't copy the list
-		/// for efficiency reasons). If provided, the typeHints map is used
+		/// as you still use the PrimitiveVariableList (it doesn't copy the
+		/// data for efficiency reasons, and the tokens are shared between all
+		/// lists). If provided, the typeHints map is used
 		/// to resolve the type of ambiguous types such as V3fVectorData, which
 		/// could represent points, normals or vectors. The typeHints map
 		/// simply maps from the name of the primitive variable to the
 		/// Renderman type token. It too is expected to exist for as long
-		/// as you still use the PrimitiveVariableList.
+		/// as you still use the PrimitiveVariableList. Indexed primitive
+		/// variables are expanded, and the expanded data is owned by the list.
 		///
 		/// TODO - typeHints is now unused and should be removed
 		PrimitiveVariableList( const IECore::PrimitiveVariableMap &primVars,
@@ -78,14 +80,14 @@ class IECORERI_API PrimitiveVariableList
 
 	private :
 
-		const char *type( const std::string &name, IECore::ConstDataPtr d, size_t &arraySize );
+		const char *type( const std::string &name, const IECore::Data *d, size_t &arraySize );
 		const char *interpolation( IECore::PrimitiveVariable::Interpolation i );
-		const void *value( IECore::DataPtr d );
+		const void *value( const IECore::Data *d );
 
-		std::vector<std::string> m_strings;
 		std::vector<const char *> m_tokens;
 		std::vector<const void *> m_values;
 		std::vector<const char *> m_charPtrs;
+		std::vector<IECore::ConstDataPtr> m_expandedData;
 
 };
 
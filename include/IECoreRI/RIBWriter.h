@@ -68,6 +68,12 @@ class IECORERI_API RIBWriter : public IECore::Writer
 		IECore::BoolParameterPtr worldBlockParameter();
 		IECore::ConstBoolParameterPtr worldBlockParameter() const;
 
+		IECore::BoolParameterPtr binaryParameter();
+		IECore::ConstBoolParameterPtr binaryParameter() const;
+
+		IECore::BoolParameterPtr compressParameter();
+		IECore::ConstBoolParameterPtr compressParameter() const;
+
 	protected :
 
 		virtual void doWrite( const IECore::CompoundObject *operands );
@@ -77,6 +83,8 @@ class IECORERI_API RIBWriter : public IECore::Writer
 		void constructParameters();
 
 		IECore::BoolParameterPtr m_worldBlockParameter;
+		IECore::BoolParameterPtr m_binaryParameter;
+		IECore::BoolParameterPtr m_compressParameter;
 
 		static const WriterDescription<RIBWriter> g_writerDescription;
 
@@ -89,6 +89,13 @@ class IECORERI_API Renderer : public IECore::Renderer
 		/// Specifies the frame number for RiFrameBegin. If not specified,
 		/// then no frame block will be output.
 		///
+		/// \li <b>"ri:rib:format" StringData()</b></br>
+		/// \li <b>"ri:rib:compression" StringData()</b></br>
+		/// Passed to an RiOption( "rib", ... ) call as soon as they are set, so
+		/// should be set before anything else. Use "binary" and "gzip" respectively
+		/// for compact RIB output. Compression is turned on automatically when the
+		/// Renderer was constructed with a filename ending in ".gz".
+		///
 		/// \li <b>"ri:*:*"</b><br>
 		/// Passed to an RiOption call.
 		virtual void setOption( const std::string &name, IECore::ConstDataPtr value );
@@ -98,6 +105,10 @@ class IECORERI_API Renderer : public IECore::Renderer
 		/// "camera:shutter"
 		///	"shutter"	V2fData()
 		/// "user:*"
+		/// "ri:automaticInstancing:statistics" CompoundData
+		/// Reports the number of automatic "instances" created, the number of
+		/// "reuses" of them, and the "memorySaved" in bytes by not emitting the
+		/// reused geometry. Statistics are shared with any procedurals.
 		/// "ri:*" Queries of this form use the Rx API and therefore only work
 		/// for options supported by that API.
 		virtual IECore::ConstDataPtr getOption( const std::string &name ) const;
@@ -188,7 +199,8 @@ class IECORERI_API Renderer : public IECore::Renderer
 		/// Passed to RiTextureCoordinates.
 		/// \li <b>"ri:automaticInstancing" BoolData</b><br>
 		/// When this is true, all primitives are rendered as instances, and if a previously rendered
-		/// primitive is encountered, the instance will simply be reused.
+		/// primitive is encountered, the instance will simply be reused. Primitives are identified
+		/// by Object::hash(), and instances are shared with procedurals.
 		virtual void setAttribute( const std::string &name, IECore::ConstDataPtr value );
 		/// \par Currently supported attributes :
 		///
@@ -35,6 +35,8 @@
 #ifndef IECORERI_SHWDEEPIMAGEREADER_H
 #define IECORERI_SHWDEEPIMAGEREADER_H
 
+#include "boost/shared_ptr.hpp"
+
 #include "dtex.h"
 
 #include "IECore/DeepImageReader.h"
@@ -45,6 +47,13 @@
 namespace IECoreRI
 {
 
+namespace Detail
+{
+
+class DeepTileCache;
+
+} // namespace Detail
+
 /// The SHWDeepImageReader class reads 3delight deep shadow files. Note that this is an Alpha-only format.
 /// \ingroup deepCompositingGroup
 /// \ingroup ioGroup
@@ -71,6 +80,7 @@ class IECORERI_API SHWDeepImageReader : public IECore::DeepImageReader
 	protected :
 
 		virtual IECore::DeepPixelPtr doReadPixel( int x, int y );
+		virtual IECore::DeepImageBlockPtr doReadBlock( const Imath::Box2i &region );
 
 	private :
 
@@ -80,6 +90,11 @@ class IECORERI_API SHWDeepImageReader : public IECore::DeepImageReader
 		/// all of the private members will be valid. If throwOnFailure is true then a descriptive
 		/// Exception is thrown rather than false being returned.
 		bool open( bool throwOnFailure = false );
+		/// Appends the samples for the specified pixel to the samples vector, each sample
+		/// being a depth followed by the channel values. Returns the number of samples appended.
+		unsigned readSamples( int x, int y, std::vector<float> &samples );
+		/// Reads a block directly from the file. Used by m_tileCache to fill its tiles.
+		IECore::DeepImageBlockPtr readTile( const Imath::Box2i &region );
 		void clean();
 		
 		DtexFile *m_inputFile;
@@ -93,6 +108,7 @@ class IECORERI_API SHWDeepImageReader : public IECore::DeepImageReader
 		Imath::M44f m_NDCToCamera;
 		std::string m_inputFileName;
 		std::string m_channelNames;
+		boost::shared_ptr<Detail::DeepTileCache> m_tileCache;
 
 };
 
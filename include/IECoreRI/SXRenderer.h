@@ -126,6 +126,11 @@ class IECORERI_API SXRenderer : public IECore::Renderer
 		//@{
 		IECore::CompoundDataPtr shade( const IECore::CompoundData *points ) const;
 		IECore::CompoundDataPtr shade( const IECore::CompoundData *points, const Imath::V2i &gridSize ) const;
+		/// Shades a large number of points in parallel, by splitting them into batches of
+		/// whole grids containing roughly batchSize points each. If batchSize is 0 then a size
+		/// is chosen automatically. The results are written into result, reusing any existing
+		/// members of the right type so that repeated calls needn't reallocate.
+		void shade( const IECore::CompoundData *points, const Imath::V2i &gridSize, IECore::CompoundData *result, size_t batchSize = 0 ) const;
 		/// This method shades a plane, of the specified resolution and returns the shaded points as a
 		/// CompoundData object pointer filled as above.
 		IECore::CompoundDataPtr shadePlane( const Imath::V2i &resolution ) const;
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORERI_DEEPTILECACHE_H
+#define IECORERI_DEEPTILECACHE_H
+
+#include "boost/function.hpp"
+#include "boost/noncopyable.hpp"
+
+#include "tbb/mutex.h"
+
+#include "IECore/DeepImageBlock.h"
+#include "IECore/LRUCache.h"
+
+namespace IECoreRI
+{
+
+namespace Detail
+{
+
+/// Caches the samples of a deep image in fixed size tiles, so that readers
+/// backed by per-pixel APIs only fetch each pixel from the file once, whether
+/// it is requested individually or as part of a block.
+class DeepTileCache : boost::noncopyable
+{
+
+	public :
+
+		/// Returns the samples for every pixel in the region. Calls are serialised
+		/// by the cache, so the function need not be threadsafe.
+		typedef boost::function<IECore::DeepImageBlockPtr ( const Imath::Box2i &region )> TileReader;
+
+		DeepTileCache( const Imath::Box2i &dataWindow, TileReader tileReader, int tileSize = 32, size_t maxBytes = 256 * 1024 * 1024 );
+
+		/// Returns the pixel, or 0 if it has no samples.
+		IECore::DeepPixelPtr readPixel( int x, int y );
+		/// Returns a block for the region, assembled from the tiles it overlaps.
+		/// Missing tiles are loaded in parallel, and the samples are copied into
+		/// the block a scanline at a time in parallel.
+		IECore::DeepImageBlockPtr readBlock( const Imath::Box2i &region );
+
+	private :
+
+		typedef IECore::LRUCache<int, IECore::ConstDeepImageBlockPtr> Cache;
+
+		IECore::ConstDeepImageBlockPtr readTile( int index, size_t &cost );
+		/// Tiles are aligned to the origin of the data window.
+		Imath::V2i tile( int x, int y ) const;
+		int tileIndex( const Imath::V2i &tile ) const;
+
+		struct LoadTiles;
+		struct CopyScanlines;
+
+		Imath::Box2i m_dataWindow;
+		TileReader m_tileReader;
+		int m_tileSize;
+		int m_numTilesX;
+		tbb::mutex m_readerMutex;
+		Cache m_cache;
+
+};
+
+} // namespace Detail
+
+} // namespace IECoreRI
+
+#endif // IECORERI_DEEPTILECACHE_H
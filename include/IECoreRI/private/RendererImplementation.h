@@ -156,12 +156,26 @@ class IECORERI_API RendererImplementation : public IECore::Renderer
 			// accessed from multiple threads when running threaded procedurals
 			typedef tbb::recursive_mutex ObjectHandlesMutex;
 			ObjectHandlesMutex objectHandlesMutex;
+			// Statistics for automatic instancing, also protected by
+			// objectHandlesMutex. The memory usage of each automatic
+			// instance is stored so we can report how much geometry
+			// was saved by reusing it.
+			typedef std::map<std::string, size_t> InstanceMemoryMap;
+			InstanceMemoryMap automaticInstanceMemory;
+			size_t automaticInstanceReuses;
+			size_t automaticInstanceMemorySaved;
 #ifdef IECORERI_WITH_NSI
 			SharedData()
-				:	handleGenerator( boost::make_shared<NSI::HandleGenerator>() )
+				:	automaticInstanceReuses( 0 ), automaticInstanceMemorySaved( 0 ),
+					handleGenerator( boost::make_shared<NSI::HandleGenerator>() )
 			{
 			}
 			NSI::HandleGeneratorPtr handleGenerator;
+#else
+			SharedData()
+				:	automaticInstanceReuses( 0 ), automaticInstanceMemorySaved( 0 )
+			{
+			}
 #endif
 		};
 				
@@ -199,6 +213,7 @@ class IECORERI_API RendererImplementation : public IECore::Renderer
 		IECore::ConstDataPtr getFontSearchPathOption( const std::string &name ) const;
 		IECore::ConstDataPtr getShutterOption( const std::string &name ) const;
 		IECore::ConstDataPtr getResolutionOption( const std::string &name ) const;
+		IECore::ConstDataPtr getAutomaticInstancingStatisticsOption( const std::string &name ) const;
 		IECore::ConstDataPtr getRxOption( const char *name ) const;
 
 		IECore::CompoundDataPtr m_options;
@@ -302,6 +317,9 @@ class IECORERI_API RendererImplementation : public IECore::Renderer
 		
 		void addPrimitive( IECore::ConstPrimitivePtr primitive );
 		
+		// Emits an ObjectInstance for each point of an "instancer" geometry.
+		void instancer( const IECore::CompoundDataMap &topology, const IECore::PrimitiveVariableMap &primVars );
+
 		void emitPrimitiveAttributes( const IECore::Primitive *primitive );
 		void emitCurvesPrimitiveAttributes( const IECore::CurvesPrimitive *primitive );
 		void emitPatchMeshPrimitiveAttributes( const IECore::PatchMeshPrimitive *primitive );
@@ -349,6 +367,9 @@ class IECORERI_API RendererImplementation : public IECore::Renderer
 		/// instances. So when auto-instancing is on, we queue up primitives in here, and turn them into an instance
 		/// at motionEnd().
 		std::vector<IECore::ConstPrimitivePtr> m_motionPrimitives;
+		/// Emits an ObjectInstance for the automatic instance with the specified name, returning
+		/// false if it doesn't exist yet. Must be called with objectHandlesMutex held.
+		bool reuseAutomaticInstance( const std::string &instanceName );
 
 };
 
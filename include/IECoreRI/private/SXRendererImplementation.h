@@ -116,6 +116,7 @@ class IECORERI_API SXRendererImplementation : public IECore::Renderer
 		
 		IECore::CompoundDataPtr shade( const IECore::CompoundData *points ) const;
 		IECore::CompoundDataPtr shade( const IECore::CompoundData *points, const Imath::V2i &gridSize ) const;
+		void shade( const IECore::CompoundData *points, const Imath::V2i &gridSize, IECore::CompoundData *result, size_t batchSize ) const;
 		IECore::CompoundDataPtr shadePlane( const Imath::V2i &resolution ) const;
 		IECore::ImagePrimitivePtr shadePlaneToImage( const Imath::V2i &resolution ) const;
 	
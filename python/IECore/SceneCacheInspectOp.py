@@ -0,0 +1,190 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+from IECore import *
+
+class SceneCacheInspectOp( Op ) :
+
+	def __init__( self ) :
+
+		Op.__init__( self, "Reports how a SceneCache file is stored, and optionally how quickly it can be read.",
+			StringParameter(
+				name = "result",
+				description = "A report of the file statistics.",
+				defaultValue = "",
+			)
+		)
+
+		self.parameters().addParameters(
+
+			[
+				FileNameParameter(
+					name = "file",
+					description = "The SceneCache file to inspect.",
+					defaultValue = "",
+					check = FileNameParameter.CheckType.MustExist,
+					extensions = "scc",
+					allowEmptyString = False,
+				),
+
+				IntParameter(
+					name = "maxLocations",
+					description = "The number of locations to list individually, largest first. "
+						"Use 0 to list none.",
+					defaultValue = 10,
+					minValue = 0,
+				),
+
+				BoolParameter(
+					name = "profileReads",
+					description = "Replays a traversal of the scene, reporting the latency of each read.",
+					defaultValue = False,
+				),
+
+				FloatParameter(
+					name = "time",
+					description = "The time at which to replay the traversal.",
+					defaultValue = 0,
+				),
+
+				IntVectorParameter(
+					name = "threadCounts",
+					description = "The thread counts to replay the traversal with. A count of 0 "
+						"uses the default number of threads.",
+					defaultValue = IntVectorData( [ 1, 0 ] ),
+				),
+			]
+		)
+
+		self.userData()["UI"] = CompoundObject(
+									{
+										"showResult": BoolData( True ),
+										"closeAfterExecution": BoolData( True ),
+									}
+								)
+
+	def doOperation( self, operands ) :
+
+		fileName = operands["file"].value
+		storage = SceneCacheAlgo.storageStatistics( fileName, operands["maxLocations"].value > 0 )
+
+		lines = []
+
+		file = storage["file"]
+		lines.append( "File : %s" % fileName )
+		lines.append( "  version : %d" % file["version"].value )
+		lines.append( "  fileSize : %s" % self.__formatBytes( file["fileSize"].value ) )
+		lines.append( "  indexSize : %s" % self.__formatBytes( file["indexSize"].value ) )
+		lines.append( "  stringTable : %d strings, %s" % ( file["numStrings"].value, self.__formatBytes( file["stringTableSize"].value ) ) )
+
+		totals = storage["totals"]
+		lines.append( "" )
+		lines.append( "Totals : %d locations, max depth %d" % ( totals["locations"].value, totals["maxDepth"].value ) )
+		lines.append( "  stored : %s, unique : %s, data : %s, ratio : %s" % (
+			self.__formatBytes( totals["storedSize"].value ),
+			self.__formatBytes( totals["uniqueStoredSize"].value ),
+			self.__formatBytes( totals["dataSize"].value ),
+			self.__formatRatio( totals["dataSize"].value, totals["storedSize"].value ),
+		) )
+		self.__formatEntries( totals, lines )
+
+		if "locations" in storage :
+
+			locations = storage["locations"]
+			paths = sorted( locations.keys(), key = lambda p : locations[p]["storedSize"].value, reverse = True )
+			paths = paths[:operands["maxLocations"].value]
+
+			lines.append( "" )
+			lines.append( "Largest locations :" )
+			for path in paths :
+				location = locations[path]
+				lines.append( "  %s : stored %s, ratio %s" % (
+					path,
+					self.__formatBytes( location["storedSize"].value ),
+					self.__formatRatio( location["dataSize"].value, location["storedSize"].value ),
+				) )
+				self.__formatEntries( location, lines, "    " )
+
+		if operands["profileReads"].value :
+
+			reads = SceneCacheAlgo.readStatistics( fileName, operands["time"].value, list( operands["threadCounts"] ) )
+			for count in operands["threadCounts"] :
+				threadResult = reads[str(count)]
+				lines.append( "" )
+				lines.append( "Reads with %d threads : wall time %.4fs" % ( threadResult["threads"].value, threadResult["wallTime"].value ) )
+				for call in ( "child", "readBound", "readTransformAsMatrix", "readAttribute", "readObject" ) :
+					c = threadResult[call]
+					lines.append( "  %-22s calls %8d  total %.4fs  mean %.6fs  median %.6fs  p95 %.6fs  max %.6fs" % (
+						call,
+						c["calls"].value, c["totalTime"].value, c["meanTime"].value,
+						c["medianTime"].value, c["p95Time"].value, c["maxTime"].value
+					) )
+
+		return StringData( "\n".join( lines ) )
+
+	@staticmethod
+	def __formatEntries( statistics, lines, indent = "  " ) :
+
+		for name in sorted( statistics.keys() ) :
+			entry = statistics[name]
+			if not isinstance( entry, CompoundData ) :
+				continue
+			lines.append( "%s%-24s samples %8d  entries %8d  stored %10s  data %10s  ratio %s" % (
+				indent, name,
+				entry["samples"].value, entry["entries"].value,
+				SceneCacheInspectOp.__formatBytes( entry["storedSize"].value ),
+				SceneCacheInspectOp.__formatBytes( entry["dataSize"].value ),
+				SceneCacheInspectOp.__formatRatio( entry["dataSize"].value, entry["storedSize"].value ),
+			) )
+
+	@staticmethod
+	def __formatBytes( numBytes ) :
+
+		for unit in ( "B", "KB", "MB" ) :
+			if numBytes < 1024 :
+				return "%d%s" % ( numBytes, unit ) if unit == "B" else "%.1f%s" % ( numBytes, unit )
+			numBytes /= 1024.0
+
+		return "%.1fGB" % numBytes
+
+	@staticmethod
+	def __formatRatio( dataSize, storedSize ) :
+
+		if not storedSize :
+			return "-"
+
+		return "%.2f" % ( float( dataSize ) / storedSize )
+
+registerRunTimeTyped( SceneCacheInspectOp )
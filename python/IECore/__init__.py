@@ -82,6 +82,7 @@ from PointsExpressionOp import PointsExpressionOp
 from Struct import Struct
 import Enum
 from LsHeaderOp import LsHeaderOp
+from SceneCacheInspectOp import SceneCacheInspectOp
 from curry import curry
 from MenuItemDefinition import MenuItemDefinition
 from MenuDefinition import MenuDefinition
@@ -0,0 +1,274 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "tbb/atomic.h"
+#include "tbb/concurrent_queue.h"
+#include "tbb/tbb_thread.h"
+#include "tbb/tick_count.h"
+
+#include "boost/bind.hpp"
+#include "boost/format.hpp"
+#include "boost/tuple/tuple.hpp"
+#include "boost/tuple/tuple_comparison.hpp"
+
+#include "IECore/AsyncMessageHandler.h"
+
+#include <map>
+
+using namespace std;
+using namespace IECore;
+
+namespace
+{
+
+struct QueueEntry
+{
+
+	enum Type
+	{
+		Message,
+		Flush,
+		Stop
+	};
+
+	QueueEntry()
+		:	type( Message ), level( MessageHandler::Invalid ), flushed( 0 )
+	{
+	}
+
+	Type type;
+	MessageHandler::Level level;
+	std::string context;
+	std::string message;
+	// Set by the writer thread once a Flush entry has been processed.
+	tbb::atomic<bool> *flushed;
+
+};
+
+typedef boost::tuple<MessageHandler::Level, std::string, std::string> MessageKey;
+// Maps from the messages output since the last flush to the
+// number of times they have been repeated since.
+typedef std::map<MessageKey, size_t> RepeatMap;
+
+// Bounds the memory used for deduplication, should a great
+// many distinct messages be emitted.
+const size_t g_maxRepeatMapSize = 10000;
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////
+// Data
+///////////////////////////////////////////////////////////////////////////////////////
+
+struct AsyncMessageHandler::Data
+{
+
+	Data( MessageHandler *handler, size_t maxMessagesPerSecond, size_t queueCapacity )
+		:	handler( handler ), maxMessagesPerSecond( maxMessagesPerSecond ), windowStart( tbb::tick_count::now() ), windowCount( 0 ), rateLimited( 0 )
+	{
+		queue.set_capacity( std::max( queueCapacity, (size_t)1 ) );
+		discarded = 0;
+	}
+
+	// Accessed concurrently by handle().
+	tbb::concurrent_bounded_queue<QueueEntry> queue;
+	tbb::atomic<size_t> discarded;
+
+	boost::scoped_ptr<tbb::tbb_thread> thread;
+
+	// Only accessed on the writer thread.
+	MessageHandler *handler;
+	const size_t maxMessagesPerSecond;
+	RepeatMap repeats;
+	tbb::tick_count windowStart;
+	size_t windowCount;
+	size_t rateLimited;
+
+	void run()
+	{
+		QueueEntry entry;
+		while( true )
+		{
+			queue.pop( entry );
+			// Exceptions can't be allowed to escape the
+			// thread, and there is nowhere to report them.
+			try
+			{
+				switch( entry.type )
+				{
+					case QueueEntry::Message :
+						write( entry );
+						break;
+					case QueueEntry::Flush :
+						writeSummaries();
+						break;
+					case QueueEntry::Stop :
+						writeSummaries();
+						return;
+				}
+			}
+			catch( ... )
+			{
+			}
+
+			if( entry.flushed )
+			{
+				*entry.flushed = true;
+			}
+		}
+	}
+
+	void write( const QueueEntry &entry )
+	{
+		if( maxMessagesPerSecond )
+		{
+			const tbb::tick_count now = tbb::tick_count::now();
+			if( ( now - windowStart ).seconds() >= 1.0 )
+			{
+				writeOmitted();
+				windowStart = now;
+				windowCount = 0;
+			}
+		}
+
+		const MessageKey key( entry.level, entry.context, entry.message );
+		RepeatMap::iterator it = repeats.find( key );
+		if( it != repeats.end() )
+		{
+			it->second++;
+			return;
+		}
+
+		if( maxMessagesPerSecond && windowCount >= maxMessagesPerSecond )
+		{
+			rateLimited++;
+			return;
+		}
+
+		if( repeats.size() >= g_maxRepeatMapSize )
+		{
+			writeRepeats();
+		}
+
+		repeats.insert( RepeatMap::value_type( key, 0 ) );
+		windowCount++;
+		handler->handle( entry.level, entry.context, entry.message );
+	}
+
+	// Outputs the repeat counts and clears the map, so that
+	// subsequent messages are output again.
+	void writeRepeats()
+	{
+		for( RepeatMap::const_iterator it = repeats.begin(); it != repeats.end(); ++it )
+		{
+			if( it->second )
+			{
+				handler->handle( it->first.get<0>(), it->first.get<1>(), boost::str( boost::format( "%s (repeated %d times)" ) % it->first.get<2>() % it->second ) );
+			}
+		}
+		repeats.clear();
+	}
+
+	void writeOmitted()
+	{
+		if( rateLimited )
+		{
+			handler->handle( MessageHandler::Warning, "AsyncMessageHandler", boost::str( boost::format( "%d messages omitted due to rate limiting" ) % rateLimited ) );
+			rateLimited = 0;
+		}
+
+		const size_t d = discarded.fetch_and_store( 0 );
+		if( d )
+		{
+			handler->handle( MessageHandler::Warning, "AsyncMessageHandler", boost::str( boost::format( "%d messages discarded due to full queue" ) % d ) );
+		}
+	}
+
+	void writeSummaries()
+	{
+		writeRepeats();
+		writeOmitted();
+	}
+
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+// structors
+///////////////////////////////////////////////////////////////////////////////////////
+
+AsyncMessageHandler::AsyncMessageHandler( MessageHandlerPtr handler, size_t maxMessagesPerSecond, size_t queueCapacity )
+	:	FilteredMessageHandler( handler ), m_data( new Data( handler.get(), maxMessagesPerSecond, queueCapacity ) )
+{
+	m_data->thread.reset( new tbb::tbb_thread( boost::bind( &Data::run, m_data.get() ) ) );
+}
+
+AsyncMessageHandler::~AsyncMessageHandler()
+{
+	QueueEntry entry;
+	entry.type = QueueEntry::Stop;
+	m_data->queue.push( entry );
+	m_data->thread->join();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// output functions
+///////////////////////////////////////////////////////////////////////////////////////
+
+void AsyncMessageHandler::handle( Level level, const std::string &context, const std::string &message )
+{
+	QueueEntry entry;
+	entry.level = level;
+	entry.context = context;
+	entry.message = message;
+	if( !m_data->queue.try_push( entry ) )
+	{
+		++m_data->discarded;
+	}
+}
+
+void AsyncMessageHandler::flush()
+{
+	tbb::atomic<bool> flushed;
+	flushed = false;
+
+	QueueEntry entry;
+	entry.type = QueueEntry::Flush;
+	entry.flushed = &flushed;
+	m_data->queue.push( entry );
+
+	while( !flushed )
+	{
+		tbb::this_tbb_thread::sleep( tbb::tick_count::interval_t( 0.001 ) );
+	}
+}
@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/BoxBlurOp.h"
+#include "IECore/SummedAreaOp.h"
+#include "IECore/CompoundParameter.h"
+#include "IECore/VectorTypedData.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+
+using namespace IECore;
+using namespace Imath;
+
+IE_CORE_DEFINERUNTIMETYPED( BoxBlurOp );
+
+BoxBlurOp::BoxBlurOp()
+	:	ChannelOp( "Blurs image channels with a box filter." )
+{
+	m_radiusParameter = new IntParameter(
+		"radius",
+		"The radius of the box in pixels. Each output pixel is the average "
+		"of the ( 2 * radius + 1 ) squared pixels surrounding it.",
+		1,
+		0
+	);
+
+	parameters()->addParameter( m_radiusParameter );
+}
+
+BoxBlurOp::~BoxBlurOp()
+{
+}
+
+IntParameter *BoxBlurOp::radiusParameter()
+{
+	return m_radiusParameter.get();
+}
+
+const IntParameter *BoxBlurOp::radiusParameter() const
+{
+	return m_radiusParameter.get();
+}
+
+// Computes the output rows from the summed area table, with four
+// lookups per pixel regardless of the radius.
+class BoxBlurOp::BlurRows
+{
+
+	public :
+
+		BlurRows( const std::vector<double> &table, int width, int height, int radius, float *channel )
+			:	m_table( table ), m_width( width ), m_height( height ), m_radius( radius ), m_channel( channel )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			const int stride = m_width + 1;
+			for( int y = range.begin(); y != range.end(); ++y )
+			{
+				const int y0 = std::max( y - m_radius, 0 );
+				const int y1 = std::min( y + m_radius + 1, m_height );
+				const double *row0 = &m_table[y0 * stride];
+				const double *row1 = &m_table[y1 * stride];
+				float *out = m_channel + y * m_width;
+				for( int x = 0; x < m_width; ++x )
+				{
+					const int x0 = std::max( x - m_radius, 0 );
+					const int x1 = std::min( x + m_radius + 1, m_width );
+					const double sum = row1[x1] - row0[x1] - row1[x0] + row0[x0];
+					out[x] = sum / ( ( x1 - x0 ) * ( y1 - y0 ) );
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<double> &m_table;
+		int m_width;
+		int m_height;
+		int m_radius;
+		float *m_channel;
+
+};
+
+void BoxBlurOp::modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels )
+{
+	const int radius = m_radiusParameter->getNumericValue();
+	if( radius == 0 )
+	{
+		return;
+	}
+
+	const int width = dataWindow.size().x + 1;
+	const int height = dataWindow.size().y + 1;
+
+	std::vector<double> table;
+	for( unsigned i=0; i<channels.size(); i++ )
+	{
+		std::vector<float> &channel = channels[i]->writable();
+		SummedAreaOp::summedAreaTable( dataWindow, &channel[0], table );
+		tbb::parallel_for( tbb::blocked_range<int>( 0, height ), BlurRows( table, width, height, radius, &channel[0] ) );
+	}
+}
@@ -40,9 +40,9 @@
 #include "IECore/ImagePrimitive.h"
 #include "IECore/FileNameParameter.h"
 #include "IECore/BoxOps.h"
-#include "IECore/ScaledDataConversion.h"
 
 #include "IECore/private/cineon.h"
+#include "IECore/private/TenBitUnpacking.h"
 
 #include "boost/format.hpp"
 
@@ -157,94 +157,54 @@ std::string CINImageReader::sourceColorSpace() const
 }
 
 
+DataPtr CINImageReader::readChannel( const string &name, const Imath::Box2i &dataWindow, bool raw )
+{
+	std::vector<std::string> names( 1, name );
+	std::vector<DataPtr> data;
+	readChannels( names, dataWindow, raw, data );
+	return data.size() ? data[0] : 0;
+}
+
 /// \todo
 /// we assume here CIN coding in the 'typical' configuration (output by film dumps, nuke, etc).
-/// this is RGB 10bit log for film, pixel-interlaced data. We convert this to unsigned short 
-/// (using the whole range of 16 bits available ) and then it's converted to the given 
+/// this is RGB 10bit log for film, pixel-interlaced data. We convert this to unsigned short
+/// (using the whole range of 16 bits available ) and then it's converted to the given
 /// typename V applying domain scale as necessary. Note that there's no cineon to linear conversion as
 /// it's now up to the base class to do it.
-template<typename V>
-DataPtr CINImageReader::readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow )
+void CINImageReader::readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data )
 {
-	typedef TypedData< std::vector< V > > TargetVector;
-
-	// figure out the offset into the bitstream for the given channel
-	assert( m_header->m_channelOffsets.find( name ) != m_header->m_channelOffsets.end() );
-	int channelOffset = m_header->m_channelOffsets[name];
-
-	assert( (int)m_header->m_imageInformation.channel_information[channelOffset].bpp == 10 );
-	int bpp = m_header->m_imageInformation.channel_information[channelOffset].bpp;
-	// todo: make sure ushort is enough for the current bpp
-	int ushortShift = sizeof(unsigned short)*8 - bpp;
-
-	// form the mask for this channel
-	unsigned int mask = 0;
-	for (int pi = 0; pi < bpp; ++pi)
+	data.clear();
+	if ( !open() )
 	{
-		mask = 1 + (mask << 1);
+		return;
 	}
-	mask <<= ((32 - bpp) - channelOffset * bpp);
 
-	ScaledDataConversion< unsigned short, V> converter;
-
-	typename TargetVector::Ptr dataContainer = new TargetVector();
-	typename TargetVector::ValueType &data = dataContainer->writable();
-	int area = ( dataWindow.size().x + 1 ) * ( dataWindow.size().y + 1 );
-	assert( area >= 0 );
-	data.resize( area );
-
-	int dataWidth = 1 + dataWindow.size().x;
-
-	Box2i wholeDataWindow = this->dataWindow();
-
-	const int yMin = dataWindow.min.y - wholeDataWindow.min.y;
-	const int yMax = dataWindow.max.y - wholeDataWindow.min.y;
-
-	const int xMin = dataWindow.min.x - wholeDataWindow.min.x;
-	const int xMax = dataWindow.max.x - wholeDataWindow.min.x;
+	assert( m_header );
 
-	int dataY = 0;
-	for ( int y = yMin ; y <= yMax ; ++y, ++dataY )
+	// figure out the offset into the bitstream for each channel
+	std::vector<int> channelIndices;
+	for ( std::vector<std::string>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
 	{
-		typename TargetVector::ValueType::size_type dataOffset = dataY * dataWidth;
-		std::vector<unsigned int>::size_type bufferOffset = y * m_bufferWidth + xMin;
-
-		for ( int x = xMin;  x <= xMax ; ++x, ++dataOffset, ++bufferOffset  )
+		Header::ChannelOffsetMap::const_iterator cIt = m_header->m_channelOffsets.find( *it );
+		if ( cIt == m_header->m_channelOffsets.end() )
 		{
-			assert( dataOffset < data.size() );
-
-			unsigned int cell = m_buffer[ bufferOffset ];
-			if ( m_reverseBytes )
-			{
-				cell = reverseBytes( cell );
-			}
-
-			// assume we have 10bit log, two wasted bits aligning to 32 longword
-			unsigned short cv = (unsigned short) ( ( mask & cell ) >> ( 2 + ( 2 - channelOffset ) * bpp ) );
-			assert( cv < 1024 );
-			data[dataOffset] = converter( (cv << ushortShift) + ((1 << ushortShift) - 1) );
+			throw IOException( ( boost::format( "CINImageReader: Could not find channel \"%s\" while reading %s" ) % *it % fileName() ).str() );
 		}
+		assert( (int)m_header->m_imageInformation.channel_information[cIt->second].bpp == 10 );
+		channelIndices.push_back( cIt->second );
 	}
-	return dataContainer;
-}
 
+	const Box2i wholeDataWindow = this->dataWindow();
+	const Box2i region( dataWindow.min - wholeDataWindow.min, dataWindow.max - wholeDataWindow.min );
 
-DataPtr CINImageReader::readChannel( const string &name, const Imath::Box2i &dataWindow, bool raw )
-{
-	if ( !open() )
+	if ( raw )
 	{
-		return 0;
+		Detail::unpackTenBitChannels<unsigned short>( &m_buffer[0], m_bufferWidth, m_reverseBytes, region, channelIndices, data );
 	}
-
-	assert( m_header );
-	DataPtr dataContainer = NULL;
-
-	if ( raw )
-		dataContainer = readTypedChannel< unsigned short >( name, dataWindow );
 	else
-		dataContainer = readTypedChannel< float >( name, dataWindow );
-
-	return dataContainer;
+	{
+		Detail::unpackTenBitChannels<float>( &m_buffer[0], m_bufferWidth, m_reverseBytes, region, channelIndices, data );
+	}
 }
 
 bool CINImageReader::open( bool throwOnFailure )
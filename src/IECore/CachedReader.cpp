@@ -241,6 +241,16 @@ ObjectPool *CachedReader::objectPool() const
 	return m_data->m_cache.objectPool();
 }
 
+LRUCacheStatistics CachedReader::statistics() const
+{
+	return m_data->m_cache.statistics();
+}
+
+void CachedReader::resetStatistics()
+{
+	m_data->m_cache.resetStatistics();
+}
+
 CachedReader *CachedReader::defaultCachedReader()
 {
 	static CachedReaderPtr c = 0;
@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <stack>
+#include <algorithm>
 #include <fnmatch.h>
 
 #include "boost/regex.hpp"
@@ -41,6 +42,9 @@
 #include "tbb/enumerable_thread_specific.h"
 #include "tbb/task_scheduler_init.h"
 #include "tbb/task.h"
+#include "tbb/mutex.h"
+#include "tbb/atomic.h"
+#include "tbb/concurrent_queue.h"
 
 #include "IECore/CapturingRenderer.h"
 #include "IECore/PointsPrimitive.h"
@@ -56,6 +60,7 @@
 #include "IECore/Shader.h"
 #include "IECore/MatrixTransform.h"
 #include "IECore/Light.h"
+#include "IECore/Profiling.h"
 
 using namespace std;
 using namespace tbb;
@@ -74,8 +79,9 @@ class CapturingRenderer::Implementation
 	public :
 	
 		Implementation()
-			:	m_mainContext( 0 )
+			:	m_mainContext( 0 ), m_sinkMaxMemory( 0 )
 		{
+			m_sinkQueueMemory = 0;
 			m_topLevelProceduralParent = new( tbb::task::allocate_root() ) tbb::empty_task;
 		}
 		
@@ -116,6 +122,10 @@ class CapturingRenderer::Implementation
 			}
 			contextStack.push( new Context );
 			m_world = 0;
+			
+			ConstIntDataPtr maxMemory = IECore::runTimeCast<const IntData>( getOption( "cp:sink:maxMemory" ) );
+			m_sinkMaxMemory = (size_t)std::max( maxMemory ? maxMemory->readable() : 1024, 0 ) * 1024 * 1024;
+			
 			m_mainContext = contextStack.top().get();
 			m_topLevelProceduralParent->set_ref_count( 1 ); // for the wait_for_all() in worldEnd()
 		}
@@ -135,6 +145,7 @@ class CapturingRenderer::Implementation
 			}
 												
 			m_topLevelProceduralParent->wait_for_all(); // wait for all procedurals to finish
+			flushSink( true ); // and for the sink to receive everything they output
 			
 			collapseGroups( contextStack.top()->stack.back() );
 			m_world = contextStack.top()->stack.back().group;
@@ -331,17 +342,28 @@ class CapturingRenderer::Implementation
 			if ( reentrant ? reentrant->readable() : true )
 			{
 				ContextPtr proceduralContext = new Context( context.get() );
-				addChild( context->stack.back(), proceduralContext->stack.back().group );
 				
 				if( context == m_mainContext )
 				{
-					// this is a top level procedural.
-					tbb::task *proceduralTask = new( m_topLevelProceduralParent->allocate_additional_child_of( *m_topLevelProceduralParent ) ) ProceduralTask( renderer, procedural, proceduralContext );
+					// this is a top level procedural. when streaming, its output goes
+					// to the sink rather than into the world.
+					GroupPtr streamGroup = 0;
+					if( m_sink )
+					{
+						streamGroup = sinkWrapper( *context );
+						streamGroup->addChild( proceduralContext->stack.back().group );
+					}
+					else
+					{
+						addChild( context->stack.back(), proceduralContext->stack.back().group );
+					}
+					tbb::task *proceduralTask = new( m_topLevelProceduralParent->allocate_additional_child_of( *m_topLevelProceduralParent ) ) ProceduralTask( renderer, procedural, proceduralContext, streamGroup );
 					m_topLevelProceduralParent->spawn( *proceduralTask );
 				}
 				else
 				{
 					// this is a child of another procedural. 
+					addChild( context->stack.back(), proceduralContext->stack.back().group );
 					tbb::task &parentProceduralTask = tbb::task::self();
 					tbb::task *proceduralTask = new( parentProceduralTask.allocate_additional_child_of( parentProceduralTask ) ) ProceduralTask( renderer, procedural, proceduralContext );
 					parentProceduralTask.spawn( *proceduralTask ); // the parent procedural will wait for this task in its execute() method
@@ -351,7 +373,10 @@ class CapturingRenderer::Implementation
 			{
 				// enclose this in an attribute block to prevent leaking:
 				attributeBegin();
-				procedural->render( renderer.get() );
+				{
+					IECORE_PROFILE_ZONE( "CapturingRenderer::procedural" );
+					procedural->render( renderer.get() );
+				}
 				attributeEnd();
 			}
 		}
@@ -364,6 +389,23 @@ class CapturingRenderer::Implementation
 			}
 			return m_world;
 		}
+		
+		void setSink( SinkPtr sink )
+		{
+			ContextStack &contextStack = m_threadContexts.local();
+			if( contextStack.size() )
+			{
+				msg( Msg::Warning, "CapturingRenderer::Implementation::setSink", "Cannot call setSink() after worldBegin()." );
+				return;
+			}
+			
+			m_sink = sink;
+		}
+		
+		SinkPtr getSink()
+		{
+			return m_sink;
+		}
 
 	private :
 	
@@ -409,8 +451,8 @@ class CapturingRenderer::Implementation
 		
 			public :
 			
-				ProceduralTask( CapturingRendererPtr renderer, Renderer::ProceduralPtr procedural, ContextPtr context )
-					:	m_renderer( renderer ), m_procedural( procedural ), m_context( context )
+				ProceduralTask( CapturingRendererPtr renderer, Renderer::ProceduralPtr procedural, ContextPtr context, GroupPtr streamGroup = 0 )
+					:	m_renderer( renderer ), m_procedural( procedural ), m_context( context ), m_streamGroup( streamGroup )
 				{			
 				}
 				
@@ -427,7 +469,10 @@ class CapturingRenderer::Implementation
 					
 					try
 					{
-						m_procedural->render( m_renderer.get() );
+						{
+							IECORE_PROFILE_ZONE( "CapturingRenderer::procedural" );
+							m_procedural->render( m_renderer.get() );
+						}
 						wait_for_all();
 						m_renderer->m_implementation->collapseGroups( m_context->stack.back() );
 					}
@@ -439,6 +484,16 @@ class CapturingRenderer::Implementation
 					
 					contextStack.pop();
 					
+					if( m_streamGroup )
+					{
+						// drop our references to the output before handing it over, so
+						// that it can be freed as soon as the sink is done with it.
+						GroupPtr streamGroup = m_streamGroup;
+						m_streamGroup = 0;
+						m_context = 0;
+						m_renderer->m_implementation->sinkWrite( streamGroup );
+					}
+					
 					return 0;
 				}
 		
@@ -447,6 +502,7 @@ class CapturingRenderer::Implementation
 				CapturingRendererPtr m_renderer;
 				Renderer::ProceduralPtr m_procedural;
 				ContextPtr m_context;
+				GroupPtr m_streamGroup;
 		
 		};
 		
@@ -688,8 +744,97 @@ class CapturingRenderer::Implementation
 			}
 		}
 		
+		// returns a group holding the full state and world transform
+		// for the top of the context stack, suitable for passing output
+		// to the sink independently of the rest of the world.
+		GroupPtr sinkWrapper( const Context &context )
+		{
+			GroupPtr result = new Group;
+			
+			CompoundDataMap attributes;
+			for( Context::StateStack::const_iterator it = context.stack.begin(); it!=context.stack.end(); it++ )
+			{
+				for( CompoundDataMap::const_iterator aIt = it->attributes.begin(); aIt!=it->attributes.end(); aIt++ )
+				{
+					attributes[aIt->first] = aIt->second->copy();
+				}
+			}
+			if( attributes.size() )
+			{
+				result->addState( new AttributeState( attributes ) );
+			}
+			
+			for( Context::StateStack::const_iterator it = context.stack.begin(); it!=context.stack.end(); it++ )
+			{
+				for( std::vector< ShaderPtr >::const_iterator sIt = it->shaders.begin(); sIt!=it->shaders.end(); sIt++ )
+				{
+					result->addState( (*sIt)->copy() );
+				}
+				for( std::vector<LightPtr>::const_iterator lIt = it->lights.begin(); lIt!=it->lights.end(); lIt++ )
+				{
+					result->addState( (*lIt)->copy() );
+				}
+			}
+			
+			const M44f &worldTransform = context.stack.back().worldTransform;
+			if( worldTransform != M44f() )
+			{
+				result->setTransform( new MatrixTransform( worldTransform ) );
+			}
+			
+			return result;
+		}
+		
+		// queues the output of a completed procedural for the sink. if
+		// the queue is using more memory than allowed we wait for the
+		// sink to consume it, otherwise we only write if no other thread
+		// is already doing so.
+		void sinkWrite( ConstGroupPtr group )
+		{
+			size_t memory = group->memoryUsage();
+			m_sinkQueue.push( SinkQueueEntry( group, memory ) );
+			size_t queueMemory = m_sinkQueueMemory += memory;
+			group = 0;
+			
+			flushSink( queueMemory > m_sinkMaxMemory );
+		}
+		
+		void flushSink( bool wait )
+		{
+			if( !m_sink )
+			{
+				return;
+			}
+		
+			tbb::mutex::scoped_lock lock;
+			if( wait )
+			{
+				lock.acquire( m_sinkMutex );
+			}
+			else if( !lock.try_acquire( m_sinkMutex ) )
+			{
+				return;
+			}
+			
+			SinkQueueEntry entry;
+			while( m_sinkQueue.try_pop( entry ) )
+			{
+				m_sinkQueueMemory -= entry.second;
+				ConstGroupPtr group = entry.first;
+				entry.first = 0;
+				m_sink->write( group );
+			}
+		}
+		
 		std::map<std::string, ConstDataPtr> m_options;
 		GroupPtr m_world;
+		
+		typedef std::pair<ConstGroupPtr, size_t> SinkQueueEntry;
+		SinkPtr m_sink;
+		size_t m_sinkMaxMemory;
+		tbb::concurrent_queue<SinkQueueEntry> m_sinkQueue;
+		tbb::atomic<size_t> m_sinkQueueMemory;
+		tbb::mutex m_sinkMutex;
 			
 };
 
@@ -913,3 +1058,25 @@ ConstGroupPtr CapturingRenderer::world()
 {
 	return m_implementation->world();
 }
+
+void CapturingRenderer::setSink( SinkPtr sink )
+{
+	m_implementation->setSink( sink );
+}
+
+CapturingRenderer::SinkPtr CapturingRenderer::getSink()
+{
+	return m_implementation->getSink();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Sink
+//////////////////////////////////////////////////////////////////////////
+
+CapturingRenderer::Sink::Sink()
+{
+}
+
+CapturingRenderer::Sink::~Sink()
+{
+}
@@ -36,15 +36,52 @@
 #include "IECore/TypeTraits.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/CompoundParameter.h"
+#include "IECore/ScaledDataConversion.h"
+#include "IECore/VectorTypedData.h"
+
+#include <algorithm>
 
 #include "boost/format.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 using namespace IECore;
 using namespace std;
 using namespace boost;
 
 IE_CORE_DEFINERUNTIMETYPED( ChannelOp );
 
+// The approximate number of pixels passed to each call to modifyTile().
+static const size_t g_minTileSize = 16384;
+
+// Channels of other types are converted to float for processing, using the
+// same scaling as the image readers and writers, so that the full range of
+// an unsigned char channel maps to [0,1].
+template<typename T>
+static FloatVectorDataPtr toFloat( const T *data )
+{
+	typedef typename T::ValueType::value_type V;
+	const typename T::ValueType &in = data->readable();
+	FloatVectorDataPtr result = new FloatVectorData;
+	std::vector<float> &out = result->writable();
+	out.resize( in.size() );
+	std::transform( in.begin(), in.end(), out.begin(), ScaledDataConversion<V, float>() );
+	return result;
+}
+
+template<typename T>
+static typename T::Ptr fromFloat( const FloatVectorData *data )
+{
+	typedef typename T::ValueType::value_type V;
+	const std::vector<float> &in = data->readable();
+	typename T::Ptr result = new T;
+	typename T::ValueType &out = result->writable();
+	out.resize( in.size() );
+	std::transform( in.begin(), in.end(), out.begin(), ScaledDataConversion<float, V>() );
+	return result;
+}
+
 ChannelOp::ChannelOp( const std::string &description )
 	:	ImagePrimitiveOp( description )
 {
@@ -112,9 +149,10 @@ void ChannelOp::modifyTypedPrimitive( ImagePrimitive * image, const CompoundObje
 			throw Exception( str( format( "Primitive variable \"%s\" has no data." ) % channelNames[i] ) );
 		}
 
-		if( !it->second.data->isInstanceOf( FloatVectorData::staticTypeId() ) )
+		const TypeId type = it->second.data->typeId();
+		if( type != FloatVectorDataTypeId && type != HalfVectorDataTypeId && type != UCharVectorDataTypeId )
 		{
-			throw Exception( str( format( "Primitive variable \"%s\" is not a float vector." ) % channelNames[i] ) );
+			throw Exception( str( format( "Primitive variable \"%s\" is not a float, half or unsigned char vector." ) % channelNames[i] ) );
 		}
 
 		size_t size = despatchTypedData<TypedDataSize>( it->second.data.get() );
@@ -123,9 +161,90 @@ void ChannelOp::modifyTypedPrimitive( ImagePrimitive * image, const CompoundObje
 			throw Exception( str( format( "Primitive variable \"%s\" has wrong size (%d but should be %d)." ) % channelNames[i] % size % numPixels ) );
 		}
 
-		channels.push_back( boost::static_pointer_cast< FloatVectorData >( it->second.data ) );
+		switch( type )
+		{
+			case HalfVectorDataTypeId :
+				channels.push_back( toFloat( static_cast<const HalfVectorData *>( it->second.data.get() ) ) );
+				break;
+			case UCharVectorDataTypeId :
+				channels.push_back( toFloat( static_cast<const UCharVectorData *>( it->second.data.get() ) ) );
+				break;
+			default :
+				channels.push_back( boost::static_pointer_cast< FloatVectorData >( it->second.data ) );
+		}
 	}
 
 	modifyChannels( image->getDisplayWindow(), image->getDataWindow(), channels );
 	/// \todo Consider cases where the derived class invalidates the channel data (by changing its length)
+
+	// Convert any channels which didn't start out as floats back to their
+	// original type, so the image doesn't grow as it passes through the op.
+	for( unsigned i=0; i<channelNames.size(); i++ )
+	{
+		PrimitiveVariable &channel = image->variables[channelNames[i]];
+		switch( channel.data->typeId() )
+		{
+			case HalfVectorDataTypeId :
+				channel.data = fromFloat<HalfVectorData>( channels[i].get() );
+				break;
+			case UCharVectorDataTypeId :
+				channel.data = fromFloat<UCharVectorData>( channels[i].get() );
+				break;
+			default :
+				break;
+		}
+	}
+}
+
+struct ChannelOp::ModifyTiles
+{
+
+	ModifyTiles( const ChannelOp *op, const Imath::Box2i &dataWindow, const std::vector<float *> &channels )
+		:	m_op( op ), m_dataWindow( dataWindow ), m_channels( channels )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<int> &range ) const
+	{
+		const size_t offset = ( range.begin() - m_dataWindow.min.y ) * ( m_dataWindow.size().x + 1 );
+
+		std::vector<float *> channels( m_channels );
+		for( std::vector<float *>::iterator it = channels.begin(); it != channels.end(); ++it )
+		{
+			*it += offset;
+		}
+
+		const Imath::Box2i tile( Imath::V2i( m_dataWindow.min.x, range.begin() ), Imath::V2i( m_dataWindow.max.x, range.end() - 1 ) );
+		m_op->modifyTile( m_dataWindow, tile, channels );
+	}
+
+	private :
+
+		const ChannelOp *m_op;
+		const Imath::Box2i &m_dataWindow;
+		const std::vector<float *> &m_channels;
+
+};
+
+void ChannelOp::modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels )
+{
+	// writable() may need to copy shared data, so we must
+	// call it up front rather than from the parallel tiles.
+	std::vector<float *> channelData;
+	for( ChannelVector::iterator it = channels.begin(); it != channels.end(); ++it )
+	{
+		channelData.push_back( &(*it)->writable()[0] );
+	}
+
+	const size_t width = dataWindow.size().x + 1;
+	const size_t rowsPerTile = std::max<size_t>( 1, g_minTileSize / width );
+	tbb::parallel_for(
+		tbb::blocked_range<int>( dataWindow.min.y, dataWindow.max.y + 1, rowsPerTile ),
+		ModifyTiles( this, dataWindow, channelData )
+	);
+}
+
+void ChannelOp::modifyTile( const Imath::Box2i &dataWindow, const Imath::Box2i &tile, const std::vector<float *> &channels ) const
+{
+	throw Exception( str( format( "%s does not implement modifyChannels() or modifyTile()." ) % typeName() ) );
 }
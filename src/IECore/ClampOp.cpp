@@ -156,21 +156,22 @@ const FloatParameter *ClampOp::maxToParameter() const
 	return parameters()->parameter<FloatParameter>( "maxTo" );
 }
 
-void ClampOp::modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels )
+void ClampOp::modifyTile( const Imath::Box2i &dataWindow, const Imath::Box2i &tile, const std::vector<float *> &channels ) const
 {
 	float minValue = minParameter()->getNumericValue();
 	float maxValue = maxParameter()->getNumericValue();
 	
 	float minTo = enableMinToParameter()->getTypedValue() ? minToParameter()->getNumericValue() : minValue;
 	float maxTo = enableMaxToParameter()->getTypedValue() ? maxToParameter()->getNumericValue() : maxValue;
-	
+
+	const size_t numPixels = ( tile.size().x + 1 ) * ( tile.size().y + 1 );
 	for( unsigned i=0; i<channels.size(); i++ )
 	{
-		vector<float> &channel = channels[i]->writable();
-		for( vector<float>::iterator it = channel.begin(), eIt = channel.end(); it != eIt; it++ )
+		float *channel = channels[i];
+		for( size_t j = 0; j < numPixels; j++ )
 		{
-			*it = *it < minValue ? minTo : ( *it > maxValue ? maxTo : *it );
+			const float v = channel[j];
+			channel[j] = v < minValue ? minTo : ( v > maxValue ? maxTo : v );
 		}
 	}
 }
-
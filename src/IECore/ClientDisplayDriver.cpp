@@ -33,14 +33,22 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
+#include <deque>
+
 #include "boost/asio.hpp"
 #include "boost/bind.hpp"
 #include "boost/array.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "tbb/tbb_thread.h"
 
 #include "IECore/ClientDisplayDriver.h"
 #include "IECore/private/DisplayDriverServerHeader.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/MemoryIndexedIO.h"
+#include "IECore/MessageHandler.h"
 
 using namespace boost;
 using namespace std;
@@ -52,12 +60,20 @@ class ClientDisplayDriver::PrivateData : public RefCounted
 {
 	public :
 		PrivateData() :
-		m_service(), m_host(""), m_port(""), m_scanLineOrderOnly(false), m_acceptsRepeatedData(false), m_socket( m_service )
+		m_service(), m_host(""), m_port(""), m_scanLineOrderOnly(false), m_acceptsRepeatedData(false), m_dataEncoding( DisplayDriverServerHeader::floatData ), m_socket( m_service ),
+		m_maxQueuedBytes( 0 ), m_queuedBytes( 0 ), m_stopSending( false ), m_sendFailed( false )
 		{
 		}
 
 		~PrivateData()
 		{
+			// discard anything still queued, as imageClose() wasn't called.
+			{
+				boost::lock_guard<boost::mutex> lock( m_queueMutex );
+				m_queue.clear();
+				m_queuedBytes = 0;
+			}
+			stopSending();
 			m_socket.close();
 		}
 
@@ -66,7 +82,121 @@ class ClientDisplayDriver::PrivateData : public RefCounted
 		std::string m_port;
 		bool m_scanLineOrderOnly;
 		bool m_acceptsRepeatedData;
+		unsigned char m_dataEncoding;
 		boost::asio::ip::tcp::socket m_socket;
+		// reused between calls to imageData(), to avoid reallocating
+		// for every bucket.
+		std::vector<char> m_encodedData;
+
+		// Asynchronous sending. Complete messages are queued by imageData(), and
+		// written to the socket by m_sendThread. The queue is limited to
+		// m_maxQueuedBytes, with queue() blocking while it is full.
+		typedef boost::shared_ptr<std::vector<char> > Message;
+		size_t m_maxQueuedBytes;
+
+		void startSending()
+		{
+			tbb::tbb_thread newThread( boost::bind( &PrivateData::sendThread, this ) );
+			m_sendThread.swap( newThread );
+		}
+
+		void queue( Message message )
+		{
+			boost::unique_lock<boost::mutex> lock( m_queueMutex );
+			while( m_queuedBytes && m_queuedBytes + message->size() > m_maxQueuedBytes && !m_sendFailed )
+			{
+				m_queueCondition.wait( lock );
+			}
+			throwIfSendFailed();
+			m_queue.push_back( message );
+			m_queuedBytes += message->size();
+			m_queueCondition.notify_all();
+		}
+
+		// Waits for all queued messages to be written, and stops the send thread.
+		void flush()
+		{
+			stopSending();
+			throwIfSendFailed();
+		}
+
+	private :
+
+		boost::mutex m_queueMutex;
+		boost::condition_variable m_queueCondition;
+		std::deque<Message> m_queue;
+		size_t m_queuedBytes;
+		bool m_stopSending;
+		bool m_sendFailed;
+		std::string m_sendError;
+		tbb::tbb_thread m_sendThread;
+
+		void stopSending()
+		{
+			{
+				boost::lock_guard<boost::mutex> lock( m_queueMutex );
+				m_stopSending = true;
+				m_queueCondition.notify_all();
+			}
+			if( m_sendThread.joinable() )
+			{
+				m_sendThread.join();
+			}
+		}
+
+		void throwIfSendFailed()
+		{
+			if( m_sendFailed )
+			{
+				throw Exception( "Could not send image data to remote display driver server : " + m_sendError );
+			}
+		}
+
+		void sendThread()
+		{
+			while( true )
+			{
+				Message message;
+				{
+					boost::unique_lock<boost::mutex> lock( m_queueMutex );
+					while( m_queue.empty() && !m_stopSending )
+					{
+						m_queueCondition.wait( lock );
+					}
+					if( m_queue.empty() )
+					{
+						return;
+					}
+					// left in the queue until it's written, so that
+					// it counts towards the limit.
+					message = m_queue.front();
+				}
+
+				try
+				{
+					boost::asio::write( m_socket, boost::asio::buffer( *message ) );
+				}
+				catch( std::exception &e )
+				{
+					boost::lock_guard<boost::mutex> lock( m_queueMutex );
+					m_sendFailed = true;
+					m_sendError = e.what();
+					m_queue.clear();
+					m_queuedBytes = 0;
+					m_queueCondition.notify_all();
+					return;
+				}
+
+				boost::lock_guard<boost::mutex> lock( m_queueMutex );
+				if( m_queue.size() && m_queue.front() == message )
+				{
+					m_queue.pop_front();
+					m_queuedBytes -= message->size();
+				}
+				m_queueCondition.notify_all();
+			}
+		}
+
 };
 
 IE_CORE_DEFINERUNTIMETYPED( ClientDisplayDriver );
@@ -84,6 +214,38 @@ ClientDisplayDriver::ClientDisplayDriver( const Imath::Box2i &displayWindow, con
 	m_data->m_host = displayHostData->readable();
 	m_data->m_port = displayPortData->readable();
 
+	// optional IntData parameter specifying the memory limit in megabytes for
+	// buckets waiting to be sent, with 0 meaning they're sent synchronously.
+	if( const IntData *queueMemoryData = parameters->member<IntData>( "displaySendQueueMemory" ) )
+	{
+		if( queueMemoryData->readable() < 0 )
+		{
+			throw Exception( "Invalid displaySendQueueMemory - must not be negative." );
+		}
+		m_data->m_maxQueuedBytes = (size_t)queueMemoryData->readable() * 1024 * 1024;
+	}
+	else
+	{
+		m_data->m_maxQueuedBytes = 64 * 1024 * 1024;
+	}
+
+	// optional StringData parameter requesting an encoding for the image data. the
+	// server replies with the encoding it accepts after the image is opened.
+	bool fallBackToHalf = false;
+	if( const StringData *encodingData = parameters->member<StringData>( "displayDataEncoding" ) )
+	{
+		const std::string &encoding = encodingData->readable();
+		if( encoding != "float" && encoding != "half" && encoding != "halfLZ4" )
+		{
+			throw Exception( "Invalid displayDataEncoding \"" + encoding + "\" - must be \"float\", \"half\" or \"halfLZ4\"." );
+		}
+		if( encoding == "halfLZ4" && !DisplayDriverServerHeader::encodingAvailable( DisplayDriverServerHeader::halfLZ4Data ) )
+		{
+			msg( Msg::Warning, "ClientDisplayDriver", "LZ4 compression is not available. Using half encoding." );
+			fallBackToHalf = true;
+		}
+	}
+
 	tcp::resolver resolver(m_data->m_service);
 	tcp::resolver::query query(m_data->m_host, m_data->m_port);
 
@@ -111,6 +273,10 @@ ClientDisplayDriver::ClientDisplayDriver( const Imath::Box2i &displayWindow, con
 
 	IECore::CompoundDataPtr tmpParameters = parameters->copy();
 	tmpParameters->writable()[ "clientPID" ] = new IntData( getpid() );
+	if( fallBackToHalf )
+	{
+		tmpParameters->writable()[ "displayDataEncoding" ] = new StringData( "half" );
+	}
 
 	// build the data block
 	io = new MemoryIndexedIO( ConstCharVectorDataPtr(), IndexedIO::rootPath, IndexedIO::Exclusive | IndexedIO::Write );
@@ -137,6 +303,21 @@ ClientDisplayDriver::ClientDisplayDriver( const Imath::Box2i &displayWindow, con
 		throw Exception( "Invalid returned acceptsRepeatedData from display driver server!" );
 	}
 	m_data->m_socket.receive( boost::asio::buffer( &m_data->m_acceptsRepeatedData, sizeof(m_data->m_acceptsRepeatedData) ) );
+
+	if ( receiveHeader( DisplayDriverServerHeader::imageOpen ) != sizeof(m_data->m_dataEncoding) )
+	{
+		throw Exception( "Invalid returned dataEncoding from display driver server!" );
+	}
+	m_data->m_socket.receive( boost::asio::buffer( &m_data->m_dataEncoding, sizeof(m_data->m_dataEncoding) ) );
+	if( !DisplayDriverServerHeader::encodingAvailable( (DisplayDriverServerHeader::DataEncoding)m_data->m_dataEncoding ) )
+	{
+		throw Exception( "Unsupported dataEncoding returned from display driver server!" );
+	}
+
+	if( m_data->m_maxQueuedBytes )
+	{
+		m_data->startSending();
+	}
 }
 
 ClientDisplayDriver::~ClientDisplayDriver()
@@ -195,6 +376,38 @@ size_t ClientDisplayDriver::receiveHeader( int msg )
 
 void ClientDisplayDriver::imageData( const Box2i &box, const float *data, size_t dataSize )
 {
+	const DisplayDriverServerHeader::DataEncoding encoding = (DisplayDriverServerHeader::DataEncoding)m_data->m_dataEncoding;
+
+	if( m_data->m_maxQueuedBytes )
+	{
+		// build the complete message, so the sending thread needs
+		// nothing more from us.
+		PrivateData::Message message( new std::vector<char>( DisplayDriverServerHeader::headerLength + sizeof( box ) ) );
+		memcpy( &(*message)[DisplayDriverServerHeader::headerLength], &box, sizeof( box ) );
+		DisplayDriverServerHeader::encodeData( encoding, data, dataSize, *message );
+
+		DisplayDriverServerHeader header( DisplayDriverServerHeader::imageData, message->size() - DisplayDriverServerHeader::headerLength );
+		memcpy( &(*message)[0], header.buffer(), DisplayDriverServerHeader::headerLength );
+
+		m_data->queue( message );
+		return;
+	}
+
+	if( encoding != DisplayDriverServerHeader::floatData )
+	{
+		std::vector<char> &encodedData = m_data->m_encodedData;
+		encodedData.clear();
+		DisplayDriverServerHeader::encodeData( encoding, data, dataSize, encodedData );
+		sendHeader( DisplayDriverServerHeader::imageData, sizeof( box ) + encodedData.size() );
+
+		boost::array<boost::asio::const_buffer, 2> buffers = { {
+			boost::asio::buffer( &box, sizeof( box ) ),
+			boost::asio::buffer( encodedData )
+		} };
+		boost::asio::write( m_data->m_socket, buffers );
+		return;
+	}
+
 	sendHeader( DisplayDriverServerHeader::imageData, sizeof( box ) + dataSize * sizeof( float ) );
 
 	boost::array<boost::asio::const_buffer, 2> buffers = { {
@@ -206,8 +419,8 @@ void ClientDisplayDriver::imageData( const Box2i &box, const float *data, size_t
 
 void ClientDisplayDriver::imageClose()
 {
+	m_data->flush();
 	sendHeader( DisplayDriverServerHeader::imageClose, 0 );
 	receiveHeader( DisplayDriverServerHeader::imageClose );
 	m_data->m_socket.close();
 }
-
@@ -32,12 +32,17 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
+#include "boost/type_traits/is_same.hpp"
+
 #include "IECore/ColorTransformOp.h"
 #include "IECore/CompoundObject.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/Primitive.h"
+#include "IECore/ScaledDataConversion.h"
 
 using namespace IECore;
 using namespace Imath;
@@ -58,7 +63,7 @@ ColorTransformOp::ColorTransformOp( const std::string &description )
 	m_redPrimVarParameter = new StringParameter(
 		"redPrimVar",
 		"The name of the primitive variable which holds the red channel of the color data. This "
-		"can have data of type HalfData, HalfVectorData, FloatData or FloatVectorData. "
+		"can have data of type HalfData, HalfVectorData, FloatData, FloatVectorData, UCharData or UCharVectorData. "
 		"However, The type of this primvar must match the type of the other color component primvars.",
 		"R"
 	);
@@ -66,7 +71,7 @@ ColorTransformOp::ColorTransformOp( const std::string &description )
 	m_greenPrimVarParameter = new StringParameter(
 		"greenPrimVar",
 		"The name of the primitive variable which holds the green channel of the color data. This "
-		"can have data of type HalfData, HalfVectorData, FloatData or FloatVectorData. "
+		"can have data of type HalfData, HalfVectorData, FloatData, FloatVectorData, UCharData or UCharVectorData. "
 		"However, The type of this primvar must match the type of the other color component primvars.",
 		"G"
 	);
@@ -74,7 +79,7 @@ ColorTransformOp::ColorTransformOp( const std::string &description )
 	m_bluePrimVarParameter = new StringParameter(
 		"bluePrimVar",
 		"The name of the primitive variable which holds the blue channel of the color data. This "
-		"can have data of type HalfData, HalfVectorData, FloatData or FloatVectorData. "
+		"can have data of type HalfData, HalfVectorData, FloatData, FloatVectorData, UCharData or UCharVectorData. "
 		"However, The type of this primvar must match the type of the other color component primvars.",
 		"B"
 	);
@@ -198,36 +203,74 @@ const typename T::BaseType *ColorTransformOp::alphaData( Primitive * primitive,
 	return d->baseReadable();
 }
 
+// The number of elements converted to float and passed to transformSpan()
+// at once, when the data isn't already in the right form.
+static const size_t g_spanSize = 1024;
+
 template <typename T>
 void ColorTransformOp::transformSeparate( Primitive * primitive, const CompoundObject * operands, T * r, T * g, T * b )
 {
+	typedef typename T::BaseType BaseType;
+
 	size_t n = r->baseSize();
-	const typename T::BaseType *alpha = alphaData<T>( primitive, n );
+	const BaseType *alpha = alphaData<T>( primitive, n );
+
+	BaseType *rw = r->baseWritable();
+	BaseType *gw = g->baseWritable();
+	BaseType *bw = b->baseWritable();
 
-	typename T::BaseType *rw = r->baseWritable();
-	typename T::BaseType *gw = g->baseWritable();
-	typename T::BaseType *bw = b->baseWritable();
+	// the same scaling as the image readers and writers is used, so
+	// that the full range of an unsigned char channel maps to [0,1].
+	ScaledDataConversion<BaseType, float> toFloat;
+	ScaledDataConversion<float, BaseType> fromFloat;
 
 	begin( operands );
 
 	try
 	{
-		for( size_t i=0; i<n; i++ )
+		if( !alpha && boost::is_same<BaseType, float>::value )
 		{
-			Color3f c( *rw, *gw, *bw );
-			if( alpha && *alpha > 0 )
-			{
-				c /= *alpha;
-			}
-			transform( c );
-			if( alpha )
+			// the channels are already in the form transformSpan() wants,
+			// so can be transformed in a single call. the casts are only
+			// needed to compile the half instantiation, which never gets here.
+			transformSpan( n, reinterpret_cast<float *>( rw ), reinterpret_cast<float *>( gw ), reinterpret_cast<float *>( bw ) );
+		}
+		else
+		{
+			std::vector<float> buffer( 3 * std::min( n, g_spanSize ) );
+			for( size_t i = 0; i < n; i += g_spanSize )
 			{
-				c *= *alpha++;
+				const size_t spanSize = std::min( g_spanSize, n - i );
+				float *rs = &buffer[0];
+				float *gs = rs + spanSize;
+				float *bs = gs + spanSize;
+
+				for( size_t j = 0; j < spanSize; ++j )
+				{
+					Color3f c( toFloat( rw[i+j] ), toFloat( gw[i+j] ), toFloat( bw[i+j] ) );
+					if( alpha && alpha[i+j] > 0 )
+					{
+						c /= toFloat( alpha[i+j] );
+					}
+					rs[j] = c[0];
+					gs[j] = c[1];
+					bs[j] = c[2];
+				}
+
+				transformSpan( spanSize, rs, gs, bs );
+
+				for( size_t j = 0; j < spanSize; ++j )
+				{
+					Color3f c( rs[j], gs[j], bs[j] );
+					if( alpha )
+					{
+						c *= toFloat( alpha[i+j] );
+					}
+					rw[i+j] = fromFloat( c[0] );
+					gw[i+j] = fromFloat( c[1] );
+					bw[i+j] = fromFloat( c[2] );
+				}
 			}
-			
-			*rw++ = c[0];
-			*gw++ = c[1];
-			*bw++ = c[2];
 		}
 	}
 	catch ( ... )
@@ -242,32 +285,52 @@ void ColorTransformOp::transformSeparate( Primitive * primitive, const CompoundO
 template<typename T>
 void ColorTransformOp::transformInterleaved( Primitive * primitive, const CompoundObject * operands, T * colors )
 {
+	typedef typename T::BaseType BaseType;
+
 	assert( colors->baseSize() %3 == 0 );
 	size_t numElements = colors->baseSize() / 3;
 
-	const typename T::BaseType *alpha = alphaData<TypedData<std::vector<typename T::BaseType> > >( primitive, numElements );
+	const BaseType *alpha = alphaData<TypedData<std::vector<BaseType> > >( primitive, numElements );
 
 	begin( operands );
 	try
 	{
-
-		size_t i = 0;
-		typename T::BaseType *data = colors->baseWritable();
-		for( i=0; i<numElements; i++ )
+		BaseType *data = colors->baseWritable();
+		std::vector<float> buffer( 3 * std::min( numElements, g_spanSize ) );
+		for( size_t i = 0; i < numElements; i += g_spanSize )
 		{
-			Color3f c( data[0], data[1], data[2] );
-			if( alpha && *alpha > 0 )
+			const size_t spanSize = std::min( g_spanSize, numElements - i );
+			float *rs = &buffer[0];
+			float *gs = rs + spanSize;
+			float *bs = gs + spanSize;
+
+			const BaseType *d = data + i * 3;
+			for( size_t j = 0; j < spanSize; ++j, d += 3 )
 			{
-				c /= *alpha;
+				Color3f c( d[0], d[1], d[2] );
+				if( alpha && alpha[i+j] > 0 )
+				{
+					c /= alpha[i+j];
+				}
+				rs[j] = c[0];
+				gs[j] = c[1];
+				bs[j] = c[2];
 			}
-			transform( c );
-			if( alpha )
+
+			transformSpan( spanSize, rs, gs, bs );
+
+			BaseType *w = data + i * 3;
+			for( size_t j = 0; j < spanSize; ++j )
 			{
-				c *= *alpha++;
+				Color3f c( rs[j], gs[j], bs[j] );
+				if( alpha )
+				{
+					c *= alpha[i+j];
+				}
+				*w++ = c[0];
+				*w++ = c[1];
+				*w++ = c[2];
 			}
-			*data++ = c[0];
-			*data++ = c[1];
-			*data++ = c[2];
 		}
 	}
 	catch ( ... )
@@ -357,6 +420,24 @@ void ColorTransformOp::modifyPrimitive( Primitive * primitive, const CompoundObj
 					static_cast<FloatVectorData *>( bIt->second.data.get() )
 				);
 				break;
+			case UCharDataTypeId :
+				transformSeparate<UCharData>(
+					primitive,
+					operands,
+					static_cast<UCharData *>( rIt->second.data.get() ),
+					static_cast<UCharData *>( gIt->second.data.get() ),
+					static_cast<UCharData *>( bIt->second.data.get() )
+				);
+				break;
+			case UCharVectorDataTypeId :
+				transformSeparate<UCharVectorData>(
+					primitive,
+					operands,
+					static_cast<UCharVectorData *>( rIt->second.data.get() ),
+					static_cast<UCharVectorData *>( gIt->second.data.get() ),
+					static_cast<UCharVectorData *>( bIt->second.data.get() )
+				);
+				break;
 			default :
 				throw Exception( "PrimitiveVariables have unsupported type." );
 				break;
@@ -365,10 +446,39 @@ void ColorTransformOp::modifyPrimitive( Primitive * primitive, const CompoundObj
 }
 
 
+void ColorTransformOp::transformColors( size_t n, float *r, float *g, float *b )
+{
+	const CompoundObject *operands = parameters()->getTypedValidatedValue<CompoundObject>();
+
+	begin( operands );
+	try
+	{
+		transformSpan( n, r, g, b );
+	}
+	catch ( ... )
+	{
+		end();
+		throw;
+	}
+	end();
+}
+
 void ColorTransformOp::begin( const CompoundObject * operands )
 {
 }
 
+void ColorTransformOp::transformSpan( size_t n, float *r, float *g, float *b ) const
+{
+	for( size_t i = 0; i < n; ++i )
+	{
+		Color3f c( r[i], g[i], b[i] );
+		transform( c );
+		r[i] = c[0];
+		g[i] = c[1];
+		b[i] = c[2];
+	}
+}
+
 void ColorTransformOp::end()
 {
 }
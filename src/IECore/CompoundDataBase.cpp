@@ -75,13 +75,14 @@ void CompoundDataBase::copyFrom( const Object *other, CopyContext *context )
 	CompoundDataMap &data = writable();
 	data.clear();
 	const CompoundDataMap &otherData = tOther->readable();
+	data.reserve( otherData.size() );
 	for( CompoundDataMap::const_iterator it = otherData.begin(); it!=otherData.end(); it++ )
 	{
 		if ( !it->second )
 		{
 			throw Exception( "Cannot copy CompoundData will NULL data pointers!" );
 		}
-		data[it->first] = context->copy<Data>( it->second.get() );
+		data.insert( data.end(), CompoundDataMap::value_type( it->first, context->copy<Data>( it->second.get() ) ) );
 	}
 }
 
@@ -163,11 +164,19 @@ void CompoundDataBase::load( LoadContextPtr context )
 
 	IndexedIO::EntryIDList memberNames;
 	container->entryIds( memberNames );
-	IndexedIO::EntryIDList::const_iterator it;
-	for( it=memberNames.begin(); it!=memberNames.end(); it++ )
+	std::vector<DataPtr> members;
+	context->load<Data>( container.get(), memberNames, members );
+	// Sorting first allows each member to be appended to the
+	// map, rather than inserted into the middle of it.
+	std::vector<CompoundDataMap::value_type> values;
+	values.reserve( memberNames.size() );
+	for( size_t i = 0; i < memberNames.size(); ++i )
 	{
-		m[*it] = context->load<Data>( container.get(), *it );
+		values.push_back( CompoundDataMap::value_type( memberNames[i], members[i] ) );
 	}
+	sort( values.begin(), values.end() );
+	m.reserve( values.size() );
+	m.insert( values.begin(), values.end() );
 }
 
 static inline bool comp( CompoundDataMap::const_iterator a, CompoundDataMap::const_iterator b )
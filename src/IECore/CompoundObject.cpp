@@ -69,13 +69,14 @@ void CompoundObject::copyFrom( const Object *other, CopyContext *context )
 	Object::copyFrom( other, context );
 	const CompoundObject *tOther = static_cast<const CompoundObject *>( other );
 	m_members.clear();
+	m_members.reserve( tOther->m_members.size() );
 	for( ObjectMap::const_iterator it=tOther->m_members.begin(); it!=tOther->m_members.end(); it++ )
 	{
 		if ( !it->second )
 		{
 			throw Exception( "Cannot copy CompoundObject will NULL data pointers!" );
 		}
-		m_members[it->first] = context->copy<Object>( it->second.get() );
+		m_members.insert( m_members.end(), ObjectMap::value_type( it->first, context->copy<Object>( it->second.get() ) ) );
 	}
 }
 
@@ -102,12 +103,20 @@ void CompoundObject::load( LoadContextPtr context )
 
 	IndexedIO::EntryIDList memberNames;
 	container->entryIds( memberNames );
-	IndexedIO::EntryIDList::const_iterator it;
-
-	for( it=memberNames.begin(); it!=memberNames.end(); it++ )
+	std::vector<ObjectPtr> members;
+	context->load<Object>( container.get(), memberNames, members );
+
+	// Sorting first allows each member to be appended to the
+	// map, rather than inserted into the middle of it.
+	std::vector<ObjectMap::value_type> values;
+	values.reserve( memberNames.size() );
+	for( size_t i = 0; i < memberNames.size(); ++i )
 	{
-		m_members[*it] = context->load<Object>( container.get(), *it );
+		values.push_back( ObjectMap::value_type( memberNames[i], members[i] ) );
 	}
+	sort( values.begin(), values.end() );
+	m_members.reserve( values.size() );
+	m_members.insert( values.begin(), values.end() );
 }
 
 bool CompoundObject::isEqualTo( const Object *other ) const
@@ -43,8 +43,99 @@
 #include "IECore/SimpleTypedData.h"
 #include "IECore/TypedObjectParameter.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Counts the influences above the threshold for a range of points.
+class CompressionCounter
+{
+
+	public :
+
+		CompressionCounter( float threshold, const std::vector<int> &offsets, const std::vector<int> &counts, const std::vector<float> &weights, std::vector<int> &newCounts )
+			:	m_threshold( threshold ), m_offsets( offsets ), m_counts( counts ), m_weights( weights ), m_newCounts( newCounts )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				int count = 0;
+				const int end = m_offsets[i] + m_counts[i];
+				for ( int current = m_offsets[i]; current < end; current++ )
+				{
+					if ( m_weights[current] > m_threshold )
+					{
+						count++;
+					}
+				}
+				m_newCounts[i] = count;
+			}
+		}
+
+	private :
+
+		float m_threshold;
+		const std::vector<int> &m_offsets;
+		const std::vector<int> &m_counts;
+		const std::vector<float> &m_weights;
+		std::vector<int> &m_newCounts;
+
+};
+
+// Copies the influences above the threshold for a range of points
+// into their new locations.
+class Compressor
+{
+
+	public :
+
+		Compressor( float threshold, const std::vector<int> &offsets, const std::vector<int> &counts, const std::vector<int> &indices, const std::vector<float> &weights, const std::vector<int> &newOffsets, std::vector<int> &newIndices, std::vector<float> &newWeights )
+			:	m_threshold( threshold ), m_offsets( offsets ), m_counts( counts ), m_indices( indices ), m_weights( weights ),
+				m_newOffsets( newOffsets ), m_newIndices( newIndices ), m_newWeights( newWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				int newCurrent = m_newOffsets[i];
+				const int end = m_offsets[i] + m_counts[i];
+				for ( int current = m_offsets[i]; current < end; current++ )
+				{
+					const float weight = m_weights[current];
+					if ( weight > m_threshold )
+					{
+						m_newIndices[newCurrent] = m_indices[current];
+						m_newWeights[newCurrent] = weight;
+						newCurrent++;
+					}
+				}
+			}
+		}
+
+	private :
+
+		float m_threshold;
+		const std::vector<int> &m_offsets;
+		const std::vector<int> &m_counts;
+		const std::vector<int> &m_indices;
+		const std::vector<float> &m_weights;
+		const std::vector<int> &m_newOffsets;
+		std::vector<int> &m_newIndices;
+		std::vector<float> &m_newWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( CompressSmoothSkinningDataOp );
 
 CompressSmoothSkinningDataOp::CompressSmoothSkinningDataOp()
@@ -71,49 +162,47 @@ void CompressSmoothSkinningDataOp::modify( Object * object, const CompoundObject
 {
 	SmoothSkinningData *skinningData = static_cast<SmoothSkinningData *>( object );
 	assert( skinningData );
-	
+
 	const float threshold = m_thresholdParameter->getNumericValue();
-	
+
 	const std::vector<int> &pointIndexOffsets = skinningData->pointIndexOffsets()->readable();
 	const std::vector<int> &pointInfluenceCounts = skinningData->pointInfluenceCounts()->readable();
 	const std::vector<int> &pointInfluenceIndices = skinningData->pointInfluenceIndices()->readable();
 	const std::vector<float> &pointInfluenceWeights = skinningData->pointInfluenceWeights()->readable();
-	
-	std::vector<int> newOffsets;
-	std::vector<int> newCounts;
-	std::vector<int> newIndices;
-	std::vector<float> newWeights;
-	
+
+	const size_t numPoints = pointIndexOffsets.size();
+
+	// count the influences to be kept for each point
+	std::vector<int> newCounts( numPoints );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numPoints, 1024 ),
+		CompressionCounter( threshold, pointIndexOffsets, pointInfluenceCounts, pointInfluenceWeights, newCounts )
+	);
+
+	std::vector<int> newOffsets( numPoints );
 	int offset = 0;
-	
-	for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
+	for ( size_t i=0; i < numPoints; i++ )
 	{
-		int count = 0;
-		
-		for ( int j=0; j < pointInfluenceCounts[i]; j++ )
-		{
-			int current = pointIndexOffsets[i] + j;
-			float weight = pointInfluenceWeights[current];
-			
-			if ( weight > threshold )
-			{
-				newIndices.push_back( pointInfluenceIndices[current] );
-				newWeights.push_back( weight );
-				count++;
-			}
-		}
-
-		newOffsets.push_back( offset );
-		newCounts.push_back( count );
-		offset += count;
+		newOffsets[i] = offset;
+		offset += newCounts[i];
 	}
-	
-	// replace the vectors on the SmoothSkinningData
-	if (  newWeights.size() != pointInfluenceWeights.size() )
+
+	// nothing to remove, so we can leave the data as it is
+	if ( (size_t)offset == pointInfluenceWeights.size() )
 	{
-		skinningData->pointIndexOffsets()->writable().swap( newOffsets );
-		skinningData->pointInfluenceCounts()->writable().swap( newCounts );
-		skinningData->pointInfluenceIndices()->writable().swap( newIndices );
-		skinningData->pointInfluenceWeights()->writable().swap( newWeights );
+		return;
 	}
+
+	std::vector<int> newIndices( offset );
+	std::vector<float> newWeights( offset );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numPoints, 1024 ),
+		Compressor( threshold, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights, newOffsets, newIndices, newWeights )
+	);
+
+	// replace the vectors on the SmoothSkinningData
+	skinningData->pointIndexOffsets()->writable().swap( newOffsets );
+	skinningData->pointInfluenceCounts()->writable().swap( newCounts );
+	skinningData->pointInfluenceIndices()->writable().swap( newIndices );
+	skinningData->pointInfluenceWeights()->writable().swap( newWeights );
 }
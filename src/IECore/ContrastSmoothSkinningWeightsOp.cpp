@@ -48,8 +48,90 @@
 #include "IECore/TypedObjectParameter.h"
 #include "IECore/Math.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Applies a contrast function to a range of the unlocked weights.
+template<typename Function>
+class WeightContraster
+{
+
+	public :
+
+		WeightContraster( const Function &function, const std::vector<bool> &locks, const std::vector<int> &pointInfluenceIndices, std::vector<float> &pointInfluenceWeights )
+			:	m_function( function ), m_locks( locks ), m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t current = r.begin(); current != r.end(); ++current )
+			{
+				if ( !m_locks[ m_pointInfluenceIndices[current] ] )
+				{
+					m_pointInfluenceWeights[current] = m_function( m_pointInfluenceWeights[current] );
+				}
+			}
+		}
+
+	private :
+
+		const Function &m_function;
+		const std::vector<bool> &m_locks;
+		const std::vector<int> &m_pointInfluenceIndices;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+// Applies a contrast function to the unlocked weights of a range of
+// the selected vertices.
+template<typename Function>
+class VertexContraster
+{
+
+	public :
+
+		VertexContraster( const Function &function, const std::vector<int64_t> &vertexIds, const std::vector<bool> &locks, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, std::vector<float> &pointInfluenceWeights )
+			:	m_function( function ), m_vertexIds( vertexIds ), m_locks( locks ), m_pointIndexOffsets( pointIndexOffsets ),
+				m_pointInfluenceCounts( pointInfluenceCounts ), m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				int currentVertId = m_vertexIds[i];
+				for ( int j=0; j < m_pointInfluenceCounts[currentVertId]; j++ )
+				{
+					int current = m_pointIndexOffsets[currentVertId] + j;
+					if ( !m_locks[ m_pointInfluenceIndices[current] ] )
+					{
+						m_pointInfluenceWeights[current] = m_function( m_pointInfluenceWeights[current] );
+					}
+				}
+			}
+		}
+
+	private :
+
+		const Function &m_function;
+		const std::vector<int64_t> &m_vertexIds;
+		const std::vector<bool> &m_locks;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( ContrastSmoothSkinningWeightsOp );
 
 ContrastSmoothSkinningWeightsOp::ContrastSmoothSkinningWeightsOp()
@@ -132,7 +214,7 @@ class ContrastSmoothSkinningWeightsOp::ContrastSmoothStep
 			m_norm = 0.5*m_firstHalfScale+0.5*m_secondHalfScale;
 		}
 
-		float operator()( float value )
+		float operator()( float value ) const
 		{
 			for ( int i = 0; i < m_iterations; i++ )
 			{
@@ -210,6 +292,11 @@ void ContrastSmoothSkinningWeightsOp::modify( Object * object, const CompoundObj
 	std::vector<int64_t> vertexIds;
 	m_vertexIdsParameter->getFrameListValue()->asList( vertexIds );
 	
+	// remove duplicates, so that each vertex is contrasted once and the
+	// vertices can be processed in parallel
+	std::sort( vertexIds.begin(), vertexIds.end() );
+	vertexIds.erase( std::unique( vertexIds.begin(), vertexIds.end() ), vertexIds.end() );
+	
 	// make sure all vertex ids are valid
 	for ( unsigned i=0; i < vertexIds.size(); i++ )
 	{
@@ -228,30 +315,18 @@ void ContrastSmoothSkinningWeightsOp::modify( Object * object, const CompoundObj
 	// an empty vertexId list means we operate over all vertices
 	if ( vertexIds.size() == 0 )
 	{
-		for ( unsigned int i=0; i < pointInfluenceWeights.size(); i++ )
-		{
-			unsigned int current = i;
-			if ( !locks[ pointInfluenceIndices[current] ] )
-			{
-				pointInfluenceWeights[current] = contrastFunction( pointInfluenceWeights[ current ] );
-			}
-		}
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, pointInfluenceWeights.size(), 4096 ),
+			WeightContraster<ContrastSmoothStep>( contrastFunction, locks, pointInfluenceIndices, pointInfluenceWeights )
+		);
 	}
 	else
 	{
 		// apply contrast with the per-influence locks
-		for ( unsigned i=0; i < vertexIds.size(); i++ )
-		{
-			int currentVertId = vertexIds[i];
-			for ( int j=0; j < pointInfluenceCounts[currentVertId]; j++ )
-			{
-				int current = pointIndexOffsets[currentVertId] + j;
-				if ( !locks[ pointInfluenceIndices[current] ] )
-				{
-					pointInfluenceWeights[current] = contrastFunction( pointInfluenceWeights[ current ] );
-				}
-			}
-		}
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, vertexIds.size(), 256 ),
+			VertexContraster<ContrastSmoothStep>( contrastFunction, vertexIds, locks, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights )
+		);
 	}
 	
 	// re-compress
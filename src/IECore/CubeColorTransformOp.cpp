@@ -42,6 +42,7 @@
 #include "IECore/MessageHandler.h"
 #include "IECore/Primitive.h"
 #include "IECore/Interpolator.h"
+#include "IECore/Exception.h"
 
 using namespace IECore;
 using namespace Imath;
@@ -88,3 +89,48 @@ void CubeColorTransformOp::transform( Imath::Color3f &color ) const
 	assert( m_data );
 	color = m_data->readable().operator()( color );
 }
+
+void CubeColorTransformOp::transformSpan( size_t n, float *r, float *g, float *b ) const
+{
+	assert( m_data );
+	m_data->readable()( n, r, g, b );
+}
+
+CubeColorLookupfDataPtr CubeColorTransformOp::bake( const std::vector<ColorTransformOpPtr> &transforms, const Imath::V3i &dimension, const Imath::Box3f &domain, CubeColorLookupf::Interpolation interpolation )
+{
+	if ( dimension.x < 2 || dimension.y < 2 || dimension.z < 2 )
+	{
+		throw InvalidArgumentException( "CubeColorTransformOp::bake : Dimension must be at least 2 in every axis" );
+	}
+
+	// Start with the lattice points themselves, in the layout used by CubeColorLookup.
+	const size_t n = dimension.x * dimension.y * dimension.z;
+	std::vector<float> r( n ), g( n ), b( n );
+	const V3f step = domain.size() / V3f( dimension - V3i( 1 ) );
+	size_t i = 0;
+	for( int x = 0; x < dimension.x; ++x )
+	{
+		for( int y = 0; y < dimension.y; ++y )
+		{
+			for( int z = 0; z < dimension.z; ++z, ++i )
+			{
+				r[i] = domain.min.x + step.x * x;
+				g[i] = domain.min.y + step.y * y;
+				b[i] = domain.min.z + step.z * z;
+			}
+		}
+	}
+
+	for( std::vector<ColorTransformOpPtr>::const_iterator it = transforms.begin(); it != transforms.end(); ++it )
+	{
+		(*it)->transformColors( n, &r[0], &g[0], &b[0] );
+	}
+
+	CubeColorLookupf::DataType data( n );
+	for( i = 0; i < n; ++i )
+	{
+		data[i] = Color3f( r[i], g[i], b[i] );
+	}
+
+	return new CubeColorLookupfData( CubeColorLookupf( dimension, data, domain, interpolation ) );
+}
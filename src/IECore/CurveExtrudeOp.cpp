@@ -37,6 +37,12 @@
 #include <math.h>
 #include <cassert>
 
+#include "boost/bind.hpp"
+#include "boost/function.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include "OpenEXR/ImathFrame.h"
 
 #include "IECore/Object.h"
@@ -556,31 +562,93 @@ PatchMeshPrimitivePtr CurveExtrudeOp::buildPatchMesh( const CurvesPrimitive * cu
 	return patchMesh;
 }
 
+namespace
+{
+
+struct PatchMeshBuilder
+{
+
+	typedef boost::function<PatchMeshPrimitivePtr ( unsigned, unsigned, unsigned )> BuildFunction;
+
+	PatchMeshBuilder( const BuildFunction &build, const std::vector<unsigned> &vertexOffsets, const std::vector<unsigned> &varyingOffsets, std::vector<PatchMeshPrimitivePtr> &patchMeshes )
+		:	m_build( build ), m_vertexOffsets( vertexOffsets ), m_varyingOffsets( varyingOffsets ), m_patchMeshes( patchMeshes )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<unsigned> &range ) const
+	{
+		for( unsigned curveIndex = range.begin(); curveIndex != range.end(); ++curveIndex )
+		{
+			m_patchMeshes[curveIndex] = m_build( curveIndex, m_vertexOffsets[curveIndex], m_varyingOffsets[curveIndex] );
+			assert( m_patchMeshes[curveIndex] );
+		}
+	}
+
+	const BuildFunction &m_build;
+	const std::vector<unsigned> &m_vertexOffsets;
+	const std::vector<unsigned> &m_varyingOffsets;
+	std::vector<PatchMeshPrimitivePtr> &m_patchMeshes;
+
+};
+
+} // namespace
+
 ObjectPtr CurveExtrudeOp::doOperation( const CompoundObject * operands )
 {
 	CurvesPrimitive * curves = m_curvesParameter->getTypedValue<CurvesPrimitive>();
 	assert( curves );
 	assert( curves->arePrimitiveVariablesValid() );
 
-	GroupPtr group = new Group();
+	// Expand any indexed primitive variables up front, so that
+	// buildPatchMesh() can index their data directly.
+	CurvesPrimitivePtr expandedCurves;
+	for( PrimitiveVariableMap::const_iterator it = curves->variables.begin(); it != curves->variables.end(); ++it )
+	{
+		if( !it->second.indices )
+		{
+			continue;
+		}
+		if( !expandedCurves )
+		{
+			expandedCurves = curves->copy();
+		}
+		expandedCurves->variables[it->first] = PrimitiveVariable( it->second.interpolation, it->second.expandedData() );
+	}
+	if( expandedCurves )
+	{
+		curves = expandedCurves.get();
+	}
 
 	const IntVectorData * verticesPerCurve = curves->verticesPerCurve();
 	assert( verticesPerCurve );
 
+	// Find where each curve's data starts, so that the curves
+	// can then be extruded independently in parallel.
+
 	unsigned numCurves = verticesPerCurve->readable().size();
+	std::vector<unsigned> vertexOffsets( numCurves );
+	std::vector<unsigned> varyingOffsets( numCurves );
 	unsigned vertexOffset = 0;
 	unsigned varyingOffset = 0;
 	for ( unsigned curveIndex = 0; curveIndex < numCurves; curveIndex++ )
 	{
-		int numVertices = curves->variableSize( PrimitiveVariable::Vertex, curveIndex );
-
-		PatchMeshPrimitivePtr patchMesh = buildPatchMesh( curves, curveIndex, vertexOffset, varyingOffset );
-		assert( patchMesh );
+		vertexOffsets[curveIndex] = vertexOffset;
+		varyingOffsets[curveIndex] = varyingOffset;
+		vertexOffset += curves->variableSize( PrimitiveVariable::Vertex, curveIndex );
+		varyingOffset += curves->variableSize( PrimitiveVariable::Varying, curveIndex );
+	}
 
-		group->addChild( patchMesh );
+	std::vector<PatchMeshPrimitivePtr> patchMeshes( numCurves );
+	const PatchMeshBuilder::BuildFunction build = boost::bind( &CurveExtrudeOp::buildPatchMesh, this, curves, _1, _2, _3 );
+	tbb::parallel_for(
+		tbb::blocked_range<unsigned>( 0, numCurves ),
+		PatchMeshBuilder( build, vertexOffsets, varyingOffsets, patchMeshes )
+	);
 
-		vertexOffset += numVertices;
-		varyingOffset += curves->variableSize( PrimitiveVariable::Varying, curveIndex );
+	GroupPtr group = new Group();
+	for( std::vector<PatchMeshPrimitivePtr>::const_iterator it = patchMeshes.begin(), eIt = patchMeshes.end(); it != eIt; ++it )
+	{
+		group->addChild( *it );
 	}
 
 	assert( group->children().size() == numCurves );
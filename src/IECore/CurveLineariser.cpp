@@ -33,12 +33,25 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/format.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/mpl/or.hpp"
+#include "boost/mpl/and.hpp"
+#include "boost/type_traits/is_floating_point.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include "OpenEXR/ImathFun.h"
+
+#include <algorithm>
 
 #include "IECore/CurveLineariser.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/FastFloat.h"
-#include "IECore/CurvesPrimitiveEvaluator.h"
 #include "IECore/MessageHandler.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/DataAlgo.h"
+#include "IECore/LineSegment.h"
 
 using namespace IECore;
 using namespace Imath;
@@ -55,8 +68,27 @@ CurveLineariser::CurveLineariser()
 		10.0f,
 		0.0f
 	);
-	
+
+	FloatParameterPtr maxErrorParameter = new FloatParameter(
+		"maxError",
+		"When greater than zero, vertices are placed adaptively so that "
+		"the linear curves deviate from the originals by no more than this "
+		"distance, and verticesPerSegment is ignored.",
+		0.0f,
+		0.0f
+	);
+
+	M44fParameterPtr errorTransformParameter = new M44fParameter(
+		"errorTransform",
+		"A transform applied to the curves before measuring the error for "
+		"adaptive linearisation. This may be a projection into raster space, "
+		"so that maxError is specified in pixels.",
+		M44f()
+	);
+
 	parameters()->addParameter( verticesPerSegmentParameter );
+	parameters()->addParameter( maxErrorParameter );
+	parameters()->addParameter( errorTransformParameter );
 }
 
 CurveLineariser::~CurveLineariser()
@@ -72,124 +104,524 @@ const FloatParameter * CurveLineariser::verticesPerSegmentParameter() const
 {
 	return parameters()->parameter<FloatParameter>( "verticesPerSegment" );
 }
-		
-void CurveLineariser::modifyTypedPrimitive( CurvesPrimitive * curves, const CompoundObject * operands )
+
+FloatParameter * CurveLineariser::maxErrorParameter()
 {
-	if( curves->basis()==CubicBasisf::linear() )
+	return parameters()->parameter<FloatParameter>( "maxError" );
+}
+
+const FloatParameter * CurveLineariser::maxErrorParameter() const
+{
+	return parameters()->parameter<FloatParameter>( "maxError" );
+}
+
+M44fParameter * CurveLineariser::errorTransformParameter()
+{
+	return parameters()->parameter<M44fParameter>( "errorTransform" );
+}
+
+const M44fParameter * CurveLineariser::errorTransformParameter() const
+{
+	return parameters()->parameter<M44fParameter>( "errorTransform" );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Resampling of primitive variables
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// The indices and weights needed to evaluate vertex and varying
+// data at a particular position on the input curves.
+struct Sample
+{
+	size_t vertexIndices[4];
+	float vertexCoefficients[4];
+	size_t varyingIndices[2];
+	float varyingT;
+};
+
+// Describes a single input curve.
+struct Curve
+{
+	int numVertices;
+	unsigned numSegments;
+	size_t vertexOffset;
+	size_t varyingOffset;
+};
+
+void computeSample( const CubicBasisf &basis, bool periodic, const Curve &curve, float v, Sample &sample )
+{
+	const float vv = v * curve.numSegments;
+	const unsigned segment = std::min( (unsigned)fastFloatFloor( vv ), curve.numSegments - 1 );
+	const float t = vv - segment;
+
+	basis.coefficients( t, sample.vertexCoefficients );
+	const unsigned i = segment * basis.step;
+	for( unsigned k = 0; k < 4; ++k )
 	{
-		return;
+		sample.vertexIndices[k] = curve.vertexOffset + ( periodic ? ( i + k ) % curve.numVertices : i + k );
 	}
-	
-	CurvesPrimitiveEvaluatorPtr evaluator = new CurvesPrimitiveEvaluator( curves );
-	PrimitiveEvaluator::ResultPtr evaluatorResult = evaluator->createResult();
-	
-	std::vector<PrimitiveVariable> primitiveVariables;
-	std::vector<TypeId> primitiveVariableTypes;
-	std::vector<void *> primitiveVariableVectors;
-	for( PrimitiveVariableMap::iterator it=curves->variables.begin(); it!=curves->variables.end(); it++ )
-	{
-		switch( it->second.interpolation )
+
+	sample.varyingIndices[0] = curve.varyingOffset + segment;
+	sample.varyingIndices[1] = curve.varyingOffset + ( periodic ? ( segment + 1 ) % curve.numSegments : segment + 1 );
+	sample.varyingT = t;
+}
+
+// Types which can be resampled by taking a weighted sum of the input values.
+template<typename T>
+struct IsWeightable : boost::mpl::and_<
+	TypeTraits::IsVectorTypedData<T>,
+	boost::mpl::or_<
+		TypeTraits::IsFloatVectorTypedData<T>,
+		TypeTraits::IsFloatVec2VectorTypedData<T>,
+		TypeTraits::IsFloatVec3VectorTypedData<T>,
+		boost::mpl::and_< TypeTraits::IsColor<typename TypeTraits::VectorValueType<T>::type>, boost::is_floating_point<typename T::BaseType> >
+	>
+> {};
+
+class Resampler
+{
+
+	public :
+
+		virtual ~Resampler()
 		{
-			case PrimitiveVariable::Invalid :
-			case PrimitiveVariable::Constant :
-			case PrimitiveVariable::Uniform :
-				// we don't need to process these as they're not interpolated
-				continue;
-			default :
-				// fall through to process the variable
-				;
 		}
-		
-		switch( it->second.data->typeId() )
+
+		/// Writes the value at the sample into element index of the output.
+		virtual void resample( const Sample &sample, size_t index ) = 0;
+
+		/// The output data, which must be resized before calling resample().
+		DataPtr output;
+
+};
+
+typedef boost::shared_ptr<Resampler> ResamplerPtr;
+
+template<typename T, bool weightable>
+class TypedResampler : public Resampler
+{
+
+	public :
+
+		TypedResampler( const std::vector<T> &input, std::vector<T> &output, bool vertex )
+			:	m_input( input ), m_output( output ), m_vertex( vertex )
+		{
+		}
+
+		virtual void resample( const Sample &sample, size_t index )
 		{
-			case V3fVectorDataTypeId :
+			if( m_vertex )
 			{
-				primitiveVariables.push_back( evaluator->primitive()->variables.find( it->first )->second );
-				primitiveVariableTypes.push_back( V3fVectorDataTypeId );
-				std::vector<V3f> &v = static_cast<V3fVectorData *>( it->second.data.get() )->writable();
-				v.clear();
-				primitiveVariableVectors.push_back( &v );
-				break;
+				T value = m_input[sample.vertexIndices[0]] * sample.vertexCoefficients[0];
+				value += m_input[sample.vertexIndices[1]] * sample.vertexCoefficients[1];
+				value += m_input[sample.vertexIndices[2]] * sample.vertexCoefficients[2];
+				value += m_input[sample.vertexIndices[3]] * sample.vertexCoefficients[3];
+				m_output[index] = value;
 			}
-			case FloatVectorDataTypeId :
+			else
 			{
-				primitiveVariables.push_back( evaluator->primitive()->variables.find( it->first )->second );
-				primitiveVariableTypes.push_back( FloatVectorDataTypeId );
-				std::vector<float> &v = static_cast<FloatVectorData *>( it->second.data.get() )->writable();
-				v.clear();
-				primitiveVariableVectors.push_back( &v );
-				break;
+				T value = m_input[sample.varyingIndices[0]] * ( 1.0f - sample.varyingT );
+				value += m_input[sample.varyingIndices[1]] * sample.varyingT;
+				m_output[index] = value;
 			}
-			case IntVectorDataTypeId :
+		}
+
+	private :
+
+		const std::vector<T> &m_input;
+		std::vector<T> &m_output;
+		bool m_vertex;
+
+};
+
+// Types which can't be weighted take the value from the nearest input vertex.
+template<typename T>
+class TypedResampler<T, false> : public Resampler
+{
+
+	public :
+
+		TypedResampler( const std::vector<T> &input, std::vector<T> &output, bool vertex )
+			:	m_input( input ), m_output( output ), m_vertex( vertex )
+		{
+		}
+
+		virtual void resample( const Sample &sample, size_t index )
+		{
+			if( m_vertex )
 			{
-				primitiveVariables.push_back( evaluator->primitive()->variables.find( it->first )->second );
-				primitiveVariableTypes.push_back( IntVectorDataTypeId );
-				std::vector<int> &v = static_cast<IntVectorData *>( it->second.data.get() )->writable();
-				v.clear();
-				primitiveVariableVectors.push_back( &v );
-				break;
+				const float *c = sample.vertexCoefficients;
+				const int nearest = std::max_element( c, c + 4 ) - c;
+				m_output[index] = m_input[sample.vertexIndices[nearest]];
 			}
-			case Color3fVectorDataTypeId :
+			else
 			{
-				primitiveVariables.push_back( evaluator->primitive()->variables.find( it->first )->second );
-				primitiveVariableTypes.push_back( Color3fVectorDataTypeId );
-				std::vector<Color3f> &v = static_cast<Color3fVectorData *>( it->second.data.get() )->writable();
+				m_output[index] = m_input[sample.varyingIndices[sample.varyingT < 0.5f ? 0 : 1]];
+			}
+		}
+
+	private :
+
+		const std::vector<T> &m_input;
+		std::vector<T> &m_output;
+		bool m_vertex;
+
+};
+
+struct CreateResampler
+{
+
+	typedef ResamplerPtr ReturnType;
+
+	CreateResampler( size_t size, bool vertex )
+		:	m_size( size ), m_vertex( vertex )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( T *data ) const
+	{
+		typedef typename T::ValueType::value_type Value;
+
+		typename T::Ptr output = new T;
+		output->writable().resize( m_size );
+		setGeometricInterpretation( output.get(), getGeometricInterpretation( data ) );
+
+		ResamplerPtr result( new TypedResampler<Value, IsWeightable<T>::value>( data->readable(), output->writable(), m_vertex ) );
+		result->output = output;
+		return result;
+	}
+
+	size_t m_size;
+	bool m_vertex;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Placement of vertices
+//////////////////////////////////////////////////////////////////////////
+
+// Spans are subdivided at most this many times when linearising adaptively.
+const int g_maxSubdivisionDepth = 10;
+
+class VertexPlacer
+{
+
+	public :
+
+		VertexPlacer( const CurvesPrimitive *curves, float verticesPerSegment, float maxError, const M44f &errorTransform )
+			:	m_basis( curves->basis() ), m_periodic( curves->periodic() ),
+				m_verticesPerSegment( verticesPerSegment ), m_maxError( maxError ), m_errorTransform( errorTransform ),
+				m_p( 0 )
+		{
+			if( m_maxError > 0.0f )
+			{
+				const V3fVectorData *p = curves->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+				if( !p )
+				{
+					throw InvalidArgumentException( "CurveLineariser : Adaptive linearisation requires vertex primitive variable \"P\"" );
+				}
+				m_p = &p->readable();
+			}
+		}
+
+		/// Fills v with the curve parameters for the vertices of the linearised curve.
+		void place( const Curve &curve, std::vector<float> &v ) const
+		{
+			v.clear();
+			if( m_maxError > 0.0f )
+			{
+				v.push_back( 0.0f );
+				for( unsigned segment = 0; segment < curve.numSegments; ++segment )
+				{
+					const float v0 = (float)segment / curve.numSegments;
+					const float v1 = (float)( segment + 1 ) / curve.numSegments;
+					subdivide( curve, v0, point( curve, v0 ), v1, point( curve, v1 ), 0, v );
+				}
+				if( m_periodic )
+				{
+					// the end of the curve is the same as the start
+					v.pop_back();
+				}
+				if( v.size() >= minVertices() )
+				{
+					return;
+				}
 				v.clear();
-				primitiveVariableVectors.push_back( &v );
-				break;
 			}
-			default :
-				msg(
-					Msg::Warning,
-					"CurveLineariser::modifyTypedPrimitive",
-					boost::format( "Ignoring primitive variable \"%s\" with unsupported type \"%s\"" ) % it->first % it->second.data->typeName()
+
+			int numVertices = fastFloatFloor( m_verticesPerSegment * (float)curve.numSegments );
+			numVertices = std::max( numVertices, (int)minVertices() );
+
+			float vStep = m_periodic ? ( 1.0f / (float)( numVertices ) ) : ( 1.0f / (float)( numVertices - 1 ) );
+			v.reserve( numVertices );
+			for( int i=0; i<numVertices; i++ )
+			{
+				v.push_back( std::min( vStep * i, 1.0f ) );
+			}
+		}
+
+	private :
+
+		size_t minVertices() const
+		{
+			return m_periodic ? 3 : 2;
+		}
+
+		/// Returns the point at v, transformed into the space in which error is measured.
+		V3f point( const Curve &curve, float v ) const
+		{
+			Sample sample;
+			computeSample( m_basis, m_periodic, curve, v, sample );
+			V3f p = (*m_p)[sample.vertexIndices[0]] * sample.vertexCoefficients[0];
+			for( int i = 1; i < 4; ++i )
+			{
+				p += (*m_p)[sample.vertexIndices[i]] * sample.vertexCoefficients[i];
+			}
+
+			V3f result;
+			m_errorTransform.multVecMatrix( p, result );
+			return result;
+		}
+
+		/// Appends the end of the span from v0 to v1, preceded by any vertices needed
+		/// to keep within the maximum error. The error is measured at the thirds of the
+		/// span, so that S shaped spans which cross the chord at their middle are refined.
+		void subdivide( const Curve &curve, float v0, const V3f &p0, float v1, const V3f &p1, int depth, std::vector<float> &v ) const
+		{
+			if( depth < g_maxSubdivisionDepth )
+			{
+				const LineSegment3f chord( p0, p1 );
+				const float error = std::max(
+					chord.distanceTo( point( curve, lerp( v0, v1, 1.0f / 3.0f ) ) ),
+					chord.distanceTo( point( curve, lerp( v0, v1, 2.0f / 3.0f ) ) )
 				);
+
+				if( error > m_maxError )
+				{
+					const float vm = ( v0 + v1 ) * 0.5f;
+					const V3f pm = point( curve, vm );
+					subdivide( curve, v0, p0, vm, pm, depth + 1, v );
+					subdivide( curve, vm, pm, v1, p1, depth + 1, v );
+					return;
+				}
+			}
+
+			v.push_back( v1 );
+		}
+
+		const CubicBasisf &m_basis;
+		bool m_periodic;
+		float m_verticesPerSegment;
+		float m_maxError;
+		M44f m_errorTransform;
+		const std::vector<V3f> *m_p;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Parallel passes
+//////////////////////////////////////////////////////////////////////////
+
+// First pass. Chooses the vertices for each curve, storing their parameters
+// only when they can't be cheaply recomputed in the second pass.
+class PlaceVertices
+{
+
+	public :
+
+		PlaceVertices( const std::vector<Curve> &curves, const VertexPlacer &placer, bool storeParameters, std::vector<int> &newVerticesPerCurve, std::vector<std::vector<float> > &parameters )
+			:	m_curves( curves ), m_placer( placer ), m_storeParameters( storeParameters ), m_newVerticesPerCurve( newVerticesPerCurve ), m_parameters( parameters )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			std::vector<float> v;
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_placer.place( m_curves[i], v );
+				m_newVerticesPerCurve[i] = v.size();
+				if( m_storeParameters )
+				{
+					m_parameters[i] = v;
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<Curve> &m_curves;
+		const VertexPlacer &m_placer;
+		bool m_storeParameters;
+		std::vector<int> &m_newVerticesPerCurve;
+		std::vector<std::vector<float> > &m_parameters;
+
+};
+
+// Second pass. Fills in the primitive variables for each curve, starting
+// at the offsets given by the first pass.
+class ResampleCurves
+{
+
+	public :
+
+		ResampleCurves( const std::vector<Curve> &curves, const VertexPlacer &placer, const CubicBasisf &basis, bool periodic, const std::vector<std::vector<float> > &parameters, const std::vector<size_t> &newVertexOffsets, const std::vector<ResamplerPtr> &resamplers )
+			:	m_curves( curves ), m_placer( placer ), m_basis( basis ), m_periodic( periodic ), m_parameters( parameters ), m_newVertexOffsets( newVertexOffsets ), m_resamplers( resamplers )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			std::vector<float> placed;
+			Sample sample;
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const std::vector<float> *v = &placed;
+				if( m_parameters.size() )
+				{
+					v = &m_parameters[i];
+				}
+				else
+				{
+					m_placer.place( m_curves[i], placed );
+				}
+
+				size_t index = m_newVertexOffsets[i];
+				for( std::vector<float>::const_iterator it = v->begin(), eIt = v->end(); it != eIt; ++it, ++index )
+				{
+					computeSample( m_basis, m_periodic, m_curves[i], *it, sample );
+					for( std::vector<ResamplerPtr>::const_iterator rIt = m_resamplers.begin(), reIt = m_resamplers.end(); rIt != reIt; ++rIt )
+					{
+						(*rIt)->resample( sample, index );
+					}
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<Curve> &m_curves;
+		const VertexPlacer &m_placer;
+		const CubicBasisf &m_basis;
+		bool m_periodic;
+		const std::vector<std::vector<float> > &m_parameters;
+		const std::vector<size_t> &m_newVertexOffsets;
+		const std::vector<ResamplerPtr> &m_resamplers;
+
+};
+
+} // namespace
+
+void CurveLineariser::modifyTypedPrimitive( CurvesPrimitive * curves, const CompoundObject * operands )
+{
+	if( curves->basis()==CubicBasisf::linear() )
+	{
+		return;
+	}
+
+	// the resamplers and the vertex placer index the data directly,
+	// so expand any indexed primitive variables first.
+	for( PrimitiveVariableMap::iterator it=curves->variables.begin(); it!=curves->variables.end(); it++ )
+	{
+		if( it->second.indices )
+		{
+			it->second = PrimitiveVariable( it->second.interpolation, it->second.expandedData() );
 		}
 	}
-	
-	size_t numCurves = curves->numCurves();
-	bool periodic = curves->periodic();
-	
+
+	const bool periodic = curves->periodic();
+	const float verticesPerSegment = operands->member<FloatData>( "verticesPerSegment" )->readable();
+	const float maxError = operands->member<FloatData>( "maxError" )->readable();
+	const M44f &errorTransform = operands->member<M44fData>( "errorTransform" )->readable();
+
+	const std::vector<int> &verticesPerCurve = curves->verticesPerCurve()->readable();
+	const size_t numCurves = verticesPerCurve.size();
+	std::vector<Curve> inputCurves( numCurves );
+	size_t vertexOffset = 0;
+	size_t varyingOffset = 0;
+	for( size_t i = 0; i < numCurves; ++i )
+	{
+		Curve &curve = inputCurves[i];
+		curve.numVertices = verticesPerCurve[i];
+		curve.numSegments = curves->numSegments( i );
+		curve.vertexOffset = vertexOffset;
+		curve.varyingOffset = varyingOffset;
+		vertexOffset += curve.numVertices;
+		varyingOffset += curves->variableSize( PrimitiveVariable::Varying, i );
+	}
+
+	// first pass : decide how many vertices each curve needs. When placing vertices
+	// adaptively we store their parameters, but otherwise it's cheaper to recompute them.
+
+	const VertexPlacer placer( curves, verticesPerSegment, maxError, errorTransform );
 	IntVectorDataPtr newVerticesPerCurveData = new IntVectorData();
 	std::vector<int> &newVerticesPerCurve = newVerticesPerCurveData->writable();
 	newVerticesPerCurve.resize( numCurves );
-	
-	float verticesPerSegment = operands->member<FloatData>( "verticesPerSegment" )->readable();
-	
-	for( size_t curveIndex=0; curveIndex<numCurves; curveIndex++ )
+	std::vector<std::vector<float> > parameters( maxError > 0.0f ? numCurves : 0 );
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numCurves ),
+		PlaceVertices( inputCurves, placer, maxError > 0.0f, newVerticesPerCurve, parameters )
+	);
+
+	std::vector<size_t> newVertexOffsets( numCurves );
+	size_t numNewVertices = 0;
+	for( size_t i = 0; i < numCurves; ++i )
 	{
-		int numVertices = fastFloatFloor( verticesPerSegment * (float)curves->numSegments( curveIndex ) );
-		numVertices = std::max( numVertices, periodic ? 3 : 2 );
-		
-		float vStep = periodic ? ( 1.0f / (float)( numVertices ) ) : ( 1.0f / (float)( numVertices - 1 ) );
-		for( int i=0; i<numVertices; i++ )
-		{
-			float v = std::min( vStep * i, 1.0f );
-			evaluator->pointAtV( curveIndex, v, evaluatorResult.get() );
-			for( size_t j=0; j<primitiveVariables.size(); j++ )
-			{
-				switch( primitiveVariableTypes[j] )
-				{
-					case V3fVectorDataTypeId :
-						static_cast<std::vector<V3f> *>( primitiveVariableVectors[j] )->push_back( evaluatorResult->vectorPrimVar( primitiveVariables[j] ) );
-						break;
-					case FloatVectorDataTypeId :
-						static_cast<std::vector<float> *>( primitiveVariableVectors[j] )->push_back( evaluatorResult->floatPrimVar( primitiveVariables[j] ) );
-						break;
-					case IntVectorDataTypeId :
-						static_cast<std::vector<int> *>( primitiveVariableVectors[j] )->push_back( evaluatorResult->intPrimVar( primitiveVariables[j] ) );
-						break;
-					case Color3fVectorDataTypeId :
-						static_cast<std::vector<Color3f> *>( primitiveVariableVectors[j] )->push_back( evaluatorResult->colorPrimVar( primitiveVariables[j] ) );
-						break;
-					default :
-						assert( 0 ); // shouldn't get here
-				}
-			}
+		newVertexOffsets[i] = numNewVertices;
+		numNewVertices += newVerticesPerCurve[i];
+	}
+
+	// allocate the new primitive variables. the linear curves have a
+	// varying value for each vertex, so all interpolated variables are the same size.
+
+	std::vector<ResamplerPtr> resamplers;
+	std::vector<PrimitiveVariable *> resampledVariables;
+	for( PrimitiveVariableMap::iterator it=curves->variables.begin(); it!=curves->variables.end(); it++ )
+	{
+		switch( it->second.interpolation )
+		{
+			case PrimitiveVariable::Invalid :
+			case PrimitiveVariable::Constant :
+			case PrimitiveVariable::Uniform :
+				// we don't need to process these as they're not interpolated
+				continue;
+			default :
+				// fall through to process the variable
+				;
 		}
-		
-		newVerticesPerCurve[curveIndex] = numVertices;
+
+		CreateResampler createResampler( numNewVertices, it->second.interpolation == PrimitiveVariable::Vertex );
+		ResamplerPtr resampler = despatchTypedData<CreateResampler, TypeTraits::IsVectorTypedData, DespatchTypedDataIgnoreError>( it->second.data.get(), createResampler );
+		if( !resampler )
+		{
+			msg(
+				Msg::Warning,
+				"CurveLineariser::modifyTypedPrimitive",
+				boost::format( "Ignoring primitive variable \"%s\" with unsupported type \"%s\"" ) % it->first % it->second.data->typeName()
+			);
+			continue;
+		}
+
+		resamplers.push_back( resampler );
+		resampledVariables.push_back( &it->second );
 	}
-	
+
+	// second pass : fill in the primitive variables.
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numCurves ),
+		ResampleCurves( inputCurves, placer, curves->basis(), periodic, parameters, newVertexOffsets, resamplers )
+	);
+
+	for( size_t i = 0; i < resamplers.size(); ++i )
+	{
+		resampledVariables[i]->data = resamplers[i]->output;
+	}
+
 	curves->setTopology( newVerticesPerCurveData, CubicBasisf::linear(), periodic );
 }
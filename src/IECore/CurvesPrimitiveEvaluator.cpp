@@ -32,10 +32,17 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_arena.h"
+
 #include "OpenEXR/ImathFun.h"
 
 #include "IECore/CurvesPrimitiveEvaluator.h"
 #include "IECore/CurvesPrimitive.h"
+#include "IECore/BoxOps.h"
 #include "IECore/Exception.h"
 #include "IECore/FastFloat.h"
 #include "IECore/LineSegment.h"
@@ -87,6 +94,13 @@ CurvesPrimitiveEvaluator::Result::Result( PrimitiveVariable p, bool linear, bool
 	}
 }
 
+// Returns the index into pv.data for the specified element,
+// taking account of any indices.
+static inline unsigned dataIndex( const PrimitiveVariable &pv, unsigned element )
+{
+	return pv.indices ? pv.indices->readable()[element] : element;
+}
+
 template<class T>
 T CurvesPrimitiveEvaluator::Result::primVar( const PrimitiveVariable &primVar, const float *coefficients ) const
 {
@@ -94,6 +108,11 @@ T CurvesPrimitiveEvaluator::Result::primVar( const PrimitiveVariable &primVar, c
 	{
 		case PrimitiveVariable::Constant :
 			{
+				if( primVar.indices )
+				{
+					const vector<T> &d = static_cast<TypedData<vector<T> > *>( primVar.data.get() )->readable();
+					return d[dataIndex( primVar, 0 )];
+				}
 				const TypedData<T> *d = static_cast<TypedData<T> *>( primVar.data.get() );
 				return d->readable();
 			}
@@ -101,7 +120,7 @@ T CurvesPrimitiveEvaluator::Result::primVar( const PrimitiveVariable &primVar, c
 		case PrimitiveVariable::Uniform :
 			{
 				const vector<T> &d = static_cast<TypedData<vector<T> > *>( primVar.data.get() )->readable();
-				return d[m_curveIndex];
+				return d[dataIndex( primVar, m_curveIndex )];
 			}
 		case PrimitiveVariable::Vertex :
 			{
@@ -109,22 +128,22 @@ T CurvesPrimitiveEvaluator::Result::primVar( const PrimitiveVariable &primVar, c
 				
 				if ( m_linear )
 				{
-					return	(T)( coefficients[0] * d[m_vertexDataIndices[0]] +
-						coefficients[1] * d[m_vertexDataIndices[1]] );
+					return	(T)( coefficients[0] * d[dataIndex( primVar, m_vertexDataIndices[0] )] +
+						coefficients[1] * d[dataIndex( primVar, m_vertexDataIndices[1] )] );
 				}
 				else
 				{
-					return	(T)( coefficients[0] * d[m_vertexDataIndices[0]] +
-						coefficients[1] * d[m_vertexDataIndices[1]] +
-						coefficients[2] * d[m_vertexDataIndices[2]] +
-						coefficients[3] * d[m_vertexDataIndices[3]] );
+					return	(T)( coefficients[0] * d[dataIndex( primVar, m_vertexDataIndices[0] )] +
+						coefficients[1] * d[dataIndex( primVar, m_vertexDataIndices[1] )] +
+						coefficients[2] * d[dataIndex( primVar, m_vertexDataIndices[2] )] +
+						coefficients[3] * d[dataIndex( primVar, m_vertexDataIndices[3] )] );
 				}
 			}
 		case PrimitiveVariable::Varying :
 		case PrimitiveVariable::FaceVarying :
 			{
 				const vector<T> &d = static_cast<TypedData<vector<T> > *>( primVar.data.get() )->readable();
-				return lerp( d[m_varyingDataIndices[0]], d[m_varyingDataIndices[1]], m_segmentV );
+				return lerp( d[dataIndex( primVar, m_varyingDataIndices[0] )], d[dataIndex( primVar, m_varyingDataIndices[1] )], m_segmentV );
 			}
 		default :
 			throw InvalidArgumentException( "PrimitiveVariable has invalid interpolation" );
@@ -299,9 +318,13 @@ void CurvesPrimitiveEvaluator::Result::init( unsigned curveIndex, float v, const
 struct CurvesPrimitiveEvaluator::Line
 {
 	public :
-	
-		Line( const V3f &p1, const V3f &p2, unsigned curveIndex, float vMin, float vMax )
-			:	m_lineSegment( p1, p2 ), m_curveIndex( curveIndex ), m_vMin( vMin ), m_vMax( vMax )
+
+		Line()
+		{
+		}
+
+		Line( const V3f &p1, const V3f &p2, unsigned curveIndex, float vMin, float vMax, float radiusMin, float radiusMax )
+			:	m_lineSegment( p1, p2 ), m_curveIndex( curveIndex ), m_vMin( vMin ), m_vMax( vMax ), m_radiusMin( radiusMin ), m_radiusMax( radiusMax )
 		{
 		}
 	
@@ -311,6 +334,60 @@ struct CurvesPrimitiveEvaluator::Line
 		int curveIndex() const { return m_curveIndex; }
 		float vMin() const { return m_vMin; }
 		float vMax() const { return m_vMax; }
+		/// Half the curve width at vMin and vMax.
+		float radiusMin() const { return m_radiusMin; }
+		float radiusMax() const { return m_radiusMax; }
+
+		/// Bound of the tube around the line.
+		Box3f bound() const
+		{
+			Box3f b;
+			b.extendBy( m_lineSegment.p0 - V3f( m_radiusMin ) );
+			b.extendBy( m_lineSegment.p0 + V3f( m_radiusMin ) );
+			b.extendBy( m_lineSegment.p1 - V3f( m_radiusMax ) );
+			b.extendBy( m_lineSegment.p1 + V3f( m_radiusMax ) );
+			return b;
+		}
+
+		/// Returns true if the ray passes through the tube around the line, setting
+		/// rayT to the distance along the ray of its closest approach to the line, and
+		/// v to the curve parameter at that point. The ray direction must be normalised.
+		bool intersect( const Line3f &ray, float &rayT, float &v ) const
+		{
+			// find the parameters s and t of the closest points p0 + s * u and
+			// ray.pos + t * ray.dir, first for the infinite lines and then clamping
+			// to the segment and ray.
+			const V3f u = m_lineSegment.p1 - m_lineSegment.p0;
+			const V3f w = ray.pos - m_lineSegment.p0;
+			const float a = u.dot( u );
+			const float b = u.dot( ray.dir );
+			const float d = u.dot( w );
+			const float e = ray.dir.dot( w );
+
+			const float denominator = a - b * b;
+			float s = 0.0f;
+			if( denominator > 1e-8f * a )
+			{
+				s = clamp( ( d - b * e ) / denominator, 0.0f, 1.0f );
+			}
+
+			float t = s * b - e;
+			if( t < 0.0f )
+			{
+				t = 0.0f;
+				s = a > 0.0f ? clamp( d / a, 0.0f, 1.0f ) : 0.0f;
+			}
+
+			const float radius = lerp( m_radiusMin, m_radiusMax, s );
+			if( ( w + t * ray.dir - s * u ).length2() > radius * radius )
+			{
+				return false;
+			}
+
+			rayT = t;
+			v = lerp( m_vMin, m_vMax, s );
+			return true;
+		}
 	
 		static int linesPerCurveSegment() { return 20; };
 	
@@ -320,16 +397,151 @@ struct CurvesPrimitiveEvaluator::Line
 		int m_curveIndex;
 		float m_vMin;
 		float m_vMax;
+		float m_radiusMin;
+		float m_radiusMax;
 		
 };
+
+struct CurvesPrimitiveEvaluator::RayHit
+{
+
+	RayHit( float maxDistance = Imath::limits<float>::max() )
+		:	distance( maxDistance ), curveIndex( 0 ), v( -1 )
+	{
+	}
+
+	bool operator < ( const RayHit &other ) const
+	{
+		return distance < other.distance;
+	}
+
+	float distance;
+	unsigned curveIndex;
+	float v;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Implementation of CurvesPrimitiveEvaluator::TreeBuilder
+//////////////////////////////////////////////////////////////////////////
+
+// Linearises the curves into the tree lines and bounds in parallel, and
+// then builds the tree from them. Each curve must already have been
+// allocated its own range of lines.
+class CurvesPrimitiveEvaluator::TreeBuilder
+{
+
+	public :
+
+		TreeBuilder( CurvesPrimitiveEvaluator *evaluator, const std::vector<size_t> &lineOffsets, const PrimitiveVariable &width, float constantWidth )
+			:	m_evaluator( evaluator ), m_lineOffsets( lineOffsets ), m_width( width ), m_constantWidth( constantWidth )
+		{
+		}
+
+		void operator()() const
+		{
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, m_lineOffsets.size() ), *this );
+			m_evaluator->m_tree.init( m_evaluator->m_treeBounds.begin(), m_evaluator->m_treeBounds.end() );
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			const CurvesPrimitive *curves = m_evaluator->m_curvesPrimitive.get();
+			const bool linear = curves->basis() == CubicBasisf::linear();
+			const std::vector<int> &verticesPerCurve = m_evaluator->m_verticesPerCurve;
+			const std::vector<V3f> &p = static_cast<const V3fVectorData *>( m_evaluator->m_p.data.get() )->readable();
+
+			PrimitiveEvaluator::ResultPtr result = m_evaluator->createResult();
+			Result *typedResult = static_cast<Result *>( result.get() );
+
+			std::vector<Box3f> &bounds = m_evaluator->m_treeBounds;
+			std::vector<Line> &lines = m_evaluator->m_treeLines;
+
+			for( size_t curveIndex = range.begin(); curveIndex != range.end(); ++curveIndex )
+			{
+				size_t lineIndex = m_lineOffsets[curveIndex];
+				if( linear )
+				{
+					int numVertices = verticesPerCurve[curveIndex];
+					int vertIndex = m_evaluator->m_vertexDataOffsets[curveIndex];
+					float prevV = 0.0f;
+					float prevRadius = 0.0f;
+					for( int i=0; i<numVertices; i++, vertIndex++ )
+					{
+						float v = clamp( (float)i/(float)(numVertices-1), 0.0f, 1.0f );
+						float radius = radiusAt( curveIndex, v, typedResult );
+						if( i!=0 )
+						{
+							lines[lineIndex] = Line( p[vertIndex-1], p[vertIndex], curveIndex, prevV, v, prevRadius, radius );
+							bounds[lineIndex] = lines[lineIndex].bound();
+							lineIndex++;
+						}
+						prevV = v;
+						prevRadius = radius;
+					}
+				}
+				else
+				{
+					unsigned numSegments = curves->numSegments( curveIndex );
+					int steps = numSegments * Line::linesPerCurveSegment();
+					V3f prevP( 0 );
+					float prevV = 0;
+					float prevRadius = 0;
+					for( int i=0; i<steps; i++ )
+					{
+						float v = clamp( (float)i/(float)(steps-1), 0.0f, 1.0f );
+						m_evaluator->pointAtV( curveIndex, v, typedResult );
+						V3f p = typedResult->point();
+						float radius = radiusAt( curveIndex, v, typedResult );
+						if( i!=0 )
+						{
+							lines[lineIndex] = Line( prevP, p, curveIndex, prevV, v, prevRadius, radius );
+							bounds[lineIndex] = lines[lineIndex].bound();
+							lineIndex++;
+						}
+
+						prevP = p;
+						prevV = v;
+						prevRadius = radius;
+					}
+				}
+				assert( lineIndex == ( curveIndex + 1 < m_lineOffsets.size() ? m_lineOffsets[curveIndex+1] : lines.size() ) );
+			}
+		}
+
+	private :
+
+		// Returns half the width at the specified position, reusing the result if it
+		// has already been initialised there by pointAtV().
+		float radiusAt( unsigned curveIndex, float v, Result *result ) const
+		{
+			if( m_width.interpolation == PrimitiveVariable::Invalid )
+			{
+				return m_constantWidth * 0.5f;
+			}
+			if( result->curveIndex() != curveIndex || result->uv()[1] != v )
+			{
+				m_evaluator->pointAtV( curveIndex, v, result );
+			}
+			return result->floatPrimVar( m_width ) * 0.5f;
+		}
+
+		CurvesPrimitiveEvaluator *m_evaluator;
+		const std::vector<size_t> &m_lineOffsets;
+		const PrimitiveVariable &m_width;
+		float m_constantWidth;
+
+};
 				
 //////////////////////////////////////////////////////////////////////////
 // Implementation of Evaluator
 //////////////////////////////////////////////////////////////////////////
 
 CurvesPrimitiveEvaluator::CurvesPrimitiveEvaluator( ConstCurvesPrimitivePtr curves )
-	:	m_curvesPrimitive( curves->copy() ), m_verticesPerCurve( m_curvesPrimitive->verticesPerCurve()->readable() ), m_haveTree( false )
+	:	m_curvesPrimitive( curves->copy() ), m_verticesPerCurve( m_curvesPrimitive->verticesPerCurve()->readable() )
 {
+	m_haveTree = false;
+
 	m_vertexDataOffsets.reserve( m_verticesPerCurve.size() );
 	m_varyingDataOffsets.reserve( m_verticesPerCurve.size() );
 	int vertexDataOffset = 0;
@@ -349,6 +561,10 @@ CurvesPrimitiveEvaluator::CurvesPrimitiveEvaluator( ConstCurvesPrimitivePtr curv
 		throw InvalidArgumentException( "No PrimitiveVariable named P on CurvesPrimitive." );
 	}
 	m_p = pIt->second;
+	if( m_p.indices )
+	{
+		m_p = PrimitiveVariable( m_p.interpolation, m_p.expandedData() );
+	}
 }
 
 CurvesPrimitiveEvaluator::~CurvesPrimitiveEvaluator()
@@ -425,8 +641,8 @@ void CurvesPrimitiveEvaluator::closestPointWalk( Box3fTree::NodeIndex nodeIndex,
 	const Box3fTree::Node &node = m_tree.node( nodeIndex );
 	if( node.isLeaf() )
 	{
-		Box3fTree::Iterator *permLast = node.permLast();
-		for( Box3fTree::Iterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const Box3fTree::Iterator *permLast = m_tree.permLast( nodeIndex );
+		for( const Box3fTree::Iterator *perm = m_tree.permFirst( nodeIndex ); perm!=permLast; perm++ )
 		{
 			const Line &line = m_treeLines[*perm - m_treeBounds.begin()];
 			
@@ -479,13 +695,164 @@ bool CurvesPrimitiveEvaluator::pointAtUV( const Imath::V2f &uv, PrimitiveEvaluat
 bool CurvesPrimitiveEvaluator::intersectionPoint( const Imath::V3f &origin, const Imath::V3f &direction,
 	PrimitiveEvaluator::Result *result, float maxDistance ) const
 {
-	throw NotImplementedException( __PRETTY_FUNCTION__ );
+	if( !m_verticesPerCurve.size() )
+	{
+		return false;
+	}
+
+	const_cast<CurvesPrimitiveEvaluator *>( this )->buildTree();
+
+	Line3f ray;
+	ray.pos = origin;
+	ray.dir = direction.normalized();
+
+	RayHit hit( maxDistance );
+	intersectionPointWalk( m_tree.rootIndex(), ray, hit );
+	if( hit.v < 0.0f )
+	{
+		return false;
+	}
+
+	Result *typedResult = static_cast<Result *>( result );
+	(typedResult->*typedResult->m_init)( hit.curveIndex, hit.v, this );
+	return true;
 }
 
 int CurvesPrimitiveEvaluator::intersectionPoints( const Imath::V3f &origin, const Imath::V3f &direction,
 	std::vector<PrimitiveEvaluator::ResultPtr> &results, float maxDistance ) const
 {
-	throw NotImplementedException( __PRETTY_FUNCTION__ );
+	results.clear();
+	if( !m_verticesPerCurve.size() )
+	{
+		return 0;
+	}
+
+	const_cast<CurvesPrimitiveEvaluator *>( this )->buildTree();
+
+	Line3f ray;
+	ray.pos = origin;
+	ray.dir = direction.normalized();
+
+	std::vector<RayHit> hits;
+	intersectionPointsWalk( m_tree.rootIndex(), ray, maxDistance, hits );
+
+	// a ray passing close to the join between two lines will hit both, and
+	// we only want to report one hit per curve, so keep only the closest.
+	std::sort( hits.begin(), hits.end() );
+	std::vector<bool> curveHit( m_verticesPerCurve.size(), false );
+	for( std::vector<RayHit>::const_iterator it = hits.begin(); it != hits.end(); ++it )
+	{
+		if( curveHit[it->curveIndex] )
+		{
+			continue;
+		}
+		curveHit[it->curveIndex] = true;
+
+		PrimitiveEvaluator::ResultPtr result = createResult();
+		Result *typedResult = static_cast<Result *>( result.get() );
+		(typedResult->*typedResult->m_init)( it->curveIndex, it->v, this );
+		results.push_back( result );
+	}
+
+	return results.size();
+}
+
+void CurvesPrimitiveEvaluator::intersectionPointWalk( Box3fTree::NodeIndex nodeIndex, const Imath::Line3f &ray, RayHit &hit ) const
+{
+	assert( m_haveTree );
+
+	const Box3fTree::Node &node = m_tree.node( nodeIndex );
+	if( node.isLeaf() )
+	{
+		const Box3fTree::Iterator *permLast = m_tree.permLast( nodeIndex );
+		for( const Box3fTree::Iterator *perm = m_tree.permFirst( nodeIndex ); perm!=permLast; perm++ )
+		{
+			const Line &line = m_treeLines[*perm - m_treeBounds.begin()];
+
+			float t, v;
+			if( line.intersect( ray, t, v ) && t < hit.distance )
+			{
+				hit.distance = t;
+				hit.curveIndex = line.curveIndex();
+				hit.v = v;
+			}
+		}
+		return;
+	}
+
+	// the tube intersection lies within the bound of each line, so we
+	// can visit the children front to back and skip any which are further
+	// away than the closest hit so far.
+	Box3fTree::NodeIndex children[2] = { Box3fTree::lowChildIndex( nodeIndex ), Box3fTree::highChildIndex( nodeIndex ) };
+	bool childHit[2];
+	float distances[2];
+	for( int i = 0; i < 2; ++i )
+	{
+		V3f boxHit;
+		childHit[i] = boxIntersects( m_tree.node( children[i] ).bound(), ray.pos, ray.dir, boxHit );
+		distances[i] = childHit[i] ? ( boxHit - ray.pos ).length() : 0.0f;
+	}
+
+	const int first = childHit[1] && ( !childHit[0] || distances[1] < distances[0] ) ? 1 : 0;
+	for( int i = 0; i < 2; ++i )
+	{
+		const int child = i == 0 ? first : 1 - first;
+		if( childHit[child] && distances[child] <= hit.distance )
+		{
+			intersectionPointWalk( children[child], ray, hit );
+		}
+	}
+}
+
+void CurvesPrimitiveEvaluator::intersectionPointsWalk( Box3fTree::NodeIndex nodeIndex, const Imath::Line3f &ray, float maxDistance, std::vector<RayHit> &hits ) const
+{
+	assert( m_haveTree );
+
+	const Box3fTree::Node &node = m_tree.node( nodeIndex );
+	if( node.isLeaf() )
+	{
+		const Box3fTree::Iterator *permLast = m_tree.permLast( nodeIndex );
+		for( const Box3fTree::Iterator *perm = m_tree.permFirst( nodeIndex ); perm!=permLast; perm++ )
+		{
+			const Line &line = m_treeLines[*perm - m_treeBounds.begin()];
+
+			RayHit hit;
+			if( line.intersect( ray, hit.distance, hit.v ) && hit.distance <= maxDistance )
+			{
+				hit.curveIndex = line.curveIndex();
+				hits.push_back( hit );
+			}
+		}
+		return;
+	}
+
+	Box3fTree::NodeIndex children[2] = { Box3fTree::lowChildIndex( nodeIndex ), Box3fTree::highChildIndex( nodeIndex ) };
+	for( int i = 0; i < 2; ++i )
+	{
+		V3f boxHit;
+		if( boxIntersects( m_tree.node( children[i] ).bound(), ray.pos, ray.dir, boxHit ) && ( boxHit - ray.pos ).length() <= maxDistance )
+		{
+			intersectionPointsWalk( children[i], ray, maxDistance, hits );
+		}
+	}
+}
+
+void CurvesPrimitiveEvaluator::batchClosestPoint( const std::vector<Imath::V3f> &points, BatchResults &results ) const
+{
+	const_cast<CurvesPrimitiveEvaluator *>( this )->buildTree();
+	PrimitiveEvaluator::batchClosestPoint( points, results );
+}
+
+void CurvesPrimitiveEvaluator::batchIntersectionPoint( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions, BatchResults &results, float maxDistance ) const
+{
+	const_cast<CurvesPrimitiveEvaluator *>( this )->buildTree();
+	PrimitiveEvaluator::batchIntersectionPoint( origins, directions, results, maxDistance );
+}
+
+void CurvesPrimitiveEvaluator::storeBatchResult( const PrimitiveEvaluator::Result *result, size_t index, BatchResults &results ) const
+{
+	results.point[index] = result->point();
+	results.uv[index] = result->uv();
 }
 
 bool CurvesPrimitiveEvaluator::pointAtV( unsigned curveIndex, float v, PrimitiveEvaluator::Result *result ) const
@@ -647,60 +1014,54 @@ void CurvesPrimitiveEvaluator::buildTree()
 		// another thread may have built the tree while we waited for the mutex
 		return;
 	}
-	
-	bool linear = m_curvesPrimitive->basis() == CubicBasisf::linear();
-	const std::vector<V3f> &p = static_cast<const V3fVectorData *>( m_p.data.get() )->readable();
-	PrimitiveEvaluator::ResultPtr result = createResult();
-	
-	size_t numCurves = m_curvesPrimitive->numCurves();
-	for( size_t curveIndex = 0; curveIndex<numCurves; curveIndex++ )
+
+	// find the width, for use in intersection queries.
+
+	float constantWidth = 1.0f;
+	PrimitiveVariable width;
+	PrimitiveVariableMap::const_iterator it = m_curvesPrimitive->variables.find( "width" );
+	if( it != m_curvesPrimitive->variables.end() && ( runTimeCast<const FloatVectorData>( it->second.data ) || runTimeCast<const FloatData>( it->second.data ) ) )
 	{
-		if( linear )
+		width = it->second;
+	}
+	else
+	{
+		it = m_curvesPrimitive->variables.find( "constantwidth" );
+		if( it != m_curvesPrimitive->variables.end() )
 		{
-			int numVertices = m_verticesPerCurve[curveIndex];
-			int vertIndex = m_vertexDataOffsets[curveIndex];
-			float prevV = 0.0f;
-			for( int i=0; i<numVertices; i++, vertIndex++ )
+			if( const FloatData *constantWidthData = runTimeCast<const FloatData>( it->second.data.get() ) )
 			{
-				float v = clamp( (float)i/(float)(numVertices-1), 0.0f, 1.0f );
-				if( i!=0 )
-				{
-					Box3f b;
-					b.extendBy( p[vertIndex-1] );
-					b.extendBy( p[vertIndex] );
-					m_treeBounds.push_back( b );
-					m_treeLines.push_back( Line(  p[vertIndex-1], p[vertIndex], curveIndex, prevV, v ) );
-				}
-				prevV = v;				
+				constantWidth = constantWidthData->readable();
 			}
 		}
-		else
-		{
-			unsigned numSegments = m_curvesPrimitive->numSegments( curveIndex );
-			int steps = numSegments * Line::linesPerCurveSegment();
-			V3f prevP( 0 );
-			float prevV = 0;
-			for( int i=0; i<steps; i++ )
-			{
-				float v = clamp( (float)i/(float)(steps-1), 0.0f, 1.0f );
-				pointAtV( curveIndex, v, result.get() );
-				V3f p = result->point();
-				if( i!=0 )
-				{
-					Box3f b;
-					b.extendBy( prevP );
-					b.extendBy( p );
-					m_treeBounds.push_back( b );
-					m_treeLines.push_back( Line( prevP, p, curveIndex, prevV, v ) );
-				}
+	}
 
-				prevP = p;
-				prevV = v;
-			}
-		}
+	// allocate a range of lines for each curve, so that the curves can
+	// then be linearised in parallel.
+
+	const bool linear = m_curvesPrimitive->basis() == CubicBasisf::linear();
+	const size_t numCurves = m_curvesPrimitive->numCurves();
+	std::vector<size_t> lineOffsets( numCurves );
+	size_t numLines = 0;
+	for( size_t curveIndex = 0; curveIndex<numCurves; curveIndex++ )
+	{
+		lineOffsets[curveIndex] = numLines;
+		int numPoints = linear ? m_verticesPerCurve[curveIndex] : m_curvesPrimitive->numSegments( curveIndex ) * Line::linesPerCurveSegment();
+		numLines += std::max( numPoints - 1, 0 );
 	}
-	
-	m_tree.init( m_treeBounds.begin(), m_treeBounds.end() );
+
+	m_treeBounds.resize( numLines );
+	m_treeLines.resize( numLines );
+
+	TreeBuilder treeBuilder( this, lineOffsets, width, constantWidth );
+#if TBB_INTERFACE_VERSION >= 10000
+	// we hold the mutex while waiting for the parallel build, so must not
+	// let this thread steal an outer task which may call buildTree() again.
+	tbb::this_task_arena::isolate( treeBuilder );
+#else
+	treeBuilder();
+#endif
+
 	m_haveTree = true;
 }
 
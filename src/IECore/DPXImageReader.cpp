@@ -40,11 +40,13 @@
 #include "IECore/ImagePrimitive.h"
 #include "IECore/FileNameParameter.h"
 #include "IECore/BoxOps.h"
-#include "IECore/ScaledDataConversion.h"
+#include "IECore/SimpleTypedParameter.h"
 
 #include "IECore/private/dpx.h"
+#include "IECore/private/TenBitUnpacking.h"
 
 #include "boost/format.hpp"
+#include "boost/iostreams/device/mapped_file.hpp"
 
 #include <algorithm>
 
@@ -70,14 +72,16 @@ const Reader::ReaderDescription<DPXImageReader> DPXImageReader::m_readerDescript
 
 DPXImageReader::DPXImageReader() :
 		ImageReader( "Reads Digital Picture eXchange (DPX) files."),
-		m_header( 0 )
+		m_data( 0 ), m_bufferMemoryMapped( false ), m_header( 0 )
 {
+	constructParameters();
 }
 
 DPXImageReader::DPXImageReader(const string & fileName) :
 		ImageReader( "Reads Digital Picture eXchange (DPX) files."),
-		m_header( 0 )
+		m_data( 0 ), m_bufferMemoryMapped( false ), m_header( 0 )
 {
+	constructParameters();
 	m_fileNameParameter->setTypedValue(fileName);
 }
 
@@ -86,6 +90,27 @@ DPXImageReader::~DPXImageReader()
 	delete m_header;
 }
 
+void DPXImageReader::constructParameters()
+{
+	m_memoryMappedParameter = new BoolParameter(
+		"memoryMapped",
+		"Maps the file into memory rather than reading it through a stream. This "
+		"avoids copying the image data into a buffer before it is unpacked.",
+		false
+	);
+	parameters()->addParameter( m_memoryMappedParameter );
+}
+
+BoolParameter *DPXImageReader::memoryMappedParameter()
+{
+	return m_memoryMappedParameter.get();
+}
+
+const BoolParameter *DPXImageReader::memoryMappedParameter() const
+{
+	return m_memoryMappedParameter.get();
+}
+
 // partial validity check: assert that the file begins with the DPX magic number
 bool DPXImageReader::canRead( const string &fileName )
 {
@@ -140,101 +165,53 @@ std::string DPXImageReader::sourceColorSpace() const
 	return "cineon";
 }
 
+DataPtr DPXImageReader::readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw )
+{
+	std::vector<std::string> names( 1, name );
+	std::vector<DataPtr> data;
+	readChannels( names, dataWindow, raw, data );
+	return data.size() ? data[0] : 0;
+}
+
 /// \todo
 /// we assume here CIN coding in the 'typical' configuration (output by film dumps, nuke, etc).
-/// this is RGB 10bit log for film, pixel-interlaced data. We convert this to unsigned short 
-/// (using the whole range of 16 bits available ) and then it's converted to the given 
+/// this is RGB 10bit log for film, pixel-interlaced data. We convert this to unsigned short
+/// (using the whole range of 16 bits available ) and then it's converted to the given
 /// typename V applying domain scale as necessary. Note that there's no cineon to linear conversion as
 /// it's now up to the base class to do it.
-template<typename V>
-DataPtr DPXImageReader::readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow )
+void DPXImageReader::readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data )
 {
-	typedef TypedData< std::vector< V > > TargetVector;
-
-	/// \todo
-	// kinda useless here, we have implicitly assumed log 10 bit in the surrounding code
-	int bpp = 10;
-	// that's the bit offset necessary to scale the channel values to unsigned short range of values.
-	int ushortShift = sizeof(unsigned short)*8 - bpp;
-
-	/// \todo
-	// figure out the offset into the bitstream for the given channel
-	int channelOffset = name == "R" ? 0 : name == "G" ? 1 : 2;
-
-	// form the mask for this channel
-	unsigned int mask = 0;
-	for (int pi = 0; pi < bpp; ++pi)
+	data.clear();
+	if (!open())
 	{
-		mask = 1 + (mask << 1);
+		return;
 	}
-	mask <<= ((32 - bpp) - channelOffset * bpp);
-
-	ScaledDataConversion< unsigned short, V> converter;
-
-	typename TargetVector::Ptr dataContainer = new TargetVector();
-	typename TargetVector::ValueType &data = dataContainer->writable();
-	int area = ( dataWindow.size().x + 1 ) * ( dataWindow.size().y + 1 );
-	assert( area >= 0 );
-	data.resize( area );
 
-	int dataWidth = 1 + dataWindow.size().x;
-
-	Box2i wholeDataWindow = this->dataWindow();
-
-	const int yMin = dataWindow.min.y - wholeDataWindow.min.y;
-	const int yMax = dataWindow.max.y - wholeDataWindow.min.y;
-
-	const int xMin = dataWindow.min.x - wholeDataWindow.min.x;
-	const int xMax = dataWindow.max.x - wholeDataWindow.min.x;
-
-	int dataY = 0;
-	for ( int y = yMin ; y <= yMax ; ++y, ++dataY )
+	/// \todo
+	// figure out the offset into the bitstream for each channel
+	std::vector<int> channelIndices;
+	for( std::vector<std::string>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
 	{
-		typename TargetVector::ValueType::size_type dataOffset = dataY * dataWidth;
-		std::vector<unsigned int>::size_type bufferOffset = y * m_bufferWidth + xMin;
-
-		for ( int x = xMin;  x <= xMax ; ++x, ++dataOffset, ++bufferOffset  )
-		{
-			assert( dataOffset < data.size() );
-
-			unsigned int cell = m_buffer[ bufferOffset ];
-			if ( m_reverseBytes )
-			{
-				cell = reverseBytes( cell );
-			}
-
-			// assume we have 10bit log, two wasted bits aligning to 32 longword
-			unsigned short cv = (unsigned short) ( ( mask & cell ) >> ( 2 + ( 2 - channelOffset ) * bpp ) );
-			assert( cv < 1024 );
-			data[dataOffset] = converter( (cv << ushortShift) + ((1 << ushortShift) - 1) );
-		}
+		channelIndices.push_back( *it == "R" ? 0 : *it == "G" ? 1 : 2 );
 	}
-	return dataContainer;
-}
 
-DataPtr DPXImageReader::readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw )
-{
-	if (!open())
-	{
-		return 0;
-	}
+	const Box2i wholeDataWindow = this->dataWindow();
+	const Box2i region( dataWindow.min - wholeDataWindow.min, dataWindow.max - wholeDataWindow.min );
 
-	DataPtr dataContainer = NULL;
 	if ( raw )
 	{
-		dataContainer = readTypedChannel< unsigned short >( name, dataWindow );
+		Detail::unpackTenBitChannels<unsigned short>( m_data, m_bufferWidth, m_reverseBytes, region, channelIndices, data );
 	}
 	else
 	{
-		dataContainer = readTypedChannel< float >( name, dataWindow );
+		Detail::unpackTenBitChannels<float>( m_data, m_bufferWidth, m_reverseBytes, region, channelIndices, data );
 	}
-
-	return dataContainer;
 }
 
 bool DPXImageReader::open( bool throwOnFailure )
 {
-	if (m_bufferFileName == fileName())
+	const bool memoryMapped = m_memoryMappedParameter->getTypedValue();
+	if (m_bufferFileName == fileName() && m_bufferMemoryMapped == memoryMapped)
 	{
 		return true;
 	}
@@ -242,7 +219,10 @@ bool DPXImageReader::open( bool throwOnFailure )
 	try
 	{
 		m_bufferFileName = fileName();
+		m_bufferMemoryMapped = memoryMapped;
 		m_buffer.clear();
+		m_mappedFile.reset();
+		m_data = 0;
 		delete m_header;
 		m_header = new Header();
 
@@ -327,14 +307,39 @@ bool DPXImageReader::open( bool throwOnFailure )
 
 		m_bufferWidth = m_header->m_imageInformation.pixels_per_line;
 		m_bufferHeight = m_header->m_imageInformation.lines_per_image_ele;
+
+		// remember that we're currently packing upto 3 channels into each 32-bit "cell"
+		const size_t bufferSize = (size_t)m_bufferWidth * m_bufferHeight;
+		const size_t dataOffset = m_header->m_fileInformation.image_data_offset;
+
+		// the data is uncompressed, so when it is suitably aligned we can use it in place
+		if ( memoryMapped && dataOffset % sizeof( unsigned int ) == 0 )
+		{
+			try
+			{
+				m_mappedFile.reset( new iostreams::mapped_file_source( fileName() ) );
+			}
+			catch( const std::exception &e )
+			{
+				throw IOException( ( format( "DPXImageReader: Cannot map file \"%s\" (%s)." ) % fileName() % e.what() ).str() );
+			}
+
+			if ( dataOffset + sizeof( unsigned int ) * bufferSize > m_mappedFile->size() )
+			{
+				throw IOException( "DPXImageReader: Error reading " + fileName() );
+			}
+
+			m_data = reinterpret_cast<const unsigned int *>( m_mappedFile->data() + dataOffset );
+			return true;
+		}
+
 		in.seekg( m_header->m_fileInformation.image_data_offset, ios_base::beg );
 		if ( in.fail() )
 		{
 			throw IOException( "DPXImageReader: Error reading " + fileName() );
 		}
 
-		// Read the data into the buffer - remember that we're currently packing upto 3 channels into each 32-bit "cell"
-		int bufferSize = ( std::max<unsigned int>( 1u, 3 / 3 ) ) * m_bufferWidth * m_bufferHeight;
+		// Read the data into the buffer
 		m_buffer.resize( bufferSize, 0 );
 
 		in.read( reinterpret_cast<char*>(&m_buffer[0]), sizeof(unsigned int) * bufferSize );
@@ -342,9 +347,14 @@ bool DPXImageReader::open( bool throwOnFailure )
 		{
 			throw IOException( "DPXImageReader: Error reading " + fileName() );
 		}
+		m_data = &m_buffer[0];
 	}
 	catch (...)
 	{
+		m_bufferFileName = "";
+		m_buffer.clear();
+		m_mappedFile.reset();
+		m_data = 0;
 		if ( throwOnFailure )
 		{
 			throw;
@@ -32,6 +32,10 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <new>
+
+#include "tbb/scalable_allocator.h"
+
 #include "IECore/Data.h"
 
 using namespace IECore;
@@ -44,6 +48,21 @@ Data::~Data()
 {
 }
 
+void *Data::operator new( size_t size )
+{
+	void *result = scalable_malloc( size );
+	if( !result )
+	{
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+void Data::operator delete( void *p )
+{
+	scalable_free( p );
+}
+
 void Data::copyFrom( const Object *other, CopyContext *context )
 {
 	Object::copyFrom( other, context );
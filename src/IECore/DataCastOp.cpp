@@ -43,6 +43,7 @@
 #include "IECore/CompoundObject.h"
 #include "IECore/Object.h"
 #include "IECore/NullObject.h"
+#include "IECore/private/ParallelTransform.h"
 
 #include <cassert>
 
@@ -154,7 +155,7 @@ castToVectorData( Data * array )
 	typename T::Ptr resultT = new T;
 	resultT->writable().resize( sourceSize / targetItemSize );
 	typename T::BaseType *target = resultT->baseWritable();
-	std::transform( source, source + sourceSize, target, CastRawData< typename S::BaseType, typename T::BaseType >() );
+	Detail::parallelTransform( source, sourceSize, target, CastRawData< typename S::BaseType, typename T::BaseType >() );
 	return resultT;
 }
 
@@ -39,6 +39,7 @@
 #include "IECore/DespatchTypedData.h"
 #include "IECore/Exception.h"
 #include "IECore/ScaledDataConversion.h"
+#include "IECore/private/ParallelTransform.h"
 
 using namespace IECore;
 
@@ -161,11 +162,7 @@ struct DataConvertOp::ConvertFnStage2
 		BaseType *baseWritable = data->baseWritable();
 		
 		ScaledDataConversion<FromBaseType, BaseType> converter;
-		
-		for( size_t i=0; i<m_arrayLength; ++i )
-		{
-			baseWritable[i] = converter( m_rawData[i] );
-		}
+		Detail::parallelTransform( m_rawData, m_arrayLength, baseWritable, converter );
 	
 		return data;
 	}
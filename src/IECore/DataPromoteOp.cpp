@@ -43,6 +43,7 @@
 #include "IECore/Object.h"
 #include "IECore/NullObject.h"
 #include "IECore/DespatchTypedData.h"
+#include "IECore/private/ParallelTransform.h"
 
 #include <cassert>
 
@@ -85,6 +86,20 @@ DataPromoteOp::~DataPromoteOp()
 {
 }
 
+namespace
+{
+
+template<typename F, typename T>
+struct PromoteValue
+{
+	inline T operator()( const F &f ) const
+	{
+		return T( f );
+	}
+};
+
+} // namespace
+
 namespace IECore
 {
 
@@ -101,11 +116,7 @@ struct DataPromoteOp::Promote2Fn<T, typename boost::enable_if< TypeTraits::IsVec
 		typename T::ValueType &vt = result->writable();
 		const typename F::ValueType &vf = d->readable();
 		vt.resize( vf.size() );
-		typename T::ValueType::iterator tIt = vt.begin();
-		for ( typename F::ValueType::const_iterator it = vf.begin(); it!=vf.end(); it++ )
-		{
-			*tIt++ = typename T::ValueType::value_type( *it );
-		}
+		Detail::parallelTransform( vf.begin(), vf.size(), vt.begin(), PromoteValue<typename F::ValueType::value_type, typename T::ValueType::value_type>() );
 		return result;
 	}
 };
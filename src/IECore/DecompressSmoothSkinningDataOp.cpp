@@ -43,8 +43,67 @@
 #include "IECore/SimpleTypedData.h"
 #include "IECore/TypedObjectParameter.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Expands the influences for a range of points into blocks containing
+// a weight for every influence.
+class Decompressor
+{
+
+	public :
+
+		Decompressor( int numInfluences, const std::vector<int> &offsets, const std::vector<int> &counts, const std::vector<int> &indices, const std::vector<float> &weights, std::vector<int> &newOffsets, std::vector<int> &newIndices, std::vector<float> &newWeights )
+			:	m_numInfluences( numInfluences ), m_offsets( offsets ), m_counts( counts ), m_indices( indices ), m_weights( weights ),
+				m_newOffsets( newOffsets ), m_newIndices( newIndices ), m_newWeights( newWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const int newOffset = i * m_numInfluences;
+				m_newOffsets[i] = newOffset;
+				for ( int j=0; j < m_numInfluences; j++ )
+				{
+					m_newIndices[newOffset + j] = j;
+					m_newWeights[newOffset + j] = 0.0f;
+				}
+
+				// we iterate backwards so that where an influence is repeated,
+				// the first weight for it is the one that is kept.
+				for ( int k = m_offsets[i] + m_counts[i] - 1; k >= m_offsets[i]; k-- )
+				{
+					const int index = m_indices[k];
+					if ( index >= 0 && index < m_numInfluences )
+					{
+						m_newWeights[newOffset + index] = m_weights[k];
+					}
+				}
+			}
+		}
+
+	private :
+
+		int m_numInfluences;
+		const std::vector<int> &m_offsets;
+		const std::vector<int> &m_counts;
+		const std::vector<int> &m_indices;
+		const std::vector<float> &m_weights;
+		std::vector<int> &m_newOffsets;
+		std::vector<int> &m_newIndices;
+		std::vector<float> &m_newWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( DecompressSmoothSkinningDataOp );
 
 DecompressSmoothSkinningDataOp::DecompressSmoothSkinningDataOp()
@@ -70,46 +129,27 @@ void DecompressSmoothSkinningDataOp::modify( Object * object, const CompoundObje
 	const std::vector<int> &pointInfluenceCounts = skinningData->pointInfluenceCounts()->readable();
 	const std::vector<int> &pointInfluenceIndices = skinningData->pointInfluenceIndices()->readable();
 	const std::vector<float> &pointInfluenceWeights = skinningData->pointInfluenceWeights()->readable();
-	
-	std::vector<int> newOffsets;
-	std::vector<int> newCounts;
-	std::vector<int> newIndices;
-	std::vector<float> newWeights;
-	
-	int offset = 0;
-	int numInfluences = influenceNames.size();
-	
-	for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
-	{
-		const std::vector<int>::const_iterator first = pointInfluenceIndices.begin() + pointIndexOffsets[i];
-		const std::vector<int>::const_iterator last = first + pointInfluenceCounts[i];
-		
-		for ( int j=0; j < numInfluences; j++ )
-		{			
-			newIndices.push_back( j );
-			
-			const std::vector<int>::const_iterator location = find( first, last, j );
-			if ( location != last )
-			{
-				newWeights.push_back( pointInfluenceWeights[ location - pointInfluenceIndices.begin() ] );
-			}
-			else
-			{
-				newWeights.push_back( 0.0f );
-			}
-		}
 
-		newOffsets.push_back( offset );
-		newCounts.push_back( numInfluences );
-		offset += numInfluences;
-	}
-	
-	// replace the vectors on the SmoothSkinningData
-	if ( newWeights.size() != pointInfluenceWeights.size() )
+	const int numInfluences = influenceNames.size();
+	const size_t numPoints = pointIndexOffsets.size();
+
+	// the data is already decompressed, so there's nothing to do
+	if ( numPoints * numInfluences == pointInfluenceWeights.size() )
 	{
-		skinningData->pointIndexOffsets()->writable().swap( newOffsets );
-		skinningData->pointInfluenceCounts()->writable().swap( newCounts );
-		skinningData->pointInfluenceIndices()->writable().swap( newIndices );
-		skinningData->pointInfluenceWeights()->writable().swap( newWeights );
+		return;
 	}
+
+	std::vector<int> newOffsets( numPoints );
+	std::vector<int> newCounts( numPoints, numInfluences );
+	std::vector<int> newIndices( numPoints * numInfluences );
+	std::vector<float> newWeights( numPoints * numInfluences );
+
+	Decompressor decompressor( numInfluences, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights, newOffsets, newIndices, newWeights );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, numPoints, 1024 ), decompressor );
+
+	// replace the vectors on the SmoothSkinningData
+	skinningData->pointIndexOffsets()->writable().swap( newOffsets );
+	skinningData->pointInfluenceCounts()->writable().swap( newCounts );
+	skinningData->pointInfluenceIndices()->writable().swap( newIndices );
+	skinningData->pointInfluenceWeights()->writable().swap( newWeights );
 }
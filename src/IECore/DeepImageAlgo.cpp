@@ -0,0 +1,469 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "IECore/DeepImageAlgo.h"
+#include "IECore/Exception.h"
+#include "IECore/VectorTypedData.h"
+
+using namespace IECore;
+
+namespace
+{
+
+bool depthSorted( const float *depths, unsigned numSamples )
+{
+	for( unsigned i = 1; i < numSamples; ++i )
+	{
+		if( depths[i] < depths[i-1] )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+class DepthLess
+{
+
+	public :
+
+		DepthLess( const float *depths )
+			:	m_depths( depths )
+		{
+		}
+
+		bool operator()( unsigned a, unsigned b ) const
+		{
+			return m_depths[a] < m_depths[b];
+		}
+
+	private :
+
+		const float *m_depths;
+
+};
+
+// Fills order with the indices of the samples in depth order.
+void depthOrder( const float *depths, unsigned numSamples, std::vector<unsigned> &order )
+{
+	order.resize( numSamples );
+	for( unsigned i = 0; i < numSamples; ++i )
+	{
+		order[i] = i;
+	}
+	std::stable_sort( order.begin(), order.end(), DepthLess( depths ) );
+}
+
+unsigned blockWidth( const DeepImageBlock *block )
+{
+	return block->region().max.x - block->region().min.x + 1;
+}
+
+unsigned blockHeight( const DeepImageBlock *block )
+{
+	return block->numPixels() ? block->numPixels() / blockWidth( block ) : 0;
+}
+
+// Sorts the samples within each pixel, for a range of scanlines.
+class SortSamples
+{
+
+	public :
+
+		SortSamples( DeepImageBlock *block )
+			:	m_block( block ), m_width( blockWidth( block ) )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<unsigned> &range ) const
+		{
+			const std::vector<unsigned> &offsets = m_block->sampleOffsets();
+			const unsigned numChannels = m_block->numChannels();
+
+			std::vector<unsigned> order;
+			std::vector<float> scratch;
+			for( unsigned p = range.begin() * m_width; p < range.end() * m_width; ++p )
+			{
+				const unsigned offset = offsets[p];
+				const unsigned numSamples = offsets[p+1] - offset;
+				if( depthSorted( m_block->depths() + offset, numSamples ) )
+				{
+					continue;
+				}
+
+				depthOrder( m_block->depths() + offset, numSamples, order );
+				scratch.resize( numSamples );
+				for( unsigned c = 0; c <= numChannels; ++c )
+				{
+					float *plane = ( c ? m_block->channelData( c - 1 ) : m_block->depths() ) + offset;
+					for( unsigned i = 0; i < numSamples; ++i )
+					{
+						scratch[i] = plane[order[i]];
+					}
+					std::copy( scratch.begin(), scratch.end(), plane );
+				}
+			}
+		}
+
+	private :
+
+		DeepImageBlock *m_block;
+		unsigned m_width;
+
+};
+
+// Composites the samples within each pixel, for a range of scanlines,
+// writing the results into the corresponding pixels of the output
+// channels.
+class Flatten
+{
+
+	public :
+
+		Flatten( const DeepImageBlock *block, const Imath::Box2i &outputWindow, const std::vector<float *> &outputs )
+			:	m_block( block ), m_width( blockWidth( block ) ), m_outputWindow( outputWindow ), m_outputs( outputs )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<unsigned> &range ) const
+		{
+			const std::vector<unsigned> &offsets = m_block->sampleOffsets();
+			const unsigned numChannels = m_block->numChannels();
+			const int alphaChannel = m_block->channelIndex( "A" );
+			const Imath::Box2i &region = m_block->region();
+			const unsigned outputWidth = m_outputWindow.max.x - m_outputWindow.min.x + 1;
+
+			std::vector<unsigned> order;
+			std::vector<float> weights;
+			for( unsigned y = range.begin(); y != range.end(); ++y )
+			{
+				const unsigned outputRow = ( region.min.y + y - m_outputWindow.min.y ) * outputWidth + region.min.x - m_outputWindow.min.x;
+				for( unsigned x = 0; x < m_width; ++x )
+				{
+					const unsigned p = y * m_width + x;
+					const unsigned offset = offsets[p];
+					const unsigned numSamples = offsets[p+1] - offset;
+					if( !numSamples )
+					{
+						continue;
+					}
+
+					const float *depths = m_block->depths() + offset;
+					const bool sorted = depthSorted( depths, numSamples );
+					if( !sorted )
+					{
+						depthOrder( depths, numSamples, order );
+					}
+
+					const unsigned outputIndex = outputRow + x;
+					if( alphaChannel < 0 )
+					{
+						// Without alpha, the nearest sample wins.
+						const unsigned nearest = sorted ? 0 : order[0];
+						for( unsigned c = 0; c < numChannels; ++c )
+						{
+							m_outputs[c][outputIndex] = m_block->channelData( c )[offset + nearest];
+						}
+						continue;
+					}
+
+					// Accumulate alpha first, to find the weight each sample contributes
+					// and the point at which the pixel becomes opaque. This leaves each
+					// channel as a simple weighted sum over its plane.
+					const float *alpha = m_block->channelData( alphaChannel ) + offset;
+					weights.resize( numSamples );
+					float accumulatedAlpha = 0.0f;
+					float weight = 1.0f;
+					unsigned numContributing = 0;
+					for( ; numContributing < numSamples && accumulatedAlpha < 1.0f; ++numContributing )
+					{
+						const unsigned i = sorted ? numContributing : order[numContributing];
+						weights[numContributing] = weight;
+						accumulatedAlpha += alpha[i] * weight;
+						weight = std::max( 1 - accumulatedAlpha, 0.0f );
+					}
+
+					for( unsigned c = 0; c < numChannels; ++c )
+					{
+						const float *data = m_block->channelData( c ) + offset;
+						float result = 0.0f;
+						if( sorted )
+						{
+							for( unsigned i = 0; i < numContributing; ++i )
+							{
+								result += data[i] * weights[i];
+							}
+						}
+						else
+						{
+							for( unsigned i = 0; i < numContributing; ++i )
+							{
+								result += data[order[i]] * weights[i];
+							}
+						}
+						m_outputs[c][outputIndex] = result;
+					}
+				}
+			}
+		}
+
+	private :
+
+		const DeepImageBlock *m_block;
+		unsigned m_width;
+		Imath::Box2i m_outputWindow;
+		const std::vector<float *> &m_outputs;
+
+};
+
+struct MergeSample
+{
+	float depth;
+	unsigned block;
+	unsigned index;
+
+	bool operator < ( const MergeSample &other ) const
+	{
+		return depth < other.depth;
+	}
+};
+
+// Merges the samples within each pixel, for a range of scanlines.
+class Merge
+{
+
+	public :
+
+		Merge( const std::vector<const DeepImageBlock *> &blocks, const std::vector<std::vector<unsigned> > &channelMaps, DeepImageBlock *result )
+			:	m_blocks( blocks ), m_channelMaps( channelMaps ), m_result( result ), m_width( blockWidth( result ) )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<unsigned> &range ) const
+		{
+			const unsigned numBlocks = m_blocks.size();
+			const unsigned numChannels = m_result->numChannels();
+			const std::vector<unsigned> &resultOffsets = m_result->sampleOffsets();
+
+			std::vector<MergeSample> samples;
+			for( unsigned p = range.begin() * m_width; p < range.end() * m_width; ++p )
+			{
+				samples.clear();
+				bool needSort = false;
+				for( unsigned b = 0; b < numBlocks; ++b )
+				{
+					const std::vector<unsigned> &offsets = m_blocks[b]->sampleOffsets();
+					const float *depths = m_blocks[b]->depths();
+					const size_t start = samples.size();
+					for( unsigned i = offsets[p]; i < offsets[p+1]; ++i )
+					{
+						MergeSample s = { depths[i], b, i };
+						samples.push_back( s );
+					}
+
+					if( needSort )
+					{
+						continue;
+					}
+
+					// Each run of sorted samples can be merged into the sorted
+					// samples preceding it in linear time. If any run is unsorted
+					// then we fall back to sorting everything at the end.
+					if( !depthSorted( depths + offsets[p], offsets[p+1] - offsets[p] ) )
+					{
+						needSort = true;
+					}
+					else if( start && samples.size() > start && samples[start].depth < samples[start-1].depth )
+					{
+						std::inplace_merge( samples.begin(), samples.begin() + start, samples.end() );
+					}
+				}
+
+				if( needSort )
+				{
+					std::stable_sort( samples.begin(), samples.end() );
+				}
+
+				const unsigned offset = resultOffsets[p];
+				float *depths = m_result->depths();
+				for( size_t i = 0, e = samples.size(); i < e; ++i )
+				{
+					depths[offset + i] = samples[i].depth;
+				}
+
+				for( unsigned c = 0; c < numChannels; ++c )
+				{
+					float *data = m_result->channelData( c ) + offset;
+					for( size_t i = 0, e = samples.size(); i < e; ++i )
+					{
+						const MergeSample &s = samples[i];
+						data[i] = m_blocks[s.block]->channelData( m_channelMaps[s.block][c] )[s.index];
+					}
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<const DeepImageBlock *> &m_blocks;
+		const std::vector<std::vector<unsigned> > &m_channelMaps;
+		DeepImageBlock *m_result;
+		unsigned m_width;
+
+};
+
+} // namespace
+
+void DeepImageAlgo::sortSamples( DeepImageBlock *block )
+{
+	if( !block->numSamples() )
+	{
+		return;
+	}
+
+	tbb::parallel_for( tbb::blocked_range<unsigned>( 0, blockHeight( block ) ), SortSamples( block ) );
+}
+
+void DeepImageAlgo::flatten( const DeepImageBlock *block, ImagePrimitive *image )
+{
+	const Imath::Box2i &region = block->region();
+	if( region.isEmpty() )
+	{
+		return;
+	}
+
+	const Imath::Box2i &dataWindow = image->getDataWindow();
+	if( !dataWindow.intersects( region.min ) || !dataWindow.intersects( region.max ) )
+	{
+		throw InvalidArgumentException( "DeepImageAlgo::flatten : Image data window does not contain the block." );
+	}
+
+	const std::vector<std::string> &channelNames = block->channelNames();
+	std::vector<float *> outputs;
+	outputs.reserve( channelNames.size() );
+	for( std::vector<std::string>::const_iterator it = channelNames.begin(); it != channelNames.end(); ++it )
+	{
+		FloatVectorData *channel = image->getChannel<float>( *it );
+		if( !channel )
+		{
+			if( image->variables.find( *it ) != image->variables.end() )
+			{
+				throw InvalidArgumentException( "DeepImageAlgo::flatten : Channel \"" + *it + "\" is not a valid float channel." );
+			}
+			channel = image->createChannel<float>( *it );
+		}
+		outputs.push_back( &channel->writable()[0] );
+	}
+
+	if( !block->numSamples() )
+	{
+		return;
+	}
+
+	tbb::parallel_for( tbb::blocked_range<unsigned>( 0, blockHeight( block ) ), Flatten( block, dataWindow, outputs ) );
+}
+
+ImagePrimitivePtr DeepImageAlgo::flatten( const DeepImageBlock *block )
+{
+	ImagePrimitivePtr result = new ImagePrimitive( block->region(), block->region() );
+	flatten( block, result.get() );
+	return result;
+}
+
+DeepImageBlockPtr DeepImageAlgo::merge( const std::vector<const DeepImageBlock *> &blocks )
+{
+	if( blocks.empty() )
+	{
+		throw InvalidArgumentException( "DeepImageAlgo::merge : No blocks to merge." );
+	}
+
+	const DeepImageBlock *first = blocks[0];
+	const std::vector<std::string> &channelNames = first->channelNames();
+	const unsigned numChannels = channelNames.size();
+
+	std::vector<std::vector<unsigned> > channelMaps( blocks.size() );
+	for( size_t b = 0; b < blocks.size(); ++b )
+	{
+		if( !blocks[b] )
+		{
+			throw InvalidArgumentException( "DeepImageAlgo::merge : Null block." );
+		}
+
+		if( blocks[b]->region() != first->region() )
+		{
+			throw InvalidArgumentException( "DeepImageAlgo::merge : Blocks must have the same region." );
+		}
+
+		if( blocks[b]->numChannels() != numChannels )
+		{
+			throw InvalidArgumentException( "DeepImageAlgo::merge : Blocks must have the same channels." );
+		}
+
+		channelMaps[b].resize( numChannels );
+		for( unsigned c = 0; c < numChannels; ++c )
+		{
+			int index = blocks[b]->channelIndex( channelNames[c] );
+			if( index < 0 )
+			{
+				throw InvalidArgumentException( "DeepImageAlgo::merge : Blocks must have the same channels." );
+			}
+			channelMaps[b][c] = index;
+		}
+	}
+
+	DeepImageBlockPtr result = new DeepImageBlock( first->region(), channelNames );
+
+	const unsigned numPixels = result->numPixels();
+	std::vector<unsigned> sampleCounts( numPixels, 0 );
+	for( size_t b = 0; b < blocks.size(); ++b )
+	{
+		for( unsigned p = 0; p < numPixels; ++p )
+		{
+			sampleCounts[p] += blocks[b]->numSamples( p );
+		}
+	}
+	result->setSampleCounts( sampleCounts );
+
+	if( result->numSamples() )
+	{
+		tbb::parallel_for( tbb::blocked_range<unsigned>( 0, blockHeight( result.get() ) ), Merge( blocks, channelMaps, result.get() ) );
+	}
+
+	return result;
+}
@@ -0,0 +1,230 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "IECore/DeepImageBlock.h"
+#include "IECore/Exception.h"
+
+using namespace IECore;
+
+DeepImageBlock::DeepImageBlock( const Imath::Box2i &region, const std::vector<std::string> &channelNames )
+	:	m_region( region ), m_width( 0 ), m_channelNames( channelNames )
+{
+	if( !m_region.isEmpty() )
+	{
+		m_width = m_region.max.x - m_region.min.x + 1;
+	}
+
+	m_sampleOffsets.resize( numPixels() + 1, 0 );
+}
+
+DeepImageBlock::~DeepImageBlock()
+{
+}
+
+const Imath::Box2i &DeepImageBlock::region() const
+{
+	return m_region;
+}
+
+unsigned DeepImageBlock::numPixels() const
+{
+	if( m_region.isEmpty() )
+	{
+		return 0;
+	}
+
+	return m_width * ( m_region.max.y - m_region.min.y + 1 );
+}
+
+unsigned DeepImageBlock::pixelIndex( int x, int y ) const
+{
+	return ( y - m_region.min.y ) * m_width + ( x - m_region.min.x );
+}
+
+unsigned DeepImageBlock::numChannels() const
+{
+	return m_channelNames.size();
+}
+
+const std::vector<std::string> &DeepImageBlock::channelNames() const
+{
+	return m_channelNames;
+}
+
+int DeepImageBlock::channelIndex( const std::string &name ) const
+{
+	std::vector<std::string>::const_iterator it = std::find( m_channelNames.begin(), m_channelNames.end(), name );
+	if( it == m_channelNames.end() )
+	{
+		return -1;
+	}
+
+	return it - m_channelNames.begin();
+}
+
+void DeepImageBlock::setSampleCounts( const std::vector<unsigned> &counts )
+{
+	const unsigned n = numPixels();
+	if( counts.size() != n )
+	{
+		throw InvalidArgumentException( "DeepImageBlock::setSampleCounts : Wrong number of sample counts." );
+	}
+
+	unsigned total = 0;
+	for( unsigned i = 0; i < n; ++i )
+	{
+		m_sampleOffsets[i] = total;
+		total += counts[i];
+	}
+	m_sampleOffsets[n] = total;
+
+	m_data.clear();
+	m_data.resize( total * ( numChannels() + 1 ), 0.0f );
+}
+
+unsigned DeepImageBlock::numSamples() const
+{
+	return m_sampleOffsets.back();
+}
+
+unsigned DeepImageBlock::numSamples( unsigned pixelIndex ) const
+{
+	return m_sampleOffsets[pixelIndex+1] - m_sampleOffsets[pixelIndex];
+}
+
+const std::vector<unsigned> &DeepImageBlock::sampleOffsets() const
+{
+	return m_sampleOffsets;
+}
+
+float *DeepImageBlock::depths()
+{
+	return m_data.empty() ? 0 : &m_data[0];
+}
+
+const float *DeepImageBlock::depths() const
+{
+	return m_data.empty() ? 0 : &m_data[0];
+}
+
+float *DeepImageBlock::channelData( unsigned channelIndex )
+{
+	return m_data.empty() ? 0 : &m_data[( channelIndex + 1 ) * numSamples()];
+}
+
+const float *DeepImageBlock::channelData( unsigned channelIndex ) const
+{
+	return m_data.empty() ? 0 : &m_data[( channelIndex + 1 ) * numSamples()];
+}
+
+void DeepImageBlock::setInterleavedSamples( const float *samples )
+{
+	const unsigned n = numSamples();
+	const unsigned numChannels = this->numChannels();
+	for( unsigned c = 0; c <= numChannels; ++c )
+	{
+		// Depth is the first plane, and comes first within each sample.
+		float *plane = &m_data[c * n];
+		const float *src = samples + c;
+		for( unsigned i = 0; i < n; ++i, src += numChannels + 1 )
+		{
+			plane[i] = *src;
+		}
+	}
+}
+
+DeepPixelPtr DeepImageBlock::pixel( int x, int y ) const
+{
+	if( !m_region.intersects( Imath::V2i( x, y ) ) )
+	{
+		throw InvalidArgumentException( "DeepImageBlock::pixel : Pixel is not inside the block." );
+	}
+
+	const unsigned index = pixelIndex( x, y );
+	const unsigned n = numSamples( index );
+	if( !n )
+	{
+		return 0;
+	}
+
+	const unsigned numChannels = this->numChannels();
+	const unsigned offset = m_sampleOffsets[index];
+
+	DeepPixelPtr result = new DeepPixel( m_channelNames, n );
+	std::vector<float> channelValues( numChannels );
+	for( unsigned i = 0; i < n; ++i )
+	{
+		for( unsigned c = 0; c < numChannels; ++c )
+		{
+			channelValues[c] = channelData( c )[offset + i];
+		}
+		result->addSample( depths()[offset + i], numChannels ? &channelValues[0] : 0 );
+	}
+
+	return result;
+}
+
+void DeepImageBlock::setPixel( int x, int y, const DeepPixel *pixel )
+{
+	if( !m_region.intersects( Imath::V2i( x, y ) ) )
+	{
+		throw InvalidArgumentException( "DeepImageBlock::setPixel : Pixel is not inside the block." );
+	}
+
+	const unsigned index = pixelIndex( x, y );
+	const unsigned n = numSamples( index );
+	if( pixel->numSamples() != n )
+	{
+		throw InvalidArgumentException( "DeepImageBlock::setPixel : DeepPixel has the wrong number of samples." );
+	}
+
+	const unsigned numChannels = this->numChannels();
+	if( pixel->numChannels() != numChannels )
+	{
+		throw InvalidArgumentException( "DeepImageBlock::setPixel : DeepPixel does not have the correct channels." );
+	}
+
+	const unsigned offset = m_sampleOffsets[index];
+	for( unsigned i = 0; i < n; ++i )
+	{
+		depths()[offset + i] = pixel->getDepth( i );
+		const float *values = pixel->channelData( i );
+		for( unsigned c = 0; c < numChannels; ++c )
+		{
+			channelData( c )[offset + i] = values[c];
+		}
+	}
+}
@@ -32,6 +32,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "boost/algorithm/string/join.hpp"
 
 #include "IECore/CompoundParameter.h"
@@ -113,13 +115,18 @@ ObjectPtr DeepImageConverter::doOperation( const CompoundObject *operands )
 		writer->worldToNDCParameter()->setValue( worldToNDC );
 	}
 
-	for ( int y=dataWindow.min.y; y <= dataWindow.max.y; ++y )
+	// Transfer the image in blocks of scanlines, so that we don't
+	// need to allocate a DeepPixel for every pixel.
+	const int blockHeight = 16;
+	for ( int y=dataWindow.min.y; y <= dataWindow.max.y; y += blockHeight )
 	{
-		for ( int x=dataWindow.min.x; x <= dataWindow.max.x; ++x )
-		{
-			DeepPixelPtr pixel = reader->readPixel( x, y );
-			writer->writePixel( x, y, pixel.get() );
-		}
+		Imath::Box2i region(
+			Imath::V2i( dataWindow.min.x, y ),
+			Imath::V2i( dataWindow.max.x, std::min( y + blockHeight - 1, dataWindow.max.y ) )
+		);
+		
+		DeepImageBlockPtr block = reader->readBlock( region );
+		writer->writeBlock( block.get() );
 	}
 
 	return new StringData( writer->fileName() );
@@ -32,6 +32,9 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
+#include "IECore/DeepImageAlgo.h"
 #include "IECore/DeepImageReader.h"
 #include "IECore/FileNameParameter.h"
 #include "IECore/ImagePrimitive.h"
@@ -57,46 +60,18 @@ ObjectPtr DeepImageReader::doOperation( const CompoundObject *operands )
 	// create our ImagePrimitive
 	ImagePrimitivePtr image = new ImagePrimitive( dataWind, displayWind );
 
-	std::vector<std::string> channels;
-	channelNames( channels );
-	
-	std::vector<std::vector<float> *> primVarData;
-	
-	Imath::V2i pixelDimensions = dataWind.size() + Imath::V2i( 1 );
-	unsigned numPixels = pixelDimensions.x * pixelDimensions.y;
-	unsigned numChannels = channels.size();
-	primVarData.reserve( numChannels );
-	
-	for ( std::vector<std::string>::const_iterator cIt = channels.begin(); cIt != channels.end(); ++cIt )
+	// read and composite a block of scanlines at a time, so
+	// that we never need to hold the samples for the whole image.
+	const int blockHeight = 64;
+	for ( int y=dataWind.min.y; y <= dataWind.max.y; y += blockHeight )
 	{
-		FloatVectorDataPtr data = new FloatVectorData( std::vector<float>( numPixels ) );
-		primVarData.push_back( &data->writable() );
-		
-		image->variables[*cIt] = PrimitiveVariable( PrimitiveVariable::Vertex, data );
-	}
+		Imath::Box2i region(
+			Imath::V2i( dataWind.min.x, y ),
+			Imath::V2i( dataWind.max.x, std::min( y + blockHeight - 1, dataWind.max.y ) )
+		);
 
-	DeepPixelPtr pixel = 0;
-	float channelData[channels.size()];
-	
-	unsigned p = 0;
-	for ( int y=dataWind.min.y; y < dataWind.max.y + 1; ++y )
-	{
-		for ( int x=dataWind.min.x; x < dataWind.max.x + 1; ++x, ++p )
-		{
-			pixel = readPixel( x, y );
-			
-			if ( !pixel )
-			{
-				continue;
-			}
-			
-			pixel->composite( channelData );
-			
-			for ( unsigned c=0; c < numChannels; ++c )
-			{
-				(*primVarData[c])[p] = channelData[c];
-			}
-		}
+		DeepImageBlockPtr block = readBlock( region );
+		DeepImageAlgo::flatten( block.get(), image.get() );
 	}
 	
 	return image;
@@ -113,6 +88,54 @@ DeepPixelPtr DeepImageReader::readPixel( int x, int y )
 	return doReadPixel( x, y );
 }
 
+DeepImageBlockPtr DeepImageReader::readBlock( const Imath::Box2i &region )
+{
+	const Imath::Box2i dataWind = dataWindow();
+	if( region.isEmpty() || !dataWind.intersects( region.min ) || !dataWind.intersects( region.max ) )
+	{
+		throw Exception( "Requested region not in available data window." );
+	}
+
+	return doReadBlock( region );
+}
+
+DeepImageBlockPtr DeepImageReader::doReadBlock( const Imath::Box2i &region )
+{
+	std::vector<std::string> channels;
+	channelNames( channels );
+
+	DeepImageBlockPtr result = new DeepImageBlock( region, channels );
+
+	std::vector<DeepPixelPtr> pixels;
+	pixels.reserve( result->numPixels() );
+	std::vector<unsigned> sampleCounts;
+	sampleCounts.reserve( result->numPixels() );
+	for ( int y = region.min.y; y <= region.max.y; ++y )
+	{
+		for ( int x = region.min.x; x <= region.max.x; ++x )
+		{
+			pixels.push_back( doReadPixel( x, y ) );
+			sampleCounts.push_back( pixels.back() ? pixels.back()->numSamples() : 0 );
+		}
+	}
+
+	result->setSampleCounts( sampleCounts );
+
+	std::vector<DeepPixelPtr>::const_iterator it = pixels.begin();
+	for ( int y = region.min.y; y <= region.max.y; ++y )
+	{
+		for ( int x = region.min.x; x <= region.max.x; ++x, ++it )
+		{
+			if ( *it )
+			{
+				result->setPixel( x, y, it->get() );
+			}
+		}
+	}
+
+	return result;
+}
+
 CompoundObjectPtr DeepImageReader::readHeader()
 {
 	std::vector<std::string> names;
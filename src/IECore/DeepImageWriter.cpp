@@ -125,6 +125,37 @@ void DeepImageWriter::writePixel( int x, int y, const DeepPixel *pixel )
 	doWritePixel( x, y, pixel );
 }
 
+void DeepImageWriter::writeBlock( const DeepImageBlock *block )
+{
+	if ( !block )
+	{
+		return;
+	}
+
+	if ( block->numChannels() != m_channelsParameter->getTypedValue().size() )
+	{
+		throw InvalidArgumentException( std::string( "DeepImageBlock does not have the correct channels." ) );
+	}
+
+	doWriteBlock( block );
+}
+
+void DeepImageWriter::doWriteBlock( const DeepImageBlock *block )
+{
+	const Imath::Box2i &region = block->region();
+	for ( int y = region.min.y; y <= region.max.y; ++y )
+	{
+		for ( int x = region.min.x; x <= region.max.x; ++x )
+		{
+			DeepPixelPtr pixel = block->pixel( x, y );
+			if ( pixel )
+			{
+				doWritePixel( x, y, pixel.get() );
+			}
+		}
+	}
+}
+
 void DeepImageWriter::registerDeepImageWriter( const std::string &extensions, CanWriteFn canWrite, CreatorFn creator, TypeId typeId )
 {
 	assert( canWrite );
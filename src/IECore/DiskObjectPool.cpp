@@ -0,0 +1,367 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <ctime>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "tbb/atomic.h"
+#include "tbb/mutex.h"
+
+#include "IECore/DiskObjectPool.h"
+#include "IECore/FileIndexedIO.h"
+#include "IECore/Exception.h"
+
+using namespace IECore;
+using namespace boost::filesystem;
+
+//////////////////////////////////////////////////////////////////////////
+// MemberData
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const char *g_extension = ".cob";
+const char *g_temporaryExtension = ".tmp";
+
+// Temporary files are still being written by another thread or process,
+// so we only remove ones old enough to have been abandoned by a process
+// that died while writing them.
+const std::time_t g_abandonedTemporaryFileAge = 60 * 60;
+
+struct File
+{
+
+	File( const path &p, std::time_t t, boost::uintmax_t s )
+		:	filePath( p ), time( t ), size( s ), temporary( p.extension() == g_temporaryExtension )
+	{
+	}
+
+	// Returns true if the file may be removed by trim() or clear().
+	bool removable( std::time_t now ) const
+	{
+		return !temporary || now - time > g_abandonedTemporaryFileAge;
+	}
+
+	bool operator < ( const File &other ) const
+	{
+		return time < other.time;
+	}
+
+	path filePath;
+	std::time_t time;
+	boost::uintmax_t size;
+	bool temporary;
+
+};
+
+bool isPoolFile( const path &p )
+{
+	const path extension = p.extension();
+	return extension == g_extension || extension == g_temporaryExtension;
+}
+
+} // namespace
+
+struct DiskObjectPool::MemberData
+{
+
+	MemberData( const std::string &directory, size_t maxDiskUsage )
+		:	directory( directory )
+	{
+		this->maxDiskUsage = maxDiskUsage;
+		diskUsage = 0;
+	}
+
+	// Objects are stored in subdirectories named using the first
+	// two characters of the hash, to avoid having huge numbers of
+	// files in a single directory.
+	path fileName( const MurmurHash &hash ) const
+	{
+		const std::string h = hash.toString();
+		return path( directory ) / h.substr( 0, 2 ) / ( h + g_extension );
+	}
+
+	// Lists all the files belonging to the pool.
+	void files( std::vector<File> &result ) const
+	{
+		// Other processes may be adding and removing files concurrently,
+		// so we must tolerate errors for individual files.
+		boost::system::error_code ec;
+		for( directory_iterator it( directory, ec ), eIt; !ec && it != eIt; it.increment( ec ) )
+		{
+			if( !is_directory( it->path(), ec ) )
+			{
+				continue;
+			}
+			boost::system::error_code subdirectoryEC;
+			for( directory_iterator fIt( it->path(), subdirectoryEC ); !subdirectoryEC && fIt != eIt; fIt.increment( subdirectoryEC ) )
+			{
+				const path &p = fIt->path();
+				if( !isPoolFile( p ) )
+				{
+					continue;
+				}
+				boost::system::error_code fileEC;
+				const boost::uintmax_t size = file_size( p, fileEC );
+				if( fileEC )
+				{
+					continue;
+				}
+				const std::time_t time = last_write_time( p, fileEC );
+				if( fileEC )
+				{
+					continue;
+				}
+				result.push_back( File( p, time, size ) );
+			}
+		}
+	}
+
+	// Measures the files on disk, and removes the least recently used
+	// ones if they exceed the limit. Because other processes may be
+	// storing files too, we trim to a little below the limit, so we
+	// don't need to do this again immediately.
+	void trim()
+	{
+		tbb::mutex::scoped_lock lock;
+		if( !lock.try_acquire( trimMutex ) )
+		{
+			// Another thread is trimming already.
+			return;
+		}
+
+		std::vector<File> allFiles;
+		files( allFiles );
+
+		boost::uintmax_t total = 0;
+		for( std::vector<File>::const_iterator it = allFiles.begin(); it != allFiles.end(); ++it )
+		{
+			total += it->size;
+		}
+
+		if( total > maxDiskUsage )
+		{
+			const boost::uintmax_t target = ( (boost::uintmax_t)maxDiskUsage / 10 ) * 9;
+			const std::time_t now = std::time( 0 );
+			std::sort( allFiles.begin(), allFiles.end() );
+			for( std::vector<File>::const_iterator it = allFiles.begin(); it != allFiles.end() && total > target; ++it )
+			{
+				if( !it->removable( now ) )
+				{
+					continue;
+				}
+				boost::system::error_code ec;
+				if( boost::filesystem::remove( it->filePath, ec ) )
+				{
+					total -= it->size;
+				}
+			}
+		}
+
+		diskUsage = total;
+	}
+
+	const std::string directory;
+	tbb::atomic<size_t> maxDiskUsage;
+	tbb::atomic<size_t> diskUsage;
+	tbb::mutex trimMutex;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// DiskObjectPool
+//////////////////////////////////////////////////////////////////////////
+
+DiskObjectPool::DiskObjectPool( const std::string &directory, size_t maxDiskUsage )
+	:	m_data( new MemberData( directory, maxDiskUsage ) )
+{
+	try
+	{
+		create_directories( directory );
+	}
+	catch( const std::exception &e )
+	{
+		throw IOException( "DiskObjectPool : Unable to create directory \"" + directory + "\" : " + e.what() );
+	}
+	m_data->trim();
+}
+
+DiskObjectPool::~DiskObjectPool()
+{
+}
+
+const std::string &DiskObjectPool::directory() const
+{
+	return m_data->directory;
+}
+
+bool DiskObjectPool::store( const Object *obj )
+{
+	const path fileName = m_data->fileName( obj->hash() );
+
+	boost::system::error_code ec;
+	if( exists( fileName, ec ) )
+	{
+		// Update the modification time so that the file
+		// is considered to have been used recently.
+		last_write_time( fileName, std::time( 0 ), ec );
+		return false;
+	}
+
+	// We write to a uniquely named temporary file and then rename
+	// it, so that other threads and processes never see partially
+	// written files.
+	static tbb::atomic<size_t> g_count;
+	const std::string temporaryFileName =
+		fileName.string() + "." + boost::lexical_cast<std::string>( getpid() ) + "." +
+		boost::lexical_cast<std::string>( g_count++ ) + g_temporaryExtension
+	;
+
+	try
+	{
+		create_directories( fileName.parent_path() );
+		{
+			IndexedIOPtr io = new FileIndexedIO( temporaryFileName, IndexedIO::rootPath, IndexedIO::Exclusive | IndexedIO::Write );
+			obj->save( io, "object" );
+		}
+		boost::filesystem::rename( temporaryFileName, fileName );
+	}
+	catch( const std::exception &e )
+	{
+		boost::filesystem::remove( temporaryFileName, ec );
+		throw IOException( "DiskObjectPool : Unable to write \"" + fileName.string() + "\" : " + e.what() );
+	}
+
+	m_data->diskUsage += file_size( fileName, ec );
+	if( m_data->diskUsage > m_data->maxDiskUsage )
+	{
+		m_data->trim();
+	}
+
+	return true;
+}
+
+ObjectPtr DiskObjectPool::retrieve( const MurmurHash &hash ) const
+{
+	const path fileName = m_data->fileName( hash );
+
+	boost::system::error_code ec;
+	if( !exists( fileName, ec ) )
+	{
+		return 0;
+	}
+
+	ObjectPtr result;
+	try
+	{
+		ConstIndexedIOPtr io = new FileIndexedIO( fileName.string(), IndexedIO::rootPath, IndexedIO::Read );
+		result = Object::load( io, "object" );
+	}
+	catch( const IECore::Exception & )
+	{
+		// The file may have been removed by another process
+		// while we were reading it, in which case we just treat
+		// it as missing. Otherwise it's been damaged somehow,
+		// and we remove it so it doesn't trouble us again.
+		// Other exceptions, such as std::bad_alloc, say nothing
+		// about the file, so we leave it in place and let them
+		// propagate.
+		boost::filesystem::remove( fileName, ec );
+		return 0;
+	}
+
+	last_write_time( fileName, std::time( 0 ), ec );
+	return result;
+}
+
+bool DiskObjectPool::contains( const MurmurHash &hash ) const
+{
+	boost::system::error_code ec;
+	return exists( m_data->fileName( hash ), ec );
+}
+
+bool DiskObjectPool::erase( const MurmurHash &hash )
+{
+	const path fileName = m_data->fileName( hash );
+
+	boost::system::error_code ec;
+	const boost::uintmax_t size = file_size( fileName, ec );
+	if( ec || !boost::filesystem::remove( fileName, ec ) )
+	{
+		return false;
+	}
+
+	m_data->diskUsage -= std::min<size_t>( size, m_data->diskUsage );
+	return true;
+}
+
+void DiskObjectPool::clear()
+{
+	std::vector<File> allFiles;
+	m_data->files( allFiles );
+	const std::time_t now = std::time( 0 );
+	boost::uintmax_t remaining = 0;
+	for( std::vector<File>::const_iterator it = allFiles.begin(); it != allFiles.end(); ++it )
+	{
+		boost::system::error_code ec;
+		if( !it->removable( now ) || !boost::filesystem::remove( it->filePath, ec ) )
+		{
+			remaining += it->size;
+		}
+	}
+	m_data->diskUsage = remaining;
+}
+
+void DiskObjectPool::setMaxDiskUsage( size_t maxDiskUsage )
+{
+	m_data->maxDiskUsage = maxDiskUsage;
+	m_data->trim();
+}
+
+size_t DiskObjectPool::getMaxDiskUsage() const
+{
+	return m_data->maxDiskUsage;
+}
+
+size_t DiskObjectPool::diskUsage() const
+{
+	return m_data->diskUsage;
+}
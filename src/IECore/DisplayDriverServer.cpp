@@ -35,8 +35,11 @@
 #include <unistd.h>
 #include <fcntl.h>
 
+#include <algorithm>
+
 #include "boost/asio.hpp"
 #include "boost/bind.hpp"
+#include "boost/shared_ptr.hpp"
 #include "tbb/tbb_thread.h"
 
 #include "IECore/DisplayDriverServer.h"
@@ -51,6 +54,11 @@ using namespace boost;
 
 IE_CORE_DEFINERUNTIMETYPED( DisplayDriverServer );
 
+// The maximum number of imageData blocks a session will read ahead of the
+// DisplayDriver. Reading is paused when this is reached, so that a slow driver
+// doesn't cause an unbounded amount of data to be buffered.
+static const size_t g_maxPendingBlocks = 16;
+
 class DisplayDriverServer::Session : public RefCounted
 {
 	public:
@@ -63,17 +71,38 @@ class DisplayDriverServer::Session : public RefCounted
 
 	private:
 
+		void readHeader();
 		void handleReadHeader( const boost::system::error_code& error );
 		void handleReadOpenParameters( const boost::system::error_code& error );
 		void handleReadDataParameters( const boost::system::error_code& error );
 		void sendResult( DisplayDriverServerHeader::MessageType msg, size_t dataSize );
 		void sendException( const char *message );
 
+		// Called on m_dispatchStrand to pass the data on to the DisplayDriver.
+		void dispatchData( CharVectorDataPtr block );
+		void dispatchClose();
+		// Called back on m_strand once the above have completed.
+		void handleDataDispatched( bool success );
+		void handleCloseDispatched( bool success, const std::string &error );
+
 	private:
 		boost::asio::ip::tcp::socket m_socket;
+		// Serialises all the socket handlers, so that each session is serviced by only
+		// one thread at a time, while separate sessions are serviced concurrently.
+		boost::asio::io_service::strand m_strand;
+		// Serialises the decoding of blocks and the calls to the DisplayDriver, so that
+		// the next block can be read from the socket while the last one is dispatched.
+		boost::asio::io_service::strand m_dispatchStrand;
 		DisplayDriverPtr m_displayDriver;
 		DisplayDriverServerHeader m_header;
 		CharVectorDataPtr m_buffer;
+		DisplayDriverServerHeader::DataEncoding m_dataEncoding;
+		// Only accessed on m_strand.
+		size_t m_pendingBlocks;
+		bool m_readPaused;
+		// Only accessed on m_dispatchStrand.
+		bool m_dispatchFailed;
+		std::vector<float> m_decodedData;
 };
 
 class DisplayDriverServer::PrivateData : public RefCounted
@@ -85,14 +114,13 @@ class DisplayDriverServer::PrivateData : public RefCounted
 		boost::asio::ip::tcp::endpoint m_endpoint;
 		boost::asio::io_service m_service;
 		boost::asio::ip::tcp::acceptor m_acceptor;
-		tbb::tbb_thread m_thread;
+		std::vector<boost::shared_ptr<tbb::tbb_thread> > m_threads;
 
 		PrivateData( int portNumber ) :
 			m_success(false),
 			m_endpoint(tcp::v4(), portNumber),
 			m_service(),
-			m_acceptor( m_service ),
-			m_thread()
+			m_acceptor( m_service )
 		{
 			m_acceptor.open(  m_endpoint.protocol() );
 			m_acceptor.set_option( boost::asio::ip::tcp::acceptor::reuse_address(true));
@@ -107,7 +135,10 @@ class DisplayDriverServer::PrivateData : public RefCounted
 			{
 				m_acceptor.cancel();
 				m_acceptor.close();
-				m_thread.join();
+				for( std::vector<boost::shared_ptr<tbb::tbb_thread> >::const_iterator it = m_threads.begin(); it != m_threads.end(); ++it )
+				{
+					(*it)->join();
+				}
 			}
 		}
 
@@ -123,7 +154,7 @@ static void fixSocketFlags( int socketDesc )
 	}
 }
 
-DisplayDriverServer::DisplayDriverServer( int portNumber ) :
+DisplayDriverServer::DisplayDriverServer( int portNumber, int numThreads ) :
 		m_data( 0 )
 {
 	m_data = new DisplayDriverServer::PrivateData( portNumber );
@@ -133,8 +164,15 @@ DisplayDriverServer::DisplayDriverServer( int portNumber ) :
 			boost::bind( &DisplayDriverServer::handleAccept, this, newSession,
 			boost::asio::placeholders::error));
 	fixSocketFlags( m_data->m_acceptor.native() );
-	tbb::tbb_thread newThread( boost::bind(&DisplayDriverServer::serverThread, this) );
-	m_data->m_thread.swap( newThread );
+
+	if( numThreads <= 0 )
+	{
+		numThreads = std::max( 1u, tbb::tbb_thread::hardware_concurrency() );
+	}
+	for( int i = 0; i < numThreads; ++i )
+	{
+		m_data->m_threads.push_back( boost::shared_ptr<tbb::tbb_thread>( new tbb::tbb_thread( boost::bind( &DisplayDriverServer::serverThread, this ) ) ) );
+	}
 }
 
 DisplayDriverServer::~DisplayDriverServer()
@@ -146,6 +184,11 @@ int DisplayDriverServer::portNumber()
 	return m_data->m_acceptor.local_endpoint().port();
 }
 
+int DisplayDriverServer::numThreads()
+{
+	return m_data->m_threads.size();
+}
+
 void DisplayDriverServer::serverThread()
 {
 	try
@@ -175,7 +218,8 @@ void DisplayDriverServer::handleAccept( DisplayDriverServer::SessionPtr session,
  */
 
 DisplayDriverServer::Session::Session( boost::asio::io_service& io_service ) :
-	m_socket( io_service ), m_displayDriver(0), m_buffer( new CharVectorData( ) )
+	m_socket( io_service ), m_strand( io_service ), m_dispatchStrand( io_service ), m_displayDriver(0), m_buffer( new CharVectorData( ) ),
+	m_dataEncoding( DisplayDriverServerHeader::floatData ), m_pendingBlocks( 0 ), m_readPaused( false ), m_dispatchFailed( false )
 {
 }
 
@@ -190,22 +234,32 @@ boost::asio::ip::tcp::socket& DisplayDriverServer::Session::socket()
 }
 
 void DisplayDriverServer::Session::start()
+{
+	readHeader();
+	fixSocketFlags( m_socket.native() );
+}
+
+void DisplayDriverServer::Session::readHeader()
 {
 	boost::asio::async_read( m_socket,
 			boost::asio::buffer( m_header.buffer(), m_header.headerLength),
-			boost::bind(
-				&DisplayDriverServer::Session::handleReadHeader, SessionPtr(this),
-				boost::asio::placeholders::error
+			m_strand.wrap(
+				boost::bind(
+					&DisplayDriverServer::Session::handleReadHeader, SessionPtr(this),
+					boost::asio::placeholders::error
+				)
 			)
 	);
-	fixSocketFlags( m_socket.native() );
 }
 
 void DisplayDriverServer::Session::handleReadHeader( const boost::system::error_code& error )
 {
 	if (error)
 	{
-		msg( Msg::Error, "DisplayDriverServer::Session::handleReadHeader", error.message().c_str() );
+		if( error != boost::asio::error::operation_aborted )
+		{
+			msg( Msg::Error, "DisplayDriverServer::Session::handleReadHeader", error.message().c_str() );
+		}
 		m_socket.close();
 		return;
 	}
@@ -229,40 +283,22 @@ void DisplayDriverServer::Session::handleReadHeader( const boost::system::error_
 	case DisplayDriverServerHeader::imageOpen:
 		boost::asio::async_read( m_socket,
 				boost::asio::buffer( &data[0], bytesAhead ),
-				boost::bind( &DisplayDriverServer::Session::handleReadOpenParameters, SessionPtr(this), boost::asio::placeholders::error)
+				m_strand.wrap( boost::bind( &DisplayDriverServer::Session::handleReadOpenParameters, SessionPtr(this), boost::asio::placeholders::error) )
 		);
 		break;
 
 	case DisplayDriverServerHeader::imageData:
 		boost::asio::async_read( m_socket,
 				boost::asio::buffer( &data[0], bytesAhead ),
-				boost::bind(&DisplayDriverServer::Session::handleReadDataParameters, SessionPtr(this),
-				boost::asio::placeholders::error));
+				m_strand.wrap( boost::bind(&DisplayDriverServer::Session::handleReadDataParameters, SessionPtr(this),
+				boost::asio::placeholders::error) ) );
 		break;
 
 	case DisplayDriverServerHeader::imageClose:
 		if ( m_displayDriver )
 		{
-			try
-			{
-				m_displayDriver->imageClose();
-			}
-			catch ( std::exception &e )
-			{
-				msg( Msg::Error, "DisplayDriverServer::Session::handleReadHeader", e.what() );
-				sendException( e.what() );
-				m_socket.close();
-				return;
-			}
-			try
-			{
-				sendResult( DisplayDriverServerHeader::imageClose, 0 );
-			}
-			catch( std::exception &e )
-			{
-				msg( Msg::Error, "DisplayDriverServer::Session::handleReadHeader", e.what() );
-			}
-			m_socket.close();
+			// the close must follow any data still waiting to be dispatched.
+			m_dispatchStrand.post( boost::bind( &DisplayDriverServer::Session::dispatchClose, SessionPtr(this) ) );
 		}
 		else
 		{
@@ -310,6 +346,19 @@ void DisplayDriverServer::Session::handleReadOpenParameters( const boost::system
 
 		scanLineOrder = m_displayDriver->scanLineOrderOnly();
 		acceptsRepeatedData = m_displayDriver->acceptsRepeatedData();
+
+		m_dataEncoding = DisplayDriverServerHeader::floatData;
+		if( const StringData *encoding = parameters->member<StringData>( "displayDataEncoding" ) )
+		{
+			if( encoding->readable() == "halfLZ4" && DisplayDriverServerHeader::encodingAvailable( DisplayDriverServerHeader::halfLZ4Data ) )
+			{
+				m_dataEncoding = DisplayDriverServerHeader::halfLZ4Data;
+			}
+			else if( encoding->readable() == "half" || encoding->readable() == "halfLZ4" )
+			{
+				m_dataEncoding = DisplayDriverServerHeader::halfData;
+			}
+		}
 	}
 	catch( std::exception &e )
 	{
@@ -328,14 +377,12 @@ void DisplayDriverServer::Session::handleReadOpenParameters( const boost::system
 		sendResult( DisplayDriverServerHeader::imageOpen, sizeof(acceptsRepeatedData) );
 		m_socket.send( boost::asio::buffer( &acceptsRepeatedData, sizeof(acceptsRepeatedData) ) );
 
+		const unsigned char dataEncoding = m_dataEncoding;
+		sendResult( DisplayDriverServerHeader::imageOpen, sizeof(dataEncoding) );
+		m_socket.send( boost::asio::buffer( &dataEncoding, sizeof(dataEncoding) ) );
+
 		// prepare for getting imageData packages
-		boost::asio::async_read( m_socket,
-			boost::asio::buffer( m_header.buffer(), m_header.headerLength),
-			boost::bind(
-				&DisplayDriverServer::Session::handleReadHeader, SessionPtr(this),
-				boost::asio::placeholders::error
-			)
-		);
+		readHeader();
 	}
 	catch( std::exception &e )
 	{
@@ -362,34 +409,115 @@ void DisplayDriverServer::Session::handleReadDataParameters( const boost::system
 		return;
 	}
 
-	try
+	// hand the block over to be dispatched, and carry on reading
+	// unless too many are already waiting.
+	CharVectorDataPtr block = new CharVectorData;
+	block->writable().swap( m_buffer->writable() );
+	m_dispatchStrand.post( boost::bind( &DisplayDriverServer::Session::dispatchData, SessionPtr(this), block ) );
+
+	if( ++m_pendingBlocks < g_maxPendingBlocks )
 	{
-		/// \todo Swap byte order if the sending host has a different order to us.
-		/// We used to send the data via MemoryIndexedIO which would take care of this
-		/// for us, but the overhead of this significantly affected interactive render
-		/// speeds.
-		const Imath::Box2i box = *reinterpret_cast<const Imath::Box2i *>( &m_buffer->readable()[0] );
-		const float *data = reinterpret_cast<const float *>( &m_buffer->readable()[0] + sizeof( box ) );
-		const size_t dataSize = ( m_buffer->readable().size() - sizeof( box ) ) / sizeof( float );
-
-		// call imageData passing the data
-		m_displayDriver->imageData( box, data, dataSize );
-
-		// prepare for getting more imageData packages or a imageClose.
-		boost::asio::async_read( m_socket,
-			boost::asio::buffer( m_header.buffer(), m_header.headerLength),
-			boost::bind(
-				&DisplayDriverServer::Session::handleReadHeader, SessionPtr(this),
-				boost::asio::placeholders::error
-			)
-		);
+		readHeader();
 	}
-	catch( std::exception &e )
+	else
+	{
+		m_readPaused = true;
+	}
+}
+
+void DisplayDriverServer::Session::dispatchData( CharVectorDataPtr block )
+{
+	bool success = !m_dispatchFailed;
+	if( success )
+	{
+		try
+		{
+			/// \todo Swap byte order if the sending host has a different order to us.
+			/// We used to send the data via MemoryIndexedIO which would take care of this
+			/// for us, but the overhead of this significantly affected interactive render
+			/// speeds.
+			const CharVectorData::ValueType &buffer = block->readable();
+			const Imath::Box2i box = *reinterpret_cast<const Imath::Box2i *>( &buffer[0] );
+			const float *data = reinterpret_cast<const float *>( &buffer[0] + sizeof( box ) );
+			size_t dataSize = ( buffer.size() - sizeof( box ) ) / sizeof( float );
+			if( m_dataEncoding != DisplayDriverServerHeader::floatData )
+			{
+				DisplayDriverServerHeader::decodeData( m_dataEncoding, &buffer[0] + sizeof( box ), buffer.size() - sizeof( box ), m_decodedData );
+				data = m_decodedData.size() ? &m_decodedData[0] : 0;
+				dataSize = m_decodedData.size();
+			}
+
+			// call imageData passing the data
+			m_displayDriver->imageData( box, data, dataSize );
+		}
+		catch( std::exception &e )
+		{
+			msg( Msg::Error, "DisplayDriverServer::Session::dispatchData", e.what() );
+			m_dispatchFailed = success = false;
+		}
+	}
+
+	m_strand.post( boost::bind( &DisplayDriverServer::Session::handleDataDispatched, SessionPtr(this), success ) );
+}
+
+void DisplayDriverServer::Session::handleDataDispatched( bool success )
+{
+	m_pendingBlocks--;
+	if( !success )
 	{
-		msg( Msg::Error, "DisplayDriverServer::Session::handleReadDataParameters", e.what() );
 		m_socket.close();
 		return;
 	}
+
+	if( m_readPaused && m_socket.is_open() )
+	{
+		m_readPaused = false;
+		readHeader();
+	}
+}
+
+void DisplayDriverServer::Session::dispatchClose()
+{
+	if( m_dispatchFailed )
+	{
+		// the socket has been closed by handleDataDispatched().
+		return;
+	}
+
+	bool success = true;
+	std::string error;
+	try
+	{
+		m_displayDriver->imageClose();
+	}
+	catch ( std::exception &e )
+	{
+		msg( Msg::Error, "DisplayDriverServer::Session::dispatchClose", e.what() );
+		success = false;
+		error = e.what();
+	}
+
+	m_strand.post( boost::bind( &DisplayDriverServer::Session::handleCloseDispatched, SessionPtr(this), success, error ) );
+}
+
+void DisplayDriverServer::Session::handleCloseDispatched( bool success, const std::string &error )
+{
+	try
+	{
+		if( success )
+		{
+			sendResult( DisplayDriverServerHeader::imageClose, 0 );
+		}
+		else
+		{
+			sendException( error.c_str() );
+		}
+	}
+	catch( std::exception &e )
+	{
+		msg( Msg::Error, "DisplayDriverServer::Session::handleCloseDispatched", e.what() );
+	}
+	m_socket.close();
 }
 
 void DisplayDriverServer::Session::sendResult( DisplayDriverServerHeader::MessageType msg, size_t dataSize )
@@ -32,7 +32,16 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
+
+#include "OpenEXR/half.h"
+
+#ifdef IECORE_WITH_LZ4
+#include "lz4.h"
+#endif
+
 #include "IECore/private/DisplayDriverServerHeader.h"
+#include "IECore/Exception.h"
 
 using namespace IECore;
 
@@ -96,3 +105,140 @@ DisplayDriverServerHeader::MessageType DisplayDriverServerHeader::messageType()
 {
 	return (MessageType)m_header[2];
 }
+
+bool DisplayDriverServerHeader::encodingAvailable( DataEncoding encoding )
+{
+	switch( encoding )
+	{
+		case floatData :
+		case halfData :
+			return true;
+		case halfLZ4Data :
+#ifdef IECORE_WITH_LZ4
+			return true;
+#else
+			return false;
+#endif
+		default :
+			return false;
+	}
+}
+
+void DisplayDriverServerHeader::encodeData( DataEncoding encoding, const float *data, size_t dataSize, std::vector<char> &result )
+{
+	const size_t offset = result.size();
+	switch( encoding )
+	{
+		case floatData :
+			result.insert( result.end(), reinterpret_cast<const char *>( data ), reinterpret_cast<const char *>( data + dataSize ) );
+			break;
+		case halfData :
+		{
+			result.resize( offset + dataSize * sizeof( half ) );
+			for( size_t i = 0; i < dataSize; ++i )
+			{
+				const half h( data[i] );
+				memcpy( &result[offset + i * sizeof( half )], &h, sizeof( half ) );
+			}
+			break;
+		}
+#ifdef IECORE_WITH_LZ4
+		case halfLZ4Data :
+		{
+			const size_t halfSize = dataSize * sizeof( half );
+			if( halfSize > (size_t)LZ4_MAX_INPUT_SIZE )
+			{
+				throw Exception( "DisplayDriverServerHeader: Image data too large for LZ4 compression." );
+			}
+
+			// group the low and high bytes of the halfs
+			std::vector<char> shuffled( halfSize );
+			for( size_t i = 0; i < dataSize; ++i )
+			{
+				const unsigned short bits = half( data[i] ).bits();
+				shuffled[i] = bits & 0xff;
+				shuffled[dataSize + i] = bits >> 8;
+			}
+
+			const unsigned int numValues = dataSize;
+			result.resize( offset + sizeof( numValues ) + LZ4_compressBound( halfSize ) );
+			memcpy( &result[offset], &numValues, sizeof( numValues ) );
+			if( halfSize )
+			{
+				const size_t start = offset + sizeof( numValues );
+				int compressedSize = LZ4_compress_default( &shuffled[0], &result[start], halfSize, result.size() - start );
+				if( compressedSize <= 0 )
+				{
+					throw Exception( "DisplayDriverServerHeader: LZ4 compression failed." );
+				}
+				result.resize( start + compressedSize );
+			}
+			else
+			{
+				result.resize( offset + sizeof( numValues ) );
+			}
+			break;
+		}
+#endif
+		default :
+			throw Exception( "DisplayDriverServerHeader: Unsupported data encoding." );
+	}
+}
+
+void DisplayDriverServerHeader::decodeData( DataEncoding encoding, const char *data, size_t size, std::vector<float> &result )
+{
+	switch( encoding )
+	{
+		case floatData :
+			result.resize( size / sizeof( float ) );
+			if( result.size() )
+			{
+				memcpy( &result[0], data, result.size() * sizeof( float ) );
+			}
+			break;
+		case halfData :
+		{
+			result.resize( size / sizeof( half ) );
+			const half *h = reinterpret_cast<const half *>( data );
+			for( size_t i = 0; i < result.size(); ++i )
+			{
+				result[i] = h[i];
+			}
+			break;
+		}
+#ifdef IECORE_WITH_LZ4
+		case halfLZ4Data :
+		{
+			unsigned int numValues = 0;
+			if( size < sizeof( numValues ) )
+			{
+				throw Exception( "DisplayDriverServerHeader: Invalid compressed image data." );
+			}
+			memcpy( &numValues, data, sizeof( numValues ) );
+			result.resize( numValues );
+			if( !numValues )
+			{
+				break;
+			}
+
+			const size_t halfSize = numValues * sizeof( half );
+			std::vector<char> shuffled( halfSize );
+			int decompressedSize = LZ4_decompress_safe( data + sizeof( numValues ), &shuffled[0], size - sizeof( numValues ), halfSize );
+			if( decompressedSize < 0 || (size_t)decompressedSize != halfSize )
+			{
+				throw Exception( "DisplayDriverServerHeader: LZ4 decompression failed." );
+			}
+
+			half h;
+			for( size_t i = 0; i < numValues; ++i )
+			{
+				h.setBits( (unsigned char)shuffled[i] | ( (unsigned short)(unsigned char)shuffled[numValues + i] << 8 ) );
+				result[i] = h;
+			}
+			break;
+		}
+#endif
+		default :
+			throw Exception( "DisplayDriverServerHeader: Unsupported data encoding." );
+	}
+}
@@ -235,6 +235,101 @@ DeepPixelPtr EXRDeepImageReader::doReadPixel( int x, int y )
 	return pixel;
 }
 
+DeepImageBlockPtr EXRDeepImageReader::doReadBlock( const Imath::Box2i &region )
+{
+	open( true );
+
+	DeepImageBlockPtr result = new DeepImageBlock( region, m_channelNames );
+
+	const int minX = m_inputFile->header().dataWindow().min.x;
+	const int width = region.max.x - region.min.x + 1;
+
+	// Fetch the scanlines and count the samples, so we can
+	// allocate the block in one go.
+	std::vector<Scanline::Ptr> scanlines;
+	scanlines.reserve( region.max.y - region.min.y + 1 );
+	std::vector<unsigned> sampleCounts;
+	sampleCounts.reserve( result->numPixels() );
+	for ( int y = region.min.y; y <= region.max.y; ++y )
+	{
+		Scanline::Ptr scanline = m_cache->get( y );
+		scanlines.push_back( scanline );
+		for ( int x = region.min.x; x <= region.max.x; ++x )
+		{
+			sampleCounts.push_back( scanline ? scanline->sampleCount[x - minX] : 0 );
+		}
+	}
+
+	result->setSampleCounts( sampleCounts );
+	if ( !result->numSamples() )
+	{
+		return result;
+	}
+
+	// Pointers to the destination plane for each channel in the file,
+	// including the depth channel.
+	const int numFileChannels = m_channelTypes.size();
+	std::vector<float *> planes( numFileChannels );
+	for ( int c = 0; c < numFileChannels; ++c )
+	{
+		if ( c == m_depthChannel )
+		{
+			planes[c] = result->depths();
+		}
+		else
+		{
+			planes[c] = result->channelData( c > m_depthChannel ? c - 1 : c );
+		}
+	}
+
+	const std::vector<unsigned> &offsets = result->sampleOffsets();
+	unsigned pixelIndex = 0;
+	for ( int y = region.min.y; y <= region.max.y; ++y )
+	{
+		const Scanline *scanline = scanlines[y - region.min.y].get();
+		if ( !scanline )
+		{
+			pixelIndex += width;
+			continue;
+		}
+
+		for ( int x = region.min.x; x <= region.max.x; ++x, ++pixelIndex )
+		{
+			const size_t xOffset = x - minX;
+			const unsigned numSamples = scanline->sampleCount[xOffset];
+			if ( !numSamples )
+			{
+				continue;
+			}
+
+			// The samples for each channel follow those of the previous
+			// channel, starting at the pointer for the first channel.
+			const char *ptr = reinterpret_cast< const char * >( scanline->pointers[xOffset] );
+			const unsigned offset = offsets[pixelIndex];
+			for ( int c = 0; c < numFileChannels; ++c )
+			{
+				float *dst = planes[c] + offset;
+				if ( m_channelTypes[c] == Imf::FLOAT )
+				{
+					memcpy( dst, ptr, numSamples * sizeof( float ) );
+					ptr += numSamples * sizeof( float );
+				}
+				else
+				{
+					const half *src = reinterpret_cast< const half * >( ptr );
+					for ( unsigned i = 0; i < numSamples; ++i )
+					{
+						dst[i] = src[i];
+					}
+					ptr += numSamples * sizeof( half );
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
 EXRDeepImageReader::Scanline::Scanline( size_t width, size_t numChannels )
 	: sampleCount( width ), pointers( width * numChannels ), data()
 {
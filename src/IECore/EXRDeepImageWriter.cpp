@@ -203,10 +203,8 @@ void EXRDeepImageWriter::writeScanline()
 	clearScanlineBuffer();
 }
 
-void EXRDeepImageWriter::doWritePixel( int x, int y, const DeepPixel *pixel )
+void EXRDeepImageWriter::advanceToScanline( int y )
 {
-	open();
-	
 	if ( y < m_currentSlice )
 	{
 		throw Exception( "Deep slices have to be written sequentially and the pixel to be written belongs to a slice that has already been written." );
@@ -224,6 +222,13 @@ void EXRDeepImageWriter::doWritePixel( int x, int y, const DeepPixel *pixel )
 	{
 		throw Exception( "Cannot write past the bounds of the deep image." );
 	}
+}
+
+void EXRDeepImageWriter::doWritePixel( int x, int y, const DeepPixel *pixel )
+{
+	open();
+
+	advanceToScanline( y );
 
 	// Write the number of samples.
 	const unsigned int numSamples = pixel->numSamples();
@@ -276,6 +281,78 @@ void EXRDeepImageWriter::doWritePixel( int x, int y, const DeepPixel *pixel )
 	}
 }
 
+void EXRDeepImageWriter::doWriteBlock( const DeepImageBlock *block )
+{
+	open();
+
+	const unsigned numChannels = numberOfChannels();
+	std::vector<const float *> channelPlanes( numChannels );
+	for ( unsigned i = 0; i < numChannels; ++i )
+	{
+		int index = block->channelIndex( channelName( i ) );
+		if ( index < 0 )
+		{
+			throw InvalidArgumentException( "DeepImageBlock does not have channel \"" + channelName( i ) + "\"." );
+		}
+		channelPlanes[i] = block->channelData( index );
+	}
+
+	const int minX = m_outputFile->header().dataWindow().min.x;
+	const Imath::Box2i &region = block->region();
+	const std::vector<unsigned> &offsets = block->sampleOffsets();
+	const float *depths = block->depths();
+
+	unsigned pixelIndex = 0;
+	for ( int y = region.min.y; y <= region.max.y; ++y )
+	{
+		bool advanced = false;
+		for ( int x = region.min.x; x <= region.max.x; ++x, ++pixelIndex )
+		{
+			const unsigned offset = offsets[pixelIndex];
+			const unsigned numSamples = offsets[pixelIndex+1] - offset;
+			if ( !numSamples )
+			{
+				continue;
+			}
+
+			if ( !advanced )
+			{
+				advanceToScanline( y );
+				advanced = true;
+			}
+
+			// Write the number of samples.
+			size_t xOffset = x - minX;
+			m_sampleCount[ xOffset ] = numSamples;
+
+			// Write the Z channel.
+			m_depthSamples[ xOffset ].assign( depths + offset, depths + offset + numSamples );
+			m_depthPointers[ xOffset ] = &m_depthSamples[ xOffset ][0];
+
+			// Write the auxiliary channels.
+			for ( unsigned i = 0, floatCount = 0, halfCount = 0; i < numChannels; ++i )
+			{
+				const float *src = channelPlanes[i] + offset;
+				int pointerIndex = m_width * i + xOffset;
+				if ( m_channelTypes[i] == Imf::FLOAT )
+				{
+					int index = m_width * floatCount + xOffset;
+					m_floatSamples[ index ].assign( src, src + numSamples );
+					m_samplePointers[ pointerIndex ] = &m_floatSamples[ index ][0];
+					++floatCount;
+				}
+				else
+				{
+					int index = m_width * halfCount + xOffset;
+					m_halfSamples[ index ].assign( src, src + numSamples );
+					m_samplePointers[ pointerIndex ] = &m_halfSamples[ index ][0];
+					++halfCount;
+				}
+			}
+		}
+	}
+}
+
 Imf::Compression EXRDeepImageWriter::compression() const
 {
 	return static_cast< Imf::Compression >( parameters()->parameter<IECore::IntParameter>("compression")->getNumericValue() );
@@ -57,6 +57,7 @@
 #include "OpenEXR/ImfMatrixAttribute.h"
 #include "OpenEXR/ImfStringAttribute.h"
 #include "OpenEXR/ImfTimeCodeAttribute.h"
+#include "OpenEXR/ImfThreading.h"
 
 #ifdef IECORE_WITH_DEEPEXR
 
@@ -81,13 +82,13 @@ const Reader::ReaderDescription<EXRImageReader> EXRImageReader::g_readerDescript
 
 EXRImageReader::EXRImageReader() :
 		ImageReader( "Reads ILM OpenEXR file format." ),
-		m_inputFile( 0 )
+		m_inputFile( 0 ), m_tiledInputFile( 0 )
 {
 }
 
 EXRImageReader::EXRImageReader(const string &fileName) :
 		ImageReader( "Reads ILM OpenEXR file format." ),
-		m_inputFile( 0 )
+		m_inputFile( 0 ), m_tiledInputFile( 0 )
 {
 	m_fileNameParameter->setTypedValue( fileName );
 }
@@ -95,6 +96,7 @@ EXRImageReader::EXRImageReader(const string &fileName) :
 EXRImageReader::~EXRImageReader()
 {
 	delete m_inputFile;
+	delete m_tiledInputFile;
 }
 
 bool EXRImageReader::canRead( const string &fileName )
@@ -176,134 +178,264 @@ std::string EXRImageReader::sourceColorSpace() const
 	return "linear";
 }
 
-template<class T>
-DataPtr EXRImageReader::readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow, const Imf::Channel *channel )
+Imath::Box2i EXRImageReader::alignedDataWindow( const Imath::Box2i &dataWindow )
 {
-	assert( channel );
-	Imath::V2i pixelDimensions = dataWindow.size() + Imath::V2i( 1 );
-	unsigned numPixels = pixelDimensions.x * pixelDimensions.y;
+	open( true );
+
+	const Header &header = m_inputFile->header();
+	const Box2i fileDataWindow = header.dataWindow();
+	if( !header.hasTileDescription() )
+	{
+		return Box2i(
+			Imath::V2i( fileDataWindow.min.x, dataWindow.min.y ),
+			Imath::V2i( fileDataWindow.max.x, dataWindow.max.y )
+		);
+	}
+
+	const TileDescription &tileDescription = header.tileDescription();
+	const Imath::V2i tileSize( tileDescription.xSize, tileDescription.ySize );
+	const Imath::V2i minTile = ( dataWindow.min - fileDataWindow.min ) / tileSize;
+	const Imath::V2i maxTile = ( dataWindow.max - fileDataWindow.min ) / tileSize;
+
+	Box2i result(
+		fileDataWindow.min + minTile * tileSize,
+		fileDataWindow.min + ( maxTile + Imath::V2i( 1 ) ) * tileSize - Imath::V2i( 1 )
+	);
+	return boxIntersection( result, fileDataWindow );
+}
 
-	typedef TypedData<vector<T> > DataType;
-	typename DataType::Ptr data = new DataType;
-	data->writable().resize( numPixels );
+/// Holds the result data for a channel being read, along with
+/// everything needed to insert it into an Imf::FrameBuffer.
+struct EXRImageReader::ChannelBuffer
+{
 
-	Imath::Box2i fullDataWindow = this->dataWindow();
-	if( fullDataWindow.min.x==dataWindow.min.x && fullDataWindow.max.x==dataWindow.max.x )
+	ChannelBuffer( const std::string &channelName, const Imf::Channel *channel, size_t numPixels )
+		:	name( channelName ), type( channel->type ), pixelSize( 0 ), pixels( 0 )
 	{
-		// the width we want to read matches the width in the file, so we can read straight
-		// into the result buffer
-		FrameBuffer frameBuffer;
-		T *buffer00 = data->baseWritable() - dataWindow.min.y * pixelDimensions.x - fullDataWindow.min.x;
-		Slice slice( channel->type, (char *)buffer00, sizeof(T), sizeof(T) * pixelDimensions.x );
-		frameBuffer.insert( name.c_str(), slice );
-		m_inputFile->setFrameBuffer( frameBuffer );
-		// exr library will choose the best order to read scanlines automatically (increasing or decreasing)
-		try
+		switch( type )
 		{
-			m_inputFile->readPixels( dataWindow.min.y, dataWindow.max.y );
+			case UINT :
+				BOOST_STATIC_ASSERT( sizeof( unsigned int ) == 4 );
+				data = createData<UIntVectorData>( numPixels );
+				break;
+			case HALF :
+				data = createData<HalfVectorData>( numPixels );
+				break;
+			case FLOAT :
+				BOOST_STATIC_ASSERT( sizeof( float ) == 4 );
+				data = createData<FloatVectorData>( numPixels );
+				break;
+			default :
+				throw IOException( ( boost::format( "EXRImageReader : Unsupported data type for channel \"%s\"" ) % name ).str() );
 		}
-		catch( Iex::InputExc &e )
+	}
+
+	/// Inserts a slice for a buffer holding the pixels in window.
+	void insert( FrameBuffer &frameBuffer, char *buffer, const Box2i &window ) const
+	{
+		const size_t width = window.size().x + 1;
+		char *buffer00 = buffer - ( window.min.y * width + window.min.x ) * pixelSize;
+		frameBuffer.insert( name.c_str(), Slice( type, buffer00, pixelSize, pixelSize * width ) );
+	}
+
+	/// Copies the rows from yBegin to yEnd inclusive from a buffer holding the pixels in
+	/// bufferWindow into our result data, which holds the pixels in dataWindow.
+	void copyRows( const char *buffer, const Box2i &bufferWindow, const Box2i &dataWindow, int yBegin, int yEnd )
+	{
+		const size_t bufferWidth = bufferWindow.size().x + 1;
+		const size_t dataWidth = dataWindow.size().x + 1;
+		for( int y = yBegin; y <= yEnd; ++y )
 		{
-			// so we can read incomplete files
-			msg( Msg::Warning, "EXRImageReader::readChannel", e.what() );
-			return data;
+			const char *src = buffer + ( ( y - bufferWindow.min.y ) * bufferWidth + dataWindow.min.x - bufferWindow.min.x ) * pixelSize;
+			char *dst = pixels + ( y - dataWindow.min.y ) * dataWidth * pixelSize;
+			memcpy( dst, src, dataWidth * pixelSize );
+		}
+	}
+
+	std::string name;
+	Imf::PixelType type;
+	size_t pixelSize;
+	DataPtr data;
+	char *pixels;
+
+	private :
+
+		template<typename T>
+		DataPtr createData( size_t numPixels )
+		{
+			typename T::Ptr result = new T;
+			result->writable().resize( numPixels );
+			pixelSize = sizeof( typename T::BaseType );
+			pixels = (char *)result->baseWritable();
+			return result;
+		}
+
+};
+
+// The number of scanlines decoded by each call to readPixels() when
+// reading a window narrower than the file. This gives the EXR library
+// enough work to spread across its threads while bounding the size of
+// the intermediate buffers.
+static const int g_scanlinesPerRead = 64;
+
+void EXRImageReader::readScanlines( const Imath::Box2i &dataWindow, std::vector<ChannelBuffer> &buffers )
+{
+	const Box2i fileDataWindow = m_inputFile->header().dataWindow();
+	if( fileDataWindow.min.x==dataWindow.min.x && fileDataWindow.max.x==dataWindow.max.x )
+	{
+		// the width we want to read matches the width in the file, so we can read straight
+		// into the result buffers
+		FrameBuffer frameBuffer;
+		for( vector<ChannelBuffer>::const_iterator it = buffers.begin(); it != buffers.end(); ++it )
+		{
+			it->insert( frameBuffer, it->pixels, dataWindow );
 		}
+		m_inputFile->setFrameBuffer( frameBuffer );
+		// exr library will choose the best order to read scanlines automatically (increasing or decreasing)
+		m_inputFile->readPixels( dataWindow.min.y, dataWindow.max.y );
+		return;
 	}
-	else
+
+	// widths don't match, we need to read bands of full scanlines into temporary buffers
+	// and then transfer just the bits we need into the result buffers.
+	const size_t fileWidth = fileDataWindow.size().x + 1;
+	vector<vector<char> > tmpBuffers( buffers.size() );
+	for( size_t i = 0; i < buffers.size(); ++i )
+	{
+		tmpBuffers[i].resize( fileWidth * g_scanlinesPerRead * buffers[i].pixelSize );
+	}
+
+	for( int yBegin = dataWindow.min.y; yBegin <= dataWindow.max.y; yBegin += g_scanlinesPerRead )
 	{
-		// widths don't match, we need to read into a temporary buffer and then transfer just
-		// the bits we need into the result buffer.
-		int numTmpPixels = fullDataWindow.size().x + 1;
-		vector<T> tmpBuffer( numTmpPixels );
-		T *tmpBufferTransferStart = &(tmpBuffer[0]) + dataWindow.min.x - fullDataWindow.min.x;
-		size_t tmpBufferTransferLength = pixelDimensions.x * sizeof( T );
-		T *transferDestination = &(data->writable()[0]);
+		const int yEnd = std::min( yBegin + g_scanlinesPerRead - 1, dataWindow.max.y );
+		const Box2i bandWindow( Imath::V2i( fileDataWindow.min.x, yBegin ), Imath::V2i( fileDataWindow.max.x, yEnd ) );
 
-		// slice has yStride of 0 so each successive scanline just overwrites the previous one
-		Slice slice( channel->type, (char *)(&(tmpBuffer[0]) - fullDataWindow.min.x), sizeof(T), 0 );
 		FrameBuffer frameBuffer;
-		frameBuffer.insert( name.c_str(), slice );
+		for( size_t i = 0; i < buffers.size(); ++i )
+		{
+			buffers[i].insert( frameBuffer, &(tmpBuffers[i][0]), bandWindow );
+		}
 		m_inputFile->setFrameBuffer( frameBuffer );
+		m_inputFile->readPixels( yBegin, yEnd );
 
-		int yStart = dataWindow.min.y;
-		int yEnd = dataWindow.max.y;
-		int yStep = 1;
-		try
+		for( size_t i = 0; i < buffers.size(); ++i )
 		{
-			for( int y=yStart; y!=(yEnd+yStep); y+=yStep )
-			{
-				m_inputFile->readPixels( y );
-				memcpy( (char *)transferDestination, (const char *)tmpBufferTransferStart, tmpBufferTransferLength );
-				transferDestination += pixelDimensions.x;
-			}
+			buffers[i].copyRows( &(tmpBuffers[i][0]), bandWindow, dataWindow, yBegin, yEnd );
 		}
-		catch( Iex::InputExc &e )
+	}
+}
+
+void EXRImageReader::readTiles( const Imath::Box2i &dataWindow, std::vector<ChannelBuffer> &buffers )
+{
+	if( !m_tiledInputFile )
+	{
+		m_tiledInputFile = new Imf::TiledInputFile( fileName().c_str(), globalThreadCount() );
+	}
+
+	const Box2i fileDataWindow = m_tiledInputFile->header().dataWindow();
+	const TileDescription &tileDescription = m_tiledInputFile->header().tileDescription();
+	const Imath::V2i minTile = ( dataWindow.min - fileDataWindow.min ) / Imath::V2i( tileDescription.xSize, tileDescription.ySize );
+	const Imath::V2i maxTile = ( dataWindow.max - fileDataWindow.min ) / Imath::V2i( tileDescription.xSize, tileDescription.ySize );
+
+	const Box2i tileWindow = alignedDataWindow( dataWindow );
+	if( tileWindow == dataWindow )
+	{
+		// the window lies on tile boundaries, so we can read straight into the result buffers
+		FrameBuffer frameBuffer;
+		for( vector<ChannelBuffer>::const_iterator it = buffers.begin(); it != buffers.end(); ++it )
 		{
-			// so we can read incomplete files
-			msg( Msg::Warning, "EXRImageReader::readChannel", e.what() );
-			return data;
+			it->insert( frameBuffer, it->pixels, dataWindow );
 		}
+		m_tiledInputFile->setFrameBuffer( frameBuffer );
+		m_tiledInputFile->readTiles( minTile.x, maxTile.x, minTile.y, maxTile.y );
+		return;
 	}
 
-#ifndef NDEBUG
-	for ( typename DataType::ValueType::const_iterator it = data->readable().begin(); it != data->readable().end(); ++it )
+	// read only the tiles touching the window into temporary buffers, and
+	// then transfer just the bits we need into the result buffers.
+	const size_t numTilePixels = ( tileWindow.size().x + 1 ) * ( tileWindow.size().y + 1 );
+	vector<vector<char> > tmpBuffers( buffers.size() );
+	FrameBuffer frameBuffer;
+	for( size_t i = 0; i < buffers.size(); ++i )
 	{
-		assert( *it == *it ); // Will fail iff NaN
+		tmpBuffers[i].resize( numTilePixels * buffers[i].pixelSize );
+		buffers[i].insert( frameBuffer, &(tmpBuffers[i][0]), tileWindow );
 	}
-#endif
+	m_tiledInputFile->setFrameBuffer( frameBuffer );
+	m_tiledInputFile->readTiles( minTile.x, maxTile.x, minTile.y, maxTile.y );
 
-	return data;
+	for( size_t i = 0; i < buffers.size(); ++i )
+	{
+		buffers[i].copyRows( &(tmpBuffers[i][0]), tileWindow, dataWindow, dataWindow.min.y, dataWindow.max.y );
+	}
 }
 
 DataPtr EXRImageReader::readChannel( const string &name, const Imath::Box2i &dataWindow, bool raw )
+{
+	vector<DataPtr> data;
+	readChannels( vector<string>( 1, name ), dataWindow, raw, data );
+	return data[0];
+}
+
+void EXRImageReader::readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data )
 {
 	open( true );
 
 	try
 	{
+		const Header &header = m_inputFile->header();
+		const Imath::V2i pixelDimensions = dataWindow.size() + Imath::V2i( 1 );
+		const size_t numPixels = pixelDimensions.x * pixelDimensions.y;
 
-		const Channel *channel = m_inputFile->header().channels().findChannel( name.c_str() );
-		assert( channel );
-		assert( channel->xSampling==1 ); /// \todo Support subsampling when we have a need for it
-		assert( channel->ySampling==1 );
-
-		DataPtr res;
-		switch( channel->type )
+		vector<ChannelBuffer> buffers;
+		buffers.reserve( names.size() );
+		for( vector<string>::const_iterator it = names.begin(); it != names.end(); ++it )
 		{
-			case UINT :
-				BOOST_STATIC_ASSERT( sizeof( unsigned int ) == 4 );
-				res = readTypedChannel<unsigned int>( name, dataWindow, channel );
-				if ( raw )
-				{
-					return res;
-				}
-				else
-				{
-					DataConvert< UIntVectorData, FloatVectorData, ScaledDataConversion< unsigned int, float > > converter;
-					ConstUIntVectorDataPtr vec = boost::static_pointer_cast< UIntVectorData >(res);
-					return converter( vec );
-				}
-
-			case HALF :
-				res = readTypedChannel<half>( name, dataWindow, channel );
-				if ( raw )
-				{
-					return res;
-				}
-				else
-				{
-					DataConvert< HalfVectorData, FloatVectorData, ScaledDataConversion< half, float > > converter;
-					ConstHalfVectorDataPtr vec = boost::static_pointer_cast< HalfVectorData >(res);
-					return converter( vec );
-				}
-
-			case FLOAT :
-				BOOST_STATIC_ASSERT( sizeof( float ) == 4 );
-				return readTypedChannel<float>( name, dataWindow, channel );
+			const Channel *channel = header.channels().findChannel( it->c_str() );
+			assert( channel );
+			assert( channel->xSampling==1 ); /// \todo Support subsampling when we have a need for it
+			assert( channel->ySampling==1 );
+			buffers.push_back( ChannelBuffer( *it, channel, numPixels ) );
+		}
 
-			default:
-				throw IOException( ( boost::format( "EXRImageReader : Unsupported data type for channel \"%s\"" ) % name ).str() );
+		try
+		{
+			if( header.hasTileDescription() )
+			{
+				readTiles( dataWindow, buffers );
+			}
+			else
+			{
+				readScanlines( dataWindow, buffers );
+			}
+		}
+		catch( Iex::InputExc &e )
+		{
+			// so we can read incomplete files
+			for( vector<ChannelBuffer>::const_iterator it = buffers.begin(); it != buffers.end(); ++it )
+			{
+				msg( Msg::Warning, "EXRImageReader::readChannel", e.what() );
+			}
+		}
 
+		data.clear();
+		data.reserve( buffers.size() );
+		for( vector<ChannelBuffer>::const_iterator it = buffers.begin(); it != buffers.end(); ++it )
+		{
+			if( raw || it->type == FLOAT )
+			{
+				data.push_back( it->data );
+			}
+			else if( it->type == HALF )
+			{
+				DataConvert< HalfVectorData, FloatVectorData, ScaledDataConversion< half, float > > converter;
+				data.push_back( converter( boost::static_pointer_cast<const HalfVectorData>( it->data ) ) );
+			}
+			else
+			{
+				DataConvert< UIntVectorData, FloatVectorData, ScaledDataConversion< unsigned int, float > > converter;
+				data.push_back( converter( boost::static_pointer_cast<const UIntVectorData>( it->data ) ) );
+			}
 		}
 	}
 	catch ( Exception &e )
@@ -336,10 +468,12 @@ bool EXRImageReader::open( bool throwOnFailure )
 
 	delete m_inputFile;
 	m_inputFile = 0;
+	delete m_tiledInputFile;
+	m_tiledInputFile = 0;
 
 	try
 	{
-		m_inputFile = new Imf::InputFile( fileName().c_str() );
+		m_inputFile = new Imf::InputFile( fileName().c_str(), globalThreadCount() );
 	}
 	catch( ... )
 	{
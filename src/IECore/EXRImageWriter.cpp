@@ -53,7 +53,9 @@
 
 #include "boost/format.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <map>
 
 using namespace IECore;
 
@@ -318,3 +320,208 @@ void EXRImageWriter::writeTypedChannel(const char *name, const Box2i &dataWindow
 	char *offset = (char *) (&channel[0] - (dataWindow.min.x + width * dataWindow.min.y));
 	fb.insert(name, Slice(pixelType, offset, sizeof(T), sizeof(T) * width));
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Incremental writing
+//////////////////////////////////////////////////////////////////////////
+
+/// Writes scanlines to the file in order as soon as all their pixels have
+/// been received, holding only the incomplete scanlines in memory.
+class EXRImageWriter::ScanlineWriter : public RefCounted
+{
+
+	public :
+
+		ScanlineWriter( const std::string &fileName, const Header &header, const vector<string> &channelNames )
+			:	m_file( fileName.c_str(), header ), m_dataWindow( header.dataWindow() ), m_channelNames( channelNames )
+		{
+		}
+
+		void writeBlock( const Box2i &box, const float *data )
+		{
+			const size_t numChannels = m_channelNames.size();
+			const size_t width = m_dataWindow.size().x + 1;
+			const size_t boxWidth = box.size().x + 1;
+			const size_t offset = ( box.min.x - m_dataWindow.min.x ) * numChannels;
+
+			for( int y = box.min.y; y <= box.max.y; ++y, data += boxWidth * numChannels )
+			{
+				Scanline &scanline = m_scanlines[y];
+				if( scanline.pixels.empty() )
+				{
+					scanline.pixels.resize( width * numChannels, 0.0f );
+					scanline.remaining = width;
+				}
+				std::copy( data, data + boxWidth * numChannels, scanline.pixels.begin() + offset );
+				scanline.remaining -= std::min( scanline.remaining, boxWidth );
+			}
+
+			writeScanlines( false );
+		}
+
+		/// Writes all remaining scanlines, returning false if
+		/// any of them were incomplete.
+		bool close()
+		{
+			return writeScanlines( true );
+		}
+
+	private :
+
+		struct Scanline
+		{
+			Scanline() : remaining( 0 ) {}
+			vector<float> pixels;
+			size_t remaining;
+		};
+
+		typedef std::map<int, Scanline> ScanlineMap;
+
+		// Writes scanlines for as long as the next one is complete, or until the
+		// end of the image if all is true. Returns false if any incomplete scanlines
+		// were written.
+		bool writeScanlines( bool all )
+		{
+			bool complete = true;
+			while( m_file.currentScanLine() <= m_dataWindow.max.y )
+			{
+				const int y = m_file.currentScanLine();
+				ScanlineMap::iterator it = m_scanlines.find( y );
+				if( !all && ( it == m_scanlines.end() || it->second.remaining ) )
+				{
+					break;
+				}
+
+				const float *pixels = 0;
+				if( it != m_scanlines.end() )
+				{
+					pixels = &(it->second.pixels[0]);
+					complete = complete && !it->second.remaining;
+				}
+				else
+				{
+					m_zeroes.resize( ( m_dataWindow.size().x + 1 ) * m_channelNames.size(), 0.0f );
+					pixels = &(m_zeroes[0]);
+					complete = false;
+				}
+
+				// slices have a yStride of 0, so that the scanline
+				// buffer is used for whichever line is being written.
+				FrameBuffer frameBuffer;
+				const size_t numChannels = m_channelNames.size();
+				for( size_t c = 0; c < numChannels; ++c )
+				{
+					char *base = (char *)( pixels + c - m_dataWindow.min.x * numChannels );
+					frameBuffer.insert( m_channelNames[c].c_str(), Slice( FLOAT, base, sizeof( float ) * numChannels, 0 ) );
+				}
+				m_file.setFrameBuffer( frameBuffer );
+				m_file.writePixels( 1 );
+
+				if( it != m_scanlines.end() )
+				{
+					m_scanlines.erase( it );
+				}
+			}
+			return complete;
+		}
+
+		OutputFile m_file;
+		Box2i m_dataWindow;
+		vector<string> m_channelNames;
+		ScanlineMap m_scanlines;
+		vector<float> m_zeroes;
+
+};
+
+EXRImageWriter::~EXRImageWriter()
+{
+}
+
+void EXRImageWriter::doBeginImage( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const std::vector<std::string> &channelNames, const CompoundData *blindData )
+{
+	std::string colorspace = colorspaceParameter()->getTypedValue();
+	if( colorspace == "autoDetect" )
+	{
+		colorspace = destinationColorSpace();
+	}
+
+	if( colorspace != "linear" && !rawChannelsParameter()->getTypedValue() )
+	{
+		ImageWriter::doBeginImage( displayWindow, dataWindow, channelNames, blindData );
+		return;
+	}
+
+	try
+	{
+		Header header( 1 + boxSize( dataWindow ).x, 1 + boxSize( dataWindow ).y, 1, Imath::V2f( 0.0, 0.0 ), 1, INCREASING_Y,
+			static_cast<Compression>( compressionParameter()->getNumericValue() ) );
+		if( blindData )
+		{
+			blindDataToHeader( blindData, header );
+		}
+		header.dataWindow() = dataWindow;
+		header.displayWindow() = displayWindow;
+
+		for( vector<string>::const_iterator it = channelNames.begin(); it != channelNames.end(); ++it )
+		{
+			header.channels().insert( it->c_str(), Channel( FLOAT ) );
+		}
+
+		m_scanlineWriter = new ScanlineWriter( fileName(), header, channelNames );
+	}
+	catch ( Exception &e )
+	{
+		throw;
+	}
+	catch ( std::exception &e )
+	{
+		throw IOException( ( boost::format("EXRImageWriter: %s") % e.what() ).str() );
+	}
+	catch ( ... )
+	{
+		throw IOException( "EXRImageWriter: Unexpected error" );
+	}
+}
+
+void EXRImageWriter::doWriteBlock( const Imath::Box2i &box, const float *data )
+{
+	if( !m_scanlineWriter )
+	{
+		ImageWriter::doWriteBlock( box, data );
+		return;
+	}
+
+	try
+	{
+		m_scanlineWriter->writeBlock( box, data );
+	}
+	catch ( std::exception &e )
+	{
+		m_scanlineWriter = 0;
+		throw IOException( ( boost::format("EXRImageWriter: %s") % e.what() ).str() );
+	}
+}
+
+void EXRImageWriter::doEndImage()
+{
+	if( !m_scanlineWriter )
+	{
+		ImageWriter::doEndImage();
+		return;
+	}
+
+	ScanlineWriterPtr scanlineWriter = m_scanlineWriter;
+	m_scanlineWriter = 0;
+
+	try
+	{
+		if( !scanlineWriter->close() )
+		{
+			msg( Msg::Warning, "EXRImageWriter::endImage", "Image incomplete - missing pixels have been written as black." );
+		}
+	}
+	catch ( std::exception &e )
+	{
+		throw IOException( ( boost::format("EXRImageWriter: %s") % e.what() ).str() );
+	}
+}
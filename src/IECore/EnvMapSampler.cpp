@@ -32,6 +32,9 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/EnvMapSampler.h"
 #include "IECore/NullObject.h"
 #include "IECore/CompoundObject.h"
@@ -41,6 +44,7 @@
 #include "IECore/LuminanceOp.h"
 #include "IECore/AngleConversion.h"
 #include "IECore/Math.h"
+#include "IECore/LRUCache.h"
 
 using namespace IECore;
 using namespace boost;
@@ -49,6 +53,105 @@ using namespace std;
 
 IE_CORE_DEFINERUNTIMETYPED( EnvMapSampler );
 
+namespace
+{
+
+// Computes the colour and direction of a range of the lights.
+class LightSampler
+{
+
+	public :
+
+		LightSampler(
+			const Box2i &dataWindow, const vector<float> &red, const vector<float> &green, const vector<float> &blue,
+			const vector<V2f> &centroids, const vector<Box2i> &areas,
+			vector<V3f> &directions, vector<Color3f> &colors
+		)
+			:	m_dataWindow( dataWindow ), m_red( red ), m_green( green ), m_blue( blue ),
+				m_centroids( centroids ), m_areas( areas ), m_directions( directions ), m_colors( colors )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			const Box2i &dataWindow = m_dataWindow;
+			float radiansPerPixel = M_PI / (dataWindow.size().y + 1);
+			float angleAtTop = ( M_PI - radiansPerPixel ) / 2.0f;
+
+			for( size_t i=range.begin(); i!=range.end(); i++ )
+			{
+				const Box2i &area = m_areas[i];
+				Color3f color( 0 );
+				const int width = area.max.x - area.min.x + 1;
+				for( int y=area.min.y; y<=area.max.y && width > 0; y++ )
+				{
+					int yRel = y - dataWindow.min.y;
+
+					float angle = angleAtTop - yRel * radiansPerPixel;
+					float weight = cosf( angle );
+					int index = (area.min.x - dataWindow.min.x) + (dataWindow.size().x + 1 ) * yRel;
+
+					// sum each row before weighting it, so the inner loop is a simple
+					// reduction over contiguous pixels.
+					const float *r = &(m_red[index]);
+					const float *g = &(m_green[index]);
+					const float *b = &(m_blue[index]);
+					Color3f rowColor( 0 );
+					for( int x=0; x<width; x++ )
+					{
+						rowColor[0] += r[x];
+						rowColor[1] += g[x];
+						rowColor[2] += b[x];
+					}
+					color += rowColor * weight;
+				}
+				color /= m_red.size();
+				m_colors[i] = color;
+
+				float phi = angleAtTop - (m_centroids[i].y - dataWindow.min.y) * radiansPerPixel;
+
+				V3f direction;
+				direction.y = sinf( phi );
+				float r = cosf( phi );
+				float theta = 2 * M_PI * lerpfactor( (float)m_centroids[i].x, (float)dataWindow.min.x, (float)dataWindow.max.x );
+				direction.x = r * cosf( theta );
+				direction.z = r * sinf( theta );
+
+				m_directions[i] = -direction; // negated so we output the direction the light shines in
+			}
+		}
+
+	private :
+
+		const Box2i &m_dataWindow;
+		const vector<float> &m_red;
+		const vector<float> &m_green;
+		const vector<float> &m_blue;
+		const vector<V2f> &m_centroids;
+		const vector<Box2i> &m_areas;
+		vector<V3f> &m_directions;
+		vector<Color3f> &m_colors;
+
+};
+
+// Results are cached by the hash of the inputs, so that repeated sampling of
+// the same environment is free.
+typedef LRUCache<MurmurHash, ConstCompoundObjectPtr> ResultCache;
+
+ConstCompoundObjectPtr nullResult( const MurmurHash &hash, size_t &cost )
+{
+	cost = 0;
+	return 0;
+}
+
+ResultCache &resultCache()
+{
+	static ResultCache c( nullResult, 100 );
+	return c;
+}
+
+} // namespace
+
 EnvMapSampler::EnvMapSampler()
 	:
 	Op(
@@ -120,6 +223,20 @@ ObjectPtr EnvMapSampler::doOperation( const CompoundObject * operands )
 	const vector<float> &green = greenData->readable();
 	const vector<float> &blue = blueData->readable();
 
+	MurmurHash hash;
+	redData->hash( hash );
+	greenData->hash( hash );
+	blueData->hash( hash );
+	hash.append( dataWindow );
+	hash.append( subdivisionDepthParameter()->getNumericValue() );
+	if( resultCache().cached( hash ) )
+	{
+		if( ConstCompoundObjectPtr cachedResult = resultCache().get( hash ) )
+		{
+			return cachedResult->copy();
+		}
+	}
+
 	// get a luminance channel
 	LuminanceOpPtr luminanceOp = new LuminanceOp();
 	luminanceOp->inputParameter()->setValue( image );
@@ -141,47 +258,18 @@ ObjectPtr EnvMapSampler::doOperation( const CompoundObject * operands )
 	vector<V3f> &directions = directionsData->writable();
 	vector<Color3f> &colors = colorsData->writable();
 
-	float radiansPerPixel = M_PI / (dataWindow.size().y + 1);
-	float angleAtTop = ( M_PI - radiansPerPixel ) / 2.0f;
-
-	for( unsigned i=0; i<centroids.size(); i++ )
-	{
-		const Box2i &area = areas[i];
-		Color3f color( 0 );
-		for( int y=area.min.y; y<=area.max.y; y++ )
-		{
-			int yRel = y - dataWindow.min.y;
-
-			float angle = angleAtTop - yRel * radiansPerPixel;
-			float weight = cosf( angle );
-			int index = (area.min.x - dataWindow.min.x) + (dataWindow.size().x + 1 ) * yRel;
-			for( int x=area.min.x; x<=area.max.x; x++ )
-			{
-				color[0] += weight * red[index];
-				color[1] += weight * green[index];
-				color[2] += weight * blue[index];
-				index++;
-			}
-		}
-		color /= red.size();
-		colors.push_back( color );
-
-		float phi = angleAtTop - (centroids[i].y - dataWindow.min.y) * radiansPerPixel;
-
-		V3f direction;
-		direction.y = sinf( phi );
-		float r = cosf( phi );
-		float theta = 2 * M_PI * lerpfactor( (float)centroids[i].x, (float)dataWindow.min.x, (float)dataWindow.max.x );
-		direction.x = r * cosf( theta );
-		direction.z = r * sinf( theta );
-
-		directions.push_back( -direction ); // negated so we output the direction the light shines in
-	}
+	directions.resize( centroids.size() );
+	colors.resize( centroids.size() );
+	LightSampler lightSampler( dataWindow, red, green, blue, centroids, areas, directions, colors );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, centroids.size() ), lightSampler );
 
 	// return the result
 	CompoundObjectPtr result = new CompoundObject;
 	result->members()["directions"] = directionsData;
 	result->members()["colors"] = colorsData;
+
+	resultCache().set( hash, result->copy(), 1 );
+
 	return result;
 }
 
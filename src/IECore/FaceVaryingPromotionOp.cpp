@@ -252,7 +252,15 @@ void FaceVaryingPromotionOp::modifyTypedPrimitive( MeshPrimitive *mesh, const Co
 		}
 		
 		promoter.setInterpolation( it->second.interpolation );
-		it->second.data = despatchTypedData<Promoter, TypeTraits::IsVectorTypedData>( it->second.data.get(), promoter );
+		if( it->second.indices )
+		{
+			// promoting the indices is sufficient, and keeps the values shared
+			it->second.indices = boost::static_pointer_cast<IntVectorData>( promoter( it->second.indices.get() ) );
+		}
+		else
+		{
+			it->second.data = despatchTypedData<Promoter, TypeTraits::IsVectorTypedData>( it->second.data.get(), promoter );
+		}
 		it->second.interpolation = PrimitiveVariable::FaceVarying;
 		
 		assert( mesh->isPrimitiveVariableValid( it->second ) );
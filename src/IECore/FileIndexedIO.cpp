@@ -32,7 +32,13 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
 #include "boost/filesystem/operations.hpp"
+#include "boost/iostreams/device/mapped_file.hpp"
 
 #include "IECore/MessageHandler.h"
 #include "IECore/FileIndexedIO.h"
@@ -58,6 +64,11 @@ class FileIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 
 		size_t m_endPosition;
 
+		boost::iostreams::mapped_file_source m_mappedFile;
+
+		// file descriptor used for positional reads in read-only mode, or -1.
+		int m_fd;
+
 		StreamFile( const std::string &filename, IndexedIO::OpenMode mode );
 
 		virtual ~StreamFile();
@@ -66,9 +77,11 @@ class FileIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 
 		void flush( size_t endPosition );
 
+		virtual void readAt( char *buffer, size_t size, Imf::Int64 pos );
+
 };
 
-FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_filename( filename ), m_endPosition(0)
+FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_filename( filename ), m_endPosition(0), m_fd(-1)
 {
 	if (mode & IndexedIO::Write)
 	{
@@ -143,6 +156,24 @@ FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::O
 			throw IOException( "FileIndexedIO: Caught error reading file '" + filename + "'" );
 		}
 
+		if ( mode & IndexedIO::MemoryMapped )
+		{
+			try
+			{
+				m_mappedFile.open( filename );
+			}
+			catch ( std::exception &e )
+			{
+				throw IOException( "FileIndexedIO: Cannot map file '" + filename + "' into memory : " + e.what() );
+			}
+			setMappedData( m_mappedFile.data(), m_mappedFile.size() );
+		}
+		else
+		{
+			// a separate descriptor allows reads from different threads using
+			// pread(), without sharing the file position of the stream.
+			m_fd = ::open( filename.c_str(), O_RDONLY );
+		}
 	}
 }
 
@@ -151,8 +182,42 @@ void FileIndexedIO::StreamFile::flush( size_t endPosition )
 	m_endPosition = endPosition;
 }
 
+void FileIndexedIO::StreamFile::readAt( char *buffer, size_t size, Imf::Int64 pos )
+{
+	if ( m_fd < 0 )
+	{
+		StreamIndexedIO::StreamFile::readAt( buffer, size, pos );
+		return;
+	}
+
+	while ( size )
+	{
+		ssize_t n = ::pread( m_fd, buffer, size, pos );
+		if ( n < 0 )
+		{
+			if ( errno == EINTR )
+			{
+				continue;
+			}
+			throw IOException( "FileIndexedIO: Error reading file '" + m_filename + "' : " + strerror( errno ) );
+		}
+		else if ( n == 0 )
+		{
+			throw IOException( "FileIndexedIO: Unexpected end of file '" + m_filename + "'" );
+		}
+		buffer += n;
+		size -= n;
+		pos += n;
+	}
+}
+
 FileIndexedIO::StreamFile::~StreamFile()
 {
+	if ( m_fd >= 0 )
+	{
+		::close( m_fd );
+	}
+
 	if ( m_openmode == IndexedIO::Write || m_openmode == IndexedIO::Append )
 	{
 		std::fstream *f = static_cast< std::fstream * >( m_stream );
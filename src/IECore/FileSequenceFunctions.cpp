@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <ctime>
 #include <math.h>
 
 #include "boost/version.hpp"
@@ -44,6 +45,10 @@
 #include "boost/filesystem/path.hpp"
 #include "boost/filesystem/convenience.hpp"
 #include "boost/algorithm/string.hpp"
+#include "boost/shared_ptr.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
 
 #include "IECore/Exception.h"
 #include "IECore/FileSequence.h"
@@ -52,6 +57,7 @@
 #include "IECore/EmptyFrameList.h"
 #include "IECore/FrameRange.h"
 #include "IECore/ReversedFrameList.h"
+#include "IECore/LRUCache.h"
 
 #if BOOST_VERSION < 103400
 
@@ -81,102 +87,231 @@
 
 using namespace IECore;
 
-void IECore::findSequences( const std::vector< std::string > &names, std::vector< FileSequencePtr > &sequences, size_t minSequenceSize )
+namespace
 {
-	sequences.clear();
-
-	/// this matches names of the form $prefix$frameNumber$suffix
-	/// placing each of those in a group of the resulting match.
-	/// both $prefix and $suffix may be the empty string and $frameNumber
-	/// may be preceded by a minus sign.
-	/// It also matches file extensions with 3 or 4 characters that contain numbers (for example: CR2, MP3 )
-	boost::regex matchExpression( std::string( "^([^#]*?)(-?[0-9]+)([^0-9#]*|[^0-9#]*\\.[a-zA-Z]{2,3}[0-9])$" ) );
 
-	/// build a mapping from ($prefix, $suffix) to a list of $frameNumbers
-	typedef std::vector< std::string > Frames;
-	typedef std::map< std::pair< std::string, std::string >, Frames > SequenceMap;
+inline bool isDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
 
-	SequenceMap sequenceMap;
+inline bool isAlpha( char c )
+{
+	return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' );
+}
 
-	for ( std::vector< std::string >::const_iterator it = names.begin(); it != names.end(); ++it )
+/// Splits names of the form $prefix$frameNumber$suffix, returning false if name
+/// doesn't have that form. This is equivalent to matching the regular expression
+///
+/// ^([^#]*?)(-?[0-9]+)([^0-9#]*|[^0-9#]*\.[a-zA-Z]{2,3}[0-9])$
+///
+/// but many times faster, which matters for directories with hundreds of thousands
+/// of files. Both $prefix and $suffix may be empty and $frameNumber may be preceded
+/// by a minus sign. The frame number is the last run of digits in the name, unless
+/// the name ends with an extension of 2 or 3 letters followed by a digit (for
+/// example CR2 or MP3), in which case it is the last run of digits before that.
+bool splitFrameNumber( const std::string &name, std::string &prefix, std::string &frame, std::string &suffix )
+{
+	if( name.find( '#' ) != std::string::npos )
 	{
-		boost::smatch matches;
-		if ( boost::regex_match( *it, matches, matchExpression ) )
-		{
-			sequenceMap[
-				SequenceMap::key_type(
-					std::string( matches[1].first, matches[1].second ),
-					std::string( matches[3].first, matches[3].second )
-				)
-			].push_back( std::string( matches[2].first, matches[2].second ) );
-		}
+		return false;
 	}
 
-	for ( SequenceMap::const_iterator it = sequenceMap.begin(); it != sequenceMap.end(); ++it )
+	const size_t size = name.size();
+	size_t frameEnd = std::string::npos;
+
+	// look for an extension containing a number
+	if( size >= 4 && isDigit( name[size-1] ) )
 	{
-		const SequenceMap::key_type &fixes = it->first;
-		const Frames &frames = it->second;
-		// todo: could be more efficient by writing a custom comparison function that uses indexes
-		//	 into the const Frames vector rather than duplicating the strings and sorting them directly
-		Frames sortedFrames = frames;
-		std::sort( sortedFrames.begin(), sortedFrames.end() );
-
-		/// in diabolical cases the elements of frames may not all have the same padding
-		/// so we'll sort them out into padded and unpadded frame sequences here, by creating
-		/// a map of padding->list of frames. unpadded things will be considered to have a padding
-		/// of 1.
-		typedef std::vector< FrameList::Frame > NumericFrames;
-		typedef std::map< unsigned int, NumericFrames > PaddingToFramesMap;
-		PaddingToFramesMap paddingToFrames;
-		for ( Frames::const_iterator fIt = sortedFrames.begin(); fIt != sortedFrames.end(); ++fIt )
+		for( size_t numLetters = 2; numLetters <= 3 && frameEnd == std::string::npos; ++numLetters )
 		{
-			std::string frame = *fIt;
-			int sign = 1;
-
-			assert( frame.size() );
-			if ( *frame.begin() == '-' )
+			if( size < numLetters + 2 || name[size-2-numLetters] != '.' )
 			{
-				frame = frame.substr( 1, frame.size() - 1 );
-				sign = -1;
+				continue;
 			}
-			if ( *frame.begin() == '0' || paddingToFrames.find( frame.size() ) != paddingToFrames.end() )
+			bool letters = true;
+			for( size_t i = size - 1 - numLetters; i < size - 1; ++i )
 			{
-				paddingToFrames[ frame.size() ].push_back( sign * boost::lexical_cast<FrameList::Frame>( frame ) );
+				letters = letters && isAlpha( name[i] );
 			}
-			else
+			if( !letters )
+			{
+				continue;
+			}
+			const size_t dot = size - 2 - numLetters;
+			for( size_t i = dot; i > 0; --i )
+			{
+				if( isDigit( name[i-1] ) )
+				{
+					frameEnd = i;
+					break;
+				}
+			}
+		}
+	}
+
+	// otherwise use the last number in the name
+	if( frameEnd == std::string::npos )
+	{
+		for( size_t i = size; i > 0; --i )
+		{
+			if( isDigit( name[i-1] ) )
 			{
-				paddingToFrames[ 1 ].push_back( sign * boost::lexical_cast<FrameList::Frame>( frame ) );
+				frameEnd = i;
+				break;
 			}
 		}
+		if( frameEnd == std::string::npos )
+		{
+			return false;
+		}
+	}
 
-		for ( PaddingToFramesMap::iterator pIt = paddingToFrames.begin(); pIt != paddingToFrames.end(); ++pIt )
+	size_t frameStart = frameEnd - 1;
+	while( frameStart > 0 && isDigit( name[frameStart-1] ) )
+	{
+		--frameStart;
+	}
+	if( frameStart > 0 && name[frameStart-1] == '-' )
+	{
+		--frameStart;
+	}
+
+	prefix = name.substr( 0, frameStart );
+	frame = name.substr( frameStart, frameEnd - frameStart );
+	suffix = name.substr( frameEnd );
+	return true;
+}
+
+/// build a mapping from ($prefix, $suffix) to a list of $frameNumbers
+typedef std::vector< std::string > Frames;
+typedef std::map< std::pair< std::string, std::string >, Frames > SequenceMap;
+
+/// Builds the sequences for a single ($prefix, $suffix) pair.
+void buildSequences( const SequenceMap::key_type &fixes, const Frames &frames, size_t minSequenceSize, std::vector< FileSequencePtr > &sequences )
+{
+	// todo: could be more efficient by writing a custom comparison function that uses indexes
+	//	 into the const Frames vector rather than duplicating the strings and sorting them directly
+	Frames sortedFrames = frames;
+	std::sort( sortedFrames.begin(), sortedFrames.end() );
+
+	/// in diabolical cases the elements of frames may not all have the same padding
+	/// so we'll sort them out into padded and unpadded frame sequences here, by creating
+	/// a map of padding->list of frames. unpadded things will be considered to have a padding
+	/// of 1.
+	typedef std::vector< FrameList::Frame > NumericFrames;
+	typedef std::map< unsigned int, NumericFrames > PaddingToFramesMap;
+	PaddingToFramesMap paddingToFrames;
+	for ( Frames::const_iterator fIt = sortedFrames.begin(); fIt != sortedFrames.end(); ++fIt )
+	{
+		std::string frame = *fIt;
+		int sign = 1;
+
+		assert( frame.size() );
+		if ( *frame.begin() == '-' )
+		{
+			frame = frame.substr( 1, frame.size() - 1 );
+			sign = -1;
+		}
+		if ( *frame.begin() == '0' || paddingToFrames.find( frame.size() ) != paddingToFrames.end() )
+		{
+			paddingToFrames[ frame.size() ].push_back( sign * boost::lexical_cast<FrameList::Frame>( frame ) );
+		}
+		else
 		{
-			const PaddingToFramesMap::key_type &padding = pIt->first;
-			NumericFrames &numericFrames = pIt->second;
-			std::sort( numericFrames.begin(), numericFrames.end() );
+			paddingToFrames[ 1 ].push_back( sign * boost::lexical_cast<FrameList::Frame>( frame ) );
+		}
+	}
+
+	for ( PaddingToFramesMap::iterator pIt = paddingToFrames.begin(); pIt != paddingToFrames.end(); ++pIt )
+	{
+		const PaddingToFramesMap::key_type &padding = pIt->first;
+		NumericFrames &numericFrames = pIt->second;
+		std::sort( numericFrames.begin(), numericFrames.end() );
 
-			FrameListPtr frameList = frameListFromList( numericFrames );
+		FrameListPtr frameList = frameListFromList( numericFrames );
 
-			std::vector< FrameList::Frame > expandedFrameList;
-			frameList->asList( expandedFrameList );
+		std::vector< FrameList::Frame > expandedFrameList;
+		frameList->asList( expandedFrameList );
 
-			/// remove any sequences with less than the given minimum.
-			if ( expandedFrameList.size() >= minSequenceSize )
+		/// remove any sequences with less than the given minimum.
+		if ( expandedFrameList.size() >= minSequenceSize )
+		{
+			std::string frameTemplate;
+			for ( PaddingToFramesMap::key_type i = 0; i < padding; i++ )
 			{
-				std::string frameTemplate;
-				for ( PaddingToFramesMap::key_type i = 0; i < padding; i++ )
-				{
-					frameTemplate += "#";
-				}
+				frameTemplate += "#";
+			}
+
+			sequences.push_back(
+				new FileSequence(
+					fixes.first + frameTemplate + fixes.second,
+					frameList
+				)
+			);
+		}
+	}
+}
+
+class SequenceBuilder
+{
+
+	public :
 
-				sequences.push_back(
-					new FileSequence(
-						fixes.first + frameTemplate + fixes.second,
-						frameList
-					)
-				);
+		SequenceBuilder( const std::vector< SequenceMap::const_iterator > &groups, size_t minSequenceSize, std::vector< std::vector< FileSequencePtr > > &sequences )
+			:	m_groups( groups ), m_minSequenceSize( minSequenceSize ), m_sequences( sequences )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				buildSequences( m_groups[i]->first, m_groups[i]->second, m_minSequenceSize, m_sequences[i] );
 			}
 		}
+
+	private :
+
+		const std::vector< SequenceMap::const_iterator > &m_groups;
+		size_t m_minSequenceSize;
+		std::vector< std::vector< FileSequencePtr > > &m_sequences;
+
+};
+
+} // namespace
+
+void IECore::findSequences( const std::vector< std::string > &names, std::vector< FileSequencePtr > &sequences, size_t minSequenceSize )
+{
+	sequences.clear();
+
+	SequenceMap sequenceMap;
+
+	std::string prefix, frame, suffix;
+	for ( std::vector< std::string >::const_iterator it = names.begin(); it != names.end(); ++it )
+	{
+		if ( splitFrameNumber( *it, prefix, frame, suffix ) )
+		{
+			sequenceMap[SequenceMap::key_type( prefix, suffix )].push_back( frame );
+		}
+	}
+
+	/// build the sequences for each group in parallel, and then gather
+	/// the results in the order of the map.
+	std::vector< SequenceMap::const_iterator > groups;
+	groups.reserve( sequenceMap.size() );
+	for ( SequenceMap::const_iterator it = sequenceMap.begin(); it != sequenceMap.end(); ++it )
+	{
+		groups.push_back( it );
+	}
+
+	std::vector< std::vector< FileSequencePtr > > groupSequences( groups.size() );
+	SequenceBuilder builder( groups, minSequenceSize, groupSequences );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, groups.size() ), builder );
+
+	for ( std::vector< std::vector< FileSequencePtr > >::const_iterator it = groupSequences.begin(); it != groupSequences.end(); ++it )
+	{
+		sequences.insert( sequences.end(), it->begin(), it->end() );
 	}
 }
 
@@ -186,20 +321,82 @@ void IECore::findSequences( const std::vector< std::string > &names, std::vector
 	findSequences( names, sequences, 2 );
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Directory listing cache
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct DirectoryListing
+{
+	std::time_t modificationTime;
+	std::vector< std::string > fileNames;
+};
+
+typedef boost::shared_ptr<const DirectoryListing> ConstDirectoryListingPtr;
+
+ConstDirectoryListingPtr listDirectory( const std::string &path, size_t &cost )
+{
+	boost::shared_ptr<DirectoryListing> result( new DirectoryListing );
+	// get the time before listing, so that modifications made during
+	// the listing invalidate it.
+	result->modificationTime = boost::filesystem::last_write_time( path );
+
+	boost::filesystem::directory_iterator end;
+	for ( boost::filesystem::directory_iterator it( path ); it != end; ++it )
+	{
+		result->fileNames.push_back( it->path().PATH_TO_STRING );
+	}
+
+	cost = result->fileNames.size() + 1;
+	return result;
+}
+
+typedef LRUCache<std::string, ConstDirectoryListingPtr> DirectoryListingCache;
+
+DirectoryListingCache &directoryListingCache()
+{
+	// the cost is measured in files.
+	static DirectoryListingCache *c = new DirectoryListingCache( listDirectory, 1000000 );
+	return *c;
+}
+
+// Directory modification times only have a resolution of a second
+// on many filesystems, so changes made shortly after a listing might
+// not be detectable. We therefore only use cached listings for
+// directories which haven't been modified recently.
+const std::time_t g_minListingAge = 2;
+
+/// Returns the names of the files in the directory at path.
+ConstDirectoryListingPtr directoryListing( const std::string &path )
+{
+	const std::time_t modificationTime = boost::filesystem::last_write_time( path );
+	if( std::time( 0 ) - modificationTime < g_minListingAge )
+	{
+		size_t cost;
+		return listDirectory( path, cost );
+	}
+
+	DirectoryListingCache &cache = directoryListingCache();
+	ConstDirectoryListingPtr result = cache.get( path );
+	if( result->modificationTime != modificationTime )
+	{
+		cache.erase( path );
+		result = cache.get( path );
+	}
+	return result;
+}
+
+} // namespace
+
 void IECore::ls( const std::string &path, std::vector< FileSequencePtr > &sequences, size_t minSequenceSize )
 {
 	sequences.clear();
 
 	if ( boost::filesystem::is_directory( path ) )
 	{
-		boost::filesystem::directory_iterator end;
-	 	std::vector< std::string > files;
-		for ( boost::filesystem::directory_iterator it( path ); it != end; ++it )
-		{
-			files.push_back( it->path().PATH_TO_STRING );
-		}
-
-		findSequences( files, sequences, minSequenceSize );
+		findSequences( directoryListing( path )->fileNames, sequences, minSequenceSize );
 	}
 }
 
@@ -236,11 +433,10 @@ void IECore::ls( const std::string &sequencePath, FileSequencePtr &sequence, siz
 		dirToCheck = ".";
 	}
 
-	boost::filesystem::directory_iterator end;
-
-	for ( boost::filesystem::directory_iterator it( dirToCheck ); it != end; ++it )
+	ConstDirectoryListingPtr listing = directoryListing( dirToCheck.string() );
+	for ( std::vector< std::string >::const_iterator it = listing->fileNames.begin(); it != listing->fileNames.end(); ++it )
 	{
-		const std::string fileName = it->path().PATH_TO_STRING;
+		const std::string &fileName = *it;
 
 		if ( fileName.size() >= std::min( prefix.size(), suffix.size() ) && fileName.substr( 0, prefix.size() ) == prefix && fileName.substr( fileName.size() - suffix.size(), suffix.size() ) == suffix )
 		{
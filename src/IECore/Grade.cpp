@@ -32,6 +32,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "IECore/Grade.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/MessageHandler.h"
@@ -228,26 +230,62 @@ void Grade::begin( const CompoundObject * operands )
 
 	m_A = multiply * ( gain - lift ) / ( whitePoint - blackPoint );
 	m_B = offset + lift - m_A * blackPoint;
+
+	m_blackClamp = m_blackClampParameter->getTypedValue();
+	m_whiteClamp = m_whiteClampParameter->getTypedValue();
 }
 
 void Grade::transform( Imath::Color3f &color ) const
 {
-	Imath::V3d c = m_A * Imath::V3d(color) + m_B;
-	color.x = ( c.x >= 0.0 ? (float)pow( c.x, m_invGamma.x ) : c.x );
-	color.y = ( c.y >= 0.0 ? (float)pow( c.y, m_invGamma.y ) : c.y );
-	color.z = ( c.z >= 0.0 ? (float)pow( c.z, m_invGamma.z ) : c.z );
+	transformSpan( 1, &color.x, &color.y, &color.z );
+}
+
+namespace
+{
 
-	if ( m_blackClampParameter->getTypedValue() )
+// Grades a single channel. This is kept separate from the per element
+// logic for the other channels, so that the compiler can vectorise it.
+void gradeChannel( size_t n, float *c, double a, double b, double invGamma, bool blackClamp, bool whiteClamp )
+{
+	if( invGamma == 1.0 )
+	{
+		// pow( x, 1 ) is x, so the gamma can be skipped without changing the result.
+		for( size_t i = 0; i < n; ++i )
+		{
+			c[i] = a * c[i] + b;
+		}
+	}
+	else
 	{
-		if ( color.x < 0.0 ) color.x = 0.0;
-		if ( color.y < 0.0 ) color.y = 0.0;
-		if ( color.z < 0.0 ) color.z = 0.0;
+		for( size_t i = 0; i < n; ++i )
+		{
+			const double v = a * c[i] + b;
+			c[i] = v >= 0.0 ? pow( v, invGamma ) : v;
+		}
 	}
 
-	if ( m_whiteClampParameter->getTypedValue() )
+	if( blackClamp )
 	{
-		if ( color.x > 1.0 ) color.x = 1.0;
-		if ( color.y > 1.0 ) color.y = 1.0;
-		if ( color.z > 1.0 ) color.z = 1.0;
+		for( size_t i = 0; i < n; ++i )
+		{
+			c[i] = std::max( c[i], 0.0f );
+		}
 	}
+
+	if( whiteClamp )
+	{
+		for( size_t i = 0; i < n; ++i )
+		{
+			c[i] = std::min( c[i], 1.0f );
+		}
+	}
+}
+
+} // namespace
+
+void Grade::transformSpan( size_t n, float *r, float *g, float *b ) const
+{
+	gradeChannel( n, r, m_A.x, m_B.x, m_invGamma.x, m_blackClamp, m_whiteClamp );
+	gradeChannel( n, g, m_A.y, m_B.y, m_invGamma.y, m_blackClamp, m_whiteClamp );
+	gradeChannel( n, b, m_A.z, m_B.z, m_invGamma.z, m_blackClamp, m_whiteClamp );
 }
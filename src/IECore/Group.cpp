@@ -345,9 +345,11 @@ void Group::load( LoadContextPtr context )
 	ConstIndexedIOPtr childrenContainer = container->subdirectory( g_childrenEntry );
 	childrenContainer->entryIds( l );
 	sort( l.begin(), l.end(), entryListCompare );
-	for( IndexedIO::EntryIDList::const_iterator it=l.begin(); it!=l.end(); it++ )
+	std::vector<VisibleRenderablePtr> children;
+	context->load<VisibleRenderable>( childrenContainer.get(), l, children );
+	for( std::vector<VisibleRenderablePtr>::const_iterator it=children.begin(); it!=children.end(); it++ )
 	{
-		addChild( context->load<VisibleRenderable>( childrenContainer.get(), *it ) );
+		addChild( *it );
 	}
 }
 
@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/format.hpp"
+#include "boost/type_traits/is_same.hpp"
 
 #include "IECore/HdrMergeOp.h"
 #include "IECore/CompoundParameter.h"
@@ -41,6 +42,9 @@
 #include "IECore/Group.h"
 #include "IECore/ImagePrimitive.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include <cassert>
 
 using namespace IECore;
@@ -149,64 +153,120 @@ const Box2fParameter * HdrMergeOp::windowingParameter() const
 	return m_windowingParameter.get();
 }
 
-template< typename T >
-inline void merge( bool firstImage, size_t &pixelCount,
-					const ImagePrimitive * img, ImagePrimitive * outImg,
-					const Imath::Box2f &windowing, float intensityMultiplier,
-					FloatVectorData * outR, FloatVectorData * outG, FloatVectorData * outB, FloatVectorData * outA )
+namespace
 {
 
-	const TypedData< std::vector< T > > *inR = img->getChannel< T >( "R" );
-	const TypedData< std::vector< T > > *inG = img->getChannel< T >( "G" );
-	const TypedData< std::vector< T > > *inB = img->getChannel< T >( "B" );
-
-	if ( firstImage )
-	{
-		pixelCount = inR->readable().size();
-		outR->writable().resize( pixelCount, 0 );
-		outG->writable().resize( pixelCount, 0 );
-		outB->writable().resize( pixelCount, 0 );
-		outA->writable().resize( pixelCount, 0 );
-		outImg->setDisplayWindow( img->getDisplayWindow() );
-		outImg->setDataWindow( img->getDataWindow() );
-	}
-	else
-	{
-		if ( pixelCount != inR->readable().size() ||
-			 pixelCount != inG->readable().size() ||
-			 pixelCount != inB->readable().size() )
-		{
-			throw Exception( "Images are not of the same resolution!!" );
-		}
-	}
+// The RGB channels of one of the input images.
+struct Input
+{
+	const void *r;
+	const void *g;
+	const void *b;
+	bool isHalf;
+	float intensityMultiplier;
+};
 
-	const T *ptrInR = &(inR->readable()[0]);
-	const T *ptrInG = &(inG->readable()[0]);
-	const T *ptrInB = &(inB->readable()[0]);
-	float *ptrOutR = &(outR->writable()[0]);
-	float *ptrOutG = &(outG->writable()[0]);
-	float *ptrOutB = &(outB->writable()[0]);
-	float *ptrOutA = &(outA->writable()[0]);
+template< typename T >
+inline void merge( bool firstImage, size_t begin, size_t end, const Input &input, const Imath::Box2f &windowing,
+					float *ptrOutR, float *ptrOutG, float *ptrOutB, float *ptrOutA )
+{
+	const T *ptrInR = static_cast<const T *>( input.r );
+	const T *ptrInG = static_cast<const T *>( input.g );
+	const T *ptrInB = static_cast<const T *>( input.b );
+	const float intensityMultiplier = input.intensityMultiplier;
 
-	for ( size_t i = 0; i < pixelCount; i++ )
+	for ( size_t i = begin; i < end; i++ )
 	{
-		float intensity = (*ptrInR + *ptrInG + *ptrInB) / 3.0;
+		float intensity = (ptrInR[i] + ptrInG[i] + ptrInB[i]) / 3.0;
 		float weight = smoothstep( windowing.min[0], windowing.min[1], intensity );
 		if ( !firstImage )
 		{
 			weight *= 1.0f - smoothstep( windowing.max[0], windowing.max[1], intensity );
 		}
 		float m = weight * intensityMultiplier;
-		*ptrOutR += *ptrInR * m;
-		*ptrOutG += *ptrInG * m;
-		*ptrOutB += *ptrInB * m;
-		*ptrOutA += weight;
+		ptrOutR[i] += ptrInR[i] * m;
+		ptrOutG[i] += ptrInG[i] * m;
+		ptrOutB[i] += ptrInB[i] * m;
+		ptrOutA[i] += weight;
+	}
+}
+
+// Merges all the inputs for a range of pixels, and normalises the result.
+// Each range is processed completely before moving on to the next, so the
+// output stays in cache while the inputs are streamed through.
+class MergePixels
+{
+
+	public :
+
+		MergePixels( const std::vector<Input> &inputs, const Imath::Box2f &windowing, float adjustment, float *outR, float *outG, float *outB, float *outA )
+			:	m_inputs( inputs ), m_windowing( windowing ), m_adjustment( adjustment ), m_outR( outR ), m_outG( outG ), m_outB( outB ), m_outA( outA )
+		{
+		}
 
-		ptrInR++; ptrInG++; ptrInB++;
-		ptrOutR++; ptrOutG++; ptrOutB++; ptrOutA++;
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t k = 0; k < m_inputs.size(); ++k )
+			{
+				if( m_inputs[k].isHalf )
+				{
+					merge<half>( k == 0, range.begin(), range.end(), m_inputs[k], m_windowing, m_outR, m_outG, m_outB, m_outA );
+				}
+				else
+				{
+					merge<float>( k == 0, range.begin(), range.end(), m_inputs[k], m_windowing, m_outR, m_outG, m_outB, m_outA );
+				}
+			}
+
+			for ( size_t i = range.begin(); i < range.end(); i++ )
+			{
+				float w = m_adjustment * m_outA[i];
+				if ( w > 0 )
+				{
+					m_outR[i] /= w;
+					m_outG[i] /= w;
+					m_outB[i] /= w;
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<Input> &m_inputs;
+		Imath::Box2f m_windowing;
+		float m_adjustment;
+		float *m_outR;
+		float *m_outG;
+		float *m_outB;
+		float *m_outA;
+
+};
+
+template< typename T >
+Input inputChannels( const ImagePrimitive *img, float intensityMultiplier, size_t pixelCount )
+{
+	const TypedData< std::vector< T > > *inR = img->getChannel< T >( "R" );
+	const TypedData< std::vector< T > > *inG = img->getChannel< T >( "G" );
+	const TypedData< std::vector< T > > *inB = img->getChannel< T >( "B" );
+
+	if ( pixelCount != inR->readable().size() ||
+		 pixelCount != inG->readable().size() ||
+		 pixelCount != inB->readable().size() )
+	{
+		throw Exception( "Images are not of the same resolution!!" );
 	}
+
+	Input result;
+	result.r = pixelCount ? &(inR->readable()[0]) : 0;
+	result.g = pixelCount ? &(inG->readable()[0]) : 0;
+	result.b = pixelCount ? &(inB->readable()[0]) : 0;
+	result.isHalf = boost::is_same<T, half>::value;
+	result.intensityMultiplier = intensityMultiplier;
+	return result;
 }
 
+} // namespace
+
 ObjectPtr HdrMergeOp::doOperation( const CompoundObject * operands )
 {
 	Group *imageGroup = static_cast<Group *>( m_inputGroupParameter->getValue() );
@@ -252,44 +312,47 @@ ObjectPtr HdrMergeOp::doOperation( const CompoundObject * operands )
 	outImg->variables["B"] = PrimitiveVariable( PrimitiveVariable::Vertex, outB );
 	outImg->variables["A"] = PrimitiveVariable( PrimitiveVariable::Vertex, outA );
 
-	// loop over inputs accumulating them into the buffer
+	// gather the inputs, checking they all match the first one
 	int numInputs = images.size();
+	const ImagePrimitive *firstImg = static_cast<const ImagePrimitive *>( images.begin()->get() );
+	const size_t pixelCount = firstImg->getChannel< float >( "R" ) ? firstImg->getChannel< float >( "R" )->readable().size() : firstImg->getChannel< half >( "R" )->readable().size();
+	outImg->setDisplayWindow( firstImg->getDisplayWindow() );
+	outImg->setDataWindow( firstImg->getDataWindow() );
 
+	std::vector<Input> inputs;
+	inputs.reserve( numInputs );
 	float exposure = exposureStep * (numInputs-1)/2.0;
-	size_t pixelCount = 0;
-	bool firstImage = true;
-	for ( Group::ChildContainer::const_iterator it = images.begin(); it != images.end(); it++, firstImage = false )
+	for ( Group::ChildContainer::const_iterator it = images.begin(); it != images.end(); it++ )
 	{
 		const ImagePrimitive *img = static_cast<const ImagePrimitive *>( it->get() );
 		float intensityMultiplier = pow( 2.0f, exposure );
 		if ( img->getChannel< float >( "R" ) )
 		{
-			merge< float >( firstImage, pixelCount, img, outImg.get(), windowing, intensityMultiplier, outR.get(), outG.get(), outB.get(), outA.get() );
+			inputs.push_back( inputChannels< float >( img, intensityMultiplier, pixelCount ) );
 		}
 		else
 		{
-			merge< half >( firstImage, pixelCount, img, outImg.get(), windowing, intensityMultiplier, outR.get(), outG.get(), outB.get(), outA.get() );
+			inputs.push_back( inputChannels< half >( img, intensityMultiplier, pixelCount ) );
 		}
 		exposure -= exposureStep;
 	}
-	
-	// normalize the outputs
-	float adjustment = pow( 2.0f, -exposureAdjustment );
-	float *ptrOutR = &(outR->writable()[0]);
-	float *ptrOutG = &(outG->writable()[0]);
-	float *ptrOutB = &(outB->writable()[0]);
-	float *ptrOutA = &(outA->writable()[0]);
 
-	for ( size_t i = 0; i < pixelCount; i++ )
+	outR->writable().resize( pixelCount, 0 );
+	outG->writable().resize( pixelCount, 0 );
+	outB->writable().resize( pixelCount, 0 );
+	outA->writable().resize( pixelCount, 0 );
+
+	if ( !pixelCount )
 	{
-		float w = adjustment * ptrOutA[i];
-		if ( w > 0 )
-		{
-			ptrOutR[i] /= w;
-			ptrOutG[i] /= w;
-			ptrOutB[i] /= w;
-		}
+		return outImg;
 	}
 
+	// accumulate the inputs into the buffers and normalize the outputs
+	float adjustment = pow( 2.0f, -exposureAdjustment );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, pixelCount, 4096 ),
+		MergePixels( inputs, windowing, adjustment, &(outR->writable()[0]), &(outG->writable()[0]), &(outB->writable()[0]), &(outA->writable()[0]) )
+	);
+
 	return outImg;
 }
@@ -32,7 +32,10 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
-#include <fstream>
+#include <algorithm>
+
+#include "boost/format.hpp"
+#include "boost/iostreams/device/mapped_file.hpp"
 
 #include "IECore/Exception.h"
 #include "IECore/IFFFile.h"
@@ -41,65 +44,74 @@
 
 using namespace IECore;
 
-IFFFile::IFFFile( const std::string &fileName ) : m_iStream( 0 ), m_streamFileName( fileName ), m_root( 0 )
+IFFFile::IFFFile( const std::string &fileName ) : m_fileName( fileName ), m_mappedFile( 0 ), m_root( 0 )
 {
 }
 
 IFFFile::~IFFFile()
 {
-	delete m_iStream;
+	delete m_root;
+	delete m_mappedFile;
 }
 
 bool IFFFile::open()
 {
-	if( !m_iStream || !m_root )
+	tbb::mutex::scoped_lock lock( m_mutex );
+	if( !m_root )
 	{
-		delete m_iStream;
-		m_iStream = new std::ifstream( m_streamFileName.c_str() );
-		if( !m_iStream->is_open() || !m_iStream->good() )
+		delete m_mappedFile;
+		m_mappedFile = 0;
+		try
+		{
+			m_mappedFile = new boost::iostreams::mapped_file_source( m_fileName );
+		}
+		catch( ... )
 		{
 			return false;
 		}
-		
-		delete m_root;
-		std::streampos begin = m_iStream->tellg();
-		
-		char id[4];
-		m_iStream->read( id, 4 );
-		if( !m_iStream->good() )
+
+		if( m_mappedFile->size() < (size_t)IFFFile::Tag::TagSize )
 		{
 			return false;
 		}
 		
-		IFFFile::Tag testTag( id );
+		IFFFile::Tag testTag( m_mappedFile->data() );
 		if( !testTag.isGroup() )
 		{
 			return false;
 		}
 		
-		m_iStream->seekg( 0, std::ios_base::end );
-		std::streampos end = m_iStream->tellg();
-		m_root = new IFFFile::Chunk( "FOR4", end - begin, this, begin, 4 );
-		m_iStream->seekg( 0, std::ios_base::beg );
+		m_root = new IFFFile::Chunk( "FOR4", m_mappedFile->size(), this, 0, 4 );
+	}
+	return m_root != 0;
+}
+
+const char *IFFFile::data( size_t position, size_t size ) const
+{
+	if( !m_mappedFile || position + size > m_mappedFile->size() )
+	{
+		throw IOException( ( boost::format( "IFFFile : Unexpected end of file in \"%s\"." ) % m_fileName ).str() );
 	}
-	return m_iStream->good() && m_root;
+	return m_mappedFile->data() + position;
 }
 
 IFFFile::Chunk::Chunk()
 	: m_type(), m_dataSize( 0 ), m_file( 0 ), m_filePosition( 0 ), m_groupName(), m_alignmentQuota( 0 ), m_children()
 {
+	m_childrenListed = false;
 }
 
-IFFFile::Chunk::Chunk( std::string type, unsigned int dataSize, IFFFilePtr file, std::streampos filePosition, int alignmentQuota )
+IFFFile::Chunk::Chunk( std::string type, unsigned int dataSize, IFFFile *file, size_t filePosition, int alignmentQuota )
 	: m_type( type ), m_dataSize( dataSize ), m_file( file ), m_filePosition( filePosition ), m_groupName(), m_alignmentQuota( alignmentQuota ), m_children()
 {
+	m_childrenListed = false;
 }
 
 IFFFile::Chunk *IFFFile::root()
 {
 	if ( !open() )
 	{
-		throw Exception( ( boost::format( "Failed to load \"%s\"." ) % m_streamFileName ).str() );
+		throw Exception( ( boost::format( "Failed to load \"%s\"." ) % m_fileName ).str() );
 	}
 	
 	return m_root;
@@ -127,29 +139,33 @@ IFFFile::Tag IFFFile::Chunk::groupName()
 
 IFFFile::Chunk::ChunkIterator IFFFile::Chunk::childrenBegin()
 {
-	if ( isGroup() && !m_children.size() )
-	{
-		ls();
-	}
-	
+	ls();
 	return m_children.begin();
 }
 
 IFFFile::Chunk::ChunkIterator IFFFile::Chunk::childrenEnd()
 {
-	if ( isGroup() && !m_children.size() )
-	{
-		ls();
-	}
-	
+	ls();
 	return m_children.end();
 }
 
 void IFFFile::Chunk::ls()
 {
-	std::streampos currentPosition = m_filePosition;
+	if ( m_childrenListed || !isGroup() )
+	{
+		return;
+	}
+
+	tbb::mutex::scoped_lock lock( m_file->m_mutex );
+	if ( m_childrenListed )
+	{
+		return;
+	}
+
+	size_t currentPosition = m_filePosition;
+	const size_t end = m_filePosition + m_dataSize;
 	
-	while ( currentPosition < m_filePosition + (std::streampos)m_dataSize )
+	while ( currentPosition < end )
 	{
 		IFFFile::Chunk child( IFFFile::Tag().name(), 0, m_file, currentPosition, m_alignmentQuota );
 		
@@ -159,26 +175,27 @@ void IFFFile::Chunk::ls()
 		
 		currentPosition += child.dataSize() + child.skippableBytes();
 	}
+
+	m_childrenListed = true;
 }
 
-void IFFFile::Chunk::readHeader( std::streampos *pos )
+void IFFFile::Chunk::readHeader( size_t *pos )
 {
-	m_file->m_iStream->seekg( *pos, std::ios_base::beg );
-	
+	size_t position = *pos;
+
 	// read type
-	char tagBuffer[IFFFile::Tag::TagSize];
-	m_file->m_iStream->read( tagBuffer, IFFFile::Tag::TagSize );
-	m_type = IFFFile::Tag( tagBuffer );
+	m_type = IFFFile::Tag( m_file->data( position, IFFFile::Tag::TagSize ) );
+	position += IFFFile::Tag::TagSize;
 	
 	// read dataSize
-	m_file->m_iStream->read( (char *)&m_dataSize, sizeof(m_dataSize) );
-	m_dataSize = asBigEndian( m_dataSize );
+	IFFFile::readData( m_file->data( position, sizeof(m_dataSize) ), &m_dataSize, 1 );
+	position += sizeof(m_dataSize);
 	
 	if ( isGroup() )
 	{
 		// read groupName
-		m_file->m_iStream->read( tagBuffer, IFFFile::Tag::TagSize );
-		m_groupName = IFFFile::Tag( tagBuffer );
+		m_groupName = IFFFile::Tag( m_file->data( position, IFFFile::Tag::TagSize ) );
+		position += IFFFile::Tag::TagSize;
 		
 		// modify dataSize
 		m_dataSize -= IFFFile::Tag::TagSize;
@@ -188,19 +205,16 @@ void IFFFile::Chunk::readHeader( std::streampos *pos )
 	}
 	
 	// set the file position of the data
-	m_filePosition = m_file->m_iStream->tellg();
+	m_filePosition = position;
 	*pos = m_filePosition;
 }
 
 void IFFFile::Chunk::read( std::string &data )
 {
-	m_file->m_iStream->seekg( m_filePosition, std::ios_base::beg );
-	
-	char buffer[m_dataSize];
-	m_file->m_iStream->read( buffer, m_dataSize );
+	const char *buffer = m_file->data( m_filePosition, m_dataSize );
 	
-	data.clear();
-	data = buffer;
+	// the string is null terminated within the chunk
+	data.assign( buffer, std::find( buffer, buffer + m_dataSize, '\0' ) );
 }
 
 int IFFFile::Chunk::alignmentQuota()
@@ -0,0 +1,252 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "tbb/mutex.h"
+
+#include "boost/format.hpp"
+
+#include "IECore/ImageChannelLoader.h"
+#include "IECore/ComputationCache.h"
+#include "IECore/ImagePrimitive.h"
+#include "IECore/ColorSpaceTransformOp.h"
+#include "IECore/VectorTypedData.h"
+#include "IECore/BoxOps.h"
+
+using namespace IECore;
+using namespace Imath;
+using namespace boost;
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////
+// MemberData
+//////////////////////////////////////////////////////////////////////////
+
+struct ImageChannelLoader::MemberData
+{
+	public :
+
+		MemberData( ImageReaderPtr reader, ObjectPoolPtr objectPool )
+			:	m_reader( reader ), m_cache( computeFn, hashFn, 10000, objectPool )
+		{
+			m_fileName = reader->fileName();
+
+			m_displayWindow = reader->displayWindowParameter()->getTypedValue();
+			if( m_displayWindow.isEmpty() )
+			{
+				m_displayWindow = reader->displayWindow();
+			}
+
+			m_dataWindow = reader->dataWindowParameter()->getTypedValue();
+			if( m_dataWindow.isEmpty() )
+			{
+				m_dataWindow = reader->dataWindow();
+			}
+			else if( boxIntersection( m_dataWindow, reader->dataWindow() ) != m_dataWindow )
+			{
+				throw Exception( "Requested data window exceeds available data window." );
+			}
+
+			vector<string> allNames;
+			reader->channelNames( allNames );
+			const vector<string> &requestedNames = reader->channelNamesParameter()->getTypedValue();
+			if( requestedNames.empty() )
+			{
+				m_channelNames = allNames;
+			}
+			else
+			{
+				for( vector<string>::const_iterator it = requestedNames.begin(); it != requestedNames.end(); ++it )
+				{
+					if( find( allNames.begin(), allNames.end(), *it ) != allNames.end() )
+					{
+						m_channelNames.push_back( *it );
+					}
+				}
+			}
+			m_hasAlpha = find( allNames.begin(), allNames.end(), "A" ) != allNames.end();
+
+			m_raw = reader->rawChannelsParameter()->getTypedValue();
+			m_colorSpace = reader->colorspaceParameter()->getTypedValue();
+			if( m_colorSpace == "autoDetect" )
+			{
+				m_colorSpace = reader->sourceColorSpace();
+			}
+		}
+
+		typedef std::pair<std::string, MemberData *> ComputeParameters;
+		typedef IECore::ComputationCache<ComputeParameters> Cache;
+
+		ImageReaderPtr m_reader;
+		// The readers aren't threadsafe, so we serialise all access to them.
+		tbb::mutex m_readerMutex;
+		Cache m_cache;
+
+		std::string m_fileName;
+		Box2i m_dataWindow;
+		Box2i m_displayWindow;
+		vector<string> m_channelNames;
+		bool m_hasAlpha;
+		bool m_raw;
+		std::string m_colorSpace;
+
+		void validate( const std::string &name ) const
+		{
+			if( find( m_channelNames.begin(), m_channelNames.end(), name ) == m_channelNames.end() )
+			{
+				throw InvalidArgumentException( ( boost::format( "ImageChannelLoader : Channel \"%s\" does not exist in \"%s\"." ) % name % m_fileName ).str() );
+			}
+		}
+
+	private :
+
+		static MurmurHash hashFn( const ComputeParameters &params )
+		{
+			const MemberData *data = params.second;
+			MurmurHash h;
+			h.append( "ImageChannelLoader" );
+			h.append( data->m_fileName );
+			h.append( params.first );
+			h.append( data->m_dataWindow );
+			h.append( data->m_raw ? 1 : 0 );
+			if( !data->m_raw )
+			{
+				h.append( data->m_colorSpace );
+			}
+			return h;
+		}
+
+		static ConstObjectPtr computeFn( const ComputeParameters &params )
+		{
+			const std::string &name = params.first;
+			MemberData *data = params.second;
+
+			bool convert = !data->m_raw && data->m_colorSpace != "linear" && name != "A";
+
+			ImagePrimitivePtr image = new ImagePrimitive( data->m_dataWindow, data->m_displayWindow );
+			{
+				tbb::mutex::scoped_lock lock( data->m_readerMutex );
+				image->variables[name] = PrimitiveVariable( PrimitiveVariable::Vertex, data->m_reader->readChannel( name, data->m_raw ) );
+				if( convert && data->m_hasAlpha )
+				{
+					// needed so the conversion can unpremultiply
+					image->variables["A"] = PrimitiveVariable( PrimitiveVariable::Vertex, data->m_reader->readChannel( "A", false ) );
+				}
+			}
+
+			if( convert )
+			{
+				ColorSpaceTransformOpPtr transformOp = new ColorSpaceTransformOp();
+				transformOp->inputColorSpaceParameter()->setTypedValue( data->m_colorSpace );
+				transformOp->outputColorSpaceParameter()->setTypedValue( "linear" );
+				transformOp->inputParameter()->setValue( image );
+				transformOp->copyParameter()->setTypedValue( false );
+				transformOp->channelsParameter()->setTypedValue( vector<string>( 1, name ) );
+				transformOp->operate();
+			}
+
+			return image->variables[name].data;
+		}
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// ImageChannelLoader
+//////////////////////////////////////////////////////////////////////////
+
+ImageChannelLoader::ImageChannelLoader( ImageReaderPtr reader, ObjectPoolPtr objectPool )
+	:	m_data( new MemberData( reader, objectPool ) )
+{
+}
+
+ImageChannelLoader::~ImageChannelLoader()
+{
+}
+
+const std::string &ImageChannelLoader::fileName() const
+{
+	return m_data->m_fileName;
+}
+
+const Imath::Box2i &ImageChannelLoader::dataWindow() const
+{
+	return m_data->m_dataWindow;
+}
+
+const Imath::Box2i &ImageChannelLoader::displayWindow() const
+{
+	return m_data->m_displayWindow;
+}
+
+const std::vector<std::string> &ImageChannelLoader::channelNames() const
+{
+	return m_data->m_channelNames;
+}
+
+ConstDataPtr ImageChannelLoader::channel( const std::string &name )
+{
+	m_data->validate( name );
+	return boost::static_pointer_cast<const Data>( m_data->m_cache.get( MemberData::ComputeParameters( name, m_data.get() ) ) );
+}
+
+bool ImageChannelLoader::cached( const std::string &name ) const
+{
+	if( find( m_data->m_channelNames.begin(), m_data->m_channelNames.end(), name ) == m_data->m_channelNames.end() )
+	{
+		return false;
+	}
+	return m_data->m_cache.get( MemberData::ComputeParameters( name, m_data.get() ), MemberData::Cache::NullIfMissing ).get() != 0;
+}
+
+ImagePrimitivePtr ImageChannelLoader::image() const
+{
+	return new ImagePrimitive( m_data->m_dataWindow, m_data->m_displayWindow );
+}
+
+void ImageChannelLoader::load( ImagePrimitive *image, const std::vector<std::string> &names )
+{
+	for( vector<string>::const_iterator it = names.begin(); it != names.end(); ++it )
+	{
+		if( image->variables.find( *it ) != image->variables.end() )
+		{
+			continue;
+		}
+		ConstDataPtr data = channel( *it );
+		image->variables[*it] = PrimitiveVariable( PrimitiveVariable::Vertex, data->copy() );
+	}
+}
+
+ObjectPool *ImageChannelLoader::objectPool() const
+{
+	return m_data->m_cache.objectPool();
+}
@@ -52,6 +52,11 @@
 
 #include "boost/format.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+
 using boost::str;
 using boost::format;
 
@@ -242,31 +247,75 @@ FloatVectorDataPtr ImageCompositeOp::getChannelData( ImagePrimitive * image, con
 		>( it->second.data.get(), converter );
 }
 
-float ImageCompositeOp::readChannelData( const ImagePrimitive * image, const FloatVectorData * data, const V2i &pixel )
+// Composites whole rows of the new data window at a time. Image B has already been
+// cropped to the new data window, but image A may only partially overlap it, so
+// rows of A are gathered into scratch buffers, padded with zeroes outside its data
+// window. Missing alpha channels are treated as having an alpha of 1 everywhere.
+class ImageCompositeOp::CompositeRows
 {
-	assert( image );
-	assert( data );
 
-	V2i offset = pixel - image->getDataWindow().min;
-	if ( offset.x < 0 || offset.y < 0 )
-	{
-		return 0.0f;
-	}
+	public :
 
-	const int width = image->getDataWindow().size().x + 1;
-	const int height = image->getDataWindow().size().y + 1;
+		CompositeRows(
+			CompositeFn fn, const Imath::Box2i &dataWindow, const Imath::Box2i &aDataWindow,
+			const FloatVectorData *a, const FloatVectorData *aAlpha, const float *b, const float *bAlpha, float *result
+		)
+			:	m_fn( fn ), m_dataWindow( dataWindow ), m_aDataWindow( aDataWindow ),
+				m_a( a->readable() ), m_aAlpha( aAlpha ? &aAlpha->readable() : 0 ), m_b( b ), m_bAlpha( bAlpha ), m_result( result )
+		{
+		}
 
-	if ( offset.x >= width || offset.y >= height )
-	{
-		return 0.0f;
-	}
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			const int width = m_dataWindow.size().x + 1;
+			const int aWidth = m_aDataWindow.size().x + 1;
+			const int minX = std::max( m_dataWindow.min.x, m_aDataWindow.min.x );
+			const int maxX = std::min( m_dataWindow.max.x, m_aDataWindow.max.x );
 
-	const int idx = offset.y * width + offset.x;
+			std::vector<float> aRow( width );
+			std::vector<float> aAlphaRow( width, 1.0f );
+			std::vector<float> ones( m_bAlpha ? 0 : width, 1.0f );
 
-	assert( idx >= 0 );
-	assert( idx < (int)data->readable().size() );
-	return data->readable()[ idx ];
-}
+			for( int y = range.begin(); y != range.end(); ++y )
+			{
+				std::fill( aRow.begin(), aRow.end(), 0.0f );
+				if( m_aAlpha )
+				{
+					std::fill( aAlphaRow.begin(), aAlphaRow.end(), 0.0f );
+				}
+
+				if( y >= m_aDataWindow.min.y && y <= m_aDataWindow.max.y && minX <= maxX )
+				{
+					const size_t aOffset = ( y - m_aDataWindow.min.y ) * aWidth + ( minX - m_aDataWindow.min.x );
+					const size_t rowOffset = minX - m_dataWindow.min.x;
+					std::copy( m_a.begin() + aOffset, m_a.begin() + aOffset + ( maxX - minX + 1 ), aRow.begin() + rowOffset );
+					if( m_aAlpha )
+					{
+						std::copy( m_aAlpha->begin() + aOffset, m_aAlpha->begin() + aOffset + ( maxX - minX + 1 ), aAlphaRow.begin() + rowOffset );
+					}
+				}
+
+				const size_t offset = ( y - m_dataWindow.min.y ) * width;
+				m_fn(
+					width, &aRow[0], &aAlphaRow[0],
+					m_b + offset, m_bAlpha ? m_bAlpha + offset : &ones[0],
+					m_result + offset
+				);
+			}
+		}
+
+	private :
+
+		CompositeFn m_fn;
+		Imath::Box2i m_dataWindow;
+		Imath::Box2i m_aDataWindow;
+		const std::vector<float> &m_a;
+		const std::vector<float> *m_aAlpha;
+		const float *m_b;
+		const float *m_bAlpha;
+		float *m_result;
+
+};
 
 void ImageCompositeOp::composite( CompositeFn fn, DataWindowResult dwr, ImagePrimitive * imageB, const CompoundObject * operands )
 {
@@ -376,22 +425,20 @@ void ImageCompositeOp::composite( CompositeFn fn, DataWindowResult dwr, ImagePri
 		newBData->writable().resize( newArea );
 		imageB->variables[ channelName ].data = newBData;
 
-		for ( int y = newDataWindow.min.y; y <= newDataWindow.max.y; y++ )
+		if( newDataWindow.isEmpty() )
 		{
-			int offset = (y - newDataWindow.min.y ) * newWidth;
-			for ( int x = newDataWindow.min.x; x <= newDataWindow.max.x; x++, offset++ )
-			{
-				float aVal = readChannelData( imageA.get(), aData.get(), V2i( x, y ) );
-				float bVal = readChannelData( imageB, bData.get(), V2i( x, y ) );
-
-				float aAlpha = aAlphaData ? readChannelData( imageA.get(), aAlphaData.get(), V2i( x, y ) ) : 1.0f;
-				float bAlpha = bAlphaData ? readChannelData( imageB, bAlphaData.get(), V2i( x, y ) ) : 1.0f;
-
-				assert( offset >= 0 );
-				assert( offset < (int)newBData->readable().size() );
-				newBData->writable()[ offset  ] = fn( aVal, aAlpha, bVal, bAlpha );
-			}
+			continue;
 		}
+
+		tbb::parallel_for(
+			tbb::blocked_range<int>( newDataWindow.min.y, newDataWindow.max.y + 1 ),
+			CompositeRows(
+				fn, newDataWindow, imageA->getDataWindow(),
+				aData.get(), aAlphaData.get(),
+				&bData->readable()[0], bAlphaData ? &bAlphaData->readable()[0] : 0,
+				&newBData->writable()[0]
+			)
+		);
 	}
 
 	/// displayWindow should be unchanged
@@ -37,6 +37,11 @@
 
 #include "boost/format.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/spin_mutex.h"
+#include "tbb/task.h"
+
 #include "IECore/ImageDiffOp.h"
 
 #include "IECore/MessageHandler.h"
@@ -49,9 +54,7 @@
 #include "IECore/Reader.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/ImagePrimitive.h"
-#include "IECore/DataConvert.h"
 #include "IECore/ScaledDataConversion.h"
-#include "IECore/MeanSquaredError.h"
 #include "IECore/ImageCropOp.h"
 
 using namespace IECore;
@@ -165,22 +168,127 @@ const BoolParameter * ImageDiffOp::alignDisplayWindows() const
 	return m_alignDisplayWindowsParameter.get();
 }
 
-/// A class to use a ScaledDataConversion to transform image data to floating point, to allow for simple measuring of
-/// error between two potentially different data types (e.g. UShort and Half)
-struct ImageDiffOp::FloatConverter
+namespace
+{
+
+// Accumulates the squared error between two channels, converting each element
+// to float on the fly using a ScaledDataConversion, so that channels of different
+// types (e.g. UShort and Half) may be compared without first converting them
+// in their entirety. The accumulation is shared between tasks, and they are
+// cancelled as soon as it exceeds the limit, since the error can only grow.
+template<typename A, typename B>
+class SquaredErrorTask
+{
+
+	public :
+
+		SquaredErrorTask( const A *a, const B *b, double limit, double &total, tbb::spin_mutex &mutex, tbb::task_group_context &context )
+			:	m_a( a ), m_b( b ), m_limit( limit ), m_total( total ), m_mutex( mutex ), m_context( context )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			ScaledDataConversion<A, float> convertA;
+			ScaledDataConversion<B, float> convertB;
+
+			double sum = 0;
+			for( size_t i = r.begin(), e = r.end(); i < e; ++i )
+			{
+				const float d = convertA( m_a[i] ) - convertB( m_b[i] );
+				sum += d * d;
+			}
+
+			tbb::spin_mutex::scoped_lock lock( m_mutex );
+			m_total += sum;
+			if( m_total > m_limit )
+			{
+				m_context.cancel_group_execution();
+			}
+		}
+
+	private :
+
+		const A *m_a;
+		const B *m_b;
+		const double m_limit;
+		double &m_total;
+		tbb::spin_mutex &m_mutex;
+		tbb::task_group_context &m_context;
+
+};
+
+template<typename A>
+struct SquaredErrorB
+{
+
+	typedef bool ReturnType;
+
+	SquaredErrorB( const std::vector<A> &a, float maxError )
+		:	m_a( a ), m_maxError( maxError )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data )
+	{
+		typedef typename T::ValueType::value_type B;
+		const std::vector<B> &b = data->readable();
+		if( b.size() != m_a.size() )
+		{
+			throw InvalidArgumentException( "ImageDiffOp : Channels have different sizes" );
+		}
+
+		if( b.empty() )
+		{
+			return false;
+		}
+
+		// The channels differ if the root-mean-squared error exceeds maxError,
+		// which is equivalent to the sum of the squared errors exceeding this
+		// limit.
+		const double limit = (double)m_maxError * m_maxError * b.size();
+
+		double total = 0;
+		tbb::spin_mutex mutex;
+		tbb::task_group_context context;
+		SquaredErrorTask<A, B> task( &m_a[0], &b[0], limit, total, mutex, context );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, b.size(), 16384 ), task, context );
+
+		return total > limit;
+	}
+
+	const std::vector<A> &m_a;
+	const float m_maxError;
+
+};
+
+} // namespace
+
+/// Despatched on the type of the first channel, and then in turn
+/// on the second, returning true if the root-mean-squared error
+/// between them exceeds maxError.
+struct ImageDiffOp::SquaredError
 {
-	typedef FloatVectorDataPtr ReturnType;
+
+	typedef bool ReturnType;
+
+	SquaredError( Data *b, float maxError )
+		:	m_b( b ), m_maxError( maxError )
+	{
+	}
 
 	template<typename T>
-	ReturnType operator()( typename T::Ptr data )
+	ReturnType operator()( const T *data )
 	{
-		assert( data );
+		typedef typename T::ValueType::value_type A;
+		SquaredErrorB<A> f( data->readable(), m_maxError );
+		return despatchTypedData<SquaredErrorB<A>, TypeTraits::IsNumericVectorTypedData>( m_b, f );
+	}
+
+	Data *m_b;
+	const float m_maxError;
 
-		return DataConvert < T, FloatVectorData, ScaledDataConversion< typename T::ValueType::value_type, float > >()
-		       (
-		               boost::static_pointer_cast<const T>( data )
-		       );
-	};
 };
 
 ObjectPtr ImageDiffOp::doOperation( const CompoundObject * operands )
@@ -238,16 +346,20 @@ ObjectPtr ImageDiffOp::doOperation( const CompoundObject * operands )
 		return new BoolData( true );
 	}
 
-	/// Use the CropOp to expand the dataWindows of both images to fill the display window
-	ImageCropOpPtr cropOp = new ImageCropOp();
-	cropOp->matchDataWindowParameter()->setTypedValue( true );
-	cropOp->cropBoxParameter()->setTypedValue( imageA->getDisplayWindow() );
+	/// Use the CropOp to expand the dataWindows of both images to fill the display window,
+	/// unless they already do, as is typical of rendered images.
+	if( imageA->getDataWindow() != imageA->getDisplayWindow() || imageB->getDataWindow() != imageB->getDisplayWindow() )
+	{
+		ImageCropOpPtr cropOp = new ImageCropOp();
+		cropOp->matchDataWindowParameter()->setTypedValue( true );
+		cropOp->cropBoxParameter()->setTypedValue( imageA->getDisplayWindow() );
 
-	cropOp->inputParameter()->setValue( imageA );
-	imageA = runTimeCast< ImagePrimitive >( cropOp->operate() );
+		cropOp->inputParameter()->setValue( imageA );
+		imageA = runTimeCast< ImagePrimitive >( cropOp->operate() );
 
-	cropOp->inputParameter()->setValue( imageB );
-	imageB = runTimeCast< ImagePrimitive >( cropOp->operate() );
+		cropOp->inputParameter()->setValue( imageB );
+		imageB = runTimeCast< ImagePrimitive >( cropOp->operate() );
+	}
 
 	const float maxError = m_maxErrorParameter->getNumericValue();
 
@@ -313,13 +425,11 @@ ObjectPtr ImageDiffOp::doOperation( const CompoundObject * operands )
 		assert( aData );
 		assert( bData );
 
-		FloatVectorDataPtr aFloatData = 0;
-		FloatVectorDataPtr bFloatData = 0;
-
+		bool differs = false;
 		try
 		{
-			aFloatData = despatchTypedData< FloatConverter, TypeTraits::IsNumericVectorTypedData > ( aData.get() );
-			bFloatData = despatchTypedData< FloatConverter, TypeTraits::IsNumericVectorTypedData > ( bData.get() );
+			SquaredError f( bData.get(), maxError );
+			differs = despatchTypedData<SquaredError, TypeTraits::IsNumericVectorTypedData>( aData.get(), f );
 		}
 		catch ( Exception &e )
 		{
@@ -327,12 +437,7 @@ ObjectPtr ImageDiffOp::doOperation( const CompoundObject * operands )
 			return new BoolData( true );
 		}
 
-		assert( aFloatData );
-		assert( bFloatData );
-		assert( aFloatData->readable().size() == bFloatData->readable().size() );
-
-		float rms = sqrt( MeanSquaredError<FloatVectorData>()( aFloatData, bFloatData ) );
-		if ( rms > maxError )
+		if ( differs )
 		{
 			return new BoolData( true );
 		}
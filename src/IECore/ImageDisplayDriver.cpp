@@ -32,6 +32,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
+
 #include "tbb/mutex.h"
 
 #include "boost/algorithm/string/predicate.hpp"
@@ -45,6 +47,57 @@ using namespace IECore;
 
 IE_CORE_DEFINERUNTIMETYPED( ImageDisplayDriver );
 
+namespace
+{
+
+// De-interleaves a row of width pixels with N channels. Having the pixel size
+// as a template parameter allows the compiler to unroll the inner loop for the
+// common cases.
+template<int N>
+void deinterleaveRow( const float *source, float * const *targets, int width )
+{
+	for( int x = 0; x < width; ++x )
+	{
+		for( int c = 0; c < N; ++c )
+		{
+			targets[c][x] = source[c];
+		}
+		source += N;
+	}
+}
+
+void deinterleaveRow( const float *source, float * const *targets, int width, int numChannels )
+{
+	switch( numChannels )
+	{
+		case 1 :
+			memcpy( targets[0], source, width * sizeof( float ) );
+			break;
+		case 2 :
+			deinterleaveRow<2>( source, targets, width );
+			break;
+		case 3 :
+			deinterleaveRow<3>( source, targets, width );
+			break;
+		case 4 :
+			deinterleaveRow<4>( source, targets, width );
+			break;
+		default :
+			for( int c = 0; c < numChannels; ++c )
+			{
+				float *target = targets[c];
+				const float *s = source + c;
+				for( int x = 0; x < width; ++x )
+				{
+					target[x] = *s;
+					s += numChannels;
+				}
+			}
+	}
+}
+
+} // namespace
+
 const DisplayDriver::DisplayDriverDescription<ImageDisplayDriver> ImageDisplayDriver::g_description;
 
 typedef std::map<std::string, ConstImagePrimitivePtr> ImagePool;
@@ -57,7 +110,7 @@ ImageDisplayDriver::ImageDisplayDriver( const Box2i &displayWindow, const Box2i
 {
 	for ( vector<string>::const_iterator it = channelNames.begin(); it != channelNames.end(); it++ )
 	{
-		m_image->createChannel<float>( *it );
+		m_channels.push_back( m_image->createChannel<float>( *it ) );
 	}
 	if( parameters )
 	{
@@ -113,30 +166,33 @@ void ImageDisplayDriver::imageData( const Box2i &box, const float *data, size_t
 		throw Exception("Invalid dataSize value.");
 	}
 
-	int channel, targetX, targetY, sourceWidth, sourceHeight, targetWidth;
-	sourceWidth = box.max.x - box.min.x + 1;
-	sourceHeight = box.max.y - box.min.y + 1;
-	targetWidth = dataWindow.max.x - dataWindow.min.x + 1;
-	channel = 0;
-	targetX = box.min.x - dataWindow.min.x;
-	targetY = box.min.y - dataWindow.min.y;
+	const int sourceWidth = box.max.x - box.min.x + 1;
+	const int sourceHeight = box.max.y - box.min.y + 1;
+	const int targetWidth = dataWindow.max.x - dataWindow.min.x + 1;
+	const int targetOffset = targetWidth * ( box.min.y - dataWindow.min.y ) + box.min.x - dataWindow.min.x;
 
-	for ( vector<string>::const_iterator it = channelNames().begin(); it != channelNames().end(); it++, channel++ )
+	if( !pixelSize )
 	{
-		vector< float > &target = boost::static_pointer_cast< FloatVectorData >(m_image->variables[ *it ].data)->writable();
-		vector< float >::iterator targetIt;
-		const float *sourceIt = data+channel;
-		targetIt = target.begin()+targetWidth*targetY+targetX;
+		return;
+	}
 
-		for ( int y = 0; y < sourceHeight; y++ )
+	// the lock is held only while fetching the pointers, so buckets from
+	// different threads can then be written concurrently.
+	vector<float *> targets( pixelSize );
+	{
+		tbb::spin_mutex::scoped_lock lock( m_writableMutex );
+		for( int c = 0; c < pixelSize; ++c )
 		{
-			for ( int x = 0; x < sourceWidth; x++ )
-			{
-				*targetIt = *sourceIt;
-				sourceIt += pixelSize;
-				targetIt++;
-			}
-			targetIt += targetWidth - sourceWidth;
+			targets[c] = &(m_channels[c]->writable()[0]) + targetOffset;
+		}
+	}
+
+	for ( int y = 0; y < sourceHeight; y++ )
+	{
+		deinterleaveRow( data + y * sourceWidth * pixelSize, &targets[0], sourceWidth, pixelSize );
+		for( int c = 0; c < pixelSize; ++c )
+		{
+			targets[c] += targetWidth;
 		}
 	}
 }
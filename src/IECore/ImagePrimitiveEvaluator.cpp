@@ -36,6 +36,9 @@
 
 #include "boost/format.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "OpenEXR/ImathBoxAlgo.h"
 #include "OpenEXR/ImathLineAlgo.h"
 
@@ -54,6 +57,149 @@ IE_CORE_DEFINERUNTIMETYPED( ImagePrimitiveEvaluator );
 
 static PrimitiveEvaluator::Description< ImagePrimitiveEvaluator > g_registraar = PrimitiveEvaluator::Description< ImagePrimitiveEvaluator >();
 
+namespace
+{
+
+// The pixels and weights used to filter the value at a single uv, computed in
+// exactly the same way as Result::getPrimVar(). Pixels outside the data window
+// have an index of -1 and contribute zero.
+struct Footprint
+{
+	int index[4];
+	float fx;
+	float fy;
+};
+
+inline int pixelIndex( const V2i &p, int dataWidth, int dataHeight )
+{
+	if ( p.x >= 0 && p.y >= 0 && p.x < dataWidth && p.y < dataHeight )
+	{
+		return ( p.y * dataWidth ) + p.x;
+	}
+	return -1;
+}
+
+inline void computeFootprint( const V2f &uv, const Box3f &bound, const Box2i &dataWindow, Footprint &footprint )
+{
+	footprint.index[0] = footprint.index[1] = footprint.index[2] = footprint.index[3] = -1;
+	footprint.fx = footprint.fy = 0.0f;
+
+	if ( uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0 || dataWindow.isEmpty() )
+	{
+		return;
+	}
+
+	const V3f p(
+		bound.min.x + uv.x * ( bound.max.x - bound.min.x ),
+		bound.min.y + uv.y * ( bound.max.y - bound.min.y ),
+		0.0f
+	);
+
+	V2f pf(
+		( p.x - bound.min.x ),
+		( p.y - bound.min.y )
+	);
+
+	const int dataWidth = dataWindow.size().x + 1;
+	const int dataHeight = dataWindow.size().y + 1;
+
+	if (
+		   pf.x <= ( dataWindow.min.x + 0.5f )
+		|| pf.y <= ( dataWindow.min.y + 0.5f )
+		|| pf.x >= ( dataWindow.max.x + 0.5f )
+		|| pf.y >= ( dataWindow.max.y + 0.5f )
+	)
+	{
+		const float tol = 1.e-3;
+		if ( pf.x >= dataWindow.max.x + 1.0f - tol && pf.x <= dataWindow.max.x + 1.0f + tol)
+		{
+			pf.x = dataWindow.max.x + 1.0f - tol;
+		}
+
+		if ( pf.y >= dataWindow.max.y + 1.0f - tol && pf.y <= dataWindow.max.y + 1.0f + tol)
+		{
+			pf.y = dataWindow.max.y + 1.0f - tol;
+		}
+
+		V2i p0( static_cast<int>( pf.x ), static_cast<int>( pf.y ) );
+		footprint.index[0] = pixelIndex( p0 - dataWindow.min, dataWidth, dataHeight );
+		return;
+	}
+
+	pf = pf - V2f( 0.5 );
+
+	V2i p0( static_cast<int>( pf.x ), static_cast<int>( pf.y ) );
+	V2i p1 = p0 + V2i( 1 );
+
+	footprint.fx = pf.x - (float)(p0.x);
+	footprint.fy = pf.y - (float)(p0.y);
+
+	p0 = p0 - dataWindow.min;
+	p1 = p1 - dataWindow.min;
+
+	footprint.index[0] = pixelIndex( V2i( p0.x, p0.y ), dataWidth, dataHeight );
+	footprint.index[1] = pixelIndex( V2i( p1.x, p0.y ), dataWidth, dataHeight );
+	footprint.index[2] = pixelIndex( V2i( p0.x, p1.y ), dataWidth, dataHeight );
+	footprint.index[3] = pixelIndex( V2i( p1.x, p1.y ), dataWidth, dataHeight );
+}
+
+inline float pixelValue( const float *channel, int index )
+{
+	return index >= 0 ? channel[index] : 0.0f;
+}
+
+// Samples a range of the uvs. The footprints are computed once for all channels,
+// and then each channel is filtered in a tight loop over the whole range.
+class ChannelSampler
+{
+
+	public :
+
+		ChannelSampler( const Box3f &bound, const Box2i &dataWindow, const std::vector<const float *> &channels, const std::vector<V2f> &uvs, std::vector<float> &values )
+			:	m_bound( bound ), m_dataWindow( dataWindow ), m_channels( channels ), m_uvs( uvs ), m_values( values )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			std::vector<Footprint> footprints( range.size() );
+			for ( size_t i = 0; i < footprints.size(); i++ )
+			{
+				computeFootprint( m_uvs[range.begin() + i], m_bound, m_dataWindow, footprints[i] );
+			}
+
+			const size_t numChannels = m_channels.size();
+			for ( size_t channelIndex = 0; channelIndex < numChannels; channelIndex++ )
+			{
+				const float *channel = m_channels[channelIndex];
+				float *out = &(m_values[range.begin() * numChannels + channelIndex]);
+				for ( size_t i = 0; i < footprints.size(); i++ )
+				{
+					const Footprint &f = footprints[i];
+					const float a = pixelValue( channel, f.index[0] );
+					const float b = pixelValue( channel, f.index[1] );
+					const float c = pixelValue( channel, f.index[2] );
+					const float d = pixelValue( channel, f.index[3] );
+					// as LinearInterpolator, which interpolates in double precision
+					const float e = static_cast<float>( a + ( b - a ) * (double)f.fx );
+					const float g = static_cast<float>( c + ( d - c ) * (double)f.fx );
+					out[i * numChannels] = static_cast<float>( e + ( g - e ) * (double)f.fy );
+				}
+			}
+		}
+
+	private :
+
+		const Box3f &m_bound;
+		const Box2i &m_dataWindow;
+		const std::vector<const float *> &m_channels;
+		const std::vector<V2f> &m_uvs;
+		std::vector<float> &m_values;
+
+};
+
+} // namespace
+
 ImagePrimitiveEvaluator::Result::Result( const Imath::Box3f &bound, const Imath::Box2i &dataWindow ) : m_bound( bound )
 {
 	m_dataWindow = dataWindow;
@@ -412,6 +558,41 @@ bool ImagePrimitiveEvaluator::pointAtPixel( const Imath::V2i &pixel, PrimitiveEv
 	return pointAtUV( uv, r );
 }
 
+void ImagePrimitiveEvaluator::channelsAtUVs( const std::vector<Imath::V2f> &uvs, const std::vector<std::string> &channelNames, std::vector<float> &values ) const
+{
+	const size_t numPixels = m_image->variableSize( PrimitiveVariable::Vertex );
+
+	std::vector<const float *> channels;
+	channels.reserve( channelNames.size() );
+	for ( std::vector<std::string>::const_iterator it = channelNames.begin(); it != channelNames.end(); ++it )
+	{
+		PrimitiveVariableMap::const_iterator vIt = m_image->variables.find( *it );
+		if ( vIt == m_image->variables.end() )
+		{
+			throw InvalidArgumentException( ( boost::format( "ImagePrimitiveEvaluator: Channel \"%s\" does not exist" ) % *it ).str() );
+		}
+
+		const FloatVectorData *data = runTimeCast<const FloatVectorData>( vIt->second.data.get() );
+		if ( !data || data->readable().size() != numPixels )
+		{
+			throw InvalidArgumentException( ( boost::format( "ImagePrimitiveEvaluator: Channel \"%s\" is not FloatVectorData with a value per pixel" ) % *it ).str() );
+		}
+
+		channels.push_back( numPixels ? &(data->readable()[0]) : 0 );
+	}
+
+	values.resize( uvs.size() * channels.size() );
+	if ( uvs.empty() || channels.empty() )
+	{
+		return;
+	}
+
+	const Box3f bound = m_image->bound();
+	const Box2i dataWindow = m_image->getDataWindow();
+	ChannelSampler sampler( bound, dataWindow, channels, uvs, values );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, uvs.size(), 1024 ), sampler );
+}
+
 bool ImagePrimitiveEvaluator::intersectionPoint( const V3f &origin, const V3f &direction,
                 PrimitiveEvaluator::Result *result, float maxDistance ) const
 {
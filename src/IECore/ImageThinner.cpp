@@ -32,13 +32,12 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
-#include "boost/multi_array.hpp"
-
 #include "IECore/ImageThinner.h"
-#include "IECore/DespatchTypedData.h"
-#include "IECore/TypeTraits.h"
 #include "IECore/CompoundParameter.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_reduce.h"
+
 using namespace IECore;
 using namespace std;
 using namespace Imath;
@@ -110,101 +109,198 @@ const FloatParameter * ImageThinner::thresholdParameter() const
 	return parameters()->parameter<FloatParameter>( "threshold" );
 }
 
-void ImageThinner::modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels )
+void ImageThinner::modifyTile( const Imath::Box2i &dataWindow, const Imath::Box2i &tile, const std::vector<float *> &channels ) const
 {
-	float threshold = thresholdParameter()->getNumericValue();
+	const float threshold = thresholdParameter()->getNumericValue();
 
-	const V2i size = dataWindow.size() + V2i( 1 );
-	
+	const size_t numPixels = ( tile.size().x + 1 ) * ( tile.size().y + 1 );
 	for( unsigned i=0; i<channels.size(); i++ )
 	{
-		FloatVectorDataPtr floatData = runTimeCast<FloatVectorData>( channels[i] );
-		if( !floatData )
+		float *channel = channels[i];
+		for( size_t j = 0; j < numPixels; j++ )
 		{
-			throw Exception( "ImageThinner::modifyChannels : only float channels supported." );
+			channel[j] = channel[j] < threshold ? 0.0f : 1.0f;
 		}
-		std::vector<float> &channel = floatData->writable();
-		
-		// threshold the image first
-		for( std::vector<float>::iterator it=channel.begin(); it!=channel.end(); it++ )
+	}
+}
+
+namespace
+{
+
+// Performs a single subpass of the thinning, reading from one buffer and
+// writing to another so that scanlines can be processed independently. The
+// serial scan from the original code only ever examined pixels before they
+// were deleted by the current subpass, so this gives identical results. The
+// neighbourhood maps are reconstructed exactly as the serial scan built them,
+// including its quirks at the left and bottom edges of the image.
+class ThinningPass
+{
+
+	public :
+
+		ThinningPass( const unsigned char *src, unsigned char *dst, const V2i &size, int mask )
+			:	m_src( src ), m_dst( dst ), m_size( size ), m_mask( mask ), m_count( 0 )
 		{
-			*it = *it < threshold ? 0.0f : 1.0f;
 		}
-		
-		// then apply the graphics gems magic that i don't understand in the slightest
-		//////////////////////////////////////////////////////////////////////////////
-		
-		boost::multi_array_ref<float, 2> image( &channel[0], boost::extents[size.y][size.x] );
-
-		int	p, q; // Neighborhood maps of adjacent cells
-		std::vector<unsigned char> qb; // Neighborhood maps of previous scanline
-		qb.resize( size.x );
-		qb[qb.size()-1] = 0; // Used for lower-right pixel
-
-		int count = 1; // Deleted pixel count
-		while( count )
+
+		ThinningPass( ThinningPass &other, tbb::split )
+			:	m_src( other.m_src ), m_dst( other.m_dst ), m_size( other.m_size ), m_mask( other.m_mask ), m_count( 0 )
 		{
-			count = 0;
+		}
 
-			for( int i = 0; i < 4 ; i++ )
+		void operator()( const tbb::blocked_range<int> &range )
+		{
+			for( int y = range.begin(); y != range.end(); y++ )
 			{
+				if( y < m_size.y - 1 )
+				{
+					scanRow( y, true );
+				}
+				else
+				{
+					scanBottomRow();
+				}
+			}
+		}
+
+		void join( const ThinningPass &other )
+		{
+			m_count += other.m_count;
+		}
 
-				int m = g_masks[i];
+		/// The number of pixels deleted.
+		size_t count() const
+		{
+			return m_count;
+		}
+
+	private :
+
+		int pixel( int x, int y ) const
+		{
+			if( x < 0 || x >= m_size.x || y < 0 || y >= m_size.y )
+			{
+				return 0;
+			}
+			return m_src[y * m_size.x + x];
+		}
 
-				// Build initial previous scan buffer
+		void apply( int p, int x, int y )
+		{
+			const size_t i = y * m_size.x + x;
+			if( m_src[i] && ( p & m_mask ) == 0 && g_delete[p] )
+			{
+				m_dst[i] = 0;
+				m_count++;
+			}
+			else
+			{
+				m_dst[i] = m_src[i];
+			}
+		}
 
-				p = image[0][0] > 0.5f;
-				for( int x = 0; x < size.x-1; x++ )
+		// Returns the neighbourhood map for the right edge pixel, which the
+		// serial scan carried over into the bottom scanline.
+		int scanRow( int y, bool write )
+		{
+			int p = ( pixel( 1, y - 1 ) << 6 ) | ( pixel( 1, y ) << 3 ) | pixel( 0, y + 1 );
+			for( int x = 0; x < m_size.x - 1; x++ )
+			{
+				p = ( ( p << 1 ) & 0666 ) | ( pixel( x + 1, y - 1 ) << 6 ) | ( pixel( x + 1, y ) << 3 ) | pixel( x + 1, y + 1 );
+				if( write )
 				{
-					qb[x] = p = ((p<<1)&0006) | (image[0][x+1] > 0.5f);
+					apply( p, x, y );
 				}
-				
-				// Scan image for pixel deletion candidates
+			}
 
-				for( int y = 0; y < size.y-1; y++ )
-				{
+			p = ( p << 1 ) & 0666;
+			if( write )
+			{
+				apply( p, m_size.x - 1, y );
+			}
 
-					q = qb[0];
-					p = ((q<<3)&0110) | (image[y+1][0] > 0.5f);
-
-					for( int x = 0; x < size.x-1; x++ )
-					{
-						q = qb[x];
-						p = ((p<<1)&0666) | ((q<<3)&0110) |
-							(image[y+1][x+1] > 0.5f);
-						qb[x] = p;
-						if( ((p&m) == 0) && g_delete[p] )
-						{
-							count++;
-							image[y][x] = 0.f;
-						}
-					}
-
-					// Process right edge pixel
-
-					p = (p<<1)&0666;
-					if( (p&m) == 0 && g_delete[p] )
-					{
-						count++;
-						image[y][size.x-1] = 0.f;
-					}
-					
-				}
+			return p;
+		}
 
-				// Process bottom scan line
+		void scanBottomRow()
+		{
+			const int y = m_size.y - 1;
 
-				for( int x = 0 ; x < size.x ; x++ )
+			int p;
+			if( y > 0 )
+			{
+				p = scanRow( y - 1, false );
+			}
+			else
+			{
+				p = pixel( 0, 0 );
+				for( int x = 0; x < m_size.x - 1; x++ )
 				{
-					q = qb[x];
-					p = ((p<<1)&0666) | ((q<<3)&0110);
-					if( (p&m) == 0 && g_delete[p] )
-					{
-						count++;
-						image[size.y-1][x] = 0.f;
-					}
+					p = ( ( p << 1 ) & 0006 ) | pixel( x + 1, 0 );
 				}
 			}
+
+			for( int x = 0; x < m_size.x; x++ )
+			{
+				p = ( ( p << 1 ) & 0666 ) | ( pixel( x + 1, y - 1 ) << 6 ) | ( pixel( x + 1, y ) << 3 );
+				apply( p, x, y );
+			}
+		}
+
+		const unsigned char *m_src;
+		unsigned char *m_dst;
+		const V2i m_size;
+		const int m_mask;
+		size_t m_count;
+
+};
+
+} // namespace
+
+void ImageThinner::modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels )
+{
+	for( unsigned i=0; i<channels.size(); i++ )
+	{
+		if( !runTimeCast<FloatVectorData>( channels[i] ) )
+		{
+			throw Exception( "ImageThinner::modifyChannels : only float channels supported." );
 		}
 	}
-}
 
+	// threshold the image first
+	ChannelOp::modifyChannels( displayWindow, dataWindow, channels );
+
+	// then apply the graphics gems magic, one channel at a time
+	//////////////////////////////////////////////////////////
+
+	const V2i size = dataWindow.size() + V2i( 1 );
+	std::vector<unsigned char> front( size.x * size.y );
+	std::vector<unsigned char> back( size.x * size.y );
+
+	for( unsigned i=0; i<channels.size(); i++ )
+	{
+		std::vector<float> &channel = channels[i]->writable();
+		for( size_t j = 0; j < channel.size(); j++ )
+		{
+			front[j] = channel[j] > 0.5f;
+		}
+
+		size_t count = 1; // Deleted pixel count
+		while( count )
+		{
+			count = 0;
+			for( int j = 0; j < 4; j++ )
+			{
+				ThinningPass pass( &front[0], &back[0], size, g_masks[j] );
+				tbb::parallel_reduce( tbb::blocked_range<int>( 0, size.y ), pass );
+				count += pass.count();
+				front.swap( back );
+			}
+		}
+
+		for( size_t j = 0; j < channel.size(); j++ )
+		{
+			channel[j] = front[j] ? 1.0f : 0.0f;
+		}
+	}
+}
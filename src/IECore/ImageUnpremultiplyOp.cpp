@@ -80,43 +80,6 @@ struct ImageUnpremultiplyOp::ToFloatVectorData
 	}
 };
 
-struct ImageUnpremultiplyOp::UnpremultFn
-{
-	typedef void ReturnType;
-
-	const FloatVectorData * m_alphaChannel;
-
-	UnpremultFn( const FloatVectorData * alphaChannel ) : m_alphaChannel( alphaChannel )
-	{
-		assert( m_alphaChannel );
-	}
-
-	template<typename T>
-	ReturnType operator()( T *dataPtr )
-	{
-		typedef typename T::ValueType Container;
-		typedef typename Container::value_type ValueType;
-
-		ScaledDataConversion< ValueType, float > toFloat;
-		ScaledDataConversion< float, ValueType > fromFloat;
-
-		FloatVectorData::ValueType::const_iterator alphaIt = m_alphaChannel->readable().begin();
-
-		Container &data = dataPtr->writable();
-		for ( typename Container::iterator it = data.begin(); it != data.end(); ++it, ++alphaIt )
-		{
-			float channelValue = toFloat( *it );
-
-			if ( fabsf(*alphaIt) > 0.0f )
-			{
-				channelValue /= *alphaIt;
-			}
-
-			*it = fromFloat( channelValue );
-		}
-	}
-};
-
 void ImageUnpremultiplyOp::modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels )
 {
 	const std::string &alphaChannelName = m_alphaChannelNameParameter->getTypedValue();
@@ -136,11 +99,35 @@ void ImageUnpremultiplyOp::modifyChannels( const Imath::Box2i &displayWindow, co
 		throw InvalidArgumentException( "ImageUnpremultiplyOp: Cannot find specified alpha channel" );
 	}
 
-	FloatVectorDataPtr alphaData = despatchTypedData< ToFloatVectorData, TypeTraits::IsNumericVectorTypedData >( it->second.data.get() );
+	m_alphaData = despatchTypedData< ToFloatVectorData, TypeTraits::IsNumericVectorTypedData >( it->second.data.get() );
+
+	try
+	{
+		ChannelOp::modifyChannels( displayWindow, dataWindow, channels );
+	}
+	catch( ... )
+	{
+		m_alphaData = 0;
+		throw;
+	}
+	m_alphaData = 0;
+}
+
+void ImageUnpremultiplyOp::modifyTile( const Imath::Box2i &dataWindow, const Imath::Box2i &tile, const std::vector<float *> &channels ) const
+{
+	const int width = dataWindow.size().x + 1;
+	const size_t numPixels = width * ( tile.size().y + 1 );
+	const float *alpha = &m_alphaData->readable()[ ( tile.min.y - dataWindow.min.y ) * width ];
 
-	ImageUnpremultiplyOp::UnpremultFn fn( alphaData.get() );
-	for ( ChannelVector::iterator it = channels.begin(); it != channels.end(); it++ )
+	for( std::vector<float *>::const_iterator it = channels.begin(); it != channels.end(); ++it )
 	{
-		despatchTypedData<ImageUnpremultiplyOp::UnpremultFn, TypeTraits::IsNumericVectorTypedData>( it->get(), fn );
+		float *channel = *it;
+		for( size_t i = 0; i < numPixels; ++i )
+		{
+			if( fabsf( alpha[i] ) > 0.0f )
+			{
+				channel[i] /= alpha[i];
+			}
+		}
 	}
 }
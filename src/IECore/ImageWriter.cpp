@@ -48,7 +48,7 @@ using namespace Imath;
 IE_CORE_DEFINERUNTIMETYPED( ImageWriter )
 
 ImageWriter::ImageWriter( const std::string &description ) :
-		Writer( description, ImagePrimitiveTypeId)
+		Writer( description, ImagePrimitiveTypeId), m_writingBlocks( false ), m_blockNumChannels( 0 )
 {
 	m_channelsParameter = new StringVectorParameter("channels", "The list of channels to write.  No list causes all channels to be written." );
 
@@ -86,6 +86,10 @@ ImageWriter::ImageWriter( const std::string &description ) :
 	parameters()->addParameter( m_rawChannelsParameter );
 }
 
+ImageWriter::~ImageWriter()
+{
+}
+
 StringVectorParameter * ImageWriter::channelNamesParameter()
 {
 	return m_channelsParameter.get();
@@ -171,6 +175,11 @@ void ImageWriter::doWrite( const CompoundObject *operands )
 		throw InvalidArgumentException( "ImageWriter: Invalid primitive variables on image" );
 	}
 
+	writeImagePrimitive( image, channels, operands );
+}
+
+void ImageWriter::writeImagePrimitive( ConstImagePrimitivePtr image, const std::vector<std::string> &channels, const CompoundObject *operands )
+{
 	Box2i dataWindow = image->getDataWindow();
 
 	std::string colorspace = operands->member< StringData >( "colorSpace" )->readable();
@@ -206,3 +215,157 @@ void ImageWriter::doWrite( const CompoundObject *operands )
 
 	writeImage( channels, image.get(), dataWindow );
 }
+
+void ImageWriter::beginImage( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const std::vector<std::string> &channelNames, const CompoundData *blindData )
+{
+	if( m_writingBlocks )
+	{
+		throw Exception( "ImageWriter : beginImage() called before endImage() was called for the previous image." );
+	}
+
+	if( dataWindow.isEmpty() )
+	{
+		throw InvalidArgumentException( "ImageWriter : Empty data window." );
+	}
+
+	// select the channels to write, in the same
+	// way as imageChannels() does for write().
+	const vector<string> &requested = m_channelsParameter->getTypedValue();
+	vector<string> names;
+	m_blockChannelIndices.clear();
+	if( !requested.size() )
+	{
+		names = channelNames;
+		for( size_t i = 0; i < channelNames.size(); ++i )
+		{
+			m_blockChannelIndices.push_back( i );
+		}
+	}
+	else
+	{
+		for( vector<string>::const_iterator it = requested.begin(); it != requested.end(); ++it )
+		{
+			vector<string>::const_iterator cIt = find( channelNames.begin(), channelNames.end(), *it );
+			if( cIt != channelNames.end() && find( names.begin(), names.end(), *it ) == names.end() )
+			{
+				names.push_back( *it );
+				m_blockChannelIndices.push_back( cIt - channelNames.begin() );
+			}
+		}
+	}
+
+	doBeginImage( displayWindow, dataWindow, names, blindData );
+
+	m_writingBlocks = true;
+	m_blockDataWindow = dataWindow;
+	m_blockNumChannels = channelNames.size();
+}
+
+void ImageWriter::writeBlock( const Imath::Box2i &box, const float *data, size_t dataSize )
+{
+	if( !m_writingBlocks )
+	{
+		throw Exception( "ImageWriter : writeBlock() called without a prior call to beginImage()." );
+	}
+
+	Box2i tmpBox = box;
+	tmpBox.extendBy( m_blockDataWindow );
+	if( box.isEmpty() || tmpBox != m_blockDataWindow )
+	{
+		throw InvalidArgumentException( "ImageWriter : The box is outside the image data window." );
+	}
+
+	const size_t numPixels = ( box.size().x + 1 ) * ( box.size().y + 1 );
+	if( dataSize != numPixels * m_blockNumChannels )
+	{
+		throw InvalidArgumentException( "ImageWriter : Invalid dataSize value." );
+	}
+
+	bool allChannels = m_blockChannelIndices.size() == m_blockNumChannels;
+	for( size_t i = 0; allChannels && i < m_blockChannelIndices.size(); ++i )
+	{
+		allChannels = m_blockChannelIndices[i] == i;
+	}
+
+	if( allChannels )
+	{
+		doWriteBlock( box, data );
+		return;
+	}
+
+	// only some of the channels are being written, so we
+	// must repack the data before passing it on.
+	const size_t numChannels = m_blockChannelIndices.size();
+	m_blockScratch.resize( numPixels * numChannels );
+	float *out = m_blockScratch.size() ? &m_blockScratch[0] : 0;
+	for( size_t i = 0; i < numPixels; ++i, data += m_blockNumChannels )
+	{
+		for( size_t c = 0; c < numChannels; ++c )
+		{
+			*out++ = data[m_blockChannelIndices[c]];
+		}
+	}
+	doWriteBlock( box, m_blockScratch.size() ? &m_blockScratch[0] : 0 );
+}
+
+void ImageWriter::endImage()
+{
+	if( !m_writingBlocks )
+	{
+		throw Exception( "ImageWriter : endImage() called without a prior call to beginImage()." );
+	}
+
+	m_writingBlocks = false;
+	m_blockScratch.clear();
+	doEndImage();
+}
+
+void ImageWriter::doBeginImage( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const std::vector<std::string> &channelNames, const CompoundData *blindData )
+{
+	m_blockImage = new ImagePrimitive( dataWindow, displayWindow );
+	for( vector<string>::const_iterator it = channelNames.begin(); it != channelNames.end(); ++it )
+	{
+		m_blockImage->createChannel<float>( *it );
+	}
+	if( blindData )
+	{
+		m_blockImage->blindData()->writable() = blindData->readable();
+	}
+	m_blockChannelNames = channelNames;
+}
+
+void ImageWriter::doWriteBlock( const Imath::Box2i &box, const float *data )
+{
+	assert( m_blockImage );
+
+	const Box2i &dataWindow = m_blockImage->getDataWindow();
+	const size_t numChannels = m_blockChannelNames.size();
+	const int sourceWidth = box.size().x + 1;
+	const int sourceHeight = box.size().y + 1;
+	const int targetWidth = dataWindow.size().x + 1;
+
+	for( size_t c = 0; c < numChannels; ++c )
+	{
+		vector<float> &target = boost::static_pointer_cast<FloatVectorData>( m_blockImage->variables[m_blockChannelNames[c]].data )->writable();
+		const float *source = data + c;
+		for( int y = 0; y < sourceHeight; ++y )
+		{
+			float *targetRow = &target[( box.min.y - dataWindow.min.y + y ) * targetWidth + box.min.x - dataWindow.min.x];
+			for( int x = 0; x < sourceWidth; ++x, source += numChannels )
+			{
+				targetRow[x] = *source;
+			}
+		}
+	}
+}
+
+void ImageWriter::doEndImage()
+{
+	assert( m_blockImage );
+
+	ConstImagePrimitivePtr image = m_blockImage;
+	m_blockImage = 0;
+
+	const CompoundObject *operands = static_cast<const CompoundObject *>( parameters()->getValue() );
+	writeImagePrimitive( image, m_blockChannelNames, operands );
+}
@@ -0,0 +1,130 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/algorithm/string/predicate.hpp"
+
+#include "IECore/ImageWriterDisplayDriver.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/MessageHandler.h"
+
+using namespace boost;
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+
+IE_CORE_DEFINERUNTIMETYPED( ImageWriterDisplayDriver );
+
+const DisplayDriver::DisplayDriverDescription<ImageWriterDisplayDriver> ImageWriterDisplayDriver::g_description;
+
+ImageWriterDisplayDriver::ImageWriterDisplayDriver( const Box2i &displayWindow, const Box2i &dataWindow, const vector<string> &channelNames, ConstCompoundDataPtr parameters ) :
+		DisplayDriver( displayWindow, dataWindow, channelNames, parameters ), m_open( false )
+{
+	ConstStringDataPtr fileName = parameters ? parameters->member<StringData>( "fileName" ) : 0;
+	if( !fileName )
+	{
+		throw InvalidArgumentException( "ImageWriterDisplayDriver : No \"fileName\" parameter specified." );
+	}
+
+	m_writer = runTimeCast<ImageWriter>( Writer::create( fileName->readable() ) );
+	if( !m_writer )
+	{
+		throw InvalidArgumentException( "ImageWriterDisplayDriver : \"" + fileName->readable() + "\" is not an image file." );
+	}
+
+	// Add all entries that follow our 'header:' metadata convention to the blindData.
+	// Other entries are omitted.
+	CompoundDataPtr blindData = new CompoundData;
+	const CompoundDataMap &p = parameters->readable();
+	for( CompoundDataMap::const_iterator it = p.begin(); it != p.end(); ++it )
+	{
+		if( starts_with( it->first.string(), "header:" ) )
+		{
+			blindData->writable()[ it->first.string().substr( 7 ) ] = it->second->copy();
+		}
+	}
+
+	m_writer->beginImage( displayWindow, dataWindow, channelNames, blindData.get() );
+	m_open = true;
+}
+
+ImageWriterDisplayDriver::~ImageWriterDisplayDriver()
+{
+	if( m_open )
+	{
+		// make sure we leave a valid file behind, even
+		// if the image was never closed.
+		try
+		{
+			m_writer->endImage();
+		}
+		catch( const std::exception &e )
+		{
+			msg( Msg::Error, "ImageWriterDisplayDriver", e.what() );
+		}
+	}
+}
+
+bool ImageWriterDisplayDriver::scanLineOrderOnly() const
+{
+	return false;
+}
+
+bool ImageWriterDisplayDriver::acceptsRepeatedData() const
+{
+	return false;
+}
+
+void ImageWriterDisplayDriver::imageData( const Box2i &box, const float *data, size_t dataSize )
+{
+	if( !m_open )
+	{
+		throw Exception( "ImageWriterDisplayDriver : imageData() called after imageClose()." );
+	}
+	m_writer->writeBlock( box, data, dataSize );
+}
+
+void ImageWriterDisplayDriver::imageClose()
+{
+	if( !m_open )
+	{
+		return;
+	}
+	m_open = false;
+	m_writer->endImage();
+}
+
+ConstImageWriterPtr ImageWriterDisplayDriver::writer() const
+{
+	return m_writer;
+}
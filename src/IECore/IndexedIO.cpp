@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <math.h>
+#include <string.h>
 #include <iostream>
 
 #include "boost/filesystem/convenience.hpp"
@@ -104,7 +105,7 @@ void IndexedIO::validateOpenMode(IndexedIO::OpenMode &mode)
 {
 	// Clear 'other' bits
 	mode &= IndexedIO::Read | IndexedIO::Write | IndexedIO::Append
-			| IndexedIO::Shared | IndexedIO::Exclusive;
+			| IndexedIO::Shared | IndexedIO::Exclusive | IndexedIO::MemoryMapped | IndexedIO::LazyIndex;
 
 	// Check for mutual exclusivity
 	if ((mode & IndexedIO::Shared)
@@ -119,6 +120,13 @@ void IndexedIO::validateOpenMode(IndexedIO::OpenMode &mode)
 		throw InvalidArgumentException("Incorrect IndexedIO open mode specified");
 	}
 
+	// Memory mapping and lazy loading are only supported for reading
+	if ((mode & (IndexedIO::MemoryMapped | IndexedIO::LazyIndex))
+		&& (mode & (IndexedIO::Write | IndexedIO::Append)))
+	{
+		throw InvalidArgumentException("Incorrect IndexedIO open mode specified");
+	}
+
 	// Set up default as 'read'
 	if (!(mode & IndexedIO::Read
 		|| mode & IndexedIO::Write
@@ -137,6 +145,124 @@ void IndexedIO::validateOpenMode(IndexedIO::OpenMode &mode)
 
 }
 
+//
+// Arrays
+//
+
+namespace
+{
+
+template<typename T>
+struct ArrayWriter
+{
+	static void apply( IndexedIO *io, const IndexedIO::Array &array )
+	{
+		io->write( array.name, static_cast<const T *>( array.data ), array.arrayLength );
+	}
+};
+
+template<typename T>
+struct ArrayReader
+{
+	static void apply( const IndexedIO *io, const IndexedIO::Array &array )
+	{
+		T *data = static_cast<T *>( array.data );
+		io->read( array.name, data, array.arrayLength );
+	}
+};
+
+template<template<typename> class F, typename IO>
+void dispatchArray( IO *io, const IndexedIO::Array &array )
+{
+	switch( array.dataType )
+	{
+		case IndexedIO::FloatArray :
+			F<float>::apply( io, array );
+			break;
+		case IndexedIO::DoubleArray :
+			F<double>::apply( io, array );
+			break;
+		case IndexedIO::HalfArray :
+			F<half>::apply( io, array );
+			break;
+		case IndexedIO::IntArray :
+			F<int>::apply( io, array );
+			break;
+		case IndexedIO::Int64Array :
+			F<int64_t>::apply( io, array );
+			break;
+		case IndexedIO::UInt64Array :
+			F<uint64_t>::apply( io, array );
+			break;
+		case IndexedIO::UIntArray :
+			F<unsigned int>::apply( io, array );
+			break;
+		case IndexedIO::CharArray :
+			F<char>::apply( io, array );
+			break;
+		case IndexedIO::UCharArray :
+			F<unsigned char>::apply( io, array );
+			break;
+		case IndexedIO::ShortArray :
+			F<short>::apply( io, array );
+			break;
+		case IndexedIO::UShortArray :
+			F<unsigned short>::apply( io, array );
+			break;
+		default :
+			throw IOException( "IndexedIO: Unsupported data type for array entry '" + array.name.value() + "'" );
+	}
+}
+
+} // namespace
+
+IndexedIO::Array::Array()
+	:	dataType( IndexedIO::Invalid ), data( 0 ), arrayLength( 0 ), elementSize( 0 )
+{
+}
+
+void IndexedIO::writeArrays( const ArrayList &arrays )
+{
+	for( ArrayList::const_iterator it = arrays.begin(); it != arrays.end(); ++it )
+	{
+		dispatchArray<ArrayWriter>( this, *it );
+	}
+}
+
+void IndexedIO::readArrays( const ArrayList &arrays ) const
+{
+	for( ArrayList::const_iterator it = arrays.begin(); it != arrays.end(); ++it )
+	{
+		dispatchArray<ArrayReader>( this, *it );
+	}
+}
+
+void IndexedIO::readArrayRange( const Array &array, unsigned long begin ) const
+{
+	const Entry e = entry( array.name );
+	if( e.entryType() != IndexedIO::File || e.dataType() != array.dataType )
+	{
+		throw IOException( "IndexedIO: Unexpected data type for array entry '" + array.name.value() + "'" );
+	}
+	if( begin + array.arrayLength > e.arrayLength() )
+	{
+		throw IOException( "IndexedIO: Range out of bounds for array entry '" + array.name.value() + "'" );
+	}
+
+	if( !array.arrayLength )
+	{
+		return;
+	}
+
+	std::vector<char> buffer( e.arrayLength() * array.elementSize );
+	Array whole = array;
+	whole.data = &buffer[0];
+	whole.arrayLength = e.arrayLength();
+	dispatchArray<ArrayReader>( this, whole );
+
+	memcpy( array.data, &buffer[begin * array.elementSize], array.arrayLength * array.elementSize );
+}
+
 //
 // Entry
 //
@@ -0,0 +1,211 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/format.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "IECore/InstancerAlgo.h"
+#include "IECore/VectorTypedData.h"
+#include "IECore/Exception.h"
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+
+namespace
+{
+
+const vector<V3f> &positions( const PrimitiveVariableMap &primVars )
+{
+	PrimitiveVariableMap::const_iterator it = primVars.find( "P" );
+	const V3fVectorData *p = it != primVars.end() ? runTimeCast<const V3fVectorData>( it->second.data.get() ) : 0;
+	if( !p )
+	{
+		throw InvalidArgumentException( "InstancerAlgo : Instancer requires V3fVectorData \"P\" primitive variable." );
+	}
+	return p->readable();
+}
+
+// Returns the optional primitive variable of the specified type,
+// or 0 if it doesn't exist or has another type.
+template<typename T>
+const typename T::ValueType *primitiveVariable( const PrimitiveVariableMap &primVars, const char *name, size_t numPoints )
+{
+	PrimitiveVariableMap::const_iterator it = primVars.find( name );
+	if( it == primVars.end() )
+	{
+		return 0;
+	}
+
+	const T *data = runTimeCast<const T>( it->second.data.get() );
+	if( !data )
+	{
+		return 0;
+	}
+
+	if( data->readable().size() != numPoints )
+	{
+		throw InvalidArgumentException( boost::str( boost::format( "InstancerAlgo : Primitive variable \"%s\" has %d elements but there are %d points." ) % name % data->readable().size() % numPoints ) );
+	}
+
+	return &data->readable();
+}
+
+// Computes the scale, then rotate, then translate
+// transform of each point.
+class TransformComputer
+{
+
+	public :
+
+		TransformComputer( const vector<V3f> &p, const vector<Quatf> *orientation, const vector<V3f> *scale, const vector<float> *uniformScale, vector<M44f> &transforms )
+			:	m_p( p ), m_orientation( orientation ), m_scale( scale ), m_uniformScale( uniformScale ), m_transforms( transforms )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				M44f m;
+				if( m_orientation )
+				{
+					m = (*m_orientation)[i].normalized().toMatrix44();
+				}
+
+				if( m_scale )
+				{
+					m = M44f().scale( (*m_scale)[i] ) * m;
+				}
+				else if( m_uniformScale )
+				{
+					m = M44f().scale( V3f( (*m_uniformScale)[i] ) ) * m;
+				}
+
+				const V3f &p = m_p[i];
+				m[3][0] = p.x;
+				m[3][1] = p.y;
+				m[3][2] = p.z;
+
+				m_transforms[i] = m;
+			}
+		}
+
+	private :
+
+		const vector<V3f> &m_p;
+		const vector<Quatf> *m_orientation;
+		const vector<V3f> *m_scale;
+		const vector<float> *m_uniformScale;
+		vector<M44f> &m_transforms;
+
+};
+
+} // namespace
+
+const std::vector<std::string> &InstancerAlgo::prototypes( const CompoundDataMap &topology )
+{
+	CompoundDataMap::const_iterator it = topology.find( "prototypes" );
+	const StringVectorData *prototypes = it != topology.end() ? runTimeCast<const StringVectorData>( it->second.get() ) : 0;
+	if( !prototypes )
+	{
+		throw InvalidArgumentException( "InstancerAlgo : Instancer requires StringVectorData \"prototypes\" topology." );
+	}
+	return prototypes->readable();
+}
+
+void InstancerAlgo::prototypeIndices( const PrimitiveVariableMap &primVars, size_t numPrototypes, std::vector<int> &indices )
+{
+	const size_t numPoints = positions( primVars ).size();
+	const vector<int> *prototypeIndex = primitiveVariable<IntVectorData>( primVars, "prototypeIndex", numPoints );
+	if( !prototypeIndex )
+	{
+		if( numPoints && !numPrototypes )
+		{
+			throw InvalidArgumentException( "InstancerAlgo : Instancer has no prototypes." );
+		}
+		indices.assign( numPoints, 0 );
+		return;
+	}
+
+	for( vector<int>::const_iterator it = prototypeIndex->begin(), eIt = prototypeIndex->end(); it != eIt; ++it )
+	{
+		if( *it < 0 || (size_t)*it >= numPrototypes )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "InstancerAlgo : Prototype index %d is out of range." ) % *it ) );
+		}
+	}
+
+	indices = *prototypeIndex;
+}
+
+void InstancerAlgo::transforms( const PrimitiveVariableMap &primVars, std::vector<Imath::M44f> &transforms )
+{
+	const vector<V3f> &p = positions( primVars );
+	transforms.resize( p.size() );
+
+	if( const vector<M44f> *instanceTransform = primitiveVariable<M44fVectorData>( primVars, "instanceTransform", p.size() ) )
+	{
+		transforms = *instanceTransform;
+		return;
+	}
+
+	TransformComputer computer(
+		p,
+		primitiveVariable<QuatfVectorData>( primVars, "orientation", p.size() ),
+		primitiveVariable<V3fVectorData>( primVars, "scale", p.size() ),
+		primitiveVariable<FloatVectorData>( primVars, "scale", p.size() ),
+		transforms
+	);
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, p.size() ), computer );
+}
+
+void InstancerAlgo::render( const CompoundDataMap &topology, const PrimitiveVariableMap &primVars, Renderer *renderer )
+{
+	const vector<string> &names = prototypes( topology );
+	vector<int> indices;
+	prototypeIndices( primVars, names.size(), indices );
+	vector<M44f> matrices;
+	transforms( primVars, matrices );
+
+	for( size_t i = 0, e = indices.size(); i < e; ++i )
+	{
+		renderer->transformBegin();
+			renderer->concatTransform( matrices[i] );
+			renderer->instance( names[indices[i]] );
+		renderer->transformEnd();
+	}
+}
@@ -34,6 +34,8 @@
 
 #include <string.h>
 
+#include <vector>
+
 #include "tbb/spin_rw_mutex.h"
 #include "tbb/concurrent_hash_map.h"
 
@@ -53,6 +55,48 @@ namespace Detail
 // represent non-null-terminated strings.
 typedef std::pair<const char *, const char *> CharRange;
 
+// MurmurHash64A, by Austin Appleby, which is placed in the public domain.
+// This has a much better distribution than the DJB hash we used previously,
+// which is important both for the buckets of each HashSet and the choice of
+// Shard below.
+inline size_t hashRange( const char *s, size_t length )
+{
+	const uint64_t m = 0xc6a4a7935bd1e995ULL;
+	const int r = 47;
+
+	uint64_t h = 0x8445d61a4e774912ULL ^ ( length * m );
+
+	const char *end = s + ( length & ~size_t( 7 ) );
+	for( ; s != end; s += 8 )
+	{
+		uint64_t k;
+		memcpy( &k, s, 8 );
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+
+	switch( length & 7 )
+	{
+		case 7 : h ^= uint64_t( (unsigned char)s[6] ) << 48;
+		case 6 : h ^= uint64_t( (unsigned char)s[5] ) << 40;
+		case 5 : h ^= uint64_t( (unsigned char)s[4] ) << 32;
+		case 4 : h ^= uint64_t( (unsigned char)s[3] ) << 24;
+		case 3 : h ^= uint64_t( (unsigned char)s[2] ) << 16;
+		case 2 : h ^= uint64_t( (unsigned char)s[1] ) << 8;
+		case 1 : h ^= uint64_t( (unsigned char)s[0] );
+			h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+}
+
 // Hash for strings of various types.
 // By overloading it for multiple types, we are able to do
 // lookups into HashSet using any type as a key, and without
@@ -61,32 +105,19 @@ typedef std::pair<const char *, const char *> CharRange;
 struct Hash
 {
 
-	// Dan Bernstein's original string hash
 	size_t operator()( const char *s ) const
 	{
-		size_t hash = 5381;
-		while( *s )
-		{
-			hash = ( ( hash << 5 ) + hash ) + *s++;
-		}
-
-		return hash;
+		return hashRange( s, strlen( s ) );
 	}
 
 	size_t operator()( const std::string &s ) const
 	{
-		return (*this)( s.c_str() );
+		return hashRange( s.c_str(), s.size() );
 	}
 
 	size_t operator()( const CharRange &range ) const
 	{
-		size_t hash = 5381;
-		for( const char *s = range.first; s != range.second; ++s )
-		{
-			hash = ( ( hash << 5 ) + hash ) + *s;
-		}
-
-		return hash;
+		return hashRange( range.first, range.second - range.first );
 	}
 
 };
@@ -103,26 +134,36 @@ struct Equal
 		return s1 == s2;
 	}
 
-	bool operator()( const char *c, const std::string &s ) const
+	bool operator()( const CharRange &c, const std::string &s ) const
 	{
-		return strcmp( c, s.c_str() )==0;
+		return s.compare( 0, std::string::npos, c.first, c.second - c.first )==0;
 	}
 
-	bool operator()( const std::string &s, const char *c ) const
+	bool operator()( const std::string &s, const CharRange &c ) const
 	{
-		return strcmp( c, s.c_str() )==0;
+		return s.compare( 0, std::string::npos, c.first, c.second - c.first )==0;
 	}
 
-	bool operator()( const CharRange &c, const std::string &s ) const
+};
+
+// Functor passing precomputed hashes to HashSet lookups, so
+// that we only hash each string once, despite using the hash
+// for both the choice of Shard and the lookup within it.
+struct PrecomputedHash
+{
+
+	PrecomputedHash( size_t hash )
+		:	hash( hash )
 	{
-		return s.compare( 0, std::string::npos, c.first, c.second - c.first )==0;
 	}
 
-	bool operator()( const std::string &s, const CharRange &c ) const
+	size_t operator()( const CharRange &range ) const
 	{
-		return s.compare( 0, std::string::npos, c.first, c.second - c.first )==0;
+		return hash;
 	}
 
+	size_t hash;
+
 };
 
 typedef boost::multi_index::multi_index_container<
@@ -137,62 +178,151 @@ typedef boost::multi_index::multi_index_container<
 > HashSet;
 
 typedef HashSet::nth_index<0>::type Index;
-typedef HashSet::nth_index_const_iterator<0>::type ConstIterator;
 typedef tbb::spin_rw_mutex Mutex;
 
-static HashSet *hashSet()
+// Rather than a single HashSet, we use many, each protected by its own
+// mutex, and choose between them using the hash of the string. This
+// greatly reduces contention when many threads are interning strings
+// at once. We align the shards so that the mutexes don't share cache
+// lines.
+struct Shard
 {
-	static HashSet g_hashSet;
-	return &g_hashSet;
-}
+	Mutex mutex;
+	HashSet hashSet;
+	char padding[64];
+};
+
+enum { NumShardBits = 6, NumShards = 1 << NumShardBits };
 
-static Mutex *mutex()
+static Shard *shards()
 {
-	static Detail::Mutex g_mutex;
-	return &g_mutex;
+	static Shard g_shards[NumShards];
+	return g_shards;
 }
 
-} // namespace Detail
+inline size_t shardIndex( size_t hash )
+{
+	// The HashSet buckets are chosen using the low bits of the hash,
+	// so we use the high bits to choose the shard.
+	return hash >> ( sizeof( size_t ) * 8 - NumShardBits );
+}
 
-const std::string *InternedString::internedString( const char *value )
+// Finds or inserts the string with the specified hash. The caller must
+// hold a lock on the shard, and specify whether or not it is a write
+// lock. It is upgraded to a write lock if necessary.
+static const std::string *internedString( Shard &shard, const CharRange &range, size_t hash, Mutex::scoped_lock &lock, bool &writer )
 {
-	Detail::HashSet *hashSet = Detail::hashSet();
-	Detail::Index &hashIndex = hashSet->get<0>();
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet::const_iterator it = hashIndex.find( value );
-	if( it!=hashIndex.end() )
+	Index &index = shard.hashSet.get<0>();
+	Index::const_iterator it = index.find( range, PrecomputedHash( hash ), Equal() );
+	if( it != index.end() )
 	{
 		return &(*it);
 	}
-	else
+
+	if( !writer )
 	{
 		lock.upgrade_to_writer();
-		return &(*(hashSet->insert( std::string( value ) ).first ) );
+		writer = true;
 	}
+	return &(*( shard.hashSet.insert( std::string( range.first, range.second - range.first ) ).first ) );
+}
+
+static const std::string *internedString( const CharRange &range )
+{
+	const size_t hash = Hash()( range );
+	Shard &shard = shards()[shardIndex( hash )];
+	Mutex::scoped_lock lock( shard.mutex, false ); // read-only lock
+	bool writer = false;
+	return internedString( shard, range, hash, lock, writer );
+}
+
+} // namespace Detail
+
+const std::string *InternedString::internedString( const char *value )
+{
+	return Detail::internedString( Detail::CharRange( value, value + strlen( value ) ) );
 }
 
 const std::string *InternedString::internedString( const char *value, size_t length )
 {
-	Detail::HashSet *hashSet = Detail::hashSet();
-	Detail::Index &hashIndex = hashSet->get<0>();
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet::const_iterator it = hashIndex.find( Detail::CharRange( value, value + length ) );
-	if( it!=hashIndex.end() )
+	return Detail::internedString( Detail::CharRange( value, value + length ) );
+}
+
+void InternedString::intern( size_t count, const char * const *values, const size_t *lengths, InternedString *result )
+{
+	// Group the strings by shard, so we can intern all the
+	// strings for each shard while holding the mutex only once.
+
+	std::vector<size_t> hashes( count );
+	std::vector<size_t> shardCounts( Detail::NumShards + 1, 0 );
+	for( size_t i = 0; i < count; ++i )
 	{
-		return &(*it);
+		hashes[i] = Detail::Hash()( Detail::CharRange( values[i], values[i] + lengths[i] ) );
+		shardCounts[Detail::shardIndex( hashes[i] ) + 1]++;
 	}
-	else
+
+	for( size_t i = 1; i <= Detail::NumShards; ++i )
 	{
-		lock.upgrade_to_writer();
-		return &(*(hashSet->insert( std::string( value, length ) ).first ) );
+		shardCounts[i] += shardCounts[i-1];
+	}
+
+	std::vector<size_t> order( count );
+	std::vector<size_t> shardEnds( shardCounts.begin(), shardCounts.end() - 1 );
+	for( size_t i = 0; i < count; ++i )
+	{
+		order[shardEnds[Detail::shardIndex( hashes[i] )]++] = i;
+	}
+
+	Detail::Shard *shards = Detail::shards();
+	for( size_t s = 0; s < Detail::NumShards; ++s )
+	{
+		const size_t begin = shardCounts[s];
+		const size_t end = shardCounts[s+1];
+		if( begin == end )
+		{
+			continue;
+		}
+
+		Detail::Mutex::scoped_lock lock( shards[s].mutex, false ); // read-only lock
+		bool writer = false;
+		for( size_t j = begin; j < end; ++j )
+		{
+			const size_t i = order[j];
+			result[i].m_value = Detail::internedString(
+				shards[s], Detail::CharRange( values[i], values[i] + lengths[i] ), hashes[i], lock, writer
+			);
+		}
+	}
+}
+
+void InternedString::intern( const std::vector<std::string> &values, std::vector<InternedString> &result )
+{
+	const size_t count = values.size();
+	std::vector<const char *> chars( count );
+	std::vector<size_t> lengths( count );
+	for( size_t i = 0; i < count; ++i )
+	{
+		chars[i] = values[i].c_str();
+		lengths[i] = values[i].size();
+	}
+
+	result.resize( count );
+	if( count )
+	{
+		intern( count, &chars[0], &lengths[0], &result[0] );
 	}
 }
 
 size_t InternedString::numUniqueStrings()
 {
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet *hashSet = Detail::hashSet();
-	return hashSet->size();
+	size_t result = 0;
+	Detail::Shard *shards = Detail::shards();
+	for( size_t s = 0; s < Detail::NumShards; ++s )
+	{
+		Detail::Mutex::scoped_lock lock( shards[s].mutex, false ); // read-only lock
+		result += shards[s].hashSet.size();
+	}
+	return result;
 }
 
 static InternedString g_emptyString("");
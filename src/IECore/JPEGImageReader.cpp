@@ -66,13 +66,15 @@ IE_CORE_DEFINERUNTIMETYPED( JPEGImageReader );
 const Reader::ReaderDescription <JPEGImageReader> JPEGImageReader::m_readerDescription ("jpeg jpg");
 
 JPEGImageReader::JPEGImageReader() :
-		ImageReader( "Reads Joint Photographic Experts Group (JPEG) files" )
+		ImageReader( "Reads Joint Photographic Experts Group (JPEG) files" ), m_bufferReduction( 0 )
 {
+	constructParameters();
 }
 
 JPEGImageReader::JPEGImageReader(const string & fileName) :
-		ImageReader( "Reads Joint Photographic Experts Group (JPEG) files" )
+		ImageReader( "Reads Joint Photographic Experts Group (JPEG) files" ), m_bufferReduction( 0 )
 {
+	constructParameters();
 	m_fileNameParameter->setTypedValue( fileName );
 }
 
@@ -80,6 +82,39 @@ JPEGImageReader::~JPEGImageReader()
 {
 }
 
+void JPEGImageReader::constructParameters()
+{
+	IntParameter::PresetsContainer reductionPresets;
+	reductionPresets.push_back( IntParameter::Preset( "Full", 1 ) );
+	reductionPresets.push_back( IntParameter::Preset( "Half", 2 ) );
+	reductionPresets.push_back( IntParameter::Preset( "Quarter", 4 ) );
+	reductionPresets.push_back( IntParameter::Preset( "Eighth", 8 ) );
+
+	m_reductionParameter = new IntParameter(
+		"reduction",
+		"Decodes the image at a reduced resolution, by this factor. This uses "
+		"the DCT scaling built into the JPEG decoder, so is much quicker than "
+		"decoding the full image and resizing it afterwards.",
+		1,
+		1,
+		8,
+		reductionPresets,
+		true
+	);
+
+	parameters()->addParameter( m_reductionParameter );
+}
+
+IntParameter *JPEGImageReader::reductionParameter()
+{
+	return m_reductionParameter.get();
+}
+
+const IntParameter *JPEGImageReader::reductionParameter() const
+{
+	return m_reductionParameter.get();
+}
+
 bool JPEGImageReader::canRead( const string &fileName )
 {
 	// attempt to open the file
@@ -138,72 +173,133 @@ std::string JPEGImageReader::sourceColorSpace() const
 	return "srgb";
 }
 
+namespace
+{
+
+// Converts bytes via a lookup table, which is considerably quicker
+// than the arithmetic in ScaledDataConversion.
 template<typename V>
-DataPtr JPEGImageReader::readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow, int channelOffset )
+class ByteConverter
 {
-	int area = ( dataWindow.size().x + 1 ) * ( dataWindow.size().y + 1 );
-	assert( area >= 0 );
-	int dataWidth = 1 + dataWindow.size().x;
-	int dataY = 0;
 
-	typedef TypedData< std::vector< V > > TargetVector;
-	
-	typename TargetVector::Ptr dataContainer = new TargetVector();
-	typename TargetVector::ValueType &data = dataContainer->writable();
-	data.resize( area );
+	public :
 
-	ScaledDataConversion< unsigned char, V> converter;
+		ByteConverter()
+		{
+			ScaledDataConversion<unsigned char, V> converter;
+			for( int i = 0; i < 256; ++i )
+			{
+				m_table[i] = converter( i );
+			}
+		}
 
-	for ( int y = dataWindow.min.y; y <= dataWindow.max.y; ++y, ++dataY )
-	{
-		typename TargetVector::ValueType::size_type dataOffset = dataY * dataWidth;
-		for ( int x = dataWindow.min.x; x <= dataWindow.max.x; ++x, ++dataOffset )
+		V operator()( unsigned char c ) const
 		{
-			assert( dataOffset < data.size() );
-			data[dataOffset] = converter( m_buffer[ m_numChannels * ( y * m_bufferWidth + x ) + channelOffset ] );
+			return m_table[c];
 		}
-	}
-	return dataContainer;
-}
 
-DataPtr JPEGImageReader::readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw )
-{
-	open( true );
+	private :
+
+		V m_table[256];
+
+};
 
-	int channelOffset = 0;
+} // namespace
+
+int JPEGImageReader::channelOffset( const std::string &name ) const
+{
+	int result = 0;
 	if ( name == "R" )
 	{
-		channelOffset = 0;
+		result = 0;
 	}
 	else if ( name == "G" )
 	{
-		channelOffset = 1;
+		result = 1;
 	}
 	else if ( name == "B" )
 	{
-		channelOffset = 2;
+		result = 2;
 	}
 	else if ( name == "Y" )
 	{
-		channelOffset = 0;
+		result = 0;
 	}
 	else
 	{
 		throw IOException( ( boost::format( "JPEGImageReader: Could not find channel \"%s\" while reading %s" ) % name % m_bufferFileName ).str() );
 	}
 
-	assert( channelOffset < m_numChannels );
+	assert( result < m_numChannels );
+	return result;
+}
+
+template<typename V>
+void JPEGImageReader::readTypedChannels( const std::vector<int> &channelOffsets, const Imath::Box2i &dataWindow, std::vector<DataPtr> &data )
+{
+	int area = ( dataWindow.size().x + 1 ) * ( dataWindow.size().y + 1 );
+	assert( area >= 0 );
+	int dataWidth = 1 + dataWindow.size().x;
+
+	typedef TypedData< std::vector< V > > TargetVector;
+
+	const size_t numChannels = channelOffsets.size();
+	std::vector<V *> outputs( numChannels );
+	for( size_t c = 0; c < numChannels; ++c )
+	{
+		typename TargetVector::Ptr dataContainer = new TargetVector();
+		dataContainer->writable().resize( area );
+		outputs[c] = &dataContainer->writable()[0];
+		data.push_back( dataContainer );
+	}
+
+	ByteConverter<V> converter;
+
+	// de-interleave all the requested channels in a single pass over the buffer
+	for ( int y = dataWindow.min.y; y <= dataWindow.max.y; ++y )
+	{
+		const unsigned char *row = &m_buffer[0] + m_numChannels * ( y * m_bufferWidth + dataWindow.min.x );
+		for( size_t c = 0; c < numChannels; ++c )
+		{
+			const unsigned char *in = row + channelOffsets[c];
+			V *out = outputs[c];
+			for( int x = 0; x < dataWidth; ++x )
+			{
+				out[x] = converter( in[x * m_numChannels] );
+			}
+			outputs[c] += dataWidth;
+		}
+	}
+}
+
+DataPtr JPEGImageReader::readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw )
+{
+	std::vector<std::string> names( 1, name );
+	std::vector<DataPtr> data;
+	readChannels( names, dataWindow, raw, data );
+	return data[0];
+}
+
+void JPEGImageReader::readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &data )
+{
+	open( true );
+
+	std::vector<int> channelOffsets;
+	for( std::vector<std::string>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+	{
+		channelOffsets.push_back( channelOffset( *it ) );
+	}
 
-	DataPtr dataContainer = NULL;
+	data.clear();
+	data.reserve( names.size() );
 	if ( raw )
 	{
-		dataContainer = readTypedChannel< unsigned char >( name, dataWindow, channelOffset );
+		readTypedChannels< unsigned char >( channelOffsets, dataWindow, data );
 	}
 	else
 	{
-		dataContainer = readTypedChannel< float >( name, dataWindow, channelOffset );
+		readTypedChannels< float >( channelOffsets, dataWindow, data );
 	}
-	return dataContainer;
 }
 
 struct JPEGReaderErrorHandler : public jpeg_error_mgr
@@ -224,12 +320,14 @@ struct JPEGReaderErrorHandler : public jpeg_error_mgr
 
 bool JPEGImageReader::open( bool throwOnFailure )
 {
-	if ( fileName() == m_bufferFileName )
+	const int reduction = m_reductionParameter->getNumericValue();
+	if ( fileName() == m_bufferFileName && reduction == m_bufferReduction )
 	{
 		return true;
 	}
 
 	m_bufferFileName = fileName();
+	m_bufferReduction = reduction;
 	m_buffer.clear();
 
 	FILE *inFile = 0;
@@ -267,6 +365,11 @@ bool JPEGImageReader::open( bool throwOnFailure )
 			jpeg_stdio_src( &cinfo, inFile );
 			jpeg_read_header( &cinfo, TRUE );
 
+			/// Let the decoder do any reduction, which is much
+			/// cheaper than decoding everything and resizing later.
+			cinfo.scale_num = 1;
+			cinfo.scale_denom = reduction;
+
 			/// Start decompression
 			jpeg_start_decompress( &cinfo );
 
@@ -296,11 +399,15 @@ bool JPEGImageReader::open( bool throwOnFailure )
 			m_bufferWidth = cinfo.output_width;
 			m_bufferHeight = cinfo.output_height;
 
-			/// Read scanlines one at a time.
+			/// Read as many scanlines as the decoder will give us at a time.
+			std::vector<JSAMPROW> rowPointers( cinfo.output_height );
+			for( unsigned int y = 0; y < cinfo.output_height; ++y )
+			{
+				rowPointers[y] = &m_buffer[0] + rowStride * y;
+			}
 			while (cinfo.output_scanline < cinfo.output_height)
 			{
-				unsigned char *rowPointer[1] = { &m_buffer[0] + rowStride * cinfo.output_scanline };
-				jpeg_read_scanlines( &cinfo, rowPointer, 1 );
+				jpeg_read_scanlines( &cinfo, &rowPointers[cinfo.output_scanline], cinfo.output_height - cinfo.output_scanline );
 			}
 
 			/// Finish decompression
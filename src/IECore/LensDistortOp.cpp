@@ -44,6 +44,13 @@
 #include "IECore/Interpolator.h"
 #include "IECore/TypeTraits.h"
 #include "IECore/DespatchTypedData.h"
+#include "IECore/ComputationCache.h"
+#include "IECore/CompoundData.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/VectorTypedData.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 using namespace boost;
 using namespace IECore;
@@ -96,27 +103,91 @@ const ObjectParameter * LensDistortOp::lensParameter() const
 	return m_lensParameter.get();
 }
 
-void LensDistortOp::begin( const CompoundObject * operands )
+namespace
+{
+
+// Fills the rows of the warp cache in parallel. Rows are stored
+// from the top of the distorted window downwards.
+class BuildCache
+{
+
+	public :
+
+		BuildCache( LensModel *lensModel, bool distort, const Imath::Box2i &distortedWindow, const Imath::Box2i &displayWindow, float *cache )
+			:	m_lensModel( lensModel ), m_distort( distort ), m_distortedWindow( distortedWindow ), m_cache( cache )
+		{
+			m_displayWH[0] = displayWindow.size().x + 1;
+			m_displayWH[1] = displayWindow.size().y + 1;
+			m_displayOrigin[0] = displayWindow.min[0];
+			m_displayOrigin[1] = displayWindow.min[1];
+		}
+
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			const int width = m_distortedWindow.size().x + 1;
+			for( int y = range.begin(); y != range.end(); ++y )
+			{
+				int pixelIndex = ( m_distortedWindow.max.y - y ) * width * 2;
+				for( int x = m_distortedWindow.min.x; x <= m_distortedWindow.max.x; ++x )
+				{
+					// Convert to UV space with the origin in the bottom left.
+					Imath::V2f p( Imath::V2f( x, y ) );
+					Imath::V2d uv( p[0] / m_displayWH[0], p[1] / m_displayWH[1] );
+
+					// Get the distorted uv coordinate.
+					Imath::V2d duv( m_distort ? m_lensModel->distort( uv ) : m_lensModel->undistort( uv ) );
+
+					// Transform it to image space.
+					p = Imath::V2f(
+						duv[0] * m_displayWH[0] + m_displayOrigin[0], ( ( m_displayWH[1] - 1. ) - ( duv[1] * m_displayWH[1] ) ) + m_displayOrigin[1]
+					);
+
+					m_cache[pixelIndex++] = p[0];
+					m_cache[pixelIndex++] = p[1];
+				}
+			}
+		}
+
+	private :
+
+		LensModel *m_lensModel;
+		bool m_distort;
+		Imath::Box2i m_distortedWindow;
+		double m_displayWH[2];
+		double m_displayOrigin[2];
+		float *m_cache;
+
+};
+
+// The warp map depends only on the lens parameters, the mode and the image
+// windows, so we cache it to avoid rebuilding it for every frame of a sequence.
+struct WarpMapArgs
+{
+	const CompoundObject *lensParameters;
+	int mode;
+	bool distort;
+	Imath::Box2i dataWindow;
+	Imath::Box2i displayWindow;
+};
+
+MurmurHash warpMapHash( const WarpMapArgs &args )
+{
+	MurmurHash h = args.lensParameters->hash();
+	h.append( args.mode );
+	h.append( args.dataWindow );
+	h.append( args.displayWindow );
+	return h;
+}
+
+ConstObjectPtr computeWarpMap( const WarpMapArgs &args )
 {
-	// Get the lens model parameters.
-	IECore::CompoundObjectPtr lensModelParams( runTimeCast<CompoundObject>( lensParameter()->getValue() ) );
-	
 	// Load the lens object.
-	m_lensModel = LensModel::create( lensModelParams );
-	m_lensModel->validate();
-	
-	// Get the distortion mode.
-	m_mode = m_modeParameter->getNumericValue();
-	
-	// Get our image information.
-	assert( runTimeCast< ImagePrimitive >(inputParameter()->getValue()) );
-	ImagePrimitive *inputImage = static_cast<ImagePrimitive *>( inputParameter()->getValue() );
-	
-	Imath::Box2i dataWindow( inputImage->getDataWindow() );
-	Imath::Box2i displayWindow( inputImage->getDisplayWindow() );
-	double displayWH[2] = { static_cast<double>( displayWindow.size().x + 1 ), static_cast<double>( displayWindow.size().y + 1 ) };
-	double displayOrigin[2] = { static_cast<double>( displayWindow.min[0] ), static_cast<double>( displayWindow.min[1] ) };
-	
+	LensModelPtr lensModel = LensModel::create( args.lensParameters );
+	lensModel->validate();
+
+	const Imath::Box2i &dataWindow = args.dataWindow;
+	const Imath::Box2i &displayWindow = args.displayWindow;
+
 	// Get the distorted window.
 	// As the LensModel::bounds() method requires that the display window has it's origin at (0,0) in the bottom left of the image and the IECore::ImagePrimitive has it's origin in the top left,
 	// convert to the correct image space and offset if by the display window's origin if it is non-zero.
@@ -126,41 +197,59 @@ void LensDistortOp::begin( const CompoundObject * operands )
 	);
 
 	// Calculate the distorted data window.
-	Imath::Box2i distortedWindow = m_lensModel->bounds( m_mode, distortionSpaceBox, ( displayWindow.size().x + 1 ), ( displayWindow.size().y + 1 ) );
+	Imath::Box2i distortedWindow = lensModel->bounds( args.mode, distortionSpaceBox, ( displayWindow.size().x + 1 ), ( displayWindow.size().y + 1 ) );
 
 	// Convert the distorted data window back to the same image space as IECore::ImagePrimitive.
-	m_distortedDataWindow =  Imath::Box2i( 
+	Imath::Box2i distortedDataWindow(
 		Imath::V2i( distortedWindow.min[0] + displayWindow.min[0], ( displayWindow.size().y - distortedWindow.max[1] ) + displayWindow.min[1] ),
 		Imath::V2i( distortedWindow.max[0] + displayWindow.min[0], ( displayWindow.size().y - distortedWindow.min[1] ) + displayWindow.min[1] )
 	);
-	
+
 	// Compute a 2D cache of the warped points for use in the warp() method.
-	IECore::FloatVectorDataPtr cachePtr = new IECore::FloatVectorData;
-	std::vector<float> &cache( cachePtr->writable() );
-	cache.resize( ( m_distortedDataWindow.size().x + 1 ) * ( m_distortedDataWindow.size().y + 1 ) * 2 ); // We interleave the X and Y vector components within the cache.
+	FloatVectorDataPtr warpData = new FloatVectorData;
+	std::vector<float> &warp( warpData->writable() );
+	warp.resize( ( distortedDataWindow.size().x + 1 ) * ( distortedDataWindow.size().y + 1 ) * 2 ); // We interleave the X and Y vector components within the cache.
 
-	for( int y = distortedWindow.max.y, pixelIndex = 0; y >= distortedWindow.min.y; --y )
-	{
-		for( int x = distortedWindow.min.x; x <= distortedWindow.max.x; ++x )
-		{
-			// Convert to UV space with the origin in the bottom left.	
-			Imath::V2f p( Imath::V2f( x, y ) );
-			Imath::V2d uv( p[0] / displayWH[0], p[1] / displayWH[1] );
+	tbb::parallel_for(
+		tbb::blocked_range<int>( distortedWindow.min.y, distortedWindow.max.y + 1 ),
+		BuildCache( lensModel.get(), args.distort, distortedWindow, displayWindow, &warp[0] )
+	);
 
-			// Get the distorted uv coordinate.
-			Imath::V2d duv( m_mode == kDistort ? m_lensModel->distort( uv ) : m_lensModel->undistort( uv ) );
+	CompoundDataPtr result = new CompoundData;
+	result->writable()["dataWindow"] = new Box2iData( distortedDataWindow );
+	result->writable()["warp"] = warpData;
+	return result;
+}
 
-			// Transform it to image space.
-			p = Imath::V2f(
-				duv[0] * displayWH[0] + displayOrigin[0], ( ( displayWH[1] - 1. ) - ( duv[1] * displayWH[1] ) ) + displayOrigin[1] 
-			);
+typedef ComputationCache<WarpMapArgs> WarpMapCache;
 
-			cache[pixelIndex++] = p[0];
-			cache[pixelIndex++] = p[1];
-		}
-	}
+WarpMapCache *warpMapCache()
+{
+	static WarpMapCache::Ptr c = new WarpMapCache( computeWarpMap, warpMapHash, 100 );
+	return c.get();
+}
+
+} // namespace
+
+void LensDistortOp::begin( const CompoundObject * operands )
+{
+	// Get the distortion mode.
+	m_mode = m_modeParameter->getNumericValue();
+
+	// Get our image information.
+	assert( runTimeCast< ImagePrimitive >(inputParameter()->getValue()) );
+	ImagePrimitive *inputImage = static_cast<ImagePrimitive *>( inputParameter()->getValue() );
+
+	WarpMapArgs args;
+	args.lensParameters = runTimeCast<CompoundObject>( lensParameter()->getValue() );
+	args.mode = m_mode;
+	args.distort = m_mode == kDistort;
+	args.dataWindow = inputImage->getDataWindow();
+	args.displayWindow = inputImage->getDisplayWindow();
 
-	m_cachePtr = cachePtr;
+	ConstCompoundDataPtr warpMap = boost::static_pointer_cast<const CompoundData>( warpMapCache()->get( args ) );
+	m_distortedDataWindow = warpMap->member<Box2iData>( "dataWindow" )->readable();
+	m_cachePtr = warpMap->member<FloatVectorData>( "warp" );
 }
 
 Imath::Box2i LensDistortOp::warpedDataWindow( const Imath::Box2i &dataWindow ) const
@@ -44,8 +44,169 @@
 #include "IECore/SimpleTypedData.h"
 #include "IECore/TypedObjectParameter.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Zeroes the unlocked weights below a minimum value, for a range of points.
+class WeightLimiter
+{
+
+	public :
+
+		WeightLimiter( float minWeight, const std::vector<bool> &locks, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, std::vector<float> &pointInfluenceWeights )
+			:	m_minWeight( minWeight ), m_locks( locks ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ),
+				m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				for ( int j=0; j < m_pointInfluenceCounts[i]; j++ )
+				{
+					int current = m_pointIndexOffsets[i] + j;
+
+					if ( !m_locks[ m_pointInfluenceIndices[current] ] && (m_pointInfluenceWeights[current] < m_minWeight) )
+					{
+						m_pointInfluenceWeights[current] = 0.0f;
+					}
+				}
+			}
+		}
+
+	private :
+
+		float m_minWeight;
+		const std::vector<bool> &m_locks;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+// Zeroes the smallest unlocked weights of each point in a range, so
+// that no more than maxInfluences remain.
+class MaxInfluencesLimiter
+{
+
+	public :
+
+		MaxInfluencesLimiter( int maxInfluences, const std::vector<bool> &locks, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, std::vector<float> &pointInfluenceWeights )
+			:	m_maxInfluences( maxInfluences ), m_locks( locks ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ),
+				m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			std::vector<int> influencesToLimit;
+
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				int numToLimit = m_pointInfluenceCounts[i] - m_maxInfluences;
+				if ( numToLimit <= 0 )
+				{
+					continue;
+				}
+
+				influencesToLimit.clear();
+
+				for ( int j=0; j < numToLimit; j++ )
+				{
+					int indexOfMin = -1;
+					float minWeight = Imath::limits<float>::max();
+
+					for ( int k=0; k < m_pointInfluenceCounts[i]; k++ )
+					{
+						int current = m_pointIndexOffsets[i] + k;
+
+						if ( m_locks[ m_pointInfluenceIndices[current] ] || find( influencesToLimit.begin(), influencesToLimit.end(), current ) != influencesToLimit.end() )
+						{
+							continue;
+						}
+
+						float weight = m_pointInfluenceWeights[current];
+
+						if ( weight < minWeight )
+						{
+							minWeight = weight;
+							indexOfMin = current;
+						}
+					}
+
+					if ( indexOfMin == -1 )
+					{
+						break;
+					}
+
+					influencesToLimit.push_back( indexOfMin );
+				}
+
+				for ( unsigned j=0; j < influencesToLimit.size(); j++ )
+				{
+					m_pointInfluenceWeights[ influencesToLimit[j] ] = 0.0f;
+				}
+			}
+		}
+
+	private :
+
+		int m_maxInfluences;
+		const std::vector<bool> &m_locks;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+// Zeroes the weights for specific influences, for a range of points.
+class IndexedLimiter
+{
+
+	public :
+
+		IndexedLimiter( const std::vector<bool> &limitIndex, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, std::vector<float> &pointInfluenceWeights )
+			:	m_limitIndex( limitIndex ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ),
+				m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				for ( int j=0; j < m_pointInfluenceCounts[i]; j++ )
+				{
+					int current = m_pointIndexOffsets[i] + j;
+
+					if ( m_limitIndex[ m_pointInfluenceIndices[current] ] )
+					{
+						m_pointInfluenceWeights[current] = 0.0f;
+					}
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<bool> &m_limitIndex;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( LimitSmoothSkinningInfluencesOp );
 
 LimitSmoothSkinningInfluencesOp::LimitSmoothSkinningInfluencesOp()
@@ -149,76 +310,27 @@ void LimitSmoothSkinningInfluencesOp::modify( Object * object, const CompoundObj
 		locks.resize( skinningData->influenceNames()->readable().size(), false );
 	}
 	
+	const tbb::blocked_range<size_t> pointRange( 0, pointIndexOffsets.size(), 1024 );
+	
 	// Limit influences based on minumum allowable weight
 	if ( mode == LimitSmoothSkinningInfluencesOp::WeightLimit )
 	{
 		float minWeight = m_minWeightParameter->getNumericValue();
 		
-		for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
-		{
-			for ( int j=0; j < pointInfluenceCounts[i]; j++ )
-			{
-				int current = pointIndexOffsets[i] + j;
-				
-				if ( !locks[ pointInfluenceIndices[current] ] && (pointInfluenceWeights[current] < minWeight) )
-				{
-					pointInfluenceWeights[current] = 0.0f;
-				}
-			}
-		}
+		tbb::parallel_for(
+			pointRange,
+			WeightLimiter( minWeight, locks, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights )
+		);
 	}
 	// Limit the number of influences per point
 	else if ( mode == LimitSmoothSkinningInfluencesOp::MaxInfluences )
 	{
 		int maxInfluences = m_maxInfluencesParameter->getNumericValue();
-		std::vector<int> influencesToLimit;
 		
-		for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
-		{
-			int numToLimit = pointInfluenceCounts[i] - maxInfluences;
-			if ( numToLimit <= 0 )
-			{
-				continue;
-			}
-			
-			influencesToLimit.clear();
-			
-			for ( int j=0; j < numToLimit; j++ )
-			{				
-				int indexOfMin = -1;
-				float minWeight = Imath::limits<float>::max();
-				
-				for ( int k=0; k < pointInfluenceCounts[i]; k++ )
-				{
-					int current = pointIndexOffsets[i] + k;
-					
-					if ( locks[ pointInfluenceIndices[current] ] || find( influencesToLimit.begin(), influencesToLimit.end(), current ) != influencesToLimit.end() )
-					{
-						continue;
-					}
-					
-					float weight = pointInfluenceWeights[current];
-					
-					if ( weight < minWeight )
-					{
-						minWeight = weight;
-						indexOfMin = current;
-					}
-				}
-				
-				if ( indexOfMin == -1 )
-				{
-					break;
-				}
-				
-				influencesToLimit.push_back( indexOfMin );
-			}
-			
-			for ( unsigned j=0; j < influencesToLimit.size(); j++ )
-			{
-				pointInfluenceWeights[ influencesToLimit[j] ] = 0.0f;
-			}
-		}
+		tbb::parallel_for(
+			pointRange,
+			MaxInfluencesLimiter( maxInfluences, locks, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights )
+		);
 	}
 	// Zero specific influences for all points
 	else if ( mode == LimitSmoothSkinningInfluencesOp::Indexed )
@@ -231,18 +343,10 @@ void LimitSmoothSkinningInfluencesOp::modify( Object * object, const CompoundObj
 			limitIndex[ indicesToLimit[i] ] = true;
 		}
 		
-		for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
-		{
-			for ( int j=0; j < pointInfluenceCounts[i]; j++ )
-			{
-				int current = pointIndexOffsets[i] + j;
-				
-				if ( limitIndex[ pointInfluenceIndices[current] ] )
-				{
-					pointInfluenceWeights[current] = 0.0f;
-				}
-			}
-		}
+		tbb::parallel_for(
+			pointRange,
+			IndexedLimiter( limitIndex, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights )
+		);
 	}
 	else
 	{
@@ -38,9 +38,15 @@
 #include "IECore/SharedSceneInterfaces.h"
 #include "IECore/MessageHandler.h"
 
+#include <map>
 #include <set>
 
 #include "boost/foreach.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/mutex.h"
+#include "tbb/parallel_for.h"
+
 using namespace IECore;
 
 IE_CORE_DEFINERUNTIMETYPEDDESCRIPTION( LinkedScene )
@@ -67,7 +73,42 @@ const InternedString LinkedScene::g_root("root");
 const InternedString LinkedScene::g_time("time");
 
 
-LinkedScene::LinkedScene( const std::string &fileName, IndexedIO::OpenMode mode ) : m_mainScene(0), m_linkedScene(0), m_rootLinkDepth(0), m_readOnly(mode & IndexedIO::Read), m_atLink(false), m_sampled(true), m_timeRemapped(false)
+class LinkedScene::LinkCache
+{
+
+	public :
+
+		typedef std::pair<ConstSceneInterfacePtr, int> Link;
+
+		// Returns the cached link for the file and root, returning false
+		// if it has not been expanded yet.
+		bool get( const std::string &key, Link &link ) const
+		{
+			tbb::mutex::scoped_lock lock( m_mutex );
+			LinkMap::const_iterator it = m_links.find( key );
+			if( it == m_links.end() )
+			{
+				return false;
+			}
+			link = it->second;
+			return true;
+		}
+
+		void set( const std::string &key, const Link &link )
+		{
+			tbb::mutex::scoped_lock lock( m_mutex );
+			m_links[key] = link;
+		}
+
+	private :
+
+		typedef std::map<std::string, Link> LinkMap;
+		LinkMap m_links;
+		mutable tbb::mutex m_mutex;
+
+};
+
+LinkedScene::LinkedScene( const std::string &fileName, IndexedIO::OpenMode mode ) : m_mainScene(0), m_linkedScene(0), m_rootLinkDepth(0), m_readOnly(mode & IndexedIO::Read), m_atLink(false), m_sampled(true), m_timeRemapped(false), m_linkCache( new LinkCache )
 {
 	if( mode & IndexedIO::Append )
 	{
@@ -77,7 +118,7 @@ LinkedScene::LinkedScene( const std::string &fileName, IndexedIO::OpenMode mode
 	m_mainScene = new SceneCache( fileName, mode );
 }
 
-LinkedScene::LinkedScene( ConstSceneInterfacePtr mainScene ) : m_mainScene(const_cast<SceneInterface*>(mainScene.get())), m_linkedScene(0), m_rootLinkDepth(0), m_readOnly(true), m_atLink(false), m_timeRemapped(false)
+LinkedScene::LinkedScene( ConstSceneInterfacePtr mainScene ) : m_mainScene(const_cast<SceneInterface*>(mainScene.get())), m_linkedScene(0), m_rootLinkDepth(0), m_readOnly(true), m_atLink(false), m_timeRemapped(false), m_linkCache( new LinkCache )
 {
 	if( SceneCachePtr scc = runTimeCast<SceneCache>( m_mainScene ) )
 	{
@@ -87,7 +128,7 @@ LinkedScene::LinkedScene( ConstSceneInterfacePtr mainScene ) : m_mainScene(const
 	m_sampled = (runTimeCast<const SampledSceneInterface>(mainScene.get()) != NULL);
 }
 
-LinkedScene::LinkedScene( SceneInterface *mainScene, const SceneInterface *linkedScene, int rootLinkDepth, bool readOnly, bool atLink, bool timeRemapped ) : m_mainScene(mainScene), m_linkedScene(linkedScene), m_rootLinkDepth(rootLinkDepth), m_readOnly(readOnly), m_atLink(atLink), m_timeRemapped(timeRemapped)
+LinkedScene::LinkedScene( SceneInterface *mainScene, const SceneInterface *linkedScene, LinkCachePtr linkCache, int rootLinkDepth, bool readOnly, bool atLink, bool timeRemapped ) : m_mainScene(mainScene), m_linkedScene(linkedScene), m_rootLinkDepth(rootLinkDepth), m_readOnly(readOnly), m_atLink(atLink), m_timeRemapped(timeRemapped), m_linkCache(linkCache)
 {
 	if ( !mainScene )
 	{
@@ -931,6 +972,22 @@ PrimitiveVariableMap LinkedScene::readObjectPrimitiveVariables( const std::vecto
 	}
 }
 
+PrimitiveVariableMap LinkedScene::readObjectPrimitiveVariableRange( const std::vector<InternedString> &primVarNames, double time, size_t begin, size_t end ) const
+{
+	if ( m_linkedScene )
+	{
+		if ( m_timeRemapped )
+		{
+			time = remappedLinkTime( time );
+		}
+		return m_linkedScene->readObjectPrimitiveVariableRange( primVarNames, time, begin, end );
+	}
+	else
+	{
+		return m_mainScene->readObjectPrimitiveVariableRange( primVarNames, time, begin, end );
+	}
+}
+
 void LinkedScene::writeObject( const Object *object, double time )
 {
 	if ( m_readOnly )
@@ -971,6 +1028,17 @@ ConstSceneInterfacePtr LinkedScene::expandLink( const StringData *fileName, cons
 {
 	if ( fileName && root )
 	{
+		std::string key;
+		SceneInterface::pathToString( root->readable(), key );
+		key = fileName->readable() + ":" + key;
+
+		LinkCache::Link link;
+		if( m_linkCache->get( key, link ) )
+		{
+			linkDepth = link.second;
+			return link.first;
+		}
+
 		ConstSceneInterfacePtr l = 0;
 		try
 		{
@@ -978,7 +1046,10 @@ ConstSceneInterfacePtr LinkedScene::expandLink( const StringData *fileName, cons
 		}
 		catch ( IECore::Exception &e )
 		{
+			// the failure isn't cached, here or by SharedSceneInterfaces, so that
+			// the link is expanded successfully once the file becomes available.
 			IECore::msg( IECore::MessageHandler::Error, "LinkedScene::expandLink", std::string( e.what() ) + " when expanding link from file \"" + m_mainScene->fileName() + "\"" );
+			SharedSceneInterfaces::erase( fileName->readable() );
 			linkDepth = 0;
 			return 0;
 		}
@@ -990,6 +1061,7 @@ ConstSceneInterfacePtr LinkedScene::expandLink( const StringData *fileName, cons
 			// \todo Consider throwing or printing error message.
 			linkDepth = 0;
 		}
+		m_linkCache->set( key, LinkCache::Link( l, linkDepth ) );
 		return l;
 	}
 	linkDepth = 0;
@@ -1065,7 +1137,7 @@ SceneInterfacePtr LinkedScene::child( const Name &name, MissingBehaviour missing
 		ConstSceneInterfacePtr c = m_linkedScene->child( name, SceneInterface::NullIfMissing );
 		if ( c )
 		{
-			return new LinkedScene( m_mainScene.get(), c.get(), m_rootLinkDepth, m_readOnly, false, m_timeRemapped );
+			return new LinkedScene( m_mainScene.get(), c.get(), m_linkCache, m_rootLinkDepth, m_readOnly, false, m_timeRemapped );
 		}
 		if( !m_atLink )
 		{
@@ -1114,7 +1186,7 @@ SceneInterfacePtr LinkedScene::child( const Name &name, MissingBehaviour missing
 			ConstSceneInterfacePtr l = expandLink( fileName.get(), root.get(), linkDepth );
 			if ( l )
 			{
-				return new LinkedScene( c.get(), l.get(), linkDepth, m_readOnly, true, timeRemapped );
+				return new LinkedScene( c.get(), l.get(), m_linkCache, linkDepth, m_readOnly, true, timeRemapped );
 			}
 		}
 		else if( c->hasAttribute( linkAttribute ) )
@@ -1128,12 +1200,12 @@ SceneInterfacePtr LinkedScene::child( const Name &name, MissingBehaviour missing
 			ConstSceneInterfacePtr l = expandLink( d->member< const StringData >( g_fileName ), d->member< const InternedStringVectorData >( g_root ), linkDepth );
 			if ( l )
 			{
-				return new LinkedScene( c.get(), l.get(), linkDepth, m_readOnly, true, timeRemapped );
+				return new LinkedScene( c.get(), l.get(), m_linkCache, linkDepth, m_readOnly, true, timeRemapped );
 			}
 		}
 	}
 
-	return new LinkedScene( c.get(), 0, 0, m_readOnly, false, false );
+	return new LinkedScene( c.get(), 0, m_linkCache, 0, m_readOnly, false, false );
 	
 }
 
@@ -1242,7 +1314,7 @@ SceneInterfacePtr LinkedScene::scene( const Path &path, MissingBehaviour missing
 		}
 		atLink = false;
 	}
-	return new LinkedScene( s.get(), l.get(), linkDepth, m_readOnly, atLink, timeRemapped );
+	return new LinkedScene( s.get(), l.get(), m_linkCache, linkDepth, m_readOnly, atLink, timeRemapped );
 }
 
 ConstSceneInterfacePtr LinkedScene::scene( const Path &path, LinkedScene::MissingBehaviour missingBehaviour ) const
@@ -1260,6 +1332,97 @@ ConstSceneInterfacePtr LinkedScene::scene( const Path &path, LinkedScene::Missin
 	return (const_cast<LinkedScene*>(this)->*nonConstSceneFn)( path, missingBehaviour );
 }
 
+namespace
+{
+
+struct BoundReader
+{
+	static void read( const SceneInterface *location, double time, Imath::Box3d &result )
+	{
+		result = location->readBound( time );
+	}
+};
+
+struct TransformReader
+{
+	static void read( const SceneInterface *location, double time, Imath::M44d &result )
+	{
+		result = location->readTransformAsMatrix( time );
+	}
+};
+
+struct ObjectReader
+{
+	static void read( const SceneInterface *location, double time, ConstObjectPtr &result )
+	{
+		if ( location->hasObject() )
+		{
+			result = location->readObject( time );
+		}
+	}
+};
+
+template<typename Reader, typename T>
+class BatchReader
+{
+	public :
+
+		BatchReader( const LinkedScene *scene, const std::vector<SceneInterface::Path> &paths, double time, std::vector<T> &results )
+			:	m_scene( scene ), m_paths( paths ), m_time( time ), m_results( results )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				ConstSceneInterfacePtr location = m_scene->scene( m_paths[i] );
+				Reader::read( location.get(), m_time, m_results[i] );
+			}
+		}
+
+	private :
+
+		const LinkedScene *m_scene;
+		const std::vector<SceneInterface::Path> &m_paths;
+		double m_time;
+		std::vector<T> &m_results;
+
+};
+
+} // namespace
+
+void LinkedScene::readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const
+{
+	if ( !m_readOnly )
+	{
+		throw Exception( "Batch read method called on write-only LinkedScene!" );
+	}
+	bounds.resize( paths.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, paths.size() ), BatchReader<BoundReader, Imath::Box3d>( this, paths, time, bounds ) );
+}
+
+void LinkedScene::readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const
+{
+	if ( !m_readOnly )
+	{
+		throw Exception( "Batch read method called on write-only LinkedScene!" );
+	}
+	transforms.resize( paths.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, paths.size() ), BatchReader<TransformReader, Imath::M44d>( this, paths, time, transforms ) );
+}
+
+void LinkedScene::readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const
+{
+	if ( !m_readOnly )
+	{
+		throw Exception( "Batch read method called on write-only LinkedScene!" );
+	}
+	objects.clear();
+	objects.resize( paths.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, paths.size() ), BatchReader<ObjectReader, ConstObjectPtr>( this, paths, time, objects ) );
+}
+
 void LinkedScene::mainSceneHash( HashType hashType, double time, MurmurHash &h ) const
 {
 	// We add the base class hash so that it does not collide with hashes returned as if the main scene was opened directly as a SceneCache.
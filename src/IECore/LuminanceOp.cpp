@@ -32,6 +32,9 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/LuminanceOp.h"
 #include "IECore/CompoundObject.h"
 #include "IECore/CompoundParameter.h"
@@ -182,17 +185,59 @@ const BoolParameter * LuminanceOp::removeColorPrimVarsParameter() const
 	return m_removeColorPrimVarsParameter.get();
 }
 
+namespace
+{
+
+template<typename T>
+class CalculateLuminance
+{
+
+	public :
+
+		CalculateLuminance( const T *r, const T *g, const T *b, const int steps[3], const Color3f &weights, T *y )
+			:	m_r( r ), m_g( g ), m_b( b ), m_weights( weights ), m_y( y )
+		{
+			m_steps[0] = steps[0];
+			m_steps[1] = steps[1];
+			m_steps[2] = steps[2];
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			const T *r = m_r + range.begin() * m_steps[0];
+			const T *g = m_g + range.begin() * m_steps[1];
+			const T *b = m_b + range.begin() * m_steps[2];
+			T *y = m_y + range.begin();
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				*y++ = m_weights[0] * *r + m_weights[1] * *g + m_weights[2] * *b;
+				r += m_steps[0];
+				g += m_steps[1];
+				b += m_steps[2];
+			}
+		}
+
+	private :
+
+		const T *m_r;
+		const T *m_g;
+		const T *m_b;
+		int m_steps[3];
+		Color3f m_weights;
+		T *m_y;
+
+};
+
+} // namespace
+
 template<typename T>
 void LuminanceOp::calculate( const T *r, const T *g, const T *b, int steps[3], int size, T *y )
 {
 	Color3f weights = m_weightsParameter->getTypedValue();
-	for( int i=0; i<size; i++ )
-	{
-		*y++ = weights[0] * *r + weights[1] * *g + weights[2] * *b;
-		r += steps[0];
-		g += steps[1];
-		b += steps[2];
-	}
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, size, 1024 ),
+		CalculateLuminance<T>( r, g, b, steps, weights, y )
+	);
 }
 
 void LuminanceOp::modifyPrimitive( Primitive * primitive, const CompoundObject * operands )
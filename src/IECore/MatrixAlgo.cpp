@@ -32,7 +32,11 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/MatrixAlgo.h"
+#include "IECore/MatrixTraits.h"
 
 using namespace Imath;
 
@@ -53,3 +57,169 @@ M44f IECore::convert( const M44d &in )
 				 in[2][0],  in[2][1],  in[2][2],  in[2][3],
 				 in[3][0],  in[3][1],  in[3][2],  in[3][3] );
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Array transformation
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+template<typename T>
+const Matrix44<T> &toMatrix44( const Matrix44<T> &m )
+{
+	return m;
+}
+
+template<typename T>
+Matrix44<T> toMatrix44( const Matrix33<T> &m )
+{
+	return Matrix44<T>( m, Vec3<T>( 0 ) );
+}
+
+// Equivalent to `v *= m` for a matrix without a projective component, but
+// without the per-point calculation and division by w. The division prevents
+// the compiler from vectorising the loop, and is redundant in the common case.
+template<typename V, typename T>
+class AffineTransformTask
+{
+
+	public :
+
+		AffineTransformTask( V *v, const Matrix44<T> &m, bool translate )
+			:	m_v( v )
+		{
+			for( int i = 0; i < 3; ++i )
+			{
+				for( int j = 0; j < 3; ++j )
+				{
+					m_m[i][j] = m[i][j];
+				}
+				m_m[3][i] = translate ? m[3][i] : T( 0 );
+			}
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			typedef typename V::BaseType S;
+
+			const T m00 = m_m[0][0], m01 = m_m[0][1], m02 = m_m[0][2];
+			const T m10 = m_m[1][0], m11 = m_m[1][1], m12 = m_m[1][2];
+			const T m20 = m_m[2][0], m21 = m_m[2][1], m22 = m_m[2][2];
+			const T m30 = m_m[3][0], m31 = m_m[3][1], m32 = m_m[3][2];
+
+			V *v = m_v;
+			for( size_t i = r.begin(), e = r.end(); i < e; ++i )
+			{
+				V &p = v[i];
+				const S x = p.x, y = p.y, z = p.z;
+				p.x = S( x * m00 + y * m10 + z * m20 + m30 );
+				p.y = S( x * m01 + y * m11 + z * m21 + m31 );
+				p.z = S( x * m02 + y * m12 + z * m22 + m32 );
+			}
+		}
+
+	private :
+
+		V *m_v;
+		T m_m[4][3];
+
+};
+
+template<typename V, typename T>
+class ProjectiveTransformTask
+{
+
+	public :
+
+		ProjectiveTransformTask( V *v, const Matrix44<T> &m )
+			:	m_v( v ), m_m( m )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(), e = r.end(); i < e; ++i )
+			{
+				m_v[i] *= m_m;
+			}
+		}
+
+	private :
+
+		V *m_v;
+		const Matrix44<T> m_m;
+
+};
+
+template<typename Task>
+void runTransformTask( size_t size, const Task &task )
+{
+	// Below this size the overhead of scheduling
+	// outweighs the work done in each task.
+	const size_t grainSize = 10000;
+	if( size <= grainSize )
+	{
+		task( tbb::blocked_range<size_t>( 0, size ) );
+	}
+	else
+	{
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, size, grainSize ), task );
+	}
+}
+
+} // namespace
+
+template<typename V, typename M>
+void IECore::transformPoints( std::vector<V> &points, const M &matrix )
+{
+	if( points.empty() )
+	{
+		return;
+	}
+
+	typedef typename IECore::MatrixTraits<M>::BaseType T;
+	const Matrix44<T> m = toMatrix44( matrix );
+	if( m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1 )
+	{
+		runTransformTask( points.size(), AffineTransformTask<V, T>( &points[0], m, true ) );
+	}
+	else
+	{
+		runTransformTask( points.size(), ProjectiveTransformTask<V, T>( &points[0], m ) );
+	}
+}
+
+template<typename V, typename M>
+void IECore::transformVectors( std::vector<V> &vectors, const M &matrix )
+{
+	if( vectors.empty() )
+	{
+		return;
+	}
+
+	typedef typename IECore::MatrixTraits<M>::BaseType T;
+	runTransformTask( vectors.size(), AffineTransformTask<V, T>( &vectors[0], toMatrix44( matrix ), false ) );
+}
+
+template<typename V, typename M>
+void IECore::transformNormals( std::vector<V> &normals, const M &matrix )
+{
+	M m = matrix.inverse();
+	m.transpose();
+	transformVectors( normals, m );
+}
+
+#define IECORE_TRANSFORM_INSTANTIATE( V, M ) \
+	template IECORE_API void IECore::transformPoints<V, M>( std::vector<V> &, const M & ); \
+	template IECORE_API void IECore::transformVectors<V, M>( std::vector<V> &, const M & ); \
+	template IECORE_API void IECore::transformNormals<V, M>( std::vector<V> &, const M & ); \
+
+IECORE_TRANSFORM_INSTANTIATE( V3f, M33f )
+IECORE_TRANSFORM_INSTANTIATE( V3f, M33d )
+IECORE_TRANSFORM_INSTANTIATE( V3f, M44f )
+IECORE_TRANSFORM_INSTANTIATE( V3f, M44d )
+IECORE_TRANSFORM_INSTANTIATE( V3d, M33f )
+IECORE_TRANSFORM_INSTANTIATE( V3d, M33d )
+IECORE_TRANSFORM_INSTANTIATE( V3d, M44f )
+IECORE_TRANSFORM_INSTANTIATE( V3d, M44d )
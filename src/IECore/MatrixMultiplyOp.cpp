@@ -47,6 +47,7 @@
 #include "IECore/Object.h"
 #include "IECore/NullObject.h"
 #include "IECore/DespatchTypedData.h"
+#include "IECore/MatrixAlgo.h"
 
 using namespace IECore;
 using namespace Imath;
@@ -123,62 +124,24 @@ struct MultiplyFunctor
 	DataPtr data;
 	ConstObjectPtr matrix;
 
-	template< typename T, typename U >
-	void multiply33( U * data, const T &matrix )
-	{
-		assert( data );
-		
-		GeometricData::Interpretation mode = data->getInterpretation();
-		typename U::ValueType::iterator beginIt = data->writable().begin();
-		typename U::ValueType::iterator endIt = data->writable().end();
-		if ( mode==GeometricData::Point || mode==GeometricData::Vector )
-		{
-			for ( typename U::ValueType::iterator it = beginIt; it != endIt; it++ )
-			{
-				*it *= matrix;
-			}
-		}
-		else if ( mode == GeometricData::Normal )
-		{
-			T m = matrix.inverse();
-			m.transpose();
-			for ( typename U::ValueType::iterator it = beginIt; it != endIt; it++ )
-			{
-				*it *= matrix;
-			}
-		}
-	}
-
 	template< typename T, typename U >
 	void multiply( U * data, const T &matrix )
 	{
 		assert( data );
-		
-		GeometricData::Interpretation mode = data->getInterpretation();
-		typename U::ValueType::iterator beginIt = data->writable().begin();
-		typename U::ValueType::iterator endIt = data->writable().end();
-		if ( mode == GeometricData::Point )
-		{
-			for ( typename U::ValueType::iterator it = beginIt; it != endIt; it++ )
-			{
-				*it *= matrix;
-			}
-		}
-		else if ( mode == GeometricData::Vector )
-		{
-			for ( typename U::ValueType::iterator it = beginIt; it != endIt; it++ )
-			{
-				matrix.multDirMatrix( *it, *it );
-			}
-		}
-		else if ( mode == GeometricData::Normal )
+
+		switch( data->getInterpretation() )
 		{
-			T m = matrix.inverse();
-			m.transpose();
-			for ( typename U::ValueType::iterator it = beginIt; it != endIt; it++ )
-			{
-				m.multDirMatrix( *it, *it );
-			}
+			case GeometricData::Point :
+				transformPoints( data->writable(), matrix );
+				break;
+			case GeometricData::Vector :
+				transformVectors( data->writable(), matrix );
+				break;
+			case GeometricData::Normal :
+				transformNormals( data->writable(), matrix );
+				break;
+			default :
+				break;
 		}
 	}
 
@@ -190,10 +153,10 @@ struct MultiplyFunctor
 		switch ( matrix->typeId() )
 		{
 		case M33fDataTypeId:
-			multiply33<M33f, U>( data, boost::static_pointer_cast< const M33fData >( matrix )->readable() );
+			multiply<M33f, U>( data, boost::static_pointer_cast< const M33fData >( matrix )->readable() );
 			break;
 		case M33dDataTypeId:
-			multiply33<M33d, U>( data, boost::static_pointer_cast< const M33dData >( matrix )->readable() );
+			multiply<M33d, U>( data, boost::static_pointer_cast< const M33dData >( matrix )->readable() );
 			break;
 		case M44fDataTypeId:
 			multiply<M44f, U>( data, boost::static_pointer_cast< const M44fData >( matrix )->readable() );
@@ -35,6 +35,8 @@
 #include "boost/multi_array.hpp"
 #include "boost/format.hpp"
 
+#include "tbb/parallel_invoke.h"
+
 #include "IECore/MedianCutSampler.h"
 #include "IECore/NullObject.h"
 #include "IECore/CompoundObject.h"
@@ -42,6 +44,7 @@
 #include "IECore/SummedAreaOp.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/Math.h"
+#include "IECore/LRUCache.h"
 
 using namespace IECore;
 using namespace boost;
@@ -164,54 +167,147 @@ static inline float energy( const Array2D &summedLuminance, const Box2i &area )
 	return a - b - c + d;
 }
 
-static void medianCut( const Array2D &luminance, const Array2D &summedLuminance, MedianCutSampler::Projection projection, const Box2i &area, vector<Box2i> &areas, vector<V2f> &centroids, int depth, int maxDepth )
+namespace
 {
-	float radiansPerPixel = M_PI / (luminance.shape()[1]);
 
-	if( depth==maxDepth )
-	{
-		float totalEnergy = 0.0f;
-		V2f position( 0.0f );
-		for( int y=area.min.y; y<=area.max.y; y++ )
+// Regions with more pixels than this are subdivided in parallel.
+const int g_parallelThreshold = 64 * 1024;
+
+class MedianCut
+{
+
+	public :
+
+		MedianCut( const Array2D &luminance, const Array2D &summedLuminance, MedianCutSampler::Projection projection, int maxDepth, vector<Box2i> &areas, vector<V2f> &centroids )
+			:	m_luminance( luminance ), m_summedLuminance( summedLuminance ), m_projection( projection ), m_maxDepth( maxDepth ), m_areas( areas ), m_centroids( centroids )
 		{
-			for( int x=area.min.x; x<=area.max.x; x++ )
-			{
-				float e = luminance[x][y];
-				position += V2f( x, y ) * e;
-				totalEnergy += e;
-			}
+			m_areas.resize( 1 << maxDepth );
+			m_centroids.resize( 1 << maxDepth );
 		}
 
-		position /= totalEnergy;
-		centroids.push_back( position );
-		areas.push_back( area );
-	}
-	else
-	{
-		// find cut dimension
-		V2f size = area.size();
-		if( projection==MedianCutSampler::LatLong )
+		// Subdivides the area, which is the index'th region at the given depth. Every region
+		// is split in two, so the results for its leaves can be written directly to their
+		// final positions, and the two halves can be processed independently.
+		void operator()( const Box2i &area, int depth, size_t index ) const
 		{
-			float centreY = (area.max.y + area.min.y) / 2.0f;
-			float centreAngle = (M_PI - radiansPerPixel) / 2.0f - centreY * radiansPerPixel;
-			size.x *= cosf( centreAngle );
+			float radiansPerPixel = M_PI / (m_luminance.shape()[1]);
+
+			if( depth==m_maxDepth )
+			{
+				float totalEnergy = 0.0f;
+				V2f position( 0.0f );
+				const int width = area.max.x - area.min.x + 1;
+				for( int y=area.min.y; y<=area.max.y && width > 0; y++ )
+				{
+					// accumulate each row separately, so the inner loop is a
+					// simple reduction over contiguous pixels.
+					const float *row = &(m_luminance[area.min.x][y]);
+					float rowEnergy = 0.0f;
+					float rowX = 0.0f;
+					for( int i=0; i<width; i++ )
+					{
+						rowEnergy += row[i];
+						rowX += row[i] * (float)( area.min.x + i );
+					}
+					position.x += rowX;
+					position.y += rowEnergy * y;
+					totalEnergy += rowEnergy;
+				}
+
+				position /= totalEnergy;
+				m_centroids[index] = position;
+				m_areas[index] = area;
+			}
+			else
+			{
+				// find cut dimension
+				V2f size = area.size();
+				if( m_projection==MedianCutSampler::LatLong )
+				{
+					float centreY = (area.max.y + area.min.y) / 2.0f;
+					float centreAngle = (M_PI - radiansPerPixel) / 2.0f - centreY * radiansPerPixel;
+					size.x *= cosf( centreAngle );
+				}
+				int cutAxis = size.x > size.y ? 0 : 1;
+				float e = energy( m_summedLuminance, area );
+				float halfE = e / 2.0f;
+				Box2i lowArea = area;
+				while( e > halfE )
+				{
+					lowArea.max[cutAxis] -= 1;
+					e = energy( m_summedLuminance, lowArea );
+				}
+				Box2i highArea = area;
+				highArea.min[cutAxis] = lowArea.max[cutAxis] + 1;
+
+				const V2i areaSize = area.size() + V2i( 1 );
+				if( areaSize.x * areaSize.y > g_parallelThreshold )
+				{
+					tbb::parallel_invoke(
+						Task( *this, lowArea, depth + 1, index * 2 ),
+						Task( *this, highArea, depth + 1, index * 2 + 1 )
+					);
+				}
+				else
+				{
+					(*this)( lowArea, depth + 1, index * 2 );
+					(*this)( highArea, depth + 1, index * 2 + 1 );
+				}
+			}
 		}
-		int cutAxis = size.x > size.y ? 0 : 1;
-		float e = energy( summedLuminance, area );
-		float halfE = e / 2.0f;
-		Box2i lowArea = area;
-		while( e > halfE )
+
+	private :
+
+		class Task
 		{
-			lowArea.max[cutAxis] -= 1;
-			e = energy( summedLuminance, lowArea );
-		}
-		Box2i highArea = area;
-		highArea.min[cutAxis] = lowArea.max[cutAxis] + 1;
-		medianCut( luminance, summedLuminance, projection, lowArea, areas, centroids, depth + 1, maxDepth );
-		medianCut( luminance, summedLuminance, projection, highArea, areas, centroids, depth + 1, maxDepth );
-	}
+
+			public :
+
+				Task( const MedianCut &medianCut, const Box2i &area, int depth, size_t index )
+					:	m_medianCut( medianCut ), m_area( area ), m_depth( depth ), m_index( index )
+				{
+				}
+
+				void operator()() const
+				{
+					m_medianCut( m_area, m_depth, m_index );
+				}
+
+			private :
+
+				const MedianCut &m_medianCut;
+				Box2i m_area;
+				int m_depth;
+				size_t m_index;
+
+		};
+
+		const Array2D &m_luminance;
+		const Array2D &m_summedLuminance;
+		MedianCutSampler::Projection m_projection;
+		int m_maxDepth;
+		vector<Box2i> &m_areas;
+		vector<V2f> &m_centroids;
+
+};
+
+// Results are cached by the hash of the inputs, so that repeated sampling of
+// the same image is free.
+typedef LRUCache<MurmurHash, ConstCompoundObjectPtr> ResultCache;
+
+ConstCompoundObjectPtr nullResult( const MurmurHash &hash, size_t &cost )
+{
+	cost = 0;
+	return 0;
+}
+
+ResultCache &resultCache()
+{
+	static ResultCache c( nullResult, 100 );
+	return c;
 }
 
+} // namespace
 
 ObjectPtr MedianCutSampler::doOperation( const CompoundObject * operands )
 {
@@ -226,9 +322,24 @@ ObjectPtr MedianCutSampler::doOperation( const CompoundObject * operands )
 		throw Exception( str( format( "No FloatVectorData channel named \"%s\"." ) % channelName ) );
 	}
 
+	Projection projection = (Projection)m_projectionParameter->getNumericValue();
+	const int subdivisionDepth = subdivisionDepthParameter()->getNumericValue();
+
+	MurmurHash hash;
+	luminance->hash( hash );
+	hash.append( dataWindow );
+	hash.append( (int)projection );
+	hash.append( subdivisionDepth );
+	if( resultCache().cached( hash ) )
+	{
+		if( ConstCompoundObjectPtr cachedResult = resultCache().get( hash ) )
+		{
+			return cachedResult->copy();
+		}
+	}
+
 	// if the projection requires it, weight the luminances so they're less
 	// important towards the poles of the sphere
-	Projection projection = (Projection)m_projectionParameter->getNumericValue();
 	if( projection==LatLong )
 	{
 		float radiansPerPixel = M_PI / (dataWindow.size().y + 1);
@@ -272,7 +383,10 @@ ObjectPtr MedianCutSampler::doOperation( const CompoundObject * operands )
 	dataWindow.min -= dataWindow.min; // let's start indexing from 0 shall we?
 	Array2D array( &(luminance->writable()[0]), extents[dataWindow.size().x+1][dataWindow.size().y+1], fortran_storage_order() );
 	Array2D summedArray( &(summedLuminance->writable()[0]), extents[dataWindow.size().x+1][dataWindow.size().y+1], fortran_storage_order() );
-	medianCut( array, summedArray, projection, dataWindow, areas->writable(), centroids->writable(), 0, subdivisionDepthParameter()->getNumericValue() );
+	MedianCut medianCut( array, summedArray, projection, subdivisionDepth, areas->writable(), centroids->writable() );
+	medianCut( dataWindow, 0, 0 );
+
+	resultCache().set( hash, result->copy(), 1 );
 
 	return result;
 }
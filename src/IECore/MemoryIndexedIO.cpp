@@ -32,23 +32,103 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "boost/iostreams/device/array.hpp"
+#include "boost/iostreams/stream.hpp"
+
 #include "IECore/MemoryIndexedIO.h"
 #include "IECore/FileIndexedIO.h"
 #include "IECore/VectorTypedData.h"
+#include "IECore/Exception.h"
 
 using namespace IECore;
 
 IE_CORE_DEFINERUNTIMETYPEDDESCRIPTION( MemoryIndexedIO )
 
+namespace
+{
+
+// A seekable boost::iostreams device which reads and writes the contents of
+// a CharVectorData, growing it as necessary. Because the data is written in
+// place, the finished file can be handed out without copying it.
+class VectorDevice
+{
+
+	public :
+
+		typedef char char_type;
+		typedef boost::iostreams::seekable_device_tag category;
+
+		VectorDevice( CharVectorData *data )
+			:	m_data( data ), m_position( 0 )
+		{
+		}
+
+		std::streamsize read( char *s, std::streamsize n )
+		{
+			const std::vector<char> &v = m_data->readable();
+			if( m_position >= v.size() )
+			{
+				return -1;
+			}
+			n = std::min( n, (std::streamsize)( v.size() - m_position ) );
+			memcpy( s, &v[m_position], n );
+			m_position += n;
+			return n;
+		}
+
+		std::streamsize write( const char *s, std::streamsize n )
+		{
+			std::vector<char> &v = m_data->writable();
+			if( m_position + n > v.size() )
+			{
+				// resize() grows the capacity geometrically, so appending
+				// many small blocks doesn't reallocate for each one.
+				v.resize( m_position + n );
+			}
+			memcpy( &v[m_position], s, n );
+			m_position += n;
+			return n;
+		}
+
+		boost::iostreams::stream_offset seek( boost::iostreams::stream_offset off, std::ios_base::seekdir way )
+		{
+			boost::iostreams::stream_offset base = 0;
+			if( way == std::ios_base::cur )
+			{
+				base = m_position;
+			}
+			else if( way == std::ios_base::end )
+			{
+				base = m_data->readable().size();
+			}
+			if( base + off < 0 )
+			{
+				throw std::ios_base::failure( "MemoryIndexedIO : Seek before the start of the buffer." );
+			}
+			m_position = base + off;
+			return m_position;
+		}
+
+	private :
+
+		CharVectorData *m_data;
+		size_t m_position;
+
+};
+
+} // namespace
+
 ///////////////////////////////////////////////
 //
-// FileIndexedIO::StreamFile (begin)
+// MemoryIndexedIO::StreamFile (begin)
 //
 ///////////////////////////////////////////////
 
 class MemoryIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 {
 	public:
+
+		StreamFile( ConstCharVectorDataPtr buf, size_t reserveSize, IndexedIO::OpenMode mode );
 		StreamFile( const char *buf, size_t size, IndexedIO::OpenMode mode );
 
 		CharVectorDataPtr buffer();
@@ -59,60 +139,97 @@ class MemoryIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 
 	private:
 
+		// Reads directly from memory we don't own.
+		void setReadStream( const char *buf, size_t size );
+
 		size_t m_endPosition;
+		// the buffer being read in Read mode, held to keep it alive.
+		ConstCharVectorDataPtr m_readBuffer;
+		// the buffer being written to in Write and Append modes.
+		CharVectorDataPtr m_buffer;
 };
 
-MemoryIndexedIO::StreamFile::StreamFile( const char *buf, size_t size, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_endPosition(0)
+MemoryIndexedIO::StreamFile::StreamFile( ConstCharVectorDataPtr buf, size_t reserveSize, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_endPosition(0)
 {
-	if (mode & IndexedIO::Write)
+	const size_t size = buf ? buf->readable().size() : 0;
+	if ( mode & ( IndexedIO::Write | IndexedIO::Append ) )
 	{
-		std::stringstream *f = new std::stringstream( std::ios::trunc | std::ios::binary | std::ios::in | std::ios::out );
-		setStream( f, true );
-	}
-	else if (mode & IndexedIO::Append)
-	{
-		if ( !buf || !size )
+		if ( ( mode & IndexedIO::Append ) && size )
 		{
-			/// Create new file
-			std::stringstream *f = new std::stringstream(  std::ios::trunc | std::ios::binary | std::ios::in | std::ios::out );
-			setStream( f, true );
+			/// Append to existing file. This is a lazy copy, which
+			/// is only duplicated when we first write to it.
+			m_buffer = buf->copy();
+			m_endPosition = size;
 		}
 		else
 		{
-			/// Read existing file
-			assert( buf );
+			/// Create new file
+			m_buffer = new CharVectorData();
+		}
 
-			/// Read existing file
-			std::stringstream *f = new std::stringstream( std::string(buf, size), std::ios::binary | std::ios::in | std::ios::out );
-			setStream( f, false );
+		if ( reserveSize )
+		{
+			m_buffer->writable().reserve( reserveSize );
 		}
+
+		boost::iostreams::stream<VectorDevice> *f = new boost::iostreams::stream<VectorDevice>( VectorDevice( m_buffer.get() ) );
+		setStream( f, m_endPosition == 0 );
 	}
 	else
 	{
 		assert( buf );
 		assert( mode & IndexedIO::Read );
-		std::stringstream *f = new std::stringstream( std::string(buf, size), std::ios::binary | std::ios::in | std::ios::out );
-		setStream( f, false );
+		// we take a lazy copy so that the caller can't modify
+		// the data we're reading, but no data is actually copied.
+		m_readBuffer = buf->copy();
+		setReadStream( size ? &(m_readBuffer->readable()[0]) : 0, size );
 	}
 }
 
+MemoryIndexedIO::StreamFile::StreamFile( const char *buf, size_t size, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_endPosition(0)
+{
+	if ( !( mode & IndexedIO::Read ) )
+	{
+		throw InvalidArgumentException( "MemoryIndexedIO : Only Read mode is supported for buffers owned by the caller." );
+	}
+	setReadStream( buf, size );
+}
+
+void MemoryIndexedIO::StreamFile::setReadStream( const char *buf, size_t size )
+{
+	m_endPosition = size;
+	// the array device requires non-const data, but in Read mode it is never written to.
+	char *data = const_cast<char *>( buf );
+	std::iostream *f = new boost::iostreams::stream<boost::iostreams::array>( data, data + size );
+	setStream( f, false );
+	setMappedData( buf, size );
+}
+
 void MemoryIndexedIO::StreamFile::flush( size_t endPosition )
 {
+	m_stream->flush();
 	m_endPosition = endPosition;
+	if ( m_buffer && m_buffer->readable().size() > m_endPosition )
+	{
+		m_buffer->writable().resize( m_endPosition );
+	}
 }
 
 CharVectorDataPtr MemoryIndexedIO::StreamFile::buffer()
 {
-	std::stringstream *s = static_cast< std::stringstream *>( m_stream );
-	assert( s );
+	if ( m_buffer )
+	{
+		m_stream->flush();
+		return m_buffer->copy();
+	}
 
-	CharVectorData::ValueType d;
-	const std::string &str = s->str();
+	if ( m_readBuffer )
+	{
+		return m_readBuffer->copy();
+	}
 
-	d.assign( str.begin(), str.end() );
-	d.resize( m_endPosition );
-	assert( d.size() ==  m_endPosition );
-	return new CharVectorData( d );
+	const char *data = mappedData( 0, m_endPosition );
+	return new CharVectorData( std::vector<char>( data, data + m_endPosition ) );
 }
 
 MemoryIndexedIO::StreamFile::~StreamFile()
@@ -126,16 +243,14 @@ MemoryIndexedIO::StreamFile::~StreamFile()
 ///////////////////////////////////////////////
 
 
-MemoryIndexedIO::MemoryIndexedIO( ConstCharVectorDataPtr buf, const IndexedIO::EntryIDList &root, IndexedIO::OpenMode mode)
+MemoryIndexedIO::MemoryIndexedIO( ConstCharVectorDataPtr buf, const IndexedIO::EntryIDList &root, IndexedIO::OpenMode mode, size_t reserveSize )
 {
-	const char *bufPtr = 0;
-	size_t size = 0;
-	if ( buf )
-	{
-		bufPtr = &(buf->readable()[0]);
-		size = buf->readable().size();
-	}
-	open( new StreamFile( bufPtr, size, mode ), root );
+	open( new StreamFile( buf, reserveSize, mode ), root );
+}
+
+MemoryIndexedIO::MemoryIndexedIO( const char *buf, size_t size, const IndexedIO::EntryIDList &root, IndexedIO::OpenMode mode )
+{
+	open( new StreamFile( buf, size, mode ), root );
 }
 
 MemoryIndexedIO::MemoryIndexedIO( StreamIndexedIO::Node &rootNode ) : StreamIndexedIO( rootNode )
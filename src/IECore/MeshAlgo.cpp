@@ -4,255 +4,97 @@
 #include "boost/mpl/and.hpp"
 #include "OpenEXR/ImathVec.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/DespatchTypedData.h"
 #include "IECore/MeshAlgo.h"
 #include "IECore/FaceVaryingPromotionOp.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/TypeTraits.h"
+#include "IECore/RadixSort.h"
+#include "IECore/CompoundData.h"
+#include "IECore/VectorTypedData.h"
+#include "IECore/ComputationCache.h"
 #include "IECore/private/PrimitiveAlgoUtils.h"
+#include "IECore/private/MeshAlgoUtils.h"
 
 using namespace IECore;
 using namespace Imath;
 
 namespace
 {
-template< typename U>
-class DeleteFlaggedUniformFunctor
+class RemapVertexIds
 {
-	public:
-		typedef DataPtr ReturnType;
-
-		DeleteFlaggedUniformFunctor( typename IECore::TypedData<std::vector<U> >::ConstPtr flagData ) : m_flagData( flagData )
-		{
-		}
-
-		template<typename T>
-		ReturnType operator()( const T *data )
-		{
-			const typename T::ValueType &inputs = data->readable();
-			const std::vector<U> &flags = m_flagData->readable();
-
-			T *filteredResultData = new T();
-			ReturnType result(filteredResultData);
-
-			typename T::ValueType &filteredResult = filteredResultData->writable();
 
-			filteredResult.reserve( inputs.size() );
-
-			for( size_t i = 0; i < inputs.size(); ++i )
-			{
-				if( !flags[i] )
-				{
-					filteredResult.push_back( inputs[i] );
-				}
-			}
-
-			return result;
-		}
-
-	private:
-		typename IECore::TypedData<std::vector<U> >::ConstPtr m_flagData;
-};
-
-template<typename U>
-class DeleteFlaggedFaceVaryingFunctor
-{
-	public:
-		typedef DataPtr ReturnType;
-
-		DeleteFlaggedFaceVaryingFunctor( typename IECore::TypedData<std::vector<U> >::ConstPtr flagData, ConstIntVectorDataPtr verticesPerFaceData ) : m_flagData( flagData ), m_verticesPerFaceData( verticesPerFaceData )
-		{
-		}
+	public :
 
-		template<typename T>
-		ReturnType operator()( const T *data )
+		RemapVertexIds( const std::vector<int> &vertexIds, const std::vector<int> &faceVaryingIndices, const std::vector<int> &remapping, std::vector<int> &result )
+			:	m_vertexIds( vertexIds ), m_faceVaryingIndices( faceVaryingIndices ), m_remapping( remapping ), m_result( result )
 		{
-			const typename T::ValueType &inputs = data->readable();
-			const std::vector<int> &verticesPerFace = m_verticesPerFaceData->readable();
-			const std::vector<U> &flags = m_flagData->readable();
-
-			T *filteredResultData = new T();
-			typename T::ValueType &filteredResult = filteredResultData->writable();
-
-			filteredResult.reserve( inputs.size() );
-
-			size_t offset = 0;
-			for( size_t f = 0; f < verticesPerFace.size(); ++f )
-			{
-				int numVerts = verticesPerFace[f];
-				if( !flags[f] )
-				{
-					for( int v = 0; v < numVerts; ++v )
-					{
-						filteredResult.push_back( inputs[offset + v] );
-					}
-				}
-				offset += numVerts;
-			}
-
-			return filteredResultData;
 		}
 
-	private:
-		typename IECore::TypedData<std::vector<U> >::ConstPtr m_flagData;
-		ConstIntVectorDataPtr m_verticesPerFaceData;
-
-};
-
-template<typename U>
-class DeleteFlaggedVertexFunctor
-{
-	public:
-		typedef DataPtr ReturnType;
-
-		DeleteFlaggedVertexFunctor( size_t maxVertexId, ConstIntVectorDataPtr vertexIdsData, ConstIntVectorDataPtr verticesPerFaceData, typename IECore::TypedData<std::vector<U> >::ConstPtr flagData )
-			: m_flagData( flagData ), m_verticesPerFaceData( verticesPerFaceData ), m_vertexIdsData( vertexIdsData )
+		void operator()( const tbb::blocked_range<size_t> &range ) const
 		{
-			const std::vector<int> &vertexIds = m_vertexIdsData->readable();
-			const std::vector<int> &verticesPerFace = m_verticesPerFaceData->readable();
-			const std::vector<U> &flags = m_flagData->readable();
-
-			m_usedVerticesData = new BoolVectorData();
-			std::vector<bool> &usedVertices = m_usedVerticesData->writable();
-
-			usedVertices.resize( maxVertexId, false );
-
-			size_t offset = 0;
-			for( size_t f = 0; f < verticesPerFace.size(); ++f )
-			{
-				int numVerts = verticesPerFace[f];
-				if( !flags[f] )
-				{
-					for( int v = 0; v < numVerts; ++v )
-					{
-						usedVertices[vertexIds[offset + v]] = true;
-					}
-				}
-				offset += numVerts;
-			}
-
-
-			m_remappingData = new IntVectorData();
-			std::vector<int> &remapping = m_remappingData->writable();
-
-			// again this array is too large but large enough
-			remapping.resize(maxVertexId, -1 );
-
-			size_t newIndex = 0;
-			for (size_t i = 0; i < usedVertices.size(); ++i)
+			for( size_t i = range.begin(); i != range.end(); ++i )
 			{
-				if( usedVertices[i] )
-				{
-					remapping[i] = newIndex;
-					newIndex++;
-				}
+				m_result[i] = m_remapping[m_vertexIds[m_faceVaryingIndices[i]]];
 			}
 		}
 
-		template<typename T>
-		ReturnType operator()( const T *data )
-		{
-			const std::vector<bool> &usedVertices = m_usedVerticesData->readable();
-
-			const typename T::ValueType &vertices = data->readable();
-
-			T *filteredVerticesData = new T();
-			typename T::ValueType &filteredVertices = filteredVerticesData->writable();
-
-			filteredVertices.reserve( vertices.size() );
+	private :
 
-			for( size_t v = 0; v < vertices.size(); ++v )
-			{
-				if( usedVertices[v] )
-				{
-					filteredVertices.push_back( vertices[v] );
-				}
-			};
+		const std::vector<int> &m_vertexIds;
+		const std::vector<int> &m_faceVaryingIndices;
+		const std::vector<int> &m_remapping;
+		std::vector<int> &m_result;
 
-			return filteredVerticesData;
-		}
-
-		ConstIntVectorDataPtr getRemapping() const { return m_remappingData; }
-
-	private:
-		typename IECore::TypedData<std::vector<U> >::ConstPtr m_flagData;
-		ConstIntVectorDataPtr m_verticesPerFaceData;
-		ConstIntVectorDataPtr m_vertexIdsData;
-
-		BoolVectorDataPtr m_usedVerticesData;
-
-		// map from old vertex index to new
-		IntVectorDataPtr m_remappingData;
 };
 
 template<typename T>
 MeshPrimitivePtr deleteFaces( const MeshPrimitive* meshPrimitive, const typename IECore::TypedData<std::vector<T> > *deleteFlagData)
 {
-	// construct 3 functors for deleting (uniform, vertex & face varying) primvars
-	DeleteFlaggedUniformFunctor<T> uniformFunctor(deleteFlagData);
-	DeleteFlaggedFaceVaryingFunctor<T> faceVaryingFunctor(deleteFlagData, meshPrimitive->verticesPerFace());
-	DeleteFlaggedVertexFunctor<T> vertexFunctor( meshPrimitive->variableSize(PrimitiveVariable::Vertex), meshPrimitive->vertexIds(), meshPrimitive->verticesPerFace(), deleteFlagData );
+	const std::vector<int> &inputVerticesPerFace = meshPrimitive->verticesPerFace()->readable();
+	const std::vector<int> &inputVertexIds = meshPrimitive->vertexIds()->readable();
 
-	// filter verticesPerFace using DeleteFlaggedUniformFunctor
-	IECore::Data *inputVerticesPerFace = const_cast< IECore::Data * >( IECore::runTimeCast<const IECore::Data>( meshPrimitive->verticesPerFace() ) );
-	IECore::DataPtr outputVerticesPerFace = despatchTypedData<DeleteFlaggedUniformFunctor<T>, TypeTraits::IsVectorTypedData>( inputVerticesPerFace, uniformFunctor );
-	IntVectorDataPtr verticesPerFace = IECore::runTimeCast<IECore::IntVectorData>(outputVerticesPerFace);
+	// find the surviving faces, and the face-vertices belonging to them
+	std::vector<int> uniformIndices;
+	Detail::survivingIndices( deleteFlagData->readable(), uniformIndices );
 
-	// filter VertexIds using DeleteFlaggedFaceVaryingFunctor
-	IECore::Data *inputVertexIds = const_cast< IECore::Data * >( IECore::runTimeCast<const IECore::Data>( meshPrimitive->vertexIds() ) );
-	IECore::DataPtr outputVertexIds = despatchTypedData<DeleteFlaggedFaceVaryingFunctor<T>, TypeTraits::IsVectorTypedData>( inputVertexIds, faceVaryingFunctor );
+	std::vector<int> faceVaryingIndices;
+	Detail::expandIndices( uniformIndices, inputVerticesPerFace, faceVaryingIndices );
 
-	// remap the indices also
-	ConstIntVectorDataPtr remappingData = vertexFunctor.getRemapping();
-	const std::vector<int>& remapping = remappingData->readable();
+	// find the vertices still used by the surviving faces, and
+	// a map from old vertex index to new
+	std::vector<char> unusedVertices( meshPrimitive->variableSize( PrimitiveVariable::Vertex ), 1 );
+	for( std::vector<int>::const_iterator it = faceVaryingIndices.begin(), eIt = faceVaryingIndices.end(); it != eIt; ++it )
+	{
+		unusedVertices[inputVertexIds[*it]] = 0;
+	}
 
-	IntVectorDataPtr vertexIdsData = IECore::runTimeCast<IECore::IntVectorData>(outputVertexIds);
-	IntVectorData::ValueType& vertexIds = vertexIdsData->writable();
+	std::vector<int> vertexIndices;
+	Detail::survivingIndices( unusedVertices, vertexIndices );
 
-	for (size_t i = 0; i < vertexIds.size(); ++i)
+	std::vector<int> remapping( unusedVertices.size(), -1 );
+	for( size_t i = 0; i < vertexIndices.size(); ++i )
 	{
-		vertexIds[i] = remapping[vertexIds[i]];
+		remapping[vertexIndices[i]] = i;
 	}
 
-	// construct mesh without positions as they'll be set when filtering the primvars
-	MeshPrimitivePtr outMeshPrimitive = new MeshPrimitive(verticesPerFace, vertexIdsData, meshPrimitive->interpolation());
+	// build the topology for the new mesh
+	IntVectorDataPtr verticesPerFace = new IntVectorData;
+	Detail::gather( inputVerticesPerFace, uniformIndices, verticesPerFace->writable() );
 
-	for (PrimitiveVariableMap::const_iterator it = meshPrimitive->variables.begin(), e = meshPrimitive->variables.end(); it != e; ++it)
-	{
-		switch(it->second.interpolation)
-		{
-			case PrimitiveVariable::Uniform:
-			{
-				IECore::Data *inputData = const_cast< IECore::Data * >( it->second.data.get() );
-				IECore::DataPtr outputData = despatchTypedData<DeleteFlaggedUniformFunctor<T>, TypeTraits::IsVectorTypedData>( inputData, uniformFunctor );
-				outMeshPrimitive->variables[it->first] = PrimitiveVariable( it->second.interpolation, outputData );
-				break;
-			}
-			case PrimitiveVariable::Vertex:
-			case PrimitiveVariable::Varying:
-			{
-				IECore::Data *inputData = const_cast< IECore::Data * >( it->second.data.get() );
-				IECore::DataPtr ouptputData = despatchTypedData<DeleteFlaggedVertexFunctor<T>, TypeTraits::IsVectorTypedData>( inputData, vertexFunctor );
-				outMeshPrimitive->variables[it->first] = PrimitiveVariable( it->second.interpolation, ouptputData );
-				break;
-			}
+	IntVectorDataPtr vertexIds = new IntVectorData;
+	vertexIds->writable().resize( faceVaryingIndices.size() );
+	RemapVertexIds remapVertexIds( inputVertexIds, faceVaryingIndices, remapping, vertexIds->writable() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, faceVaryingIndices.size() ), remapVertexIds );
+
+	// construct mesh without positions as they'll be set when filtering the primvars
+	MeshPrimitivePtr outMeshPrimitive = new MeshPrimitive( verticesPerFace, vertexIds, meshPrimitive->interpolation() );
+	Detail::compactPrimitiveVariables( meshPrimitive->variables, outMeshPrimitive->variables, &uniformIndices, &vertexIndices, &vertexIndices, &faceVaryingIndices );
 
-			case PrimitiveVariable::FaceVarying:
-			{
-				IECore::Data *inputData = const_cast< IECore::Data * >( it->second.data.get() );
-				IECore::DataPtr outputData = despatchTypedData<DeleteFlaggedFaceVaryingFunctor<T>, TypeTraits::IsVectorTypedData>( inputData, faceVaryingFunctor );
-				outMeshPrimitive->variables[it->first] = PrimitiveVariable ( it->second.interpolation, outputData);
-				break;
-			}
-			case PrimitiveVariable::Constant:
-			case PrimitiveVariable::Invalid:
-			{
-				outMeshPrimitive->variables[it->first] = it->second;
-				break;
-			}
-		}
-	}
 	return outMeshPrimitive;
 }
 
@@ -495,8 +337,589 @@ std::string TexturePrimVarNames::indicesName() const
 	return uvSetName + "Indices";
 }
 
+// Computes the offsets into the face table for a range of positions in the
+// sorted keys. Each position is where the faces for all elements greater
+// than the previous key, up to and including its own key, start.
+class FaceAdjacencyOffsets
+{
+
+	public :
+
+		FaceAdjacencyOffsets( const std::vector<unsigned int> &sortedKeys, size_t numElements, std::vector<unsigned int> &offsets )
+			:	m_sortedKeys( sortedKeys ), m_numElements( numElements ), m_offsets( offsets )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			const size_t numKeys = m_sortedKeys.size();
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const size_t first = i ? m_sortedKeys[i-1] + 1 : 0;
+				const size_t last = i < numKeys ? m_sortedKeys[i] : m_numElements;
+				for( size_t e = first; e <= last; ++e )
+				{
+					m_offsets[e] = i;
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<unsigned int> &m_sortedKeys;
+		size_t m_numElements;
+		std::vector<unsigned int> &m_offsets;
+
+};
+
+// Fills in the index of the face each face-vertex belongs to, for a range of faces.
+class FaceVertexFaces
+{
+
+	public :
+
+		FaceVertexFaces( const std::vector<int> &verticesPerFace, const std::vector<int> &faceOffsets, std::vector<unsigned int> &faces )
+			:	m_verticesPerFace( verticesPerFace ), m_faceOffsets( faceOffsets ), m_faces( faces )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				std::fill( m_faces.begin() + m_faceOffsets[f], m_faces.begin() + m_faceOffsets[f] + m_verticesPerFace[f], f );
+			}
+		}
+
+	private :
+
+		const std::vector<int> &m_verticesPerFace;
+		const std::vector<int> &m_faceOffsets;
+		std::vector<unsigned int> &m_faces;
+
+};
+
+// Computes a key for the edge leading out of each face-vertex, for a range
+// of faces. The key is the same regardless of the direction of the edge, so
+// that sorting them brings together all the references to each edge.
+class EdgeKeys
+{
+
+	public :
+
+		EdgeKeys( const std::vector<int> &verticesPerFace, const std::vector<int> &vertexIds, const std::vector<int> &faceOffsets, std::vector<uint64_t> &keys )
+			:	m_verticesPerFace( verticesPerFace ), m_vertexIds( vertexIds ), m_faceOffsets( faceOffsets ), m_keys( keys )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				const int first = m_faceOffsets[f];
+				const int last = first + m_verticesPerFace[f] - 1;
+				for( int i = first; i <= last; ++i )
+				{
+					const uint64_t v0 = m_vertexIds[i];
+					const uint64_t v1 = m_vertexIds[ i == last ? first : i + 1 ];
+					m_keys[i] = v0 < v1 ? ( v0 << 32 ) | v1 : ( v1 << 32 ) | v0;
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<int> &m_verticesPerFace;
+		const std::vector<int> &m_vertexIds;
+		const std::vector<int> &m_faceOffsets;
+		std::vector<uint64_t> &m_keys;
+
+};
+
+// Builds the tables returned by MeshAlgo::topology().
+ConstObjectPtr computeTopology( const MeshPrimitive * const &mesh )
+{
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const size_t numFaces = verticesPerFace.size();
+	const size_t numFaceVertices = vertexIds.size();
+
+	CompoundDataPtr result = new CompoundData;
+
+	IntVectorDataPtr faceOffsetsData = new IntVectorData;
+	std::vector<int> &faceOffsets = faceOffsetsData->writable();
+	Detail::faceOffsets( verticesPerFace, faceOffsets );
+	result->writable()["faceOffsets"] = faceOffsetsData;
+
+	UIntVectorDataPtr vertexFaceOffsetsData = new UIntVectorData;
+	UIntVectorDataPtr vertexFacesData = new UIntVectorData;
+	Detail::faceAdjacency( verticesPerFace, vertexIds, mesh->variableSize( PrimitiveVariable::Vertex ), vertexFaceOffsetsData->writable(), vertexFacesData->writable() );
+	result->writable()["vertexFaceOffsets"] = vertexFaceOffsetsData;
+	result->writable()["vertexFaces"] = vertexFacesData;
+
+	// sort the face-vertices by the edge leading out of them. the sort
+	// is stable, so the references to each edge remain in face order.
+	std::vector<uint64_t> keys( numFaceVertices );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, numFaces ), EdgeKeys( verticesPerFace, vertexIds, faceOffsets, keys ) );
+
+	std::vector<unsigned int> faceVertices( numFaceVertices );
+	for( size_t i = 0; i < numFaceVertices; ++i )
+	{
+		faceVertices[i] = i;
+	}
+	RadixSort().sortPairs( keys, faceVertices );
+
+	std::vector<unsigned int> faces( numFaceVertices );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, numFaces ), FaceVertexFaces( verticesPerFace, faceOffsets, faces ) );
+
+	V2iVectorDataPtr edgesData = new V2iVectorData;
+	IntVectorDataPtr faceVertexEdgesData = new IntVectorData;
+	UIntVectorDataPtr edgeFaceOffsetsData = new UIntVectorData;
+	UIntVectorDataPtr edgeFacesData = new UIntVectorData;
+	std::vector<V2i> &edges = edgesData->writable();
+	std::vector<int> &faceVertexEdges = faceVertexEdgesData->writable();
+	std::vector<unsigned int> &edgeFaceOffsets = edgeFaceOffsetsData->writable();
+	std::vector<unsigned int> &edgeFaces = edgeFacesData->writable();
+
+	faceVertexEdges.resize( numFaceVertices );
+	edgeFaces.resize( numFaceVertices );
+	for( size_t i = 0; i < numFaceVertices; ++i )
+	{
+		if( !i || keys[i] != keys[i-1] )
+		{
+			edgeFaceOffsets.push_back( i );
+			edges.push_back( V2i( keys[i] >> 32, keys[i] & 0xffffffff ) );
+		}
+		faceVertexEdges[faceVertices[i]] = edges.size() - 1;
+		edgeFaces[i] = faces[faceVertices[i]];
+	}
+	edgeFaceOffsets.push_back( numFaceVertices );
+
+	result->writable()["edges"] = edgesData;
+	result->writable()["faceVertexEdges"] = faceVertexEdgesData;
+	result->writable()["edgeFaceOffsets"] = edgeFaceOffsetsData;
+	result->writable()["edgeFaces"] = edgeFacesData;
+
+	// tabulate the neighbours of each vertex from the edges. because the
+	// edges are sorted, the neighbours of each vertex are filled in ascending
+	// order.
+	const size_t numVertices = mesh->variableSize( PrimitiveVariable::Vertex );
+	UIntVectorDataPtr vertexNeighbourOffsetsData = new UIntVectorData;
+	UIntVectorDataPtr vertexNeighboursData = new UIntVectorData;
+	std::vector<unsigned int> &vertexNeighbourOffsets = vertexNeighbourOffsetsData->writable();
+	std::vector<unsigned int> &vertexNeighbours = vertexNeighboursData->writable();
+
+	vertexNeighbourOffsets.resize( numVertices + 1, 0 );
+	for( std::vector<V2i>::const_iterator it = edges.begin(); it != edges.end(); ++it )
+	{
+		vertexNeighbourOffsets[it->x + 1]++;
+		if( it->y != it->x )
+		{
+			vertexNeighbourOffsets[it->y + 1]++;
+		}
+	}
+	for( size_t i = 0; i < numVertices; ++i )
+	{
+		vertexNeighbourOffsets[i+1] += vertexNeighbourOffsets[i];
+	}
+
+	vertexNeighbours.resize( vertexNeighbourOffsets.back() );
+	std::vector<unsigned int> next( vertexNeighbourOffsets.begin(), vertexNeighbourOffsets.end() - 1 );
+	for( std::vector<V2i>::const_iterator it = edges.begin(); it != edges.end(); ++it )
+	{
+		vertexNeighbours[next[it->x]++] = it->y;
+		if( it->y != it->x )
+		{
+			vertexNeighbours[next[it->y]++] = it->x;
+		}
+	}
+
+	result->writable()["vertexNeighbourOffsets"] = vertexNeighbourOffsetsData;
+	result->writable()["vertexNeighbours"] = vertexNeighboursData;
+
+	return result;
+}
+
+MurmurHash topologyHash( const MeshPrimitive * const &mesh )
+{
+	MurmurHash h;
+	mesh->topologyHash( h );
+	return h;
+}
+
+typedef ComputationCache<const MeshPrimitive *> TopologyCache;
+
+TopologyCache *topologyCache()
+{
+	static TopologyCache::Ptr c = new TopologyCache( computeTopology, topologyHash );
+	return c.get();
+}
+
+// Computes the tangent, bitangent and normal for a range of triangles.
+class FaceTangents
+{
+
+	public :
+
+		FaceTangents(
+			const std::vector<V3f> &points, const std::vector<int> &vertIds, const std::vector<float> &u, const std::vector<float> &v,
+			std::vector<V3f> &tangents, std::vector<V3f> &bitangents, std::vector<V3f> &normals
+		)
+			:	m_points( points ), m_vertIds( vertIds ), m_u( u ), m_v( v ), m_tangents( tangents ), m_bitangents( bitangents ), m_normals( normals )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t faceIndex = range.begin(); faceIndex != range.end(); ++faceIndex )
+			{
+				// indices into the facevarying data for this face
+				size_t fvi0 = faceIndex * 3;
+				size_t fvi1 = fvi0 + 1;
+				size_t fvi2 = fvi1 + 1;
+				assert( fvi2 < m_vertIds.size() );
+				assert( fvi2 < m_u.size() );
+				assert( fvi2 < m_v.size() );
+
+				// positions for each vertex of this face
+				const V3f &p0 = m_points[m_vertIds[fvi0]];
+				const V3f &p1 = m_points[m_vertIds[fvi1]];
+				const V3f &p2 = m_points[m_vertIds[fvi2]];
+
+				// uv coordinates for each vertex of this face
+				const V2f uv0( m_u[fvi0], m_v[fvi0] );
+				const V2f uv1( m_u[fvi1], m_v[fvi1] );
+				const V2f uv2( m_u[fvi2], m_v[fvi2] );
+
+				// compute tangents and normal for this face
+				const V3f e0 = p1 - p0;
+				const V3f e1 = p2 - p0;
+
+				const V2f e0uv = uv1 - uv0;
+				const V2f e1uv = uv2 - uv0;
+
+				m_tangents[faceIndex] = ( e0 * -e1uv.y + e1 * e0uv.y ).normalized();
+				m_bitangents[faceIndex] = ( e0 * -e1uv.x + e1 * e0uv.x ).normalized();
+
+				V3f normal = ( p2 - p1 ).cross( p0 - p1 );
+				normal.normalize();
+				m_normals[faceIndex] = normal;
+			}
+		}
+
+	private :
+
+		const std::vector<V3f> &m_points;
+		const std::vector<int> &m_vertIds;
+		const std::vector<float> &m_u;
+		const std::vector<float> &m_v;
+		std::vector<V3f> &m_tangents;
+		std::vector<V3f> &m_bitangents;
+		std::vector<V3f> &m_normals;
+
+};
+
+// Accumulates the face tangents for a range of unique uv indices, and
+// then normalizes and orthogonalizes them.
+class AccumulateTangents
+{
+
+	public :
+
+		AccumulateTangents(
+			const std::vector<unsigned int> &offsets, const std::vector<unsigned int> &faces,
+			const std::vector<V3f> &faceTangents, const std::vector<V3f> &faceBitangents, const std::vector<V3f> &faceNormals,
+			bool orthoTangents, std::vector<V3f> &uTangents, std::vector<V3f> &vTangents
+		)
+			:	m_offsets( offsets ), m_faces( faces ), m_faceTangents( faceTangents ), m_faceBitangents( faceBitangents ), m_faceNormals( faceNormals ),
+				m_orthoTangents( orthoTangents ), m_uTangents( uTangents ), m_vTangents( vTangents )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				V3f uTangent( 0 );
+				V3f vTangent( 0 );
+				V3f normal( 0 );
+				for( unsigned int j = m_offsets[i]; j < m_offsets[i+1]; ++j )
+				{
+					const unsigned int face = m_faces[j];
+					uTangent += m_faceTangents[face];
+					vTangent += m_faceBitangents[face];
+					normal += m_faceNormals[face];
+				}
+
+				// normalize and orthogonalize everything
+				normal.normalize();
+
+				uTangent.normalize();
+				vTangent.normalize();
+
+				// Make uTangent/vTangent orthogonal to normal
+				uTangent -= normal * uTangent.dot( normal );
+				vTangent -= normal * vTangent.dot( normal );
+
+				uTangent.normalize();
+				vTangent.normalize();
+
+				if( m_orthoTangents )
+				{
+					vTangent -= uTangent * vTangent.dot( uTangent );
+					vTangent.normalize();
+				}
+
+				// Ensure we have set of basis vectors (n, uT, vT) with the correct handedness.
+				if( uTangent.cross( vTangent ).dot( normal ) < 0.0f )
+				{
+					uTangent *= -1.0f;
+				}
+
+				m_uTangents[i] = uTangent;
+				m_vTangents[i] = vTangent;
+			}
+		}
+
+	private :
+
+		const std::vector<unsigned int> &m_offsets;
+		const std::vector<unsigned int> &m_faces;
+		const std::vector<V3f> &m_faceTangents;
+		const std::vector<V3f> &m_faceBitangents;
+		const std::vector<V3f> &m_faceNormals;
+		bool m_orthoTangents;
+		std::vector<V3f> &m_uTangents;
+		std::vector<V3f> &m_vTangents;
+
+};
+
+// Converts the tangents for each unique uv index back into facevarying data.
+class FaceVaryingTangents
+{
+
+	public :
+
+		FaceVaryingTangents( const std::vector<int> &stIndices, const std::vector<V3f> &uTangents, const std::vector<V3f> &vTangents, std::vector<V3f> &fvU, std::vector<V3f> &fvV )
+			:	m_stIndices( stIndices ), m_uTangents( uTangents ), m_vTangents( vTangents ), m_fvU( fvU ), m_fvV( fvV )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_fvU[i] = m_uTangents[m_stIndices[i]];
+				m_fvV[i] = m_vTangents[m_stIndices[i]];
+			}
+		}
+
+	private :
+
+		const std::vector<int> &m_stIndices;
+		const std::vector<V3f> &m_uTangents;
+		const std::vector<V3f> &m_vTangents;
+		std::vector<V3f> &m_fvU;
+		std::vector<V3f> &m_fvV;
+
+};
+
 } // anonymous namespace
 
+//////////////////////////////////////////////////////////////////////////
+// Normals
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+template<typename Vec>
+class FaceNormals
+{
+
+	public :
+
+		FaceNormals( const std::vector<Vec> &points, const std::vector<int> &vertIds, const std::vector<int> &faceOffsets, std::vector<Vec> &normals )
+			:	m_points( points ), m_vertIds( vertIds ), m_faceOffsets( faceOffsets ), m_normals( normals )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				// calculate the face normal. note that this method is very naive, and doesn't
+				// cope with colinear vertices or concave faces - we could use polygonNormal() from
+				// PolygonAlgo.h to deal with that, but currently we'd prefer to avoid the overhead.
+				const int *vertId = &(m_vertIds[m_faceOffsets[i]]);
+				const Vec &p0 = m_points[*vertId];
+				const Vec &p1 = m_points[*(vertId+1)];
+				const Vec &p2 = m_points[*(vertId+2)];
+
+				Vec normal = (p2-p1).cross(p0-p1);
+				normal.normalize();
+				m_normals[i] = normal;
+			}
+		}
+
+	private :
+
+		const std::vector<Vec> &m_points;
+		const std::vector<int> &m_vertIds;
+		const std::vector<int> &m_faceOffsets;
+		std::vector<Vec> &m_normals;
+
+};
+
+// Accumulates the face normals onto each vertex by gathering
+// from the adjacent faces in order, which gives the same
+// results as a serial loop scattering from each face.
+template<typename Vec>
+class VertexNormals
+{
+
+	public :
+
+		VertexNormals( const std::vector<Vec> &faceNormals, const std::vector<unsigned int> &adjacencyOffsets, const std::vector<unsigned int> &adjacentFaces, std::vector<Vec> &normals )
+			:	m_faceNormals( faceNormals ), m_adjacencyOffsets( adjacencyOffsets ), m_adjacentFaces( adjacentFaces ), m_normals( normals )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				Vec normal( 0 );
+				for( unsigned int j = m_adjacencyOffsets[i]; j < m_adjacencyOffsets[i+1]; ++j )
+				{
+					normal += m_faceNormals[m_adjacentFaces[j]];
+				}
+				normal.normalize();
+				m_normals[i] = normal;
+			}
+		}
+
+	private :
+
+		const std::vector<Vec> &m_faceNormals;
+		const std::vector<unsigned int> &m_adjacencyOffsets;
+		const std::vector<unsigned int> &m_adjacentFaces;
+		std::vector<Vec> &m_normals;
+
+};
+
+struct CalculateNormals
+{
+	typedef DataPtr ReturnType;
+
+	CalculateNormals( const MeshPrimitive *mesh, PrimitiveVariable::Interpolation interpolation )
+		:	m_vertIds( mesh->vertexIds() ), m_topology( MeshAlgo::topology( mesh ) ), m_interpolation( interpolation )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( T * data )
+	{
+		typedef typename T::ValueType VecContainer;
+		typedef typename VecContainer::value_type Vec;
+
+		const typename T::ValueType &points = data->readable();
+		const std::vector<int> &vertIds = m_vertIds->readable();
+		const std::vector<int> &faceOffsets = m_topology->member<IntVectorData>( "faceOffsets" )->readable();
+
+		typename T::Ptr normalsData = new T;
+		normalsData->setInterpretation( GeometricData::Normal );
+		VecContainer &normals = normalsData->writable();
+
+		// calculate the face normals in parallel
+		VecContainer faceNormals( faceOffsets.size() );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, faceOffsets.size() ),
+			FaceNormals<Vec>( points, vertIds, faceOffsets, faceNormals )
+		);
+
+		if( m_interpolation == PrimitiveVariable::Uniform )
+		{
+			normals.swap( faceNormals );
+			return normalsData;
+		}
+
+		// and accumulate them onto the vertices, again in parallel
+		const std::vector<unsigned int> &adjacencyOffsets = m_topology->member<UIntVectorData>( "vertexFaceOffsets" )->readable();
+		const std::vector<unsigned int> &adjacentFaces = m_topology->member<UIntVectorData>( "vertexFaces" )->readable();
+
+		normals.resize( points.size() );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, points.size() ),
+			VertexNormals<Vec>( faceNormals, adjacencyOffsets, adjacentFaces, normals )
+		);
+
+		return normalsData;
+	}
+
+	private :
+
+		ConstIntVectorDataPtr m_vertIds;
+		ConstCompoundDataPtr m_topology;
+		PrimitiveVariable::Interpolation m_interpolation;
+
+};
+
+struct CalculateNormalsErrorHandler
+{
+	template<typename T, typename F>
+	void operator()( const T *d, const F &f )
+	{
+		std::string e = boost::str( boost::format( "MeshAlgo::calculateNormals : Position primitive variable has unsupported data type \"%s\"." ) % d->typeName() );
+		throw InvalidArgumentException( e );
+	}
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Detail
+//////////////////////////////////////////////////////////////////////////
+
+namespace IECore
+{
+
+namespace Detail
+{
+
+void faceAdjacency( const std::vector<int> &verticesPerFace, const std::vector<int> &indices, size_t numElements, std::vector<unsigned int> &offsets, std::vector<unsigned int> &faces )
+{
+	std::vector<unsigned int> keys( indices.begin(), indices.end() );
+
+	std::vector<int> faceOffsets;
+	Detail::faceOffsets( verticesPerFace, faceOffsets );
+	faces.resize( indices.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, verticesPerFace.size() ), FaceVertexFaces( verticesPerFace, faceOffsets, faces ) );
+
+	// The radix sort is stable, so the faces for each element
+	// remain in ascending order.
+	RadixSort().sortPairs( keys, faces );
+
+	assert( keys.empty() || keys.back() < numElements );
+	offsets.resize( numElements + 1 );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, keys.size() + 1 ), FaceAdjacencyOffsets( keys, numElements, offsets ) );
+}
+
+void faceOffsets( const std::vector<int> &verticesPerFace, std::vector<int> &offsets )
+{
+	offsets.resize( verticesPerFace.size() );
+	int offset = 0;
+	for( size_t i = 0, numFaces = verticesPerFace.size(); i < numFaces; ++i )
+	{
+		offsets[i] = offset;
+		offset += verticesPerFace[i];
+	}
+}
+
+} // namespace Detail
+
+} // namespace IECore
+
 namespace IECore
 {
 
@@ -561,90 +984,41 @@ std::pair<PrimitiveVariable, PrimitiveVariable> calculateTangents(
 	// they are known to be sharing a uv. for each one of these unique indices we compute
 	// the tangents and normal, by accumulating all the tangents and normals for the faces
 	// that reference them. we then take this data and shuffle it back into facevarying
-	// primvars for the mesh.
+	// primvars for the mesh. each stage is performed in parallel, with the accumulation
+	// gathering from the adjacent faces in order, so the results are deterministic.
 	int numUniqueTangents = 1 + *std::max_element( stIndices.begin(), stIndices.end() );
 
-	std::vector<V3f> uTangents( numUniqueTangents, V3f( 0 ) );
-	std::vector<V3f> vTangents( numUniqueTangents, V3f( 0 ) );
-	std::vector<V3f> normals( numUniqueTangents, V3f( 0 ) );
-
-	for( size_t faceIndex = 0; faceIndex < vertsPerFace.size(); faceIndex++ )
+	const size_t numFaces = vertsPerFace.size();
+	std::vector<V3f> faceTangents( numFaces );
+	std::vector<V3f> faceBitangents( numFaces );
+	std::vector<V3f> faceNormals( numFaces );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaces ),
+		FaceTangents( points, vertIds, u, v, faceTangents, faceBitangents, faceNormals )
+	);
+
+	// when the uvs share the connectivity of the vertices, we can use the
+	// cached topology rather than tabulate the adjacency ourselves.
+	ConstCompoundDataPtr topology;
+	std::vector<unsigned int> stAdjacencyOffsets;
+	std::vector<unsigned int> stAdjacentFaces;
+	if( stIndicesData == vertIdsData )
 	{
-		assert( vertsPerFace[faceIndex] == 3 );
-
-		// indices into the facevarying data for this face
-		size_t fvi0 = faceIndex * 3;
-		size_t fvi1 = fvi0 + 1;
-		size_t fvi2 = fvi1 + 1;
-		assert( fvi2 < vertIds.size() );
-		assert( fvi2 < u.size() );
-		assert( fvi2 < v.size() );
-
-		// positions for each vertex of this face
-		const V3f &p0 = points[vertIds[fvi0]];
-		const V3f &p1 = points[vertIds[fvi1]];
-		const V3f &p2 = points[vertIds[fvi2]];
-
-		// uv coordinates for each vertex of this face
-		const V2f uv0( u[fvi0], v[fvi0] );
-		const V2f uv1( u[fvi1], v[fvi1] );
-		const V2f uv2( u[fvi2], v[fvi2] );
-
-		// compute tangents and normal for this face
-		const V3f e0 = p1 - p0;
-		const V3f e1 = p2 - p0;
-
-		const V2f e0uv = uv1 - uv0;
-		const V2f e1uv = uv2 - uv0;
-
-		V3f tangent = ( e0 * -e1uv.y + e1 * e0uv.y ).normalized();
-		V3f bitangent = ( e0 * -e1uv.x + e1 * e0uv.x ).normalized();
-
-		V3f normal = ( p2 - p1 ).cross( p0 - p1 );
-		normal.normalize();
-
-		// and accumlate them into the computation so far
-		uTangents[stIndices[fvi0]] += tangent;
-		uTangents[stIndices[fvi1]] += tangent;
-		uTangents[stIndices[fvi2]] += tangent;
-
-		vTangents[stIndices[fvi0]] += bitangent;
-		vTangents[stIndices[fvi1]] += bitangent;
-		vTangents[stIndices[fvi2]] += bitangent;
-
-		normals[stIndices[fvi0]] += normal;
-		normals[stIndices[fvi1]] += normal;
-		normals[stIndices[fvi2]] += normal;
-
+		topology = MeshAlgo::topology( mesh );
 	}
-
-	// normalize and orthogonalize everything
-	for( size_t i = 0; i < uTangents.size(); i++ )
+	else
 	{
-		normals[i].normalize();
-
-		uTangents[i].normalize();
-		vTangents[i].normalize();
-
-		// Make uTangent/vTangent orthogonal to normal
-		uTangents[i] -= normals[i] * uTangents[i].dot( normals[i] );
-		vTangents[i] -= normals[i] * vTangents[i].dot( normals[i] );
-
-		uTangents[i].normalize();
-		vTangents[i].normalize();
-
-		if( orthoTangents )
-		{
-			vTangents[i] -= uTangents[i] * vTangents[i].dot( uTangents[i] );
-			vTangents[i].normalize();
-		}
-
-		// Ensure we have set of basis vectors (n, uT, vT) with the correct handedness.
-		if( uTangents[i].cross( vTangents[i] ).dot( normals[i] ) < 0.0f )
-		{
-			uTangents[i] *= -1.0f;
-		}
+		Detail::faceAdjacency( vertsPerFace, stIndices, numUniqueTangents, stAdjacencyOffsets, stAdjacentFaces );
 	}
+	const std::vector<unsigned int> &adjacencyOffsets = topology ? topology->member<UIntVectorData>( "vertexFaceOffsets" )->readable() : stAdjacencyOffsets;
+	const std::vector<unsigned int> &adjacentFaces = topology ? topology->member<UIntVectorData>( "vertexFaces" )->readable() : stAdjacentFaces;
+
+	std::vector<V3f> uTangents( numUniqueTangents );
+	std::vector<V3f> vTangents( numUniqueTangents );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numUniqueTangents ),
+		AccumulateTangents( adjacencyOffsets, adjacentFaces, faceTangents, faceBitangents, faceNormals, orthoTangents, uTangents, vTangents )
+	);
 
 	// convert the tangents back to facevarying data and add that to the mesh
 	V3fVectorDataPtr fvUD = new V3fVectorData();
@@ -655,11 +1029,10 @@ std::pair<PrimitiveVariable, PrimitiveVariable> calculateTangents(
 	fvU.resize( stIndices.size() );
 	fvV.resize( stIndices.size() );
 
-	for( unsigned i = 0; i < stIndices.size(); i++ )
-	{
-		fvU[i] = uTangents[stIndices[i]];
-		fvV[i] = vTangents[stIndices[i]];
-	}
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, stIndices.size() ),
+		FaceVaryingTangents( stIndices, uTangents, vTangents, fvU, fvV )
+	);
 
 	PrimitiveVariable tangentPrimVar( PrimitiveVariable::FaceVarying, fvUD );
 	PrimitiveVariable bitangentPrimVar( PrimitiveVariable::FaceVarying, fvVD );
@@ -667,11 +1040,13 @@ std::pair<PrimitiveVariable, PrimitiveVariable> calculateTangents(
 	return std::make_pair( tangentPrimVar, bitangentPrimVar );
 }
 
-void resamplePrimitiveVariable( const MeshPrimitive *mesh, PrimitiveVariable& primitiveVariable, PrimitiveVariable::Interpolation interpolation )
+ConstCompoundDataPtr topology( const MeshPrimitive *mesh )
 {
-	Data *srcData = primitiveVariable.data.get();
-	DataPtr dstData;
+	return boost::static_pointer_cast<const CompoundData>( topologyCache()->get( mesh ) );
+}
 
+void resamplePrimitiveVariable( const MeshPrimitive *mesh, PrimitiveVariable& primitiveVariable, PrimitiveVariable::Interpolation interpolation )
+{
 	PrimitiveVariable::Interpolation srcInterpolation = primitiveVariable.interpolation;
 
 	if ( srcInterpolation == interpolation )
@@ -679,6 +1054,23 @@ void resamplePrimitiveVariable( const MeshPrimitive *mesh, PrimitiveVariable& pr
 		return;
 	}
 
+	if( primitiveVariable.indices )
+	{
+		if( interpolation == PrimitiveVariable::FaceVarying && srcInterpolation != PrimitiveVariable::Constant )
+		{
+			// promoting the indices is sufficient, and keeps the values shared
+			MeshAnythingToFaceVarying fn( mesh, srcInterpolation );
+			IntVectorDataPtr indices = boost::static_pointer_cast<IntVectorData>( fn( primitiveVariable.indices.get() ) );
+			primitiveVariable = PrimitiveVariable( interpolation, primitiveVariable.data, indices );
+			return;
+		}
+		// other resamplings combine values, so we must operate on the expanded data
+		primitiveVariable = PrimitiveVariable( srcInterpolation, primitiveVariable.expandedData() );
+	}
+
+	Data *srcData = primitiveVariable.data.get();
+	DataPtr dstData;
+
 	// average array to single value
 	if ( interpolation == PrimitiveVariable::Constant )
 	{
@@ -738,6 +1130,31 @@ void resamplePrimitiveVariable( const MeshPrimitive *mesh, PrimitiveVariable& pr
 }
 
 
+PrimitiveVariable calculateNormals( const MeshPrimitive *mesh, PrimitiveVariable::Interpolation interpolation, const std::string &position )
+{
+	if( interpolation != PrimitiveVariable::Vertex && interpolation != PrimitiveVariable::Uniform )
+	{
+		throw InvalidArgumentException( "MeshAlgo::calculateNormals : Interpolation must be Vertex or Uniform" );
+	}
+
+	PrimitiveVariableMap::const_iterator pvIt = mesh->variables.find( position );
+	if(
+		pvIt == mesh->variables.end() || !pvIt->second.data ||
+		( pvIt->second.interpolation != PrimitiveVariable::Vertex && pvIt->second.interpolation != PrimitiveVariable::Varying ) ||
+		!mesh->isPrimitiveVariableValid( pvIt->second )
+	)
+	{
+		std::string e = boost::str( boost::format( "MeshAlgo::calculateNormals : MeshPrimitive has no valid Vertex \"%s\" primitive variable." ) % position );
+		throw InvalidArgumentException( e );
+	}
+
+	CalculateNormals f( mesh, interpolation );
+	return PrimitiveVariable(
+		interpolation,
+		despatchTypedData<CalculateNormals, TypeTraits::IsVec3VectorTypedData, CalculateNormalsErrorHandler>( pvIt->second.data.get(), f )
+	);
+}
+
 MeshPrimitivePtr deleteFaces( const MeshPrimitive *meshPrimitive, const PrimitiveVariable& facesToDelete )
 {
 
@@ -771,5 +1188,44 @@ MeshPrimitivePtr deleteFaces( const MeshPrimitive *meshPrimitive, const Primitiv
 
 }
 
+MeshPrimitivePtr mergeMeshes( const std::vector<const MeshPrimitive *> &meshes )
+{
+	MeshPrimitivePtr result = new MeshPrimitive;
+	if( meshes.empty() )
+	{
+		return result;
+	}
+
+	// topology
+
+	std::vector<const std::vector<int> *> verticesPerFaceSources;
+	std::vector<const std::vector<int> *> vertexIdsSources;
+	std::vector<size_t> vertexOffsets;
+	size_t numVertices = 0;
+	for( std::vector<const MeshPrimitive *>::const_iterator it = meshes.begin(), eIt = meshes.end(); it != eIt; ++it )
+	{
+		verticesPerFaceSources.push_back( &(*it)->verticesPerFace()->readable() );
+		vertexIdsSources.push_back( &(*it)->vertexIds()->readable() );
+		vertexOffsets.push_back( numVertices );
+		numVertices += (*it)->variableSize( PrimitiveVariable::Vertex );
+	}
+
+	IntVectorDataPtr verticesPerFaceData = new IntVectorData;
+	Detail::mergeIndices( verticesPerFaceSources, std::vector<size_t>( meshes.size(), 0 ), verticesPerFaceData->writable() );
+
+	IntVectorDataPtr vertexIdsData = new IntVectorData;
+	Detail::mergeIndices( vertexIdsSources, vertexOffsets, vertexIdsData->writable() );
+
+	// the inputs are valid, so the result is too
+	result->setTopologyUnchecked( verticesPerFaceData, vertexIdsData, numVertices, meshes[0]->interpolation() );
+
+	// primitive variables
+
+	static const int interpolationRanks[] = { 0, 0, 1, 2, 2, 3 };
+	Detail::mergePrimitiveVariables( meshes, &resamplePrimitiveVariable, interpolationRanks, result.get(), "MeshAlgo::mergeMeshes" );
+
+	return result;
+}
+
 } //namespace MeshAlgo
 } //namespace IECore
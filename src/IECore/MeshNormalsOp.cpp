@@ -35,8 +35,8 @@
 #include "boost/format.hpp"
 
 #include "IECore/MeshNormalsOp.h"
-#include "IECore/DespatchTypedData.h"
 #include "IECore/CompoundParameter.h"
+#include "IECore/MeshAlgo.h"
 
 using namespace IECore;
 using namespace std;
@@ -109,98 +109,6 @@ const IntParameter * MeshNormalsOp::interpolationParameter() const
 	return parameters()->parameter<IntParameter>( "interpolation" );
 }
 
-struct MeshNormalsOp::CalculateNormals
-{
-	typedef DataPtr ReturnType;
-
-	CalculateNormals( const IntVectorData *vertsPerFace, const IntVectorData *vertIds, PrimitiveVariable::Interpolation interpolation )
-		:	m_vertsPerFace( vertsPerFace ), m_vertIds( vertIds ), m_interpolation( interpolation )
-	{
-	}
-
-	template<typename T>
-	ReturnType operator()( T * data )
-	{
-		typedef typename T::ValueType VecContainer;
-		typedef typename VecContainer::value_type Vec;
-
-		const typename T::ValueType &points = data->readable();
-		const vector<int> &vertsPerFace = m_vertsPerFace->readable();
-		const vector<int> &vertIds = m_vertIds->readable();
-
-		typename T::Ptr normalsData = new T;
-		normalsData->setInterpretation( GeometricData::Normal );
-		VecContainer &normals = normalsData->writable();
-		if( m_interpolation == PrimitiveVariable::Uniform )
-		{
-			normals.reserve( vertsPerFace.size() );
-		}
-		else
-		{
-			normals.resize( points.size(), Vec( 0 ) );
-		}
-
-		// loop over the faces
-		const int *vertId = &(vertIds[0]);
-		for( vector<int>::const_iterator it = vertsPerFace.begin(); it!=vertsPerFace.end(); it++ )
-		{
-			// calculate the face normal. note that this method is very naive, and doesn't
-			// cope with colinear vertices or concave faces - we could use polygonNormal() from
-			// PolygonAlgo.h to deal with that, but currently we'd prefer to avoid the overhead.
-			const Vec &p0 = points[*vertId];
-			const Vec &p1 = points[*(vertId+1)];
-			const Vec &p2 = points[*(vertId+2)];
-
-			Vec normal = (p2-p1).cross(p0-p1);
-			normal.normalize();
-
-			if( m_interpolation == PrimitiveVariable::Uniform )
-			{
-				normals.push_back( normal );
-				vertId += *it;
-			}
-			else
-			{
-				// accumulate the face normal onto each of the vertices
-				// for this face.
-				for( int i=0; i<*it; ++i )
-				{
-					normals[*vertId] += normal;
-					++vertId;
-				}
-			}
-		}
-
-		// normalize each of the vertex normals
-		if( m_interpolation == PrimitiveVariable::Vertex )
-		{
-			for( typename VecContainer::iterator it=normals.begin(), eIt=normals.end(); it != eIt; ++it )
-			{
-				it->normalize();
-			}
-		}
-		
-		return normalsData;
-	}
-
-	private :
-
-		ConstIntVectorDataPtr m_vertsPerFace;
-		ConstIntVectorDataPtr m_vertIds;
-		PrimitiveVariable::Interpolation m_interpolation;
-
-};
-
-struct MeshNormalsOp::HandleErrors
-{
-	template<typename T, typename F>
-	void operator()( const T *d, const F &f )
-	{
-		string e = boost::str( boost::format( "MeshNormalsOp : pPrimVarName parameter has unsupported data type \"%s\"." ) % d->typeName() );
-		throw InvalidArgumentException( e );
-	}
-};
-
 void MeshNormalsOp::modifyTypedPrimitive( MeshPrimitive * mesh, const CompoundObject * operands )
 {
 	const std::string &pPrimVarName = pPrimVarNameParameter()->getTypedValue();
@@ -219,8 +127,5 @@ void MeshNormalsOp::modifyTypedPrimitive( MeshPrimitive * mesh, const CompoundOb
 
 	const PrimitiveVariable::Interpolation interpolation = static_cast<PrimitiveVariable::Interpolation>( operands->member<IntData>( "interpolation" )->readable() );
 	
-	CalculateNormals f( mesh->verticesPerFace(), mesh->vertexIds(), interpolation );
-	DataPtr n = despatchTypedData<CalculateNormals, TypeTraits::IsVec3VectorTypedData, HandleErrors>( pvIt->second.data.get(), f );
-
-	mesh->variables[ nPrimVarNameParameter()->getTypedValue() ] = PrimitiveVariable( interpolation, n );
+	mesh->variables[ nPrimVarNameParameter()->getTypedValue() ] = MeshAlgo::calculateNormals( mesh, interpolation, pPrimVarName );
 }
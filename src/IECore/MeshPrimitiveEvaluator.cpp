@@ -32,7 +32,16 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <numeric>
+
+#include "boost/bind.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+#include "tbb/parallel_sort.h"
 
 #include "OpenEXR/ImathBoxAlgo.h"
 #include "OpenEXR/ImathLineAlgo.h"
@@ -44,6 +53,7 @@
 #include "IECore/MeshPrimitiveEvaluator.h"
 #include "IECore/TriangleAlgo.h"
 #include "IECore/SimpleTypedData.h"
+#include "IECore/private/RayBoxIntersector.h"
 
 using namespace IECore;
 using namespace Imath;
@@ -52,6 +62,13 @@ IE_CORE_DEFINERUNTIMETYPED( MeshPrimitiveEvaluator );
 
 static PrimitiveEvaluator::Description< MeshPrimitiveEvaluator > g_registraar = PrimitiveEvaluator::Description< MeshPrimitiveEvaluator >();
 
+// Returns the index into pv.data for the specified element,
+// taking account of any indices.
+static inline size_t dataIndex( const PrimitiveVariable &pv, size_t element )
+{
+	return pv.indices ? pv.indices->readable()[element] : element;
+}
+
 MeshPrimitiveEvaluator::Result::Result()
 {
 }
@@ -110,7 +127,7 @@ const std::string &MeshPrimitiveEvaluator::Result::stringPrimVar( const Primitiv
 
 		if (data)
 		{
-			return data->readable()[0];
+			return data->readable()[ dataIndex( pv, 0 ) ];
 		}
 	}
 
@@ -150,37 +167,43 @@ T MeshPrimitiveEvaluator::Result::getPrimVar( const PrimitiveVariable &pv ) cons
 		throw InvalidArgumentException( "Could not retrieve primvar data for MeshPrimitiveEvaluator" );
 	}
 
+	const std::vector<T> &d = data->readable();
 	switch ( pv.interpolation )
 	{
 		case PrimitiveVariable::Constant :
-			assert( data->readable().size() == 1 );
+			assert( d.size() >= 1 );
 
-			return data->readable()[0];
+			return d[ dataIndex( pv, 0 ) ];
 
 		case PrimitiveVariable::Uniform :
-			assert( m_triangleIdx < data->readable().size() );
+			assert( dataIndex( pv, m_triangleIdx ) < d.size() );
 
-			return data->readable()[ m_triangleIdx ];
+			return d[ dataIndex( pv, m_triangleIdx ) ];
 
 		case PrimitiveVariable::Vertex :
 		case PrimitiveVariable::Varying:
-			assert( m_vertexIds[0] < (int)data->readable().size() );
-			assert( m_vertexIds[1] < (int)data->readable().size() );
-			assert( m_vertexIds[2] < (int)data->readable().size() );
-
-			return static_cast<T>( data->readable()[ m_vertexIds[0] ] * m_bary[0] + data->readable()[ m_vertexIds[1] ] * m_bary[1] + data->readable()[ m_vertexIds[2] ] * m_bary[2] );
+		{
+			const size_t i0 = dataIndex( pv, m_vertexIds[0] );
+			const size_t i1 = dataIndex( pv, m_vertexIds[1] );
+			const size_t i2 = dataIndex( pv, m_vertexIds[2] );
+			assert( i0 < d.size() );
+			assert( i1 < d.size() );
+			assert( i2 < d.size() );
+
+			return static_cast<T>( d[ i0 ] * m_bary[0] + d[ i1 ] * m_bary[1] + d[ i2 ] * m_bary[2] );
+		}
 
 		case PrimitiveVariable::FaceVarying:
-
-			assert( (m_triangleIdx * 3) + 0 < data->readable().size() );
-			assert( (m_triangleIdx * 3) + 1 < data->readable().size() );
-			assert( (m_triangleIdx * 3) + 2 < data->readable().size() );
-
-			return static_cast<T>(
-				  data->readable()[ (m_triangleIdx * 3) + 0 ] * m_bary[0]
-				+ data->readable()[ (m_triangleIdx * 3) + 1 ] * m_bary[1]
-				+ data->readable()[ (m_triangleIdx * 3) + 2 ] * m_bary[2]
-			);
+		{
+			const size_t i0 = dataIndex( pv, (m_triangleIdx * 3) + 0 );
+			const size_t i1 = dataIndex( pv, (m_triangleIdx * 3) + 1 );
+			const size_t i2 = dataIndex( pv, (m_triangleIdx * 3) + 2 );
+			assert( i0 < d.size() );
+			assert( i1 < d.size() );
+			assert( i2 < d.size() );
+
+			return static_cast<T>( d[ i0 ] * m_bary[0] + d[ i1 ] * m_bary[1] + d[ i2 ] * m_bary[2] );
+		}
 
 		default :
 			/// Unimplemented primvar interpolation
@@ -205,8 +228,10 @@ const V3i &MeshPrimitiveEvaluator::Result::vertexIds() const
 	return m_vertexIds;
 }
 
-MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh ) : m_uvTree(0), m_haveMassProperties( false ), m_haveSurfaceArea( false ), m_haveAverageNormals( false )
+MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh, AccelerationStructure accelerationStructure ) : m_tree(0), m_bvh(0), m_uvTree(0), m_haveMassProperties( false ), m_haveSurfaceArea( false )
 {
+	m_haveAverageNormals = false;
+
 	if (! mesh )
 	{
 		throw InvalidArgumentException( "No mesh given to MeshPrimitiveEvaluator");
@@ -217,7 +242,17 @@ MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh ) : m
 		throw InvalidArgumentException( "Mesh with invalid primitive variables given to MeshPrimitiveEvaluator");
 	}
 
-	m_mesh = mesh->copy();
+	// Expand any indexed variables, so that the internal lookups
+	// of "P", "s" and "t" can index the data directly.
+	MeshPrimitivePtr meshCopy = mesh->copy();
+	for( PrimitiveVariableMap::iterator it = meshCopy->variables.begin(); it != meshCopy->variables.end(); ++it )
+	{
+		if( it->second.indices )
+		{
+			it->second = PrimitiveVariable( it->second.interpolation, it->second.expandedData() );
+		}
+	}
+	m_mesh = meshCopy;
 
 
 	PrimitiveVariableMap::const_iterator primVarIt = m_mesh->variables.find("P");
@@ -250,63 +285,85 @@ MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh ) : m
 	}
 
 	const std::vector<int> &verticesPerFace = m_mesh->verticesPerFace()->readable();
-	m_triangles.reserve( verticesPerFace.size() );
-	m_uvTriangles.reserve( verticesPerFace.size() );
-	unsigned int triangleIdx = 0;
-	IntVectorData::ValueType::const_iterator vertexIdIt = m_meshVertexIds->begin();
-	for ( IntVectorData::ValueType::const_iterator it = verticesPerFace.begin();
-		it != verticesPerFace.end(); ++it, ++triangleIdx)
+	for ( IntVectorData::ValueType::const_iterator it = verticesPerFace.begin(); it != verticesPerFace.end(); ++it )
 	{
-
 		if (*it != 3 )
 		{
 			throw InvalidArgumentException( "Non-triangular mesh given to MeshPrimitiveEvaluator");
 		}
+	}
 
-		Imath::V3i triangleVertexIds;
+	const bool haveUVs = m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid;
 
-		triangleVertexIds[0] = *vertexIdIt++;
-		assert( triangleVertexIds[0] < (int)( m_verts->readable().size() ) );
-		triangleVertexIds[1] = *vertexIdIt++;
-		assert( triangleVertexIds[1] < (int)( m_verts->readable().size() ) );
-		triangleVertexIds[2] = *vertexIdIt++;
-		assert( triangleVertexIds[2] < (int)( m_verts->readable().size() ) );
+	m_triangles.resize( verticesPerFace.size() );
+	if( haveUVs )
+	{
+		m_uvTriangles.resize( verticesPerFace.size() );
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, verticesPerFace.size() ),
+		boost::bind( &MeshPrimitiveEvaluator::calculateTriangleBounds, this, _1 )
+	);
+
+	// the trees are each built in parallel internally, but building
+	// them concurrently also overlaps the serial work at their roots.
+	if( haveUVs )
+	{
+		tbb::parallel_invoke(
+			boost::bind( &MeshPrimitiveEvaluator::buildTriangleTree, this, accelerationStructure ),
+			boost::bind( &MeshPrimitiveEvaluator::buildUVTree, this )
+		);
+	}
+	else
+	{
+		buildTriangleTree( accelerationStructure );
+	}
+}
 
-		const V3f &p0 = m_verts->readable()[ triangleVertexIds[0] ];
-		const V3f &p1 = m_verts->readable()[ triangleVertexIds[1] ];
-		const V3f &p2 = m_verts->readable()[ triangleVertexIds[2] ];
+void MeshPrimitiveEvaluator::calculateTriangleBounds( const tbb::blocked_range<size_t> &range )
+{
+	const bool haveUVs = m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid;
 
-		Box3f bound( p0 );
-		bound.extendBy( p1 );
-		bound.extendBy( p2 );
+	for( size_t triangleIdx = range.begin(); triangleIdx != range.end(); ++triangleIdx )
+	{
+		const Imath::V3i vertexIds = triangleVertexIds( triangleIdx );
 
-		m_triangles.push_back( bound );
+		Box3f &bound = m_triangles[triangleIdx];
+		bound = Box3f( m_verts->readable()[ vertexIds[0] ] );
+		bound.extendBy( m_verts->readable()[ vertexIds[1] ] );
+		bound.extendBy( m_verts->readable()[ vertexIds[2] ] );
 
-		if ( m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid )
+		if ( haveUVs )
 		{
 			Imath::V2f uv[3];
-			triangleUVs( triangleIdx, triangleVertexIds, uv );
+			triangleUVs( triangleIdx, vertexIds, uv );
 
-			Box2f uvBound( uv[0] );
+			Box2f &uvBound = m_uvTriangles[triangleIdx];
+			uvBound = Box2f( uv[0] );
 			uvBound.extendBy( uv[1] );
 			uvBound.extendBy( uv[2] );
-
-			m_uvTriangles.push_back( uvBound );
 		}
 	}
-	
-	m_tree = new TriangleBoundTree( m_triangles.begin(), m_triangles.end() );
+}
 
-	if ( m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid )
+void MeshPrimitiveEvaluator::buildTriangleTree( AccelerationStructure accelerationStructure )
+{
+	if( accelerationStructure == BVHAcceleration )
 	{
-		m_uvTree = new UVBoundTree( m_uvTriangles.begin(), m_uvTriangles.end() );
+		m_bvh = new TriangleBVH( m_triangles.begin(), m_triangles.end() );
 	}
 	else
 	{
-		m_uvTree = 0;
+		m_tree = new TriangleBoundTree( m_triangles.begin(), m_triangles.end() );
 	}
 }
 
+void MeshPrimitiveEvaluator::buildUVTree()
+{
+	m_uvTree = new UVBoundTree( m_uvTriangles.begin(), m_uvTriangles.end() );
+}
+
 PrimitiveEvaluatorPtr MeshPrimitiveEvaluator::create( ConstPrimitivePtr primitive )
 {
 	ConstMeshPrimitivePtr mesh = runTimeCast< const MeshPrimitive >( primitive );
@@ -317,11 +374,14 @@ PrimitiveEvaluatorPtr MeshPrimitiveEvaluator::create( ConstPrimitivePtr primitiv
 
 MeshPrimitiveEvaluator::~MeshPrimitiveEvaluator()
 {
-	assert( m_tree );
+	assert( m_tree || m_bvh );
 
 	delete m_tree;
 	m_tree = 0;
 
+	delete m_bvh;
+	m_bvh = 0;
+
 	delete m_uvTree;
 	m_uvTree = 0;
 }
@@ -482,62 +542,119 @@ void MeshPrimitiveEvaluator::calculateAverageNormals() const
 		return;
 	}
 	
-	ConstIntVectorDataPtr verticesPerFace = m_mesh->verticesPerFace();
+	const std::vector<int> &vertexIds = *m_meshVertexIds;
+	const int numTriangles = m_triangles.size();
+	const int numVertices = m_verts->readable().size();
+
+	/// Build vertex connectivity. We want to be able to quickly find the list of triangles connected to each vertex,
+	/// so store them contiguously, with the triangles for vertex v being those in the range
+	/// [ vertexTriangles[vertexTriangleOffsets[v]], vertexTriangles[vertexTriangleOffsets[v+1]] ), in ascending order.
+	std::vector<int> vertexTriangleOffsets( numVertices + 1, 0 );
+	for( std::vector<int>::const_iterator it = vertexIds.begin(); it != vertexIds.end(); ++it )
+	{
+		vertexTriangleOffsets[*it + 1]++;
+	}
+	std::partial_sum( vertexTriangleOffsets.begin(), vertexTriangleOffsets.end(), vertexTriangleOffsets.begin() );
 
-#ifndef NDEBUG
-	for (IntVectorData::ValueType::const_iterator it = verticesPerFace->readable().begin(); it != verticesPerFace->readable().end(); ++it )
+	std::vector<int> vertexTriangles( vertexIds.size() );
+	std::vector<int> nextVertexTriangle( vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1 );
+	for( size_t i = 0, e = vertexIds.size(); i < e; ++i )
 	{
-		assert( *it == 3 );
+		vertexTriangles[ nextVertexTriangle[ vertexIds[i] ]++ ] = i / 3;
 	}
-#endif
 
-	/// Build vertex connectivity. We want to be able to quickly find the list of triangles connected to each vertex.
-	typedef std::map< VertexIndex, std::set<TriangleIndex> > VertexConnectivity;
-	VertexConnectivity vertexConnectivity;
+	/// Calculate "Angle-weighted pseudo-normal" for each vertex. A description of this, and proof of its validity for use in signed distance functions
+	/// can be found here: www.ann.jussieu.fr/~frey/papiers/PsNormTVCG.pdf
+	V3fVectorDataPtr vertexAngleWeightedNormals = new V3fVectorData();
+	vertexAngleWeightedNormals->writable().resize( numVertices );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numVertices ),
+		boost::bind(
+			&MeshPrimitiveEvaluator::calculateVertexNormals, this, _1,
+			boost::cref( vertexTriangleOffsets ), boost::cref( vertexTriangles ), boost::ref( vertexAngleWeightedNormals->writable() )
+		)
+	);
 
-	IntVectorData::ValueType::const_iterator it = m_meshVertexIds->begin();
-	int triangleIndex = 0;
-	while ( it != m_meshVertexIds->end() )
+	/// Calculate edge connectivity. For any given pair of (connected) vertices we want to be able to find the faces connected to that edge.
+	/// We store the same edges going in the opposite direction, too. This doubles our (small) storage overhead but allows for faster lookups.
+	/// Sorting groups the faces for each edge together, in ascending order.
+	typedef std::pair<Edge, TriangleIndex> EdgeTriangle;
+	std::vector<EdgeTriangle> edgeTriangles;
+	edgeTriangles.reserve( numTriangles * 6 );
+	for( TriangleIndex triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex )
 	{
-		VertexIndex v0 = *it ++;
-		VertexIndex v1 = *it ++;
-		VertexIndex v2 = *it ++;
+		VertexIndex v0 = vertexIds[triangleIndex * 3];
+		VertexIndex v1 = vertexIds[triangleIndex * 3 + 1];
+		VertexIndex v2 = vertexIds[triangleIndex * 3 + 2];
+
+		edgeTriangles.push_back( EdgeTriangle( Edge( v0, v1 ), triangleIndex ) );
+		edgeTriangles.push_back( EdgeTriangle( Edge( v0, v2 ), triangleIndex ) );
+		edgeTriangles.push_back( EdgeTriangle( Edge( v1, v2 ), triangleIndex ) );
+		edgeTriangles.push_back( EdgeTriangle( Edge( v1, v0 ), triangleIndex ) );
+		edgeTriangles.push_back( EdgeTriangle( Edge( v2, v0 ), triangleIndex ) );
+		edgeTriangles.push_back( EdgeTriangle( Edge( v2, v1 ), triangleIndex ) );
+	}
+	tbb::parallel_sort( edgeTriangles.begin(), edgeTriangles.end() );
 
-		vertexConnectivity[ v0 ].insert( triangleIndex );
-		vertexConnectivity[ v1 ].insert( triangleIndex );
-		vertexConnectivity[ v2 ].insert( triangleIndex );
+	/// Calculate the average edge normals
+	EdgeAverageNormals edgeAverageNormals;
+	for( std::vector<EdgeTriangle>::const_iterator it = edgeTriangles.begin(); it != edgeTriangles.end(); )
+	{
+		std::vector<EdgeTriangle>::const_iterator groupEnd = it + 1;
+		while( groupEnd != edgeTriangles.end() && groupEnd->first == it->first )
+		{
+			++groupEnd;
+		}
 
-		triangleIndex++;
-	}
+		if( groupEnd - it > 2 )
+		{
+			/// If there are more than 2 faces connected to any given edge then the mesh is non-manifold, which results in an exception.
+			throw Exception("Non-manifold mesh given to MeshPrimitiveImplicitSurfaceFunction");
+		}
+		else if( groupEnd - it == 1 )
+		{
+			/// If there are less than 2 faces connected to any given edge then the mesh is not closed, which results in an exception.
+			throw Exception("Mesh given to MeshPrimitiveImplicitSurfaceFunction is not closed");
+		}
 
-	assert( triangleIndex == (int)(verticesPerFace->readable().size()) );
+		const V3i ids0 = triangleVertexIds( it->second );
+		const V3i ids1 = triangleVertexIds( (it + 1)->second );
 
-	/// Calculate "Angle-weighted pseudo-normal" for each vertex. A description of this, and proof of its validity for use in signed distance functions
-	/// can be found here: www.ann.jussieu.fr/~frey/papiers/PsNormTVCG.pdf
-	m_vertexAngleWeightedNormals = new V3fVectorData( );
-	m_vertexAngleWeightedNormals->writable().reserve( m_verts->readable().size() );
+		const std::vector<V3f> &p = m_verts->readable();
+		const V3f n = ( triangleNormal( p[ids0[0]], p[ids0[1]], p[ids0[2]] ) + triangleNormal( p[ids1[0]], p[ids1[1]], p[ids1[2]] ) ) / 2.0f;
 
-	int numVertices = m_verts->readable().size();
+		// edges are visited in sorted order, so inserting at the end is constant time
+		edgeAverageNormals.insert( edgeAverageNormals.end(), EdgeAverageNormals::value_type( it->first, n ) );
+
+		it = groupEnd;
+	}
+
+	// only publish the results once we know the mesh is suitable
+	m_vertexAngleWeightedNormals = vertexAngleWeightedNormals;
+	m_edgeAverageNormals.swap( edgeAverageNormals );
+
+	m_haveAverageNormals = true;
+}
 
-	for ( VertexIndex vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
+void MeshPrimitiveEvaluator::calculateVertexNormals( const tbb::blocked_range<size_t> &range, const std::vector<int> &vertexTriangleOffsets, const std::vector<int> &vertexTriangles, std::vector<Imath::V3f> &normals ) const
+{
+	for ( VertexIndex vertexIndex = range.begin(); vertexIndex != (VertexIndex)range.end(); vertexIndex++)
 	{
 		Imath::V3f n( 0.0, 0.0, 0.0 );
 
-		const std::set<TriangleIndex> &connectedTriangles = vertexConnectivity[ vertexIndex ];
-
-		double angleTotal = 0.0;
-		for (std::set<TriangleIndex>::const_iterator faceIt = connectedTriangles.begin(); faceIt != connectedTriangles.end(); ++faceIt)
+		for( int i = vertexTriangleOffsets[vertexIndex]; i < vertexTriangleOffsets[vertexIndex+1]; ++i )
 		{
+			const TriangleIndex triangleIndex = vertexTriangles[i];
+			if( i > vertexTriangleOffsets[vertexIndex] && vertexTriangles[i-1] == triangleIndex )
+			{
+				// degenerate triangle referencing this vertex more than once
+				continue;
+			}
 
 			/// Find the vertices associated with this triangle
-			VertexIndex v0 = (*m_meshVertexIds)[ (*faceIt) * 3 + 0 ];
-			assert( vertexConnectivity[ v0 ].find( *faceIt ) != vertexConnectivity[ v0 ].end() );
-
-			VertexIndex v1 = (*m_meshVertexIds)[ (*faceIt) * 3 + 1 ];
-			assert( vertexConnectivity[ v1 ].find( *faceIt ) != vertexConnectivity[ v1 ].end() );
-
-			VertexIndex v2 = (*m_meshVertexIds)[ (*faceIt) * 3 + 2 ];
-			assert( vertexConnectivity[ v2 ].find( *faceIt ) != vertexConnectivity[ v2 ].end() );
+			VertexIndex v0 = (*m_meshVertexIds)[ triangleIndex * 3 + 0 ];
+			VertexIndex v1 = (*m_meshVertexIds)[ triangleIndex * 3 + 1 ];
+			VertexIndex v2 = (*m_meshVertexIds)[ triangleIndex * 3 + 2 ];
 
 			/// Find the two edges that go from the current vertex (i) to the other	two triangle vertices
 			Imath::V3f e0, e1;
@@ -562,7 +679,6 @@ void MeshPrimitiveEvaluator::calculateAverageNormals() const
 			double cosAngle = e0.dot( e1 );
 			double angle = acos( cosAngle );
 			assert( angle >= -Imath::limits<double>::epsilon() );
-			angleTotal += angle;
 
 			const Imath::V3f &p0 = m_verts->readable()[ v0 ];
 			const Imath::V3f &p1 = m_verts->readable()[ v1 ];
@@ -572,79 +688,8 @@ void MeshPrimitiveEvaluator::calculateAverageNormals() const
 
 		n.normalize();
 
-		assert(m_vertexAngleWeightedNormals);
-
-		m_vertexAngleWeightedNormals->writable().push_back( n );
+		normals[vertexIndex] = n;
 	}
-
-	assert( m_vertexAngleWeightedNormals->readable().size() == m_verts->readable().size()  );
-
-	/// Calculate edge connectivity. For any given pair of (connected) vertices we want to be able to find the faces connected to that edge.
-	typedef std::map<Edge, std::vector<int> > EdgeConnectivity;
-
-	EdgeConnectivity edgeConnectivity;
-
-	it = m_meshVertexIds->begin();
-	triangleIndex = 0;
-	while ( it != m_meshVertexIds->end() )
-	{
-		VertexIndex v0 = *it ++;
-		VertexIndex v1 = *it ++;
-		VertexIndex v2 = *it ++;
-
-		edgeConnectivity[ Edge(v0, v1) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v0, v2) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v1, v2) ].push_back( triangleIndex );
-
-		/// Store the same edges going in the opposite direction, too. This doubles our (small) storage overhead but allows for faster lookups.
-		edgeConnectivity[ Edge(v1, v0) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v2, v0) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v2, v1) ].push_back( triangleIndex );
-
-		triangleIndex ++;
-	}
-
-	/// Calculate the average edge normals
-	for (EdgeConnectivity::const_iterator it = edgeConnectivity.begin(); it != edgeConnectivity.end(); ++it)
-	{
-		if (it->second.size() > 2)
-		{
-			/// If there are more than 2 faces connected to any given edge then the mesh is non-manifold, which results in an exception.
-			throw Exception("Non-manifold mesh given to MeshPrimitiveImplicitSurfaceFunction");
-		}
-		else if (it->second.size() == 1)
-		{
-			/// If there are less than 2 faces connected to any given edge then the mesh is not closed, which results in an exception.
-			throw Exception("Mesh given to MeshPrimitiveImplicitSurfaceFunction is not closed");
-		}
-		else
-		{
-			assert( it->second.size() == 2 );
-		}
-
-		TriangleIndex triangle0 = it->second[0];
-		TriangleIndex triangle1 = it->second[1];
-
-		VertexIndex v00 = (*m_meshVertexIds)[ triangle0 * 3 + 0 ];
-		VertexIndex v01 = (*m_meshVertexIds)[ triangle0 * 3 + 1 ];
-		VertexIndex v02 = (*m_meshVertexIds)[ triangle0 * 3 + 2 ];
-
-		VertexIndex v10 = (*m_meshVertexIds)[ triangle1 * 3 + 0 ];
-		VertexIndex v11 = (*m_meshVertexIds)[ triangle1 * 3 + 1 ];
-		VertexIndex v12 = (*m_meshVertexIds)[ triangle1 * 3 + 2 ];
-
-		const Imath::V3f &p00 = m_verts->readable()[ v00 ];
-		const Imath::V3f &p01 = m_verts->readable()[ v01 ];
-		const Imath::V3f &p02 = m_verts->readable()[ v02 ];
-
-		const Imath::V3f &p10 = m_verts->readable()[ v10 ];
-		const Imath::V3f &p11 = m_verts->readable()[ v11 ];
-		const Imath::V3f &p12 = m_verts->readable()[ v12 ];
-
-		m_edgeAverageNormals[ it->first ] = ( triangleNormal( p00, p01, p02 ) + triangleNormal( p10, p11, p12 ) ) / 2.0f;
-	}
-
-	m_haveAverageNormals = true;
 }
 
 bool MeshPrimitiveEvaluator::signedDistance( const Imath::V3f &p, float &distance, PrimitiveEvaluator::Result *result ) const
@@ -766,12 +811,17 @@ bool MeshPrimitiveEvaluator::closestPoint( const V3f &p, PrimitiveEvaluator::Res
 		return false;
 	}
 
-	assert( m_tree );
-
 	Result *mr = static_cast<Result *>( result );
 
 	float maxDistSqrd = limits<float>::max();
 
+	if( m_bvh )
+	{
+		closestPointBVHWalk( p, maxDistSqrd, mr );
+		return true;
+	}
+
+	assert( m_tree );
 	closestPointWalk( m_tree->rootIndex(), p, maxDistSqrd, mr );
 
 	return true;
@@ -802,8 +852,6 @@ bool MeshPrimitiveEvaluator::intersectionPoint( const Imath::V3f &origin, const
 		return false;
 	}
 
-	assert( m_tree );
-
 	Result *mr = static_cast<Result *>( result );
 
 	float maxDistSqrd = maxDistance * maxDistance;
@@ -812,8 +860,14 @@ bool MeshPrimitiveEvaluator::intersectionPoint( const Imath::V3f &origin, const
 	ray.pos = origin;
 	ray.dir = direction.normalized();
 
+	if( m_bvh )
+	{
+		return intersectionPointBVHWalk( ray, maxDistSqrd, mr );
+	}
+
 	bool hit = false;
 
+	assert( m_tree );
 	intersectionPointWalk( m_tree->rootIndex(), ray, maxDistSqrd, mr, hit );
 	return hit;
 }
@@ -828,15 +882,21 @@ int MeshPrimitiveEvaluator::intersectionPoints( const Imath::V3f &origin, const
 		return 0;
 	}
 
-	assert( m_tree );
-
 	float maxDistSqrd = maxDistance * maxDistance;
 
 	Imath::Line3f ray;
 	ray.pos = origin;
 	ray.dir = direction.normalized();
 
-	intersectionPointsWalk( m_tree->rootIndex(), ray, maxDistSqrd, results );
+	if( m_bvh )
+	{
+		intersectionPointsBVHWalk( ray, maxDistSqrd, results );
+	}
+	else
+	{
+		assert( m_tree );
+		intersectionPointsWalk( m_tree->rootIndex(), ray, maxDistSqrd, results );
+	}
 
 	return results.size();
 }
@@ -882,8 +942,8 @@ void MeshPrimitiveEvaluator::closestPointWalk( TriangleBoundTree::NodeIndex node
 	const TriangleBoundTree::Node &node = m_tree->node( nodeIndex );
 	if( node.isLeaf() )
 	{
-		TriangleBoundTree::Iterator *permLast = node.permLast();
-		for( TriangleBoundTree::Iterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const TriangleBoundTree::Iterator *permLast = m_tree->permLast( nodeIndex );
+		for( const TriangleBoundTree::Iterator *perm = m_tree->permFirst( nodeIndex ); perm!=permLast; perm++ )
 		{
 			size_t triangleIndex = *perm - m_triangles.begin(); // triangle index is just the distance of the triangle from the beginning of the vector
 			size_t vertIdOffset = triangleIndex * 3;
@@ -982,8 +1042,8 @@ bool MeshPrimitiveEvaluator::pointAtUVWalk( UVBoundTree::NodeIndex nodeIndex, co
 	if( node.isLeaf() )
 	{
 		
-		UVBoundTree::Iterator *permLast = node.permLast();
-		for( UVBoundTree::Iterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const UVBoundTree::Iterator *permLast = m_uvTree->permLast( nodeIndex );
+		for( const UVBoundTree::Iterator *perm = m_uvTree->permFirst( nodeIndex ); perm!=permLast; perm++ )
 		{
 			size_t triangleIndex = *perm - m_uvTriangles.begin(); // triangle index is just the distance of the triangle from the beginning of the vector
 			size_t vertIdOffset = triangleIndex * 3;
@@ -1044,10 +1104,10 @@ bool MeshPrimitiveEvaluator::intersectionPointWalk( TriangleBoundTree::NodeIndex
 
 	if( node.isLeaf() )
 	{
-		TriangleBoundTree::Iterator *permLast = node.permLast();
+		const TriangleBoundTree::Iterator *permLast = m_tree->permLast( nodeIndex );
 		bool intersects = false;
 
-		for( TriangleBoundTree::Iterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		for( const TriangleBoundTree::Iterator *perm = m_tree->permFirst( nodeIndex ); perm!=permLast; perm++ )
 		{
 			size_t triangleIndex = *perm - m_triangles.begin(); // triangle index is just the distance of the triangle from the beginning of the vector
 			size_t vertIdOffset = triangleIndex * 3;
@@ -1204,9 +1264,9 @@ void MeshPrimitiveEvaluator::intersectionPointsWalk( TriangleBoundTree::NodeInde
 
 	if( node.isLeaf() )
 	{
-		TriangleBoundTree::Iterator *permLast = node.permLast();
+		const TriangleBoundTree::Iterator *permLast = m_tree->permLast( nodeIndex );
 
-		for( TriangleBoundTree::Iterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		for( const TriangleBoundTree::Iterator *perm = m_tree->permFirst( nodeIndex ); perm!=permLast; perm++ )
 		{
 			size_t triangleIndex = *perm - m_triangles.begin(); // triangle index is just the distance of the triangle from the beginning of the vector
 			size_t vertIdOffset = triangleIndex * 3;
@@ -1284,6 +1344,235 @@ void MeshPrimitiveEvaluator::intersectionPointsWalk( TriangleBoundTree::NodeInde
 	}
 }
 
+void MeshPrimitiveEvaluator::closestPointBVHWalk( const Imath::V3f &p, float &closestDistanceSqrd, Result *result ) const
+{
+	assert( m_bvh );
+
+	// Nodes yet to be visited, along with the squared distance
+	// from p to their bounds.
+	std::pair<TriangleBVH::NodeIndex, float> stack[TriangleBVH::maxDepth + 1];
+	int stackSize = 0;
+	stack[stackSize++] = std::make_pair( m_bvh->rootIndex(), 0.0f );
+
+	while( stackSize )
+	{
+		const std::pair<TriangleBVH::NodeIndex, float> entry = stack[--stackSize];
+		if( entry.second >= closestDistanceSqrd )
+		{
+			continue;
+		}
+
+		const TriangleBVH::Node &node = m_bvh->node( entry.first );
+		if( node.isLeaf() )
+		{
+			const TriangleBVH::Iterator *permLast = m_bvh->permLast( entry.first );
+			for( const TriangleBVH::Iterator *perm = m_bvh->permFirst( entry.first ); perm != permLast; ++perm )
+			{
+				const size_t triangleIndex = *perm - m_triangles.begin();
+				const V3i vertexIds = triangleVertexIds( triangleIndex );
+				const V3f &p0 = m_verts->readable()[vertexIds[0]];
+				const V3f &p1 = m_verts->readable()[vertexIds[1]];
+				const V3f &p2 = m_verts->readable()[vertexIds[2]];
+
+				V3f bary;
+				const float dSqrd = triangleClosestBarycentric( p0, p1, p2, p, bary );
+				if( dSqrd < closestDistanceSqrd )
+				{
+					closestDistanceSqrd = dSqrd;
+					setResult( result, triangleIndex, vertexIds, bary, trianglePoint( p0, p1, p2, bary ) );
+				}
+			}
+		}
+		else
+		{
+			// Push the farthest child first, so that the closest is visited next.
+			const TriangleBVH::NodeIndex lowIndex = m_bvh->lowChildIndex( entry.first );
+			const TriangleBVH::NodeIndex highIndex = m_bvh->highChildIndex( entry.first );
+			const float dLow = vecDistance2( closestPointInBox( p, m_bvh->node( lowIndex ).bound() ), p );
+			const float dHigh = vecDistance2( closestPointInBox( p, m_bvh->node( highIndex ).bound() ), p );
+			if( dLow < dHigh )
+			{
+				stack[stackSize++] = std::make_pair( highIndex, dHigh );
+				stack[stackSize++] = std::make_pair( lowIndex, dLow );
+			}
+			else
+			{
+				stack[stackSize++] = std::make_pair( lowIndex, dLow );
+				stack[stackSize++] = std::make_pair( highIndex, dHigh );
+			}
+		}
+	}
+}
+
+bool MeshPrimitiveEvaluator::intersectionPointBVHWalk( const Imath::Line3f &ray, float &maxDistSqrd, Result *result ) const
+{
+	assert( m_bvh );
+
+	const Detail::RayBoxIntersector rayBox( ray );
+	float maxDist = sqrtf( maxDistSqrd );
+	bool hit = false;
+
+	// Nodes yet to be visited, along with the distance
+	// at which the ray enters their bounds.
+	std::pair<TriangleBVH::NodeIndex, float> stack[TriangleBVH::maxDepth + 1];
+	int stackSize = 0;
+	float tNear;
+	if( rayBox.intersects( m_bvh->node( m_bvh->rootIndex() ).bound(), maxDist, tNear ) )
+	{
+		stack[stackSize++] = std::make_pair( m_bvh->rootIndex(), tNear );
+	}
+
+	while( stackSize )
+	{
+		const std::pair<TriangleBVH::NodeIndex, float> entry = stack[--stackSize];
+		if( entry.second > maxDist )
+		{
+			continue;
+		}
+
+		const TriangleBVH::Node &node = m_bvh->node( entry.first );
+		if( node.isLeaf() )
+		{
+			const TriangleBVH::Iterator *permLast = m_bvh->permLast( entry.first );
+			for( const TriangleBVH::Iterator *perm = m_bvh->permFirst( entry.first ); perm != permLast; ++perm )
+			{
+				const size_t triangleIndex = *perm - m_triangles.begin();
+				const V3i vertexIds = triangleVertexIds( triangleIndex );
+
+				V3f hitPoint, bary;
+				bool front;
+				if( triangleRayIntersection( m_verts->readable()[vertexIds[0]], m_verts->readable()[vertexIds[1]], m_verts->readable()[vertexIds[2]], ray.pos, ray.dir, hitPoint, bary, front ) )
+				{
+					const float dSqrd = vecDistance2( hitPoint, ray.pos );
+					if( dSqrd < maxDistSqrd )
+					{
+						maxDistSqrd = dSqrd;
+						maxDist = sqrtf( dSqrd );
+						setResult( result, triangleIndex, vertexIds, bary, hitPoint );
+						hit = true;
+					}
+				}
+			}
+		}
+		else
+		{
+			// Push the farthest child first, so that the closest is visited next.
+			const TriangleBVH::NodeIndex lowIndex = m_bvh->lowChildIndex( entry.first );
+			const TriangleBVH::NodeIndex highIndex = m_bvh->highChildIndex( entry.first );
+			float tLow, tHigh;
+			const bool lowHit = rayBox.intersects( m_bvh->node( lowIndex ).bound(), maxDist, tLow );
+			const bool highHit = rayBox.intersects( m_bvh->node( highIndex ).bound(), maxDist, tHigh );
+			if( lowHit && highHit )
+			{
+				if( tLow < tHigh )
+				{
+					stack[stackSize++] = std::make_pair( highIndex, tHigh );
+					stack[stackSize++] = std::make_pair( lowIndex, tLow );
+				}
+				else
+				{
+					stack[stackSize++] = std::make_pair( lowIndex, tLow );
+					stack[stackSize++] = std::make_pair( highIndex, tHigh );
+				}
+			}
+			else if( lowHit )
+			{
+				stack[stackSize++] = std::make_pair( lowIndex, tLow );
+			}
+			else if( highHit )
+			{
+				stack[stackSize++] = std::make_pair( highIndex, tHigh );
+			}
+		}
+	}
+
+	return hit;
+}
+
+void MeshPrimitiveEvaluator::intersectionPointsBVHWalk( const Imath::Line3f &ray, float maxDistSqrd, std::vector<PrimitiveEvaluator::ResultPtr> &results ) const
+{
+	assert( m_bvh );
+
+	const Detail::RayBoxIntersector rayBox( ray );
+	const float maxDist = sqrtf( maxDistSqrd );
+
+	TriangleBVH::NodeIndex stack[TriangleBVH::maxDepth + 1];
+	int stackSize = 0;
+	stack[stackSize++] = m_bvh->rootIndex();
+
+	while( stackSize )
+	{
+		const TriangleBVH::NodeIndex nodeIndex = stack[--stackSize];
+		float tNear;
+		if( !rayBox.intersects( m_bvh->node( nodeIndex ).bound(), maxDist, tNear ) )
+		{
+			continue;
+		}
+
+		const TriangleBVH::Node &node = m_bvh->node( nodeIndex );
+		if( node.isLeaf() )
+		{
+			const TriangleBVH::Iterator *permLast = m_bvh->permLast( nodeIndex );
+			for( const TriangleBVH::Iterator *perm = m_bvh->permFirst( nodeIndex ); perm != permLast; ++perm )
+			{
+				const size_t triangleIndex = *perm - m_triangles.begin();
+				const V3i vertexIds = triangleVertexIds( triangleIndex );
+
+				V3f hitPoint, bary;
+				bool front;
+				if( triangleRayIntersection( m_verts->readable()[vertexIds[0]], m_verts->readable()[vertexIds[1]], m_verts->readable()[vertexIds[2]], ray.pos, ray.dir, hitPoint, bary, front ) )
+				{
+					if( vecDistance2( hitPoint, ray.pos ) < maxDistSqrd )
+					{
+						ResultPtr result = new Result();
+						setResult( result.get(), triangleIndex, vertexIds, bary, hitPoint );
+						results.push_back( result );
+					}
+				}
+			}
+		}
+		else
+		{
+			stack[stackSize++] = m_bvh->highChildIndex( nodeIndex );
+			stack[stackSize++] = m_bvh->lowChildIndex( nodeIndex );
+		}
+	}
+}
+
+Imath::V3i MeshPrimitiveEvaluator::triangleVertexIds( size_t triangleIndex ) const
+{
+	const size_t vertIdOffset = triangleIndex * 3;
+	const Imath::V3i result( (*m_meshVertexIds)[vertIdOffset], (*m_meshVertexIds)[vertIdOffset+1], (*m_meshVertexIds)[vertIdOffset+2] );
+
+	assert( result[0] < (int)( m_verts->readable().size() ) );
+	assert( result[1] < (int)( m_verts->readable().size() ) );
+	assert( result[2] < (int)( m_verts->readable().size() ) );
+
+	return result;
+}
+
+void MeshPrimitiveEvaluator::setResult( Result *result, size_t triangleIndex, const Imath::V3i &vertexIds, const Imath::V3f &barycentricCoordinates, const Imath::V3f &p ) const
+{
+	result->m_bary = barycentricCoordinates;
+	result->m_vertexIds = vertexIds;
+	result->m_triangleIdx = triangleIndex;
+	result->m_p = p;
+
+	if ( m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid )
+	{
+		result->m_uv = V2f(
+			result->floatPrimVar( m_u ),
+			result->floatPrimVar( m_v )
+		);
+	}
+
+	result->m_n = triangleNormal(
+		m_verts->readable()[vertexIds[0]],
+		m_verts->readable()[vertexIds[1]],
+		m_verts->readable()[vertexIds[2]]
+	);
+}
+
 const Imath::Box2f MeshPrimitiveEvaluator::uvBound() const
 {
 	if( !m_uvTree )
@@ -1303,6 +1592,11 @@ const MeshPrimitiveEvaluator::TriangleBoundTree *MeshPrimitiveEvaluator::triangl
 	return m_tree;
 }
 
+const MeshPrimitiveEvaluator::TriangleBVH *MeshPrimitiveEvaluator::triangleBVH() const
+{
+	return m_bvh;
+}
+
 const MeshPrimitiveEvaluator::UVBoundVector *MeshPrimitiveEvaluator::uvBounds() const
 {
 	return m_uvTree ? &m_uvTriangles : 0;
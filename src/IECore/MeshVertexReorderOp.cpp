@@ -35,9 +35,12 @@
 #include "IECore/CompoundParameter.h"
 #include "IECore/MeshVertexReorderOp.h"
 #include "IECore/DespatchTypedData.h"
+#include "IECore/MeshAlgo.h"
 
 #include "boost/format.hpp"
 
+#include <cmath>
+
 using namespace IECore;
 using namespace std;
 
@@ -45,12 +48,26 @@ IE_CORE_DEFINERUNTIMETYPED( MeshVertexReorderOp );
 
 MeshVertexReorderOp::MeshVertexReorderOp() : MeshPrimitiveOp( "Calculates vertex normals for a mesh." )
 {
+	IntParameter::PresetsContainer modePresets;
+	modePresets.push_back( IntParameter::Preset( "Topological", Topological ) );
+	modePresets.push_back( IntParameter::Preset( "VertexCache", VertexCache ) );
+
+	m_modeParameter = new IntParameter(
+		"mode",
+		"Topological mode orders the mesh by traversing it from the starting vertices. VertexCache mode "
+		"orders the faces for efficient GPU vertex cache use, and the vertices by their first use.",
+		Topological,
+		modePresets,
+		true
+	);
+
 	m_startingVerticesParameter = new V3iParameter(
 	        "startingVertices",
 	        "startingVertices description",
 	        Imath::V3i( 0, 1, 2 )
 	);
 
+	parameters()->addParameter( m_modeParameter );
 	parameters()->addParameter( m_startingVerticesParameter );
 }
 
@@ -58,6 +75,16 @@ MeshVertexReorderOp::~MeshVertexReorderOp()
 {
 }
 
+IntParameter * MeshVertexReorderOp::modeParameter()
+{
+	return m_modeParameter.get();
+}
+
+const IntParameter * MeshVertexReorderOp::modeParameter() const
+{
+	return m_modeParameter.get();
+}
+
 V3iParameter * MeshVertexReorderOp::startingVerticesParameter()
 {
 	return m_startingVerticesParameter.get();
@@ -358,6 +385,20 @@ void MeshVertexReorderOp::modifyTypedPrimitive( MeshPrimitive * mesh, const Comp
 		throw InvalidArgumentException( "MeshVertexReorderOp : \"P\" primitive variable is invalid." );
 	}
 
+	if ( m_modeParameter->getNumericValue() == VertexCache )
+	{
+		reorderForVertexCache( mesh );
+	}
+	else
+	{
+		reorderTopological( mesh );
+	}
+
+	assert( mesh->arePrimitiveVariablesValid() );
+}
+
+void MeshVertexReorderOp::reorderTopological( MeshPrimitive * mesh )
+{
 	buildInternalTopology( mesh );
 
 	Imath::V3i faceVtxSrc = m_startingVerticesParameter->getTypedValue();
@@ -436,34 +477,249 @@ void MeshVertexReorderOp::modifyTypedPrimitive( MeshPrimitive * mesh, const Comp
 	assert( newVertexIds.size() == mesh->vertexIds()->readable().size() );
 	mesh->setTopology( new IntVectorData( newVerticesPerFace ), new IntVectorData( newVertexIds ) );
 
+	reorderPrimitiveVariables( mesh, vertexRemap, faceVaryingRemap, faceRemap );
+}
+
+namespace
+{
+
+// Vertex cache optimisation after Tom Forsyth's "Linear-Speed Vertex Cache
+// Optimisation". Faces are emitted greedily, each time choosing the face whose
+// vertices score highest. Vertices score highly if they are near the front of a
+// simulated LRU cache, or if few unemitted faces remain to use them, so that
+// they are finished with and need not be reloaded later.
+
+const int g_cacheSize = 32;
+const float g_cacheDecayPower = 1.5f;
+const float g_lastFaceScore = 0.75f;
+const float g_valenceBoostScale = 2.0f;
+const float g_valenceBoostPower = 0.5f;
+
+float vertexScore( int cachePosition, unsigned remainingFaces )
+{
+	if ( !remainingFaces )
+	{
+		// no faces left to use this vertex
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if ( cachePosition >= 0 )
+	{
+		if ( cachePosition < 3 )
+		{
+			// used by the last face - a fixed score avoids
+			// favouring strips over more compact orderings
+			score = g_lastFaceScore;
+		}
+		else
+		{
+			score = powf( 1.0f - (float)( cachePosition - 3 ) / (float)( g_cacheSize - 3 ), g_cacheDecayPower );
+		}
+	}
+
+	return score + g_valenceBoostScale * powf( (float)remainingFaces, -g_valenceBoostPower );
+}
+
+} // namespace
+
+void MeshVertexReorderOp::reorderForVertexCache( MeshPrimitive * mesh )
+{
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const int numFaces = verticesPerFace.size();
+	const int numVerts = mesh->variableSize( PrimitiveVariable::Vertex );
+
+	ConstCompoundDataPtr topology = MeshAlgo::topology( mesh );
+	const std::vector<int> &faceOffsets = topology->member<IntVectorData>( "faceOffsets" )->readable();
+	const std::vector<unsigned int> &vertexFaceOffsets = topology->member<UIntVectorData>( "vertexFaceOffsets" )->readable();
+	const std::vector<unsigned int> &vertexFaces = topology->member<UIntVectorData>( "vertexFaces" )->readable();
+
+	// initial scores
+
+	std::vector<unsigned> remainingFaces( numVerts );
+	std::vector<int> cachePositions( numVerts, -1 );
+	std::vector<float> vertexScores( numVerts );
+	for ( int v = 0; v < numVerts; ++v )
+	{
+		remainingFaces[v] = vertexFaceOffsets[v+1] - vertexFaceOffsets[v];
+		vertexScores[v] = vertexScore( -1, remainingFaces[v] );
+	}
+
+	std::vector<float> faceScores( numFaces, 0.0f );
+	for ( int f = 0; f < numFaces; ++f )
+	{
+		for ( int i = faceOffsets[f], e = faceOffsets[f] + verticesPerFace[f]; i < e; ++i )
+		{
+			faceScores[f] += vertexScores[vertexIds[i]];
+		}
+	}
+
+	// emit faces
+
+	std::vector<int> faceOrder;
+	faceOrder.reserve( numFaces );
+	std::vector<char> emitted( numFaces, 0 );
+	std::vector<int> cache;
+	std::vector<int> newCache;
+	std::vector<unsigned> stamps( numVerts, 0 );
+	unsigned stamp = 0;
+	int nextUnemitted = 0;
+	int bestFace = -1;
+
+	while ( (int)faceOrder.size() < numFaces )
+	{
+		if ( bestFace < 0 )
+		{
+			// nothing in the cache is useful, so start
+			// again from the first remaining face
+			while ( emitted[nextUnemitted] )
+			{
+				++nextUnemitted;
+			}
+			bestFace = nextUnemitted;
+		}
+
+		emitted[bestFace] = 1;
+		faceOrder.push_back( bestFace );
+
+		// move the face's vertices to the front of the cache
+
+		++stamp;
+		newCache.clear();
+		for ( int i = faceOffsets[bestFace], e = faceOffsets[bestFace] + verticesPerFace[bestFace]; i < e; ++i )
+		{
+			const int v = vertexIds[i];
+			remainingFaces[v]--;
+			if ( stamps[v] != stamp )
+			{
+				stamps[v] = stamp;
+				newCache.push_back( v );
+			}
+		}
+		for ( std::vector<int>::const_iterator it = cache.begin(); it != cache.end(); ++it )
+		{
+			if ( stamps[*it] != stamp )
+			{
+				newCache.push_back( *it );
+			}
+		}
+
+		// update the scores of everything that was or is in the cache,
+		// propagating the changes to the faces, and find the best face
+		// amongst those using cached vertices.
+
+		float bestScore = -1.0f;
+		bestFace = -1;
+		for ( int c = 0, ce = newCache.size(); c < ce; ++c )
+		{
+			const int v = newCache[c];
+			cachePositions[v] = c < g_cacheSize ? c : -1;
+			const float score = vertexScore( cachePositions[v], remainingFaces[v] );
+			const float delta = score - vertexScores[v];
+			vertexScores[v] = score;
+
+			for ( unsigned i = vertexFaceOffsets[v]; i < vertexFaceOffsets[v+1]; ++i )
+			{
+				const int f = vertexFaces[i];
+				if ( emitted[f] )
+				{
+					continue;
+				}
+				faceScores[f] += delta;
+				if ( c < g_cacheSize && faceScores[f] > bestScore )
+				{
+					bestScore = faceScores[f];
+					bestFace = f;
+				}
+			}
+		}
+
+		if ( (int)newCache.size() > g_cacheSize )
+		{
+			newCache.resize( g_cacheSize );
+		}
+		cache.swap( newCache );
+	}
+
+	// number the vertices in order of first use, with any unused
+	// vertices following on in their original order.
+
+	std::vector<int> vertexMap( numVerts, -1 );
+	std::vector<int> vertexRemap;
+	vertexRemap.reserve( numVerts );
+	std::vector<int> newVerticesPerFace;
+	newVerticesPerFace.reserve( numFaces );
+	std::vector<int> newVertexIds;
+	newVertexIds.reserve( vertexIds.size() );
+	std::vector<int> faceVaryingRemap;
+	faceVaryingRemap.reserve( vertexIds.size() );
+
+	for ( std::vector<int>::const_iterator it = faceOrder.begin(); it != faceOrder.end(); ++it )
+	{
+		newVerticesPerFace.push_back( verticesPerFace[*it] );
+		for ( int i = faceOffsets[*it], e = faceOffsets[*it] + verticesPerFace[*it]; i < e; ++i )
+		{
+			const int v = vertexIds[i];
+			if ( vertexMap[v] == -1 )
+			{
+				vertexMap[v] = vertexRemap.size();
+				vertexRemap.push_back( v );
+			}
+			newVertexIds.push_back( vertexMap[v] );
+			faceVaryingRemap.push_back( i );
+		}
+	}
+
+	for ( int v = 0; v < numVerts; ++v )
+	{
+		if ( vertexMap[v] == -1 )
+		{
+			vertexRemap.push_back( v );
+		}
+	}
+
+	mesh->setTopologyUnchecked( new IntVectorData( newVerticesPerFace ), new IntVectorData( newVertexIds ), numVerts, mesh->interpolation() );
+
+	reorderPrimitiveVariables( mesh, vertexRemap, faceVaryingRemap, faceOrder );
+}
+
+void MeshVertexReorderOp::reorderPrimitiveVariables( MeshPrimitive * mesh, const std::vector<int> &vertexRemap, const std::vector<int> &faceVaryingRemap, const std::vector<int> &uniformRemap )
+{
 	ReorderFn vertexFn( vertexRemap );
 	ReorderFn faceVaryingFn( faceVaryingRemap );
-	ReorderFn uniformFn( faceRemap );
+	ReorderFn uniformFn( uniformRemap );
 
 	for ( PrimitiveVariableMap::iterator it = mesh->variables.begin(); it != mesh->variables.end(); ++it )
 	{
+		ReorderFn *fn = 0;
 		if ( it->second.interpolation == PrimitiveVariable::FaceVarying )
 		{
-			assert( it->second.data );
-
-			faceVaryingFn.m_name = it->first;
-			it->second.data = despatchTypedData<ReorderFn, TypeTraits::IsVectorTypedData>( it->second.data.get(), faceVaryingFn );
+			fn = &faceVaryingFn;
 		}
 		else if ( it->second.interpolation == PrimitiveVariable::Vertex || it->second.interpolation == PrimitiveVariable::Varying )
 		{
-			assert( it->second.data );
-
-			vertexFn.m_name = it->first;
-			it->second.data = despatchTypedData<ReorderFn, TypeTraits::IsVectorTypedData>( it->second.data.get(), vertexFn );
+			fn = &vertexFn;
 		}
 		else if ( it->second.interpolation == PrimitiveVariable::Uniform )
 		{
-			assert( it->second.data );
+			fn = &uniformFn;
+		}
+		else
+		{
+			continue;
+		}
 
-			uniformFn.m_name = it->first;
-			it->second.data = despatchTypedData<ReorderFn, TypeTraits::IsVectorTypedData>( it->second.data.get(), uniformFn );
+		assert( it->second.data );
+		fn->m_name = it->first;
+		if ( it->second.indices )
+		{
+			// indexed values are shared, so only the indices need reordering
+			it->second.indices = runTimeCast<IntVectorData>( (*fn)( it->second.indices.get() ) );
+		}
+		else
+		{
+			it->second.data = despatchTypedData<ReorderFn, TypeTraits::IsVectorTypedData>( it->second.data.get(), *fn );
 		}
 	}
-
-	assert( mesh->arePrimitiveVariablesValid() );
 }
@@ -45,8 +45,46 @@
 #include "IECore/SmoothSkinningData.h"
 #include "IECore/SimpleTypedData.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Mixes a range of weights, using the mixing weight for the
+// corresponding influence.
+class WeightMixer
+{
+
+	public :
+
+		WeightMixer( const std::vector<float> &mixingWeights, const std::vector<int> &influenceIndices, const std::vector<float> &mixingInfluenceWeights, std::vector<float> &influenceWeights )
+			:	m_mixingWeights( mixingWeights ), m_influenceIndices( influenceIndices ), m_mixingInfluenceWeights( mixingInfluenceWeights ), m_influenceWeights( influenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			LinearInterpolator<float> lerp;
+			for ( size_t current = r.begin(); current != r.end(); ++current )
+			{
+				lerp( m_mixingInfluenceWeights[current], m_influenceWeights[current], m_mixingWeights[ m_influenceIndices[current] ], m_influenceWeights[current] );
+			}
+		}
+
+	private :
+
+		const std::vector<float> &m_mixingWeights;
+		const std::vector<int> &m_influenceIndices;
+		const std::vector<float> &m_mixingInfluenceWeights;
+		std::vector<float> &m_influenceWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( MixSmoothSkinningWeightsOp );
 
 MixSmoothSkinningWeightsOp::MixSmoothSkinningWeightsOp()
@@ -131,25 +169,16 @@ void MixSmoothSkinningWeightsOp::modify( Object * object, const CompoundObject *
 		throw IECore::Exception( "MixSmoothSkinningWeightsOp: skinningDataToMix and input have different pointInfluenceIndices when decompressed" );
 	}
 	
-	const std::vector<int> &inputIndexOffsets = skinningData->pointIndexOffsets()->readable();
-	const std::vector<int> &inputInfluenceCounts = skinningData->pointInfluenceCounts()->readable();
 	const std::vector<int> &inputInfluenceIndices = skinningData->pointInfluenceIndices()->readable();
 	
 	std::vector<float> &inputInfluenceWeights = skinningData->pointInfluenceWeights()->writable();
 	const std::vector<float> &mixingInfluenceWeights = mixingData->pointInfluenceWeights()->readable();
 	
-	LinearInterpolator<float> lerp;
-	
-	// mix the weights
-	for ( unsigned i=0; i < inputIndexOffsets.size(); i++ )
-	{
-		for ( int j=0; j < inputInfluenceCounts[i]; j++ )
-		{
-			int current = inputIndexOffsets[i] + j;
-			
-			lerp( mixingInfluenceWeights[current], inputInfluenceWeights[current], mixingWeights[ inputInfluenceIndices[current] ], inputInfluenceWeights[current] );
-		}
-	}
+	// mix the weights. the data is decompressed, so every weight belongs to a point.
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, inputInfluenceWeights.size(), 4096 ),
+		WeightMixer( mixingWeights, inputInfluenceIndices, mixingInfluenceWeights, inputInfluenceWeights )
+	);
 	
 	// re-compress the input data
 	CompressSmoothSkinningDataOp compressionOp;
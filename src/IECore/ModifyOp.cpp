@@ -99,7 +99,7 @@ const BoolParameter *ModifyOp::enableParameter() const
 ObjectPtr ModifyOp::doOperation( const CompoundObject *operands )
 {
 	ObjectPtr object = m_inputParameter->getValue();
-	if( m_copyParameter->getTypedValue() )
+	if( m_copyParameter->getTypedValue() && !uniquelyReferenced( object.get(), operands ) )
 	{
 		object = object->copy();
 	}
@@ -109,3 +109,34 @@ ObjectPtr ModifyOp::doOperation( const CompoundObject *operands )
 	}
 	return object;
 }
+
+bool ModifyOp::resultCacheable( const CompoundObject *operands ) const
+{
+	return m_copyParameter->getTypedValue();
+}
+
+bool ModifyOp::uniquelyReferenced( const Object *object, const CompoundObject *operands ) const
+{
+	// Account for every reference we know of. Anything else holding a reference
+	// means we must copy, as it would see the modification.
+	// - the input parameter itself, and the `object` pointer in doOperation().
+	size_t knownReferences = 2;
+	// - the value of the parameters() compound, which getValue() brings up to date.
+	const CompoundObject *parametersValue = runTimeCast<const CompoundObject>( parameters()->getValue() );
+	if( parametersValue && parametersValue->member<Object>( m_inputParameter->name() ) == object )
+	{
+		knownReferences++;
+	}
+	// - the operands, if they were passed to operate() separately.
+	if( operands && operands != parametersValue && operands->member<Object>( m_inputParameter->name() ) == object )
+	{
+		knownReferences++;
+	}
+	// - the result of the last operation, if we modified this object in place then.
+	if( resultParameter()->getValue() == object )
+	{
+		knownReferences++;
+	}
+
+	return object->refCount() == (RefCounted::RefCount)knownReferences;
+}
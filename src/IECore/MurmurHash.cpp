@@ -34,11 +34,60 @@
 
 #include <iomanip>
 #include <sstream>
+#include <cstring>
 
 #include "IECore/MurmurHash.h"
 
 using namespace IECore;
 
+namespace
+{
+
+const uint64_t c1 = 0x87c37b91114253d5;
+const uint64_t c2 = 0x4cf5ad432745937f;
+
+// One lane of the bulk hash. Each lane is a standard MurmurHash3
+// accumulator, fed with every fourth 16 byte block of the input.
+struct Lane
+{
+
+	Lane( uint64_t seed1, uint64_t seed2 )
+		:	h1( seed1 ), h2( seed2 )
+	{
+	}
+
+	inline void block( uint64_t k1, uint64_t k2 )
+	{
+		k1 *= c1; k1  = rotl64( k1, 31 ); k1 *= c2; h1 ^= k1;
+
+		h1 = rotl64( h1, 27 ); h1 += h2; h1 = h1*5 + 0x52dce729;
+
+		k2 *= c2; k2  = rotl64( k2, 33 ); k2 *= c1; h2 ^= k2;
+
+		h2 = rotl64( h2, 31); h2 += h1; h2 = h2*5 + 0x38495ab5;
+	}
+
+	inline void finalise( uint64_t bytes )
+	{
+		h1 ^= bytes; h2 ^= bytes;
+
+		h1 += h2;
+		h2 += h1;
+
+		h1 = fmix( h1 );
+		h2 = fmix( h2 );
+
+		h1 += h2;
+		h2 += h1;
+	}
+
+	uint64_t h1;
+	uint64_t h2;
+
+};
+
+} // namespace
+
 MurmurHash::MurmurHash()
 	:	m_h1( 0 ), m_h2( 0 )
 {
@@ -49,6 +98,50 @@ MurmurHash::MurmurHash( const MurmurHash &other )
 {
 }
 
+void MurmurHash::appendBulk( const void *data, size_t bytes )
+{
+	// The serial algorithm is limited by the dependency of each block
+	// on the result of the last, so we interleave four independent
+	// lanes, each hashing every fourth block. These are then combined,
+	// along with any remaining tail, using the standard append.
+
+	const size_t nStripes = bytes / 64;
+
+	Lane l0( m_h1, m_h2 );
+	Lane l1( m_h1 + 1, m_h2 + 1 );
+	Lane l2( m_h1 + 2, m_h2 + 2 );
+	Lane l3( m_h1 + 3, m_h2 + 3 );
+
+	const char *stripe = (const char *)data;
+	for( size_t i = 0; i < nStripes; ++i, stripe += 64 )
+	{
+		// memcpy rather than casting, because there are no
+		// alignment guarantees for the data. the compiler
+		// turns this into plain loads.
+		uint64_t k[8];
+		memcpy( k, stripe, 64 );
+		l0.block( k[0], k[1] );
+		l1.block( k[2], k[3] );
+		l2.block( k[4], k[5] );
+		l3.block( k[6], k[7] );
+	}
+
+	const uint64_t laneBytes = nStripes * 16;
+	l0.finalise( laneBytes );
+	l1.finalise( laneBytes );
+	l2.finalise( laneBytes );
+	l3.finalise( laneBytes );
+
+	const uint64_t lanes[8] = { l0.h1, l0.h2, l1.h1, l1.h2, l2.h1, l2.h2, l3.h1, l3.h2 };
+	append( lanes, 8 );
+
+	const size_t tailBytes = bytes - nStripes * 64;
+	if( tailBytes )
+	{
+		append( stripe, tailBytes, 1 );
+	}
+}
+
 std::string MurmurHash::toString() const
 {
 	std::stringstream s;
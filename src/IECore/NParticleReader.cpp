@@ -40,10 +40,12 @@
 #include "IECore/FileNameParameter.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/Timer.h"
+#include "IECore/LRUCache.h"
 
 #include "OpenEXR/ImathRandom.h"
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include <algorithm>
 #include <fstream>
@@ -56,6 +58,73 @@ using namespace std;
 
 IE_CORE_DEFINERUNTIMETYPED( NParticleReader );
 
+namespace
+{
+
+// Opened files are shared between readers, so that the chunk index
+// built while reading one frame can be reused when reading the next.
+// This makes random access to frames during playback much cheaper.
+
+std::time_t modificationTime( const std::string &fileName )
+{
+	try
+	{
+		return boost::filesystem::last_write_time( fileName );
+	}
+	catch( ... )
+	{
+		return 0;
+	}
+}
+
+struct CachedFile
+{
+	IFFFilePtr file;
+	std::time_t modificationTime;
+};
+
+CachedFile fileCacheGetter( const std::string &fileName, size_t &cost )
+{
+	CachedFile result;
+	result.modificationTime = modificationTime( fileName );
+	result.file = new IFFFile( fileName );
+	// open the file now, so that failures are reported by the cache
+	result.file->root();
+	cost = 1;
+	return result;
+}
+
+typedef LRUCache<std::string, CachedFile> FileCache;
+
+FileCache &fileCache()
+{
+	static FileCache c( fileCacheGetter, 50 );
+	return c;
+}
+
+IFFFilePtr cachedFile( const std::string &fileName )
+{
+	try
+	{
+		CachedFile cached = fileCache().get( fileName );
+		if( cached.modificationTime != modificationTime( fileName ) )
+		{
+			// the file has changed since we cached it
+			fileCache().erase( fileName );
+			cached = fileCache().get( fileName );
+		}
+		return cached.file;
+	}
+	catch( ... )
+	{
+		// don't cache failures, in case the file appears later
+		fileCache().erase( fileName );
+		throw;
+	}
+}
+
+} // namespace
+
 const Reader::ReaderDescription<NParticleReader> NParticleReader::m_readerDescription( "mc" );
 
 NParticleReader::NParticleReader()
@@ -101,7 +170,7 @@ bool NParticleReader::open()
 {
 	if( !m_iffFile || m_iffFileName!=fileName() )
 	{
-		m_iffFile = new IFFFile( fileName().c_str() );
+		m_iffFile = cachedFile( fileName() );
 		
 		IFFFile::Chunk *root = m_iffFile->root();
 		IFFFile::Chunk::ChunkIterator headerIt = root->childrenBegin();
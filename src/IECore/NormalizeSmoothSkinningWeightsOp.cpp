@@ -43,8 +43,81 @@
 #include "IECore/SimpleTypedData.h"
 #include "IECore/TypedObjectParameter.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Normalizes the weights for a range of points.
+class Normalizer
+{
+
+	public :
+
+		Normalizer( const std::vector<bool> &locks, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, std::vector<float> &pointInfluenceWeights )
+			:	m_locks( locks ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ),
+				m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			std::vector<int> unlockedIndices;
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				unlockedIndices.clear();
+				float totalLockedWeights = 0.0f;
+				float totalUnlockedWeights = 0.0f;
+
+				for ( int j=0; j < m_pointInfluenceCounts[i]; j++ )
+				{
+					int current = m_pointIndexOffsets[i] + j;
+
+					if ( m_locks[ m_pointInfluenceIndices[current] ] )
+					{
+						totalLockedWeights += m_pointInfluenceWeights[current];
+					}
+					else
+					{
+						totalUnlockedWeights += m_pointInfluenceWeights[current];
+						unlockedIndices.push_back( current );
+					}
+				}
+
+				float remainingWeight = 1.0f - totalLockedWeights;
+
+				if ( (remainingWeight == 0.0f) || (totalUnlockedWeights == 0.0f) )
+				{
+					for ( unsigned j=0; j < unlockedIndices.size(); j++ )
+					{
+						m_pointInfluenceWeights[ unlockedIndices[j] ] = 0.0f;
+					}
+				}
+				else
+				{
+					for ( unsigned j=0; j < unlockedIndices.size(); j++ )
+					{
+						m_pointInfluenceWeights[ unlockedIndices[j] ] = (m_pointInfluenceWeights[ unlockedIndices[j] ] * remainingWeight) / totalUnlockedWeights;
+					}
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<bool> &m_locks;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( NormalizeSmoothSkinningWeightsOp );
 
 NormalizeSmoothSkinningWeightsOp::NormalizeSmoothSkinningWeightsOp()
@@ -87,7 +160,6 @@ void NormalizeSmoothSkinningWeightsOp::modify( Object * object, const CompoundOb
 	
 	bool useLocks = m_useLocksParameter->getTypedValue();
 	std::vector<bool> &locks = m_influenceLocksParameter->getTypedValue();
-	std::vector<int> unlockedIndices;
 		
 	// make sure there is one lock per influence
 	if ( useLocks && ( locks.size() != skinningData->influenceNames()->readable().size() ) )
@@ -101,42 +173,8 @@ void NormalizeSmoothSkinningWeightsOp::modify( Object * object, const CompoundOb
 		locks.resize( skinningData->influenceNames()->readable().size(), false );
 	}
 	
-	for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
-	{
-		unlockedIndices.clear();
-		float totalLockedWeights = 0.0f;
-		float totalUnlockedWeights = 0.0f;
-
-		for ( int j=0; j < pointInfluenceCounts[i]; j++ )
-		{
-			int current = pointIndexOffsets[i] + j;
-
-			if ( locks[ pointInfluenceIndices[current] ] )
-			{
-				totalLockedWeights += pointInfluenceWeights[current];
-			}
-			else
-			{
-				totalUnlockedWeights += pointInfluenceWeights[current];
-				unlockedIndices.push_back( current );
-			}
-		}
-
-		float remainingWeight = 1.0f - totalLockedWeights;
-
-		if ( (remainingWeight == 0.0f) || (totalUnlockedWeights == 0.0f) )
-		{
-			for ( unsigned j=0; j < unlockedIndices.size(); j++ )
-			{
-				pointInfluenceWeights[ unlockedIndices[j] ] = 0.0f;
-			}
-		}
-		else
-		{
-			for ( unsigned j=0; j < unlockedIndices.size(); j++ )
-			{
-				pointInfluenceWeights[ unlockedIndices[j] ] = (pointInfluenceWeights[ unlockedIndices[j] ] * remainingWeight) / totalUnlockedWeights;
-			}
-		}
-	}
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, pointIndexOffsets.size(), 1024 ),
+		Normalizer( locks, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights )
+	);
 }
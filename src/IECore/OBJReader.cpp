@@ -33,28 +33,21 @@
 //////////////////////////////////////////////////////////////////////////
 
 
-#include <iostream>
-#include <iterator>
+#include <cmath>
 #include <fstream>
 
-#include "boost/bind.hpp"
-#include "boost/version.hpp"
-#if BOOST_VERSION >= 103600
-#define BOOST_SPIRIT_USE_OLD_NAMESPACE
-#include "boost/spirit/include/classic.hpp"
-#else
-#include "boost/spirit.hpp"
-#endif
+#include "boost/filesystem/operations.hpp"
+#include "boost/format.hpp"
+#include "boost/iostreams/device/mapped_file.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 #include "IECore/OBJReader.h"
-#include "IECore/CompoundData.h"
-#include "IECore/SimpleTypedData.h"
+#include "IECore/Exception.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/MessageHandler.h"
-#include "IECore/NumericParameter.h"
-#include "IECore/TypedParameter.h"
 #include "IECore/MeshPrimitive.h"
-#include "IECore/CompoundParameter.h"
 #include "IECore/FileNameParameter.h"
 #include "IECore/ObjectParameter.h"
 #include "IECore/NullObject.h"
@@ -63,13 +56,9 @@ using namespace std;
 using namespace IECore;
 using namespace Imath;
 using namespace boost;
-using namespace boost::spirit;
 
 IE_CORE_DEFINERUNTIMETYPED(OBJReader);
 
-// syntactic sugar for specifying our grammar
-typedef boost::spirit::rule<boost::spirit::phrase_scanner_t> srule;
-
 const Reader::ReaderDescription<OBJReader> OBJReader::m_readerDescription("obj");
 
 OBJReader::OBJReader( const std::string &fileName )
@@ -77,6 +66,15 @@ OBJReader::OBJReader( const std::string &fileName )
 	NullObject, MeshPrimitive::staticTypeId()))
 {
 	m_fileNameParameter->setTypedValue( fileName );
+
+	m_indexedFaceVaryingParameter = new BoolParameter(
+		"indexedFaceVarying",
+		"Outputs texture coordinates and normals as indexed FaceVarying primitive "
+		"variables, referencing the values in the file directly rather than expanding "
+		"them to one value per face-vertex.",
+		false
+	);
+	parameters()->addParameter( m_indexedFaceVaryingParameter );
 }
 
 bool OBJReader::canRead( const string &fileName )
@@ -92,265 +90,667 @@ bool OBJReader::canRead( const string &fileName )
 	return in.is_open();
 }
 
-ObjectPtr OBJReader::doOperation(const CompoundObject * operands)
+BoolParameter *OBJReader::indexedFaceVaryingParameter()
 {
-	// for now we are going to retrieve vertex, texture, normal coordinates, faces.
-	// later (when we have the primitives), we will handle a larger subset of the
-	// OBJ format
+	return m_indexedFaceVaryingParameter.get();
+}
 
-	IntVectorDataPtr vpf = new IntVectorData();
-	m_vpf = &vpf->writable();
+const BoolParameter *OBJReader::indexedFaceVaryingParameter() const
+{
+	return m_indexedFaceVaryingParameter.get();
+}
 
-	IntVectorDataPtr vids = new IntVectorData();
-	m_vids = &vids->writable();
+//////////////////////////////////////////////////////////////////////////
+// Tokenising. See http://paulbourke.net/dataformats/obj/ for the format.
+//////////////////////////////////////////////////////////////////////////
 
-	V3fVectorDataPtr vertices = new V3fVectorData();
-	m_vertices = &vertices->writable();
+namespace
+{
 
- 	// separate texture coordinates
-	FloatVectorDataPtr sTextureCoordinates = new FloatVectorData();
-	m_sTextureCoordinates = &sTextureCoordinates->writable();
+// The approximate number of bytes parsed by each task.
+const size_t g_chunkSize = 1024 * 1024;
 
-	FloatVectorDataPtr tTextureCoordinates = new FloatVectorData();
-	m_tTextureCoordinates = &tTextureCoordinates->writable();
+inline bool isSpace( char c )
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
 
-	// build normals
-	V3fVectorDataPtr normals = new V3fVectorData();
-	m_normals = &normals->writable();
+inline bool isDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
 
-	// parse the file
-	parseOBJ();
+inline void skipSpace( const char *&p, const char *end )
+{
+	while( p != end && isSpace( *p ) )
+	{
+		++p;
+	}
+}
 
-	// create our MeshPrimitive
-	MeshPrimitivePtr mesh = new MeshPrimitive( vpf, vids, "linear", vertices );
-	if( sTextureCoordinates->readable().size() )
+inline void skipLine( const char *&p, const char *end )
+{
+	while( p != end && *p++ != '\n' )
+	{
+	}
+}
+
+inline bool parseInt( const char *&p, const char *end, int &result )
+{
+	const char *c = p;
+	bool negative = false;
+	if( c != end && ( *c == '-' || *c == '+' ) )
 	{
-		mesh->variables.insert(PrimitiveVariableMap::value_type("s", PrimitiveVariable( PrimitiveVariable::FaceVarying, sTextureCoordinates)));
-	
+		negative = *c == '-';
+		++c;
 	}
-	if( tTextureCoordinates->readable().size() )
+
+	if( c == end || !isDigit( *c ) )
 	{
-		mesh->variables.insert(PrimitiveVariableMap::value_type("t", PrimitiveVariable(  PrimitiveVariable::FaceVarying, tTextureCoordinates)));
+		return false;
 	}
-	if( normals->readable().size() )
+
+	int value = 0;
+	while( c != end && isDigit( *c ) )
 	{
-		mesh->variables.insert(PrimitiveVariableMap::value_type("N", PrimitiveVariable(  PrimitiveVariable::FaceVarying, normals)));
+		value = value * 10 + ( *c - '0' );
+		++c;
 	}
-	return mesh;
+
+	result = negative ? -value : value;
+	p = c;
+	return true;
 }
 
+const double g_powersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
 
-// parse a vertex
-void OBJReader::parseVertex(const char * begin, const char * end)
+// Parses a floating point number in the [+-]digits[.digits][(e|E)[+-]digits]
+// form. This is considerably faster than strtod(), and doesn't require the
+// data to be null terminated. Mantissas of up to 15 significant digits are
+// exact, which is ample for the float results we need.
+inline bool parseFloat( const char *&p, const char *end, float &result )
 {
-	vector<float> vec;
-	srule vertex = "v" >> real_p[append(vec)] >> real_p[append(vec)] >> real_p[append(vec)];
-	parse(begin, vertex, space_p);
-
-	// build v
-	V3f v;
-	v[0] = vec[0];
- 	v[1] = vec[1];
- 	v[2] = vec[2];
-
-	// add this vertex
-	m_vertices->push_back(v);
-}
+	const char *c = p;
+	bool negative = false;
+	if( c != end && ( *c == '-' || *c == '+' ) )
+	{
+		negative = *c == '-';
+		++c;
+	}
 
-// parse a texture coordinate
-void OBJReader::parseTextureCoordinate(const char * begin, const char * end)
-{
-	vector<float> vec;
-	srule vertex = "vt" >> real_p[append(vec)] >> real_p[append(vec)] >> *(real_p[append(vec)]);
-	parse(begin, vertex, space_p);
-
-	// build v
-	V3f vt;
-	vt[0] = vec[0];
- 	vt[1] = vec[1];
-	vt[2] = vec.size() == 3 ? vec[2] : 0.0f;
-
-	// add this texture coordinate
-	m_introducedTextureCoordinates.push_back(vt);
+	double mantissa = 0;
+	int exponent = 0;
+	bool haveDigits = false;
+	while( c != end && isDigit( *c ) )
+	{
+		mantissa = mantissa * 10.0 + ( *c - '0' );
+		haveDigits = true;
+		++c;
+	}
+
+	if( c != end && *c == '.' )
+	{
+		++c;
+		while( c != end && isDigit( *c ) )
+		{
+			mantissa = mantissa * 10.0 + ( *c - '0' );
+			--exponent;
+			haveDigits = true;
+			++c;
+		}
+	}
+
+	if( !haveDigits )
+	{
+		return false;
+	}
+
+	if( c != end && ( *c == 'e' || *c == 'E' ) )
+	{
+		const char *e = c + 1;
+		int explicitExponent = 0;
+		if( parseInt( e, end, explicitExponent ) )
+		{
+			exponent += explicitExponent;
+			c = e;
+		}
+	}
+
+	double value = mantissa;
+	if( exponent > 0 )
+	{
+		value *= exponent <= 22 ? g_powersOfTen[exponent] : pow( 10.0, exponent );
+	}
+	else if( exponent < 0 )
+	{
+		value /= exponent >= -22 ? g_powersOfTen[-exponent] : pow( 10.0, -exponent );
+	}
+
+	result = (float)( negative ? -value : value );
+	p = c;
+	return true;
 }
 
-// parse a normal
-void OBJReader::parseNormal(const char * begin, const char * end)
+template<typename T>
+inline bool parseFloats( const char *&p, const char *end, T &result, int n )
 {
-	vector<float> vec;
-	srule vertex = "vn" >> real_p[append(vec)] >> real_p[append(vec)] >> real_p[append(vec)];
-	parse(begin, vertex, space_p);
-
-	// build v
-	V3f vn;
-	vn[0] = vec[0];
-	vn[1] = vec[1];
-	vn[2] = vec[2];
-
-	// add this normal
-	m_introducedNormals.push_back(vn);
+	for( int i = 0; i < n; ++i )
+	{
+		skipSpace( p, end );
+		if( !parseFloat( p, end, result[i] ) )
+		{
+			return false;
+		}
+	}
+	return true;
 }
 
-// parse face
-void OBJReader::parseFace(const char * begin, const char * end)
+// The results of parsing a contiguous range of lines.
+struct Chunk
 {
-	vector<int> vec;
-	vector<int> tvec;
-	vector<int> nvec;
 
-	srule entry = int_p[append(vec)] >>
-		(
-			("/" >> (int_p[append(tvec)] | epsilon_p) >> "/" >> (int_p[append(nvec)] | epsilon_p))
-			| epsilon_p
-		);
+	Chunk()
+		:	begin( 0 ), end( 0 ), vertexOffset( 0 ), uvOffset( 0 ), normalOffset( 0 ), faceOffset( 0 ), faceVertexOffset( 0 )
+	{
+	}
+
+	const char *begin;
+	const char *end;
+
+	std::vector<V3f> vertices;
+	std::vector<V2f> uvs;
+	std::vector<V3f> normals;
+
+	std::vector<int> verticesPerFace;
+	std::vector<int> vertexIds;
+	std::vector<int> uvIds;
+	std::vector<int> normalIds;
 
-	srule face = "f"  >> entry >> entry >> entry >> *(entry);
-	parse(begin, face, space_p);
+	// Positions in the id arrays above which came from negative (relative)
+	// indices. These have been resolved relative to the elements of this
+	// chunk only, and must be offset by the number of elements in all
+	// preceding chunks during the merge.
+	std::vector<size_t> relativeVertexIds;
+	std::vector<size_t> relativeUVIds;
+	std::vector<size_t> relativeNormalIds;
 
-	// push back the degree of the face
-	m_vpf->push_back(vec.size());
+	// The location of this chunk's results within the merged results.
+	size_t vertexOffset;
+	size_t uvOffset;
+	size_t normalOffset;
+	size_t faceOffset;
+	size_t faceVertexOffset;
 
-	// merge in the edges.  we index from 0, so shift them down.
-	// also, vertices may be indexed negatively, in which case they are relative to
-	// the current set of vertices
-	for(vector<int>::const_iterator i = vec.begin(); i != vec.end(); ++i)
+	// Set if the chunk couldn't be parsed or merged, since we can't throw
+	// from within the parallel loops.
+	std::string error;
+
+};
+
+typedef std::vector<Chunk> Chunks;
+
+inline bool appendIndex( int index, size_t numElements, std::vector<int> &ids, std::vector<size_t> &relativeIds )
+{
+	if( index > 0 )
+	{
+		ids.push_back( index - 1 );
+	}
+	else if( index < 0 )
+	{
+		// may be negative if it refers to a previous chunk
+		relativeIds.push_back( ids.size() );
+		ids.push_back( (int)numElements + index );
+	}
+	else
 	{
-		m_vids->push_back(*i > 0 ? *i - 1 : m_vertices->size() + *i);
+		return false;
 	}
+	return true;
+}
 
+bool parseFace( const char *&p, const char *end, Chunk &chunk )
+{
+	const size_t numUVIds = chunk.uvIds.size();
+	const size_t numNormalIds = chunk.normalIds.size();
 
-	// merge in texture coordinates and normals, if present
-	// OBJ format requires an encoding for faces which uses one of the vertex/texture/normal specifications
-	// consistently across the entire face.  eg. we can have all v/vt/vn, or all v//vn, or all v, but not
-	// v//vn then v/vt/vn ...
-	if(!nvec.empty())
+	int numVertices = 0;
+	while( true )
 	{
-		if(nvec.size() != vec.size())
-			throw Exception("invalid face specification");
+		skipSpace( p, end );
+		if( p == end || *p == '\n' || *p == '#' )
+		{
+			break;
+		}
 
-		// copy in these references to normal vectors to the mesh's normal vector
-		for(vector<int>::const_iterator i = nvec.begin(); i != nvec.end(); ++i)
+		int index = 0;
+		if( !parseInt( p, end, index ) || !appendIndex( index, chunk.vertices.size(), chunk.vertexIds, chunk.relativeVertexIds ) )
 		{
-			m_normals->push_back(m_introducedNormals[*i > 0 ? *i - 1 : m_introducedNormals.size() + *i]);
+			return false;
+		}
+		++numVertices;
+
+		if( p != end && *p == '/' )
+		{
+			++p;
+			if( parseInt( p, end, index ) && !appendIndex( index, chunk.uvs.size(), chunk.uvIds, chunk.relativeUVIds ) )
+			{
+				return false;
+			}
+			if( p != end && *p == '/' )
+			{
+				++p;
+				if( parseInt( p, end, index ) && !appendIndex( index, chunk.normals.size(), chunk.normalIds, chunk.relativeNormalIds ) )
+				{
+					return false;
+				}
+			}
+		}
+
+		if( p != end && !isSpace( *p ) && *p != '\n' && *p != '#' )
+		{
+			return false;
 		}
 	}
-	// otherwise, check if we have specified normals in some previous face
-	// if so, and no normals were given here (examples, encoders that do this?), pump in
-	// default normal.  the default normal defined here is the zero normal, which is by
-	// definition orthogonal to every other vector.  this might result in odd lighting.
-	else
+
+	// OBJ requires each face to use one of the vertex/texture/normal specifications
+	// consistently - eg. we can have all v/vt/vn, or all v//vn, or all v, but not
+	// v//vn then v/vt/vn.
+	const size_t faceUVIds = chunk.uvIds.size() - numUVIds;
+	const size_t faceNormalIds = chunk.normalIds.size() - numNormalIds;
+	if( ( faceUVIds && faceUVIds != (size_t)numVertices ) || ( faceNormalIds && faceNormalIds != (size_t)numVertices ) )
+	{
+		return false;
+	}
+
+	if( numVertices )
+	{
+		chunk.verticesPerFace.push_back( numVertices );
+	}
+	return true;
+}
+
+void parseChunk( Chunk &chunk )
+{
+	const char *p = chunk.begin;
+	const char *end = chunk.end;
+	while( p != end )
 	{
-		V3f zero(0.0f, 0.0f, 0.0f);
-		for(unsigned int i = 0; i < nvec.size(); ++i)
+		skipSpace( p, end );
+		if( p == end )
+		{
+			break;
+		}
+
+		const char *keyword = p;
+		while( p != end && !isSpace( *p ) && *p != '\n' )
+		{
+			++p;
+		}
+		const size_t keywordLength = p - keyword;
+
+		// statements we don't support, and those which don't
+		// parse, are ignored.
+		if( keywordLength == 1 && keyword[0] == 'v' )
+		{
+			V3f v;
+			if( parseFloats( p, end, v, 3 ) )
+			{
+				chunk.vertices.push_back( v );
+			}
+		}
+		else if( keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 't' )
 		{
-			m_normals->push_back(zero);
+			V2f vt;
+			if( parseFloats( p, end, vt, 2 ) )
+			{
+				chunk.uvs.push_back( vt );
+			}
 		}
+		else if( keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 'n' )
+		{
+			V3f vn;
+			if( parseFloats( p, end, vn, 3 ) )
+			{
+				chunk.normals.push_back( vn );
+			}
+		}
+		else if( keywordLength == 1 && keyword[0] == 'f' )
+		{
+			if( !parseFace( p, end, chunk ) )
+			{
+				chunk.error = "invalid face specification";
+				return;
+			}
+		}
+
+		skipLine( p, end );
 	}
+}
+
+class ChunkParser
+{
+
+	public :
+
+		ChunkParser( Chunks &chunks )
+			:	m_chunks( chunks )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				parseChunk( m_chunks[i] );
+			}
+		}
+
+	private :
+
+		Chunks &m_chunks;
+
+};
 
-	//
-	// merge in texture coordinates, if present
-	//
-	if(!tvec.empty())
+//////////////////////////////////////////////////////////////////////////
+// Merging
+//////////////////////////////////////////////////////////////////////////
+
+// Offsets the relative ids of a chunk, checks all ids are in range, and
+// copies them into the merged result.
+bool mergeIds( std::vector<int> &ids, const std::vector<size_t> &relativeIds, size_t offset, size_t numElements, int *result )
+{
+	for( std::vector<size_t>::const_iterator it = relativeIds.begin(), eIt = relativeIds.end(); it != eIt; ++it )
 	{
-		if(tvec.size() != vec.size())
-			throw Exception("invalid face specification");
+		ids[*it] += offset;
+	}
 
-		for(unsigned int i = 0; i < tvec.size(); ++i)
+	for( size_t i = 0, e = ids.size(); i < e; ++i )
+	{
+		if( ids[i] < 0 || (size_t)ids[i] >= numElements )
 		{
-			int index = tvec[i] > 0 ? tvec[i] - 1 : m_introducedTextureCoordinates.size() + tvec[i];
-			m_sTextureCoordinates->push_back(m_introducedTextureCoordinates[index][0]);
-			m_tTextureCoordinates->push_back(m_introducedTextureCoordinates[index][1]);
+			return false;
 		}
+		result[i] = ids[i];
 	}
-	else
+	return true;
+}
+
+// Copies the vertex data from each chunk into the merged results.
+class VertexMerger
+{
+
+	public :
+
+		VertexMerger( Chunks &chunks, V3f *vertices, float *s, float *t, V3f *normals )
+			:	m_chunks( chunks ), m_vertices( vertices ), m_s( s ), m_t( t ), m_normals( normals )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const Chunk &chunk = m_chunks[i];
+				std::copy( chunk.vertices.begin(), chunk.vertices.end(), m_vertices + chunk.vertexOffset );
+				std::copy( chunk.normals.begin(), chunk.normals.end(), m_normals + chunk.normalOffset );
+				for( size_t j = 0, e = chunk.uvs.size(); j < e; ++j )
+				{
+					m_s[chunk.uvOffset + j] = chunk.uvs[j][0];
+					m_t[chunk.uvOffset + j] = chunk.uvs[j][1];
+				}
+			}
+		}
+
+	private :
+
+		Chunks &m_chunks;
+		V3f *m_vertices;
+		float *m_s;
+		float *m_t;
+		V3f *m_normals;
+
+};
+
+// Copies the topology and face-vertex indices from each chunk into the
+// merged results.
+class FaceMerger
+{
+
+	public :
+
+		FaceMerger( Chunks &chunks, size_t numVertices, size_t numUVs, size_t numNormals, int *verticesPerFace, int *vertexIds, int *uvIds, int *normalIds )
+			:	m_chunks( chunks ), m_numVertices( numVertices ), m_numUVs( numUVs ), m_numNormals( numNormals ),
+				m_verticesPerFace( verticesPerFace ), m_vertexIds( vertexIds ), m_uvIds( uvIds ), m_normalIds( normalIds )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				Chunk &chunk = m_chunks[i];
+				std::copy( chunk.verticesPerFace.begin(), chunk.verticesPerFace.end(), m_verticesPerFace + chunk.faceOffset );
+				if(
+					!mergeIds( chunk.vertexIds, chunk.relativeVertexIds, chunk.vertexOffset, m_numVertices, m_vertexIds + chunk.faceVertexOffset ) ||
+					( m_uvIds && !mergeIds( chunk.uvIds, chunk.relativeUVIds, chunk.uvOffset, m_numUVs, m_uvIds + chunk.faceVertexOffset ) ) ||
+					( m_normalIds && !mergeIds( chunk.normalIds, chunk.relativeNormalIds, chunk.normalOffset, m_numNormals, m_normalIds + chunk.faceVertexOffset ) )
+				)
+				{
+					chunk.error = "index out of range";
+				}
+			}
+		}
+
+	private :
+
+		Chunks &m_chunks;
+		size_t m_numVertices;
+		size_t m_numUVs;
+		size_t m_numNormals;
+		int *m_verticesPerFace;
+		int *m_vertexIds;
+		int *m_uvIds;
+		int *m_normalIds;
+
+};
+
+// Expands indexed values to one value per face-vertex.
+template<typename T>
+class Expander
+{
+
+	public :
+
+		Expander( const std::vector<T> &values, const std::vector<int> &indices, std::vector<T> &result )
+			:	m_values( values ), m_indices( indices ), m_result( result )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_result[i] = m_values[m_indices[i]];
+			}
+		}
+
+	private :
+
+		const std::vector<T> &m_values;
+		const std::vector<int> &m_indices;
+		std::vector<T> &m_result;
+
+};
+
+template<typename T>
+typename T::Ptr expand( const T *values, const IntVectorData *indices )
+{
+	typename T::Ptr result = new T;
+	result->writable().resize( indices->readable().size() );
+	Expander<typename T::ValueType::value_type> expander( values->readable(), indices->readable(), result->writable() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, indices->readable().size(), 1000 ), expander );
+	return result;
+}
+
+void throwIfError( const Chunks &chunks, const std::string &fileName )
+{
+	for( Chunks::const_iterator it = chunks.begin(), eIt = chunks.end(); it != eIt; ++it )
 	{
-		for(unsigned int i = 0; i < tvec.size(); ++i)
+		if( it->error.size() )
 		{
-			m_sTextureCoordinates->push_back(0.0f);
-			m_tTextureCoordinates->push_back(0.0f);
+			throw Exception( ( boost::format( "OBJReader : Error reading \"%s\" (%s)." ) % fileName % it->error ).str() );
 		}
 	}
 }
 
-void OBJReader::parseGroup(const char *begin, const char *end)
+} // namespace
+
+ObjectPtr OBJReader::doOperation(const CompoundObject * operands)
 {
-	// set current group
-	vector<string> groupNames;
-	srule grouping = "g" >> *(lexeme_d[alnum_p >> *(alnum_p)][append(groupNames)]);
+	// for now we are going to retrieve vertex, texture, normal coordinates, faces.
+	// later (when we have the primitives), we will handle a larger subset of the
+	// OBJ format
 
-	parse(begin, grouping, space_p);
+	const std::string fileName = this->fileName();
+	const bool indexedFaceVarying = m_indexedFaceVaryingParameter->getTypedValue();
 
-	// from 'http://local.wasp.uwa.edu.au/~pbourke/dataformats/obj/':
-	// The default group name is default.
-	if(groupNames.empty())
+	// map the file and split it into chunks at line boundaries
+
+	boost::iostreams::mapped_file_source mappedFile;
+	Chunks chunks;
+	try
 	{
-		groupNames.push_back("default");
+		if( boost::filesystem::file_size( fileName ) )
+		{
+			mappedFile.open( fileName );
+		}
+	}
+	catch( const std::exception &e )
+	{
+		throw IOException( ( boost::format( "OBJReader : Cannot map file \"%s\" (%s)." ) % fileName % e.what() ).str() );
 	}
 
-	// \todo associate mesh objects with group names
-}
+	if( mappedFile.is_open() )
+	{
+		const char *data = mappedFile.data();
+		const char *end = data + mappedFile.size();
+		const char *p = data;
+		while( p != end )
+		{
+			Chunk chunk;
+			chunk.begin = p;
+			p = (size_t)( end - p ) > g_chunkSize ? p + g_chunkSize : end;
+			skipLine( p, end );
+			chunk.end = p;
+			chunks.push_back( chunk );
+		}
+	}
+
+	// parse all the chunks in parallel
+
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, chunks.size(), 1 ), ChunkParser( chunks ) );
+	throwIfError( chunks, fileName );
+
+	// figure out where each chunk goes in the merged results
+
+	size_t numVertices = 0, numUVs = 0, numNormals = 0, numFaces = 0, numFaceVertices = 0, numUVIds = 0, numNormalIds = 0;
+	for( Chunks::iterator it = chunks.begin(), eIt = chunks.end(); it != eIt; ++it )
+	{
+		it->vertexOffset = numVertices;
+		it->uvOffset = numUVs;
+		it->normalOffset = numNormals;
+		it->faceOffset = numFaces;
+		it->faceVertexOffset = numFaceVertices;
+		numVertices += it->vertices.size();
+		numUVs += it->uvs.size();
+		numNormals += it->normals.size();
+		numFaces += it->verticesPerFace.size();
+		numFaceVertices += it->vertexIds.size();
+		numUVIds += it->uvIds.size();
+		numNormalIds += it->normalIds.size();
+	}
+
+	// texture coordinates and normals can only be output if every
+	// face references them.
 
-void OBJReader::parseOBJ() {
-
-	srule comment = comment_p("#");
-
-	// see
-	// http://local.wasp.uwa.edu.au/~pbourke/dataformats/obj/
-
-	// vertices
-	srule vertex         = ("v"  >> real_p >> real_p >> real_p) [bind(&OBJReader::parseVertex,            this, _1, _2)];
-	srule vertex_texture = ("vt" >> real_p >> real_p)           [bind(&OBJReader::parseTextureCoordinate, this, _1, _2)];
-	srule vertex_normal  = ("vn" >> real_p >> real_p >> real_p) [bind(&OBJReader::parseNormal,            this, _1, _2)];
-	//srule vertex_parameter_space  = "vp" >> real_p >> real_p >> real_p;
-
-	// srule cs_types = ("bmatrix" | "bezier" | "bspline" | "cardinal" | "taylor");
-	// srule vertex_curve_or_surface = "cstype" >> "rat" >> cs_types;
-	// srule vertex_degree  = "deg" >> real_p >> real_p;
-	// srule vertex_basis_matrix  = "bmat";
-	// srule vertex_step_size  = "step" >> int_p >> int_p;
-	srule vertex_type = vertex | vertex_texture | vertex_normal;
-
-	// elements
-	srule point = "p" >> real_p >> *(real_p);
-	srule  line = "l" >> int_p >> int_p >> *(int_p);
-	srule  face = (ch_p('f') >> *(anychar_p))[bind(&OBJReader::parseFace, this, _1, _2)];
-	// srule curve = "curv";
-	// srule curve_2d = "curv2";
-	// srule surface = "surf";
-	srule element = point | line | face;
-
- 	// free-form curve / surface statements
-	// srule parameter = "parm";
-	// srule trim_loop = "trim";
-	// srule hole_loop = "hole";
-	// srule special_curve = "scrv";
-	// srule special_point = "sp";
-	// srule end_statement = "end";
-
-	// connectivity
-	//srule connect = "con";
-
-	// grouping
-	srule group_name = ("g" >> *(anychar_p))[bind(&OBJReader::parseGroup, this, _1, _2)];
-	//	srule smoothing_group = "s";
-	//	srule merging_group = "mg";
-	srule object_name = "o" >> int_p;
-	srule grouping = group_name | object_name;
-
-	// display and render attributes
-	// srule bevel_interpretation = "bevel";
-	// srule color_interpolation = "c_interp";
-	// srule dissolve_interpolation = "d_interp";
-	// srule level_of_detail = "lod";
-	// srule material_name = "usemtl";
-	// srule material_library = "mtllib";
-	// srule shadow_casting = "shadow_obj";
-	// srule ray_tracing = "trace_obj";
-	// srule curve_approximation_technique = "ctech";
-	// srule surface_approximation_technique = "stech";
-
-	ifstream in(fileName().c_str());
-	string str;
-	while(getline(in, str))
-		parse(str.c_str(), vertex_type | element | grouping | comment, space_p);
+	const bool haveUVs = numUVIds && numUVIds == numFaceVertices;
+	const bool haveNormals = numNormalIds && numNormalIds == numFaceVertices;
+	if( numUVIds && !haveUVs )
+	{
+		msg( Msg::Warning, "OBJReader", boost::format( "Ignoring texture coordinates in \"%s\" because not all faces reference them." ) % fileName );
+	}
+	if( numNormalIds && !haveNormals )
+	{
+		msg( Msg::Warning, "OBJReader", boost::format( "Ignoring normals in \"%s\" because not all faces reference them." ) % fileName );
+	}
+
+	// merge
+
+	V3fVectorDataPtr vertices = new V3fVectorData();
+	vertices->writable().resize( numVertices );
+	FloatVectorDataPtr s = new FloatVectorData();
+	FloatVectorDataPtr t = new FloatVectorData();
+	s->writable().resize( numUVs );
+	t->writable().resize( numUVs );
+	V3fVectorDataPtr normals = new V3fVectorData();
+	normals->writable().resize( numNormals );
+
+	VertexMerger vertexMerger(
+		chunks,
+		numVertices ? &vertices->writable()[0] : 0,
+		numUVs ? &s->writable()[0] : 0,
+		numUVs ? &t->writable()[0] : 0,
+		numNormals ? &normals->writable()[0] : 0
+	);
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, chunks.size(), 1 ), vertexMerger );
+
+	IntVectorDataPtr vpf = new IntVectorData();
+	vpf->writable().resize( numFaces );
+	IntVectorDataPtr vids = new IntVectorData();
+	vids->writable().resize( numFaceVertices );
+	IntVectorDataPtr uvIds = new IntVectorData();
+	uvIds->writable().resize( haveUVs ? numFaceVertices : 0 );
+	IntVectorDataPtr normalIds = new IntVectorData();
+	normalIds->writable().resize( haveNormals ? numFaceVertices : 0 );
+
+	FaceMerger faceMerger(
+		chunks, numVertices, numUVs, numNormals,
+		numFaces ? &vpf->writable()[0] : 0,
+		numFaceVertices ? &vids->writable()[0] : 0,
+		haveUVs ? &uvIds->writable()[0] : 0,
+		haveNormals ? &normalIds->writable()[0] : 0
+	);
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, chunks.size(), 1 ), faceMerger );
+	throwIfError( chunks, fileName );
+
+	// create our MeshPrimitive
+	MeshPrimitivePtr mesh = new MeshPrimitive( vpf, vids, "linear", vertices );
+	if( haveUVs )
+	{
+		if( indexedFaceVarying )
+		{
+			mesh->variables["s"] = PrimitiveVariable( PrimitiveVariable::FaceVarying, s, uvIds );
+			mesh->variables["t"] = PrimitiveVariable( PrimitiveVariable::FaceVarying, t, uvIds );
+		}
+		else
+		{
+			mesh->variables["s"] = PrimitiveVariable( PrimitiveVariable::FaceVarying, expand( s.get(), uvIds.get() ) );
+			mesh->variables["t"] = PrimitiveVariable( PrimitiveVariable::FaceVarying, expand( t.get(), uvIds.get() ) );
+		}
+	}
+	if( haveNormals )
+	{
+		if( indexedFaceVarying )
+		{
+			mesh->variables["N"] = PrimitiveVariable( PrimitiveVariable::FaceVarying, normals, normalIds );
+		}
+		else
+		{
+			mesh->variables["N"] = PrimitiveVariable( PrimitiveVariable::FaceVarying, expand( normals.get(), normalIds.get() ) );
+		}
+	}
+	return mesh;
 }
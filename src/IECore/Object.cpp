@@ -36,8 +36,14 @@
 #include "IECore/MurmurHash.h"
 
 #include "boost/format.hpp"
+#include "boost/bind.hpp"
+#include "boost/function.hpp"
 #include "boost/tokenizer.hpp"
 
+#include "tbb/mutex.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include <iostream>
 
 
@@ -169,12 +175,54 @@ void Object::SaveContext::save( const Object *toSave, IndexedIO *container, cons
 // load context stuff
 //////////////////////////////////////////////////////////////////////////////////////////
 
-Object::LoadContext::LoadContext( ConstIndexedIOPtr ioInterface )
-	:	m_ioInterface( ioInterface ), m_loadedObjects( new LoadedObjectMap )
+class Object::LoadContext::LoadedObjects
+{
+
+	public :
+
+		LoadedObjects( bool parallel )
+			:	parallel( parallel )
+		{
+		}
+
+		ObjectPtr find( const IndexedIO::EntryIDList &path )
+		{
+			Mutex::scoped_lock lock( m_mutex );
+			Map::const_iterator it = m_map.find( path );
+			return it != m_map.end() ? it->second : ObjectPtr();
+		}
+
+		// If another thread has inserted an object for the same path in
+		// the meantime, that object is returned in preference to the one
+		// passed, so that all references resolve to the same instance.
+		ObjectPtr insert( const IndexedIO::EntryIDList &path, ObjectPtr object )
+		{
+			Mutex::scoped_lock lock( m_mutex );
+			return m_map.insert( Map::value_type( path, object ) ).first->second;
+		}
+
+		const bool parallel;
+
+	private :
+
+		typedef std::map<IndexedIO::EntryIDList, ObjectPtr> Map;
+		typedef tbb::mutex Mutex;
+
+		// We don't hold the mutex while loading, because the load may
+		// recurse back into us, possibly from other threads. The price is
+		// that two threads may occasionally load the same shared object
+		// simultaneously, with only one result being kept.
+		Map m_map;
+		Mutex m_mutex;
+
+};
+
+Object::LoadContext::LoadContext( ConstIndexedIOPtr ioInterface, bool parallel )
+	:	m_ioInterface( ioInterface ), m_loadedObjects( new LoadedObjects( parallel ) )
 {
 }
 
-Object::LoadContext::LoadContext( ConstIndexedIOPtr ioInterface, boost::shared_ptr<LoadedObjectMap> loadedObjects )
+Object::LoadContext::LoadContext( ConstIndexedIOPtr ioInterface, boost::shared_ptr<LoadedObjects> loadedObjects )
 	:	m_ioInterface( ioInterface ), m_loadedObjects( loadedObjects )
 {
 }
@@ -228,15 +276,14 @@ ObjectPtr Object::LoadContext::loadObjectOrReference( const IndexedIO *container
 				pathParts.push_back( *t );
 			}
 		}
-		std::pair< LoadedObjectMap::iterator,bool > ret = m_loadedObjects->insert( std::pair<IndexedIO::EntryIDList, ObjectPtr>( pathParts, NULL ) );
-		if ( ret.second )
+		if( ObjectPtr loaded = m_loadedObjects->find( pathParts ) )
 		{
-			// jump to the path..
-			ConstIndexedIOPtr ioObject = m_ioInterface->directory( pathParts );
-			// add the loaded object to the map.
-			ret.first->second = loadObject( ioObject.get() );
+			return loaded;
 		}
-		return ret.first->second;
+		// jump to the path..
+		ConstIndexedIOPtr ioObject = m_ioInterface->directory( pathParts );
+		// add the loaded object to the map.
+		return m_loadedObjects->insert( pathParts, loadObject( ioObject.get() ) );
 	}
 	else
 	{
@@ -245,16 +292,62 @@ ObjectPtr Object::LoadContext::loadObjectOrReference( const IndexedIO *container
 		IndexedIO::EntryIDList pathParts;
 		ioObject->path( pathParts );
 
-		std::pair< LoadedObjectMap::iterator,bool > ret = m_loadedObjects->insert( std::pair<IndexedIO::EntryIDList, ObjectPtr>( pathParts, NULL ) );
-		if ( ret.second )
+		if( ObjectPtr loaded = m_loadedObjects->find( pathParts ) )
 		{
-			// add the loaded object to the map.
-			ret.first->second = loadObject( ioObject.get() );
+			return loaded;
 		}
-		return ret.first->second;
+		// add the loaded object to the map.
+		return m_loadedObjects->insert( pathParts, loadObject( ioObject.get() ) );
 	}
 }
 
+namespace
+{
+
+struct ObjectLoader
+{
+
+	typedef boost::function<ObjectPtr ( const IndexedIO::EntryID & )> LoadFn;
+
+	ObjectLoader( const LoadFn &load, const IndexedIO::EntryIDList &names, std::vector<ObjectPtr> &objects )
+		:	m_load( load ), m_names( names ), m_objects( objects )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			m_objects[i] = m_load( m_names[i] );
+		}
+	}
+
+	private :
+
+		LoadFn m_load;
+		const IndexedIO::EntryIDList &m_names;
+		std::vector<ObjectPtr> &m_objects;
+
+};
+
+} // namespace
+
+void Object::LoadContext::loadObjectsOrReferences( const IndexedIO *container, const IndexedIO::EntryIDList &names, std::vector<ObjectPtr> &objects )
+{
+	objects.resize( names.size() );
+	if( !m_loadedObjects->parallel || names.size() < 2 )
+	{
+		for( size_t i = 0; i < names.size(); ++i )
+		{
+			objects[i] = loadObjectOrReference( container, names[i] );
+		}
+		return;
+	}
+
+	ObjectLoader loader( boost::bind( &LoadContext::loadObjectOrReference, this, container, _1 ), names, objects );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, names.size(), 1 ), loader );
+}
+
 // this function can only load concrete objects. it can't load references to
 // objects. path is relative to the root of m_ioInterface
 ObjectPtr Object::LoadContext::loadObject( const IndexedIO *container )
@@ -274,7 +367,12 @@ ObjectPtr Object::LoadContext::loadObject( const IndexedIO *container )
 //////////////////////////////////////////////////////////////////////////////////////////
 
 Object::MemoryAccumulator::MemoryAccumulator()
-	:	m_total( 0 )
+	:	m_total( 0 ), m_sharedBlocks( 0 )
+{
+}
+
+Object::MemoryAccumulator::MemoryAccumulator( SharedBlocks *sharedBlocks )
+	:	m_total( 0 ), m_sharedBlocks( sharedBlocks )
 {
 }
 
@@ -304,6 +402,12 @@ void Object::MemoryAccumulator::accumulate( const Object *object )
 
 void Object::MemoryAccumulator::accumulate( const void *ptr, size_t bytes )
 {
+	if( m_sharedBlocks )
+	{
+		m_sharedBlocks->insert( SharedBlocks::value_type( ptr, bytes ) );
+		return;
+	}
+
 	if( m_accumulated.find( ptr )==m_accumulated.end() )
 	{
 		m_total += bytes;
@@ -488,9 +592,9 @@ ObjectPtr Object::create( const std::string &typeName )
 	return creatorAndData.first( creatorAndData.second );
 }
 
-ObjectPtr Object::load( ConstIndexedIOPtr ioInterface, const IndexedIO::EntryID &name )
+ObjectPtr Object::load( ConstIndexedIOPtr ioInterface, const IndexedIO::EntryID &name, bool parallel )
 {
-	LoadContextPtr context( new LoadContext( ioInterface ) );
+	LoadContextPtr context( new LoadContext( ioInterface, parallel ) );
 	ObjectPtr result = context->load<Object>( ioInterface.get(), name );
 	return result;
 }
@@ -41,8 +41,63 @@
 #include "IECore/Primitive.h"
 #include "IECore/DespatchTypedData.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Interpolates a set of primitive variables in parallel, writing
+// the results into the variables of the result primitive.
+class VariableInterpolator
+{
+
+	public :
+
+		struct Variable
+		{
+			ConstDataPtr y0;
+			ConstDataPtr y1;
+			// True if y0 and y1 are expanded data from variables
+			// with differing indices.
+			bool expanded;
+			PrimitiveVariable *result;
+		};
+		typedef std::vector<Variable> Variables;
+
+		VariableInterpolator( Variables &variables, double x )
+			:	m_variables( variables ), m_x( x )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				Variable &v = m_variables[i];
+				ObjectPtr resultData = linearObjectInterpolation( v.y0.get(), v.y1.get(), m_x );
+				if( resultData )
+				{
+					v.result->data = boost::static_pointer_cast<Data>( resultData );
+					if( v.expanded )
+					{
+						v.result->indices = 0;
+					}
+				}
+			}
+		}
+
+	private :
+
+		Variables &m_variables;
+		double m_x;
+
+};
+
+} // namespace
+
 namespace IECore
 {
 
@@ -146,23 +201,34 @@ void LinearInterpolator< Object >::operator()( const Object *y0, const Object *y
 			const Object *bd1 = x1->blindData();
 			ObjectPtr bdr = xRes->blindData();
 			LinearInterpolator<Object>()( bd0, bd1, x, bdr );			
-			// interpolate primitive variables
+			// interpolate primitive variables. variables which are identical in
+			// both primitives are left sharing the data copied from x0, and the
+			// remainder are interpolated in parallel.
+			VariableInterpolator::Variables variables;
 			for( PrimitiveVariableMap::const_iterator it0 = x0->variables.begin(); it0 != x0->variables.end(); it0++ )
 			{
 				PrimitiveVariableMap::const_iterator it1 = x1->variables.find( it0->first );
 				if( it1 != x1->variables.end() &&
 					it0->second.data->typeId() == it1->second.data->typeId() &&
-					it0->second.interpolation == it1->second.interpolation
+					it0->second.interpolation == it1->second.interpolation &&
+					it0->second != it1->second
 				)
 				{
-					PrimitiveVariableMap::iterator itRes = xRes->variables.find( it0->first );
-					ObjectPtr resultData = linearObjectInterpolation( it0->second.data.get(), it1->second.data.get(), x );
-					if( resultData )
-					{
-						itRes->second.data = boost::static_pointer_cast<Data>( resultData );
-					}
+					// values can only be interpolated directly when they are indexed identically
+					const bool sameIndices = it0->second.indices == it1->second.indices ||
+						( it0->second.indices && it1->second.indices && it0->second.indices->isEqualTo( it1->second.indices.get() ) );
+					VariableInterpolator::Variable v = {
+						sameIndices ? it0->second.data : it0->second.expandedData(),
+						sameIndices ? it1->second.data : it1->second.expandedData(),
+						!sameIndices,
+						&(xRes->variables.find( it0->first )->second)
+					};
+					variables.push_back( v );
 				}
 			}
+
+			VariableInterpolator variableInterpolator( variables, x );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, variables.size() ), variableInterpolator );
 		}
 		else
 		{
@@ -32,9 +32,18 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "boost/bind.hpp"
 #include "boost/lexical_cast.hpp"
+#include "boost/scoped_ptr.hpp"
+
+#include "tbb/atomic.h"
+#include "tbb/spin_mutex.h"
+#include "tbb/spin_rw_mutex.h"
+
 #include "IECore/LRUCache.h"
 #include "IECore/ObjectPool.h"
+#include "IECore/Exception.h"
+#include "IECore/MessageHandler.h"
 
 using namespace IECore;
 
@@ -42,29 +51,348 @@ using namespace IECore;
 // MemberData
 ////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+
+// Accounts for the blocks of data which may be shared between the objects
+// in the pool, so that each is counted only once. The cost given to the
+// cache for each object excludes its shared blocks, which are instead
+// totalled here and subtracted from the memory limit given to the cache.
+class SharedMemory
+{
+
+	public :
+
+		SharedMemory()
+			:	m_total( 0 )
+		{
+		}
+
+		// Returns the cost of the object excluding any shared blocks,
+		// and registers the blocks as being held by the object. The
+		// registration must be balanced by a call to release().
+		size_t acquire( const Object *object )
+		{
+			Object::MemoryAccumulator::SharedBlocks blocks;
+			Object::MemoryAccumulator accumulator( &blocks );
+			accumulator.accumulate( object );
+
+			Mutex::scoped_lock lock( m_mutex );
+			std::vector<const void *> &registration = m_registrations.insert( Registrations::value_type( object, std::vector<const void *>() ) )->second;
+			registration.reserve( blocks.size() );
+			for( Object::MemoryAccumulator::SharedBlocks::const_iterator it = blocks.begin(); it != blocks.end(); ++it )
+			{
+				Block &block = m_blocks[it->first];
+				if( !block.holders++ )
+				{
+					block.bytes = it->second;
+					m_total += block.bytes;
+				}
+				registration.push_back( it->first );
+			}
+
+			return accumulator.total();
+		}
+
+		void release( const ConstObjectPtr &object )
+		{
+			Mutex::scoped_lock lock( m_mutex );
+			Registrations::iterator rIt = m_registrations.find( object.get() );
+			if( rIt == m_registrations.end() )
+			{
+				return;
+			}
+
+			for( std::vector<const void *>::const_iterator it = rIt->second.begin(); it != rIt->second.end(); ++it )
+			{
+				Blocks::iterator bIt = m_blocks.find( *it );
+				assert( bIt != m_blocks.end() );
+				if( !--bIt->second.holders )
+				{
+					m_total -= bIt->second.bytes;
+					m_blocks.erase( bIt );
+				}
+			}
+			m_registrations.erase( rIt );
+		}
+
+		size_t total() const
+		{
+			Mutex::scoped_lock lock( m_mutex );
+			return m_total;
+		}
+
+	private :
+
+		struct Block
+		{
+			Block() : bytes( 0 ), holders( 0 ) {}
+			size_t bytes;
+			size_t holders;
+		};
+
+		typedef std::map<const void *, Block> Blocks;
+		// A multimap because concurrent stores may briefly
+		// register the same object twice.
+		typedef std::multimap<const Object *, std::vector<const void *> > Registrations;
+		typedef tbb::spin_mutex Mutex;
+
+		mutable Mutex m_mutex;
+		Blocks m_blocks;
+		Registrations m_registrations;
+		size_t m_total;
+
+};
+
+// The cache is held behind a virtual interface so that the policy can
+// be chosen at runtime without templating ObjectPool itself.
+struct Cache
+{
+
+	virtual ~Cache()
+	{
+	}
+
+	virtual ConstObjectPtr get( const MurmurHash &h ) = 0;
+	virtual bool set( const MurmurHash &h, const ConstObjectPtr &obj, size_t cost ) = 0;
+	virtual bool cached( const MurmurHash &h ) const = 0;
+	virtual bool erase( const MurmurHash &h ) = 0;
+	virtual void clear() = 0;
+	virtual void setMaxCost( size_t maxCost ) = 0;
+	virtual size_t getMaxCost() const = 0;
+	virtual size_t currentCost() const = 0;
+	virtual LRUCacheStatistics statistics() const = 0;
+	virtual void resetStatistics() = 0;
+
+};
+
+template<template<typename> class Policy>
+struct PolicyCache : public Cache
+{
+
+	PolicyCache( size_t maxMemory, DiskObjectPool *diskObjectPool, SharedMemory *sharedMemory )
+		:	cache(
+				Getter( diskObjectPool, sharedMemory, this ), boost::bind( &SharedMemory::release, sharedMemory, _2 ), maxMemory,
+				diskObjectPool ? typename LRUCacheType::EvictionCallback( DiskWriter( diskObjectPool ) ) : typename LRUCacheType::EvictionCallback()
+			)
+	{
+	}
+
+	virtual ConstObjectPtr get( const MurmurHash &h )
+	{
+		return cache.get( h );
+	}
+
+	virtual bool set( const MurmurHash &h, const ConstObjectPtr &obj, size_t cost )
+	{
+		return cache.set( h, obj, cost );
+	}
+
+	virtual bool cached( const MurmurHash &h ) const
+	{
+		return cache.cached( h );
+	}
+
+	virtual bool erase( const MurmurHash &h )
+	{
+		return cache.erase( h );
+	}
+
+	virtual void clear()
+	{
+		cache.clear();
+	}
+
+	virtual void setMaxCost( size_t maxCost )
+	{
+		cache.setMaxCost( maxCost );
+	}
+
+	virtual size_t getMaxCost() const
+	{
+		return cache.getMaxCost();
+	}
+
+	virtual size_t currentCost() const
+	{
+		return cache.currentCost();
+	}
+
+	virtual LRUCacheStatistics statistics() const
+	{
+		return cache.statistics();
+	}
+
+	virtual void resetStatistics()
+	{
+		cache.resetStatistics();
+	}
+
+	/// our getter returns NULL, unless the object can be loaded from the DiskObjectPool
+	struct Getter
+	{
+
+		Getter( DiskObjectPool *diskObjectPool, SharedMemory *sharedMemory, const PolicyCache *policyCache )
+			:	diskObjectPool( diskObjectPool ), sharedMemory( sharedMemory ), policyCache( policyCache )
+		{
+		}
+
+		ConstObjectPtr operator()( const MurmurHash &h, size_t &cost ) const
+		{
+			cost = 0;
+			if( !diskObjectPool )
+			{
+				return NULL;
+			}
+			ConstObjectPtr result = diskObjectPool->retrieve( h );
+			if( result )
+			{
+				cost = sharedMemory->acquire( result.get() );
+				// The cache won't store an object which exceeds its limit,
+				// and so won't call the removal callback to release it.
+				// Reading the limit is safe, even though other access to
+				// the cache from the getter isn't, and it can't change
+				// before the cache makes the same test, because
+				// MemberData::get() prevents updateCacheLimit() from
+				// running concurrently.
+				if( cost > policyCache->getMaxCost() )
+				{
+					sharedMemory->release( result );
+				}
+			}
+			return result;
+		}
+
+		DiskObjectPool *diskObjectPool;
+		SharedMemory *sharedMemory;
+		const PolicyCache *policyCache;
+
+	};
+
+	/// writes evicted objects to the DiskObjectPool
+	struct DiskWriter
+	{
+
+		DiskWriter( DiskObjectPool *diskObjectPool )
+			:	diskObjectPool( diskObjectPool )
+		{
+		}
+
+		void operator()( const MurmurHash &h, const ConstObjectPtr &obj ) const
+		{
+			if( !obj )
+			{
+				return;
+			}
+			try
+			{
+				diskObjectPool->store( obj.get() );
+			}
+			catch( const std::exception &e )
+			{
+				msg( Msg::Warning, "ObjectPool", e.what() );
+			}
+		}
+
+		DiskObjectPool *diskObjectPool;
+
+	};
+
+	typedef LRUCache< MurmurHash, ConstObjectPtr, Policy > LRUCacheType;
+	LRUCacheType cache;
+
+};
+
+Cache *createCache( size_t maxMemory, ObjectPool::EvictionPolicy evictionPolicy, DiskObjectPool *diskObjectPool, SharedMemory *sharedMemory )
+{
+	switch( evictionPolicy )
+	{
+		case ObjectPool::ExactLRU :
+			return new PolicyCache<LRUCachePolicy::Exact>( maxMemory, diskObjectPool, sharedMemory );
+		case ObjectPool::ShardedLRU :
+			return new PolicyCache<LRUCachePolicy::Sharded>( maxMemory, diskObjectPool, sharedMemory );
+		case ObjectPool::TwoQueue :
+			return new PolicyCache<LRUCachePolicy::TwoQueue>( maxMemory, diskObjectPool, sharedMemory );
+		case ObjectPool::CostWeighted :
+			return new PolicyCache<LRUCachePolicy::CostWeighted>( maxMemory, diskObjectPool, sharedMemory );
+	}
+	throw InvalidArgumentException( "ObjectPool : Invalid eviction policy." );
+}
+
+} // namespace
+
 struct ObjectPool::MemberData
 {
 
-	MemberData( size_t maxMemory ) : cache( getter, maxMemory )
+	MemberData( size_t maxMemory, EvictionPolicy evictionPolicy, DiskObjectPoolPtr diskObjectPool )
+		:	evictionPolicy( evictionPolicy ), diskObjectPool( diskObjectPool ), cache( createCache( maxMemory, evictionPolicy, diskObjectPool.get(), &sharedMemory ) )
 	{
+		this->maxMemory = maxMemory;
 	}
 
-	LRUCache< MurmurHash, ConstObjectPtr > cache;
+	// Gets an object from the cache, which may load it from
+	// the DiskObjectPool. Loading must not overlap with a change
+	// to the cache limit, because the getter and the cache must
+	// agree on whether the object is too costly to store, or
+	// its shared blocks would never be released.
+	ConstObjectPtr get( const MurmurHash &hash )
+	{
+		if( !diskObjectPool )
+		{
+			return cache->get( hash );
+		}
+		LimitMutex::scoped_lock lock( limitMutex, /* write = */ false );
+		return cache->get( hash );
+	}
 
-	/// our getter always returns NULL
-	static ConstObjectPtr getter( const MurmurHash &h, size_t &cost )
+	// Gives the cache whatever remains of the memory limit
+	// once the shared blocks have been accounted for. This
+	// must be called after any operation which may have
+	// changed the shared total. Changes are serialised, so
+	// that concurrent calls can't apply an out of date limit
+	// after a more recent one.
+	void updateCacheLimit()
 	{
-		cost = 0;
-		return NULL;
+		if( computeCacheLimit() == cache->getMaxCost() )
+		{
+			return;
+		}
+
+		LimitMutex::scoped_lock lock( limitMutex );
+		const size_t limit = computeCacheLimit();
+		if( limit != cache->getMaxCost() )
+		{
+			cache->setMaxCost( limit );
+		}
 	}
+
+	size_t computeCacheLimit() const
+	{
+		const size_t shared = sharedMemory.total();
+		const size_t max = maxMemory;
+		return max > shared ? max - shared : 0;
+	}
+
+	const EvictionPolicy evictionPolicy;
+	const DiskObjectPoolPtr diskObjectPool;
+	tbb::atomic<size_t> maxMemory;
+	SharedMemory sharedMemory;
+	boost::scoped_ptr<Cache> cache;
+	typedef tbb::spin_rw_mutex LimitMutex;
+	LimitMutex limitMutex;
+	// The cache itself can't distinguish hits from misses, because
+	// our getter caches NULL for missing objects, so we count them
+	// ourselves.
+	LRUCacheStatisticsCounters statistics;
+
 };
 
 //////////////////////////////////////////////////////////////////////////
 // ObjectPool
 //////////////////////////////////////////////////////////////////////////
 
-ObjectPool::ObjectPool( size_t maxMemory )
-	:	m_data( new MemberData(maxMemory) )
+ObjectPool::ObjectPool( size_t maxMemory, EvictionPolicy evictionPolicy, DiskObjectPoolPtr diskObjectPool )
+	:	m_data( new MemberData( maxMemory, evictionPolicy, diskObjectPool ) )
 {
 }
 
@@ -72,9 +400,33 @@ ObjectPool::~ObjectPool()
 {
 }
 
+ObjectPool::EvictionPolicy ObjectPool::evictionPolicy() const
+{
+	return m_data->evictionPolicy;
+}
+
+DiskObjectPool *ObjectPool::diskObjectPool() const
+{
+	return m_data->diskObjectPool.get();
+}
+
 ConstObjectPtr ObjectPool::retrieve( const MurmurHash &hash ) const
 {
-	return m_data->cache.get(hash);
+	ConstObjectPtr result = m_data->get( hash );
+	if( m_data->diskObjectPool )
+	{
+		// the object may have been loaded from disk
+		m_data->updateCacheLimit();
+	}
+	if( result )
+	{
+		m_data->statistics.hit();
+	}
+	else
+	{
+		m_data->statistics.miss();
+	}
+	return result;
 }
 
 ConstObjectPtr ObjectPool::store( const Object *obj, StoreMode mode )
@@ -82,57 +434,93 @@ ConstObjectPtr ObjectPool::store( const Object *obj, StoreMode mode )
 	MurmurHash h = obj->hash();
 
 	// first tries to see if the object is already in the cache and return that one quickly.
-	ConstObjectPtr cachedObj = m_data->cache.get(h);
-	if ( cachedObj )
+	// we check cached() first so that a store of a new object counts as a single access
+	// to the eviction policy, rather than a miss followed by a set.
+	if( m_data->cache->cached( h ) )
 	{
-		return cachedObj;
+		ConstObjectPtr cachedObj = m_data->get( h );
+		if ( cachedObj )
+		{
+			m_data->statistics.hit();
+			return cachedObj;
+		}
 	}
 
+	m_data->statistics.miss();
+
+	ConstObjectPtr cachedObj;
 	if ( mode == StoreCopy )
 	{
 		cachedObj = obj->copy();
-		m_data->cache.set( h, cachedObj, obj->memoryUsage() );
-		return cachedObj;
 	}
 	else if ( mode == StoreReference )
 	{
-		m_data->cache.set( h, obj, obj->memoryUsage() );
-		return obj;
+		cachedObj = obj;
 	}
 	else
 	{
 		throw Exception( "Invalid store mode!" );
 	}
+
+	// The shared blocks must be acquired before the object is stored,
+	// because it may be released again as soon as it is stored.
+	const size_t cost = m_data->sharedMemory.acquire( cachedObj.get() );
+	if( !m_data->cache->set( h, cachedObj, cost ) )
+	{
+		m_data->sharedMemory.release( cachedObj );
+	}
+	m_data->updateCacheLimit();
+
+	return cachedObj;
 }
 
 bool ObjectPool::contains( const MurmurHash &hash ) const
 {
-	return m_data->cache.cached(hash);
+	return m_data->cache->cached(hash);
 }
 
 void ObjectPool::clear()
 {
-	m_data->cache.clear();
+	m_data->cache->clear();
+	m_data->updateCacheLimit();
 }
 
 bool ObjectPool::erase( const MurmurHash &hash )
 {
-	return m_data->cache.erase(hash);
+	const bool result = m_data->cache->erase(hash);
+	m_data->updateCacheLimit();
+	return result;
 }
 
 void ObjectPool::setMaxMemoryUsage( size_t maxMemory )
 {
-	m_data->cache.setMaxCost(maxMemory);
+	m_data->maxMemory = maxMemory;
+	m_data->updateCacheLimit();
 }
 
 size_t ObjectPool::getMaxMemoryUsage() const
 {
-	return m_data->cache.getMaxCost();
+	return m_data->maxMemory;
 }
 
 size_t ObjectPool::memoryUsage() const
 {
-	return m_data->cache.currentCost();
+	return m_data->cache->currentCost() + m_data->sharedMemory.total();
+}
+
+LRUCacheStatistics ObjectPool::statistics() const
+{
+	const LRUCacheStatistics cacheStatistics = m_data->cache->statistics();
+	LRUCacheStatistics result = m_data->statistics.statistics();
+	result.evictions = cacheStatistics.evictions;
+	result.getterTime = cacheStatistics.getterTime;
+	return result;
+}
+
+void ObjectPool::resetStatistics()
+{
+	m_data->statistics.reset();
+	m_data->cache->resetStatistics();
 }
 
 ObjectPool *ObjectPool::defaultObjectPool()
@@ -142,7 +530,23 @@ ObjectPool *ObjectPool::defaultObjectPool()
 	{
 		const char *m = getenv( "IECORE_OBJECTPOOL_MEMORY" );
 		size_t mi = m ? boost::lexical_cast<size_t>( m ) : 500;
-		c = new ObjectPool(1024 * 1024 * mi);
+
+		DiskObjectPoolPtr diskObjectPool = 0;
+		if( const char *diskPath = getenv( "IECORE_OBJECTPOOL_DISKCACHE_PATH" ) )
+		{
+			const char *diskSize = getenv( "IECORE_OBJECTPOOL_DISKCACHE_SIZE" );
+			size_t diskSizeMB = diskSize ? boost::lexical_cast<size_t>( diskSize ) : 10000;
+			try
+			{
+				diskObjectPool = new DiskObjectPool( diskPath, 1024 * 1024 * diskSizeMB );
+			}
+			catch( const std::exception &e )
+			{
+				msg( Msg::Warning, "ObjectPool::defaultObjectPool", e.what() );
+			}
+		}
+
+		c = new ObjectPool( 1024 * 1024 * mi, ShardedLRU, diskObjectPool );
 	}
 	return c.get();
 }
@@ -34,18 +34,63 @@
 
 #include "IECore/Op.h"
 #include "IECore/CompoundParameter.h"
+#include "IECore/ComputationCache.h"
 
 using namespace IECore;
 
+//////////////////////////////////////////////////////////////////////////
+// Result cache
+//////////////////////////////////////////////////////////////////////////
+
+struct Op::ResultCacheKey
+{
+	ResultCacheKey( Op *op, const CompoundObject *operands )
+		:	op( op ), operands( operands )
+	{
+		op->hash( operands, hash );
+	}
+
+	Op *op;
+	const CompoundObject *operands;
+	MurmurHash hash;
+};
+
+ConstObjectPtr Op::cachedOperation( const ResultCacheKey &key )
+{
+	return key.op->doOperation( key.operands );
+}
+
+MurmurHash Op::resultCacheKeyHash( const ResultCacheKey &key )
+{
+	return key.hash;
+}
+
+namespace
+{
+
+// Templated only so that it may be instantiated with the private Op::ResultCacheKey.
+template<typename T>
+ComputationCache<T> &resultCache( typename ComputationCache<T>::ComputeFn computeFn, typename ComputationCache<T>::HashFn hashFn )
+{
+	static typename ComputationCache<T>::Ptr g_cache = new ComputationCache<T>( computeFn, hashFn );
+	return *g_cache;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Op
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Op );
 
 Op::Op( const std::string &description, ParameterPtr resultParameter )
-	:	Parameterised( description ), m_resultParameter( resultParameter )
+	:	Parameterised( description ), m_resultParameter( resultParameter ), m_resultCaching( false )
 {
 }
 
 Op::Op( const std::string &description, CompoundParameterPtr compoundParameter, ParameterPtr resultParameter )
-	:	Parameterised( description, compoundParameter ), m_resultParameter( resultParameter )
+	:	Parameterised( description, compoundParameter ), m_resultParameter( resultParameter ), m_resultCaching( false )
 {
 }
 
@@ -61,7 +106,20 @@ ObjectPtr Op::operate()
 
 ObjectPtr Op::operate( const CompoundObject *operands )
 {
-	ObjectPtr result = doOperation( operands );
+	ObjectPtr result;
+	if( m_resultCaching && resultCacheable( operands ) )
+	{
+		// the cached result is shared, so we return a copy the caller is free to modify.
+		ConstObjectPtr cachedResult = resultCache<ResultCacheKey>( cachedOperation, resultCacheKeyHash ).get( ResultCacheKey( this, operands ) );
+		if( cachedResult )
+		{
+			result = cachedResult->copy();
+		}
+	}
+	else
+	{
+		result = doOperation( operands );
+	}
 	m_resultParameter->setValidatedValue( result );
 	return result;
 }
@@ -71,3 +129,32 @@ const Parameter * Op::resultParameter() const
 	return m_resultParameter.get();
 }
 
+void Op::setResultCaching( bool enabled )
+{
+	m_resultCaching = enabled;
+}
+
+bool Op::getResultCaching() const
+{
+	return m_resultCaching;
+}
+
+void Op::clearResultCache()
+{
+	resultCache<ResultCacheKey>( cachedOperation, resultCacheKeyHash ).clear();
+}
+
+void Op::hash( const CompoundObject *operands, MurmurHash &h ) const
+{
+	// the description distinguishes Ops implemented in Python which
+	// haven't registered a type of their own.
+	h.append( typeName() );
+	h.append( description() );
+	operands->hash( h );
+}
+
+bool Op::resultCacheable( const CompoundObject *operands ) const
+{
+	return true;
+}
+
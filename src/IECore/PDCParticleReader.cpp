@@ -32,14 +32,19 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "boost/iostreams/device/mapped_file.hpp"
+#include "boost/type_traits/is_same.hpp"
+
+#include "OpenEXR/ImathRandom.h"
+
 #include "IECore/PDCParticleReader.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/ByteOrder.h"
+#include "IECore/Exception.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/FileNameParameter.h"
 #include "IECore/Timer.h"
-#include "IECore/ParticleReader.inl"
 
 
 #include <algorithm>
@@ -47,6 +52,7 @@
 
 #include <fstream>
 #include <cassert>
+#include <cstring>
 
 using namespace IECore;
 using namespace boost;
@@ -58,13 +64,28 @@ IE_CORE_DEFINERUNTIMETYPED( PDCParticleReader );
 const Reader::ReaderDescription<PDCParticleReader> PDCParticleReader::m_readerDescription( "pdc" );
 
 PDCParticleReader::PDCParticleReader( )
-	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_iStream( 0 ), m_idAttribute( 0 )
+	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_iStream( 0 ), m_selectionValid( false )
 {
+	m_memoryMappedParameter = new BoolParameter(
+		"memoryMapped",
+		"Maps the file into memory rather than reading it through a stream. This "
+		"avoids copying the raw data for each attribute before it is decoded.",
+		false
+	);
+	parameters()->addParameter( m_memoryMappedParameter );
 }
 
 PDCParticleReader::PDCParticleReader( const std::string &fileName )
-	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_iStream( 0 ), m_idAttribute( 0 )
+	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_iStream( 0 ), m_selectionValid( false )
 {
+	m_memoryMappedParameter = new BoolParameter(
+		"memoryMapped",
+		"Maps the file into memory rather than reading it through a stream. This "
+		"avoids copying the raw data for each attribute before it is decoded.",
+		false
+	);
+	parameters()->addParameter( m_memoryMappedParameter );
+
 	m_fileNameParameter->setTypedValue( fileName );
 }
 
@@ -94,6 +115,9 @@ bool PDCParticleReader::open()
 	if( !m_iStream || m_streamFileName!=fileName() )
 	{
 		delete m_iStream;
+		m_mappedFile.reset();
+		m_selectionValid = false;
+		m_header.attributes.clear();
 		m_iStream = new ifstream( fileName().c_str() );
 		if( !m_iStream->is_open() || !m_iStream->good() )
 		{
@@ -203,7 +227,6 @@ bool PDCParticleReader::open()
 
 		m_header.valid = m_iStream->good();
 		m_streamFileName = fileName();
-		m_idAttribute = 0;
 	}
 	return m_iStream->good() && m_header.valid;
 }
@@ -246,7 +269,210 @@ void PDCParticleReader::readElements( T *buffer, std::streampos pos, unsigned lo
 	assert( m_iStream->good() );
 }
 
+namespace
+{
+
+// Decodes numComponents values of type In per particle from the raw file
+// data, converting them to type Out. When indices are provided only those
+// particles are decoded, with indexOffset being the index of the first
+// particle in data.
+template<typename In, typename Out>
+void decode( const char *data, bool reverse, size_t numComponents, size_t numParticles, const unsigned *indices, size_t indexOffset, Out *out )
+{
+	if( !reverse && !indices && boost::is_same<In, Out>::value )
+	{
+		// same type, same byte order and no filtering - a straight copy will do.
+		memcpy( out, data, numParticles * numComponents * sizeof( In ) );
+		return;
+	}
+
+	const size_t stride = numComponents * sizeof( In );
+	for( size_t i=0; i<numParticles; i++ )
+	{
+		const char *p = data + ( indices ? indices[i] - indexOffset : i ) * stride;
+		for( size_t c=0; c<numComponents; c++ )
+		{
+			In v;
+			memcpy( &v, p, sizeof( In ) );
+			if( reverse )
+			{
+				v = reverseBytes( v );
+			}
+			*out++ = static_cast<Out>( v );
+			p += sizeof( In );
+		}
+	}
+}
+
+} // namespace
+
+const char *PDCParticleReader::attributeData( const Record &record, size_t offset, size_t size, std::vector<char> &buffer )
+{
+	if( m_memoryMappedParameter->getTypedValue() )
+	{
+		if( !m_mappedFile )
+		{
+			try
+			{
+				m_mappedFile.reset( new iostreams::mapped_file_source( fileName() ) );
+			}
+			catch( const std::exception &e )
+			{
+				throw IOException( ( format( "PDCParticleReader : Cannot map file \"%s\" (%s)." ) % fileName() % e.what() ).str() );
+			}
+		}
+		const size_t position = (size_t)record.position + offset;
+		if( position + size > m_mappedFile->size() )
+		{
+			throw IOException( ( format( "PDCParticleReader : File \"%s\" is truncated." ) % fileName() ).str() );
+		}
+		return m_mappedFile->data() + position;
+	}
+
+	buffer.resize( size );
+	m_iStream->seekg( record.position + (std::streamoff)offset );
+	m_iStream->read( &buffer[0], size );
+	if( !m_iStream->good() )
+	{
+		throw IOException( ( format( "PDCParticleReader : Error reading file \"%s\"." ) % fileName() ).str() );
+	}
+	return &buffer[0];
+}
+
+const PDCParticleReader::Record *PDCParticleReader::idRecord() const
+{
+	map<string, Record>::const_iterator it = m_header.attributes.find( "particleId" );
+	if( it == m_header.attributes.end() )
+	{
+		it = m_header.attributes.find( "id" );
+	}
+
+	if( it != m_header.attributes.end() && ( it->second.type == DoubleArray || it->second.type == IntegerArray ) )
+	{
+		return &(it->second);
+	}
+	return 0;
+}
+
+const std::vector<unsigned> *PDCParticleReader::selection()
+{
+	const float percentage = particlePercentage();
+	if( percentage >= 100.0f )
+	{
+		return 0;
+	}
+
+	const int seed = particlePercentageSeed();
+	if( m_selectionValid && m_selectionPercentage == percentage && m_selectionSeed == seed )
+	{
+		return &m_selection;
+	}
+
+	// this must match the selection made by ParticleReader::filterAttr(),
+	// so that filtering behaves exactly as it does for other readers.
+	const size_t n = m_header.numParticles;
+	const float fraction = percentage / 100.0f;
+	m_selection.clear();
+	Rand48 r;
+
+	const Record *ids = idRecord();
+	if( ids )
+	{
+		std::vector<char> buffer;
+		if( ids->type == IntegerArray )
+		{
+			std::vector<int> idValues( n );
+			if( n )
+			{
+				decode<int, int>( attributeData( *ids, 0, n * sizeof( int ), buffer ), m_header.reverseBytes, 1, n, 0, 0, &idValues[0] );
+			}
+			for( size_t i=0; i<n; i++ )
+			{
+				r.init( seed + idValues[i] );
+				if( r.nextf() <= fraction )
+				{
+					m_selection.push_back( i );
+				}
+			}
+		}
+		else
+		{
+			std::vector<double> idValues( n );
+			if( n )
+			{
+				decode<double, double>( attributeData( *ids, 0, n * sizeof( double ), buffer ), m_header.reverseBytes, 1, n, 0, 0, &idValues[0] );
+			}
+			for( size_t i=0; i<n; i++ )
+			{
+				r.init( seed + (int)idValues[i] );
+				if( r.nextf() <= fraction )
+				{
+					m_selection.push_back( i );
+				}
+			}
+		}
+	}
+	else
+	{
+		r.init( seed );
+		for( size_t i=0; i<n; i++ )
+		{
+			if( r.nextf() <= fraction )
+			{
+				m_selection.push_back( i );
+			}
+		}
+	}
+
+	m_selectionValid = true;
+	m_selectionPercentage = percentage;
+	m_selectionSeed = seed;
+	return &m_selection;
+}
+
+template<typename T, typename F>
+typename T::Ptr PDCParticleReader::readArray( const Record &record, size_t numComponents, size_t begin, size_t end )
+{
+	const size_t n = m_header.numParticles;
+	begin = std::min( begin, n );
+	end = std::max( begin, std::min( end, n ) );
+
+	const unsigned *indices = 0;
+	size_t numSelected = end - begin;
+	if( const std::vector<unsigned> *s = selection() )
+	{
+		// the selection is sorted, so we can find the
+		// selected particles within the range by bisection.
+		const std::vector<unsigned>::const_iterator rangeBegin = lower_bound( s->begin(), s->end(), begin );
+		const std::vector<unsigned>::const_iterator rangeEnd = lower_bound( rangeBegin, s->end(), end );
+		numSelected = rangeEnd - rangeBegin;
+		indices = numSelected ? &*rangeBegin : 0;
+	}
+
+	typename T::Ptr result = new T;
+	result->writable().resize( numSelected );
+	if( !numSelected )
+	{
+		return result;
+	}
+
+	// only read the data spanned by the particles we're keeping.
+	const size_t stride = numComponents * sizeof( F );
+	const size_t first = indices ? indices[0] : begin;
+	const size_t last = indices ? indices[numSelected-1] + 1 : end;
+
+	std::vector<char> buffer;
+	const char *data = attributeData( record, first * stride, ( last - first ) * stride, buffer );
+	decode<F, typename T::BaseType>( data, m_header.reverseBytes, numComponents, numSelected, indices, first, result->baseWritable() );
+	return result;
+}
+
 DataPtr PDCParticleReader::readAttribute( const std::string &name )
+{
+	return readAttributeRange( name, 0, numParticles() );
+}
+
+DataPtr PDCParticleReader::readAttributeRange( const std::string &name, size_t begin, size_t end )
 {
 	if( !open() )
 	{
@@ -259,8 +485,7 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 		return 0;
 	}
 
-	const Data *idAttr = idAttribute();
-	if ( !idAttr && particlePercentage() < 100.0f )
+	if ( !idRecord() && particlePercentage() < 100.0f )
 	{
 		msg( Msg::Warning, "PDCParticleReader::filterAttr", format( "Percentage filtering requested but file \"%s\" contains no particle Id attribute." ) % fileName() );
 	}
@@ -276,12 +501,7 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 			}
 			break;
 		case IntegerArray :
-			{
-				IntVectorDataPtr d( new IntVectorData );
-				d->writable().resize( numParticles() );
-				readElements( &d->writable()[0], it->second.position, numParticles() );
-				result = filterAttr<IntVectorData, IntVectorData>( d.get(), particlePercentage(), idAttr );
-			}
+			result = readArray<IntVectorData, int>( it->second, 1, begin, end );
 			break;
 		case Double :
 			{
@@ -300,20 +520,15 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 			}
 			break;
 		case DoubleArray :
+			switch( realType() )
 			{
-				DoubleVectorDataPtr d( new DoubleVectorData );
-				d->writable().resize( numParticles() );
-				readElements( &d->writable()[0], it->second.position, numParticles() );
-				switch( realType() )
-				{
-					case Native :
-					case Double :
-						result = filterAttr<DoubleVectorData, DoubleVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-					case Float :
-						result = filterAttr<FloatVectorData, DoubleVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-				}
+				case Native :
+				case Double :
+					result = readArray<DoubleVectorData, double>( it->second, 1, begin, end );
+					break;
+				case Float :
+					result = readArray<FloatVectorData, double>( it->second, 1, begin, end );
+					break;
 			}
 			break;
 		case Vector :
@@ -333,34 +548,15 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 			}
 			break;
 		case VectorArray :
+			switch( realType() )
 			{
-				V3dVectorDataPtr d( new V3dVectorData );
-				/// \todo
-				/// by all accounts the line below should be this :
-				///
-				/// d->writable().resize( numParticles() );
-				///
-				/// ie it shouldn't initialize the memory. but for some reason
-				/// that runs far far slower for us (at least an order of magnitude
-				/// slower) when we're in maya or python. we don't know why but it seems
-				/// to be related to libstdc++ (maya has it's own). so we're opting for
-				/// the initialized version - this seems slightly (~10%) slower when the planets
-				/// are aligned correctly, but so much faster when the planets are aligned against
-				/// us, as they seem to be whenever we're coding in maya. testing seems to show that
-				/// this resize problem only occurs with V3d, and not with V3f, or double, or even
-				/// a struct with 3 doubles in, or even a template struct with 3 doubles in.
-				d->writable().resize( numParticles(), V3d( 0 ) );
-				readElements( (double *)&d->writable()[0], it->second.position, numParticles() * 3 );
-				switch( realType() )
-				{
-					case Native :
-					case Double :
-						result = filterAttr<V3dVectorData, V3dVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-					case Float :
-						result = filterAttr<V3fVectorData, V3dVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-				}
+				case Native :
+				case Double :
+					result = readArray<V3dVectorData, double>( it->second, 3, begin, end );
+					break;
+				case Float :
+					result = readArray<V3fVectorData, double>( it->second, 3, begin, end );
+					break;
 			}
 			break;
 		default :
@@ -370,39 +566,14 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 	return result;
 }
 
-const Data * PDCParticleReader::idAttribute()
+BoolParameter *PDCParticleReader::memoryMappedParameter()
 {
-	if( !open() )
-	{
-		return 0;
-	}
-	if( !m_idAttribute )
-	{
-		map<string, Record>::const_iterator it = m_header.attributes.find( "particleId" );
-		if( it == m_header.attributes.end() )
-		{
-			it = m_header.attributes.find( "id" );
-		}
-		
-		if( it!=m_header.attributes.end() )
-		{
-			if( it->second.type==DoubleArray )
-			{
-				DoubleVectorDataPtr doubleVec = new DoubleVectorData;
-				doubleVec->writable().resize( numParticles() );
-				readElements( &doubleVec->writable()[0], it->second.position, numParticles() );
-				m_idAttribute = doubleVec;
-			}
-			if( it->second.type==IntegerArray )
-			{
-				IntVectorDataPtr intVec = new IntVectorData;
-				intVec->writable().resize( numParticles() );
-				readElements( &intVec->writable()[0], it->second.position, numParticles() );
-				m_idAttribute = intVec;
-			}
-		}
-	}
-	return m_idAttribute.get();
+	return m_memoryMappedParameter.get();
+}
+
+const BoolParameter *PDCParticleReader::memoryMappedParameter() const
+{
+	return m_memoryMappedParameter.get();
 }
 
 std::string PDCParticleReader::positionPrimVarName()
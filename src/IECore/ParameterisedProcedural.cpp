@@ -36,6 +36,7 @@
 #include "IECore/CompoundParameter.h"
 #include "IECore/Renderer.h"
 #include "IECore/AttributeBlock.h"
+#include "IECore/Profiling.h"
 
 using namespace IECore;
 
@@ -144,6 +145,7 @@ void ParameterisedProcedural::render( Renderer *renderer ) const
 
 void ParameterisedProcedural::render( Renderer *renderer, bool inAttributeBlock, bool withState, bool withGeometry, bool immediateGeometry ) const
 {
+	IECORE_PROFILE_ZONE( "ParameterisedProcedural::render" );
 	ConstCompoundObjectPtr validatedArgs = parameters()->getTypedValidatedValue<CompoundObject>();
 
 	AttributeBlock attributeBlock( renderer, inAttributeBlock );
@@ -45,6 +45,7 @@
 #include "IECore/NullObject.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/TestTypedData.h"
+#include "IECore/Exception.h"
 
 #include <algorithm>
 
@@ -154,18 +155,84 @@ const BoolParameter * ParticleReader::convertPrimVarNamesParameter() const
 	return m_convertPrimVarNamesParameter.get();
 }
 
+namespace
+{
+
+struct RangeCopier
+{
+	typedef DataPtr ReturnType;
+
+	RangeCopier( size_t begin, size_t end )
+		:	m_begin( begin ), m_end( end )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		const typename T::ValueType &in = data->readable();
+		const size_t begin = std::min( m_begin, in.size() );
+		const size_t end = std::max( begin, std::min( m_end, in.size() ) );
+
+		typename T::Ptr result = new T;
+		result->writable().assign( in.begin() + begin, in.begin() + end );
+		return result;
+	}
+
+	size_t m_begin;
+	size_t m_end;
+};
+
+} // namespace
+
+DataPtr ParticleReader::readAttributeRange( const std::string &name, size_t begin, size_t end )
+{
+	DataPtr d = readAttribute( name );
+	if( !d || !testTypedData<TypeTraits::IsVectorTypedData>( d.get() ) )
+	{
+		return d;
+	}
+
+	if( particlePercentage() < 100.0f )
+	{
+		throw Exception( ( format( "ParticleReader::readAttributeRange : %s does not support percentage filtering of ranges." ) % typeName() ).str() );
+	}
+
+	RangeCopier rangeCopier( begin, end );
+	return despatchTypedData<RangeCopier, TypeTraits::IsVectorTypedData>( d.get(), rangeCopier );
+}
+
+PointsPrimitivePtr ParticleReader::readRange( size_t begin, size_t end )
+{
+	return readPoints( true, begin, end );
+}
+
 ObjectPtr ParticleReader::doOperation( const CompoundObject * operands )
+{
+	return readPoints( false, 0, 0 );
+}
+
+PointsPrimitivePtr ParticleReader::readPoints( bool range, size_t begin, size_t end )
 {
 	vector<string> attributes;
 	particleAttributes( attributes );
-	PointsPrimitivePtr result = new PointsPrimitive( numParticles() );
+
+	size_t numPoints = numParticles();
+	if( range )
+	{
+		begin = std::min( begin, numPoints );
+		end = std::max( begin, std::min( end, numPoints ) );
+		numPoints = end - begin;
+	}
+
+	PointsPrimitivePtr result = new PointsPrimitive( numPoints );
 	// because of percentage filtering we don't really know the number of points until we've loaded an attribute.
 	// we start off with numParticles() in case there aren't any varying attributes in the cache at all, but replace it
 	// below as soon as we have a revised (percentage filtered) value.
 	bool haveNumPoints = false;
 	for( vector<string>::const_iterator it = attributes.begin(); it!=attributes.end(); it++ )
 	{
-		DataPtr d = readAttribute( *it );
+		DataPtr d = range ? readAttributeRange( *it, begin, end ) : readAttribute( *it );
 
 		if ( testTypedData<TypeTraits::IsVectorTypedData>( d.get() ) )
 		{
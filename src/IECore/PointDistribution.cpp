@@ -1,14 +1,132 @@
 #include "IECore/PointDistribution.h"
 #include "IECore/Exception.h"
 #include "IECore/ImathRandAdapter.h"
+#include "IECore/FastFloat.h"
+#include "IECore/LRUCache.h"
+#include "IECore/MurmurHash.h"
 
 #include "OpenEXR/ImathRandom.h"
 
+#include "boost/bind.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include <fstream>
 #include <algorithm>
+#include <cmath>
 
 using namespace IECore;
 
+//////////////////////////////////////////////////////////////////////////
+// Internal types
+//////////////////////////////////////////////////////////////////////////
+
+struct PointDistribution::CandidatesKey
+{
+	CandidatesKey()
+		:	density( 0 )
+	{
+	}
+
+	CandidatesKey( const Imath::Box2f &b, float d )
+		:	bounds( b ), density( d )
+	{
+	}
+
+	bool operator == ( const CandidatesKey &other ) const
+	{
+		return bounds == other.bounds && density == other.density;
+	}
+
+	friend size_t tbb_hasher( const CandidatesKey &key )
+	{
+		MurmurHash h;
+		h.append( key.bounds );
+		h.append( key.density );
+		return tbb_hasher( h );
+	}
+
+	Imath::Box2f bounds;
+	float density;
+};
+
+class PointDistribution::Cache : public LRUCache<CandidatesKey, ConstCandidatesPtr>
+{
+
+	public :
+
+		Cache( const PointDistribution *distribution )
+			:	LRUCache<CandidatesKey, ConstCandidatesPtr>( boost::bind( &PointDistribution::generateCandidates, distribution, _1, _2 ), memoryLimit() )
+		{
+		}
+
+	private :
+
+		static size_t memoryLimit()
+		{
+			const char *m = getenv( "IECORE_POINTDISTRIBUTION_MEMORY" );
+			return 1024 * 1024 * ( m ? boost::lexical_cast<size_t>( m ) : 100 );
+		}
+
+};
+
+// A unit of work for generateCandidates(). Either the top level points
+// and subpoints of a tile, or the complete recursion from one of its
+// subtiles.
+struct PointDistribution::Job
+{
+	Job( const Tile *t, const Imath::V2f &b, unsigned l )
+		:	tile( t ), bottomLeft( b ), level( l )
+	{
+	}
+
+	const Tile *tile;
+	Imath::V2f bottomLeft;
+	unsigned level;
+};
+
+class PointDistribution::JobRunner
+{
+
+	public :
+
+		JobRunner( const PointDistribution *distribution, const std::vector<Job> &jobs, const Imath::Box2f &bounds, float density, std::vector<Candidates> &results )
+			:	m_distribution( distribution ), m_jobs( jobs ), m_bounds( bounds ), m_density( density ), m_results( results )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i=r.begin(); i!=r.end(); ++i )
+			{
+				const Job &job = m_jobs[i];
+				if( job.level == 0 )
+				{
+					m_distribution->processTile( *job.tile, job.bottomLeft, m_bounds, m_density, m_results[i] );
+				}
+				else
+				{
+					m_distribution->recurseTile( *job.tile, job.bottomLeft, job.level, m_bounds, m_density, true, m_results[i] );
+				}
+			}
+		}
+
+	private :
+
+		const PointDistribution *m_distribution;
+		const std::vector<Job> &m_jobs;
+		const Imath::Box2f &m_bounds;
+		float m_density;
+		std::vector<Candidates> &m_results;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// PointDistribution
+//////////////////////////////////////////////////////////////////////////
+
 PointDistribution::PointDistribution( const std::string &tileSet )
 	:	m_numSubTiles( 0 )
 {
@@ -98,9 +216,15 @@ PointDistribution::PointDistribution( const std::string &tileSet )
 	std::random_shuffle( m_perm.begin(), m_perm.begin() + m_permSize, random );
 	// fill second half of table with a copy of first half
 	std::copy( m_perm.begin(), m_perm.begin() + m_permSize, m_perm.begin() + m_permSize );
+
+	m_cache.reset( new Cache( this ) );
 	
 }
 
+PointDistribution::~PointDistribution()
+{
+}
+
 const PointDistribution &PointDistribution::defaultInstance()
 {
 	static PointDistribution *p = 0;
@@ -115,3 +239,165 @@ const PointDistribution &PointDistribution::defaultInstance()
 	}
 	return *p;
 }
+
+PointDistribution::ConstCandidatesPtr PointDistribution::candidates( const Imath::Box2f &bounds, float density ) const
+{
+	return m_cache->get( CandidatesKey( bounds, density ) );
+}
+
+PointDistribution::ConstCandidatesPtr PointDistribution::generateCandidates( const CandidatesKey &key, size_t &cost ) const
+{
+	const Imath::Box2f &bounds = key.bounds;
+	const float density = key.density;
+
+	Imath::Box2i bi;
+	bi.min.x = fastFloatFloor( bounds.min.x );
+	bi.max.x = fastFloatFloor( bounds.max.x );
+	bi.min.y = fastFloatFloor( bounds.min.y );
+	bi.max.y = fastFloatFloor( bounds.max.y );
+
+	// Divide the work up into jobs which can be run in parallel, ordered
+	// such that concatenating their results gives exactly the same order
+	// as a serial traversal.
+
+	std::vector<Job> jobs;
+	for( int x=bi.min.x; x<=bi.max.x; x++ )
+	{
+		for( int y=bi.min.y; y<=bi.max.y; y++ )
+		{
+			unsigned sw = hash( x, y );
+			unsigned nw = hash( x, y+1 );
+			unsigned ne = hash( x+1, y+1 );
+			unsigned se = hash( x+1, y );
+			int w = (sw + nw) % 2;
+			int n = (nw + ne) % 2;
+			int e = (ne + se) % 2;
+			for( unsigned i=0; i<m_tiles.size(); i++ )
+			{
+				const Tile *tile = &m_tiles[i];
+				if( tile->w==w && tile->n==n && tile->e==e )
+				{
+					const Imath::V2f bottomLeft( x, y );
+					jobs.push_back( Job( tile, bottomLeft, 0 ) );
+					if( subdivides( *tile, bottomLeft, 0, bounds, density ) )
+					{
+						const float size = tileSize( 0 );
+						for( int sy=0; sy<m_numSubTiles; sy++ )
+						{
+							for( int sx=0; sx<m_numSubTiles; sx++ )
+							{
+								const Imath::V2f subBottomLeft = bottomLeft + Imath::V2f( sx, sy ) * size / m_numSubTiles;
+								jobs.push_back( Job( tile->subTiles[sy*m_numSubTiles + sx], subBottomLeft, 1 ) );
+							}
+						}
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	std::vector<Candidates> results( jobs.size() );
+	JobRunner runner( this, jobs, bounds, density, results );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, jobs.size(), 1 ), runner );
+
+	size_t numPoints = 0;
+	for( std::vector<Candidates>::const_iterator it = results.begin(), eIt = results.end(); it != eIt; ++it )
+	{
+		numPoints += it->points.size();
+	}
+
+	boost::shared_ptr<Candidates> result( new Candidates );
+	result->points.reserve( numPoints );
+	result->densityThresholds.reserve( numPoints );
+	for( std::vector<Candidates>::const_iterator it = results.begin(), eIt = results.end(); it != eIt; ++it )
+	{
+		result->points.insert( result->points.end(), it->points.begin(), it->points.end() );
+		result->densityThresholds.insert( result->densityThresholds.end(), it->densityThresholds.begin(), it->densityThresholds.end() );
+	}
+
+	cost = sizeof( Candidates ) + numPoints * ( sizeof( Imath::V2f ) + sizeof( float ) );
+	return result;
+}
+
+void PointDistribution::processTile( const Tile &tile, const Imath::V2f &bottomLeft, const Imath::Box2f &bounds, float density, Candidates &candidates ) const
+{
+	unsigned potentialPoints = std::min( tile.points.size(), (size_t)density );
+	float factor = 1.0f / density;
+	for( unsigned i=0; i<potentialPoints; i++ )
+	{
+		const Imath::V2f p = bottomLeft + tile.points[i];
+		if( !bounds.intersects( p ) )
+		{
+			continue;
+		}
+
+		candidates.points.push_back( p );
+		candidates.densityThresholds.push_back( i * factor );
+	}
+
+	// the subtiles are dealt with as separate jobs
+	recurseTile( tile, bottomLeft, 0, bounds, density, false, candidates );
+}
+
+void PointDistribution::recurseTile( const Tile &tile, const Imath::V2f &bottomLeft, unsigned level, const Imath::Box2f &bounds, float density, bool recurse, Candidates &candidates ) const
+{
+	float tileSize = this->tileSize( level );
+
+	Imath::Box2f tileBound( bottomLeft, bottomLeft + Imath::V2f( tileSize ) );
+	if( !tileBound.intersects( bounds ) )
+	{
+		return;
+	}
+
+	float tileArea = tileSize * tileSize;
+	float numPointsInTile = density * tileArea;
+	int potentialPoints = std::min( (int)tile.subPoints.size(), (int)numPointsInTile - (int)tile.points.size() );
+
+	float factor = 1.0f / ( numPointsInTile );
+
+	for( int i=0; i<potentialPoints; i++ )
+	{
+		const Imath::V2f p = bottomLeft + tile.subPoints[i] * tileSize;
+		if( !bounds.intersects( p ) )
+		{
+			continue;
+		}
+
+		candidates.points.push_back( p );
+		candidates.densityThresholds.push_back( ( i + tile.points.size() ) * factor );
+	}
+
+	if( recurse && numPointsInTile - tile.points.size() > tile.subPoints.size() )
+	{
+		for( int y=0; y<m_numSubTiles; y++ )
+		{
+			for( int x=0; x<m_numSubTiles; x++ )
+			{
+				Imath::V2f newBottomLeft = bottomLeft + Imath::V2f( x, y ) * tileSize / m_numSubTiles;
+				recurseTile( *(tile.subTiles[y*m_numSubTiles + x]), newBottomLeft, level + 1, bounds, density, true, candidates );
+			}
+		}
+	}
+}
+
+bool PointDistribution::subdivides( const Tile &tile, const Imath::V2f &bottomLeft, unsigned level, const Imath::Box2f &bounds, float density ) const
+{
+	// must match the conditions for recursion in recurseTile()
+	float tileSize = this->tileSize( level );
+
+	Imath::Box2f tileBound( bottomLeft, bottomLeft + Imath::V2f( tileSize ) );
+	if( !tileBound.intersects( bounds ) )
+	{
+		return false;
+	}
+
+	float tileArea = tileSize * tileSize;
+	float numPointsInTile = density * tileArea;
+	return numPointsInTile - tile.points.size() > tile.subPoints.size();
+}
+
+float PointDistribution::tileSize( unsigned level ) const
+{
+	return 1.0f / powf( (float)m_numSubTiles, (float)level );
+}
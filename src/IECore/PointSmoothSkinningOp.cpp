@@ -52,6 +52,9 @@
 #include "IECore/VectorOps.h"
 #include "IECore/DespatchTypedData.h"
 
+#include "OpenEXR/ImathMatrixAlgo.h"
+#include "OpenEXR/ImathQuat.h"
+
 using namespace IECore;
 using namespace Imath;
 using namespace std;
@@ -95,12 +98,13 @@ PointSmoothSkinningOp::PointSmoothSkinningOp() :
 
 	IntParameter::PresetsContainer blendPresets;
 	blendPresets.push_back( IntParameter::Preset( "Linear", Linear ) );
+	blendPresets.push_back( IntParameter::Preset( "DualQuaternion", DualQuaternion ) );
 	m_blendParameter = new IntParameter(
 	        "blend",
 	        "Blending algorithm used to deform the mesh.",
 	        Linear,
 	        Linear,
-	        Linear,
+	        DualQuaternion,
 	        blendPresets,
 	        true
 	);
@@ -203,117 +207,348 @@ const IntVectorParameter * PointSmoothSkinningOp::refIndicesParameter() const
 	return m_refIndicesParameter.get();
 }
 
+namespace
+{
+
+// Base class for linear blend skinning, providing the deformation
+// of normals.
+class LinearSkinner
+{
+
+	public :
+
+		LinearSkinner( const std::vector<M44f> &matrices )
+			:	m_matrices( matrices )
+		{
+		}
+
+		template<typename Iterator>
+		V3f deformNormal( const V3f &n, Iterator begin, Iterator end ) const
+		{
+			V3f result( 0 );
+			V3f t;
+			for( Iterator it = begin; it != end; ++it )
+			{
+				m_matrices[it->index].multDirMatrix( n, t );
+				result += t * it->weight;
+			}
+			return result;
+		}
+
+	protected :
+
+		const std::vector<M44f> &m_matrices;
+
+};
+
+// Linear blend skinning for arbitrary matrices.
+class ProjectiveLinearSkinner : public LinearSkinner
+{
+
+	public :
+
+		ProjectiveLinearSkinner( const std::vector<M44f> &matrices )
+			:	LinearSkinner( matrices )
+		{
+		}
+
+		template<typename Iterator>
+		V3f deformPoint( const V3f &p, Iterator begin, Iterator end ) const
+		{
+			V3f result( 0 );
+			for( Iterator it = begin; it != end; ++it )
+			{
+				result += p * m_matrices[it->index] * it->weight;
+			}
+			return result;
+		}
+
+};
+
+// Linear blend skinning for matrices which are all affine. This performs the
+// same arithmetic as V3f * M44f, but avoids the projective divide.
+class AffineLinearSkinner : public LinearSkinner
+{
+
+	public :
+
+		AffineLinearSkinner( const std::vector<M44f> &matrices )
+			:	LinearSkinner( matrices )
+		{
+		}
+
+		static bool compatible( const std::vector<M44f> &matrices )
+		{
+			for( std::vector<M44f>::const_iterator it = matrices.begin(); it != matrices.end(); ++it )
+			{
+				const M44f &m = *it;
+				if( m[0][3] != 0.0f || m[1][3] != 0.0f || m[2][3] != 0.0f || m[3][3] != 1.0f )
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		template<typename Iterator>
+		V3f deformPoint( const V3f &p, Iterator begin, Iterator end ) const
+		{
+			V3f result( 0 );
+			for( Iterator it = begin; it != end; ++it )
+			{
+				const M44f &m = m_matrices[it->index];
+				const V3f t(
+					p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0],
+					p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1],
+					p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2]
+				);
+				result += t * it->weight;
+			}
+			return result;
+		}
+
+};
+
+// Dual quaternion skinning. The rigid part of each matrix is converted to
+// a dual quaternion up front, so that the blending for each point is
+// cheap.
+class DualQuaternionSkinner
+{
+
+	public :
+
+		DualQuaternionSkinner( const std::vector<M44f> &matrices )
+		{
+			m_transforms.reserve( matrices.size() );
+			for( std::vector<M44f>::const_iterator it = matrices.begin(); it != matrices.end(); ++it )
+			{
+				M44f m = *it;
+				V3f scale, shear;
+				extractAndRemoveScalingAndShear( m, scale, shear, false );
+
+				Transform t;
+				t.real = extractQuat( m );
+				t.dual = Quatf( 0.0f, it->translation() ) * t.real * 0.5f;
+				m_transforms.push_back( t );
+			}
+		}
+
+		template<typename Iterator>
+		V3f deformPoint( const V3f &p, Iterator begin, Iterator end ) const
+		{
+			Quatf real, dual;
+			if( !blend( begin, end, real, dual ) )
+			{
+				return V3f( 0 );
+			}
+			const V3f translation = ( dual * ~real ).v * 2.0f;
+			return rotate( real, p ) + translation;
+		}
+
+		template<typename Iterator>
+		V3f deformNormal( const V3f &n, Iterator begin, Iterator end ) const
+		{
+			Quatf real, dual;
+			if( !blend( begin, end, real, dual ) )
+			{
+				return V3f( 0 );
+			}
+			return rotate( real, n );
+		}
+
+	private :
+
+		template<typename Iterator>
+		bool blend( Iterator begin, Iterator end, Quatf &real, Quatf &dual ) const
+		{
+			real = Quatf( 0, 0, 0, 0 );
+			dual = Quatf( 0, 0, 0, 0 );
+			if( begin == end )
+			{
+				return false;
+			}
+
+			// q and -q represent the same rotation, so we flip each quaternion
+			// into the same hemisphere as the first before blending, to ensure
+			// we interpolate along the shortest path.
+			const Quatf &pivot = m_transforms[begin->index].real;
+			for( Iterator it = begin; it != end; ++it )
+			{
+				const Transform &t = m_transforms[it->index];
+				const float weight = ( t.real ^ pivot ) < 0.0f ? -it->weight : it->weight;
+				real += t.real * weight;
+				dual += t.dual * weight;
+			}
+
+			const float length = real.length();
+			if( length == 0.0f )
+			{
+				return false;
+			}
+			real /= length;
+			dual /= length;
+			return true;
+		}
+
+		static V3f rotate( const Quatf &q, const V3f &v )
+		{
+			const M33f m = q.toMatrix33();
+			return V3f(
+				v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0],
+				v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1],
+				v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2]
+			);
+		}
+
+		struct Transform
+		{
+			Quatf real;
+			Quatf dual;
+		};
+
+		std::vector<Transform> m_transforms;
+
+};
+
+} // namespace
+
+template<typename Skinner>
 struct PointSmoothSkinningOp::DeformPositions
 {
 	public :
-		
-		DeformPositions( std::vector<V3f> &p_data, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, const std::vector<float> &pointInfluenceWeights, const std::vector<M44f> &skin_data, const std::vector<int> &refId_data )
-			:	m_pData( p_data ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ), m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights ), m_skinData(skin_data), m_refIdData(refId_data)
+
+		DeformPositions( const Skinner &skinner, std::vector<V3f> &p_data, const std::vector<int> &influenceOffsets, const std::vector<Influence> &influences, const std::vector<int> &refId_data )
+			:	m_skinner( skinner ), m_pData( p_data ), m_influenceOffsets( influenceOffsets ), m_influences( influences ), m_refIdData( refId_data )
 		{
 		}
 
 		void operator()( const tbb::blocked_range<size_t> &r ) const
 		{
+			const std::vector<Influence>::const_iterator influences = m_influences.begin();
 			for( size_t p_it=r.begin(); p_it!=r.end(); ++p_it )
 			{
-				V3f p_new(0,0,0);
-				
+				// get the actual index to look up in the smooth skinning data
+				const int p_id = m_refIdData.size() ? m_refIdData[p_it] : p_it;
 				V3f &p_value = m_pData[p_it];
-				int p_id;
-				if( m_refIdData.size() )
-				{
-					// get the actual index to look up in the smooth skinning data
-					p_id = m_refIdData[p_it];
-				}
-				else
-				{
-					p_id = p_it;
-				}
-
-				int p_influence_count = m_pointInfluenceCounts[p_id];
-				int p_index_offset = m_pointIndexOffsets[p_id];
-	
-				for (int p_influence_id = p_index_offset; p_influence_id < (p_index_offset+p_influence_count);
-						p_influence_id++)
-				{
-					int influence_id = m_pointInfluenceIndices[p_influence_id];
-					float weight = m_pointInfluenceWeights[p_influence_id];
-					p_new += p_value * m_skinData[influence_id] * weight;
-				}
-				p_value = p_new;
+				p_value = m_skinner.deformPoint( p_value, influences + m_influenceOffsets[p_id], influences + m_influenceOffsets[p_id+1] );
 			}
 		}
-	
+
 	private :
-		
+
+		const Skinner &m_skinner;
 		std::vector<V3f> &m_pData;
-		const std::vector<int> &m_pointIndexOffsets;
-		const std::vector<int> &m_pointInfluenceCounts;
-		const std::vector<int> &m_pointInfluenceIndices;
-		const std::vector<float> &m_pointInfluenceWeights;
-		const std::vector<M44f> &m_skinData;
+		const std::vector<int> &m_influenceOffsets;
+		const std::vector<Influence> &m_influences;
 		const std::vector<int> &m_refIdData;
-		
+
 };
 
+template<typename Skinner>
 struct PointSmoothSkinningOp::DeformNormals
 {
 	public :
-		
-		DeformNormals( std::vector<V3f> &n_data, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, const std::vector<float> &pointInfluenceWeights, const std::vector<M44f> &skin_data, const std::vector<int> &refId_data, std::vector<int> &vertexIndicesData )
-			:	m_nData( n_data ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ), m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights ), m_skinData(skin_data), m_refIdData(refId_data), m_vertexIndicesData( vertexIndicesData )
+
+		DeformNormals( const Skinner &skinner, std::vector<V3f> &n_data, const std::vector<int> &influenceOffsets, const std::vector<Influence> &influences, const std::vector<int> &refId_data, const std::vector<int> *vertexIndicesData )
+			:	m_skinner( skinner ), m_nData( n_data ), m_influenceOffsets( influenceOffsets ), m_influences( influences ), m_refIdData( refId_data ), m_vertexIndicesData( vertexIndicesData )
 		{
 		}
 
 		void operator()( const tbb::blocked_range<size_t> &r ) const
 		{
+			const std::vector<Influence>::const_iterator influences = m_influences.begin();
 			for( size_t n_it=r.begin(); n_it!=r.end(); ++n_it )
 			{
-				V3f n_new(0,0,0);
-				
-				V3f &n_value = m_nData[n_it];
-				V3f n_unw;
-				
 				int n_id = n_it;
-
-				if( m_vertexIndicesData.size() )
+				if( m_vertexIndicesData )
 				{
-					n_id = m_vertexIndicesData[n_id];
+					n_id = (*m_vertexIndicesData)[n_id];
 				}
 				if( m_refIdData.size() )
 				{
 					n_id = m_refIdData[n_id];
 				}
-				
-				int n_influence_count = m_pointInfluenceCounts[n_id];
-				int n_index_offset = m_pointIndexOffsets[n_id];
-	
-				for (int n_influence_id = n_index_offset; n_influence_id < (n_index_offset+n_influence_count);
-						n_influence_id++)
-				{
-					int influence_id = m_pointInfluenceIndices[n_influence_id];
-					float weight = m_pointInfluenceWeights[n_influence_id];
-	
-					m_skinData[influence_id].multDirMatrix(n_value,n_unw);
-					n_new += n_unw * weight;
-				}	
-				n_value = n_new;
+
+				V3f &n_value = m_nData[n_it];
+				n_value = m_skinner.deformNormal( n_value, influences + m_influenceOffsets[n_id], influences + m_influenceOffsets[n_id+1] );
 			}
 		}
-	
+
 	private :
-		
+
+		const Skinner &m_skinner;
 		std::vector<V3f> &m_nData;
-		const std::vector<int> &m_pointIndexOffsets;
-		const std::vector<int> &m_pointInfluenceCounts;
-		const std::vector<int> &m_pointInfluenceIndices;
-		const std::vector<float> &m_pointInfluenceWeights;
-		const std::vector<M44f> &m_skinData;
+		const std::vector<int> &m_influenceOffsets;
+		const std::vector<Influence> &m_influences;
 		const std::vector<int> &m_refIdData;
-		const std::vector<int> &m_vertexIndicesData;
-		
+		const std::vector<int> *m_vertexIndicesData;
+
 };
 
+void PointSmoothSkinningOp::compileInfluences( const SmoothSkinningData *ssd )
+{
+	const std::vector<int> &pointIndexOffsets = ssd->pointIndexOffsets()->readable();
+	const std::vector<int> &pointInfluenceCounts = ssd->pointInfluenceCounts()->readable();
+	const std::vector<int> &pointInfluenceIndices = ssd->pointInfluenceIndices()->readable();
+	const std::vector<float> &pointInfluenceWeights = ssd->pointInfluenceWeights()->readable();
+
+	m_influenceOffsets.clear();
+	m_influenceOffsets.reserve( pointInfluenceCounts.size() + 1 );
+	m_influences.clear();
+	m_influences.reserve( pointInfluenceIndices.size() );
+
+	for( size_t i = 0; i < pointInfluenceCounts.size(); ++i )
+	{
+		m_influenceOffsets.push_back( m_influences.size() );
+		const int end = pointIndexOffsets[i] + pointInfluenceCounts[i];
+		for( int j = pointIndexOffsets[i]; j < end; ++j )
+		{
+			if( pointInfluenceWeights[j] != 0.0f )
+			{
+				Influence influence = { pointInfluenceIndices[j], pointInfluenceWeights[j] };
+				m_influences.push_back( influence );
+			}
+		}
+	}
+	m_influenceOffsets.push_back( m_influences.size() );
+}
+
+template<typename Skinner>
+void PointSmoothSkinningOp::deform( const Skinner &skinner, Primitive *pt, std::vector<V3f> &p_data, const std::vector<int> &refId_data, bool deform_n, const std::string &normal_var ) const
+{
+	// deform our P
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, p_data.size() ),
+		DeformPositions<Skinner>( skinner, p_data, m_influenceOffsets, m_influences, refId_data )
+	);
+
+	// deform our N
+	if ( deform_n )
+	{
+		PrimitiveVariableMap::const_iterator it = pt->variables.find(normal_var);
+		if ( it != pt->variables.end() )
+		{
+			V3fVectorData *n = pt->variableData<V3fVectorData>(normal_var);
+			std::vector<V3f> &n_data =  n->writable();
+
+			const std::vector<int> *vertexIndicesData = 0;
+			if (it->second.interpolation == PrimitiveVariable::FaceVarying )
+			{
+				MeshPrimitive *mesh = dynamic_cast<MeshPrimitive *>( pt );
+				if( mesh )
+				{
+					vertexIndicesData = &mesh->vertexIds()->readable();
+				}
+			}
+
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, n_data.size() ),
+				DeformNormals<Skinner>( skinner, n_data, m_influenceOffsets, m_influences, refId_data, vertexIndicesData )
+			);
+		}
+	}
+}
+
 void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operands )
 {
 	// get the input parameters
@@ -379,6 +614,7 @@ void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operand
 	if ( ssd != m_prevSmoothSkinningData )
 	{
 		ssd->validate();
+		compileInfluences( ssd.get() );
 		m_prevSmoothSkinningData = ssd;
 	}
 
@@ -431,49 +667,24 @@ void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operand
 
 
 	// iterate through all the points in the source primitive and deform using the weighted skinning matrices
-	if ( blend == Linear )
+	switch( blend )
 	{
-		const std::vector<int> &pointIndexOffsets = ssd->pointIndexOffsets()->readable();
-		const std::vector<int> &pointInfluenceCounts = ssd->pointInfluenceCounts()->readable();
-		const std::vector<int> &pointInfluenceIndices = ssd->pointInfluenceIndices()->readable();
-		const std::vector<float> &pointInfluenceWeights = ssd->pointInfluenceWeights()->readable();
-		
-		// deform our P
-		tbb::parallel_for(
-			tbb::blocked_range<size_t>( 0, p_size ),
-			DeformPositions( p_data, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights, skin_data, refId_data )
-		);
-	
-		// deform our N
-		if ( deform_n )
-		{
-			PrimitiveVariableMap::const_iterator it = pt->variables.find(normal_var);
-			if ( it != pt->variables.end() )
+		case Linear :
+			if( AffineLinearSkinner::compatible( skin_data ) )
 			{
-				V3fVectorData *n = pt->variableData<V3fVectorData>(normal_var);
-				std::vector<V3f> &n_data =  n->writable();
-				
-				std::vector<int> vertexIndicesData;
-				if (it->second.interpolation == PrimitiveVariable::FaceVarying )
-				{
-					MeshPrimitive *mesh = dynamic_cast<MeshPrimitive *>( pt );
-					if( mesh )
-					{
-						vertexIndicesData = mesh->vertexIds()->readable();
-					}
-				}
-				
-				tbb::parallel_for(
-					tbb::blocked_range<size_t>( 0, n_data.size() ),
-					DeformNormals( n_data, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights, skin_data, refId_data, vertexIndicesData )
-				);
+				deform( AffineLinearSkinner( skin_data ), pt, p_data, refId_data, deform_n, normal_var );
 			}
-        }
-	}
-	else
-	{
-		// this should never happen
-		assert(0);
+			else
+			{
+				deform( ProjectiveLinearSkinner( skin_data ), pt, p_data, refId_data, deform_n, normal_var );
+			}
+			break;
+		case DualQuaternion :
+			deform( DualQuaternionSkinner( skin_data ), pt, p_data, refId_data, deform_n, normal_var );
+			break;
+		default :
+			// this should never happen
+			assert(0);
 	}
 
 }
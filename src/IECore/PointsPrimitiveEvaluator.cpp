@@ -32,10 +32,17 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/PointsPrimitiveEvaluator.h"
 #include "IECore/PointsPrimitive.h"
 #include "IECore/Exception.h"
 #include "IECore/SimpleTypedData.h"
+#include "IECore/VectorOps.h"
+#include "IECore/private/RayBoxIntersector.h"
 
 using namespace std;
 using namespace Imath;
@@ -50,7 +57,7 @@ PrimitiveEvaluator::Description<PointsPrimitiveEvaluator> PointsPrimitiveEvaluat
 //////////////////////////////////////////////////////////////////////////
 
 PointsPrimitiveEvaluator::Result::Result( PointsPrimitiveEvaluator::ConstPtr evaluator )
-	:	m_evaluator( evaluator )
+	:	m_pointIndex( 0 ), m_intersection( false ), m_evaluator( evaluator )
 {
 }
 
@@ -84,11 +91,19 @@ const T &PointsPrimitiveEvaluator::Result::primVar( const PrimitiveVariable &pri
 
 Imath::V3f PointsPrimitiveEvaluator::Result::point() const
 {
+	if( m_intersection )
+	{
+		return m_point;
+	}
 	return primVar<V3f>( m_evaluator->m_p );
 }
 
 Imath::V3f PointsPrimitiveEvaluator::Result::normal() const
 {
+	if( m_intersection )
+	{
+		return m_normal;
+	}
 	throw NotImplementedException( __PRETTY_FUNCTION__ );
 }
 
@@ -147,8 +162,15 @@ half PointsPrimitiveEvaluator::Result::halfPrimVar( const PrimitiveVariable &pv
 //////////////////////////////////////////////////////////////////////////
 
 PointsPrimitiveEvaluator::PointsPrimitiveEvaluator( ConstPointsPrimitivePtr points )
-	:	m_pointsPrimitive( points->copy() ), m_haveTree( false )
+	:	m_pointsPrimitive( points->copy() ), m_widthVector( 0 ), m_constantWidth( 1.0f )
 {
+	// Note that the copy above is cheap - TypedData shares its contents with the
+	// original copy-on-write, so only the primitive variable map is duplicated,
+	// and yet we're protected against subsequent changes to the original.
+
+	m_haveTree = false;
+	m_haveBVH = false;
+
 	PrimitiveVariableMap::iterator pIt = m_pointsPrimitive->variables.find( "P" );
 	if( pIt==m_pointsPrimitive->variables.end() )
 	{
@@ -160,6 +182,31 @@ PointsPrimitiveEvaluator::PointsPrimitiveEvaluator( ConstPointsPrimitivePtr poin
 		throw InvalidArgumentException( "PrimitiveVariable P is not of type V3fVectorData." );
 	}
 	m_pVector = &( boost::static_pointer_cast<const V3fVectorData>( m_p.data )->readable() );
+
+	PrimitiveVariableMap::const_iterator wIt = m_pointsPrimitive->variables.find( "width" );
+	if( wIt != m_pointsPrimitive->variables.end() )
+	{
+		if( const FloatVectorData *w = runTimeCast<const FloatVectorData>( wIt->second.data.get() ) )
+		{
+			if( w->readable().size() >= m_pVector->size() )
+			{
+				m_widthVector = &w->readable();
+			}
+		}
+		else if( const FloatData *w = runTimeCast<const FloatData>( wIt->second.data.get() ) )
+		{
+			m_constantWidth *= w->readable();
+		}
+	}
+
+	PrimitiveVariableMap::const_iterator cwIt = m_pointsPrimitive->variables.find( "constantwidth" );
+	if( cwIt != m_pointsPrimitive->variables.end() )
+	{
+		if( const FloatData *w = runTimeCast<const FloatData>( cwIt->second.data.get() ) )
+		{
+			m_constantWidth *= w->readable();
+		}
+	}
 }
 
 PointsPrimitiveEvaluator::~PointsPrimitiveEvaluator()
@@ -220,8 +267,10 @@ bool PointsPrimitiveEvaluator::closestPoint( const Imath::V3f &p, PrimitiveEvalu
 	const_cast<PointsPrimitiveEvaluator *>( this )->buildTree();
 
 	V3fTree::Iterator it = m_tree.nearestNeighbour( p );
-	static_cast<Result *>( result )->m_pointIndex = it - m_pVector->begin();
-	
+	Result *r = static_cast<Result *>( result );
+	r->m_pointIndex = it - m_pVector->begin();
+	r->m_intersection = false;
+
 	return true;
 }
 
@@ -233,13 +282,351 @@ bool PointsPrimitiveEvaluator::pointAtUV( const Imath::V2f &uv, PrimitiveEvaluat
 bool PointsPrimitiveEvaluator::intersectionPoint( const Imath::V3f &origin, const Imath::V3f &direction,
 	PrimitiveEvaluator::Result *result, float maxDistance ) const
 {
-	throw NotImplementedException( __PRETTY_FUNCTION__ );
+	if( m_pVector->empty() )
+	{
+		return false;
+	}
+
+	// see comment in closestPoint()
+	const_cast<PointsPrimitiveEvaluator *>( this )->buildBVH();
+
+	Imath::Line3f ray;
+	ray.pos = origin;
+	ray.dir = direction.normalized();
+
+	const Detail::RayBoxIntersector rayBox( ray );
+	bool hit = false;
+	size_t hitIndex = 0;
+
+	// Nodes yet to be visited, along with the distance
+	// at which the ray enters their bounds.
+	std::pair<Box3fBVH::NodeIndex, float> stack[Box3fBVH::maxDepth + 1];
+	int stackSize = 0;
+	float tNear;
+	if( rayBox.intersects( m_bvh.node( m_bvh.rootIndex() ).bound(), maxDistance, tNear ) )
+	{
+		stack[stackSize++] = std::make_pair( m_bvh.rootIndex(), tNear );
+	}
+
+	while( stackSize )
+	{
+		const std::pair<Box3fBVH::NodeIndex, float> entry = stack[--stackSize];
+		if( entry.second > maxDistance )
+		{
+			continue;
+		}
+
+		const Box3fBVH::Node &node = m_bvh.node( entry.first );
+		if( node.isLeaf() )
+		{
+			const Box3fBVH::Iterator *permLast = m_bvh.permLast( entry.first );
+			for( const Box3fBVH::Iterator *perm = m_bvh.permFirst( entry.first ); perm != permLast; ++perm )
+			{
+				const size_t pointIndex = *perm - m_bounds.begin();
+				float distance;
+				if( intersectsSphere( pointIndex, ray, maxDistance, distance ) )
+				{
+					maxDistance = distance;
+					hitIndex = pointIndex;
+					hit = true;
+				}
+			}
+		}
+		else
+		{
+			// Push the farthest child first, so that the closest is visited next.
+			const Box3fBVH::NodeIndex lowIndex = m_bvh.lowChildIndex( entry.first );
+			const Box3fBVH::NodeIndex highIndex = m_bvh.highChildIndex( entry.first );
+			float tLow, tHigh;
+			const bool lowHit = rayBox.intersects( m_bvh.node( lowIndex ).bound(), maxDistance, tLow );
+			const bool highHit = rayBox.intersects( m_bvh.node( highIndex ).bound(), maxDistance, tHigh );
+			if( lowHit && highHit )
+			{
+				if( tLow < tHigh )
+				{
+					stack[stackSize++] = std::make_pair( highIndex, tHigh );
+					stack[stackSize++] = std::make_pair( lowIndex, tLow );
+				}
+				else
+				{
+					stack[stackSize++] = std::make_pair( lowIndex, tLow );
+					stack[stackSize++] = std::make_pair( highIndex, tHigh );
+				}
+			}
+			else if( lowHit )
+			{
+				stack[stackSize++] = std::make_pair( lowIndex, tLow );
+			}
+			else if( highHit )
+			{
+				stack[stackSize++] = std::make_pair( highIndex, tHigh );
+			}
+		}
+	}
+
+	if( hit )
+	{
+		setIntersectionResult( static_cast<Result *>( result ), hitIndex, ray, maxDistance );
+	}
+
+	return hit;
 }
 
+namespace
+{
+
+struct DistanceLess
+{
+	bool operator()( const std::pair<float, size_t> &a, const std::pair<float, size_t> &b ) const
+	{
+		return a.first < b.first;
+	}
+};
+
+} // namespace
+
 int PointsPrimitiveEvaluator::intersectionPoints( const Imath::V3f &origin, const Imath::V3f &direction,
 	std::vector<PrimitiveEvaluator::ResultPtr> &results, float maxDistance ) const
 {
-	throw NotImplementedException( __PRETTY_FUNCTION__ );
+	results.clear();
+
+	if( m_pVector->empty() )
+	{
+		return 0;
+	}
+
+	// see comment in closestPoint()
+	const_cast<PointsPrimitiveEvaluator *>( this )->buildBVH();
+
+	Imath::Line3f ray;
+	ray.pos = origin;
+	ray.dir = direction.normalized();
+
+	const Detail::RayBoxIntersector rayBox( ray );
+	std::vector<std::pair<float, size_t> > hits;
+
+	Box3fBVH::NodeIndex stack[Box3fBVH::maxDepth + 1];
+	int stackSize = 0;
+	stack[stackSize++] = m_bvh.rootIndex();
+
+	while( stackSize )
+	{
+		const Box3fBVH::NodeIndex nodeIndex = stack[--stackSize];
+		float tNear;
+		if( !rayBox.intersects( m_bvh.node( nodeIndex ).bound(), maxDistance, tNear ) )
+		{
+			continue;
+		}
+
+		const Box3fBVH::Node &node = m_bvh.node( nodeIndex );
+		if( node.isLeaf() )
+		{
+			const Box3fBVH::Iterator *permLast = m_bvh.permLast( nodeIndex );
+			for( const Box3fBVH::Iterator *perm = m_bvh.permFirst( nodeIndex ); perm != permLast; ++perm )
+			{
+				const size_t pointIndex = *perm - m_bounds.begin();
+				float distance;
+				if( intersectsSphere( pointIndex, ray, maxDistance, distance ) )
+				{
+					hits.push_back( std::make_pair( distance, pointIndex ) );
+				}
+			}
+		}
+		else
+		{
+			stack[stackSize++] = m_bvh.lowChildIndex( nodeIndex );
+			stack[stackSize++] = m_bvh.highChildIndex( nodeIndex );
+		}
+	}
+
+	std::sort( hits.begin(), hits.end(), DistanceLess() );
+
+	results.reserve( hits.size() );
+	for( std::vector<std::pair<float, size_t> >::const_iterator it = hits.begin(), eIt = hits.end(); it != eIt; ++it )
+	{
+		ResultPtr result = new Result( this );
+		setIntersectionResult( result.get(), it->second, ray, it->first );
+		results.push_back( result );
+	}
+
+	return results.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Batch queries
+//////////////////////////////////////////////////////////////////////////
+
+class PointsPrimitiveEvaluator::BatchClosestPoint
+{
+
+	public :
+
+		BatchClosestPoint( const PointsPrimitiveEvaluator *evaluator, const std::vector<V3f> &points, BatchResults &results )
+			:	m_evaluator( evaluator ), m_points( points ), m_results( results )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				m_results.success[i] = 1;
+				m_results.point[i] = *m_evaluator->m_tree.nearestNeighbour( m_points[i] );
+			}
+		}
+
+	private :
+
+		const PointsPrimitiveEvaluator *m_evaluator;
+		const std::vector<V3f> &m_points;
+		BatchResults &m_results;
+
+};
+
+void PointsPrimitiveEvaluator::batchClosestPoint( const std::vector<Imath::V3f> &points, BatchResults &results ) const
+{
+	results.resize( points.size() );
+	if( m_pVector->empty() )
+	{
+		return;
+	}
+
+	// see comment in closestPoint()
+	const_cast<PointsPrimitiveEvaluator *>( this )->buildTree();
+
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, points.size() ), BatchClosestPoint( this, points, results ) );
+}
+
+size_t PointsPrimitiveEvaluator::pointsInRadius( const Imath::V3f &p, float radius, std::vector<size_t> &indices ) const
+{
+	indices.clear();
+	if( m_pVector->empty() )
+	{
+		return 0;
+	}
+
+	// see comment in closestPoint()
+	const_cast<PointsPrimitiveEvaluator *>( this )->buildTree();
+
+	std::vector<V3fTree::Iterator> neighbours;
+	m_tree.nearestNeighbours( p, radius, neighbours );
+
+	indices.reserve( neighbours.size() );
+	for( std::vector<V3fTree::Iterator>::const_iterator it = neighbours.begin(), eIt = neighbours.end(); it != eIt; ++it )
+	{
+		indices.push_back( *it - m_pVector->begin() );
+	}
+
+	return indices.size();
+}
+
+class PointsPrimitiveEvaluator::BatchPointsInRadius
+{
+
+	public :
+
+		BatchPointsInRadius( const PointsPrimitiveEvaluator *evaluator, const std::vector<V3f> &points, float radius, std::vector<std::vector<size_t> > &indices )
+			:	m_evaluator( evaluator ), m_points( points ), m_radius( radius ), m_indices( indices )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				m_evaluator->pointsInRadius( m_points[i], m_radius, m_indices[i] );
+			}
+		}
+
+	private :
+
+		const PointsPrimitiveEvaluator *m_evaluator;
+		const std::vector<V3f> &m_points;
+		float m_radius;
+		std::vector<std::vector<size_t> > &m_indices;
+
+};
+
+void PointsPrimitiveEvaluator::batchPointsInRadius( const std::vector<Imath::V3f> &points, float radius, std::vector<std::vector<size_t> > &indices ) const
+{
+	indices.resize( points.size() );
+	if( m_pVector->empty() )
+	{
+		for( std::vector<std::vector<size_t> >::iterator it = indices.begin(), eIt = indices.end(); it != eIt; ++it )
+		{
+			it->clear();
+		}
+		return;
+	}
+
+	// build up front, so the tasks don't all wait on the mutex
+	const_cast<PointsPrimitiveEvaluator *>( this )->buildTree();
+
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, points.size() ), BatchPointsInRadius( this, points, radius, indices ) );
+}
+
+void PointsPrimitiveEvaluator::storeBatchResult( const PrimitiveEvaluator::Result *result, size_t index, BatchResults &results ) const
+{
+	results.point[index] = result->point();
+	if( static_cast<const Result *>( result )->m_intersection )
+	{
+		results.normal[index] = result->normal();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Acceleration structures and intersection
+//////////////////////////////////////////////////////////////////////////
+
+float PointsPrimitiveEvaluator::radius( size_t pointIndex ) const
+{
+	const float width = m_widthVector ? (*m_widthVector)[pointIndex] : 1.0f;
+	return m_constantWidth * width / 2.0f;
+}
+
+bool PointsPrimitiveEvaluator::intersectsSphere( size_t pointIndex, const Imath::Line3f &ray, float maxDistance, float &distance ) const
+{
+	// ray.dir is normalised, so the quadratic has a leading coefficient of 1
+	const float r = radius( pointIndex );
+	const V3f oc = ray.pos - (*m_pVector)[pointIndex];
+	const float b = oc.dot( ray.dir );
+	const float c = oc.length2() - r * r;
+	const float discriminant = b * b - c;
+	if( discriminant < 0.0f )
+	{
+		return false;
+	}
+
+	const float s = sqrtf( discriminant );
+	// take the entry point, or the exit point if the ray starts inside the sphere
+	float t = -b - s;
+	if( t < 0.0f )
+	{
+		t = -b + s;
+		if( t < 0.0f )
+		{
+			return false;
+		}
+	}
+
+	if( t >= maxDistance )
+	{
+		return false;
+	}
+
+	distance = t;
+	return true;
+}
+
+void PointsPrimitiveEvaluator::setIntersectionResult( Result *result, size_t pointIndex, const Imath::Line3f &ray, float distance ) const
+{
+	result->m_pointIndex = pointIndex;
+	result->m_intersection = true;
+	result->m_point = ray.pos + ray.dir * distance;
+
+	const V3f d = result->m_point - (*m_pVector)[pointIndex];
+	const float l = d.length();
+	result->m_normal = l > 0.0f ? d / l : -ray.dir;
 }
 
 void PointsPrimitiveEvaluator::buildTree()
@@ -248,14 +635,40 @@ void PointsPrimitiveEvaluator::buildTree()
 	{
 		return;
 	}
-	
+
 	TreeMutex::scoped_lock lock( m_treeMutex );
 	if( m_haveTree )
 	{
 		// another thread may have built the tree while we waited for the mutex
 		return;
 	}
-	
+
 	m_tree.init( m_pVector->begin(), m_pVector->end() );
 	m_haveTree = true;
 }
+
+void PointsPrimitiveEvaluator::buildBVH()
+{
+	if( m_haveBVH )
+	{
+		return;
+	}
+
+	TreeMutex::scoped_lock lock( m_bvhMutex );
+	if( m_haveBVH )
+	{
+		// another thread may have built the hierarchy while we waited for the mutex
+		return;
+	}
+
+	const std::vector<V3f> &p = *m_pVector;
+	m_bounds.resize( p.size() );
+	for( size_t i = 0, e = p.size(); i < e; ++i )
+	{
+		const V3f r( radius( i ) );
+		m_bounds[i] = Box3f( p[i] - r, p[i] + r );
+	}
+
+	m_bvh.init( m_bounds.begin(), m_bounds.end() );
+	m_haveBVH = true;
+}
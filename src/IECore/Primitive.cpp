@@ -33,11 +33,14 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <cassert>
+#include <algorithm>
 
 #include "IECore/Primitive.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/TypeTraits.h"
 #include "IECore/DespatchTypedData.h"
+#include "IECore/TestTypedData.h"
+#include "IECore/DataAlgo.h"
 #include "IECore/MurmurHash.h"
 
 using namespace IECore;
@@ -52,7 +55,9 @@ using namespace Imath;
 static IndexedIO::EntryID g_variablesEntry("variables");
 static IndexedIO::EntryID g_interpolationEntry("interpolation");
 static IndexedIO::EntryID g_dataEntry("data");
-const unsigned int Primitive::m_ioVersion = 1;
+static IndexedIO::EntryID g_indicesEntry("indices");
+static const std::string g_P( "P" );
+const unsigned int Primitive::m_ioVersion = 2;
 IE_CORE_DEFINEABSTRACTOBJECTTYPEDESCRIPTION( Primitive );
 
 Primitive::Primitive()
@@ -66,7 +71,7 @@ Primitive::~Primitive()
 Imath::Box3f Primitive::bound() const
 {
 	Box3f result;
-	PrimitiveVariableMap::const_iterator it = variables.find( "P" );
+	PrimitiveVariableMap::const_iterator it = variables.find( g_P );
 	if( it!=variables.end() )
 	{
 		ConstV3fVectorDataPtr p = runTimeCast<const V3fVectorData>( it->second.data );
@@ -89,7 +94,8 @@ void Primitive::copyFrom( const Object *other, IECore::Object::CopyContext *cont
 	variables.clear();
 	for( PrimitiveVariableMap::const_iterator it=tOther->variables.begin(); it!=tOther->variables.end(); it++ )
 	{
-		variables.insert( PrimitiveVariableMap::value_type( it->first, PrimitiveVariable( it->second.interpolation, context->copy<Data>( it->second.data.get() ) ) ) );
+		IntVectorDataPtr indices = it->second.indices ? context->copy<IntVectorData>( it->second.indices.get() ) : 0;
+		variables.insert( PrimitiveVariableMap::value_type( it->first, PrimitiveVariable( it->second.interpolation, context->copy<Data>( it->second.data.get() ), indices ) ) );
 	}
 }
 
@@ -104,6 +110,10 @@ void Primitive::save( IECore::Object::SaveContext *context ) const
 		const int i = it->second.interpolation;
 		ioPrimVar->write( g_interpolationEntry, i );
 		context->save( it->second.data.get(), ioPrimVar.get(), g_dataEntry );
+		if( it->second.indices )
+		{
+			context->save( it->second.indices.get(), ioPrimVar.get(), g_indicesEntry );
+		}
 	}
 }
 
@@ -131,17 +141,40 @@ void Primitive::load( IECore::Object::LoadContextPtr context )
 	for( it=names.begin(); it!=names.end(); it++ )
 	{
 		ConstIndexedIOPtr ioPrimVar = ioVariables->subdirectory( *it );
-		int i; 
-		ioPrimVar->read( g_interpolationEntry, i );
-		variables.insert( 
-			PrimitiveVariableMap::value_type( *it, PrimitiveVariable( (PrimitiveVariable::Interpolation)i, context->load<Data>( ioPrimVar.get(), g_dataEntry ) ) ) 
-		);
+		variables.insert( PrimitiveVariableMap::value_type( *it, loadPrimitiveVariable( context.get(), ioPrimVar.get() ) ) );
 	}
 }
 
-PrimitiveVariableMap Primitive::loadPrimitiveVariables( const IndexedIO *ioInterface, const IndexedIO::EntryID &name, const IndexedIO::EntryIDList &primVarNames )
+PrimitiveVariable Primitive::loadPrimitiveVariable( IECore::Object::LoadContext *context, const IndexedIO *ioPrimVar )
 {
-	IECore::Object::LoadContextPtr context = new Object::LoadContext( ioInterface->subdirectory( name )->subdirectory( g_dataEntry ) );
+	int i;
+	ioPrimVar->read( g_interpolationEntry, i );
+	IntVectorDataPtr indices;
+	if( ioPrimVar->hasEntry( g_indicesEntry ) )
+	{
+		indices = context->load<IntVectorData>( ioPrimVar, g_indicesEntry );
+	}
+	return PrimitiveVariable( (PrimitiveVariable::Interpolation)i, context->load<Data>( ioPrimVar, g_dataEntry ), indices );
+}
+
+ConstIndexedIOPtr Primitive::loadVariablesContainer( const IndexedIO *ioInterface, const IndexedIO::EntryID &name, IECore::Object::LoadContextPtr &context )
+{
+	ConstIndexedIOPtr ioObject;
+	IndexedIO::Entry e = ioInterface->entry( name );
+	if( e.entryType()==IndexedIO::File && e.dataType()==IndexedIO::InternedStringArray )
+	{
+		// the entry is a reference to a primitive saved elsewhere in the file
+		IndexedIO::EntryIDList path( e.arrayLength() );
+		InternedString *p = &(path[0]);
+		ioInterface->read( name, p, e.arrayLength() );
+		ioObject = ioInterface->directory( path );
+	}
+	else
+	{
+		ioObject = ioInterface->subdirectory( name );
+	}
+
+	context = new Object::LoadContext( ioObject->subdirectory( g_dataEntry ) );
 
 	unsigned int v = m_ioVersion;
 	ConstIndexedIOPtr container = context->container( Primitive::staticTypeName(), v );
@@ -149,7 +182,13 @@ PrimitiveVariableMap Primitive::loadPrimitiveVariables( const IndexedIO *ioInter
 	{
 		throw Exception( "Could not find Primitive entry in the file!" );
 	}
-	ConstIndexedIOPtr ioVariables = container->subdirectory( g_variablesEntry );
+	return container->subdirectory( g_variablesEntry );
+}
+
+PrimitiveVariableMap Primitive::loadPrimitiveVariables( const IndexedIO *ioInterface, const IndexedIO::EntryID &name, const IndexedIO::EntryIDList &primVarNames )
+{
+	IECore::Object::LoadContextPtr context;
+	ConstIndexedIOPtr ioVariables = loadVariablesContainer( ioInterface, name, context );
 
 	PrimitiveVariableMap variables;
 	IndexedIO::EntryIDList::const_iterator it;
@@ -160,11 +199,164 @@ PrimitiveVariableMap Primitive::loadPrimitiveVariables( const IndexedIO *ioInter
 		{
 			continue;
 		}
-		int i; 
+		variables.insert( PrimitiveVariableMap::value_type( *it, loadPrimitiveVariable( context.get(), ioPrimVar.get() ) ) );
+	}
+
+	return variables;
+}
+
+namespace
+{
+
+IndexedIO::EntryID g_typeEntry( "type" );
+IndexedIO::EntryID g_valueEntry( "value" );
+IndexedIO::EntryID g_geometricInterpretationEntry( "interpretation" );
+
+// Returns the directory holding an object saved by Object::SaveContext, following
+// references to objects saved elsewhere in the file. Returns 0 for references in
+// the obsolete string format.
+ConstIndexedIOPtr objectDirectory( const IndexedIO *container, const IndexedIO::EntryID &name )
+{
+	IndexedIO::Entry e = container->entry( name );
+	if( e.entryType()==IndexedIO::Directory )
+	{
+		return container->subdirectory( name );
+	}
+	if( e.dataType()!=IndexedIO::InternedStringArray )
+	{
+		return 0;
+	}
+
+	IndexedIO::EntryIDList path( e.arrayLength() );
+	InternedString *p = &(path[0]);
+	container->read( name, p, e.arrayLength() );
+	return container->directory( path );
+}
+
+// Fills vector data with a range of the elements stored by TypedData::save(),
+// returning false if they weren't stored as an array of the expected base type.
+struct RangeLoader
+{
+	typedef bool ReturnType;
+
+	RangeLoader( const IndexedIO *container, size_t begin, size_t end )
+		:	m_container( container ), m_begin( begin ), m_end( end )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( T *data ) const
+	{
+		typedef typename T::BaseType BaseType;
+		const size_t n = sizeof( typename T::ValueType::value_type ) / sizeof( BaseType );
+
+		if( !m_container->hasEntry( g_valueEntry ) )
+		{
+			return false;
+		}
+		IndexedIO::Entry e = m_container->entry( g_valueEntry );
+		IndexedIO::Array array( g_valueEntry, (const BaseType *)0, 0 );
+		if( e.entryType()!=IndexedIO::File || e.dataType()!=array.dataType )
+		{
+			return false;
+		}
+
+		const size_t size = e.arrayLength() / n;
+		const size_t begin = std::min( m_begin, size );
+		const size_t end = std::max( begin, std::min( m_end, size ) );
+		data->writable().resize( end - begin );
+		if( end > begin )
+		{
+			array.data = data->baseWritable();
+			array.arrayLength = ( end - begin ) * n;
+			m_container->readArrayRange( array, begin * n );
+		}
+		return true;
+	}
+
+	const IndexedIO *m_container;
+	size_t m_begin;
+	size_t m_end;
+};
+
+DataPtr loadDataRange( const IndexedIO *container, const IndexedIO::EntryID &name, size_t begin, size_t end )
+{
+	ConstIndexedIOPtr ioObject = objectDirectory( container, name );
+	if( !ioObject )
+	{
+		return 0;
+	}
+
+	std::string type;
+	ioObject->read( g_typeEntry, type );
+	DataPtr data = runTimeCast<Data>( Object::create( type ) );
+	if( !data || !testTypedData<TypeTraits::IsNumericBasedVectorTypedData>( data.get() ) )
+	{
+		return 0;
+	}
+
+	ConstIndexedIOPtr ioData = ioObject->subdirectory( g_dataEntry );
+	RangeLoader rangeLoader( ioData.get(), begin, end );
+	if( !despatchTypedData<RangeLoader, TypeTraits::IsNumericBasedVectorTypedData>( data.get(), rangeLoader ) )
+	{
+		return 0;
+	}
+
+	if( ioData->hasEntry( g_geometricInterpretationEntry ) )
+	{
+		unsigned interpretation;
+		ioData->read( g_geometricInterpretationEntry, interpretation );
+		setGeometricInterpretation( data.get(), (GeometricData::Interpretation)interpretation );
+	}
+	return data;
+}
+
+} // namespace
+
+PrimitiveVariableMap Primitive::loadPrimitiveVariableRange( const IndexedIO *ioInterface, const IndexedIO::EntryID &name, const IndexedIO::EntryIDList &primVarNames, size_t begin, size_t end, IndexedIO::EntryIDList &unsupportedNames )
+{
+	IECore::Object::LoadContextPtr context;
+	ConstIndexedIOPtr ioVariables = loadVariablesContainer( ioInterface, name, context );
+
+	PrimitiveVariableMap variables;
+	IndexedIO::EntryIDList::const_iterator it;
+	for( it=primVarNames.begin(); it!=primVarNames.end(); it++ )
+	{
+		ConstIndexedIOPtr ioPrimVar = ioVariables->subdirectory( *it, IndexedIO::NullIfMissing );
+		if ( !ioPrimVar )
+		{
+			continue;
+		}
+
+		int i;
 		ioPrimVar->read( g_interpolationEntry, i );
-		variables.insert( 
-			PrimitiveVariableMap::value_type( *it, PrimitiveVariable( (PrimitiveVariable::Interpolation)i, context->load<Data>( ioPrimVar.get(), g_dataEntry ) ) ) 
-		);
+		const PrimitiveVariable::Interpolation interpolation = (PrimitiveVariable::Interpolation)i;
+		if( interpolation!=PrimitiveVariable::Vertex && interpolation!=PrimitiveVariable::Varying && interpolation!=PrimitiveVariable::FaceVarying )
+		{
+			variables.insert( PrimitiveVariableMap::value_type( *it, loadPrimitiveVariable( context.get(), ioPrimVar.get() ) ) );
+			continue;
+		}
+
+		if( ioPrimVar->hasEntry( g_indicesEntry ) )
+		{
+			IntVectorDataPtr indices = runTimeCast<IntVectorData>( loadDataRange( ioPrimVar.get(), g_indicesEntry, begin, end ) );
+			if( !indices )
+			{
+				unsupportedNames.push_back( *it );
+				continue;
+			}
+			variables.insert( PrimitiveVariableMap::value_type( *it, PrimitiveVariable( interpolation, context->load<Data>( ioPrimVar.get(), g_dataEntry ), indices ) ) );
+		}
+		else
+		{
+			DataPtr data = loadDataRange( ioPrimVar.get(), g_dataEntry, begin, end );
+			if( !data )
+			{
+				unsupportedNames.push_back( *it );
+				continue;
+			}
+			variables.insert( PrimitiveVariableMap::value_type( *it, PrimitiveVariable( interpolation, data ) ) );
+		}
 	}
 
 	return variables;
@@ -190,6 +382,10 @@ void Primitive::memoryUsage( Object::MemoryAccumulator &a ) const
 	for( PrimitiveVariableMap::const_iterator it=variables.begin(); it!=variables.end(); it++ )
 	{
 		a.accumulate( it->second.data.get() );
+		if( it->second.indices )
+		{
+			a.accumulate( it->second.indices.get() );
+		}
 	}
 }
 
@@ -201,6 +397,10 @@ void Primitive::hash( MurmurHash &h ) const
 		h.append( it->first );
 		h.append( it->second.interpolation );
 		it->second.data->hash( h );
+		if( it->second.indices )
+		{
+			it->second.indices->hash( h );
+		}
 	}
 	
 	topologyHash( h );
@@ -229,6 +429,35 @@ struct ValidateArraySize
 	size_t m_variableSize;
 };
 
+struct ValidateIndices
+{
+	typedef bool ReturnType;
+
+	ValidateIndices( const std::vector<int> &indices ) : m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	bool operator() ( const T *data )
+	{
+		assert( data );
+
+		const size_t size = data->readable().size();
+		for( std::vector<int>::const_iterator it = m_indices.begin(); it != m_indices.end(); ++it )
+		{
+			if( *it < 0 || (size_t)*it >= size )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	private:
+
+	const std::vector<int> &m_indices;
+};
+
 struct ReturnFalseErrorHandler
 {
 	typedef bool ReturnType;
@@ -260,6 +489,17 @@ bool Primitive::isPrimitiveVariableValid( const PrimitiveVariable &pv ) const
 	/// \todo This is not correct in the case of CurvesPrimitives, where uniform interpolation should be
 	/// treated the same as constant.
 	size_t sz = variableSize( pv.interpolation );
+	if( pv.indices )
+	{
+		// indexed data may be of any length, provided there is
+		// an index per element and every index is in range.
+		if( pv.indices->readable().size() != sz )
+		{
+			return false;
+		}
+		ValidateIndices func( pv.indices->readable() );
+		return despatchTypedData<ValidateIndices, TypeTraits::IsVectorTypedData, ReturnFalseErrorHandler>( pv.data.get(), func );
+	}
 	ValidateArraySize func( sz );
 	return despatchTypedData<ValidateArraySize, TypeTraits::IsVectorTypedData, ReturnFalseErrorHandler>( pv.data.get(), func );
 }
@@ -0,0 +1,497 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "boost/format.hpp"
+
+#include "OpenEXR/ImathLimits.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include "IECore/PrimitiveCompression.h"
+#include "IECore/CompoundData.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/VectorTypedData.h"
+#include "IECore/VectorTraits.h"
+
+using namespace IECore;
+using namespace Imath;
+
+namespace
+{
+
+InternedString g_encodingEntry( "__encoding" );
+InternedString g_valuesEntry( "values" );
+InternedString g_minEntry( "min" );
+InternedString g_maxEntry( "max" );
+InternedString g_typeIdEntry( "typeId" );
+InternedString g_interpretationEntry( "interpretation" );
+
+const std::string g_quantised( "quantised" );
+const std::string g_octahedral( "octahedral" );
+
+const float g_maxQuantised = 65535.0f;
+
+//////////////////////////////////////////////////////////////////////////
+// Quantisation
+//////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+class Quantiser
+{
+
+	public :
+
+		typedef VectorTraits<T> Traits;
+
+		Quantiser( const std::vector<T> &src, const std::vector<float> &min, const std::vector<float> &scale, std::vector<unsigned short> &dst )
+			:	m_src( src ), m_min( min ), m_scale( scale ), m_dst( dst )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			const unsigned int n = Traits::dimensions();
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				for( unsigned int c = 0; c < n; ++c )
+				{
+					const float q = ( Traits::get( m_src[i], c ) - m_min[c] ) * m_scale[c];
+					m_dst[i*n+c] = (unsigned short)std::min( g_maxQuantised, std::max( 0.0f, q + 0.5f ) );
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<T> &m_src;
+		const std::vector<float> &m_min;
+		const std::vector<float> &m_scale;
+		std::vector<unsigned short> &m_dst;
+
+};
+
+template<typename T>
+class Dequantiser
+{
+
+	public :
+
+		typedef VectorTraits<T> Traits;
+
+		Dequantiser( const std::vector<unsigned short> &src, const std::vector<float> &min, const std::vector<float> &step, std::vector<T> &dst )
+			:	m_src( src ), m_min( min ), m_step( step ), m_dst( dst )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			const unsigned int n = Traits::dimensions();
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				for( unsigned int c = 0; c < n; ++c )
+				{
+					Traits::set( m_dst[i], c, m_min[c] + m_step[c] * (float)m_src[i*n+c] );
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<unsigned short> &m_src;
+		const std::vector<float> &m_min;
+		const std::vector<float> &m_step;
+		std::vector<T> &m_dst;
+
+};
+
+template<typename DataType>
+CompoundDataPtr quantise( const DataType *data )
+{
+	typedef typename DataType::ValueType::value_type T;
+	typedef VectorTraits<T> Traits;
+
+	const std::vector<T> &src = data->readable();
+	const unsigned int n = Traits::dimensions();
+
+	FloatVectorDataPtr minData = new FloatVectorData( std::vector<float>( n, limits<float>::max() ) );
+	FloatVectorDataPtr maxData = new FloatVectorData( std::vector<float>( n, -limits<float>::max() ) );
+	std::vector<float> &min = minData->writable();
+	std::vector<float> &max = maxData->writable();
+	for( typename std::vector<T>::const_iterator it = src.begin(), eIt = src.end(); it != eIt; ++it )
+	{
+		for( unsigned int c = 0; c < n; ++c )
+		{
+			const float v = Traits::get( *it, c );
+			min[c] = std::min( min[c], v );
+			max[c] = std::max( max[c], v );
+		}
+	}
+
+	std::vector<float> scale( n, 0.0f );
+	for( unsigned int c = 0; c < n; ++c )
+	{
+		if( !( max[c] >= min[c] ) || !( max[c] - min[c] <= limits<float>::max() ) )
+		{
+			// empty, or containing values we can't quantise
+			return 0;
+		}
+		if( max[c] > min[c] )
+		{
+			scale[c] = g_maxQuantised / ( max[c] - min[c] );
+		}
+	}
+
+	UShortVectorDataPtr valuesData = new UShortVectorData;
+	valuesData->writable().resize( src.size() * n );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, src.size(), 1024 ), Quantiser<T>( src, min, scale, valuesData->writable() ) );
+
+	CompoundDataPtr result = new CompoundData;
+	result->writable()[g_encodingEntry] = new StringData( g_quantised );
+	result->writable()[g_valuesEntry] = valuesData;
+	result->writable()[g_minEntry] = minData;
+	result->writable()[g_maxEntry] = maxData;
+	return result;
+}
+
+template<typename DataType>
+DataPtr dequantise( const CompoundData *encoded )
+{
+	typedef typename DataType::ValueType::value_type T;
+	typedef VectorTraits<T> Traits;
+
+	const std::vector<unsigned short> &src = encoded->member<UShortVectorData>( g_valuesEntry, true )->readable();
+	const std::vector<float> &min = encoded->member<FloatVectorData>( g_minEntry, true )->readable();
+	const std::vector<float> &max = encoded->member<FloatVectorData>( g_maxEntry, true )->readable();
+	const unsigned int n = Traits::dimensions();
+	if( min.size() != n || max.size() != n || src.size() % n )
+	{
+		throw Exception( "PrimitiveCompression : Invalid quantised data" );
+	}
+
+	std::vector<float> step( n );
+	for( unsigned int c = 0; c < n; ++c )
+	{
+		step[c] = ( max[c] - min[c] ) / g_maxQuantised;
+	}
+
+	typename DataType::Ptr result = new DataType;
+	result->writable().resize( src.size() / n );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, result->readable().size(), 1024 ), Dequantiser<T>( src, min, step, result->writable() ) );
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Octahedral normal encoding
+//////////////////////////////////////////////////////////////////////////
+
+inline float signNotZero( float v )
+{
+	return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+inline unsigned short quantiseUnit( float v )
+{
+	return (unsigned short)std::min( g_maxQuantised, std::max( 0.0f, ( v * 0.5f + 0.5f ) * g_maxQuantised + 0.5f ) );
+}
+
+inline float dequantiseUnit( unsigned short v )
+{
+	return (float)v / g_maxQuantised * 2.0f - 1.0f;
+}
+
+class OctahedralEncoder
+{
+
+	public :
+
+		OctahedralEncoder( const std::vector<V3f> &src, std::vector<unsigned short> &dst )
+			:	m_src( src ), m_dst( dst )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const V3f &n = m_src[i];
+				const float l1 = fabs( n.x ) + fabs( n.y ) + fabs( n.z );
+				float x = n.x / l1;
+				float y = n.y / l1;
+				if( n.z < 0.0f )
+				{
+					const float ox = x;
+					x = ( 1.0f - fabs( y ) ) * signNotZero( ox );
+					y = ( 1.0f - fabs( ox ) ) * signNotZero( y );
+				}
+				m_dst[i*2] = quantiseUnit( x );
+				m_dst[i*2+1] = quantiseUnit( y );
+			}
+		}
+
+	private :
+
+		const std::vector<V3f> &m_src;
+		std::vector<unsigned short> &m_dst;
+
+};
+
+class OctahedralDecoder
+{
+
+	public :
+
+		OctahedralDecoder( const std::vector<unsigned short> &src, std::vector<V3f> &dst )
+			:	m_src( src ), m_dst( dst )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				V3f n( dequantiseUnit( m_src[i*2] ), dequantiseUnit( m_src[i*2+1] ), 0.0f );
+				n.z = 1.0f - fabs( n.x ) - fabs( n.y );
+				if( n.z < 0.0f )
+				{
+					const float ox = n.x;
+					n.x = ( 1.0f - fabs( n.y ) ) * signNotZero( ox );
+					n.y = ( 1.0f - fabs( ox ) ) * signNotZero( n.y );
+				}
+				m_dst[i] = n.normalized();
+			}
+		}
+
+	private :
+
+		const std::vector<unsigned short> &m_src;
+		std::vector<V3f> &m_dst;
+
+};
+
+CompoundDataPtr encodeNormals( const V3fVectorData *data )
+{
+	const std::vector<V3f> &src = data->readable();
+	for( std::vector<V3f>::const_iterator it = src.begin(), eIt = src.end(); it != eIt; ++it )
+	{
+		// the encoding only preserves direction
+		if( !( fabs( it->length2() - 1.0f ) < 1e-4f ) )
+		{
+			return 0;
+		}
+	}
+
+	UShortVectorDataPtr valuesData = new UShortVectorData;
+	valuesData->writable().resize( src.size() * 2 );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, src.size(), 1024 ), OctahedralEncoder( src, valuesData->writable() ) );
+
+	CompoundDataPtr result = new CompoundData;
+	result->writable()[g_encodingEntry] = new StringData( g_octahedral );
+	result->writable()[g_valuesEntry] = valuesData;
+	return result;
+}
+
+DataPtr decodeNormals( const CompoundData *encoded )
+{
+	const std::vector<unsigned short> &src = encoded->member<UShortVectorData>( g_valuesEntry, true )->readable();
+	if( src.size() % 2 )
+	{
+		throw Exception( "PrimitiveCompression : Invalid octahedral data" );
+	}
+
+	V3fVectorDataPtr result = new V3fVectorData;
+	result->writable().resize( src.size() / 2 );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, result->readable().size(), 1024 ), OctahedralDecoder( src, result->writable() ) );
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Variable encoding
+//////////////////////////////////////////////////////////////////////////
+
+bool hasSuffix( const std::string &name, const char *suffix )
+{
+	const size_t n = strlen( suffix );
+	return name.size() > n + 1 && name[name.size()-n-1] == '_' && !name.compare( name.size() - n, n, suffix );
+}
+
+// Matches the "s", "t", "uv" and "st" naming conventions for texture coordinates,
+// including their prefixed forms such as "map1_s" or "map1_uv".
+bool isTextureCoordinate( const std::string &name )
+{
+	static const char *names[] = { "s", "t", "uv", "st", 0 };
+	for( const char **n = names; *n; ++n )
+	{
+		if( name == *n || hasSuffix( name, *n ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+CompoundDataPtr encode( const std::string &name, const PrimitiveVariable &variable )
+{
+	if( variable.interpolation == PrimitiveVariable::Constant || variable.interpolation == PrimitiveVariable::Invalid || !variable.data )
+	{
+		return 0;
+	}
+
+	CompoundDataPtr result;
+	GeometricData::Interpretation interpretation = GeometricData::None;
+	if( const V3fVectorData *v3f = runTimeCast<const V3fVectorData>( variable.data.get() ) )
+	{
+		interpretation = v3f->getInterpretation();
+		if( interpretation == GeometricData::Point || ( interpretation == GeometricData::None && name == "P" ) )
+		{
+			result = quantise( v3f );
+		}
+		else if( interpretation == GeometricData::Normal || ( interpretation == GeometricData::None && name == "N" ) )
+		{
+			result = encodeNormals( v3f );
+		}
+	}
+	else if( const V2fVectorData *v2f = runTimeCast<const V2fVectorData>( variable.data.get() ) )
+	{
+		// GeometricData has no interpretation for texture coordinates,
+		// so we rely on the name to avoid degrading arbitrary V2f data.
+		if( isTextureCoordinate( name ) )
+		{
+			interpretation = v2f->getInterpretation();
+			result = quantise( v2f );
+		}
+	}
+	else if( const FloatVectorData *f = runTimeCast<const FloatVectorData>( variable.data.get() ) )
+	{
+		if( isTextureCoordinate( name ) )
+		{
+			result = quantise( f );
+		}
+	}
+
+	if( result )
+	{
+		result->writable()[g_typeIdEntry] = new IntData( variable.data->typeId() );
+		result->writable()[g_interpretationEntry] = new IntData( interpretation );
+	}
+	return result;
+}
+
+DataPtr decode( const CompoundData *encoded )
+{
+	const std::string &encoding = encoded->member<StringData>( g_encodingEntry, true )->readable();
+	const TypeId typeId = (TypeId)encoded->member<IntData>( g_typeIdEntry, true )->readable();
+	const GeometricData::Interpretation interpretation = (GeometricData::Interpretation)encoded->member<IntData>( g_interpretationEntry, true )->readable();
+
+	if( encoding == g_quantised )
+	{
+		switch( typeId )
+		{
+			case V3fVectorDataTypeId :
+			{
+				V3fVectorDataPtr result = boost::static_pointer_cast<V3fVectorData>( dequantise<V3fVectorData>( encoded ) );
+				result->setInterpretation( interpretation );
+				return result;
+			}
+			case V2fVectorDataTypeId :
+			{
+				V2fVectorDataPtr result = boost::static_pointer_cast<V2fVectorData>( dequantise<V2fVectorData>( encoded ) );
+				result->setInterpretation( interpretation );
+				return result;
+			}
+			case FloatVectorDataTypeId :
+				return dequantise<FloatVectorData>( encoded );
+			default :
+				break;
+		}
+	}
+	else if( encoding == g_octahedral && typeId == V3fVectorDataTypeId )
+	{
+		V3fVectorDataPtr result = boost::static_pointer_cast<V3fVectorData>( decodeNormals( encoded ) );
+		result->setInterpretation( interpretation );
+		return result;
+	}
+
+	throw Exception( boost::str( boost::format( "PrimitiveCompression : Unsupported encoding \"%s\"" ) % encoding ) );
+}
+
+} // namespace
+
+namespace IECore
+{
+
+namespace PrimitiveCompression
+{
+
+PrimitivePtr compress( const Primitive *primitive )
+{
+	PrimitivePtr result = boost::static_pointer_cast<Primitive>( primitive->copy() );
+	for( PrimitiveVariableMap::iterator it = result->variables.begin(); it != result->variables.end(); ++it )
+	{
+		CompoundDataPtr encoded = encode( it->first, it->second );
+		if( encoded )
+		{
+			it->second.data = encoded;
+		}
+	}
+	return result;
+}
+
+bool decompress( PrimitiveVariableMap &variables )
+{
+	bool result = false;
+	for( PrimitiveVariableMap::iterator it = variables.begin(); it != variables.end(); ++it )
+	{
+		if( isCompressed( it->second ) )
+		{
+			it->second.data = decode( static_cast<const CompoundData *>( it->second.data.get() ) );
+			result = true;
+		}
+	}
+	return result;
+}
+
+bool isCompressed( const PrimitiveVariable &variable )
+{
+	const CompoundData *compoundData = runTimeCast<const CompoundData>( variable.data.get() );
+	return compoundData && compoundData->readable().find( g_encodingEntry ) != compoundData->readable().end();
+}
+
+} // namespace PrimitiveCompression
+
+} // namespace IECore
@@ -32,7 +32,11 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include "IECore/PrimitiveEvaluator.h"
+#include "IECore/Exception.h"
 
 #include "IECore/MeshPrimitiveEvaluator.h"
 #include "IECore/SpherePrimitiveEvaluator.h"
@@ -40,6 +44,7 @@
 
 using namespace IECore;
 
+
 IE_CORE_DEFINERUNTIMETYPED( PrimitiveEvaluator );
 
 PrimitiveEvaluator::CreatorMap &PrimitiveEvaluator::getCreateFns()
@@ -101,3 +106,139 @@ bool PrimitiveEvaluator::signedDistance( const Imath::V3f &p, float &distance, R
 
 	return true;
 }
+
+class PrimitiveEvaluator::BatchClosestPoint
+{
+
+	public :
+
+		BatchClosestPoint( const PrimitiveEvaluator *evaluator, const std::vector<Imath::V3f> &points, BatchResults &results )
+			:	m_evaluator( evaluator ), m_points( points ), m_results( results )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			ResultPtr result = m_evaluator->createResult();
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const bool success = m_evaluator->closestPoint( m_points[i], result.get() );
+				m_results.success[i] = success;
+				if( success )
+				{
+					m_evaluator->storeBatchResult( result.get(), i, m_results );
+				}
+			}
+		}
+
+	private :
+
+		const PrimitiveEvaluator *m_evaluator;
+		const std::vector<Imath::V3f> &m_points;
+		BatchResults &m_results;
+
+};
+
+class PrimitiveEvaluator::BatchPointAtUV
+{
+
+	public :
+
+		BatchPointAtUV( const PrimitiveEvaluator *evaluator, const std::vector<Imath::V2f> &uvs, BatchResults &results )
+			:	m_evaluator( evaluator ), m_uvs( uvs ), m_results( results )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			ResultPtr result = m_evaluator->createResult();
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const bool success = m_evaluator->pointAtUV( m_uvs[i], result.get() );
+				m_results.success[i] = success;
+				if( success )
+				{
+					m_evaluator->storeBatchResult( result.get(), i, m_results );
+				}
+			}
+		}
+
+	private :
+
+		const PrimitiveEvaluator *m_evaluator;
+		const std::vector<Imath::V2f> &m_uvs;
+		BatchResults &m_results;
+
+};
+
+class PrimitiveEvaluator::BatchIntersectionPoint
+{
+
+	public :
+
+		BatchIntersectionPoint( const PrimitiveEvaluator *evaluator, const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions, float maxDistance, BatchResults &results )
+			:	m_evaluator( evaluator ), m_origins( origins ), m_directions( directions ), m_maxDistance( maxDistance ), m_results( results )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			ResultPtr result = m_evaluator->createResult();
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const bool success = m_evaluator->intersectionPoint( m_origins[i], m_directions[i], result.get(), m_maxDistance );
+				m_results.success[i] = success;
+				if( success )
+				{
+					m_evaluator->storeBatchResult( result.get(), i, m_results );
+				}
+			}
+		}
+
+	private :
+
+		const PrimitiveEvaluator *m_evaluator;
+		const std::vector<Imath::V3f> &m_origins;
+		const std::vector<Imath::V3f> &m_directions;
+		float m_maxDistance;
+		BatchResults &m_results;
+
+};
+
+void PrimitiveEvaluator::BatchResults::resize( size_t size )
+{
+	success.assign( size, 0 );
+	point.assign( size, Imath::V3f( 0 ) );
+	normal.assign( size, Imath::V3f( 0 ) );
+	uv.assign( size, Imath::V2f( 0 ) );
+}
+
+void PrimitiveEvaluator::batchClosestPoint( const std::vector<Imath::V3f> &points, BatchResults &results ) const
+{
+	results.resize( points.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, points.size() ), BatchClosestPoint( this, points, results ) );
+}
+
+void PrimitiveEvaluator::batchPointAtUV( const std::vector<Imath::V2f> &uvs, BatchResults &results ) const
+{
+	results.resize( uvs.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, uvs.size() ), BatchPointAtUV( this, uvs, results ) );
+}
+
+void PrimitiveEvaluator::batchIntersectionPoint( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions, BatchResults &results, float maxDistance ) const
+{
+	if( origins.size() != directions.size() )
+	{
+		throw InvalidArgumentException( "PrimitiveEvaluator::batchIntersectionPoint : origins and directions must have the same length" );
+	}
+
+	results.resize( origins.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, origins.size() ), BatchIntersectionPoint( this, origins, directions, maxDistance, results ) );
+}
+
+void PrimitiveEvaluator::storeBatchResult( const Result *result, size_t index, BatchResults &results ) const
+{
+	results.point[index] = result->point();
+	results.normal[index] = result->normal();
+	results.uv[index] = result->uv();
+}
@@ -34,9 +34,42 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "IECore/PrimitiveVariable.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/DataAlgo.h"
 
 using namespace IECore;
 
+namespace
+{
+
+struct Expander
+{
+	typedef DataPtr ReturnType;
+
+	Expander( const std::vector<int> &indices ) : m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	DataPtr operator()( const T *data )
+	{
+		const typename T::ValueType &src = data->readable();
+		typename T::Ptr result = new T;
+		typename T::ValueType &dst = result->writable();
+		dst.reserve( m_indices.size() );
+		for( std::vector<int>::const_iterator it = m_indices.begin(), eIt = m_indices.end(); it != eIt; ++it )
+		{
+			dst.push_back( src[*it] );
+		}
+		setGeometricInterpretation( result.get(), getGeometricInterpretation( data ) );
+		return result;
+	}
+
+	const std::vector<int> &m_indices;
+};
+
+} // namespace
+
 PrimitiveVariable::PrimitiveVariable()
 	: interpolation( Invalid ), data( 0 )
 {
@@ -47,10 +80,16 @@ PrimitiveVariable::PrimitiveVariable( Interpolation i, DataPtr d )
 {
 }
 
+PrimitiveVariable::PrimitiveVariable( Interpolation i, DataPtr d, IntVectorDataPtr indices )
+	: interpolation( i ), data( d ), indices( indices )
+{
+}
+
 PrimitiveVariable::PrimitiveVariable( const PrimitiveVariable &other )
 {
 	interpolation = other.interpolation;
 	data = other.data;
+	indices = other.indices;
 }
 
 PrimitiveVariable::PrimitiveVariable( const PrimitiveVariable &other, bool deepCopy )
@@ -59,10 +98,12 @@ PrimitiveVariable::PrimitiveVariable( const PrimitiveVariable &other, bool deepC
 	if( deepCopy )
 	{
 		data = other.data ? other.data->copy() : 0;
+		indices = other.indices ? other.indices->copy() : 0;
 	}
 	else
 	{
 		data = other.data;
+		indices = other.indices;
 	}
 }
 
@@ -72,6 +113,17 @@ bool PrimitiveVariable::operator==( const PrimitiveVariable &other ) const
 	{
 		return false;
 	}
+	if( indices && other.indices )
+	{
+		if( !indices->isEqualTo( other.indices.get() ) )
+		{
+			return false;
+		}
+	}
+	else if( indices || other.indices )
+	{
+		return false;
+	}
 	if( data && other.data )
 	{
 		return data->isEqualTo( other.data.get() );
@@ -84,3 +136,14 @@ bool PrimitiveVariable::operator!=( const PrimitiveVariable &other ) const
 	return !(*this == other);
 }
 
+
+DataPtr PrimitiveVariable::expandedData() const
+{
+	if( !indices || !data )
+	{
+		return data;
+	}
+
+	Expander expander( indices->readable() );
+	return despatchTypedData<Expander, TypeTraits::IsVectorTypedData>( data.get(), expander );
+}
@@ -0,0 +1,206 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <vector>
+
+#include "tbb/atomic.h"
+#include "tbb/enumerable_thread_specific.h"
+
+#include "IECore/Profiling.h"
+#include "IECore/Exception.h"
+
+using namespace IECore;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal storage
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct Event
+{
+	const char *name;
+	tbb::tick_count start;
+	tbb::tick_count end;
+};
+
+// Each thread records into its own buffer, so recording needs no locking.
+struct ThreadEvents
+{
+
+	ThreadEvents()
+		:	threadId( ++g_nextThreadId )
+	{
+	}
+
+	int threadId;
+	std::vector<Event> events;
+
+	static tbb::atomic<int> g_nextThreadId;
+
+};
+
+tbb::atomic<int> ThreadEvents::g_nextThreadId;
+
+typedef tbb::enumerable_thread_specific<ThreadEvents> ThreadSpecificEvents;
+ThreadSpecificEvents g_events;
+
+tbb::atomic<bool> g_enabled;
+const tbb::tick_count g_origin = tbb::tick_count::now();
+
+void writeEscaped( std::ostream &stream, const char *s )
+{
+	for( ; *s; ++s )
+	{
+		switch( *s )
+		{
+			case '"' :
+				stream << "\\\"";
+				break;
+			case '\\' :
+				stream << "\\\\";
+				break;
+			case '\n' :
+				stream << "\\n";
+				break;
+			default :
+				stream << *s;
+		}
+	}
+}
+
+double microseconds( const tbb::tick_count &t )
+{
+	return ( t - g_origin ).seconds() * 1000000.0;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Public API
+//////////////////////////////////////////////////////////////////////////
+
+bool Profiling::available()
+{
+#ifdef IECORE_WITH_PROFILING
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Profiling::setEnabled( bool enabled )
+{
+	g_enabled = enabled;
+}
+
+bool Profiling::getEnabled()
+{
+	return g_enabled;
+}
+
+void Profiling::clear()
+{
+	for( ThreadSpecificEvents::iterator it = g_events.begin(); it != g_events.end(); ++it )
+	{
+		std::vector<Event>().swap( it->events );
+	}
+}
+
+void Profiling::writeChromeTrace( std::ostream &stream )
+{
+	std::ios_base::fmtflags flags = stream.flags();
+	stream.setf( std::ios_base::fixed );
+	std::streamsize precision = stream.precision( 3 );
+
+	stream << "{\"traceEvents\":[";
+	bool first = true;
+	for( ThreadSpecificEvents::const_iterator it = g_events.begin(); it != g_events.end(); ++it )
+	{
+		for( std::vector<Event>::const_iterator eIt = it->events.begin(); eIt != it->events.end(); ++eIt )
+		{
+			stream << ( first ? "\n" : ",\n" );
+			first = false;
+
+			stream << "{\"name\":\"";
+			writeEscaped( stream, eIt->name );
+			stream << "\",\"cat\":\"IECore\",\"ph\":\"X\",\"pid\":0,\"tid\":" << it->threadId;
+			stream << ",\"ts\":" << microseconds( eIt->start );
+			stream << ",\"dur\":" << ( eIt->end - eIt->start ).seconds() * 1000000.0 << "}";
+		}
+	}
+	stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	stream.flags( flags );
+	stream.precision( precision );
+}
+
+void Profiling::writeChromeTrace( const std::string &fileName )
+{
+	std::ofstream stream( fileName.c_str() );
+	if( !stream.good() )
+	{
+		throw IOException( "Unable to open file \"" + fileName + "\" for writing." );
+	}
+	writeChromeTrace( stream );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Zone
+//////////////////////////////////////////////////////////////////////////
+
+Profiling::Zone::Zone( const char *name )
+	:	m_name( name ), m_enabled( g_enabled )
+{
+	if( m_enabled )
+	{
+		m_start = tbb::tick_count::now();
+	}
+}
+
+Profiling::Zone::~Zone()
+{
+	if( !m_enabled )
+	{
+		return;
+	}
+
+	Event event;
+	event.name = m_name;
+	event.start = m_start;
+	event.end = tbb::tick_count::now();
+	g_events.local().events.push_back( event );
+}
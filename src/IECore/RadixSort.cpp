@@ -32,11 +32,16 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <cassert>
 #include <string.h>
+#include <algorithm>
 
 #include "boost/static_assert.hpp"
 
-#include "IECore/ByteOrder.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "IECore/Exception.h"
 #include "IECore/RadixSort.h"
 
 using namespace IECore;
@@ -44,463 +49,644 @@ using namespace IECore;
 BOOST_STATIC_ASSERT( sizeof(int) == 4 );
 BOOST_STATIC_ASSERT( sizeof(unsigned int) == 4 );
 BOOST_STATIC_ASSERT( sizeof(float) == 4 );
+BOOST_STATIC_ASSERT( sizeof(double) == 8 );
 
-RadixSort::RadixSort() : m_currentSize( 0 ), m_ranks( 0 ), m_ranks2( 0 )
-{
-	m_ranks = new UIntVectorData();
-	m_ranks2 = new UIntVectorData();
-
-	m_currentSize |= 0x80000000;
-}
+//////////////////////////////////////////////////////////////////////////
+// Implementation details
+//////////////////////////////////////////////////////////////////////////
 
-RadixSort::~RadixSort()
+namespace
 {
-}
 
-void RadixSort::resize( unsigned int s )
-{
-	m_ranks->writable().resize( s );
-	m_ranks2->writable().resize( s );
-}
+// Inputs are split into blocks of at least this many elements. Each pass
+// histograms and scatters the blocks in parallel, so an input smaller than
+// this is sorted entirely on the calling thread.
+const size_t g_minBlockSize = 65536;
+// Limits the memory used by the per-block histograms.
+const size_t g_maxBlocks = 256;
 
+// Maps each key type onto an unsigned integer with the same ordering,
+// so that every pass of the sort can be treated identically.
 template<typename T>
-bool RadixSort::checkPassValidity( const std::vector<T> &input, unsigned int pass, unsigned int* &curCount, unsigned char &uniqueVal )
+struct RadixKey;
+
+template<>
+struct RadixKey<unsigned int>
 {
-	curCount = &m_histogram[ pass << 8 ];
+	typedef uint32_t Type;
+	static Type get( unsigned int v ) { return v; }
+};
 
-#ifdef IE_CORE_BIG_ENDIAN
-	uniqueVal = *((( unsigned char* )( &input[0] ) ) + sizeof(T) - 1 - pass );
-#else
-	uniqueVal = *((( unsigned char* )( &input[0] ) ) + pass );
-#endif
+template<>
+struct RadixKey<int>
+{
+	typedef uint32_t Type;
+	static Type get( int v ) { return static_cast<uint32_t>( v ) ^ 0x80000000u; }
+};
 
-	if ( curCount[ uniqueVal ] == input.size() )
+template<>
+struct RadixKey<float>
+{
+	typedef uint32_t Type;
+	static Type get( float v )
 	{
-		return false;
+		// Flipping all the bits of negative values reverses their order,
+		// and flipping just the sign bit of positive ones moves them above
+		// the negative values.
+		uint32_t u;
+		memcpy( &u, &v, sizeof( u ) );
+		return ( u & 0x80000000u ) ? ~u : u ^ 0x80000000u;
 	}
+};
 
-	return true;
-}
+template<>
+struct RadixKey<uint64_t>
+{
+	typedef uint64_t Type;
+	static Type get( uint64_t v ) { return v; }
+};
 
-void RadixSort::checkResize( unsigned int s )
+template<>
+struct RadixKey<int64_t>
 {
-	unsigned int curSize = ( m_currentSize & 0x7fffffff );
+	typedef uint64_t Type;
+	static Type get( int64_t v ) { return static_cast<uint64_t>( v ) ^ ( uint64_t( 1 ) << 63 ); }
+};
 
-	if ( s != curSize )
+template<>
+struct RadixKey<double>
+{
+	typedef uint64_t Type;
+	static Type get( double v )
 	{
-		resize( s );
-
-		m_currentSize = s;
-		m_currentSize |= 0x80000000;
+		const uint64_t signBit = uint64_t( 1 ) << 63;
+		uint64_t u;
+		memcpy( &u, &v, sizeof( u ) );
+		return ( u & signBit ) ? ~u : u ^ signBit;
 	}
+};
+
+template<typename K>
+inline unsigned int digit( K key, unsigned int pass )
+{
+	return ( key >> ( pass * 8 ) ) & 0xff;
 }
 
-const std::vector<unsigned int> &RadixSort::operator()( const std::vector<float> &input2 )
+// Divides the input into the blocks which are processed
+// in parallel.
+struct Blocks
 {
-	const unsigned int nb = input2.size();
-	checkResize( nb );
 
-	if ( !nb )
+	Blocks( size_t size )
+		:	size( size ), blockSize( std::max( g_minBlockSize, ( size + g_maxBlocks - 1 ) / g_maxBlocks ) ), numBlocks( ( size + blockSize - 1 ) / blockSize )
 	{
-		assert( m_ranks );
-		return m_ranks->readable();
 	}
 
-	const unsigned int *input = ( const unsigned int * ) &input2[0];
-
-	bool alreadySorted = createHistograms< float >( input2 );
-	if ( alreadySorted )
+	size_t begin( size_t block ) const
 	{
-		return m_ranks->readable();
+		return block * blockSize;
 	}
 
-	unsigned int numNegativeValues = 0;
-
-	const unsigned int *h3 = &m_histogram[ 768 ];
-	for ( unsigned int i = 128; i < 256; i ++ )
+	size_t end( size_t block ) const
 	{
-		numNegativeValues += h3[i];
+		return std::min( ( block + 1 ) * blockSize, size );
 	}
 
-	for ( unsigned int j = 0; j < 4; j ++ )
-	{
-		if ( j != 3 )
+	size_t size;
+	size_t blockSize;
+	size_t numBlocks;
+
+};
+
+// Provides the keys and values for the first pass of an indirect
+// sort, reading the input in the order left by the previous sort,
+// or in its natural order if ranks is null. Sources also provide
+// access to the keys in their natural order, which is faster for
+// operations where the order is irrelevant.
+template<typename T>
+class InputSource
+{
+
+	public :
+
+		typedef typename RadixKey<T>::Type Key;
+
+		InputSource( const T *input, const unsigned int *ranks )
+			:	m_input( input ), m_ranks( ranks )
+		{
+		}
+
+		unsigned int value( size_t i ) const
 		{
-			unsigned char uniqueVal = 0;
-			unsigned int *curCount = 0;
+			return m_ranks ? m_ranks[i] : i;
+		}
 
-			bool performPass = checkPassValidity( input2, j, curCount, uniqueVal );
+		Key key( size_t i ) const
+		{
+			return RadixKey<T>::get( m_input[value( i )] );
+		}
 
-			if ( performPass )
-			{
-				m_link[0] = &m_ranks2->writable()[0];
+		Key naturalKey( size_t i ) const
+		{
+			return RadixKey<T>::get( m_input[i] );
+		}
 
-				for ( unsigned int i = 1; i < 256; i++ )
-				{
-					m_link[i] = m_link[ i - 1 ] + curCount[ i - 1 ];
-				}
+		bool natural() const
+		{
+			return !m_ranks;
+		}
 
-				const unsigned char *inputBytes = ( const unsigned char * ) input;
-#ifdef IE_CORE_BIG_ENDIAN
-				inputBytes += sizeof(float) - 1 - j;
-#else
-				inputBytes += j;
-#endif
+	private :
 
-				if ( m_currentSize & 0x80000000 )
-				{
-					for ( unsigned int i = 0; i < nb; i++ )
-					{
-						*m_link[ inputBytes[i<<2] ]++ = i;
-					}
-					m_currentSize&=0x7fffffff;
-				}
-				else
-				{
-					for ( UIntVectorData::ValueType::const_iterator it = m_ranks->readable().begin(); it != m_ranks->readable().end(); ++it )
-					{
-						unsigned int id = *it;
-						*m_link[ inputBytes[ id << 2 ] ]++ = id;
-					}
-				}
+		const T *m_input;
+		const unsigned int *m_ranks;
 
-				std::swap( m_ranks, m_ranks2 );
-			}
+};
+
+// Provides the keys and values from the buffers written by
+// a previous pass.
+template<typename K>
+class BufferSource
+{
+
+	public :
+
+		typedef K Key;
+
+		BufferSource( const K *keys, const unsigned int *values )
+			:	m_keys( keys ), m_values( values )
+		{
 		}
-		else
+
+		unsigned int value( size_t i ) const
 		{
-			unsigned char uniqueVal = 0;
-			unsigned int *curCount = 0;
-			bool performPass = checkPassValidity( input2, j, curCount, uniqueVal );
+			return m_values[i];
+		}
 
-			if ( performPass )
-			{
-				m_link[0] = &m_ranks2->writable()[numNegativeValues];
-				for ( unsigned int i = 1; i < 128; i++ )
-				{
-					m_link[i] = m_link[ i - 1 ] + curCount[ i - 1 ];
-				}
+		Key key( size_t i ) const
+		{
+			return m_keys[i];
+		}
 
-				m_link[255] = &m_ranks2->writable()[0];
-				for ( unsigned int i = 0; i < 127; i ++ )
-				{
-					m_link[254 - i ] = m_link[255-i] + curCount[255 - i ];
-				}
+		Key naturalKey( size_t i ) const
+		{
+			return m_keys[i];
+		}
 
-				for ( unsigned int i = 128; i < 256; i ++ )
-				{
-					m_link[i] += curCount[i];
-				}
+		bool natural() const
+		{
+			return true;
+		}
 
-				if ( m_currentSize & 0x80000000 )
-				{
-					for ( unsigned int i = 0; i < nb; i++ )
-					{
-						unsigned int radix = input[i] >> 24;
-
-						if ( radix < 128 )
-						{
-							*m_link[ radix ]++ = i;
-						}
-						else
-						{
-							*( --m_link[ radix] ) = i;
-						}
-					}
-					m_currentSize&=0x7fffffff;
-				}
-				else
+	private :
+
+		const K *m_keys;
+		const unsigned int *m_values;
+
+};
+
+// Determines whether or not each block of the source is already sorted.
+template<typename Source>
+class CheckSortedBlocks
+{
+
+	public :
+
+		typedef typename Source::Key Key;
+
+		CheckSortedBlocks( const Source &source, const Blocks &blocks, char *sorted )
+			:	m_source( source ), m_blocks( blocks ), m_sorted( sorted )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t b = r.begin(); b != r.end(); ++b )
+			{
+				const size_t begin = m_blocks.begin( b );
+				const size_t end = m_blocks.end( b );
+
+				// Compare against the last key of the previous block, so
+				// that the blocks are sorted relative to each other too.
+				Key prevKey = m_source.key( begin ? begin - 1 : 0 );
+				size_t i = begin;
+				for( ; i < end; ++i )
 				{
-					for ( unsigned int i = 0; i < nb; i ++ )
+					const Key k = m_source.key( i );
+					if( k < prevKey )
 					{
-						unsigned int radix = input[ m_ranks->readable()[i] ] >> 24;
-
-						if ( radix < 128 )
-						{
-							*m_link[ radix ] ++ = m_ranks->readable()[i];
-						}
-						else
-						{
-							*( --m_link[ radix ] ) = m_ranks->readable()[i];
-						}
+						break;
 					}
+					prevKey = k;
 				}
-
-				std::swap( m_ranks, m_ranks2 );
+				m_sorted[b] = i == end;
 			}
-			else
+		}
+
+	private :
+
+		Source m_source;
+		const Blocks &m_blocks;
+		char *m_sorted;
+
+};
+
+// Computes the histograms for all passes of each block in a single
+// read of the source. The histograms are computed in the natural order
+// of the source, which is significantly quicker than reading in sorted
+// order.
+template<typename Source>
+class HistogramBlocks
+{
+
+	public :
+
+		typedef typename Source::Key Key;
+		static const unsigned int numPasses = sizeof( Key );
+
+		HistogramBlocks( const Source &source, const Blocks &blocks, unsigned int *histograms )
+			:	m_source( source ), m_blocks( blocks ), m_histograms( histograms )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t b = r.begin(); b != r.end(); ++b )
 			{
-				if ( uniqueVal >= 128 )
+				unsigned int *h = m_histograms + b * numPasses * 256;
+				std::fill( h, h + numPasses * 256, 0 );
+
+				const size_t end = m_blocks.end( b );
+				for( size_t i = m_blocks.begin( b ); i < end; ++i )
 				{
-					if ( m_currentSize & 0x80000000 )
+					const Key k = m_source.naturalKey( i );
+					for( unsigned int pass = 0; pass < numPasses; ++pass )
 					{
-						for ( unsigned int i = 0; i < nb; i++ )
-						{
-							m_ranks2->writable()[i] = nb - i - 1;
-						}
-						m_currentSize&=0x7fffffff;
+						h[ pass * 256 + digit( k, pass ) ]++;
 					}
-					else
-					{
-						for ( unsigned int i = 0; i < nb; i++ )
-						{
-							m_ranks2->writable()[i] = m_ranks->readable()[ nb - i - 1 ];
-						}
-					}
-
-					std::swap( m_ranks, m_ranks2 );
 				}
 			}
 		}
-	}
 
-	return m_ranks->readable();
-}
+	private :
 
-const std::vector<unsigned int> &RadixSort::operator()( const std::vector<unsigned int> &input2 )
-{
-	const unsigned int nb = input2.size();
-	checkResize( nb );
+		Source m_source;
+		const Blocks &m_blocks;
+		unsigned int *m_histograms;
 
-	if ( !nb )
-	{
-		return m_ranks->readable();
-	}
-	const unsigned int *input = &input2[0];
+};
 
-	bool alreadySorted = createHistograms< unsigned int >( input2 );
-	if ( alreadySorted )
-	{
-		return m_ranks->readable();
-	}
+// Computes the histogram of each block for a single pass.
+template<typename Source>
+class CountBlocks
+{
 
-	for ( unsigned int j = 0; j < 4; j ++ )
-	{
-		unsigned char uniqueVal = 0;
-		unsigned int *curCount = 0;
-		bool performPass = checkPassValidity( input2, j, curCount, uniqueVal );
+	public :
 
-		if ( performPass )
+		CountBlocks( const Source &source, const Blocks &blocks, unsigned int pass, unsigned int *counts )
+			:	m_source( source ), m_blocks( blocks ), m_pass( pass ), m_counts( counts )
 		{
-			m_link[0] = &m_ranks2->writable()[0];
+		}
 
-			for( unsigned int i = 1; i < 256; i++ )
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t b = r.begin(); b != r.end(); ++b )
 			{
-				m_link[i] = m_link[i - 1] + curCount[ i - 1 ];
+				unsigned int *c = m_counts + b * 256;
+				std::fill( c, c + 256, 0 );
+				const size_t end = m_blocks.end( b );
+				for( size_t i = m_blocks.begin( b ); i < end; ++i )
+				{
+					c[ digit( m_source.key( i ), m_pass ) ]++;
+				}
 			}
+		}
+
+	private :
+
+		Source m_source;
+		const Blocks &m_blocks;
+		unsigned int m_pass;
+		unsigned int *m_counts;
 
-			const unsigned char *inputBytes = ( const unsigned char * )( input );
-#ifdef IE_CORE_BIG_ENDIAN
-			inputBytes += sizeof(unsigned int) - 1 - j;
-#else
-			inputBytes += j;
-#endif
+};
+
+// Scatters the keys and values of each block to their positions
+// for a single pass, starting from the offsets given for each
+// block and digit.
+template<typename Source>
+class ScatterBlocks
+{
+
+	public :
+
+		typedef typename Source::Key Key;
+
+		ScatterBlocks( const Source &source, const Blocks &blocks, unsigned int pass, unsigned int *offsets, Key *keys, unsigned int *values )
+			:	m_source( source ), m_blocks( blocks ), m_pass( pass ), m_offsets( offsets ), m_keys( keys ), m_values( values )
+		{
+		}
 
-			if (m_currentSize & 0x80000000)
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t b = r.begin(); b != r.end(); ++b )
 			{
-				for ( unsigned int i = 0; i < nb; i++ )
+				unsigned int *o = m_offsets + b * 256;
+				const size_t end = m_blocks.end( b );
+				for( size_t i = m_blocks.begin( b ); i < end; ++i )
 				{
-					*m_link[ inputBytes[ (i<<2) ] ]++ = i;
+					const Key k = m_source.key( i );
+					const unsigned int dst = o[ digit( k, m_pass ) ]++;
+					m_keys[dst] = k;
+					m_values[dst] = m_source.value( i );
 				}
-				m_currentSize &= 0x7fffffff;
 			}
-			else
-			{
-				for ( UIntVectorData::ValueType::const_iterator it = m_ranks->readable().begin(); it != m_ranks->readable().end(); ++it )
-				{
-					unsigned int id = *it;
+		}
 
-					*m_link[ inputBytes[ (id << 2) ] ]++ = id;
-				}
-			}
+	private :
 
-			std::swap( m_ranks, m_ranks2 );
-		}
-	}
+		Source m_source;
+		const Blocks &m_blocks;
+		unsigned int m_pass;
+		unsigned int *m_offsets;
+		Key *m_keys;
+		unsigned int *m_values;
 
-	return m_ranks->readable();
-}
+};
 
-const std::vector<unsigned int> &RadixSort::operator()( const std::vector<int> &input2 )
+template<typename Body>
+void processBlocks( const Blocks &blocks, const Body &body )
 {
-	const unsigned int nb = input2.size();
-	checkResize( nb );
-
-	if ( !nb )
+	if( blocks.numBlocks == 1 )
 	{
-		return m_ranks->readable();
+		body( tbb::blocked_range<size_t>( 0, 1 ) );
 	}
-	const unsigned int *input = ( const unsigned int * ) &input2[0];
-
-	bool alreadySorted = createHistograms< int >( input2 );
-	if ( alreadySorted )
+	else
 	{
-		return m_ranks->readable();
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, blocks.numBlocks, 1 ), body );
 	}
+}
+
+template<typename Source>
+bool sorted( const Source &source, const Blocks &blocks )
+{
+	std::vector<char> blockSorted( blocks.numBlocks );
+	processBlocks( blocks, CheckSortedBlocks<Source>( source, blocks, &blockSorted[0] ) );
+	return std::find( blockSorted.begin(), blockSorted.end(), 0 ) == blockSorted.end();
+}
 
-	unsigned int numNegativeValues = 0;
-	unsigned int* h3= &m_histogram[768];
-	for ( unsigned int i = 128; i < 256; i++ )
+// Performs the passes of the sort, reading from source for the first pass
+// with work to do, and writing to keys[0] and values[0]. Subsequent passes
+// alternate between the buffers. Returns the index of the buffers holding the
+// result.
+template<typename Source>
+unsigned int scatter( const Source &source, const Blocks &blocks, std::vector<unsigned int> &blockHistograms, std::vector<unsigned int> &blockOffsets, typename Source::Key *keys[2], unsigned int *values[2] )
+{
+	typedef typename Source::Key Key;
+	const unsigned int numPasses = sizeof( Key );
+
+	blockHistograms.resize( blocks.numBlocks * numPasses * 256 );
+	processBlocks( blocks, HistogramBlocks<Source>( source, blocks, &blockHistograms[0] ) );
+
+	unsigned int histograms[sizeof( Key ) * 256];
+	std::copy( blockHistograms.begin(), blockHistograms.begin() + numPasses * 256, histograms );
+	for( size_t b = 1; b < blocks.numBlocks; ++b )
 	{
-		numNegativeValues += h3[i];
+		const unsigned int *h = &blockHistograms[ b * numPasses * 256 ];
+		for( unsigned int i = 0; i < numPasses * 256; ++i )
+		{
+			histograms[i] += h[i];
+		}
 	}
 
-	for ( unsigned int j = 0; j < 4; j ++ )
-	{
-		unsigned char uniqueVal = 0;
-		unsigned int *curCount = 0;
-		bool performPass = checkPassValidity( input2, j, curCount, uniqueVal );
+	blockOffsets.resize( blocks.numBlocks * 256 );
 
-		if ( performPass )
+	const Key firstKey = source.key( 0 );
+	unsigned int numPassesPerformed = 0;
+	for( unsigned int pass = 0; pass < numPasses; ++pass )
+	{
+		// If every key has the same digit then the pass
+		// would leave the order unchanged.
+		const unsigned int *h = histograms + pass * 256;
+		if( h[ digit( firstKey, pass ) ] == blocks.size )
 		{
-			if ( j != 3 )
-			{
-				m_link[0] = &m_ranks2->writable()[0];
+			continue;
+		}
 
-				for( unsigned int i = 1; i < 256; i++ )
-				{
-					m_link[i] = m_link[i - 1] + curCount[ i - 1 ];
-				}
-			}
-			else
+		// Compute the counts for each block. The block histograms are only
+		// valid for the natural order of the source, so must otherwise be
+		// recomputed - unless there is only the one block, in which case
+		// the order is irrelevant.
+		const unsigned int current = ( numPassesPerformed + 1 ) % 2;
+		if( ( !numPassesPerformed && source.natural() ) || blocks.numBlocks == 1 )
+		{
+			for( size_t b = 0; b < blocks.numBlocks; ++b )
 			{
-				m_link[0] = &m_ranks2->writable()[numNegativeValues];
-				for( unsigned int i = 1; i < 128; i++ )
-				{
-					m_link[i] = m_link[i - 1] + curCount[ i - 1 ];
-				}
-				m_link[128] = &m_ranks2->writable()[0];
-				for( unsigned int i = 129; i < 256; i++ )
-				{
-					m_link[i] = m_link[i - 1] + curCount[ i - 1 ];
-				}
+				const unsigned int *blockHistogram = &blockHistograms[ ( b * numPasses + pass ) * 256 ];
+				std::copy( blockHistogram, blockHistogram + 256, &blockOffsets[ b * 256 ] );
 			}
+		}
+		else if( !numPassesPerformed )
+		{
+			processBlocks( blocks, CountBlocks<Source>( source, blocks, pass, &blockOffsets[0] ) );
+		}
+		else
+		{
+			processBlocks( blocks, CountBlocks<BufferSource<Key> >( BufferSource<Key>( keys[current], values[current] ), blocks, pass, &blockOffsets[0] ) );
+		}
 
-			const unsigned char *inputBytes = ( const unsigned char * )( input );
-#ifdef IE_CORE_BIG_ENDIAN
-			inputBytes += sizeof(int) - 1 - j;
-#else
-			inputBytes += j;
-#endif
-
-			if (m_currentSize & 0x80000000)
-			{
-				for ( unsigned int i = 0; i < nb; i++ )
-				{
-					*m_link[ inputBytes[ i<<2 ] ]++ = i;
-				}
-				m_currentSize &= 0x7fffffff;
-			}
-			else
+		// Turn the counts into offsets. Each block writes after all
+		// smaller digits, and after the same digit from earlier blocks,
+		// which keeps the sort stable.
+		unsigned int offset = 0;
+		for( unsigned int d = 0; d < 256; ++d )
+		{
+			for( size_t b = 0; b < blocks.numBlocks; ++b )
 			{
-				for ( UIntVectorData::ValueType::const_iterator it = m_ranks->readable().begin(); it != m_ranks->readable().end(); ++it )
-				{
-					unsigned int id = *it;
-					*m_link[ inputBytes[ id << 2 ] ]++ = id;
-				}
+				unsigned int &o = blockOffsets[ b * 256 + d ];
+				const unsigned int count = o;
+				o = offset;
+				offset += count;
 			}
+		}
 
-			std::swap( m_ranks, m_ranks2 );
+		const unsigned int next = numPassesPerformed % 2;
+		if( !numPassesPerformed )
+		{
+			processBlocks( blocks, ScatterBlocks<Source>( source, blocks, pass, &blockOffsets[0], keys[next], values[next] ) );
+		}
+		else
+		{
+			processBlocks( blocks, ScatterBlocks<BufferSource<Key> >( BufferSource<Key>( keys[current], values[current] ), blocks, pass, &blockOffsets[0], keys[next], values[next] ) );
 		}
+		numPassesPerformed++;
 	}
 
-	return m_ranks->readable();
+	// If the source wasn't sorted then at least one pass must have been made.
+	assert( numPassesPerformed );
+	return ( numPassesPerformed + 1 ) % 2;
 }
 
+} // namespace
 
-template<typename T>
-bool RadixSort::createHistograms( const std::vector<T> &input )
+//////////////////////////////////////////////////////////////////////////
+// RadixSort
+//////////////////////////////////////////////////////////////////////////
+
+RadixSort::RadixSort() : m_currentSize( 0 ), m_ranks( 0 ), m_ranks2( 0 )
 {
-	BOOST_STATIC_ASSERT( sizeof(T) == 4 );
+	m_ranks = new UIntVectorData();
+	m_ranks2 = new UIntVectorData();
 
-	memset( &m_histogram[0], 0, 256 * 4 * sizeof( unsigned int ) );
+	m_currentSize |= 0x80000000;
+}
 
-	const unsigned char *p = reinterpret_cast< const unsigned char * > ( &input[0] );
-	const unsigned char *pEnd = &p[ input.size() * 4 ] ;
+RadixSort::~RadixSort()
+{
+}
 
-#ifdef IE_CORE_BIG_ENDIAN
-	unsigned int *h3 = &m_histogram[0];
-	unsigned int *h2 = &m_histogram[256];
-	unsigned int *h1 = &m_histogram[512];
-	unsigned int *h0 = &m_histogram[768];
-#else
-	unsigned int *h0 = &m_histogram[0];
-	unsigned int *h1 = &m_histogram[256];
-	unsigned int *h2 = &m_histogram[512];
-	unsigned int *h3 = &m_histogram[768];
-#endif
+void RadixSort::resize( unsigned int s )
+{
+	m_ranks->writable().resize( s );
+	m_ranks2->writable().resize( s );
+}
 
-	bool alreadySorted = true;
+void RadixSort::checkResize( unsigned int s )
+{
+	unsigned int curSize = ( m_currentSize & 0x7fffffff );
 
-	if ( m_currentSize & 0x80000000 )
+	if ( s != curSize )
 	{
-		const T *running = &input[0];
-		T prevVal = *running;
+		resize( s );
 
-		while ( p != pEnd )
-		{
-			T val = *running++;
+		m_currentSize = s;
+		m_currentSize |= 0x80000000;
+	}
+}
 
-			if ( val < prevVal )
-			{
-				alreadySorted = false;
-				break;
-			}
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<float> &input )
+{
+	sortIndices( input );
+	return m_ranks->readable();
+}
 
-			prevVal = val;
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<unsigned int> &input )
+{
+	sortIndices( input );
+	return m_ranks->readable();
+}
 
-			h0[ *p++ ] ++;
-			h1[ *p++ ] ++;
-			h2[ *p++ ] ++;
-			h3[ *p++ ] ++;
-		}
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<int> &input )
+{
+	sortIndices( input );
+	return m_ranks->readable();
+}
+
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<double> &input )
+{
+	sortIndices( input );
+	return m_ranks->readable();
+}
+
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<uint64_t> &input )
+{
+	sortIndices( input );
+	return m_ranks->readable();
+}
+
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<int64_t> &input )
+{
+	sortIndices( input );
+	return m_ranks->readable();
+}
+
+void RadixSort::sortPairs( std::vector<unsigned int> &keys, std::vector<unsigned int> &values )
+{
+	sortPairsInternal( keys, values );
+}
 
-		if ( alreadySorted )
+void RadixSort::sortPairs( std::vector<uint64_t> &keys, std::vector<unsigned int> &values )
+{
+	sortPairsInternal( keys, values );
+}
+
+template<typename T>
+void RadixSort::sortIndices( const std::vector<T> &input )
+{
+	typedef typename RadixKey<T>::Type Key;
+
+	const unsigned int nb = input.size();
+	checkResize( nb );
+
+	if( !nb )
+	{
+		return;
+	}
+
+	// Check to see if the order left by the previous sort is still valid.
+
+	const Blocks blocks( nb );
+	const InputSource<T> source( &input[0], ( m_currentSize & 0x80000000 ) ? 0 : &m_ranks->readable()[0] );
+	if( sorted( source, blocks ) )
+	{
+		if( m_currentSize & 0x80000000 )
 		{
-			for ( unsigned int i = 0; i < input.size(); i ++ )
+			std::vector<unsigned int> &ranks = m_ranks->writable();
+			for( unsigned int i = 0; i < nb; i++ )
 			{
-				m_ranks->writable()[i] = i;
+				ranks[i] = i;
 			}
-			return true;
+			m_currentSize &= 0x7fffffff;
 		}
+		return;
 	}
-	else
-	{
-		const unsigned int* indices = &m_ranks->readable()[0];
-		T prevVal = input[ *indices ];
 
-		while ( p != pEnd )
-		{
-			T val = input[ *indices++ ];
-			if ( val < prevVal )
-			{
-				alreadySorted = false;
-				break;
-			}
+	// Sort the keys along with the indices, so that later passes
+	// read them sequentially rather than indirecting into the input.
+	// The first pass reads from m_ranks, so must write elsewhere.
 
-			prevVal = val;
+	std::vector<Key> sortedKeys( size_t( nb ) * 2 );
+	Key *keys[2] = { &sortedKeys[0], &sortedKeys[nb] };
+	unsigned int *values[2] = { &m_ranks2->writable()[0], &m_ranks->writable()[0] };
 
-			h0[ *p++ ] ++;
-			h1[ *p++ ] ++;
-			h2[ *p++ ] ++;
-			h3[ *p++ ] ++;
-		}
+	if( scatter( source, blocks, m_blockHistograms, m_blockOffsets, keys, values ) == 0 )
+	{
+		std::swap( m_ranks, m_ranks2 );
+	}
+	m_currentSize &= 0x7fffffff;
+}
 
-		if ( alreadySorted )
-		{
-			return true;
-		}
+template<typename T>
+void RadixSort::sortPairsInternal( std::vector<T> &keys, std::vector<unsigned int> &values )
+{
+	if( keys.size() != values.size() )
+	{
+		throw InvalidArgumentException( "RadixSort : Keys and values must have the same length" );
+	}
 
+	if( keys.empty() )
+	{
+		return;
 	}
 
-	while ( p != pEnd )
+	// Keys are permuted in place, so the coherence between calls is
+	// exploited simply by checking to see if they are still sorted.
+
+	const Blocks blocks( keys.size() );
+	const BufferSource<T> source( &keys[0], &values[0] );
+	if( sorted( source, blocks ) )
 	{
-		h0[ *p++ ] ++;
-		h1[ *p++ ] ++;
-		h2[ *p++ ] ++;
-		h3[ *p++ ] ++;
+		return;
 	}
 
-	return false;
-}
+	std::vector<T> tmpKeys( keys.size() );
+	std::vector<unsigned int> tmpValues( values.size() );
+	T *keyBuffers[2] = { &tmpKeys[0], &keys[0] };
+	unsigned int *valueBuffers[2] = { &tmpValues[0], &values[0] };
 
+	if( scatter( source, blocks, m_blockHistograms, m_blockOffsets, keyBuffers, valueBuffers ) == 0 )
+	{
+		keys.swap( tmpKeys );
+		values.swap( tmpValues );
+	}
+}
@@ -34,7 +34,7 @@
 
 #include <cassert>
 
-#include "tbb/mutex.h"
+#include "tbb/concurrent_unordered_map.h"
 
 #include "boost/format.hpp"
 
@@ -43,8 +43,29 @@
 
 using namespace IECore;
 
-RunTimeTyped::Mutex RunTimeTyped::g_baseTypeIdsMutex;
-RunTimeTyped::Mutex RunTimeTyped::g_derivedTypeIdsMutex;
+namespace
+{
+
+// The complete ancestry and descendants of each type, computed lazily on
+// first request. These are queried frequently from many threads, so are held
+// in concurrent maps which can be read without taking any lock. Entries are
+// only ever added, so the references we return to them remain valid.
+typedef tbb::concurrent_unordered_map<TypeId, std::vector<TypeId> > CompleteBaseTypesMap;
+typedef tbb::concurrent_unordered_map<TypeId, std::set<TypeId> > CompleteDerivedTypesMap;
+
+CompleteBaseTypesMap &completeBaseTypes()
+{
+	static CompleteBaseTypesMap *baseTypes = new CompleteBaseTypesMap();
+	return *baseTypes;
+}
+
+CompleteDerivedTypesMap &completeDerivedTypes()
+{
+	static CompleteDerivedTypesMap *derivedTypes = new CompleteDerivedTypesMap();
+	return *derivedTypes;
+}
+
+} // namespace
 
 RunTimeTyped::RunTimeTyped()
 {
@@ -215,49 +236,40 @@ TypeId RunTimeTyped::baseTypeId( TypeId typeId )
 
 const std::vector<TypeId> &RunTimeTyped::baseTypeIds( TypeId typeId )
 {
-	Mutex::scoped_lock lock( g_baseTypeIdsMutex, false ); // read-only lock
-	BaseTypesRegistryMap &baseTypes = completeBaseTypesRegistry();
-
-	BaseTypesRegistryMap::iterator it = baseTypes.find( typeId );
+	CompleteBaseTypesMap &baseTypes = completeBaseTypes();
+	CompleteBaseTypesMap::const_iterator it = baseTypes.find( typeId );
 	if ( it != baseTypes.end() )
 	{
 		return it->second;
 	}
-	
-	lock.upgrade_to_writer();
-	
-	baseTypes.insert( BaseTypesRegistryMap::value_type( typeId, std::vector<TypeId>() ) );
-	it = baseTypes.find( typeId );
-	assert( it != baseTypes.end() );
 
+	std::vector<TypeId> typeIds;
 	TypeId baseType = baseTypeId( typeId );
 	while ( baseType != InvalidTypeId )
 	{
-		it->second.push_back( baseType );
+		typeIds.push_back( baseType );
 		baseType = baseTypeId( baseType );
 	}
 
-	return it->second;
+	// Another thread may have inserted an identical entry
+	// concurrently, in which case we return that instead.
+	return baseTypes.insert( CompleteBaseTypesMap::value_type( typeId, typeIds ) ).first->second;
 }
 
 const std::set<TypeId> &RunTimeTyped::derivedTypeIds( TypeId typeId )
 {
-	Mutex::scoped_lock lock( g_derivedTypeIdsMutex, false ); // read-only lock
-	DerivedTypesRegistryMap &derivedTypes = completeDerivedTypesRegistry();
-	DerivedTypesRegistryMap::iterator it = derivedTypes.find( typeId );
-
-	if ( it == derivedTypes.end() )
-	{	
-		lock.upgrade_to_writer();
-		derivedTypes.insert( DerivedTypesRegistryMap::value_type( typeId, std::set<TypeId>() ) );
-		it = derivedTypes.find( typeId );
-		assert( it != derivedTypes.end() );
-
-		// Walk over the hierarchy of derived types
-		derivedTypeIdsWalk( typeId, it->second );
+	CompleteDerivedTypesMap &derivedTypes = completeDerivedTypes();
+	CompleteDerivedTypesMap::const_iterator it = derivedTypes.find( typeId );
+	if ( it != derivedTypes.end() )
+	{
+		return it->second;
 	}
 
-	return it->second;
+	// Walk over the hierarchy of derived types
+	std::set<TypeId> typeIds;
+	derivedTypeIdsWalk( typeId, typeIds );
+
+	return derivedTypes.insert( CompleteDerivedTypesMap::value_type( typeId, typeIds ) ).first->second;
 }
 
 void RunTimeTyped::derivedTypeIdsWalk( TypeId typeId, std::set<TypeId> &typeIds )
@@ -279,20 +291,6 @@ void RunTimeTyped::derivedTypeIdsWalk( TypeId typeId, std::set<TypeId> &typeIds
 	}
 }
 
-RunTimeTyped::BaseTypesRegistryMap &RunTimeTyped::completeBaseTypesRegistry()
-{
-	static BaseTypesRegistryMap *baseTypes = new BaseTypesRegistryMap();
-	assert( baseTypes );
-	return *baseTypes;
-}
-
-RunTimeTyped::DerivedTypesRegistryMap &RunTimeTyped::completeDerivedTypesRegistry()
-{
-	static DerivedTypesRegistryMap *derivedTypes = new DerivedTypesRegistryMap();
-	assert( derivedTypes );
-	return *derivedTypes;
-}
-
 TypeId RunTimeTyped::typeIdFromTypeName( const char *typeName )
 {
 	assert( typeName );
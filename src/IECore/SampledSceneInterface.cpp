@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "IECore/SampledSceneInterface.h"
+#include "IECore/Exception.h"
 
 using namespace IECore;
 
@@ -41,3 +42,57 @@ IE_CORE_DEFINERUNTIMETYPEDDESCRIPTION( SampledSceneInterface )
 SampledSceneInterface::~SampledSceneInterface()
 {
 }
+
+void SampledSceneInterface::readTransformSamples( double startTime, double endTime, std::vector<double> &times, std::vector<Imath::M44d> &transforms ) const
+{
+	if ( endTime < startTime )
+	{
+		throw InvalidArgumentException( "SampledSceneInterface::readTransformSamples : endTime must not be less than startTime" );
+	}
+
+	times.clear();
+	transforms.clear();
+	if ( !numTransformSamples() )
+	{
+		return;
+	}
+
+	size_t first, last, unused;
+	transformSampleInterval( startTime, first, unused );
+	transformSampleInterval( endTime, unused, last );
+
+	times.reserve( last - first + 1 );
+	transforms.reserve( last - first + 1 );
+	for ( size_t i = first; i <= last; ++i )
+	{
+		times.push_back( transformSampleTime( i ) );
+		transforms.push_back( readTransformAsMatrixAtSample( i ) );
+	}
+}
+
+void SampledSceneInterface::readObjectSamples( double startTime, double endTime, std::vector<double> &times, std::vector<ConstObjectPtr> &objects ) const
+{
+	if ( endTime < startTime )
+	{
+		throw InvalidArgumentException( "SampledSceneInterface::readObjectSamples : endTime must not be less than startTime" );
+	}
+
+	times.clear();
+	objects.clear();
+	if ( !hasObject() || !numObjectSamples() )
+	{
+		return;
+	}
+
+	size_t first, last, unused;
+	objectSampleInterval( startTime, first, unused );
+	objectSampleInterval( endTime, unused, last );
+
+	times.reserve( last - first + 1 );
+	objects.reserve( last - first + 1 );
+	for ( size_t i = first; i <= last; ++i )
+	{
+		times.push_back( objectSampleTime( i ) );
+		objects.push_back( readObjectAtSample( i ) );
+	}
+}
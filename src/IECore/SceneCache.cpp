@@ -32,8 +32,20 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cmath>
+
+#include <sys/stat.h>
+
+#include "boost/lexical_cast.hpp"
 #include"boost/tuple/tuple.hpp"
+#include "tbb/atomic.h"
 #include "tbb/concurrent_hash_map.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/recursive_mutex.h"
+#include "tbb/task.h"
+#include "tbb/task_group.h"
 
 #include "OpenEXR/ImathBoxAlgo.h"
 
@@ -43,11 +55,13 @@
 #include "IECore/VisibleRenderable.h"
 #include "IECore/ObjectInterpolator.h"
 #include "IECore/Primitive.h"
+#include "IECore/PrimitiveCompression.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/TransformationMatrixData.h"
 #include "IECore/SharedSceneInterfaces.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/ComputationCache.h"
+#include "IECore/Profiling.h"
 
 using namespace IECore;
 using namespace Imath;
@@ -78,12 +92,37 @@ static InternedString tagsEntry("tags");
 static InternedString localTagsEntry("localTags");
 static InternedString ancestorTagsEntry("ancestorTags");
 static InternedString descendentTagsEntry("descendentTags");
+static InternedString indexEntry("index");
+static InternedString pathsEntry("paths");
+static InternedString boundsEntry("bounds");
 
 const SceneInterface::Name &SceneCache::animatedObjectTopologyAttribute = InternedString( "sceneInterface:animatedObjectTopology" );
 const SceneInterface::Name &SceneCache::animatedObjectPrimVarsAttribute = InternedString( "sceneInterface:animatedObjectPrimVars" );
 
 typedef std::vector<double> SampleTimes;
 
+// Returns the bound containing the given one transformed by every sample of each transform
+// in turn, from the innermost (last) to the outermost. Used for the location bounds stored in
+// the index, which must contain the location at any time.
+static Imath::Box3d transformBySamples( const Imath::Box3d &bound, const std::vector< std::vector<Imath::M44d> > &transforms )
+{
+	Imath::Box3d result = bound;
+	for ( std::vector< std::vector<Imath::M44d> >::const_reverse_iterator it = transforms.rbegin(); it != transforms.rend(); ++it )
+	{
+		if ( it->empty() )
+		{
+			continue;
+		}
+		Imath::Box3d transformed;
+		for ( std::vector<Imath::M44d>::const_iterator mIt = it->begin(); mIt != it->end(); ++mIt )
+		{
+			transformed.extendBy( Imath::transform( result, *mIt ) );
+		}
+		result = transformed;
+	}
+	return result;
+}
+
 class SceneCache::Implementation : public RefCounted
 {
 	public :
@@ -302,7 +341,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			else
 			{
 				// only the root instance allocate the map.
-				m_sharedData = new SharedData;
+				m_sharedData = new SharedData( fileIdentity( io.get() ) );
 			}
 		}
 	
@@ -360,25 +399,28 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 		static inline double sampleInterval( const SampleTimes &sampleTimes, double time, size_t &floorIndex, size_t &ceilIndex )
 		{
-			SampleTimes::const_iterator it = sampleTimes.begin();
-			for ( ; it != sampleTimes.end(); it++ )
-			{
-				if ( time <= *it )
-				{
-					break;
-				}
-			}
-			if ( it == sampleTimes.begin() )
+			const size_t numSamples = sampleTimes.size();
+			if ( !numSamples || time <= sampleTimes.front() )
 			{
 				ceilIndex = floorIndex = 0;
 				return 0;
 			}
-			if ( it == sampleTimes.end() )
+			if ( time > sampleTimes.back() )
 			{
-				ceilIndex = floorIndex = sampleTimes.size() - 1;
+				ceilIndex = floorIndex = numSamples - 1;
 				return 0;
 			}
-			ceilIndex = (it - sampleTimes.begin());
+
+			// Guess the first sample not before the time assuming the samples are uniformly
+			// spaced, which is the common case, so that densely sampled caches find it in constant
+			// time. Otherwise we fall back to a binary search.
+			const double first = sampleTimes.front();
+			ceilIndex = (size_t)std::ceil( (time - first) / (sampleTimes.back() - first) * (numSamples - 1) );
+			ceilIndex = std::max( (size_t)1, std::min( ceilIndex, numSamples - 1 ) );
+			if ( !( sampleTimes[ceilIndex-1] < time && time <= sampleTimes[ceilIndex] ) )
+			{
+				ceilIndex = std::lower_bound( sampleTimes.begin(), sampleTimes.end(), time ) - sampleTimes.begin();
+			}
 			floorIndex = ceilIndex - 1;
 			double x = (time - sampleTimes[floorIndex]) / (sampleTimes[ceilIndex] - sampleTimes[floorIndex]);
 			if ( x < 1e-4 )
@@ -654,7 +696,9 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 		static PrimitiveVariableMap readObjectPrimitiveVariablesAtSample( const IndexedIOPtr &io, const std::vector<InternedString> &primVarNames, size_t sample )
 		{
-			return Primitive::loadPrimitiveVariables( io->subdirectory( objectEntry ).get(), sampleEntry(sample), primVarNames );
+			PrimitiveVariableMap result = Primitive::loadPrimitiveVariables( io->subdirectory( objectEntry ).get(), sampleEntry(sample), primVarNames );
+			PrimitiveCompression::decompress( result );
+			return result;
 		}
 
 		PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const
@@ -671,10 +715,56 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				return readObjectPrimitiveVariablesAtSample(m_indexedIO, primVarNames, sample2);
 			}
 
-			IndexedIOPtr objectIO = m_indexedIO->subdirectory( objectEntry );
-			PrimitiveVariableMap map1 = Primitive::loadPrimitiveVariables( objectIO.get(), sampleEntry(sample1), primVarNames );
-			PrimitiveVariableMap map2 = Primitive::loadPrimitiveVariables( objectIO.get(), sampleEntry(sample2), primVarNames );
+			PrimitiveVariableMap map1 = readObjectPrimitiveVariablesAtSample( m_indexedIO, primVarNames, sample1 );
+			PrimitiveVariableMap map2 = readObjectPrimitiveVariablesAtSample( m_indexedIO, primVarNames, sample2 );
+			interpolatePrimitiveVariables( map1, map2, x );
+			return map1;
+		}
 
+		static PrimitiveVariableMap readObjectPrimitiveVariableRangeAtSample( const IndexedIOPtr &io, const std::vector<InternedString> &primVarNames, size_t sample, size_t begin, size_t end, IndexedIO::EntryIDList &unsupportedNames )
+		{
+			PrimitiveVariableMap result = Primitive::loadPrimitiveVariableRange( io->subdirectory( objectEntry ).get(), sampleEntry(sample), primVarNames, begin, end, unsupportedNames );
+			PrimitiveCompression::decompress( result );
+			return result;
+		}
+
+		// Reads the range of the variables which can be read partially, appending the
+		// names of the others to unsupportedNames.
+		PrimitiveVariableMap readObjectPrimitiveVariableRange( const std::vector<InternedString> &primVarNames, double time, size_t begin, size_t end, IndexedIO::EntryIDList &unsupportedNames ) const
+		{
+			size_t sample1, sample2;
+			double x = objectSampleInterval( time, sample1, sample2 );
+
+			if ( x == 0 )
+			{
+				return readObjectPrimitiveVariableRangeAtSample( m_indexedIO, primVarNames, sample1, begin, end, unsupportedNames );
+			}
+			if ( x == 1 )
+			{
+				return readObjectPrimitiveVariableRangeAtSample( m_indexedIO, primVarNames, sample2, begin, end, unsupportedNames );
+			}
+
+			IndexedIO::EntryIDList unsupportedNames2;
+			PrimitiveVariableMap map1 = readObjectPrimitiveVariableRangeAtSample( m_indexedIO, primVarNames, sample1, begin, end, unsupportedNames );
+			PrimitiveVariableMap map2 = readObjectPrimitiveVariableRangeAtSample( m_indexedIO, primVarNames, sample2, begin, end, unsupportedNames2 );
+
+			// a variable which can't be read partially at one of the samples
+			// must be read whole at both, so that the two can be interpolated.
+			for ( IndexedIO::EntryIDList::const_iterator it = unsupportedNames2.begin(); it != unsupportedNames2.end(); it++ )
+			{
+				if ( std::find( unsupportedNames.begin(), unsupportedNames.end(), *it ) == unsupportedNames.end() )
+				{
+					map1.erase( *it );
+					unsupportedNames.push_back( *it );
+				}
+			}
+
+			interpolatePrimitiveVariables( map1, map2, x );
+			return map1;
+		}
+
+		static void interpolatePrimitiveVariables( PrimitiveVariableMap &map1, const PrimitiveVariableMap &map2, double x )
+		{
 			for ( PrimitiveVariableMap::iterator it1 = map1.begin(); it1 != map1.end(); it1++ )
 			{
 				PrimitiveVariableMap::const_iterator it2 = map2.find( it1->first );
@@ -682,9 +772,29 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				{
 					continue;
 				}
-				it1->second.data = boost::static_pointer_cast< Data >( linearObjectInterpolation( it1->second.data.get(), it2->second.data.get(), x ) );
+				// values which can't be interpolated are left as they are at the first sample
+				ObjectPtr data;
+				if( it1->second.indices == it2->second.indices ||
+					( it1->second.indices && it2->second.indices && it1->second.indices->isEqualTo( it2->second.indices.get() ) )
+				)
+				{
+					data = linearObjectInterpolation( it1->second.data.get(), it2->second.data.get(), x );
+					if ( data )
+					{
+						it1->second.data = boost::static_pointer_cast< Data >( data );
+					}
+				}
+				else
+				{
+					// differently indexed values must be expanded before they can be interpolated
+					data = linearObjectInterpolation( it1->second.expandedData().get(), it2->second.expandedData().get(), x );
+					if ( data )
+					{
+						it1->second.data = boost::static_pointer_cast< Data >( data );
+						it1->second.indices = 0;
+					}
+				}
 			}
-			return map1;
 		}
 
 		ReaderImplementationPtr child( const Name &name, MissingBehaviour missingBehaviour )
@@ -702,6 +812,37 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return new ReaderImplementation( childIO, this );
 		}
 
+		// Fills names with the children of this location, returning the directory
+		// holding them, or null if there are none. Used by SceneCache::traverse() to
+		// visit all the children without looking the directory up for each one.
+		IndexedIOPtr childrenDirectory( NameList &names ) const
+		{
+			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, IndexedIO::NullIfMissing );
+			if ( !children )
+			{
+				names.clear();
+				return 0;
+			}
+			children->entryIds( names, IndexedIO::Directory );
+			return children;
+		}
+
+		// The state of SceneCache::traverse() for one level of the hierarchy.
+		// Each frame is reused for all the locations at its depth.
+		struct TraversalFrame
+		{
+			TraversalFrame() : nextChild( 0 )
+			{
+			}
+
+			ReaderImplementationPtr location;
+			IndexedIOPtr children;
+			NameList childNames;
+			size_t nextChild;
+			// The SceneCache passed to the visitor for the children of the location.
+			SceneCachePtr cursor;
+		};
+
 		SceneCache::ImplementationPtr scene( const Path &path, MissingBehaviour missingBehaviour )
 		{
 			// go to root of the scene and than CD to the location...
@@ -719,6 +860,86 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return location;
 		}
 
+		void readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds )
+		{
+			bounds.resize( paths.size() );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, paths.size() ), BatchReader<BoundReader, Imath::Box3d>( this, paths, time, bounds ) );
+		}
+
+		void readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms )
+		{
+			transforms.resize( paths.size() );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, paths.size() ), BatchReader<TransformReader, Imath::M44d>( this, paths, time, transforms ) );
+		}
+
+		void readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects )
+		{
+			objects.clear();
+			objects.resize( paths.size() );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, paths.size() ), BatchReader<ObjectReader, ConstObjectPtr>( this, paths, time, objects ) );
+		}
+
+		void taggedLocations( const Name &tag, std::vector<Path> &paths ) const
+		{
+			paths.clear();
+			ConstIndexedIOPtr index = root()->m_indexedIO->subdirectory( indexEntry, IndexedIO::NullIfMissing );
+			if ( !index )
+			{
+				// files written before the index was introduced must be traversed.
+				traverseTaggedLocations( tag, paths );
+				return;
+			}
+
+			ConstIndexedIOPtr tagsIO = index->subdirectory( tagsEntry );
+			if ( !tagsIO->hasEntry( tag ) )
+			{
+				return;
+			}
+
+			std::vector<std::string> locations;
+			readStrings( tagsIO.get(), tag, locations );
+			appendLocationsBelow( locations, std::vector<bool>( locations.size(), true ), paths );
+		}
+
+		void locationsIntersecting( const Imath::Box3d &bound, std::vector<Path> &paths ) const
+		{
+			paths.clear();
+			ConstIndexedIOPtr index = root()->m_indexedIO->subdirectory( indexEntry, IndexedIO::NullIfMissing );
+			if ( !index )
+			{
+				// files written before the index was introduced must be traversed.
+				std::vector< std::vector<M44d> > ancestorTransforms;
+				traverseLocationsIntersecting( bound, ancestorTransforms, paths );
+				return;
+			}
+
+			ConstIndexedIOPtr boundsIO = index->subdirectory( boundsEntry );
+			if ( !boundsIO->hasEntry( pathsEntry ) )
+			{
+				return;
+			}
+
+			std::vector<std::string> locations;
+			readStrings( boundsIO.get(), pathsEntry, locations );
+
+			std::vector<double> boxes( locations.size() * 6 );
+			double *boxesPtr = &boxes[0];
+			boundsIO->read( boundsEntry, boxesPtr, boxes.size() );
+
+			std::vector<bool> intersecting( locations.size() );
+			for ( size_t i = 0; i < locations.size(); ++i )
+			{
+				const Box3d box( V3d( boxesPtr + i * 6 ), V3d( boxesPtr + i * 6 + 3 ) );
+				intersecting[i] = box.intersects( bound );
+			}
+			appendLocationsBelow( locations, intersecting, paths );
+		}
+
+		void prefetch( const std::vector<Path> &paths, double startTime, double endTime )
+		{
+			tbb::task::enqueue( *new( tbb::task::allocate_root() ) PrefetchTask( this, paths, startTime, endTime ) );
+		}
+
 		void hash( HashType hashType, double time, MurmurHash &h, bool ignoreSceneHash = false ) const
 		{
 			size_t s0, s1;
@@ -770,15 +991,23 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 					if ( m_indexedIO->hasEntry( objectEntry ) )
 					{
+						// hash the file locations the samples are stored at rather than this
+						// scene location, so that locations sharing identical objects (as
+						// deduplicated by the writer) have identical hashes and can be instanced.
 						x = objectSampleInterval( time, s0, s1 );
-						h.append( lerp( (double)s0, (double)s1, x ) );
-					}
-					else
-					{
-						// return a simple hash for no object (which does not include the scene location).
-						return;
+						IndexedIO::EntryIDList samplePath;
+						objectSamplePath( s0, samplePath );
+						h.append( &samplePath[0], samplePath.size() );
+						if( x > 0 )
+						{
+							objectSamplePath( s1, samplePath );
+							h.append( &samplePath[0], samplePath.size() );
+							h.append( x );
+						}
+						h.append( m_sharedData->fileHash );
 					}
-					break;
+					// return without the scene location hash.
+					return;
 
 				case ChildNamesHash:
 
@@ -821,7 +1050,144 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		}
 
 	private :
-	
+
+		struct BoundReader
+		{
+			static void read( const ReaderImplementation *location, double time, Imath::Box3d &result )
+			{
+				result = location->readBound( time );
+			}
+		};
+
+		struct TransformReader
+		{
+			static void read( const ReaderImplementation *location, double time, Imath::M44d &result )
+			{
+				result = location->readTransformAsMatrix( time );
+			}
+		};
+
+		struct ObjectReader
+		{
+			static void read( const ReaderImplementation *location, double time, ConstObjectPtr &result )
+			{
+				if ( location->hasObject() )
+				{
+					result = location->readObject( time );
+				}
+			}
+		};
+
+		// Functor for the batch reading methods. Each path is resolved and read
+		// independently, relying on the reader being safe for concurrent access.
+		template<typename Reader, typename T>
+		class BatchReader
+		{
+			public :
+
+				BatchReader( ReaderImplementation *reader, const std::vector<Path> &paths, double time, std::vector<T> &results )
+					:	m_reader( reader ), m_paths( paths ), m_time( time ), m_results( results )
+				{
+				}
+
+				void operator()( const tbb::blocked_range<size_t> &r ) const
+				{
+					for ( size_t i = r.begin(); i != r.end(); ++i )
+					{
+						ImplementationPtr location = m_reader->scene( m_paths[i], SceneInterface::ThrowIfMissing );
+						Reader::read( ReaderImplementation::reader( location.get() ), m_time, m_results[i] );
+					}
+				}
+
+			private :
+
+				ReaderImplementation *m_reader;
+				const std::vector<Path> &m_paths;
+				double m_time;
+				std::vector<T> &m_results;
+
+		};
+
+
+		// Background task used by prefetch(). It loads every transform and object sample
+		// needed to evaluate the given locations within the time range, so that they are
+		// already held by the caches in m_sharedData when they are requested. It holds a
+		// reference to the reader, which keeps the file open until the task completes.
+		class PrefetchTask : public tbb::task
+		{
+
+			public :
+
+				PrefetchTask( ReaderImplementationPtr reader, const std::vector<Path> &paths, double startTime, double endTime )
+					:	m_reader( reader ), m_paths( paths ), m_startTime( startTime ), m_endTime( endTime )
+				{
+				}
+
+				virtual task *execute()
+				{
+					// Prefetching is only a hint, so we ignore any errors and leave them
+					// to be reported when the location is actually read. The transforms
+					// and objects are prefetched separately, so that an error reading
+					// one doesn't prevent the other from being prefetched.
+					for ( std::vector<Path>::const_iterator it = m_paths.begin(); it != m_paths.end(); ++it )
+					{
+						ImplementationPtr impl;
+						try
+						{
+							impl = m_reader->scene( *it, SceneInterface::NullIfMissing );
+						}
+						catch( ... )
+						{
+						}
+						if ( !impl )
+						{
+							continue;
+						}
+						const ReaderImplementation *location = ReaderImplementation::reader( impl.get() );
+
+						size_t first, last, unused;
+						try
+						{
+							location->transformSampleInterval( m_startTime, first, unused );
+							location->transformSampleInterval( m_endTime, unused, last );
+							for ( size_t i = first; i <= last; ++i )
+							{
+								location->readTransformAtSample( i );
+							}
+						}
+						catch( ... )
+						{
+						}
+
+						try
+						{
+							if ( location->hasObject() )
+							{
+								location->objectSampleInterval( m_startTime, first, unused );
+								location->objectSampleInterval( m_endTime, unused, last );
+								for ( size_t i = first; i <= last; ++i )
+								{
+									location->readObjectAtSample( i );
+								}
+							}
+						}
+						catch( ... )
+						{
+						}
+					}
+					return 0;
+				}
+
+			private :
+
+				ReaderImplementationPtr m_reader;
+				std::vector<Path> m_paths;
+				double m_startTime;
+				double m_endTime;
+
+		};
+
+
 		// \todo Consider using concurrent_vector for constant access time.
 		typedef tbb::concurrent_hash_map< uint64_t, SampleTimes > SampleTimesMap;
 		typedef std::map< IndexedIO::EntryID, const SampleTimes* > AttributeSamplesMap;
@@ -833,22 +1199,158 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		typedef IECore::ComputationCache< SimpleCacheKey > SimpleCache;
 		typedef IECore::ComputationCache< AttributeCacheKey > AttributeCache;
 
+	public :
+
+		/// The caches shared by every reader in the process, so that a file opened more than once
+		/// (for instance both directly and via SharedSceneInterfaces) is only loaded once. The
+		/// computation caches only map hashes, and the memory is bounded by the ObjectPool
+		/// holding the results.
+		struct Caches
+		{
+			Caches()
+				:	objectPool( new ObjectPool( 1024 * 1024 * memoryLimit() ) ),
+					objectCache( new SimpleCache( doReadObjectAtSample, objectHash, 100000, objectPool ) ),
+					attributeCache( new AttributeCache( doReadAttributeAtSample, attributeHash, 100000, objectPool ) ),
+					transformCache( new SimpleCache( doReadTransformAtSample, simpleHash, 100000, objectPool ) )
+			{
+				hits = 0;
+				misses = 0;
+			}
+
+			static size_t memoryLimit()
+			{
+				const char *m = getenv( "IECORE_SCENECACHE_MEMORY" );
+				if( !m )
+				{
+					return 500;
+				}
+
+				try
+				{
+					return boost::lexical_cast<size_t>( m );
+				}
+				catch( const boost::bad_lexical_cast & )
+				{
+					msg( Msg::Warning, "SceneCache", boost::format( "Invalid value \"%s\" for IECORE_SCENECACHE_MEMORY - using 500 instead." ) % m );
+					return 500;
+				}
+			}
+
+			void clear()
+			{
+				objectCache->clear();
+				attributeCache->clear();
+				transformCache->clear();
+				objectPool->clear();
+				hits = 0;
+				misses = 0;
+			}
+
+			ObjectPoolPtr objectPool;
+			SimpleCache::Ptr objectCache;
+			AttributeCache::Ptr attributeCache;
+			SimpleCache::Ptr transformCache;
+			tbb::atomic<size_t> hits;
+			tbb::atomic<size_t> misses;
+		};
+
+		static Caches &caches()
+		{
+			static Caches *c = new Caches;
+			return *c;
+		}
+
+		/// Must be called when a file has been written, so that readers opened
+		/// afterwards don't share cache entries with readers of the previous
+		/// contents, even if the file identity is otherwise unchanged.
+		static void fileWritten( const std::string &fileName )
+		{
+			FileGenerations::accessor a;
+			fileGenerations().insert( a, fileName );
+			a->second++;
+		}
+
+	private :
+
+		typedef tbb::concurrent_hash_map< std::string, uint64_t > FileGenerations;
+
+		static FileGenerations &fileGenerations()
+		{
+			static FileGenerations *g = new FileGenerations;
+			return *g;
+		}
+
+		/// Returns the cached result for key, computing it if necessary, and
+		/// updates the cache statistics.
+		template<typename Key>
+		static ConstObjectPtr cachedGet( ComputationCache<Key> *cache, const Key &key )
+		{
+			ConstObjectPtr result = cache->get( key, ComputationCache<Key>::NullIfMissing );
+			if ( result )
+			{
+				caches().hits++;
+				return result;
+			}
+			caches().misses++;
+			return cache->get( key );
+		}
+
+		/// Returns a hash identifying the contents of the file open for reading, so that
+		/// readers of the same file share entries in the caches. Files are identified by
+		/// their name, device, inode, size, nanosecond modification time and the number
+		/// of times they've been written by this process. Other IndexedIO instances (such
+		/// as MemoryIndexedIO) are identified uniquely.
+		static MurmurHash fileIdentity( const IndexedIO *io )
+		{
+			MurmurHash h;
+			if ( io->typeId() == FileIndexedIOTypeId )
+			{
+				const std::string &fileName = static_cast< const FileIndexedIO * >( io )->fileName();
+				struct stat s;
+				if( stat( fileName.c_str(), &s ) == 0 )
+				{
+					h.append( fileName );
+					h.append( (uint64_t)s.st_dev );
+					h.append( (uint64_t)s.st_ino );
+					h.append( (uint64_t)s.st_size );
+#ifdef __APPLE__
+					h.append( (uint64_t)s.st_mtimespec.tv_sec );
+					h.append( (uint64_t)s.st_mtimespec.tv_nsec );
+#else
+					h.append( (uint64_t)s.st_mtim.tv_sec );
+					h.append( (uint64_t)s.st_mtim.tv_nsec );
+#endif
+					FileGenerations::const_accessor a;
+					if( fileGenerations().find( a, fileName ) )
+					{
+						h.append( a->second );
+					}
+					return h;
+				}
+				// fall back to a unique identifier below.
+			}
+			static tbb::atomic<uint64_t> g_uniqueId;
+			h.append( (uint64_t)++g_uniqueId );
+			return h;
+		}
+
 		/// Hold pointers to values allocated/deallocated by the root scene object (the last one to die)
 		class SharedData : public RefCounted
 		{
 			public :
 
-				SharedData() : 
-					objectCache( new SimpleCache( doReadObjectAtSample, simpleHash,  10000 )  ), 
-					attributeCache( new AttributeCache( doReadAttributeAtSample, attributeHash, 1000) ), 
-					transformCache( new SimpleCache(  doReadTransformAtSample, simpleHash, 1000) )
+				SharedData( const MurmurHash &fileHash ) :
+					fileHash( fileHash ),
+					objectCache( caches().objectCache.get() ),
+					attributeCache( caches().attributeCache.get() ),
+					transformCache( caches().transformCache.get() )
 				{
 				}
 
 				/// utility function used by the ReaderImplementation to use the LRUCache for transform reading
 				IECore::ConstDataPtr readTransformAtSample( const ReaderImplementation *reader, size_t sample )
 				{
-					return runTimeCast< const Data >( transformCache->get( SimpleCacheKey(reader, sample) ) );
+					return runTimeCast< const Data >( cachedGet( transformCache, SimpleCacheKey(reader, sample) ) );
 				}
 
 				/// utility function used by the ReaderImplementation to use the LRUCache for object reading
@@ -866,6 +1368,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 						ConstObjectPtr obj = objectCache->get( currentKey, SimpleCache::NullIfMissing );
 						if ( !obj )
 						{
+							caches().misses++;
 							/// ok, try to build the object from another frame...
 							ConstObjectPtr defaultObj = objectCache->get( defaultKey, SimpleCache::NullIfMissing );
 							if ( defaultObj )
@@ -886,26 +1389,30 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 							/// ok, we don't have the object even from other times in the cache... load it from the file then.
 							obj = objectCache->get( currentKey );
 						}
+						else
+						{
+							caches().hits++;
+						}
 						/// register the object as the default, so next frames could reuse them
 						objectCache->set( defaultKey, obj.get(), ObjectPool::StoreReference );
 						return obj;
 					}
 					/// The object has animated topology... so we load the entire object
-					ConstObjectPtr obj = objectCache->get(currentKey);
-					return obj;
+					return cachedGet( objectCache, currentKey );
 				}
 
 				/// utility function used by the ReaderImplementation to use the LRUCache for attribute reading
 				IECore::ConstObjectPtr readAttributeAtSample( const ReaderImplementation *reader, const SceneCache::Name &name, size_t sample )
 				{
-					return attributeCache->get( AttributeCacheKey(reader,name,sample) );
+					return cachedGet( attributeCache, AttributeCacheKey(reader,name,sample) );
 				}
 
 				// \todo Consider adding "ReaderImplementation *rootScene" to optimize the scene() calls.
 				SampleTimesMap sampleTimesMap;
-				SimpleCache::Ptr objectCache;
-				AttributeCache::Ptr attributeCache;
-				SimpleCache::Ptr transformCache;
+				MurmurHash fileHash;
+				SimpleCache *objectCache;
+				AttributeCache *attributeCache;
+				SimpleCache *transformCache;
 
 			private :
 
@@ -1020,8 +1527,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 		static void sceneHash( const ReaderImplementation *scene, MurmurHash &h )
 		{
-			// \todo Currently there's a chance of hash collision if the file is closed and others opened, if the shared data object happens to be allocated in the same address. Replace it by a more reliable mechanism for uniquely identifying the file. 
-			h.append( (uint64_t)scene->m_sharedData );
+			h.append( scene->m_sharedData->fileHash );
 			const ReaderImplementation *currScene = scene;
 			while( currScene->m_parent )
 			{
@@ -1031,6 +1537,146 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			h.append( currScene->name() );
 		}
 
+		const ReaderImplementation *root() const
+		{
+			const ReaderImplementation *result = this;
+			while( result->m_parent )
+			{
+				result = result->m_parent.get();
+			}
+			return result;
+		}
+
+		static void readStrings( const IndexedIO *io, const IndexedIO::EntryID &name, std::vector<std::string> &strings )
+		{
+			const IndexedIO::Entry e = io->entry( name );
+			strings.resize( e.arrayLength() );
+			std::string *stringsPtr = &strings[0];
+			io->read( name, stringsPtr, strings.size() );
+		}
+
+		// Appends the locations from the index which are selected, and which are at or below
+		// this location.
+		void appendLocationsBelow( const std::vector<std::string> &locations, const std::vector<bool> &selected, std::vector<Path> &paths ) const
+		{
+			Path thisPath;
+			path( thisPath );
+			std::string prefix;
+			SceneInterface::pathToString( thisPath, prefix );
+			if ( thisPath.size() )
+			{
+				prefix += "/";
+			}
+
+			for ( size_t i = 0; i < locations.size(); ++i )
+			{
+				const std::string &location = locations[i];
+				if ( !selected[i] )
+				{
+					continue;
+				}
+				if ( location.compare( 0, prefix.size(), prefix ) != 0 && location + "/" != prefix )
+				{
+					continue;
+				}
+				paths.push_back( Path() );
+				SceneInterface::stringToPath( location, paths.back() );
+			}
+		}
+
+		void traverseTaggedLocations( const Name &tag, std::vector<Path> &paths ) const
+		{
+			if ( hasTag( tag, SceneInterface::LocalTag ) )
+			{
+				paths.push_back( Path() );
+				path( paths.back() );
+			}
+			if ( !hasTag( tag, SceneInterface::DescendantTag ) )
+			{
+				return;
+			}
+
+			NameList children;
+			childNames( children );
+			for ( NameList::const_iterator it = children.begin(); it != children.end(); ++it )
+			{
+				ConstReaderImplementationPtr c = const_cast<ReaderImplementation *>( this )->child( *it, SceneInterface::ThrowIfMissing );
+				c->traverseTaggedLocations( tag, paths );
+			}
+		}
+
+		// Matches the bounds written to the index by WriterImplementation::flush() : the union of
+		// the bound over all samples, transformed by every sample of each transform above in turn.
+		// The transform samples of the ancestors are passed in ancestorTransforms, innermost last.
+		void traverseLocationsIntersecting( const Imath::Box3d &bound, std::vector< std::vector<Imath::M44d> > &ancestorTransforms, std::vector<Path> &paths ) const
+		{
+			if ( !m_indexedIO->hasEntry( boundEntry ) )
+			{
+				return;
+			}
+
+			ancestorTransforms.push_back( std::vector<M44d>() );
+			std::vector<M44d> &transforms = ancestorTransforms.back();
+			for ( size_t i = 0, n = m_parent ? numTransformSamples() : 0; i < n; ++i )
+			{
+				transforms.push_back( readTransformAsMatrixAtSample( i ) );
+			}
+
+			Box3d worldBound;
+			for ( size_t i = 0, n = numBoundSamples(); i < n; ++i )
+			{
+				worldBound.extendBy( readBoundAtSample( i ) );
+			}
+			worldBound = transformBySamples( worldBound, ancestorTransforms );
+
+			if ( worldBound.intersects( bound ) )
+			{
+				paths.push_back( Path() );
+				path( paths.back() );
+
+				NameList children;
+				childNames( children );
+				for ( NameList::const_iterator it = children.begin(); it != children.end(); ++it )
+				{
+					ConstReaderImplementationPtr c = const_cast<ReaderImplementation *>( this )->child( *it, SceneInterface::ThrowIfMissing );
+					c->traverseLocationsIntersecting( bound, ancestorTransforms, paths );
+				}
+			}
+
+			ancestorTransforms.pop_back();
+		}
+
+		// Fills path with the location in the file the object sample is stored at, following
+		// the reference written when the sample is shared with another scene location.
+		void objectSamplePath( size_t sample, IndexedIO::EntryIDList &path ) const
+		{
+			ConstIndexedIOPtr io = m_indexedIO->subdirectory( objectEntry );
+			const IndexedIO::EntryID entryId = sampleEntry( sample );
+			const IndexedIO::Entry e = io->entry( entryId );
+			if( e.entryType() == IndexedIO::File && e.dataType() == IndexedIO::InternedStringArray )
+			{
+				path.resize( e.arrayLength() );
+				InternedString *p = &(path[0]);
+				io->read( entryId, p, e.arrayLength() );
+				return;
+			}
+			io->path( path );
+			path.push_back( entryId );
+		}
+
+		// Hashes objects by their location in the file, so that scene locations sharing the
+		// same object also share the cached copy.
+		static MurmurHash objectHash( const SimpleCacheKey &key )
+		{
+			const ReaderImplementation *reader = key.first;
+			IndexedIO::EntryIDList path;
+			reader->objectSamplePath( key.second, path );
+			MurmurHash h;
+			h.append( reader->m_sharedData->fileHash );
+			h.append( &path[0], path.size() );
+			return h;
+		}
+
 		static MurmurHash simpleHash( const SimpleCacheKey &key )
 		{
 			const ReaderImplementation *reader = key.first;
@@ -1062,7 +1708,12 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		// static function used by the cache mechanism to actually load the object data from file.
 		static ObjectPtr doReadObjectAtSample( const SimpleCacheKey &key )
 		{
-			return Object::load( key.first->m_indexedIO->subdirectory( objectEntry ), sampleEntry(key.second) );
+			ObjectPtr result = Object::load( key.first->m_indexedIO->subdirectory( objectEntry ), sampleEntry(key.second) );
+			if( Primitive *primitive = runTimeCast<Primitive>( result.get() ) )
+			{
+				PrimitiveCompression::decompress( primitive->variables );
+			}
+			return result;
 		}
 
 		static MurmurHash attributeHash( const AttributeCacheKey &key )
@@ -1115,28 +1766,33 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 		IE_CORE_DECLAREPTR( WriterImplementation )
 
-		WriterImplementation( IndexedIOPtr io, Implementation *parent = 0) : SceneCache::Implementation( io ), m_parent(static_cast< WriterImplementation* >( parent ))
+		WriterImplementation( IndexedIOPtr io, Implementation *parent = 0) : SceneCache::Implementation( io ), m_parent(static_cast< WriterImplementation* >( parent )), m_objectTopologyInitialised( false )
 		{
 			if ( m_parent )
 			{
-				// use same map from the root
+				// use same map and shared data from the root
 				m_sampleTimesMap = m_parent->m_sampleTimesMap;
+				m_sharedData = m_parent->m_sharedData;
 			}
 			else
 			{
 				// only the root instance allocate the map.
 				m_sampleTimesMap = new SampleTimesMap;
+				m_sharedData = new SharedData;
 			}
 		}
 
 		virtual ~WriterImplementation()
 		{
-			// the root location destruction triggers the flush on the file.
+			// the root location destruction triggers the flush on the file, unless close() did it already.
 			if ( !m_parent )
 			{
 				try
 				{
-					flush();
+					if ( m_sampleTimesMap )
+					{
+						flush();
+					}
 				}
 				catch ( Exception &e )
 				{
@@ -1146,6 +1802,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				{
 					msg( Msg::Error, "SceneCache::~SceneCache", "Corrupted file resulted from unknown exception while flushing data." );
 				}
+				delete m_sharedData;
 			}
 		}
 
@@ -1217,6 +1874,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 			size_t sampleIndex = m_transformSampleTimes.size();
 			m_transformSampleTimes.push_back( time );
+			Mutex::scoped_lock lock( m_sharedData->mutex );
 			IndexedIOPtr io = m_indexedIO->subdirectory( transformEntry, IndexedIO::CreateIfMissing );
 			((const Object *)transform)->save( io, sampleEntry(sampleIndex) );
 			m_transformSamples.push_back( transform );
@@ -1242,6 +1900,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 			size_t sampleIndex = sampleTimes.size();
 			sampleTimes.push_back( time );
+			Mutex::scoped_lock lock( m_sharedData->mutex );
 			IndexedIOPtr io = m_indexedIO->subdirectory( attributesEntry, IndexedIO::CreateIfMissing );
 			io = io->subdirectory( name, IndexedIO::CreateIfMissing );
 			attribute->save( io, sampleEntry(sampleIndex) );
@@ -1250,6 +1909,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		void writeLocalTag( const char *tag )
 		{
 			writable();
+			Mutex::scoped_lock lock( m_sharedData->mutex );
 			IndexedIOPtr io = m_indexedIO->subdirectory( localTagsEntry, IndexedIO::CreateIfMissing );
 			// we just create a IndexedIO::Directory
 			io->subdirectory( tag, IndexedIO::CreateIfMissing );
@@ -1262,6 +1922,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				return;
 			}
 			writable();
+			Mutex::scoped_lock lock( m_sharedData->mutex );
 			IndexedIOPtr io(0);
 			if ( tagLocation == SceneInterface::LocalTag )
 			{
@@ -1286,6 +1947,26 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 		}
 
+		void setGeometryCompression( bool enabled )
+		{
+			m_sharedData->compressGeometry = enabled;
+		}
+
+		bool getGeometryCompression() const
+		{
+			return m_sharedData->compressGeometry;
+		}
+
+		void close()
+		{
+			if ( m_parent )
+			{
+				throw Exception( "Call to close is only allowed at the root scene!" );
+			}
+			writable();
+			flush();
+		}
+
 		void writeObject( const Object *object, double time )
 		{
 			writable();
@@ -1299,6 +1980,14 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			{
 				throw Exception( "Call to writeObject at the root scene is not allowed!" );
 			}
+
+			// The object is serialised in the background, so we take a copy to leave the
+			// caller free to modify it as soon as we return. This is cheap because Data is
+			// copy-on-write.
+			ConstObjectPtr objectCopy = object->copy();
+
+			Mutex::scoped_lock lock( m_sharedData->mutex );
+
 			if ( m_objectSampleTimes.size() )
 			{
 				if ( *(m_objectSampleTimes.rbegin()) >= time )
@@ -1308,135 +1997,298 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 			size_t sampleIndex = m_objectSampleTimes.size();
 			m_objectSampleTimes.push_back( time );
-			IndexedIOPtr io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
-			object->save( io, sampleEntry(sampleIndex) );
 			
-			const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( object );
-			if ( renderable )
+			if ( runTimeCast< const VisibleRenderable >( object ) )
 			{
 				if ( !m_objectSamples.size() && m_objectSampleTimes.size() > 1 )
 				{
 					throw Exception( "Either all object samples must have bounds (VisibleRenderable) or none of them!" );
 				}
-				
-				const Primitive *primitive = runTimeCast< const Primitive >( renderable );
-				if ( primitive )
+				// the bound is computed by saveObjectSample().
+				m_objectSamples.push_back( Box3d() );
+			}
+			else
+			{
+				if ( m_objectSamples.size() )
 				{
-					MurmurHash topologyHash;
-					primitive->topologyHash( topologyHash );
-					topologyHash.append( primitive->typeId() );
-					if ( m_objectSamples.empty() )
-					{
-						m_animatedObjectTopology = AnimatedHashTest( topologyHash, false );
-					}
-					
-					if ( topologyHash != m_animatedObjectTopology.first )
-					{
-						m_animatedObjectTopology.second = true;
-					}
-					
-					for ( PrimitiveVariableMap::const_iterator it = primitive->variables.begin(); it != primitive->variables.end(); ++it )
-					{
-						Name primVarName = Name( it->first );
-						
-						MurmurHash hash;
-						it->second.data->hash( hash );
-						hash.append( it->second.interpolation );
-						
-						AnimatedPrimVarMap::iterator pIt = m_animatedObjectPrimVars.find( primVarName );
-						if ( pIt == m_animatedObjectPrimVars.end() )
-						{
-							m_animatedObjectPrimVars.insert( AnimatedPrimVarMap::value_type( primVarName, AnimatedHashTest( hash, false ) ) );
-						}
-						else if ( hash != pIt->second.first )
-						{
-							pIt->second.second = true;
-						}
-					}
+					throw Exception( "Either all object samples must have bounds (VisibleRenderable) or none of them!" );
 				}
-				
-				Box3f bf = renderable->bound();
-				Box3d bd(
-					V3d( bf.min.x, bf.min.y, bf.min.z ),
-					V3f( bf.max.x, bf.max.y, bf.max.z )
-				);
-				m_objectSamples.push_back( bd );
 			}
-			else
+
+			if ( sampleIndex == 0 )
+			{
+				// save the type of object as a tag
+				char objectTypeTag[128];
+				strcpy( objectTypeTag, "ObjectType:");
+				strcpy( &objectTypeTag[11], object->typeName() );
+				writeLocalTag( objectTypeTag );
+			}
+
+			// create the object location now, so that the background task doesn't
+			// modify this location's directory while other threads may be querying it.
+			m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
+
+			m_sharedData->tasks.run( ObjectSampleWriter( this, objectCopy, sampleIndex ) );
+		}
+
+		WriterImplementationPtr child( const Name &name, MissingBehaviour missingBehaviour )
+		{
+			if ( missingBehaviour == SceneInterface::CreateIfMissing )
+			{
+				writable();
+			}
+
+			Mutex::scoped_lock lock( m_sharedData->mutex );
+
+			std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator it = m_children.find( name );
+			if ( it != m_children.end() )
+			{
+				return it->second;
+			}
+
+			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, (IndexedIO::MissingBehaviour)missingBehaviour );
+			if ( !children )
+			{
+				return 0;
+			}
+			IndexedIOPtr childIO = children->subdirectory( name, (IndexedIO::MissingBehaviour)missingBehaviour );
+			if ( !childIO )
+			{
+				return 0;
+			}
+			WriterImplementationPtr result = new WriterImplementation( childIO, this );
+			this->m_children[ name ] = result;
+			return result;
+		}
+
+		SceneCache::ImplementationPtr createChild( const SceneCache::Name &name )
+		{
+			writable();
+			Mutex::scoped_lock lock( m_sharedData->mutex );
+			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, IndexedIO::CreateIfMissing );
+			if ( children->hasEntry( name ) )
+			{
+				throw Exception( "Child already exists!" );
+			}
+			IndexedIOPtr childIO = children->createSubdirectory( name );
+			WriterImplementationPtr result = new WriterImplementation( childIO, this );
+			this->m_children[ name ] = result;
+			return result;
+		}
+
+		static WriterImplementation *writer( Implementation *impl, bool throwException = true )
+		{
+			WriterImplementation *writer = dynamic_cast< WriterImplementation* >( impl );
+			if ( throwException && !writer )
+			{
+				throw Exception( "Function not supported when loading a scene file." );
+			}
+			return writer;
+		}
+
+	private :
+
+		typedef std::vector< Imath::Box3d > BoxSamples;
+		typedef ConstDataPtr TransformSample;
+		typedef std::vector< TransformSample > TransformSamples;
+
+		typedef tbb::recursive_mutex Mutex;
+
+		// Data shared by all the locations of a file being written, owned by the root location.
+		// Maps from the hash of each object saved to the file to its location.
+		typedef std::map< MurmurHash, IndexedIO::EntryIDList > SavedObjectMap;
+		typedef std::map< SceneCache::Name, std::vector<std::string> > TaggedLocations;
+
+		struct SharedData
+		{
+			SharedData() : compressGeometry( false )
+			{
+				taskFailed = false;
+			}
+
+			// Serialises access to the IndexedIO, which isn't thread-safe for writing,
+			// and to the state modified by the object writing tasks.
+			Mutex mutex;
+			// Tasks serialising objects in the background. They're all waited for before flushing.
+			tbb::task_group tasks;
+			// The first error from the tasks, which is thrown by all subsequent writes and
+			// by flush(). taskError is only accessed under the mutex.
+			tbb::atomic<bool> taskFailed;
+			std::string taskError;
+			// Whether Primitives are saved using PrimitiveCompression.
+			bool compressGeometry;
+			// Every object saved to the file, so that identical objects can
+			// be stored as references to the first.
+			SavedObjectMap savedObjects;
+			// The index written to the root when flushing, listing the locations
+			// with each local tag, and the bound of each location over all time
+			// in the space of the root, stored as consecutive min and max values.
+			TaggedLocations taggedLocations;
+			std::vector<std::string> boundLocations;
+			std::vector<double> locationBounds;
+		};
+
+		// Task which saves an object sample in the background, and records the information
+		// required to compute the bounds and animated attributes when flushing.
+		struct ObjectSampleWriter
+		{
+			ObjectSampleWriter( WriterImplementation *location, ConstObjectPtr object, size_t sampleIndex )
+				:	m_location( location ), m_object( object ), m_sampleIndex( sampleIndex )
+			{
+			}
+
+			void operator()() const
+			{
+				try
+				{
+					m_location->saveObjectSample( m_object.get(), m_sampleIndex );
+				}
+				catch( const std::exception &e )
+				{
+					m_location->taskFailed( e.what() );
+				}
+				catch( ... )
+				{
+					m_location->taskFailed( "Unknown error" );
+				}
+			}
+
+			WriterImplementationPtr m_location;
+			ConstObjectPtr m_object;
+			size_t m_sampleIndex;
+		};
+
+		void taskFailed( const std::string &error )
+		{
+			Mutex::scoped_lock lock( m_sharedData->mutex );
+			if ( m_sharedData->taskFailed )
+			{
+				return;
+			}
+			std::string p;
+			SceneInterface::Path pathVector;
+			path( pathVector );
+			SceneInterface::pathToString( pathVector, p );
+			m_sharedData->taskError = ( boost::format( "Error saving object at \"%s\" : %s" ) % p % error ).str();
+			m_sharedData->taskFailed = true;
+		}
+
+		void rethrowTaskError() const
+		{
+			if ( m_sharedData->taskFailed )
+			{
+				Mutex::scoped_lock lock( m_sharedData->mutex );
+				throw Exception( m_sharedData->taskError );
+			}
+		}
+
+		void saveObjectSample( const Object *object, size_t sampleIndex )
+		{
+			// hash and bound the object before taking the lock,
+			// so that multiple objects can be processed in parallel.
+			const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( object );
+			const Primitive *primitive = runTimeCast< const Primitive >( renderable );
+
+			MurmurHash objectHash;
+			object->hash( objectHash );
+
+			MurmurHash topologyHash;
+			std::vector< std::pair< Name, MurmurHash > > primVarHashes;
+			if ( primitive )
 			{
-				if ( m_objectSamples.size() )
+				primitive->topologyHash( topologyHash );
+				topologyHash.append( primitive->typeId() );
+
+				primVarHashes.reserve( primitive->variables.size() );
+				for ( PrimitiveVariableMap::const_iterator it = primitive->variables.begin(); it != primitive->variables.end(); ++it )
 				{
-					throw Exception( "Either all object samples must have bounds (VisibleRenderable) or none of them!" );
+					MurmurHash hash;
+					it->second.data->hash( hash );
+					hash.append( it->second.interpolation );
+					primVarHashes.push_back( std::pair< Name, MurmurHash >( Name( it->first ), hash ) );
 				}
 			}
 
-			if ( sampleIndex == 0 )
+			Box3d bd;
+			if ( renderable )
 			{
-				// save the type of object as a tag
-				char objectTypeTag[128];
-				strcpy( objectTypeTag, "ObjectType:");
-				strcpy( &objectTypeTag[11], object->typeName() );
-				writeLocalTag( objectTypeTag );
+				Box3f bf = renderable->bound();
+				bd = Box3d(
+					V3d( bf.min.x, bf.min.y, bf.min.z ),
+					V3f( bf.max.x, bf.max.y, bf.max.z )
+				);
 			}
-		}
 
-		WriterImplementationPtr child( const Name &name, MissingBehaviour missingBehaviour )
-		{
-			if ( missingBehaviour == SceneInterface::CreateIfMissing )
+			bool alreadySaved = false;
 			{
-				writable();
+				Mutex::scoped_lock lock( m_sharedData->mutex );
+				alreadySaved = m_sharedData->savedObjects.find( objectHash ) != m_sharedData->savedObjects.end();
 			}
 
-			std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator it = m_children.find( name );
-			if ( it != m_children.end() )
+			// the hashes and bound above are from the uncompressed primitive,
+			// so that they match those computed when reading.
+			ConstObjectPtr compressed;
+			if ( primitive && !alreadySaved && m_sharedData->compressGeometry )
 			{
-				return it->second;
+				compressed = PrimitiveCompression::compress( primitive );
+				object = compressed.get();
 			}
 
-			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, (IndexedIO::MissingBehaviour)missingBehaviour );
-			if ( !children )
+			Mutex::scoped_lock lock( m_sharedData->mutex );
+
+			IndexedIOPtr io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
+			SavedObjectMap::const_iterator savedIt = m_sharedData->savedObjects.find( objectHash );
+			if ( savedIt != m_sharedData->savedObjects.end() )
 			{
-				return 0;
+				// The object is identical to one already saved, either as another sample
+				// of this location or anywhere else in the file, so we store a reference
+				// to it rather than serialising it again. Object::load() and
+				// Primitive::loadPrimitiveVariables() both resolve such references.
+				io->write( sampleEntry(sampleIndex), &(savedIt->second[0]), savedIt->second.size() );
 			}
-			IndexedIOPtr childIO = children->subdirectory( name, (IndexedIO::MissingBehaviour)missingBehaviour );
-			if ( !childIO )
+			else
 			{
-				return 0;
+				object->save( io, sampleEntry(sampleIndex) );
+				IndexedIO::EntryIDList &savedPath = m_sharedData->savedObjects[objectHash];
+				io->path( savedPath );
+				savedPath.push_back( sampleEntry(sampleIndex) );
 			}
-			WriterImplementationPtr result = new WriterImplementation( childIO, this );
-			this->m_children[ name ] = result;
-			return result;
-		}
 
-		SceneCache::ImplementationPtr createChild( const SceneCache::Name &name )
-		{
-			writable();
-			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, IndexedIO::CreateIfMissing );
-			if ( children->hasEntry( name ) )
+			if ( renderable )
 			{
-				throw Exception( "Child already exists!" );
+				m_objectSamples[sampleIndex] = bd;
 			}
-			IndexedIOPtr childIO = children->createSubdirectory( name );
-			WriterImplementationPtr result = new WriterImplementation( childIO, this );
-			this->m_children[ name ] = result;
-			return result;
-		}
 
-		static WriterImplementation *writer( Implementation *impl, bool throwException = true )
-		{
-			WriterImplementation *writer = dynamic_cast< WriterImplementation* >( impl );
-			if ( throwException && !writer )
+			if ( primitive )
 			{
-				throw Exception( "Function not supported when loading a scene file." );
-			}
-			return writer;
-		}
+				// Samples may be processed in any order, but a topology or primitive variable
+				// is animated if any sample differs from the first one processed, regardless
+				// of which one that is.
+				if ( !m_objectTopologyInitialised )
+				{
+					m_animatedObjectTopology = AnimatedHashTest( topologyHash, false );
+					m_objectTopologyInitialised = true;
+				}
 
-	private :
+				if ( topologyHash != m_animatedObjectTopology.first )
+				{
+					m_animatedObjectTopology.second = true;
+				}
 
-		typedef std::vector< Imath::Box3d > BoxSamples;
-		typedef ConstDataPtr TransformSample;
-		typedef std::vector< TransformSample > TransformSamples;
+				for ( std::vector< std::pair< Name, MurmurHash > >::const_iterator it = primVarHashes.begin(); it != primVarHashes.end(); ++it )
+				{
+					AnimatedPrimVarMap::iterator pIt = m_animatedObjectPrimVars.find( it->first );
+					if ( pIt == m_animatedObjectPrimVars.end() )
+					{
+						m_animatedObjectPrimVars.insert( AnimatedPrimVarMap::value_type( it->first, AnimatedHashTest( it->second, false ) ) );
+					}
+					else if ( it->second != pIt->second.first )
+					{
+						pIt->second.second = true;
+					}
+				}
+			}
+		}
 
 		IndexedIOPtr globalSampleTimes()
 		{
@@ -1453,6 +2305,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			{
 				throw Exception( "This scene has already been flushed to disk. You can't make further changes to it." );
 			}
+			rethrowTaskError();
 		}
 
 		// Function to store intelligently the given sample times in the file location.
@@ -1602,11 +2455,23 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		// It triggers flush recursivelly on all the child locations.
 		// It also sets m_sampleTimesMap to NULL which prevents further modification on this and all child scene interface objects through their call to writable().
 		// Responsible for writing missing data such as all the sample 
-		// times from object,transform,attributes and bounds. And also computes the 
-		// animated bounding boxes in case they were not explicitly writen.
+		// times from object,transform,attributes and bounds. The animated bounding
+		// boxes, in case they were not explicitly writen, are computed beforehand
+		// by computeBounds().
 		//
 		void flush()
 		{
+			if ( !m_parent && m_sampleTimesMap )
+			{
+				// wait for all the objects to be written. if any of them failed, the file
+				// can't be completed, so we throw rather than writing the index.
+				m_sharedData->tasks.wait();
+				rethrowTaskError();
+				// the object bounds are all known now, so we can compute the bounds for the whole
+				// hierarchy up front, leaving only the writing to the recursion below.
+				computeBounds();
+			}
+
 			if ( m_parent )
 			{
 				NameList tags;
@@ -1667,6 +2532,67 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				storeSampleTimes( m_objectSampleTimes, io );				
 			}
 			
+			if ( m_boundSampleTimes.size() )
+			{
+				// save the bound sample times
+				io = m_indexedIO->subdirectory( boundEntry, IndexedIO::CreateIfMissing );
+				storeSampleTimes( m_boundSampleTimes, io );
+
+				// store computed bounds in file
+				uint64_t sampleIndex = 0;
+				for ( BoxSamples::const_iterator bit = m_boundSamples.begin(); bit != m_boundSamples.end(); bit++, sampleIndex++ )
+				{
+					io->write( sampleEntry(sampleIndex), bit->min.getValue(), 6 );
+				}
+			}
+
+			if ( m_parent )
+			{
+				NameList tags;
+				// propagate tags to parent
+				readTags( tags, SceneInterface::LocalTag | SceneInterface::DescendantTag );
+				m_parent->writeTags( tags, SceneInterface::DescendantTag );
+			}
+
+			// deallocate children since we now computed everything from them anyways...
+			m_children.clear();
+
+			if ( m_sampleTimesMap )
+			{
+				addToIndex();
+			}
+
+			if ( !m_parent && m_sampleTimesMap )
+			{
+				// we are at the root...
+				writeIndex();
+				// deallocate samples map stored in the root object.
+				delete m_sampleTimesMap;
+				// and make sure the caches do not contain this file, forcing it to reload it.
+				if ( m_indexedIO->typeId() == FileIndexedIOTypeId )
+				{
+					const std::string &fileName = static_cast< FileIndexedIO * >( m_indexedIO.get() )->fileName();
+					ReaderImplementation::fileWritten( fileName );
+					SharedSceneInterfaces::erase( fileName );
+				}
+			}
+			m_sampleTimesMap = 0;
+		}
+
+		// Computes the bounds of this location and all its descendants, ready for flush() to write them.
+		// Missing bounds are the union of the object bound and the transformed child bounds, merged
+		// over all their sample times. Each location only modifies its own bounds and reads those of
+		// its children, so sibling subtrees are computed in parallel, bottom up.
+		void computeBounds()
+		{
+			std::vector< WriterImplementation * > children;
+			children.reserve( m_children.size() );
+			for ( std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator cit = m_children.begin(); cit != m_children.end(); cit++ )
+			{
+				children.push_back( cit->second.get() );
+			}
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, children.size() ), BoundsComputer( children ) );
+
 			// We have to compute the bounding box over time for the object and each child.
 			for ( std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator cit = m_children.begin(); cit != m_children.end(); cit++ )
 			{
@@ -1821,45 +2747,97 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				// union all the bounding box samples from the child and also from the optional object stored in this location
 				accumulateBoxSamples( m_objectSampleTimes, m_objectSamples );
 			}
-			
 
-			if ( m_boundSampleTimes.size() )
+			// and finally the bound over all time in the space of the root, for addToIndex().
+			m_indexBound = Box3d();
+			if ( m_boundSamples.empty() )
 			{
-				// save the bound sample times
-				io = m_indexedIO->subdirectory( boundEntry, IndexedIO::CreateIfMissing );
-				storeSampleTimes( m_boundSampleTimes, io );
+				return;
+			}
 
-				// store computed bounds in file
-				uint64_t sampleIndex = 0;
-				for ( BoxSamples::const_iterator bit = m_boundSamples.begin(); bit != m_boundSamples.end(); bit++, sampleIndex++ )
+			for ( BoxSamples::const_iterator it = m_boundSamples.begin(); it != m_boundSamples.end(); ++it )
+			{
+				m_indexBound.extendBy( *it );
+			}
+
+			std::vector< std::vector<M44d> > ancestorTransforms;
+			for ( const WriterImplementation *location = this; location->m_parent; location = location->m_parent )
+			{
+				ancestorTransforms.insert( ancestorTransforms.begin(), std::vector<M44d>() );
+				for ( TransformSamples::const_iterator it = location->m_transformSamples.begin(); it != location->m_transformSamples.end(); ++it )
 				{
-					io->write( sampleEntry(sampleIndex), bit->min.getValue(), 6 );
+					ancestorTransforms.front().push_back( dataToMatrix( it->get() ) );
 				}
 			}
+			m_indexBound = transformBySamples( m_indexBound, ancestorTransforms );
+		}
 
-			if ( m_parent )
+		// Functor for computing the bounds of a range of child locations in parallel.
+		struct BoundsComputer
+		{
+			BoundsComputer( const std::vector< WriterImplementation * > &locations )
+				:	m_locations( locations )
 			{
-				NameList tags;
-				// propagate tags to parent
-				readTags( tags, SceneInterface::LocalTag | SceneInterface::DescendantTag );
-				m_parent->writeTags( tags, SceneInterface::DescendantTag );
 			}
 
-			// deallocate children since we now computed everything from them anyways...
-			m_children.clear();
-
-			if ( !m_parent && m_sampleTimesMap )
+			void operator()( const tbb::blocked_range<size_t> &range ) const
 			{
-				// we are at the root...
-				// deallocate samples map stored in the root object.
-				delete m_sampleTimesMap;
-				// and make sure the cache does not contain this file, forcing it to reload it.
-				if ( m_indexedIO->typeId() == FileIndexedIOTypeId )
+				for ( size_t i = range.begin(); i != range.end(); ++i )
 				{
-					SharedSceneInterfaces::erase( static_cast< FileIndexedIO * >( m_indexedIO.get() )->fileName() );
+					m_locations[i]->computeBounds();
 				}
 			}
-			m_sampleTimesMap = 0;
+
+			const std::vector< WriterImplementation * > &m_locations;
+		};
+
+		// Records the local tags and the bound of this location in the index written at the root.
+		void addToIndex()
+		{
+			std::string locationPath;
+			Path p;
+			path( p );
+			SceneInterface::pathToString( p, locationPath );
+
+			NameList tags;
+			readTags( tags, SceneInterface::LocalTag );
+			for ( NameList::const_iterator it = tags.begin(); it != tags.end(); ++it )
+			{
+				m_sharedData->taggedLocations[*it].push_back( locationPath );
+			}
+
+			if ( m_boundSamples.empty() )
+			{
+				return;
+			}
+
+			// computed by computeBounds().
+			const Box3d &bound = m_indexBound;
+			m_sharedData->boundLocations.push_back( locationPath );
+			m_sharedData->locationBounds.insert( m_sharedData->locationBounds.end(), bound.min.getValue(), bound.min.getValue() + 3 );
+			m_sharedData->locationBounds.insert( m_sharedData->locationBounds.end(), bound.max.getValue(), bound.max.getValue() + 3 );
+		}
+
+		// Writes the index of tagged locations and location bounds, which allows
+		// ReaderImplementation to answer queries without traversing the hierarchy.
+		void writeIndex()
+		{
+			IndexedIOPtr index = m_indexedIO->subdirectory( indexEntry, IndexedIO::CreateIfMissing );
+
+			IndexedIOPtr tagsIO = index->subdirectory( tagsEntry, IndexedIO::CreateIfMissing );
+			for ( TaggedLocations::const_iterator it = m_sharedData->taggedLocations.begin(); it != m_sharedData->taggedLocations.end(); ++it )
+			{
+				tagsIO->write( it->first, &(it->second[0]), it->second.size() );
+			}
+
+			IndexedIOPtr boundsIO = index->subdirectory( boundsEntry, IndexedIO::CreateIfMissing );
+			const std::vector<std::string> &locations = m_sharedData->boundLocations;
+			if ( locations.size() )
+			{
+				const std::vector<double> &bounds = m_sharedData->locationBounds;
+				boundsIO->write( pathsEntry, &locations[0], locations.size() );
+				boundsIO->write( boundsEntry, &bounds[0], bounds.size() );
+			}
 		}
 
 		/// This functions transforms the bounding boxes with the animated transforms and also scales the bounding boxes in a way that it
@@ -1991,6 +2969,8 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		WriterImplementation* m_parent;
 		std::map< SceneCache::Name, WriterImplementationPtr > m_children;
 
+		SharedData *m_sharedData;
+
 		typedef std::map< SampleTimes, uint64_t > SampleTimesMap;
 		typedef std::map< SceneCache::Name, SampleTimes > AttributeSamplesMap;
 
@@ -2005,10 +2985,13 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		BoxSamples m_objectSamples;
 		// overwriting bounding boxes (or used during flush to compute the final bounding boxes).
 		BoxSamples m_boundSamples;
+		// the bound over all time in the space of the root, computed for the index before flushing.
+		Imath::Box3d m_indexBound;
 		
 		typedef std::pair< MurmurHash, bool> AnimatedHashTest;
 		typedef std::map< SceneCache::Name, AnimatedHashTest > AnimatedPrimVarMap;
 		
+		bool m_objectTopologyInitialised;
 		AnimatedHashTest m_animatedObjectTopology;
 		AnimatedPrimVarMap m_animatedObjectPrimVars;
 };
@@ -2133,12 +3116,14 @@ double SceneCache::boundSampleInterval( double time, size_t &floorIndex, size_t
 
 Imath::Box3d SceneCache::readBoundAtSample( size_t sampleIndex ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readBoundAtSample" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readBoundAtSample( sampleIndex );
 }
 
 Imath::Box3d SceneCache::readBound( double time ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readBound" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readBound( time );
 }
@@ -2169,24 +3154,28 @@ double SceneCache::transformSampleInterval( double time, size_t &floorIndex, siz
 
 ConstDataPtr SceneCache::readTransformAtSample( size_t sampleIndex ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readTransformAtSample" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readTransformAtSample( sampleIndex );
 }
 
 Imath::M44d SceneCache::readTransformAsMatrixAtSample( size_t sampleIndex ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readTransformAsMatrixAtSample" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readTransformAsMatrixAtSample( sampleIndex );
 }
 
 ConstDataPtr SceneCache::readTransform( double time ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readTransform" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readTransform( time );
 }
 
 Imath::M44d SceneCache::readTransformAsMatrix( double time ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readTransformAsMatrix" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readTransformAsMatrix( time );
 }
@@ -2227,12 +3216,14 @@ double SceneCache::attributeSampleInterval( const Name &name, double time, size_
 
 ConstObjectPtr SceneCache::readAttributeAtSample( const Name &name, size_t sampleIndex ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readAttributeAtSample" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readAttributeAtSample( name, sampleIndex );
 }
 
 ConstObjectPtr SceneCache::readAttribute( const Name &name, double time ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readAttribute" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readAttribute( name, time );
 }
@@ -2302,22 +3293,40 @@ double SceneCache::objectSampleInterval( double time, size_t &floorIndex, size_t
 
 ConstObjectPtr SceneCache::readObjectAtSample( size_t sampleIndex ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readObjectAtSample" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readObjectAtSample( sampleIndex );
 }
 
 ConstObjectPtr SceneCache::readObject( double time ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readObject" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readObject( time );
 }
 
 PrimitiveVariableMap SceneCache::readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::readObjectPrimitiveVariables" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	return reader->readObjectPrimitiveVariables( primVarNames, time );
 }
 
+PrimitiveVariableMap SceneCache::readObjectPrimitiveVariableRange( const std::vector<InternedString> &primVarNames, double time, size_t begin, size_t end ) const
+{
+	IECORE_PROFILE_ZONE( "SceneCache::readObjectPrimitiveVariableRange" );
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	IndexedIO::EntryIDList unsupportedNames;
+	PrimitiveVariableMap result = reader->readObjectPrimitiveVariableRange( primVarNames, time, begin, end, unsupportedNames );
+	if ( !unsupportedNames.empty() )
+	{
+		// fall back to reading these whole and copying out the range
+		PrimitiveVariableMap remaining = SceneInterface::readObjectPrimitiveVariableRange( unsupportedNames, time, begin, end );
+		result.insert( remaining.begin(), remaining.end() );
+	}
+	return result;
+}
+
 void SceneCache::writeObject( const Object *object, double time )
 {
 	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
@@ -2353,6 +3362,7 @@ SceneInterfacePtr SceneCache::child( const Name &name, SceneCache::MissingBehavi
 
 ConstSceneInterfacePtr SceneCache::child( const Name &name, SceneCache::MissingBehaviour missingBehaviour ) const
 {
+	IECORE_PROFILE_ZONE( "SceneCache::child" );
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
 	ImplementationPtr impl = reader->child( name, missingBehaviour );
 	if ( !impl )
@@ -2399,6 +3409,113 @@ ConstSceneInterfacePtr SceneCache::scene( const Path &path, SceneCache::MissingB
 	return duplicate( impl );
 }
 
+void SceneCache::readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const
+{
+	IECORE_PROFILE_ZONE( "SceneCache::readBounds" );
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->readBounds( paths, time, bounds );
+}
+
+void SceneCache::readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const
+{
+	IECORE_PROFILE_ZONE( "SceneCache::readTransformsAsMatrices" );
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->readTransformsAsMatrices( paths, time, transforms );
+}
+
+void SceneCache::readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const
+{
+	IECORE_PROFILE_ZONE( "SceneCache::readObjects" );
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->readObjects( paths, time, objects );
+}
+
+void SceneCache::prefetch( const std::vector<Path> &paths, double startTime, double endTime ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->prefetch( paths, startTime, endTime );
+}
+
+void SceneCache::traverse( Visitor &visitor ) const
+{
+	IECORE_PROFILE_ZONE( "SceneCache::traverse" );
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+
+	Path path;
+	reader->path( path );
+	if ( !visitor.visit( this, path ) )
+	{
+		return;
+	}
+
+	// Rather than creating a SceneCache for every location, we create one per level of
+	// the hierarchy and point it at each location in turn. The frames beyond the current
+	// depth are kept, so their name lists and cursors are reused by later branches.
+	std::vector<ReaderImplementation::TraversalFrame> frames( 1 );
+	frames[0].location = reader;
+	frames[0].children = reader->childrenDirectory( frames[0].childNames );
+
+	size_t depth = 0;
+	while ( true )
+	{
+		ReaderImplementation::TraversalFrame &frame = frames[depth];
+		if ( frame.nextChild == frame.childNames.size() )
+		{
+			if ( !depth )
+			{
+				break;
+			}
+			depth--;
+			path.pop_back();
+			continue;
+		}
+
+		const Name childName = frame.childNames[frame.nextChild++];
+		ReaderImplementationPtr child = new ReaderImplementation( frame.children->subdirectory( childName ), frame.location.get() );
+
+		if ( frames.size() == depth + 1 )
+		{
+			frames.push_back( ReaderImplementation::TraversalFrame() );
+		}
+
+		ReaderImplementation::TraversalFrame &childFrame = frames[depth + 1];
+		if ( childFrame.cursor )
+		{
+			childFrame.cursor->m_implementation = child;
+		}
+		else
+		{
+			ImplementationPtr impl = child;
+			childFrame.cursor = duplicate( impl );
+		}
+
+		path.push_back( childName );
+		if ( visitor.visit( childFrame.cursor.get(), path ) )
+		{
+			childFrame.location = child;
+			childFrame.children = child->childrenDirectory( childFrame.childNames );
+			childFrame.nextChild = 0;
+			depth++;
+		}
+		else
+		{
+			path.pop_back();
+		}
+	}
+}
+
+void SceneCache::taggedLocations( const Name &tag, std::vector<Path> &paths ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->taggedLocations( tag, paths );
+}
+
+void SceneCache::locationsIntersecting( const Imath::Box3d &bound, std::vector<Path> &paths ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->locationsIntersecting( bound, paths );
+}
+
 void SceneCache::hash( HashType hashType, double time, MurmurHash &h ) const
 {
 	SceneInterface::hash( hashType, time, h );
@@ -2412,7 +3529,45 @@ SceneCachePtr SceneCache::duplicate( ImplementationPtr& impl ) const
 	return new SceneCache( impl );
 }
 
+ObjectPool *SceneCache::cacheObjectPool()
+{
+	return ReaderImplementation::caches().objectPool.get();
+}
+
+SceneCache::CacheStatistics SceneCache::cacheStatistics()
+{
+	ReaderImplementation::Caches &caches = ReaderImplementation::caches();
+	CacheStatistics result;
+	result.hits = caches.hits;
+	result.misses = caches.misses;
+	result.memoryUsage = caches.objectPool->memoryUsage();
+	return result;
+}
+
+void SceneCache::clearCache()
+{
+	ReaderImplementation::caches().clear();
+}
+
 bool SceneCache::readOnly() const
 {
 	return dynamic_cast< const ReaderImplementation* >( m_implementation.get() ) != NULL;
 }
+
+void SceneCache::setGeometryCompression( bool enabled )
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+	writer->setGeometryCompression( enabled );
+}
+
+bool SceneCache::getGeometryCompression() const
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+	return writer->getGeometryCompression();
+}
+
+void SceneCache::close()
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+	writer->close();
+}
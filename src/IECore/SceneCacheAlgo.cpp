@@ -0,0 +1,468 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "boost/lexical_cast.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_scheduler_init.h"
+#include "tbb/tick_count.h"
+
+#include "IECore/SceneCacheAlgo.h"
+#include "IECore/SceneCache.h"
+#include "IECore/StreamIndexedIO.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/Exception.h"
+
+using namespace IECore;
+
+//////////////////////////////////////////////////////////////////////////
+// Storage statistics
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+InternedString g_rootEntry( "root" );
+InternedString g_childrenEntry( "children" );
+InternedString g_attributesEntry( "attributes" );
+InternedString g_boundEntry( "bound" );
+InternedString g_transformEntry( "transform" );
+InternedString g_objectEntry( "object" );
+
+struct EntryStatistics
+{
+	EntryStatistics()
+		:	samples( 0 ), entries( 0 ), storedSize( 0 ), dataSize( 0 )
+	{
+	}
+
+	void add( const EntryStatistics &other )
+	{
+		samples += other.samples;
+		entries += other.entries;
+		storedSize += other.storedSize;
+		dataSize += other.dataSize;
+	}
+
+	CompoundDataPtr data() const
+	{
+		CompoundDataPtr result = new CompoundData;
+		result->writable()["samples"] = new UInt64Data( samples );
+		result->writable()["entries"] = new UInt64Data( entries );
+		result->writable()["storedSize"] = new UInt64Data( storedSize );
+		result->writable()["dataSize"] = new UInt64Data( dataSize );
+		return result;
+	}
+
+	uint64_t samples;
+	uint64_t entries;
+	uint64_t storedSize;
+	uint64_t dataSize;
+};
+
+typedef std::map<std::string, EntryStatistics> EntryStatisticsMap;
+
+CompoundDataPtr statisticsData( const EntryStatisticsMap &statistics )
+{
+	CompoundDataPtr result = new CompoundData;
+	EntryStatistics total;
+	for( EntryStatisticsMap::const_iterator it = statistics.begin(); it != statistics.end(); ++it )
+	{
+		result->writable()[it->first] = it->second.data();
+		total.storedSize += it->second.storedSize;
+		total.dataSize += it->second.dataSize;
+	}
+	result->writable()["storedSize"] = new UInt64Data( total.storedSize );
+	result->writable()["dataSize"] = new UInt64Data( total.dataSize );
+	return result;
+}
+
+ConstStreamIndexedIOPtr streamSubdirectory( const StreamIndexedIO *io, const IndexedIO::EntryID &name, IndexedIO::MissingBehaviour missingBehaviour = IndexedIO::ThrowIfMissing )
+{
+	return boost::static_pointer_cast<const StreamIndexedIO>( io->subdirectory( name, missingBehaviour ) );
+}
+
+class StorageAccumulator
+{
+
+	public :
+
+		StorageAccumulator( bool perLocation )
+			:	m_locations( perLocation ? new CompoundData : 0 ), m_numLocations( 0 ), m_maxDepth( 0 ), m_uniqueStoredSize( 0 )
+		{
+		}
+
+		void accumulateFile( const StreamIndexedIO *io )
+		{
+			IndexedIO::EntryIDList names;
+			io->entryIds( names );
+			for( IndexedIO::EntryIDList::const_iterator it = names.begin(); it != names.end(); ++it )
+			{
+				if( *it != g_rootEntry )
+				{
+					accumulateEntry( io, *it, m_totals[it->value()] );
+				}
+			}
+		}
+
+		void accumulateLocation( const SceneCache *scene, const StreamIndexedIO *io, size_t depth )
+		{
+			m_numLocations++;
+			m_maxDepth = std::max<uint64_t>( m_maxDepth, depth );
+
+			EntryStatisticsMap statistics;
+			IndexedIO::EntryIDList names;
+			io->entryIds( names );
+			for( IndexedIO::EntryIDList::const_iterator it = names.begin(); it != names.end(); ++it )
+			{
+				if( *it == g_childrenEntry )
+				{
+					continue;
+				}
+				else if( *it == g_attributesEntry )
+				{
+					ConstStreamIndexedIOPtr attributesIO = streamSubdirectory( io, *it );
+					IndexedIO::EntryIDList attributeNames;
+					attributesIO->entryIds( attributeNames );
+					for( IndexedIO::EntryIDList::const_iterator aIt = attributeNames.begin(); aIt != attributeNames.end(); ++aIt )
+					{
+						EntryStatistics &s = statistics["attribute:" + aIt->value()];
+						s.samples = scene->numAttributeSamples( *aIt );
+						accumulateEntry( attributesIO.get(), *aIt, s );
+					}
+					continue;
+				}
+
+				EntryStatistics &s = statistics[it->value()];
+				if( *it == g_boundEntry )
+				{
+					s.samples = scene->numBoundSamples();
+				}
+				else if( *it == g_transformEntry )
+				{
+					s.samples = scene->numTransformSamples();
+				}
+				else if( *it == g_objectEntry )
+				{
+					s.samples = scene->numObjectSamples();
+				}
+				accumulateEntry( io, *it, s );
+			}
+
+			for( EntryStatisticsMap::const_iterator it = statistics.begin(); it != statistics.end(); ++it )
+			{
+				m_totals[it->first].add( it->second );
+			}
+
+			if( m_locations )
+			{
+				SceneInterface::Path path;
+				scene->path( path );
+				std::string pathString;
+				SceneInterface::pathToString( path, pathString );
+				m_locations->writable()[pathString] = statisticsData( statistics );
+			}
+
+			SceneInterface::NameList childNames;
+			scene->childNames( childNames );
+			if( childNames.empty() )
+			{
+				return;
+			}
+
+			ConstStreamIndexedIOPtr childrenIO = streamSubdirectory( io, g_childrenEntry );
+			for( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+			{
+				ConstSceneCachePtr child = boost::static_pointer_cast<const SceneCache>( scene->child( *it ) );
+				accumulateLocation( child.get(), streamSubdirectory( childrenIO.get(), *it ).get(), depth + 1 );
+			}
+		}
+
+		CompoundDataPtr result( const StreamIndexedIO *io ) const
+		{
+			const StreamIndexedIO::FileStorage fileStorage = io->fileStorage();
+			CompoundDataPtr file = new CompoundData;
+			file->writable()["version"] = new IntData( fileStorage.version );
+			file->writable()["fileSize"] = new UInt64Data( fileStorage.fileSize );
+			file->writable()["indexSize"] = new UInt64Data( fileStorage.indexSize );
+			file->writable()["numStrings"] = new UInt64Data( fileStorage.numStrings );
+			file->writable()["stringTableSize"] = new UInt64Data( fileStorage.stringTableSize );
+
+			CompoundDataPtr totals = statisticsData( m_totals );
+			totals->writable()["locations"] = new UInt64Data( m_numLocations );
+			totals->writable()["maxDepth"] = new UInt64Data( m_maxDepth );
+			totals->writable()["uniqueStoredSize"] = new UInt64Data( m_uniqueStoredSize );
+
+			CompoundDataPtr result = new CompoundData;
+			result->writable()["file"] = file;
+			result->writable()["totals"] = totals;
+			if( m_locations )
+			{
+				result->writable()["locations"] = m_locations;
+			}
+			return result;
+		}
+
+	private :
+
+		void accumulateEntry( const StreamIndexedIO *io, const IndexedIO::EntryID &name, EntryStatistics &statistics )
+		{
+			if( io->entry( name ).entryType() == IndexedIO::File )
+			{
+				const StreamIndexedIO::EntryStorage storage = io->entryStorage( name );
+				statistics.entries++;
+				statistics.storedSize += storage.storedSize;
+				statistics.dataSize += storage.dataSize;
+				if( m_offsets.insert( storage.offset ).second )
+				{
+					m_uniqueStoredSize += storage.storedSize;
+				}
+				return;
+			}
+
+			ConstStreamIndexedIOPtr directory = streamSubdirectory( io, name );
+			IndexedIO::EntryIDList names;
+			directory->entryIds( names );
+			for( IndexedIO::EntryIDList::const_iterator it = names.begin(); it != names.end(); ++it )
+			{
+				accumulateEntry( directory.get(), *it, statistics );
+			}
+		}
+
+		CompoundDataPtr m_locations;
+		EntryStatisticsMap m_totals;
+		uint64_t m_numLocations;
+		uint64_t m_maxDepth;
+		uint64_t m_uniqueStoredSize;
+		std::set<size_t> m_offsets;
+
+};
+
+} // namespace
+
+CompoundDataPtr SceneCacheAlgo::storageStatistics( const std::string &fileName, bool perLocation )
+{
+	IndexedIOPtr io = IndexedIO::create( fileName, IndexedIO::rootPath, IndexedIO::Read );
+	ConstStreamIndexedIOPtr streamIO = runTimeCast<const StreamIndexedIO>( io );
+	if( !streamIO )
+	{
+		throw InvalidArgumentException( "SceneCacheAlgo::storageStatistics : \"" + fileName + "\" is not stored with a StreamIndexedIO" );
+	}
+
+	ConstSceneCachePtr scene = new SceneCache( io );
+
+	StorageAccumulator accumulator( perLocation );
+	accumulator.accumulateFile( streamIO.get() );
+	accumulator.accumulateLocation( scene.get(), streamSubdirectory( streamIO.get(), g_rootEntry ).get(), 0 );
+	return accumulator.result( streamIO.get() );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Read statistics
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+enum Call
+{
+	Child = 0,
+	ReadBound,
+	ReadTransform,
+	ReadAttribute,
+	ReadObject,
+	NumCalls
+};
+
+const char *g_callNames[] = { "child", "readBound", "readTransformAsMatrix", "readAttribute", "readObject" };
+
+typedef std::vector<double> Latencies;
+typedef tbb::enumerable_thread_specific< std::vector<Latencies> > ThreadLatencies;
+
+// Records the duration of its own lifetime.
+class CallTimer
+{
+
+	public :
+
+		CallTimer( ThreadLatencies &latencies, Call call )
+			:	m_latencies( latencies ), m_call( call ), m_start( tbb::tick_count::now() )
+		{
+		}
+
+		~CallTimer()
+		{
+			m_latencies.local()[m_call].push_back( ( tbb::tick_count::now() - m_start ).seconds() );
+		}
+
+	private :
+
+		ThreadLatencies &m_latencies;
+		Call m_call;
+		tbb::tick_count m_start;
+
+};
+
+void replay( const SceneInterface *scene, double time, ThreadLatencies &latencies );
+
+class ChildReplayer
+{
+
+	public :
+
+		ChildReplayer( const SceneInterface *scene, const SceneInterface::NameList &childNames, double time, ThreadLatencies &latencies )
+			:	m_scene( scene ), m_childNames( childNames ), m_time( time ), m_latencies( latencies )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				ConstSceneInterfacePtr child;
+				{
+					CallTimer timer( m_latencies, Child );
+					child = m_scene->child( m_childNames[i] );
+				}
+				replay( child.get(), m_time, m_latencies );
+			}
+		}
+
+	private :
+
+		const SceneInterface *m_scene;
+		const SceneInterface::NameList &m_childNames;
+		double m_time;
+		ThreadLatencies &m_latencies;
+
+};
+
+void replay( const SceneInterface *scene, double time, ThreadLatencies &latencies )
+{
+	{
+		CallTimer timer( latencies, ReadBound );
+		scene->readBound( time );
+	}
+
+	{
+		CallTimer timer( latencies, ReadTransform );
+		scene->readTransformAsMatrix( time );
+	}
+
+	SceneInterface::NameList attributeNames;
+	scene->attributeNames( attributeNames );
+	for( SceneInterface::NameList::const_iterator it = attributeNames.begin(); it != attributeNames.end(); ++it )
+	{
+		CallTimer timer( latencies, ReadAttribute );
+		scene->readAttribute( *it, time );
+	}
+
+	if( scene->hasObject() )
+	{
+		CallTimer timer( latencies, ReadObject );
+		scene->readObject( time );
+	}
+
+	SceneInterface::NameList childNames;
+	scene->childNames( childNames );
+	ChildReplayer childReplayer( scene, childNames, time, latencies );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, childNames.size() ), childReplayer );
+}
+
+CompoundDataPtr latencyStatistics( Latencies &latencies )
+{
+	std::sort( latencies.begin(), latencies.end() );
+
+	double total = 0;
+	for( Latencies::const_iterator it = latencies.begin(); it != latencies.end(); ++it )
+	{
+		total += *it;
+	}
+
+	const size_t n = latencies.size();
+	CompoundDataPtr result = new CompoundData;
+	result->writable()["calls"] = new UInt64Data( n );
+	result->writable()["totalTime"] = new DoubleData( total );
+	result->writable()["meanTime"] = new DoubleData( n ? total / n : 0.0 );
+	result->writable()["medianTime"] = new DoubleData( n ? latencies[n / 2] : 0.0 );
+	result->writable()["p95Time"] = new DoubleData( n ? latencies[std::min( n - 1, ( n * 95 ) / 100 )] : 0.0 );
+	result->writable()["maxTime"] = new DoubleData( n ? latencies.back() : 0.0 );
+	return result;
+}
+
+} // namespace
+
+CompoundDataPtr SceneCacheAlgo::readStatistics( const std::string &fileName, double time, const std::vector<int> &threadCounts )
+{
+	CompoundDataPtr result = new CompoundData;
+	for( std::vector<int>::const_iterator it = threadCounts.begin(); it != threadCounts.end(); ++it )
+	{
+		const int threads = *it > 0 ? *it : tbb::task_scheduler_init::default_num_threads();
+		tbb::task_scheduler_init scheduler( threads );
+
+		// start each traversal with nothing cached
+		SceneCache::cacheObjectPool()->clear();
+		ConstSceneInterfacePtr scene = new SceneCache( fileName, IndexedIO::Read );
+
+		ThreadLatencies threadLatencies( std::vector<Latencies>( NumCalls ) );
+		const tbb::tick_count start = tbb::tick_count::now();
+		replay( scene.get(), time, threadLatencies );
+		const double wallTime = ( tbb::tick_count::now() - start ).seconds();
+
+		std::vector<Latencies> latencies( NumCalls );
+		for( ThreadLatencies::const_iterator tIt = threadLatencies.begin(); tIt != threadLatencies.end(); ++tIt )
+		{
+			for( int call = 0; call < NumCalls; ++call )
+			{
+				latencies[call].insert( latencies[call].end(), (*tIt)[call].begin(), (*tIt)[call].end() );
+			}
+		}
+
+		CompoundDataPtr threadResult = new CompoundData;
+		threadResult->writable()["threads"] = new IntData( threads );
+		threadResult->writable()["wallTime"] = new DoubleData( wallTime );
+		for( int call = 0; call < NumCalls; ++call )
+		{
+			threadResult->writable()[g_callNames[call]] = latencyStatistics( latencies[call] );
+		}
+		result->writable()[boost::lexical_cast<std::string>( *it )] = threadResult;
+	}
+	return result;
+}
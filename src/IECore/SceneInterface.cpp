@@ -32,14 +32,54 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <deque>
+
 #include "boost/filesystem/convenience.hpp"
 #include "boost/tokenizer.hpp"
+
 #include "IECore/SceneInterface.h"
+#include "IECore/DataAlgo.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/TestTypedData.h"
+#include "IECore/TypeTraits.h"
+#include "IECore/VectorTypedData.h"
 
 using namespace IECore;
 
 IE_CORE_DEFINERUNTIMETYPEDDESCRIPTION( SceneInterface )
 
+namespace
+{
+
+struct RangeCopier
+{
+	typedef DataPtr ReturnType;
+
+	RangeCopier( size_t begin, size_t end )
+		:	m_begin( begin ), m_end( end )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		const typename T::ValueType &in = data->readable();
+		const size_t begin = std::min( m_begin, in.size() );
+		const size_t end = std::max( begin, std::min( m_end, in.size() ) );
+
+		typename T::Ptr result = new T;
+		result->writable().assign( in.begin() + begin, in.begin() + end );
+		setGeometricInterpretation( result.get(), getGeometricInterpretation( data ) );
+		return result;
+	}
+
+	size_t m_begin;
+	size_t m_end;
+};
+
+} // namespace
+
 const SceneInterface::Name &SceneInterface::rootName = IndexedIO::rootName;
 const SceneInterface::Path &SceneInterface::rootPath = IndexedIO::rootPath;
 const SceneInterface::Name &SceneInterface::visibilityName( "scene:visible" );
@@ -124,6 +164,112 @@ void SceneInterface::hash( HashType hashType, double time, MurmurHash &h ) const
 	h.append( typeId() );
 }
 
+PrimitiveVariableMap SceneInterface::readObjectPrimitiveVariableRange( const std::vector<InternedString> &primVarNames, double time, size_t begin, size_t end ) const
+{
+	PrimitiveVariableMap variables = readObjectPrimitiveVariables( primVarNames, time );
+
+	RangeCopier rangeCopier( begin, end );
+	for ( PrimitiveVariableMap::iterator it = variables.begin(); it != variables.end(); it++ )
+	{
+		PrimitiveVariable &variable = it->second;
+		if ( variable.interpolation != PrimitiveVariable::Vertex && variable.interpolation != PrimitiveVariable::Varying && variable.interpolation != PrimitiveVariable::FaceVarying )
+		{
+			continue;
+		}
+
+		if ( variable.indices )
+		{
+			variable.indices = boost::static_pointer_cast<IntVectorData>( rangeCopier( variable.indices.get() ) );
+		}
+		else if ( variable.data && testTypedData<TypeTraits::IsVectorTypedData>( variable.data.get() ) )
+		{
+			variable.data = despatchTypedData<RangeCopier, TypeTraits::IsVectorTypedData>( variable.data.get(), rangeCopier );
+		}
+	}
+
+	return variables;
+}
+
+void SceneInterface::readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const
+{
+	bounds.resize( paths.size() );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		bounds[i] = scene( paths[i] )->readBound( time );
+	}
+}
+
+void SceneInterface::readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const
+{
+	transforms.resize( paths.size() );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		transforms[i] = scene( paths[i] )->readTransformAsMatrix( time );
+	}
+}
+
+void SceneInterface::readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const
+{
+	objects.clear();
+	objects.resize( paths.size() );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		ConstSceneInterfacePtr s = scene( paths[i] );
+		if ( s->hasObject() )
+		{
+			objects[i] = s->readObject( time );
+		}
+	}
+}
+
+void SceneInterface::prefetch( const std::vector<Path> &paths, double startTime, double endTime ) const
+{
+}
+
+SceneInterface::Visitor::~Visitor()
+{
+}
+
+namespace
+{
+
+// The child names are held in a deque, with one list per level of the hierarchy,
+// so that growing it doesn't invalidate the lists already being iterated.
+typedef std::deque<SceneInterface::NameList> ChildNamesStack;
+
+void traverseWalk( const SceneInterface *scene, SceneInterface::Visitor &visitor, SceneInterface::Path &path, ChildNamesStack &childNamesStack, size_t depth )
+{
+	if( !visitor.visit( scene, path ) )
+	{
+		return;
+	}
+
+	if( childNamesStack.size() <= depth )
+	{
+		childNamesStack.resize( depth + 1 );
+	}
+
+	SceneInterface::NameList &childNames = childNamesStack[depth];
+	scene->childNames( childNames );
+	for( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+	{
+		ConstSceneInterfacePtr child = scene->child( *it );
+		path.push_back( *it );
+		traverseWalk( child.get(), visitor, path, childNamesStack, depth + 1 );
+		path.pop_back();
+	}
+}
+
+} // namespace
+
+void SceneInterface::traverse( Visitor &visitor ) const
+{
+	Path p;
+	path( p );
+	ChildNamesStack childNamesStack;
+	traverseWalk( this, visitor, p, childNamesStack, 0 );
+}
+
 void SceneInterface::pathToString( const SceneInterface::Path &p, std::string &path )
 {
 	if ( !p.size() )
@@ -42,13 +42,118 @@
 #include "IECore/CompressSmoothSkinningDataOp.h"
 #include "IECore/DecompressSmoothSkinningDataOp.h"
 #include "IECore/Interpolator.h"
+#include "IECore/MeshAlgo.h"
 #include "IECore/NormalizeSmoothSkinningWeightsOp.h"
 #include "IECore/SmoothSkinningData.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/TypedObjectParameter.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Computes the smoothed weights for a range of the vertices being smoothed,
+// by blending each weight towards the average weight of the neighbouring
+// vertices.
+class Smoother
+{
+
+	public :
+
+		Smoother( const std::vector<int64_t> &vertexIds, const std::vector<unsigned int> &neighbourOffsets, const std::vector<unsigned int> &neighbours, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<float> &pointInfluenceWeights, float smoothingRatio, std::vector<float> &smoothInfluenceWeights )
+			:	m_vertexIds( vertexIds ), m_neighbourOffsets( neighbourOffsets ), m_neighbours( neighbours ), m_pointIndexOffsets( pointIndexOffsets ),
+				m_pointInfluenceCounts( pointInfluenceCounts ), m_pointInfluenceWeights( pointInfluenceWeights ), m_smoothingRatio( smoothingRatio ),
+				m_smoothInfluenceWeights( smoothInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			LinearInterpolator<float> lerp;
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				int currentVertId = m_vertexIds[i];
+				const unsigned int firstNeighbour = m_neighbourOffsets[currentVertId];
+				const unsigned int lastNeighbour = m_neighbourOffsets[currentVertId+1];
+				float numNeighbours = lastNeighbour - firstNeighbour;
+
+				for ( int j=0; j < m_pointInfluenceCounts[currentVertId]; j++ )
+				{
+					int current = m_pointIndexOffsets[currentVertId] + j;
+
+					// calculate the average neighbour weight
+					float totalNeighbourWeight = 0.0f;
+					for ( unsigned int n = firstNeighbour; n < lastNeighbour; n++ )
+					{
+						totalNeighbourWeight += m_pointInfluenceWeights[ m_pointIndexOffsets[ m_neighbours[n] ] + j ];
+					}
+					float averageNeighbourWeight = totalNeighbourWeight / numNeighbours;
+
+					lerp( m_pointInfluenceWeights[current], averageNeighbourWeight, m_smoothingRatio, m_smoothInfluenceWeights[current] );
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<int64_t> &m_vertexIds;
+		const std::vector<unsigned int> &m_neighbourOffsets;
+		const std::vector<unsigned int> &m_neighbours;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<float> &m_pointInfluenceWeights;
+		float m_smoothingRatio;
+		std::vector<float> &m_smoothInfluenceWeights;
+
+};
+
+// Copies the smoothed weights for the unlocked influences of a range of
+// the vertices being smoothed.
+class LockedCopier
+{
+
+	public :
+
+		LockedCopier( const std::vector<int64_t> &vertexIds, const std::vector<bool> &locks, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, const std::vector<float> &smoothInfluenceWeights, std::vector<float> &pointInfluenceWeights )
+			:	m_vertexIds( vertexIds ), m_locks( locks ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ),
+				m_pointInfluenceIndices( pointInfluenceIndices ), m_smoothInfluenceWeights( smoothInfluenceWeights ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				int currentVertId = m_vertexIds[i];
+				for ( int j=0; j < m_pointInfluenceCounts[currentVertId]; j++ )
+				{
+					int current = m_pointIndexOffsets[currentVertId] + j;
+					if ( !m_locks[ m_pointInfluenceIndices[current] ] )
+					{
+						m_pointInfluenceWeights[current] = m_smoothInfluenceWeights[current];
+					}
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<int64_t> &m_vertexIds;
+		const std::vector<bool> &m_locks;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		const std::vector<float> &m_smoothInfluenceWeights;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( SmoothSmoothSkinningWeightsOp );
 
 SmoothSmoothSkinningWeightsOp::SmoothSmoothSkinningWeightsOp()
@@ -133,7 +238,6 @@ void SmoothSmoothSkinningWeightsOp::modify( Object * object, const CompoundObjec
 		throw IECore::Exception( "SmoothSmoothSkinningWeightsOp: The given mesh is not valid" );
 	}
 	int numMeshVerts = mesh->variableSize( PrimitiveVariable::Vertex );
-	const std::vector<int> &meshVertexIds = mesh->vertexIds()->readable();
 	
 	// make sure the mesh matches the skinning data
 	if ( numMeshVerts != numSsdVerts )
@@ -159,6 +263,11 @@ void SmoothSmoothSkinningWeightsOp::modify( Object * object, const CompoundObjec
 	std::vector<int64_t> vertexIds;
 	m_vertexIdsParameter->getFrameListValue()->asList( vertexIds );
 	
+	// remove duplicates, so that each vertex is smoothed once and the
+	// vertices can be processed in parallel
+	std::sort( vertexIds.begin(), vertexIds.end() );
+	vertexIds.erase( std::unique( vertexIds.begin(), vertexIds.end() ), vertexIds.end() );
+	
 	// make sure all vertex ids are valid
 	for ( unsigned i=0; i < vertexIds.size(); i++ )
 	{
@@ -177,50 +286,13 @@ void SmoothSmoothSkinningWeightsOp::modify( Object * object, const CompoundObjec
 		}
 	}
 	
-	// add the mesh vertices to the neighbourhood graph
-	/// \todo: consider moving this mesh connectivity graphing to the MeshPrimitive
-	Graph meshGraph;
-	for ( int i=0; i < numMeshVerts; i++ )
-	{
-		boost::add_vertex( meshGraph );
-	}
-	
-	// add the mesh edges to the neighbourhood graph
-	int v = 0, v1, v2;
-	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
-	unsigned numFaces = verticesPerFace.size();
-	for ( unsigned f=0; f < numFaces; f++ )
-	{
-		for ( int fv=0; fv < verticesPerFace[f] - 1; fv++ )
-		{
-			v1 = meshVertexIds[v+fv];
-			v2 = meshVertexIds[v+fv+1];
-			
-			Vertex source = boost::vertex( v1, meshGraph );
-			Vertex target = boost::vertex( v2, meshGraph );
-			if ( !boost::edge( source, target, meshGraph ).second )
-			{
-				boost::add_edge( source, target, meshGraph );
-			}
-		}
-		
-		v1 = meshVertexIds[v + verticesPerFace[f] - 1];
-		v2 = meshVertexIds[v];
-		Vertex source = boost::vertex( v1, meshGraph );
-		Vertex target = boost::vertex( v2, meshGraph );
-		if ( !boost::edge( source, target, meshGraph ).second )
-		{
-			boost::add_edge( source, target, meshGraph );
-		}
-		
-		v += verticesPerFace[f];
-	}
-	
-	// get the property map that relates each Graph Vertex to a vertexId
-	VertexIdMap vertexIdMap = boost::get( boost::vertex_index, meshGraph );
+	// get the connectivity of the mesh. this is cached, so repeated
+	// smoothing of the same mesh only computes it once.
+	ConstCompoundDataPtr topology = MeshAlgo::topology( mesh );
+	const std::vector<unsigned int> &neighbourOffsets = topology->member<UIntVectorData>( "vertexNeighbourOffsets" )->readable();
+	const std::vector<unsigned int> &neighbours = topology->member<UIntVectorData>( "vertexNeighbours" )->readable();
 	
 	std::vector<float> smoothInfluenceWeights( skinningData->pointInfluenceWeights()->readable().size(), 0.0f );
-	LinearInterpolator<float> lerp;
 	float smoothingRatio = m_smoothingRatioParameter->getNumericValue();
 	int numIterations = m_iterationsParameter->getNumericValue();
 	
@@ -229,50 +301,22 @@ void SmoothSmoothSkinningWeightsOp::modify( Object * object, const CompoundObjec
 	normalizeOp.parameters()->setParameterValue( "applyLocks", m_useLocksParameter->getValue() );
 	normalizeOp.parameters()->setParameterValue( "influenceLocks", m_influenceLocksParameter->getValue() );
 	
+	const tbb::blocked_range<size_t> vertexRange( 0, vertexIds.size(), 256 );
+	
 	// iterate
 	for ( int iteration=0; iteration < numIterations; iteration++ )
 	{
 		// smooth the weights
-		for ( unsigned i=0; i < vertexIds.size(); i++ )
-		{
-			int currentVertId = vertexIds[i];
-			Vertex currentVert = boost::vertex( currentVertId, meshGraph );
-			NeighbourIteratorRange neighbourhood = boost::adjacent_vertices( currentVert, meshGraph );
-			float numNeighbours = boost::out_degree( currentVert, meshGraph );
-			
-			for ( int j=0; j < pointInfluenceCounts[currentVertId]; j++ )
-			{
-				int current = pointIndexOffsets[currentVertId] + j;
-				
-				// calculate the average neighbour weight
-				float totalNeighbourWeight = 0.0f;
-				for( NeighbourIterator nIt = neighbourhood.first; nIt != neighbourhood.second; nIt++ )
-				{
-					int neighbourId = vertexIdMap[*nIt];					
-					float currentNeighbourWeight = pointInfluenceWeights[ pointIndexOffsets[neighbourId] + j ];
-					totalNeighbourWeight += currentNeighbourWeight;
-				}
-				float averageNeighbourWeight = totalNeighbourWeight / numNeighbours;
-				
-				lerp( pointInfluenceWeights[current], averageNeighbourWeight, smoothingRatio, smoothInfluenceWeights[current] );
-			}
-		}
+		tbb::parallel_for(
+			vertexRange,
+			Smoother( vertexIds, neighbourOffsets, neighbours, pointIndexOffsets, pointInfluenceCounts, pointInfluenceWeights, smoothingRatio, smoothInfluenceWeights )
+		);
 		
 		// apply the per-influence locks
-		for ( unsigned i=0; i < vertexIds.size(); i++ )
-		{
-			int currentVertId = vertexIds[i];
-
-			for ( int j=0; j < pointInfluenceCounts[currentVertId]; j++ )
-			{
-				int current = pointIndexOffsets[currentVertId] + j;
-
-				if ( !locks[ pointInfluenceIndices[current] ] )
-				{
-					pointInfluenceWeights[current] = smoothInfluenceWeights[current];
-				}
-			}
-		}
+		tbb::parallel_for(
+			vertexRange,
+			LockedCopier( vertexIds, locks, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, smoothInfluenceWeights, pointInfluenceWeights )
+		);
 		
 		// normalize
 		normalizeOp.inputParameter()->setValidatedValue( skinningData );
@@ -38,28 +38,43 @@
 #include <list>
 #include <iostream>
 #include <cassert>
+#include <cstring>
 #include <map>
 #include <set>
 
 #include "boost/tokenizer.hpp"
 #include "boost/optional.hpp"
 #include "boost/format.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/unordered_map.hpp"
 #include "boost/iostreams/device/file.hpp"
 #include "boost/iostreams/filtering_streambuf.hpp"
 #include "boost/iostreams/filtering_stream.hpp"
 #include "boost/iostreams/stream.hpp"
 #include "boost/iostreams/filter/gzip.hpp"
+#include "boost/iostreams/device/array.hpp"
+#include "boost/iostreams/device/back_inserter.hpp"
 #include "tbb/spin_rw_mutex.h"
 
+#ifdef IECORE_WITH_LZ4
+#include "lz4.h"
+#endif
+
+#ifdef IECORE_WITH_ZSTD
+#include "zstd.h"
+#endif
+
 #include "IECore/ByteOrder.h"
 #include "IECore/MemoryStream.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/StreamIndexedIO.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/Profiling.h"
 
 #define HARDLINK				127
 #define SUBINDEX_DIR			126
+#define COMPRESSED_DATA			0x80
 
 static const Imf::Int64 g_unversionedMagicNumber = 0x0B00B1E5;
 static const Imf::Int64 g_versionedMagicNumber = 0xB00B1E50;
@@ -69,22 +84,39 @@ static const Imf::Int64 g_versionedMagicNumber = 0xB00B1E50;
 /// Version 5: introduced subindex as zipped data blocks (to reduce size of the main index). 
 ///            Hard links are represented as regular data nodes, that points to same data on file (no removal of data ever). 
 ///            Removed the linkCount field on the data nodes.
+/// Version 6: index and subindex blocks are prefixed by the codec used to compress them (gzip, lz4 or zstd)
+///            and their uncompressed size.
+/// Version 7: optional compression of data entries, flagged in the DataType of their nodes.
+/// Version 8: the StringCache is stored as contiguous arrays, so that it can be loaded in bulk.
 /// \todo Store SubIndexSize and NodeCount as unsigned 64bit integers
-static const Imf::Int64 g_currentVersion = 5;
+static const Imf::Int64 g_currentVersion = 8;
+
+/// New files are written at this version, so that they remain readable by older builds. Only
+/// selecting a codec other than gzip or enabling data compression raises them to g_currentVersion.
+static const Imf::Int64 g_compatibleVersion = 5;
 
 /// FileFormat ::= Data Index IndexOffset Version MagicNumber
 /// Data ::= DataEntry*
-/// Index ::= zip(StringCache NodeTree FreePages)
+/// Index ::= Block(StringCache NodeTree FreePages)
 
 /// DataEntry ::= Stores data from nodes: 
-///                [Data nodes] binary data indexed by DataOffset/DataSize and 
-///                [Subindex]   SubIndexSize zip(NodeCount NodeTree*) indexed by SubIndexOffset.
-/// SubIndexSize :: = uint32 - number of bytes in the zipped subindex that follows
-
-/// StringCache ::= NumStrings String*
+///                [Data nodes] binary data indexed by DataOffset/DataSize or
+///                             ShuffleSize Block(binary data) if the DataType is flagged as compressed, and
+///                [Subindex]   SubIndexSize Block(NodeCount NodeTree*) indexed by SubIndexOffset.
+/// ShuffleSize ::= char ( size of the elements whose bytes were regrouped before compression, or 1 if not shuffled )
+/// SubIndexSize :: = uint32 - number of bytes in the compressed subindex block that follows
+
+/// Block(X) ::= Codec UncompressedSize codec(X) ( Version >= 6 )
+///              zip(X) ( Version <= 5 )
+/// Codec ::= char ( value from StreamIndexedIO::Compression )
+/// UncompressedSize ::= uint64 ( number of bytes in X )
+
+/// StringCache ::= NumStrings StringId* StringLength* StringDataSize char* ( Version >= 8 )
+///                 NumStrings ( StringLength char* StringId )* ( Version <= 7 )
 /// NumStrings ::= int64
-/// String ::= StringLength char*
-/// StringLength ::= int64
+/// StringId ::= int64 ( stored in increasing order for Version >= 8 )
+/// StringLength ::= uint32 ( Version >= 8 ), int64 ( Version <= 7 )
+/// StringDataSize ::= int64 ( total number of chars in all strings )
 
 /// NodeTree Node* ( A Directory node followed by it's child nodes )
 /// Node ::= EntryType EntryStringCacheID NodeCount ( if EntryType == Directory )
@@ -92,7 +124,7 @@ static const Imf::Int64 g_currentVersion = 5;
 ///			 EntryType EntryStringCacheID SubIndexOffset ( If EntryType == SUBINDEX_DIR )
 /// EntryType ::= char ( value from IndexedIO::EntryType )
 /// EntryStringCacheID ::= int64 ( index in StringCache )
-/// DataType ::= char ( value from IndexedIO::DataType )
+/// DataType ::= char ( value from IndexedIO::DataType, with the COMPRESSED_DATA bit set for compressed data entries )
 /// ArrayLength ::= int64 ( if DataType is array, then this tells how long they are )
 /// NodeID ::= int64 ( unique Id of this node in the file )
 /// ParentNodeID ::= int64 ( Id for the parent node )
@@ -140,51 +172,457 @@ void readLittleEndian( F &f, T &n )
 	}
 }
 
+/// Accumulates serialised index data in memory, prior to compression.
+class MemoryWriter : boost::noncopyable
+{
+	public :
+
+		void write( const char *data, size_t size )
+		{
+			m_data.insert( m_data.end(), data, data + size );
+		}
+
+		const std::vector<char> &data() const
+		{
+			return m_data;
+		}
+
+	private :
+
+		std::vector<char> m_data;
+
+};
+
+/// Provides the read() interface used by the index parsing functions over a block of
+/// decompressed data, avoiding the overhead of a stream.
+class MemoryReader : boost::noncopyable
+{
+	public :
+
+		MemoryReader( const char *data, size_t size ) : m_data( data ), m_size( size ), m_pos( 0 )
+		{
+		}
+
+		void read( char *buffer, size_t size )
+		{
+			if ( m_pos + size > m_size )
+			{
+				throw IOException( "StreamIndexedIO: Unexpected end of index data!" );
+			}
+			memcpy( buffer, m_data + m_pos, size );
+			m_pos += size;
+		}
+
+		void skip( size_t size )
+		{
+			if ( m_pos + size > m_size )
+			{
+				throw IOException( "StreamIndexedIO: Unexpected end of index data!" );
+			}
+			m_pos += size;
+		}
+
+		void seek( size_t pos )
+		{
+			if ( pos > m_size )
+			{
+				throw IOException( "StreamIndexedIO: Unexpected end of index data!" );
+			}
+			m_pos = pos;
+		}
+
+		size_t tell() const
+		{
+			return m_pos;
+		}
+
+		const char *data() const
+		{
+			return m_data;
+		}
+
+	private :
+
+		const char *m_data;
+		size_t m_size;
+		size_t m_pos;
+
+};
+
+static StreamIndexedIO::Compression initialDefaultCompression()
+{
+	const char *c = getenv( "IECORE_INDEXEDIO_COMPRESSION" );
+	if( !c )
+	{
+		return StreamIndexedIO::Gzip;
+	}
+
+	StreamIndexedIO::Compression result = StreamIndexedIO::Gzip;
+	if( !strcmp( c, "lz4" ) )
+	{
+		result = StreamIndexedIO::LZ4;
+	}
+	else if( !strcmp( c, "zstd" ) )
+	{
+		result = StreamIndexedIO::Zstd;
+	}
+	else if( strcmp( c, "gzip" ) )
+	{
+		msg( Msg::Warning, "StreamIndexedIO", boost::format( "Unknown IECORE_INDEXEDIO_COMPRESSION value \"%s\"." ) % c );
+	}
+
+	if( !StreamIndexedIO::compressionAvailable( result ) )
+	{
+		msg( Msg::Warning, "StreamIndexedIO", boost::format( "Compression \"%s\" is not available. Using gzip." ) % c );
+		result = StreamIndexedIO::Gzip;
+	}
+	return result;
+}
+
+static StreamIndexedIO::Compression g_defaultCompression = initialDefaultCompression();
+
+// zstd is used when the best compression ratio is wanted, but the highest levels
+// are too slow to write large indexes.
+static const int g_zstdCompressionLevel = 12;
+
+static void gzipCompress( const char *data, size_t size, std::vector<char> &result )
+{
+	io::filtering_ostream compressingStream;
+	compressingStream.push( io::gzip_compressor() );
+	compressingStream.push( io::back_inserter( result ) );
+	compressingStream.write( data, size );
+	compressingStream.reset();
+}
+
+/// Compresses the data into a Block as described in the file format, appending it to result.
+static void compressBlock( StreamIndexedIO::Compression compression, const char *data, size_t size, std::vector<char> &result )
+{
+	result.push_back( (char)compression );
+	const Imf::Int64 uncompressedSize = asLittleEndian<Imf::Int64>( size );
+	result.insert( result.end(), (const char *)&uncompressedSize, (const char *)&uncompressedSize + sizeof( uncompressedSize ) );
+	const size_t headerSize = result.size();
+
+	switch( compression )
+	{
+		case StreamIndexedIO::Gzip :
+			gzipCompress( data, size, result );
+			break;
+#ifdef IECORE_WITH_LZ4
+		case StreamIndexedIO::LZ4 :
+		{
+			if( size > (size_t)LZ4_MAX_INPUT_SIZE )
+			{
+				throw IOException( "StreamIndexedIO: Index too large for LZ4 compression!" );
+			}
+			result.resize( headerSize + LZ4_compressBound( size ) );
+			int compressedSize = LZ4_compress_default( data, &result[headerSize], size, result.size() - headerSize );
+			if( compressedSize <= 0 )
+			{
+				throw IOException( "StreamIndexedIO: LZ4 compression failed!" );
+			}
+			result.resize( headerSize + compressedSize );
+			break;
+		}
+#endif
+#ifdef IECORE_WITH_ZSTD
+		case StreamIndexedIO::Zstd :
+		{
+			result.resize( headerSize + ZSTD_compressBound( size ) );
+			size_t compressedSize = ZSTD_compress( &result[headerSize], result.size() - headerSize, data, size, g_zstdCompressionLevel );
+			if( ZSTD_isError( compressedSize ) )
+			{
+				throw IOException( std::string( "StreamIndexedIO: Zstd compression failed : " ) + ZSTD_getErrorName( compressedSize ) );
+			}
+			result.resize( headerSize + compressedSize );
+			break;
+		}
+#endif
+		default :
+			throw IOException( "StreamIndexedIO: Unsupported compression!" );
+	}
+}
+
+/// Decompresses a Block as described in the file format.
+static void decompressBlock( const char *data, size_t size, std::vector<char> &result )
+{
+	Imf::Int64 uncompressedSize = 0;
+	if( size < sizeof( char ) + sizeof( uncompressedSize ) )
+	{
+		throw IOException( "StreamIndexedIO: Invalid compressed block!" );
+	}
+
+	const StreamIndexedIO::Compression compression = (StreamIndexedIO::Compression)data[0];
+	memcpy( &uncompressedSize, data + 1, sizeof( uncompressedSize ) );
+	if( bigEndian() )
+	{
+		uncompressedSize = reverseBytes<>( uncompressedSize );
+	}
+	data += sizeof( char ) + sizeof( uncompressedSize );
+	size -= sizeof( char ) + sizeof( uncompressedSize );
+
+	// the size comes from the file, so validate it before allocating
+	// for it, using the maximum compression ratio of each codec.
+	Imf::Int64 maxUncompressedSize = 0;
+	switch( compression )
+	{
+		case StreamIndexedIO::Gzip :
+			// deflate can't do better than 1032:1
+			maxUncompressedSize = (Imf::Int64)size * 1032;
+			break;
+#ifdef IECORE_WITH_LZ4
+		case StreamIndexedIO::LZ4 :
+			// each byte of a run length encodes at most 255 bytes
+			maxUncompressedSize = (Imf::Int64)size * 255 + 16;
+			break;
+#endif
+#ifdef IECORE_WITH_ZSTD
+		case StreamIndexedIO::Zstd :
+		{
+			// ZSTD_compress() records the content size in the frame header
+			const unsigned long long contentSize = ZSTD_getFrameContentSize( data, size );
+			if( contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR )
+			{
+				maxUncompressedSize = contentSize;
+			}
+			break;
+		}
+#endif
+		default :
+			throw IOException( "StreamIndexedIO: File uses a compression codec which is not available in this build!" );
+	}
+
+	if( uncompressedSize > maxUncompressedSize || uncompressedSize > (Imf::Int64)result.max_size() )
+	{
+		throw IOException( "StreamIndexedIO: Invalid compressed block size!" );
+	}
+
+	result.resize( uncompressedSize );
+	if( !uncompressedSize )
+	{
+		return;
+	}
+
+	switch( compression )
+	{
+		case StreamIndexedIO::Gzip :
+		{
+			io::filtering_istream decompressingStream;
+			decompressingStream.push( io::gzip_decompressor() );
+			decompressingStream.push( io::array_source( data, size ) );
+			decompressingStream.read( &result[0], uncompressedSize );
+			if( (Imf::Int64)decompressingStream.gcount() != uncompressedSize )
+			{
+				throw IOException( "StreamIndexedIO: Gzip decompression failed!" );
+			}
+			break;
+		}
+#ifdef IECORE_WITH_LZ4
+		case StreamIndexedIO::LZ4 :
+		{
+			int decompressedSize = LZ4_decompress_safe( data, &result[0], size, uncompressedSize );
+			if( decompressedSize < 0 || (Imf::Int64)decompressedSize != uncompressedSize )
+			{
+				throw IOException( "StreamIndexedIO: LZ4 decompression failed!" );
+			}
+			break;
+		}
+#endif
+#ifdef IECORE_WITH_ZSTD
+		case StreamIndexedIO::Zstd :
+		{
+			size_t decompressedSize = ZSTD_decompress( &result[0], uncompressedSize, data, size );
+			if( ZSTD_isError( decompressedSize ) || decompressedSize != uncompressedSize )
+			{
+				throw IOException( "StreamIndexedIO: Zstd decompression failed!" );
+			}
+			break;
+		}
+#endif
+		default :
+			throw IOException( "StreamIndexedIO: File uses a compression codec which is not available in this build!" );
+	}
+}
+
+/// Temporary buffer used by the read functions. Unlike StreamFile::ioBuffer() it isn't
+/// shared, so concurrent reads don't need to be serialised. Small reads use the stack.
+class ReadBuffer : boost::noncopyable
+{
+	public :
+
+		ReadBuffer( size_t size ) : m_heapData( size > sizeof( m_stackData ) ? new char[size] : 0 )
+		{
+		}
+
+		~ReadBuffer()
+		{
+			delete [] m_heapData;
+		}
+
+		inline char *get()
+		{
+			return m_heapData ? m_heapData : m_stackData;
+		}
+
+	private :
+
+		char m_stackData[256];
+		char *m_heapData;
+
+};
+
+/// Regroups the bytes of each element by significance, so that the slowly varying exponent
+/// and high order mantissa bytes of floating point data end up next to each other, which
+/// greatly improves the compression ratio. Trailing bytes which don't make a whole element
+/// are copied unchanged.
+static void shuffleBytes( const char *data, size_t size, size_t elementSize, char *result )
+{
+	const size_t numElements = size / elementSize;
+	for ( size_t i = 0; i < numElements; i++ )
+	{
+		for ( size_t b = 0; b < elementSize; b++ )
+		{
+			result[b * numElements + i] = data[i * elementSize + b];
+		}
+	}
+	const size_t shuffledSize = numElements * elementSize;
+	memcpy( result + shuffledSize, data + shuffledSize, size - shuffledSize );
+}
+
+/// The inverse of shuffleBytes().
+static void unshuffleBytes( const char *data, size_t size, size_t elementSize, char *result )
+{
+	const size_t numElements = size / elementSize;
+	for ( size_t i = 0; i < numElements; i++ )
+	{
+		for ( size_t b = 0; b < elementSize; b++ )
+		{
+			result[i * elementSize + b] = data[b * numElements + i];
+		}
+	}
+	const size_t shuffledSize = numElements * elementSize;
+	memcpy( result + shuffledSize, data + shuffledSize, size - shuffledSize );
+}
+
+/// The size of the elements whose bytes are shuffled before compressing data entries.
+template<typename T>
+struct ShuffleTraits
+{
+	static size_t elementSize() { return sizeof( T ); }
+};
+
+template<>
+struct ShuffleTraits<std::string>
+{
+	static size_t elementSize() { return 1; }
+};
+
+/// Validates the size of decompressed data entries before they are unflattened,
+/// so that damaged files can't cause reads beyond the end of the data.
+template<typename T>
+struct FlattenedSizeTraits
+{
+	static bool valid( const std::vector<char> &data )
+	{
+		return data.size() == (size_t)IndexedIODetail::size<T>();
+	}
+
+	static bool valid( const std::vector<char> &data, unsigned long arrayLength )
+	{
+		return data.size() == arrayLength * (size_t)IndexedIODetail::size<T>();
+	}
+};
+
+template<>
+struct FlattenedSizeTraits<std::string>
+{
+	static bool valid( const std::vector<char> &data )
+	{
+		return !data.empty() && data.back() == '\0';
+	}
+
+	// Each string is stored as its length followed by its characters.
+	static bool valid( const std::vector<char> &data, unsigned long arrayLength )
+	{
+		const size_t lengthSize = IndexedIODetail::size<unsigned long>();
+		size_t offset = 0;
+		for ( unsigned long i = 0; i < arrayLength; i++ )
+		{
+			if ( data.size() - offset < lengthSize )
+			{
+				return false;
+			}
+			unsigned long stringLength = 0;
+			IndexedIO::DataFlattenTraits<unsigned long>::unflatten( &data[offset], stringLength );
+			offset += lengthSize;
+			if ( data.size() - offset < stringLength )
+			{
+				return false;
+			}
+			offset += stringLength;
+		}
+		return offset == data.size();
+	}
+};
+
 class StreamIndexedIO::StringCache
 {
 	public:
 
-		StringCache() : m_prevId(0), m_ioBuffer(0), m_ioBufferLen(0)
+		StringCache() : m_prevId(0)
 		{
 			m_idToStringMap.reserve(100);
 		}
 
 		template < typename F >
-		StringCache( F &f ) : m_prevId(0), m_ioBuffer(0), m_ioBufferLen(0)
+		StringCache( F &f, Imf::Int64 version ) : m_prevId(0)
 		{
 			Imf::Int64 sz;
 			readLittleEndian(f,sz);
 
 			m_idToStringMap.reserve(sz + 100);
+			m_stringToIdMap.rehash(sz + 100);
 
+			if ( version >= 8 )
+			{
+				readBlock( f, sz );
+				return;
+			}
+
+			std::vector<char> buffer;
 			for (Imf::Int64 i = 0; i < sz; ++i)
 			{
-				const char *s = read(f);
+				Imf::Int64 length;
+				readLittleEndian( f, length );
+				buffer.resize( length + 1 );
+				f.read( &buffer[0], length * sizeof(char) );
 
 				Imf::Int64 id;
 				readLittleEndian( f,id );
 
-				m_prevId = std::max( id, m_prevId );
-
-				m_stringToIdMap[s] = id;
-				if ( id >= m_idToStringMap.size() )
-				{
-					m_idToStringMap.resize(id+1, (const char *)"");
-				}
-				m_idToStringMap[id] = s;
+				insert( IndexedIO::EntryID( &buffer[0], length ), id );
 			}
 		}
 
 		template < typename F >
-		void write( F &f ) const
+		void write( F &f, Imf::Int64 version ) const
 		{
 			Imf::Int64 sz = m_stringToIdMap.size();
 			writeLittleEndian( f,sz );
 
+			if ( version >= 8 )
+			{
+				writeBlock( f );
+				return;
+			}
+
 			for (StringToIdMap::const_iterator it = m_stringToIdMap.begin();
 				it != m_stringToIdMap.end(); ++it)
 			{
-				write(f, it->first);
+				const std::string &s = it->first.value();
+				Imf::Int64 length = s.size();
+				writeLittleEndian( f, length );
+				/// Does not include null terminator
+				f.write( s.c_str(), length * sizeof(char) );
 
 				writeLittleEndian(f,it->second);
 			}
@@ -211,15 +649,8 @@ class StreamIndexedIO::StringCache
 					throw IOException( (boost::format ( "StringCache: could not find string %s!" ) % s.value() ).str() );
 				}
 
-				Imf::Int64 id = ++m_prevId;
-
-				m_stringToIdMap[s] = id;
-				if ( id >= m_idToStringMap.size() )
-				{
-					m_idToStringMap.resize(id+1, (const char *)"");
-				}
-				m_idToStringMap[id] = s;
-
+				Imf::Int64 id = m_prevId + 1;
+				insert( s, id );
 				return id;
 			}
 			else
@@ -247,48 +678,144 @@ class StreamIndexedIO::StringCache
 			return m_stringToIdMap.size();
 		}
 
+		/// Returns the combined length of all the strings.
+		size_t stringsSize() const
+		{
+			size_t result = 0;
+			for ( StringToIdMap::const_iterator it = m_stringToIdMap.begin(); it != m_stringToIdMap.end(); ++it )
+			{
+				result += it->first.value().size();
+			}
+			return result;
+		}
+
+		/// Returns the memory used by the lookup tables. The strings themselves
+		/// are shared with all other InternedStrings, so aren't included.
+		size_t memoryUsage() const
+		{
+			return m_idToStringMap.capacity() * sizeof( IndexedIO::EntryID ) +
+				m_stringToIdMap.size() * ( sizeof( StringToIdMap::value_type ) + sizeof( void * ) ) +
+				m_stringToIdMap.bucket_count() * sizeof( void * );
+		}
+
 	protected:
 
+		void insert( const IndexedIO::EntryID &s, Imf::Int64 id )
+		{
+			m_prevId = std::max( id, m_prevId );
+
+			m_stringToIdMap[s] = id;
+			if ( id >= m_idToStringMap.size() )
+			{
+				m_idToStringMap.resize(id+1, IndexedIO::EntryID());
+			}
+			m_idToStringMap[id] = s;
+		}
+
+		/// Writes the ids, lengths and characters of all the strings as three contiguous
+		/// arrays, in id order, so that they can be loaded in a few bulk reads.
 		template < typename F >
-		void write( F &f, const std::string &s ) const
+		void writeBlock( F &f ) const
 		{
-			Imf::Int64 sz = s.size();
-			writeLittleEndian( f, sz );
+			std::vector<Imf::Int64> ids;
+			std::vector<uint32_t> lengths;
+			ids.reserve( m_stringToIdMap.size() );
+			lengths.reserve( m_stringToIdMap.size() );
+			Imf::Int64 dataSize = 0;
+
+			for ( Imf::Int64 id = 0; id < m_idToStringMap.size(); id++ )
+			{
+				// skip the unused ids, for which we store the empty string
+				const IndexedIO::EntryID &s = m_idToStringMap[id];
+				StringToIdMap::const_iterator it = m_stringToIdMap.find( s );
+				if ( it == m_stringToIdMap.end() || it->second != id )
+				{
+					continue;
+				}
+
+				if ( s.value().size() >= UINT32_MAX )
+				{
+					throw IOException( "StringCache: string too long!" );
+				}
+
+				ids.push_back( asLittleEndian<Imf::Int64>( id ) );
+				lengths.push_back( asLittleEndian<uint32_t>( s.value().size() ) );
+				dataSize += s.value().size();
+			}
+
+			if ( ids.size() != m_stringToIdMap.size() )
+			{
+				throw IOException( "StringCache: inconsistent string table!" );
+			}
 
-			/// Does not include null terminator
-			f.write( s.c_str(), sz * sizeof(char) );
+			if ( !ids.empty() )
+			{
+				f.write( (const char *)&ids[0], ids.size() * sizeof( Imf::Int64 ) );
+				f.write( (const char *)&lengths[0], lengths.size() * sizeof( uint32_t ) );
+			}
+
+			writeLittleEndian( f, dataSize );
+			for ( std::vector<Imf::Int64>::const_iterator it = ids.begin(); it != ids.end(); ++it )
+			{
+				const std::string &s = m_idToStringMap[ asLittleEndian<Imf::Int64>( *it ) ].value();
+				f.write( s.c_str(), s.size() );
+			}
 		}
 
 		template < typename F >
-		const char *read( F &f ) const
+		void readBlock( F &f, Imf::Int64 sz )
 		{
-			Imf::Int64 sz;
-			readLittleEndian( f, sz );
+			if ( !sz )
+			{
+				Imf::Int64 dataSize;
+				readLittleEndian( f, dataSize );
+				return;
+			}
 
-			if ( m_ioBufferLen < sz + 1 )
+			std::vector<Imf::Int64> ids( sz );
+			std::vector<uint32_t> lengths( sz );
+			f.read( (char *)&ids[0], sz * sizeof( Imf::Int64 ) );
+			f.read( (char *)&lengths[0], sz * sizeof( uint32_t ) );
+
+			Imf::Int64 dataSize;
+			readLittleEndian( f, dataSize );
+			std::vector<char> data( dataSize + 1 );
+			f.read( &data[0], dataSize );
+
+			// Intern all the strings in one batch, as it is
+			// significantly cheaper than interning them one by one.
+			std::vector<const char *> chars( sz );
+			std::vector<size_t> charLengths( sz );
+			const char *c = &data[0];
+			const char *end = c + dataSize;
+			for ( Imf::Int64 i = 0; i < sz; i++ )
 			{
-				if ( m_ioBuffer )
+				const uint32_t length = asLittleEndian<uint32_t>( lengths[i] );
+				if ( c + length > end )
 				{
-					delete [] m_ioBuffer;
+					throw IOException( "StringCache: corrupt string table!" );
 				}
-				m_ioBufferLen = sz+1;
-				m_ioBuffer = new char[m_ioBufferLen];
+				chars[i] = c;
+				charLengths[i] = length;
+				c += length;
+			}
+
+			std::vector<IndexedIO::EntryID> strings( sz );
+			InternedString::intern( sz, &chars[0], &charLengths[0], &strings[0] );
+
+			for ( Imf::Int64 i = 0; i < sz; i++ )
+			{
+				insert( strings[i], asLittleEndian<Imf::Int64>( ids[i] ) );
 			}
-			f.read( m_ioBuffer, sz*sizeof(char));
-			m_ioBuffer[sz] = '\0';
-			return m_ioBuffer;
 		}
 
 		Imf::Int64 m_prevId;
 
-		typedef std::map< IndexedIO::EntryID, Imf::Int64 > StringToIdMap;
+		typedef boost::unordered_map< IndexedIO::EntryID, Imf::Int64 > StringToIdMap;
 		typedef std::vector< IndexedIO::EntryID > IdToStringMap;
 
 		StringToIdMap m_stringToIdMap;
 		IdToStringMap m_idToStringMap;
-
-		mutable char *m_ioBuffer;
-		mutable unsigned long m_ioBufferLen;
 };
 
 /// NodeBase is a base class for nodes representing the index
@@ -347,12 +874,17 @@ class SmallDataNode : public NodeBase
 		static const size_t maxArrayLength = UINT16_MAX;
 		static const size_t maxSize = UINT32_MAX;
 		
-		SmallDataNode( IndexedIO::EntryID name, IndexedIO::DataType dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset ) : 
-			NodeBase(NodeBase::SmallData, name), m_dataType(dataType), m_arrayLength((Length)arrayLength), m_size((Size)size), m_offset(offset) {}
+		SmallDataNode( IndexedIO::EntryID name, IndexedIO::DataType dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset, bool compressed = false ) : 
+			NodeBase(NodeBase::SmallData, name), m_dataType( dataType | ( compressed ? COMPRESSED_DATA : 0 ) ), m_arrayLength((Length)arrayLength), m_size((Size)size), m_offset(offset) {}
 
 		inline IndexedIO::DataType dataType() 
 		{
-			return static_cast<IndexedIO::DataType>(m_dataType);
+			return static_cast<IndexedIO::DataType>( m_dataType & ~COMPRESSED_DATA );
+		}
+
+		inline bool compressed()
+		{
+			return m_dataType & COMPRESSED_DATA;
 		}
 
 		inline Imf::Int64 arrayLength()
@@ -373,8 +905,9 @@ class SmallDataNode : public NodeBase
 	protected :
 
 		/// data fields from IndexedIO::Entry
-		// using char instead of enum to compact members in one word
-		const char m_dataType;
+		// using char instead of enum to compact members in one word.
+		// the COMPRESSED_DATA bit is used to flag compressed data.
+		const unsigned char m_dataType;
 
 		/// data fields from IndexedIO::Entry
 		const Length m_arrayLength;
@@ -393,14 +926,19 @@ class DataNode : public NodeBase
 		static const size_t maxArrayLength = UINT64_MAX;
 		static const size_t maxSize = UINT64_MAX;
 		
-		DataNode( IndexedIO::EntryID name, IndexedIO::DataType dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset ) : 
-			NodeBase(NodeBase::Data, name), m_dataType(dataType), m_arrayLength(arrayLength), m_size(size), m_offset(offset) {}
+		DataNode( IndexedIO::EntryID name, IndexedIO::DataType dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset, bool compressed = false ) : 
+			NodeBase(NodeBase::Data, name), m_dataType(dataType), m_compressed(compressed), m_arrayLength(arrayLength), m_size(size), m_offset(offset) {}
 
 		inline IndexedIO::DataType dataType() 
 		{
 			return m_dataType;
 		}
 
+		inline bool compressed()
+		{
+			return m_compressed;
+		}
+
 		inline Imf::Int64 arrayLength()
 		{
 			return m_arrayLength;
@@ -419,6 +957,7 @@ class DataNode : public NodeBase
 		void copyFrom( DataNode *other )
 		{
 			m_dataType = other->m_dataType;
+			m_compressed = other->m_compressed;
 			m_arrayLength = other->m_arrayLength;
 			m_offset = other->m_offset;
 			m_size = other->m_size;
@@ -429,6 +968,9 @@ class DataNode : public NodeBase
 		/// data fields from IndexedIO::Entry
 		IndexedIO::DataType m_dataType;
 
+		/// true if the data was compressed when it was written
+		bool m_compressed;
+
 		/// data fields from IndexedIO::Entry
 		Imf::Int64 m_arrayLength;
 
@@ -464,10 +1006,14 @@ class DirectoryNode : public NodeBase
 	public :
 		/// Directory nodes can save it's children to sub-indexes to free resources and reduce the size of the main index.
 		/// Once saved to a subindex, they become read-only.
+		/// When a file is opened with IndexedIO::LazyIndex, directories from the main index are
+		/// created as DeferredIndex and their children are loaded from the retained index the
+		/// first time they are accessed, after which they become LoadedSubIndex.
 		enum SubIndexMode {
 			NoSubIndex = 0,
 			SavedSubIndex,
 			LoadedSubIndex,
+			DeferredIndex,
 		};
 
 		typedef std::vector< NodeBase* > ChildMap;
@@ -478,6 +1024,9 @@ class DirectoryNode : public NodeBase
 		// constructor used when building a directory based on an existing SubIndexNode (because we want to load the contents soon).
 		DirectoryNode( SubIndexNode *subindex, DirectoryNode *parent ) : NodeBase(NodeBase::Directory, subindex->name()), m_subindex(SavedSubIndex), m_sortedChildren(false), m_subindexChildren(false), m_offset(subindex->offset()), m_parent(parent) {}
 
+		// constructor used when deferring the loading of the children, which are stored at the given offset in the main index.
+		DirectoryNode( IndexedIO::EntryID name, Imf::Int64 indexOffset ) : NodeBase(NodeBase::Directory, name), m_subindex(DeferredIndex), m_sortedChildren(false), m_subindexChildren(false), m_offset(indexOffset), m_parent(0) {}
+
 		// returns what's the state of this directory, whether it's contents are in a subindex and whether they have been loaded or not.
 		inline SubIndexMode subindex()
 		{
@@ -550,7 +1099,8 @@ class DirectoryNode : public NodeBase
 		bool m_sortedChildren; // same as above
 		bool m_subindexChildren;	// true if one or more children are subindex. Helps avoiding the mutex...
 
-		/// The offset in the file to this node's subindex block if m_subindex is not NoSubIndex.
+		/// The offset in the file to this node's subindex block if m_subindex is not NoSubIndex,
+		/// or the offset of its children in the main index if m_subindex is DeferredIndex.
 		Imf::Int64 m_offset;
 
 		/// A pointer to the parent node in the tree - will be NULL for the root node
@@ -579,10 +1129,13 @@ class StreamIndexedIO::Node
 		// Returns the named child directory node or NULL if not existent. Loads the subindex for the child nodes (if applicable).
 		DirectoryNode* directoryChild( const IndexedIO::EntryID &name ) const;
 		/// returns information about the Data node
-		inline bool dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size ) const;
+		inline bool dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size, bool &compressed ) const;
+		/// returns information about several Data nodes, locking the directory only once.
+		/// Throws if any of the arrays doesn't name a Data node.
+		void dataChildInfo( const IndexedIO::ArrayList &arrays, std::vector<size_t> &offsets, std::vector<size_t> &sizes, std::vector<bool> &compressed ) const;
 
 		DirectoryNode* addChild( const IndexedIO::EntryID & childName );
-		void addDataChild( const IndexedIO::EntryID & childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size );
+		void addDataChild( const IndexedIO::EntryID & childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size, bool compressed = false );
 
 		void removeChild( const IndexedIO::EntryID &childName, bool throwException = true );
 
@@ -625,12 +1178,45 @@ class StreamIndexedIO::Index : public RefCounted
 		/// \param prefixSize If true than it will prepend to the block, the size of it
 		Imf::Int64 writeUniqueData( const char *data, size_t size, bool prefixSize = false );
 
+		/// As above, but for several blocks at once. The blocks which haven't been saved before are
+		/// written with a single seek to one contiguous region of the file.
+		void writeUniqueData( const std::vector<const char *> &data, const std::vector<size_t> &sizes, std::vector<Imf::Int64> &offsets );
+
 		/// flushes the children of the given directory node to a subindex in the file
 		void commitNodeToSubIndex( DirectoryNode *n );
 
 		/// read the subindex that contains the children of the given node
+		/// or, for DeferredIndex nodes, read its children from the main index.
 		void readNodeFromSubIndex( DirectoryNode *n );
 
+		/// Returns the memory used by the resident parts of the index.
+		size_t memoryUsage() const;
+
+		/// Raises the version written to the file to g_currentVersion if it is older than
+		/// the specified version, returning false if existing blocks prevent it.
+		bool requireVersion( Imf::Int64 version );
+
+		/// the codec used when writing index and subindex blocks.
+		void setCompression( StreamIndexedIO::Compression compression );
+		StreamIndexedIO::Compression getCompression() const;
+
+		/// the settings used when writing data entries. See StreamIndexedIO::setDataCompression().
+		void setDataCompression( bool enabled, StreamIndexedIO::Compression compression, bool shuffle, size_t minSize );
+		bool getDataCompression() const;
+
+		/// Writes the data of a data node, compressing it when data compression is enabled and
+		/// worthwhile. Returns the offset of the data, and sets storedSize and compressed to the
+		/// values to be stored in the node.
+		Imf::Int64 writeData( const char *data, size_t size, size_t elementSize, size_t &storedSize, bool &compressed );
+
+		/// Reads and decompresses the data of a compressed data node.
+		void readCompressedData( Imf::Int64 offset, size_t storedSize, std::vector<char> &result ) const;
+		/// Returns the size of the data of a compressed data node, without decompressing it.
+		size_t compressedDataSize( Imf::Int64 offset, size_t storedSize ) const;
+
+		/// Fills in the description of the file.
+		void fileStorage( StreamIndexedIO::FileStorage &storage ) const;
+
 		typedef tbb::spin_rw_mutex Mutex;
 		typedef Mutex::scoped_lock MutexLock;
 		/// Returns an appropriate mutex scoped lock to access the given Directory node.
@@ -651,11 +1237,26 @@ class StreamIndexedIO::Index : public RefCounted
 
 		Imf::Int64 m_version;
 
+		StreamIndexedIO::Compression m_compression;
+
+		bool m_dataCompression;
+		StreamIndexedIO::Compression m_dataCodec;
+		bool m_dataShuffle;
+		size_t m_dataCompressionMinSize;
+
+		/// true if subindex blocks exist in the file, fixing the format they were written in
+		bool m_hasSubIndices;
+
 		bool m_hasChanged;
 
 		Imf::Int64 m_offset;
 		Imf::Int64 m_next;
 
+		// the version and sizes of the file when it was opened
+		Imf::Int64 m_fileVersion;
+		Imf::Int64 m_fileSize;
+		Imf::Int64 m_indexSize;
+
 		// only used on Version <= 4
 		typedef std::vector< NodeBase* > IndexToNodeMap;
 		IndexToNodeMap m_indexToNodeMap;
@@ -665,6 +1266,10 @@ class StreamIndexedIO::Index : public RefCounted
 
 		StringCache m_stringCache;
 
+		/// the uncompressed main index, retained in IndexedIO::LazyIndex mode
+		/// so that the children of DeferredIndex directories can be loaded on demand.
+		std::vector<char> m_deferredIndex;
+
 		StreamIndexedIO::StreamFilePtr m_stream;
 
 		struct FreePage;
@@ -693,6 +1298,9 @@ class StreamIndexedIO::Index : public RefCounted
 		/// Write the index to the file stream
 		Imf::Int64 write();
 
+		/// Compresses a serialised index or subindex into a Block appropriate for the file version.
+		void compress( const std::vector<char> &data, std::vector<char> &result ) const;
+
 		/// Write the node (and all child nodes) to a stream
 		template < typename F >
 		void writeNode( DirectoryNode *n, F &f );
@@ -717,10 +1325,29 @@ class StreamIndexedIO::Index : public RefCounted
 		template < typename F >
 		NodeBase *readNodeV4( F &f );
 
+		/// Returns a new directory node, reading its children from the stream.
+		template < typename F >
+		DirectoryNode *readDirectoryNode( const IndexedIO::EntryID &name, F &f );
+
+		/// Overload which creates a DeferredIndex node when reading from the retained main index.
+		DirectoryNode *readDirectoryNode( const IndexedIO::EntryID &name, MemoryReader &f );
+
+		/// Advances the reader past the children of a directory node, without creating them.
+		void skipNodeChildren( MemoryReader &f );
+
+		/// Reads the children of a DeferredIndex node from the retained main index.
+		void readDeferredChildren( DirectoryNode *n );
+
+		size_t memoryUsage( NodeBase *n ) const;
+
 		/// Replace the contents of this node with data read from a stream.
 		/// Returns a newly created Node.
 		template < typename F >
 		NodeBase *readNode( F &f );
+
+		/// Reads a NodeCount followed by that many child nodes, registering them with n.
+		template < typename F >
+		void readNodeChildren( DirectoryNode *n, F &f );
 };
 
 ///////////////////////////////////////////////
@@ -869,7 +1496,7 @@ DirectoryNode* StreamIndexedIO::Node::directoryChild( const IndexedIO::EntryID &
 		{
 			DirectoryNode *dir = static_cast< DirectoryNode *>( (*it) );
 
-			if ( dir->subindex() == DirectoryNode::SavedSubIndex )
+			if ( dir->subindex() == DirectoryNode::SavedSubIndex || dir->subindex() == DirectoryNode::DeferredIndex )
 			{
 				if ( m_node->subindexChildren() )
 				{
@@ -915,7 +1542,7 @@ DirectoryNode* StreamIndexedIO::Node::directoryChild( const IndexedIO::EntryID &
 	return 0;
 }
 
-bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size ) const
+bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size, bool &compressed ) const
 {
 	Index::MutexLock lock;
 	m_idx->lockDirectory( lock, m_node );
@@ -930,6 +1557,7 @@ bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_
 			DataNode *n = static_cast< DataNode *>( p );
 			offset = n->offset();
 			size = n->size();
+			compressed = n->compressed();
 			return true;
 		}
 		else if ( p->nodeType() == NodeBase::SmallData )
@@ -937,12 +1565,52 @@ bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_
 			SmallDataNode *n = static_cast< SmallDataNode *>( p );
 			offset = n->offset();
 			size = n->size();
+			compressed = n->compressed();
 			return true;
 		}
 	}
 	return false;
 }
 
+void StreamIndexedIO::Node::dataChildInfo( const IndexedIO::ArrayList &arrays, std::vector<size_t> &offsets, std::vector<size_t> &sizes, std::vector<bool> &compressed ) const
+{
+	offsets.resize( arrays.size() );
+	sizes.resize( arrays.size() );
+	compressed.resize( arrays.size() );
+
+	Index::MutexLock lock;
+	m_idx->lockDirectory( lock, m_node );
+
+	for ( size_t i = 0; i < arrays.size(); i++ )
+	{
+		NodeBase *p = 0;
+		DirectoryNode::ChildMap::const_iterator cit = m_node->findChild( arrays[i].name );
+		if ( cit != m_node->children().end() )
+		{
+			p = *cit;
+		}
+
+		if ( p && p->nodeType() == NodeBase::Data )
+		{
+			DataNode *n = static_cast< DataNode *>( p );
+			offsets[i] = n->offset();
+			sizes[i] = n->size();
+			compressed[i] = n->compressed();
+		}
+		else if ( p && p->nodeType() == NodeBase::SmallData )
+		{
+			SmallDataNode *n = static_cast< SmallDataNode *>( p );
+			offsets[i] = n->offset();
+			sizes[i] = n->size();
+			compressed[i] = n->compressed();
+		}
+		else
+		{
+			throw IOException( "StreamIndexedIO::readArrays: Data entry not found '" + arrays[i].name.value() + "'" );
+		}
+	}
+}
+
 DirectoryNode* StreamIndexedIO::Node::addChild( const IndexedIO::EntryID &childName )
 {
 	if ( m_node->subindex() )
@@ -969,7 +1637,7 @@ DirectoryNode* StreamIndexedIO::Node::addChild( const IndexedIO::EntryID &childN
 	return child;
 }
 
-void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size )
+void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size, bool compressed )
 {
 	if ( m_node->subindex() )
 	{
@@ -985,7 +1653,7 @@ void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, I
 
 	if ( arrayLen <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize )
 	{
-		SmallDataNode* child = new SmallDataNode(childName, dataType, arrayLen, size, offset);
+		SmallDataNode* child = new SmallDataNode(childName, dataType, arrayLen, size, offset, compressed);
 		if ( !child )
 		{
 			throw Exception( "Failed to allocate node!" );
@@ -994,7 +1662,7 @@ void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, I
 	}
 	else
 	{
-		DataNode* child = new DataNode(childName, dataType, arrayLen, size, offset);
+		DataNode* child = new DataNode(childName, dataType, arrayLen, size, offset, compressed);
 		if ( !child )
 		{
 			throw Exception( "Failed to allocate node!" );
@@ -1075,7 +1743,8 @@ void StreamIndexedIO::Node::removeChild( const IndexedIO::EntryID &childName, bo
 //
 ///////////////////////////////////////////////
 
-StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream ) : m_root(0), m_version(g_currentVersion), m_hasChanged(false), m_offset(0), m_next(0), m_stream(stream)
+StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream ) : m_root(0), m_version(g_compatibleVersion), m_compression(g_defaultCompression),
+	m_dataCompression(false), m_dataCodec(StreamIndexedIO::Gzip), m_dataShuffle(true), m_dataCompressionMinSize(0), m_hasSubIndices(false), m_hasChanged(false), m_offset(0), m_next(0), m_fileVersion(0), m_fileSize(0), m_indexSize(0), m_stream(stream)
 {
 	m_stringCache.add(IndexedIO::rootName);
 }
@@ -1123,6 +1792,7 @@ void StreamIndexedIO::Index::openStream()
 
 		f.seekg( 0, std::ios::end );
 		Imf::Int64 end = f.tellg();
+		m_fileSize = end;
 		f.seekg( end-1*sizeof(Imf::Int64), std::ios::beg );
 
 		Imf::Int64 magicNumber = 0;
@@ -1147,9 +1817,37 @@ void StreamIndexedIO::Index::openStream()
 			throw IOException("Not a StreamIndexedIO file");
 		}
 
+		if ( m_version > g_currentVersion )
+		{
+			throw IOException( ( boost::format( "StreamIndexedIO: File version %d is newer than the latest supported version %d." ) % m_version % g_currentVersion ).str() );
+		}
+
+		m_fileVersion = m_version;
+		m_indexSize = end - m_offset;
+
 		f.seekg( m_offset, std::ios::beg );
 
-		if (m_version >= 2 )
+		if ( m_version >= 6 )
+		{
+			std::vector<char> compressedIndex( end - m_offset );
+			f.read( &compressedIndex[0], compressedIndex.size() );
+			std::vector<char> index;
+			decompressBlock( &compressedIndex[0], compressedIndex.size(), index );
+
+			if ( m_stream->openMode() & IndexedIO::LazyIndex )
+			{
+				// keep the index, so that directories can be read from it when accessed
+				m_deferredIndex.swap( index );
+				MemoryReader reader( &m_deferredIndex[0], m_deferredIndex.size() );
+				read( reader );
+			}
+			else
+			{
+				MemoryReader reader( &index[0], index.size() );
+				read( reader );
+			}
+		}
+		else if (m_version >= 2 )
 		{
 			io::filtering_istream decompressingStream;
 			char *compressedIndex = new char[ end - m_offset ];
@@ -1165,12 +1863,30 @@ void StreamIndexedIO::Index::openStream()
 		{
 			read( f );
 		}
+
+		if ( m_version < g_compatibleVersion )
+		{
+			// Older files have no subindices, so when appending we can rewrite
+			// the whole index using the compatible version. Later versions keep
+			// their own version, so that their existing subindex blocks remain
+			// readable alongside any new ones.
+			m_version = g_compatibleVersion;
+		}
+		else
+		{
+			m_hasSubIndices = true;
+		}
 	}
 	else
 	{
 		// creating a new empty Index
 		m_root = new DirectoryNode(IndexedIO::rootName);
 		m_hasChanged = true;
+
+		if ( m_compression != StreamIndexedIO::Gzip )
+		{
+			m_version = g_currentVersion;
+		}
 	}
 }
 
@@ -1337,7 +2053,8 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 		IndexedIO::DataType dataType = IndexedIO::Invalid;
 		Imf::Int64 arrayLength = 0;
 		f.read( &t, sizeof(char) );
-		dataType = (IndexedIO::DataType)t;
+		const bool compressed = (unsigned char)t & COMPRESSED_DATA;
+		dataType = (IndexedIO::DataType)( (unsigned char)t & ~COMPRESSED_DATA );
 	
 		if ( IndexedIO::Entry::isArray( dataType ) )
 		{
@@ -1350,30 +2067,18 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 
 		if ( arrayLength <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize )
 		{
-			SmallDataNode *n = new SmallDataNode( m_stringCache.findById( stringId ), dataType, arrayLength, size, offset );
+			SmallDataNode *n = new SmallDataNode( m_stringCache.findById( stringId ), dataType, arrayLength, size, offset, compressed );
 			return n;
 		}
 		else
 		{
-			DataNode *n = new DataNode( m_stringCache.findById( stringId ), dataType, arrayLength, size, offset );
+			DataNode *n = new DataNode( m_stringCache.findById( stringId ), dataType, arrayLength, size, offset, compressed );
 			return n;
 		}
 	}
 	else if ( entryType == IndexedIO::Directory )
 	{
-		DirectoryNode *n = new DirectoryNode( m_stringCache.findById( stringId ) );
-
-		uint32_t nodeCount = 0;
-		readLittleEndian( f, nodeCount );
-
-		for ( uint32_t c = 0; c < nodeCount; c++ )
-		{
-			NodeBase *child = readNode( f );
-			n->registerChild( child );
-		}
-		// force sorting all children so that read-only is multi-threaded
-		n->sortChildren();
-		return n;
+		return readDirectoryNode( m_stringCache.findById( stringId ), f );
 	}
 	else if ( entryType == SUBINDEX_DIR )
 	{
@@ -1388,12 +2093,97 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 	}
 }
 
+template < typename F >
+DirectoryNode *StreamIndexedIO::Index::readDirectoryNode( const IndexedIO::EntryID &name, F &f )
+{
+	DirectoryNode *n = new DirectoryNode( name );
+
+	readNodeChildren( n, f );
+
+	// force sorting all children so that read-only is multi-threaded
+	n->sortChildren();
+	return n;
+}
+
+DirectoryNode *StreamIndexedIO::Index::readDirectoryNode( const IndexedIO::EntryID &name, MemoryReader &f )
+{
+	if ( m_deferredIndex.empty() || f.data() != &m_deferredIndex[0] )
+	{
+		return readDirectoryNode<MemoryReader>( name, f );
+	}
+
+	DirectoryNode *n = new DirectoryNode( name, f.tell() );
+	skipNodeChildren( f );
+	return n;
+}
+
+void StreamIndexedIO::Index::skipNodeChildren( MemoryReader &f )
+{
+	uint32_t nodeCount = 0;
+	readLittleEndian( f, nodeCount );
+
+	for ( uint32_t i = 0; i < nodeCount; i++ )
+	{
+		char entryType;
+		f.read( &entryType, sizeof(char) );
+		// EntryStringCacheID
+		f.skip( sizeof(Imf::Int64) );
+
+		if ( entryType == IndexedIO::File )
+		{
+			char t;
+			f.read( &t, sizeof(char) );
+			const IndexedIO::DataType dataType = (IndexedIO::DataType)( (unsigned char)t & ~COMPRESSED_DATA );
+			// ArrayLength, DataOffset and DataSize
+			f.skip( ( IndexedIO::Entry::isArray( dataType ) ? 3 : 2 ) * sizeof(Imf::Int64) );
+		}
+		else if ( entryType == IndexedIO::Directory )
+		{
+			skipNodeChildren( f );
+		}
+		else if ( entryType == SUBINDEX_DIR )
+		{
+			f.skip( sizeof(Imf::Int64) );
+		}
+		else
+		{
+			throw IOException( "Invalid EntryType!" );
+		}
+	}
+}
+
+void StreamIndexedIO::Index::readDeferredChildren( DirectoryNode *n )
+{
+	MemoryReader reader( &m_deferredIndex[0], m_deferredIndex.size() );
+	reader.seek( n->offset() );
+	readNodeChildren( n, reader );
+
+	/// make sure the children is sorted to avoid non-thread safe sorting happening later...
+	n->sortChildren();
+
+	/// mark the node as loaded
+	n->recoveredSubIndex();
+}
+
+template < typename F >
+void StreamIndexedIO::Index::readNodeChildren( DirectoryNode *n, F &f )
+{
+	uint32_t nodeCount = 0;
+	readLittleEndian( f, nodeCount );
+
+	for ( uint32_t i = 0; i < nodeCount; i++ )
+	{
+		NodeBase *child = readNode( f );
+		n->registerChild( child );
+	}
+}
+
 template < typename F >
 void StreamIndexedIO::Index::read( F &f )
 {
 	if (m_version >= 1)
 	{
-		m_stringCache = StringCache( f );
+		m_stringCache = StringCache( f, m_version );
 	}
 
 	if ( m_version >= 5 )
@@ -1405,6 +2195,12 @@ void StreamIndexedIO::Index::read( F &f )
 		{
 			throw Exception( "StreamIndexedIO::Index::read - Root node is not a directory!!" );
 		}
+
+		if ( m_root->subindex() == DirectoryNode::DeferredIndex )
+		{
+			// the root is always resident
+			readDeferredChildren( m_root );
+		}
 	}
 	else
 	{
@@ -1498,6 +2294,10 @@ void StreamIndexedIO::Index::writeDataNode( D *node, F &f )
 	writeLittleEndian( f, id );
 
 	t = node->dataType();
+	if ( node->compressed() )
+	{
+		t |= COMPRESSED_DATA;
+	}
 	f.write( &t, sizeof(char) );
 
 	if ( IndexedIO::Entry::isArray(node->dataType()) )
@@ -1592,43 +2392,33 @@ Imf::Int64 StreamIndexedIO::Index::write()
 
 	m_offset = indexStart;
 
-	MemoryStreamSink sink;
-	io::filtering_ostream compressingStream;
-	compressingStream.push( io::gzip_compressor() );
-	compressingStream.push( sink );
-	assert( compressingStream.is_complete() );
+	MemoryWriter writer;
 
-	m_stringCache.write( compressingStream );
+	m_stringCache.write( writer, m_version );
 
-	writeNode( m_root, compressingStream );
+	writeNode( m_root, writer );
 
 	assert( m_freePagesOffset.size() == m_freePagesSize.size() );
 	Imf::Int64 numFreePages = m_freePagesSize.size();
 
 	// Write out number of free "pages"
-	writeLittleEndian( compressingStream, numFreePages);
+	writeLittleEndian( writer, numFreePages);
 
 	/// Write out each free page
 	for ( FreePagesSizeMap::const_iterator it = m_freePagesSize.begin(); it != m_freePagesSize.end(); ++it)
 	{
-		writeLittleEndian( compressingStream, it->second->m_offset );
-		writeLittleEndian( compressingStream, it->second->m_size );
+		writeLittleEndian( writer, it->second->m_offset );
+		writeLittleEndian( writer, it->second->m_size );
 	}
 
-	/// To synchronize/close, etc.
-	compressingStream.pop();
-	compressingStream.pop();
-
-	char *data=0;
-	std::streamsize sz;
-	sink.get( data, sz );
-	assert( data );
-	assert( sz > 0 );
+	std::vector<char> data;
+	compress( writer.data(), data );
+	assert( data.size() > 0 );
 
-	f.write( data, sz );
+	f.write( &data[0], data.size() );
 
 	writeLittleEndian( f, m_offset );
-	writeLittleEndian( f, g_currentVersion );
+	writeLittleEndian( f, m_version );
 	writeLittleEndian( f, g_versionedMagicNumber );
 
 	m_hasChanged = false;
@@ -1636,6 +2426,146 @@ Imf::Int64 StreamIndexedIO::Index::write()
 	return f.tellp();
 }
 
+void StreamIndexedIO::Index::compress( const std::vector<char> &data, std::vector<char> &result ) const
+{
+	if ( m_version >= 6 )
+	{
+		compressBlock( m_compression, &data[0], data.size(), result );
+	}
+	else
+	{
+		gzipCompress( &data[0], data.size(), result );
+	}
+}
+
+bool StreamIndexedIO::Index::requireVersion( Imf::Int64 version )
+{
+	if ( m_version >= version )
+	{
+		return true;
+	}
+
+	if ( m_version < 6 && m_hasSubIndices )
+	{
+		// the gzipped subindex blocks of version 5 can't be mixed with
+		// the codec prefixed blocks of later versions.
+		return false;
+	}
+
+	m_version = g_currentVersion;
+	return true;
+}
+
+void StreamIndexedIO::Index::setCompression( StreamIndexedIO::Compression compression )
+{
+	if ( !StreamIndexedIO::compressionAvailable( compression ) )
+	{
+		throw InvalidArgumentException( "StreamIndexedIO: Compression is not available in this build." );
+	}
+	if ( compression != StreamIndexedIO::Gzip && !requireVersion( 6 ) )
+	{
+		throw InvalidArgumentException( "StreamIndexedIO: Compression is not supported by the version of the file being appended to." );
+	}
+	m_compression = compression;
+}
+
+StreamIndexedIO::Compression StreamIndexedIO::Index::getCompression() const
+{
+	return m_compression;
+}
+
+void StreamIndexedIO::Index::setDataCompression( bool enabled, StreamIndexedIO::Compression compression, bool shuffle, size_t minSize )
+{
+	if ( enabled )
+	{
+		if ( !StreamIndexedIO::compressionAvailable( compression ) )
+		{
+			throw InvalidArgumentException( "StreamIndexedIO: Compression is not available in this build." );
+		}
+
+		if ( !requireVersion( 7 ) )
+		{
+			throw InvalidArgumentException( "StreamIndexedIO: Data compression is not supported by the version of the file being appended to." );
+		}
+	}
+
+	m_dataCompression = enabled;
+	m_dataCodec = compression;
+	m_dataShuffle = shuffle;
+	m_dataCompressionMinSize = minSize;
+}
+
+bool StreamIndexedIO::Index::getDataCompression() const
+{
+	return m_dataCompression;
+}
+
+Imf::Int64 StreamIndexedIO::Index::writeData( const char *data, size_t size, size_t elementSize, size_t &storedSize, bool &compressed )
+{
+	compressed = false;
+	storedSize = size;
+
+	if ( m_dataCompression && size && size >= m_dataCompressionMinSize )
+	{
+		const unsigned char shuffleSize = ( m_dataShuffle && elementSize > 1 && elementSize <= 255 ) ? elementSize : 1;
+
+		std::vector<char> block;
+		block.push_back( shuffleSize );
+		if ( shuffleSize > 1 )
+		{
+			std::vector<char> shuffled( size );
+			shuffleBytes( data, size, shuffleSize, &shuffled[0] );
+			compressBlock( m_dataCodec, &shuffled[0], size, block );
+		}
+		else
+		{
+			compressBlock( m_dataCodec, data, size, block );
+		}
+
+		// incompressible data is stored as is, so that it can still be read directly.
+		if ( block.size() < size )
+		{
+			compressed = true;
+			storedSize = block.size();
+			return writeUniqueData( &block[0], block.size() );
+		}
+	}
+
+	return writeUniqueData( data, size );
+}
+
+void StreamIndexedIO::Index::readCompressedData( Imf::Int64 offset, size_t storedSize, std::vector<char> &result ) const
+{
+	if ( storedSize < 1 )
+	{
+		throw IOException( "StreamIndexedIO: Invalid compressed data entry!" );
+	}
+
+	ReadBuffer buffer( storedSize );
+	const char *block = m_stream->mappedData( offset, storedSize );
+	if ( !block )
+	{
+		m_stream->readAt( buffer.get(), storedSize, offset );
+		block = buffer.get();
+	}
+
+	const unsigned char shuffleSize = block[0];
+	if ( shuffleSize > 1 )
+	{
+		std::vector<char> shuffled;
+		decompressBlock( block + 1, storedSize - 1, shuffled );
+		result.resize( shuffled.size() );
+		if ( !shuffled.empty() )
+		{
+			unshuffleBytes( &shuffled[0], shuffled.size(), shuffleSize, &result[0] );
+		}
+	}
+	else
+	{
+		decompressBlock( block + 1, storedSize - 1, result );
+	}
+}
+
 Imf::Int64 StreamIndexedIO::Index::allocate( Imf::Int64 sz )
 {
 	Imf::Int64 loc = 0;
@@ -1879,6 +2809,53 @@ Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t siz
 	return loc;
 }
 
+void StreamIndexedIO::Index::writeUniqueData( const std::vector<const char *> &data, const std::vector<size_t> &sizes, std::vector<Imf::Int64> &offsets )
+{
+	m_hasChanged = true;
+
+	// find the blocks which haven't been stored already. We keep the map iterator for
+	// every block, so that duplicates within the batch share the offset of the first.
+	std::vector< HashToDataMap::iterator > entries( data.size() );
+	std::vector< size_t > newBlocks;
+	Imf::Int64 totalSize = 0;
+	for ( size_t i = 0; i < data.size(); i++ )
+	{
+		if ( sizes[i] >= UINT32_MAX )
+		{
+			throw IOException( "StreamIndexedIO: Data size too long!" );
+		}
+
+		MurmurHash hash;
+		hash.append( data[i], sizes[i] );
+
+		std::pair< HashToDataMap::iterator,bool > ret = m_hashToDataMap.insert( HashToDataMap::value_type( std::pair< MurmurHash,Imf::Int64>(hash,sizes[i]), 0 ) );
+		entries[i] = ret.first;
+		if ( ret.second )
+		{
+			newBlocks.push_back( i );
+			totalSize += sizes[i];
+		}
+	}
+
+	if ( newBlocks.size() )
+	{
+		Imf::Int64 loc = allocate( totalSize );
+		m_stream->seekp( loc, std::ios::beg );
+		for ( std::vector< size_t >::const_iterator it = newBlocks.begin(); it != newBlocks.end(); ++it )
+		{
+			entries[*it]->second = loc;
+			m_stream->write( data[*it], sizes[*it] );
+			loc += sizes[*it];
+		}
+	}
+
+	offsets.resize( data.size() );
+	for ( size_t i = 0; i < data.size(); i++ )
+	{
+		offsets[i] = entries[i]->second;
+	}
+}
+
 void StreamIndexedIO::Index::deallocateWalk( NodeBase* n )
 {
 	assert(n);
@@ -1914,24 +2891,15 @@ void StreamIndexedIO::Index::commitNodeToSubIndex( DirectoryNode *n )
 
 	if ( n->subindex() == DirectoryNode::NoSubIndex )
 	{
-		MemoryStreamSink sink;
-		io::filtering_ostream compressingStream;
-		compressingStream.push( io::gzip_compressor() );
-		compressingStream.push( sink );
-		assert( compressingStream.is_complete() );
-
-		writeNodeChildren( n, compressingStream );
-
-		compressingStream.pop();
-		compressingStream.pop();
+		MemoryWriter writer;
+		writeNodeChildren( n, writer );
 
-		char *data=0;
-		std::streamsize sz;
-		sink.get( data, sz );
-		uint32_t subindexSize = sz;
+		std::vector<char> data;
+		compress( writer.data(), data );
 
 		// tell the Directory node that it's contents have been written as a subindex		
-		n->setSubIndexOffset( writeUniqueData( data, subindexSize, true ) );
+		n->setSubIndexOffset( writeUniqueData( &data[0], data.size(), true ) );
+		m_hasSubIndices = true;
 	}
 }
 
@@ -1945,35 +2913,141 @@ void StreamIndexedIO::Index::readNodeFromSubIndex( DirectoryNode *n )
 		return;
 	}
 
-	m_stream->seekg( n->offset(), std::ios::beg );
+	if ( n->subindex() == DirectoryNode::DeferredIndex )
+	{
+		readDeferredChildren( n );
+		return;
+	}
 
 	uint32_t subindexSize = 0;
-	readLittleEndian( *m_stream, subindexSize );
+	const char *data = m_stream->mappedData( n->offset(), sizeof( subindexSize ) );
+	if ( data )
+	{
+		// the file is mapped, so we can decompress straight from it
+		memcpy( &subindexSize, data, sizeof( subindexSize ) );
+		if ( bigEndian() )
+		{
+			subindexSize = reverseBytes<>( subindexSize );
+		}
+		data = m_stream->mappedData( n->offset() + sizeof( subindexSize ), subindexSize );
+	}
+	else
+	{
+		m_stream->seekg( n->offset(), std::ios::beg );
+		readLittleEndian( *m_stream, subindexSize );
+
+		char *buffer = m_stream->ioBuffer(subindexSize);
+		m_stream->read( buffer, subindexSize );
+		data = buffer;
+	}
+
+	if ( m_version >= 6 )
+	{
+		std::vector<char> subindex;
+		decompressBlock( data, subindexSize, subindex );
+		MemoryReader reader( &subindex[0], subindex.size() );
+		readNodeChildren( n, reader );
+	}
+	else
+	{
+		io::filtering_istream decompressingStream;
+		MemoryStreamSource source( const_cast<char *>( data ), subindexSize, false );
+		decompressingStream.push( io::gzip_decompressor() );
+		decompressingStream.push( source );
+		assert( decompressingStream.is_complete() );
 
-	char *data = m_stream->ioBuffer(subindexSize);
-	m_stream->read( data, subindexSize );
+		readNodeChildren( n, decompressingStream );
+	}
 
-	io::filtering_istream decompressingStream;
-	MemoryStreamSource source( data, subindexSize, false );
-	decompressingStream.push( io::gzip_decompressor() );
-	decompressingStream.push( source );
-	assert( decompressingStream.is_complete() );
+	/// make sure the children is sorted to avoid non-thread safe sorting happening later...
+	n->sortChildren();
 
-	uint32_t nodeCount = 0;
+	/// mark the node as loaded from subindex
+	n->recoveredSubIndex();
+}
+
+size_t StreamIndexedIO::Index::compressedDataSize( Imf::Int64 offset, size_t storedSize ) const
+{
+	// the shuffle size, followed by the header of the compressed block
+	char header[ 2 * sizeof( char ) + sizeof( Imf::Int64 ) ];
+	if ( storedSize < sizeof( header ) )
+	{
+		throw IOException( "StreamIndexedIO: Invalid compressed data entry!" );
+	}
+
+	const char *block = m_stream->mappedData( offset, sizeof( header ) );
+	if ( !block )
+	{
+		m_stream->readAt( header, sizeof( header ), offset );
+		block = header;
+	}
+
+	Imf::Int64 uncompressedSize = 0;
+	memcpy( &uncompressedSize, block + 2, sizeof( uncompressedSize ) );
+	return asLittleEndian<Imf::Int64>( uncompressedSize );
+}
+
+void StreamIndexedIO::Index::fileStorage( StreamIndexedIO::FileStorage &storage ) const
+{
+	storage.version = m_fileVersion;
+	storage.fileSize = m_fileSize;
+	storage.indexSize = m_indexSize;
+	storage.numStrings = m_stringCache.size();
+	storage.stringTableSize = m_stringCache.stringsSize();
+}
+
+size_t StreamIndexedIO::Index::memoryUsage() const
+{
+	size_t result = sizeof( *this ) + m_deferredIndex.capacity() + m_stringCache.memoryUsage();
+	result += m_removedNodes.capacity() * sizeof( NodeBase * );
+	result += m_freePagesOffset.size() * ( sizeof( FreePage ) + sizeof( FreePagesOffsetMap::value_type ) + sizeof( FreePagesSizeMap::value_type ) );
+	if ( m_root )
+	{
+		result += memoryUsage( m_root );
+	}
+	return result;
+}
+
+size_t StreamIndexedIO::Index::memoryUsage( NodeBase *n ) const
+{
+	switch( n->nodeType() )
+	{
+		case NodeBase::Data :
+			return sizeof( DataNode );
+		case NodeBase::SmallData :
+			return sizeof( SmallDataNode );
+		case NodeBase::SubIndex :
+			return sizeof( SubIndexNode );
+		case NodeBase::Directory :
+			break;
+		default :
+			throw Exception( "Unknown node type!" );
+	}
+
+	DirectoryNode *dir = static_cast< DirectoryNode * >( n );
+	size_t result = sizeof( DirectoryNode );
 
-	readLittleEndian( decompressingStream, nodeCount );
-	
-	for ( uint32_t i = 0; i < nodeCount; i++ )
+	const DirectoryNode::SubIndexMode mode = dir->subindex();
+	if ( mode != DirectoryNode::NoSubIndex && mode != DirectoryNode::LoadedSubIndex )
 	{
-		NodeBase *child = readNode( decompressingStream );
-		n->registerChild( child );
+		// the children are not resident
+		return result;
 	}
 
-	/// make sure the children is sorted to avoid non-thread safe sorting happening later...
-	n->sortChildren();
+	// we don't recurse while holding the lock, as the children may share its mutex
+	DirectoryNode::ChildMap children;
+	{
+		MutexLock lock;
+		lockDirectory( lock, dir );
+		children = dir->children();
+		result += dir->children().capacity() * sizeof( NodeBase * );
+	}
 
-	/// mark the node as loaded from subindex
-	n->recoveredSubIndex();
+	for ( DirectoryNode::ChildMap::const_iterator it = children.begin(); it != children.end(); ++it )
+	{
+		result += memoryUsage( *it );
+	}
+	return result;
 }
 
 void StreamIndexedIO::Index::lockDirectory( MutexLock &lock, const DirectoryNode *n, bool writeAccess ) const
@@ -2000,7 +3074,7 @@ void StreamIndexedIO::Index::lockDirectory( MutexLock &lock, const DirectoryNode
 //
 ///////////////////////////////////////////////
 
-StreamIndexedIO::StreamFile::StreamFile( IndexedIO::OpenMode mode ) : m_openmode(mode), m_stream(0), m_ioBufferLen(0), m_ioBuffer(0)
+StreamIndexedIO::StreamFile::StreamFile( IndexedIO::OpenMode mode ) : m_openmode(mode), m_stream(0), m_mappedData(0), m_mappedSize(0), m_ioBufferLen(0), m_ioBuffer(0)
 {
 	IndexedIO::validateOpenMode(m_openmode);
 }
@@ -2031,6 +3105,25 @@ void StreamIndexedIO::StreamFile::setStream( std::iostream *stream, bool emptyFi
 	}
 }
 
+void StreamIndexedIO::StreamFile::setMappedData( const char *data, size_t size )
+{
+	m_mappedData = data;
+	m_mappedSize = size;
+}
+
+const char *StreamIndexedIO::StreamFile::mappedData( Imf::Int64 pos, size_t size ) const
+{
+	if ( !m_mappedData )
+	{
+		return 0;
+	}
+	if ( pos + size > m_mappedSize )
+	{
+		throw IOException( "StreamIndexedIO: Attempt to read beyond the end of the mapped file!" );
+	}
+	return m_mappedData + pos;
+}
+
 char *StreamIndexedIO::StreamFile::ioBuffer( unsigned long size )
 {
 	if ( !m_ioBuffer )
@@ -2113,6 +3206,19 @@ void StreamIndexedIO::StreamFile::write( const char *buffer, size_t size )
 	m_stream->write( buffer, size );
 }
 
+void StreamIndexedIO::StreamFile::readAt( char *buffer, size_t size, Imf::Int64 pos )
+{
+	if ( const char *mapped = mappedData( pos, size ) )
+	{
+		memcpy( buffer, mapped, size );
+		return;
+	}
+
+	MutexLock lock( m_mutex );
+	m_stream->seekg( pos, std::ios::beg );
+	m_stream->read( buffer, size );
+}
+
 ///////////////////////////////////////////////
 //
 // StreamIndexedIO::StreamFile (end)
@@ -2197,6 +3303,87 @@ void StreamIndexedIO::setRoot( const IndexedIO::EntryIDList &root )
 	assert( m_node );
 }
 
+void StreamIndexedIO::setCompression( Compression compression )
+{
+	m_node->m_idx->setCompression( compression );
+}
+
+StreamIndexedIO::Compression StreamIndexedIO::getCompression() const
+{
+	return m_node->m_idx->getCompression();
+}
+
+void StreamIndexedIO::setDefaultCompression( Compression compression )
+{
+	if ( !compressionAvailable( compression ) )
+	{
+		throw InvalidArgumentException( "StreamIndexedIO: Compression is not available in this build." );
+	}
+	g_defaultCompression = compression;
+}
+
+StreamIndexedIO::Compression StreamIndexedIO::getDefaultCompression()
+{
+	return g_defaultCompression;
+}
+
+bool StreamIndexedIO::compressionAvailable( Compression compression )
+{
+	switch( compression )
+	{
+		case Gzip :
+			return true;
+		case LZ4 :
+#ifdef IECORE_WITH_LZ4
+			return true;
+#else
+			return false;
+#endif
+		case Zstd :
+#ifdef IECORE_WITH_ZSTD
+			return true;
+#else
+			return false;
+#endif
+		default :
+			return false;
+	}
+}
+
+void StreamIndexedIO::setDataCompression( bool enabled, Compression compression, bool shuffle, size_t minSize )
+{
+	m_node->m_idx->setDataCompression( enabled, compression, shuffle, minSize );
+}
+
+bool StreamIndexedIO::getDataCompression() const
+{
+	return m_node->m_idx->getDataCompression();
+}
+
+size_t StreamIndexedIO::indexMemoryUsage() const
+{
+	return m_node->m_idx->memoryUsage();
+}
+
+StreamIndexedIO::EntryStorage StreamIndexedIO::entryStorage( const IndexedIO::EntryID &name ) const
+{
+	EntryStorage result;
+	if ( !m_node->dataChildInfo( name, result.offset, result.storedSize, result.compressed ) )
+	{
+		throw IOException( "StreamIndexedIO::entryStorage: Data entry not found '" + name.value() + "'" );
+	}
+
+	result.dataSize = result.compressed ? m_node->m_idx->compressedDataSize( result.offset, result.storedSize ) : result.storedSize;
+	return result;
+}
+
+StreamIndexedIO::FileStorage StreamIndexedIO::fileStorage() const
+{
+	FileStorage result;
+	m_node->m_idx->fileStorage( result );
+	return result;
+}
+
 void StreamIndexedIO::flush()
 {
 	m_node->m_idx->flush();
@@ -2451,6 +3638,7 @@ void StreamIndexedIO::commit()
 
 void StreamIndexedIO::write(const IndexedIO::EntryID &name, const InternedString *x, unsigned long arrayLength)
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::write" );
 	writable(name);
 	remove(name, false);
 
@@ -2473,21 +3661,25 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const InternedString
 
 	IndexedIO::DataFlattenTraits<Imf::Int64*>::flatten(constIds, arrayLength, data);
 
-	size_t offset = index->writeUniqueData( data, size );
+	size_t storedSize = 0;
+	bool compressed = false;
+	size_t offset = index->writeData( data, size, sizeof( Imf::Int64 ), storedSize, compressed );
 
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	m_node->addDataChild( name, dataType, arrayLength, offset, storedSize, compressed );
 
 	delete [] ids;
 }
 
 void StreamIndexedIO::read(const IndexedIO::EntryID &name, InternedString *&x, unsigned long arrayLength) const
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::read" );
 	assert( m_node );
 	readable(name);
 
 	Imf::Int64 dataOffset(0), dataSize(0);
+	bool compressed = false;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, compressed ) )
 	{
 		throw IOException( "StreamIndexedIO::read : Data entry not found '" + name.value() + "'" );
 	}
@@ -2495,20 +3687,36 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, InternedString *&x, u
 	Imf::Int64 *ids = new Imf::Int64[arrayLength];
 
 	StreamIndexedIO::StreamFile &f = streamFile();
+	if ( compressed )
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
-
-#ifdef IE_CORE_LITTLE_ENDIAN
-		// raw read
-		f.read( (char*)ids, dataSize );
+		std::vector<char> data;
+		m_node->m_idx->readCompressedData( dataOffset, dataSize, data );
+		if ( data.size() != arrayLength * sizeof( Imf::Int64 ) )
+		{
+			delete [] ids;
+			throw IOException( "StreamIndexedIO::read : Unexpected size for data entry '" + name.value() + "'" );
+		}
+		IndexedIO::DataFlattenTraits<Imf::Int64*>::unflatten( &data[0], ids, arrayLength );
 	}
+	else if ( const char *mapped = f.mappedData( dataOffset, dataSize ) )
+	{
+#ifdef IE_CORE_LITTLE_ENDIAN
+		memcpy( ids, mapped, dataSize );
 #else
-		char *data = f.ioBuffer(dataSize);
-		f.read( data, dataSize );
+		IndexedIO::DataFlattenTraits<Imf::Int64*>::unflatten( mapped, ids, arrayLength );
+#endif
 	}
-	IndexedIO::DataFlattenTraits<Imf::Int64*>::unflatten( data, ids, arrayLength );
+	else
+	{
+#ifdef IE_CORE_LITTLE_ENDIAN
+		// raw read
+		f.readAt( (char*)ids, dataSize, dataOffset );
+#else
+		ReadBuffer data( dataSize );
+		f.readAt( data.get(), dataSize, dataOffset );
+		IndexedIO::DataFlattenTraits<Imf::Int64*>::unflatten( data.get(), ids, arrayLength );
 #endif
+	}
 
 	const StringCache &stringCache = m_node->m_idx->stringCache();
 	if (!x)
@@ -2523,9 +3731,36 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, InternedString *&x, u
 	delete [] ids;
 }
 
+const char *StreamIndexedIO::mappedData( const IndexedIO::EntryID &name, size_t &size ) const
+{
+	assert( m_node );
+	readable(name);
+
+	Imf::Int64 dataOffset(0), dataSize(0);
+	bool compressed = false;
+
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, compressed ) )
+	{
+		throw IOException( "StreamIndexedIO::mappedData: Data entry not found '" + name.value() + "'" );
+	}
+
+	if ( compressed )
+	{
+		return 0;
+	}
+
+	const char *result = streamFile().mappedData( dataOffset, dataSize );
+	if ( result )
+	{
+		size = dataSize;
+	}
+	return result;
+}
+
 template<typename T>
 void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T *x, unsigned long arrayLength)
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::write" );
 	writable(name);
 	remove(name, false);
 
@@ -2536,28 +3771,34 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T *x, unsigned
 	assert(data);
 	IndexedIO::DataFlattenTraits<T*>::flatten(x, arrayLength, data);
 
-	Imf::Int64 offset = m_node->m_idx->writeUniqueData( data, size );
+	size_t storedSize = 0;
+	bool compressed = false;
+	Imf::Int64 offset = m_node->m_idx->writeData( data, size, ShuffleTraits<T>::elementSize(), storedSize, compressed );
 
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	m_node->addDataChild( name, dataType, arrayLength, offset, storedSize, compressed );
 }
 
 template<typename T>
 void StreamIndexedIO::rawWrite(const IndexedIO::EntryID &name, const T *x, unsigned long arrayLength)
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::write" );
 	writable(name);
 	remove(name, false);
 
 	unsigned long size = IndexedIO::DataSizeTraits<T*>::size(x, arrayLength);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T*>::type();
 
-	Imf::Int64 offset =  m_node->m_idx->writeUniqueData( (char*)x, size );
+	size_t storedSize = 0;
+	bool compressed = false;
+	Imf::Int64 offset =  m_node->m_idx->writeData( (char*)x, size, sizeof( T ), storedSize, compressed );
 
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	m_node->addDataChild( name, dataType, arrayLength, offset, storedSize, compressed );
 }
 
 template<typename T>
 void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T &x)
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::write" );
 	writable(name);
 	remove(name, false);
 
@@ -2568,9 +3809,11 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T &x)
 	assert(data);
 	IndexedIO::DataFlattenTraits<T>::flatten(x, data);
 
-	Imf::Int64 offset =  m_node->m_idx->writeUniqueData( data, size );
+	size_t storedSize = 0;
+	bool compressed = false;
+	Imf::Int64 offset =  m_node->m_idx->writeData( data, size, ShuffleTraits<T>::elementSize(), storedSize, compressed );
 
-	m_node->addDataChild( name, dataType, 0, offset, size );
+	m_node->addDataChild( name, dataType, 0, offset, storedSize, compressed );
 }
 
 template<typename T>
@@ -2582,80 +3825,132 @@ void StreamIndexedIO::rawWrite(const IndexedIO::EntryID &name, const T &x)
 	unsigned long size = IndexedIO::DataSizeTraits<T>::size(x);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T>::type();
 
-	Imf::Int64 offset = m_node->m_idx->writeUniqueData( (char*)&x, size );
+	size_t storedSize = 0;
+	bool compressed = false;
+	Imf::Int64 offset = m_node->m_idx->writeData( (char*)&x, size, sizeof( T ), storedSize, compressed );
 
-	m_node->addDataChild( name, dataType, 0, offset, size );
+	m_node->addDataChild( name, dataType, 0, offset, storedSize, compressed );
 }
 
 template<typename T>
 void StreamIndexedIO::read(const IndexedIO::EntryID &name, T *&x, unsigned long arrayLength) const
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::read" );
 	assert( m_node );
 	readable(name);
 
 	Imf::Int64 dataOffset(0), dataSize(0);
+	bool compressed = false;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, compressed ) )
 	{
 		throw IOException( "StreamIndexedIO::read: Data entry not found '" + name.value() + "'" );
 	}
 
 	StreamIndexedIO::StreamFile &f = streamFile();
+	if ( compressed )
+	{
+		std::vector<char> data;
+		m_node->m_idx->readCompressedData( dataOffset, dataSize, data );
+		if ( !FlattenedSizeTraits<T>::valid( data, arrayLength ) )
+		{
+			throw IOException( "StreamIndexedIO::read: Unexpected size for data entry '" + name.value() + "'" );
+		}
+		if (!x)
+		{
+			x = new T[arrayLength];
+		}
+		if ( arrayLength )
+		{
+			IndexedIO::DataFlattenTraits<T*>::unflatten( &data[0], x, arrayLength );
+		}
+	}
+	else if ( const char *mapped = f.mappedData( dataOffset, dataSize ) )
+	{
+		IndexedIO::DataFlattenTraits<T*>::unflatten( mapped, x, arrayLength );
+	}
+	else
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		char *data = f.ioBuffer(dataSize);
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( data, dataSize );
-		IndexedIO::DataFlattenTraits<T*>::unflatten( data, x, arrayLength );
+		ReadBuffer data( dataSize );
+		f.readAt( data.get(), dataSize, dataOffset );
+		IndexedIO::DataFlattenTraits<T*>::unflatten( data.get(), x, arrayLength );
 	}
 }
 
 template<typename T>
 void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T *&x, unsigned long arrayLength) const
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::read" );
 	assert( m_node );
 	readable(name);
 
 	Imf::Int64 dataOffset(0), dataSize(0);
+	bool compressed = false;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, compressed ) )
 	{
 		throw IOException( "StreamIndexedIO::rawRead: Data entry not found '" + name.value() + "'" );
 	}
 
-	if (!x)
+	if ( compressed )
 	{
-		x = new T[arrayLength];
+		std::vector<char> data;
+		m_node->m_idx->readCompressedData( dataOffset, dataSize, data );
+		if ( data.size() != arrayLength * sizeof( T ) )
+		{
+			throw IOException( "StreamIndexedIO::rawRead: Unexpected size for data entry '" + name.value() + "'" );
+		}
+		if (!x)
+		{
+			x = new T[arrayLength];
+		}
+		memcpy( x, &data[0], data.size() );
+		return;
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
+	if (!x)
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( (char*)x, dataSize );
+		x = new T[arrayLength];
 	}
+
+	streamFile().readAt( (char*)x, dataSize, dataOffset );
 }
 
 template<typename T>
 void StreamIndexedIO::read(const IndexedIO::EntryID &name, T &x) const
 {
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::read" );
 	assert( m_node );
 	readable(name);
 
 	Imf::Int64 dataOffset(0), dataSize(0);
+	bool compressed = false;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, compressed ) )
 	{
 		throw IOException( "StreamIndexedIO::read Data entry not found '" + name.value() + "'" );
 	}
 
 	StreamIndexedIO::StreamFile &f = streamFile();
+	if ( compressed )
+	{
+		std::vector<char> data;
+		m_node->m_idx->readCompressedData( dataOffset, dataSize, data );
+		if ( !FlattenedSizeTraits<T>::valid( data ) )
+		{
+			throw IOException( "StreamIndexedIO::read: Unexpected size for data entry '" + name.value() + "'" );
+		}
+		IndexedIO::DataFlattenTraits<T>::unflatten( &data[0], x );
+	}
+	else if ( const char *mapped = f.mappedData( dataOffset, dataSize ) )
+	{
+		IndexedIO::DataFlattenTraits<T>::unflatten( mapped, x );
+	}
+	else
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		char *data = f.ioBuffer(dataSize);
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( data, dataSize );
-		IndexedIO::DataFlattenTraits<T>::unflatten( data, x );
+		ReadBuffer data( dataSize );
+		f.readAt( data.get(), dataSize, dataOffset );
+		IndexedIO::DataFlattenTraits<T>::unflatten( data.get(), x );
 	}
 }
 
@@ -2666,18 +3961,26 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T &x) const
 	readable(name);
 
 	Imf::Int64 dataOffset(0), dataSize(0);
+	bool compressed = false;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, compressed ) )
 	{
 		throw IOException( "StreamIndexedIO::rawRead: Data entry not found '" + name.value() + "'" );
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
+	if ( compressed )
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( (char*)&x, dataSize );
+		std::vector<char> data;
+		m_node->m_idx->readCompressedData( dataOffset, dataSize, data );
+		if ( data.size() != sizeof( T ) )
+		{
+			throw IOException( "StreamIndexedIO::rawRead: Unexpected size for data entry '" + name.value() + "'" );
+		}
+		memcpy( &x, &data[0], sizeof( T ) );
+		return;
 	}
+
+	streamFile().readAt( (char*)&x, dataSize, dataOffset );
 }
 
 #ifdef IE_CORE_LITTLE_ENDIAN
@@ -2688,6 +3991,231 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T &x) const
 #define WRITE	write
 #endif
 
+// Arrays
+
+namespace
+{
+
+// Arrays of strings can't be read or written without flattening them.
+void validateArrays( const IndexedIO::ArrayList &arrays )
+{
+	for ( IndexedIO::ArrayList::const_iterator it = arrays.begin(); it != arrays.end(); ++it )
+	{
+		if ( !IndexedIO::Entry::isArray( it->dataType ) || it->dataType == IndexedIO::StringArray || it->dataType == IndexedIO::InternedStringArray )
+		{
+			throw IOException( "StreamIndexedIO: Unsupported data type for array entry '" + it->name.value() + "'" );
+		}
+	}
+}
+
+// Uncompressed entries closer together than this are read with a single
+// call, discarding the bytes between them.
+const size_t g_maxReadGap = 4096;
+// But we don't want to allocate huge temporary buffers to do so.
+const size_t g_maxCoalescedRead = 16 * 1024 * 1024;
+
+struct OffsetLess
+{
+	OffsetLess( const std::vector<size_t> &offsets ) : m_offsets( offsets )
+	{
+	}
+
+	bool operator()( size_t a, size_t b ) const
+	{
+		return m_offsets[a] < m_offsets[b];
+	}
+
+	const std::vector<size_t> &m_offsets;
+};
+
+} // namespace
+
+void StreamIndexedIO::writeArrays( const IndexedIO::ArrayList &arrays )
+{
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::writeArrays" );
+#ifdef IE_CORE_LITTLE_ENDIAN
+	validateArrays( arrays );
+
+	Index *index = m_node->m_idx.get();
+	if ( index->getDataCompression() )
+	{
+		// each entry is compressed individually, so there's nothing to be gained
+		IndexedIO::writeArrays( arrays );
+		return;
+	}
+
+	std::vector<const char *> data( arrays.size() );
+	std::vector<size_t> sizes( arrays.size() );
+	for ( size_t i = 0; i < arrays.size(); i++ )
+	{
+		writable( arrays[i].name );
+		data[i] = static_cast<const char *>( arrays[i].data );
+		sizes[i] = arrays[i].arrayLength * arrays[i].elementSize;
+	}
+
+	std::vector<Imf::Int64> offsets;
+	index->writeUniqueData( data, sizes, offsets );
+
+	for ( size_t i = 0; i < arrays.size(); i++ )
+	{
+		remove( arrays[i].name, false );
+		m_node->addDataChild( arrays[i].name, arrays[i].dataType, arrays[i].arrayLength, offsets[i], sizes[i] );
+	}
+#else
+	IndexedIO::writeArrays( arrays );
+#endif
+}
+
+void StreamIndexedIO::readArrays( const IndexedIO::ArrayList &arrays ) const
+{
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::readArrays" );
+#ifdef IE_CORE_LITTLE_ENDIAN
+	validateArrays( arrays );
+	for ( IndexedIO::ArrayList::const_iterator it = arrays.begin(); it != arrays.end(); ++it )
+	{
+		readable( it->name );
+	}
+
+	std::vector<size_t> offsets, sizes;
+	std::vector<bool> compressed;
+	m_node->dataChildInfo( arrays, offsets, sizes, compressed );
+
+	StreamIndexedIO::StreamFile &f = streamFile();
+	std::vector<size_t> pending;
+	for ( size_t i = 0; i < arrays.size(); i++ )
+	{
+		const size_t expectedSize = arrays[i].arrayLength * arrays[i].elementSize;
+		char *dst = static_cast<char *>( arrays[i].data );
+		if ( compressed[i] )
+		{
+			std::vector<char> data;
+			m_node->m_idx->readCompressedData( offsets[i], sizes[i], data );
+			if ( data.size() != expectedSize )
+			{
+				throw IOException( "StreamIndexedIO::readArrays: Unexpected size for data entry '" + arrays[i].name.value() + "'" );
+			}
+			memcpy( dst, &data[0], expectedSize );
+			continue;
+		}
+
+		if ( sizes[i] != expectedSize )
+		{
+			throw IOException( "StreamIndexedIO::readArrays: Unexpected size for data entry '" + arrays[i].name.value() + "'" );
+		}
+
+		if ( const char *mapped = f.mappedData( offsets[i], sizes[i] ) )
+		{
+			memcpy( dst, mapped, expectedSize );
+		}
+		else
+		{
+			pending.push_back( i );
+		}
+	}
+
+	// read the remaining entries in order of their position in the file,
+	// coalescing those which are stored close together.
+	std::sort( pending.begin(), pending.end(), OffsetLess( offsets ) );
+
+	std::vector<size_t>::const_iterator it = pending.begin();
+	while ( it != pending.end() )
+	{
+		const size_t begin = offsets[*it];
+		size_t end = begin + sizes[*it];
+		std::vector<size_t>::const_iterator runEnd = it + 1;
+		while ( runEnd != pending.end() && offsets[*runEnd] <= end + g_maxReadGap )
+		{
+			const size_t newEnd = std::max( end, offsets[*runEnd] + sizes[*runEnd] );
+			if ( newEnd - begin > g_maxCoalescedRead )
+			{
+				break;
+			}
+			end = newEnd;
+			++runEnd;
+		}
+
+		if ( runEnd == it + 1 )
+		{
+			f.readAt( static_cast<char *>( arrays[*it].data ), sizes[*it], begin );
+		}
+		else
+		{
+			ReadBuffer buffer( end - begin );
+			f.readAt( buffer.get(), end - begin, begin );
+			for ( ; it != runEnd; ++it )
+			{
+				memcpy( arrays[*it].data, buffer.get() + offsets[*it] - begin, sizes[*it] );
+			}
+		}
+		it = runEnd;
+	}
+#else
+	IndexedIO::readArrays( arrays );
+#endif
+}
+
+void StreamIndexedIO::readArrayRange( const IndexedIO::Array &array, unsigned long begin ) const
+{
+	IECORE_PROFILE_ZONE( "StreamIndexedIO::readArrayRange" );
+#ifdef IE_CORE_LITTLE_ENDIAN
+	const IndexedIO::ArrayList arrays( 1, array );
+	validateArrays( arrays );
+	readable( array.name );
+
+	const IndexedIO::Entry e = entry( array.name );
+	if ( e.dataType() != array.dataType )
+	{
+		throw IOException( "StreamIndexedIO::readArrayRange: Unexpected data type for data entry '" + array.name.value() + "'" );
+	}
+	if ( begin + array.arrayLength > e.arrayLength() )
+	{
+		throw IOException( "StreamIndexedIO::readArrayRange: Range out of bounds for data entry '" + array.name.value() + "'" );
+	}
+	if ( !array.arrayLength )
+	{
+		return;
+	}
+
+	std::vector<size_t> offsets, sizes;
+	std::vector<bool> compressed;
+	m_node->dataChildInfo( arrays, offsets, sizes, compressed );
+
+	const size_t rangeOffset = begin * array.elementSize;
+	const size_t rangeSize = array.arrayLength * array.elementSize;
+	char *dst = static_cast<char *>( array.data );
+	if ( compressed[0] )
+	{
+		// the compressed blocks don't map to element ranges, so we have
+		// no choice but to decompress everything.
+		std::vector<char> data;
+		m_node->m_idx->readCompressedData( offsets[0], sizes[0], data );
+		if ( data.size() != e.arrayLength() * array.elementSize )
+		{
+			throw IOException( "StreamIndexedIO::readArrayRange: Unexpected size for data entry '" + array.name.value() + "'" );
+		}
+		memcpy( dst, &data[rangeOffset], rangeSize );
+		return;
+	}
+
+	if ( sizes[0] != e.arrayLength() * array.elementSize )
+	{
+		throw IOException( "StreamIndexedIO::readArrayRange: Unexpected size for data entry '" + array.name.value() + "'" );
+	}
+
+	StreamIndexedIO::StreamFile &f = streamFile();
+	if ( const char *mapped = f.mappedData( offsets[0] + rangeOffset, rangeSize ) )
+	{
+		memcpy( dst, mapped, rangeSize );
+	}
+	else
+	{
+		f.readAt( dst, rangeSize, offsets[0] + rangeOffset );
+	}
+#else
+	IndexedIO::readArrayRange( array, begin );
+#endif
+}
+
 // Write
 
 void StreamIndexedIO::write(const IndexedIO::EntryID &name, const float *x, unsigned long arrayLength)
@@ -33,8 +33,12 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "IECore/SummedAreaOp.h"
-#include "IECore/DespatchTypedData.h"
-#include "IECore/TypeTraits.h"
+#include "IECore/VectorTypedData.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
 
 using namespace IECore;
 using namespace std;
@@ -51,57 +55,105 @@ SummedAreaOp::~SummedAreaOp()
 {
 }
 
-struct SummedAreaOp::SumArea
+// Fills in each row of the table with the running sum along that row.
+class SummedAreaOp::SumRows
 {
-	typedef void ReturnType;
 
-	SumArea( const Imath::Box2i &dataWindow )
-		:	m_dataWindow( dataWindow )
-	{
-	}
+	public :
 
-	template<typename T>
-	ReturnType operator()( T * data )
-	{
-		typedef typename T::ValueType Container;
-		typedef typename Container::value_type V;
+		SumRows( const float *channel, int width, double *table )
+			:	m_channel( channel ), m_width( width ), m_table( table )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			for( int y = range.begin(); y != range.end(); ++y )
+			{
+				const float *in = m_channel + y * m_width;
+				double *out = m_table + ( y + 1 ) * ( m_width + 1 );
+				double sum = 0;
+				*out++ = 0;
+				for( int x = 0; x < m_width; ++x )
+				{
+					sum += in[x];
+					*out++ = sum;
+				}
+			}
+		}
+
+	private :
+
+		const float *m_channel;
+		int m_width;
+		double *m_table;
+
+};
+
+// Accumulates the row sums down each column. Each task processes a range
+// of columns for all rows, so the inner loop runs along contiguous memory.
+class SummedAreaOp::SumColumns
+{
 
-		Container &buffer = data->writable();
+	public :
 
-		// deal with first row alone, as it doesn't have values above it
-		unsigned pixelIndex=0;
-		V rowSum = 0;
-		for( int x=m_dataWindow.min.x; x<=m_dataWindow.max.x; x++, pixelIndex++ )
+		SumColumns( int width, int height, double *table )
+			:	m_width( width ), m_height( height ), m_table( table )
 		{
-			rowSum += buffer[pixelIndex];
-			buffer[pixelIndex] = rowSum;
 		}
-		// now do the other rows
-		unsigned upperPixelIndex = 0;
-		pixelIndex = m_dataWindow.size().x + 1;
-		for( int y=m_dataWindow.min.y + 1; y<=m_dataWindow.max.y; y++ )
+
+		void operator()( const tbb::blocked_range<int> &range ) const
 		{
-			rowSum = 0;
-			for( int x=m_dataWindow.min.x; x<=m_dataWindow.max.x; x++ )
+			const int stride = m_width + 1;
+			for( int y = 2; y <= m_height; ++y )
 			{
-				rowSum += buffer[pixelIndex];
-				buffer[pixelIndex++] = rowSum + buffer[upperPixelIndex++];
+				const double *above = m_table + ( y - 1 ) * stride;
+				double *row = m_table + y * stride;
+				for( int x = range.begin(); x != range.end(); ++x )
+				{
+					row[x] += above[x];
+				}
 			}
 		}
-	}
 
 	private :
 
-		Box2i m_dataWindow;
+		int m_width;
+		int m_height;
+		double *m_table;
 
 };
 
+void SummedAreaOp::summedAreaTable( const Imath::Box2i &dataWindow, const float *channel, std::vector<double> &table )
+{
+	const int width = dataWindow.size().x + 1;
+	const int height = dataWindow.size().y + 1;
+
+	table.resize( ( width + 1 ) * ( height + 1 ) );
+	std::fill( table.begin(), table.begin() + width + 1, 0.0 );
+
+	tbb::parallel_for( tbb::blocked_range<int>( 0, height ), SumRows( channel, width, &table[0] ) );
+	tbb::parallel_for( tbb::blocked_range<int>( 1, width + 1, 256 ), SumColumns( width, height, &table[0] ) );
+}
+
 void SummedAreaOp::modifyChannels( const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, ChannelVector &channels )
 {
-	SumArea summer( dataWindow );
+	const int width = dataWindow.size().x + 1;
+	const int height = dataWindow.size().y + 1;
+
+	std::vector<double> table;
 	for( unsigned i=0; i<channels.size(); i++ )
 	{
-		despatchTypedData<SumArea, TypeTraits::IsNumericVectorTypedData>( channels[i].get(), summer );
+		std::vector<float> &channel = channels[i]->writable();
+		summedAreaTable( dataWindow, &channel[0], table );
+		for( int y = 0; y < height; ++y )
+		{
+			const double *row = &table[( y + 1 ) * ( width + 1 ) + 1];
+			float *out = &channel[y * width];
+			for( int x = 0; x < width; ++x )
+			{
+				out[x] = row[x];
+			}
+		}
 	}
 }
-
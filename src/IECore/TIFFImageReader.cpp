@@ -54,6 +54,10 @@
 #include "boost/format.hpp"
 #include "boost/algorithm/string/predicate.hpp"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+
 #include "tiffio.h"
 
 using namespace IECore;
@@ -180,7 +184,7 @@ bool TIFFImageReader::isComplete()
 		/// compression methods support random access to the image data.
 		ScopedTIFFErrorHandler errorHandler;
 
-		readBuffer();
+		readBuffer( m_dataWindow );
 
 		return !errorHandler.hasError();
 	}
@@ -279,6 +283,51 @@ T TIFFImageReader::tiffFieldDefaulted( unsigned int t )
 	return value;
 }
 
+namespace
+{
+
+// Extracts a single channel from interleaved rows of the buffer, converting
+// to the output type. Rows are processed in parallel, and the inner loop is
+// a simple strided copy, which the compiler can vectorise.
+template<typename T, typename V>
+class ChannelConverter
+{
+
+	public :
+
+		ChannelConverter( const T *buffer, int samplesPerPixel, int bufferWidth, const Box2i &window, V *data )
+			:	m_buffer( buffer ), m_samplesPerPixel( samplesPerPixel ), m_bufferWidth( bufferWidth ), m_window( window ), m_data( data )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			ScaledDataConversion<T, V> converter;
+			const int width = m_window.size().x + 1;
+			const size_t stride = m_samplesPerPixel;
+			for( int y = range.begin(); y != range.end(); ++y )
+			{
+				const T *in = m_buffer + stride * ( ( m_window.min.y + y ) * (size_t)m_bufferWidth + m_window.min.x );
+				V *out = m_data + y * (size_t)width;
+				for( int x = 0; x < width; ++x )
+				{
+					out[x] = converter( in[x * stride] );
+				}
+			}
+		}
+
+	private :
+
+		const T *m_buffer;
+		int m_samplesPerPixel;
+		int m_bufferWidth;
+		Box2i m_window;
+		V *m_data;
+
+};
+
+} // namespace
+
 template<typename T, typename V>
 DataPtr TIFFImageReader::readTypedChannel( const std::string &name, const Box2i &dataWindow )
 {
@@ -310,29 +359,16 @@ DataPtr TIFFImageReader::readTypedChannel( const std::string &name, const Box2i
 	assert( area >= 0 );
 	data.resize( area );
 
-	int dataWidth = 1 + dataWindow.size().x;
-	int bufferDataWidth = 1 + m_dataWindow.size().x;
-
-	ScaledDataConversion<T, V> converter;
-
-	int dataY = 0;
-	for ( int y = dataWindow.min.y - m_dataWindow.min.y ; y <= dataWindow.max.y - m_dataWindow.min.y ; ++y, ++dataY )
-	{
-		int dataX = 0;
+	// \todo Currently, we only support PLANARCONFIG_CONTIG for TIFFTAG_PLANARCONFIG.
+	assert( m_planarConfig ==  PLANARCONFIG_CONTIG );
 
-		for ( int x = dataWindow.min.x - m_dataWindow.min.x;  x <= dataWindow.max.x - m_dataWindow.min.x ; ++x, ++dataX  )
-		{
-			const T* buf = reinterpret_cast< T* >( & m_buffer[0] );
-			assert( buf );
+	const Box2i bufferWindow( dataWindow.min - m_dataWindow.min, dataWindow.max - m_dataWindow.min );
+	const T *buffer = reinterpret_cast<const T *>( &m_buffer[0] ) + channelOffset;
 
-			// \todo Currently, we only support PLANARCONFIG_CONTIG for TIFFTAG_PLANARCONFIG.
-			assert( m_planarConfig ==  PLANARCONFIG_CONTIG );
-			typename TargetVector::ValueType::size_type dataOffset = dataY * dataWidth + dataX;
-			assert( dataOffset < data.size() );
-
-			data[dataOffset] = converter( buf[ m_samplesPerPixel * ( y * bufferDataWidth + x ) + channelOffset ] );
-		}
-	}
+	tbb::parallel_for(
+		tbb::blocked_range<int>( 0, bufferWindow.size().y + 1 ),
+		ChannelConverter<T, V>( buffer, m_samplesPerPixel, 1 + m_dataWindow.size().x, bufferWindow, &data[0] )
+	);
 
 	return dataContainer;
 }
@@ -341,10 +377,7 @@ DataPtr TIFFImageReader::readChannel( const std::string &name, const Imath::Box2
 {
 	readCurrentDirectory( true );
 
-	if ( m_buffer.size() == 0 )
-	{
-		readBuffer();
-	}
+	readBuffer( dataWindow );
 
 	if ( m_sampleFormat == SAMPLEFORMAT_IEEEFP )
 	{
@@ -408,99 +441,253 @@ DataPtr TIFFImageReader::readChannel( const std::string &name, const Imath::Box2
 	}
 }
 
-void TIFFImageReader::readBuffer()
+namespace
 {
-	assert( m_tiffImage );
-	assert( m_haveDirectory );
-
-	int width = boxSize( m_dataWindow ).x + 1;
-	int height = boxSize( m_dataWindow ).y + 1;
 
-	// \todo Currently, we only support PLANARCONFIG_CONTIG for TIFFTAG_PLANARCONFIG.
-	assert( m_planarConfig ==  PLANARCONFIG_CONTIG );
-	std::vector<unsigned char>::size_type bufLineSize = (size_t)( (float)m_bitsPerSample / 8 * m_samplesPerPixel * width );
-	std::vector<unsigned char>::size_type bufSize = bufLineSize * height;
-	assert( bufSize );
-	m_buffer.resize( bufSize, 0 );
+// Images smaller than this are decoded serially, as it isn't
+// worth the cost of opening additional file handles.
+const size_t g_minParallelDecodeBytes = 1024 * 1024;
 
-	if ( TIFFIsTiled( m_tiffImage ) )
+// Decodes strips or tiles (collectively "chunks") into the image buffer.
+// For contiguous planar configurations both are arranged in rows, with
+// strips just being tiles which span the whole image width.
+struct ChunkLayout
+{
+	bool tiled;
+	int width;
+	int height;
+	int chunkWidth;
+	int chunkLength;
+	int chunksAcross;
+	size_t pixelSize;
+	size_t bufLineSize;
+	tsize_t chunkSize;
+
+	V2i origin( uint32 chunk ) const
 	{
-		tsize_t tileSize = TIFFTileSize( m_tiffImage );
-		ttile_t numTiles = TIFFNumberOfTiles( m_tiffImage );
+		return V2i( ( chunk % chunksAcross ) * chunkWidth, ( chunk / chunksAcross ) * chunkLength );
+	}
 
-		/// Create a buffer to hold an individual tile
-		int tileWidth = tiffField<uint32>( TIFFTAG_TILEWIDTH );
-		if ( tileWidth == 0 )
+	void decode( TIFF *tiffImage, uint32 chunk, unsigned char *buffer, std::vector<unsigned char> &scratch, const std::string &fileName ) const
+	{
+		const V2i o = origin( chunk );
+		unsigned char *imageData = buffer + o.y * bufLineSize + o.x * pixelSize;
+		if( tiled )
 		{
-			throw IOException( ( boost::format("TIFFImageReader: Unsupported value (%d) for TIFFTAG_TILEWIDTH while reading %s") % tileWidth % fileName() ).str() );
-		}
+			scratch.resize( chunkSize );
+			if( TIFFReadEncodedTile( tiffImage, chunk, &scratch[0], chunkSize ) == -1 )
+			{
+				throw IOException( (boost::format( "TIFFImageReader: Error on tile number %d while reading %s") % chunk % fileName ).str() );
+			}
 
-		int tileLength = tiffField<uint32>( TIFFTAG_TILELENGTH );
-		if ( tileLength == 0 )
+			/// Copy the tile into its rightful place in the image buffer.
+			/// We have to be careful here as the image might not be an exact
+			/// multiple of tiles, in which case we can't copy the tiles round the
+			/// edges in their entirety as that would give us buffer overruns.
+			const int rowsToCopy = min( chunkLength, height - o.y );
+			const int columnsToCopy = min( chunkWidth, width - o.x );
+			const size_t tileLineSize = pixelSize * chunkWidth;
+			const unsigned char *tileData = &scratch[0];
+			for( int l = 0; l < rowsToCopy; l++ )
+			{
+				memcpy( imageData, tileData, pixelSize * columnsToCopy );
+				imageData += bufLineSize;
+				tileData += tileLineSize;
+			}
+		}
+		else
 		{
-			throw IOException( ( boost::format("TIFFImageReader: Unsupported value (%d) for TIFFTAG_TILELENGTH while reading %s") % tileLength % fileName() ).str() );
+			// the last strip may be shorter than the rest
+			const tsize_t size = min<tsize_t>( chunkSize, ( height - o.y ) * bufLineSize );
+			if( TIFFReadEncodedStrip( tiffImage, chunk, imageData, size ) == -1 )
+			{
+				throw IOException( (boost::format( "TIFFImageReader: Error on strip number %d while reading %s") % chunk % fileName ).str() );
+			}
 		}
+	}
 
-		std::vector<unsigned char>::size_type pixelSize = (size_t)( (float)m_bitsPerSample / 8 * m_samplesPerPixel );
-		std::vector<unsigned char>::size_type tileLineSize = pixelSize * tileWidth;
-		std::vector<unsigned char>::size_type tileBufSize = tileLineSize * tileLength;
-		std::vector<unsigned char> tileBuffer;
-		tileBuffer.resize( tileBufSize, 0 );
+};
 
-		int x = 0;
-		int y = 0;
+// Libtiff handles can't be shared between threads, so each thread
+// opens its own, which are closed when the ThreadHandles are destroyed.
+class ThreadHandles
+{
+
+	public :
 
-		/// Read each tile
-		for ( ttile_t tile = 0; tile < numTiles; tile++ )
+		ThreadHandles( const std::string &fileName, unsigned int directory )
+			:	m_fileName( fileName ), m_directory( directory ), m_handles( (TIFF *)0 )
 		{
-			tsize_t imageOffset = y * bufLineSize + x * ( bufLineSize / width );
-			int result = TIFFReadEncodedTile( m_tiffImage, tile, &tileBuffer[0], tileSize );
+		}
 
-			if ( result == -1 )
+		~ThreadHandles()
+		{
+			for( Handles::iterator it = m_handles.begin(), eIt = m_handles.end(); it != eIt; ++it )
 			{
-				throw IOException( (boost::format( "TIFFImageReader: Error on tile number %d while reading %s") % tile % fileName() ).str() );
+				if( *it )
+				{
+					TIFFClose( *it );
+				}
 			}
+		}
 
-			/// Copy the tile into its rightful place in the image buffer.
-			/// We have to be careful here as the image might not be an exact
-			/// multiple of tiles, in which case we can't copy the tiles round the
-			/// edges in their entirety as that would give us buffer overruns.
-			int rowsToCopy = min( tileLength, height - y );
-			int columnsToCopy = min( (int)tileWidth, width - x );
-			tsize_t tileOffset = 0;
-			for ( int l = 0; l < rowsToCopy; l ++)
+		/// Must be called with a ScopedTIFFErrorHandler in place.
+		TIFF *local()
+		{
+			TIFF *&handle = m_handles.local();
+			if( !handle )
 			{
-				memcpy( &m_buffer[0] + imageOffset, &tileBuffer[0] + tileOffset, pixelSize * columnsToCopy );
-				imageOffset += bufLineSize;
-				tileOffset += tileLineSize;
+				handle = TIFFOpen( m_fileName.c_str(), "r" );
+				if( !handle || TIFFSetDirectory( handle, m_directory ) != 1 )
+				{
+					throw IOException( ( boost::format( "TIFFImageReader: Unable to open \"%s\" for parallel decoding" ) % m_fileName ).str() );
+				}
 			}
+			return handle;
+		}
 
-			x = x + tileWidth;
+	private :
 
-			if ( x >= width )
+		typedef tbb::enumerable_thread_specific<TIFF *> Handles;
+
+		std::string m_fileName;
+		unsigned int m_directory;
+		Handles m_handles;
+
+};
+
+class ParallelDecoder
+{
+
+	public :
+
+		ParallelDecoder( const ChunkLayout &layout, const std::vector<uint32> &chunks, unsigned char *buffer, ThreadHandles &handles, const std::string &fileName )
+			:	m_layout( layout ), m_chunks( chunks ), m_buffer( buffer ), m_handles( handles ), m_fileName( fileName )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			ScopedTIFFErrorHandler errorHandler;
+			TIFF *tiffImage = m_handles.local();
+			std::vector<unsigned char> scratch;
+			for( size_t i = range.begin(); i != range.end(); ++i )
 			{
-				x = 0;
-				y += tileLength;
+				m_layout.decode( tiffImage, m_chunks[i], m_buffer, scratch, m_fileName );
 			}
+			errorHandler.throwIfError();
 		}
+
+	private :
+
+		const ChunkLayout &m_layout;
+		const std::vector<uint32> &m_chunks;
+		unsigned char *m_buffer;
+		ThreadHandles &m_handles;
+		const std::string &m_fileName;
+
+};
+
+} // namespace
+
+void TIFFImageReader::readBuffer( const Imath::Box2i &region )
+{
+	assert( m_tiffImage );
+	assert( m_haveDirectory );
+
+	ChunkLayout layout;
+	layout.width = boxSize( m_dataWindow ).x + 1;
+	layout.height = boxSize( m_dataWindow ).y + 1;
+
+	// \todo Currently, we only support PLANARCONFIG_CONTIG for TIFFTAG_PLANARCONFIG.
+	assert( m_planarConfig ==  PLANARCONFIG_CONTIG );
+	layout.pixelSize = (size_t)( (float)m_bitsPerSample / 8 * m_samplesPerPixel );
+	layout.bufLineSize = layout.pixelSize * layout.width;
+
+	layout.tiled = TIFFIsTiled( m_tiffImage );
+	if( layout.tiled )
+	{
+		layout.chunkWidth = tiffField<uint32>( TIFFTAG_TILEWIDTH );
+		if ( layout.chunkWidth == 0 )
+		{
+			throw IOException( ( boost::format("TIFFImageReader: Unsupported value (%d) for TIFFTAG_TILEWIDTH while reading %s") % layout.chunkWidth % fileName() ).str() );
+		}
+
+		layout.chunkLength = tiffField<uint32>( TIFFTAG_TILELENGTH );
+		if ( layout.chunkLength == 0 )
+		{
+			throw IOException( ( boost::format("TIFFImageReader: Unsupported value (%d) for TIFFTAG_TILELENGTH while reading %s") % layout.chunkLength % fileName() ).str() );
+		}
+		layout.chunkSize = TIFFTileSize( m_tiffImage );
 	}
 	else
 	{
-		tsize_t stripSize = TIFFStripSize( m_tiffImage );
-		tsize_t imageOffset = 0;
-		tstrip_t numStrips = TIFFNumberOfStrips( m_tiffImage );
-		for ( tstrip_t strip = 0; strip < numStrips; strip++ )
+		layout.chunkWidth = layout.width;
+		layout.chunkLength = min<uint32>( tiffFieldDefaulted<uint32>( TIFFTAG_ROWSPERSTRIP ), layout.height );
+		layout.chunkSize = TIFFStripSize( m_tiffImage );
+	}
+	layout.chunksAcross = ( layout.width + layout.chunkWidth - 1 ) / layout.chunkWidth;
+	const uint32 numChunks = layout.tiled ? TIFFNumberOfTiles( m_tiffImage ) : TIFFNumberOfStrips( m_tiffImage );
+
+	if( m_buffer.empty() )
+	{
+		std::vector<unsigned char>::size_type bufSize = layout.bufLineSize * layout.height;
+		assert( bufSize );
+		m_buffer.resize( bufSize, 0 );
+		m_chunksRead.clear();
+		m_chunksRead.resize( numChunks, false );
+	}
+
+	// Find the chunks overlapping the region which we haven't already read.
+	// This allows regions of large images to be read without decoding the
+	// whole file.
+
+	const Box2i bufferRegion(
+		Imath::V2i( std::max( region.min.x - m_dataWindow.min.x, 0 ), std::max( region.min.y - m_dataWindow.min.y, 0 ) ),
+		Imath::V2i( std::min( region.max.x - m_dataWindow.min.x, layout.width - 1 ), std::min( region.max.y - m_dataWindow.min.y, layout.height - 1 ) )
+	);
+
+	std::vector<uint32> chunks;
+	for( uint32 chunk = 0; chunk < numChunks; ++chunk )
+	{
+		if( m_chunksRead[chunk] )
+		{
+			continue;
+		}
+		const V2i o = layout.origin( chunk );
+		const Box2i chunkBox( o, o + V2i( layout.chunkWidth - 1, layout.chunkLength - 1 ) );
+		if( boxIntersects( chunkBox, bufferRegion ) )
 		{
-			tsize_t result = TIFFReadEncodedStrip( m_tiffImage, strip, &m_buffer[0] + imageOffset, stripSize );
+			chunks.push_back( chunk );
+		}
+	}
 
-			if ( result == -1 )
-			{
-				throw IOException( (boost::format( "TIFFImageReader: Error on strip number %d while reading %s") % strip % fileName() ).str() );
-			}
+	if( chunks.empty() )
+	{
+		return;
+	}
 
-			imageOffset += result;
+	if( chunks.size() == 1 || chunks.size() * layout.chunkSize < g_minParallelDecodeBytes )
+	{
+		std::vector<unsigned char> scratch;
+		for( std::vector<uint32>::const_iterator it = chunks.begin(), eIt = chunks.end(); it != eIt; ++it )
+		{
+			layout.decode( m_tiffImage, *it, &m_buffer[0], scratch, fileName() );
 		}
 	}
+	else
+	{
+		ThreadHandles handles( fileName(), m_currentDirectoryIndex );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, chunks.size() ),
+			ParallelDecoder( layout, chunks, &m_buffer[0], handles, fileName() )
+		);
+	}
+
+	for( std::vector<uint32>::const_iterator it = chunks.begin(), eIt = chunks.end(); it != eIt; ++it )
+	{
+		m_chunksRead[*it] = true;
+	}
 }
 
 bool TIFFImageReader::open( bool throwOnFailure )
@@ -516,6 +703,7 @@ bool TIFFImageReader::open( bool throwOnFailure )
 			TIFFClose( m_tiffImage );
 			m_tiffImage = 0;
 			m_buffer.clear();
+			m_chunksRead.clear();
 		}
 	}
 
@@ -603,6 +791,7 @@ bool TIFFImageReader::readCurrentDirectory( bool throwOnFailure )
 		}
 
 		m_buffer.clear();
+		m_chunksRead.clear();
 
 		int width = tiffField<uint32>( TIFFTAG_IMAGEWIDTH );
 		if ( width == 0 )
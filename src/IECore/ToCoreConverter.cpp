@@ -35,6 +35,7 @@
 #include "IECore/ToCoreConverter.h"
 #include "IECore/Object.h"
 #include "IECore/CompoundParameter.h"
+#include "IECore/Profiling.h"
 
 using namespace IECore;
 
@@ -51,6 +52,7 @@ ToCoreConverter::~ToCoreConverter()
 
 IECore::ObjectPtr ToCoreConverter::convert() const
 {
+	IECORE_PROFILE_ZONE( "ToCoreConverter::convert" );
 	ConstCompoundObjectPtr operands = parameters()->getTypedValidatedValue<CompoundObject>();
 	return doConversion( operands );
 }
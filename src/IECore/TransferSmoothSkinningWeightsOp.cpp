@@ -45,8 +45,67 @@
 #include "IECore/CompressSmoothSkinningDataOp.h"
 #include "IECore/DecompressSmoothSkinningDataOp.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace IECore;
 
+namespace
+{
+
+// Moves the source weights onto the target influence, for a range of points.
+class WeightTransferer
+{
+
+	public :
+
+		WeightTransferer( int targetIndex, const std::vector<bool> &isSource, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, std::vector<float> &pointInfluenceWeights )
+			:	m_targetIndex( targetIndex ), m_isSource( isSource ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ),
+				m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				float targetWeight = 0.0;
+				int targetCurrentIndex = 0;
+
+				for ( int j=0; j < m_pointInfluenceCounts[i]; j++ )
+				{
+					int current = m_pointIndexOffsets[i] + j;
+					int index = m_pointInfluenceIndices[current];
+					float weight = m_pointInfluenceWeights[current];
+
+					if( index == m_targetIndex )
+					{
+						targetWeight += weight;
+						targetCurrentIndex = current;
+					}
+					else if ( m_isSource[index] )
+					{
+						targetWeight += weight;
+						m_pointInfluenceWeights[current] = 0.0;
+					}
+				}
+				m_pointInfluenceWeights[ targetCurrentIndex ] = targetWeight;
+			}
+		}
+
+	private :
+
+		int m_targetIndex;
+		const std::vector<bool> &m_isSource;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		std::vector<float> &m_pointInfluenceWeights;
+
+};
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( TransferSmoothSkinningWeightsOp );
 
 TransferSmoothSkinningWeightsOp::TransferSmoothSkinningWeightsOp()
@@ -126,35 +185,17 @@ void TransferSmoothSkinningWeightsOp::modify( Object * object, const CompoundObj
 	const std::vector<int> &pointInfluenceIndices = skinningData->pointInfluenceIndices()->readable();
 	std::vector<float> &pointInfluenceWeights = skinningData->pointInfluenceWeights()->writable();
 	
-	for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
+	std::vector<bool> isSource( influenceNames.size(), false );
+	for ( unsigned i=0; i < sourceIndices.size(); i++ )
 	{
-		float targetWeight = 0.0;
-		int targetCurrentIndex = 0;
-		
-		for ( int j=0; j < pointInfluenceCounts[i]; j++ )
-		{
-			int current = pointIndexOffsets[i] + j;
-			int index = pointInfluenceIndices[current];
-			float weight = pointInfluenceWeights[current];
-			
-			if( index == targetIndex )
-			{
-				targetWeight += weight;
-				targetCurrentIndex = current;
-			}
-			else
-			{
-				const std::vector<int>::const_iterator found = find( sourceIndices.begin(), sourceIndices.end(), index );
-				if ( found != sourceIndices.end() )
-				{
-					targetWeight += weight;
-					pointInfluenceWeights[ current ] = 0.0;
-				}
-			}
-		}
-		pointInfluenceWeights[ targetCurrentIndex ] = targetWeight;
+		isSource[ sourceIndices[i] ] = true;
 	}
 	
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, pointIndexOffsets.size(), 1024 ),
+		WeightTransferer( targetIndex, isSource, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights )
+	);
+	
 	// re-compress
 	CompressSmoothSkinningDataOpPtr compressionOp = new CompressSmoothSkinningDataOp;
 	compressionOp->inputParameter()->setValidatedValue( skinningData );
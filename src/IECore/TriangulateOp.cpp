@@ -32,6 +32,9 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/CompoundObject.h"
 #include "IECore/MeshPrimitive.h"
 #include "IECore/TriangulateOp.h"
@@ -39,6 +42,7 @@
 #include "IECore/TriangleAlgo.h"
 #include "IECore/Exception.h"
 #include "IECore/CompoundParameter.h"
+#include "IECore/DataAlgo.h"
 
 using namespace IECore;
 
@@ -88,247 +92,403 @@ const BoolParameter * TriangulateOp::throwExceptionsParameter() const
 	return m_throwExceptionsParameter.get();
 }
 
-/// A functor for use with despatchTypedData, which copies elements from another vector, as specified by an array of indices into that data
-struct TriangleDataRemap
+namespace
 {
-	typedef size_t ReturnType;
 
-	TriangleDataRemap( const std::vector<int> &indices ) : m_other(0), m_indices( indices )
+/// Maps face-vertices or faces of the triangulated mesh back to those of the original, using a table.
+struct TableIndexer
+{
+	TableIndexer( const std::vector<int> &indices ) : m_indices( indices )
+	{
+	}
+
+	int operator()( size_t i ) const
 	{
+		return m_indices[i];
 	}
 
-	const Data * m_other;
 	const std::vector<int> &m_indices;
+};
 
-	template<typename T>
-	size_t operator() ( T * data )
+/// Maps face-vertices of a triangulated quads-only mesh back to the original arithmetically, each
+/// quad having been split into the triangles ( 0, 1, 2 ) and ( 0, 2, 3 ).
+struct QuadFaceVaryingIndexer
+{
+	int operator()( size_t i ) const
 	{
-		assert( data );
-		typename T::ValueType &dataWritable = data->writable();
-		
-		const T * otherData = runTimeCast<const T, const Data>( m_other );
-		assert( otherData );
-		const typename T::ValueType &otherDataReadable = otherData->readable();
+		static const int offsets[6] = { 0, 1, 2, 0, 2, 3 };
+		return ( i / 6 ) * 4 + offsets[i % 6];
+	}
+};
+
+/// Maps faces of a triangulated quads-only mesh back to the original.
+struct QuadUniformIndexer
+{
+	int operator()( size_t i ) const
+	{
+		return i / 2;
+	}
+};
+
+template<typename T, typename Indexer>
+class RemapRange
+{
 
-		dataWritable.clear();
-		dataWritable.reserve( m_indices.size() );
+	public :
 
-		for ( std::vector<int>::const_iterator it = m_indices.begin(); it != m_indices.end(); ++it )
+		RemapRange( const std::vector<T> &src, const Indexer &indexer, std::vector<T> &dst )
+			:	m_src( src ), m_indexer( indexer ), m_dst( dst )
 		{
-			dataWritable.push_back( otherDataReadable[ *it ] );
 		}
 
-		assert( dataWritable.size() == m_indices.size() );
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_dst[i] = m_src[ m_indexer( i ) ];
+			}
+		}
+
+	private :
+
+		const std::vector<T> &m_src;
+		const Indexer &m_indexer;
+		std::vector<T> &m_dst;
 
-		return dataWritable.size();
-	}
 };
 
-/// A simple class to allow TriangulateOp to operate on either V3fVectorData or V3dVectorData using
-/// despatchTypedData
-struct TriangulateOp::TriangulateFn
+/// Fills dst with the elements of src specified by the indexer, in parallel.
+template<typename T, typename Indexer>
+void remap( const std::vector<T> &src, const Indexer &indexer, std::vector<T> &dst )
 {
-	typedef void ReturnType;
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, dst.size() ), RemapRange<T, Indexer>( src, indexer, dst ) );
+}
 
-	MeshPrimitive * m_mesh;
-	float m_tolerance;
-	bool m_throwExceptions;
+/// Elements of a std::vector<bool> share storage, so can't be written concurrently.
+template<typename Indexer>
+void remap( const std::vector<bool> &src, const Indexer &indexer, std::vector<bool> &dst )
+{
+	for( size_t i = 0, n = dst.size(); i < n; ++i )
+	{
+		dst[i] = src[ indexer( i ) ];
+	}
+}
 
-	TriangulateFn( MeshPrimitive * mesh, float tolerance, bool throwExceptions )
-	: m_mesh( mesh ), m_tolerance( tolerance ), m_throwExceptions( throwExceptions )
+/// A functor for use with despatchTypedData, which returns new data holding the elements
+/// of the original specified by the indexer.
+template<typename Indexer>
+struct TriangleDataRemap
+{
+	typedef DataPtr ReturnType;
+
+	TriangleDataRemap( const Indexer &indexer, size_t size ) : m_indexer( indexer ), m_size( size )
 	{
 	}
 
+	const Indexer &m_indexer;
+	size_t m_size;
+
 	template<typename T>
-	ReturnType operator()( T * p )
+	DataPtr operator() ( T * data )
 	{
-		typedef typename T::ValueType::value_type Vec;
+		assert( data );
+		typename T::Ptr result = new T;
+		result->writable().resize( m_size );
+		remap( data->readable(), m_indexer, result->writable() );
+		return result;
+	}
+};
 
-		const typename T::ValueType &pReadable = p->readable();
+/// Fills in the indices needed to rebuild the face-varying and uniform primitive variables
+/// for a range of faces, each of which is triangulated as a fan.
+class FanIndices
+{
 
-		MeshPrimitivePtr meshCopy = m_mesh->copy();
+	public :
 
-		ConstIntVectorDataPtr verticesPerFace = m_mesh->verticesPerFace();
-		const std::vector<int> &verticesPerFaceReadable = verticesPerFace->readable();
-		ConstIntVectorDataPtr vertexIds = m_mesh->vertexIds();
-		const std::vector<int> &vertexIdsReadable = vertexIds->readable();
+		FanIndices( const std::vector<int> &verticesPerFace, const std::vector<int> &faceOffsets, const std::vector<int> &triangleOffsets, std::vector<int> &faceVaryingIndices, std::vector<int> &uniformIndices )
+			:	m_verticesPerFace( verticesPerFace ), m_faceOffsets( faceOffsets ), m_triangleOffsets( triangleOffsets ),
+				m_faceVaryingIndices( faceVaryingIndices ), m_uniformIndices( uniformIndices )
+		{
+		}
 
-		IntVectorDataPtr newVertexIds = new IntVectorData();
-		std::vector<int> &newVertexIdsWritable = newVertexIds->writable();
-		newVertexIdsWritable.reserve( vertexIdsReadable.size() );
-
-		IntVectorDataPtr newVerticesPerFace = new IntVectorData();
-		std::vector<int> &newVerticesPerFaceWritable = newVerticesPerFace->writable();
-		newVerticesPerFaceWritable.reserve( verticesPerFaceReadable.size() );
-
-		std::vector<int> faceVaryingIndices;
-		std::vector<int> uniformIndices;
-		int faceVertexIdStart = 0;
-		int faceIdx = 0;
-		for ( IntVectorData::ValueType::const_iterator it = verticesPerFaceReadable.begin(); it != verticesPerFaceReadable.end(); ++it, ++faceIdx )
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				const int i0 = m_faceOffsets[f];
+				int t = m_triangleOffsets[f];
+				std::vector<int>::iterator fvIt = m_faceVaryingIndices.begin() + t * 3;
+				for( int i = 1; i < m_verticesPerFace[f] - 1; ++i, ++t )
+				{
+					*fvIt++ = i0;
+					*fvIt++ = i0 + i;
+					*fvIt++ = i0 + i + 1;
+					m_uniformIndices[t] = f;
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<int> &m_verticesPerFace;
+		const std::vector<int> &m_faceOffsets;
+		const std::vector<int> &m_triangleOffsets;
+		std::vector<int> &m_faceVaryingIndices;
+		std::vector<int> &m_uniformIndices;
+
+};
+
+enum FaceError
+{
+	NoError = 0,
+	ConcaveError,
+	NonPlanarError
+};
+
+/// Checks that a range of faces are convex and planar, so that they may be triangulated as fans,
+/// recording the first problem found with each face.
+template<typename Vec>
+class ValidateFaces
+{
+
+	public :
+
+		ValidateFaces( const std::vector<Vec> &p, const std::vector<int> &verticesPerFace, const std::vector<int> &vertexIds, const std::vector<int> &faceOffsets, float tolerance, std::vector<char> &errors )
+			:	m_p( p ), m_verticesPerFace( verticesPerFace ), m_vertexIds( vertexIds ), m_faceOffsets( faceOffsets ), m_tolerance( tolerance ), m_errors( errors )
 		{
-			int numFaceVerts = *it;
+		}
 
-			if ( numFaceVerts > 3 )
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
 			{
-				/// For the time being, just do a simple triangle fan.
+				m_errors[f] = m_verticesPerFace[f] > 3 ? validate( f ) : NoError;
+			}
+		}
 
-				const int i0 = faceVertexIdStart + 0;
-				const int v0 = vertexIdsReadable[ i0 ];
+	private :
 
-				int i1 = faceVertexIdStart + 1;
-				int i2 = faceVertexIdStart + 2;
-				int v1 = vertexIdsReadable[ i1 ];
-				int v2 = vertexIdsReadable[ i2 ];
+		FaceError validate( size_t f ) const
+		{
+			const int numFaceVerts = m_verticesPerFace[f];
+			const int faceVertexIdStart = m_faceOffsets[f];
+			const int v0 = m_vertexIds[ faceVertexIdStart ];
 
-				const Vec firstTriangleNormal = triangleNormal( pReadable[ v0 ], pReadable[ v1 ], pReadable[ v2 ] );
+			const Vec firstTriangleNormal = triangleNormal( m_p[ v0 ], m_p[ m_vertexIds[ faceVertexIdStart + 1 ] ], m_p[ m_vertexIds[ faceVertexIdStart + 2 ] ] );
 
-				if (m_throwExceptions)
+			/// Convexivity test - for each edge, all other vertices must be on the same "side" of it
+			for( int i = 0; i < numFaceVerts - 1; i++ )
+			{
+				const int edgeStart = m_vertexIds[ faceVertexIdStart + i ];
+				const int edgeEnd = m_vertexIds[ faceVertexIdStart + i + 1 ];
+
+				const Vec edge = m_p[ edgeEnd ] - m_p[ edgeStart ];
+				const float edgeLength = edge.length();
+
+				if( edgeLength > m_tolerance )
 				{
-					/// Convexivity test - for each edge, all other vertices must be on the same "side" of it
-					for (int i = 0; i < numFaceVerts - 1; i++)
-					{
-						const int edgeStartIndex = faceVertexIdStart + i + 0;
-						const int edgeStart = vertexIdsReadable[ edgeStartIndex ];
+					const Vec edgeDirection = edge / edgeLength;
 
-						const int edgeEndIndex = faceVertexIdStart + i + 1;
-						const int edgeEnd = vertexIdsReadable[ edgeEndIndex ];
+					/// Construct a plane whose normal is perpendicular to both the edge and the polygon's normal
+					const Vec planeNormal = edgeDirection.cross( firstTriangleNormal );
+					const float planeConstant = planeNormal.dot( m_p[ edgeStart ] );
 
-						const Vec edge = pReadable[ edgeEnd ] - pReadable[ edgeStart ];
-						const float edgeLength = edge.length();
+					int sign = 0;
+					for( int j = 0; j < numFaceVerts; j++ )
+					{
+						const int testVertex = m_vertexIds[ faceVertexIdStart + j ];
 
-						if (edgeLength > m_tolerance)
+						if( testVertex != edgeStart && testVertex != edgeEnd )
 						{
-							const Vec edgeDirection = edge / edgeLength;
-
-							/// Construct a plane whose normal is perpendicular to both the edge and the polygon's normal
-							const Vec planeNormal = edgeDirection.cross( firstTriangleNormal );
-							const float planeConstant = planeNormal.dot( pReadable[ edgeStart ] );
+							float signedDistance = planeNormal.dot( m_p[ testVertex ] ) - planeConstant;
 
-							int sign = 0;
-							bool first = true;
-							for (int j = 0; j < numFaceVerts; j++)
+							if( fabs( signedDistance ) > m_tolerance )
 							{
-								const int testVertexIndex = faceVertexIdStart + j;
-								const int testVertex = vertexIdsReadable[ testVertexIndex ];
-
-								if ( testVertex != edgeStart && testVertex != edgeEnd )
+								const int thisSign = signedDistance < 0.0 ? -1 : 1;
+								if( !sign )
+								{
+									sign = thisSign;
+								}
+								else if( thisSign != sign )
 								{
-									float signedDistance = planeNormal.dot( pReadable[ testVertex ] ) - planeConstant;
-
-									if ( fabs(signedDistance) > m_tolerance)
-									{
-										int thisSign = 1;
-										if ( signedDistance < 0.0 )
-										{
-											thisSign = -1;
-										}
-										if (first)
-										{
-											sign = thisSign;
-											first = false;
-										}
-										else if ( thisSign != sign )
-										{
-											assert( sign != 0 );
-											throw InvalidArgumentException("TriangulateOp cannot deal with concave polygons");
-										}
-									}
+									return ConcaveError;
 								}
 							}
 						}
 					}
 				}
+			}
 
-				for (int i = 1; i < numFaceVerts - 1; i++)
+			for( int i = 1; i < numFaceVerts - 1; i++ )
+			{
+				const int v1 = m_vertexIds[ faceVertexIdStart + i ];
+				const int v2 = m_vertexIds[ faceVertexIdStart + i + 1 ];
+				if( fabs( triangleNormal( m_p[ v0 ], m_p[ v1 ], m_p[ v2 ] ).dot( firstTriangleNormal ) - 1.0 ) > m_tolerance )
 				{
-					i1 = faceVertexIdStart + ( (i + 0) % numFaceVerts );
-					i2 = faceVertexIdStart + ( (i + 1) % numFaceVerts );
-					v1 = vertexIdsReadable[ i1 ];
-					v2 = vertexIdsReadable[ i2 ];
+					return NonPlanarError;
+				}
+			}
 
-					if ( m_throwExceptions && fabs( triangleNormal( pReadable[ v0 ], pReadable[ v1 ], pReadable[ v2 ] ).dot( firstTriangleNormal ) - 1.0 ) > m_tolerance )
-					{
-						throw InvalidArgumentException("TriangulateOp cannot deal with non-planar polygons");
-					}
+			return NoError;
+		}
 
-					/// Create a new triangle
-					newVerticesPerFaceWritable.push_back( 3 );
+		const std::vector<Vec> &m_p;
+		const std::vector<int> &m_verticesPerFace;
+		const std::vector<int> &m_vertexIds;
+		const std::vector<int> &m_faceOffsets;
+		float m_tolerance;
+		std::vector<char> &m_errors;
 
-					/// Triangulate the vertices
-					newVertexIdsWritable.push_back( v0 );
-					newVertexIdsWritable.push_back( v1 );
-					newVertexIdsWritable.push_back( v2 );
+};
 
-					/// Store the indices required to rebuild the facevarying primvars
-					faceVaryingIndices.push_back( i0 );
-					faceVaryingIndices.push_back( i1 );
-					faceVaryingIndices.push_back( i2 );
+} // namespace
 
-					uniformIndices.push_back( faceIdx );
-				}
-			}
-			else
-			{
-				assert( numFaceVerts == 3 );
+/// A simple class to allow TriangulateOp to operate on either V3fVectorData or V3dVectorData using
+/// despatchTypedData
+struct TriangulateOp::TriangulateFn
+{
+	typedef void ReturnType;
 
-				int i0 = faceVertexIdStart + 0;
-				int i1 = faceVertexIdStart + 1;
-				int i2 = faceVertexIdStart + 2;
+	MeshPrimitive * m_mesh;
+	float m_tolerance;
+	bool m_throwExceptions;
 
-				newVerticesPerFaceWritable.push_back( 3 );
+	TriangulateFn( MeshPrimitive * mesh, float tolerance, bool throwExceptions )
+	: m_mesh( mesh ), m_tolerance( tolerance ), m_throwExceptions( throwExceptions )
+	{
+	}
 
-				/// Copy across the vertexId data
-				newVertexIdsWritable.push_back( vertexIdsReadable[ i0 ] );
-				newVertexIdsWritable.push_back( vertexIdsReadable[ i1 ] );
-				newVertexIdsWritable.push_back( vertexIdsReadable[ i2 ] );
+	template<typename T>
+	ReturnType operator()( T * p )
+	{
+		typedef typename T::ValueType::value_type Vec;
 
-				/// Store the indices required to rebuild the facevarying primvars
-				faceVaryingIndices.push_back( i0 );
-				faceVaryingIndices.push_back( i1 );
-				faceVaryingIndices.push_back( i2 );
+		const std::vector<int> &verticesPerFace = m_mesh->verticesPerFace()->readable();
+		const size_t numFaces = verticesPerFace.size();
+		const bool quadsOnly = m_mesh->minVerticesPerFace() == 4 && m_mesh->maxVerticesPerFace() == 4;
 
-				uniformIndices.push_back( faceIdx );
+		/// Compute the offsets of each face into the original face-varying data and the
+		/// triangulated faces. We don't need them for a quads-only mesh unless we're validating.
+		std::vector<int> faceOffsets;
+		std::vector<int> triangleOffsets;
+		if( !quadsOnly || m_throwExceptions )
+		{
+			faceOffsets.resize( numFaces );
+			triangleOffsets.resize( numFaces + 1 );
+			int faceOffset = 0;
+			int triangleOffset = 0;
+			for( size_t f = 0; f < numFaces; ++f )
+			{
+				faceOffsets[f] = faceOffset;
+				triangleOffsets[f] = triangleOffset;
+				assert( verticesPerFace[f] >= 3 );
+				faceOffset += verticesPerFace[f];
+				triangleOffset += verticesPerFace[f] - 2;
 			}
+			triangleOffsets[numFaces] = triangleOffset;
+		}
 
-			faceVertexIdStart += numFaceVerts;
+		if( m_throwExceptions )
+		{
+			std::vector<char> errors( numFaces );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, numFaces ),
+				ValidateFaces<Vec>( p->readable(), verticesPerFace, m_mesh->vertexIds()->readable(), faceOffsets, m_tolerance, errors )
+			);
+
+			/// Report the first problem in face order, as a serial implementation would.
+			for( std::vector<char>::const_iterator eIt = errors.begin(); eIt != errors.end(); ++eIt )
+			{
+				if( *eIt == ConcaveError )
+				{
+					throw InvalidArgumentException( "TriangulateOp cannot deal with concave polygons" );
+				}
+				else if( *eIt == NonPlanarError )
+				{
+					throw InvalidArgumentException( "TriangulateOp cannot deal with non-planar polygons" );
+				}
+			}
 		}
 
+		if( quadsOnly )
+		{
+			rebuild( QuadFaceVaryingIndexer(), QuadUniformIndexer(), numFaces * 2 );
+		}
+		else
+		{
+			const size_t numTriangles = triangleOffsets[numFaces];
+			std::vector<int> faceVaryingIndices( numTriangles * 3 );
+			std::vector<int> uniformIndices( numTriangles );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, numFaces ),
+				FanIndices( verticesPerFace, faceOffsets, triangleOffsets, faceVaryingIndices, uniformIndices )
+			);
+
+			rebuild( TableIndexer( faceVaryingIndices ), TableIndexer( uniformIndices ), numTriangles );
+		}
+
+		assert( m_mesh->arePrimitiveVariablesValid() );
+	}
+
+	/// Replaces the topology and the face-varying and uniform primitive variables of the mesh, using
+	/// indexers mapping from the triangulated face-vertices and faces back to the original ones.
+	template<typename FaceVaryingIndexer, typename UniformIndexer>
+	void rebuild( const FaceVaryingIndexer &faceVaryingIndexer, const UniformIndexer &uniformIndexer, size_t numTriangles )
+	{
+		IntVectorDataPtr newVertexIds = new IntVectorData();
+		newVertexIds->writable().resize( numTriangles * 3 );
+		remap( m_mesh->vertexIds()->readable(), faceVaryingIndexer, newVertexIds->writable() );
+
+		IntVectorDataPtr newVerticesPerFace = new IntVectorData( std::vector<int>( numTriangles, 3 ) );
+
 		m_mesh->setTopology( newVerticesPerFace, newVertexIds, m_mesh->interpolation() );
 
-		/// Rebuild all the facevarying primvars, using the list of indices into the old data we created above.
-		assert( faceVaryingIndices.size() == newVertexIds->readable().size() );
-		TriangleDataRemap varyingRemap( faceVaryingIndices );
-		TriangleDataRemap uniformRemap( uniformIndices );
+		TriangleDataRemap<FaceVaryingIndexer> varyingRemap( faceVaryingIndexer, numTriangles * 3 );
+		TriangleDataRemap<UniformIndexer> uniformRemap( uniformIndexer, numTriangles );
 		for ( PrimitiveVariableMap::iterator it = m_mesh->variables.begin(); it != m_mesh->variables.end(); ++it )
 		{
-			if ( it->second.interpolation == PrimitiveVariable::FaceVarying )
+			if( it->second.indices && ( it->second.interpolation == PrimitiveVariable::FaceVarying || it->second.interpolation == PrimitiveVariable::Uniform ) )
 			{
- 				assert( it->second.data );
-				varyingRemap.m_other = it->second.data.get();
-				DataPtr data = it->second.data->copy();
-
-				size_t primVarSize = despatchTypedData<TriangleDataRemap, TypeTraits::IsVectorTypedData>( data.get(), varyingRemap );
-				assert( primVarSize == faceVaryingIndices.size() );
-				(void)primVarSize;
+				// remap the indices rather than the data, so the values remain shared
+				IntVectorDataPtr indices = new IntVectorData;
+				if( it->second.interpolation == PrimitiveVariable::FaceVarying )
+				{
+					indices->writable().resize( numTriangles * 3 );
+					remap( it->second.indices->readable(), faceVaryingIndexer, indices->writable() );
+				}
+				else
+				{
+					indices->writable().resize( numTriangles );
+					remap( it->second.indices->readable(), uniformIndexer, indices->writable() );
+				}
+				it->second.indices = indices;
+				continue;
+			}
 
-				it->second.data = data;
+			DataPtr data;
+			if ( it->second.interpolation == PrimitiveVariable::FaceVarying )
+			{
+				assert( it->second.data );
+				data = despatchTypedData<TriangleDataRemap<FaceVaryingIndexer>, TypeTraits::IsVectorTypedData>( it->second.data.get(), varyingRemap );
 			}
 			else if ( it->second.interpolation == PrimitiveVariable::Uniform )
 			{
- 				assert( it->second.data );
-				uniformRemap.m_other = it->second.data.get();
-				DataPtr data = it->second.data->copy();
-
-				size_t primVarSize = despatchTypedData<TriangleDataRemap, TypeTraits::IsVectorTypedData>( data.get(), uniformRemap );
-				assert( primVarSize == uniformIndices.size() );
-				(void)primVarSize;
+				assert( it->second.data );
+				data = despatchTypedData<TriangleDataRemap<UniformIndexer>, TypeTraits::IsVectorTypedData>( it->second.data.get(), uniformRemap );
+			}
+			else
+			{
+				continue;
+			}
 
-				it->second.data = data;
+			const GeometricData::Interpretation interpretation = getGeometricInterpretation( it->second.data.get() );
+			if( interpretation != GeometricData::None )
+			{
+				setGeometricInterpretation( data.get(), interpretation );
 			}
+			it->second.data = data;
 		}
-
-		assert( m_mesh->arePrimitiveVariablesValid() );
 	}
 
 	struct ErrorHandler
@@ -51,7 +51,7 @@ UVDistortOp::UVDistortOp()
 	:	WarpOp(
 			"Distorts an ImagePrimitive by using a UV map as reference. The UV map must have the same pixel aspect then the image to be distorted. "
 			"The resulting image will have the same data window as the reference UV map."
-		), m_u(0), m_v(0)
+		)
 {
 	m_uvMapParameter = new ObjectParameter(
 		"uvMap",
@@ -77,6 +77,32 @@ const ObjectParameter * UVDistortOp::uvMapParameter() const
 	return m_uvMapParameter.get();
 }
 
+struct UVDistortOp::Copy
+{
+		typedef void ReturnType;
+
+		Copy( std::vector<Imath::V2f> &uvs, int component )
+			:	m_uvs( uvs ), m_component( component )
+		{
+		}
+
+		template<typename T>
+		ReturnType operator()( const T *data )
+		{
+			const typename T::ValueType &readable = data->readable();
+			m_uvs.resize( readable.size() );
+			for( size_t i = 0; i < readable.size(); i++ )
+			{
+				m_uvs[i][m_component] = (float)readable[i];
+			}
+		}
+
+	private:
+
+		std::vector<Imath::V2f> &m_uvs;
+		int m_component;
+};
+
 void UVDistortOp::begin( const CompoundObject * operands )
 {
 	assert( runTimeCast< ImagePrimitive >(m_uvMapParameter->getValue()) );
@@ -87,11 +113,11 @@ void UVDistortOp::begin( const CompoundObject * operands )
 	{
 		throw Exception("No channel R found in the given uv map object!");
 	}
-	m_u = mit->second.data;
+	const Data *u = mit->second.data.get();
 
-	if ( m_u->typeId() != FloatVectorDataTypeId &&
-		m_u->typeId() != DoubleVectorDataTypeId &&
-		m_u->typeId() != HalfVectorDataTypeId )
+	if ( u->typeId() != FloatVectorDataTypeId &&
+		u->typeId() != DoubleVectorDataTypeId &&
+		u->typeId() != HalfVectorDataTypeId )
 	{
 		throw Exception("Channel R in the given uv map is not float type!");
 	}
@@ -101,15 +127,20 @@ void UVDistortOp::begin( const CompoundObject * operands )
 	{
 		throw Exception("No channel G found in the given uv map object!");
 	}
-	m_v = mit->second.data;
+	const Data *v = mit->second.data.get();
 
-	if ( m_v->typeId() != FloatVectorDataTypeId &&
-		m_v->typeId() != DoubleVectorDataTypeId &&
-		m_v->typeId() != HalfVectorDataTypeId )
+	if ( v->typeId() != FloatVectorDataTypeId &&
+		v->typeId() != DoubleVectorDataTypeId &&
+		v->typeId() != HalfVectorDataTypeId )
 	{
 		throw Exception("Channel G in the given uv map is not float type!");
 	}
 
+	Copy copyU( m_uvs, 0 );
+	despatchTypedData<Copy, TypeTraits::IsFloatVectorTypedData>( const_cast<Data *>( u ), copyU );
+	Copy copyV( m_uvs, 1 );
+	despatchTypedData<Copy, TypeTraits::IsFloatVectorTypedData>( const_cast<Data *>( v ), copyV );
+
 	assert( runTimeCast< ImagePrimitive >(inputParameter()->getValue()) );
 	ImagePrimitive *inputImage = static_cast<ImagePrimitive *>( inputParameter()->getValue() );
 	m_uvSize = uvImage->getDataWindow().size();
@@ -123,25 +154,6 @@ Imath::Box2i UVDistortOp::warpedDataWindow( const Imath::Box2i &dataWindow ) con
 	return Imath::Box2i( m_uvOrigin, m_uvOrigin + m_uvSize );
 }
 
-struct UVDistortOp::Lookup
-{
-		typedef float ReturnType;
-
-		Lookup( unsigned pos ) : m_pos( pos )
-		{
-		}
-
-		template<typename T>
-		ReturnType operator()( typename T::ConstPtr data )
-		{
-			return (ReturnType)(data->readable()[ m_pos ]);
-		}
-
-	private:
-
-		unsigned m_pos;
-};
-
 Imath::V2f UVDistortOp::warp( const Imath::V2f &p ) const
 {
 	Imath::V2f uvCoord = (p - m_uvOrigin);
@@ -151,16 +163,10 @@ Imath::V2f UVDistortOp::warp( const Imath::V2f &p ) const
 	y = ( y < 0 ? 0 : y > m_uvSize.y ? m_uvSize.y : y );
 	unsigned pos = x + y * (m_uvSize.x + 1);
 
-	UVDistortOp::Lookup lookup( pos );
-
-	return Imath::V2f(
-		despatchTypedData< UVDistortOp::Lookup, TypeTraits::IsFloatVectorTypedData>( const_cast<Data *>( m_u.get() ), lookup ),
-		despatchTypedData< UVDistortOp::Lookup, TypeTraits::IsFloatVectorTypedData>( const_cast<Data *>( m_v.get() ), lookup )
-	) * m_imageSize + m_imageOrigin;
+	return m_uvs[pos] * m_imageSize + m_imageOrigin;
 }
 
 void UVDistortOp::end()
 {
-	m_u = 0;
-	m_v = 0;
+	std::vector<Imath::V2f>().swap( m_uvs );
 }
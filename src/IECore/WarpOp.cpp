@@ -38,6 +38,13 @@
 #include "IECore/TypeTraits.h"
 #include "IECore/CompoundParameter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 using namespace IECore;
 using namespace Imath;
 using namespace boost;
@@ -50,12 +57,13 @@ WarpOp::WarpOp( const std::string &description )
 	IntParameter::PresetsContainer filterPresets;
 	filterPresets.push_back( IntParameter::Preset( "None", WarpOp::None ) );
 	filterPresets.push_back( IntParameter::Preset( "Bilinear", WarpOp::Bilinear ) );
+	filterPresets.push_back( IntParameter::Preset( "Bicubic", WarpOp::Bicubic ) );
 	m_filterParameter = new IntParameter(
 		"filter",
 		"Defines the filter to be used on the warped coordinates.",
 		WarpOp::Bilinear,
 		WarpOp::None,
-		WarpOp::Bilinear,
+		WarpOp::Bicubic,
 		filterPresets,
 		true
 	);
@@ -100,11 +108,52 @@ struct WarpOp::Warp
 	Warp( WarpOp * warp, WarpOp::FilterType filter, WarpOp::BoundMode boundMode, const Imath::Box2i &warpedDataWindow, const Imath::Box2i &originalDataWindow )
 		:	m_warpOp( warp ), m_filter( filter ), m_boundMode( boundMode ), m_outputDataWindow( warpedDataWindow ), m_inputDataWindow( originalDataWindow )
 	{
+		if( m_filter != WarpOp::None && m_filter != WarpOp::Bilinear && m_filter != WarpOp::Bicubic )
+		{
+			throw Exception("Invalid filter type!");
+		}
+
+		// The warped positions are the same for every channel, so we compute
+		// them once up front rather than calling warp() per channel per pixel.
+		m_positions.resize( ( m_outputDataWindow.size().x + 1 ) * ( m_outputDataWindow.size().y + 1 ) );
+		tbb::parallel_for(
+			tbb::blocked_range<int>( m_outputDataWindow.min.y, m_outputDataWindow.max.y + 1 ),
+			Positions( *this )
+		);
 	}
 
-	inline void computePixelCoordinates( float x, float y, int &x1, int &y1, int &x2, int &y2, float &ratioX, float &ratioY )
+	class Positions
+	{
+
+		public :
+
+			Positions( Warp &warp )
+				:	m_warp( warp )
+			{
+			}
+
+			void operator()( const tbb::blocked_range<int> &range ) const
+			{
+				const Imath::Box2i &outputDataWindow = m_warp.m_outputDataWindow;
+				unsigned int outputWidth = outputDataWindow.size().x + 1;
+				Imath::V2f *positions = &m_warp.m_positions[ ( range.begin() - outputDataWindow.min.y ) * outputWidth ];
+				for( int y=range.begin(); y!=range.end(); y++ )
+				{
+					for( int x=outputDataWindow.min.x; x<=outputDataWindow.max.x; x++, positions++ )
+					{
+						*positions = m_warp.m_warpOp->warp( Imath::V2f( x, y ) );
+					}
+				}
+			}
+
+		private :
+
+			Warp &m_warp;
+
+	};
+
+	inline void computePixelCoordinates( const Imath::V2f &inPos, int &x1, int &y1, int &x2, int &y2, float &ratioX, float &ratioY ) const
 	{
-		Imath::V2f inPos = m_warpOp->warp( Imath::V2f( x, y ) );
 		x1 = int(inPos.x);
 		y1 = int(inPos.y);
 		if ( x1 > inPos.x )
@@ -135,6 +184,16 @@ struct WarpOp::Warp
 		y2 -= m_inputDataWindow.min.y;
 	}
 
+	// Catmull-Rom weights for the four samples surrounding a point
+	// at fractional offset t from the second sample.
+	static inline void cubicWeights( float t, double w[4] )
+	{
+		w[0] = 0.5 * ( ( -t + 2.0 ) * t - 1.0 ) * t;
+		w[1] = 0.5 * ( ( 3.0 * t - 5.0 ) * t * t + 2.0 );
+		w[2] = 0.5 * ( ( -3.0 * t + 4.0 ) * t + 1.0 ) * t;
+		w[3] = 0.5 * ( t - 1.0 ) * t * t;
+	}
+
 	template<typename V>
 	inline V clampXY( const std::vector<V> &buffer, int x, int y, int width, int height ) const
 	{
@@ -152,57 +211,124 @@ struct WarpOp::Warp
 		return buffer[ x + y * width ];
 	}
 
-	template<typename T>
-	ReturnType operator()( T * data )
+	template<typename V>
+	class Rows
 	{
-		typedef typename T::ValueType Container;
-		typedef typename Container::value_type V;
-		typename T::Ptr inData = data->copy();
-		const Container &inBuffer = inData->readable();
-		unsigned int outputWidth = m_outputDataWindow.size().x + 1;
-		unsigned int inputWidth = m_inputDataWindow.size().x + 1;
-		unsigned int inputHeight = m_inputDataWindow.size().y + 1;
-		Container &outBuffer = data->writable();
-		outBuffer.resize( outputWidth * (m_outputDataWindow.size().y + 1) );
-		int x1, x2, y1, y2;
-		float ratioX, ratioY;
-		unsigned pixelIndex=0;
-		double r1, r2, r;
 
-		switch( m_filter )
-		{
-		case WarpOp::None:
-			for( int y=m_outputDataWindow.min.y; y<=m_outputDataWindow.max.y; y++ )
+		public :
+
+			Rows( const Warp &warp, const std::vector<V> &inBuffer, std::vector<V> &outBuffer )
+				:	m_warp( warp ), m_inBuffer( inBuffer ), m_outBuffer( outBuffer )
 			{
-				for( int x=m_outputDataWindow.min.x; x<=m_outputDataWindow.max.x; x++, pixelIndex++ )
-				{
-					Imath::V2f inPos = m_warpOp->warp( Imath::V2f( x, y ) );
-					x1 = int(inPos.x) - m_inputDataWindow.min.x;
-					y1 = int(inPos.y) - m_inputDataWindow.min.y;
-					outBuffer[pixelIndex] = clampXY<V>( inBuffer, x1, y1, inputWidth, inputHeight);
-				}
 			}
-			break;
 
-		case WarpOp::Bilinear:
-			for( int y=m_outputDataWindow.min.y; y<=m_outputDataWindow.max.y; y++ )
+			void operator()( const tbb::blocked_range<int> &range ) const
 			{
-				for( int x=m_outputDataWindow.min.x; x<=m_outputDataWindow.max.x; x++, pixelIndex++ )
+				const Imath::Box2i &outputDataWindow = m_warp.m_outputDataWindow;
+				const Imath::Box2i &inputDataWindow = m_warp.m_inputDataWindow;
+				const std::vector<Imath::V2f> &positions = m_warp.m_positions;
+				unsigned int outputWidth = outputDataWindow.size().x + 1;
+				unsigned int inputWidth = inputDataWindow.size().x + 1;
+				unsigned int inputHeight = inputDataWindow.size().y + 1;
+				unsigned pixelIndex = ( range.begin() - outputDataWindow.min.y ) * outputWidth;
+				int x1, x2, y1, y2;
+				float ratioX, ratioY;
+				double r1, r2, r;
+
+				switch( m_warp.m_filter )
 				{
-					computePixelCoordinates( x, y, x1, y1, x2, y2, ratioX, ratioY );
-					LinearInterpolator<double>()( (double)clampXY<V>( inBuffer, x1, y1, inputWidth, inputHeight ),
-												  (double)clampXY<V>( inBuffer, x2, y1, inputWidth, inputHeight ), ratioX, r1 );
-					LinearInterpolator<double>()( (double)clampXY<V>( inBuffer, x1, y2, inputWidth, inputHeight ),
-												  (double)clampXY<V>( inBuffer, x2, y2, inputWidth, inputHeight ), ratioX, r2 );
-					LinearInterpolator<double>()( r1, r2, ratioY, r );
-					outBuffer[pixelIndex] = (V)r;
+				case WarpOp::None:
+					for( int y=range.begin(); y!=range.end(); y++ )
+					{
+						for( int x=outputDataWindow.min.x; x<=outputDataWindow.max.x; x++, pixelIndex++ )
+						{
+							const Imath::V2f &inPos = positions[pixelIndex];
+							x1 = int(inPos.x) - inputDataWindow.min.x;
+							y1 = int(inPos.y) - inputDataWindow.min.y;
+							m_outBuffer[pixelIndex] = m_warp.clampXY<V>( m_inBuffer, x1, y1, inputWidth, inputHeight);
+						}
+					}
+					break;
+
+				case WarpOp::Bilinear:
+					for( int y=range.begin(); y!=range.end(); y++ )
+					{
+						for( int x=outputDataWindow.min.x; x<=outputDataWindow.max.x; x++, pixelIndex++ )
+						{
+							m_warp.computePixelCoordinates( positions[pixelIndex], x1, y1, x2, y2, ratioX, ratioY );
+							LinearInterpolator<double>()( (double)m_warp.clampXY<V>( m_inBuffer, x1, y1, inputWidth, inputHeight ),
+														  (double)m_warp.clampXY<V>( m_inBuffer, x2, y1, inputWidth, inputHeight ), ratioX, r1 );
+							LinearInterpolator<double>()( (double)m_warp.clampXY<V>( m_inBuffer, x1, y2, inputWidth, inputHeight ),
+														  (double)m_warp.clampXY<V>( m_inBuffer, x2, y2, inputWidth, inputHeight ), ratioX, r2 );
+							LinearInterpolator<double>()( r1, r2, ratioY, r );
+							m_outBuffer[pixelIndex] = (V)r;
+						}
+					}
+					break;
+
+				case WarpOp::Bicubic:
+					for( int y=range.begin(); y!=range.end(); y++ )
+					{
+						for( int x=outputDataWindow.min.x; x<=outputDataWindow.max.x; x++, pixelIndex++ )
+						{
+							const Imath::V2f &inPos = positions[pixelIndex];
+							const float fx = std::floor( inPos.x );
+							const float fy = std::floor( inPos.y );
+							double wx[4], wy[4];
+							cubicWeights( inPos.x - fx, wx );
+							cubicWeights( inPos.y - fy, wy );
+							x1 = int(fx) - 1 - inputDataWindow.min.x;
+							y1 = int(fy) - 1 - inputDataWindow.min.y;
+
+							r = 0;
+							for( int j=0; j<4; j++ )
+							{
+								r1 = 0;
+								for( int i=0; i<4; i++ )
+								{
+									r1 += wx[i] * (double)m_warp.clampXY<V>( m_inBuffer, x1 + i, y1 + j, inputWidth, inputHeight );
+								}
+								r += wy[j] * r1;
+							}
+
+							// Catmull-Rom can overshoot, which would wrap around for integer channels.
+							if( std::numeric_limits<V>::is_integer )
+							{
+								r = std::max( (double)std::numeric_limits<V>::min(), std::min( (double)std::numeric_limits<V>::max(), r ) );
+							}
+							m_outBuffer[pixelIndex] = (V)r;
+						}
+					}
+					break;
+
+				default:
+					break;
 				}
 			}
-			break;
 
-		default:
-			throw Exception("Invalid filter type!");
-		}
+		private :
+
+			const Warp &m_warp;
+			const std::vector<V> &m_inBuffer;
+			std::vector<V> &m_outBuffer;
+
+	};
+
+	template<typename T>
+	ReturnType operator()( T * data )
+	{
+		typedef typename T::ValueType Container;
+		typedef typename Container::value_type V;
+
+		typename T::Ptr inData = data->copy();
+		const Container &inBuffer = inData->readable();
+		Container &outBuffer = data->writable();
+		outBuffer.resize( m_positions.size() );
+
+		tbb::parallel_for(
+			tbb::blocked_range<int>( m_outputDataWindow.min.y, m_outputDataWindow.max.y + 1 ),
+			Rows<V>( *this, inBuffer, outBuffer )
+		);
 	}
 
 	private :
@@ -211,6 +337,7 @@ struct WarpOp::Warp
 		WarpOp::BoundMode m_boundMode;
 		Imath::Box2i m_outputDataWindow;
 		Imath::Box2i m_inputDataWindow;
+		std::vector<Imath::V2f> m_positions;
 };
 
 void WarpOp::modifyTypedPrimitive( ImagePrimitive * image, const CompoundObject * operands )
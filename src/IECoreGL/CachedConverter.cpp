@@ -32,13 +32,20 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <set>
+
 #include "boost/lexical_cast.hpp"
 #include "boost/format.hpp"
 #include "boost/bind.hpp"
 #include "boost/bind/placeholders.hpp"
 
+#include "tbb/task.h"
+#include "tbb/spin_mutex.h"
+
 #include "IECore/LRUCache.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/MessageHandler.h"
+#include "IECore/TypeIds.h"
 
 #include "IECoreGL/ToGLConverter.h"
 #include "IECoreGL/CachedConverter.h"
@@ -67,6 +74,11 @@ struct CacheKey
 		: object( o ), hash( o->hash() )
 	{
 	}
+
+	CacheKey( const IECore::Object *o, const IECore::MurmurHash &h )
+		: object( o ), hash( h )
+	{
+	}
 	
 	bool operator == ( const CacheKey &other ) const
 	{
@@ -116,12 +128,61 @@ struct CachedConverter::MemberData
 	
 	void removalCallback( const CacheKey &key, const IECore::RunTimeTypedPtr &value )
 	{
+		// Removals may be triggered by conversions on any thread.
+		tbb::spin_mutex::scoped_lock lock( deferredRemovalsMutex );
 		deferredRemovals.push_back( value );
 	}
 	
+	// Performs a conversion requested by convertAsync(), holding
+	// references to both the converter and the object for the
+	// duration.
+	class ConversionTask : public tbb::task
+	{
+
+		public :
+
+			ConversionTask( CachedConverter *converter, MemberData *data, const IECore::Object *object, const IECore::MurmurHash &hash )
+				:	m_converter( converter ), m_data( data ), m_object( object ), m_hash( hash )
+			{
+			}
+
+			virtual tbb::task *execute()
+			{
+				try
+				{
+					m_data->cache.get( CacheKey( m_object.get(), m_hash ) );
+				}
+				catch( const std::exception &e )
+				{
+					// We leave the hash in asyncConversions so that the
+					// failed conversion isn't retried on every redraw.
+					IECore::msg( IECore::Msg::Error, "CachedConverter::convertAsync", e.what() );
+					return 0;
+				}
+
+				tbb::spin_mutex::scoped_lock lock( m_data->asyncConversionsMutex );
+				m_data->asyncConversions.erase( m_hash );
+				return 0;
+			}
+
+		private :
+
+			CachedConverterPtr m_converter;
+			MemberData *m_data;
+			IECore::ConstObjectPtr m_object;
+			IECore::MurmurHash m_hash;
+
+	};
+
 	typedef IECore::LRUCache<CacheKey, IECore::RunTimeTypedPtr> Cache;
 	Cache cache;
+
+	tbb::spin_mutex deferredRemovalsMutex;
 	std::vector<IECore::RunTimeTypedPtr> deferredRemovals;
+
+	// Hashes of the objects being converted by ConversionTasks.
+	tbb::spin_mutex asyncConversionsMutex;
+	std::set<IECore::MurmurHash> asyncConversions;
 	
 };
 
@@ -140,6 +201,36 @@ IECore::ConstRunTimeTypedPtr CachedConverter::convert( const IECore::Object *obj
 	return m_data->cache.get( CacheKey( object ) );
 }
 
+IECore::ConstRunTimeTypedPtr CachedConverter::convertAsync( const IECore::Object *object )
+{
+	CacheKey key( object );
+	if( m_data->cache.cached( key ) )
+	{
+		return m_data->cache.get( key );
+	}
+
+	// Textures and buffers are created in the GL context as part of
+	// their conversion, so can't be made on a background thread. The
+	// conversion of all other primitives is pure CPU work - their GL
+	// resources are created lazily when they are first rendered.
+	if( !object->isInstanceOf( IECore::PrimitiveTypeId ) || object->isInstanceOf( IECore::ImagePrimitiveTypeId ) )
+	{
+		return m_data->cache.get( key );
+	}
+
+	{
+		tbb::spin_mutex::scoped_lock lock( m_data->asyncConversionsMutex );
+		if( !m_data->asyncConversions.insert( key.hash ).second )
+		{
+			// already in progress
+			return 0;
+		}
+	}
+
+	tbb::task::enqueue( *new( tbb::task::allocate_root() ) MemberData::ConversionTask( this, m_data, object, key.hash ) );
+	return 0;
+}
+
 size_t CachedConverter::getMaxMemory() const
 {
 	return m_data->cache.getMaxCost();
@@ -153,7 +244,12 @@ void CachedConverter::setMaxMemory( size_t maxMemory )
 
 void CachedConverter::clearUnused()
 {
-	m_data->deferredRemovals.clear();
+	std::vector<IECore::RunTimeTypedPtr> removals;
+	{
+		tbb::spin_mutex::scoped_lock lock( m_data->deferredRemovalsMutex );
+		removals.swap( m_data->deferredRemovals );
+	}
+	// removals are destroyed here, outside the lock
 }
 
 CachedConverter *CachedConverter::defaultCachedConverter()
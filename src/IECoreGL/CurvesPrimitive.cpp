@@ -61,6 +61,7 @@ namespace IECoreGL
 IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( CurvesPrimitive::IgnoreBasis, CurvesPrimitiveIgnoreBasisTypeId, bool, false );
 IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( CurvesPrimitive::UseGLLines, CurvesPrimitiveUseGLLinesTypeId, bool, false );
 IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( CurvesPrimitive::GLLineWidth, CurvesPrimitiveGLLineWidthTypeId, float, 1 );
+IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( CurvesPrimitive::TessellationSegmentLength, CurvesPrimitiveTessellationSegmentLengthTypeId, float, 0 );
 
 } // namespace IECoreGL
 
@@ -96,14 +97,15 @@ class CurvesPrimitive::MemberData : public IECore::RefCounted
 
 		struct GeometrySetup
 		{
-			GeometrySetup( ConstShaderPtr os, Shader::SetupPtr ss, bool l, bool r )
-				:	originalShader( os ), shaderSetup( ss ), linear( l ), ribbons( r )
+			GeometrySetup( ConstShaderPtr os, Shader::SetupPtr ss, bool l, bool r, bool t )
+				:	originalShader( os ), shaderSetup( ss ), linear( l ), ribbons( r ), tessellated( t )
 			{
 			}
 			ConstShaderPtr originalShader;
 			Shader::SetupPtr shaderSetup;
 			bool linear;
 			bool ribbons;
+			bool tessellated;
 		};
 
 		typedef std::vector<GeometrySetup> GeometrySetupVector;
@@ -150,8 +152,13 @@ void CurvesPrimitive::addPrimitiveVariable( const std::string &name, const IECor
 
 const Shader::Setup *CurvesPrimitive::shaderSetup( const Shader *shader, State *state ) const
 {
-	bool linear, ribbons;
-	renderMode( state, linear, ribbons );
+	bool linear, ribbons, tessellated;
+	renderMode( state, linear, ribbons, tessellated );
+
+	// if the current shader has a specific geometry shader component,
+	// then we assume the user has provided one capable of doing the tesselation,
+	// and must give it the lines_adjacency primitives it expects.
+	tessellated = tessellated && shader->geometrySource() == "";
 
 	if( linear && !ribbons  )
 	{
@@ -164,7 +171,7 @@ const Shader::Setup *CurvesPrimitive::shaderSetup( const Shader *shader, State *
 	
 	for( MemberData::GeometrySetupVector::const_iterator it = m_memberData->geometrySetups.begin(), eIt = m_memberData->geometrySetups.end(); it != eIt; it++ )
 	{
-		if( it->originalShader == shader && it->linear == linear && it->ribbons == ribbons )
+		if( it->originalShader == shader && it->linear == linear && it->ribbons == ribbons && it->tessellated == tessellated )
 		{
 			return it->shaderSetup.get();
 		}
@@ -172,7 +179,20 @@ const Shader::Setup *CurvesPrimitive::shaderSetup( const Shader *shader, State *
 
 	ConstShaderPtr geometryShader = shader;
 	ShaderStateComponent *shaderStateComponent = state->get<ShaderStateComponent>();
-	if( geometryShader->geometrySource() == "" )
+	if( tessellated )
+	{
+		// substitute in our own tessellation shaders, which replace the
+		// geometry shader entirely.
+		ShaderLoader *shaderLoader = shaderStateComponent->shaderLoader();
+		geometryShader = shaderLoader->create(
+			geometryShader->vertexSource(),
+			tessControlSource(),
+			ribbons ? cubicRibbonsTessEvaluationSource() : cubicLinesTessEvaluationSource(),
+			"",
+			geometryShader->fragmentSource()
+		);
+	}
+	else if( geometryShader->geometrySource() == "" )
 	{
 		// if the current shader has a specific geometry shader component,
 		// then we assume the user has provided one capable of doing the tesselation,
@@ -201,15 +221,15 @@ const Shader::Setup *CurvesPrimitive::shaderSetup( const Shader *shader, State *
 	geometryShaderSetup->addUniformParameter( "basis", new IECore::M44fData( m_memberData->basis.matrix ) );
 	geometryShaderSetup->addUniformParameter( "width", new IECore::M44fData( m_memberData->width ) );
 
-	m_memberData->geometrySetups.push_back( MemberData::GeometrySetup( shader, geometryShaderSetup, linear, ribbons ) );
+	m_memberData->geometrySetups.push_back( MemberData::GeometrySetup( shader, geometryShaderSetup, linear, ribbons, tessellated ) );
 	
 	return geometryShaderSetup.get();
 }
 
 void CurvesPrimitive::render( const State *currentState, IECore::TypeId style ) const
 {
-	bool linear, ribbons;
-	renderMode( currentState, linear, ribbons );
+	bool linear, ribbons, tessellated;
+	renderMode( currentState, linear, ribbons, tessellated );
 	
 	if( !ribbons )
 	{
@@ -221,6 +241,42 @@ void CurvesPrimitive::render( const State *currentState, IECore::TypeId style )
 		}
 	}
 
+	if( tessellated )
+	{
+		// shaderSetup() only uses tessellation shaders when the original shader
+		// has no geometry shader, so we must check that the bound program is
+		// one of ours before drawing patches.
+		GLint program = 0;
+		glGetIntegerv( GL_CURRENT_PROGRAM, &program );
+		tessellated = false;
+		for( MemberData::GeometrySetupVector::const_iterator it = m_memberData->geometrySetups.begin(), eIt = m_memberData->geometrySetups.end(); it != eIt; it++ )
+		{
+			if( it->tessellated && it->shaderSetup->shader()->program() == (GLuint)program )
+			{
+				tessellated = true;
+				break;
+			}
+		}
+
+		if( tessellated )
+		{
+			// the level of detail depends on the viewport and segment length,
+			// which may change without the shader setup being rebuilt, so we
+			// update them directly for each draw. everything else lives in
+			// buffers which are uploaded only once.
+			GLint viewport[4];
+			glGetIntegerv( GL_VIEWPORT, viewport );
+			glUniform2f( glGetUniformLocation( program, "viewportSize" ), viewport[2], viewport[3] );
+			glUniform1f( glGetUniformLocation( program, "segmentLength" ), currentState->get<TessellationSegmentLength>()->value() );
+
+			ensureAdjacencyVertIds();
+			Buffer::ScopedBinding indexBinding( *(m_memberData->adjacencyVertIdsBuffer), GL_ELEMENT_ARRAY_BUFFER );
+			glPatchParameteri( GL_PATCH_VERTICES, 4 );
+			glDrawElements( GL_PATCHES, m_memberData->numAdjacencyVertIds, GL_UNSIGNED_INT, 0 );
+			return;
+		}
+	}
+
 	if( linear )
 	{
 		ensureLinearAdjacencyVertIds();
@@ -242,17 +298,19 @@ void CurvesPrimitive::renderInstances( size_t numInstances ) const
 	glDrawElementsInstancedARB( GL_LINES, m_memberData->numVertIds, GL_UNSIGNED_INT, 0, numInstances );
 }
 
-void CurvesPrimitive::renderMode( const State *state, bool &linear, bool &ribbons ) const
+void CurvesPrimitive::renderMode( const State *state, bool &linear, bool &ribbons, bool &tessellated ) const
 {
 	if( glslVersion() < 150 )
 	{
 		linear = true;
 		ribbons = false;
+		tessellated = false;
 		return;
 	}
 	
 	linear = m_memberData->basis==IECore::CubicBasisf::linear() || state->get<IgnoreBasis>()->value();
 	ribbons = !state->get<UseGLLines>()->value();
+	tessellated = !linear && glslVersion() >= 400 && state->get<TessellationSegmentLength>()->value() > 0.0f;
 }
 
 const std::string &CurvesPrimitive::cubicLinesGeometrySource()
@@ -365,6 +423,91 @@ const std::string &CurvesPrimitive::linearRibbonsGeometrySource()
 	return s;
 }
 
+const std::string &CurvesPrimitive::tessControlSource()
+{
+	// the same levels serve both of the evaluation shaders below. isolines
+	// use the first two outer levels as the number of lines and the number
+	// of spans per line, while quads are subdivided by level along the curve
+	// in u and not at all across it in v.
+	static std::string s =
+
+		"#version 400 compatibility\n"
+		""
+		"#include \"IECoreGL/CurvesPrimitive.h\"\n"
+		""
+		"IECOREGL_CURVESPRIMITIVE_DECLARE_TESSELLATION_CONTROL_PARAMETERS\n"
+		""
+		"void main()"
+		"{"
+		"	IECOREGL_ASSIGN_TESSELLATION_CONTROL_PASS_THROUGH"
+		""
+		"	if( gl_InvocationID == 0 )"
+		"	{"
+		"		float level = IECOREGL_CURVESPRIMITIVE_TESSELLATION_LEVEL();"
+		"		gl_TessLevelOuter[0] = 1.0;"
+		"		gl_TessLevelOuter[1] = level;"
+		"		gl_TessLevelOuter[2] = 1.0;"
+		"		gl_TessLevelOuter[3] = level;"
+		"		gl_TessLevelInner[0] = level;"
+		"		gl_TessLevelInner[1] = 1.0;"
+		"	}"
+		"}";
+
+	return s;
+}
+
+const std::string &CurvesPrimitive::cubicLinesTessEvaluationSource()
+{
+	static std::string s =
+
+		"#version 400 compatibility\n"
+		""
+		"#include \"IECoreGL/CurvesPrimitive.h\"\n"
+		""
+		"IECOREGL_CURVESPRIMITIVE_DECLARE_CUBIC_LINES_TESSELLATION_PARAMETERS\n"
+		""
+		"void main()"
+		"{"
+		"	float t = gl_TessCoord.x;"
+		"	IECOREGL_ASSIGN_TESSELLATION_PASS_THROUGH( t )"
+		"	gl_Position = IECOREGL_CURVESPRIMITIVE_POSITION( t );"
+		"}";
+
+	return s;
+}
+
+const std::string &CurvesPrimitive::cubicRibbonsTessEvaluationSource()
+{
+	static std::string s =
+
+		"#version 400 compatibility\n"
+		""
+		"#include \"IECoreGL/CurvesPrimitive.h\"\n"
+		""
+		"IECOREGL_CURVESPRIMITIVE_DECLARE_CUBIC_RIBBONS_TESSELLATION_PARAMETERS\n"
+		""
+		"out vec3 fragmentI;"
+		"out vec3 fragmentN;"
+		"out vec2 fragmentst;"
+		""
+		"void main()"
+		"{"
+		"	float t = gl_TessCoord.x;"
+		"	float s = gl_TessCoord.y;"
+		""
+		"	vec4 p, n, uTangent, vTangent;"
+		"	IECOREGL_CURVESPRIMITIVE_CUBICFRAME( t, p, n, uTangent, vTangent );"
+		""
+		"	IECOREGL_ASSIGN_TESSELLATION_PASS_THROUGH( t )"
+		"	fragmentN = n.xyz;"
+		"	fragmentI = -n.xyz;"
+		"	fragmentst = vec2( s, t );"
+		"	gl_Position = p + width * ( 1.0 - 2.0 * s ) * uTangent;"
+		"}";
+
+	return s;
+}
+
 void CurvesPrimitive::ensureVertIds() const
 {
 	if( m_memberData->vertIdsBuffer )
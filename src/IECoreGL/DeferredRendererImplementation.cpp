@@ -43,20 +43,35 @@
 #include "IECoreGL/Texture.h"
 
 #include "IECore/MessageHandler.h"
+#include "IECore/CompoundData.h"
+#include "IECore/SimpleTypedData.h"
 #include "boost/noncopyable.hpp"
 
+#include "OpenEXR/ImathBoxAlgo.h"
+
 #include "tbb/task.h"
 #include "tbb/task_scheduler_init.h"
 #include "tbb/atomic.h"
+#include "tbb/tick_count.h"
 
 #include <cassert>
+#include <algorithm>
+#include <typeinfo>
+#include <limits>
+#include <cstdlib>
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
 
 using namespace IECoreGL;
 using namespace Imath;
 using namespace std;
 
 DeferredRendererImplementation::DeferredRendererImplementation()
+	:	m_maxPendingProcedurals( 0 )
 {
+	m_pendingProcedurals = 0;
 
 	m_defaultContext = new RenderContext();
 	m_defaultContext->transformStack.push( M44f() );
@@ -353,27 +368,54 @@ struct DeferredRendererImplementation::ScopedRenderContext : private boost::nonc
 		const char *m_msgContext;
 };
 
+namespace
+{
+
+std::string proceduralClassName( const IECore::Renderer::Procedural *proc )
+{
+	const char *name = typeid( *proc ).name();
+#ifdef __GNUC__
+	int status = 0;
+	char *demangled = abi::__cxa_demangle( name, 0, 0, &status );
+	if( demangled )
+	{
+		std::string result( demangled );
+		free( demangled );
+		return result;
+	}
+#endif
+	return name;
+}
+
+// An estimate of the relative cost of expanding a procedural, used to
+// start the most expensive ones first. We assume that bigger procedurals
+// generate more geometry, and that procedurals without bounds are
+// the most expensive of all.
+float proceduralCost( const IECore::Renderer::Procedural *proc, const M44f &transform )
+{
+	const Box3f b = proc->bound();
+	if( b == IECore::Renderer::Procedural::noBound )
+	{
+		return std::numeric_limits<float>::max();
+	}
+	if( b.isEmpty() )
+	{
+		return 0.0f;
+	}
+	return Imath::transform( b, transform ).size().length();
+}
+
+} // namespace
+
 class DeferredRendererImplementation::ProceduralTask : public tbb::task, private boost::noncopyable
 {
 	public:
 
 		ProceduralTask( DeferredRendererImplementation &renderer, IECore::Renderer::ProceduralPtr proc, IECore::RendererPtr param ) : 
-			m_renderer(renderer), m_procedural(proc), m_param(param), m_taskList(0)
+			m_renderer(renderer), m_procedural(proc), m_param(param), m_subtasks(0)
 		{
-			m_numSubtasks = 0;
-			RenderContext *curContext = m_renderer.currentContext();
-			
-			// create a RenderContext for a new Procedural based on the current context
-			StatePtr completeState = new State( false );
-			for ( StateStack::iterator it = curContext->stateStack.begin(); it != curContext->stateStack.end(); it++ )
-			{
-				completeState->add( *it );
-			}
-			m_proceduralContext = new RenderContext();
-			m_proceduralContext->localTransform = curContext->localTransform;
-			m_proceduralContext->transformStack.push( curContext->transformStack.top() );
-			m_proceduralContext->stateStack.push_back( completeState );
-			m_proceduralContext->groupStack.push( curContext->groupStack.top() );
+			m_proceduralContext = m_renderer.proceduralContext();
+			m_renderer.m_pendingProcedurals++;
 		}
 
 		virtual ~ProceduralTask()
@@ -382,42 +424,88 @@ class DeferredRendererImplementation::ProceduralTask : public tbb::task, private
 
 		task* execute() 
 		{
-			tbb::task_list taskList;
+			m_renderer.m_pendingProcedurals--;
 
-			m_taskList = &taskList;
+			Subtasks subtasks;
+			m_subtasks = &subtasks;
+			m_renderer.expandProcedural( m_procedural.get(), m_param.get(), m_proceduralContext );
+			m_subtasks = 0;
 
-			// activates the render context on the task's thread.
-			ScopedRenderContext scopedProceduralContext( m_proceduralContext, m_renderer, "DeferredRendererImplementation::ProceduralTask::execute" );
-			m_procedural->render( m_param.get() );
-			set_ref_count( m_numSubtasks + 1 );
-			spawn_and_wait_for_all(taskList);
-			taskList.clear();
-			m_taskList = 0;
+			// Spawn the most expensive children first, so they're the
+			// first to be stolen by idle threads, and the cheap ones
+			// are left to fill in the gaps at the end.
+			std::stable_sort( subtasks.begin(), subtasks.end(), moreExpensive );
+			tbb::task_list taskList;
+			for( Subtasks::const_iterator it = subtasks.begin(); it != subtasks.end(); ++it )
+			{
+				taskList.push_back( *it->second );
+			}
+
+			set_ref_count( subtasks.size() + 1 );
+			spawn_and_wait_for_all( taskList );
 			return NULL;
 		}
 
-		void addSubtask( ProceduralTask& subtask )
+		void addSubtask( ProceduralTask &subtask, float cost )
 		{
-			if ( !m_taskList )
+			if ( !m_subtasks )
 			{
 				IECore::msg( IECore::Msg::Error, "DeferredRendererImplementation::ProceduralTask::addSubtask", "No tasklist!" );
 				return;
 			}
-			m_taskList->push_back( subtask );
-			m_numSubtasks++;
+			m_subtasks->push_back( Subtask( cost, &subtask ) );
 		}
 
 	private :
 
-		tbb::atomic<unsigned int> m_numSubtasks;
+		typedef std::pair<float, ProceduralTask *> Subtask;
+		typedef std::vector<Subtask> Subtasks;
+
+		static bool moreExpensive( const Subtask &a, const Subtask &b )
+		{
+			return a.first > b.first;
+		}
+
 		RenderContextPtr m_proceduralContext;
 		DeferredRendererImplementation &m_renderer;
 		IECore::Renderer::ProceduralPtr m_procedural;
 		IECore::RendererPtr m_param;
-		tbb::task_list *m_taskList;
+		Subtasks *m_subtasks;
 };
 
+DeferredRendererImplementation::RenderContextPtr DeferredRendererImplementation::proceduralContext()
+{
+	RenderContext *curContext = currentContext();
+
+	StatePtr completeState = new State( false );
+	for ( StateStack::iterator it = curContext->stateStack.begin(); it != curContext->stateStack.end(); it++ )
+	{
+		completeState->add( *it );
+	}
+	RenderContextPtr result = new RenderContext();
+	result->localTransform = curContext->localTransform;
+	result->transformStack.push( curContext->transformStack.top() );
+	result->stateStack.push_back( completeState );
+	result->groupStack.push( curContext->groupStack.top() );
+	return result;
+}
+
+void DeferredRendererImplementation::expandProcedural( const IECore::Renderer::Procedural *proc, IECore::Renderer *renderer, RenderContextPtr context )
+{
+	const tbb::tick_count startTime = tbb::tick_count::now();
+	{
+		// activates the render context on this thread.
+		ScopedRenderContext scopedProceduralContext( context, *this, "DeferredRendererImplementation::ProceduralTask::execute" );
+		proc->render( renderer );
+	}
+	const double time = ( tbb::tick_count::now() - startTime ).seconds();
 
+	const std::string className = proceduralClassName( proc );
+	tbb::spin_mutex::scoped_lock lock( m_proceduralStatisticsMutex );
+	ProceduralStatistics &statistics = m_proceduralStatistics[className];
+	statistics.count++;
+	statistics.time += time;
+}
 
 void DeferredRendererImplementation::addProcedural( IECore::Renderer::ProceduralPtr proc, IECore::RendererPtr renderer )
 {
@@ -452,6 +540,12 @@ void DeferredRendererImplementation::addProcedural( IECore::Renderer::Procedural
 			}
 			m_threadContextPool.clear();
 		}
+		else if( m_maxPendingProcedurals > 0 && m_pendingProcedurals >= m_maxPendingProcedurals )
+		{
+			// too many procedurals are waiting already - expand this one
+			// immediately rather than adding to them.
+			expandProcedural( proc.get(), renderer.get(), proceduralContext() );
+		}
 		else
 		{
 			ProceduralTask *parentTask = dynamic_cast< ProceduralTask *>(&ProceduralTask::self());
@@ -460,7 +554,7 @@ void DeferredRendererImplementation::addProcedural( IECore::Renderer::Procedural
 				// add a child task to the current task
 				ProceduralTask& a = *new(parentTask->allocate_child()) ProceduralTask( *this, proc, renderer );
 				// register this class on the parent task
-				parentTask->addSubtask( a );
+				parentTask->addSubtask( a, proceduralCost( proc.get(), getTransform() ) );
 			}
 			else
 			{
@@ -476,6 +570,32 @@ void DeferredRendererImplementation::addProcedural( IECore::Renderer::Procedural
 	}
 }
 
+void DeferredRendererImplementation::setMaxPendingProcedurals( int maxPendingProcedurals )
+{
+	m_maxPendingProcedurals = maxPendingProcedurals;
+}
+
+int DeferredRendererImplementation::getMaxPendingProcedurals() const
+{
+	return m_maxPendingProcedurals;
+}
+
+IECore::CompoundDataPtr DeferredRendererImplementation::proceduralStatistics() const
+{
+	IECore::CompoundDataPtr result = new IECore::CompoundData;
+
+	tbb::spin_mutex::scoped_lock lock( m_proceduralStatisticsMutex );
+	for( ProceduralStatisticsMap::const_iterator it = m_proceduralStatistics.begin(), eIt = m_proceduralStatistics.end(); it != eIt; ++it )
+	{
+		IECore::CompoundDataPtr s = new IECore::CompoundData;
+		s->writable()["count"] = new IECore::IntData( it->second.count );
+		s->writable()["time"] = new IECore::DoubleData( it->second.time );
+		result->writable()[it->first] = s;
+	}
+
+	return result;
+}
+
 ScenePtr DeferredRendererImplementation::scene()
 {
 	return m_scene;
@@ -92,6 +92,18 @@ const AlphaTexture *Font::texture() const
 
 void Font::renderSprites( const std::string &text ) const
 {
+	vector<V2f> positions, texCoords;
+	spriteQuads( text, positions, texCoords );
+	renderSpriteQuads( positions, texCoords );
+}
+
+void Font::spriteQuads( const std::string &text, std::vector<Imath::V2f> &positions, std::vector<Imath::V2f> &texCoords ) const
+{
+	positions.clear();
+	texCoords.clear();
+	positions.reserve( text.size() * 4 );
+	texCoords.reserve( text.size() * 4 );
+
 	Box2f charBound = m_font->bound();
 	V2f origin( 0 );
 
@@ -104,21 +116,18 @@ void Font::renderSprites( const std::string &text ) const
 		int tx = c % 16;
 		int ty = 7 - (c / 16);
 
-		glBegin( GL_QUADS );
+		texCoords.push_back( V2f( tx * sStep + eps, ty * tStep + eps ) );
+		positions.push_back( V2f( origin.x + charBound.min.x, origin.y + charBound.min.y ) );
 
-			glTexCoord2f( tx * sStep + eps, ty * tStep + eps );
-			glVertex2f( origin.x + charBound.min.x, origin.y + charBound.min.y );
+		texCoords.push_back( V2f( (tx + 1) * sStep - eps, ty * tStep + eps ) );
+		positions.push_back( V2f( origin.x + charBound.max.x, origin.y + charBound.min.y ) );
 
-			glTexCoord2f( (tx + 1) * sStep - eps, ty * tStep + eps );
-			glVertex2f( origin.x + charBound.max.x, origin.y + charBound.min.y );
+		texCoords.push_back( V2f( (tx + 1) * sStep - eps, (ty + 1) * tStep - eps ) );
+		positions.push_back( V2f( origin.x + charBound.max.x, origin.y + charBound.max.y ) );
 
-			glTexCoord2f( (tx + 1) * sStep - eps, (ty + 1) * tStep - eps );
-			glVertex2f( origin.x + charBound.max.x, origin.y + charBound.max.y );
+		texCoords.push_back( V2f( tx * sStep + eps, (ty + 1) * tStep - eps ) );
+		positions.push_back( V2f( origin.x + charBound.min.x, origin.y + charBound.max.y ) );
 
-			glTexCoord2f( tx * sStep + eps, (ty + 1) * tStep - eps);
-			glVertex2f( origin.x + charBound.min.x, origin.y + charBound.max.y );
-
-		glEnd();
 		if( i < text.size() - 1 )
 		{
 			origin += m_font->advance( c, text[i+1] );
@@ -126,6 +135,25 @@ void Font::renderSprites( const std::string &text ) const
 	}
 }
 
+void Font::renderSpriteQuads( const std::vector<Imath::V2f> &positions, const std::vector<Imath::V2f> &texCoords )
+{
+	if( positions.empty() )
+	{
+		return;
+	}
+
+	glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glVertexPointer( 2, GL_FLOAT, 0, &positions[0] );
+		glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+		glTexCoordPointer( 2, GL_FLOAT, 0, &texCoords[0] );
+
+		glDrawArrays( GL_QUADS, 0, positions.size() );
+
+	glPopClientAttrib();
+}
+
 void Font::renderMeshes( const std::string &text, State *state ) const
 {
 	glPushMatrix();
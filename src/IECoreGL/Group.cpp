@@ -35,6 +35,8 @@
 #include "IECoreGL/GL.h"
 #include "IECoreGL/Group.h"
 #include "IECoreGL/State.h"
+#include "IECoreGL/MeshPrimitive.h"
+#include "IECoreGL/Selector.h"
 
 #include "OpenEXR/ImathBoxAlgo.h"
 
@@ -42,6 +44,150 @@ using namespace IECoreGL;
 using namespace Imath;
 using namespace std;
 
+//////////////////////////////////////////////////////////////////////////
+// Selection utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Returns true if the box can't possibly intersect the current
+// view volume. During selection the projection matrix contains
+// the pick matrix, so the view volume is just the selection region,
+// and this lets us reject whole subtrees before drawing them.
+bool outsideSelectionRegion( const Box3f &box )
+{
+	if( box.isEmpty() )
+	{
+		return false;
+	}
+
+	M44f modelView, projection;
+	glGetFloatv( GL_MODELVIEW_MATRIX, modelView.getValue() );
+	glGetFloatv( GL_PROJECTION_MATRIX, projection.getValue() );
+	const M44f clip = modelView * projection;
+
+	unsigned outside = 0x3f;
+	for( int i = 0; i < 8; ++i )
+	{
+		const V3f p(
+			i & 1 ? box.max.x : box.min.x,
+			i & 2 ? box.max.y : box.min.y,
+			i & 4 ? box.max.z : box.min.z
+		);
+
+		float c[4];
+		for( int j = 0; j < 4; ++j )
+		{
+			c[j] = p.x * clip[0][j] + p.y * clip[1][j] + p.z * clip[2][j] + clip[3][j];
+		}
+
+		unsigned code = 0;
+		code |= c[0] < -c[3] ? 0x01 : 0;
+		code |= c[0] > c[3] ? 0x02 : 0;
+		code |= c[1] < -c[3] ? 0x04 : 0;
+		code |= c[1] > c[3] ? 0x08 : 0;
+		code |= c[2] < -c[3] ? 0x10 : 0;
+		code |= c[2] > c[3] ? 0x20 : 0;
+
+		outside &= code;
+		if( !outside )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Instancing utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Runs of at least this many consecutive instances of the
+// same mesh are drawn with a single instanced draw call.
+const size_t g_minInstances = 2;
+
+// A child which consists of a chain of Groups, each with a
+// single child, terminating in a MeshPrimitive. This is
+// the form generated by the Renderer when the same mesh
+// (automatically instanced by hash) is rendered repeatedly
+// with differing transforms.
+struct Instance
+{
+
+	Instance()
+		:	primitive( 0 )
+	{
+	}
+
+	// Returns true if renderable meets the criteria above.
+	bool set( const Renderable *renderable )
+	{
+		groups.clear();
+		transform = M44f();
+		while( const Group *group = IECore::runTimeCast<const Group>( renderable ) )
+		{
+			if( group->children().size() != 1 )
+			{
+				return false;
+			}
+			groups.push_back( group );
+			transform = group->getTransform() * transform;
+			renderable = group->children().front().get();
+		}
+		primitive = IECore::runTimeCast<const MeshPrimitive>( renderable );
+		return primitive && groups.size();
+	}
+
+	// Returns true if other can be drawn alongside this
+	// in a single instanced draw call.
+	bool compatible( const Instance &other ) const
+	{
+		if( other.primitive != primitive || other.groups.size() != groups.size() )
+		{
+			return false;
+		}
+		for( size_t i = 0; i < groups.size(); ++i )
+		{
+			if( !groups[i]->getState()->equivalent( *(other.groups[i]->getState()) ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const MeshPrimitive *primitive;
+	vector<const Group *> groups;
+	M44f transform;
+
+};
+
+// Binds the states of the groups in turn, and then renders
+// the primitive for each of the transforms.
+void renderInstances( const Instance &instance, const vector<M44f> &transforms, size_t level, State *currentState )
+{
+	if( level == instance.groups.size() )
+	{
+		instance.primitive->renderInstanced( currentState, transforms );
+		return;
+	}
+
+	State::ScopedBinding scope( *(instance.groups[level]->getState()), *currentState );
+	renderInstances( instance, transforms, level + 1, currentState );
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Group
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Group );
 
 Group::Group()
@@ -85,6 +231,13 @@ void Group::setState( StatePtr state )
 
 void Group::render( State *currentState ) const
 {
+	if( Selector::currentSelector() && outsideSelectionRegion( bound() ) )
+	{
+		// Nothing below us can be hit, so there's no need
+		// to draw it.
+		return;
+	}
+
 	const bool haveTransform = m_transform != M44f();
 	if( haveTransform )
 	{
@@ -108,9 +261,34 @@ void Group::render( State *currentState ) const
 	
 	{
 		State::ScopedBinding scope( *m_state, *currentState );
-		for( ChildContainer::const_iterator it=m_children.begin(); it!=m_children.end(); it++ )
+
+		Instance instance, nextInstance;
+		vector<M44f> transforms;
+		for( ChildContainer::const_iterator it=m_children.begin(); it!=m_children.end(); )
 		{
+			// Gather up a run of consecutive instances of the same mesh
+			// with equivalent state, and if it is long enough, draw them
+			// all at once.
+			ChildContainer::const_iterator runEnd = it;
+			if( instance.set( it->get() ) )
+			{
+				transforms.clear();
+				transforms.push_back( instance.transform );
+				for( ++runEnd; runEnd != m_children.end() && nextInstance.set( runEnd->get() ) && instance.compatible( nextInstance ); ++runEnd )
+				{
+					transforms.push_back( nextInstance.transform );
+				}
+
+				if( transforms.size() >= g_minInstances )
+				{
+					renderInstances( instance, transforms, 0, currentState );
+					it = runEnd;
+					continue;
+				}
+			}
+
 			(*it)->render( currentState );
+			++it;
 		}
 	}
 	
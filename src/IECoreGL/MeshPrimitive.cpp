@@ -33,12 +33,19 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <cassert>
+#include <algorithm>
 
 #include "IECore/DespatchTypedData.h"
 
 #include "IECoreGL/MeshPrimitive.h"
 #include "IECoreGL/GL.h"
 #include "IECoreGL/State.h"
+#include "IECoreGL/Buffer.h"
+#include "IECoreGL/CachedConverter.h"
+#include "IECoreGL/Selector.h"
+#include "IECoreGL/ShaderLoader.h"
+#include "IECoreGL/ShaderStateComponent.h"
+#include "IECoreGL/TypedStateComponent.h"
 
 #include "OpenEXR/ImathMath.h"
 
@@ -47,6 +54,116 @@ using namespace Imath;
 using namespace std;
 
 
+//////////////////////////////////////////////////////////////////////////
+// Instancing utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// The default vertex shader, modified to apply a per-instance
+// transform passed in the four columns of instanceMatrix.
+const std::string &instancingVertexSource()
+{
+	static string s =
+
+		"#version 120\n"
+		""
+		"#if __VERSION__ <= 120\n"
+		"#define in attribute\n"
+		"#define out varying\n"
+		"#endif\n"
+		""
+		"uniform vec3 Cs = vec3( 1, 1, 1 );"
+		"uniform bool vertexCsActive = false;"
+		""
+		"in vec3 vertexP;"
+		"in vec3 vertexN;"
+		"in vec2 vertexst;"
+		"in vec3 vertexCs;"
+		""
+		"in vec4 instanceMatrix0;"
+		"in vec4 instanceMatrix1;"
+		"in vec4 instanceMatrix2;"
+		"in vec4 instanceMatrix3;"
+		""
+		"out vec3 fragmentI;"
+		"out vec3 fragmentP;"
+		"out vec3 fragmentN;"
+		"out vec2 fragmentst;"
+		"out vec3 fragmentCs;"
+		""
+		"void main()"
+		"{"
+		"	mat4 instanceMatrix = mat4( instanceMatrix0, instanceMatrix1, instanceMatrix2, instanceMatrix3 );"
+		"	vec4 pCam = gl_ModelViewMatrix * instanceMatrix * vec4( vertexP, 1 );"
+		"	gl_Position = gl_ProjectionMatrix * pCam;"
+		"	fragmentP = pCam.xyz;"
+		"	fragmentN = normalize( gl_NormalMatrix * mat3( instanceMatrix ) * vertexN );"
+		"	if( gl_ProjectionMatrix[2][3] != 0.0 )"
+		"	{"
+		"		fragmentI = normalize( -pCam.xyz );"
+		"	}"
+		"	else"
+		"	{"
+		"		fragmentI = vec3( 0, 0, -1 );"
+		"	}"
+		""
+		"	fragmentst = vertexst;"
+		"	fragmentCs = mix( Cs, vertexCs, float( vertexCsActive ) );"
+		"}";
+
+	return s;
+}
+
+struct InstancingShader
+{
+
+	InstancingShader( const IECore::MurmurHash &hash, const Shader::ConstSetupPtr &shaderSetup = Shader::ConstSetupPtr() )
+		:	hash( hash ), shaderSetup( shaderSetup )
+	{
+	}
+
+	IECore::MurmurHash hash;
+	Shader::ConstSetupPtr shaderSetup;
+
+	bool operator < ( const InstancingShader &rhs ) const
+	{
+		return hash < rhs.hash;
+	}
+
+};
+
+// Makes a shader setup equivalent to the one in the state, but
+// with the vertex shader replaced by one which performs instancing.
+const Shader::Setup *instancingShaderSetup( State *state )
+{
+	ShaderStateComponent *shaderStateComponent = state->get<ShaderStateComponent>();
+	const IECore::MurmurHash hash = shaderStateComponent->hash();
+
+	static vector<InstancingShader> instancingShaders;
+	vector<InstancingShader>::iterator it = lower_bound(
+		instancingShaders.begin(),
+		instancingShaders.end(),
+		hash
+	);
+	if( it != instancingShaders.end() && it->hash == hash )
+	{
+		return it->shaderSetup.get();
+	}
+
+	const Shader *originalShader = shaderStateComponent->shaderSetup()->shader();
+	ConstShaderPtr shader = shaderStateComponent->shaderLoader()->create( instancingVertexSource(), "", originalShader->fragmentSource() );
+	Shader::SetupPtr shaderSetup = new Shader::Setup( shader );
+	shaderStateComponent->addParametersToShaderSetup( shaderSetup.get() );
+
+	instancingShaders.insert( it, InstancingShader( hash, shaderSetup.get() ) );
+
+	return shaderSetup.get();
+}
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // MemberData
 //////////////////////////////////////////////////////////////////////////
@@ -60,8 +177,16 @@ class MeshPrimitive::MemberData : public IECore::RefCounted
 		{
 		}
 
+		MemberData( IECore::ConstUIntVectorDataPtr vertIds ) : numTriangles( vertIds->readable().size() / 3 ), vertIds( vertIds )
+		{
+		}
+
 		unsigned numTriangles;
 		Imath::Box3f bound;
+		
+		/// Only set for indexed meshes.
+		IECore::ConstUIntVectorDataPtr vertIds;
+		mutable IECoreGL::ConstBufferPtr vertIdsBuffer;
 
 };
 
@@ -76,6 +201,11 @@ MeshPrimitive::MeshPrimitive( unsigned numTriangles )
 {
 }
 
+MeshPrimitive::MeshPrimitive( IECore::ConstUIntVectorDataPtr vertIds )
+	:	m_memberData( new MemberData( vertIds ) )
+{
+}
+
 MeshPrimitive::~MeshPrimitive()
 {
 }
@@ -97,7 +227,8 @@ void MeshPrimitive::addPrimitiveVariable( const std::string &name, const IECore:
 		}
 	}
 
-	if ( primVar.interpolation==IECore::PrimitiveVariable::FaceVarying )
+	const IECore::PrimitiveVariable::Interpolation vertexInterpolation = m_memberData->vertIds ? IECore::PrimitiveVariable::Vertex : IECore::PrimitiveVariable::FaceVarying;
+	if ( primVar.interpolation==vertexInterpolation )
 	{
 		addVertexAttribute( name, primVar.data );
 	}
@@ -105,15 +236,113 @@ void MeshPrimitive::addPrimitiveVariable( const std::string &name, const IECore:
 	{
 		addUniformAttribute( name, primVar.data );
 	}
-	else if ( primVar.interpolation==IECore::PrimitiveVariable::Vertex || primVar.interpolation==IECore::PrimitiveVariable::Varying )
+	else if ( primVar.interpolation!=IECore::PrimitiveVariable::Invalid )
 	{
-		throw( "IECoreGL::MeshPrimitive : Invalid interpolation for \"" + name + "\". Must be FaceVarying or Constant." );
+		throw IECore::Exception(
+			"IECoreGL::MeshPrimitive : Invalid interpolation for \"" + name + "\". Must be " +
+			( m_memberData->vertIds ? "Vertex" : "FaceVarying" ) + " or Constant."
+		);
 	}
 }
 
 void MeshPrimitive::renderInstances( size_t numInstances ) const
 {
-	glDrawArraysInstancedARB( GL_TRIANGLES, 0, m_memberData->numTriangles * 3, numInstances );
+	if( !m_memberData->vertIds )
+	{
+		glDrawArraysInstancedARB( GL_TRIANGLES, 0, m_memberData->numTriangles * 3, numInstances );
+		return;
+	}
+
+	if( !m_memberData->vertIdsBuffer )
+	{
+		CachedConverterPtr cachedConverter = CachedConverter::defaultCachedConverter();
+		m_memberData->vertIdsBuffer = IECore::runTimeCast<const Buffer>( cachedConverter->convert( m_memberData->vertIds.get() ) );
+	}
+
+	Buffer::ScopedBinding indexBinding( *(m_memberData->vertIdsBuffer), GL_ELEMENT_ARRAY_BUFFER );
+	glDrawElementsInstancedARB( GL_TRIANGLES, m_memberData->numTriangles * 3, GL_UNSIGNED_INT, 0, numInstances );
+}
+
+void MeshPrimitive::renderInstanced( State *state, const std::vector<Imath::M44f> &transforms ) const
+{
+	if( !instancedRenderingSupported( state ) )
+	{
+		for( std::vector<Imath::M44f>::const_iterator it = transforms.begin(), eIt = transforms.end(); it != eIt; ++it )
+		{
+			glPushMatrix();
+			glMultMatrixf( it->getValue() );
+			render( state );
+			glPopMatrix();
+		}
+		return;
+	}
+
+	// Imath matrices are stored in row-major order, so when read by GL
+	// in column-major order, each row provides one column.
+	IECore::Color4fVectorDataPtr columns[4];
+	for( int i = 0; i < 4; ++i )
+	{
+		columns[i] = new IECore::Color4fVectorData;
+		columns[i]->writable().reserve( transforms.size() );
+	}
+	for( std::vector<Imath::M44f>::const_iterator it = transforms.begin(), eIt = transforms.end(); it != eIt; ++it )
+	{
+		for( int i = 0; i < 4; ++i )
+		{
+			columns[i]->writable().push_back( Imath::Color4f( (*it)[i][0], (*it)[i][1], (*it)[i][2], (*it)[i][3] ) );
+		}
+	}
+
+	PushAttrib attributeBlock( GL_DEPTH_BUFFER_BIT );
+	glDepthMask( true );
+
+	const Shader::Setup *uniformSetup = instancingShaderSetup( state );
+	Shader::Setup::ScopedBinding uniformBinding( *uniformSetup );
+
+	Shader::SetupPtr primitiveSetup = new Shader::Setup( uniformSetup->shader() );
+	addPrimitiveVariablesToShaderSetup( primitiveSetup.get() );
+	primitiveSetup->addVertexAttribute( "instanceMatrix0", columns[0], 1 );
+	primitiveSetup->addVertexAttribute( "instanceMatrix1", columns[1], 1 );
+	primitiveSetup->addVertexAttribute( "instanceMatrix2", columns[2], 1 );
+	primitiveSetup->addVertexAttribute( "instanceMatrix3", columns[3], 1 );
+	Shader::Setup::ScopedBinding primitiveBinding( *primitiveSetup );
+
+	// inherit Cs from the state if it isn't provided by the shader or a primitive variable
+	if( !uniformSetup->hasCsValue() && !primitiveSetup->hasCsValue() )
+	{
+		if( const Shader::Parameter *csParameter = primitiveSetup->shader()->csParameter() )
+		{
+			glUniform3fv( csParameter->location, 1, state->get<Color>()->value().getValue() );
+		}
+	}
+
+	renderInstances( transforms.size() );
+}
+
+bool MeshPrimitive::instancedRenderingSupported( const State *state ) const
+{
+	if( Selector::currentSelector() )
+	{
+		// selection needs the usual per-primitive id shaders
+		return false;
+	}
+
+	if(
+		!state->get<Primitive::DrawSolid>()->value() ||
+		state->get<Primitive::DrawWireframe>()->value() ||
+		state->get<Primitive::DrawOutline>()->value() ||
+		state->get<Primitive::DrawPoints>()->value() ||
+		state->get<Primitive::DrawBound>()->value() ||
+		depthSortRequested( state )
+	)
+	{
+		return false;
+	}
+
+	// we can only substitute our instancing vertex shader if the user
+	// hasn't specified their own vertex or geometry shader.
+	const Shader *shader = state->get<ShaderStateComponent>()->shaderSetup()->shader();
+	return shader->vertexSource() == "" && shader->geometrySource() == "";
 }
 
 Imath::Box3f MeshPrimitive::bound() const
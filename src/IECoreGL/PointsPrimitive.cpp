@@ -34,8 +34,16 @@
 
 #include "OpenEXR/ImathFun.h"
 #include "OpenEXR/ImathMatrixAlgo.h"
+#include "OpenEXR/ImathBoxAlgo.h"
+#include "OpenEXR/ImathRandom.h"
+
+#include <limits>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 #include "IECore/MessageHandler.h"
+#include "IECore/RadixSort.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/VectorTypedData.h"
 
@@ -49,6 +57,8 @@
 #include "IECoreGL/ShaderStateComponent.h"
 #include "IECoreGL/ShaderLoader.h"
 #include "IECoreGL/TextureLoader.h"
+#include "IECoreGL/CachedConverter.h"
+#include "IECoreGL/Buffer.h"
 #include "IECoreGL/GL.h"
 
 using namespace IECoreGL;
@@ -65,6 +75,8 @@ namespace IECoreGL
 
 IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( PointsPrimitive::UseGLPoints, PointsPrimitiveUseGLPointsTypeId, GLPointsUsage, ForPointsOnly );
 IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( PointsPrimitive::GLPointWidth, PointsPrimitiveGLPointWidthTypeId, float, 1.0f );
+IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( PointsPrimitive::LODMinimumWidth, PointsPrimitiveLODMinimumWidthTypeId, float, 0.0f );
+IECOREGL_TYPEDSTATECOMPONENT_SPECIALISEANDINSTANTIATE( PointsPrimitive::LODDensity, PointsPrimitiveLODDensityTypeId, float, 0.0f );
 
 } // namespace IECoreGL
 
@@ -89,11 +101,19 @@ class PointsPrimitive::MemberData : public IECore::RefCounted
 		IECore::ConstDataPtr rotations;
 
 		mutable Imath::Box3f bound;
+		mutable float maxRadius;
 		mutable bool recomputeBound;
 
-		mutable bool renderSorted;
-		mutable std::vector<unsigned int> depthOrder;
-		mutable std::vector<float> depths;
+		// A random permutation of the point indices, used to
+		// choose a subset of points to draw for level of detail.
+		mutable IECore::UIntVectorDataPtr lodOrder;
+		mutable ConstBufferPtr lodOrderBuffer;
+
+		// The point indices sorted from back to front, along with
+		// the view direction used to compute them.
+		mutable IECore::RadixSort depthSorter;
+		mutable std::vector<unsigned int> depths;
+		mutable ConstBufferPtr depthOrderBuffer;
 		mutable Imath::V3f depthCameraDirection;
 
 		struct InstancingSetup
@@ -145,6 +165,7 @@ void PointsPrimitive::updateBounds() const
 
 	m_memberData->recomputeBound = false;
 
+	m_memberData->maxRadius = 0.0f;
 	if( !m_memberData->points )
 	{
 		m_memberData->bound = Box3f();
@@ -166,6 +187,7 @@ void PointsPrimitive::updateBounds() const
 			r /= *a;
 		}
 		a += aStep;
+		m_memberData->maxRadius = max( m_memberData->maxRadius, r );
 		m_memberData->bound.extendBy( Box3f( pd[i] - V3f( r ), pd[i] + V3f( r ) ) );
 	}
 }
@@ -176,6 +198,9 @@ void PointsPrimitive::addPrimitiveVariable( const std::string &name, const IECor
 	{
 		m_memberData->recomputeBound = true;
 		m_memberData->points = IECore::runTimeCast< IECore::V3fVectorData >( primVar.data->copy() );
+		m_memberData->lodOrder = 0;
+		m_memberData->lodOrderBuffer = 0;
+		m_memberData->depthOrderBuffer = 0;
 	}
 	else if( name == "constantwidth" )
 	{
@@ -283,21 +308,18 @@ void PointsPrimitive::render( const State *currentState, IECore::TypeId style )
 		return;
 	}
 
-	/*if( depthSortRequested( state ) )
-	{
-		depthSort();
-		m_memberData->renderSorted = true;
-	}
-	else
-	{
-		m_memberData->renderSorted = false;
-	}*/
-
 	switch( effectiveType( currentState ) )
 	{
 		case Point :
 			glPointSize( currentState->get<GLPointWidth>()->value() );
-			renderInstances( 1 );
+			if( depthSortRequested( currentState ) )
+			{
+				renderSortedPoints();
+			}
+			else
+			{
+				renderPoints( lodPointCount( currentState ) );
+			}
 			break;
 		case Disk :
 			m_memberData->diskPrimitive->renderInstances( m_memberData->points->readable().size() );
@@ -361,9 +383,117 @@ PointsPrimitive::Type PointsPrimitive::effectiveType( const State *state ) const
 			result = Point;
 			break;
 	}
+
+	if( result != Point )
+	{
+		const float minimumWidth = state->get<LODMinimumWidth>()->value();
+		if( minimumWidth > 0.0f && projectedPointWidth() < minimumWidth )
+		{
+			result = Point;
+		}
+	}
+
 	return result;
 }
 
+float PointsPrimitive::projectedPointWidth() const
+{
+	updateBounds();
+	if( m_memberData->bound.isEmpty() )
+	{
+		return 0.0f;
+	}
+
+	const M44f modelView = Camera::matrix();
+	const M44f projection = Camera::projectionMatrix();
+	GLint viewport[4];
+	glGetIntegerv( GL_VIEWPORT, viewport );
+
+	const float scale = V3f( modelView[0][0], modelView[0][1], modelView[0][2] ).length();
+	float width = m_memberData->maxRadius * scale * projection[0][0] * viewport[2];
+	if( Camera::perspectiveProjection() )
+	{
+		const float nearestDepth = -transform( m_memberData->bound, modelView ).max.z;
+		if( nearestDepth <= 0.0f )
+		{
+			// the camera is inside or in front of the bound
+			return numeric_limits<float>::max();
+		}
+		width /= nearestDepth;
+	}
+
+	return width;
+}
+
+size_t PointsPrimitive::lodPointCount( const State *state ) const
+{
+	const size_t numPoints = m_memberData->points->readable().size();
+	const float density = state->get<LODDensity>()->value();
+	if( density <= 0.0f )
+	{
+		return numPoints;
+	}
+
+	updateBounds();
+	const M44f m = Camera::matrix() * Camera::projectionMatrix();
+	GLint viewport[4];
+	glGetIntegerv( GL_VIEWPORT, viewport );
+
+	const Box3f &b = m_memberData->bound;
+	Box2f rasterBound;
+	for( int i = 0; i < 8; ++i )
+	{
+		const V3f p( i & 1 ? b.max.x : b.min.x, i & 2 ? b.max.y : b.min.y, i & 4 ? b.max.z : b.min.z );
+		const float w = p.x * m[0][3] + p.y * m[1][3] + p.z * m[2][3] + m[3][3];
+		if( w <= 0.0f )
+		{
+			// part of the bound is behind the camera
+			return numPoints;
+		}
+		const float x = p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0];
+		const float y = p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1];
+		rasterBound.extendBy( V2f( x / w * 0.5f * viewport[2], y / w * 0.5f * viewport[3] ) );
+	}
+
+	const V2f size = rasterBound.size();
+	const float maxPoints = std::max( size.x * size.y * density, 1.0f );
+	return maxPoints < numPoints ? static_cast<size_t>( maxPoints ) : numPoints;
+}
+
+void PointsPrimitive::renderPoints( size_t numPoints ) const
+{
+	const vector<V3f> &points = m_memberData->points->readable();
+	if( numPoints >= points.size() )
+	{
+		renderInstances( 1 );
+		return;
+	}
+
+	if( !m_memberData->lodOrderBuffer )
+	{
+		// Drawing the first numPoints elements of a random permutation gives
+		// an unbiased subset, and successive levels of detail are nested within
+		// each other, so points don't flicker as the level changes.
+		m_memberData->lodOrder = new UIntVectorData;
+		vector<unsigned int> &order = m_memberData->lodOrder->writable();
+		order.resize( points.size() );
+		for( size_t i = 0; i < order.size(); ++i )
+		{
+			order[i] = i;
+		}
+		Rand32 r( 0 );
+		for( size_t i = order.size() - 1; i > 0; --i )
+		{
+			swap( order[i], order[r.nexti() % ( i + 1 )] );
+		}
+		CachedConverterPtr cachedConverter = CachedConverter::defaultCachedConverter();
+		m_memberData->lodOrderBuffer = IECore::runTimeCast<const Buffer>( cachedConverter->convert( m_memberData->lodOrder.get() ) );
+	}
+
+	Buffer::ScopedBinding indexBinding( *(m_memberData->lodOrderBuffer), GL_ELEMENT_ARRAY_BUFFER );
+	glDrawElements( GL_POINTS, numPoints, GL_UNSIGNED_INT, 0 );
+}
+
 std::string &PointsPrimitive::instancingVertexSource()
 {
 	static std::string s =
@@ -415,49 +545,89 @@ std::string &PointsPrimitive::instancingVertexSource()
 	return s;
 }
 
-struct SortFn
+namespace
 {
-	SortFn( const vector<float> &d ) : depths( d ) {};
-	bool operator()( int f, int s ) { return depths[f] > depths[s]; };
-	const vector<float> &depths;
+
+// Computes depths along the view direction, quantised to 16 bits so
+// that the radix sort needs only two passes. The depths are inverted
+// so that an ascending sort orders the points from back to front.
+class QuantiseDepths
+{
+
+	public :
+
+		QuantiseDepths( const V3f *points, const V3f &direction, float minDepth, float scale, unsigned int *depths )
+			:	m_points( points ), m_direction( direction ), m_minDepth( minDepth ), m_scale( scale ), m_depths( depths )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t i = r.begin(), e = r.end(); i < e; ++i )
+			{
+				const float d = ( m_points[i].dot( m_direction ) - m_minDepth ) * m_scale;
+				m_depths[i] = 65535 - static_cast<unsigned int>( clamp( d, 0.0f, 65535.0f ) );
+			}
+		}
+
+	private :
+
+		const V3f *m_points;
+		const V3f m_direction;
+		const float m_minDepth;
+		const float m_scale;
+		unsigned int *m_depths;
+
 };
 
-/// \todo Use IECore::RadixSort (might still want to use std::sort for small numbers of points - profile to check this)
+} // namespace
+
 void PointsPrimitive::depthSort() const
 {
 	V3f cameraDirection = Camera::viewDirectionInObjectSpace();
 	cameraDirection.normalize();
 
-	const vector<V3f> &points = m_memberData->points->readable();
-	if( !m_memberData->depthOrder.size() )
-	{
-		// never sorted before. initialize space.
-		m_memberData->depthOrder.resize( points.size() );
-		for( unsigned int i=0; i<m_memberData->depthOrder.size(); i++ )
-		{
-			m_memberData->depthOrder[i] = i;
-		}
-		m_memberData->depths.resize( points.size() );
-	}
-	else
+	// If we've sorted before, see if the camera direction has
+	// changed enough to warrant resorting.
+	if( m_memberData->depthOrderBuffer && cameraDirection.dot( m_memberData->depthCameraDirection ) > 0.95 )
 	{
-		// sorted before. see if the camera direction has changed enough
-		// to warrant resorting.
-		if( cameraDirection.dot( m_memberData->depthCameraDirection ) > 0.95 )
-		{
-			return;
-		}
+		return;
 	}
 
 	m_memberData->depthCameraDirection = cameraDirection;
 
-	// calculate all distances
-	for( unsigned int i=0; i<m_memberData->depths.size(); i++ )
+	// Find the range of depths from the bound, so that we
+	// don't need a separate pass over the points.
+	updateBounds();
+	const Box3f &b = m_memberData->bound;
+	float minDepth = numeric_limits<float>::max();
+	float maxDepth = -numeric_limits<float>::max();
+	for( int i = 0; i < 8; ++i )
 	{
-		m_memberData->depths[i] = points[i].dot( m_memberData->depthCameraDirection );
+		const V3f p( i & 1 ? b.max.x : b.min.x, i & 2 ? b.max.y : b.min.y, i & 4 ? b.max.z : b.min.z );
+		const float d = p.dot( cameraDirection );
+		minDepth = min( minDepth, d );
+		maxDepth = max( maxDepth, d );
 	}
+	const float scale = maxDepth > minDepth ? 65535.0f / ( maxDepth - minDepth ) : 0.0f;
 
-	// sort based on those distances
-	SortFn sorter( m_memberData->depths );
-	sort( m_memberData->depthOrder.begin(), m_memberData->depthOrder.end(), sorter );
+	const vector<V3f> &points = m_memberData->points->readable();
+	vector<unsigned int> &depths = m_memberData->depths;
+	depths.resize( points.size() );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, points.size(), 10000 ),
+		QuantiseDepths( &points[0], cameraDirection, minDepth, scale, &depths[0] )
+	);
+
+	// The sorter is reused between calls, so it can exploit
+	// the coherence between successive orders.
+	const vector<unsigned int> &order = m_memberData->depthSorter( depths );
+	m_memberData->depthOrderBuffer = new Buffer( &order[0], order.size() * sizeof( unsigned int ), GL_ELEMENT_ARRAY_BUFFER, GL_DYNAMIC_DRAW );
+}
+
+void PointsPrimitive::renderSortedPoints() const
+{
+	depthSort();
+	Buffer::ScopedBinding indexBinding( *(m_memberData->depthOrderBuffer), GL_ELEMENT_ARRAY_BUFFER );
+	glDrawElements( GL_POINTS, m_memberData->points->readable().size(), GL_UNSIGNED_INT, 0 );
 }
@@ -371,12 +371,37 @@ void Primitive::render( const State *currentState, IECore::TypeId style ) const
 
 void Primitive::addUniformAttribute( const std::string &name, IECore::ConstDataPtr data )
 {
-	m_uniformAttributes[name] = data->copy();
+	addAttribute( m_uniformAttributes, name, data );
 }
 
 void Primitive::addVertexAttribute( const std::string &name, IECore::ConstDataPtr data )
 {
-	m_vertexAttributes[name] = data->copy();
+	addAttribute( m_vertexAttributes, name, data );
+}
+
+void Primitive::addAttribute( AttributeMap &attributes, const std::string &name, IECore::ConstDataPtr data )
+{
+	AttributeMap::iterator it = attributes.find( name );
+	if( it != attributes.end() )
+	{
+		if( it->second->hash() == data->hash() )
+		{
+			// Nothing has changed, so our existing shader setups remain valid.
+			return;
+		}
+		// Discard the shader setups referencing the old value. They'll be
+		// rebuilt on demand, and because the CachedConverter keys buffers
+		// by data hash, only the attributes which have changed will need
+		// uploading again. This allows a deforming primitive to update just
+		// "P" and "N", for instance, without rebuilding everything else.
+		m_shaderSetups.clear();
+		if( name == "P" )
+		{
+			m_boundSetup = 0;
+		}
+	}
+
+	attributes[name] = data->copy();
 }
 
 bool Primitive::depthSortRequested( const State * state ) const
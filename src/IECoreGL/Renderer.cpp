@@ -51,6 +51,7 @@
 #include "IECore/SplineToImage.h"
 #include "IECore/CurvesPrimitive.h"
 #include "IECore/PointsPrimitive.h"
+#include "IECore/InstancerAlgo.h"
 
 #include "IECoreGL/Renderer.h"
 #include "IECoreGL/State.h"
@@ -151,6 +152,7 @@ struct IECoreGL::Renderer::MemberData
 		vector<CameraPtr> cameras;
 		vector<DisplayPtr> displays;
 		bool drawCoordinateSystems;
+		int maxPendingProcedurals;
 	} options;
 
 	/// This is used only before worldBegin, so we can correctly get the transforms for cameras.
@@ -272,6 +274,7 @@ IECoreGL::Renderer::Renderer()
 	const char *texturePath = getenv( "IECOREGL_TEXTURE_PATHS" );
 	m_data->options.textureSearchPath = m_data->options.textureSearchPathDefault = texturePath ? texturePath : "";
 	m_data->options.drawCoordinateSystems = false;
+	m_data->options.maxPendingProcedurals = 0;
 	
 	m_data->transformStack.push( M44f() );
 
@@ -408,6 +411,28 @@ static IECore::DataPtr drawCoordinateSystemsOptionGetter( const std::string &nam
 	return new BoolData( memberData->options.drawCoordinateSystems );
 }
 
+static void maxPendingProceduralsOptionSetter( const std::string &name, IECore::ConstDataPtr value, IECoreGL::Renderer::MemberData *memberData )
+{
+	if( ConstIntDataPtr i = castWithWarning<IntData>( value, name, "Renderer::setOption" ) )
+	{
+		memberData->options.maxPendingProcedurals = i->readable();
+	}
+}
+
+static IECore::DataPtr maxPendingProceduralsOptionGetter( const std::string &name, IECoreGL::Renderer::MemberData *memberData )
+{
+	return new IntData( memberData->options.maxPendingProcedurals );
+}
+
+static IECore::DataPtr proceduralStatisticsOptionGetter( const std::string &name, IECoreGL::Renderer::MemberData *memberData )
+{
+	if( DeferredRendererImplementation *r = runTimeCast<DeferredRendererImplementation>( memberData->implementation.get() ) )
+	{
+		return r->proceduralStatistics();
+	}
+	return new CompoundData;
+}
+
 static const OptionSetterMap *optionSetters()
 {
 	static OptionSetterMap *o = new OptionSetterMap;
@@ -423,6 +448,7 @@ static const OptionSetterMap *optionSetters()
 		(*o)["gl:searchPath:texture"] = textureSearchPathOptionSetter;
 		(*o)["searchPath:texture"] = textureSearchPathOptionSetter;
 		(*o)["gl:drawCoordinateSystems"] = drawCoordinateSystemsOptionSetter;
+		(*o)["gl:procedural:maxPending"] = maxPendingProceduralsOptionSetter;
 	}
 	return o;
 }
@@ -442,6 +468,8 @@ static const OptionGetterMap *optionGetters()
 		(*o)["gl:searchPath:texture"] = textureSearchPathOptionGetter;
 		(*o)["searchPath:texture"] = textureSearchPathOptionGetter;
 		(*o)["gl:drawCoordinateSystems"] = drawCoordinateSystemsOptionGetter;
+		(*o)["gl:procedural:maxPending"] = maxPendingProceduralsOptionGetter;
+		(*o)["gl:procedural:statistics"] = proceduralStatisticsOptionGetter;
 	}
 	return o;
 }
@@ -571,7 +599,9 @@ void IECoreGL::Renderer::worldBegin()
 
 	if( m_data->options.mode==MemberData::Deferred )
 	{
-		m_data->implementation = new DeferredRendererImplementation;
+		DeferredRendererImplementationPtr r = new DeferredRendererImplementation;
+		r->setMaxPendingProcedurals( m_data->options.maxPendingProcedurals );
+		m_data->implementation = r;
 	}
 	else
 	{
@@ -1356,12 +1386,15 @@ static const AttributeSetterMap *attributeSetters()
 		(*a)["gl:shade:transparent"] = typedAttributeSetter<TransparentShadingStateComponent>;
 		(*a)["gl:pointsPrimitive:useGLPoints"] = pointsPrimitiveUseGLPointsSetter;
 		(*a)["gl:pointsPrimitive:glPointWidth"] = typedAttributeSetter<IECoreGL::PointsPrimitive::GLPointWidth>;
+		(*a)["gl:pointsPrimitive:lodMinimumWidth"] = typedAttributeSetter<IECoreGL::PointsPrimitive::LODMinimumWidth>;
+		(*a)["gl:pointsPrimitive:lodDensity"] = typedAttributeSetter<IECoreGL::PointsPrimitive::LODDensity>;
 		(*a)["name"] = nameSetter;
 		(*a)["doubleSided"] = typedAttributeSetter<DoubleSidedStateComponent>;
 		(*a)["rightHandedOrientation"] = typedAttributeSetter<RightHandedOrientationStateComponent>;
 		(*a)["gl:curvesPrimitive:useGLLines"] = typedAttributeSetter<IECoreGL::CurvesPrimitive::UseGLLines>;
 		(*a)["gl:curvesPrimitive:glLineWidth"] = typedAttributeSetter<IECoreGL::CurvesPrimitive::GLLineWidth>;
 		(*a)["gl:curvesPrimitive:ignoreBasis"] = typedAttributeSetter<IECoreGL::CurvesPrimitive::IgnoreBasis>;
+		(*a)["gl:curvesPrimitive:tessellationSegmentLength"] = typedAttributeSetter<IECoreGL::CurvesPrimitive::TessellationSegmentLength>;
 		(*a)["gl:smoothing:points"] = typedAttributeSetter<PointSmoothingStateComponent>;
 		(*a)["gl:smoothing:lines"] = typedAttributeSetter<LineSmoothingStateComponent>;
 		(*a)["gl:smoothing:polygons"] = typedAttributeSetter<PolygonSmoothingStateComponent>;
@@ -1410,12 +1443,15 @@ static const AttributeGetterMap *attributeGetters()
 		(*a)["gl:shade:transparent"] = typedAttributeGetter<TransparentShadingStateComponent>;
 		(*a)["gl:pointsPrimitive:useGLPoints"] = pointsPrimitiveUseGLPointsGetter;
 		(*a)["gl:pointsPrimitive:glPointWidth"] = typedAttributeGetter<IECoreGL::PointsPrimitive::GLPointWidth>;
+		(*a)["gl:pointsPrimitive:lodMinimumWidth"] = typedAttributeGetter<IECoreGL::PointsPrimitive::LODMinimumWidth>;
+		(*a)["gl:pointsPrimitive:lodDensity"] = typedAttributeGetter<IECoreGL::PointsPrimitive::LODDensity>;
 		(*a)["name"] = nameGetter;
 		(*a)["doubleSided"] = typedAttributeGetter<DoubleSidedStateComponent>;
 		(*a)["rightHandedOrientation"] = typedAttributeGetter<RightHandedOrientationStateComponent>;
 		(*a)["gl:curvesPrimitive:useGLLines"] = typedAttributeGetter<IECoreGL::CurvesPrimitive::UseGLLines>;
 		(*a)["gl:curvesPrimitive:glLineWidth"] = typedAttributeGetter<IECoreGL::CurvesPrimitive::GLLineWidth>;
 		(*a)["gl:curvesPrimitive:ignoreBasis"] = typedAttributeGetter<IECoreGL::CurvesPrimitive::IgnoreBasis>;
+		(*a)["gl:curvesPrimitive:tessellationSegmentLength"] = typedAttributeGetter<IECoreGL::CurvesPrimitive::TessellationSegmentLength>;
 		(*a)["gl:smoothing:points"] = typedAttributeGetter<PointSmoothingStateComponent>;
 		(*a)["gl:smoothing:lines"] = typedAttributeGetter<LineSmoothingStateComponent>;
 		(*a)["gl:smoothing:polygons"] = typedAttributeGetter<PolygonSmoothingStateComponent>;
@@ -1761,8 +1797,86 @@ void IECoreGL::Renderer::patchMesh( const IECore::CubicBasisf &uBasis, const IEC
 	msg( Msg::Warning, "Renderer::patchMesh", "Not implemented" );
 }
 
+static void instancer( const IECore::CompoundDataMap &topology, const IECore::PrimitiveVariableMap &primVars, IECoreGL::Renderer::MemberData *memberData )
+{
+	const vector<string> &prototypeNames = InstancerAlgo::prototypes( topology );
+	vector<int> prototypeIndices;
+	InstancerAlgo::prototypeIndices( primVars, prototypeNames.size(), prototypeIndices );
+	vector<M44f> transforms;
+	InstancerAlgo::transforms( primVars, transforms );
+
+	vector<GroupPtr> prototypes;
+	for( vector<string>::const_iterator it = prototypeNames.begin(), eIt = prototypeNames.end(); it != eIt; ++it )
+	{
+		IECoreGL::Renderer::MemberData::InstanceMap::const_iterator iIt = memberData->instances.find( *it );
+		if( iIt == memberData->instances.end() )
+		{
+			msg( Msg::Warning, "Renderer::geometry", boost::format( "No instance named \"%s\" was found." ) % *it );
+		}
+		prototypes.push_back( iIt != memberData->instances.end() ? iIt->second : 0 );
+	}
+
+	// Group the points by prototype, so that Group::render() sees
+	// long runs of the same prototype and can draw each run with
+	// a single instanced draw call.
+	vector<size_t> offsets( prototypes.size() + 1, 0 );
+	for( vector<int>::const_iterator it = prototypeIndices.begin(), eIt = prototypeIndices.end(); it != eIt; ++it )
+	{
+		offsets[*it + 1]++;
+	}
+	for( size_t i = 1; i < offsets.size(); ++i )
+	{
+		offsets[i] += offsets[i-1];
+	}
+	vector<size_t> order( prototypeIndices.size() );
+	for( size_t i = 0; i < prototypeIndices.size(); ++i )
+	{
+		order[offsets[prototypeIndices[i]]++] = i;
+	}
+
+	GroupPtr group = new Group;
+	for( vector<size_t>::const_iterator it = order.begin(), eIt = order.end(); it != eIt; ++it )
+	{
+		const GroupPtr &prototype = prototypes[prototypeIndices[*it]];
+		if( !prototype )
+		{
+			continue;
+		}
+		GroupPtr instanceGroup = new Group;
+		instanceGroup->setTransform( transforms[*it] );
+		instanceGroup->addChild( prototype );
+		group->addChild( instanceGroup );
+	}
+
+	if( memberData->currentInstance )
+	{
+		memberData->addCurrentInstanceChild( group );
+	}
+	else if( memberData->inWorld )
+	{
+		memberData->implementation->addInstance( group );
+	}
+	else
+	{
+		msg( Msg::Warning, "Renderer::geometry", "Unsupported instancer outside world and instance block!" );
+	}
+}
+
 void IECoreGL::Renderer::geometry( const std::string &type, const IECore::CompoundDataMap &topology, const IECore::PrimitiveVariableMap &primVars )
 {
+	if( type == "instancer" )
+	{
+		try
+		{
+			instancer( topology, primVars, m_data );
+		}
+		catch( const std::exception &e )
+		{
+			msg( Msg::Error, "Renderer::geometry", e.what() );
+		}
+		return;
+	}
+
 	msg( Msg::Warning, "Renderer::geometry", boost::format( "Geometry type \"%s\" not implemented." ) % type );
 }
 
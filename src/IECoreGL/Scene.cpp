@@ -38,15 +38,386 @@
 #include "IECoreGL/Camera.h"
 #include "IECoreGL/Selector.h"
 #include "IECoreGL/ShaderStateComponent.h"
+#include "IECoreGL/TypedStateComponent.h"
+#include "IECoreGL/MeshPrimitive.h"
+#include "IECoreGL/BoxPrimitive.h"
+
+#include "OpenEXR/ImathBoxAlgo.h"
+
+#include <algorithm>
 
 using namespace IECoreGL;
 using namespace Imath;
 using namespace std;
 
+//////////////////////////////////////////////////////////////////////////
+// RenderList
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Returns true if the box is entirely outside the view volume described
+// by clip, which transforms from the space of the box into clip space. This
+// is conservative - boxes near the corners of the frustum may not be culled.
+bool outsideFrustum( const Box3f &box, const M44f &clip )
+{
+	unsigned outside = 0x3f;
+	for( int i = 0; i < 8; ++i )
+	{
+		const V3f p(
+			i & 1 ? box.max.x : box.min.x,
+			i & 2 ? box.max.y : box.min.y,
+			i & 4 ? box.max.z : box.min.z
+		);
+
+		const float x = p.x * clip[0][0] + p.y * clip[1][0] + p.z * clip[2][0] + clip[3][0];
+		const float y = p.x * clip[0][1] + p.y * clip[1][1] + p.z * clip[2][1] + clip[3][1];
+		const float z = p.x * clip[0][2] + p.y * clip[1][2] + p.z * clip[2][2] + clip[3][2];
+		const float w = p.x * clip[0][3] + p.y * clip[1][3] + p.z * clip[2][3] + clip[3][3];
+
+		unsigned code = 0;
+		code |= x < -w ? 0x01 : 0;
+		code |= x > w ? 0x02 : 0;
+		code |= y < -w ? 0x04 : 0;
+		code |= y > w ? 0x08 : 0;
+		code |= z < -w ? 0x10 : 0;
+		code |= z > w ? 0x20 : 0;
+
+		outside &= code;
+		if( !outside )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+M44f currentMatrix( GLenum matrix )
+{
+	M44f result;
+	glGetFloatv( matrix, result.getValue() );
+	return result;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// RenderList
+//////////////////////////////////////////////////////////////////////////
+
+class Scene::RenderList : public IECore::RefCounted
+{
+
+	public :
+
+		RenderList( const Group *root, const State *baseState )
+			:	m_baseState( baseState )
+		{
+			StatePtr state = new State( *baseState );
+			m_states.push_back( state );
+			gather( root, M44f(), state.get() );
+			stable_sort( m_items.begin(), m_items.end(), ItemLess() );
+			buildRuns();
+		}
+
+		virtual ~RenderList()
+		{
+			for( Runs::const_iterator it = m_runs.begin(); it != m_runs.end(); ++it )
+			{
+				if( it->query )
+				{
+					glDeleteQueriesARB( 1, &it->query );
+				}
+			}
+		}
+
+		const State *baseState() const
+		{
+			return m_baseState;
+		}
+
+		void render( bool frustumCulling, bool occlusionCulling ) const
+		{
+			// The items are in the space of the root of the scene, which is the
+			// current modelview space.
+			M44f clip;
+			if( frustumCulling )
+			{
+				clip = currentMatrix( GL_MODELVIEW_MATRIX ) * currentMatrix( GL_PROJECTION_MATRIX );
+			}
+
+			if( occlusionCulling )
+			{
+				updateOcclusion();
+			}
+
+			const State *previous = m_states.front().get();
+			vector<M44f> transforms;
+			vector<const Run *> occludedRuns;
+			for( Runs::const_iterator rIt = m_runs.begin(); rIt != m_runs.end(); ++rIt )
+			{
+				const Run &run = *rIt;
+				if( frustumCulling && outsideFrustum( run.bound, clip ) )
+				{
+					continue;
+				}
+
+				if( occlusionCulling && run.occluded )
+				{
+					// Not drawn, but its bound will be tested again
+					// once everything else has been drawn.
+					occludedRuns.push_back( &run );
+					continue;
+				}
+
+				const State *state = m_items[run.begin].state;
+				state->bind( *previous );
+				previous = state;
+
+				if( occlusionCulling )
+				{
+					beginQuery( run );
+				}
+
+				if( run.mesh )
+				{
+					// Sorting has put repeated meshes with the same state next to
+					// each other, so we can draw them all in one go.
+					transforms.clear();
+					for( size_t i = run.begin; i < run.end; ++i )
+					{
+						if( !frustumCulling || !outsideFrustum( m_items[i].bound, clip ) )
+						{
+							transforms.push_back( m_items[i].transform );
+						}
+					}
+					if( transforms.size() )
+					{
+						run.mesh->renderInstanced( m_items[run.begin].state, transforms );
+					}
+				}
+				else
+				{
+					renderItem( m_items[run.begin] );
+				}
+
+				if( occlusionCulling )
+				{
+					glEndQueryARB( GL_SAMPLES_PASSED_ARB );
+				}
+			}
+
+			m_states.front()->bind( *previous );
+
+			if( occludedRuns.size() )
+			{
+				// Test the bounds of the runs which were occluded last time
+				// against the depth buffer we've just drawn, so they can be
+				// drawn next time if they've become visible.
+				glPushAttrib( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT );
+				glColorMask( GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE );
+				glDepthMask( GL_FALSE );
+				glEnable( GL_DEPTH_TEST );
+				glDisable( GL_CULL_FACE );
+
+				for( vector<const Run *>::const_iterator it = occludedRuns.begin(); it != occludedRuns.end(); ++it )
+				{
+					beginQuery( **it );
+					BoxPrimitive::renderSolid( (*it)->bound );
+					glEndQueryARB( GL_SAMPLES_PASSED_ARB );
+				}
+
+				glPopAttrib();
+			}
+		}
+
+	private :
+
+		struct Item
+		{
+			ConstRenderablePtr renderable;
+			// Effective state, owned by m_states.
+			State *state;
+			const StateComponent *shader;
+			bool transparent;
+			M44f transform;
+			// World space bound.
+			Box3f bound;
+		};
+
+		typedef vector<Item> Items;
+
+		// A range of items to be drawn together. Runs with a mesh
+		// consist of repeated instances of that mesh with the same
+		// state, and all other runs contain a single item.
+		struct Run
+		{
+			size_t begin;
+			size_t end;
+			const MeshPrimitive *mesh;
+			Box3f bound;
+			// Occlusion query issued when the run was last drawn, and
+			// whether or not the result showed it to be invisible.
+			mutable GLuint query;
+			mutable bool occluded;
+		};
+
+		typedef vector<Run> Runs;
+
+		// Orders opaque items by shader, then state, then renderable,
+		// so as to minimise state changes and expose instancing. Transparent
+		// items come last and are left in their original order, as it is
+		// significant for blending.
+		struct ItemLess
+		{
+			bool operator()( const Item &a, const Item &b ) const
+			{
+				if( a.transparent != b.transparent )
+				{
+					return b.transparent;
+				}
+				if( a.transparent )
+				{
+					return false;
+				}
+				if( a.shader != b.shader )
+				{
+					return a.shader < b.shader;
+				}
+				if( a.state != b.state )
+				{
+					return a.state < b.state;
+				}
+				return a.renderable < b.renderable;
+			}
+		};
+
+		void gather( const Group *group, const M44f &parentTransform, State *parentState )
+		{
+			const M44f transform = group->getTransform() * parentTransform;
+
+			// Only keep a new state if the group actually changes something,
+			// so that the common case of a primitive in a Group with empty
+			// state shares its parent's state, and can be batched with it.
+			State *state = parentState;
+			StatePtr composed = new State( *parentState );
+			if( composed->compose( *group->getState() ) )
+			{
+				m_states.push_back( composed );
+				state = composed.get();
+			}
+
+			const Group::ChildContainer &children = group->children();
+			for( Group::ChildContainer::const_iterator it = children.begin(); it != children.end(); ++it )
+			{
+				if( const Group *childGroup = IECore::runTimeCast<const Group>( it->get() ) )
+				{
+					gather( childGroup, transform, state );
+				}
+				else
+				{
+					Item item;
+					item.renderable = *it;
+					item.state = state;
+					item.shader = state->get<ShaderStateComponent>();
+					item.transparent = state->get<TransparentShadingStateComponent>()->value();
+					item.transform = transform;
+					item.bound = Imath::transform( (*it)->bound(), transform );
+					m_items.push_back( item );
+				}
+			}
+		}
+
+		void buildRuns()
+		{
+			for( size_t i = 0; i < m_items.size(); )
+			{
+				Run run;
+				run.begin = i;
+				run.end = i + 1;
+				run.mesh = IECore::runTimeCast<const MeshPrimitive>( m_items[i].renderable.get() );
+				run.bound = m_items[i].bound;
+				run.query = 0;
+				run.occluded = false;
+				if( run.mesh )
+				{
+					while( run.end < m_items.size() && m_items[run.end].renderable == m_items[i].renderable && m_items[run.end].state == m_items[i].state )
+					{
+						run.bound.extendBy( m_items[run.end].bound );
+						++run.end;
+					}
+					if( run.end - run.begin == 1 )
+					{
+						run.mesh = 0;
+					}
+				}
+				m_runs.push_back( run );
+				i = run.end;
+			}
+		}
+
+		void renderItem( const Item &item ) const
+		{
+			const bool haveTransform = item.transform != M44f();
+			if( haveTransform )
+			{
+				glPushMatrix();
+				glMultMatrixf( item.transform.getValue() );
+			}
+			item.renderable->render( item.state );
+			if( haveTransform )
+			{
+				glPopMatrix();
+			}
+		}
+
+		void beginQuery( const Run &run ) const
+		{
+			if( !run.query )
+			{
+				glGenQueriesARB( 1, &run.query );
+			}
+			glBeginQueryARB( GL_SAMPLES_PASSED_ARB, run.query );
+		}
+
+		// Collects the results of the queries issued last time. Results which
+		// aren't available yet are ignored rather than waited for, and the
+		// run keeps its previous visibility until they are.
+		void updateOcclusion() const
+		{
+			for( Runs::const_iterator it = m_runs.begin(); it != m_runs.end(); ++it )
+			{
+				if( !it->query )
+				{
+					continue;
+				}
+				GLuint available = 0;
+				glGetQueryObjectuivARB( it->query, GL_QUERY_RESULT_AVAILABLE_ARB, &available );
+				if( available )
+				{
+					GLuint samplesPassed = 0;
+					glGetQueryObjectuivARB( it->query, GL_QUERY_RESULT_ARB, &samplesPassed );
+					it->occluded = samplesPassed == 0;
+				}
+			}
+		}
+
+		const State *m_baseState;
+		vector<StatePtr> m_states;
+		Items m_items;
+		Runs m_runs;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Scene
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Scene );
 
 Scene::Scene()
-	:	m_root( new Group ), m_camera( 0 )
+	:	m_root( new Group ), m_camera( 0 ), m_renderListEnabled( false ), m_frustumCullingEnabled( false ), m_occlusionCullingEnabled( false )
 {
 }
 
@@ -67,7 +438,18 @@ void Scene::render( State *state ) const
 
 		State::bindBaseState();
 		state->bind();
-		root()->render( state );
+		if( m_renderListEnabled )
+		{
+			if( !m_renderList || m_renderList->baseState() != state )
+			{
+				m_renderList = new RenderList( m_root.get(), state );
+			}
+			m_renderList->render( m_frustumCullingEnabled, m_occlusionCullingEnabled );
+		}
+		else
+		{
+			root()->render( state );
+		}
 
 	glPopAttrib();
 	glUseProgram( prevProgram );
@@ -115,6 +497,45 @@ ConstCameraPtr Scene::getCamera() const
 	return m_camera;
 }
 
+void Scene::setRenderListEnabled( bool enabled )
+{
+	m_renderListEnabled = enabled;
+	if( !enabled )
+	{
+		m_renderList = 0;
+	}
+}
+
+bool Scene::getRenderListEnabled() const
+{
+	return m_renderListEnabled;
+}
+
+void Scene::setFrustumCullingEnabled( bool enabled )
+{
+	m_frustumCullingEnabled = enabled;
+}
+
+bool Scene::getFrustumCullingEnabled() const
+{
+	return m_frustumCullingEnabled;
+}
+
+void Scene::setOcclusionCullingEnabled( bool enabled )
+{
+	m_occlusionCullingEnabled = enabled;
+}
+
+bool Scene::getOcclusionCullingEnabled() const
+{
+	return m_occlusionCullingEnabled;
+}
+
+void Scene::dirtyRenderList()
+{
+	m_renderList = 0;
+}
+
 GroupPtr Scene::root()
 {
 	return m_root;
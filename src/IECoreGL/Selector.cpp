@@ -35,6 +35,8 @@
 #include "boost/format.hpp"
 #include "boost/timer.hpp"
 
+#include "OpenEXR/ImathFun.h"
+
 #include "IECore/MessageHandler.h"
 #include "IECore/Exception.h"
 
@@ -48,6 +50,7 @@
 #include "IECoreGL/ShaderStateComponent.h"
 #include "IECoreGL/NameStateComponent.h"
 #include "IECoreGL/FrameBuffer.h"
+#include "IECoreGL/Buffer.h"
 #include "IECoreGL/TypedStateComponent.h"
 #include "IECoreGL/Primitive.h"
 #include "IECoreGL/ShaderLoader.h"
@@ -60,6 +63,17 @@ using namespace IECoreGL;
 // Selector::Implementation
 //////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+
+// The resolution of the IDRender framebuffer is limited to this, so
+// that selecting over large regions doesn't require us to read back
+// large numbers of pixels.
+const int g_maxIDResolution = 128;
+const float g_samplesPerPixel = 4.0f;
+
+} // namespace
+
 class Selector::Implementation : public IECore::RefCounted
 {
 
@@ -94,6 +108,7 @@ class Selector::Implementation : public IECore::RefCounted
 			regionCenter.y = viewport[1] + viewport[3] * (1.0f - regionCenter.y);
 			regionSize.x *= viewport[2];
 			regionSize.y *= viewport[3];
+			m_regionSize = regionSize;
 
 			glMatrixMode( GL_PROJECTION );
 			glLoadIdentity();
@@ -245,6 +260,7 @@ class Selector::Implementation : public IECore::RefCounted
 		
 		Mode m_mode;
 		Imath::M44d m_postProjectionMatrix;
+		Imath::V2f m_regionSize;
 		std::vector<HitRecord> &m_hits;
 		StatePtr m_baseState;
 		GLuint m_currentName;
@@ -297,6 +313,7 @@ class Selector::Implementation : public IECore::RefCounted
 		//////////////////////////////////////////////////////////////////////////
 
 		FrameBufferPtr m_frameBuffer;
+		Imath::V2i m_frameBufferSize;
 		boost::shared_ptr<FrameBuffer::ScopedBinding> m_frameBufferBinding;
 		GLint m_prevProgram;
 		ConstShaderPtr m_currentIDShader;
@@ -306,14 +323,23 @@ class Selector::Implementation : public IECore::RefCounted
 
 		void beginIDRender()
 		{
+			// We render the region with a few samples per pixel, so that thin
+			// objects partially covering a pixel can still be hit, but there's
+			// no need to go further than that, and for large regions we limit
+			// the resolution further still.
+			m_frameBufferSize = Imath::V2i(
+				Imath::clamp( Imath::ceil( m_regionSize.x * g_samplesPerPixel ), 1, g_maxIDResolution ),
+				Imath::clamp( Imath::ceil( m_regionSize.y * g_samplesPerPixel ), 1, g_maxIDResolution )
+			);
+
 			m_frameBuffer = new FrameBuffer();
-			m_frameBuffer->setColor( new UIntTexture( 128, 128 ) );
-			m_frameBuffer->setDepth( new DepthTexture( 128, 128 ) );
+			m_frameBuffer->setColor( new UIntTexture( m_frameBufferSize.x, m_frameBufferSize.y ) );
+			m_frameBuffer->setDepth( new DepthTexture( m_frameBufferSize.x, m_frameBufferSize.y ) );
 			m_frameBuffer->validate();
 			m_frameBufferBinding = boost::shared_ptr<FrameBuffer::ScopedBinding>( new FrameBuffer::ScopedBinding( *m_frameBuffer ) );
 			
 			glGetIntegerv( GL_VIEWPORT, m_prevViewport );
-			glViewport( 0, 0, 128, 128 );
+			glViewport( 0, 0, m_frameBufferSize.x, m_frameBufferSize.y );
 			
 			GLfloat prevClearColor[4];
 			GLfloat prevClearDepth;
@@ -339,31 +365,74 @@ class Selector::Implementation : public IECore::RefCounted
 		{
 			glUseProgram( m_prevProgram );
 			glViewport( m_prevViewport[0], m_prevViewport[1], m_prevViewport[2], m_prevViewport[3] );
-			m_frameBufferBinding.reset();
 
-			IECore::ImagePrimitivePtr idsImage = m_frameBuffer->getColor()->imagePrimitive();
-			const IECore::UIntVectorData *idsData = static_cast<const IECore::UIntVectorData *>( idsImage->variables["Y"].data.get() );
-			const std::vector<unsigned int> ids = idsData->readable();
+			// Read the ids and depths into pixel buffers rather than directly
+			// into client memory. This lets both transfers be queued before we
+			// wait on either, and lets us process the pixels in place when we
+			// map the buffers, rather than converting them via ImagePrimitives.
+			const size_t numPixels = m_frameBufferSize.x * m_frameBufferSize.y;
+			BufferPtr idBuffer = new Buffer( 0, numPixels * sizeof( GLuint ), GL_PIXEL_PACK_BUFFER, GL_STREAM_READ );
+			BufferPtr zBuffer = new Buffer( 0, numPixels * sizeof( GLfloat ), GL_PIXEL_PACK_BUFFER, GL_STREAM_READ );
+
+			GLint prevReadBuffer;
+			glGetIntegerv( GL_READ_BUFFER, &prevReadBuffer );
+			glReadBuffer( GL_COLOR_ATTACHMENT0 );
+			{
+				Buffer::ScopedBinding binding( *idBuffer, GL_PIXEL_PACK_BUFFER );
+				glReadPixels( 0, 0, m_frameBufferSize.x, m_frameBufferSize.y, GL_RED_INTEGER, GL_UNSIGNED_INT, 0 );
+			}
+			{
+				Buffer::ScopedBinding binding( *zBuffer, GL_PIXEL_PACK_BUFFER );
+				glReadPixels( 0, 0, m_frameBufferSize.x, m_frameBufferSize.y, GL_DEPTH_COMPONENT, GL_FLOAT, 0 );
+			}
+			glReadBuffer( prevReadBuffer );
 
-			IECore::ImagePrimitivePtr zImage = m_frameBuffer->getDepth()->imagePrimitive();
-			const IECore::FloatVectorData *zData = static_cast<const IECore::FloatVectorData *>( zImage->variables["Z"].data.get() );
-			const std::vector<float> z = zData->readable();
+			m_frameBufferBinding.reset();
 
-			std::map<unsigned int, HitRecord> idRecords;	
-			for( size_t i = 0, e = ids.size(); i < e; i++ )
+			std::map<unsigned int, HitRecord> idRecords;
 			{
-				if( ids[i] == 0 )
+				Buffer::ScopedBinding idBinding( *idBuffer, GL_PIXEL_PACK_BUFFER );
+				const GLuint *ids = static_cast<const GLuint *>( glMapBuffer( GL_PIXEL_PACK_BUFFER, GL_READ_ONLY ) );
 				{
-					continue;
+					Buffer::ScopedBinding zBinding( *zBuffer, GL_PIXEL_PACK_BUFFER );
+					const GLfloat *z = static_cast<const GLfloat *>( glMapBuffer( GL_PIXEL_PACK_BUFFER, GL_READ_ONLY ) );
+					if( ids && z )
+					{
+						std::map<unsigned int, HitRecord>::iterator it = idRecords.end();
+						for( size_t i = 0; i < numPixels; i++ )
+						{
+							if( ids[i] == 0 )
+							{
+								continue;
+							}
+							// neighbouring pixels usually have the same id, so
+							// we can often avoid searching the map.
+							if( it == idRecords.end() || it->first != ids[i] )
+							{
+								it = idRecords.find( ids[i] );
+								if( it == idRecords.end() )
+								{
+									HitRecord r( Imath::limits<float>::max(), Imath::limits<float>::min(), ids[i] );
+									it = idRecords.insert( std::pair<unsigned int, HitRecord>( ids[i], r ) ).first;
+								}
+							}
+							it->second.depthMin = std::min( it->second.depthMin, z[i] );
+							it->second.depthMax = std::max( it->second.depthMax, z[i] );
+						}
+					}
+					else
+					{
+						IECore::msg( IECore::Msg::Error, "IECoreGL::Selector end", "Unable to map pixel buffers" );
+					}
+					if( z )
+					{
+						glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+					}
 				}
-				std::map<unsigned int, HitRecord>::iterator it = idRecords.find( ids[i] );
-				if( it == idRecords.end() )
+				if( ids )
 				{
-					HitRecord r( Imath::limits<float>::max(), Imath::limits<float>::min(), ids[i] );
-					it = idRecords.insert( std::pair<unsigned int, HitRecord>( ids[i], r ) ).first;
+					glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
 				}
-				it->second.depthMin = std::min( it->second.depthMin, z[i] );
-				it->second.depthMax = std::max( it->second.depthMax, z[i] );		
 			}
 
 			m_hits.clear();
@@ -67,9 +67,10 @@ class Shader::Implementation : public IECore::RefCounted
 
 	public :
 
-		Implementation( const std::string &vertexSource, const std::string &geometrySource, const std::string &fragmentSource )
-			:	m_vertexSource( vertexSource ), m_geometrySource( geometrySource ), m_fragmentSource( fragmentSource ),
-				m_vertexShader( 0 ), m_geometryShader( 0 ), m_fragmentShader( 0 ), m_program( 0 ),
+		Implementation( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource )
+			:	m_vertexSource( vertexSource ), m_tessControlSource( tessControlSource ), m_tessEvaluationSource( tessEvaluationSource ),
+				m_geometrySource( geometrySource ), m_fragmentSource( fragmentSource ),
+				m_vertexShader( 0 ), m_tessControlShader( 0 ), m_tessEvaluationShader( 0 ), m_geometryShader( 0 ), m_fragmentShader( 0 ), m_program( 0 ),
 				m_csParameter( NULL )
 		{		
 			string actualVertexSource = vertexSource;
@@ -84,17 +85,33 @@ class Shader::Implementation : public IECore::RefCounted
 			}
 
 			compile( actualVertexSource, GL_VERTEX_SHADER, m_vertexShader );
+			compile( tessControlSource, GL_TESS_CONTROL_SHADER, m_tessControlShader );
+			compile( tessEvaluationSource, GL_TESS_EVALUATION_SHADER, m_tessEvaluationShader );
 			compile( geometrySource, GL_GEOMETRY_SHADER, m_geometryShader );
 			compile( actualFragmentSource, GL_FRAGMENT_SHADER, m_fragmentShader );
 
 			m_program = glCreateProgram();
 			glAttachShader( m_program, m_vertexShader );
+			if( m_tessControlShader )
+			{
+				glAttachShader( m_program, m_tessControlShader );
+			}
+			if( m_tessEvaluationShader )
+			{
+				glAttachShader( m_program, m_tessEvaluationShader );
+			}
 			if( m_geometryShader )
 			{
 				glAttachShader( m_program, m_geometryShader );
 			}
 			glAttachShader( m_program, m_fragmentShader );
 
+			if( GLEW_ARB_get_program_binary )
+			{
+				// let the driver know we may call programBinary() later
+				glProgramParameteri( m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+			}
+
 			glLinkProgram( m_program );
 			GLint linkStatus = 0;
 			glGetProgramiv( m_program, GL_LINK_STATUS, &linkStatus );
@@ -148,96 +165,31 @@ class Shader::Implementation : public IECore::RefCounted
 					IECore::msg( IECore::Msg::Warning, "IECoreGL::Shader", warning );
 				}
 			}
+			buildParameterMaps();
+		}
+		
+		Implementation( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource, GLenum binaryFormat, const std::vector<char> &binary )
+			:	m_vertexSource( vertexSource ), m_tessControlSource( tessControlSource ), m_tessEvaluationSource( tessEvaluationSource ),
+				m_geometrySource( geometrySource ), m_fragmentSource( fragmentSource ),
+				m_vertexShader( 0 ), m_tessControlShader( 0 ), m_tessEvaluationShader( 0 ), m_geometryShader( 0 ), m_fragmentShader( 0 ), m_program( 0 ),
+				m_csParameter( NULL )
+		{
+			if( !GLEW_ARB_get_program_binary )
 			{
-				// build the uniform parameter description map
-				GLint numUniforms = 0;
-				glGetProgramiv( m_program, GL_ACTIVE_UNIFORMS, &numUniforms );
-				GLint maxUniformNameLength = 0;
-				glGetProgramiv( m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformNameLength );
-				vector<char> nameChars( maxUniformNameLength );
-				GLuint textureUnit = 0;
-				for( int i=0; i<numUniforms; i++ )
-				{
-					Parameter p;
-					glGetActiveUniform( m_program, i, maxUniformNameLength, 0, &p.size, &p.type, &nameChars[0] );
-					p.location = glGetUniformLocation( m_program, &nameChars[0] );
-					
-					std::string name = &nameChars[0];
-
-					// ignore native parameters
-					if( 0 == name.compare( 0, 3, "gl_" ) )
-					{
-						continue;
-					}
-
-					if( p.size > 1 )
-					{
-						// remove the "[0]" from the end of the string
-						size_t bracketPos = name.rfind( "[" );
-						if( bracketPos != std::string::npos )
-						{
-							name = name.substr( 0, bracketPos );
-						}
-					}
-
-					if( p.type == GL_SAMPLER_2D )
-					{
-						// we assign a specific texture unit to each individual
-						// sampler parameter - this makes it much easier to save
-						// and restore state when applying nested Setups.
-						p.textureUnit = textureUnit++;
-					}
-					else
-					{
-						p.textureUnit = 0;
-					}
-
-					m_uniformParameters[name] = p;
-					
-					if( name == "Cs" )
-					{
-						m_csParameter = &(m_uniformParameters[name]);
-					}
-				}
+				throw Exception( "Program binaries are not supported." );
 			}
 
+			m_program = glCreateProgram();
+			glProgramBinary( m_program, binaryFormat, binary.empty() ? 0 : &binary[0], binary.size() );
+			GLint linkStatus = 0;
+			glGetProgramiv( m_program, GL_LINK_STATUS, &linkStatus );
+			if( !linkStatus )
 			{
-				// build the vertex parameter description map
-				GLint numVertexs = 0;
-				glGetProgramiv( m_program, GL_ACTIVE_ATTRIBUTES, &numVertexs );
-				GLint maxVertexNameLength = 0;
-				glGetProgramiv( m_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxVertexNameLength );
-
-				// some versions of the nvidia drivers are returning maxVertexNameLength==0 when
-				// no attributes other than built in gl_* ones are defined by the shader. we don't
-				// bother retrieving anything in this case, as we skip built in parameters anyway.
-				if( numVertexs && maxVertexNameLength )
-				{
-					vector<char> nameChars( maxVertexNameLength );
-					for( int i=0; i<numVertexs; i++ )
-					{
-						Parameter p;
-						glGetActiveAttrib( m_program, i, maxVertexNameLength, 0, &p.size, &p.type, &nameChars[0] );
-						p.location = glGetAttribLocation( m_program, &nameChars[0] );
-						
-						std::string name = &nameChars[0];
-
-						// ignore native parameters
-						if( 0 == name.compare( 0, 3, "gl_" ) )
-						{
-							continue;
-						}
-
-						/// \todo implement arrays
-						if( p.size != 1 )
-						{
-							continue;
-						}
-						
-						m_vertexAttributes[name] = p;
-					}
-				}
+				release();
+				throw Exception( "Program binary was rejected by the driver." );
 			}
+
+			buildParameterMaps();
 		}
 		
 		virtual ~Implementation()
@@ -249,12 +201,41 @@ class Shader::Implementation : public IECore::RefCounted
 		{
 			return m_program;
 		}
+
+		bool programBinary( GLenum &binaryFormat, std::vector<char> &binary ) const
+		{
+			if( !GLEW_ARB_get_program_binary )
+			{
+				return false;
+			}
+
+			GLint length = 0;
+			glGetProgramiv( m_program, GL_PROGRAM_BINARY_LENGTH, &length );
+			if( !length )
+			{
+				return false;
+			}
+
+			binary.resize( length );
+			glGetProgramBinary( m_program, length, 0, &binaryFormat, &binary[0] );
+			return true;
+		}
 		
 		const std::string &vertexSource() const
 		{
 			return m_vertexSource;
 		}
 		
+		const std::string &tessControlSource() const
+		{
+			return m_tessControlSource;
+		}
+
+		const std::string &tessEvaluationSource() const
+		{
+			return m_tessEvaluationSource;
+		}
+
 		const std::string &geometrySource() const
 		{
 			return m_geometrySource;
@@ -311,10 +292,14 @@ class Shader::Implementation : public IECore::RefCounted
 		friend class Shader::Setup;
 		
 		std::string m_vertexSource;
+		std::string m_tessControlSource;
+		std::string m_tessEvaluationSource;
 		std::string m_geometrySource;
 		std::string m_fragmentSource;
 
 		GLuint m_vertexShader;
+		GLuint m_tessControlShader;
+		GLuint m_tessEvaluationShader;
 		GLuint m_geometryShader;
 		GLuint m_fragmentShader;
 		GLuint m_program;
@@ -365,9 +350,105 @@ class Shader::Implementation : public IECore::RefCounted
 			}
 		}
 
+		void buildParameterMaps()
+		{
+			{
+				// build the uniform parameter description map
+				GLint numUniforms = 0;
+				glGetProgramiv( m_program, GL_ACTIVE_UNIFORMS, &numUniforms );
+				GLint maxUniformNameLength = 0;
+				glGetProgramiv( m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformNameLength );
+				vector<char> nameChars( maxUniformNameLength );
+				GLuint textureUnit = 0;
+				for( int i=0; i<numUniforms; i++ )
+				{
+					Parameter p;
+					glGetActiveUniform( m_program, i, maxUniformNameLength, 0, &p.size, &p.type, &nameChars[0] );
+					p.location = glGetUniformLocation( m_program, &nameChars[0] );
+					
+					std::string name = &nameChars[0];
+
+					// ignore native parameters
+					if( 0 == name.compare( 0, 3, "gl_" ) )
+					{
+						continue;
+					}
+
+					if( p.size > 1 )
+					{
+						// remove the "[0]" from the end of the string
+						size_t bracketPos = name.rfind( "[" );
+						if( bracketPos != std::string::npos )
+						{
+							name = name.substr( 0, bracketPos );
+						}
+					}
+
+					if( p.type == GL_SAMPLER_2D )
+					{
+						// we assign a specific texture unit to each individual
+						// sampler parameter - this makes it much easier to save
+						// and restore state when applying nested Setups.
+						p.textureUnit = textureUnit++;
+					}
+					else
+					{
+						p.textureUnit = 0;
+					}
+
+					m_uniformParameters[name] = p;
+					
+					if( name == "Cs" )
+					{
+						m_csParameter = &(m_uniformParameters[name]);
+					}
+				}
+			}
+
+			{
+				// build the vertex parameter description map
+				GLint numVertexs = 0;
+				glGetProgramiv( m_program, GL_ACTIVE_ATTRIBUTES, &numVertexs );
+				GLint maxVertexNameLength = 0;
+				glGetProgramiv( m_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxVertexNameLength );
+
+				// some versions of the nvidia drivers are returning maxVertexNameLength==0 when
+				// no attributes other than built in gl_* ones are defined by the shader. we don't
+				// bother retrieving anything in this case, as we skip built in parameters anyway.
+				if( numVertexs && maxVertexNameLength )
+				{
+					vector<char> nameChars( maxVertexNameLength );
+					for( int i=0; i<numVertexs; i++ )
+					{
+						Parameter p;
+						glGetActiveAttrib( m_program, i, maxVertexNameLength, 0, &p.size, &p.type, &nameChars[0] );
+						p.location = glGetAttribLocation( m_program, &nameChars[0] );
+						
+						std::string name = &nameChars[0];
+
+						// ignore native parameters
+						if( 0 == name.compare( 0, 3, "gl_" ) )
+						{
+							continue;
+						}
+
+						/// \todo implement arrays
+						if( p.size != 1 )
+						{
+							continue;
+						}
+						
+						m_vertexAttributes[name] = p;
+					}
+				}
+			}
+		}
+
 		void release()
 		{
 			glDeleteShader( m_vertexShader );
+			glDeleteShader( m_tessControlShader );
+			glDeleteShader( m_tessEvaluationShader );
 			glDeleteShader( m_geometryShader );
 			glDeleteShader( m_fragmentShader );
 			glDeleteProgram( m_program );
@@ -382,12 +463,27 @@ class Shader::Implementation : public IECore::RefCounted
 IE_CORE_DEFINERUNTIMETYPED( Shader );
 
 Shader::Shader( const std::string &vertexSource, const std::string &fragmentSource )
-	:	m_implementation( new Implementation( vertexSource, "", fragmentSource ) )
+	:	m_implementation( new Implementation( vertexSource, "", "", "", fragmentSource ) )
 {
 }
 
 Shader::Shader( const std::string &vertexSource, const std::string &geometrySource, const std::string &fragmentSource )
-	:	m_implementation( new Implementation( vertexSource, geometrySource, fragmentSource ) )
+	:	m_implementation( new Implementation( vertexSource, "", "", geometrySource, fragmentSource ) )
+{
+}
+
+Shader::Shader( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource )
+	:	m_implementation( new Implementation( vertexSource, tessControlSource, tessEvaluationSource, geometrySource, fragmentSource ) )
+{
+}
+
+Shader::Shader( const std::string &vertexSource, const std::string &geometrySource, const std::string &fragmentSource, GLenum binaryFormat, const std::vector<char> &binary )
+	:	m_implementation( new Implementation( vertexSource, "", "", geometrySource, fragmentSource, binaryFormat, binary ) )
+{
+}
+
+Shader::Shader( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource, GLenum binaryFormat, const std::vector<char> &binary )
+	:	m_implementation( new Implementation( vertexSource, tessControlSource, tessEvaluationSource, geometrySource, fragmentSource, binaryFormat, binary ) )
 {
 }
 
@@ -400,11 +496,26 @@ GLuint Shader::program() const
 	return m_implementation->program();
 }
 
+bool Shader::programBinary( GLenum &binaryFormat, std::vector<char> &binary ) const
+{
+	return m_implementation->programBinary( binaryFormat, binary );
+}
+
 const std::string &Shader::vertexSource() const
 {
 	return m_implementation->vertexSource();
 }
 
+const std::string &Shader::tessControlSource() const
+{
+	return m_implementation->tessControlSource();
+}
+
+const std::string &Shader::tessEvaluationSource() const
+{
+	return m_implementation->tessEvaluationSource();
+}
+
 const std::string &Shader::geometrySource() const
 {
 	return m_implementation->geometrySource();
@@ -39,8 +39,10 @@
 #include "boost/wave/cpplexer/cpp_lex_token.hpp"
 #include "boost/wave/cpplexer/cpp_lex_iterator.hpp"
 #include "boost/format.hpp"
+#include "boost/filesystem/operations.hpp"
 
 #include "IECore/MessageHandler.h"
+#include "IECore/MurmurHash.h"
 
 #include "IECoreGL/ShaderLoader.h"
 #include "IECoreGL/Shader.h"
@@ -151,9 +153,13 @@ class ShaderLoader::Implementation : public IECore::RefCounted
 			fragmentSource = it->second.fragment;
 		}
 
-		ShaderPtr create( const std::string &vertexShader, const std::string &geometryShader, const std::string &fragmentShader )
+		ShaderPtr create( const std::string &vertexShader, const std::string &tessControlShader, const std::string &tessEvaluationShader, const std::string &geometryShader, const std::string &fragmentShader )
 		{
 			std::string uniqueName = vertexShader + "\n## Geometry ##\n" + geometryShader + "## Fragment ##\n" + fragmentShader;
+			if( tessControlShader.size() || tessEvaluationShader.size() )
+			{
+				uniqueName += "## TessControl ##\n" + tessControlShader + "## TessEvaluation ##\n" + tessEvaluationShader;
+			}
 
 			ShaderMap::iterator it = m_loadedShaders.find( uniqueName );
 			if( it!=m_loadedShaders.end() )
@@ -163,11 +169,28 @@ class ShaderLoader::Implementation : public IECore::RefCounted
 
 			clearUnused();
 
-			ShaderPtr s = new Shader(
-				preprocessShader( "<Vertex Shader>", vertexShader ),
-				preprocessShader( "<Geometry Shader>", geometryShader ),
-				preprocessShader( "<Fragment Shader>", fragmentShader )
-			);
+			const std::string vertexSource = preprocessShader( "<Vertex Shader>", vertexShader );
+			const std::string tessControlSource = preprocessShader( "<Tessellation Control Shader>", tessControlShader );
+			const std::string tessEvaluationSource = preprocessShader( "<Tessellation Evaluation Shader>", tessEvaluationShader );
+			const std::string geometrySource = preprocessShader( "<Geometry Shader>", geometryShader );
+			const std::string fragmentSource = preprocessShader( "<Fragment Shader>", fragmentShader );
+
+			ShaderPtr s = 0;
+			if( m_cacheDirectory.size() )
+			{
+				const path binaryPath = cachePath( vertexSource, tessControlSource, tessEvaluationSource, geometrySource, fragmentSource );
+				s = readCachedShader( binaryPath, vertexSource, tessControlSource, tessEvaluationSource, geometrySource, fragmentSource );
+				if( !s )
+				{
+					s = new Shader( vertexSource, tessControlSource, tessEvaluationSource, geometrySource, fragmentSource );
+					writeCachedShader( binaryPath, s.get() );
+				}
+			}
+			else
+			{
+				s = new Shader( vertexSource, tessControlSource, tessEvaluationSource, geometrySource, fragmentSource );
+			}
+
 			m_loadedShaders[uniqueName] = s;
 
 			return s;
@@ -177,7 +200,7 @@ class ShaderLoader::Implementation : public IECore::RefCounted
 		{
 			std::string vertexSource, geometrySource, fragmentSource;
 			loadSource( name, vertexSource, geometrySource, fragmentSource );
-			return create( vertexSource, geometrySource, fragmentSource );
+			return create( vertexSource, "", "", geometrySource, fragmentSource );
 		}
 
 		void clearUnused()
@@ -202,6 +225,16 @@ class ShaderLoader::Implementation : public IECore::RefCounted
 			m_loadedShaders.clear();
 		}
 
+		void setCacheDirectory( const std::string &cacheDirectory )
+		{
+			m_cacheDirectory = cacheDirectory;
+		}
+
+		const std::string &getCacheDirectory() const
+		{
+			return m_cacheDirectory;
+		}
+
 	private :
 	
 		struct Source
@@ -219,6 +252,7 @@ class ShaderLoader::Implementation : public IECore::RefCounted
 		IECore::SearchPath m_searchPaths;
 		bool m_preprocess;
 		IECore::SearchPath m_preprocessorSearchPaths;
+		std::string m_cacheDirectory;
 
 		std::string readFile( const std::string &fileName ) const
 		{
@@ -240,6 +274,84 @@ class ShaderLoader::Implementation : public IECore::RefCounted
 			return result;
 		}
 
+		// Program binaries are only valid for the driver that produced
+		// them, so we include it in the hash along with the source.
+		path cachePath( const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource ) const
+		{
+			IECore::MurmurHash h;
+			h.append( IECORE_MURMURHASH_VERSION );
+			h.append( vertexSource );
+			h.append( tessControlSource );
+			h.append( tessEvaluationSource );
+			h.append( geometrySource );
+			h.append( fragmentSource );
+			h.append( (const char *)glGetString( GL_VENDOR ) );
+			h.append( (const char *)glGetString( GL_RENDERER ) );
+			h.append( (const char *)glGetString( GL_VERSION ) );
+			return path( m_cacheDirectory ) / ( h.toString() + ".glbin" );
+		}
+
+		ShaderPtr readCachedShader( const path &binaryPath, const std::string &vertexSource, const std::string &tessControlSource, const std::string &tessEvaluationSource, const std::string &geometrySource, const std::string &fragmentSource ) const
+		{
+			ifstream f( binaryPath.string().c_str(), ios::binary );
+			if( !f.is_open() )
+			{
+				return 0;
+			}
+
+			GLenum binaryFormat = 0;
+			f.read( (char *)&binaryFormat, sizeof( binaryFormat ) );
+			vector<char> binary( ( istreambuf_iterator<char>( f ) ), istreambuf_iterator<char>() );
+			if( binary.empty() )
+			{
+				return 0;
+			}
+
+			try
+			{
+				return new Shader( vertexSource, tessControlSource, tessEvaluationSource, geometrySource, fragmentSource, binaryFormat, binary );
+			}
+			catch( const std::exception &e )
+			{
+				// most likely the driver has changed in a way its version string
+				// doesn't reflect - we'll just compile again and replace the file.
+				IECore::msg( IECore::Msg::Debug, "IECoreGL::ShaderLoader", boost::format( "Ignoring cached program \"%s\" ( %s )." ) % binaryPath.string() % e.what() );
+				return 0;
+			}
+		}
+
+		void writeCachedShader( const path &binaryPath, const Shader *shader ) const
+		{
+			GLenum binaryFormat = 0;
+			vector<char> binary;
+			if( !shader->programBinary( binaryFormat, binary ) )
+			{
+				return;
+			}
+
+			try
+			{
+				create_directories( binaryPath.parent_path() );
+				// write to a temporary file and rename, so that concurrent sessions
+				// never see a partially written binary.
+				const path tmpPath = unique_path( binaryPath.string() + ".%%%%-%%%%-%%%%" );
+				{
+					ofstream f( tmpPath.string().c_str(), ios::binary );
+					f.write( (const char *)&binaryFormat, sizeof( binaryFormat ) );
+					f.write( &binary[0], binary.size() );
+					if( !f.good() )
+					{
+						throw IECore::IOException( "Write failed" );
+					}
+				}
+				boost::filesystem::rename( tmpPath, binaryPath );
+			}
+			catch( const std::exception &e )
+			{
+				IECore::msg( IECore::Msg::Warning, "IECoreGL::ShaderLoader", boost::format( "Unable to cache program \"%s\" ( %s )." ) % binaryPath.string() % e.what() );
+			}
+		}
+
 		std::string preprocessShader( const std::string &fileName, const std::string &source ) const
 		{
 			if ( source == "" )
@@ -315,7 +427,12 @@ void ShaderLoader::loadSource( const std::string &name, std::string &vertexShade
 
 ShaderPtr ShaderLoader::create( const std::string &vertexShader, const std::string &geometryShader, const std::string &fragmentShader )
 {
-	return m_implementation->create( vertexShader, geometryShader, fragmentShader );
+	return m_implementation->create( vertexShader, "", "", geometryShader, fragmentShader );
+}
+
+ShaderPtr ShaderLoader::create( const std::string &vertexShader, const std::string &tessControlShader, const std::string &tessEvaluationShader, const std::string &geometryShader, const std::string &fragmentShader )
+{
+	return m_implementation->create( vertexShader, tessControlShader, tessEvaluationShader, geometryShader, fragmentShader );
 }
 
 void ShaderLoader::clearUnused( )
@@ -333,6 +450,16 @@ ShaderPtr ShaderLoader::load( const std::string &name )
 	return m_implementation->load( name );
 }
 
+void ShaderLoader::setCacheDirectory( const std::string &cacheDirectory )
+{
+	m_implementation->setCacheDirectory( cacheDirectory );
+}
+
+const std::string &ShaderLoader::getCacheDirectory() const
+{
+	return m_implementation->getCacheDirectory();
+}
+
 ShaderLoader *ShaderLoader::defaultShaderLoader()
 {
 	static ShaderLoaderPtr t = 0;
@@ -342,6 +469,8 @@ ShaderLoader *ShaderLoader::defaultShaderLoader()
 		const char *p = getenv( "IECOREGL_SHADER_INCLUDE_PATHS" );
 		IECore::SearchPath pp( p ? p : "", ":" );
 		t = new ShaderLoader( IECore::SearchPath( e ? e : "", ":" ), p ? &pp : 0 );
+		const char *c = getenv( "IECOREGL_SHADER_CACHE_PATH" );
+		t->setCacheDirectory( c ? c : "" );
 	}
 	return t.get();
 }
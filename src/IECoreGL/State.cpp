@@ -136,6 +136,63 @@ class State::Implementation : public IECore::RefCounted
 			return m_components.size()==creators()->size();
 		}
 
+		bool equivalent( const Implementation *other ) const
+		{
+			if( m_components.size() != other->m_components.size() )
+			{
+				return false;
+			}
+
+			for( ComponentMap::const_iterator it = m_components.begin(), oIt = other->m_components.begin(); it != m_components.end(); ++it, ++oIt )
+			{
+				if( it->first != oIt->first || it->second.component != oIt->second.component || it->second.override != oIt->second.override )
+				{
+					return false;
+				}
+			}
+
+			const bool haveUserAttributes = m_userAttributes && !m_userAttributes->readable().empty();
+			const bool otherHasUserAttributes = other->m_userAttributes && !other->m_userAttributes->readable().empty();
+			if( haveUserAttributes != otherHasUserAttributes )
+			{
+				return false;
+			}
+
+			return !haveUserAttributes || *m_userAttributes == *(other->m_userAttributes);
+		}
+
+		bool compose( const Implementation *s )
+		{
+			bool changed = false;
+			for( ComponentMap::const_iterator it=s->m_components.begin(); it!=s->m_components.end(); it++ )
+			{
+				ComponentMap::iterator cIt = m_components.find( it->first );
+				if( cIt == m_components.end() )
+				{
+					m_components.insert( *it );
+					changed = true;
+				}
+				else if( !cIt->second.override && ( cIt->second.component != it->second.component || it->second.override ) )
+				{
+					cIt->second = it->second;
+					changed = true;
+				}
+			}
+			return changed;
+		}
+
+		void bind( const Implementation *previous ) const
+		{
+			for( ComponentMap::const_iterator it=m_components.begin(); it!=m_components.end(); it++ )
+			{
+				ComponentMap::const_iterator pIt = previous->m_components.find( it->first );
+				if( pIt == previous->m_components.end() || pIt->second.component != it->second.component )
+				{
+					it->second.component->bind();
+				}
+			}
+		}
+
 		IECore::CompoundData *userAttributes()
 		{
 			if( !m_userAttributes )
@@ -290,6 +347,21 @@ bool State::isComplete() const
 	return m_implementation->isComplete();
 }
 
+bool State::equivalent( const State &other ) const
+{
+	return m_implementation->equivalent( other.m_implementation.get() );
+}
+
+bool State::compose( const State &s )
+{
+	return m_implementation->compose( s.m_implementation.get() );
+}
+
+void State::bind( const State &previous ) const
+{
+	m_implementation->bind( previous.m_implementation.get() );
+}
+
 const State *State::defaultState()
 {
 	static StatePtr s = new State( true );
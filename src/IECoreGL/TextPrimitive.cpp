@@ -144,7 +144,11 @@ void TextPrimitive::renderSprites( State *state ) const
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
 
-		m_font->renderSprites( m_text );
+		if( m_spritePositions.empty() )
+		{
+			m_font->spriteQuads( m_text, m_spritePositions, m_spriteTexCoords );
+		}
+		Font::renderSpriteQuads( m_spritePositions, m_spriteTexCoords );
 
 		glUseProgram( oldProgram );
 
@@ -32,70 +32,357 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <limits>
+
+#include "boost/bind.hpp"
+#include "boost/bind/placeholders.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/filesystem/operations.hpp"
+
 #include "IECoreGL/TextureLoader.h"
 #include "IECoreGL/ToGLTextureConverter.h"
 #include "IECoreGL/Texture.h"
 
 #include "IECore/MessageHandler.h"
 #include "IECore/Reader.h"
+#include "IECore/ObjectReader.h"
+#include "IECore/ObjectWriter.h"
+#include "IECore/LRUCache.h"
+#include "IECore/MurmurHash.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/TypeTraits.h"
 
 using namespace IECoreGL;
+using namespace boost::filesystem;
 
-TextureLoader::TextureLoader( const IECore::SearchPath &searchPaths )
-	:	m_searchPaths( searchPaths )
+//////////////////////////////////////////////////////////////////////////
+// Downsampling utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
 {
-}
 
-TexturePtr TextureLoader::load( const std::string &name )
+// Box filters a channel down to half size in each dimension.
+struct ChannelHalver
 {
-	TexturesMap::const_iterator it = m_loadedTextures.find( name );
-	if( it!=m_loadedTextures.end() )
-	{
-		return it->second;
-	}
+	typedef IECore::DataPtr ReturnType;
 
-	boost::filesystem::path path = m_searchPaths.find( name );
-	if( path.empty() )
+	template<typename T>
+	ReturnType operator()( typename T::ConstPtr data )
 	{
-		IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "Couldn't find \"%s\"." ) % name );
-		m_loadedTextures[name] = 0; // to save us trying over and over again
-		return 0;
-	}
+		typedef typename T::ValueType::value_type ElementType;
 
-	IECore::ReaderPtr r = IECore::Reader::create( path.string() );
-	if( !r )
-	{
-		IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "Couldn't create a Reader for \"%s\"." ) % path.string() );
-		m_loadedTextures[name] = 0; // to save us trying over and over again
-		return 0;
+		const std::vector<ElementType> &in = data->readable();
+		if( in.size() != (size_t)( width * height ) )
+		{
+			throw IECore::Exception( "Channel data has wrong size." );
+		}
+
+		typename T::Ptr result = new T;
+		std::vector<ElementType> &out = result->writable();
+		out.resize( newWidth * newHeight );
+
+		for( int y = 0; y < newHeight; ++y )
+		{
+			const int y0 = std::min( y * 2, height - 1 );
+			const int y1 = std::min( y * 2 + 1, height - 1 );
+			for( int x = 0; x < newWidth; ++x )
+			{
+				const int x0 = std::min( x * 2, width - 1 );
+				const int x1 = std::min( x * 2 + 1, width - 1 );
+				const float sum =
+					(float)in[y0*width+x0] + (float)in[y0*width+x1] +
+					(float)in[y1*width+x0] + (float)in[y1*width+x1];
+				out[y*newWidth+x] = ElementType( sum * 0.25f );
+			}
+		}
+
+		return result;
 	}
 
-	IECore::ObjectPtr o = r->read();
-	IECore::ImagePrimitivePtr i = IECore::runTimeCast<IECore::ImagePrimitive>( o );
-	if( !i )
+	int width;
+	int height;
+	int newWidth;
+	int newHeight;
+};
+
+// Returns a copy of image halved in size as many times as necessary to
+// fit within maximumResolution, or image itself if it already fits.
+IECore::ImagePrimitivePtr downsample( IECore::ImagePrimitivePtr image, int maximumResolution )
+{
+	const Imath::V2i size = image->getDataWindow().size() + Imath::V2i( 1 );
+	ChannelHalver halver;
+	halver.width = size.x;
+	halver.height = size.y;
+	if( halver.width <= maximumResolution && halver.height <= maximumResolution )
 	{
-		IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "\"%s\" is not an image." ) % path.string() );
-		m_loadedTextures[name] = 0; // to save us trying over and over again
-		return 0;
+		return image;
 	}
 
-	TexturePtr t = 0;
-	try
+	IECore::PrimitiveVariableMap channels;
+	for( IECore::PrimitiveVariableMap::const_iterator it = image->variables.begin(), eIt = image->variables.end(); it != eIt; ++it )
 	{
-		ToGLTextureConverterPtr converter = new ToGLTextureConverter( i );
-		t = IECore::runTimeCast<Texture>( converter->convert() );
+		if( image->channelValid( it->first ) )
+		{
+			channels[it->first] = it->second;
+		}
 	}
-	catch( const std::exception &e )
+
+	while( halver.width > maximumResolution || halver.height > maximumResolution )
 	{
-		IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "Texture conversion failed for \"%s\" ( %s )." ) % path.string() % e.what() );
+		halver.newWidth = std::max( 1, ( halver.width + 1 ) / 2 );
+		halver.newHeight = std::max( 1, ( halver.height + 1 ) / 2 );
+		for( IECore::PrimitiveVariableMap::iterator it = channels.begin(), eIt = channels.end(); it != eIt; ++it )
+		{
+			it->second.data = IECore::despatchTypedData<ChannelHalver, IECore::TypeTraits::IsNumericVectorTypedData>( it->second.data.get(), halver );
+		}
+		halver.width = halver.newWidth;
+		halver.height = halver.newHeight;
 	}
-	m_loadedTextures[name] = t;
-	return t;
+
+	const Imath::Box2i window( Imath::V2i( 0 ), Imath::V2i( halver.width - 1, halver.height - 1 ) );
+	IECore::ImagePrimitivePtr result = new IECore::ImagePrimitive( window, window );
+	result->variables = channels;
+	return result;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// TextureLoader::Implementation
+//////////////////////////////////////////////////////////////////////////
+
+class TextureLoader::Implementation : public IECore::RefCounted
+{
+
+	public :
+
+		Implementation( const IECore::SearchPath &searchPaths )
+			:	m_searchPaths( searchPaths ), m_maximumResolution( 0 ),
+				m_cache( boost::bind( &Implementation::getter, this, ::_1, ::_2 ), std::numeric_limits<size_t>::max() )
+		{
+		}
+
+		TexturePtr load( const std::string &name )
+		{
+			return m_cache.get( name );
+		}
+
+		void clear()
+		{
+			m_cache.clear();
+		}
+
+		size_t getMaxMemory() const
+		{
+			return m_cache.getMaxCost();
+		}
+
+		void setMaxMemory( size_t maxMemory )
+		{
+			m_cache.setMaxCost( maxMemory );
+		}
+
+		void setMaximumResolution( int maximumResolution )
+		{
+			if( maximumResolution != m_maximumResolution )
+			{
+				m_maximumResolution = maximumResolution;
+				clear();
+			}
+		}
+
+		int getMaximumResolution() const
+		{
+			return m_maximumResolution;
+		}
+
+		void setCacheDirectory( const std::string &cacheDirectory )
+		{
+			m_cacheDirectory = cacheDirectory;
+		}
+
+		const std::string &getCacheDirectory() const
+		{
+			return m_cacheDirectory;
+		}
+
+	private :
+
+		// Failures are cached with zero cost, to save us trying over and over again.
+		TexturePtr getter( const std::string &name, size_t &cost )
+		{
+			cost = 0;
+
+			boost::filesystem::path path = m_searchPaths.find( name );
+			if( path.empty() )
+			{
+				IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "Couldn't find \"%s\"." ) % name );
+				return 0;
+			}
+
+			IECore::ImagePrimitivePtr i = readImage( path );
+			if( !i )
+			{
+				return 0;
+			}
+
+			TexturePtr t = 0;
+			try
+			{
+				ToGLTextureConverterPtr converter = new ToGLTextureConverter( i );
+				t = IECore::runTimeCast<Texture>( converter->convert() );
+			}
+			catch( const std::exception &e )
+			{
+				IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "Texture conversion failed for \"%s\" ( %s )." ) % path.string() % e.what() );
+				return 0;
+			}
+
+			cost = i->memoryUsage();
+			return t;
+		}
+
+		IECore::ImagePrimitivePtr readImage( const boost::filesystem::path &path ) const
+		{
+			boost::filesystem::path cachedPath;
+			if( m_maximumResolution > 0 && m_cacheDirectory.size() )
+			{
+				cachedPath = cachePath( path );
+				if( exists( cachedPath ) )
+				{
+					try
+					{
+						IECore::ObjectReaderPtr r = new IECore::ObjectReader( cachedPath.string() );
+						IECore::ImagePrimitivePtr i = IECore::runTimeCast<IECore::ImagePrimitive>( r->read() );
+						if( i )
+						{
+							return i;
+						}
+					}
+					catch( const std::exception &e )
+					{
+						IECore::msg( IECore::Msg::Debug, "IECoreGL::TextureLoader::load", boost::format( "Ignoring cached image \"%s\" ( %s )." ) % cachedPath.string() % e.what() );
+					}
+				}
+			}
+
+			IECore::ReaderPtr r = IECore::Reader::create( path.string() );
+			if( !r )
+			{
+				IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "Couldn't create a Reader for \"%s\"." ) % path.string() );
+				return 0;
+			}
+
+			IECore::ObjectPtr o = r->read();
+			IECore::ImagePrimitivePtr i = IECore::runTimeCast<IECore::ImagePrimitive>( o );
+			if( !i )
+			{
+				IECore::msg( IECore::Msg::Error, "IECoreGL::TextureLoader::load", boost::format( "\"%s\" is not an image." ) % path.string() );
+				return 0;
+			}
+
+			if( m_maximumResolution > 0 )
+			{
+				IECore::ImagePrimitivePtr downsampled = downsample( i, m_maximumResolution );
+				if( downsampled != i && !cachedPath.empty() )
+				{
+					writeCachedImage( cachedPath, downsampled.get() );
+				}
+				i = downsampled;
+			}
+
+			return i;
+		}
+
+		boost::filesystem::path cachePath( const boost::filesystem::path &path ) const
+		{
+			IECore::MurmurHash h;
+			h.append( IECORE_MURMURHASH_VERSION );
+			h.append( absolute( path ).string() );
+			h.append( (int64_t)last_write_time( path ) );
+			h.append( m_maximumResolution );
+			return boost::filesystem::path( m_cacheDirectory ) / ( h.toString() + ".cob" );
+		}
+
+		void writeCachedImage( const boost::filesystem::path &cachedPath, IECore::ImagePrimitive *image ) const
+		{
+			try
+			{
+				create_directories( cachedPath.parent_path() );
+				// write to a temporary file and rename, so that concurrent sessions
+				// never see a partially written image.
+				const boost::filesystem::path tmpPath = unique_path( cachedPath.parent_path() / "%%%%-%%%%-%%%%.tmp.cob" );
+				IECore::ObjectWriterPtr w = new IECore::ObjectWriter( image, tmpPath.string() );
+				w->write();
+				boost::filesystem::rename( tmpPath, cachedPath );
+			}
+			catch( const std::exception &e )
+			{
+				IECore::msg( IECore::Msg::Warning, "IECoreGL::TextureLoader::load", boost::format( "Unable to cache image \"%s\" ( %s )." ) % cachedPath.string() % e.what() );
+			}
+		}
+
+		IECore::SearchPath m_searchPaths;
+		int m_maximumResolution;
+		std::string m_cacheDirectory;
+
+		typedef IECore::LRUCache<std::string, TexturePtr> Cache;
+		Cache m_cache;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// TextureLoader
+//////////////////////////////////////////////////////////////////////////
+
+TextureLoader::TextureLoader( const IECore::SearchPath &searchPaths )
+	:	m_implementation( new Implementation( searchPaths ) )
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+}
+
+TexturePtr TextureLoader::load( const std::string &name )
+{
+	return m_implementation->load( name );
 }
 
 void TextureLoader::clear()
 {
-	m_loadedTextures.clear();
+	m_implementation->clear();
+}
+
+size_t TextureLoader::getMaxMemory() const
+{
+	return m_implementation->getMaxMemory();
+}
+
+void TextureLoader::setMaxMemory( size_t maxMemory )
+{
+	m_implementation->setMaxMemory( maxMemory );
+}
+
+void TextureLoader::setMaximumResolution( int maximumResolution )
+{
+	m_implementation->setMaximumResolution( maximumResolution );
+}
+
+int TextureLoader::getMaximumResolution() const
+{
+	return m_implementation->getMaximumResolution();
+}
+
+void TextureLoader::setCacheDirectory( const std::string &cacheDirectory )
+{
+	m_implementation->setCacheDirectory( cacheDirectory );
+}
+
+const std::string &TextureLoader::getCacheDirectory() const
+{
+	return m_implementation->getCacheDirectory();
 }
 
 TextureLoader *TextureLoader::defaultTextureLoader()
@@ -105,6 +392,16 @@ TextureLoader *TextureLoader::defaultTextureLoader()
 	{
 		const char *e = getenv( "IECOREGL_TEXTURE_PATHS" );
 		t = new TextureLoader( IECore::SearchPath( e ? e : "", ":" ) );
+		if( const char *m = getenv( "IECOREGL_TEXTURELOADER_MEMORY" ) )
+		{
+			t->setMaxMemory( (size_t)1024 * 1024 * boost::lexical_cast<int>( m ) );
+		}
+		if( const char *r = getenv( "IECOREGL_TEXTURELOADER_MAXIMUM_RESOLUTION" ) )
+		{
+			t->setMaximumResolution( boost::lexical_cast<int>( r ) );
+		}
+		const char *c = getenv( "IECOREGL_TEXTURE_CACHE_PATH" );
+		t->setCacheDirectory( c ? c : "" );
 	}
 	return t.get();
 }
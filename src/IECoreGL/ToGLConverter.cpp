@@ -36,6 +36,7 @@
 
 #include "IECore/ObjectParameter.h"
 #include "IECore/CompoundParameter.h"
+#include "IECore/Profiling.h"
 
 using namespace IECoreGL;
 using namespace IECore;
@@ -53,6 +54,7 @@ ToGLConverter::~ToGLConverter()
 
 IECore::RunTimeTypedPtr ToGLConverter::convert()
 {
+	IECORE_PROFILE_ZONE( "ToGLConverter::convert" );
 	ConstCompoundObjectPtr operands = parameters()->getTypedValidatedValue<CompoundObject>();
 	return doConversion( srcParameter()->getValue(), operands );
 }
@@ -38,16 +38,122 @@
 
 #include "IECore/MeshPrimitive.h"
 #include "IECore/TriangulateOp.h"
-#include "IECore/MeshNormalsOp.h"
+#include "IECore/MeshAlgo.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/MessageHandler.h"
-#include "IECore/FaceVaryingPromotionOp.h"
 
 #include "IECoreGL/ToGLMeshConverter.h"
 #include "IECoreGL/MeshPrimitive.h"
 
 using namespace IECoreGL;
 
+//////////////////////////////////////////////////////////////////////////
+// Vertex welding utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Compares two elements of the data for a primitive variable, so that we
+// can determine whether or not two face-vertices can share a GL vertex.
+class ElementComparator : public IECore::RefCounted
+{
+
+	public :
+
+		virtual bool equal( size_t a, size_t b ) const = 0;
+
+};
+
+IE_CORE_DECLAREPTR( ElementComparator );
+
+template<typename T>
+class TypedElementComparator : public ElementComparator
+{
+
+	public :
+
+		TypedElementComparator( const T *data, const std::vector<int> *indices )
+			:	m_data( data->readable() ), m_indices( indices )
+		{
+		}
+
+		virtual bool equal( size_t a, size_t b ) const
+		{
+			if( m_indices )
+			{
+				return m_data[(*m_indices)[a]] == m_data[(*m_indices)[b]];
+			}
+			return m_data[a] == m_data[b];
+		}
+
+	private :
+
+		const typename T::ValueType &m_data;
+		const std::vector<int> *m_indices;
+
+};
+
+struct CreateElementComparator
+{
+
+	typedef ElementComparatorPtr ReturnType;
+
+	CreateElementComparator( const std::vector<int> *indices )
+		:	m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data )
+	{
+		return new TypedElementComparator<T>( data, m_indices );
+	}
+
+	private :
+
+		const std::vector<int> *m_indices;
+
+};
+
+// Generates per GL vertex data by gathering elements from the
+// original primitive variable data.
+struct GatherElements
+{
+
+	typedef IECore::DataPtr ReturnType;
+
+	GatherElements( const std::vector<int> &indices )
+		:	m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data )
+	{
+		const typename T::ValueType &in = data->readable();
+		typename T::Ptr result = new T();
+		typename T::ValueType &out = result->writable();
+		out.reserve( m_indices.size() );
+		for( std::vector<int>::const_iterator it = m_indices.begin(), eIt = m_indices.end(); it != eIt; ++it )
+		{
+			out.push_back( in[*it] );
+		}
+		return result;
+	}
+
+	private :
+
+		const std::vector<int> &m_indices;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// ToGLMeshConverter
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( ToGLMeshConverter );
 
 ToGLConverter::ConverterDescription<ToGLMeshConverter> ToGLMeshConverter::g_description;
@@ -64,55 +170,194 @@ ToGLMeshConverter::~ToGLMeshConverter()
 
 IECore::RunTimeTypedPtr ToGLMeshConverter::doConversion( IECore::ConstObjectPtr src, IECore::ConstCompoundObjectPtr operands ) const
 {
-	IECore::MeshPrimitivePtr mesh = boost::static_pointer_cast<IECore::MeshPrimitive>( src->copy() ); // safe because the parameter validated it for us
+	IECore::ConstMeshPrimitivePtr mesh = boost::static_pointer_cast<const IECore::MeshPrimitive>( src ); // safe because the parameter validated it for us
 	
 	if( !mesh->variableData<IECore::V3fVectorData>( "P", IECore::PrimitiveVariable::Vertex ) )
 	{
 		throw IECore::Exception( "Must specify primitive variable \"P\", of type V3fVectorData and interpolation type Vertex." );
 	}
 
-	if( mesh->variables.find( "N" )==mesh->variables.end() )
+	// We never modify or copy the source mesh. Instead we take a shallow copy of
+	// its primitive variables, which shares the underlying data.
+	IECore::PrimitiveVariableMap variables = mesh->variables;
+
+	if( variables.find( "N" )==variables.end() )
 	{
 		// the mesh has no normals - we need to explicitly add some. if it's a polygon
 		// mesh (interpolation==linear) then we add per-face normals for a faceted look
 		// and if it's a subdivision mesh we add smooth per-vertex normals.
-		IECore::MeshNormalsOpPtr normalOp = new IECore::MeshNormalsOp();
-		normalOp->inputParameter()->setValue( mesh );
-		normalOp->copyParameter()->setTypedValue( false );
-		normalOp->interpolationParameter()->setNumericValue(
+		variables["N"] = IECore::MeshAlgo::calculateNormals(
+			mesh.get(),
 			mesh->interpolation() == "linear" ? IECore::PrimitiveVariable::Uniform : IECore::PrimitiveVariable::Vertex
 		);
-		normalOp->operate();
 	}
 	
-	IECore::TriangulateOpPtr op = new IECore::TriangulateOp();
-	op->inputParameter()->setValue( mesh );
-	op->throwExceptionsParameter()->setTypedValue( false ); // it's better to see something than nothing
-	op->copyParameter()->setTypedValue( false );
-	op->operate();
+	if( mesh->maxVerticesPerFace() != 3 )
+	{
+		// TriangulateOp replaces rather than modifies the Uniform and FaceVarying data,
+		// so we can triangulate a new mesh sharing our primitive variables. Meshes which
+		// are already triangulated skip this entirely.
+		IECore::MeshPrimitivePtr triangulatedMesh = new IECore::MeshPrimitive( mesh->verticesPerFace(), mesh->vertexIds(), mesh->interpolation() );
+		triangulatedMesh->variables = variables;
 
-	IECore::FaceVaryingPromotionOpPtr faceVaryingOp = new IECore::FaceVaryingPromotionOp;
-	faceVaryingOp->inputParameter()->setValue( mesh );
-	faceVaryingOp->copyParameter()->setTypedValue( false );
-	faceVaryingOp->operate();
+		IECore::TriangulateOpPtr op = new IECore::TriangulateOp();
+		op->inputParameter()->setValue( triangulatedMesh );
+		op->throwExceptionsParameter()->setTypedValue( false ); // it's better to see something than nothing
+		op->copyParameter()->setTypedValue( false );
+		op->operate();
 
-	MeshPrimitivePtr glMesh = new MeshPrimitive( mesh->numFaces() );
+		variables = triangulatedMesh->variables;
+		mesh = triangulatedMesh;
+	}
+
+	// Rather than promote everything to FaceVarying and draw a separate vertex for
+	// every corner of every triangle, we weld together all the face-vertices which
+	// share a vertex id and have identical Uniform and FaceVarying values. This
+	// gives us an indexed mesh in which vertices are split only where there are
+	// genuine discontinuities (uv seams, hard edges and the like), saving memory
+	// and allowing the GPU to reuse transformed vertices.
 
-	for ( IECore::PrimitiveVariableMap::iterator pIt = mesh->variables.begin(); pIt != mesh->variables.end(); ++pIt )
+	std::vector<ElementComparatorPtr> uniformComparators;
+	std::vector<ElementComparatorPtr> faceVaryingComparators;
+	for( IECore::PrimitiveVariableMap::iterator pIt = variables.begin(); pIt != variables.end(); )
 	{
-		if ( pIt->second.data )
+		IECore::PrimitiveVariableMap::iterator next = pIt; ++next;
+		if( !pIt->second.data )
 		{
-			glMesh->addPrimitiveVariable( pIt->first, pIt->second );
+			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", boost::format( "No data given for primvar \"%s\"" ) % pIt->first );
+			variables.erase( pIt );
 		}
-		else
+		else if( !mesh->isPrimitiveVariableValid( pIt->second ) )
 		{
-			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", boost::format( "No data given for primvar \"%s\"" ) % pIt->first );
+			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", boost::format( "Ignoring invalid primvar \"%s\"" ) % pIt->first );
+			variables.erase( pIt );
 		}
+		else if( pIt->second.interpolation == IECore::PrimitiveVariable::Uniform || pIt->second.interpolation == IECore::PrimitiveVariable::FaceVarying )
+		{
+			CreateElementComparator createComparator( pIt->second.indices ? &pIt->second.indices->readable() : 0 );
+			ElementComparatorPtr comparator = IECore::despatchTypedData<CreateElementComparator, IECore::TypeTraits::IsVectorTypedData>( pIt->second.data.get(), createComparator );
+			if( pIt->second.interpolation == IECore::PrimitiveVariable::Uniform )
+			{
+				uniformComparators.push_back( comparator );
+			}
+			else
+			{
+				faceVaryingComparators.push_back( comparator );
+			}
+		}
+		pIt = next;
+	}
+
+	// The triangulated mesh has three face-vertices per face, so the
+	// face for face-vertex fv is simply fv / 3.
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const size_t numFaceVertices = vertexIds.size();
+
+	// GL vertices sharing a vertex id are kept in a singly linked list,
+	// headed by firstGLVertex and continued by nextGLVertex.
+	std::vector<int> firstGLVertex( mesh->variableSize( IECore::PrimitiveVariable::Vertex ), -1 );
+	std::vector<int> nextGLVertex;
+	// The face-vertex from which each GL vertex takes its values.
+	std::vector<int> faceVaryingIndices;
+
+	IECore::UIntVectorDataPtr glVertIdsData = new IECore::UIntVectorData;
+	std::vector<unsigned int> &glVertIds = glVertIdsData->writable();
+	glVertIds.reserve( numFaceVertices );
+
+	for( size_t fv = 0; fv < numFaceVertices; ++fv )
+	{
+		const size_t face = fv / 3;
+		int glVertex = firstGLVertex[vertexIds[fv]];
+		for( ; glVertex != -1; glVertex = nextGLVertex[glVertex] )
+		{
+			const size_t candidate = faceVaryingIndices[glVertex];
+			bool equivalent = true;
+			for( std::vector<ElementComparatorPtr>::const_iterator cIt = uniformComparators.begin(); equivalent && cIt != uniformComparators.end(); ++cIt )
+			{
+				equivalent = (*cIt)->equal( face, candidate / 3 );
+			}
+			for( std::vector<ElementComparatorPtr>::const_iterator cIt = faceVaryingComparators.begin(); equivalent && cIt != faceVaryingComparators.end(); ++cIt )
+			{
+				equivalent = (*cIt)->equal( fv, candidate );
+			}
+			if( equivalent )
+			{
+				break;
+			}
+		}
+
+		if( glVertex == -1 )
+		{
+			glVertex = faceVaryingIndices.size();
+			faceVaryingIndices.push_back( fv );
+			nextGLVertex.push_back( firstGLVertex[vertexIds[fv]] );
+			firstGLVertex[vertexIds[fv]] = glVertex;
+		}
+
+		glVertIds.push_back( glVertex );
+	}
+
+	std::vector<int> vertexIndices( faceVaryingIndices.size() );
+	std::vector<int> uniformIndices( faceVaryingIndices.size() );
+	for( size_t i = 0; i < faceVaryingIndices.size(); ++i )
+	{
+		vertexIndices[i] = vertexIds[faceVaryingIndices[i]];
+		uniformIndices[i] = faceVaryingIndices[i] / 3;
+	}
+
+	IECore::PrimitiveVariableMap glVariables;
+	for( IECore::PrimitiveVariableMap::const_iterator pIt = variables.begin(); pIt != variables.end(); ++pIt )
+	{
+		const std::vector<int> *indices = 0;
+		switch( pIt->second.interpolation )
+		{
+			case IECore::PrimitiveVariable::Constant :
+				glVariables[pIt->first] = pIt->second;
+				continue;
+			case IECore::PrimitiveVariable::Uniform :
+				indices = &uniformIndices;
+				break;
+			case IECore::PrimitiveVariable::Vertex :
+			case IECore::PrimitiveVariable::Varying :
+				indices = &vertexIndices;
+				break;
+			case IECore::PrimitiveVariable::FaceVarying :
+				indices = &faceVaryingIndices;
+				break;
+			default :
+				continue;
+		}
+
+		// Indexed primitive variables are gathered through their own indices.
+		std::vector<int> composedIndices;
+		if( pIt->second.indices )
+		{
+			const std::vector<int> &variableIndices = pIt->second.indices->readable();
+			composedIndices.reserve( indices->size() );
+			for( std::vector<int>::const_iterator it = indices->begin(), eIt = indices->end(); it != eIt; ++it )
+			{
+				composedIndices.push_back( variableIndices[*it] );
+			}
+			indices = &composedIndices;
+		}
+
+		GatherElements gatherer( *indices );
+		glVariables[pIt->first] = IECore::PrimitiveVariable(
+			IECore::PrimitiveVariable::Vertex,
+			IECore::despatchTypedData<GatherElements, IECore::TypeTraits::IsVectorTypedData>( pIt->second.data.get(), gatherer )
+		);
+	}
+
+	MeshPrimitivePtr glMesh = new MeshPrimitive( glVertIdsData );
+
+	for ( IECore::PrimitiveVariableMap::const_iterator pIt = glVariables.begin(); pIt != glVariables.end(); ++pIt )
+	{
+		glMesh->addPrimitiveVariable( pIt->first, pIt->second );
 	}
 
-	IECore::PrimitiveVariableMap::const_iterator sIt = mesh->variables.find( "s" );
-	IECore::PrimitiveVariableMap::const_iterator tIt = mesh->variables.find( "t" );
-	if ( sIt != mesh->variables.end() && tIt != mesh->variables.end() )
+	IECore::PrimitiveVariableMap::const_iterator sIt = glVariables.find( "s" );
+	IECore::PrimitiveVariableMap::const_iterator tIt = glVariables.find( "t" );
+	if ( sIt != glVariables.end() && tIt != glVariables.end() )
 	{
 		if ( sIt->second.interpolation != IECore::PrimitiveVariable::Constant  
 			&&  tIt->second.interpolation != IECore::PrimitiveVariable::Constant
@@ -145,7 +390,7 @@ IECore::RunTimeTypedPtr ToGLMeshConverter::doConversion( IECore::ConstObjectPtr
 			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", "If specified, primitive variables \"s\" and \"t\" must be of type FloatVectorData and non-Constant interpolation type." );
 		}
 	}
-	else if ( sIt != mesh->variables.end() || tIt != mesh->variables.end() )
+	else if ( sIt != glVariables.end() || tIt != glVariables.end() )
 	{
 		IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", "Primitive variable \"s\" or \"t\" found, but not both." );
 	}
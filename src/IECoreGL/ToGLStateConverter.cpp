@@ -162,10 +162,13 @@ const AttributeToStateMap &attributeToStateMap()
 		m["gl:primitive:pointColor"] = attributeToTypedState<PointColorStateComponent>;
 		m["gl:pointsPrimitive:useGLPoints"] = attributeToUseGLPointsState;
 		m["gl:pointsPrimitive:glPointWidth"] = attributeToTypedState<IECoreGL::PointsPrimitive::GLPointWidth>;
+		m["gl:pointsPrimitive:lodMinimumWidth"] = attributeToTypedState<IECoreGL::PointsPrimitive::LODMinimumWidth>;
+		m["gl:pointsPrimitive:lodDensity"] = attributeToTypedState<IECoreGL::PointsPrimitive::LODDensity>;
 		m["doubleSided"] = attributeToTypedState<DoubleSidedStateComponent>;
 		m["gl:curvesPrimitive:useGLLines"] = attributeToTypedState<IECoreGL::CurvesPrimitive::UseGLLines>;
 		m["gl:curvesPrimitive:glLineWidth"] = attributeToTypedState<IECoreGL::CurvesPrimitive::GLLineWidth>;
 		m["gl:curvesPrimitive:ignoreBasis"] = attributeToTypedState<IECoreGL::CurvesPrimitive::IgnoreBasis>;
+		m["gl:curvesPrimitive:tessellationSegmentLength"] = attributeToTypedState<IECoreGL::CurvesPrimitive::TessellationSegmentLength>;
 		m["gl:smoothing:points"] = attributeToTypedState<PointSmoothingStateComponent>;
 		m["gl:smoothing:lines"] = attributeToTypedState<LineSmoothingStateComponent>;
 		m["gl:smoothing:polygons"] = attributeToTypedState<PolygonSmoothingStateComponent>;
@@ -50,11 +50,18 @@ static IECore::RunTimeTypedPtr convert( CachedConverter &c, IECore::ObjectPtr o
 	return boost::const_pointer_cast<IECore::RunTimeTyped>( c.convert( o.get() ) );
 }
 
+static IECore::RunTimeTypedPtr convertAsync( CachedConverter &c, IECore::ObjectPtr o )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	return boost::const_pointer_cast<IECore::RunTimeTyped>( c.convertAsync( o.get() ) );
+}
+
 void IECoreGL::bindCachedConverter()
 {
 	IECorePython::RefCountedClass<CachedConverter, IECore::RefCounted>( "CachedConverter" )
 		.def( init<size_t>() )
 		.def( "convert", &convert )
+		.def( "convertAsync", &convertAsync )
 		.def( "getMaxMemory", &CachedConverter::getMaxMemory )
 		.def( "setMaxMemory", &CachedConverter::setMaxMemory )
 		.def( "clearUnused", &CachedConverter::clearUnused )
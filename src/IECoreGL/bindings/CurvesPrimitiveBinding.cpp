@@ -67,6 +67,7 @@ void bindCurvesPrimitive()
 	bindTypedStateComponent<CurvesPrimitive::IgnoreBasis>( "IgnoreBasis" );
 	bindTypedStateComponent<CurvesPrimitive::UseGLLines>( "UseGLLines" );
 	bindTypedStateComponent<CurvesPrimitive::GLLineWidth>( "GLLineWidth" );
+	bindTypedStateComponent<CurvesPrimitive::TessellationSegmentLength>( "TessellationSegmentLength" );
 	
 }
 
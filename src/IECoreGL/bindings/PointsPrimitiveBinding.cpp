@@ -62,6 +62,8 @@ void bindPointsPrimitive()
 	
 	bindTypedStateComponent< PointsPrimitive::UseGLPoints >( "UseGLPoints" );
 	bindTypedStateComponent< PointsPrimitive::GLPointWidth >( "GLPointWidth" );
+	bindTypedStateComponent< PointsPrimitive::LODMinimumWidth >( "LODMinimumWidth" );
+	bindTypedStateComponent< PointsPrimitive::LODDensity >( "LODDensity" );
 }
 
 } // namespace
@@ -69,6 +69,13 @@ void bindScene()
 		.def( "select", &select )
 		.def( "setCamera", &Scene::setCamera )
 		.def( "getCamera", (CameraPtr (Scene::*)())&Scene::getCamera )
+		.def( "setRenderListEnabled", &Scene::setRenderListEnabled )
+		.def( "getRenderListEnabled", &Scene::getRenderListEnabled )
+		.def( "dirtyRenderList", &Scene::dirtyRenderList )
+		.def( "setFrustumCullingEnabled", &Scene::setFrustumCullingEnabled )
+		.def( "getFrustumCullingEnabled", &Scene::getFrustumCullingEnabled )
+		.def( "setOcclusionCullingEnabled", &Scene::setOcclusionCullingEnabled )
+		.def( "getOcclusionCullingEnabled", &Scene::getOcclusionCullingEnabled )
 	;
 }
 
@@ -108,8 +108,11 @@ void bindShader()
 	scope s = IECorePython::RunTimeTypedClass<Shader>()
 		.def( init<const std::string &, const std::string &>() )
 		.def( init<const std::string &, const std::string &, const std::string &>() )
+		.def( init<const std::string &, const std::string &, const std::string &, const std::string &, const std::string &>() )
 		.def( "program", &Shader::program )
 		.def( "vertexSource", &Shader::vertexSource, return_value_policy<copy_const_reference>() )
+		.def( "tessControlSource", &Shader::tessControlSource, return_value_policy<copy_const_reference>() )
+		.def( "tessEvaluationSource", &Shader::tessEvaluationSource, return_value_policy<copy_const_reference>() )
 		.def( "geometrySource", &Shader::geometrySource, return_value_policy<copy_const_reference>() )
 		.def( "fragmentSource", &Shader::fragmentSource, return_value_policy<copy_const_reference>() )
 		.def( "uniformParameterNames", &uniformParameterNames )
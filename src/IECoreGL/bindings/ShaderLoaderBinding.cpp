@@ -55,15 +55,21 @@ static python::tuple loadSource( ShaderLoader &s, const std::string &name )
 
 void bindShaderLoader()
 {
+	ShaderPtr (ShaderLoader::*create)( const std::string &, const std::string &, const std::string & ) = &ShaderLoader::create;
+	ShaderPtr (ShaderLoader::*createTessellated)( const std::string &, const std::string &, const std::string &, const std::string &, const std::string & ) = &ShaderLoader::create;
+
 	IECorePython::RefCountedClass<ShaderLoader, IECore::RefCounted>( "ShaderLoader" )
 		.def( init<const IECore::SearchPath &>() )
 		.def( init<const IECore::SearchPath &, const IECore::SearchPath *>() )
 		.def( "loadSource", &loadSource )
-		.def( "create", &ShaderLoader::create )
+		.def( "create", create )
+		.def( "create", createTessellated )
 		.def( "load", &ShaderLoader::load )
 		.def( "defaultShaderLoader", &ShaderLoader::defaultShaderLoader, return_value_policy<IECorePython::CastToIntrusivePtr>() )
 		.staticmethod( "defaultShaderLoader" )
 		.def( "clear", &ShaderLoader::clear)
+		.def( "setCacheDirectory", &ShaderLoader::setCacheDirectory )
+		.def( "getCacheDirectory", &ShaderLoader::getCacheDirectory, return_value_policy<copy_const_reference>() )
 	;
 }
 
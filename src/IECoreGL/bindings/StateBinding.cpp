@@ -78,6 +78,7 @@ void bindState()
 		.def( "get", &get )
 		.def( "remove", (void (State::*)( IECore::TypeId) )&State::remove )
 		.def( "isComplete", &State::isComplete )
+		.def( "compose", &State::compose )
 		.def( "userAttributes", &userAttributes )
 		.def( "defaultState", &defaultState ).staticmethod( "defaultState" )
 		.def( "bindBaseState", &State::bindBaseState ).staticmethod( "bindBaseState" )
@@ -50,6 +50,12 @@ void bindTextureLoader()
 		.def( init<const IECore::SearchPath &>() )
 		.def( "load", &TextureLoader::load )
 		.def( "clear", &TextureLoader::clear )
+		.def( "getMaxMemory", &TextureLoader::getMaxMemory )
+		.def( "setMaxMemory", &TextureLoader::setMaxMemory )
+		.def( "setMaximumResolution", &TextureLoader::setMaximumResolution )
+		.def( "getMaximumResolution", &TextureLoader::getMaximumResolution )
+		.def( "setCacheDirectory", &TextureLoader::setCacheDirectory )
+		.def( "getCacheDirectory", &TextureLoader::getCacheDirectory, return_value_policy<copy_const_reference>() )
 		.def( "defaultTextureLoader", &TextureLoader::defaultTextureLoader, return_value_policy<IECorePython::CastToIntrusivePtr>() )
 		.staticmethod( "defaultTextureLoader" )
 	;
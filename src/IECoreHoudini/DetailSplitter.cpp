@@ -32,12 +32,52 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "GA/GA_AIFSharedStringTuple.h"
 #include "GU/GU_Detail.h"
 
 #include "IECoreHoudini/DetailSplitter.h"
 
 using namespace IECoreHoudini;
 
+namespace
+{
+
+// Builds the sub-detail for each partition. The source detail is only read,
+// so the partitions can be merged concurrently.
+struct MergePartitions
+{
+	MergePartitions( const GU_Detail *geo, const std::vector<GA_OffsetList> &offsets, std::vector<GU_Detail *> &result )
+		: m_geo( geo ), m_offsets( offsets ), m_result( result )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for ( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			if ( !m_offsets[i].entries() )
+			{
+				continue;
+			}
+			
+			GU_Detail *newGeo = new GU_Detail();
+			GA_Range matchPrims( m_geo->getPrimitiveMap(), m_offsets[i] );
+			newGeo->mergePrimitives( *m_geo, matchPrims );
+			newGeo->incrementMetaCacheCount();
+			m_result[i] = newGeo;
+		}
+	}
+
+	const GU_Detail *m_geo;
+	const std::vector<GA_OffsetList> &m_offsets;
+	std::vector<GU_Detail *> &m_result;
+};
+
+} // namespace
+
 DetailSplitter::DetailSplitter( const GU_DetailHandle &handle, const std::string &key )
 	: m_lastMetaCount( -1 ), m_key( key ), m_handle( handle )
 {
@@ -95,35 +135,41 @@ bool DetailSplitter::validate()
 	const GA_Attribute *attr = attrRef.getAttribute();
 	const GA_AIFSharedStringTuple *tuple = attr->getAIFSharedStringTuple();
 	
-	std::map<GA_StringIndexType, GA_OffsetList> offsets;
+	// partition all the primitives in a single pass, indexing the partitions
+	// by string handle rather than looking them up by name. Partition 0 holds
+	// the primitives without a valid handle.
+	GA_StringTableStatistics stats;
+	tuple->getStatistics( attr, stats );
+	std::vector<GA_OffsetList> offsets( stats.getCapacity() + 1 );
+	
 	GA_Range primRange = geo->getPrimitiveRange();
 	for ( GA_Iterator it = primRange.begin(); !it.atEnd(); ++it )
 	{
 		GA_StringIndexType currentHandle = tuple->getHandle( attr, it.getOffset() );
-		
-		std::map<GA_StringIndexType, GA_OffsetList>::iterator oIt = offsets.find( currentHandle );
-		if ( oIt == offsets.end() )
-		{
-			oIt = offsets.insert( std::pair<GA_StringIndexType, GA_OffsetList>( currentHandle, GA_OffsetList() ) ).first;
-		}
-		
-		oIt->second.append( it.getOffset() );
+		size_t index = ( currentHandle >= 0 && (size_t)currentHandle < offsets.size() - 1 ) ? currentHandle + 1 : 0;
+		offsets[index].append( it.getOffset() );
 	}
 	
-	for ( std::map<GA_StringIndexType, GA_OffsetList>::iterator oIt = offsets.begin(); oIt != offsets.end(); ++oIt )
+	std::vector<GU_Detail *> newGeos( offsets.size(), (GU_Detail *)0 );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, offsets.size(), 1 ), MergePartitions( geo, offsets, newGeos ) );
+	
+	for ( size_t i = 0; i < newGeos.size(); ++i )
 	{
-		GU_Detail *newGeo = new GU_Detail();
-		GA_Range matchPrims( geo->getPrimitiveMap(), oIt->second );
-		newGeo->mergePrimitives( *geo, matchPrims );
-		newGeo->incrementMetaCacheCount();
+		if ( !newGeos[i] )
+		{
+			continue;
+		}
 		
 		GU_DetailHandle handle;
-		handle.allocateAndSet( newGeo, true );
+		handle.allocateAndSet( newGeos[i], true );
 		
 		std::string current = "";
-		if ( const char *value = tuple->getTableString( attr, oIt->first ) )
+		if ( i > 0 )
 		{
-			current = value;
+			if ( const char *value = tuple->getTableString( attr, (GA_StringIndexType)( i - 1 ) ) )
+			{
+				current = value;
+			}
 		}
 		
 		m_cache[current] = handle;
@@ -34,6 +34,11 @@
 
 #include "boost/python.hpp"
 
+#include "tbb/mutex.h"
+#include "tbb/parallel_for.h"
+
+#include "UT/UT_Version.h"
+
 #include "IECore/CompoundObject.h"
 
 #include "IECoreHoudini/FromHoudiniPolygonsConverter.h"
@@ -41,6 +46,127 @@
 using namespace IECore;
 using namespace IECoreHoudini;
 
+namespace
+{
+
+// Functors for extracting the topology in parallel. The first counts the
+// vertices of each face, and the second fills in the vertex ids once
+// the face offsets into the vertex id array are known.
+
+struct FaceSizes
+{
+	FaceSizes( const GA_PrimitiveList &primitives, const std::vector<GA_Offset> &primOffsets, std::vector<int> &vertsPerFace )
+		:	m_primitives( primitives ), m_primOffsets( primOffsets ), m_vertsPerFace( vertsPerFace )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		for ( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			m_vertsPerFace[i] = m_primitives.get( m_primOffsets[i] )->getVertexCount();
+		}
+	}
+
+	private :
+
+		const GA_PrimitiveList &m_primitives;
+		const std::vector<GA_Offset> &m_primOffsets;
+		std::vector<int> &m_vertsPerFace;
+};
+
+struct FaceVertexIds
+{
+	FaceVertexIds( const GU_Detail *geo, const std::vector<GA_Offset> &primOffsets, const std::vector<int> &faceOffsets, std::vector<int> &vertIds )
+		:	m_geo( geo ), m_primOffsets( primOffsets ), m_faceOffsets( faceOffsets ), m_vertIds( vertIds )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		const GA_PrimitiveList &primitives = m_geo->getPrimitiveList();
+		for ( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			const GA_Primitive *prim = primitives.get( m_primOffsets[i] );
+			size_t numPrimVerts = prim->getVertexCount();
+			int *ids = &m_vertIds[m_faceOffsets[i]];
+			for ( size_t j=0; j < numPrimVerts; j++ )
+			{
+				ids[j] = m_geo->pointIndex( prim->getPointOffset( numPrimVerts - 1 - j ) );
+			}
+		}
+	}
+
+	private :
+
+		const GU_Detail *m_geo;
+		const std::vector<GA_Offset> &m_primOffsets;
+		const std::vector<int> &m_faceOffsets;
+		std::vector<int> &m_vertIds;
+};
+
+#if UT_MAJOR_VERSION_INT >= 15
+
+// The topology extracted most recently from each detail. When exporting
+// a sequence with constant topology, this lets us reuse the previous frame's
+// topology rather than extract it again. The data ids of the primitive list
+// and the vertex to point references tell us when the topology has changed.
+struct CachedTopology
+{
+	GA_DataId primitiveListId;
+	GA_DataId pointRefId;
+	GA_Size numPoints;
+	GA_Size numVertices;
+	ConstIntVectorDataPtr vertsPerFace;
+	ConstIntVectorDataPtr vertIds;
+};
+
+typedef std::map<int, CachedTopology> TopologyCache;
+TopologyCache g_topologyCache;
+tbb::mutex g_topologyCacheMutex;
+const size_t g_maxCachedTopologies = 64;
+
+bool cachedTopology( const GU_Detail *geo, ConstIntVectorDataPtr &vertsPerFace, ConstIntVectorDataPtr &vertIds )
+{
+	tbb::mutex::scoped_lock lock( g_topologyCacheMutex );
+	TopologyCache::const_iterator it = g_topologyCache.find( geo->getUniqueId() );
+	if (
+		it == g_topologyCache.end() ||
+		it->second.primitiveListId != geo->getPrimitiveList().getDataId() ||
+		it->second.pointRefId != geo->getTopology().getPointRef()->getDataId() ||
+		it->second.numPoints != geo->getNumPoints() ||
+		it->second.numVertices != geo->getNumVertices()
+	)
+	{
+		return false;
+	}
+	
+	vertsPerFace = it->second.vertsPerFace;
+	vertIds = it->second.vertIds;
+	return true;
+}
+
+void cacheTopology( const GU_Detail *geo, ConstIntVectorDataPtr vertsPerFace, ConstIntVectorDataPtr vertIds )
+{
+	tbb::mutex::scoped_lock lock( g_topologyCacheMutex );
+	if ( g_topologyCache.size() >= g_maxCachedTopologies && !g_topologyCache.count( geo->getUniqueId() ) )
+	{
+		g_topologyCache.clear();
+	}
+	
+	CachedTopology &cached = g_topologyCache[geo->getUniqueId()];
+	cached.primitiveListId = geo->getPrimitiveList().getDataId();
+	cached.pointRefId = geo->getTopology().getPointRef()->getDataId();
+	cached.numPoints = geo->getNumPoints();
+	cached.numVertices = geo->getNumVertices();
+	cached.vertsPerFace = vertsPerFace;
+	cached.vertIds = vertIds;
+}
+
+#endif
+
+} // namespace
+
 IE_CORE_DEFINERUNTIMETYPED( FromHoudiniPolygonsConverter );
 
 FromHoudiniGeometryConverter::Description<FromHoudiniPolygonsConverter> FromHoudiniPolygonsConverter::m_description( MeshPrimitiveTypeId );
@@ -105,19 +231,51 @@ ObjectPtr FromHoudiniPolygonsConverter::doDetailConversion( const GU_Detail *geo
 		}
 	}
 	
-	// loop over primitives gathering mesh data
-	std::vector<int> vertIds;
-	std::vector<int> vertsPerFace;
-	for ( GA_Iterator it=firstPrim; !it.atEnd(); ++it )
+	ConstIntVectorDataPtr vertsPerFaceData = 0;
+	ConstIntVectorDataPtr vertIdsData = 0;
+
+#if UT_MAJOR_VERSION_INT >= 15
+
+	cachedTopology( geo, vertsPerFaceData, vertIdsData );
+
+#endif
+
+	if ( !vertsPerFaceData )
 	{
-		const GA_Primitive *prim = primitives.get( it.getOffset() );
-		size_t numPrimVerts = prim->getVertexCount();
-		vertsPerFace.push_back( numPrimVerts );
-		std::vector<int> ids( numPrimVerts );
-		for ( size_t j=0; j < numPrimVerts; j++ )
+		// gather the mesh data in parallel
+		std::vector<GA_Offset> primOffsets;
+		primOffsets.reserve( geo->getNumPrimitives() );
+		for ( GA_Iterator it=firstPrim; !it.atEnd(); ++it )
 		{
-			vertIds.push_back( geo->pointIndex( prim->getPointOffset( numPrimVerts - 1 - j ) ) );
+			primOffsets.push_back( it.getOffset() );
 		}
+		
+		IntVectorDataPtr vertsPerFace = new IntVectorData;
+		std::vector<int> &vertsPerFaceWritable = vertsPerFace->writable();
+		vertsPerFaceWritable.resize( primOffsets.size() );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, primOffsets.size() ), FaceSizes( primitives, primOffsets, vertsPerFaceWritable ) );
+		
+		std::vector<int> faceOffsets( primOffsets.size() );
+		int numVertIds = 0;
+		for ( size_t i=0; i < vertsPerFaceWritable.size(); ++i )
+		{
+			faceOffsets[i] = numVertIds;
+			numVertIds += vertsPerFaceWritable[i];
+		}
+		
+		IntVectorDataPtr vertIds = new IntVectorData;
+		vertIds->writable().resize( numVertIds );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, primOffsets.size() ), FaceVertexIds( geo, primOffsets, faceOffsets, vertIds->writable() ) );
+		
+		vertsPerFaceData = vertsPerFace;
+		vertIdsData = vertIds;
+
+#if UT_MAJOR_VERSION_INT >= 15
+
+		cacheTopology( geo, vertsPerFaceData, vertIdsData );
+
+#endif
+
 	}
 	
 	// try to get the interpolation type from the geo
@@ -153,7 +311,7 @@ ObjectPtr FromHoudiniPolygonsConverter::doDetailConversion( const GU_Detail *geo
 		}
 	}
 	
-	result->setTopology( new IntVectorData( vertsPerFace ), new IntVectorData( vertIds ), interpolation );
+	result->setTopology( vertsPerFaceData, vertIdsData, interpolation );
 	
 	if ( geo->getNumVertices() )
 	{
@@ -32,9 +32,19 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <map>
+
+#include "boost/filesystem.hpp"
+
+#include "tbb/spin_mutex.h"
+
 #include "IECore/CompoundParameter.h"
+#include "IECore/MemoryIndexedIO.h"
+#include "IECore/ObjectPool.h"
 #include "IECore/Reader.h"
 #include "IECore/TypeIds.h"
+#include "IECore/VectorTypedData.h"
 #include "IECore/Writer.h"
 
 #include "IECoreHoudini/GEO_CobIOTranslator.h"
@@ -45,6 +55,134 @@
 using namespace IECore;
 using namespace IECoreHoudini;
 
+namespace
+{
+
+// Maps from the identity of each file loaded during the session to the
+// hash of the object it contained, so that repeated loads of an unchanged
+// file can retrieve the object from the ObjectPool instead of reading it again.
+typedef std::map<MurmurHash, MurmurHash> LoadedFileMap;
+typedef tbb::spin_mutex LoadedFileMutex;
+
+LoadedFileMap g_loadedFiles;
+LoadedFileMutex g_loadedFilesMutex;
+
+// Identifies a file by its name, size and modification time. Returns
+// false if the stream doesn't correspond to a file.
+bool fileKey( const std::string &fileName, MurmurHash &key )
+{
+	boost::system::error_code ec;
+	const boost::filesystem::path path( fileName );
+	const std::time_t time = boost::filesystem::last_write_time( path, ec );
+	if( ec )
+	{
+		return false;
+	}
+
+	const boost::uintmax_t size = boost::filesystem::file_size( path, ec );
+	if( ec )
+	{
+		return false;
+	}
+
+	key.append( fileName );
+	key.append( (uint64_t)time );
+	key.append( (uint64_t)size );
+	return true;
+}
+
+// Reads the remainder of the stream into memory. The stream may be
+// compressed or held in memory, in which case there is no file to
+// reopen by name.
+CharVectorDataPtr readStream( UT_IStream &is )
+{
+	CharVectorDataPtr result = new CharVectorData;
+	std::vector<char> &data = result->writable();
+
+	const exint chunkSize = 1 << 20;
+	while( true )
+	{
+		const size_t offset = data.size();
+		data.resize( offset + chunkSize );
+		const exint numRead = is.bread( &data[offset], chunkSize );
+		data.resize( offset + std::max<exint>( numRead, 0 ) );
+		if( numRead < chunkSize )
+		{
+			break;
+		}
+	}
+
+	return result;
+}
+
+ConstObjectPtr loadObject( UT_IStream &is, bool ateMagic )
+{
+	const std::string fileName = is.getLabel() ? is.getLabel() : "";
+
+	MurmurHash key;
+	const bool haveKey = fileKey( fileName, key );
+	if( haveKey )
+	{
+		MurmurHash objectHash;
+		bool loadedBefore = false;
+		{
+			LoadedFileMutex::scoped_lock lock( g_loadedFilesMutex );
+			LoadedFileMap::const_iterator it = g_loadedFiles.find( key );
+			if( it != g_loadedFiles.end() )
+			{
+				objectHash = it->second;
+				loadedBefore = true;
+			}
+		}
+
+		if( loadedBefore )
+		{
+			// May still fail if the pool has since evicted the object.
+			if( ConstObjectPtr object = ObjectPool::defaultObjectPool()->retrieve( objectHash ) )
+			{
+				return object;
+			}
+		}
+	}
+
+	ConstObjectPtr object = 0;
+	if( !ateMagic )
+	{
+		CharVectorDataPtr buffer = readStream( is );
+		try
+		{
+			IndexedIOPtr io = new MemoryIndexedIO( buffer, IndexedIO::rootPath, IndexedIO::Read );
+			object = Object::load( io, "object", /* parallel = */ true );
+		}
+		catch( ... )
+		{
+			// Not a Cortex object stream - we fall back to
+			// the Readers for other formats such as pdc.
+		}
+	}
+
+	if( !object )
+	{
+		ReaderPtr reader = Reader::create( fileName );
+		if( !reader )
+		{
+			return 0;
+		}
+		object = reader->read();
+	}
+
+	if( haveKey && object )
+	{
+		object = ObjectPool::defaultObjectPool()->store( object.get(), ObjectPool::StoreReference );
+		LoadedFileMutex::scoped_lock lock( g_loadedFilesMutex );
+		g_loadedFiles[key] = object->hash();
+	}
+
+	return object;
+}
+
+} // namespace
+
 GEO_CobIOTranslator::GEO_CobIOTranslator()
 {
 }
@@ -83,18 +221,10 @@ int GEO_CobIOTranslator::checkMagicNumber( unsigned magic )
 
 GA_Detail::IOStatus GEO_CobIOTranslator::fileLoad( GEO_Detail *geo, UT_IStream &is, bool ate_magic )
 {
-	((UT_IFStream&)is).close();
-	
 	ConstObjectPtr object = 0;
 	try
 	{
-		ReaderPtr reader = Reader::create( is.getLabel() );
-		if ( !reader )
-		{
-			return false;
-		}
-		
-		object = reader->read();
+		object = loadObject( is, ate_magic );
 	}
 	catch ( IECore::Exception e )
 	{
@@ -164,6 +164,15 @@ void GR_CortexPrimitive::update( RE_Render *r, const GT_PrimitiveHandle &primh,
 		return;
 	}
 	
+	// Houdini calls update() for many reasons other than changes to the geometry,
+	// so we only rebuild the scene if the renderable or display mode have changed.
+	IECore::MurmurHash sceneHash = m_renderable->Object::hash();
+	sceneHash.append( p.dopts.boundBox() );
+	if ( m_scene && sceneHash == m_sceneHash )
+	{
+		return;
+	}
+	
 	IECoreGL::RendererPtr renderer = new IECoreGL::Renderer();
 	renderer->setOption( "gl:mode", new IECore::StringData( "deferred" ) );
 	renderer->setOption( "gl:drawCoordinateSystems", new IECore::BoolData( true ) );
@@ -186,6 +195,7 @@ void GR_CortexPrimitive::update( RE_Render *r, const GT_PrimitiveHandle &primh,
 	
 	m_scene = renderer->scene();
 	m_scene->setCamera( 0 ); // houdini will be providing the camera
+	m_sceneHash = sceneHash;
 }
 
 #if UT_MAJOR_VERSION_INT >= 16
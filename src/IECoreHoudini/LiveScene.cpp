@@ -44,6 +44,8 @@
 #include "UT/UT_WorkArgs.h" 
 
 #include "IECore/Group.h"
+#include "IECore/LRUCache.h"
+#include "IECore/SimpleTypedData.h"
 #include "IECore/TransformationMatrixData.h"
 
 #include "IECoreHoudini/Convert.h"
@@ -68,7 +70,64 @@ static InternedString contentName( "geo" );
 PRM_Name LiveScene::pTags( "ieTags", "ieTags" );
 static const UT_String tagGroupPrefix( "ieTag_" );
 
-LiveScene::LiveScene() : m_rootIndex( 0 ), m_contentIndex( 0 ), m_defaultTime( std::numeric_limits<double>::infinity() )
+// Appends the ids Houdini uses to track changes to a detail
+static void appendDetailIds( const GU_DetailHandle &handle, MurmurHash &h )
+{
+	GU_DetailHandleAutoReadLock readHandle( handle );
+	if ( const GU_Detail *geo = readHandle.getGdp() )
+	{
+		h.append( (int64_t)geo->getUniqueId() );
+		h.append( (int64_t)geo->getMetaCacheCount() );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// LiveScene::Cache
+//////////////////////////////////////////////////////////////////////////
+
+class LiveScene::Cache : public RefCounted
+{
+	public :
+		
+		Cache() : m_cache( nullGetter, 500 * 1024 * 1024 )
+		{
+		}
+		
+		/// Returns the cached value for key, or 0 if it hasn't been computed.
+		ConstObjectPtr get( const MurmurHash &key )
+		{
+			if ( !m_cache.cached( key ) )
+			{
+				return 0;
+			}
+			
+			return m_cache.get( key );
+		}
+		
+		void set( const MurmurHash &key, const Object *value )
+		{
+			m_cache.set( key, value, value->memoryUsage() );
+		}
+	
+	private :
+		
+		// values are only ever added with set(), so a lookup which races
+		// with an eviction just yields a value that will be recomputed.
+		static ConstObjectPtr nullGetter( const MurmurHash &key, size_t &cost )
+		{
+			cost = 0;
+			return 0;
+		}
+		
+		LRUCache<MurmurHash, ConstObjectPtr> m_cache;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// LiveScene
+//////////////////////////////////////////////////////////////////////////
+
+LiveScene::LiveScene() : m_rootIndex( 0 ), m_contentIndex( 0 ), m_defaultTime( std::numeric_limits<double>::infinity() ), m_cache( new Cache )
 {
 	MOT_Director *motDirector = dynamic_cast<MOT_Director *>( OPgetDirector() );
 	motDirector->getObjectManager()->getFullPath( m_nodePath );
@@ -78,13 +137,13 @@ LiveScene::LiveScene() : m_rootIndex( 0 ), m_contentIndex( 0 ), m_defaultTime( s
 }
 
 LiveScene::LiveScene( const UT_String &nodePath, const Path &contentPath, const Path &rootPath, double defaultTime )
-	: m_rootIndex( 0 ), m_contentIndex( 0 ), m_defaultTime( defaultTime )
+	: m_rootIndex( 0 ), m_contentIndex( 0 ), m_defaultTime( defaultTime ), m_cache( new Cache )
 {
 	constructCommon( nodePath, contentPath, rootPath, 0 );
 }
 
 LiveScene::LiveScene( const UT_String &nodePath, const Path &contentPath, const Path &rootPath, const LiveScene& parent )
-	: m_rootIndex( 0 ), m_contentIndex( 0 ), m_splitter( parent.m_splitter ), m_defaultTime( parent.m_defaultTime )
+	: m_rootIndex( 0 ), m_contentIndex( 0 ), m_splitter( parent.m_splitter ), m_defaultTime( parent.m_defaultTime ), m_cache( parent.m_cache )
 {
 	constructCommon( nodePath, contentPath, rootPath, m_splitter.get() );
 }
@@ -234,6 +293,12 @@ Imath::Box3d LiveScene::readBound( double time ) const
 {
 	OP_Node *node = retrieveNode( true );
 	
+	const MurmurHash key = cacheKey( "bound", time, node );
+	if ( ConstBox3dDataPtr cached = runTimeCast<const Box3dData>( m_cache->get( key ) ) )
+	{
+		return cached->readable();
+	}
+	
 	Imath::Box3d bounds;
 	UT_BoundingBox box;
 	OP_Context context( adjustTime( time ) );
@@ -247,6 +312,7 @@ Imath::Box3d LiveScene::readBound( double time ) const
 	// paths embedded within a sop already have bounds accounted for
 	if ( m_contentIndex )
 	{
+		m_cache->set( key, new Box3dData( bounds ) );
 		return bounds;
 	}
 	
@@ -262,6 +328,8 @@ Imath::Box3d LiveScene::readBound( double time ) const
 		}
 	}
 	
+	m_cache->set( key, new Box3dData( bounds ) );
+	
 	return bounds;
 }
 
@@ -299,14 +367,23 @@ Imath::M44d LiveScene::readTransformAsMatrix( double time ) const
 		return Imath::M44d();
 	}
 	
+	const MurmurHash key = cacheKey( "transform", time, objNode );
+	if ( ConstM44dDataPtr cached = runTimeCast<const M44dData>( m_cache->get( key ) ) )
+	{
+		return cached->readable();
+	}
+	
+	Imath::M44d result;
 	UT_DMatrix4 matrix;
 	OP_Context context( adjustTime( time ) );
-	if ( !objNode->getParmTransform( context, matrix ) )
+	if ( objNode->getParmTransform( context, matrix ) )
 	{
-		return Imath::M44d();
+		result = IECore::convert<Imath::M44d>( matrix );
 	}
 	
-	return IECore::convert<Imath::M44d>( matrix );
+	m_cache->set( key, new M44dData( result ) );
+	
+	return result;
 }
 
 ConstDataPtr LiveScene::readWorldTransform( double time ) const
@@ -332,14 +409,23 @@ Imath::M44d LiveScene::readWorldTransformAsMatrix( double time ) const
 		return Imath::M44d();
 	}
 	
+	const MurmurHash key = cacheKey( "worldTransform", time, objNode );
+	if ( ConstM44dDataPtr cached = runTimeCast<const M44dData>( m_cache->get( key ) ) )
+	{
+		return cached->readable();
+	}
+	
+	Imath::M44d result;
 	UT_DMatrix4 matrix;
 	OP_Context context( adjustTime( time ) );
-	if ( !objNode->getWorldTransform( matrix, context ) )
+	if ( objNode->getWorldTransform( matrix, context ) )
 	{
-		return Imath::M44d();
+		result = IECore::convert<Imath::M44d>( matrix );
 	}
 	
-	return IECore::convert<Imath::M44d>( matrix );
+	m_cache->set( key, new M44dData( result ) );
+	
+	return result;
 }
 
 void LiveScene::writeTransform( const Data *transform, double time )
@@ -444,39 +530,10 @@ bool LiveScene::hasTag( const Name &name, int filter ) const
 	if ( filter & SceneInterface::LocalTag )
 	{
 		// check tags based on primitive groups
-		OBJ_Node *contentNode = retrieveNode( true )->castToOBJNode();
-		if ( contentNode && contentNode->getObjectType() == OBJ_GEOMETRY && m_splitter )
+		ConstInternedStringVectorDataPtr tags = groupTags();
+		if ( std::binary_search( tags->readable().begin(), tags->readable().end(), name ) )
 		{
-			GU_DetailHandle newHandle = contentHandle();
-			if ( !newHandle.isNull() )
-			{
-				GU_DetailHandleAutoReadLock readHandle( newHandle );
-				if ( const GU_Detail *geo = readHandle.getGdp() )
-				{
-					GA_Range prims = geo->getPrimitiveRange();
-
-					for ( GA_GroupTable::iterator<GroupType> it=geo->primitiveGroups().beginTraverse(); !it.atEnd(); ++it )
-					{
-						GA_PrimitiveGroup *group = static_cast<GA_PrimitiveGroup*>( it.group() );
-						if ( group->getInternal() || group->isEmpty() )
-						{
-							continue;
-						}
-						
-						const UT_String groupName = group->getName().c_str();
-						if ( groupName.startsWith( tagGroupPrefix ) && group->containsAny( prims ) )
-						{
-							UT_String tag;
-							groupName.substr( tag, tagGroupPrefix.length() );
-							tag.substitute( "_", ":" );
-							if ( tag.equal( name.c_str() ) )
-							{
-								return true;
-							}
-						}
-					}
-				}
-			}
+			return true;
 		}
 	}
 	
@@ -527,38 +584,10 @@ void LiveScene::readTags( NameList &tags, int filter ) const
 	if ( filter & SceneInterface::LocalTag )
 	{
 		// add tags based on primitive groups
-		OBJ_Node *contentNode = retrieveNode( true )->castToOBJNode();
-		if ( contentNode && contentNode->getObjectType() == OBJ_GEOMETRY && m_splitter )
-		{
-			GU_DetailHandle newHandle = contentHandle();
-			if ( !newHandle.isNull() )
-			{
-				GU_DetailHandleAutoReadLock readHandle( newHandle );
-				if ( const GU_Detail *geo = readHandle.getGdp() )
-				{
-					GA_Range prims = geo->getPrimitiveRange();
-
-					for ( GA_GroupTable::iterator<GroupType> it=geo->primitiveGroups().beginTraverse(); !it.atEnd(); ++it )
-					{
-						GA_PrimitiveGroup *group = static_cast<GA_PrimitiveGroup*>( it.group() );
-						if ( group->getInternal() || group->isEmpty() )
-						{
-							continue;
-						}
-					
-						const UT_String groupName = group->getName().c_str();
-						if ( groupName.startsWith( tagGroupPrefix ) && group->containsAny( prims ) )
-						{
-							UT_String tag;
-							groupName.substr( tag, tagGroupPrefix.length() );
-							tag.substitute( "_", ":" );
-							uniqueTags.insert( tag.buffer() );
-						}
-					}
-				}
-			}
-		}
+		ConstInternedStringVectorDataPtr groupTagsData = groupTags();
+		uniqueTags.insert( groupTagsData->readable().begin(), groupTagsData->readable().end() );
 	}
+	
 	tags.insert( tags.end(), uniqueTags.begin(), uniqueTags.end() );
 }
 
@@ -567,6 +596,59 @@ void LiveScene::writeTags( const NameList &tags )
 	throw Exception( "IECoreHoudini::LiveScene::writeTags not supported" );
 }
 
+ConstInternedStringVectorDataPtr LiveScene::groupTags() const
+{
+	OBJ_Node *contentNode = retrieveNode( true )->castToOBJNode();
+	if ( !contentNode || contentNode->getObjectType() != OBJ_GEOMETRY || !m_splitter )
+	{
+		return new InternedStringVectorData;
+	}
+	
+	// the tags depend only on the geometry held by the splitter, so time is irrelevant
+	MurmurHash key = cacheKey( "groupTags", 0.0, contentNode );
+	appendDetailIds( m_splitter->handle(), key );
+	if ( ConstInternedStringVectorDataPtr cached = runTimeCast<const InternedStringVectorData>( m_cache->get( key ) ) )
+	{
+		return cached;
+	}
+	
+	std::set<Name> uniqueTags;
+	GU_DetailHandle newHandle = contentHandle();
+	if ( !newHandle.isNull() )
+	{
+		GU_DetailHandleAutoReadLock readHandle( newHandle );
+		if ( const GU_Detail *geo = readHandle.getGdp() )
+		{
+			GA_Range prims = geo->getPrimitiveRange();
+			
+			for ( GA_GroupTable::iterator<GroupType> it=geo->primitiveGroups().beginTraverse(); !it.atEnd(); ++it )
+			{
+				GA_PrimitiveGroup *group = static_cast<GA_PrimitiveGroup*>( it.group() );
+				if ( group->getInternal() || group->isEmpty() )
+				{
+					continue;
+				}
+				
+				const UT_String groupName = group->getName().c_str();
+				if ( groupName.startsWith( tagGroupPrefix ) && group->containsAny( prims ) )
+				{
+					UT_String tag;
+					groupName.substr( tag, tagGroupPrefix.length() );
+					tag.substitute( "_", ":" );
+					uniqueTags.insert( tag.buffer() );
+				}
+			}
+		}
+	}
+	
+	// the set leaves the tags sorted, so hasTag() can use a binary search
+	InternedStringVectorDataPtr result = new InternedStringVectorData;
+	result->writable().insert( result->writable().end(), uniqueTags.begin(), uniqueTags.end() );
+	m_cache->set( key, result.get() );
+	
+	return result;
+}
+
 static const char *emptyString = "";
 
 bool LiveScene::hasObject() const
@@ -650,6 +732,14 @@ ConstObjectPtr LiveScene::readObject( double time ) const
 		OP_Context context( adjustTime( time ) );
 		GU_DetailHandle handle = objNode->getRenderGeometryHandle( context, false );
 		
+		MurmurHash key = cacheKey( "object", time, objNode );
+		appendDetailIds( handle, key );
+		
+		if ( ConstObjectPtr cached = m_cache->get( key ) )
+		{
+			return cached;
+		}
+		
 		if ( !m_splitter || ( handle != m_splitter->handle() ) )
 		{
 			m_splitter = new DetailSplitter( handle );
@@ -662,7 +752,13 @@ ConstObjectPtr LiveScene::readObject( double time ) const
 			return 0;
 		}
 		
-		return converter->convert();
+		ConstObjectPtr result = converter->convert();
+		if ( result )
+		{
+			m_cache->set( key, result.get() );
+		}
+		
+		return result;
 	}
 	
 	/// \todo: need to account for cameras and lights
@@ -996,6 +1092,7 @@ SceneInterfacePtr LiveScene::retrieveScene( const Path &path, MissingBehaviour m
 	
 	LiveScenePtr rootScene = create();
 	rootScene->setDefaultTime( m_defaultTime );
+	rootScene->m_cache = m_cache;
 	for ( Path::const_iterator it = rootPath.begin(); it != rootPath.end(); ++it )
 	{
 		rootScene = IECore::runTimeCast<LiveScene>( rootScene->child( *it ) );
@@ -1164,6 +1261,25 @@ GU_DetailHandle LiveScene::contentHandle() const
 	return handle;
 }
 
+MurmurHash LiveScene::cacheKey( const char *type, double time, const OP_Node *node ) const
+{
+	MurmurHash h;
+	h.append( type );
+	h.append( m_nodePath.buffer() );
+	if ( m_contentIndex )
+	{
+		for ( Path::const_iterator it = m_path.begin() + m_contentIndex; it != m_path.end(); ++it )
+		{
+			h.append( *it );
+		}
+	}
+	h.append( time );
+	h.append( node->getUniqueId() );
+	h.append( node->getCookCount() );
+	
+	return h;
+}
+
 void LiveScene::registerCustomAttributes( ReadNamesFn namesFn, ReadAttrFn readFn )
 {
 	CustomAttributeReader r;
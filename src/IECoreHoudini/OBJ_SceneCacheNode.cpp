@@ -409,6 +409,19 @@ void OBJ_SceneCacheNode<BaseType>::sceneChanged()
 	this->m_static = boost::indeterminate;
 }
 
+template<typename BaseType>
+void OBJ_SceneCacheNode<BaseType>::setStatic( bool isStatic )
+{
+	this->m_static = isStatic;
+	
+	// only update time dependency if Houdini thinks its static
+	if ( !BaseType::flags().getTimeDep() && !BaseType::getParmList()->getCookTimeDependent() )
+	{
+		BaseType::flags().setTimeDep( !isStatic );
+		BaseType::getParmList()->setCookTimeDependent( !isStatic );
+	}
+}
+
 template<typename BaseType>
 void OBJ_SceneCacheNode<BaseType>::updateState()
 {
@@ -40,6 +40,9 @@
 
 #endif
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "PRM/PRM_ChoiceList.h"
 #include "UT/UT_Interrupt.h"
 #include "UT/UT_PtrArray.h"
@@ -162,6 +165,13 @@ void OBJ_SceneCacheTransform::expandHierarchy( const SceneInterface *scene )
 		return;
 	}
 	
+	// gather the structure of the subtree up front, so node creation
+	// below doesn't need to query the cache for each location
+	Location rootLocation;
+	rootLocation.scene = scene;
+	gatherChildren( rootLocation, params.tagFilter, params.depth == AllDescendants, params.hierarchy == Parenting );
+	indexLocations( rootLocation );
+	
 	OBJ_Node *rootNode = this;
 	if ( scene->hasObject() )
 	{
@@ -188,11 +198,13 @@ void OBJ_SceneCacheTransform::expandHierarchy( const SceneInterface *scene )
 	UT_Interrupt *progress = UTgetInterrupt();
 	if ( !progress->opStart( ( "Expand Hierarchy for " + getPath() ).c_str() ) )
 	{
+		m_locations.clear();
 		return;
 	}
 	
 	doExpandChildren( scene, rootNode, params );
 	setInt( pExpanded.getToken(), 0, 0, 1 );
+	m_locations.clear();
 	
 	if ( params.hierarchy == Parenting && !scene->hasObject() )
 	{
@@ -202,8 +214,88 @@ void OBJ_SceneCacheTransform::expandHierarchy( const SceneInterface *scene )
 	progress->opEnd();
 }
 
+OBJ_SceneCacheTransform::Location::Location()
+	: hasObject( false ), hasChildren( false ), tagged( false ), isStatic( false )
+{
+}
+
+const OBJ_SceneCacheTransform::Location *OBJ_SceneCacheTransform::location( const SceneInterface *scene ) const
+{
+	LocationMap::const_iterator it = m_locations.find( scene );
+	return ( it != m_locations.end() ) ? it->second : 0;
+}
+
+struct OBJ_SceneCacheTransform::GatherChildren
+{
+	GatherChildren( Location &parent, const SceneInterface::NameList &childNames, const UT_StringMMPattern &tagFilter, bool recurse, bool recurseUntagged )
+		: m_parent( parent ), m_childNames( childNames ), m_tagFilter( tagFilter ), m_recurse( recurse ), m_recurseUntagged( recurseUntagged )
+	{
+	}
+	
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for ( size_t i=range.begin(); i != range.end(); ++i )
+		{
+			Location &child = m_parent.children[i];
+			child.scene = m_parent.scene->child( m_childNames[i] );
+			gatherLocation( child, m_tagFilter, m_recurse, m_recurseUntagged );
+		}
+	}
+	
+	private :
+		
+		Location &m_parent;
+		const SceneInterface::NameList &m_childNames;
+		const UT_StringMMPattern &m_tagFilter;
+		bool m_recurse;
+		bool m_recurseUntagged;
+};
+
+void OBJ_SceneCacheTransform::gatherChildren( Location &parent, const UT_StringMMPattern &tagFilter, bool recurse, bool recurseUntagged )
+{
+	SceneInterface::NameList childNames;
+	parent.scene->childNames( childNames );
+	parent.hasChildren = !childNames.empty();
+	parent.children.resize( childNames.size() );
+	
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, childNames.size() ), GatherChildren( parent, childNames, tagFilter, recurse, recurseUntagged ) );
+}
+
+void OBJ_SceneCacheTransform::gatherLocation( Location &location, const UT_StringMMPattern &tagFilter, bool recurse, bool recurseUntagged )
+{
+	const SceneInterface *scene = location.scene.get();
+	location.hasObject = scene->hasObject();
+	location.tagged = tagged( scene, tagFilter );
+	
+	const SampledSceneInterface *sampledScene = runTimeCast<const SampledSceneInterface>( scene );
+	location.isStatic = ( sampledScene ) ? ( sampledScene->numTransformSamples() < 2 ) : false;
+	
+	// we don't expand non-tagged children for SubNetwork mode, so there is no need to gather them
+	if ( recurse && ( location.tagged || recurseUntagged ) )
+	{
+		gatherChildren( location, tagFilter, recurse, recurseUntagged );
+	}
+	else
+	{
+		SceneInterface::NameList childNames;
+		scene->childNames( childNames );
+		location.hasChildren = !childNames.empty();
+	}
+}
+
+void OBJ_SceneCacheTransform::indexLocations( const Location &location )
+{
+	m_locations[location.scene.get()] = &location;
+	for ( std::vector<Location>::const_iterator it=location.children.begin(); it != location.children.end(); ++it )
+	{
+		indexLocations( *it );
+	}
+}
+
 OBJ_Node *OBJ_SceneCacheTransform::doExpandObject( const SceneInterface *scene, OP_Network *parent, const Parameters &params )
 {
+	const Location *loc = location( scene );
+	
 	const char *name = ( params.hierarchy == Parenting ) ? scene->name().c_str() : "geo";
 	OP_Node *opNode = parent->createNode( OBJ_SceneCacheGeometry::typeName, name );
 	OBJ_SceneCacheGeometry *geo = reinterpret_cast<OBJ_SceneCacheGeometry*>( opNode );
@@ -212,6 +304,10 @@ OBJ_Node *OBJ_SceneCacheTransform::doExpandObject( const SceneInterface *scene,
 	if ( params.hierarchy == Parenting )
 	{
 		geo->setPath( scene );
+		if ( loc )
+		{
+			geo->setStatic( loc->isStatic );
+		}
 	}
 	else
 	{
@@ -227,7 +323,7 @@ OBJ_Node *OBJ_SceneCacheTransform::doExpandObject( const SceneInterface *scene,
 	geo->setShapeFilter( params.shapeFilter );
 	geo->setFullPathName( params.fullPathName );
 	
-	bool visible = tagged( scene, params.tagFilter );
+	bool visible = ( loc ) ? loc->tagged : tagged( scene, params.tagFilter );
 	if ( visible )
 	{
 		geo->setTagFilter( params.tagFilterStr );
@@ -242,11 +338,17 @@ OBJ_Node *OBJ_SceneCacheTransform::doExpandObject( const SceneInterface *scene,
 
 OBJ_Node *OBJ_SceneCacheTransform::doExpandChild( const SceneInterface *scene, OP_Network *parent, const Parameters &params )
 {
+	const Location *loc = location( scene );
+	
 	OP_Node *opNode = parent->createNode( OBJ_SceneCacheTransform::typeName, scene->name().c_str() );
 	OBJ_SceneCacheTransform *xform = reinterpret_cast<OBJ_SceneCacheTransform*>( opNode );
 	
 	xform->referenceParent( pFile.getToken() );
 	xform->setPath( scene );
+	if ( loc )
+	{
+		xform->setStatic( loc->isStatic );
+	}
 	xform->setSpace( Local );
 	xform->setGeometryType( (OBJ_SceneCacheTransform::GeometryType)params.geometryType );
 	xform->setAttributeFilter( params.attributeFilter );
@@ -256,14 +358,30 @@ OBJ_Node *OBJ_SceneCacheTransform::doExpandChild( const SceneInterface *scene, O
 	xform->setInt( pHierarchy.getToken(), 0, 0, params.hierarchy );
 	xform->setInt( pDepth.getToken(), 0, 0, params.depth );
 	
-	SceneInterface::NameList children;
-	scene->childNames( children );
-	if ( children.empty() && !scene->hasObject() )
+	bool hasChildren = false;
+	bool hasObject = false;
+	bool visible = false;
+	if ( loc )
+	{
+		hasChildren = loc->hasChildren;
+		hasObject = loc->hasObject;
+		visible = loc->tagged;
+	}
+	else
+	{
+		SceneInterface::NameList children;
+		scene->childNames( children );
+		hasChildren = !children.empty();
+		hasObject = scene->hasObject();
+		visible = tagged( scene, params.tagFilter );
+	}
+	
+	if ( !hasChildren && !hasObject )
 	{
 		xform->setInt( pExpanded.getToken(), 0, 0, 1 );
 	}
 	
-	if ( tagged( scene, params.tagFilter ) )
+	if ( visible )
 	{
 		xform->setTagFilter( params.tagFilterStr );
 	}
@@ -295,34 +413,51 @@ void OBJ_SceneCacheTransform::doExpandChildren( const SceneInterface *scene, OP_
 		parent = parent->getParent();
 	}
 	
-	SceneInterface::NameList children;
-	scene->childNames( children );
-	for ( SceneInterface::NameList::const_iterator it=children.begin(); it != children.end(); ++it )
+	// use the locations gathered by expandHierarchy() if we have them,
+	// falling back to querying the scene directly otherwise.
+	std::vector<Location> queriedChildren;
+	const Location *loc = location( scene );
+	if ( !loc )
+	{
+		SceneInterface::NameList childNames;
+		scene->childNames( childNames );
+		queriedChildren.resize( childNames.size() );
+		for ( size_t i=0; i < childNames.size(); ++i )
+		{
+			Location &childLocation = queriedChildren[i];
+			childLocation.scene = scene->child( childNames[i] );
+			childLocation.hasObject = childLocation.scene->hasObject();
+			childLocation.tagged = tagged( childLocation.scene.get(), params.tagFilter );
+		}
+	}
+	
+	const std::vector<Location> &children = ( loc ) ? loc->children : queriedChildren;
+	for ( std::vector<Location>::const_iterator it=children.begin(); it != children.end(); ++it )
 	{
-		ConstSceneInterfacePtr child = scene->child( *it );
+		const SceneInterface *child = it->scene.get();
 		
 		OBJ_Node *childNode = 0;
 		if ( params.hierarchy == SubNetworks )
 		{
-			childNode = doExpandChild( child.get(), parent, params );
-			if ( params.depth == AllDescendants && child->hasObject() && tagged( child.get(), params.tagFilter ) )
+			childNode = doExpandChild( child, parent, params );
+			if ( params.depth == AllDescendants && it->hasObject && it->tagged )
 			{
 				Parameters childParams( params );
 				childParams.depth = Children;
-				doExpandObject( child.get(), childNode, childParams );
+				doExpandObject( child, childNode, childParams );
 			}
 		}
 		else if ( params.hierarchy == Parenting )
 		{
-			if ( child->hasObject() )
+			if ( it->hasObject )
 			{
 				Parameters childParams( params );
 				childParams.depth = Children;
-				childNode = doExpandObject( child.get(), parent, childParams );
+				childNode = doExpandObject( child, parent, childParams );
 			}
 			else
 			{
-				childNode = doExpandChild( child.get(), parent, params );
+				childNode = doExpandChild( child, parent, params );
 			}
 			
 			childNode->setInput( 0, inputNode );
@@ -330,7 +465,7 @@ void OBJ_SceneCacheTransform::doExpandChildren( const SceneInterface *scene, OP_
 		
 		if ( params.depth == AllDescendants )
 		{
-			if ( params.hierarchy == SubNetworks && !tagged( child.get(), params.tagFilter ) )
+			if ( params.hierarchy == SubNetworks && !it->tagged )
 			{
 				// we don't expand non-tagged children for SubNetwork mode, but we
 				// do for Parenting mode, because otherwise the hierarchy would be
@@ -338,7 +473,7 @@ void OBJ_SceneCacheTransform::doExpandChildren( const SceneInterface *scene, OP_
 				continue;
 			}
 			
-			doExpandChildren( child.get(), childNode, params );
+			doExpandChildren( child, childNode, params );
 			childNode->setInt( pExpanded.getToken(), 0, 0, 1 );
 		}
 	}
@@ -39,6 +39,8 @@
 #include "UT/UT_StringMMPattern.h"
 #include "UT/UT_WorkArgs.h"
 
+#include "tbb/parallel_for.h"
+
 #include "IECore/CoordinateSystem.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/Group.h"
@@ -303,104 +305,93 @@ OP_ERROR SOP_SceneCacheSource::cookMySop( OP_Context &context )
 	return error();
 }
 
-void SOP_SceneCacheSource::loadObjects( const IECore::SceneInterface *scene, Imath::M44d transform, double time, Space space, Parameters &params, size_t rootSize )
+struct SOP_SceneCacheSource::LoadLocations
 {
-	UT_Interrupt *progress = UTgetInterrupt();
-	progress->setLongOpText( ( "Loading " + scene->name().string() ).c_str() );
-	if ( progress->opInterrupt() )
+	LoadLocations( SOP_SceneCacheSource *node, std::vector<Location> &locations, const Parameters &params, double time, Space space )
+		:	m_node( node ), m_locations( locations ), m_params( params ), m_time( time ), m_space( space )
 	{
-		return;
 	}
 	
-	if ( scene->hasObject() && UT_String( scene->name() ).multiMatch( params.shapeFilter ) && tagged( scene, params.tagFilter ) )
+	void operator()( const tbb::blocked_range<size_t> &range ) const
 	{
-		std::string name = relativePath( scene, rootSize );
-		
-		Imath::M44d currentTransform;
-		if ( space == Local )
-		{
-			currentTransform = scene->readTransformAsMatrix( time );
-		}
-		else if ( space != Object )
+		for ( size_t i = range.begin(); i != range.end(); ++i )
 		{
-			currentTransform = transform;
+			m_node->loadLocation( m_locations[i], m_params, m_time, m_space );
 		}
-		
-		ConstObjectPtr object = 0;
-		if ( params.geometryType == BoundingBox )
-		{
-			Imath::Box3d bound = scene->readBound( time );
-			object = MeshPrimitive::createBox( Imath::Box3f( bound.min, bound.max ) );
-			
-			params.hasAnimatedTopology = false;
-			params.hasAnimatedPrimVars = true;
-			params.animatedPrimVars.clear();
-			params.animatedPrimVars.push_back( "P" );
-		}
-		else if ( params.geometryType == PointCloud )
-		{
-			std::vector<Imath::V3f> point( 1, scene->readBound( time ).center() );
-			PointsPrimitivePtr points = new PointsPrimitive( new V3fVectorData( point ) );
-			std::vector<Imath::V3f> basis1( 1, Imath::V3f( currentTransform[0][0], currentTransform[0][1], currentTransform[0][2] ) );
-			std::vector<Imath::V3f> basis2( 1, Imath::V3f( currentTransform[1][0], currentTransform[1][1], currentTransform[1][2] ) );
-			std::vector<Imath::V3f> basis3( 1, Imath::V3f( currentTransform[2][0], currentTransform[2][1], currentTransform[2][2] ) );
-			points->variables["basis1"] = PrimitiveVariable( PrimitiveVariable::Vertex, new V3fVectorData( basis1 ) );
-			points->variables["basis2"] = PrimitiveVariable( PrimitiveVariable::Vertex, new V3fVectorData( basis2 ) );
-			points->variables["basis3"] = PrimitiveVariable( PrimitiveVariable::Vertex, new V3fVectorData( basis3 ) );
-			
-			params.hasAnimatedTopology = false;
-			params.hasAnimatedPrimVars = true;
-			params.animatedPrimVars.clear();
-			params.animatedPrimVars.push_back( "P" );
-			params.animatedPrimVars.push_back( "basis1" );
-			params.animatedPrimVars.push_back( "basis2" );
-			params.animatedPrimVars.push_back( "basis3" );
-			
-			object = points;
-		}
-		else
-		{
-			object = scene->readObject( time );
-			
-			params.hasAnimatedTopology = scene->hasAttribute( SceneCache::animatedObjectTopologyAttribute );
-			params.hasAnimatedPrimVars = scene->hasAttribute( SceneCache::animatedObjectPrimVarsAttribute );
-			if ( params.hasAnimatedPrimVars )
-			{
-				const ConstObjectPtr animatedPrimVarObj = scene->readAttribute( SceneCache::animatedObjectPrimVarsAttribute, 0 );
-				const InternedStringVectorData *animatedPrimVarData = IECore::runTimeCast<const InternedStringVectorData>( animatedPrimVarObj.get() );
-				if ( animatedPrimVarData )
-				{
-					const std::vector<InternedString> &values = animatedPrimVarData->readable();
-					params.animatedPrimVars.clear();
-					params.animatedPrimVars.resize( values.size() );
-					std::copy( values.begin(), values.end(), params.animatedPrimVars.begin() );
-				}
-			}
-		}
-		
-		// modify the object if necessary
-		object = modifyObject( object.get(), params );
-		
-		// transform the object unless its an identity
-		if ( currentTransform != Imath::M44d() )
+	}
+	
+	private :
+	
+		SOP_SceneCacheSource *m_node;
+		std::vector<Location> &m_locations;
+		const Parameters &m_params;
+		double m_time;
+		Space m_space;
+};
+
+void SOP_SceneCacheSource::loadObjects( const IECore::SceneInterface *scene, Imath::M44d transform, double time, Space space, Parameters &params, size_t rootSize )
+{
+	std::vector<Location> locations;
+	if ( !gatherLocations( scene, transform, params, time, space, rootSize, locations ) )
+	{
+		return;
+	}
+	
+	// reading, modifying and transforming the objects is independent for each
+	// location, so we do it in parallel. only the conversion into the gdp must
+	// be serialised.
+	UT_Interrupt *progress = UTgetInterrupt();
+	progress->setLongOpText( ( "Reading " + scene->name().string() ).c_str() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, locations.size() ), LoadLocations( this, locations, params, time, space ) );
+	
+	for ( std::vector<Location>::iterator it = locations.begin(); it != locations.end(); ++it )
+	{
+		progress->setLongOpText( ( "Converting " + it->scene->name().string() ).c_str() );
+		if ( progress->opInterrupt() )
 		{
-			object = transformObject( object.get(), currentTransform, params );
+			return;
 		}
 		
-		// convert the object to Houdini
-		if ( !convertObject( object.get(), name, scene, params ) )
+		if ( !convertObject( *it, params ) )
 		{
 			std::string fullName;
 			SceneInterface::Path path;
-			scene->path( path );
+			it->scene->path( path );
 			SceneInterface::pathToString( path, fullName );
 			addWarning( SOP_MESSAGE, ( "Could not convert " + fullName + " to Houdini" ).c_str() );
 		}
+		
+		// release the object as soon as it has been converted
+		it->object = 0;
+	}
+}
+
+bool SOP_SceneCacheSource::gatherLocations( const IECore::SceneInterface *scene, Imath::M44d transform, const Parameters &params, double time, Space space, size_t rootSize, std::vector<Location> &locations )
+{
+	UT_Interrupt *progress = UTgetInterrupt();
+	progress->setLongOpText( ( "Loading " + scene->name().string() ).c_str() );
+	if ( progress->opInterrupt() )
+	{
+		return false;
+	}
+	
+	if ( scene->hasObject() && UT_String( scene->name() ).multiMatch( params.shapeFilter ) && tagged( scene, params.tagFilter ) )
+	{
+		Location location;
+		location.scene = scene;
+		location.name = relativePath( scene, rootSize );
+		if ( space != Local && space != Object )
+		{
+			location.transform = transform;
+		}
+		location.hasAnimatedTopology = false;
+		location.hasAnimatedPrimVars = false;
+		locations.push_back( location );
 	}
 	
 	if ( evalInt( pObjectOnly.getToken(), 0, 0 ) )
 	{
-		return;
+		return true;
 	}
 	
 	SceneInterface::NameList children;
@@ -411,12 +402,91 @@ void SOP_SceneCacheSource::loadObjects( const IECore::SceneInterface *scene, Ima
 		ConstSceneInterfacePtr child = scene->child( *it );
 		if ( tagged( child.get(), params.tagFilter ) )
 		{
-			loadObjects( child.get(), child->readTransformAsMatrix( time ) * transform, time, space, params, rootSize );
+			if ( !gatherLocations( child.get(), child->readTransformAsMatrix( time ) * transform, params, time, space, rootSize, locations ) )
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+
+void SOP_SceneCacheSource::loadLocation( Location &location, const Parameters &params, double time, Space space )
+{
+	const SceneInterface *scene = location.scene.get();
+	
+	Imath::M44d currentTransform = location.transform;
+	if ( space == Local )
+	{
+		currentTransform = scene->readTransformAsMatrix( time );
+	}
+	
+	ConstObjectPtr object = 0;
+	if ( params.geometryType == BoundingBox )
+	{
+		Imath::Box3d bound = scene->readBound( time );
+		object = MeshPrimitive::createBox( Imath::Box3f( bound.min, bound.max ) );
+		
+		location.hasAnimatedTopology = false;
+		location.hasAnimatedPrimVars = true;
+		location.animatedPrimVars.clear();
+		location.animatedPrimVars.push_back( "P" );
+	}
+	else if ( params.geometryType == PointCloud )
+	{
+		std::vector<Imath::V3f> point( 1, scene->readBound( time ).center() );
+		PointsPrimitivePtr points = new PointsPrimitive( new V3fVectorData( point ) );
+		std::vector<Imath::V3f> basis1( 1, Imath::V3f( currentTransform[0][0], currentTransform[0][1], currentTransform[0][2] ) );
+		std::vector<Imath::V3f> basis2( 1, Imath::V3f( currentTransform[1][0], currentTransform[1][1], currentTransform[1][2] ) );
+		std::vector<Imath::V3f> basis3( 1, Imath::V3f( currentTransform[2][0], currentTransform[2][1], currentTransform[2][2] ) );
+		points->variables["basis1"] = PrimitiveVariable( PrimitiveVariable::Vertex, new V3fVectorData( basis1 ) );
+		points->variables["basis2"] = PrimitiveVariable( PrimitiveVariable::Vertex, new V3fVectorData( basis2 ) );
+		points->variables["basis3"] = PrimitiveVariable( PrimitiveVariable::Vertex, new V3fVectorData( basis3 ) );
+		
+		location.hasAnimatedTopology = false;
+		location.hasAnimatedPrimVars = true;
+		location.animatedPrimVars.clear();
+		location.animatedPrimVars.push_back( "P" );
+		location.animatedPrimVars.push_back( "basis1" );
+		location.animatedPrimVars.push_back( "basis2" );
+		location.animatedPrimVars.push_back( "basis3" );
+		
+		object = points;
+	}
+	else
+	{
+		object = scene->readObject( time );
+		
+		location.hasAnimatedTopology = scene->hasAttribute( SceneCache::animatedObjectTopologyAttribute );
+		location.hasAnimatedPrimVars = scene->hasAttribute( SceneCache::animatedObjectPrimVarsAttribute );
+		if ( location.hasAnimatedPrimVars )
+		{
+			const ConstObjectPtr animatedPrimVarObj = scene->readAttribute( SceneCache::animatedObjectPrimVarsAttribute, 0 );
+			const InternedStringVectorData *animatedPrimVarData = IECore::runTimeCast<const InternedStringVectorData>( animatedPrimVarObj.get() );
+			if ( animatedPrimVarData )
+			{
+				const std::vector<InternedString> &values = animatedPrimVarData->readable();
+				location.animatedPrimVars.clear();
+				location.animatedPrimVars.resize( values.size() );
+				std::copy( values.begin(), values.end(), location.animatedPrimVars.begin() );
+			}
 		}
 	}
+	
+	// modify the object if necessary
+	object = modifyObject( object.get(), params );
+	
+	// transform the object unless its an identity
+	if ( currentTransform != Imath::M44d() )
+	{
+		object = transformObject( object.get(), currentTransform, location );
+	}
+	
+	location.object = object;
 }
 
-ConstObjectPtr SOP_SceneCacheSource::modifyObject( const IECore::Object *object, Parameters &params )
+ConstObjectPtr SOP_SceneCacheSource::modifyObject( const IECore::Object *object, const Parameters &params )
 {
 	ConstObjectPtr result = object;
 	
@@ -471,7 +541,7 @@ SOP_SceneCacheSource::TransformGeometricData::ReturnType SOP_SceneCacheSource::T
 	return ( interp == GeometricData::Point || interp == GeometricData::Normal || interp == GeometricData::Vector );
 }
 
-ConstObjectPtr SOP_SceneCacheSource::transformObject( const IECore::Object *object, const Imath::M44d &transform, Parameters &params )
+ConstObjectPtr SOP_SceneCacheSource::transformObject( const IECore::Object *object, const Imath::M44d &transform, Location &location )
 {
 	if ( const Primitive *primitive = IECore::runTimeCast<const Primitive>( object ) )
 	{
@@ -497,10 +567,10 @@ ConstObjectPtr SOP_SceneCacheSource::transformObject( const IECore::Object *obje
 				primVars.push_back( it->first );
 				
 				// add the transforming prim vars to the animated list
-				if ( std::find( params.animatedPrimVars.begin(), params.animatedPrimVars.end(), it->first ) == params.animatedPrimVars.end() )
+				if ( std::find( location.animatedPrimVars.begin(), location.animatedPrimVars.end(), it->first ) == location.animatedPrimVars.end() )
 				{
-					params.animatedPrimVars.push_back( it->first );
-					params.hasAnimatedPrimVars = true;
+					location.animatedPrimVars.push_back( it->first );
+					location.hasAnimatedPrimVars = true;
 				}
 			}
 		}
@@ -533,8 +603,13 @@ ConstObjectPtr SOP_SceneCacheSource::transformObject( const IECore::Object *obje
 	return object;
 }
 
-bool SOP_SceneCacheSource::convertObject( const IECore::Object *object, const std::string &name, const SceneInterface *scene, Parameters &params )
+bool SOP_SceneCacheSource::convertObject( const Location &location, Parameters &params )
 {
+	const IECore::Object *object = location.object.get();
+	const std::string &name = location.name;
+	const SceneInterface *scene = location.scene.get();
+	
+
 	ToHoudiniGeometryConverterPtr converter = 0;
 	if ( params.geometryType == Cortex )
 	{
@@ -568,10 +643,10 @@ bool SOP_SceneCacheSource::convertObject( const IECore::Object *object, const st
 	{
 		GA_Range primRange = rIt->second;
 		const Primitive *primitive = IECore::runTimeCast<const Primitive>( object );
-		if ( primitive && !params.hasAnimatedTopology && params.hasAnimatedPrimVars )
+		if ( primitive && !location.hasAnimatedTopology && location.hasAnimatedPrimVars )
 		{
 			// this means constant topology and primitive variables, even though multiple samples were written
-			if ( params.animatedPrimVars.empty() )
+			if ( location.animatedPrimVars.empty() )
 			{
 				return true;
 			}
@@ -580,7 +655,7 @@ bool SOP_SceneCacheSource::convertObject( const IECore::Object *object, const st
 			
 			// update the animated primitive variables only
 			std::string animatedPrimVarStr = "";
-			for ( std::vector<InternedString>::const_iterator it = params.animatedPrimVars.begin(); it != params.animatedPrimVars.end(); ++it )
+			for ( std::vector<InternedString>::const_iterator it = location.animatedPrimVars.begin(); it != location.animatedPrimVars.end(); ++it )
 			{
 				animatedPrimVarStr += it->string() + " ";
 			}
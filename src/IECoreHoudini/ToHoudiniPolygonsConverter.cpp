@@ -33,6 +33,11 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "GU/GU_PrimPoly.h"
+#include "UT/UT_Version.h"
+
+#if UT_MAJOR_VERSION_INT >= 14
+#include "GEO/GEO_PolyCounts.h"
+#endif
 
 #include "IECoreHoudini/ToHoudiniPolygonsConverter.h"
 #include "IECoreHoudini/ToHoudiniStringAttribConverter.h"
@@ -67,6 +72,40 @@ bool ToHoudiniPolygonsConverter::doConversion( const Object *object, GU_Detail *
 		return false;
 	}
 	
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	
+#if UT_MAJOR_VERSION_INT >= 14
+
+	// build all the polygons in a single block, which is much faster than
+	// building them one at a time. houdini winds polygons in the opposite
+	// direction to cortex, so the vertex order of each face is reversed.
+	GEO_PolyCounts polyCounts;
+	std::vector<int> polyPointNumbers;
+	polyPointNumbers.reserve( vertexIds.size() );
+	
+	size_t vertCount = 0;
+	for ( size_t f=0; f < verticesPerFace.size(); f++ )
+	{
+		polyCounts.append( verticesPerFace[f] );
+		for ( size_t v=0; v < (size_t)verticesPerFace[f]; v++ )
+		{
+			polyPointNumbers.push_back( vertexIds[ vertCount + verticesPerFace[f] - 1 - v ] );
+		}
+		
+		vertCount += verticesPerFace[f];
+	}
+	
+	GA_Range newPrims;
+	if ( verticesPerFace.size() )
+	{
+		GA_Offset firstPoint = GA_Iterator( newPoints ).getOffset();
+		GA_Offset firstPrim = GU_PrimPoly::buildBlock( geo, firstPoint, newPoints.getEntries(), polyCounts, &polyPointNumbers[0] );
+		newPrims = GA_Range( geo->getPrimitiveMap(), firstPrim, firstPrim + verticesPerFace.size() );
+	}
+
+#else
+
 	GA_OffsetList pointOffsets;
 	pointOffsets.reserve( newPoints.getEntries() );
 	for ( GA_Iterator it=newPoints.begin(); !it.atEnd(); ++it )
@@ -74,9 +113,6 @@ bool ToHoudiniPolygonsConverter::doConversion( const Object *object, GU_Detail *
 		pointOffsets.append( it.getOffset() );
 	}
 	
-	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
-	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
-	
 	GA_OffsetList offsets;
 	offsets.reserve( verticesPerFace.size() );
 	
@@ -96,6 +132,9 @@ bool ToHoudiniPolygonsConverter::doConversion( const Object *object, GU_Detail *
 	}
 	
 	GA_Range newPrims( geo->getPrimitiveMap(), offsets );
+
+#endif
+
 	transferAttribs( geo, newPoints, newPrims );
 	
 	// add the interpolation type
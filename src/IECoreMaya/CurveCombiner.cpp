@@ -35,7 +35,7 @@
 #include "maya/MFnTypedAttribute.h"
 #include "maya/MFnPluginData.h"
 
-#include "IECore/CurvesMergeOp.h"
+#include "IECore/CurvesAlgo.h"
 
 #include "IECoreMaya/CurveCombiner.h"
 #include "IECoreMaya/MayaTypeIds.h"
@@ -99,12 +99,15 @@ MStatus CurveCombiner::compute( const MPlug &plug, MDataBlock &dataBlock )
 	{
 	
 		MArrayDataHandle arrayHandle = dataBlock.inputArrayValue( aInputCurves );
-		IECore::CurvesPrimitivePtr combinedCurves = 0;
-		
-		IECore::CurvesMergeOpPtr curvesMergeOp = new IECore::CurvesMergeOp();
-		curvesMergeOp->copyParameter()->setTypedValue( false );
-		
+
+		// the conversions use the Maya API so must be done serially here, but
+		// we then merge everything in a single pass rather than growing the
+		// result one curve at a time.
+		std::vector<IECore::ConstCurvesPrimitivePtr> cortexCurves;
+		std::vector<const IECore::CurvesPrimitive *> cortexCurvesRaw;
+
 		unsigned numCurves = arrayHandle.elementCount();
+		cortexCurves.reserve( numCurves );
 		for( unsigned curveIndex = 0; curveIndex < numCurves; curveIndex++, arrayHandle.next() )
 		{
 			MObject curve = arrayHandle.inputValue().asNurbsCurve();
@@ -112,23 +115,12 @@ MStatus CurveCombiner::compute( const MPlug &plug, MDataBlock &dataBlock )
 			// we want worldspace points if a worldShape is connected, and local otherwise
 			converter->spaceParameter()->setNumericValue( FromMayaShapeConverter::World );
 			IECore::CurvesPrimitivePtr cortexCurve = boost::static_pointer_cast<IECore::CurvesPrimitive>( converter->convert() );
-			
-			if( !combinedCurves )
-			{
-				combinedCurves = cortexCurve;
-				curvesMergeOp->inputParameter()->setValue( combinedCurves );
-			}
-			else
-			{
-				curvesMergeOp->curvesParameter()->setValue( cortexCurve );
-				curvesMergeOp->operate();
-			}
-		}
-		
-		if( !combinedCurves )
-		{
-			combinedCurves = new IECore::CurvesPrimitive();
+
+			cortexCurves.push_back( cortexCurve );
+			cortexCurvesRaw.push_back( cortexCurve.get() );
 		}
+
+		IECore::CurvesPrimitivePtr combinedCurves = IECore::CurvesAlgo::mergeCurves( cortexCurvesRaw );
 		
 		MFnPluginData fnD;
 		MObject data = fnD.create( IECoreMaya::ObjectData::id );
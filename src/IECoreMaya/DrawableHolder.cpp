@@ -37,6 +37,7 @@
 #include "IECore/SimpleTypedData.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/MessageHandler.h"
+#include "IECore/LRUCache.h"
 
 #include "IECorePython/ScopedGILLock.h"
 
@@ -50,9 +51,34 @@
 
 #include "maya/MFnNumericAttribute.h"
 #include "maya/MFnNumericData.h"
+#include "maya/MAnimControl.h"
 
 using namespace IECoreMaya;
 
+namespace
+{
+
+// Scenes are cached per DrawableHolder, keyed by node, class, parameter values and time.
+// As in ProceduralHolder, they aren't shared between nodes, so that nothing done to the
+// scene of one node can affect another.
+// IECoreGL scenes don't report their memory usage, so the cost of each is one, and
+// the cache is bounded by the number of scenes it holds.
+typedef IECore::LRUCache<IECore::MurmurHash, IECoreGL::ScenePtr> SceneCache;
+
+IECoreGL::ScenePtr nullSceneGetter( const IECore::MurmurHash &key, size_t &cost )
+{
+	cost = 0;
+	return 0;
+}
+
+SceneCache &sceneCache()
+{
+	static SceneCache c( nullSceneGetter, 50 );
+	return c;
+}
+
+} // namespace
+
 const MTypeId DrawableHolder::id = DrawableHolderId;
 const MString DrawableHolder::typeName = "ieDrawable";
 
@@ -131,6 +157,29 @@ IECoreGL::ConstScenePtr DrawableHolder::scene()
 	if( drawableInterface )
 	{
 		setParameterisedValues();
+		
+		std::string className;
+		int classVersion = 0;
+		getParameterised( &className, &classVersion );
+		
+		IECore::MurmurHash key;
+		key.append( (uint64_t)this );
+		key.append( className );
+		key.append( classVersion );
+		drawableInterface->parameters()->getValue()->hash( key );
+		// drawables are free to query the maya time directly
+		key.append( MAnimControl::currentTime().as( MTime::kSeconds ) );
+		
+		SceneCache &cache = sceneCache();
+		if( cache.cached( key ) )
+		{
+			m_scene = cache.get( key );
+			if( m_scene )
+			{
+				return m_scene;
+			}
+		}
+		
 		try
 		{
 			IECoreGL::RendererPtr renderer = new IECoreGL::Renderer;
@@ -148,6 +197,7 @@ IECoreGL::ConstScenePtr DrawableHolder::scene()
 			m_scene = renderer->scene();
 			m_scene->setCamera( 0 );
 			
+			cache.set( key, m_scene, 1 );
 		}
 		catch( boost::python::error_already_set )
 		{
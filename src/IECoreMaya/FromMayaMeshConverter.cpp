@@ -48,6 +48,10 @@
 #include "maya/MFnMesh.h"
 #include "maya/MFnAttribute.h"
 #include "maya/MString.h"
+#include "maya/MFloatVectorArray.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 #include <algorithm>
 
@@ -58,6 +62,57 @@ using namespace Imath;
 
 IE_CORE_DEFINERUNTIMETYPED( FromMayaMeshConverter );
 
+namespace
+{
+
+// The MFnMesh bulk getters must be called on the main thread, but the
+// per face-vertex gathers from the arrays they return are done in parallel.
+
+struct GatherNormals
+{
+	GatherNormals( const float *normals, const MIntArray &normalIds, vector<V3f> &result )
+		:	m_normals( normals ), m_normalIds( normalIds ), m_result( result )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			const float *n = m_normals + 3 * m_normalIds[i];
+			m_result[i] = V3f( n[0], n[1], n[2] );
+		}
+	}
+
+	const float *m_normals;
+	const MIntArray &m_normalIds;
+	vector<V3f> &m_result;
+};
+
+struct GatherUVs
+{
+	GatherUVs( const MFloatArray &values, const vector<int> &indices, bool flip, vector<float> &result )
+		:	m_values( values ), m_indices( indices ), m_flip( flip ), m_result( result )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			const float value = m_values[ m_indices[i] ];
+			m_result[i] = m_flip ? 1 - value : value;
+		}
+	}
+
+	const MFloatArray &m_values;
+	const vector<int> &m_indices;
+	bool m_flip;
+	vector<float> &m_result;
+};
+
+} // namespace
+
 FromMayaShapeConverter::Description<FromMayaMeshConverter> FromMayaMeshConverter::m_description( MFn::kMesh, MeshPrimitiveTypeId, true );
 FromMayaShapeConverter::Description<FromMayaMeshConverter> FromMayaMeshConverter::m_dataDescription( MFn::kMeshData, MeshPrimitiveTypeId, true );
 
@@ -315,44 +370,25 @@ IECore::V3fVectorDataPtr FromMayaMeshConverter::normals() const
 	V3fVectorDataPtr normalsData = new V3fVectorData;
 	normalsData->setInterpretation( GeometricData::Normal );
 	vector<V3f> &normals = normalsData->writable();
-	normals.reserve( fnMesh.numFaceVertices() );
 	
-	int numPolygons = fnMesh.numPolygons();
-	V3f blankVector;
+	MIntArray normalCounts, normalIds;
+	fnMesh.getNormalIds( normalCounts, normalIds );
+	normals.resize( normalIds.length() );
 	
 	if( space() == MSpace::kObject )
 	{
 		const float* rawNormals = fnMesh.getRawNormals(0);
-		MIntArray normalIds;
-		for( int i=0; i<numPolygons; i++ )
-		{
-			fnMesh.getFaceNormalIds( i, normalIds );
-			for( unsigned j=0; j < normalIds.length(); ++j )
-			{
-				const float* normalIt = rawNormals + 3 * normalIds[j];
-				normals.push_back( blankVector );
-				V3f& nn = normals.back();
-				nn.x = *normalIt++;
-				nn.y = *normalIt++;
-				nn.z = *normalIt;
-			}
-		}
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, normals.size() ), GatherNormals( rawNormals, normalIds, normals ) );
 	}
 	else
 	{
-		MFloatVectorArray faceNormals;
-		for( int i=0; i<numPolygons; i++ )
+		MFloatVectorArray mNormals;
+		fnMesh.getNormals( mNormals, space() );
+		vector<V3f> spaceNormals( mNormals.length() );
+		std::transform( MArrayIter<MFloatVectorArray>::begin( mNormals ), MArrayIter<MFloatVectorArray>::end( mNormals ), spaceNormals.begin(), VecConvert<MFloatVector, V3f>() );
+		if( spaceNormals.size() )
 		{
-			fnMesh.getFaceVertexNormals( i, faceNormals, space() );
-			for( unsigned j=0; j<faceNormals.length(); j++ )
-			{
-				MFloatVector& n = faceNormals[j];
-				normals.push_back( blankVector );
-				V3f& nn = normals.back();
-				nn.x = n.x;
-				nn.y = n.y;
-				nn.z = n.z;
-			}
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, normals.size() ), GatherNormals( spaceNormals[0].getValue(), normalIds, normals ) );
 		}
 	}
 	
@@ -385,20 +421,14 @@ void FromMayaMeshConverter::sAndT( const MString &uvSet, IECore::ConstIntVectorD
 		if( s )
 		{
 			vector< float >& sValues = s->writable();
-			sValues.reserve( numIndices );
-			for( size_t i=0; i < numIndices; ++i )
-			{
-				sValues.push_back( uArray[ stIndices[i] ] );
-			}
+			sValues.resize( numIndices );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, numIndices ), GatherUVs( uArray, stIndices, false, sValues ) );
 		}
 		if( t )
 		{
 			vector< float >& tValues = t->writable();
-			tValues.reserve( numIndices );
-			for( size_t i=0; i < numIndices; ++i )
-			{
-				tValues.push_back( 1 - vArray[ stIndices[i] ] );
-			}
+			tValues.resize( numIndices );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, numIndices ), GatherUVs( vArray, stIndices, true, tValues ) );
 		}
 	}
 	
@@ -430,15 +460,11 @@ IECore::IntVectorDataPtr FromMayaMeshConverter::stIndices( const MString &uvSet
 	MFnMesh fnMesh( object() );
 	
 	// get face vertex counts:
-	int numPolygons = fnMesh.numPolygons();
+	MIntArray vertexCounts, polygonVertices;
+	fnMesh.getVertices( vertexCounts, polygonVertices );
 	IntVectorDataPtr verticesPerFaceData = new IntVectorData;
-	verticesPerFaceData->writable().resize( numPolygons );
-	vector<int>::iterator verticesPerFaceIt = verticesPerFaceData->writable().begin();
-	
-	for( int i=0; i<numPolygons; i++ )
-	{
-		*verticesPerFaceIt++ = fnMesh.polygonVertexCount( i );
-	}
+	verticesPerFaceData->writable().resize( vertexCounts.length() );
+	copy( MArrayIter<MIntArray>::begin( vertexCounts ), MArrayIter<MIntArray>::end( vertexCounts ), verticesPerFaceData->writable().begin() );
 	
 	return getStIndices( uvSet, verticesPerFaceData );
 }
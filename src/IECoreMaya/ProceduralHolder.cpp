@@ -34,6 +34,11 @@
 
 #include <boost/python.hpp>
 
+#include "boost/bind.hpp"
+
+#include "tbb/atomic.h"
+#include "tbb/task_group.h"
+
 #include "OpenEXR/ImathMatrixAlgo.h"
 #include "OpenEXR/ImathBoxAlgo.h"
 
@@ -61,6 +66,7 @@
 #include "IECore/SimpleTypedData.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/AngleConversion.h"
+#include "IECore/LRUCache.h"
 
 #include "maya/MFnNumericAttribute.h"
 #include "maya/MFnTypedAttribute.h"
@@ -74,6 +80,8 @@
 #include "maya/MFnStringData.h"
 #include "maya/MPlugArray.h"
 #include "maya/MObjectArray.h"
+#include "maya/MAnimControl.h"
+#include "maya/MGlobal.h"
 
 using namespace Imath;
 using namespace IECore;
@@ -114,14 +122,180 @@ MObject ProceduralHolder::aComponentBoundCenterX;
 MObject ProceduralHolder::aComponentBoundCenterY;
 MObject ProceduralHolder::aComponentBoundCenterZ;
 
+//////////////////////////////////////////////////////////////////////////
+// Scene cache and background expansion
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Scenes are cached per ProceduralHolder, keyed by ProceduralHolder::sceneKey(). They
+// can't be shared between nodes, because ProceduralHolderUI modifies the groups of a
+// node's scene to hilite its selected components.
+// IECoreGL scenes don't report their memory usage, so the cost of each is one, and
+// the cache is bounded by the number of scenes it holds.
+typedef LRUCache<MurmurHash, IECoreGL::ScenePtr> SceneCache;
+
+IECoreGL::ScenePtr nullSceneGetter( const MurmurHash &key, size_t &cost )
+{
+	cost = 0;
+	return 0;
+}
+
+SceneCache &sceneCache()
+{
+	static SceneCache c( nullSceneGetter, 50 );
+	return c;
+}
+
+IECoreGL::ScenePtr cachedScene( const MurmurHash &key )
+{
+	SceneCache &c = sceneCache();
+	if( !c.cached( key ) )
+	{
+		return 0;
+	}
+	return c.get( key );
+}
+
+bool canRerender( ParameterisedProcedural *procedural )
+{
+	IECorePython::ScopedGILLock gilLock;
+	boost::python::object pythonProcedural( ParameterisedProceduralPtr( procedural ) );
+	return PyObject_HasAttrString( pythonProcedural.ptr(), "willRerender" );
+}
+
+IECoreGL::RendererPtr renderProcedural( ParameterisedProcedural *procedural, bool drawCoordinateSystems )
+{
+	IECoreGL::RendererPtr renderer = new IECoreGL::Renderer();
+	renderer->setOption( "gl:mode", new StringData( "deferred" ) );
+	renderer->setOption( "gl:drawCoordinateSystems", new BoolData( drawCoordinateSystems ) );
+	renderer->worldBegin();
+
+		// using the form with many arguments so that we can customise
+		// rendering. in particular it's very important that the geometry
+		// is rendered immediately and not deferred in a procedural. if it
+		// were deferred then that procedural might end up being called on
+		// another thread, and then try to get the GIL - this results in deadlock
+		// as sometimes (but not always) maya holds the GIL on the thread calling
+		// scene(). it's ok if the procedural spawns more procedurals because at
+		// that point we release the GIL ourselves in the bindings.
+		procedural->render(
+			renderer.get(),
+			false, // we don't need an attribute block
+			true, // we do want doRenderState() called
+			true, // we do want geometry (doRender)
+			true  // we want geometry rendered immediately (not deferred in a procedural call)
+		);
+
+	renderer->worldEnd();
+
+	renderer->scene()->setCamera( 0 );
+	
+	return renderer;
+}
+
+} // namespace
+
+class ProceduralHolder::SceneBuilder : public RefCounted
+{
+
+	public :
+
+		SceneBuilder( ParameterisedProceduralPtr procedural, bool drawCoordinateSystems, const MurmurHash &key, unsigned generation )
+			:	m_procedural( procedural ), m_drawCoordinateSystems( drawCoordinateSystems ), m_key( key ), m_generation( generation )
+		{
+			m_done = false;
+			m_tasks.run( boost::bind( &SceneBuilder::build, this ) );
+		}
+
+		virtual ~SceneBuilder()
+		{
+			wait();
+		}
+
+		bool done() const
+		{
+			return m_done;
+		}
+
+		/// Waits for the expansion to complete and returns the scene,
+		/// or 0 if the procedural threw.
+		IECoreGL::ScenePtr wait()
+		{
+			if( !m_done )
+			{
+				// the expansion needs the GIL, and we may or may not be holding it.
+				// acquiring it first makes it safe to release it unconditionally.
+				IECorePython::ScopedGILLock gilLock;
+				IECorePython::ScopedGILRelease gilRelease;
+				m_tasks.wait();
+			}
+			return m_scene;
+		}
+
+		const MurmurHash &key() const
+		{
+			return m_key;
+		}
+
+		unsigned generation() const
+		{
+			return m_generation;
+		}
+
+	private :
+
+		void build()
+		{
+			try
+			{
+				m_scene = renderProcedural( m_procedural.get(), m_drawCoordinateSystems )->scene();
+			}
+			catch( boost::python::error_already_set )
+			{
+				IECorePython::ScopedGILLock gilLock;
+				PyErr_Print();
+			}
+			catch( const std::exception &e )
+			{
+				msg( Msg::Error, "ProceduralHolder::SceneBuilder", e.what() );
+			}
+			catch( ... )
+			{
+				msg( Msg::Error, "ProceduralHolder::SceneBuilder", "Caught unknown exception" );
+			}
+
+			m_done = true;
+			// we can't touch the viewport from this thread, so ask maya to redraw once it's idle
+			MGlobal::executeCommandOnIdle( "refresh" );
+		}
+
+		ParameterisedProceduralPtr m_procedural;
+		bool m_drawCoordinateSystems;
+		MurmurHash m_key;
+		unsigned m_generation;
+
+		tbb::task_group m_tasks;
+		tbb::atomic<bool> m_done;
+		IECoreGL::ScenePtr m_scene;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// ProceduralHolder
+//////////////////////////////////////////////////////////////////////////
+
 
 ProceduralHolder::ProceduralHolder()
-	:	m_boundDirty( true ), m_sceneDirty( true ), m_lastRenderer( 0 )
+	:	m_boundDirty( true ), m_sceneDirty( true ), m_lastRenderer( 0 ), m_sceneGeneration( 0 )
 {
 }
 
 ProceduralHolder::~ProceduralHolder()
 {
+	// the SceneBuilder destructor waits for the expansion to complete
+	m_sceneBuilder = 0;
 }
 
 void ProceduralHolder::postConstructor()
@@ -395,6 +569,9 @@ MBoundingBox ProceduralHolder::boundingBox() const
 
 	m_bound = MBoundingBox( MPoint( -1, -1, -1 ), MPoint( 1, 1, 1 ) );
 
+	// the background expansion may be reading the parameter values we're about to set
+	const_cast<ProceduralHolder*>(this)->waitForSceneBuilder();
+
 	ParameterisedProceduralPtr p = const_cast<ProceduralHolder*>(this)->getProcedural();
 	if( p )
 	{
@@ -449,6 +626,7 @@ MStatus ProceduralHolder::setDependentsDirty( const MPlug &plug, MPlugArray &plu
 	{
 		// it's an input to the procedural
 		m_boundDirty = m_sceneDirty = true;
+		m_sceneGeneration++;
 		m_componentToBoundMap.clear();
 		childChanged( kBoundingBoxChanged ); // this is necessary to cause maya to redraw
 		
@@ -616,76 +794,68 @@ IECore::ParameterisedProceduralPtr ProceduralHolder::getProcedural( std::string
 
 IECoreGL::ConstScenePtr ProceduralHolder::scene()
 {
+	waitForSceneBuilder();
+	
 	if( !m_sceneDirty  )
 	{
 		return m_scene;
 	}
 
-	m_scene = 0;
+	IECoreGL::ScenePtr scene = 0;
 	ParameterisedProceduralPtr p = ((ProceduralHolder*)this)->getProcedural();
 	if( p )
 	{
 		setParameterisedValues( true /* lazy */ );
 		try
 		{
+			// procedurals which can rerender edit the previous scene in place,
+			// so they can't share scenes via the cache
+			const bool rerenderable = canRerender( p.get() );
+			
+			MurmurHash key;
+			if( !rerenderable )
+			{
+				key = sceneKey( p.get() );
+				scene = cachedScene( key );
+			}
+			
 			IECoreGL::RendererPtr rendererToReuse = 0;
+			if( rerenderable && m_lastRenderer )
 			{
 				IECorePython::ScopedGILLock gilLock;
 				boost::python::object pythonProcedural( p );
-				if( m_lastRenderer && PyObject_HasAttrString( pythonProcedural.ptr(), "willRerender" ) )
+				/// \todo Consider how we might modify the ParameterisedProcedural (and possibly Renderer::Procedural?) interface
+				/// to properly support rerendering. Do this in conjunction with the todo in IECoreGL::Renderer::command() (about formalising a
+				/// proper interface for specifying scene edits to a Renderer).
+				bool rerender = boost::python::extract<bool>( pythonProcedural.attr( "willRerender" )( m_lastRenderer, IECore::ObjectPtr( p->parameters()->getValue() ) ) );
+				if( rerender )
 				{
-					/// \todo Consider how we might modify the ParameterisedProcedural (and possibly Renderer::Procedural?) interface
-					/// to properly support rerendering. Do this in conjunction with the todo in IECoreGL::Renderer::command() (about formalising a
-					/// proper interface for specifying scene edits to a Renderer).
-					bool rerender = boost::python::extract<bool>( pythonProcedural.attr( "willRerender" )( m_lastRenderer, IECore::ObjectPtr( p->parameters()->getValue() ) ) );
-					if( rerender )
-					{
-						rendererToReuse = m_lastRenderer;
-					}
+					rendererToReuse = m_lastRenderer;
 				}
 			}
 
-			if( rendererToReuse )
+			if( scene )
+			{
+				// we had it cached already
+			}
+			else if( rendererToReuse )
 			{
 				rendererToReuse->command( "editBegin", CompoundDataMap() );
 
 				p->render( rendererToReuse.get() );
-				m_scene = rendererToReuse->scene();
+				scene = rendererToReuse->scene();
 				
 				rendererToReuse->command( "editEnd", CompoundDataMap() );
 			}
 			else
 			{
-				IECoreGL::RendererPtr renderer = new IECoreGL::Renderer();
-				renderer->setOption( "gl:mode", new StringData( "deferred" ) );
-				renderer->setOption( "gl:drawCoordinateSystems", new BoolData( MPlug( thisMObject(), aDrawCoordinateSystems ).asBool() ) );
-				renderer->worldBegin();
-
-					// using the form with many arguments so that we can customise
-					// rendering. in particular it's very important that the geometry
-					// is rendered immediately and not deferred in a procedural. if it
-					// were deferred then that procedural might end up being called on
-					// another thread, and then try to get the GIL - this results in deadlock
-					// as sometimes (but not always) maya holds the GIL on the thread calling
-					// scene(). it's ok if the procedural spawns more procedurals because at
-					// that point we release the GIL ourselves in the bindings.
-					p->render(
-						renderer.get(),
-						false, // we don't need an attribute block
-						true, // we do want doRenderState() called
-						true, // we do want geometry (doRender)
-						true  // we want geometry rendered immediately (not deferred in a procedural call)
-					);
-
-				renderer->worldEnd();
-
-				m_scene = renderer->scene();
-				m_scene->setCamera( 0 );
-
-				m_lastRenderer = renderer;
+				m_lastRenderer = renderProcedural( p.get(), MPlug( thisMObject(), aDrawCoordinateSystems ).asBool() );
+				scene = m_lastRenderer->scene();
+				if( !rerenderable )
+				{
+					sceneCache().set( key, scene, 1 );
+				}
 			}
-			
-			buildComponents();
 		}
 		catch( boost::python::error_already_set )
 		{
@@ -702,10 +872,125 @@ IECoreGL::ConstScenePtr ProceduralHolder::scene()
 		}
 	}
 
-	m_sceneDirty = false;
+	setScene( scene );
 	return m_scene;
 }
 
+IECoreGL::ConstScenePtr ProceduralHolder::sceneIfReady()
+{
+	if( m_sceneBuilder )
+	{
+		if( !m_sceneBuilder->done() )
+		{
+			return 0;
+		}
+		finishSceneBuilder();
+	}
+	
+	if( !m_sceneDirty )
+	{
+		return m_scene;
+	}
+	
+	ParameterisedProceduralPtr p = getProcedural();
+	if( !p )
+	{
+		setScene( 0 );
+		return 0;
+	}
+	
+	if( canRerender( p.get() ) )
+	{
+		// rerendering is incremental, so there's little to be gained by doing it in the background
+		return scene();
+	}
+	
+	setParameterisedValues( true /* lazy */ );
+	const MurmurHash key = sceneKey( p.get() );
+	if( IECoreGL::ScenePtr scene = cachedScene( key ) )
+	{
+		setScene( scene );
+		return m_scene;
+	}
+	
+	// compute the bound now, while doing so doesn't require waiting for the
+	// builder, so that it can be drawn in place of the scene in the meantime.
+	boundingBox();
+	
+	m_sceneBuilder = new SceneBuilder( p, MPlug( thisMObject(), aDrawCoordinateSystems ).asBool(), key, m_sceneGeneration );
+	return 0;
+}
+
+MStatus ProceduralHolder::setParameterisedValues()
+{
+	waitForSceneBuilder();
+	return ParameterisedHolderComponentShape::setParameterisedValues();
+}
+
+MurmurHash ProceduralHolder::sceneKey( const ParameterisedProcedural *procedural )
+{
+	std::string className;
+	int classVersion = 0;
+	getParameterised( &className, &classVersion );
+	
+	MurmurHash h;
+	// see comments for SceneCache
+	h.append( (uint64_t)this );
+	h.append( className );
+	h.append( classVersion );
+	procedural->parameters()->getValue()->hash( h );
+	h.append( MPlug( thisMObject(), aDrawCoordinateSystems ).asBool() );
+	// procedurals are free to query the maya time directly
+	h.append( MAnimControl::currentTime().as( MTime::kSeconds ) );
+	
+	return h;
+}
+
+void ProceduralHolder::waitForSceneBuilder()
+{
+	if( m_sceneBuilder )
+	{
+		m_sceneBuilder->wait();
+		finishSceneBuilder();
+	}
+}
+
+void ProceduralHolder::finishSceneBuilder()
+{
+	SceneBuilderPtr builder = m_sceneBuilder;
+	m_sceneBuilder = 0;
+	
+	IECoreGL::ScenePtr scene = builder->wait();
+	if( scene )
+	{
+		sceneCache().set( builder->key(), scene, 1 );
+	}
+	
+	// only use the result if the parameters haven't changed since the builder started
+	if( builder->generation() == m_sceneGeneration )
+	{
+		setScene( scene );
+	}
+}
+
+void ProceduralHolder::setScene( IECoreGL::ScenePtr scene )
+{
+	m_scene = scene;
+	m_sceneDirty = false;
+	
+	if( m_scene )
+	{
+		try
+		{
+			buildComponents();
+		}
+		catch( const std::exception &e )
+		{
+			msg( Msg::Error, "ProceduralHolder::setScene", e.what() );
+		}
+	}
+}
+
 void ProceduralHolder::componentToPlugs( MObject &component, MSelectionList &selectionList ) const
 {
 	MStatus s;
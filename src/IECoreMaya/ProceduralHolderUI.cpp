@@ -266,7 +266,9 @@ void ProceduralHolderUI::draw( const MDrawRequest &request, M3dView &view ) cons
 		{
 			resetHilites();
 
-			IECoreGL::ConstScenePtr scene = proceduralHolder->scene();
+			// the procedural may still be expanding in the background, in which case
+			// we draw its bound until it's ready.
+			IECoreGL::ConstScenePtr scene = proceduralHolder->sceneIfReady();
 			if( scene )
 			{
 				IECoreGL::State *displayState = m_displayStyle.baseState( (M3dView::DisplayStyle)request.displayStyle() );
@@ -298,6 +300,12 @@ void ProceduralHolderUI::draw( const MDrawRequest &request, M3dView &view ) cons
 				}
 				scene->render( displayState );
 			}
+			else
+			{
+				// boundingBox() would wait for the expansion if the bound was dirtied
+				// since it started, so we draw the last bound computed instead.
+				IECoreGL::BoxPrimitive::renderWireframe( IECore::convert<Imath::Box3f>( proceduralHolder->m_bound ) );
+			}
 		}
 	}
 	catch( const IECoreGL::Exception &e )
@@ -40,6 +40,11 @@
 #include "boost/python.hpp"
 #include "boost/tokenizer.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <set>
+
 #include "OpenEXR/ImathMatrixAlgo.h"
 #include "OpenEXR/ImathBoxAlgo.h"
 
@@ -152,6 +157,124 @@ MObject SceneShapeInterface::aBoundCenterZ;
 
 // This post load callback is used to dirty the aOutputObjects elements
 // following loading - see further  comments in initialize.
+namespace
+{
+
+std::string relativePathName( const SceneInterface::Path &root, const SceneInterface::Path &path )
+{
+	assert( root.size() <= path.size() );
+	
+	if( root == path )
+	{
+		return "/";
+	}
+	
+	std::string pathName;
+	
+	SceneInterface::Path::const_iterator it = path.begin();
+	it += root.size();
+
+	for ( ; it != path.end(); it++ )
+	{
+		pathName += '/';
+		pathName += it->value();
+	}
+	
+	return pathName;
+}
+
+template<typename T>
+bool findQueryResult( tbb::mutex &mutex, const std::map<SceneInterface::Path, T> &results, const SceneInterface *scene, T &result )
+{
+	SceneInterface::Path path;
+	scene->path( path );
+
+	tbb::mutex::scoped_lock lock( mutex );
+	typename std::map<SceneInterface::Path, T>::const_iterator it = results.find( path );
+	if( it == results.end() )
+	{
+		return false;
+	}
+
+	result = it->second;
+	return true;
+}
+
+ConstObjectPtr transformObject( const Object *object, const M44d &matrix )
+{
+	TransformOpPtr transformer = new TransformOp();
+	transformer->inputParameter()->setValue( const_cast< Object *>( object ) );		/// safe const_cast because the op will duplicate the Object.
+	transformer->copyParameter()->setTypedValue( true );
+	transformer->matrixParameter()->setValue( new M44dData( matrix ) );
+	return transformer->operate();
+}
+
+// Transforms objects into world space in parallel.
+struct TransformObjects
+{
+	TransformObjects( const std::vector<M44d> &matrices, std::vector<ConstObjectPtr> &objects )
+		:	m_matrices( matrices ), m_objects( objects )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			if( m_objects[i] )
+			{
+				m_objects[i] = transformObject( m_objects[i].get(), m_matrices[i] );
+			}
+		}
+	}
+
+	const std::vector<M44d> &m_matrices;
+	std::vector<ConstObjectPtr> &m_objects;
+};
+
+} // namespace
+
+// Builds a single location of the preview scene. The IECoreGL renderer expands
+// procedurals concurrently, so emitting each child location as one of these
+// reads and converts the hierarchy in parallel.
+class SceneShapeInterface::LocationProcedural : public IECore::Renderer::Procedural
+{
+
+	public :
+	
+		LocationProcedural( SceneShapeInterface *node, ConstSceneInterfacePtr scene, const SceneInterface::Path &rootPath, double time, bool drawBounds, bool drawGeometry, const SceneInterface::NameList &drawTags )
+			:	m_node( node ), m_scene( scene ), m_rootPath( rootPath ), m_time( time ), m_drawBounds( drawBounds ), m_drawGeometry( drawGeometry ), m_drawTags( drawTags )
+		{
+		}
+		
+		virtual Imath::Box3f bound() const
+		{
+			return noBound;
+		}
+		
+		virtual void render( IECore::Renderer *renderer ) const
+		{
+			IECoreGL::Renderer *glRenderer = static_cast<IECoreGL::Renderer *>( renderer );
+			m_node->recurseBuildScene( glRenderer, m_scene.get(), m_rootPath, m_time, m_drawBounds, m_drawGeometry, false, m_drawTags );
+		}
+		
+		virtual MurmurHash hash() const
+		{
+			return MurmurHash();
+		}
+	
+	private :
+	
+		SceneShapeInterface *m_node;
+		ConstSceneInterfacePtr m_scene;
+		SceneInterface::Path m_rootPath;
+		double m_time;
+		bool m_drawBounds;
+		bool m_drawGeometry;
+		SceneInterface::NameList m_drawTags;
+
+};
+
 class SceneShapeInterface::PostLoadCallback : public IECoreMaya::PostLoadCallback
 {
 
@@ -747,14 +870,10 @@ MStatus SceneShapeInterface::compute( const MPlug &plug, MDataBlock &dataBlock )
 		MDataHandle timeHandle = dataBlock.inputValue( aTime );
 		MTime time = timeHandle.asTime();
 
-		MPlug pQuerySpace( thisMObject(), aQuerySpace );
-		int querySpace;
-		pQuerySpace.getValue( querySpace );
+		// the query inputs are read through the data block rather than
+		// via MPlugs, which is safe during parallel evaluation.
+		int querySpace = dataBlock.inputValue( aQuerySpace ).asInt();
 
-		MString name;
-		SceneInterface::Path path;
-		MPlug pSceneQueries( thisMObject(), aSceneQueries );
-		
 		ConstSceneInterfacePtr sc = getSceneInterface();
 		if( !sc )
 		{
@@ -764,12 +883,31 @@ MStatus SceneShapeInterface::compute( const MPlug &plug, MDataBlock &dataBlock )
 			return MS::kFailure;
 		}
 
+		// gather all the queried paths, so that the ones not requested
+		// yet are computed in the same batch as the ones which are.
+		std::map<unsigned, MString> queryNames;
+		std::vector<SceneInterface::Path> queryPaths;
+		MArrayDataHandle queriesHandle = dataBlock.inputArrayValue( aSceneQueries );
+		for( unsigned i = 0, n = queriesHandle.elementCount(); i < n; ++i )
+		{
+			queriesHandle.jumpToArrayElement( i );
+			const MString &name = queriesHandle.inputValue().asString();
+			queryNames[queriesHandle.elementIndex()] = name;
+
+			SceneInterface::Path path = fullPathName( name.asChar() );
+			if( sc->scene( path, SceneInterface::NullIfMissing ) )
+			{
+				queryPaths.push_back( path );
+			}
+		}
+
+		updateQueryCache( topLevelPlug, sc.get(), queryPaths, time.as( MTime::kSeconds ), querySpace );
+
 		unsigned numIndices = indices.length();
 		for( unsigned i = 0; i < numIndices; ++i )
 		{
-			MPlug pQuery = pSceneQueries.elementByLogicalIndex( indices[i] );
-			pQuery.getValue( name );
-			path = fullPathName( name.asChar() );
+			const MString &name = queryNames[indices[i]];
+			SceneInterface::Path path = fullPathName( name.asChar() );
 			ConstSceneInterfacePtr scene = sc->scene( path,  SceneInterface::NullIfMissing );
 			if( !scene )
 			{
@@ -808,15 +946,18 @@ MStatus SceneShapeInterface::computeOutputPlug( const MPlug &plug, const MPlug &
 		MArrayDataBuilder transformBuilder = transformHandle.builder();
 
 		M44d transformd;
-		if( querySpace == World )
+		if( !findQueryResult( m_queryCacheMutex, m_queryCache.transforms, scene, transformd ) )
 		{
-			// World Space (starting from scene root)
-			transformd = worldTransform( scene, time.as( MTime::kSeconds ) );
-		}
-		else if( querySpace == Local )
-		{
-			// Local space
-			transformd = scene->readTransformAsMatrix( time.as( MTime::kSeconds ) );
+			if( querySpace == World )
+			{
+				// World Space (starting from scene root)
+				transformd = worldTransform( scene, time.as( MTime::kSeconds ) );
+			}
+			else if( querySpace == Local )
+			{
+				// Local space
+				transformd = scene->readTransformAsMatrix( time.as( MTime::kSeconds ) );
+			}
 		}
 
 		V3f translate( 0 ), shear( 0 ), rotate( 0 ), scale( 1 );
@@ -834,19 +975,15 @@ MStatus SceneShapeInterface::computeOutputPlug( const MPlug &plug, const MPlug &
 		MArrayDataHandle outputDataHandle = dataBlock.outputArrayValue( aOutputObjects, &s );
 		MArrayDataBuilder outputBuilder = outputDataHandle.builder();
 
-		ConstObjectPtr object = scene->readObject( time.as( MTime::kSeconds ) );
-
-		if( querySpace == World )
+		ConstObjectPtr object;
+		if( !findQueryResult( m_queryCacheMutex, m_queryCache.objects, scene, object ) )
 		{
-			// If world space, need to transform the object using the concatenated matrix from the sceneInterface path to the query path
-			M44d transformd;
-			transformd = worldTransform( scene, time.as( MTime::kSeconds ) );
-
-			TransformOpPtr transformer = new TransformOp();
-			transformer->inputParameter()->setValue( const_cast< Object *>(object.get()) );		/// safe const_cast because the op will duplicate the Object.
-			transformer->copyParameter()->setTypedValue( true );
-			transformer->matrixParameter()->setValue( new M44dData( transformd ) );
-			object = transformer->operate();
+			object = scene->readObject( time.as( MTime::kSeconds ) );
+			if( querySpace == World )
+			{
+				// If world space, need to transform the object using the concatenated matrix from the sceneInterface path to the query path
+				object = transformObject( object.get(), worldTransform( scene, time.as( MTime::kSeconds ) ) );
+			}
 		}
 
 		IECore::TypeId type = object->typeId();
@@ -918,13 +1055,16 @@ MStatus SceneShapeInterface::computeOutputPlug( const MPlug &plug, const MPlug &
 		MArrayDataHandle boundHandle = dataBlock.outputArrayValue( aBound );
 		MArrayDataBuilder boundBuilder = boundHandle.builder();
 
-		Box3d bboxd = scene->readBound( time.as( MTime::kSeconds ) );
-
-		if( querySpace == World )
+		Box3d bboxd;
+		if( !findQueryResult( m_queryCacheMutex, m_queryCache.bounds, scene, bboxd ) )
 		{
-			// World Space (from root path)
-			M44d transformd = worldTransform( scene, time.as( MTime::kSeconds ) );
-			bboxd = transform( bboxd, transformd );
+			bboxd = scene->readBound( time.as( MTime::kSeconds ) );
+			if( querySpace == World )
+			{
+				// World Space (from root path)
+				M44d transformd = worldTransform( scene, time.as( MTime::kSeconds ) );
+				bboxd = transform( bboxd, transformd );
+			}
 		}
 		Box3f bound( bboxd.min, bboxd.max );
 
@@ -1012,6 +1152,114 @@ MStatus SceneShapeInterface::computeOutputPlug( const MPlug &plug, const MPlug &
 	return s;
 }
 
+void SceneShapeInterface::updateQueryCache( const MPlug &topLevelPlug, const SceneInterface *scene, const std::vector<SceneInterface::Path> &paths, double time, int querySpace )
+{
+	tbb::mutex::scoped_lock lock( m_queryCacheMutex );
+
+	if( m_queryCache.scene != scene || m_queryCache.time != time || m_queryCache.querySpace != querySpace )
+	{
+		m_queryCache = QueryCache();
+		m_queryCache.scene = scene;
+		m_queryCache.time = time;
+		m_queryCache.querySpace = querySpace;
+	}
+
+	std::vector<SceneInterface::Path> missingPaths;
+	for( std::vector<SceneInterface::Path>::const_iterator it = paths.begin(); it != paths.end(); ++it )
+	{
+		if(
+			( topLevelPlug == aTransform && !m_queryCache.transforms.count( *it ) ) ||
+			( topLevelPlug == aBound && !m_queryCache.bounds.count( *it ) ) ||
+			( topLevelPlug == aOutputObjects && !m_queryCache.objects.count( *it ) )
+		)
+		{
+			missingPaths.push_back( *it );
+		}
+	}
+
+	if( missingPaths.empty() )
+	{
+		return;
+	}
+
+	// the transforms to the query space, which are needed by all world space
+	// queries. for world space we read the local transforms for every location
+	// between the root and the queried paths in one batch, and concatenate them.
+	std::vector<M44d> transforms;
+	if( querySpace == World )
+	{
+		SceneInterface::Path rootPath;
+		scene->path( rootPath );
+
+		std::set<SceneInterface::Path> ancestorSet;
+		for( std::vector<SceneInterface::Path>::const_iterator it = missingPaths.begin(); it != missingPaths.end(); ++it )
+		{
+			for( size_t i = rootPath.size() + 1; i <= it->size(); ++i )
+			{
+				ancestorSet.insert( SceneInterface::Path( it->begin(), it->begin() + i ) );
+			}
+		}
+
+		std::vector<SceneInterface::Path> ancestors( ancestorSet.begin(), ancestorSet.end() );
+		std::vector<M44d> localTransforms;
+		scene->readTransformsAsMatrices( ancestors, time, localTransforms );
+
+		std::map<SceneInterface::Path, M44d> localTransformMap;
+		for( size_t i = 0; i < ancestors.size(); ++i )
+		{
+			localTransformMap[ancestors[i]] = localTransforms[i];
+		}
+
+		transforms.resize( missingPaths.size() );
+		for( size_t i = 0; i < missingPaths.size(); ++i )
+		{
+			const SceneInterface::Path &path = missingPaths[i];
+			for( size_t j = rootPath.size() + 1; j <= path.size(); ++j )
+			{
+				transforms[i] = localTransformMap[SceneInterface::Path( path.begin(), path.begin() + j )] * transforms[i];
+			}
+		}
+	}
+	else if( topLevelPlug == aTransform )
+	{
+		scene->readTransformsAsMatrices( missingPaths, time, transforms );
+	}
+
+	if( topLevelPlug == aTransform )
+	{
+		for( size_t i = 0; i < missingPaths.size(); ++i )
+		{
+			m_queryCache.transforms[missingPaths[i]] = transforms[i];
+		}
+	}
+	else if( topLevelPlug == aBound )
+	{
+		std::vector<Box3d> bounds;
+		scene->readBounds( missingPaths, time, bounds );
+		for( size_t i = 0; i < missingPaths.size(); ++i )
+		{
+			m_queryCache.bounds[missingPaths[i]] = querySpace == World ? transform( bounds[i], transforms[i] ) : bounds[i];
+		}
+	}
+	else if( topLevelPlug == aOutputObjects )
+	{
+		std::vector<ConstObjectPtr> objects;
+		scene->readObjects( missingPaths, time, objects );
+		if( querySpace == World )
+		{
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, objects.size() ), TransformObjects( transforms, objects ) );
+		}
+
+		for( size_t i = 0; i < missingPaths.size(); ++i )
+		{
+			if( objects[i] )
+			{
+				m_queryCache.objects[missingPaths[i]] = objects[i];
+			}
+		}
+	}
+}
+
 M44d SceneShapeInterface::worldTransform( ConstSceneInterfacePtr scene, double time )
 {
 	SceneInterface::Path p;
@@ -1191,10 +1439,13 @@ void SceneShapeInterface::buildScene( IECoreGL::RendererPtr renderer, ConstScene
 
 	renderer->concatTransform( convert<M44f>( worldTransform( subSceneInterface, time.as( MTime::kSeconds ) ) ) );
 
-	recurseBuildScene( renderer.get(), subSceneInterface.get(), time.as( MTime::kSeconds ), drawBounds, drawGeometry, objectOnly, drawTags );
+	SceneInterface::Path rootPath;
+	getSceneInterface()->path( rootPath );
+
+	recurseBuildScene( renderer.get(), subSceneInterface.get(), rootPath, time.as( MTime::kSeconds ), drawBounds, drawGeometry, objectOnly, drawTags );
 }
 
-void SceneShapeInterface::recurseBuildScene( IECoreGL::Renderer * renderer, const SceneInterface *subSceneInterface, double time, bool drawBounds, bool drawGeometry, bool objectOnly, const SceneInterface::NameList &drawTags )
+void SceneShapeInterface::recurseBuildScene( IECoreGL::Renderer * renderer, const SceneInterface *subSceneInterface, const SceneInterface::Path &rootPath, double time, bool drawBounds, bool drawGeometry, bool objectOnly, const SceneInterface::NameList &drawTags )
 {
 	if ( drawTags.size() )
 	{
@@ -1227,7 +1478,7 @@ void SceneShapeInterface::recurseBuildScene( IECoreGL::Renderer * renderer, cons
 	AttributeBlock a(renderer);
 	SceneInterface::Path pathName;
 	subSceneInterface->path( pathName );
-	std::string pathStr = relativePathName( pathName );
+	std::string pathStr = ::relativePathName( rootPath, pathName );
 	renderer->setAttribute( "name", new StringData( pathStr ) );
 	renderer->setAttribute( "gl:curvesPrimitive:useGLLines", new BoolData( true ) );
 	
@@ -1249,6 +1500,7 @@ void SceneShapeInterface::recurseBuildScene( IECoreGL::Renderer * renderer, cons
 		subSceneInterface->readAttribute( LinkedScene::timeLinkAttribute, time )->hash( hash );
 		/// register the hash mapped to the name of the group
 		InternedString pathInternedStr(pathStr);
+		tbb::mutex::scoped_lock lock( m_instancesMutex );
 		std::pair< HashToName::iterator, bool > ret = m_hashToName.insert( HashToName::value_type( hash, pathInternedStr ) );
 		if ( !ret.second )
 		{
@@ -1261,7 +1513,7 @@ void SceneShapeInterface::recurseBuildScene( IECoreGL::Renderer * renderer, cons
 
 	if( drawGeometry && subSceneInterface->hasObject() )
 	{
-		ConstObjectPtr object = subSceneInterface->readObject( time );
+		ConstObjectPtr object = readPreviewObject( subSceneInterface, pathStr, time );
 		
 		if( runTimeCast< const CoordinateSystem >(object.get()) )
 		{
@@ -1312,7 +1564,7 @@ void SceneShapeInterface::recurseBuildScene( IECoreGL::Renderer * renderer, cons
 		for ( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
 		{
 			ConstSceneInterfacePtr childScene = subSceneInterface->child( *it );
-			recurseBuildScene( renderer, childScene.get(), time, drawBounds, drawGeometry, objectOnly, drawTags );
+			renderer->procedural( new LocationProcedural( this, childScene, rootPath, time, drawBounds, drawGeometry, drawTags ) );
 		}
 	}
 }
@@ -1396,9 +1648,22 @@ IECoreGL::ConstScenePtr SceneShapeInterface::glScene()
 
 	if( sceneInterface )
 	{
+		// during playback, time changes often leave the scene unchanged, in which
+		// case we can keep the scene we already have.
+		MurmurHash previewHash = previewSceneHash( sceneInterface.get() );
+		if( m_scene && previewHash != MurmurHash() && previewHash == m_previewSceneHash )
+		{
+			m_previewSceneDirty = false;
+			return m_scene;
+		}
+		m_previewSceneHash = previewHash;
+
 		SceneInterface::NameList childNames;
 		sceneInterface->childNames( childNames );
 
+		m_previousObjectCache.swap( m_objectCache );
+		m_objectCache.clear();
+
 		IECoreGL::RendererPtr renderer = new IECoreGL::Renderer();
 		renderer->setOption( "gl:mode", new StringData( "deferred" ) );
 
@@ -1408,6 +1673,8 @@ IECoreGL::ConstScenePtr SceneShapeInterface::glScene()
 		}
 		renderer->worldEnd();
 	
+		m_previousObjectCache.clear();
+
 		m_scene = renderer->scene();
 		m_scene->setCamera( 0 );
 	}
@@ -1424,6 +1691,78 @@ IECoreGL::ConstScenePtr SceneShapeInterface::glScene()
 	return m_scene;
 }
 
+MurmurHash SceneShapeInterface::previewSceneHash( const SceneInterface *scene )
+{
+	MPlug pTime( thisMObject(), aTime );
+	MTime time;
+	pTime.getValue( time );
+
+	MurmurHash h;
+	scene->hash( SceneInterface::HierarchyHash, time.as( MTime::kSeconds ), h );
+
+	// the base class implementation only hashes the type, and can't be used to detect changes
+	MurmurHash baseHash;
+	baseHash.append( scene->typeId() );
+	if( h == baseHash )
+	{
+		return MurmurHash();
+	}
+
+	SceneInterface::Path path;
+	scene->path( path );
+	for( SceneInterface::Path::const_iterator it = path.begin(); it != path.end(); ++it )
+	{
+		h.append( *it );
+	}
+
+	bool drawBounds, drawGeometry, objectOnly;
+	MPlug( thisMObject(), aDrawChildBounds ).getValue( drawBounds );
+	MPlug( thisMObject(), aDrawGeometry ).getValue( drawGeometry );
+	MPlug( thisMObject(), aObjectOnly ).getValue( objectOnly );
+	h.append( drawBounds );
+	h.append( drawGeometry );
+	h.append( objectOnly );
+
+	MString drawTagsFilter;
+	MPlug( thisMObject(), aDrawTagsFilter ).getValue( drawTagsFilter );
+	h.append( drawTagsFilter.asChar() );
+
+	return h;
+}
+
+ConstObjectPtr SceneShapeInterface::readPreviewObject( const SceneInterface *scene, const InternedString &name, double time )
+{
+	MurmurHash h;
+	scene->hash( SceneInterface::ObjectHash, time, h );
+
+	MurmurHash baseHash;
+	baseHash.append( scene->typeId() );
+	if( h == baseHash )
+	{
+		return scene->readObject( time );
+	}
+
+	ConstObjectPtr object;
+	{
+		tbb::mutex::scoped_lock lock( m_objectCacheMutex );
+		ObjectCache::const_iterator it = m_previousObjectCache.find( name );
+		if( it != m_previousObjectCache.end() && it->second.first == h )
+		{
+			object = it->second.second;
+		}
+	}
+
+	if( !object )
+	{
+		object = scene->readObject( time );
+	}
+
+	tbb::mutex::scoped_lock lock( m_objectCacheMutex );
+	m_objectCache[name] = ObjectCache::mapped_type( h, object );
+
+	return object;
+}
+
 void SceneShapeInterface::registerGroup( const std::string &name, IECoreGL::GroupPtr &group )
 {
 		int index = m_nameToGroupMap.size();
@@ -1513,25 +1852,7 @@ std::string SceneShapeInterface::relativePathName( SceneInterface::Path path )
 {
 	SceneInterface::Path root;
 	getSceneInterface()->path( root );
-	assert( root.size() <= path.size() );
-	
-	if( root == path )
-	{
-		return "/";
-	}
-	
-	std::string pathName;
-	
-	SceneInterface::Path::const_iterator it = path.begin();
-	it += root.size();
-
-	for ( ; it != path.end(); it++ )
-	{
-		pathName += '/';
-		pathName += it->value();
-	}
-	
-	return pathName;
+	return ::relativePathName( root, path );
 }
 
 SceneInterface::Path SceneShapeInterface::fullPathName( std::string relativeName )
@@ -45,7 +45,6 @@
 #include "maya/MFloatVectorArray.h"
 #include "maya/MFloatArray.h"
 #include "maya/MIntArray.h"
-#include "maya/MItMeshPolygon.h"
 #include "maya/MGlobal.h"
 #include "maya/MPlug.h"
 #include "maya/MFnEnumAttribute.h"
@@ -54,12 +53,59 @@
 #include "IECore/PrimitiveVariable.h"
 #include "IECore/MessageHandler.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "IECoreMaya/Convert.h"
+#include "IECoreMaya/MArrayIter.h"
 #include "IECoreMaya/ToMayaMeshConverter.h"
 #include "IECoreMaya/FromMayaMeshConverter.h"
 
 using namespace IECoreMaya;
 
+namespace
+{
+
+// Converts Cortex vectors into a preallocated Maya array in parallel.
+template<typename From, typename To>
+struct ConvertElements
+{
+	ConvertElements( const std::vector<From> &from, To *to )
+		:	m_from( from ), m_to( to )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			m_to[i] = IECore::convert<To, From>( m_from[i] );
+		}
+	}
+
+	const std::vector<From> &m_from;
+	To *m_to;
+};
+
+template<typename MArray, typename From>
+void convertElements( const std::vector<From> &from, MArray &to )
+{
+	typedef typename MArrayTraits<MArray>::ValueType To;
+	to.setLength( from.size() );
+	if( from.size() )
+	{
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, from.size() ), ConvertElements<From, To>( from, MArrayIter<MArray>::begin( to ) ) );
+	}
+}
+
+void copyElements( const std::vector<int> &from, MIntArray &to )
+{
+	to.setLength( from.size() );
+	std::copy( from.begin(), from.end(), MArrayIter<MIntArray>::begin( to ) );
+}
+
+} // namespace
+
 ToMayaMeshConverter::Description ToMayaMeshConverter::g_meshDataDescription( IECore::MeshPrimitive::staticTypeId(), MFn::kMeshData );
 ToMayaMeshConverter::Description ToMayaMeshConverter::g_meshDescription( IECore::MeshPrimitive::staticTypeId(), MFn::kMesh );
 
@@ -280,12 +326,7 @@ bool ToMayaMeshConverter::doConversion( IECore::ConstObjectPtr from, MObject &to
 		if (p)
 		{
 			numVertices = p->readable().size();
-
-			vertexArray.setLength( numVertices );
-			for (int i = 0; i < numVertices; i++)
-			{
-				vertexArray[i] = IECore::convert<MFloatPoint, Imath::V3f>( p->readable()[i] );
-			}
+			convertElements( p->readable(), vertexArray );
 		}
 		else
 		{
@@ -293,12 +334,7 @@ bool ToMayaMeshConverter::doConversion( IECore::ConstObjectPtr from, MObject &to
 			if (p)
 			{
 				numVertices = p->readable().size();
-
-				vertexArray.setLength( numVertices );
-				for (int i = 0; i < numVertices; i++)
-				{
-					vertexArray[i] = IECore::convert<MFloatPoint, Imath::V3d>( p->readable()[i] );
-				}
+				convertElements( p->readable(), vertexArray );
 			}
 			else
 			{
@@ -313,20 +349,11 @@ bool ToMayaMeshConverter::doConversion( IECore::ConstObjectPtr from, MObject &to
 	assert( verticesPerFace );
 	int numPolygons = verticesPerFace->readable().size();
 
-	polygonCounts.setLength( numPolygons );
-	for (int i = 0; i < numPolygons; i++)
-	{
-		polygonCounts[i] = verticesPerFace->readable()[i];
-	}
+	copyElements( verticesPerFace->readable(), polygonCounts );
 
 	IECore::ConstIntVectorDataPtr vertexIds = mesh->vertexIds();
 	assert( vertexIds );
-	int numPolygonConnects = vertexIds->readable().size();
-	polygonConnects.setLength( numPolygonConnects );
-	for (int i = 0; i < numPolygonConnects; i++)
-	{
-		polygonConnects[i] = vertexIds->readable()[i];
-	}
+	copyElements( vertexIds->readable(), polygonConnects );
 
 	MObject mObj = fnMesh.create( numVertices, numPolygons, vertexArray, polygonCounts, polygonConnects, to, &s );
 
@@ -345,26 +372,14 @@ bool ToMayaMeshConverter::doConversion( IECore::ConstObjectPtr from, MObject &to
 			IECore::ConstV3fVectorDataPtr n = IECore::runTimeCast<const IECore::V3fVectorData>(it->second.data);
 			if (n)
 			{
-				int numVertexNormals = n->readable().size();
-
-				vertexNormalsArray.setLength( numVertexNormals );
-				for (int i = 0; i < numVertexNormals; i++)
-				{
-					vertexNormalsArray[i] = IECore::convert<MVector, Imath::V3f>( n->readable()[i] );
-				}
+				convertElements( n->readable(), vertexNormalsArray );
 			}
 			else
 			{
 				IECore::ConstV3dVectorDataPtr n = IECore::runTimeCast<const IECore::V3dVectorData>(it->second.data);
 				if (n)
 				{
-					int numVertexNormals = n->readable().size();
-
-					vertexNormalsArray.setLength( numVertexNormals );
-					for (int i = 0; i < numVertexNormals; i++)
-					{
-						vertexNormalsArray[i] = IECore::convert<MVector, Imath::V3d>( n->readable()[i] );
-					}
+					convertElements( n->readable(), vertexNormalsArray );
 				}
 				else
 				{
@@ -374,27 +389,20 @@ bool ToMayaMeshConverter::doConversion( IECore::ConstObjectPtr from, MObject &to
 			
 			if ( vertexNormalsArray.length() )
 			{
-				MStatus status;
-				MItMeshPolygon itPolygon( mObj, &status );
-				if( status != MS::kSuccess )
-				{
-					IECore::msg( IECore::Msg::Warning, "ToMayaMeshConverter::doConversion", "Failed to create mesh iterator" );
-				}
-
-				unsigned v = 0;
-				MIntArray vertexIds;
+				// the face ids follow directly from the topology, so there's
+				// no need to iterate over the new mesh to find them.
 				MIntArray faceIds;
-				
-				for ( ; !itPolygon.isDone(); itPolygon.next() )
+				faceIds.setLength( polygonConnects.length() );
+				unsigned faceVertex = 0;
+				for ( int i = 0; i < numPolygons; ++i )
 				{
-					for ( v=0; v < itPolygon.polygonVertexCount(); ++v )
+					for ( int v = 0; v < polygonCounts[i]; ++v )
 					{
-						faceIds.append( itPolygon.index() );
-						vertexIds.append( itPolygon.vertexIndex( v ) );
+						faceIds[faceVertex++] = i;
 					}
 				}
 
-				if( !fnMesh.setFaceVertexNormals( vertexNormalsArray, faceIds, vertexIds ) )
+				if( !fnMesh.setFaceVertexNormals( vertexNormalsArray, faceIds, polygonConnects ) )
 				{
 					IECore::msg( IECore::Msg::Warning, "ToMayaMeshConverter::doConversion", "Setting normals failed" );
 				}
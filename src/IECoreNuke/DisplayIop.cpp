@@ -34,6 +34,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "DDImage/Knobs.h"
 #include "DDImage/Row.h"
 
@@ -149,6 +151,7 @@ const DD::Image::Iop::Description DisplayIop::g_description( "ieDisplay", Displa
 DisplayIop::DisplayIop( Node *node )
 	:	Iop( node ), m_portNumber( 1559 ), m_server( g_servers.get( m_portNumber ) ), m_updateCount( 0 ), m_driver( 0 )
 {
+	std::fill( m_channelData, m_channelData + 4, (const float *)0 );
 	inputs( 0 );
 	slowness( 0 ); // disable caching as we're buffering everything internally ourselves
 	NukeDisplayDriver::instanceCreatedSignal.connect( boost::bind( &DisplayIop::driverCreated, this, _1 ) );
@@ -209,13 +212,26 @@ void DisplayIop::append( DD::Image::Hash &hash )
 
 void DisplayIop::_validate( bool forReal )
 {
+	static const char *inputChannels[] = { "R", "G", "B", "A" };
+
 	Box2i displayWindow( V2i( 0, 0 ), V2i( 255, 255 ) );
 	
+	m_image = 0;
 	if( firstDisplayIop()->m_driver )
 	{
-		displayWindow = firstDisplayIop()->m_driver->image()->getDisplayWindow();
+		m_image = firstDisplayIop()->m_driver->image();
+		displayWindow = m_image->getDisplayWindow();
+	}
+
+	for( int i = 0; i < 4; ++i )
+	{
+		const FloatVectorData *inputData = m_image ? m_image->variableData<FloatVectorData>( inputChannels[i] ) : 0;
+		m_channelData[i] = inputData && !inputData->readable().empty() ? &(inputData->readable()[0]) : 0;
 	}
 
+	m_displayWindow = displayWindow;
+	m_dataWindow = m_image ? m_image->getDataWindow() : Box2i();
+
 	m_format = m_fullSizeFormat = Format( displayWindow.size().x + 1, displayWindow.size().y + 1 );
 	// these set function don't copy the format, but instead reference its address.
 	// we therefore have to store the format as member data.
@@ -229,37 +245,30 @@ void DisplayIop::_validate( bool forReal )
 void DisplayIop::engine( int y, int x, int r, const DD::Image::ChannelSet &channels, DD::Image::Row &row )
 {
 	Channel outputChannels[4] = { Chan_Red, Chan_Green, Chan_Blue, Chan_Alpha };
-	const char *inputChannels[] = { "R", "G", "B", "A", 0 };
-	
-	const ImagePrimitive *image = 0;
-	Box2i inputDataWindow;
-	Box2i inputDisplayWindow;
-	if( firstDisplayIop()->m_driver )
-	{
-		image = firstDisplayIop()->m_driver->image().get();
-		inputDataWindow = image->getDataWindow();
-		inputDisplayWindow = image->getDisplayWindow();
-	}
-	
-	int i = 0;
-	while( inputChannels[i] )
+
+	// remap coordinate relative to our data window. nuke images have pixel origin at bottom,
+	// cortex images have pixel origin at top.
+	const int dataY = m_displayWindow.max.y - y;
+	const int dataX = std::max( x, m_dataWindow.min.x );
+	const int dataR = std::min( r, m_dataWindow.max.x + 1 );
+	const bool rowInDataWindow = dataY >= m_dataWindow.min.y && dataY <= m_dataWindow.max.y && dataX < dataR;
+
+	for( int i = 0; i < 4; ++i )
 	{
-		const FloatVectorData *inputData = image ? image->variableData<FloatVectorData>( inputChannels[i] ) : 0;
-		if( inputData )
-		{
-			float *output = row.writable( outputChannels[i] ) + x;
-			// remap coordinate relative to our data window. nuke images have pixel origin at bottom,
-			// cortex images have pixel origin at top.
-			V2i pDataWindow = V2i( x, inputDisplayWindow.max.y - y ) - inputDataWindow.min;
-			const float *input = &((inputData->readable())[pDataWindow.y*(inputDataWindow.size().x+1) + pDataWindow.x]);
-			memcpy( output, input, (r-x) * sizeof( float ) );
-		}
-		else
+		if( !m_channelData[i] || !rowInDataWindow )
 		{
 			row.erase( outputChannels[i] );
+			continue;
 		}
-		i++;
-	}    
+
+		// copy the part of the row covered by the data window straight from
+		// the driver's buffer, and zero the remainder.
+		float *output = row.writable( outputChannels[i] );
+		const float *input = m_channelData[i] + ( dataY - m_dataWindow.min.y ) * ( m_dataWindow.size().x + 1 ) + ( dataX - m_dataWindow.min.x );
+		std::fill( output + x, output + dataX, 0.0f );
+		memcpy( output + dataX, input, ( dataR - dataX ) * sizeof( float ) );
+		std::fill( output + dataR, output + r, 0.0f );
+	}
 }
 
 DD::Image::Op *DisplayIop::build( Node *node )
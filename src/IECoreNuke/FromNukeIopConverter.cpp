@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "DDImage/Row.h"
+
+#include "IECore/ImagePrimitive.h"
+
+#include "IECoreNuke/FromNukeIopConverter.h"
+
+using namespace IECoreNuke;
+using namespace IECore;
+using namespace Imath;
+
+namespace
+{
+
+std::string channelName( DD::Image::Channel z )
+{
+	switch( z )
+	{
+		case DD::Image::Chan_Red :
+			return "R";
+		case DD::Image::Chan_Green :
+			return "G";
+		case DD::Image::Chan_Blue :
+			return "B";
+		case DD::Image::Chan_Alpha :
+			return "A";
+		case DD::Image::Chan_Z :
+			return "Z";
+		default :
+			return DD::Image::getName( z );
+	}
+}
+
+// Fetches rows from an Iop and copies them into the channels of an ImagePrimitive.
+// Each task uses its own Row, so the rows for different scanlines can be computed
+// by Nuke concurrently.
+class RowCopier
+{
+	public :
+
+		RowCopier( DD::Image::Iop *iop, const DD::Image::Box &box, const DD::Image::ChannelSet &channels, const std::vector<float *> &outputs )
+			:	m_iop( iop ), m_box( box ), m_channels( channels ), m_outputs( outputs )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			const int width = m_box.w();
+			DD::Image::Row row( m_box.x(), m_box.r() );
+			for( int y = range.begin(); y != range.end(); ++y )
+			{
+				m_iop->get( y, m_box.x(), m_box.r(), m_channels, row );
+				if( m_iop->aborted() )
+				{
+					return;
+				}
+
+				// nuke's y axis points up, and the ImagePrimitive's points down.
+				const size_t offset = ( m_box.t() - 1 - y ) * width;
+				size_t c = 0;
+				foreach( z, m_channels )
+				{
+					memcpy( m_outputs[c++] + offset, row[z] + m_box.x(), width * sizeof( float ) );
+				}
+			}
+		}
+
+	private :
+
+		DD::Image::Iop *m_iop;
+		const DD::Image::Box &m_box;
+		const DD::Image::ChannelSet &m_channels;
+		const std::vector<float *> &m_outputs;
+
+};
+
+} // namespace
+
+IE_CORE_DEFINERUNTIMETYPED( FromNukeIopConverter );
+
+FromNukeIopConverter::FromNukeIopConverter( DD::Image::Iop *iop )
+	:	FromNukeConverter( "Converts the output of nuke Iops to IECore ImagePrimitives." ), m_iop( iop )
+{
+}
+
+FromNukeIopConverter::~FromNukeIopConverter()
+{
+}
+
+IECore::ObjectPtr FromNukeIopConverter::doConversion( IECore::ConstCompoundObjectPtr operands ) const
+{
+	DD::Image::Box box = m_iop->requestedBox();
+	box.intersect( m_iop->info() );
+
+	DD::Image::ChannelSet channels = m_iop->requested_channels();
+	channels &= m_iop->channels();
+
+	Box2i dataWindow( V2i( box.x(), box.y() ), V2i( box.r() - 1, box.t() - 1 ) );
+	ImagePrimitivePtr result = new ImagePrimitive( dataWindow, dataWindow );
+
+	if( box.w() <= 0 || box.h() <= 0 )
+	{
+		return result;
+	}
+
+	// create all the channels up front, so the rows can be copied straight into them.
+	std::vector<float *> outputs;
+	foreach( z, channels )
+	{
+		FloatVectorDataPtr channelData = result->createChannel<float>( channelName( z ) );
+		outputs.push_back( &*(channelData->writable().begin()) );
+	}
+
+	RowCopier copier( m_iop, box, channels, outputs );
+	tbb::parallel_for( tbb::blocked_range<int>( box.y(), box.t() ), copier );
+
+	return result;
+}
@@ -36,7 +36,7 @@
 #include "IECore/TypedPrimitiveParameter.h"
 
 #include "IECoreNuke/ImagePrimitiveParameterHandler.h"
-#include "IECoreNuke/FromNukeTileConverter.h"
+#include "IECoreNuke/FromNukeIopConverter.h"
 
 using namespace IECoreNuke;
 
@@ -70,9 +70,7 @@ void ImagePrimitiveParameterHandler::setParameterValue( IECore::Parameter *param
 	DD::Image::Iop *iOp = static_cast<DD::Image::Iop *>( *first );
 	if( iOp )
 	{
-		DD::Image::Tile tile( *iOp, iOp->requested_channels(), true );
-		
-		FromNukeTileConverterPtr converter = new FromNukeTileConverter( &tile );
+		FromNukeIopConverterPtr converter = new FromNukeIopConverter( iOp );
 		IECore::ImagePrimitivePtr image = boost::static_pointer_cast<IECore::ImagePrimitive>( converter->convert() );
 		
 		/// \todo Sort out data window vs display window and suchlike.
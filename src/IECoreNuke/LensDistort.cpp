@@ -48,6 +48,8 @@
 #include "IECore/NumericParameter.h"
 #include "boost/algorithm/string.hpp"
 #include "boost/regex.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 #include "IECoreNuke/LensDistort.h"
 
 using namespace DD::Image;
@@ -59,6 +61,60 @@ static const char* const CLASS = "ieLensDistort";
 
 static const char* const HELP = "Applies or removes lens distortion from an input using a parameterised lens model.";
 
+// Computes the distorted positions for a LensDistort's warp grid. The rows of the grid are
+// split into one chunk per lens model, so that each chunk can be computed by a separate task
+// without sharing a lens model between threads.
+class WarpGridBuilder
+{
+	public :
+
+		WarpGridBuilder( const std::vector<IECore::LensModelPtr> &models, DD::Image::Lock *locks, int mode, const Imath::Box2i &window, const Imath::Box2d &inputBox, double width, double height, std::vector<Imath::V2f> &grid )
+			:	m_models( models ), m_locks( locks ), m_mode( mode ), m_window( window ), m_inputBox( inputBox ), m_width( width ), m_height( height ), m_grid( grid )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<int> &range ) const
+		{
+			const int numRows = m_window.size().y + 1;
+			const int numColumns = m_window.size().x + 1;
+			const int numChunks = m_models.size();
+
+			for( int c = range.begin(); c != range.end(); ++c )
+			{
+				Guard l( m_locks[c] );
+				IECore::LensModel *model = m_models[c].get();
+
+				const int rowEnd = ( numRows * (c + 1) ) / numChunks;
+				for( int row = ( numRows * c ) / numChunks; row < rowEnd; ++row )
+				{
+					const double v( double( row + m_window.min.y ) / m_height );
+					Imath::V2f *out = &m_grid[row * numColumns];
+					for( int column = 0; column < numColumns; ++column )
+					{
+						Imath::V2d p( double( column + m_window.min.x ) / m_width, v );
+						Imath::V2d dp = m_mode ? model->distort( p ) : model->undistort( p );
+
+						// Clamp our distorted values to the bounding box.
+						dp.x = std::min( m_inputBox.max.x, std::max( m_inputBox.min.x, dp.x * m_width ) );
+						dp.y = std::min( m_inputBox.max.y, std::max( m_inputBox.min.y, dp.y * m_height ) );
+						out[column] = Imath::V2f( dp.x, dp.y );
+					}
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<IECore::LensModelPtr> &m_models;
+		DD::Image::Lock *m_locks;
+		int m_mode;
+		const Imath::Box2i &m_window;
+		const Imath::Box2d &m_inputBox;
+		double m_width;
+		double m_height;
+		std::vector<Imath::V2f> &m_grid;
+};
+
 DD::Image::Op *LensDistort::build( Node *node ){ return new LensDistort( node ); }
 
 const Iop::Description LensDistort::m_description( CLASS, LensDistort::build );
@@ -228,10 +284,61 @@ void LensDistort::_validate(bool for_real)
 	Imath::Box2i input( Imath::V2i( input0().info().x(), input0().info().y() ), Imath::V2i( input0().info().r()-1, input0().info().t()-1 ) );
 	Imath::Box2i box( m_model[0]->bounds( m_mode, input, format().width(), format().height() ) );
 	info_.set( box.min.x-black, box.min.y-black, box.max.x+black, box.max.y+black );
+
+	if( for_real )
+	{
+		updateWarpGrid();
+	}
 	
 	set_out_channels( Mask_All );
 }
 
+void LensDistort::updateWarpGrid()
+{
+	const Info &inputInfo = input0().info();
+	const Imath::Box2i window( Imath::V2i( info_.x(), info_.y() ), Imath::V2i( info_.r()-1, info_.t()-1 ) );
+
+	DD::Image::Hash hash;
+	hash.append( m_mode );
+	hash.append( m_model[0]->typeName() );
+	for( PluginAttributeList::const_iterator it = m_pluginAttributes.begin(); it != m_pluginAttributes.end(); ++it )
+	{
+		hash.append( it->m_name );
+		hash.append( it->m_value );
+	}
+	hash.append( format().width() );
+	hash.append( format().height() );
+	hash.append( window.min.x );
+	hash.append( window.min.y );
+	hash.append( window.max.x );
+	hash.append( window.max.y );
+	hash.append( inputInfo.x() );
+	hash.append( inputInfo.y() );
+	hash.append( inputInfo.r() );
+	hash.append( inputInfo.t() );
+
+	if( hash == m_warpHash && !m_warpGrid.empty() )
+	{
+		return;
+	}
+
+	m_warpWindow = window;
+	m_warpGrid.clear();
+	if( window.isEmpty() )
+	{
+		m_warpHash = Hash();
+		return;
+	}
+
+	m_warpGrid.resize( ( window.size().x + 1 ) * ( window.size().y + 1 ) );
+
+	const Imath::Box2d inputBox( Imath::V2d( inputInfo.x(), inputInfo.y() ), Imath::V2d( inputInfo.r()-1, inputInfo.t()-1 ) );
+	WarpGridBuilder builder( m_model, m_locks, m_mode, window, inputBox, format().width(), format().height(), m_warpGrid );
+	tbb::parallel_for( tbb::blocked_range<int>( 0, m_nThreads, 1 ), builder );
+
+	m_warpHash = hash;
+}
+
 // Given an output bounding box, compute the input bounding box and request the image data that we need.
 // We do this be using the output size and getting the bounds of the inverse distortion.
 void LensDistort::_request( int x, int y, int r, int t, ChannelMask channels, int count )
@@ -253,59 +360,24 @@ void LensDistort::engine( int y, int x, int r, ChannelMask channels, Row & outro
 		return;
 	}
 
-	const Info &info = input0().info();
-	const double h( format().height() );
-	const double w( format().width() );
-	const double v( double(y)/h );
-	double x_min = std::numeric_limits<double>::max();
-	double x_max = std::numeric_limits<double>::min();
-	double y_min = std::numeric_limits<double>::max();
-	double y_max = std::numeric_limits<double>::min();
-	
-	// Work out which of the array of lens models we should use depending on the current thread.
-	int lensIdx = 0;
-	const Thread::ThreadInfo * f = Thread::thisThread();
-	if( f ) lensIdx=f->index;
-	
-	// Clamp the index to the array range.
-	lensIdx = lensIdx > m_nThreads ? 0 : lensIdx;
-	
-	// Create an array of distorted values that we will populate.
-	Imath::V2d distort[r-x];
-	
-	// Thread safe read of distortion data.
+	if( y < m_warpWindow.min.y || y > m_warpWindow.max.y || x < m_warpWindow.min.x || r-1 > m_warpWindow.max.x )
 	{
-		Guard l( m_locks[lensIdx] );
-		
-		// Distort each pixel on the row, store the result in an array and track the bounding box.
-		for( int i = x; i < r; i++ )
-		{
-			double u = (i+0.0)/w;
-	
-			Imath::V2d &dp( distort[i-x] );
-			Imath::V2d p(u, v);
-			if( m_mode )
-			{
-				dp = m_model[lensIdx]->distort( p );
-			}
-			else
-			{
-				dp = m_model[lensIdx]->undistort( p );
-			}
-			
-			dp.x *= w;
-			dp.y *= h;
-			
-			// Clamp our distorted values to the bounding box.
-			dp.x = std::max( double(info.x()), dp.x );
-			dp.y = std::max( double(info.y()), dp.y );
-			dp.x = std::min( double(info.r()-1), dp.x );
-			dp.y = std::min( double(info.t()-1), dp.y );
-			x_min = std::min( x_min, dp.x );
-			y_min = std::min( y_min, dp.y );
-			x_max = std::max( x_max, dp.x );
-			y_max = std::max( y_max, dp.y );
-		}
+		outrow.erase( channels );
+		return;
+	}
+
+	// Look up the precomputed distortion for this row and track the bounding box.
+	const Imath::V2f *distort = &m_warpGrid[ ( y - m_warpWindow.min.y ) * ( m_warpWindow.size().x + 1 ) + ( x - m_warpWindow.min.x ) ];
+	float x_min = std::numeric_limits<float>::max();
+	float x_max = -std::numeric_limits<float>::max();
+	float y_min = std::numeric_limits<float>::max();
+	float y_max = -std::numeric_limits<float>::max();
+	for( int i = 0; i < r-x; i++ )
+	{
+		x_min = std::min( x_min, distort[i].x );
+		y_min = std::min( y_min, distort[i].y );
+		x_max = std::max( x_max, distort[i].x );
+		y_max = std::max( y_max, distort[i].y );
 	}
 	
 	// Now we know which pixels we'll need, request them!
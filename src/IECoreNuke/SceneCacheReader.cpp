@@ -38,6 +38,9 @@
 
 #include "boost/regex.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "DDImage/SceneView_KnobI.h"
 #include "DDImage/Enumeration_KnobI.h"
 #include "DDImage/GeoSelectKnobI.h"
@@ -96,10 +99,15 @@ class SceneCacheReader::SharedData
 			m_pathPrefix( "" ),
 			m_pathPrefixLength( 0 ),
 			m_scriptFinishedLoading( false ),
-			m_isFirstRun( true )
+			m_isFirstRun( true ),
+			m_filterMatchesValid( false )
 		{
 		}
 
+		// The maximum number of entries held in m_objectCache. When the limit is
+		// reached the cache is cleared before adding a new entry.
+		static const size_t m_maxCachedFrames = 50;
+
 		std::string m_evaluatedFilePath; // Holds the SceneCache file path after any TCL scripts have been evaluated..
 		std::string m_rootText; // Holds the processed root item in the SceneCache.
 		std::string m_filterText; // Processed text to filter the scene with.
@@ -136,6 +144,61 @@ class SceneCacheReader::SharedData
 
 		// A flag which is used to initialize the internal data structures the first time the node is run.
 		bool m_isFirstRun;
+
+		// The indices of the items which matched the last name filter, along with the filter
+		// expression and tag that produced them. When the filter is a plain string and the new
+		// text contains the previous text (as happens when typing into the filter knob) only these
+		// items need to be searched.
+		std::vector<unsigned int> m_filterMatches;
+		std::string m_filterMatchesExpression;
+		std::string m_filterMatchesTag;
+		bool m_filterMatchesValid;
+
+		// Holds the transformed objects produced by loadPrimitives(), keyed by the scene and
+		// selection hashes so that frames which have already been visited needn't be read again.
+		typedef std::map< DD::Image::U64, std::vector<IECore::ConstObjectPtr> > ObjectCache;
+		ObjectCache m_objectCache;
+};
+
+// Reads and transforms the objects for a range of locations. Used by loadPrimitives()
+// to load the selected locations in parallel - the Nuke geometry is then created from
+// the results in a final serial pass, as the GeometryList isn't threadsafe.
+class SceneCacheReader::ObjectLoader
+{
+	public :
+
+		ObjectLoader( const std::vector<IECore::ConstSceneInterfacePtr> &scenes, const IECore::SceneInterface::Path &rootPath, double time, std::vector<IECore::ConstObjectPtr> &objects )
+			:	m_scenes( scenes ), m_rootPath( rootPath ), m_time( time ), m_objects( objects )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const IECore::SceneInterface *scene = m_scenes[i].get();
+				if( !scene || !scene->hasObject() )
+				{
+					continue;
+				}
+
+				IECore::ConstObjectPtr object = scene->readObject( m_time );
+				Imath::M44d transformd = SceneCacheReader::worldTransform( scene, m_rootPath, m_time );
+
+				IECore::TransformOpPtr transformer = new IECore::TransformOp();
+				transformer->inputParameter()->setValue( const_cast< IECore::Object * >(object.get()) );	// safe const_cast because the Op will copy the input object.
+				transformer->copyParameter()->setTypedValue( true );
+				transformer->matrixParameter()->setValue( new IECore::M44dData( transformd ) );
+				m_objects[i] = transformer->operate();
+			}
+		}
+
+	private :
+
+		const std::vector<IECore::ConstSceneInterfacePtr> &m_scenes;
+		const IECore::SceneInterface::Path &m_rootPath;
+		double m_time;
+		std::vector<IECore::ConstObjectPtr> &m_objects;
 };
 
 // A simple function for comparing two strings. Used when sorting a vector of strings.
@@ -150,6 +213,54 @@ bool bothSlashes( char a, char b )
 	    return a == '/' && b == '/';
 }
 
+// Returns true if the filter expression contains no regex syntax, in which case
+// it can be matched with a simple substring search.
+static bool isLiteralExpression( const std::string &expr )
+{
+	return expr.find_first_of( ".[]{}()\\*+?|^$" ) == std::string::npos;
+}
+
+// Flags the items which match a filter expression. Used by filterScene() to
+// search all of the candidate items in parallel.
+class ItemMatcher
+{
+	public :
+
+		ItemMatcher( const std::vector<std::string> &items, const std::vector<unsigned int> &candidates, const std::string &expr, bool literal, std::vector<char> &matches )
+			:	m_items( items ), m_candidates( candidates ), m_expr( expr ), m_literal( literal ), m_matches( matches )
+		{
+			if( !m_literal )
+			{
+				m_regex = boost::regex( m_expr );
+			}
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const std::string &itemName( m_items[ m_candidates[i] ] );
+				if( m_literal )
+				{
+					m_matches[i] = itemName.find( m_expr ) != std::string::npos;
+				}
+				else
+				{
+					m_matches[i] = boost::regex_search( itemName, m_regex );
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<std::string> &m_items;
+		const std::vector<unsigned int> &m_candidates;
+		const std::string &m_expr;
+		bool m_literal;
+		boost::regex m_regex;
+		std::vector<char> &m_matches;
+};
+
 static void buildSceneView( std::vector< std::string > &list, TagMap &tagMap, const IECore::ConstSceneInterfacePtr sceneInterface, int rootPrefixLen );
 
 SceneCacheReader::SceneCacheReader( Node *node )
@@ -582,7 +693,11 @@ void SceneCacheReader::rebuildSceneView()
 		validate( false );
 	}
 
-	Hash newSceneHash( sceneHash() );
+	// The items and tags don't vary with time, so unlike sceneHash() we
+	// don't include the frame, and only rebuild when the file or root change.
+	Hash newSceneHash;
+	newSceneHash.append( m_data->m_evaluatedFilePath );
+	newSceneHash.append( m_data->m_rootText );
 
 	// Check to see if the scene has changed. If it has then we need to 
 	// rebuild our internal representation of it.
@@ -602,6 +717,7 @@ void SceneCacheReader::rebuildSceneView()
 
 		// Reset our internal data structures.
 		m_data->m_tagMap.clear();
+		m_data->m_filterMatchesValid = false;
 	
 		// Clear the SceneView_knob.
 		std::vector<std::string> sceneItems;
@@ -712,39 +828,54 @@ void SceneCacheReader::filterScene( const std::string &filterText, const std::st
 	
 	if( expr != "/" && expr != "*" && expr != "" )
 	{
-		// Get the filter text that we will use to filter the scene.
-		try
+		const bool literal = isLiteralExpression( expr );
+
+		// Decide which items need to be searched. When the user is typing a plain
+		// string into the filter knob each new expression contains the last one,
+		// so only the items that matched previously can possibly match now.
+		std::vector<unsigned int> candidates;
+		if(
+			m_data->m_filterMatchesValid && literal && isLiteralExpression( m_data->m_filterMatchesExpression ) &&
+			m_data->m_filterMatchesTag == filterTag && expr.find( m_data->m_filterMatchesExpression ) != std::string::npos
+		)
 		{
-			// Loop over all of the items in the scene and create a unique list of all entries whose name matches our regular expression.
-			boost::regex expression( expr );
-			
-			if( filterByTag ) // Filter by tag and expression
+			candidates.swap( m_data->m_filterMatches );
+		}
+		else if( filterByTag )
+		{
+			candidates = m_data->m_tagMap[filterTag];
+		}
+		else
+		{
+			candidates.reserve( sceneItems.size() );
+			for( unsigned int i = 0; i < sceneItems.size(); ++i )
 			{
-				for( std::vector<unsigned int>::const_iterator it = m_data->m_tagMap[filterTag].begin(); it != m_data->m_tagMap[filterTag].end(); ++it )
-				{
-					const std::string &itemName( sceneItems[*it] );
-					boost::sregex_token_iterator iter( itemName.begin(), itemName.end(), expression, 0 );
-					boost::sregex_token_iterator end;
-					if( iter != end )
-					{
-						// Append the index to our vector of filtered items.
-						filteredIndices.push_back( *it );
-					}
-				}
+				candidates.push_back( i );
 			}
-			else // Only filter by expression.
+		}
+
+		m_data->m_filterMatchesValid = false;
+
+		try
+		{
+			// Match the candidates in parallel, then gather the matching indices in order.
+			std::vector<char> matches( candidates.size(), 0 );
+			ItemMatcher matcher( sceneItems, candidates, expr, literal, matches );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, candidates.size() ), matcher );
+
+			for( size_t i = 0; i < candidates.size(); ++i )
 			{
-				for( std::vector<std::string>::const_iterator it = sceneItems.begin(); it != sceneItems.end(); ++it )
+				if( matches[i] )
 				{
-					boost::sregex_token_iterator iter( it->begin(), it->end(), expression, 0 );
-					boost::sregex_token_iterator end;
-					if( iter != end )
-					{
-						// Append the index to our vector of filtered items.
-						filteredIndices.push_back( it-sceneItems.begin() );
-					}
+					// Append the index to our vector of filtered items.
+					filteredIndices.push_back( candidates[i] );
 				}
 			}
+
+			m_data->m_filterMatches = filteredIndices;
+			m_data->m_filterMatchesExpression = expr;
+			m_data->m_filterMatchesTag = filterTag;
+			m_data->m_filterMatchesValid = true;
 		}
 		catch(...)
 		{
@@ -758,24 +889,15 @@ void SceneCacheReader::filterScene( const std::string &filterText, const std::st
 			if( filterByTag )
 			{
 				// Just filter the items with the chosen the tag.
-				const std::vector<unsigned int> &tagIndices( m_data->m_tagMap[filterTag] );
-				if( !tagIndices.empty() )
-				{
-					filteredIndices.reserve( tagIndices.size() );
-					for( std::vector<unsigned int>::const_iterator it( tagIndices.begin() ); it != tagIndices.end(); ++it )
-					{
-						filteredIndices.push_back( *it );	
-					}
-				}
+				filteredIndices = m_data->m_tagMap[filterTag];
 			}
 			else
 			{
 				// Don't filter any of the results.
 				filteredIndices.reserve( sceneItems.size() );
-				for( std::vector<std::string>::const_iterator it( sceneItems.begin() ); it != sceneItems.end(); ++it )
+				for( unsigned int i = 0; i < sceneItems.size(); ++i )
 				{
-					int index = it - sceneItems.begin(); 
-					filteredIndices.push_back( index );	
+					filteredIndices.push_back( i );
 				}
 			}
 		}
@@ -858,6 +980,34 @@ void SceneCacheReader::updateTagFilterKnob()
 	}
 }
 
+// Builds the lists of items and tags for a range of children. Used by buildSceneView()
+// to traverse sibling locations in parallel.
+class ChildSceneViewBuilder
+{
+	public :
+
+		ChildSceneViewBuilder( const IECore::SceneInterface *parent, const IECore::SceneInterface::NameList &childNames, int rootPrefixLen, std::vector< std::vector<std::string> > &lists, std::vector<TagMap> &tagMaps )
+			:	m_parent( parent ), m_childNames( childNames ), m_rootPrefixLen( rootPrefixLen ), m_lists( lists ), m_tagMaps( tagMaps )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				buildSceneView( m_lists[i], m_tagMaps[i], m_parent->child( m_childNames[i] ), m_rootPrefixLen );
+			}
+		}
+
+	private :
+
+		const IECore::SceneInterface *m_parent;
+		const IECore::SceneInterface::NameList &m_childNames;
+		int m_rootPrefixLen;
+		std::vector< std::vector<std::string> > &m_lists;
+		std::vector<TagMap> &m_tagMaps;
+};
+
 /// This recursive method traverses the sceneInterface to build a list of item names and a mapping of the tags to the indices in the items.
 static void buildSceneView( std::vector< std::string > &list, TagMap &tagMap, const IECore::ConstSceneInterfacePtr sceneInterface, int rootPrefixLen )
 {
@@ -896,11 +1046,36 @@ static void buildSceneView( std::vector< std::string > &list, TagMap &tagMap, co
 		sceneInterface->childNames( childNames );
 		sort( childNames.begin(), childNames.end(), compareNoCase );
 
-		for ( IECore::SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+		if( childNames.size() == 1 )
 		{
-			IECore::SceneInterface::Name name = *it;
-			const IECore::ConstSceneInterfacePtr childScene = sceneInterface->child( name );
-			buildSceneView( list, tagMap, childScene, rootPrefixLen );
+			buildSceneView( list, tagMap, sceneInterface->child( childNames[0] ), rootPrefixLen );
+			return;
+		}
+
+		// Build the views of the children in parallel and then append them in order,
+		// offsetting the tagged indices by the number of items which precede them.
+		std::vector< std::vector<std::string> > childLists( childNames.size() );
+		std::vector<TagMap> childTagMaps( childNames.size() );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, childNames.size() ), ChildSceneViewBuilder( sceneInterface.get(), childNames, rootPrefixLen, childLists, childTagMaps ) );
+
+		for( size_t i = 0; i < childNames.size(); ++i )
+		{
+			const unsigned int offset = list.size();
+			for( TagMap::const_iterator tIt = childTagMaps[i].begin(); tIt != childTagMaps[i].end(); ++tIt )
+			{
+				std::vector<unsigned int> &indices = tagMap[tIt->first];
+				for( std::vector<unsigned int>::const_iterator iIt = tIt->second.begin(); iIt != tIt->second.end(); ++iIt )
+				{
+					indices.push_back( *iIt + offset );
+				}
+			}
+
+			std::vector<std::string> &childList = childLists[i];
+			list.resize( offset + childList.size() );
+			for( size_t j = 0; j < childList.size(); ++j )
+			{
+				list[offset+j].swap( childList[j] );
+			}
 		}
 	}
 }
@@ -1006,12 +1181,32 @@ void SceneCacheReader::create_geometry( DD::Image::Scene &scene, DD::Image::Geom
 			SceneView_KnobI *sceneView( m_sceneKnob->sceneViewKnob() );
 			const std::vector<std::string> &items = sceneView->menu();
 
+			std::vector<std::string> paths;
+			paths.reserve( data->m_selectedItems.size() );
 			for( std::vector<unsigned int>::const_iterator it( data->m_selectedItems.begin() ); it != data->m_selectedItems.end(); ++it )
 			{
 				unsigned int index = *it;
 				if ( index < data->m_filteredToItem.size() )
 				{
-					loadPrimitive( out, items[ data->m_filteredToItem[index] ] );
+					paths.push_back( items[ data->m_filteredToItem[index] ] );
+				}
+			}
+
+			// Read the objects in parallel, then convert them in order.
+			std::vector<IECore::ConstObjectPtr> objects;
+			loadPrimitives( paths, objects );
+
+			for( std::vector<IECore::ConstObjectPtr>::const_iterator it = objects.begin(); it != objects.end(); ++it )
+			{
+				if( !*it )
+				{
+					continue;
+				}
+
+				IECoreNuke::ToNukeGeometryConverterPtr converter = IECoreNuke::ToNukeGeometryConverter::create( *it );
+				if (converter)
+				{
+					converter->convert( out );
 				}
 			}
 		}
@@ -1024,51 +1219,64 @@ void SceneCacheReader::create_geometry( DD::Image::Scene &scene, DD::Image::Geom
 	}
 }
 
-void SceneCacheReader::loadPrimitive( DD::Image::GeometryList &out, const std::string &path )
+void SceneCacheReader::loadPrimitives( const std::vector<std::string> &paths, std::vector<IECore::ConstObjectPtr> &objects )
 {
 	SharedData *data = sharedData();
 
-	std::string itemPath;
-	if( data->m_rootText == "/" )
-	{
-		// Remove the "/root" prefix that was added to the path name.
-		itemPath = path.substr( 5 ); // "/root" is 5 characters long...
-	}
-	else
+	// The scene hash accounts for the file, root and frame, and the selection
+	// hash for the selected items.
+	Hash hash = sceneHash();
+	hash.append( selectionHash() );
+	hash.append( m_worldSpace );
+
+	SharedData::ObjectCache::const_iterator cit = data->m_objectCache.find( hash.value() );
+	if( cit != data->m_objectCache.end() )
 	{
-		// Add the prefix that we removed when creating the entry.
-		itemPath = data->m_pathPrefix + path;
+		objects = cit->second;
+		return;
 	}
 
-	IECore::ConstSceneInterfacePtr sceneInterface( getSceneInterface( itemPath ) );
-	if( sceneInterface )
+	// Resolve the locations serially, as getSceneInterface() reports errors on the Op.
+	std::vector<IECore::ConstSceneInterfacePtr> scenes;
+	scenes.reserve( paths.size() );
+	for( std::vector<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it )
 	{
-		double time = outputContext().frame() / DD::Image::root_real_fps();
-		IECore::ConstObjectPtr object = sceneInterface->readObject( time );
-		IECore::SceneInterface::Path rootPath;
-		if( m_worldSpace )
+		std::string itemPath;
+		if( data->m_rootText == "/" )
 		{
-			IECore::SceneInterface::stringToPath( "/", rootPath );
+			// Remove the "/root" prefix that was added to the path name.
+			itemPath = it->substr( 5 ); // "/root" is 5 characters long...
 		}
 		else
 		{
-			IECore::SceneInterface::stringToPath( data->m_rootText, rootPath );
+			// Add the prefix that we removed when creating the entry.
+			itemPath = data->m_pathPrefix + *it;
 		}
 
-		Imath::M44d transformd;
-		transformd = worldTransform( sceneInterface, rootPath, time );
-		IECore::TransformOpPtr transformer = new IECore::TransformOp();
-		transformer->inputParameter()->setValue( const_cast< IECore::Object * >(object.get()) );	// safe const_cast because the Op will copy the input object.
-		transformer->copyParameter()->setTypedValue( true );
-		transformer->matrixParameter()->setValue( new IECore::M44dData( transformd ) );
-		object = transformer->operate();
-		
-		IECoreNuke::ToNukeGeometryConverterPtr converter = IECoreNuke::ToNukeGeometryConverter::create( object );
-		if (converter)
-		{
-			converter->convert( out );
-		}
+		scenes.push_back( getSceneInterface( itemPath ) );
+	}
+
+	IECore::SceneInterface::Path rootPath;
+	if( m_worldSpace )
+	{
+		IECore::SceneInterface::stringToPath( "/", rootPath );
+	}
+	else
+	{
+		IECore::SceneInterface::stringToPath( data->m_rootText, rootPath );
+	}
+
+	double time = outputContext().frame() / DD::Image::root_real_fps();
+
+	objects.clear();
+	objects.resize( scenes.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, scenes.size() ), ObjectLoader( scenes, rootPath, time, objects ) );
+
+	if( data->m_objectCache.size() >= SharedData::m_maxCachedFrames )
+	{
+		data->m_objectCache.clear();
 	}
+	data->m_objectCache[hash.value()] = objects;
 }
 
 Imath::M44d SceneCacheReader::worldTransform( IECore::ConstSceneInterfacePtr scene, IECore::SceneInterface::Path root, double time )
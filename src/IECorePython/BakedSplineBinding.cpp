@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/python.hpp"
+
+#include "IECore/BakedSpline.h"
+#include "IECore/VectorTypedData.h"
+
+#include "IECorePython/BakedSplineBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
+
+using namespace boost::python;
+using namespace std;
+using namespace IECore;
+
+namespace IECorePython
+{
+
+template<typename T>
+static boost::python::tuple interval( const T &s )
+{
+	typename T::XInterval i = s.interval();
+	return boost::python::make_tuple( i.lower(), i.upper() );
+}
+
+template<typename T>
+static typename TypedData<vector<typename T::YType> >::Ptr evaluateVector( const T &s, typename TypedData<vector<typename T::XType> >::ConstPtr x )
+{
+	typename TypedData<vector<typename T::YType> >::Ptr y = new TypedData<vector<typename T::YType> >;
+	ScopedGILRelease gilRelease;
+	s( x->readable(), y->writable() );
+	return y;
+}
+
+template<typename T>
+void bindBakedSpline( const char *name )
+{
+	class_<T>( name, no_init )
+		.def( init<const typename T::SplineType &, optional<size_t> >( ( arg( "spline" ), arg( "numSamples" ) = 256 ) ) )
+		.def( "interval", &interval<T> )
+		.def( "numSamples", &T::numSamples )
+		.def( "error", &T::error )
+		.def( "__call__", (typename T::YType (T::*)( typename T::XType ) const)&T::operator() )
+		.def( "__call__", &evaluateVector<T>, "Returns an array of values when given an array of x positions." )
+	;
+}
+
+void bindBakedSpline()
+{
+	bindBakedSpline<BakedSplineff>( "BakedSplineff" );
+	bindBakedSpline<BakedSplinedd>( "BakedSplinedd" );
+	bindBakedSpline<BakedSplinefColor3f>( "BakedSplinefColor3f" );
+	bindBakedSpline<BakedSplinefColor4f>( "BakedSplinefColor4f" );
+}
+
+} // namespace IECorePython
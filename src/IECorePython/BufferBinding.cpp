@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/python.hpp"
+
+#include <cstring>
+
+#include "IECorePython/BufferBinding.h"
+
+using namespace boost::python;
+using namespace IECore;
+
+namespace
+{
+
+enum FormatKind
+{
+	Invalid,
+	Signed,
+	Unsigned,
+	Float
+};
+
+FormatKind formatKind( const char *format )
+{
+	// skip native byte order and alignment specifiers
+	if( *format == '@' || *format == '=' )
+	{
+		format++;
+	}
+
+	if( !*format || format[1] )
+	{
+		// we only support single values
+		return Invalid;
+	}
+
+	if( strchr( "bhilq", *format ) )
+	{
+		return Signed;
+	}
+	else if( strchr( "BHILQ", *format ) )
+	{
+		return Unsigned;
+	}
+	else if( strchr( "efd", *format ) )
+	{
+		return Float;
+	}
+
+	return Invalid;
+}
+
+int getBuffer( PyObject *exporter, Py_buffer *view, int flags )
+{
+	IECorePython::Buffer &buffer = extract<IECorePython::Buffer &>( exporter );
+	return buffer.getBuffer( exporter, view, flags );
+}
+
+bool isWritable( const IECorePython::Buffer &buffer )
+{
+	return buffer.isWritable();
+}
+
+DataPtr data( const IECorePython::Buffer &buffer )
+{
+	return boost::const_pointer_cast<Data>( buffer.data() );
+}
+
+} // namespace
+
+namespace IECorePython
+{
+
+Buffer::Buffer( ConstDataPtr data, const void *address, size_t numElements, size_t numComponents, const char *format, size_t itemSize, bool writable )
+	:	m_data( data ), m_address( address ), m_format( format ), m_itemSize( itemSize ), m_writable( writable )
+{
+	m_ndim = numComponents > 1 ? 2 : 1;
+	m_shape[0] = numElements;
+	m_shape[1] = numComponents;
+	m_strides[0] = numComponents * itemSize;
+	m_strides[1] = itemSize;
+}
+
+ConstDataPtr Buffer::data() const
+{
+	return m_data;
+}
+
+bool Buffer::isWritable() const
+{
+	return m_writable;
+}
+
+int Buffer::getBuffer( PyObject *exporter, Py_buffer *view, int flags )
+{
+	if( ( flags & PyBUF_WRITABLE ) == PyBUF_WRITABLE && !m_writable )
+	{
+		PyErr_SetString( PyExc_BufferError, "Buffer is not writable. Use toBuffer( writable = True ) to create a writable buffer." );
+		view->obj = NULL;
+		return -1;
+	}
+
+	Py_INCREF( exporter );
+	view->obj = exporter;
+	view->buf = const_cast<void *>( m_address );
+	view->len = m_shape[0] * m_strides[0];
+	view->readonly = !m_writable;
+	view->itemsize = m_itemSize;
+	view->format = ( flags & PyBUF_FORMAT ) == PyBUF_FORMAT ? const_cast<char *>( m_format ) : NULL;
+	view->ndim = m_ndim;
+	view->shape = ( flags & PyBUF_ND ) == PyBUF_ND ? m_shape : NULL;
+	view->strides = ( flags & PyBUF_STRIDES ) == PyBUF_STRIDES ? m_strides : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+
+	return 0;
+}
+
+bool compatibleBufferFormat( const char *format, Py_ssize_t itemSize, const char *nativeFormat, Py_ssize_t nativeItemSize )
+{
+	if( !format )
+	{
+		// unsigned bytes
+		format = "B";
+	}
+
+	if( itemSize != nativeItemSize )
+	{
+		return false;
+	}
+
+	const FormatKind kind = formatKind( format );
+	return kind != Invalid && kind == formatKind( nativeFormat );
+}
+
+void bindBuffer()
+{
+	class_<Buffer>( "Buffer", "Exposes the memory of a VectorTypedData object via the python buffer protocol.", no_init )
+		.def( "isWritable", &isWritable )
+		.def( "data", &data, "Returns the data which owns the memory of the buffer." )
+	;
+
+	// Boost.Python doesn't support the buffer protocol, so we add it
+	// to the type object ourselves.
+
+	PyTypeObject *type = (PyTypeObject *)converter::registered<Buffer>::converters.get_class_object();
+
+	static PyBufferProcs bufferProcs;
+	bufferProcs.bf_getbuffer = getBuffer;
+	bufferProcs.bf_releasebuffer = NULL;
+
+	type->tp_as_buffer = &bufferProcs;
+#ifdef Py_TPFLAGS_HAVE_NEWBUFFER
+	type->tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+	PyType_Modified( type );
+}
+
+} // namespace IECorePython
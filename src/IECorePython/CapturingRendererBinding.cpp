@@ -38,14 +38,62 @@
 
 #include "IECore/CapturingRenderer.h"
 #include "IECore/Group.h"
+#include "IECore/MessageHandler.h"
 
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILLock.h"
 
 #include "IECorePython/CapturingRendererBinding.h"
 
 using namespace boost::python;
 using namespace IECore;
 
+namespace
+{
+
+class SinkWrapper : public RefCountedWrapper<CapturingRenderer::Sink>
+{
+	public :
+
+		SinkWrapper( PyObject *self )
+			: RefCountedWrapper<CapturingRenderer::Sink>( self )
+		{
+		}
+
+		virtual void write( ConstGroupPtr group )
+		{
+			ScopedGILLock gilLock;
+			try
+			{
+				object o = this->methodOverride( "write" );
+				if( o )
+				{
+					o( group->copy() );
+				}
+				else
+				{
+					msg( Msg::Error, "SinkWrapper::write", "write() python method not defined" );
+				}
+			}
+			catch( error_already_set )
+			{
+				PyErr_Print();
+			}
+			catch( const std::exception &e )
+			{
+				msg( Msg::Error, "SinkWrapper::write", e.what() );
+			}
+			catch( ... )
+			{
+				msg( Msg::Error, "SinkWrapper::write", "Caught unknown exception" );
+			}
+		}
+
+};
+
+} // namespace
+
 namespace IECorePython
 {
 
@@ -56,9 +104,16 @@ GroupPtr world( CapturingRenderer &r )
 
 void bindCapturingRenderer()
 {
-	RunTimeTypedClass<CapturingRenderer>()
+	scope s = RunTimeTypedClass<CapturingRenderer>()
 		.def( init<>() )
 		.def( "world", world )
+		.def( "setSink", &CapturingRenderer::setSink )
+		.def( "getSink", &CapturingRenderer::getSink )
+	;
+
+	RefCountedClass<CapturingRenderer::Sink, RefCounted, SinkWrapper>( "Sink" )
+		.def( init<>() )
+		.def( "write", &CapturingRenderer::Sink::write )
 	;
 }
 
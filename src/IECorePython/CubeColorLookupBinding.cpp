@@ -145,7 +145,7 @@ void bindCubeColorLookup( const char *name )
 {
 	class_<T> o = class_<T>( name, no_init )
 		.def( init<>() )
-		.def( "__call__", &T::operator() )
+		.def( "__call__", (typename T::ColorType (T::*)( const typename T::ColorType & ) const)&T::operator() )
 		.def( "dimension", &T::dimension, return_value_policy<copy_const_reference>() )
 		.def( "domain", &T::domain, return_value_policy<copy_const_reference>() )
 		.def( "data", &getData<T> )
@@ -162,6 +162,7 @@ void bindCubeColorLookup( const char *name )
 		enum_< typename T::Interpolation >( "Interpolation" )
 			.value( "NoInterpolation", T::NoInterpolation )
 			.value( "Linear", T::Linear )
+			.value( "Tetrahedral", T::Tetrahedral )
 		;
 	}
 
@@ -43,13 +43,40 @@ using namespace boost;
 using namespace boost::python;
 using namespace IECore;
 
+namespace
+{
+
+CubeColorLookupfDataPtr bake( list transforms, const Imath::V3i &dimension, const Imath::Box3f &domain, CubeColorLookupf::Interpolation interpolation )
+{
+	std::vector<ColorTransformOpPtr> t;
+	for( long i = 0, e = len( transforms ); i < e; ++i )
+	{
+		t.push_back( extract<ColorTransformOpPtr>( transforms[i] ) );
+	}
+	return CubeColorTransformOp::bake( t, dimension, domain, interpolation );
+}
+
+} // namespace
+
 namespace IECorePython
 {
 
 void bindCubeColorTransformOp()
 {
+	using boost::python::arg;
+
 	RunTimeTypedClass<CubeColorTransformOp>()
 		.def( init<>() )
+		.def(
+			"bake", &bake,
+			(
+				arg( "transforms" ),
+				arg( "dimension" ),
+				arg( "domain" ) = Imath::Box3f( Imath::V3f( 0 ), Imath::V3f( 1 ) ),
+				arg( "interpolation" ) = CubeColorLookupf::Linear
+			)
+		)
+		.staticmethod( "bake" )
 	;
 }
 
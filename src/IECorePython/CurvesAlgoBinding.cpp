@@ -41,6 +41,22 @@
 using namespace boost::python;
 using namespace IECore;
 
+namespace
+{
+
+CurvesPrimitivePtr mergeCurvesWrapper( boost::python::list curvesPrimitiveList )
+{
+	int numCurvesPrimitives = boost::python::len( curvesPrimitiveList );
+	std::vector<const CurvesPrimitive *> curvesPrimitives( numCurvesPrimitives );
+	for( int i = 0; i < numCurvesPrimitives; ++i )
+	{
+		curvesPrimitives[i] = extract<const CurvesPrimitive *>( curvesPrimitiveList[i] );
+	}
+	return CurvesAlgo::mergeCurves( curvesPrimitives );
+}
+
+} // namespace
+
 namespace IECorePython
 {
 
@@ -53,6 +69,7 @@ void bindCurvesAlgo()
 
 	def( "resamplePrimitiveVariable", &CurvesAlgo::resamplePrimitiveVariable );
 	def( "deleteCurves", &CurvesAlgo::deleteCurves );
+	def( "mergeCurves", &mergeCurvesWrapper );
 }
 
 } // namespace IECorePython
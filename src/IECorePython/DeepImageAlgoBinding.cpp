@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/python.hpp"
+
+#include "IECore/DeepImageAlgo.h"
+#include "IECorePython/DeepImageAlgoBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
+
+using namespace boost;
+using namespace boost::python;
+using namespace IECore;
+
+namespace IECorePython
+{
+
+static void sortSamples( DeepImageBlock *block )
+{
+	ScopedGILRelease gilRelease;
+	DeepImageAlgo::sortSamples( block );
+}
+
+static void flattenInto( const DeepImageBlock *block, ImagePrimitive *image )
+{
+	ScopedGILRelease gilRelease;
+	DeepImageAlgo::flatten( block, image );
+}
+
+static ImagePrimitivePtr flatten( const DeepImageBlock *block )
+{
+	ScopedGILRelease gilRelease;
+	return DeepImageAlgo::flatten( block );
+}
+
+static DeepImageBlockPtr merge( object blocks )
+{
+	// hold references to the blocks while the GIL is released
+	std::vector<DeepImageBlockPtr> blockPtrs;
+	std::vector<const DeepImageBlock *> blockVector;
+	for( long i = 0, e = len( blocks ); i < e; ++i )
+	{
+		DeepImageBlockPtr block = extract<DeepImageBlockPtr>( blocks[i] );
+		blockPtrs.push_back( block );
+		blockVector.push_back( block.get() );
+	}
+
+	ScopedGILRelease gilRelease;
+	return DeepImageAlgo::merge( blockVector );
+}
+
+void bindDeepImageAlgo()
+{
+	object deepImageAlgoModule( borrowed( PyImport_AddModule( "IECore.DeepImageAlgo" ) ) );
+	scope().attr( "DeepImageAlgo" ) = deepImageAlgoModule;
+
+	scope deepImageAlgoScope( deepImageAlgoModule );
+
+	def( "sortSamples", &sortSamples );
+	def( "flatten", &flatten );
+	def( "flatten", &flattenInto );
+	def( "merge", &merge );
+}
+
+} // namespace IECorePython
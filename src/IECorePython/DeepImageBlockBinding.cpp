@@ -0,0 +1,160 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/python.hpp" // this include /must/ come first!
+
+#include "boost/python/suite/indexing/container_utils.hpp"
+
+#include "IECore/DeepImageBlock.h"
+#include "IECore/Exception.h"
+#include "IECore/VectorTypedData.h"
+#include "IECorePython/DeepImageBlockBinding.h"
+#include "IECorePython/RefCountedBinding.h"
+
+using namespace boost::python;
+using namespace IECore;
+
+namespace IECorePython
+{
+
+static DeepImageBlockPtr constructor( const Imath::Box2i &region, object names )
+{
+	std::vector<std::string> channelNames;
+	container_utils::extend_container( channelNames, names );
+	return new DeepImageBlock( region, channelNames );
+}
+
+static StringVectorDataPtr channelNames( const DeepImageBlock &block )
+{
+	return new StringVectorData( block.channelNames() );
+}
+
+static void setSampleCounts( DeepImageBlock &block, object counts )
+{
+	std::vector<unsigned> c;
+	container_utils::extend_container( c, counts );
+	block.setSampleCounts( c );
+}
+
+static unsigned numSamples( const DeepImageBlock &block )
+{
+	return block.numSamples();
+}
+
+static unsigned pixelNumSamples( const DeepImageBlock &block, unsigned pixelIndex )
+{
+	if( pixelIndex >= block.numPixels() )
+	{
+		throw InvalidArgumentException( "Pixel index out of range" );
+	}
+	return block.numSamples( pixelIndex );
+}
+
+static UIntVectorDataPtr sampleOffsets( const DeepImageBlock &block )
+{
+	return new UIntVectorData( block.sampleOffsets() );
+}
+
+static FloatVectorDataPtr planeData( const float *plane, unsigned numSamples )
+{
+	FloatVectorDataPtr result = new FloatVectorData;
+	if( plane )
+	{
+		result->writable().assign( plane, plane + numSamples );
+	}
+	return result;
+}
+
+static void setPlaneData( float *plane, unsigned numSamples, const FloatVectorData *data )
+{
+	if( !data || data->readable().size() != numSamples )
+	{
+		throw InvalidArgumentException( "Data must have one value per sample" );
+	}
+	std::copy( data->readable().begin(), data->readable().end(), plane );
+}
+
+static unsigned validChannelIndex( const DeepImageBlock &block, unsigned channelIndex )
+{
+	if( channelIndex >= block.numChannels() )
+	{
+		throw InvalidArgumentException( "Channel index out of range" );
+	}
+	return channelIndex;
+}
+
+static FloatVectorDataPtr depths( const DeepImageBlock &block )
+{
+	return planeData( block.depths(), block.numSamples() );
+}
+
+static void setDepths( DeepImageBlock &block, const FloatVectorData *data )
+{
+	setPlaneData( block.depths(), block.numSamples(), data );
+}
+
+static FloatVectorDataPtr channelData( const DeepImageBlock &block, unsigned channelIndex )
+{
+	return planeData( block.channelData( validChannelIndex( block, channelIndex ) ), block.numSamples() );
+}
+
+static void setChannelData( DeepImageBlock &block, unsigned channelIndex, const FloatVectorData *data )
+{
+	setPlaneData( block.channelData( validChannelIndex( block, channelIndex ) ), block.numSamples(), data );
+}
+
+void bindDeepImageBlock()
+{
+	RefCountedClass<DeepImageBlock, RefCounted>( "DeepImageBlock" )
+		.def( "__init__", make_constructor( &constructor, default_call_policies(), ( arg_( "region" ), arg_( "channelNames" ) ) ) )
+		.def( "region", &DeepImageBlock::region, return_value_policy<copy_const_reference>() )
+		.def( "numPixels", &DeepImageBlock::numPixels )
+		.def( "pixelIndex", &DeepImageBlock::pixelIndex )
+		.def( "numChannels", &DeepImageBlock::numChannels )
+		.def( "channelNames", &channelNames )
+		.def( "channelIndex", &DeepImageBlock::channelIndex )
+		.def( "setSampleCounts", &setSampleCounts )
+		.def( "numSamples", &numSamples )
+		.def( "numSamples", &pixelNumSamples )
+		.def( "sampleOffsets", &sampleOffsets )
+		.def( "depths", &depths )
+		.def( "setDepths", &setDepths )
+		.def( "channelData", &channelData )
+		.def( "setChannelData", &setChannelData )
+		.def( "pixel", &DeepImageBlock::pixel )
+		.def( "setPixel", &DeepImageBlock::setPixel )
+	;
+}
+
+} // namespace IECorePython
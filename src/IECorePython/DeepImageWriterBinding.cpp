@@ -75,6 +75,7 @@ void bindDeepImageWriter()
 {
 	RunTimeTypedClass<DeepImageWriter>()
 		.def( "writePixel", &DeepImageWriter::writePixel, ( arg_( "x" ), arg_( "y" ), arg_( "pixel" ) ) )
+		.def( "writeBlock", &DeepImageWriter::writeBlock, ( arg_( "block" ) ) )
 		.def( "create", &DeepImageWriter::create ).staticmethod( "create" )
 		.def( "supportedExtensions", ( list(*)( ) )&supportedExtensions )
 		.def( "supportedExtensions", ( list(*)( TypeId ) )&supportedExtensions )
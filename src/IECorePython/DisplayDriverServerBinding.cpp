@@ -51,8 +51,9 @@ void bindDisplayDriverServer()
 	using boost::python::arg;
 
 	RunTimeTypedClass<DisplayDriverServer>()
-		.def( init< int >( ( arg( "portNumber" ) = 0 ) ) )
+		.def( init< int, int >( ( arg( "portNumber" ) = 0, arg( "numThreads" ) = 0 ) ) )
 		.def( "portNumber", &DisplayDriverServer::portNumber )
+		.def( "numThreads", &DisplayDriverServer::numThreads )
 	;
 
 }
@@ -53,6 +53,7 @@ void bindEXRImageReader()
 		.def( init<>() )
 		.def( init<const std::string &>() )
 		.def( "canRead", &EXRImageReader::canRead ).staticmethod( "canRead" )
+		.def( "alignedDataWindow", &EXRImageReader::alignedDataWindow )
 	;
 
 }
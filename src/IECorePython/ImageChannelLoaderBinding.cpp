@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+// This include needs to be the very first to prevent problems with warnings
+// regarding redefinition of _POSIX_C_SOURCE
+#include "boost/python.hpp"
+#include "boost/python/suite/indexing/container_utils.hpp"
+
+#include "IECore/ImageChannelLoader.h"
+#include "IECore/ImagePrimitive.h"
+#include "IECore/VectorTypedData.h"
+#include "IECorePython/ImageChannelLoaderBinding.h"
+#include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
+
+using namespace boost::python;
+using namespace IECore;
+
+namespace IECorePython
+{
+
+static DataPtr channel( ImageChannelLoader &l, const std::string &name )
+{
+	ScopedGILRelease gilRelease;
+	return l.channel( name )->copy();
+}
+
+static StringVectorDataPtr channelNames( const ImageChannelLoader &l )
+{
+	return new StringVectorData( l.channelNames() );
+}
+
+static void load( ImageChannelLoader &l, ImagePrimitivePtr image, object names )
+{
+	std::vector<std::string> n;
+	boost::python::container_utils::extend_container( n, names );
+	ScopedGILRelease gilRelease;
+	l.load( image.get(), n );
+}
+
+void bindImageChannelLoader()
+{
+	RefCountedClass<ImageChannelLoader, RefCounted>( "ImageChannelLoader" )
+		.def( init<ImageReaderPtr, optional<ObjectPoolPtr> >() )
+		.def( "fileName", &ImageChannelLoader::fileName, return_value_policy<copy_const_reference>() )
+		.def( "dataWindow", &ImageChannelLoader::dataWindow, return_value_policy<copy_const_reference>() )
+		.def( "displayWindow", &ImageChannelLoader::displayWindow, return_value_policy<copy_const_reference>() )
+		.def( "channelNames", &channelNames )
+		.def( "channel", &channel )
+		.def( "cached", &ImageChannelLoader::cached )
+		.def( "image", &ImageChannelLoader::image )
+		.def( "load", &load )
+		.def( "objectPool", &ImageChannelLoader::objectPool, return_value_policy<CastToIntrusivePtr>() )
+	;
+}
+
+}
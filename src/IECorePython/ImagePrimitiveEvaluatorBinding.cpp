@@ -35,8 +35,10 @@
 #include "boost/python.hpp"
 
 #include "IECore/ImagePrimitiveEvaluator.h"
+#include "IECore/VectorTypedData.h"
 #include "IECorePython/ImagePrimitiveEvaluatorBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace IECore;
 using namespace boost::python;
@@ -55,6 +57,14 @@ struct ImagePrimitiveEvaluatorHelper
 		return evaluator.pointAtPixel( pixel, result );
 	}
 
+	static FloatVectorDataPtr channelsAtUVs( ImagePrimitiveEvaluator &evaluator, const V2fVectorData *uvs, const StringVectorData *channelNames )
+	{
+		FloatVectorDataPtr result = new FloatVectorData;
+		ScopedGILRelease gilRelease;
+		evaluator.channelsAtUVs( uvs->readable(), channelNames->readable(), result->writable() );
+		return result;
+	}
+
 	static object R( ImagePrimitiveEvaluator &evaluator )
 	{
 		PrimitiveVariableMap::const_iterator it = evaluator.R();
@@ -133,6 +143,7 @@ void bindImagePrimitiveEvaluator()
 	object m = RunTimeTypedClass<ImagePrimitiveEvaluator>()
 		.def( init< ImagePrimitivePtr > () )
 		.def( "pointAtPixel", &ImagePrimitiveEvaluatorHelper::pointAtPixel )
+		.def( "channelsAtUVs", &ImagePrimitiveEvaluatorHelper::channelsAtUVs )
 		.def( "R", &ImagePrimitiveEvaluatorHelper::R )
 		.def( "G", &ImagePrimitiveEvaluatorHelper::G )
 		.def( "B", &ImagePrimitiveEvaluatorHelper::B )
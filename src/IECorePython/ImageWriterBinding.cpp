@@ -34,10 +34,14 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/python.hpp"
+#include "boost/python/suite/indexing/container_utils.hpp"
 
 #include "IECore/ImageWriter.h"
+#include "IECore/CompoundData.h"
+#include "IECore/VectorTypedData.h"
 #include "IECorePython/ImageWriterBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using std::string;
 using namespace boost;
@@ -47,11 +51,34 @@ using namespace IECore;
 namespace IECorePython
 {
 
+static void beginImage( ImageWriter &writer, const Imath::Box2i &displayWindow, const Imath::Box2i &dataWindow, const list &channelNames, ConstCompoundDataPtr blindData )
+{
+	std::vector<std::string> names;
+	boost::python::container_utils::extend_container( names, channelNames );
+	writer.beginImage( displayWindow, dataWindow, names, blindData.get() );
+}
+
+static void writeBlock( ImageWriter &writer, const Imath::Box2i &box, ConstFloatVectorDataPtr data )
+{
+	ScopedGILRelease gilRelease;
+	const std::vector<float> &d = data->readable();
+	writer.writeBlock( box, d.size() ? &d[0] : 0, d.size() );
+}
+
+static void endImage( ImageWriter &writer )
+{
+	ScopedGILRelease gilRelease;
+	writer.endImage();
+}
+
 void bindImageWriter()
 {
 	RunTimeTypedClass<ImageWriter>()
 		.def( "canWrite", &ImageWriter::canWrite ).staticmethod( "canWrite" )
 		.def( "destinationColorSpace", &ImageWriter::destinationColorSpace )
+		.def( "beginImage", &beginImage, ( arg( "displayWindow" ), arg( "dataWindow" ), arg( "channelNames" ), arg( "blindData" ) = object() ) )
+		.def( "writeBlock", &writeBlock )
+		.def( "endImage", &endImage )
 	;
 }
 
@@ -306,6 +306,8 @@ void bindIndexedIOBase()
 			.value("Append", IndexedIO::Append)
 			.value("Shared", IndexedIO::Shared)
 			.value("Exclusive", IndexedIO::Exclusive)
+			.value("MemoryMapped", IndexedIO::MemoryMapped)
+			.value("LazyIndex", IndexedIO::LazyIndex)
 			.export_values()
 		;
 
@@ -408,7 +410,28 @@ void bindIndexedIOBase()
 
 void bindStreamIndexedIO()
 {
-	IECorePython::RunTimeTypedClass<StreamIndexedIO>();
+	IECorePython::RunTimeTypedClass<StreamIndexedIO> streamIndexedIOClass;
+	{
+		scope s( streamIndexedIOClass );
+
+		enum_< StreamIndexedIO::Compression >( "Compression" )
+			.value( "Gzip", StreamIndexedIO::Gzip )
+			.value( "LZ4", StreamIndexedIO::LZ4 )
+			.value( "Zstd", StreamIndexedIO::Zstd )
+			.export_values()
+		;
+	}
+
+	streamIndexedIOClass
+		.def( "setCompression", &StreamIndexedIO::setCompression )
+		.def( "getCompression", &StreamIndexedIO::getCompression )
+		.def( "setDefaultCompression", &StreamIndexedIO::setDefaultCompression ).staticmethod( "setDefaultCompression" )
+		.def( "getDefaultCompression", &StreamIndexedIO::getDefaultCompression ).staticmethod( "getDefaultCompression" )
+		.def( "compressionAvailable", &StreamIndexedIO::compressionAvailable ).staticmethod( "compressionAvailable" )
+		.def( "setDataCompression", &StreamIndexedIO::setDataCompression, ( arg( "enabled" ), arg( "compression" ) = StreamIndexedIO::Gzip, arg( "shuffle" ) = true, arg( "minSize" ) = 1024 ) )
+		.def( "getDataCompression", &StreamIndexedIO::getDataCompression )
+		.def( "indexMemoryUsage", &StreamIndexedIO::indexMemoryUsage )
+	;
 }
 
 void bindFileIndexedIO()
@@ -139,14 +139,13 @@ class PythonLRUCache : public LRUCache<object, object>
 
 } // namespace
 
-typedef LRUCache<int, int> TestCache;
-
 static int get( int key, size_t &cost )
 {
 	cost = 1;
 	return key;
 }
 
+template<typename TestCache>
 struct GetFromTestCache
 {
 	public :
@@ -182,14 +181,17 @@ struct GetFromTestCache
 		
 };
 	
+template<template<typename> class Policy>
 void testLRUCacheThreading( int numIterations, int numValues, int maxCost, int clearFrequency = 0 )
 {
+	typedef LRUCache<int, int, Policy> TestCache;
+
 	// do lots of parallel cache accesses. then clear the cache in the main
 	// thread and check that it has emptied successfully, to ensure that the
 	// cost counting has been accurate.
 
 	TestCache cache( get, maxCost );
-	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache( cache, numValues, clearFrequency ) );
+	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache<TestCache>( cache, numValues, clearFrequency ) );
 	
 	if( cache.currentCost() > cache.getMaxCost() )
 	{
@@ -205,7 +207,7 @@ void testLRUCacheThreading( int numIterations, int numValues, int maxCost, int c
 	// as above, but using setMaxCost( 0 ) to clear the cache.
 
 	TestCache cache2( get, maxCost );
-	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache( cache2, numValues, clearFrequency ) );
+	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache<TestCache>( cache2, numValues, clearFrequency ) );
 
 	if( cache2.currentCost() > cache2.getMaxCost() )
 	{
@@ -221,6 +223,13 @@ void testLRUCacheThreading( int numIterations, int numValues, int maxCost, int c
 
 void IECorePython::bindLRUCache()
 {
+
+	class_<LRUCacheStatistics>( "LRUCacheStatistics" )
+		.def_readonly( "hits", &LRUCacheStatistics::hits )
+		.def_readonly( "misses", &LRUCacheStatistics::misses )
+		.def_readonly( "evictions", &LRUCacheStatistics::evictions )
+		.def_readonly( "getterTime", &LRUCacheStatistics::getterTime )
+	;
 	
 	class_<PythonLRUCache, boost::noncopyable>( "LRUCache", no_init )
 		.def( init<object, PythonLRUCache::Cost>( ( boost::python::arg_( "getter" ), boost::python::arg_( "maxCost" )=500  ) ) )
@@ -233,12 +242,25 @@ void IECorePython::bindLRUCache()
 		.def( "get", &PythonLRUCache::get )
 		.def( "set", &PythonLRUCache::set )
 		.def( "cached", &PythonLRUCache::cached )
+		.def( "statistics", &PythonLRUCache::statistics )
+		.def( "resetStatistics", &PythonLRUCache::resetStatistics )
 	;
 	
 	/// \todo If we create an IECoreTest module, move this into it.
 	def(
 		"testLRUCacheThreading",
-		testLRUCacheThreading,
+		testLRUCacheThreading<LRUCachePolicy::Exact>,
+		(
+			boost::python::arg( "numIterations" ),
+			boost::python::arg( "numValues" ),
+			boost::python::arg( "maxCost" ),
+			boost::python::arg( "clearFrequency" ) = 0
+		)
+	);
+	
+	def(
+		"testShardedLRUCacheThreading",
+		testLRUCacheThreading<LRUCachePolicy::Sharded>,
 		(
 			boost::python::arg( "numIterations" ),
 			boost::python::arg( "numValues" ),
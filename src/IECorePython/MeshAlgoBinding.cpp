@@ -73,6 +73,22 @@ struct StdPairToTupleConverter
 	}
 };
 
+CompoundDataPtr topology( const MeshPrimitive *mesh )
+{
+	return MeshAlgo::topology( mesh )->copy();
+}
+
+MeshPrimitivePtr mergeMeshesWrapper( boost::python::list meshList )
+{
+	int numMeshes = boost::python::len( meshList );
+	std::vector<const MeshPrimitive *> meshes( numMeshes );
+	for( int i = 0; i < numMeshes; ++i )
+	{
+		meshes[i] = extract<const MeshPrimitive *>( meshList[i] );
+	}
+	return MeshAlgo::mergeMeshes( meshes );
+}
+
 } // namespace anonymous
 
 namespace IECorePython
@@ -88,8 +104,11 @@ void bindMeshAlgo()
 	StdPairToTupleConverter<IECore::PrimitiveVariable, IECore::PrimitiveVariable>();
 
 	def( "calculateTangents", &MeshAlgo::calculateTangents, ( arg_( "uvSet" ) = "st", arg_( "orthoTangents" ) = true, arg_( "position" ) = "P" ) );
+	def( "calculateNormals", &MeshAlgo::calculateNormals, ( arg_( "mesh" ), arg_( "interpolation" ) = PrimitiveVariable::Vertex, arg_( "position" ) = "P" ) );
 	def( "resamplePrimitiveVariable", &MeshAlgo::resamplePrimitiveVariable );
 	def( "deleteFaces", &MeshAlgo::deleteFaces );
+	def( "topology", &topology );
+	def( "mergeMeshes", &mergeMeshesWrapper );
 }
 
 } // namespace IECorePython
@@ -38,6 +38,7 @@
 #include "IECorePython/MeshPrimitiveEvaluatorBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 #include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace IECore;
 using namespace boost::python;
@@ -46,6 +47,18 @@ using namespace IECore;
 namespace IECorePython
 {
 
+static MeshPrimitiveEvaluatorPtr constructor( MeshPrimitivePtr mesh, MeshPrimitiveEvaluator::AccelerationStructure accelerationStructure )
+{
+	// building the acceleration structure can take a while
+	ScopedGILRelease gilRelease;
+	return new MeshPrimitiveEvaluator( mesh, accelerationStructure );
+}
+
+static MeshPrimitiveEvaluatorPtr constructor2( MeshPrimitivePtr mesh )
+{
+	return constructor( mesh, MeshPrimitiveEvaluator::KDTreeAcceleration );
+}
+
 static bool barycentricPosition( const MeshPrimitiveEvaluator &e, unsigned int t, const Imath::V3f &b, PrimitiveEvaluator::Result *r )
 {
 	e.validateResult( r );
@@ -55,7 +68,8 @@ static bool barycentricPosition( const MeshPrimitiveEvaluator &e, unsigned int t
 void bindMeshPrimitiveEvaluator()
 {
 	object m = RunTimeTypedClass<MeshPrimitiveEvaluator>()
-		.def( init< MeshPrimitivePtr > () )
+		.def( "__init__", make_constructor( &constructor ) )
+		.def( "__init__", make_constructor( &constructor2 ) )
 		.def( "barycentricPosition", &barycentricPosition )
 		.def( "uvBound", &MeshPrimitiveEvaluator::uvBound )	
 	;
@@ -63,6 +77,11 @@ void bindMeshPrimitiveEvaluator()
 	{
 		scope ms( m );
 
+		enum_<MeshPrimitiveEvaluator::AccelerationStructure>( "AccelerationStructure" )
+			.value( "KDTreeAcceleration", MeshPrimitiveEvaluator::KDTreeAcceleration )
+			.value( "BVHAcceleration", MeshPrimitiveEvaluator::BVHAcceleration )
+		;
+
 		RefCountedClass<MeshPrimitiveEvaluator::Result, PrimitiveEvaluator::Result>( "Result" )
 			.def( "triangleIndex", &MeshPrimitiveEvaluator::Result::triangleIndex )
 			.def( "barycentricCoordinates", &MeshPrimitiveEvaluator::Result::barycentricCoordinates, return_value_policy<copy_const_reference>() )
@@ -48,10 +48,17 @@ namespace IECorePython
 void bindMeshVertexReorderOp()
 {
 
-	RunTimeTypedClass<MeshVertexReorderOp>()
+	object o = RunTimeTypedClass<MeshVertexReorderOp>()
 		.def( init<>() )
 	;
 
+	scope s( o );
+
+	enum_<MeshVertexReorderOp::Mode>( "Mode" )
+		.value( "Topological", MeshVertexReorderOp::Topological )
+		.value( "VertexCache", MeshVertexReorderOp::VertexCache )
+	;
+
 }
 
 } // namespace IECorePython
@@ -40,9 +40,11 @@
 #include "IECore/CompoundMessageHandler.h"
 #include "IECore/FilteredMessageHandler.h"
 #include "IECore/LevelFilteredMessageHandler.h"
+#include "IECore/AsyncMessageHandler.h"
 #include "IECorePython/MessageHandlerBinding.h"
 #include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/ScopedGILLock.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
@@ -90,6 +92,19 @@ LevelFilteredMessageHandlerPtr levelFilteredMessageHandlerConstructor(MessageHan
 	return new LevelFilteredMessageHandler( handle, level );
 }
 
+AsyncMessageHandlerPtr asyncMessageHandlerConstructor( MessageHandlerPtr handler, size_t maxMessagesPerSecond, size_t queueCapacity )
+{
+	return new AsyncMessageHandler( handler, maxMessagesPerSecond, queueCapacity );
+}
+
+void asyncMessageHandlerFlush( AsyncMessageHandler &h )
+{
+	// The background thread may need the GIL to
+	// output to a handler implemented in Python.
+	ScopedGILRelease gilRelease;
+	h.flush();
+}
+
 } // namespace
 
 void IECorePython::bindMessageHandler()
@@ -141,6 +156,11 @@ void IECorePython::bindMessageHandler()
 		.def( "defaultLevel", &LevelFilteredMessageHandler::defaultLevel ).staticmethod( "defaultLevel" )
 	;
 
+	RefCountedClass<AsyncMessageHandler, FilteredMessageHandler>( "AsyncMessageHandler" )
+		.def( "__init__", make_constructor( &asyncMessageHandlerConstructor, default_call_policies(), ( boost::python::arg_( "handler" ), boost::python::arg_( "maxMessagesPerSecond" ) = 100, boost::python::arg_( "queueCapacity" ) = 10000 ) ) )
+		.def( "flush", &asyncMessageHandlerFlush )
+	;
+
 	scope mhS( mh );
 
 	enum_<MessageHandler::Level>( "Level" )
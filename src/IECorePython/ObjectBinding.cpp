@@ -42,6 +42,7 @@
 #include "IECorePython/ObjectBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 #include "IECorePython/ScopedGILLock.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
@@ -71,13 +72,37 @@ static void registerAbstractType( TypeId typeId, const std::string &typeName )
 	Object::registerType( typeId, typeName, 0, (void*)0 );
 }
 
+static ObjectPtr load( ConstIndexedIOPtr ioInterface, const IndexedIO::EntryID &name, bool parallel )
+{
+	ScopedGILRelease gilRelease;
+	return Object::load( ioInterface, name, parallel );
+}
+
+static void save( const Object &object, IndexedIOPtr ioInterface, const IndexedIO::EntryID &name )
+{
+	ScopedGILRelease gilRelease;
+	object.save( ioInterface, name );
+}
+
+static ObjectPtr copy( const Object &object )
+{
+	ScopedGILRelease gilRelease;
+	return object.copy();
+}
+
+static MurmurHash hash( const Object &object )
+{
+	ScopedGILRelease gilRelease;
+	return object.hash();
+}
+
 void bindObject()
 {
 
 	RunTimeTypedClass<Object>()
 		.def( self == self )
 		.def( self != self )
-		.def( "copy", &Object::copy )
+		.def( "copy", &copy )
 		.def( "copyFrom", (void (Object::*)( const Object * ) )&Object::copyFrom )
 		.def( "isType", (bool (*)( const std::string &) )&Object::isType )
 		.def( "isType", (bool (*)( TypeId) )&Object::isType )
@@ -88,11 +113,11 @@ void bindObject()
 		.def( "create", (ObjectPtr (*)( const std::string &) )&Object::create )
 		.def( "create", (ObjectPtr (*)( TypeId ) )&Object::create )
 		.staticmethod( "create" )
-		.def( "load", (ObjectPtr (*)( ConstIndexedIOPtr, const IndexedIO::EntryID & ) )&Object::load )
+		.def( "load", &load, ( arg( "ioInterface" ), arg( "name" ), arg( "parallel" ) = false ) )
 		.staticmethod( "load" )
-		.def( "save", (void (Object::*)( IndexedIOPtr, const IndexedIO::EntryID & )const )&Object::save )
+		.def( "save", &save )
 		.def( "memoryUsage", (size_t (Object::*)()const )&Object::memoryUsage, "Returns the number of bytes this instance occupies in memory" )
-		.def( "hash", (MurmurHash (Object::*)() const)&Object::hash )
+		.def( "hash", &hash )
 		.def( "hash", (void (Object::*)( MurmurHash & ) const)&Object::hash )
 		.def( "registerType", registerType )
 		.def( "registerType", registerAbstractType )
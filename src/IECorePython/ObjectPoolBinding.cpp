@@ -40,6 +40,7 @@
 
 #include "IECorePython/ObjectPoolBinding.h"
 #include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
@@ -54,7 +55,12 @@ ObjectPtr store( ObjectPool &pool, Object* obj, ObjectPool::StoreMode storeMode
 
 ObjectPtr retrieve( const ObjectPool &pool, MurmurHash key, bool _copy )
 {
-	ConstObjectPtr o = pool.retrieve(key);
+	ConstObjectPtr o;
+	{
+		// the object may be loaded from the DiskObjectPool
+		ScopedGILRelease gilRelease;
+		o = pool.retrieve(key);
+	}
 
 	if ( !o )
 	{
@@ -82,10 +88,20 @@ void bindObjectPool()
 			.value("StoreReference", ObjectPool::StoreReference)
 			.export_values()
 		;
+
+		enum_< ObjectPool::EvictionPolicy > ("EvictionPolicy")
+			.value("ExactLRU", ObjectPool::ExactLRU)
+			.value("ShardedLRU", ObjectPool::ShardedLRU)
+			.value("TwoQueue", ObjectPool::TwoQueue)
+			.value("CostWeighted", ObjectPool::CostWeighted)
+			.export_values()
+		;
 	}
 
 	objectPoolClass
-		.def( init<size_t>() )
+		.def( init<size_t, ObjectPool::EvictionPolicy, DiskObjectPoolPtr>( ( arg( "maxMemory" ), arg( "evictionPolicy" ) = ObjectPool::ShardedLRU, arg( "diskObjectPool" ) = DiskObjectPoolPtr() ) ) )
+		.def( "evictionPolicy", &ObjectPool::evictionPolicy )
+		.def( "diskObjectPool", &ObjectPool::diskObjectPool, return_value_policy<CastToIntrusivePtr>() )
 		.def( "erase", &ObjectPool::erase )
 		.def( "clear", &ObjectPool::clear )
 		.def( "retrieve", &retrieve, ( arg("key"), arg("_copy") = true ) )		/// _copy=false provides low level access to the pointer stored in the cache
@@ -94,6 +110,8 @@ void bindObjectPool()
 		.def( "memoryUsage", &ObjectPool::memoryUsage )
 		.def( "getMaxMemoryUsage", &ObjectPool::getMaxMemoryUsage)
 		.def( "setMaxMemoryUsage", &ObjectPool::setMaxMemoryUsage )
+		.def( "statistics", &ObjectPool::statistics )
+		.def( "resetStatistics", &ObjectPool::resetStatistics )
 		.def( "defaultObjectPool", &ObjectPool::defaultObjectPool, return_value_policy<CastToIntrusivePtr>() )
 		.staticmethod( "defaultObjectPool" )
 	;
@@ -88,6 +88,9 @@ void bindOp()
 		.def( "operate", &operateWithArgs )
 		.def( "__call__", &operate )
 		.def( "__call__", &operateWithArgs )
+		.def( "setResultCaching", &Op::setResultCaching )
+		.def( "getResultCaching", &Op::getResultCaching )
+		.def( "clearResultCache", &Op::clearResultCache ).staticmethod( "clearResultCache" )
 	;
 
 }
@@ -36,6 +36,7 @@
 
 #include "IECore/ParticleReader.h"
 #include "IECore/VectorTypedData.h"
+#include "IECore/PointsPrimitive.h"
 #include "IECorePython/ParticleReaderBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 
@@ -60,6 +61,8 @@ void bindParticleReader()
 		.def( "numParticles", &ParticleReader::numParticles )
 		.def( "attributeNames", &attributeNames )
 		.def( "readAttribute", &ParticleReader::readAttribute )
+		.def( "readAttributeRange", &ParticleReader::readAttributeRange )
+		.def( "readRange", &ParticleReader::readRange )
 	;
 }
 
@@ -36,12 +36,32 @@
 
 #include "IECore/PointsPrimitive.h"
 #include "IECore/PointsPrimitiveEvaluator.h"
+#include "IECore/VectorTypedData.h"
 #include "IECorePython/PointsPrimitiveEvaluatorBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace IECore;
 using namespace boost::python;
 
+namespace
+{
+
+IntVectorDataPtr pointsInRadius( const PointsPrimitiveEvaluator &evaluator, const Imath::V3f &p, float radius )
+{
+	std::vector<size_t> indices;
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		evaluator.pointsInRadius( p, radius, indices );
+	}
+
+	IntVectorDataPtr result = new IntVectorData;
+	result->writable().insert( result->writable().end(), indices.begin(), indices.end() );
+	return result;
+}
+
+} // namespace
+
 namespace IECorePython
 {
 
@@ -49,6 +69,7 @@ void bindPointsPrimitiveEvaluator()
 {
 	scope s = RunTimeTypedClass<PointsPrimitiveEvaluator>()
 		.def( init<PointsPrimitivePtr>() )
+		.def( "pointsInRadius", &pointsInRadius )
 	;
 	
 	RefCountedClass<PointsPrimitiveEvaluator::Result, PrimitiveEvaluator::Result>( "Result" )
@@ -35,8 +35,11 @@
 #include "boost/python.hpp"
 
 #include "IECore/PrimitiveEvaluator.h"
+#include "IECore/CompoundData.h"
+#include "IECore/VectorTypedData.h"
 #include "IECorePython/PrimitiveEvaluatorBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace IECore;
 using namespace boost::python;
@@ -54,6 +57,7 @@ struct PrimitiveEvaluatorHelper
 			PyErr_SetString( PyExc_ValueError, "Null primitive" );
 			throw_error_already_set();
 		}
+		ScopedGILRelease gilRelease;
 		return PrimitiveEvaluator::create( primitive );
 	}
 
@@ -128,6 +132,46 @@ struct PrimitiveEvaluatorHelper
 		return result;
 	}
 
+	static CompoundDataPtr batchResults( const PrimitiveEvaluator::BatchResults &results )
+	{
+		CompoundDataPtr result = new CompoundData;
+		result->writable()["success"] = new BoolVectorData( std::vector<bool>( results.success.begin(), results.success.end() ) );
+		result->writable()["P"] = new V3fVectorData( results.point );
+		result->writable()["N"] = new V3fVectorData( results.normal );
+		result->writable()["uv"] = new V2fVectorData( results.uv );
+		return result;
+	}
+
+	static CompoundDataPtr batchClosestPoint( PrimitiveEvaluator &evaluator, const V3fVectorData *points )
+	{
+		PrimitiveEvaluator::BatchResults results;
+		{
+			ScopedGILRelease gilRelease;
+			evaluator.batchClosestPoint( points->readable(), results );
+		}
+		return batchResults( results );
+	}
+
+	static CompoundDataPtr batchPointAtUV( PrimitiveEvaluator &evaluator, const V2fVectorData *uvs )
+	{
+		PrimitiveEvaluator::BatchResults results;
+		{
+			ScopedGILRelease gilRelease;
+			evaluator.batchPointAtUV( uvs->readable(), results );
+		}
+		return batchResults( results );
+	}
+
+	static CompoundDataPtr batchIntersectionPoint( PrimitiveEvaluator &evaluator, const V3fVectorData *origins, const V3fVectorData *directions, float maxDistance )
+	{
+		PrimitiveEvaluator::BatchResults results;
+		{
+			ScopedGILRelease gilRelease;
+			evaluator.batchIntersectionPoint( origins->readable(), directions->readable(), results, maxDistance );
+		}
+		return batchResults( results );
+	}
+
 	static PrimitivePtr primitive( PrimitiveEvaluator &evaluator )
 	{
 		return evaluator.primitive()->copy();
@@ -181,6 +225,9 @@ void bindPrimitiveEvaluator()
 		.def( "intersectionPoint", intersectionPointMaxDist )
 		.def( "intersectionPoints", intersectionPoints )
 		.def( "intersectionPoints", intersectionPointsMaxDist )
+		.def( "batchClosestPoint", &PrimitiveEvaluatorHelper::batchClosestPoint )
+		.def( "batchPointAtUV", &PrimitiveEvaluatorHelper::batchPointAtUV )
+		.def( "batchIntersectionPoint", &PrimitiveEvaluatorHelper::batchIntersectionPoint, ( arg( "self" ), arg( "origins" ), arg( "directions" ), arg( "maxDistance" ) = Imath::limits<float>::max() ) )
 		.def( "primitive", &PrimitiveEvaluatorHelper::primitive )
 		.def( "volume", &PrimitiveEvaluator::volume )
 		.def( "centerOfGravity", &PrimitiveEvaluator::centerOfGravity )
@@ -56,6 +56,12 @@ struct RadixSortWrapper : public RadixSort
 
 		return result;
 	}
+
+	template<typename T>
+	void sortPairs( TypedData< std::vector<T> > *keys, UIntVectorData *values )
+	{
+		this->RadixSort::sortPairs( keys->writable(), values->writable() );
+	}
 };
 
 void bindRadixSort()
@@ -65,6 +71,11 @@ void bindRadixSort()
 		.def( "sort", &RadixSortWrapper::sort<int> )
 		.def( "sort", &RadixSortWrapper::sort<unsigned int> )
 		.def( "sort", &RadixSortWrapper::sort<float> )
+		.def( "sort", &RadixSortWrapper::sort<int64_t> )
+		.def( "sort", &RadixSortWrapper::sort<uint64_t> )
+		.def( "sort", &RadixSortWrapper::sort<double> )
+		.def( "sortPairs", &RadixSortWrapper::sortPairs<unsigned int> )
+		.def( "sortPairs", &RadixSortWrapper::sortPairs<uint64_t> )
 	;
 }
 
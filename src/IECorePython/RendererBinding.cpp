@@ -239,63 +239,90 @@ static void points( Renderer &r, size_t numPoints, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.points( numPoints, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.points( numPoints, p );
+	}
 }
 
 static void disk( Renderer &r, float radius, float z, float thetaMax, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.disk( radius, z, thetaMax, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.disk( radius, z, thetaMax, p );
+	}
 }
 
 static void curves( Renderer &r, const CubicBasisf &basis, bool periodic, ConstIntVectorDataPtr numVertices, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.curves( basis, periodic, numVertices, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.curves( basis, periodic, numVertices, p );
+	}
 }
 
 static void text( Renderer &r, const std::string &font, const std::string &text, float kerning, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.text( font, text, kerning, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.text( font, text, kerning, p );
+	}
 }
 
 static void sphere( Renderer &r, float radius, float zMin, float zMax, float thetaMax, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.sphere( radius, zMin, zMax, thetaMax, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.sphere( radius, zMin, zMax, thetaMax, p );
+	}
 }
 
 static void image( Renderer &r, const Imath::Box2i &dataWindow, const Imath::Box2i &displayWindow, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.image( dataWindow, displayWindow, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.image( dataWindow, displayWindow, p );
+	}
 }
 
 static void mesh( Renderer &r, ConstIntVectorDataPtr vertsPerFace, ConstIntVectorDataPtr vertIds, const std::string &interpolation, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.mesh( vertsPerFace, vertIds, interpolation, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.mesh( vertsPerFace, vertIds, interpolation, p );
+	}
 }
 
 static void nurbs( Renderer &r, int uOrder, ConstFloatVectorDataPtr uKnot, float uMin, float uMax, int vOrder, ConstFloatVectorDataPtr vKnot, float vMin, float vMax, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.nurbs( uOrder, uKnot, uMin, uMax, vOrder, vKnot, vMin, vMax, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.nurbs( uOrder, uKnot, uMin, uMax, vOrder, vKnot, vMin, vMax, p );
+	}
 }
 
 static void patchMesh( Renderer &r, const CubicBasisf &uBasis, const CubicBasisf &vBasis, int nu, bool uPeriodic, int nv, bool vPeriodic, const dict &primVars )
 {
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.patchMesh( uBasis, vBasis, nu, uPeriodic, nv, vPeriodic, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.patchMesh( uBasis, vBasis, nu, uPeriodic, nv, vPeriodic, p );
+	}
 }
 
 static void geometry( Renderer &r, const std::string &type, const dict &topology, const dict &primVars )
@@ -305,7 +332,10 @@ static void geometry( Renderer &r, const std::string &type, const dict &topology
 
 	PrimitiveVariableMap p;
 	fillPrimitiveVariableMap( p, primVars );
-	r.geometry( type, t, p );
+	{
+		ScopedGILRelease gilRelease;
+		r.geometry( type, t, p );
+	}
 }
 
 static void instanceBegin( Renderer &r, const std::string &name, const dict &parameters )
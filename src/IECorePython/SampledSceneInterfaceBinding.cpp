@@ -105,6 +105,36 @@ ObjectPtr readObjectAtSample( SampledSceneInterface &m, size_t sampleIndex )
 	return 0;
 }
 
+static tuple readTransformSamples( const SampledSceneInterface &m, double startTime, double endTime )
+{
+	std::vector<double> times;
+	std::vector<Imath::M44d> transforms;
+	m.readTransformSamples( startTime, endTime, times, transforms );
+
+	list timesList, transformsList;
+	for ( size_t i = 0; i < times.size(); ++i )
+	{
+		timesList.append( times[i] );
+		transformsList.append( transforms[i] );
+	}
+	return make_tuple( timesList, transformsList );
+}
+
+static tuple readObjectSamples( const SampledSceneInterface &m, double startTime, double endTime )
+{
+	std::vector<double> times;
+	std::vector<ConstObjectPtr> objects;
+	m.readObjectSamples( startTime, endTime, times, objects );
+
+	list timesList, objectsList;
+	for ( size_t i = 0; i < times.size(); ++i )
+	{
+		timesList.append( times[i] );
+		objectsList.append( objects[i] ? objects[i]->copy() : ObjectPtr() );
+	}
+	return make_tuple( timesList, objectsList );
+}
+
 void bindSampledSceneInterface()
 {
 	RunTimeTypedClass<SampledSceneInterface>()
@@ -126,6 +156,8 @@ void bindSampledSceneInterface()
 		.def( "transformSampleInterval", &transformSampleInterval )
 		.def( "attributeSampleInterval", &attributeSampleInterval )
 		.def( "objectSampleInterval", &objectSampleInterval )
+		.def( "readTransformSamples", &readTransformSamples )
+		.def( "readObjectSamples", &readObjectSamples )
 	;
 }
 
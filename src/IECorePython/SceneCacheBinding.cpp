@@ -38,6 +38,8 @@
 
 #include "IECore/SceneCache.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 #include "IECorePython/SceneCacheBinding.h"
 
@@ -49,6 +51,7 @@ namespace IECorePython
 
 static SceneCachePtr constructor( const std::string &fileName, IndexedIO::OpenMode mode )
 {
+	ScopedGILRelease gilRelease;
 	return new SceneCache( fileName, mode );
 }
 
@@ -57,11 +60,67 @@ static SceneCachePtr constructor2( IECore::IndexedIOPtr indexedIO )
 	return new SceneCache( indexedIO );
 }
 
+static void close( SceneCache &s )
+{
+	ScopedGILRelease gilRelease;
+	s.close();
+}
+
+static dict cacheStatistics()
+{
+	SceneCache::CacheStatistics stats = SceneCache::cacheStatistics();
+	dict result;
+	result["hits"] = stats.hits;
+	result["misses"] = stats.misses;
+	result["memoryUsage"] = stats.memoryUsage;
+	return result;
+}
+
+static list pathsToList( const std::vector<SceneInterface::Path> &paths )
+{
+	list result;
+	for ( std::vector<SceneInterface::Path>::const_iterator it = paths.begin(); it != paths.end(); ++it )
+	{
+		std::string path;
+		SceneInterface::pathToString( *it, path );
+		result.append( path );
+	}
+	return result;
+}
+
+static list taggedLocations( const SceneCache &s, const SceneInterface::Name &tag )
+{
+	std::vector<SceneInterface::Path> paths;
+	{
+		ScopedGILRelease gilRelease;
+		s.taggedLocations( tag, paths );
+	}
+	return pathsToList( paths );
+}
+
+static list locationsIntersecting( const SceneCache &s, const Imath::Box3d &bound )
+{
+	std::vector<SceneInterface::Path> paths;
+	{
+		ScopedGILRelease gilRelease;
+		s.locationsIntersecting( bound, paths );
+	}
+	return pathsToList( paths );
+}
+
 void bindSceneCache()
 {
 	RunTimeTypedClass<SceneCache>()
 		.def( "__init__", make_constructor( &constructor ), "Opens a scene file for read or write." )
 		.def( "__init__", make_constructor( &constructor2 ), "Opens a scene from a previously opened file handle." )
+		.def( "cacheObjectPool", &SceneCache::cacheObjectPool, return_value_policy<CastToIntrusivePtr>() ).staticmethod( "cacheObjectPool" )
+		.def( "cacheStatistics", &cacheStatistics ).staticmethod( "cacheStatistics" )
+		.def( "clearCache", &SceneCache::clearCache ).staticmethod( "clearCache" )
+		.def( "setGeometryCompression", &SceneCache::setGeometryCompression )
+		.def( "getGeometryCompression", &SceneCache::getGeometryCompression )
+		.def( "close", &close, "Finishes writing the file, throwing if any errors occurred." )
+		.def( "taggedLocations", &taggedLocations, "Returns the paths of the locations at or below this one with the given local tag." )
+		.def( "locationsIntersecting", &locationsIntersecting, "Returns the paths of the locations at or below this one whose bound intersects the given one, in the space of the root." )
 	;
 }
 
@@ -38,6 +38,7 @@
 #include "IECore/SharedSceneInterfaces.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 #include "IECorePython/IECoreBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 #include "IECorePython/SceneInterfaceBinding.h"
 
@@ -149,7 +150,29 @@ static dict readObjectPrimitiveVariables( const SceneInterface &m, list varNameL
 	SceneInterface::NameList v;
 	listToSceneInterfaceNameList( varNameList, v );
 
-	PrimitiveVariableMap varMap = m.readObjectPrimitiveVariables( v, time );
+	PrimitiveVariableMap varMap;
+	{
+		ScopedGILRelease gilRelease;
+		varMap = m.readObjectPrimitiveVariables( v, time );
+	}
+	dict result;
+	for ( PrimitiveVariableMap::const_iterator it = varMap.begin(); it != varMap.end(); it++ )
+	{
+		result[ it->first ] = it->second;
+	}
+	return result;
+}
+
+static dict readObjectPrimitiveVariableRange( const SceneInterface &m, list varNameList, double time, size_t begin, size_t end )
+{
+	SceneInterface::NameList v;
+	listToSceneInterfaceNameList( varNameList, v );
+
+	PrimitiveVariableMap varMap;
+	{
+		ScopedGILRelease gilRelease;
+		varMap = m.readObjectPrimitiveVariableRange( v, time, begin, end );
+	}
 	dict result;
 	for ( PrimitiveVariableMap::const_iterator it = varMap.begin(); it != varMap.end(); it++ )
 	{
@@ -177,8 +200,15 @@ void writeTags( SceneInterface &m, list tagList )
 	m.writeTags(v);	
 }
 
+Imath::Box3d readBound( const SceneInterface &m, double time )
+{
+	ScopedGILRelease gilRelease;
+	return m.readBound( time );
+}
+
 DataPtr readTransform( SceneInterface &m, double time )
 {
+	ScopedGILRelease gilRelease;
 	ConstDataPtr t = m.readTransform(time);
 	if ( t )
 	{
@@ -187,8 +217,15 @@ DataPtr readTransform( SceneInterface &m, double time )
 	return 0;
 }
 
+Imath::M44d readTransformAsMatrix( const SceneInterface &m, double time )
+{
+	ScopedGILRelease gilRelease;
+	return m.readTransformAsMatrix( time );
+}
+
 ObjectPtr readAttribute( SceneInterface &m, const SceneInterface::Name &name, double time )
 {
+	ScopedGILRelease gilRelease;
 	ConstObjectPtr o = m.readAttribute(name,time);
 	if ( o )
 	{
@@ -199,6 +236,7 @@ ObjectPtr readAttribute( SceneInterface &m, const SceneInterface::Name &name, do
 
 ObjectPtr readObject( SceneInterface &m, double time )
 {
+	ScopedGILRelease gilRelease;
 	ConstObjectPtr o = m.readObject(time);
 	if ( o )
 	{
@@ -207,8 +245,140 @@ ObjectPtr readObject( SceneInterface &m, double time )
 	return 0;
 }
 
+void writeObject( SceneInterface &m, const Object *object, double time )
+{
+	ScopedGILRelease gilRelease;
+	m.writeObject( object, time );
+}
+
+static void listToPaths( list l, std::vector<SceneInterface::Path> &paths )
+{
+	int listLen = IECorePython::len( l );
+	paths.resize( listLen );
+	for ( int i = 0; i < listLen; i++ )
+	{
+		extract< std::string > ex( l[i] );
+		if ( ex.check() )
+		{
+			SceneInterface::stringToPath( ex(), paths[i] );
+		}
+		else
+		{
+			extract< list > exList( l[i] );
+			if ( !exList.check() )
+			{
+				throw IECore::InvalidArgumentException( std::string( "Invalid value! Expecting a list of paths." ) );
+			}
+			listToSceneInterfaceNameList( exList(), paths[i] );
+		}
+	}
+}
+
+static list readBounds( const SceneInterface &m, list pathList, double time )
+{
+	std::vector<SceneInterface::Path> paths;
+	listToPaths( pathList, paths );
+	std::vector<Imath::Box3d> bounds;
+	{
+		ScopedGILRelease gilRelease;
+		m.readBounds( paths, time, bounds );
+	}
+	list result;
+	for ( std::vector<Imath::Box3d>::const_iterator it = bounds.begin(); it != bounds.end(); it++ )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+static list readTransformsAsMatrices( const SceneInterface &m, list pathList, double time )
+{
+	std::vector<SceneInterface::Path> paths;
+	listToPaths( pathList, paths );
+	std::vector<Imath::M44d> transforms;
+	{
+		ScopedGILRelease gilRelease;
+		m.readTransformsAsMatrices( paths, time, transforms );
+	}
+	list result;
+	for ( std::vector<Imath::M44d>::const_iterator it = transforms.begin(); it != transforms.end(); it++ )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+static list readObjects( const SceneInterface &m, list pathList, double time )
+{
+	std::vector<SceneInterface::Path> paths;
+	listToPaths( pathList, paths );
+	std::vector<ConstObjectPtr> objects;
+	{
+		ScopedGILRelease gilRelease;
+		m.readObjects( paths, time, objects );
+	}
+	list result;
+	for ( std::vector<ConstObjectPtr>::const_iterator it = objects.begin(); it != objects.end(); it++ )
+	{
+		if ( *it )
+		{
+			result.append( ObjectPtr( (*it)->copy() ) );
+		}
+		else
+		{
+			result.append( object() );
+		}
+	}
+	return result;
+}
+
+static void prefetch( const SceneInterface &m, list pathList, double startTime, double endTime )
+{
+	std::vector<SceneInterface::Path> paths;
+	listToPaths( pathList, paths );
+	ScopedGILRelease gilRelease;
+	m.prefetch( paths, startTime, endTime );
+}
+
+namespace
+{
+
+// Calls a python callable for each location, with the scene and its path.
+// The callable may return False to skip the children of the location.
+class PythonVisitor : public SceneInterface::Visitor
+{
+
+	public :
+
+		PythonVisitor( object callable )
+			:	m_callable( callable )
+		{
+		}
+
+		virtual bool visit( const SceneInterface *scene, const SceneInterface::Path &path )
+		{
+			SceneInterface::Path p( path );
+			object result = m_callable( SceneInterfacePtr( const_cast<SceneInterface *>( scene ) ), arrayToList( p ) );
+			return result.ptr() == Py_None || extract<bool>( result );
+		}
+
+	private :
+
+		object m_callable;
+
+};
+
+} // namespace
+
+static void traverse( const SceneInterface &m, object callable )
+{
+	PythonVisitor visitor( callable );
+	m.traverse( visitor );
+}
+
 static MurmurHash sceneHash( SceneInterface &m, SceneInterface::HashType hashType, double time )
 {
+	ScopedGILRelease gilRelease;
 	MurmurHash h;
 	m.hash( hashType, time, h );
 	return h;
@@ -260,10 +430,10 @@ void bindSceneInterface()
 		.def( "fileName", &SceneInterface::fileName )
 		.def( "pathAsString", pathAsString )
 		.def( "name", &SceneInterface::name )
-		.def( "readBound", &SceneInterface::readBound )
+		.def( "readBound", &readBound )
 		.def( "writeBound", &SceneInterface::writeBound )
 		.def( "readTransform", &readTransform )
-		.def( "readTransformAsMatrix", &SceneInterface::readTransformAsMatrix )
+		.def( "readTransformAsMatrix", &readTransformAsMatrix )
 		.def( "writeTransform", &SceneInterface::writeTransform )
 		.def( "hasAttribute", &SceneInterface::hasAttribute )
 		.def( "attributeNames", attributeNames )
@@ -274,13 +444,19 @@ void bindSceneInterface()
 		.def( "writeTags", writeTags )
 		.def( "readObject", &readObject )
 		.def( "readObjectPrimitiveVariables", &readObjectPrimitiveVariables )
-		.def( "writeObject", &SceneInterface::writeObject )
+		.def( "readObjectPrimitiveVariableRange", &readObjectPrimitiveVariableRange )
+		.def( "writeObject", &writeObject )
 		.def( "hasObject", &SceneInterface::hasObject )
 		.def( "hasChild", &SceneInterface::hasChild )
 		.def( "childNames", &childNames )
 		.def( "child", nonConstChild, ( arg( "name" ), arg( "missingBehaviour" ) = SceneInterface::ThrowIfMissing ) )
 		.def( "createChild", &SceneInterface::createChild )
 		.def( "scene", &nonConstScene, ( arg( "path" ), arg( "missingBehaviour" ) = SceneInterface::ThrowIfMissing ) )
+		.def( "readBounds", &readBounds )
+		.def( "readTransformsAsMatrices", &readTransformsAsMatrices )
+		.def( "readObjects", &readObjects )
+		.def( "prefetch", &prefetch )
+		.def( "traverse", &traverse )
 		.def( "hash", &sceneHash )
 
 		.def( "pathToString", pathToString ).staticmethod("pathToString")
@@ -470,6 +470,8 @@ void bindTypeId()
 		.value( "EXRDeepImageReader", EXRDeepImageReaderTypeId )
 		.value( "EXRDeepImageWriter", EXRDeepImageWriterTypeId )
 		.value( "ExternalProcedural", ExternalProceduralTypeId )
+		.value( "ImageWriterDisplayDriver", ImageWriterDisplayDriverTypeId )
+		.value( "BoxBlurOp", BoxBlurOpTypeId )
 	;
 	
 	converter::registry::push_back(
@@ -57,6 +57,7 @@ void bindWarpOp()
 	enum_<WarpOp::FilterType>( "FilterType" )
 		.value( "Bilinear", WarpOp::Bilinear )
 		.value( "None", WarpOp::None )
+		.value( "Bicubic", WarpOp::Bicubic )
 	;
 
 }
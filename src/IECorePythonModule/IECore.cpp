@@ -51,6 +51,7 @@
 #include "IECorePython/GeometricTypedDataBinding.h"
 #include "IECorePython/SimpleTypedDataBinding.h"
 #include "IECorePython/VectorTypedDataBinding.h"
+#include "IECorePython/BufferBinding.h"
 #include "IECorePython/ObjectBinding.h"
 #include "IECorePython/TypeIdBinding.h"
 #include "IECorePython/CompoundDataBinding.h"
@@ -91,6 +92,7 @@
 #include "IECorePython/ShaderBinding.h"
 #include "IECorePython/SearchPathBinding.h"
 #include "IECorePython/CachedReaderBinding.h"
+#include "IECorePython/ImageChannelLoaderBinding.h"
 #include "IECorePython/ParameterisedBinding.h"
 #include "IECorePython/OpBinding.h"
 #include "IECorePython/ObjectParameterBinding.h"
@@ -185,8 +187,11 @@
 #include "IECorePython/MeshVertexReorderOpBinding.h"
 #include "IECorePython/SplineBinding.h"
 #include "IECorePython/SplineDataBinding.h"
+#include "IECorePython/BakedSplineBinding.h"
 #include "IECorePython/DisplayDriverBinding.h"
 #include "IECorePython/ImageDisplayDriverBinding.h"
+#include "IECorePython/ImageWriterDisplayDriverBinding.h"
+#include "IECorePython/BoxBlurOpBinding.h"
 #include "IECorePython/CoordinateSystemBinding.h"
 #include "IECorePython/ClientDisplayDriverBinding.h"
 #include "IECorePython/DisplayDriverServerBinding.h"
@@ -275,6 +280,8 @@
 #include "IECorePython/DataConvertOpBinding.h"
 #include "IECorePython/PNGImageReaderBinding.h"
 #include "IECorePython/DeepPixelBinding.h"
+#include "IECorePython/DeepImageBlockBinding.h"
+#include "IECorePython/DeepImageAlgoBinding.h"
 #include "IECorePython/DeepImageReaderBinding.h"
 #include "IECorePython/DeepImageWriterBinding.h"
 #include "IECorePython/DeepImageConverterBinding.h"
@@ -296,6 +303,7 @@
 #include "IECorePython/StandardRadialLensModelBinding.h"
 #include "IECorePython/LensDistortOpBinding.h"
 #include "IECorePython/ObjectPoolBinding.h"
+#include "IECorePython/DiskObjectPoolBinding.h"
 #include "IECorePython/EXRDeepImageReaderBinding.h"
 #include "IECorePython/EXRDeepImageWriterBinding.h"
 #include "IECorePython/ExternalProceduralBinding.h"
@@ -304,6 +312,9 @@
 #include "IECorePython/MeshAlgoBinding.h"
 #include "IECorePython/CurvesAlgoBinding.h"
 #include "IECorePython/PointsAlgoBinding.h"
+#include "IECorePython/ProceduralAlgoBinding.h"
+#include "IECorePython/ProfilingBinding.h"
+#include "IECorePython/SceneCacheAlgoBinding.h"
 #include "IECore/IECore.h"
 
 using namespace IECorePython;
@@ -324,6 +335,7 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindData();
 	bindGeometricTypedData();
 	bindAllSimpleTypedData();
+	bindBuffer();
 	bindAllVectorTypedData();
 	bindCompoundData();
 	bindIndexedIO();
@@ -367,6 +379,7 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindShader();
 	bindSearchPath();
 	bindCachedReader();
+	bindImageChannelLoader();
 	bindObjectParameter();
 	bindModifyOp();
 	bindPrimitiveOp();
@@ -472,12 +485,15 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindMeshVertexReorderOp();
 	bindSpline();
 	bindSplineData();
+	bindBakedSpline();
 	bindCoordinateSystem();
 
 #ifdef IECORE_WITH_ASIO
 
 	bindDisplayDriver();
 	bindImageDisplayDriver();
+	bindImageWriterDisplayDriver();
+	bindBoxBlurOp();
 	bindClientDisplayDriver();
 	bindDisplayDriverServer();
 	// see note in Sconstruct re IECORE_WITH_ASIO and OBJReader
@@ -575,6 +591,8 @@ BOOST_PYTHON_MODULE(_IECore)
 #endif
 	
 	bindDeepPixel();
+	bindDeepImageBlock();
+	bindDeepImageAlgo();
 	bindDeepImageReader();
 	bindDeepImageWriter();
 	bindDeepImageConverter();
@@ -595,6 +613,7 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindLensModel();
 	bindStandardRadialLensModel();
 	bindLensDistortOp();
+	bindDiskObjectPool();
 	bindObjectPool();
 	bindExternalProcedural();
 	bindClippingPlane();
@@ -602,6 +621,9 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindMeshAlgo();
 	bindCurvesAlgo();
 	bindPointsAlgo();
+	bindProceduralAlgo();
+	bindProfiling();
+	bindSceneCacheAlgo();
 
 #ifdef IECORE_WITH_DEEPEXR
 
@@ -33,12 +33,14 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/algorithm/string.hpp"
+#include "boost/bind.hpp"
 #include "boost/filesystem/convenience.hpp"
 #include "boost/format.hpp"
 
 #include "IECore/FileNameParameter.h"
 
 #include "IECoreRI/DTEXDeepImageReader.h"
+#include "IECoreRI/private/DeepTileCache.h"
 
 using namespace IECore;
 using namespace IECoreRI;
@@ -136,29 +138,66 @@ DeepPixelPtr DTEXDeepImageReader::doReadPixel( int x, int y )
 		return 0;
 	}
 	
+	return m_tileCache->readPixel( x, y );
+}
+
+DeepImageBlockPtr DTEXDeepImageReader::doReadBlock( const Imath::Box2i &region )
+{
+	open( true );
+	
+	return m_tileCache->readBlock( region );
+}
+
+DeepImageBlockPtr DTEXDeepImageReader::readTile( const Imath::Box2i &region )
+{
+	std::vector<std::string> names;
+	channelNames( names );
+	DeepImageBlockPtr result = new DeepImageBlock( region, names );
+	
+	// The sample counts aren't known until each pixel has been read,
+	// so we gather all the samples before filling the block.
+	std::vector<unsigned> sampleCounts;
+	sampleCounts.reserve( result->numPixels() );
+	std::vector<float> samples;
+	for ( int y=region.min.y; y <= region.max.y; ++y )
+	{
+		for ( int x=region.min.x; x <= region.max.x; ++x )
+		{
+			sampleCounts.push_back( readSamples( x, y, samples ) );
+		}
+	}
+	
+	result->setSampleCounts( sampleCounts );
+	if ( result->numSamples() )
+	{
+		result->setInterleavedSamples( &samples[0] );
+	}
+	
+	return result;
+}
+
+unsigned DTEXDeepImageReader::readSamples( int x, int y, std::vector<float> &samples )
+{
 	if ( m_dtexImage->GetPixel( x, y, m_dtexPixel ) != RixDeepTexture::k_ErrNOERR )
 	{
 		return 0;
 	}
 	
 	int numSamples = m_dtexPixel->GetNumPoints();
-	if ( !numSamples )
+	if ( numSamples <= 0 )
 	{
 		return 0;
 	}
 	
-	DeepPixelPtr pixel = new DeepPixel( m_channelNames, numSamples );
-	
-	float depth = 0;
-	float channelData[pixel->numChannels()];
-	
-	for ( int i=0; i < numSamples; ++i )
+	const size_t sampleSize = m_channelNames.size() + 1;
+	size_t current = samples.size();
+	samples.resize( current + numSamples * sampleSize );
+	for ( int i=0; i < numSamples; ++i, current += sampleSize )
 	{
-		m_dtexPixel->GetPoint( i, &depth, channelData );
-		pixel->addSample( depth, channelData );
+		m_dtexPixel->GetPoint( i, &samples[current], &samples[current + 1] );
 	}
 	
-	return pixel;
+	return numSamples;
 }
 
 bool DTEXDeepImageReader::open( bool throwOnFailure )
@@ -197,6 +236,8 @@ bool DTEXDeepImageReader::open( bool throwOnFailure )
 		
 		m_dtexImage->GetNl( m_worldToCamera.getValue() );
 		m_dtexImage->GetNP( m_worldToNDC.getValue() );
+		
+		m_tileCache.reset( new Detail::DeepTileCache( m_dataWindow, boost::bind( &DTEXDeepImageReader::readTile, this, _1 ) ) );
 	}
 	else
 	{
@@ -223,6 +264,8 @@ bool DTEXDeepImageReader::open( bool throwOnFailure )
 
 void DTEXDeepImageReader::cleanRixInterface()
 {
+	m_tileCache.reset();
+	
 	RixDeepTexture *dtexInterface = (RixDeepTexture *)RixGetContext()->GetRixInterface( k_RixDeepTexture );
 	
 	if ( m_dtexPixel )
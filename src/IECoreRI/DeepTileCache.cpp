@@ -0,0 +1,210 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+
+#include "boost/bind.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "IECoreRI/private/DeepTileCache.h"
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreRI::Detail;
+
+struct DeepTileCache::LoadTiles
+{
+
+	LoadTiles( Cache &cache, const std::vector<int> &indices, std::vector<ConstDeepImageBlockPtr> &tiles )
+		:	m_cache( cache ), m_indices( indices ), m_tiles( tiles )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			m_tiles[i] = m_cache.get( m_indices[i] );
+		}
+	}
+
+	private :
+
+		Cache &m_cache;
+		const std::vector<int> &m_indices;
+		std::vector<ConstDeepImageBlockPtr> &m_tiles;
+
+};
+
+struct DeepTileCache::CopyScanlines
+{
+
+	CopyScanlines( const DeepTileCache &cache, const std::vector<ConstDeepImageBlockPtr> &tiles, const V2i &firstTile, int numTilesX, DeepImageBlock *block )
+		:	m_cache( cache ), m_tiles( tiles ), m_firstTile( firstTile ), m_numTilesX( numTilesX ), m_block( block )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<int> &range ) const
+	{
+		const Box2i &region = m_block->region();
+		const unsigned numChannels = m_block->numChannels();
+		const std::vector<unsigned> &offsets = m_block->sampleOffsets();
+
+		for( int y = range.begin(); y != range.end(); ++y )
+		{
+			int x = region.min.x;
+			while( x <= region.max.x )
+			{
+				const V2i t = m_cache.tile( x, y ) - m_firstTile;
+				const DeepImageBlock *tile = m_tiles[t.y * m_numTilesX + t.x].get();
+				const int spanEnd = std::min( region.max.x, tile->region().max.x );
+
+				// the samples for a span of pixels are contiguous in both the tile
+				// and the block, so each plane can be copied in one go.
+				const unsigned srcBegin = tile->sampleOffsets()[tile->pixelIndex( x, y )];
+				const unsigned srcEnd = tile->sampleOffsets()[tile->pixelIndex( spanEnd, y ) + 1];
+				const unsigned dst = offsets[m_block->pixelIndex( x, y )];
+				const size_t n = srcEnd - srcBegin;
+				if( n )
+				{
+					memcpy( m_block->depths() + dst, tile->depths() + srcBegin, n * sizeof( float ) );
+					for( unsigned c = 0; c < numChannels; ++c )
+					{
+						memcpy( m_block->channelData( c ) + dst, tile->channelData( c ) + srcBegin, n * sizeof( float ) );
+					}
+				}
+
+				x = spanEnd + 1;
+			}
+		}
+	}
+
+	private :
+
+		const DeepTileCache &m_cache;
+		const std::vector<ConstDeepImageBlockPtr> &m_tiles;
+		V2i m_firstTile;
+		int m_numTilesX;
+		DeepImageBlock *m_block;
+
+};
+
+DeepTileCache::DeepTileCache( const Imath::Box2i &dataWindow, TileReader tileReader, int tileSize, size_t maxBytes )
+	:	m_dataWindow( dataWindow ), m_tileReader( tileReader ), m_tileSize( tileSize ),
+		m_numTilesX( ( dataWindow.max.x - dataWindow.min.x ) / tileSize + 1 ),
+		m_cache( boost::bind( &DeepTileCache::readTile, this, _1, _2 ), maxBytes )
+{
+}
+
+DeepPixelPtr DeepTileCache::readPixel( int x, int y )
+{
+	ConstDeepImageBlockPtr t = m_cache.get( tileIndex( tile( x, y ) ) );
+	return t->pixel( x, y );
+}
+
+DeepImageBlockPtr DeepTileCache::readBlock( const Imath::Box2i &region )
+{
+	const V2i firstTile = tile( region.min.x, region.min.y );
+	const V2i lastTile = tile( region.max.x, region.max.y );
+	const int numTilesX = lastTile.x - firstTile.x + 1;
+
+	std::vector<int> indices;
+	for( int ty = firstTile.y; ty <= lastTile.y; ++ty )
+	{
+		for( int tx = firstTile.x; tx <= lastTile.x; ++tx )
+		{
+			indices.push_back( tileIndex( V2i( tx, ty ) ) );
+		}
+	}
+
+	std::vector<ConstDeepImageBlockPtr> tiles( indices.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, indices.size(), 1 ), LoadTiles( m_cache, indices, tiles ) );
+
+	DeepImageBlockPtr result = new DeepImageBlock( region, tiles[0]->channelNames() );
+
+	std::vector<unsigned> sampleCounts;
+	sampleCounts.reserve( result->numPixels() );
+	for( int y = region.min.y; y <= region.max.y; ++y )
+	{
+		for( int x = region.min.x; x <= region.max.x; ++x )
+		{
+			const V2i t = tile( x, y ) - firstTile;
+			const DeepImageBlock *block = tiles[t.y * numTilesX + t.x].get();
+			sampleCounts.push_back( block->numSamples( block->pixelIndex( x, y ) ) );
+		}
+	}
+
+	result->setSampleCounts( sampleCounts );
+	if( result->numSamples() )
+	{
+		tbb::parallel_for( tbb::blocked_range<int>( region.min.y, region.max.y + 1 ), CopyScanlines( *this, tiles, firstTile, numTilesX, result.get() ) );
+	}
+
+	return result;
+}
+
+ConstDeepImageBlockPtr DeepTileCache::readTile( int index, size_t &cost )
+{
+	const V2i t( index % m_numTilesX, index / m_numTilesX );
+	Box2i region( m_dataWindow.min + t * m_tileSize );
+	region.max = V2i(
+		std::min( region.min.x + m_tileSize - 1, m_dataWindow.max.x ),
+		std::min( region.min.y + m_tileSize - 1, m_dataWindow.max.y )
+	);
+
+	DeepImageBlockPtr result;
+	{
+		tbb::mutex::scoped_lock lock( m_readerMutex );
+		result = m_tileReader( region );
+	}
+
+	cost = sizeof( DeepImageBlock ) +
+		result->sampleOffsets().size() * sizeof( unsigned ) +
+		result->numSamples() * ( result->numChannels() + 1 ) * sizeof( float );
+
+	return result;
+}
+
+V2i DeepTileCache::tile( int x, int y ) const
+{
+	return V2i( ( x - m_dataWindow.min.x ) / m_tileSize, ( y - m_dataWindow.min.y ) / m_tileSize );
+}
+
+int DeepTileCache::tileIndex( const Imath::V2i &tile ) const
+{
+	return tile.y * m_numTilesX + tile.x;
+}
@@ -44,6 +44,7 @@
 #include "IECore/DespatchTypedData.h"
 #include "IECore/MatrixAlgo.h"
 #include "IECore/ParticleReader.inl"
+#include "IECore/CompoundParameter.h"
 
 #include <algorithm>
 
@@ -64,16 +65,40 @@ IE_CORE_DEFINERUNTIMETYPED( PTCParticleReader );
 const Reader::ReaderDescription<PTCParticleReader> PTCParticleReader::m_readerDescription( "3Dbake 3DWbake ptc" );
 
 PTCParticleReader::PTCParticleReader( )
-	:	ParticleReader( "Reads Renderman point cloud format" ), m_ptcFile( 0 ), m_userDataBuffer( 0 )
+	:	ParticleReader( "Reads Renderman point cloud format" ), m_ptcFile( 0 ), m_nextPoint( 0 ), m_userDataBuffer( 0 )
 {
+	constructParameters();
 }
 
 PTCParticleReader::PTCParticleReader( const std::string &fileName )
-	:	ParticleReader( "Reads Renderman point cloud format" ), m_ptcFile( 0 ), m_userDataBuffer( 0 )
+	:	ParticleReader( "Reads Renderman point cloud format" ), m_ptcFile( 0 ), m_nextPoint( 0 ), m_userDataBuffer( 0 )
 {
+	constructParameters();
 	m_fileNameParameter->setTypedValue( fileName );
 }
 
+void PTCParticleReader::constructParameters()
+{
+	m_boundParameter = new Box3fParameter(
+		"bound",
+		"Particles outside this bound are discarded while the file is read. "
+		"Leave it empty to read all particles.",
+		Box3f()
+	);
+
+	parameters()->addParameter( m_boundParameter );
+}
+
+Box3fParameter *PTCParticleReader::boundParameter()
+{
+	return m_boundParameter.get();
+}
+
+const Box3fParameter *PTCParticleReader::boundParameter() const
+{
+	return m_boundParameter.get();
+}
+
 PTCParticleReader::~PTCParticleReader()
 {
 	close();
@@ -98,6 +123,7 @@ void PTCParticleReader::close()
 		PtcClosePointCloudFile( m_ptcFile );
 		m_ptcFile = NULL;
 	}
+	m_nextPoint = 0;
 	if (m_userDataBuffer)
 	{
 		delete [] m_userDataBuffer;
@@ -260,13 +286,19 @@ ObjectPtr PTCParticleReader::doOperation( const CompoundObject * operands )
 	size_t nParticles = numParticles();
 	PointsPrimitivePtr result = new PointsPrimitive( nParticles );
 
-	CompoundDataPtr attributeObjects = readAttributes( attributes );
+	CompoundDataPtr attributeObjects = readAttributes( attributes, 0, nParticles );
 	if ( !attributeObjects )
 	{
 		throw Exception( ( format( "Failed to load \"%s\"." ) % fileName() ).str() );
 
 	}
 
+	// filtering happens during the read, so the attributes tell us how many points we kept.
+	if( attributeObjects->readable().size() )
+	{
+		result->setNumPoints( despatchTypedData<TypedDataSize, TypeTraits::IsVectorTypedData>( attributeObjects->readable().begin()->second.get() ) );
+	}
+
 	for( vector<string>::const_iterator it = attributes.begin(); it!=attributes.end(); it++ )
 	{
 		CompoundDataMap::const_iterator itData = attributeObjects->readable().find( *it );
@@ -339,7 +371,7 @@ DataPtr PTCParticleReader::readAttribute( const std::string &name )
 {
 	std::vector< std::string > names;
 	names.push_back( name );
-	CompoundDataPtr result = readAttributes( names );
+	CompoundDataPtr result = readAttributes( names, 0, numParticles() );
 	if (!result)
 	{
 		return 0;
@@ -352,13 +384,57 @@ DataPtr PTCParticleReader::readAttribute( const std::string &name )
 	return it->second;
 }
 
-CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string> &names )
+DataPtr PTCParticleReader::readAttributeRange( const std::string &name, size_t begin, size_t end )
+{
+	MurmurHash h = parameters()->getValue()->hash();
+	h.append( (uint64_t)begin );
+	h.append( (uint64_t)end );
+
+	if( !m_rangeAttributes || h != m_rangeHash || !m_rangeAttributes->readable().count( name ) )
+	{
+		std::vector< std::string > names;
+		particleAttributes( names );
+		if( find( names.begin(), names.end(), name ) == names.end() )
+		{
+			names.push_back( name );
+		}
+		m_rangeAttributes = readAttributes( names, begin, end );
+		m_rangeHash = h;
+		if( !m_rangeAttributes )
+		{
+			return 0;
+		}
+	}
+
+	CompoundDataMap::const_iterator it = m_rangeAttributes->readable().find( name );
+	if ( it == m_rangeAttributes->readable().end() )
+	{
+		return 0;
+	}
+	return it->second;
+}
+
+CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string> &names, size_t begin, size_t end )
 {
 	if( !open() )
 	{
 		return 0;
 	}
 
+	begin = std::min( begin, (size_t)m_header.nPoints );
+	end = std::max( begin, std::min( end, (size_t)m_header.nPoints ) );
+
+	// PtcReadDataPoint() can only move forwards, so we must reopen
+	// the file if the range starts before the current position.
+	if( begin < m_nextPoint )
+	{
+		close();
+		if( !open() )
+		{
+			return 0;
+		}
+	}
+
 	CompoundDataPtr result = new CompoundData();
 
 	std::map< std::string, struct AttrInfo > attrInfo;
@@ -371,6 +447,16 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 	float normalBuffer[ 3 ];
 	float radiusBuffer[ 1 ];
 
+	const Box3f &bound = m_boundParameter->getTypedValue();
+	if( !bound.isEmpty() )
+	{
+		// we need the positions to test against the bound, whether or not they were requested.
+		point = &pointBuffer[ 0 ];
+	}
+
+	const float fraction = particlePercentage() / 100.0f;
+	const size_t expectedParticles = bound.isEmpty() ? (size_t)( ( end - begin ) * std::min( fraction, 1.0f ) ) : 0;
+
 	vector<string>::const_iterator it;
 	for( it=names.begin(); it!=names.end(); it++ )
 	{
@@ -420,7 +506,7 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 		case PTCParticleIO::Color:
 			{
 				Color3fVectorDataPtr d = new Color3fVectorData();
-				d->writable().resize( numParticles() );
+				d->writable().reserve( expectedParticles );
 				dataVector = d;
 				break;
 			}
@@ -428,17 +514,17 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 		case PTCParticleIO::Normal:
 		case PTCParticleIO::Vector:
 			v3fVector = new V3fVectorData();
-			v3fVector->writable().resize( numParticles() );
+			v3fVector->writable().reserve( expectedParticles );
 			dataVector = v3fVector;
 			break;
 		case PTCParticleIO::Float:
 			floatVector = new FloatVectorData();
-			floatVector->writable().resize( numParticles() );
+			floatVector->writable().reserve( expectedParticles );
 			dataVector = floatVector;
 			break;
 		case PTCParticleIO::Matrix:
 			matrixVector = new M44fVectorData();
-			matrixVector->writable().resize( numParticles() );
+			matrixVector->writable().reserve( expectedParticles );
 			dataVector = matrixVector;
 		default:
 			msg( Msg::Error, "PTCParticleReader::readAttributes()", format( "Internal error. Unrecognized type '%d' loading attribute %s." ) % type % name );
@@ -454,14 +540,52 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 		attrInfo[ name ] = info;
 	}
 
-	for ( int i = 0; i < m_header.nPoints; i++)
+	// skip to the start of the range without decoding anything.
+	while( m_nextPoint < begin )
+	{
+		if ( !PtcReadDataPoint( m_ptcFile, 0, 0, 0, 0 ) )
+		{
+			msg( Msg::Warning, "PTCParticleReader::readAttributes", format( "Failed to read point %d." ) % m_nextPoint );
+			close();
+			return 0;
+		}
+		m_nextPoint++;
+	}
+
+	// percentage filtering is based on order, so we advance the generator to the
+	// start of the range to keep the same particles as a read of the whole file.
+	/// \todo do we have ids from ptc files to be used in the filtering?
+	const bool filter = fraction < 1.0f;
+	Imath::Rand48 r;
+	r.init( particlePercentageSeed() );
+	for( size_t i = 0; filter && i < begin; i++ )
+	{
+		r.nextf();
+	}
+
+	for ( size_t i = begin; i < end; i++)
 	{
+		// particles rejected by the percentage filter are read without being decoded.
+		const bool keep = !filter || r.nextf() <= fraction;
+
 		const float *attributePtr;
-		if ( !PtcReadDataPoint( m_ptcFile, point, normal, radius, userData ) )
+		if ( !( keep ? PtcReadDataPoint( m_ptcFile, point, normal, radius, userData ) : PtcReadDataPoint( m_ptcFile, 0, 0, 0, 0 ) ) )
 		{
 			msg( Msg::Warning, "PTCParticleReader::readAttributes", format( "Failed to read point %d." ) % i );
+			close();
 			return 0;
 		}
+		m_nextPoint++;
+
+		if( !keep )
+		{
+			continue;
+		}
+
+		if( !bound.isEmpty() && !bound.intersects( V3f( point[0], point[1], point[2] ) ) )
+		{
+			continue;
+		}
 
 		std::map< std::string, struct AttrInfo >::iterator it;
 		for (it = attrInfo.begin(); it != attrInfo.end(); it++)
@@ -471,30 +595,23 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 			{
 			case Color3fVectorDataTypeId :
 				{
-					Color3f &c = static_pointer_cast<Color3fVectorData>(it->second.targetData)->writable()[ i ];
-					c[0] = attributePtr[0];
-					c[1] = attributePtr[1];
-					c[2] = attributePtr[2];
+					static_pointer_cast<Color3fVectorData>(it->second.targetData)->writable().push_back( Color3f( attributePtr[0], attributePtr[1], attributePtr[2] ) );
 					break;
 				}
 			case V3fVectorDataTypeId:
 				{
-					V3f &p = static_pointer_cast<V3fVectorData>(it->second.targetData)->writable()[ i ];
-					p[0] = attributePtr[0];
-					p[1] = attributePtr[1];
-					p[2] = attributePtr[2];
+					static_pointer_cast<V3fVectorData>(it->second.targetData)->writable().push_back( V3f( attributePtr[0], attributePtr[1], attributePtr[2] ) );
 					break;
 				}
 			case FloatVectorDataTypeId:
-				static_pointer_cast<FloatVectorData>(it->second.targetData)->writable()[ i ] = attributePtr[0];
+				static_pointer_cast<FloatVectorData>(it->second.targetData)->writable().push_back( attributePtr[0] );
 				break;
 			case M44fVectorDataTypeId:
 				{
-					M44f &m = static_pointer_cast<M44fVectorData>(it->second.targetData)->writable()[ i ];
-					m = M44f(	attributePtr[0], attributePtr[1], attributePtr[2], attributePtr[3],
+					static_pointer_cast<M44fVectorData>(it->second.targetData)->writable().push_back( M44f(	attributePtr[0], attributePtr[1], attributePtr[2], attributePtr[3],
 								attributePtr[4], attributePtr[5], attributePtr[6], attributePtr[7],
 								attributePtr[8], attributePtr[9], attributePtr[9], attributePtr[10],
-								attributePtr[12], attributePtr[13], attributePtr[14], attributePtr[15]  );
+								attributePtr[12], attributePtr[13], attributePtr[14], attributePtr[15] ) );
 					break;
 				}
 			default:
@@ -504,10 +621,9 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 		}
 	}
 
-	/// \todo do we have ids from ptc files to be used in the filtering?
+	// the particles have already been filtered, so we only need to convert each attribute.
 	const Data *ids = 0;
 	DataPtr filteredData = 0;
-	// filter and convert each attribute individually.
 	std::map< std::string, struct AttrInfo >::const_iterator attrIt;
 	for( attrIt=attrInfo.begin(); attrIt!=attrInfo.end(); attrIt++ )
 	{
@@ -518,10 +634,10 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 			{
 				case ParticleReader::Native :
 				case ParticleReader::Float :
-					filteredData = filterAttr<Color3fVectorData, Color3fVectorData>( static_cast<Color3fVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<Color3fVectorData, Color3fVectorData>( static_cast<Color3fVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 				case ParticleReader::Double :
-					filteredData = filterAttr<Color3dVectorData, Color3fVectorData>( static_cast<Color3fVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<Color3dVectorData, Color3fVectorData>( static_cast<Color3fVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 			}
 			break;
@@ -532,10 +648,10 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 			{
 				case ParticleReader::Native :
 				case ParticleReader::Float :
-					filteredData = filterAttr<V3fVectorData, V3fVectorData>( static_cast<V3fVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<V3fVectorData, V3fVectorData>( static_cast<V3fVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 				case ParticleReader::Double :
-					filteredData = filterAttr<V3dVectorData, V3fVectorData>( static_cast<V3fVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<V3dVectorData, V3fVectorData>( static_cast<V3fVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 			}
 			break;
@@ -544,10 +660,10 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 			{
 				case ParticleReader::Native :
 				case ParticleReader::Float :
-					filteredData = filterAttr<FloatVectorData, FloatVectorData>( static_cast<FloatVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<FloatVectorData, FloatVectorData>( static_cast<FloatVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 				case ParticleReader::Double :
-					filteredData = filterAttr<DoubleVectorData, FloatVectorData>( static_cast<FloatVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<DoubleVectorData, FloatVectorData>( static_cast<FloatVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 			}
 			break;
@@ -556,10 +672,10 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 			{
 				case ParticleReader::Native :
 				case ParticleReader::Float :
-					filteredData = filterAttr<M44fVectorData, M44fVectorData>( static_cast<M44fVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<M44fVectorData, M44fVectorData>( static_cast<M44fVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 				case ParticleReader::Double :
-					filteredData = filterAttr<M44dVectorData, M44fVectorData>( static_cast<M44fVectorData *>( attrIt->second.targetData.get() ), particlePercentage(), ids );
+					filteredData = filterAttr<M44dVectorData, M44fVectorData>( static_cast<M44fVectorData *>( attrIt->second.targetData.get() ), 100.0f, ids );
 					break;
 			}
 			break;
@@ -569,8 +685,6 @@ CompoundDataPtr PTCParticleReader::readAttributes( const std::vector<std::string
 		}
 		result->writable()[attrIt->first] = filteredData;
 	}
-	// close the file so that this function can be called again for other attribute...
-	close();
 
 	return result;
 }
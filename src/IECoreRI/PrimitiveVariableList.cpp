@@ -38,25 +38,49 @@
 #include "IECore/DespatchTypedData.h"
 
 #include "boost/format.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "tbb/concurrent_unordered_set.h"
 
 using namespace IECore;
 using namespace IECoreRI;
 using namespace std;
 using namespace boost;
 
+namespace
+{
+
+// Tokens are interned so that lists for motion samples and instances,
+// which almost always share the same declarations, don't each allocate
+// their own copies. The set never moves its elements, so the c_str()
+// pointers remain valid for the lifetime of the process.
+typedef tbb::concurrent_unordered_set<std::string> TokenSet;
+TokenSet g_tokens;
+
+const char *internedToken( const std::string &token )
+{
+	return g_tokens.insert( token ).first->c_str();
+}
+
+} // namespace
+
 PrimitiveVariableList::PrimitiveVariableList( const IECore::PrimitiveVariableMap &primVars, const std::map<std::string, std::string> *typeHints )
 {
-	// figure out how many strings we need to deal with so we can reserve
-	// enough space for them
+	// expand any indexed primitive variables, since RI has no
+	// equivalent, and figure out how many strings we need to deal
+	// with so we can reserve enough space for them
 	int numStrings = 0;
+	m_expandedData.reserve( primVars.size() );
 	PrimitiveVariableMap::const_iterator it;
 	for( it=primVars.begin(); it!=primVars.end(); it++ )
 	{
-		TypeId type = it->second.data->typeId();
+		m_expandedData.push_back( it->second.expandedData() );
+		const Data *data = m_expandedData.back().get();
+		TypeId type = data->typeId();
 		switch( type )
 		{
 			case StringVectorDataTypeId :
-				numStrings += boost::static_pointer_cast<StringVectorData>( it->second.data )->readable().size();
+				numStrings += static_cast<const StringVectorData *>( data )->readable().size();
 				break;
 
 			case StringDataTypeId :
@@ -71,18 +95,24 @@ PrimitiveVariableList::PrimitiveVariableList( const IECore::PrimitiveVariableMap
 	}
 
 	// reserve the space
-	m_strings.reserve( numStrings );
 	m_charPtrs.reserve( numStrings );
+	m_tokens.reserve( primVars.size() );
+	m_values.reserve( primVars.size() );
 
-	// build the tokens and values arrays
-	for( it=primVars.begin(); it!=primVars.end(); it++ )
+	// build the tokens and values arrays. numeric data is passed straight
+	// through without copying, as its layout already matches what RI expects.
+	std::string token;
+	std::vector<ConstDataPtr>::const_iterator dIt = m_expandedData.begin();
+	for( it=primVars.begin(); it!=primVars.end(); it++, dIt++ )
 	{
 		size_t arraySize = 0;
-		const char *t = type( it->first, it->second.data, arraySize );
+		const char *t = type( it->first, dIt->get(), arraySize );
 		const char *i = interpolation( it->second.interpolation );
 		if( t && i )
 		{
-			// push the interpolation/type/name string
+			// build the interpolation/type/name string
+			token = i;
+			token += " ";
 			if( it->second.interpolation==PrimitiveVariable::Constant && arraySize )
 			{
 				// when interpolation is constant, we should treat anything with
@@ -96,14 +126,19 @@ PrimitiveVariableList::PrimitiveVariableList( const IECore::PrimitiveVariableMap
 					t = "vector";
 				}
 
-				m_strings.push_back( boost::str( boost::format( "%s %s %s[%d]" ) % i % t % it->first % arraySize ) );
+				token += t;
+				token += " ";
+				token += it->first;
+				token += "[" + boost::lexical_cast<string>( arraySize ) + "]";
 			}
 			else
 			{
-				m_strings.push_back( string( i ) + " " + t + " " + it->first );
+				token += t;
+				token += " ";
+				token += it->first;
 			}
-			m_tokens.push_back( m_strings.rbegin()->c_str() );
-			m_values.push_back( value( it->second.data ) );
+			m_tokens.push_back( internedToken( token ) );
+			m_values.push_back( value( dIt->get() ) );
 		}
 	}
 }
@@ -156,31 +191,31 @@ namespace
 }
 
 
-const char *PrimitiveVariableList::type( const std::string &name, ConstDataPtr d, size_t &arraySize )
+const char *PrimitiveVariableList::type( const std::string &name, const IECore::Data *d, size_t &arraySize )
 {
 	arraySize = 0;
 	IECore::TypeId t = d->typeId();
 	switch( t )
 	{
 		case V3fVectorDataTypeId :
-			arraySize = boost::static_pointer_cast<const V3fVectorData>( d )->readable().size();
-			return geometryInterpretationToType( boost::static_pointer_cast<const V3fVectorData>( d )->getInterpretation(), name );
+			arraySize = static_cast<const V3fVectorData *>( d )->readable().size();
+			return geometryInterpretationToType( static_cast<const V3fVectorData *>( d )->getInterpretation(), name );
 		case V3fDataTypeId :
-			return geometryInterpretationToType( boost::static_pointer_cast<const V3fData>( d )->getInterpretation(), name );
+			return geometryInterpretationToType( static_cast<const V3fData *>( d )->getInterpretation(), name );
 		case Color3fVectorDataTypeId :
-			arraySize = boost::static_pointer_cast<const Color3fVectorData>( d )->readable().size();
+			arraySize = static_cast<const Color3fVectorData *>( d )->readable().size();
 		case Color3fDataTypeId :
 			return "color";
 		case FloatVectorDataTypeId :
-			arraySize = boost::static_pointer_cast<const FloatVectorData>( d )->readable().size();
+			arraySize = static_cast<const FloatVectorData *>( d )->readable().size();
 		case FloatDataTypeId :
 			return "float";
 		case IntVectorDataTypeId :
-			arraySize = boost::static_pointer_cast<const IntVectorData>( d )->readable().size();
+			arraySize = static_cast<const IntVectorData *>( d )->readable().size();
 		case IntDataTypeId :
 			return "int";
 		case StringVectorDataTypeId :
-			arraySize = boost::static_pointer_cast<const StringVectorData>( d )->readable().size();
+			arraySize = static_cast<const StringVectorData *>( d )->readable().size();
 		case StringDataTypeId :
 			return "string";
 		default :
@@ -216,17 +251,17 @@ const char *PrimitiveVariableList::interpolation( IECore::PrimitiveVariable::Int
 	}
 }
 
-const void *PrimitiveVariableList::value( IECore::DataPtr d )
+const void *PrimitiveVariableList::value( const IECore::Data *d )
 {
 	if( d->typeId()==StringData::staticTypeId() )
 	{
-		const char *v = boost::static_pointer_cast<StringData>( d )->readable().c_str();
+		const char *v = static_cast<const StringData *>( d )->readable().c_str();
 		m_charPtrs.push_back( v );
 		return &*(m_charPtrs.rbegin());
 	}
 	else if( d->typeId()==StringVectorData::staticTypeId() )
 	{
-		const StringVectorData &sd = static_cast<StringVectorData &>( *d );
+		const StringVectorData &sd = static_cast<const StringVectorData &>( *d );
 		for( unsigned i=0; i<sd.readable().size(); i++ )
 		{
 			m_charPtrs.push_back( sd.readable()[i].c_str() );
@@ -234,5 +269,5 @@ const void *PrimitiveVariableList::value( IECore::DataPtr d )
 		return (&*(m_charPtrs.rbegin())) - ( sd.readable().size() - 1 );
 	}
 
-	return despatchTypedData< TypedDataAddress, TypeTraits::IsTypedData, DespatchTypedDataIgnoreError >( const_cast<Data *>( d.get() ) );
+	return despatchTypedData< TypedDataAddress, TypeTraits::IsTypedData, DespatchTypedDataIgnoreError >( const_cast<Data *>( d ) );
 }
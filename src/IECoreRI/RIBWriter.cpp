@@ -35,6 +35,7 @@
 #include "IECore/FileNameParameter.h"
 #include "IECore/CompoundParameter.h"
 #include "IECore/CompoundData.h"
+#include "IECore/SimpleTypedData.h"
 #include "IECore/Renderable.h"
 #include "IECore/TypedParameter.h"
 
@@ -78,9 +79,37 @@ IECore::ConstBoolParameterPtr RIBWriter::worldBlockParameter() const
 	return m_worldBlockParameter;
 }
 
+IECore::BoolParameterPtr RIBWriter::binaryParameter()
+{
+	return m_binaryParameter;
+}
+
+IECore::ConstBoolParameterPtr RIBWriter::binaryParameter() const
+{
+	return m_binaryParameter;
+}
+
+IECore::BoolParameterPtr RIBWriter::compressParameter()
+{
+	return m_compressParameter;
+}
+
+IECore::ConstBoolParameterPtr RIBWriter::compressParameter() const
+{
+	return m_compressParameter;
+}
+
 void RIBWriter::doWrite( const IECore::CompoundObject *operands )
 {
 	RendererPtr renderer = new Renderer( fileName() );
+	if( m_binaryParameter->getTypedValue() )
+	{
+		renderer->setOption( "ri:rib:format", new IECore::StringData( "binary" ) );
+	}
+	if( m_compressParameter->getTypedValue() )
+	{
+		renderer->setOption( "ri:rib:compression", new IECore::StringData( "gzip" ) );
+	}
 
 	IECore::Renderable *renderable = static_cast<IECore::Renderable *>( const_cast<IECore::Object *>( object() ) );
 	if( !m_worldBlockParameter->getTypedValue() )
@@ -106,4 +135,20 @@ void RIBWriter::constructParameters()
 		false
 	);
 	parameters()->addParameter( m_worldBlockParameter );
+
+	m_binaryParameter = new IECore::BoolParameter(
+		"binary",
+		"If this is on, then the RIB is written in binary rather than "
+		"ASCII form, which is smaller and quicker to parse.",
+		false
+	);
+	parameters()->addParameter( m_binaryParameter );
+
+	m_compressParameter = new IECore::BoolParameter(
+		"compress",
+		"If this is on, then the RIB is compressed with gzip. Compression "
+		"is also used automatically for file names ending in \".gz\".",
+		false
+	);
+	parameters()->addParameter( m_compressParameter );
 }
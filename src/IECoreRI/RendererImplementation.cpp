@@ -48,6 +48,7 @@
 #include "IECore/MurmurHash.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/TypeTraits.h"
+#include "IECore/InstancerAlgo.h"
 
 #include "boost/algorithm/string/case_conv.hpp"
 #include "boost/algorithm/string/predicate.hpp"
@@ -95,6 +96,13 @@ IECoreRI::RendererImplementation::RendererImplementation( const std::string &nam
 	if( name!="" )
 	{
 		RiBegin( (char *)name.c_str() );
+		if( boost::ends_with( name, ".gz" ) )
+		{
+			// must be specified before anything else is written
+			StringDataPtr gzip = new StringData( "gzip" );
+			ParameterList pl( "compression", gzip.get() );
+			RiOptionV( "rib", pl.n(), pl.tokens(), pl.values() );
+		}
 	}
 	else
 	{
@@ -199,6 +207,7 @@ void IECoreRI::RendererImplementation::constructCommon()
 	m_getOptionHandlers["camera:shutter"] = &IECoreRI::RendererImplementation::getShutterOption;
 	m_getOptionHandlers["camera:resolution"] = &IECoreRI::RendererImplementation::getResolutionOption;
 	m_getOptionHandlers["searchPath:font"] = &IECoreRI::RendererImplementation::getFontSearchPathOption;
+	m_getOptionHandlers["ri:automaticInstancing:statistics"] = &IECoreRI::RendererImplementation::getAutomaticInstancingStatisticsOption;
 
 	m_setAttributeHandlers["ri:shadingRate"] = &IECoreRI::RendererImplementation::setShadingRateAttribute;
 	m_setAttributeHandlers["ri:matte"] = &IECoreRI::RendererImplementation::setMatteAttribute;
@@ -286,6 +295,17 @@ void IECoreRI::RendererImplementation::setOption( const std::string &name, IECor
 		return;
 	}
 	
+	if( name.compare( 0, 7, "ri:rib:" ) == 0 )
+	{
+		// rib formatting options must be emitted immediately, so they
+		// apply to everything written before worldBegin() too.
+		ScopedContext scopedContext( m_context );
+		ParameterList pl( name.substr( 7 ), value.get() );
+		RiOptionV( "rib", pl.n(), pl.tokens(), pl.values() );
+		m_options->writable()[name] = value->copy();
+		return;
+	}
+
 	// we need to group related options together into a single RiOption or RiHider call, so we
 	// just accumulate the options until worldBegin() where we'll emit them.
 	m_options->writable()[name] = value->copy();
@@ -381,6 +401,17 @@ IECore::ConstDataPtr IECoreRI::RendererImplementation::getFontSearchPathOption(
 	return new StringData( m_fontSearchPath.getPaths( ":" ) );
 }
 
+IECore::ConstDataPtr IECoreRI::RendererImplementation::getAutomaticInstancingStatisticsOption( const std::string &name ) const
+{
+	SharedData::ObjectHandlesMutex::scoped_lock objectHandlesLock( m_sharedData->objectHandlesMutex );
+
+	CompoundDataPtr result = new CompoundData;
+	result->writable()["instances"] = new UInt64Data( m_sharedData->automaticInstanceMemory.size() );
+	result->writable()["reuses"] = new UInt64Data( m_sharedData->automaticInstanceReuses );
+	result->writable()["memorySaved"] = new UInt64Data( m_sharedData->automaticInstanceMemorySaved );
+	return result;
+}
+
 IECore::ConstDataPtr IECoreRI::RendererImplementation::getShutterOption( const std::string &name ) const
 {
 	float shutter[2];
@@ -570,6 +601,11 @@ void IECoreRI::RendererImplementation::worldBegin()
 			}
 			processed = true;
 		}
+		else if( name.compare( 0, 7, "ri:rib:" ) == 0 )
+		{
+			// already emitted by setOption()
+			processed = true;
+		}
 		else if( name.compare( 0, 3, "ri:" )==0 )
 		{
 			size_t i = name.find_first_of( ":", 3 );
@@ -1524,26 +1560,27 @@ void IECoreRI::RendererImplementation::motionEnd()
 			
 			SharedData::ObjectHandlesMutex::scoped_lock objectHandlesLock( m_sharedData->objectHandlesMutex);
 
-			SharedData::ObjectHandleMap::const_iterator it = m_sharedData->objectHandles.find( instanceName );
-			if( it != m_sharedData->objectHandles.end() )
-			{
-				instance( instanceName );
-			}
-			else
+			if( !reuseAutomaticInstance( instanceName ) )
 			{
+				size_t memory = 0;
 				instanceBegin( instanceName, CompoundDataMap() );
 					emitPrimitiveAttributes( m_motionPrimitives[0].get() );
 					RiMotionBeginV( m_delayedMotionTimes.size(), &*(m_delayedMotionTimes.begin() ) );
 						for( std::vector<IECore::ConstPrimitivePtr>::const_iterator it = m_motionPrimitives.begin(); it!=m_motionPrimitives.end(); it++ )					
 						{
 							emitPrimitive( it->get() );
+							memory += (*it)->memoryUsage();
 						}
 					RiMotionEnd();
 				instanceEnd();
 				instance( instanceName );
-				m_delayedMotionTimes.clear();
-				m_motionPrimitives.clear();
+				m_sharedData->automaticInstanceMemory[instanceName] = memory;
 			}
+
+			// the samples must be discarded whether or not the instance
+			// already existed, otherwise they'd leak into the next motion block.
+			m_delayedMotionTimes.clear();
+			m_motionPrimitives.clear();
 		}
 	}
 	m_motionType = None;
@@ -1679,12 +1716,57 @@ void IECoreRI::RendererImplementation::geometry( const std::string &type, const
 	{
 		RiGeometry( "teapot", 0 );
 	}
+	else if( type=="instancer" )
+	{
+		instancer( topology, primVars );
+	}
 	else
 	{
 		msg( Msg::Warning, "IECoreRI::RendererImplementation::geometry", format( "Unsupported geometry type \"%s\"." ) % type );
 	}
 }
 
+void IECoreRI::RendererImplementation::instancer( const IECore::CompoundDataMap &topology, const IECore::PrimitiveVariableMap &primVars )
+{
+	vector<int> prototypeIndices;
+	vector<M44f> transforms;
+	vector<RtObjectHandle> handles;
+	try
+	{
+		const vector<string> &prototypes = InstancerAlgo::prototypes( topology );
+		InstancerAlgo::prototypeIndices( primVars, prototypes.size(), prototypeIndices );
+		InstancerAlgo::transforms( primVars, transforms );
+
+		// look up the handles once up front, rather than once per point as
+		// separate instance() calls would.
+		SharedData::ObjectHandlesMutex::scoped_lock objectHandlesLock( m_sharedData->objectHandlesMutex );
+		for( vector<string>::const_iterator it = prototypes.begin(), eIt = prototypes.end(); it != eIt; ++it )
+		{
+			SharedData::ObjectHandleMap::const_iterator hIt = m_sharedData->objectHandles.find( *it );
+			if( hIt==m_sharedData->objectHandles.end() )
+			{
+				throw InvalidArgumentException( boost::str( boost::format( "No object named \"%s\" available for instancing." ) % *it ) );
+			}
+			handles.push_back( const_cast<RtObjectHandle>( hIt->second ) );
+		}
+	}
+	catch( const std::exception &e )
+	{
+		msg( Msg::Error, "IECoreRI::RendererImplementation::geometry", e.what() );
+		return;
+	}
+
+	RtMatrix m;
+	for( size_t i = 0, e = prototypeIndices.size(); i < e; ++i )
+	{
+		convert( transforms[i], m );
+		RiTransformBegin();
+			RiConcatTransform( m );
+			RiObjectInstance( handles[prototypeIndices[i]] );
+		RiTransformEnd();
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // primitive processing. the primitive methods above just create IECore::Primitives
 // and then pass them into addPrimitive(), where we do automatic instancing and suchlike
@@ -1714,18 +1796,14 @@ void IECoreRI::RendererImplementation::addPrimitive( IECore::ConstPrimitivePtr p
 
 			SharedData::ObjectHandlesMutex::scoped_lock objectHandlesLock( m_sharedData->objectHandlesMutex );
 			
-			SharedData::ObjectHandleMap::const_iterator it = m_sharedData->objectHandles.find( instanceName );
-			if( it != m_sharedData->objectHandles.end() )
-			{
-				instance( instanceName );
-			}
-			else
+			if( !reuseAutomaticInstance( instanceName ) )
 			{
 				instanceBegin( instanceName, CompoundDataMap() );
 					emitPrimitiveAttributes( primitive.get() );
 					emitPrimitive( primitive.get() );
 				instanceEnd();
 				instance( instanceName );
+				m_sharedData->automaticInstanceMemory[instanceName] = primitive->memoryUsage();
 			}
 		}
 		else
@@ -1736,6 +1814,25 @@ void IECoreRI::RendererImplementation::addPrimitive( IECore::ConstPrimitivePtr p
 	}
 }
 
+bool IECoreRI::RendererImplementation::reuseAutomaticInstance( const std::string &instanceName )
+{
+	SharedData::ObjectHandleMap::const_iterator it = m_sharedData->objectHandles.find( instanceName );
+	if( it == m_sharedData->objectHandles.end() )
+	{
+		return false;
+	}
+
+	instance( instanceName );
+
+	m_sharedData->automaticInstanceReuses++;
+	SharedData::InstanceMemoryMap::const_iterator mIt = m_sharedData->automaticInstanceMemory.find( instanceName );
+	if( mIt != m_sharedData->automaticInstanceMemory.end() )
+	{
+		m_sharedData->automaticInstanceMemorySaved += mIt->second;
+	}
+	return true;
+}
+
 void IECoreRI::RendererImplementation::emitPrimitiveAttributes( const IECore::Primitive *primitive )
 {
 	switch( primitive->typeId() )
@@ -33,12 +33,14 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/algorithm/string.hpp"
+#include "boost/bind.hpp"
 #include "boost/filesystem/convenience.hpp"
 #include "boost/format.hpp"
 
 #include "IECore/FileNameParameter.h"
 
 #include "IECoreRI/SHWDeepImageReader.h"
+#include "IECoreRI/private/DeepTileCache.h"
 
 using namespace IECore;
 using namespace IECoreRI;
@@ -131,19 +133,57 @@ DeepPixelPtr SHWDeepImageReader::doReadPixel( int x, int y )
 		return 0;
 	}
 	
+	return m_tileCache->readPixel( x, y );
+}
+
+DeepImageBlockPtr SHWDeepImageReader::doReadBlock( const Imath::Box2i &region )
+{
+	open( true );
+	
+	return m_tileCache->readBlock( region );
+}
+
+DeepImageBlockPtr SHWDeepImageReader::readTile( const Imath::Box2i &region )
+{
+	std::vector<std::string> names;
+	channelNames( names );
+	DeepImageBlockPtr result = new DeepImageBlock( region, names );
+	
+	// The sample counts aren't known until each pixel has been read,
+	// so we gather all the samples before filling the block.
+	std::vector<unsigned> sampleCounts;
+	sampleCounts.reserve( result->numPixels() );
+	std::vector<float> samples;
+	for ( int y=region.min.y; y <= region.max.y; ++y )
+	{
+		for ( int x=region.min.x; x <= region.max.x; ++x )
+		{
+			sampleCounts.push_back( readSamples( x, y, samples ) );
+		}
+	}
+	
+	result->setSampleCounts( sampleCounts );
+	if ( result->numSamples() )
+	{
+		result->setInterleavedSamples( &samples[0] );
+	}
+	
+	return result;
+}
+
+unsigned SHWDeepImageReader::readSamples( int x, int y, std::vector<float> &samples )
+{
 	if ( DtexGetPixel( m_dtexImage, x, y, m_dtexPixel ) != DTEX_NOERR )
 	{
 		return 0;
 	}
 	
 	int numSamples = DtexPixelGetNumPoints( m_dtexPixel );
-	if ( !numSamples )
+	if ( numSamples <= 0 )
 	{
 		return 0;
 	}
 	
-	DeepPixelPtr pixel = new DeepPixel( m_channelNames, numSamples );
-	
 	unsigned numRealChannels = DtexNumChan( m_dtexImage );
 	
 	float depth = 0;
@@ -163,6 +203,11 @@ DeepPixelPtr SHWDeepImageReader::doReadPixel( int x, int y )
 		correction = nearClip / ( Imath::V3f(((x+0.5f)/(m_dataWindow.max.x+1) * 2 - 1), -((y+0.5)/(m_dataWindow.max.y+1) * 2 - 1),0) * m_NDCToCamera ).length();
 	}
 
+	// Although there may be several real channels, we only output
+	// as many as we have channel names for.
+	const unsigned numChannels = m_channelNames.size();
+	samples.reserve( samples.size() + numSamples * ( numChannels + 1 ) );
+	
 	for ( int i=0; i < numSamples; ++i )
 	{
 		DtexPixelGetPoint( m_dtexPixel, i, &depth, channelData );
@@ -182,10 +227,11 @@ DeepPixelPtr SHWDeepImageReader::doReadPixel( int x, int y )
 			previous[j] = current;
 		}
 		
-		pixel->addSample( depth, channelData );
+		samples.push_back( depth );
+		samples.insert( samples.end(), channelData, channelData + numChannels );
 	}
 	
-	return pixel;
+	return numSamples;
 }
 
 bool SHWDeepImageReader::open( bool throwOnFailure )
@@ -252,6 +298,8 @@ bool SHWDeepImageReader::open( bool throwOnFailure )
 				m_NDCToCamera[ix][iy] = NDCToCameraDouble[ix][iy];
 			}
 		}
+		
+		m_tileCache.reset( new Detail::DeepTileCache( m_dataWindow, boost::bind( &SHWDeepImageReader::readTile, this, _1 ) ) );
 	}
 	else
 	{
@@ -278,6 +326,8 @@ bool SHWDeepImageReader::open( bool throwOnFailure )
 
 void SHWDeepImageReader::clean()
 {
+	m_tileCache.reset();
+	
 	if ( m_dtexPixel )
 	{
 		DtexDestroyPixel( m_dtexPixel );
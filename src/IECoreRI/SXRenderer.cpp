@@ -258,6 +258,11 @@ IECore::CompoundDataPtr SXRenderer::shade( const IECore::CompoundData *points, c
 	return m_implementation->shade( points, gridSize );
 }
 
+void SXRenderer::shade( const IECore::CompoundData *points, const Imath::V2i &gridSize, IECore::CompoundData *result, size_t batchSize ) const
+{
+	m_implementation->shade( points, gridSize, result, batchSize );
+}
+
 IECore::CompoundDataPtr SXRenderer::shadePlane( const Imath::V2i &resolution ) const
 {
 	return m_implementation->shadePlane( resolution );
@@ -43,12 +43,17 @@
 #include "IECore/MatrixAlgo.h"
 #include "IECore/Transform.h"
 #include "IECore/Group.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/DataAlgo.h"
 
 #include "boost/algorithm/string/case_conv.hpp"
 #include "boost/format.hpp"
 
 #include "tbb/tbb_thread.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "ri.h"
@@ -691,6 +696,223 @@ IECore::CompoundDataPtr IECoreRI::SXRendererImplementation::shade( const IECore:
 	return executor.execute( points, gridSize );
 }
 
+namespace
+{
+
+// Extracts the points for a single batch from varying data,
+// returning NULL for uniform data, which can be shared as-is.
+struct Slice
+{
+	typedef DataPtr ReturnType;
+
+	Slice( size_t numPoints, size_t begin, size_t end )
+		:	m_numPoints( numPoints ), m_begin( begin ), m_end( end )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		const typename T::ValueType &v = data->readable();
+		if( v.size() != m_numPoints )
+		{
+			return NULL;
+		}
+		typename T::Ptr result = new T;
+		result->writable().assign( v.begin() + m_begin, v.begin() + m_end );
+		setGeometricInterpretation( result.get(), getGeometricInterpretation( data ) );
+		return result;
+	}
+
+	size_t m_numPoints;
+	size_t m_begin;
+	size_t m_end;
+
+};
+
+struct VectorSize
+{
+	typedef size_t ReturnType;
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		return data->readable().size();
+	}
+};
+
+struct Resize
+{
+	typedef void ReturnType;
+
+	Resize( size_t size )
+		:	m_size( size )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( T *data ) const
+	{
+		data->writable().resize( m_size );
+	}
+
+	size_t m_size;
+
+};
+
+// Copies the results of a batch into the appropriate
+// range of the final result.
+struct CopyInto
+{
+	typedef void ReturnType;
+
+	CopyInto( Data *destination, size_t offset )
+		:	m_destination( destination ), m_offset( offset )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		T *destination = static_cast<T *>( m_destination );
+		std::copy( data->readable().begin(), data->readable().end(), destination->writable().begin() + m_offset );
+	}
+
+	Data *m_destination;
+	size_t m_offset;
+
+};
+
+struct ShadeBatches
+{
+
+	ShadeBatches( const SXExecutor &executor, const CompoundData *points, size_t numPoints, size_t batchSize, const V2i &gridSize, std::vector<CompoundDataPtr> &results )
+		:	m_executor( executor ), m_points( points ), m_numPoints( numPoints ), m_batchSize( batchSize ), m_gridSize( gridSize ), m_results( results )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			const size_t begin = i * m_batchSize;
+			const size_t end = std::min( begin + m_batchSize, m_numPoints );
+
+			CompoundDataPtr batch = new CompoundData;
+			Slice slice( m_numPoints, begin, end );
+			for( CompoundDataMap::const_iterator it = m_points->readable().begin(), eIt = m_points->readable().end(); it != eIt; ++it )
+			{
+				DataPtr d = despatchTypedData<Slice, TypeTraits::IsVectorTypedData, DespatchTypedDataIgnoreError>( it->second.get(), slice );
+				batch->writable()[it->first] = d ? d : it->second;
+			}
+
+			m_results[i] = m_executor.execute( batch.get(), m_gridSize );
+		}
+	}
+
+	const SXExecutor &m_executor;
+	const CompoundData *m_points;
+	size_t m_numPoints;
+	size_t m_batchSize;
+	V2i m_gridSize;
+	std::vector<CompoundDataPtr> &m_results;
+
+};
+
+} // namespace
+
+void IECoreRI::SXRendererImplementation::shade( const IECore::CompoundData *points, const Imath::V2i &gridSize, IECore::CompoundData *result, size_t batchSize ) const
+{
+	SXExecutor::ShaderVector shaders;
+	const State &state = m_stateStack.top();
+	if( state.displacementShader )
+	{
+		shaders.push_back( state.displacementShader );
+	}
+	if( state.surfaceShader )
+	{
+		shaders.push_back( state.surfaceShader );
+	}
+	if( state.atmosphereShader )
+	{
+		shaders.push_back( state.atmosphereShader );
+	}
+	if( state.imagerShader )
+	{
+		shaders.push_back( state.imagerShader );
+	}
+
+	if( !shaders.size() )
+	{
+		throw Exception( "No shaders specified" );
+	}
+
+	const V3fVectorData *p = points->member<V3fVectorData>( "P", true /* throw */ );
+	const size_t numPoints = p->readable().size();
+	if( !numPoints )
+	{
+		throw Exception( "\"P\" has zero length." );
+	}
+
+	// choose a batch size made up of whole grids. by default we aim for several
+	// batches per thread so the load balances well, but avoid grids so small
+	// that the per-call overhead of the Sx library dominates.
+
+	const size_t gridPoints = gridSize.x > 0 && gridSize.y > 0 ? gridSize.x * gridSize.y : 1;
+	if( numPoints % gridPoints )
+	{
+		throw Exception( boost::str( boost::format( "Wrong number of points (%d) for grid (%dx%d)." ) % numPoints % gridSize.x % gridSize.y ) );
+	}
+
+	if( !batchSize )
+	{
+		batchSize = numPoints / ( 4 * std::max( 1u, tbb::tbb_thread::hardware_concurrency() ) );
+		batchSize = std::max( batchSize, (size_t)1024 );
+		batchSize = std::min( batchSize, (size_t)16384 );
+	}
+	batchSize = std::max( batchSize / gridPoints, (size_t)1 ) * gridPoints;
+
+	const size_t numBatches = ( numPoints + batchSize - 1 ) / batchSize;
+
+	// shade the batches in parallel. the Sx context is told to expect
+	// hardware_concurrency() threads on construction, so it is safe to
+	// share it between them.
+
+	SXExecutor executor( shaders, state.context.get(), state.coshaders, state.lights );
+	std::vector<CompoundDataPtr> batchResults( numBatches );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, numBatches, 1 ), ShadeBatches( executor, points, numPoints, batchSize, gridSize, batchResults ) );
+
+	// and gather the results, reusing any existing data of the
+	// right type in the result.
+
+	CompoundDataMap &resultMembers = result->writable();
+	for( CompoundDataMap::const_iterator it = batchResults[0]->readable().begin(), eIt = batchResults[0]->readable().end(); it != eIt; ++it )
+	{
+		Data *batchData = it->second.get();
+		const size_t batchDataSize = despatchTypedData<VectorSize, TypeTraits::IsVectorTypedData, DespatchTypedDataIgnoreError>( batchData );
+		if( batchDataSize != std::min( batchSize, numPoints ) )
+		{
+			// uniform output
+			resultMembers[it->first] = batchData;
+			continue;
+		}
+
+		DataPtr &destination = resultMembers[it->first];
+		if( !destination || destination->typeId() != batchData->typeId() )
+		{
+			destination = runTimeCast<Data>( Object::create( batchData->typeId() ) );
+		}
+		despatchTypedData<Resize, TypeTraits::IsVectorTypedData, DespatchTypedDataIgnoreError>( destination.get(), Resize( numPoints ) );
+		setGeometricInterpretation( destination.get(), getGeometricInterpretation( batchData ) );
+
+		for( size_t i = 0; i < numBatches; ++i )
+		{
+			Data *d = batchResults[i]->member<Data>( it->first, true /* throw */ );
+			despatchTypedData<CopyInto, TypeTraits::IsVectorTypedData, DespatchTypedDataIgnoreError>( d, CopyInto( destination.get(), i * batchSize ) );
+		}
+	}
+}
+
 IECore::CompoundDataPtr IECoreRI::SXRendererImplementation::shadePlane( const V2i &resolution ) const
 {
 	IECore::CompoundDataPtr points = new IECore::CompoundData();
@@ -58,6 +58,12 @@ static IECore::CompoundDataPtr shade2( SXRendererPtr r, const IECore::CompoundDa
 	return r->shade( points, gridSize );
 }
 
+static void shade3( SXRendererPtr r, const IECore::CompoundData *points, const Imath::V2i &gridSize, IECore::CompoundData *result, size_t batchSize )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	r->shade( points, gridSize, result, batchSize );
+}
+
 static IECore::CompoundDataPtr shadePlane( SXRendererPtr r, const Imath::V2i &resolution )
 {
 	IECorePython::ScopedGILRelease gilRelease;
@@ -76,6 +82,7 @@ void bindSXRenderer()
 		.def( init<>() )
 		.def( "shade", &shade )
 		.def( "shade", &shade2 )
+		.def( "shade", &shade3, ( arg( "points" ), arg( "gridSize" ), arg( "result" ), arg( "batchSize" ) = 0 ) )
 		.def( "shadePlane", &shadePlane )
 		.def( "shadePlaneToImage", &shadePlaneToImage )
 	;
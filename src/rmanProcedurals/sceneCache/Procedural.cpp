@@ -0,0 +1,236 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <sstream>
+
+#include "ri.h"
+
+#include "OpenEXR/ImathBoxAlgo.h"
+
+#include "IECore/SharedSceneInterfaces.h"
+#include "IECore/SceneInterface.h"
+#include "IECore/AttributeBlock.h"
+#include "IECore/VisibleRenderable.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/MessageHandler.h"
+
+#include "IECoreRI/Renderer.h"
+
+#if defined(_WIN32)
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+
+// A RenderMan procedural which renders a SceneCache or LinkedScene directly
+// in C++, without the interpreter startup and GIL contention of going through
+// the python procedural. It is invoked as :
+//
+// Procedural "DynamicLoad" [ "ieSceneCache" "fileName [path [time]]" ] [ bound ]
+//
+// Where path defaults to "/" and time to 0. The bound should be the bound of
+// the location, in its own space - the location's transform is not applied.
+// Each child location is emitted as a separate procedural with its own bound,
+// so the renderer only expands the parts of the scene it actually needs. The
+// files themselves are opened via SharedSceneInterfaces, so they are shared by
+// all the locations and all the invocations of the procedural.
+
+namespace
+{
+
+struct Arguments
+{
+	string fileName;
+	string path;
+	double time;
+};
+
+bool visible( const SceneInterface *scene, double time )
+{
+	if( !scene->hasAttribute( SceneInterface::visibilityName ) )
+	{
+		return true;
+	}
+
+	ConstBoolDataPtr visibility = runTimeCast<const BoolData>( scene->readAttribute( SceneInterface::visibilityName, time ) );
+	return !visibility || visibility->readable();
+}
+
+void renderLocation( const SceneInterface *scene, double time, IECore::Renderer *renderer );
+
+class SceneProcedural : public IECore::Renderer::Procedural
+{
+
+	public :
+
+		SceneProcedural( ConstSceneInterfacePtr scene, double time )
+			:	m_scene( scene ), m_time( time )
+		{
+		}
+
+		virtual Imath::Box3f bound() const
+		{
+			const Box3d bound = transform( m_scene->readBound( m_time ), m_scene->readTransformAsMatrix( m_time ) );
+			return Box3f( V3f( bound.min ), V3f( bound.max ) );
+		}
+
+		virtual void render( IECore::Renderer *renderer ) const
+		{
+			AttributeBlock attributeBlock( renderer );
+			renderer->concatTransform( M44f( m_scene->readTransformAsMatrix( m_time ) ) );
+			renderLocation( m_scene.get(), m_time, renderer );
+		}
+
+		virtual MurmurHash hash() const
+		{
+			SceneInterface::Path path;
+			m_scene->path( path );
+
+			MurmurHash h;
+			h.append( m_scene->fileName() );
+			h.append( path.size() ? &path[0] : 0, path.size() );
+			h.append( m_time );
+			return h;
+		}
+
+	private :
+
+		ConstSceneInterfacePtr m_scene;
+		double m_time;
+
+};
+
+void renderLocation( const SceneInterface *scene, double time, IECore::Renderer *renderer )
+{
+	SceneInterface::Path path;
+	scene->path( path );
+	string pathString;
+	SceneInterface::pathToString( path, pathString );
+	renderer->setAttribute( "name", new StringData( pathString ) );
+
+	SceneInterface::NameList attributeNames;
+	scene->attributeNames( attributeNames );
+	for( SceneInterface::NameList::const_iterator it = attributeNames.begin(); it != attributeNames.end(); ++it )
+	{
+		if( it->string().compare( 0, 3, "ri:" ) != 0 && it->string().compare( 0, 5, "user:" ) != 0 )
+		{
+			continue;
+		}
+		if( ConstDataPtr data = runTimeCast<const Data>( scene->readAttribute( *it, time ) ) )
+		{
+			renderer->setAttribute( *it, data );
+		}
+	}
+
+	if( scene->hasObject() )
+	{
+		if( ConstVisibleRenderablePtr renderable = runTimeCast<const VisibleRenderable>( scene->readObject( time ) ) )
+		{
+			renderable->render( renderer );
+		}
+	}
+
+	SceneInterface::NameList childNames;
+	scene->childNames( childNames );
+	for( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+	{
+		ConstSceneInterfacePtr child = scene->child( *it );
+		if( visible( child.get(), time ) )
+		{
+			renderer->procedural( new SceneProcedural( child, time ) );
+		}
+	}
+}
+
+} // namespace
+
+extern "C"
+{
+
+RtPointer DLLEXPORT ConvertParameters( RtString paramstr )
+{
+	Arguments *arguments = new Arguments;
+	arguments->path = "/";
+	arguments->time = 0;
+
+	istringstream s( paramstr );
+	s >> arguments->fileName;
+	if( s >> arguments->path )
+	{
+		s >> arguments->time;
+	}
+
+	return arguments;
+}
+
+RtVoid DLLEXPORT Subdivide( RtPointer data, float detail )
+{
+	const Arguments *arguments = (const Arguments *)data;
+
+	try
+	{
+		SceneInterface::Path path;
+		SceneInterface::stringToPath( arguments->path, path );
+		ConstSceneInterfacePtr scene = SharedSceneInterfaces::get( arguments->fileName )->scene( path );
+		if( !visible( scene.get(), arguments->time ) )
+		{
+			return;
+		}
+
+		IECoreRI::RendererPtr renderer = new IECoreRI::Renderer();
+		AttributeBlock attributeBlock( renderer );
+		renderLocation( scene.get(), arguments->time, renderer.get() );
+	}
+	catch( const std::exception &e )
+	{
+		msg( Msg::Error, "SceneCache procedural", e.what() );
+	}
+	catch( ... )
+	{
+		msg( Msg::Error, "SceneCache procedural", "Caught unknown exception" );
+	}
+}
+
+RtVoid DLLEXPORT Free( RtPointer data )
+{
+	Arguments *arguments = (Arguments *)data;
+	delete arguments;
+}
+
+}
@@ -75,6 +75,7 @@ from MeshPrimitive import *
 from Shader import *
 from SearchPath import *
 from CachedReader import *
+from ImageChannelLoaderTest import *
 from Reader import *
 from RunTimeTyped import *
 from Op import *
@@ -136,6 +137,7 @@ from ImageDiffOp import *
 from TriangulatorTest import *
 from BezierAlgoTest import *
 from MeshNormalsOpTest import *
+from ModifyOpTest import ModifyOpTest
 from PrimitiveTest import *
 from MeshMergeOpTest import *
 from UnicodeToStringTest import *
@@ -144,6 +146,7 @@ from ImathRootsTest import *
 from AngleConversionTest import *
 from LuminanceOpTest import *
 from SummedAreaOpTest import *
+from BoxBlurOpTest import *
 from GradeTest import *
 from MedianCutSamplerTest import *
 from EnvMapSamplerTest import *
@@ -151,6 +154,7 @@ from RandomTest import *
 from MeshVertexReorderOpTest import *
 from SplineTest import *
 from SplineDataTest import *
+from BakedSplineTest import *
 from TypeIdTest import *
 from LayeredDictTest import *
 from SplineParameterTest import *
@@ -233,6 +237,8 @@ from LRUCacheTest import LRUCacheTest
 from DataInterleaveOpTest import DataInterleaveOpTest
 from DataConvertOpTest import DataConvertOpTest
 from DeepPixelTest import DeepPixelTest
+from DeepImageBlockTest import DeepImageBlockTest
+from DeepImageAlgoTest import DeepImageAlgoTest
 from ConfigLoaderTest import ConfigLoaderTest
 from MurmurHashTest import MurmurHashTest
 from BoolVectorData import BoolVectorDataTest
@@ -250,6 +256,7 @@ from LinkedSceneTest import LinkedSceneTest
 from StandardRadialLensModelTest import StandardRadialLensModelTest
 from LensDistortOpTest import LensDistortOpTest
 from ObjectPoolTest import ObjectPoolTest
+from DiskObjectPoolTest import DiskObjectPoolTest
 from RefCountedTest import RefCountedTest
 from ExternalProceduralTest import ExternalProceduralTest
 from ClippingPlaneTest import ClippingPlaneTest
@@ -257,6 +264,9 @@ from DataAlgoTest import DataAlgoTest
 from MeshAlgoTest import *
 from CurvesAlgoTest import *
 from PointsAlgoTest import *
+from ProceduralAlgoTest import ProceduralAlgoTest
+from ProfilingTest import ProfilingTest
+from SceneCacheAlgoTest import SceneCacheAlgoTest
 from DisplayDriverServerTest import DisplayDriverServerTest
 
 if IECore.withDeepEXR() :
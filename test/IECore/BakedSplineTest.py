@@ -0,0 +1,142 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+import random
+
+import IECore
+
+class BakedSplineTest( unittest.TestCase ) :
+
+	def __spline( self ) :
+
+		return IECore.Splineff(
+			IECore.CubicBasisf.catmullRom(),
+			(
+				( 0, 0 ),
+				( 0, 0 ),
+				( 0.2, 0.8 ),
+				( 0.5, 0.3 ),
+				( 1, 1 ),
+				( 1, 1 ),
+			)
+		)
+
+	def testConstructor( self ) :
+
+		s = self.__spline()
+
+		b = IECore.BakedSplineff( s )
+		self.assertEqual( b.numSamples(), 256 )
+		self.assertEqual( b.interval(), s.interval() )
+
+		b = IECore.BakedSplineff( s, 10 )
+		self.assertEqual( b.numSamples(), 10 )
+
+		self.assertRaises( Exception, IECore.BakedSplineff, s, 1 )
+		self.assertRaises( Exception, IECore.BakedSplineff, IECore.Splineff() )
+
+	def testAccuracy( self ) :
+
+		s = self.__spline()
+		b = IECore.BakedSplineff( s, 1024 )
+
+		random.seed( 0 )
+		maxError = 0
+		for i in range( 0, 1000 ) :
+			x = random.uniform( 0, 1 )
+			maxError = max( maxError, abs( b( x ) - s( x ) ) )
+
+		self.failUnless( maxError < 0.001 )
+		# the reported error is an estimate, but it should be
+		# of the right order of magnitude
+		self.failUnless( maxError <= b.error() * 1.5 )
+
+		# error should decrease as the sample count increases
+		self.failUnless( IECore.BakedSplineff( s, 64 ).error() > b.error() )
+
+	def testSamplesAreExact( self ) :
+
+		s = self.__spline()
+		b = IECore.BakedSplineff( s, 11 )
+
+		for i in range( 0, 11 ) :
+			x = i / 10.0
+			self.assertAlmostEqual( b( x ), s( x ), 5 )
+
+	def testClamping( self ) :
+
+		s = self.__spline()
+		b = IECore.BakedSplineff( s )
+
+		self.assertAlmostEqual( b( -1 ), s( 0 ), 5 )
+		self.assertAlmostEqual( b( 2 ), s( 1 ), 5 )
+
+	def testVector( self ) :
+
+		s = self.__spline()
+		b = IECore.BakedSplineff( s )
+
+		x = IECore.FloatVectorData( [ i / 9999.0 for i in range( 0, 10000 ) ] )
+		y = b( x )
+
+		self.failUnless( isinstance( y, IECore.FloatVectorData ) )
+		self.assertEqual( len( y ), len( x ) )
+		for i in range( 0, len( x ), 97 ) :
+			self.assertEqual( y[i], b( x[i] ) )
+
+	def testColor( self ) :
+
+		s = IECore.SplinefColor3f(
+			IECore.CubicBasisf.linear(),
+			(
+				( 0, IECore.Color3f( 0, 0.5, 1 ) ),
+				( 0, IECore.Color3f( 0, 0.5, 1 ) ),
+				( 1, IECore.Color3f( 1, 0.5, 0 ) ),
+				( 1, IECore.Color3f( 1, 0.5, 0 ) ),
+			)
+		)
+
+		b = IECore.BakedSplinefColor3f( s, 2 )
+		self.assertAlmostEqual( b.error(), 0, 5 )
+
+		c = b( 0.25 )
+		self.failUnless( c.equalWithAbsError( IECore.Color3f( 0.25, 0.5, 0.75 ), 0.0001 ) )
+
+		y = b( IECore.FloatVectorData( [ 0, 0.5, 1 ] ) )
+		self.failUnless( isinstance( y, IECore.Color3fVectorData ) )
+		self.failUnless( y[1].equalWithAbsError( IECore.Color3f( 0.5 ), 0.0001 ) )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -61,6 +61,10 @@ class TestBoundedKDTree:
 
 				self.assert_( nearestBound.intersects( bound ) )
 
+			# and no intersecting bounds should have been missed
+			expected = [ i for i in range( 0, numBounds ) if self.bounds[i].intersects( bound ) ]
+			self.assertEqual( sorted( bIdxArray ), expected )
+
 	def doIntersectingBounds(self, numBounds):
 
 		self.makeTree(numBounds)
@@ -0,0 +1,86 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+import IECore
+
+class BoxBlurOpTest( unittest.TestCase ) :
+
+	def __image( self, values, size ) :
+
+		b = IECore.Box2i( IECore.V2i( 0 ), size - IECore.V2i( 1 ) )
+		i = IECore.ImagePrimitive( b, b )
+		i["Y"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( values ) )
+		return i
+
+	def test( self ) :
+
+		i = self.__image( [ 1, 2, 3, 4, 5, 6, 7, 8, 9 ], IECore.V2i( 3 ) )
+		ii = IECore.BoxBlurOp()( input=i, channels=IECore.StringVectorData( ["Y"] ), radius=1 )
+
+		yy = ii["Y"].data
+		# centre pixel sees the whole image, corners and
+		# edges see only the part of the box within it.
+		self.assertAlmostEqual( yy[4], 5, 6 )
+		self.assertAlmostEqual( yy[0], ( 1 + 2 + 4 + 5 ) / 4.0, 6 )
+		self.assertAlmostEqual( yy[1], ( 1 + 2 + 3 + 4 + 5 + 6 ) / 6.0, 6 )
+		self.assertAlmostEqual( yy[8], ( 5 + 6 + 8 + 9 ) / 4.0, 6 )
+
+	def testZeroRadius( self ) :
+
+		i = self.__image( [ 1, 2, 3, 4 ], IECore.V2i( 2 ) )
+		ii = IECore.BoxBlurOp()( input=i, channels=IECore.StringVectorData( ["Y"] ), radius=0 )
+		self.assertEqual( ii, i )
+
+	def testConstantImage( self ) :
+
+		i = self.__image( [ 0.5 ] * 200 * 150, IECore.V2i( 200, 150 ) )
+		ii = IECore.BoxBlurOp()( input=i, channels=IECore.StringVectorData( ["Y"] ), radius=7 )
+
+		for v in ii["Y"].data :
+			self.assertAlmostEqual( v, 0.5, 6 )
+
+	def testLargeRadius( self ) :
+
+		# a radius covering the whole image gives
+		# the average everywhere.
+		i = self.__image( [ 1, 2, 3, 4, 5, 6 ], IECore.V2i( 3, 2 ) )
+		ii = IECore.BoxBlurOp()( input=i, channels=IECore.StringVectorData( ["Y"] ), radius=10 )
+
+		for v in ii["Y"].data :
+			self.assertAlmostEqual( v, 3.5, 6 )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -1026,6 +1026,66 @@ class CapturingRendererTest( unittest.TestCase ) :
 		self.assertEqual( w.state()[0].handle, "myLightHandle" )
 		self.assertEqual( w.state()[0].parameters, IECore.CompoundData( { "intensity" : IECore.FloatData( 10 ) } ) )
 
+	def testSink( self ) :
+	
+		# this is necessary so python will allow threads created by the renderer
+		# to enter into python when those threads execute procedurals.
+		IECore.initThreads()
+	
+		class ListSink( IECore.CapturingRenderer.Sink ) :
+		
+			def __init__( self ) :
+			
+				IECore.CapturingRenderer.Sink.__init__( self )
+				self.groups = []
+				
+			def write( self, group ) :
+			
+				self.groups.append( group )
+	
+		for maxMemory in ( 0, 1024 ) :
+		
+			sink = ListSink()
+		
+			r = IECore.CapturingRenderer()
+			r.setOption( "cp:sink:maxMemory", IECore.IntData( maxMemory ) )
+			r.setSink( sink )
+			self.failUnless( r.getSink().isSame( sink ) )
+			
+			with IECore.WorldBlock( r ) :
+			
+				r.setAttribute( "user:a", IECore.IntData( 1 ) )
+				r.sphere( 1, -1, 1, 360, {} )
+				
+				for i in range( 0, 100 ) :
+					with IECore.AttributeBlock( r ) :
+						r.concatTransform( IECore.M44f.createTranslated( IECore.V3f( i, 0, 0 ) ) )
+						r.procedural( self.SnowflakeProcedural( maxLevel = 1 ) )
+			
+			# only the sphere remains in the world
+			w = r.world()
+			self.assertEqual( len( w.children() ), 1 )
+			self.failUnless( isinstance( w.children()[0], IECore.SpherePrimitive ) )
+			
+			# and all the procedurals went to the sink
+			self.assertEqual( len( sink.groups ), 100 )
+			translations = set()
+			for g in sink.groups :
+				self.assertEqual( g.getAttribute( "user:a" ), IECore.IntData( 1 ) )
+				translations.add( int( g.getTransform().transform().translation().x ) )
+				self.assertEqual( len( g.children() ), 1 )
+				self.assertEqual( len( g.children()[0].children() ), 5 )
+			self.assertEqual( translations, set( range( 0, 100 ) ) )
+			
+	def testCannotSetSinkInWorld( self ) :
+	
+		r = IECore.CapturingRenderer()
+		with IECore.WorldBlock( r ) :
+			with IECore.CapturingMessageHandler() as mh :
+				r.setSink( IECore.CapturingRenderer.Sink() )
+			self.assertEqual( len( mh.messages ), 1 )
+			self.assertEqual( r.getSink(), None )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -129,6 +129,44 @@ class ClampOpTest( unittest.TestCase ) :
 				intermediateValues = True
 				
 		self.failIf( intermediateValues )	
+
+	def testLargeImage( self ) :
+
+		# big enough to be split into several tiles,
+		# each of which must be clamped correctly.
+		window = IECore.Box2i( IECore.V2i( -10, 5 ), IECore.V2i( 289, 204 ) )
+		numPixels = 300 * 200
+
+		r = IECore.FloatVectorData( [ float( i ) / numPixels for i in range( 0, numPixels ) ] )
+		image = IECore.ImagePrimitive( window, window )
+		image["R"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, r )
+
+		image2 = IECore.ClampOp()( input=image, min=0.25, max=0.5 )
+
+		self.assertEqual( len( image2["R"].data ), numPixels )
+		for i in range( 0, numPixels ) :
+			self.assertEqual( image2["R"].data[i], min( max( r[i], 0.25 ), 0.5 ) )
+
+	def testHalfAndUCharChannels( self ) :
+
+		window = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 255, 0 ) )
+		image = IECore.ImagePrimitive( window, window )
+		image["R"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.HalfVectorData( [ i / 255.0 for i in range( 0, 256 ) ] ) )
+		image["G"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.UCharVectorData( range( 0, 256 ) ) )
+		image["B"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ i / 255.0 for i in range( 0, 256 ) ] ) )
+
+		image2 = IECore.ClampOp()( input=image, min=0.25, max=0.5 )
+
+		# channels keep their original types
+		self.failUnless( isinstance( image2["R"].data, IECore.HalfVectorData ) )
+		self.failUnless( isinstance( image2["G"].data, IECore.UCharVectorData ) )
+		self.failUnless( isinstance( image2["B"].data, IECore.FloatVectorData ) )
+
+		# and unsigned char values are treated as being in the range [0,1]
+		self.assertEqual( min( image2["G"].data ), 64 )
+		self.assertEqual( max( image2["G"].data ), 128 )
+		self.assertAlmostEqual( min( image2["R"].data ), 0.25, 3 )
+		self.assertAlmostEqual( max( image2["R"].data ), 0.5, 3 )
 				
 if __name__ == "__main__":
 	unittest.main()
@@ -180,6 +180,38 @@ class TestPythonColorTransformOp( unittest.TestCase ) :
 
 		self.assertEqual( pp["Cs"].data, Color3fVectorData( [ x + Color3f( 1, 2, 3 ) for x in cs ] ) )
 
+	def testManyElements( self ) :
+
+		# enough elements to be transformed in several spans,
+		# with some zero alphas thrown in.
+		n = 2500
+		p = PointsPrimitive( n )
+		r = FloatVectorData( [ x * 0.25 for x in range( 0, n ) ] )
+		cs = Color3fVectorData( [ Color3f( x, x * 2, x * 3 ) for x in range( 0, n ) ] )
+		a = FloatVectorData( [ ( x % 4 ) * 0.5 for x in range( 0, n ) ] )
+		p["R"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, r )
+		p["G"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, r.copy() )
+		p["B"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, r.copy() )
+		p["A"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, a )
+
+		o = AddOp()
+		pp = o( input=p, colorPrimVar="" )
+
+		self.assertEqual( o.numTransforms, n )
+		for i in range( 0, n ) :
+			for c, add in ( ( "R", 1 ), ( "G", 2 ), ( "B", 3 ) ) :
+				expected = r[i] + add * a[i] if a[i] > 0 else 0
+				self.assertAlmostEqual( pp[c].data[i], expected, 4 )
+
+		p["Cs"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, cs )
+		pp = o( input=p )
+
+		self.assertEqual( o.numTransforms, n * 2 )
+		for i in range( 0, n ) :
+			expected = cs[i] + Color3f( 1, 2, 3 ) * a[i] if a[i] > 0 else Color3f( 0 )
+			for j in range( 0, 3 ) :
+				self.assertAlmostEqual( pp["Cs"].data[i][j], expected[j], 3 )
+
 	def testExceptions( self ) :
 
 		p = PointsPrimitive( 2 )
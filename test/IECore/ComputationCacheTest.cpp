@@ -209,6 +209,36 @@ struct ComputationCacheTest
 		BOOST_CHECK_EQUAL( size_t(500), cache.cachedComputations() );
 	}
 
+	void testStatistics()
+	{
+		Cache cache( get, hash, 1000, new ObjectPool( 10000 ) );
+
+		LRUCacheStatistics s = cache.statistics();
+		BOOST_CHECK_EQUAL( size_t(0), s.hits );
+		BOOST_CHECK_EQUAL( size_t(0), s.misses );
+		BOOST_CHECK_EQUAL( size_t(0), s.evictions );
+
+		cache.get( ComputationParams(1) );
+		cache.get( ComputationParams(1) );
+		cache.get( ComputationParams(2), Cache::NullIfMissing );
+
+		s = cache.statistics();
+		BOOST_CHECK_EQUAL( size_t(1), s.hits );
+		BOOST_CHECK_EQUAL( size_t(2), s.misses );
+		BOOST_CHECK_EQUAL( size_t(0), s.evictions );
+		BOOST_CHECK( s.getterTime >= 0.0 );
+
+		cache.setMaxComputations( 1 );
+		BOOST_CHECK_EQUAL( size_t(1), cache.statistics().evictions );
+
+		cache.resetStatistics();
+		s = cache.statistics();
+		BOOST_CHECK_EQUAL( size_t(0), s.hits );
+		BOOST_CHECK_EQUAL( size_t(0), s.misses );
+		BOOST_CHECK_EQUAL( size_t(0), s.evictions );
+		BOOST_CHECK_EQUAL( 0.0, s.getterTime );
+	}
+
 };
 
 int ComputationCacheTest::getCount(0);
@@ -222,6 +252,7 @@ struct ComputationCacheTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &ComputationCacheTest::test, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &ComputationCacheTest::testThreadedGet, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &ComputationCacheTest::testStatistics, instance ) );
 	}
 };
 
@@ -304,6 +304,51 @@ class CubeColorTransformOpTest( unittest.TestCase ) :
 
 
 
+	def testTetrahedral( self ) :
+
+		cubeLookup = CubeColorTransformOpTest.makeColorCube( V3i( 5, 4, 3 ) )
+		cubeLookup.setInterpolation( CubeColorLookupf.Interpolation.Tetrahedral )
+
+		colors = Color3fVectorData( [ Color3f( 0.1, 0.7, 0.3 ), Color3f( 0.9, 0.2, 0.6 ), Color3f( 1, 0, 0.5 ), Color3f( 0.25, 0.25, 0.75 ) ] )
+		p = PointsPrimitive( len( colors ) )
+		p["Cs"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, colors )
+
+		result = CubeColorTransformOp()( input = p, cube = cubeLookup )
+
+		# the cube holds an identity transform, which tetrahedral
+		# interpolation should reproduce exactly.
+		for i in range( 0, len( colors ) ) :
+			self.failUnless( result["Cs"].data[i].equalWithAbsError( colors[i], 1e-6 ) )
+			self.failUnless( cubeLookup( colors[i] ).equalWithAbsError( colors[i], 1e-6 ) )
+
+	def testBake( self ) :
+
+		grade1 = Grade()
+		grade1["multiply"] = Color3f( 0.5, 1.5, 1 )
+		grade1["blackClamp"] = False
+		grade1["whiteClamp"] = False
+
+		grade2 = Grade()
+		grade2["offset"] = Color3f( 0.1, -0.2, 0.3 )
+		grade2["blackClamp"] = False
+		grade2["whiteClamp"] = False
+
+		cube = CubeColorTransformOp.bake( [ grade1, grade2 ], V3i( 9 ) )
+		self.failUnless( isinstance( cube, CubeColorLookupfData ) )
+		self.assertEqual( cube.value.dimension(), V3i( 9 ) )
+
+		values = [ 0, 0.1, 0.33, 0.5, 0.9, 1 ]
+		p = PointsPrimitive( len( values ) )
+		p["Cs"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, Color3fVectorData( [ Color3f( v, 1 - v, v * v ) for v in values ] ) )
+
+		expected = grade2( input = grade1( input = p ) )
+		result = CubeColorTransformOp()( input = p, cube = cube )
+
+		for i in range( 0, len( values ) ) :
+			self.failUnless( result["Cs"].data[i].equalWithAbsError( expected["Cs"].data[i], 1e-5 ) )
+
+		self.assertRaises( RuntimeError, CubeColorTransformOp.bake, [ grade1 ], V3i( 1, 2, 2 ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
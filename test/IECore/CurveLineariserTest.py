@@ -325,6 +325,89 @@ class CurveLineariserTest( unittest.TestCase ) :
 		
 		self.runTest( c )
 			
+	def testAdaptive( self ) :
+
+		v = IECore.V3f
+		c = IECore.CurvesPrimitive(
+
+			IECore.IntVectorData( [ 6, 6 ] ),
+			IECore.CubicBasisf.catmullRom(),
+			False,
+			IECore.V3fVectorData(
+				[
+					v( 0, 0, 0 ),
+					v( 1, 0, 0 ),
+					v( 2, 0, 0 ),
+					v( 3, 0, 0 ),
+					v( 4, 0, 0 ),
+					v( 5, 0, 0 ),
+					v( 0, 0, 0 ),
+					v( 0, 1, 0 ),
+					v( 1, 1, 0 ),
+					v( 1, 0, 0 ),
+					v( 2, 0, 0 ),
+					v( 2, 1, 0 )
+				]
+			)
+		)
+
+		c2 = IECore.CurveLineariser()( input=c, maxError=0.01 )
+
+		self.assertEqual( c2.basis(), IECore.CubicBasisf.linear() )
+		self.assert_( c2.arePrimitiveVariablesValid() )
+
+		# the straight curve needs only the original segment boundaries,
+		# whereas the wiggly one needs more vertices to stay within the error.
+		self.assertEqual( c2.verticesPerCurve()[0], 4 )
+		self.assert_( c2.verticesPerCurve()[1] > 4 )
+
+		e = IECore.CurvesPrimitiveEvaluator( c )
+		r = e.createResult()
+		e2 = IECore.CurvesPrimitiveEvaluator( c2 )
+		r2 = e2.createResult()
+		for curveIndex in range( 0, c.numCurves() ) :
+			for i in range( 0, 100 ) :
+				e.pointAtV( curveIndex, float( i ) / 99, r )
+				self.failUnless( e2.closestPoint( r.point(), r2 ) )
+				self.assert_( ( r2.point() - r.point() ).length() < 0.02 )
+
+		# scaling the error measurement should require more vertices
+
+		c3 = IECore.CurveLineariser()( input=c, maxError=0.01, errorTransform=IECore.M44f.createScaled( IECore.V3f( 10 ) ) )
+		self.assert_( c3.verticesPerCurve()[1] > c2.verticesPerCurve()[1] )
+
+	def testPrimitiveVariableTypes( self ) :
+
+		v = IECore.V3f
+		c = IECore.CurvesPrimitive(
+
+			IECore.IntVectorData( [ 4 ] ),
+			IECore.CubicBasisf.bSpline(),
+			False,
+			IECore.V3fVectorData( [ v( 0, 0, 0 ), v( 0, 1, 0 ), v( 1, 1, 0 ), v( 1, 0, 0 ) ] )
+		)
+
+		c["uv"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.V2fVectorData( [ IECore.V2f( 1 ) ] * 4 ) )
+		c["Cs"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Varying, IECore.Color4fVectorData( [ IECore.Color4f( 0 ), IECore.Color4f( 1 ) ] ) )
+		c["s"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.StringVectorData( [ "a", "a", "a", "a" ] ) )
+		c["i"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Varying, IECore.IntVectorData( [ 1, 2 ] ) )
+
+		c2 = IECore.CurveLineariser()( input=c, verticesPerSegment=10 )
+
+		self.assertEqual( c.keys(), c2.keys() )
+		self.assert_( c2.arePrimitiveVariablesValid() )
+
+		for uv in c2["uv"].data :
+			self.assert_( uv.equalWithAbsError( IECore.V2f( 1 ), 0.0001 ) )
+
+		cs = c2["Cs"].data
+		self.assert_( cs[0].equalWithAbsError( IECore.Color4f( 0 ), 0.0001 ) )
+		self.assert_( cs[-1].equalWithAbsError( IECore.Color4f( 1 ), 0.0001 ) )
+
+		self.assertEqual( c2["s"].data, IECore.StringVectorData( [ "a" ] * len( c2["s"].data ) ) )
+		self.assertEqual( c2["i"].data[0], 1 )
+		self.assertEqual( c2["i"].data[-1], 2 )
+
 if __name__ == "__main__":
 	unittest.main()
 
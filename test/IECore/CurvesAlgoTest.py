@@ -32,6 +32,8 @@
 #
 ##########################################################################
 
+from __future__ import with_statement
+
 import unittest
 import IECore
 
@@ -966,5 +968,95 @@ class CurvesAlgoDeleteCurvesTest ( unittest.TestCase ):
 		self.assertEqual( actualCurves["e"].data, IECore.FloatVectorData([2, 3])  )
 		self.assertEqual( actualCurves["e"].interpolation, IECore.PrimitiveVariable.Interpolation.FaceVarying)
 
+class CurvesAlgoMergeCurvesTest( unittest.TestCase ) :
+
+	def curves( self, numCurves, offset ) :
+
+		result = IECore.CurvesPrimitive(
+			IECore.IntVectorData( [ 2 ] * numCurves ),
+			IECore.CubicBasisf.linear(),
+			False,
+			IECore.V3fVectorData( [ IECore.V3f( offset + i ) for i in range( 0, numCurves * 2 ) ] )
+		)
+		result["a"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( offset ) )
+		result["c"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Uniform, IECore.IntVectorData( [ offset ] * numCurves ) )
+
+		return result
+
+	def testMerge( self ) :
+
+		inputs = [ self.curves( i + 1, i * 100 ) for i in range( 0, 5 ) ]
+		merged = IECore.CurvesAlgo.mergeCurves( inputs )
+
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged.numCurves(), 15 )
+		self.assertEqual( merged.basis(), IECore.CubicBasisf.linear() )
+		self.assertEqual( merged["a"].data, IECore.FloatData( 0 ) )
+
+		# should match merging pairwise with CurvesMergeOp
+		expected = inputs[0].copy()
+		for c in inputs[1:] :
+			expected = IECore.CurvesMergeOp()( input = expected, curves = c )
+
+		self.assertEqual( merged.verticesPerCurve(), expected.verticesPerCurve() )
+		self.assertEqual( merged["P"], expected["P"] )
+		self.assertEqual( merged["c"], expected["c"] )
+
+	def testMismatchedPrimitiveVariables( self ) :
+
+		c1 = self.curves( 2, 5 )
+		c2 = self.curves( 2, 10 )
+		c2["c"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1, 2 ] ) )
+
+		with IECore.CapturingMessageHandler() as mh :
+			merged = IECore.CurvesAlgo.mergeCurves( [ c1, c2 ] )
+
+		self.assertEqual( len( mh.messages ), 1 )
+		self.assertEqual( merged["c"].data, IECore.IntVectorData( [ 5, 5, 0, 0 ] ) )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+	def testMismatchedInterpolation( self ) :
+
+		c1 = self.curves( 2, 0 )
+		c2 = self.curves( 3, 10 )
+		c2["c"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( range( 0, 6 ) ) )
+		del c2["a"]
+		c2["d"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Varying, IECore.FloatVectorData( [ 1 ] * 6 ) )
+
+		merged = IECore.CurvesAlgo.mergeCurves( [ c1, c2 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged["c"].interpolation, IECore.PrimitiveVariable.Interpolation.Vertex )
+		self.assertEqual( merged["c"].data, IECore.IntVectorData( [ 0 ] * 4 + range( 0, 6 ) ) )
+
+		self.assertEqual( merged["d"].interpolation, IECore.PrimitiveVariable.Interpolation.Varying )
+		self.assertEqual( merged["d"].data, IECore.FloatVectorData( [ 0 ] * 4 + [ 1 ] * 6 ) )
+
+	def testIndexedPrimitiveVariables( self ) :
+
+		c1 = self.curves( 2, 0 )
+		c2 = self.curves( 3, 10 )
+		for c in ( c1, c2 ) :
+			c["s"] = IECore.PrimitiveVariable(
+				IECore.PrimitiveVariable.Interpolation.Uniform,
+				IECore.FloatVectorData( [ 1, 2 ] ),
+				IECore.IntVectorData( [ 1 ] * c.numCurves() )
+			)
+
+		merged = IECore.CurvesAlgo.mergeCurves( [ c1, c2 ] )
+		self.assertEqual( merged["s"].data, IECore.FloatVectorData( [ 1, 2, 1, 2 ] ) )
+		self.assertEqual( merged["s"].indices, IECore.IntVectorData( [ 1, 1, 3, 3, 3 ] ) )
+		self.assertEqual( merged["s"].expandedData(), IECore.FloatVectorData( [ 2 ] * 5 ) )
+
+		del c2["s"]
+		merged = IECore.CurvesAlgo.mergeCurves( [ c1, c2 ] )
+		self.assertEqual( merged["s"].data, IECore.FloatVectorData( [ 2, 2, 0, 0, 0 ] ) )
+		self.assertEqual( merged["s"].indices, None )
+
+	def testEmpty( self ) :
+
+		merged = IECore.CurvesAlgo.mergeCurves( [] )
+		self.assertEqual( merged.numCurves(), 0 )
+
 if __name__ == "__main__":
 	unittest.main()
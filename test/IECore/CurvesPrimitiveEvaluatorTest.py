@@ -1221,6 +1221,104 @@ class CurvesPrimitiveEvaluatorTest( unittest.TestCase ) :
 						self.failUnless( abs( (p2 - p).length() ) < 0.05 )
 						self.assertEqual( c2, c )
 
+	def __straightCurves( self, numCurves, basis = IECore.CubicBasisf.linear() ) :
+
+		# vertical curves of height 2, spaced one unit apart along x.
+		p = IECore.V3fVectorData()
+		for c in range( 0, numCurves ) :
+			for i in range( 0, 4 ) :
+				p.append( IECore.V3f( c, i * 2.0 / 3.0 - 1, 0 ) )
+
+		return IECore.CurvesPrimitive( IECore.IntVectorData( [ 4 ] * numCurves ), basis, False, p )
+
+	def testIntersectionPoint( self ) :
+
+		for basis in ( IECore.CubicBasisf.linear(), IECore.CubicBasisf.bSpline(), IECore.CubicBasisf.catmullRom() ) :
+
+			curves = self.__straightCurves( 3, basis )
+			curves["width"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 0.2 ) )
+
+			e = IECore.CurvesPrimitiveEvaluator( curves )
+			r = e.createResult()
+
+			# ray along z hitting the middle curve.
+			self.failUnless( e.intersectionPoint( IECore.V3f( 1.05, 0, -5 ), IECore.V3f( 0, 0, 1 ), r ) )
+			self.assertEqual( r.curveIndex(), 1 )
+			self.failUnless( abs( r.point().x - 1 ) < 0.001 )
+			self.failUnless( abs( r.point().y ) < 0.01 )
+
+			# outside the width of any curve.
+			self.failIf( e.intersectionPoint( IECore.V3f( 1.15, 0, -5 ), IECore.V3f( 0, 0, 1 ), r ) )
+
+			# beyond the maximum distance.
+			self.failIf( e.intersectionPoint( IECore.V3f( 1.05, 0, -5 ), IECore.V3f( 0, 0, 1 ), r, 4 ) )
+
+			# pointing away.
+			self.failIf( e.intersectionPoint( IECore.V3f( 1.05, 0, -5 ), IECore.V3f( 0, 0, -1 ), r ) )
+
+			# ray along x hits the nearest curve first.
+			self.failUnless( e.intersectionPoint( IECore.V3f( 5, 0.1, 0 ), IECore.V3f( -1, 0, 0 ), r ) )
+			self.assertEqual( r.curveIndex(), 2 )
+			self.failUnless( e.intersectionPoint( IECore.V3f( -5, 0.1, 0 ), IECore.V3f( 1, 0, 0 ), r ) )
+			self.assertEqual( r.curveIndex(), 0 )
+
+	def testIntersectionPoints( self ) :
+
+		curves = self.__straightCurves( 5 )
+		e = IECore.CurvesPrimitiveEvaluator( curves )
+
+		# passes through all the curves, including at the joins between segments.
+		for y in ( 0, 1.0 / 3.0, 0.5 ) :
+			results = e.intersectionPoints( IECore.V3f( 10, y, 0 ), IECore.V3f( -1, 0, 0 ) )
+			self.assertEqual( [ r.curveIndex() for r in results ], [ 4, 3, 2, 1, 0 ] )
+			for r in results :
+				self.failUnless( abs( r.point().y - y ) < 0.001 )
+
+		results = e.intersectionPoints( IECore.V3f( 10, 0, 0 ), IECore.V3f( -1, 0, 0 ), 7.5 )
+		self.assertEqual( [ r.curveIndex() for r in results ], [ 4, 3 ] )
+
+		self.assertEqual( e.intersectionPoints( IECore.V3f( 10, 5, 0 ), IECore.V3f( -1, 0, 0 ) ), [] )
+
+	def testIntersectionWidth( self ) :
+
+		curves = self.__straightCurves( 2 )
+		e = IECore.CurvesPrimitiveEvaluator( curves )
+		r = e.createResult()
+
+		# default width is 1
+		self.failUnless( e.intersectionPoint( IECore.V3f( 0.45, 0, -5 ), IECore.V3f( 0, 0, 1 ), r ) )
+		self.assertEqual( r.curveIndex(), 0 )
+
+		curves["constantwidth"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 0.5 ) )
+		e = IECore.CurvesPrimitiveEvaluator( curves )
+		self.failIf( e.intersectionPoint( IECore.V3f( 0.45, 0, -5 ), IECore.V3f( 0, 0, 1 ), r ) )
+		self.failUnless( e.intersectionPoint( IECore.V3f( 0.2, 0, -5 ), IECore.V3f( 0, 0, 1 ), r ) )
+
+		# vertex widths tapering from 1 at the root to 0 at the tip.
+		curves["width"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 1, 2.0 / 3.0, 1.0 / 3.0, 0 ] * 2 ) )
+		e = IECore.CurvesPrimitiveEvaluator( curves )
+		self.failUnless( e.intersectionPoint( IECore.V3f( 0.45, -0.95, -5 ), IECore.V3f( 0, 0, 1 ), r ) )
+		self.failIf( e.intersectionPoint( IECore.V3f( 0.45, 0.95, -5 ), IECore.V3f( 0, 0, 1 ), r ) )
+
+	def testBatchQueries( self ) :
+
+		curves = self.__straightCurves( 100, IECore.CubicBasisf.catmullRom() )
+		e = IECore.CurvesPrimitiveEvaluator( curves )
+
+		points = IECore.V3fVectorData( [ IECore.V3f( c, 0.25, 0.1 ) for c in range( 0, 100 ) ] )
+		results = e.batchClosestPoint( points )
+		self.assertEqual( len( results["success"] ), 100 )
+		for i in range( 0, 100 ) :
+			self.failUnless( results["success"][i] )
+			self.failUnless( results["P"][i].equalWithAbsError( IECore.V3f( i, 0.25, 0 ), 0.001 ) )
+
+		origins = IECore.V3fVectorData( [ IECore.V3f( c, 0.25, -1 ) for c in range( 0, 100 ) ] )
+		directions = IECore.V3fVectorData( [ IECore.V3f( 0, 0, 1 ) ] * 100 )
+		results = e.batchIntersectionPoint( origins, directions )
+		for i in range( 0, 100 ) :
+			self.failUnless( results["success"][i] )
+			self.failUnless( results["P"][i].equalWithAbsError( IECore.V3f( i, 0.25, 0 ), 0.001 ) )
+
 	def testTopologyMethods( self ) :
 	
 		c = IECore.CurvesPrimitive( IECore.IntVectorData( [ 6, 6 ] ), IECore.CubicBasisf.linear(), False, IECore.V3fVectorData( [ IECore.V3f( 0 ) ] * 12 ) )
@@ -111,6 +111,30 @@ class TestDPXReader(unittest.TestCase):
 
 			self.assert_( ( color - expectedColor).length() < 1.e-6 )
 
+	def testMemoryMapped( self ) :
+
+		r = DPXImageReader( "test/IECore/data/dpx/uvMap.512x256.dpx" )
+		r["rawChannels"].setTypedValue( True )
+		expected = r.read()
+
+		r["memoryMapped"].setTypedValue( True )
+		self.assertEqual( r.read(), expected )
+
+		r["rawChannels"].setTypedValue( False )
+		img = r.read()
+		r["memoryMapped"].setTypedValue( False )
+		self.assertEqual( r.read(), img )
+
+	def testReadChannelSubset( self ) :
+
+		r = DPXImageReader( "test/IECore/data/dpx/uvMap.512x256.dpx" )
+		img = r.read()
+
+		r["channels"].setValue( StringVectorData( [ "G" ] ) )
+		g = r.read()
+		self.assertEqual( g.keys(), [ "G" ] )
+		self.assertEqual( g["G"], img["G"] )
+
 	def testAll( self ):
 
 		fileNames = glob.glob( "test/IECore/data/dpx/*.dpx" )
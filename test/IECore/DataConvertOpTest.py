@@ -96,6 +96,32 @@ class DataConvertOpTest( unittest.TestCase ) :
 			targetType = IECore.V3fVectorData.staticTypeId()
 			
 		)
-	
+
+	def testLargeArrays( self ) :
+
+		d = IECore.UShortVectorData( [ i % 65536 for i in range( 0, 300000 ) ] )
+
+		o = IECore.DataConvertOp()(
+
+			data = d,
+			targetType = IECore.FloatVectorData.staticTypeId()
+
+		)
+
+		self.assertEqual( len( o ), len( d ) )
+		for i in range( 0, len( d ), 997 ) :
+			self.assertAlmostEqual( o[i], d[i] / 65535.0, 5 )
+
+		o = IECore.DataConvertOp()(
+
+			data = IECore.FloatVectorData( range( 0, 300000 ) ),
+			targetType = IECore.V3fVectorData.staticTypeId()
+
+		)
+
+		self.assertEqual( len( o ), 100000 )
+		for i in range( 0, len( o ), 997 ) :
+			self.assertEqual( o[i], IECore.V3f( i * 3, i * 3 + 1, i * 3 + 2 ) )
+
 if __name__ == "__main__":
     unittest.main()
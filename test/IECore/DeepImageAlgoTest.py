@@ -0,0 +1,169 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import random
+import unittest
+
+import IECore
+
+class DeepImageAlgoTest( unittest.TestCase ) :
+
+	def __block( self, region, channelNames, seed = 0 ) :
+
+		r = random.Random( seed )
+		block = IECore.DeepImageBlock( region, channelNames )
+		block.setSampleCounts( [ r.randint( 0, 5 ) for i in range( 0, block.numPixels() ) ] )
+		# DeepPixel doesn't define an order for samples at equal depths, so
+		# we avoid them in order to make comparisons against it.
+		block.setDepths( IECore.FloatVectorData( r.sample( xrange( 0, 100000 ), block.numSamples() ) ) )
+		for c in range( 0, block.numChannels() ) :
+			block.setChannelData( c, IECore.FloatVectorData( [ r.randint( 0, 100 ) / 100.0 for i in range( 0, block.numSamples() ) ] ) )
+
+		return block
+
+	def testSortSamples( self ) :
+
+		region = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 9, 4 ) )
+		block = self.__block( region, [ "R", "A" ] )
+		sortedBlock = self.__block( region, [ "R", "A" ] )
+		IECore.DeepImageAlgo.sortSamples( sortedBlock )
+
+		self.assertEqual( sortedBlock.sampleOffsets(), block.sampleOffsets() )
+
+		depths = sortedBlock.depths()
+		offsets = sortedBlock.sampleOffsets()
+		for p in range( 0, sortedBlock.numPixels() ) :
+			pixelDepths = list( depths[offsets[p]:offsets[p+1]] )
+			self.assertEqual( pixelDepths, sorted( pixelDepths ) )
+			for c in range( 0, 2 ) :
+				self.assertEqual(
+					sorted( zip( depths[offsets[p]:offsets[p+1]], sortedBlock.channelData( c )[offsets[p]:offsets[p+1]] ) ),
+					sorted( zip( block.depths()[offsets[p]:offsets[p+1]], block.channelData( c )[offsets[p]:offsets[p+1]] ) ),
+				)
+
+	def testFlatten( self ) :
+
+		region = IECore.Box2i( IECore.V2i( 2, 3 ), IECore.V2i( 20, 12 ) )
+		for channelNames in ( [ "R", "G", "B", "A" ], [ "R", "G", "B" ] ) :
+
+			block = self.__block( region, channelNames )
+			image = IECore.DeepImageAlgo.flatten( block )
+
+			self.assertEqual( image.dataWindow, region )
+			self.assertEqual( set( image.channelNames() ), set( channelNames ) )
+
+			for y in range( region.min.y, region.max.y + 1 ) :
+				for x in range( region.min.x, region.max.x + 1 ) :
+					i = block.pixelIndex( x, y )
+					pixel = block.pixel( x, y )
+					expected = pixel.composite() if pixel is not None else [ 0 ] * len( channelNames )
+					for c, name in enumerate( channelNames ) :
+						self.assertAlmostEqual( image[name].data[i], expected[c], 6 )
+
+	def testFlattenIntoImage( self ) :
+
+		region = IECore.Box2i( IECore.V2i( 2, 3 ), IECore.V2i( 5, 4 ) )
+		block = self.__block( region, [ "R", "A" ] )
+
+		dataWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 9 ) )
+		image = IECore.ImagePrimitive( dataWindow, dataWindow )
+		image["R"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ -1 ] * 100 ) )
+
+		IECore.DeepImageAlgo.flatten( block, image )
+		self.assertTrue( "A" in image )
+
+		for y in range( 0, 10 ) :
+			for x in range( 0, 10 ) :
+				i = y * 10 + x
+				pixel = block.pixel( x, y ) if region.intersects( IECore.V2i( x, y ) ) else None
+				if pixel is None :
+					self.assertEqual( image["R"].data[i], -1 )
+					self.assertEqual( image["A"].data[i], 0 )
+				else :
+					expected = pixel.composite()
+					self.assertAlmostEqual( image["R"].data[i], expected[0], 6 )
+					self.assertAlmostEqual( image["A"].data[i], expected[1], 6 )
+
+		smallWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 3 ) )
+		self.assertRaises( RuntimeError, IECore.DeepImageAlgo.flatten, block, IECore.ImagePrimitive( smallWindow, smallWindow ) )
+
+	def testMerge( self ) :
+
+		region = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 7, 5 ) )
+		block1 = self.__block( region, [ "R", "A" ], seed = 1 )
+		block2 = self.__block( region, [ "A", "R" ], seed = 2 )
+		# offset the depths to avoid ties with the first block
+		block2.setDepths( IECore.FloatVectorData( [ d + 0.5 for d in block2.depths() ] ) )
+		IECore.DeepImageAlgo.sortSamples( block2 )
+
+		merged = IECore.DeepImageAlgo.merge( [ block1, block2 ] )
+		self.assertEqual( merged.region(), region )
+		self.assertEqual( merged.channelNames(), IECore.StringVectorData( [ "R", "A" ] ) )
+		self.assertEqual( merged.numSamples(), block1.numSamples() + block2.numSamples() )
+
+		for y in range( region.min.y, region.max.y + 1 ) :
+			for x in range( region.min.x, region.max.x + 1 ) :
+
+				i = merged.pixelIndex( x, y )
+				self.assertEqual( merged.numSamples( i ), block1.numSamples( i ) + block2.numSamples( i ) )
+
+				offsets = merged.sampleOffsets()
+				depths = list( merged.depths()[offsets[i]:offsets[i+1]] )
+				self.assertEqual( depths, sorted( depths ) )
+
+				p = merged.pixel( x, y )
+				p1 = block1.pixel( x, y )
+				p2 = block2.pixel( x, y )
+				if p is None :
+					self.assertTrue( p1 is None and p2 is None )
+					continue
+
+				expected = IECore.DeepPixel( [ "R", "A" ] )
+				for source in ( p1, p2 ) :
+					if source is not None :
+						expected.merge( source )
+				self.assertEqual( p.composite(), expected.composite() )
+
+	def testMergeErrors( self ) :
+
+		region = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 3 ) )
+		block = self.__block( region, [ "R", "A" ] )
+
+		self.assertRaises( RuntimeError, IECore.DeepImageAlgo.merge, [] )
+		self.assertRaises( RuntimeError, IECore.DeepImageAlgo.merge, [ block, self.__block( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 4 ) ), [ "R", "A" ] ) ] )
+		self.assertRaises( RuntimeError, IECore.DeepImageAlgo.merge, [ block, self.__block( region, [ "G", "A" ] ) ] )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -0,0 +1,109 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+
+import IECore
+
+class DeepImageBlockTest( unittest.TestCase ) :
+
+	def testConstructor( self ) :
+
+		region = IECore.Box2i( IECore.V2i( 1, 2 ), IECore.V2i( 3, 3 ) )
+		b = IECore.DeepImageBlock( region, [ "R", "G", "B", "A" ] )
+
+		self.assertEqual( b.region(), region )
+		self.assertEqual( b.numPixels(), 6 )
+		self.assertEqual( b.numChannels(), 4 )
+		self.assertEqual( b.channelNames(), IECore.StringVectorData( [ "R", "G", "B", "A" ] ) )
+		self.assertEqual( b.channelIndex( "B" ), 2 )
+		self.assertEqual( b.channelIndex( "Z" ), -1 )
+		self.assertEqual( b.numSamples(), 0 )
+		self.assertEqual( b.sampleOffsets(), IECore.UIntVectorData( [ 0 ] * 7 ) )
+		self.assertEqual( b.depths(), IECore.FloatVectorData() )
+
+		for x in range( 1, 4 ) :
+			for y in range( 2, 4 ) :
+				self.assertEqual( b.pixel( x, y ), None )
+
+	def testSampleCounts( self ) :
+
+		b = IECore.DeepImageBlock( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 2, 1 ) ), [ "A" ] )
+		self.assertRaises( RuntimeError, b.setSampleCounts, [ 1, 2 ] )
+
+		b.setSampleCounts( [ 1, 0, 3, 2, 0, 1 ] )
+		self.assertEqual( b.numSamples(), 7 )
+		self.assertEqual( [ b.numSamples( i ) for i in range( 0, 6 ) ], [ 1, 0, 3, 2, 0, 1 ] )
+		self.assertEqual( b.sampleOffsets(), IECore.UIntVectorData( [ 0, 1, 1, 4, 6, 6, 7 ] ) )
+		self.assertEqual( b.pixelIndex( 2, 0 ), 2 )
+		self.assertEqual( b.pixelIndex( 0, 1 ), 3 )
+		self.assertEqual( b.depths(), IECore.FloatVectorData( [ 0 ] * 7 ) )
+		self.assertEqual( b.channelData( 0 ), IECore.FloatVectorData( [ 0 ] * 7 ) )
+
+	def testPixels( self ) :
+
+		b = IECore.DeepImageBlock( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 1, 0 ) ), [ "R", "A" ] )
+		b.setSampleCounts( [ 0, 2 ] )
+
+		b.setDepths( IECore.FloatVectorData( [ 2, 1 ] ) )
+		b.setChannelData( 0, IECore.FloatVectorData( [ 0.25, 0.5 ] ) )
+		b.setChannelData( 1, IECore.FloatVectorData( [ 0.5, 1 ] ) )
+		self.assertRaises( RuntimeError, b.setDepths, IECore.FloatVectorData( [ 1 ] ) )
+		self.assertRaises( RuntimeError, b.setChannelData, 2, IECore.FloatVectorData( [ 1, 2 ] ) )
+
+		self.assertEqual( b.pixel( 0, 0 ), None )
+		p = b.pixel( 1, 0 )
+		self.assertEqual( p.channelNames(), ( "R", "A" ) )
+		self.assertEqual( p.numSamples(), 2 )
+		# DeepPixel sorts its samples by depth
+		self.assertEqual( p.getDepth( 0 ), 1 )
+		self.assertEqual( p.channelData( 0 ), ( 0.5, 1 ) )
+		self.assertEqual( p.getDepth( 1 ), 2 )
+		self.assertEqual( p.channelData( 1 ), ( 0.25, 0.5 ) )
+		self.assertRaises( RuntimeError, b.pixel, 2, 0 )
+
+		p2 = IECore.DeepPixel( [ "R", "A" ] )
+		p2.addSample( 3, [ 0.125, 0.25 ] )
+		p2.addSample( 4, [ 0.0625, 0.75 ] )
+		b.setPixel( 1, 0, p2 )
+		self.assertEqual( b.depths(), IECore.FloatVectorData( [ 3, 4 ] ) )
+		self.assertEqual( b.channelData( 0 ), IECore.FloatVectorData( [ 0.125, 0.0625 ] ) )
+		self.assertEqual( b.channelData( 1 ), IECore.FloatVectorData( [ 0.25, 0.75 ] ) )
+
+		# wrong number of samples
+		self.assertRaises( RuntimeError, b.setPixel, 0, 0, p2 )
+
+if __name__ == "__main__":
+	unittest.main()
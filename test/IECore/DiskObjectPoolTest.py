@@ -0,0 +1,157 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+import os
+import shutil
+import time
+
+from IECore import *
+
+class DiskObjectPoolTest( unittest.TestCase ) :
+
+	__directory = "/tmp/IECoreDiskObjectPoolTest"
+
+	def testStoreAndRetrieve( self ) :
+
+		p = DiskObjectPool( self.__directory, 1024 * 1024 )
+		self.assertEqual( p.directory(), self.__directory )
+		self.assertEqual( p.getMaxDiskUsage(), 1024 * 1024 )
+		self.assertEqual( p.diskUsage(), 0 )
+
+		a = StringVectorData( [ "a", "b", "c" ] )
+		self.assertFalse( p.contains( a.hash() ) )
+		self.assertEqual( p.retrieve( a.hash() ), None )
+
+		self.assertTrue( p.store( a ) )
+		self.assertFalse( p.store( a ) )
+		self.assertTrue( p.contains( a.hash() ) )
+		self.assertTrue( p.diskUsage() > 0 )
+		self.assertEqual( p.retrieve( a.hash() ), a )
+
+		# a second pool on the same directory should see the same objects
+		p2 = DiskObjectPool( self.__directory, 1024 * 1024 )
+		self.assertEqual( p2.diskUsage(), p.diskUsage() )
+		self.assertEqual( p2.retrieve( a.hash() ), a )
+
+		self.assertTrue( p.erase( a.hash() ) )
+		self.assertFalse( p.erase( a.hash() ) )
+		self.assertFalse( p2.contains( a.hash() ) )
+		self.assertEqual( p.diskUsage(), 0 )
+
+	def testMaxDiskUsage( self ) :
+
+		p = DiskObjectPool( self.__directory, 1024 * 1024 )
+		for i in range( 0, 100 ) :
+			p.store( IntVectorData( range( i, i + 1000 ) ) )
+
+		self.assertTrue( p.diskUsage() <= 1024 * 1024 )
+
+		p.setMaxDiskUsage( p.diskUsage() / 2 )
+		self.assertTrue( p.diskUsage() <= p.getMaxDiskUsage() )
+		self.assertTrue( p.diskUsage() > 0 )
+
+		p.clear()
+		self.assertEqual( p.diskUsage(), 0 )
+		for i in range( 0, 100 ) :
+			self.assertFalse( p.contains( IntVectorData( range( i, i + 1000 ) ).hash() ) )
+
+	def testTemporaryFilesInProgress( self ) :
+
+		p = DiskObjectPool( self.__directory, 1024 * 1024 )
+		a = IntVectorData( range( 0, 1000 ) )
+		p.store( a )
+
+		# simulate files being written by other processes. the recent
+		# one must be left alone, but the abandoned one may be removed.
+		subdirectory = os.path.join( self.__directory, a.hash().toString()[:2] )
+		inProgress = os.path.join( subdirectory, "inProgress.cob.1.0.tmp" )
+		abandoned = os.path.join( subdirectory, "abandoned.cob.1.1.tmp" )
+		for f in ( inProgress, abandoned ) :
+			open( f, "w" ).write( "x" * 1000 )
+
+		oneDayAgo = time.time() - 60 * 60 * 24
+		os.utime( abandoned, ( oneDayAgo, oneDayAgo ) )
+
+		p.setMaxDiskUsage( 0 )
+		self.assertTrue( os.path.exists( inProgress ) )
+		self.assertFalse( os.path.exists( abandoned ) )
+		self.assertFalse( p.contains( a.hash() ) )
+
+		open( abandoned, "w" ).write( "x" * 1000 )
+		os.utime( abandoned, ( oneDayAgo, oneDayAgo ) )
+
+		p.clear()
+		self.assertTrue( os.path.exists( inProgress ) )
+		self.assertFalse( os.path.exists( abandoned ) )
+
+	def testObjectPoolSecondLevel( self ) :
+
+		d = DiskObjectPool( self.__directory, 1024 * 1024 )
+
+		a = IntVectorData( range( 0, 1000 ) )
+		b = IntVectorData( range( 1000, 2000 ) )
+
+		p = ObjectPool( a.memoryUsage(), diskObjectPool = d )
+		self.assertTrue( p.diskObjectPool().isSame( d ) )
+
+		p.store( a, ObjectPool.StoreReference )
+		self.assertFalse( d.contains( a.hash() ) )
+
+		# storing b evicts a from memory, moving it to disk
+		p.store( b, ObjectPool.StoreReference )
+		self.assertFalse( p.contains( a.hash() ) )
+		self.assertTrue( d.contains( a.hash() ) )
+
+		# and retrieving a reloads it into memory
+		self.assertEqual( p.retrieve( a.hash() ), a )
+		self.assertTrue( p.contains( a.hash() ) )
+		self.assertTrue( d.contains( b.hash() ) )
+
+		# explicit removals don't write to disk
+		d.clear()
+		p.clear()
+		self.assertFalse( d.contains( a.hash() ) )
+
+	def setUp( self ) :
+
+		self.tearDown()
+
+	def tearDown( self ) :
+
+		if os.path.exists( self.__directory ) :
+			shutil.rmtree( self.__directory )
+
+if __name__ == "__main__":
+	unittest.main()
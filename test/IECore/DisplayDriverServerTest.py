@@ -57,6 +57,14 @@ class DisplayDriverServerTest( unittest.TestCase ) :
 		self.assertNotEqual( s4.portNumber(), 0 )
 		self.assertNotEqual( s4.portNumber(), s3.portNumber() )
 
+	def testNumThreads( self ) :
+
+		s = IECore.DisplayDriverServer( 0, 3 )
+		self.assertEqual( s.numThreads(), 3 )
+
+		s = IECore.DisplayDriverServer()
+		self.failUnless( s.numThreads() >= 1 )
+
 if __name__ == "__main__":
 	unittest.main()
 
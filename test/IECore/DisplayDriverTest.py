@@ -72,6 +72,43 @@ class TestImageDisplayDriver(unittest.TestCase):
 		idd.imageClose()
 		self.assertEqual( idd.image(), img )
 
+	def testBuckets( self ) :
+
+		channels = [ "a", "b", "c", "d", "e" ]
+		dataWindow = Box2i( V2i( 10, 20 ), V2i( 19, 29 ) )
+		idd = ImageDisplayDriver( dataWindow, dataWindow, channels, CompoundData() )
+
+		def value( x, y, c ) :
+			return x + y * 100 + c * 10000
+
+		for by in range( 20, 30, 4 ) :
+			for bx in range( 10, 20, 4 ) :
+				box = Box2i( V2i( bx, by ), V2i( min( bx + 3, 19 ), min( by + 3, 29 ) ) )
+				buf = FloatVectorData()
+				for y in range( box.min.y, box.max.y + 1 ) :
+					for x in range( box.min.x, box.max.x + 1 ) :
+						for c in range( 0, len( channels ) ) :
+							buf.append( value( x, y, c ) )
+				idd.imageData( box, buf )
+
+			if by == 20 :
+				# copies taken before the image is complete mustn't
+				# be affected by subsequent buckets.
+				partial = idd.image().copy()
+
+		idd.imageClose()
+
+		image = idd.image()
+		for c in range( 0, len( channels ) ) :
+			data = image[channels[c]].data
+			partialData = partial[channels[c]].data
+			i = 0
+			for y in range( 20, 30 ) :
+				for x in range( 10, 20 ) :
+					self.assertEqual( data[i], value( x, y, c ) )
+					self.assertEqual( partialData[i], value( x, y, c ) if y < 24 else 0 )
+					i += 1
+
 	def testFactory( self ):
 
 		idd = DisplayDriver.create( "ImageDisplayDriver", Box2i( V2i(0,0), V2i(100,100) ), Box2i( V2i(10,10), V2i(40,40) ), [ 'r', 'g', 'b' ], CompoundData() )
@@ -135,6 +172,63 @@ class TestImageDisplayDriver(unittest.TestCase):
 		i = dd.image()
 		self.assertEqual( i["Y"].data, y )
 
+class TestImageWriterDisplayDriver( unittest.TestCase ) :
+
+	__fileName = "test/IECore/data/exrFiles/imageWriterDisplayDriver.exr"
+
+	def testWrite( self ) :
+
+		img = Reader.create( "test/IECore/data/tiff/bluegreen_noise.400x300.tif" )()
+		channelNames = [ "R", "G", "B" ]
+
+		dd = DisplayDriver.create(
+			"ImageWriterDisplayDriver",
+			img.displayWindow,
+			img.dataWindow,
+			channelNames,
+			{
+				"fileName" : StringData( self.__fileName ),
+				"header:myAttribute" : StringData( "myValue" ),
+			}
+		)
+		self.failUnless( isinstance( dd, ImageWriterDisplayDriver ) )
+		self.failUnless( isinstance( dd.writer(), EXRImageWriter ) )
+		self.assertEqual( dd.scanLineOrderOnly(), False )
+		self.assertEqual( dd.acceptsRepeatedData(), False )
+
+		# send the image in buckets, bottom row first
+		width = img.dataWindow.size().x + 1
+		bucketSize = 64
+		for y in reversed( range( img.dataWindow.min.y, img.dataWindow.max.y + 1, bucketSize ) ) :
+			for x in range( img.dataWindow.min.x, img.dataWindow.max.x + 1, bucketSize ) :
+				box = Box2i( V2i( x, y ), V2i( min( x + bucketSize - 1, img.dataWindow.max.x ), min( y + bucketSize - 1, img.dataWindow.max.y ) ) )
+				data = FloatVectorData()
+				for by in range( box.min.y, box.max.y + 1 ) :
+					for bx in range( box.min.x, box.max.x + 1 ) :
+						i = ( by - img.dataWindow.min.y ) * width + bx - img.dataWindow.min.x
+						for c in channelNames :
+							data.append( img[c].data[i] )
+				dd.imageData( box, data )
+
+		dd.imageClose()
+		self.assertRaises( RuntimeError, dd.imageData, img.dataWindow, FloatVectorData( [ 0 ] * width * ( img.dataWindow.size().y + 1 ) * 3 ) )
+
+		imgNew = Reader.create( self.__fileName ).read()
+		self.assertEqual( imgNew.dataWindow, img.dataWindow )
+		self.assertEqual( imgNew.blindData()["myAttribute"], StringData( "myValue" ) )
+		for c in channelNames :
+			self.assertEqual( imgNew[c].data, img[c].data )
+
+	def testMissingFileName( self ) :
+
+		window = Box2i( V2i( 0 ), V2i( 15 ) )
+		self.assertRaises( RuntimeError, ImageWriterDisplayDriver, window, window, [ "Y" ], CompoundData() )
+
+	def tearDown( self ) :
+
+		if os.path.isfile( self.__fileName ) :
+			os.remove( self.__fileName )
+
 class TestClientServerDisplayDriver(unittest.TestCase):
 
 	def setUp( self ):
@@ -259,6 +353,125 @@ class TestClientServerDisplayDriver(unittest.TestCase):
 		i = ImageDisplayDriver.removeStoredImage( "myHandle" )
 		self.assertEqual( i["Y"].data, y )
 
+	def testDataEncodings( self ) :
+
+		window = Box2i( V2i( 0 ), V2i( 15 ) )
+		# values exactly representable as halfs, so that
+		# all encodings should transfer them losslessly.
+		y = FloatVectorData( [ ( i % 64 ) / 16.0 for i in range( 0, 16 * 16 ) ] )
+
+		for encoding in [ "float", "half", "halfLZ4" ] :
+
+			dd = ClientDisplayDriver(
+				window, window,
+				[ "Y" ],
+				CompoundData( {
+					"displayHost" : "localhost",
+					"displayPort" : "1559",
+					"displayDataEncoding" : encoding,
+					"remoteDisplayType" : "ImageDisplayDriver",
+					"handle" : "myHandle"
+				} )
+			)
+
+			for i in range( 0, 16 ) :
+				row = Box2i( V2i( 0, i ), V2i( 15, i ) )
+				dd.imageData( row, FloatVectorData( y[i*16:(i+1)*16] ) )
+			dd.imageClose()
+
+			image = ImageDisplayDriver.removeStoredImage( "myHandle" )
+			self.assertEqual( image["Y"].data, y )
+
+	def testInterleavedSessions( self ) :
+
+		window = Box2i( V2i( 0 ), V2i( 15 ) )
+
+		drivers = []
+		for i in range( 0, 4 ) :
+			drivers.append(
+				ClientDisplayDriver(
+					window, window,
+					[ "Y" ],
+					CompoundData( {
+						"displayHost" : "localhost",
+						"displayPort" : "1559",
+						"remoteDisplayType" : "ImageDisplayDriver",
+						"handle" : "myHandle%d" % i
+					} )
+				)
+			)
+
+		for y in range( 0, 16 ) :
+			row = Box2i( V2i( 0, y ), V2i( 15, y ) )
+			for i, dd in enumerate( drivers ) :
+				dd.imageData( row, FloatVectorData( [ i + y ] * 16 ) )
+
+		for dd in drivers :
+			dd.imageClose()
+
+		for i in range( 0, 4 ) :
+			image = ImageDisplayDriver.removeStoredImage( "myHandle%d" % i )
+			expected = FloatVectorData()
+			for y in range( 0, 16 ) :
+				expected.extend( [ float( i + y ) ] * 16 )
+			self.assertEqual( image["Y"].data, expected )
+
+	def testSendQueueMemory( self ) :
+
+		window = Box2i( V2i( 0 ), V2i( 15 ) )
+		y = FloatVectorData( [ i / 16.0 for i in range( 0, 16 * 16 ) ] )
+
+		for queueMemory in [ 0, 1, 64 ] :
+
+			dd = ClientDisplayDriver(
+				window, window,
+				[ "Y" ],
+				CompoundData( {
+					"displayHost" : "localhost",
+					"displayPort" : "1559",
+					"displaySendQueueMemory" : IntData( queueMemory ),
+					"remoteDisplayType" : "ImageDisplayDriver",
+					"handle" : "myHandle"
+				} )
+			)
+
+			for i in range( 0, 16 ) :
+				row = Box2i( V2i( 0, i ), V2i( 15, i ) )
+				dd.imageData( row, FloatVectorData( y[i*16:(i+1)*16] ) )
+			dd.imageClose()
+
+			image = ImageDisplayDriver.removeStoredImage( "myHandle" )
+			self.assertEqual( image["Y"].data, y )
+
+		self.assertRaises(
+			RuntimeError,
+			ClientDisplayDriver,
+			window, window,
+			[ "Y" ],
+			CompoundData( {
+				"displayHost" : "localhost",
+				"displayPort" : "1559",
+				"displaySendQueueMemory" : IntData( -1 ),
+				"remoteDisplayType" : "ImageDisplayDriver",
+			} )
+		)
+
+	def testInvalidDataEncoding( self ) :
+
+		window = Box2i( V2i( 0 ), V2i( 15 ) )
+		self.assertRaises(
+			RuntimeError,
+			ClientDisplayDriver,
+			window, window,
+			[ "Y" ],
+			CompoundData( {
+				"displayHost" : "localhost",
+				"displayPort" : "1559",
+				"displayDataEncoding" : "notAnEncoding",
+				"remoteDisplayType" : "ImageDisplayDriver",
+			} )
+		)
+
 	def tearDown( self ):
 
 		self.server = None
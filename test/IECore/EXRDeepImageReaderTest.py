@@ -113,6 +113,30 @@ class EXRDeepImageReaderTest(unittest.TestCase):
 		self.assertEqual( d.getDepth(7), 9.751317024230957 )
 		self.assertEqual( d.getDepth(8), 9.7521572113037109 )
 
+	def testReadBlock( self ) :
+
+		reader = DeepImageReader.create( "test/IECoreRI/data/exr/primitives.exr" )
+		region = Box2i( V2i( 150, 280 ), V2i( 159, 289 ) )
+		block = reader.readBlock( region )
+
+		self.assertEqual( block.region(), region )
+		self.assertEqual( block.channelNames(), reader.channelNames() )
+		self.assertTrue( block.numSamples() > 0 )
+
+		for y in range( region.min.y, region.max.y + 1 ) :
+			for x in range( region.min.x, region.max.x + 1 ) :
+				p = reader.readPixel( x, y )
+				bp = block.pixel( x, y )
+				if p is None :
+					self.assertEqual( bp, None )
+					continue
+				self.assertEqual( bp.numSamples(), p.numSamples() )
+				for i in range( 0, p.numSamples() ) :
+					self.assertEqual( bp.getDepth( i ), p.getDepth( i ) )
+					self.assertEqual( bp.channelData( i ), p.channelData( i ) )
+
+		self.assertRaises( RuntimeError, reader.readBlock, Box2i( V2i( 500 ), V2i( 512 ) ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
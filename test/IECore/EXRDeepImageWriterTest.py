@@ -129,6 +129,43 @@ class EXRDeepImageWriterTest(unittest.TestCase):
 		self.assertEqual( dict( zip( rp3.channelNames(), rp3[1] ) ), { "R" : 0.0625,  "G" : 0.25, "A" : 0.0625 } )
 		self.failUnless( reader.readPixel( 1, 0 ) is None )
 	
+	def testWriteBlock( self ) :
+
+		reader = EXRDeepImageReader( "test/IECoreRI/data/exr/primitives.exr" )
+
+		writer = EXRDeepImageWriter( EXRDeepImageWriterTest.__output )
+		writer.parameters()['channelNames'].setValue( reader.channelNames() )
+		writer.parameters()['halfPrecisionChannels'].setValue( StringVectorData( [ "R", "G", "B" ] ) )
+		writer.parameters()['resolution'].setTypedValue( reader.dataWindow().size() + V2i( 1 ) )
+
+		# the first block only covers the end of the scanline,
+		# so the rest of each scanline should be empty.
+		block1 = reader.readBlock( Box2i( V2i( 256, 0 ), V2i( 511, 299 ) ) )
+		block2 = reader.readBlock( Box2i( V2i( 0, 300 ), V2i( 511, 511 ) ) )
+		writer.writeBlock( block1 )
+		writer.writeBlock( block2 )
+
+		# we can't go backwards.
+		self.assertRaises( RuntimeError, writer.writeBlock, block1 )
+		del writer
+
+		written = EXRDeepImageReader( EXRDeepImageWriterTest.__output )
+		self.assertEqual( written.channelNames(), reader.channelNames() )
+
+		for x, y in [ ( 154, 285 ), ( 300, 285 ), ( 154, 400 ), ( 300, 400 ) ] :
+			p = reader.readPixel( x, y )
+			wp = written.readPixel( x, y )
+			if x < 256 and y < 300 :
+				self.assertEqual( wp, None )
+				continue
+			self.assertEqual( p is None, wp is None )
+			if p is None :
+				continue
+			self.assertEqual( wp.numSamples(), p.numSamples() )
+			for i in range( 0, p.numSamples() ) :
+				self.assertEqual( wp.getDepth( i ), p.getDepth( i ) )
+				self.assertEqual( wp.channelData( i ), p.channelData( i ) )
+
 	def tearDown( self ) :
 		
 		if os.path.isfile( EXRDeepImageWriterTest.__output ) :
@@ -245,6 +245,25 @@ class TestEXRReader(unittest.TestCase):
 				self.assertEqual( wholeResult.floatPrimVar( wholeG ), slicedResult.floatPrimVar( slicedG ) )
 				self.assertEqual( wholeResult.floatPrimVar( wholeB ), slicedResult.floatPrimVar( slicedB ) )
 
+	def testAlignedDataWindow( self ) :
+
+		# scanline files can only be read efficiently a whole row at a time
+		r = EXRImageReader( "test/IECore/data/exrFiles/uvMapWithDataWindow.100x100.exr" )
+		self.assertEqual( r.alignedDataWindow( Box2i( V2i( 30 ), V2i( 40 ) ) ), Box2i( V2i( 25, 30 ), V2i( 49, 40 ) ) )
+		self.assertEqual( r.alignedDataWindow( r.dataWindow() ), r.dataWindow() )
+
+		# and reading an aligned window must give the same
+		# results as reading the whole image
+		iWhole = r.read()
+		r.parameters()["dataWindow"].setTypedValue( Box2i( V2i( 25, 30 ), V2i( 49, 40 ) ) )
+		iSliced = r.read()
+
+		offset = ( 30 - 25 ) * 25
+		for c in ( "R", "G", "B" ) :
+			self.assertEqual( len( iSliced[c].data ), 25 * 11 )
+			for i in range( 0, len( iSliced[c].data ) ) :
+				self.assertEqual( iSliced[c].data[i], iWhole[c].data[i + offset] )
+
 	def testNonZeroDataWindowOrigin( self ) :
 
 		r = EXRImageReader( "test/IECore/data/exrFiles/uvMapWithDataWindow.100x100.exr" )
@@ -280,6 +280,95 @@ class TestEXRWriter(unittest.TestCase):
 
 		self.assertEqual( imgBlindData, CompoundData( headerValues ) )
 
+	def __writeBlocks( self, writer, img, channelNames, blockSize = 16 ) :
+
+		# writes the image as interleaved blocks, in reverse
+		# order to make sure the writer doesn't depend on
+		# receiving scanlines in order.
+		dataWindow = img.dataWindow
+		width = dataWindow.size().x + 1
+
+		boxes = []
+		for y in range( dataWindow.min.y, dataWindow.max.y + 1, blockSize ) :
+			for x in range( dataWindow.min.x, dataWindow.max.x + 1, blockSize ) :
+				boxes.append( Box2i( V2i( x, y ), V2i( min( x + blockSize - 1, dataWindow.max.x ), min( y + blockSize - 1, dataWindow.max.y ) ) ) )
+		boxes.reverse()
+
+		writer.beginImage( img.displayWindow, dataWindow, channelNames )
+		for box in boxes :
+			data = FloatVectorData()
+			for y in range( box.min.y, box.max.y + 1 ) :
+				for x in range( box.min.x, box.max.x + 1 ) :
+					i = ( y - dataWindow.min.y ) * width + x - dataWindow.min.x
+					for c in channelNames :
+						data.append( img[c].data[i] )
+			writer.writeBlock( box, data )
+		writer.endImage()
+
+	def testWriteBlocks( self ) :
+
+		displayWindow = Box2i( V2i( 0 ), V2i( 99 ) )
+		dataWindow = Box2i( V2i( 10, 5 ), V2i( 73, 50 ) )
+		imgOrig = self.__makeFloatImage( dataWindow, displayWindow, withAlpha = True )
+
+		w = EXRImageWriter()
+		w["fileName"].setTypedValue( "test/IECore/data/exrFiles/output.exr" )
+		self.__writeBlocks( w, imgOrig, [ "R", "G", "B", "A" ] )
+
+		imgNew = Reader.create( "test/IECore/data/exrFiles/output.exr" ).read()
+		self.assertEqual( imgNew.dataWindow, dataWindow )
+		self.assertEqual( imgNew.displayWindow, displayWindow )
+		self.assertEqual( set( imgNew.keys() ), set( [ "R", "G", "B", "A" ] ) )
+		for c in [ "R", "G", "B", "A" ] :
+			self.assertEqual( imgNew[c].data, imgOrig[c].data )
+
+		# only the channels requested by the parameter should be written
+
+		w["channels"].setValue( StringVectorData( [ "B", "R" ] ) )
+		self.__writeBlocks( w, imgOrig, [ "R", "G", "B", "A" ] )
+
+		imgNew = Reader.create( "test/IECore/data/exrFiles/output.exr" ).read()
+		self.assertEqual( set( imgNew.keys() ), set( [ "R", "B" ] ) )
+		for c in [ "R", "B" ] :
+			self.assertEqual( imgNew[c].data, imgOrig[c].data )
+
+	def testWriteBlocksWithColorConversion( self ) :
+
+		displayWindow = Box2i( V2i( 0 ), V2i( 39 ) )
+		imgOrig = self.__makeFloatImage( displayWindow, displayWindow )
+
+		w = Writer.create( imgOrig, "test/IECore/data/exrFiles/output.exr" )
+		w["colorSpace"].setValue( StringData( "srgb" ) )
+		w.write()
+		imgExpected = Reader.create( "test/IECore/data/exrFiles/output.exr" ).read()
+		os.remove( "test/IECore/data/exrFiles/output.exr" )
+
+		# blocks can't be converted as they arrive, but must
+		# still give the same result.
+		self.__writeBlocks( w, imgOrig, [ "R", "G", "B" ] )
+		imgNew = Reader.create( "test/IECore/data/exrFiles/output.exr" ).read()
+		for c in [ "R", "G", "B" ] :
+			self.assertEqual( imgNew[c].data, imgExpected[c].data )
+
+	def testWriteBlocksErrors( self ) :
+
+		window = Box2i( V2i( 0 ), V2i( 9 ) )
+		w = EXRImageWriter()
+		w["fileName"].setTypedValue( "test/IECore/data/exrFiles/output.exr" )
+
+		self.assertRaises( RuntimeError, w.writeBlock, window, FloatVectorData( [ 0 ] * 100 ) )
+		self.assertRaises( RuntimeError, w.endImage )
+
+		w.beginImage( window, window, [ "Y" ] )
+		self.assertRaises( RuntimeError, w.beginImage, window, window, [ "Y" ] )
+		self.assertRaises( RuntimeError, w.writeBlock, Box2i( V2i( 5 ), V2i( 10 ) ), FloatVectorData( [ 0 ] * 36 ) )
+		self.assertRaises( RuntimeError, w.writeBlock, window, FloatVectorData( [ 0 ] * 99 ) )
+		w.writeBlock( window, FloatVectorData( [ 0.5 ] * 100 ) )
+		w.endImage()
+
+		imgNew = Reader.create( "test/IECore/data/exrFiles/output.exr" ).read()
+		self.assertEqual( imgNew["Y"].data, FloatVectorData( [ 0.5 ] * 100 ) )
+
 	def setUp( self ) :
 
 		if os.path.isfile( "test/IECore/data/exrFiles/output.exr") :
@@ -33,6 +33,7 @@
 ##########################################################################
 
 import os
+import time
 import unittest
 import shutil
 from IECore import *
@@ -458,6 +459,39 @@ class testLs( unittest.TestCase ) :
 		l = ls( "test/sequences/lsTest/a.###.tif" )
 		self.assertFalse( l )
 
+	def testFrameNumberParsing( self ) :
+
+		def names( sequences ) :
+			return sorted( [ str( s ) for s in sequences ] )
+
+		self.assertEqual( names( findSequences( [ "a1b2c", "a1b3c" ] ) ), [ "a1b#c 2-3" ] )
+		self.assertEqual( names( findSequences( [ "a--1.tif", "a--2.tif" ] ) ), [ "a-#.tif -2--1" ] )
+		self.assertEqual( names( findSequences( [ "a.1.mp3", "a.2.mp3" ] ) ), [ "a.#.mp3 1-2" ] )
+		self.assertEqual( names( findSequences( [ "a.1.tiff3", "a.2.tiff3" ] ) ), [] )
+		self.assertEqual( names( findSequences( [ "mp1", "mp2" ] ) ), [ "mp# 1-2" ] )
+		self.assertEqual( names( findSequences( [ "1", "2", "x", "#1", "#2" ] ) ), [ "# 1-2" ] )
+
+	def testListingCache( self ) :
+
+		self.tearDown()
+		os.system( "mkdir -p test/sequences/lsTest" )
+
+		s = FileSequence( "a.####.tif", FrameRange( 1, 10 ) )
+		for f in s.fileNames() :
+			os.system( "touch 'test/sequences/lsTest/" + f + "'" )
+
+		# Listings are only cached for directories which haven't
+		# been modified recently.
+		time.sleep( 2.5 )
+
+		self.assertEqual( ls( "test/sequences/lsTest" ), [ s ] )
+		self.assertEqual( ls( "test/sequences/lsTest" ), [ s ] )
+
+		os.system( "touch 'test/sequences/lsTest/a.0011.tif'" )
+		s.frameList = FrameRange( 1, 11 )
+		self.assertEqual( ls( "test/sequences/lsTest" ), [ s ] )
+		self.assertEqual( ls( "test/sequences/lsTest/a.####.tif" ), s )
+
 	def tearDown( self ) :
 
 		if os.path.exists( "test/sequences" ) :
@@ -0,0 +1,211 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <cstdlib>
+
+#include "boost/lexical_cast.hpp"
+
+#include "IECore/FlatMap.h"
+#include "IECore/InternedString.h"
+
+#include "FlatMapTest.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace IECore
+{
+
+struct FlatMapTest
+{
+
+	typedef FlatMap<InternedString, int> Map;
+	typedef std::map<InternedString, int> StdMap;
+
+	// Performs the same random operations on a FlatMap and
+	// a std::map, checking that they always agree.
+	void testMatchesStdMap()
+	{
+		srand( 42 );
+
+		Map m;
+		StdMap s;
+		for( int i = 0; i < 10000; ++i )
+		{
+			const InternedString key( lexical_cast<std::string>( rand() % 100 ) );
+			switch( rand() % 4 )
+			{
+				case 0 :
+					m[key] = i;
+					s[key] = i;
+					break;
+				case 1 :
+				{
+					std::pair<Map::iterator, bool> r = m.insert( Map::value_type( key, i ) );
+					std::pair<StdMap::iterator, bool> rs = s.insert( StdMap::value_type( key, i ) );
+					BOOST_CHECK_EQUAL( r.second, rs.second );
+					BOOST_CHECK( r.first->first == key );
+					BOOST_CHECK_EQUAL( r.first->second, rs.first->second );
+					break;
+				}
+				case 2 :
+					BOOST_CHECK_EQUAL( m.erase( key ), s.erase( key ) );
+					break;
+				case 3 :
+				{
+					Map::const_iterator it = m.find( key );
+					StdMap::const_iterator its = s.find( key );
+					BOOST_CHECK_EQUAL( it == m.end(), its == s.end() );
+					if( it != m.end() )
+					{
+						BOOST_CHECK_EQUAL( it->second, its->second );
+					}
+					BOOST_CHECK_EQUAL( m.count( key ), s.count( key ) );
+					break;
+				}
+			}
+
+			BOOST_REQUIRE_EQUAL( m.size(), s.size() );
+		}
+
+		// Iteration order must match, because CompoundObject and CompoundData
+		// rely on it for isEqualTo().
+		Map::const_iterator it = m.begin();
+		for( StdMap::const_iterator its = s.begin(); its != s.end(); ++its, ++it )
+		{
+			BOOST_CHECK( it->first == its->first );
+			BOOST_CHECK_EQUAL( it->second, its->second );
+		}
+		BOOST_CHECK( it == m.end() );
+	}
+
+	void testEraseWhileIterating()
+	{
+		Map m;
+		for( int i = 0; i < 10; ++i )
+		{
+			m[lexical_cast<std::string>( i )] = i;
+		}
+
+		for( Map::iterator it = m.begin(); it != m.end(); )
+		{
+			if( it->second % 2 )
+			{
+				it = m.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		BOOST_CHECK_EQUAL( m.size(), 5u );
+		for( Map::const_iterator it = m.begin(); it != m.end(); ++it )
+		{
+			BOOST_CHECK_EQUAL( it->second % 2, 0 );
+		}
+	}
+
+	void testHintedInsert()
+	{
+		Map m;
+		m["a"] = 1;
+		m["b"] = 2;
+
+		// A correct hint and an incorrect one must
+		// both give the same result as a plain insert.
+		Map::iterator it = m.insert( m.end(), Map::value_type( "c", 3 ) );
+		BOOST_CHECK( it->first == InternedString( "c" ) );
+		it = m.insert( m.begin(), Map::value_type( "d", 4 ) );
+		BOOST_CHECK( it->first == InternedString( "d" ) );
+		it = m.insert( m.begin(), Map::value_type( "a", 10 ) );
+		BOOST_CHECK_EQUAL( it->second, 1 );
+
+		BOOST_CHECK_EQUAL( m.size(), 4u );
+		for( Map::const_iterator it = m.begin(); it != m.end(); ++it )
+		{
+			if( it != m.begin() )
+			{
+				BOOST_CHECK( (it - 1)->first < it->first );
+			}
+		}
+	}
+
+	void testComparison()
+	{
+		Map m1;
+		m1["a"] = 1;
+		m1["b"] = 2;
+
+		Map m2;
+		m2["b"] = 2;
+		m2["a"] = 1;
+
+		BOOST_CHECK( m1 == m2 );
+		BOOST_CHECK( !( m1 != m2 ) );
+
+		m2["b"] = 3;
+		BOOST_CHECK( m1 != m2 );
+
+		Map m3( m1 );
+		BOOST_CHECK( m3 == m1 );
+		m3.clear();
+		BOOST_CHECK( m3.empty() );
+		m3.swap( m1 );
+		BOOST_CHECK( m1.empty() );
+		BOOST_CHECK_EQUAL( m3.size(), 2u );
+	}
+
+};
+
+struct FlatMapTestSuite : public boost::unit_test::test_suite
+{
+
+	FlatMapTestSuite() : boost::unit_test::test_suite( "FlatMapTestSuite" )
+	{
+		boost::shared_ptr<FlatMapTest> instance( new FlatMapTest() );
+		add( BOOST_CLASS_TEST_CASE( &FlatMapTest::testMatchesStdMap, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &FlatMapTest::testEraseWhileIterating, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &FlatMapTest::testHintedInsert, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &FlatMapTest::testComparison, instance ) );
+	}
+};
+
+void addFlatMapTest( boost::unit_test::test_suite *test )
+{
+	test->add( new FlatMapTestSuite() );
+}
+
+} // namespace IECore
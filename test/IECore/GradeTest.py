@@ -101,6 +101,31 @@ class TestGradeColorTransformOp( unittest.TestCase ) :
 		imgNew = grade( input = rampImg )
 		self.assertEqual( rampImg, imgNew )
 
+	def testClamps( self ) :
+
+		values = [ -1, -0.5, 0, 0.25, 0.5, 1, 2 ]
+		p = PointsPrimitive( len( values ) )
+		p["Cs"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, Color3fVectorData( [ Color3f( v ) for v in values ] ) )
+
+		grade = Grade()
+		grade['gamma'] = Color3f( 1, 2, 0.5 )
+
+		def expected( v, gamma, blackClamp, whiteClamp ) :
+			if v >= 0 :
+				v = v ** ( 1.0 / gamma )
+			if blackClamp :
+				v = max( v, 0 )
+			if whiteClamp :
+				v = min( v, 1 )
+			return v
+
+		for blackClamp in ( False, True ) :
+			for whiteClamp in ( False, True ) :
+				pp = grade( input = p, blackClamp = blackClamp, whiteClamp = whiteClamp )
+				for i, v in enumerate( values ) :
+					for c, gamma in enumerate( ( 1, 2, 0.5 ) ) :
+						self.assertAlmostEqual( pp["Cs"].data[i][c], expected( v, gamma, blackClamp, whiteClamp ), 5 )
+
 	def tearDown( self ):
 		if os.path.exists( self.testImgName ):
 			os.remove( self.testImgName )
@@ -78,6 +78,8 @@
 #include "CompoundObjectTest.h"
 #include "ComputationCacheTest.h"
 #include "SceneCacheThreadingTest.h"
+#include "IndexedIOThreadingTest.h"
+#include "FlatMapTest.h"
 
 using namespace boost::unit_test;
 
@@ -121,6 +123,8 @@ bool init()
 		addCompoundObjectTest(test);
 		addComputationCacheTest(test);
 		addSceneCacheThreadingTest(test);
+		addIndexedIOThreadingTest(test);
+		addFlatMapTest(test);
 	}
 	catch (std::exception &ex)
 	{
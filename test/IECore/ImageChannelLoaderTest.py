@@ -0,0 +1,107 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+
+import IECore
+
+class ImageChannelLoaderTest( unittest.TestCase ) :
+
+	def testChannelNames( self ) :
+
+		r = IECore.Reader.create( "test/IECore/data/exrFiles/manyChannels.exr" )
+		l = IECore.ImageChannelLoader( r, IECore.ObjectPool( 1024 * 1024 * 100 ) )
+		self.assertEqual( l.fileName(), "test/IECore/data/exrFiles/manyChannels.exr" )
+		self.assertEqual( l.channelNames(), r.channelNames() )
+		self.assertEqual( l.dataWindow(), r.dataWindow() )
+		self.assertEqual( l.displayWindow(), r.displayWindow() )
+
+		r = IECore.Reader.create( "test/IECore/data/exrFiles/manyChannels.exr" )
+		r["channels"].setValue( IECore.StringVectorData( [ "R", "B", "notAChannel" ] ) )
+		l = IECore.ImageChannelLoader( r, IECore.ObjectPool( 1024 * 1024 * 100 ) )
+		self.assertEqual( l.channelNames(), IECore.StringVectorData( [ "R", "B" ] ) )
+		self.assertRaises( RuntimeError, l.channel, "G" )
+
+	def testLazyLoading( self ) :
+
+		full = IECore.Reader.create( "test/IECore/data/exrFiles/manyChannels.exr" ).read()
+
+		pool = IECore.ObjectPool( 1024 * 1024 * 100 )
+		l = IECore.ImageChannelLoader( IECore.Reader.create( "test/IECore/data/exrFiles/manyChannels.exr" ), pool )
+		self.assertEqual( pool.memoryUsage(), 0 )
+
+		image = l.image()
+		self.assertEqual( image.dataWindow, full.dataWindow )
+		self.assertEqual( image.displayWindow, full.displayWindow )
+		self.assertEqual( image.keys(), [] )
+
+		l.load( image, [ "R", "G" ] )
+		self.assertEqual( sorted( image.keys() ), [ "G", "R" ] )
+		self.failUnless( l.cached( "R" ) )
+		self.failUnless( l.cached( "G" ) )
+		self.failIf( l.cached( "B" ) )
+		self.assertEqual( image["R"].data, full["R"].data )
+		self.assertEqual( image["G"].data, full["G"].data )
+
+		self.assertEqual( l.channel( "B" ), full["B"].data )
+		self.failUnless( l.cached( "B" ) )
+
+	def testSharedThroughObjectPool( self ) :
+
+		pool = IECore.ObjectPool( 1024 * 1024 * 100 )
+		l1 = IECore.ImageChannelLoader( IECore.Reader.create( "test/IECore/data/exrFiles/manyChannels.exr" ), pool )
+		l2 = IECore.ImageChannelLoader( IECore.Reader.create( "test/IECore/data/exrFiles/manyChannels.exr" ), pool )
+
+		l1.channel( "R" )
+		memory = pool.memoryUsage()
+		self.failUnless( memory > 0 )
+		l2.channel( "R" )
+		self.assertEqual( pool.memoryUsage(), memory )
+
+		# different settings shouldn't share entries
+		r = IECore.Reader.create( "test/IECore/data/exrFiles/manyChannels.exr" )
+		r["rawChannels"].setTypedValue( True )
+		l3 = IECore.ImageChannelLoader( r, pool )
+		self.failIf( l3.cached( "R" ) )
+
+	def testColorSpaceConversion( self ) :
+
+		full = IECore.Reader.create( "test/IECore/data/jpg/uvMap.512x256.jpg" ).read()
+		l = IECore.ImageChannelLoader( IECore.Reader.create( "test/IECore/data/jpg/uvMap.512x256.jpg" ), IECore.ObjectPool( 1024 * 1024 * 100 ) )
+		for c in [ "R", "G", "B" ] :
+			self.assertEqual( l.channel( c ), full[c].data )
+
+if __name__ == "__main__":
+	unittest.main()
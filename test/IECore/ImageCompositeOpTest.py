@@ -100,6 +100,42 @@ class ImageCompositeOpTest( unittest.TestCase ) :
 
 		self.__test( ImageCompositeOp.Operation.Multiply, "test/IECore/data/expectedResults/imageCompositeOpMultiply.exr" )
 
+	def testPartialOverlap( self ) :
+
+		displayWindow = Box2i( V2i( 0 ), V2i( 9 ) )
+
+		def image( dataWindow, value, alpha ) :
+			i = ImagePrimitive( dataWindow, displayWindow )
+			n = ( dataWindow.size().x + 1 ) * ( dataWindow.size().y + 1 )
+			i["R"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, FloatVectorData( [ value * alpha ] * n ) )
+			i["A"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, FloatVectorData( [ alpha ] * n ) )
+			return i
+
+		imageA = image( Box2i( V2i( 4, 2 ), V2i( 9, 6 ) ), 1.0, 0.5 )
+		imageB = image( Box2i( V2i( 1, 1 ), V2i( 5, 8 ) ), 0.25, 1.0 )
+
+		result = ImageCompositeOp()(
+			input = imageB,
+			imageA = imageA,
+			channels = StringVectorData( [ "R" ] ),
+			operation = ImageCompositeOp.Operation.Over
+		)
+
+		dataWindow = result.dataWindow
+		self.assertEqual( dataWindow, Box2i( V2i( 1, 1 ), V2i( 9, 8 ) ) )
+
+		r = result["R"].data
+		width = dataWindow.size().x + 1
+		for y in range( dataWindow.min.y, dataWindow.max.y + 1 ) :
+			for x in range( dataWindow.min.x, dataWindow.max.x + 1 ) :
+				inA = imageA.dataWindow.intersects( V2i( x, y ) )
+				inB = imageB.dataWindow.intersects( V2i( x, y ) )
+				a = 0.5 if inA else 0
+				aAlpha = 0.5 if inA else 0
+				b = 0.25 if inB else 0
+				expected = a + b * ( 1 - aAlpha )
+				self.assertAlmostEqual( r[(y-dataWindow.min.y)*width + x - dataWindow.min.x], expected, 6 )
+
 
 if __name__ == "__main__":
     unittest.main()
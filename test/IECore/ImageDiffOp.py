@@ -171,6 +171,30 @@ class TestImageDiffOp(unittest.TestCase):
 
 		self.failIf( res.value )
 
+	def testMixedTypesAndMaxError( self ) :
+
+		w = Box2i( V2i( 0 ), V2i( 511 ) )
+
+		imageA = ImagePrimitive( w, w )
+		imageB = ImagePrimitive( w, w )
+
+		n = 512 * 512
+		imageA["R"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, FloatVectorData( [ 0.5 ] * n ) )
+		imageB["R"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, HalfVectorData( [ 0.5 ] * n ) )
+
+		op = ImageDiffOp()
+		self.failIf( op( imageA = imageA, imageB = imageB, maxError = 0.0001 ).value )
+
+		# an error of 0.25 in every pixel gives an rms error of 0.25
+		imageB["R"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, HalfVectorData( [ 0.75 ] * n ) )
+		self.failUnless( op( imageA = imageA, imageB = imageB, maxError = 0.2 ).value )
+		self.failIf( op( imageA = imageA, imageB = imageB, maxError = 0.3 ).value )
+
+		# mismatched channel sizes are reported as a difference
+		imageB["R"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, HalfVectorData( [ 0.5 ] * ( n - 1 ) ) )
+		with CapturingMessageHandler() as m :
+			self.failUnless( op( imageA = imageA, imageB = imageB ).value )
+
 
 if __name__ == "__main__":
 	unittest.main()
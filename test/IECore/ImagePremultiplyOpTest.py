@@ -60,6 +60,28 @@ class ImagePremultiplyOpTest( unittest.TestCase ) :
 		diff = diffOp( imageA = result, imageB = expectedResult ).value
 		self.failIf( diff )
 
+	def testLargeImage( self ) :
+
+		# big enough to be split into several tiles, each of
+		# which must use the matching section of the alpha channel.
+		window = Box2i( V2i( -10, 5 ), V2i( 289, 204 ) )
+		numPixels = 300 * 200
+
+		img = ImagePrimitive( window, window )
+		r = FloatVectorData()
+		r.resize( numPixels, 1 )
+		img["R"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, r )
+		a = FloatVectorData( [ float( i % 1000 ) / 1000 for i in range( 0, numPixels ) ] )
+		img["A"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, a )
+
+		result = ImagePremultiplyOp()(
+			input = img,
+			channels = StringVectorData( [ "R" ] ),
+			alphaChannelName = "A"
+		)
+
+		self.assertEqual( result["R"].data, a )
+
 
 
 if __name__ == "__main__":
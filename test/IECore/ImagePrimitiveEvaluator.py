@@ -339,6 +339,32 @@ class TestImagePrimitiveEvaluator( unittest.TestCase ) :
 		self.failIf( res.value )
 
 
+	def testChannelsAtUVs( self ) :
+
+		reader = Reader.create( "test/IECore/data/exrFiles/uvMap.512x256.exr" )
+		img = reader.read()
+
+		ipe = PrimitiveEvaluator.create( img )
+		r = ipe.createResult()
+
+		random.seed( 2 )
+		uvs = V2fVectorData( [ V2f( random.uniform( 0.0, 1.0 ), random.uniform( 0.0, 1.0 ) ) for i in range( 0, 5000 ) ] )
+		# exercise the edges and the uvs outside the image
+		uvs.extend( [ V2f( 0 ), V2f( 1 ), V2f( 0, 1 ), V2f( 1, 0 ), V2f( 0.5, 1 ), V2f( -0.1, 0.5 ), V2f( 0.5, 1.1 ) ] )
+
+		values = ipe.channelsAtUVs( uvs, StringVectorData( [ "R", "G" ] ) )
+		self.assertEqual( len( values ), 2 * len( uvs ) )
+
+		for i, uv in enumerate( uvs ) :
+			if ipe.pointAtUV( uv, r ) :
+				self.assertEqual( values[i*2], r.floatPrimVar( ipe.R() ) )
+				self.assertEqual( values[i*2+1], r.floatPrimVar( ipe.G() ) )
+			else :
+				self.assertEqual( values[i*2], 0 )
+				self.assertEqual( values[i*2+1], 0 )
+
+		self.assertRaises( Exception, ipe.channelsAtUVs, uvs, StringVectorData( [ "notAChannel" ] ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
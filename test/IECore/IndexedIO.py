@@ -38,6 +38,7 @@ import os
 import unittest
 import math
 import random
+import struct
 
 from IECore import *
 
@@ -158,6 +159,34 @@ class TestMemoryIndexedIO(unittest.TestCase):
 
 			self.assertEqual( len(entryNames), len(dataPresent) )
 
+	def testBufferIsIndependent( self ) :
+
+		f = MemoryIndexedIO( CharVectorData(), [], IndexedIO.OpenMode.Write )
+		StringData( "test1" ).save( f, "obj1" )
+		buf = f.buffer()
+
+		StringData( "test2" ).save( f, "obj2" )
+		self.failIf( len( f.buffer() ) == len( buf ) )
+
+		f2 = MemoryIndexedIO( buf, [], IndexedIO.OpenMode.Read )
+		self.assertEqual( f2.entryIds(), [ "obj1" ] )
+		self.assertEqual( Object.load( f2, "obj1" ), StringData( "test1" ) )
+
+	def testAppendBuffer( self ) :
+
+		f = MemoryIndexedIO( CharVectorData(), [], IndexedIO.OpenMode.Write )
+		StringData( "test1" ).save( f, "obj1" )
+		buf = f.buffer()
+
+		# an unmodified file opened for append returns the original data
+		f = MemoryIndexedIO( buf, [], IndexedIO.OpenMode.Append )
+		self.assertEqual( f.buffer(), buf )
+
+		StringData( "test2" ).save( f, "obj2" )
+		buf2 = f.buffer()
+		self.assertEqual( set( MemoryIndexedIO( buf, [], IndexedIO.OpenMode.Read ).entryIds() ), set( [ "obj1" ] ) )
+		self.assertEqual( set( MemoryIndexedIO( buf2, [], IndexedIO.OpenMode.Read ).entryIds() ), set( [ "obj1", "obj2" ] ) )
+
 class TestFileIndexedIO(unittest.TestCase):
 
 	badNames = ['*', '!', '&', '^', '@', '#', '$', '(', ')', '<', '+',
@@ -573,6 +602,218 @@ class TestFileIndexedIO(unittest.TestCase):
 		self.failIf(fv is gv)
 		self.assertEqual(fv, gv)
 
+	def testMemoryMapped( self ) :
+		"""Test FileIndexedIO reading in MemoryMapped mode"""
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		g = f.subdirectory( "sub1", IndexedIO.MissingBehaviour.CreateIfMissing )
+
+		fv = FloatVectorData( range( 0, 1000 ) )
+		sv = StringVectorData( [ "a", "bb", "ccc" ] )
+		g.write( "floats", fv )
+		g.write( "strings", sv )
+		g.write( "int", 10 )
+		g.write( "string", "hello" )
+		g.commit()
+		del f, g
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Read | IndexedIO.OpenMode.MemoryMapped )
+		self.assertTrue( f.openMode() & IndexedIO.OpenMode.MemoryMapped )
+
+		g = f.subdirectory( "sub1" )
+		self.assertEqual( g.read( "floats" ), fv )
+		self.assertEqual( g.read( "strings" ), sv )
+		self.assertEqual( g.read( "int" ).value, 10 )
+		self.assertEqual( g.read( "string" ).value, "hello" )
+
+		self.assertRaises( RuntimeError, FileIndexedIO, "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write | IndexedIO.OpenMode.MemoryMapped )
+		self.assertRaises( RuntimeError, FileIndexedIO, "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Append | IndexedIO.OpenMode.MemoryMapped )
+
+	def testCompression( self ) :
+		"""Test FileIndexedIO index compression codecs"""
+
+		self.assertTrue( StreamIndexedIO.compressionAvailable( StreamIndexedIO.Compression.Gzip ) )
+
+		for compression in StreamIndexedIO.Compression.values.values() :
+
+			f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+			if not StreamIndexedIO.compressionAvailable( compression ) :
+				self.assertRaises( RuntimeError, f.setCompression, compression )
+				continue
+
+			f.setCompression( compression )
+			self.assertEqual( f.getCompression(), compression )
+
+			for i in range( 0, 10 ) :
+				g = f.subdirectory( "sub%d" % i, IndexedIO.MissingBehaviour.CreateIfMissing )
+				g.write( "value", i )
+				g.commit()
+			f.write( "root", "abc" )
+			del f, g
+
+			f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Read )
+			self.assertEqual( f.read( "root" ).value, "abc" )
+			for i in range( 0, 10 ) :
+				self.assertEqual( f.subdirectory( "sub%d" % i ).read( "value" ).value, i )
+
+	def testDataCompression( self ) :
+		"""Test FileIndexedIO data compression"""
+
+		floats = FloatVectorData( [ math.sin( i * 0.01 ) for i in range( 0, 10000 ) ] )
+		ints = IntVectorData( range( 0, 10000 ) )
+		strings = StringVectorData( [ "string%d" % ( i % 10 ) for i in range( 0, 1000 ) ] )
+		small = FloatVectorData( [ 1, 2, 3 ] )
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		f.write( "ints", ints )
+		del f
+		uncompressedSize = os.path.getsize( "./test/FileIndexedIO.fio" )
+
+		for compression in StreamIndexedIO.Compression.values.values() :
+
+			if not StreamIndexedIO.compressionAvailable( compression ) :
+				continue
+
+			f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+			f.setDataCompression( True, compression )
+			f.write( "ints", ints )
+			del f
+			self.assertTrue( os.path.getsize( "./test/FileIndexedIO.fio" ) < uncompressedSize )
+
+			for shuffle in ( True, False ) :
+
+				f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+				self.assertFalse( f.getDataCompression() )
+				f.setDataCompression( True, compression, shuffle )
+				self.assertTrue( f.getDataCompression() )
+
+				f.write( "floats", floats )
+				f.write( "ints", ints )
+				f.write( "strings", strings )
+				f.write( "small", small )
+				f.write( "value", 10 )
+				g = f.subdirectory( "sub", IndexedIO.MissingBehaviour.CreateIfMissing )
+				g.write( "floats", floats )
+				g.commit()
+				f.setDataCompression( False )
+				f.write( "uncompressed", floats )
+				del f, g
+
+				for mode in ( IndexedIO.OpenMode.Read, IndexedIO.OpenMode.Read | IndexedIO.OpenMode.MemoryMapped ) :
+					f = FileIndexedIO( "./test/FileIndexedIO.fio", [], mode )
+					self.assertEqual( f.read( "floats" ), floats )
+					self.assertEqual( f.read( "ints" ), ints )
+					self.assertEqual( f.read( "strings" ), strings )
+					self.assertEqual( f.read( "small" ), small )
+					self.assertEqual( f.read( "value" ).value, 10 )
+					self.assertEqual( f.subdirectory( "sub" ).read( "floats" ), floats )
+					self.assertEqual( f.read( "uncompressed" ), floats )
+					del f
+
+	def testFileVersion( self ) :
+		"""Test FileIndexedIO only writes newer file versions when required"""
+
+		fileName = "./test/FileIndexedIO.fio"
+
+		def fileVersion() :
+			with open( fileName, "rb" ) as f :
+				f.seek( -16, os.SEEK_END )
+				return struct.unpack( "<q", f.read( 8 ) )[0]
+
+		f = FileIndexedIO( fileName, [], IndexedIO.OpenMode.Write )
+		f.setCompression( StreamIndexedIO.Compression.Gzip )
+		g = f.subdirectory( "sub", IndexedIO.MissingBehaviour.CreateIfMissing )
+		g.write( "value", 1 )
+		g.commit()
+		del f, g
+		self.assertEqual( fileVersion(), 5 )
+
+		# the existing subindices prevent the use of newer features
+		f = FileIndexedIO( fileName, [], IndexedIO.OpenMode.Append )
+		self.assertRaises( RuntimeError, f.setDataCompression, True )
+		f.write( "appended", 2 )
+		del f
+		self.assertEqual( fileVersion(), 5 )
+
+		f = FileIndexedIO( fileName, [], IndexedIO.OpenMode.Write )
+		f.setCompression( StreamIndexedIO.Compression.Gzip )
+		f.setDataCompression( True )
+		f.write( "value", 1 )
+		del f
+		self.assertEqual( fileVersion(), 8 )
+
+		# files written by newer versions of Cortex can't be read
+		with open( fileName, "r+b" ) as f :
+			f.seek( -16, os.SEEK_END )
+			f.write( struct.pack( "<q", 1000 ) )
+		self.assertRaises( RuntimeError, FileIndexedIO, fileName, [], IndexedIO.OpenMode.Read )
+
+	def testManyEntryNames( self ) :
+		"""Test FileIndexedIO with many unique entry names"""
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		for i in range( 0, 100 ) :
+			g = f.subdirectory( "group%d" % i, IndexedIO.MissingBehaviour.CreateIfMissing )
+			for j in range( 0, 100 ) :
+				g.write( "entry%d_%d" % ( i, j ), i * 100 + j )
+			g.write( "", i )
+		del f, g
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Append )
+		f.write( "appended", "name" )
+		f.write( "entry0_0", 0 )
+		del f
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Read )
+		self.assertEqual( len( f.entryIds() ), 102 )
+		self.assertEqual( f.read( "appended" ).value, "name" )
+		self.assertEqual( f.read( "entry0_0" ).value, 0 )
+		for i in range( 0, 100 ) :
+			g = f.subdirectory( "group%d" % i )
+			self.assertEqual( len( g.entryIds() ), 101 )
+			self.assertEqual( g.read( "" ).value, i )
+			for j in range( 0, 100 ) :
+				self.assertEqual( g.read( "entry%d_%d" % ( i, j ) ).value, i * 100 + j )
+
+	def testLazyIndex( self ) :
+		"""Test FileIndexedIO loading directories on demand"""
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		for i in range( 0, 10 ) :
+			g = f.subdirectory( "group%d" % i, IndexedIO.MissingBehaviour.CreateIfMissing )
+			for j in range( 0, 10 ) :
+				h = g.subdirectory( "child%d" % j, IndexedIO.MissingBehaviour.CreateIfMissing )
+				h.write( "value", i * 10 + j )
+				h.write( "values", IntVectorData( range( 0, j ) ) )
+			if i % 2 :
+				g.commit()
+		f.write( "root", "abc" )
+		del f, g, h
+
+		self.assertRaises( RuntimeError, FileIndexedIO, "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write | IndexedIO.OpenMode.LazyIndex )
+		self.assertRaises( RuntimeError, FileIndexedIO, "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Append | IndexedIO.OpenMode.LazyIndex )
+
+		for mode in ( IndexedIO.OpenMode.Read, IndexedIO.OpenMode.Read | IndexedIO.OpenMode.LazyIndex ) :
+
+			f = FileIndexedIO( "./test/FileIndexedIO.fio", [], mode )
+			initialMemoryUsage = f.indexMemoryUsage()
+			self.assertTrue( initialMemoryUsage > 0 )
+
+			self.assertEqual( f.read( "root" ).value, "abc" )
+			self.assertEqual( len( f.entryIds() ), 11 )
+			for i in range( 0, 10 ) :
+				g = f.subdirectory( "group%d" % i )
+				self.assertEqual( len( g.entryIds() ), 10 )
+				for j in range( 0, 10 ) :
+					h = g.subdirectory( "child%d" % j )
+					self.assertEqual( h.read( "value" ).value, i * 10 + j )
+					self.assertEqual( h.read( "values" ), IntVectorData( range( 0, j ) ) )
+					self.assertEqual( h.parentDirectory().currentEntryId(), "group%d" % i )
+
+			self.assertEqual( f.directory( [ "group3", "child4" ] ).read( "value" ).value, 34 )
+			self.assertTrue( f.indexMemoryUsage() > initialMemoryUsage )
+			del f, g, h
+
 	def setUp( self ):
 
 		if os.path.isfile("./test/FileIndexedIO.fio") :
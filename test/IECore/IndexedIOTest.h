@@ -45,6 +45,7 @@
 
 #include "IECore/IECore.h"
 #include "IECore/IndexedIO.h"
+#include "IECore/MemoryIndexedIO.h"
 
 namespace IECore
 {
@@ -158,6 +159,98 @@ struct IndexedIOTest
 		}
 	}
 
+	void testArrays()
+	{
+		std::vector<float> f( 1000 );
+		std::vector<int> i( 10 );
+		std::vector<unsigned char> c( 3 );
+		for( size_t j = 0; j < f.size(); ++j )
+		{
+			f[j] = j * 0.5f;
+		}
+		for( size_t j = 0; j < i.size(); ++j )
+		{
+			i[j] = -(int)j;
+		}
+		c[0] = 1; c[1] = 2; c[2] = 3;
+
+		IndexedIO::ArrayList arrays;
+		arrays.push_back( IndexedIO::Array( "f", &f[0], f.size() ) );
+		arrays.push_back( IndexedIO::Array( "i", &i[0], i.size() ) );
+		arrays.push_back( IndexedIO::Array( "c", &c[0], c.size() ) );
+		// duplicate data should be shared with the first copy
+		arrays.push_back( IndexedIO::Array( "i2", &i[0], i.size() ) );
+
+		MemoryIndexedIOPtr io = new MemoryIndexedIO( ConstCharVectorDataPtr(), IndexedIO::rootPath, IndexedIO::Write );
+		io->writeArrays( arrays );
+		io->write( "single", &f[0], f.size() );
+
+		BOOST_CHECK_EQUAL( io->entry( "f" ).dataType(), IndexedIO::FloatArray );
+		BOOST_CHECK_EQUAL( io->entry( "f" ).arrayLength(), f.size() );
+		BOOST_CHECK_EQUAL( io->entry( "c" ).dataType(), IndexedIO::UCharArray );
+
+		ConstCharVectorDataPtr buffer = io->buffer();
+		io = new MemoryIndexedIO( buffer, IndexedIO::rootPath, IndexedIO::Read );
+
+		// individual reads of entries written together
+		std::vector<int> i2( i.size() );
+		int *i2Data = &i2[0];
+		io->read( "i2", i2Data, i2.size() );
+		BOOST_CHECK( i2 == i );
+
+		// vectored reads, including of an entry written individually
+		std::vector<float> fr( f.size() ), singler( f.size() );
+		std::vector<int> ir( i.size() );
+		std::vector<unsigned char> cr( c.size() );
+		IndexedIO::ArrayList reads;
+		reads.push_back( IndexedIO::Array( "c", &cr[0], cr.size() ) );
+		reads.push_back( IndexedIO::Array( "single", &singler[0], singler.size() ) );
+		reads.push_back( IndexedIO::Array( "f", &fr[0], fr.size() ) );
+		reads.push_back( IndexedIO::Array( "i", &ir[0], ir.size() ) );
+		io->readArrays( reads );
+
+		BOOST_CHECK( fr == f );
+		BOOST_CHECK( singler == f );
+		BOOST_CHECK( ir == i );
+		BOOST_CHECK( cr == c );
+
+		// missing entries and mismatched sizes should throw
+		reads.push_back( IndexedIO::Array( "missing", &ir[0], ir.size() ) );
+		BOOST_CHECK_THROW( io->readArrays( reads ), IOException );
+		reads.back() = IndexedIO::Array( "i", &ir[0], ir.size() - 1 );
+		BOOST_CHECK_THROW( io->readArrays( reads ), IOException );
+	}
+
+	void testCompressedSizeMismatch()
+	{
+		std::vector<float> f( 1000, 1.0f );
+		std::vector<std::string> s( 100, std::string( 100, 'a' ) );
+
+		MemoryIndexedIOPtr io = new MemoryIndexedIO( ConstCharVectorDataPtr(), IndexedIO::rootPath, IndexedIO::Write );
+		io->setDataCompression( true, StreamIndexedIO::Gzip, true, 0 );
+		io->write( "f", &f[0], f.size() );
+		io->write( "s", &s[0], s.size() );
+
+		ConstCharVectorDataPtr buffer = io->buffer();
+		io = new MemoryIndexedIO( buffer, IndexedIO::rootPath, IndexedIO::Read );
+		BOOST_CHECK( io->entry( "f" ).arrayLength() == f.size() );
+
+		std::vector<std::string> sr( s.size() );
+		std::string *srData = &sr[0];
+		io->read( "s", srData, sr.size() );
+		BOOST_CHECK( sr == s );
+
+		// lengths which don't match the decompressed data must throw
+		// rather than unflattening beyond the end of it.
+		std::vector<float> fr( f.size() + 1 );
+		float *frData = &fr[0];
+		BOOST_CHECK_THROW( io->read( "f", frData, fr.size() ), IOException );
+
+		std::vector<std::string> sr2( s.size() + 1 );
+		std::string *sr2Data = &sr2[0];
+		BOOST_CHECK_THROW( io->read( "s", sr2Data, sr2.size() ), IOException );
+	}
+
 	template<typename D>
 	void write( IndexedIOPtr io)
 	{
@@ -248,6 +341,8 @@ struct IndexedIOTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &IndexedIOTest<T>::template testArray<char>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &IndexedIOTest<T>::template testArray<unsigned char>, instance ) );
 
+		add( BOOST_CLASS_TEST_CASE( &IndexedIOTest<T>::testArrays, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &IndexedIOTest<T>::testCompressedSizeMismatch, instance ) );
 
 	}
 
@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+#include "boost/format.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/FileIndexedIO.h"
+
+#include "IndexedIOThreadingTest.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+
+namespace IECore
+{
+
+static const size_t numEntries = 2000;
+static const size_t entryLength = 4096;
+
+struct IndexedIOThreadingTest
+{
+
+	IndexedIOThreadingTest() : m_fileName( "test/IECore/indexedIOThreadingTest.fio" )
+	{
+		IndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Write );
+		std::vector<float> data( entryLength );
+		for ( size_t i = 0; i < numEntries; ++i )
+		{
+			std::fill( data.begin(), data.end(), float( i ) );
+			io->write( entryName( i ), &data[0], entryLength );
+		}
+	}
+
+	~IndexedIOThreadingTest()
+	{
+		remove( m_fileName.c_str() );
+	}
+
+	static IndexedIO::EntryID entryName( size_t i )
+	{
+		return ( boost::format( "entry%d" ) % i ).str();
+	}
+
+	struct ReadEntries
+	{
+		public :
+
+			ReadEntries( ConstIndexedIOPtr io ) : m_io( io ), m_errors( 0 )
+			{
+			}
+
+			ReadEntries( ReadEntries &that, tbb::split ) : m_io( that.m_io ), m_errors( 0 )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				std::vector<float> data( entryLength );
+				for ( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					float *p = &data[0];
+					m_io->read( entryName( i ), p, entryLength );
+					if ( data.front() != float( i ) || data.back() != float( i ) )
+					{
+						m_errors++;
+					}
+				}
+			}
+
+			void join( const ReadEntries &that )
+			{
+				m_errors += that.m_errors;
+			}
+
+			size_t errors() const
+			{
+				return m_errors;
+			}
+
+		private :
+
+			ConstIndexedIOPtr m_io;
+			mutable size_t m_errors;
+
+	};
+
+	// Reads all the entries with varying numbers of threads,
+	// checking that every read returns the expected data.
+	void testRead( IndexedIO::OpenMode mode )
+	{
+		const int maxThreads = std::max( 8, task_scheduler_init::default_num_threads() );
+		for ( int numThreads = 1; numThreads <= maxThreads; numThreads *= 2 )
+		{
+			task_scheduler_init scheduler( numThreads );
+
+			ConstIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, mode );
+
+			ReadEntries task( io );
+			for ( int i = 0; i < 10; ++i )
+			{
+				parallel_reduce( blocked_range<size_t>( 0, numEntries ), task );
+			}
+
+			BOOST_CHECK( task.errors() == 0 );
+		}
+	}
+
+	void testStreamRead()
+	{
+		testRead( IndexedIO::Read );
+	}
+
+	void testMemoryMappedRead()
+	{
+		testRead( IndexedIO::Read | IndexedIO::MemoryMapped );
+	}
+
+	std::string m_fileName;
+
+};
+
+struct IndexedIOThreadingTestSuite : public boost::unit_test::test_suite
+{
+
+	IndexedIOThreadingTestSuite() : boost::unit_test::test_suite( "IndexedIOThreadingTestSuite" )
+	{
+		boost::shared_ptr<IndexedIOThreadingTest> instance( new IndexedIOThreadingTest() );
+
+		add( BOOST_CLASS_TEST_CASE( &IndexedIOThreadingTest::testStreamRead, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &IndexedIOThreadingTest::testMemoryMappedRead, instance ) );
+	}
+};
+
+void addIndexedIOThreadingTest(boost::unit_test::test_suite* test)
+{
+	test->add( new IndexedIOThreadingTestSuite( ) );
+}
+
+} // namespace IECore
@@ -95,6 +95,50 @@ struct InternedStringTest
 
 	};
 
+	struct BatchConstructor
+	{
+		public :
+
+			BatchConstructor()
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				std::vector<std::string> strings;
+				for( size_t i=r.begin(); i!=r.end(); ++i )
+				{
+					strings.push_back( "batch" + lexical_cast<std::string>( i % 5000 ) );
+				}
+
+				std::vector<InternedString> interned;
+				InternedString::intern( strings, interned );
+				for( size_t i = 0; i < strings.size(); ++i )
+				{
+					// can't use boost unit test assertions from threads
+					assert( interned[i].string() == strings[i] );
+					assert( interned[i] == InternedString( strings[i] ) );
+				}
+			}
+
+	};
+
+	void testBatchConstruction()
+	{
+		const size_t numUniqueStrings = InternedString::numUniqueStrings();
+		parallel_for( blocked_range<size_t>( 0, 100000, 1000 ), BatchConstructor() );
+		BOOST_CHECK( InternedString::numUniqueStrings() <= numUniqueStrings + 5000 );
+
+		const char *values[] = { "a", "bc", "bcd", "a" };
+		const size_t lengths[] = { 1, 2, 2, 1 };
+		InternedString result[4];
+		InternedString::intern( 4, values, lengths, result );
+		BOOST_CHECK_EQUAL( result[0], InternedString( "a" ) );
+		BOOST_CHECK_EQUAL( result[1], InternedString( "bc" ) );
+		BOOST_CHECK_EQUAL( result[2], InternedString( "bc" ) );
+		BOOST_CHECK_EQUAL( result[3], InternedString( "a" ) );
+	}
+
 };
 
 
@@ -107,6 +151,7 @@ struct InternedStringTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testConcurrentConstruction, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testRangeConstruction, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testBatchConstruction, instance ) );
 
 	}
 };
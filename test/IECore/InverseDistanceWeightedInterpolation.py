@@ -146,6 +146,27 @@ class TestInverseDistanceWeightedInterpolation(unittest.TestCase):
 		)
 
 		self.failIf( res.value )
-		
+
+	def testVectorQueriesMatchSingleQueries( self ) :
+
+		random.seed( 2 )
+
+		p = V3fVectorData()
+		v = V3fVectorData()
+		for i in range( 0, 1000 ) :
+			p.append( V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) ) )
+			v.append( V3f( random.uniform( 0, 1 ), random.uniform( 0, 1 ), random.uniform( 0, 1 ) ) )
+
+		idw = InverseDistanceWeightedInterpolationV3fV3f( p, v, 8 )
+
+		queryPoints = V3fVectorData()
+		for i in range( 0, 5000 ) :
+			queryPoints.append( V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) ) )
+
+		r = idw( queryPoints )
+		self.assertEqual( len( r ), len( queryPoints ) )
+		for i in range( 0, len( queryPoints ) ) :
+			self.failUnless( r[i].equalWithAbsError( idw( queryPoints[i] ), 1e-5 ) )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -215,6 +215,23 @@ class TestJPEGReader(unittest.TestCase):
 
 			self.assert_( ( color - expectedColor).length() < 1.e-3 )
 
+	def testReduction( self ):
+
+		r = JPEGImageReader( "test/IECore/data/jpg/uvMap.512x256.jpg" )
+		full = r.read()
+
+		r["reduction"].setNumericValue( 4 )
+		self.assertEqual( r.dataWindow(), Box2i( V2i( 0, 0 ), V2i( 127, 63 ) ) )
+		self.assertEqual( r.displayWindow(), Box2i( V2i( 0, 0 ), V2i( 127, 63 ) ) )
+
+		img = r.read()
+		self.assertEqual( img.dataWindow, Box2i( V2i( 0, 0 ), V2i( 127, 63 ) ) )
+		self.assert_( img.arePrimitiveVariablesValid() )
+		self.assertEqual( len( img["R"].data ), 128 * 64 )
+
+		r["reduction"].setNumericValue( 1 )
+		self.assertEqual( r.read(), full )
+
 	def testErrors( self ):
 
 		r = JPEGImageReader()
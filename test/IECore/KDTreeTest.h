@@ -60,6 +60,7 @@ class KDTreeTest
 		void testNearestNeighour();
 		void testNearestNeighours();
 		void testNearestNNeighours();
+		void testBatchedNearestNNeighbours();
 
 	private:
 
@@ -99,6 +100,7 @@ struct KDTreeTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNeighour, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNeighours, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNNeighours, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testBatchedNearestNNeighbours, instance ) );
 	}
 };
 
@@ -192,4 +192,54 @@ void KDTreeTest<T>::testNearestNNeighours()
 
 }
 
+template<typename T>
+void KDTreeTest<T>::testBatchedNearestNNeighbours()
+{
+	const unsigned int neighboursRequested = 5;
+
+	NeighbourVector batchedNeighbours;
+	m_tree->nearestNNeighbours( m_points.begin(), m_points.end(), neighboursRequested, batchedNeighbours );
+	BOOST_CHECK( batchedNeighbours.size() == m_points.size() * neighboursRequested );
+
+	NeighbourVector nearNeighbours;
+	for( size_t i = 0; i < m_points.size(); ++i )
+	{
+		unsigned int numNeighbours = m_tree->nearestNNeighbours( m_points[i], neighboursRequested, nearNeighbours );
+		for( unsigned int j = 0; j < neighboursRequested; ++j )
+		{
+			const typename Tree::Neighbour &n = batchedNeighbours[i * neighboursRequested + j];
+			if( j < numNeighbours )
+			{
+				BOOST_CHECK( n.point == nearNeighbours[j].point );
+				BOOST_CHECK( n.distSquared == nearNeighbours[j].distSquared );
+			}
+			else
+			{
+				// fewer points in the tree than were requested
+				BOOST_CHECK( n.point == m_points.end() );
+			}
+		}
+	}
+
+	// Check that a tree large enough to be built in parallel
+	// gives the correct results.
+	PointVector points( 20000 );
+	for( size_t i = 0; i < points.size(); ++i )
+	{
+		for( unsigned int j = 0; j < VectorTraits<T>::dimensions(); ++j )
+		{
+			points[i][j] = m_randGen.nextf();
+		}
+	}
+
+	Tree tree( points.begin(), points.end() );
+	tree.nearestNNeighbours( points.begin(), points.end(), 1, batchedNeighbours );
+	for( size_t i = 0; i < points.size(); ++i )
+	{
+		// The nearest neighbour to me should be myself!
+		BOOST_CHECK( batchedNeighbours[i].point == points.begin() + i );
+		BOOST_CHECK( tree.nearestNeighbour( points[i] ) == points.begin() + i );
+	}
+}
+
 }
@@ -278,6 +278,50 @@ class LRUCacheTest( unittest.TestCase ) :
 		
 		# clearing all the time while doing concurrent lookups
 		IECore.testLRUCacheThreading( 100000, 1000, 90, 20 )
-		
+	
+	def testCPPShardedThreading( self ) :
+	
+		IECore.testShardedLRUCacheThreading( 100000, 100, 100 )
+		IECore.testShardedLRUCacheThreading( 100000, 100, 90 )
+		IECore.testShardedLRUCacheThreading( 100000, 1000, 2 )
+		IECore.testShardedLRUCacheThreading( 100000, 1000, 90, 20 )
+
+	def testStatistics( self ) :
+
+		def getter( key ) :
+
+			time.sleep( 0.01 )
+			return ( key, 1 )
+
+		c = IECore.LRUCache( getter, 2 )
+
+		s = c.statistics()
+		self.assertEqual( s.hits, 0 )
+		self.assertEqual( s.misses, 0 )
+		self.assertEqual( s.evictions, 0 )
+		self.assertEqual( s.getterTime, 0 )
+
+		c.get( 1 )
+		c.get( 1 )
+		c.get( 2 )
+		c.get( 3 )
+
+		s = c.statistics()
+		self.assertEqual( s.hits, 1 )
+		self.assertEqual( s.misses, 3 )
+		self.assertEqual( s.evictions, 1 )
+		self.assertTrue( s.getterTime > 0.02 )
+
+		# explicit removals aren't evictions
+		c.clear()
+		self.assertEqual( c.statistics().evictions, 1 )
+
+		c.resetStatistics()
+		s = c.statistics()
+		self.assertEqual( s.hits, 0 )
+		self.assertEqual( s.misses, 0 )
+		self.assertEqual( s.evictions, 0 )
+		self.assertEqual( s.getterTime, 0 )
+
 if __name__ == "__main__":
     unittest.main()
@@ -51,11 +51,12 @@ namespace IECore
 struct LRUCacheThreadingTest
 {
 		
+	template<typename Cache>
 	struct GetFromCache
 	{
 		public :
 		
-			GetFromCache( LRUCache<int, IntDataPtr> &cache )
+			GetFromCache( Cache &cache )
 				:	m_cache( cache )
 			{
 			}
@@ -72,7 +73,7 @@ struct LRUCacheThreadingTest
 			
 		private :
 		
-			LRUCache<int, IntDataPtr> &m_cache;
+			Cache &m_cache;
 			
 	};
 
@@ -84,12 +85,96 @@ struct LRUCacheThreadingTest
 
 	void test()
 	{
-		LRUCache<int, IntDataPtr> cache( get, 1000 );
+		typedef LRUCache<int, IntDataPtr> Cache;
+		Cache cache( get, 1000 );
 		
-		parallel_for( blocked_range<size_t>( 0, 10000 ), GetFromCache( cache ) );
+		parallel_for( blocked_range<size_t>( 0, 10000 ), GetFromCache<Cache>( cache ) );
+		BOOST_CHECK( cache.currentCost() <= cache.getMaxCost() );
+	}
+	
+	void testSharded()
+	{
+		typedef LRUCache<int, IntDataPtr, LRUCachePolicy::Sharded> Cache;
+		Cache cache( get, 1000 );
+		
+		parallel_for( blocked_range<size_t>( 0, 10000 ), GetFromCache<Cache>( cache ) );
+		BOOST_CHECK( cache.currentCost() <= cache.getMaxCost() );
+		
+		cache.clear();
+		BOOST_CHECK_EQUAL( cache.currentCost(), 0u );
+	}
+	
+	void testShardedSecondChance()
+	{
+		typedef LRUCache<int, IntDataPtr, LRUCachePolicy::Sharded> Cache;
+		Cache cache( get, 100 );
+		
+		for( int i = 0; i < 10; ++i )
+		{
+			cache.get( i );
+		}
+		BOOST_CHECK_EQUAL( cache.currentCost(), 100u );
+		
+		// referencing the oldest item should save it from
+		// being the first to be removed.
+		cache.get( 0 );
+		cache.get( 10 );
+		
+		BOOST_CHECK_EQUAL( cache.currentCost(), 100u );
+		BOOST_CHECK( cache.cached( 0 ) );
+		BOOST_CHECK( !cache.cached( 1 ) );
+		BOOST_CHECK( cache.cached( 10 ) );
+	}
+
+	static tbb::atomic<int> slowGetCount;
+
+	static IntDataPtr slowGet( int key, size_t &cost )
+	{
+		slowGetCount++;
+		this_tbb_thread::sleep( tick_count::interval_t( 0.01 ) );
+		cost = 1;
+		return new IntData( key );
+	}
+
+	template<typename Cache>
+	struct GetFewKeysFromCache
+	{
+		public :
+
+			GetFewKeysFromCache( Cache &cache )
+				:	m_cache( cache )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				for( size_t i=r.begin(); i!=r.end(); ++i )
+				{
+					IntDataPtr k = m_cache.get( i % 4 );
+					assert( k->readable() == (int)( i % 4 ) );
+				}
+			}
+
+		private :
+
+			Cache &m_cache;
+
+	};
+
+	void testConcurrentGetsComputeOnce()
+	{
+		typedef LRUCache<int, IntDataPtr, LRUCachePolicy::Sharded> Cache;
+		Cache cache( slowGet, 100 );
+
+		slowGetCount = 0;
+		parallel_for( blocked_range<size_t>( 0, 1000, 1 ), GetFewKeysFromCache<Cache>( cache ) );
+		BOOST_CHECK_EQUAL( (int)slowGetCount, 4 );
+		BOOST_CHECK_EQUAL( cache.currentCost(), 4u );
 	}
 };
 
+tbb::atomic<int> LRUCacheThreadingTest::slowGetCount;
+
 
 struct LRUCacheThreadingTestSuite : public boost::unit_test::test_suite
 {
@@ -99,6 +184,9 @@ struct LRUCacheThreadingTestSuite : public boost::unit_test::test_suite
 		boost::shared_ptr<LRUCacheThreadingTest> instance( new LRUCacheThreadingTest() );
 
 		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::test, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::testSharded, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::testShardedSecondChance, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::testConcurrentGetsComputeOnce, instance ) );
 	}
 };
 
@@ -67,3 +67,62 @@ class LensDistortOpTest(unittest.TestCase):
 
 		self.assertEqual( img.displayWindow, img2.displayWindow )
 		
+	def __lensModel( self ) :
+
+		o = CompoundObject()
+		o["lensModel"] = StringData( "StandardRadialLensModel" )
+		o["distortion"] = DoubleData( 0.2 )
+		o["anamorphicSqueeze"] = DoubleData( 1. )
+		o["curvatureX"] = DoubleData( 0.2 )
+		o["curvatureY"] = DoubleData( 0.5 )
+		o["quarticDistortion"] = DoubleData( .1 )
+		return o
+
+	def testRepeatedOperation( self ) :
+
+		# the second operation reuses the cached warp map,
+		# and must give identical results.
+		img = EXRImageReader( "test/IECore/data/exrFiles/uvMapWithDataWindow.100x100.exr" ).read()
+
+		op = LensDistortOp()
+		op["input"] = img
+		op["mode"] = LensModel.Undistort
+		op["lensModel"].setValue( self.__lensModel() )
+
+		out1 = op()
+		out2 = op()
+		self.assertEqual( out1, out2 )
+
+		# changing the mode or the lens must not
+		# pick up the cached map.
+		op["mode"] = LensModel.Distort
+		out3 = op()
+		self.assertNotEqual( out1.dataWindow, out3.dataWindow )
+
+		o = self.__lensModel()
+		o["distortion"] = DoubleData( 0.1 )
+		op["mode"] = LensModel.Undistort
+		op["lensModel"].setValue( o )
+		out4 = op()
+		self.assertNotEqual( out1, out4 )
+
+	def testBicubicFilter( self ) :
+
+		img = EXRImageReader( "test/IECore/data/exrFiles/uvMapWithDataWindow.100x100.exr" ).read()
+
+		op = LensDistortOp()
+		op["input"] = img
+		op["mode"] = LensModel.Undistort
+		op["lensModel"].setValue( self.__lensModel() )
+
+		op["filter"].setNumericValue( int( WarpOp.FilterType.Bilinear ) )
+		bilinear = op()
+		op["filter"].setNumericValue( int( WarpOp.FilterType.Bicubic ) )
+		bicubic = op()
+
+		self.assertEqual( bicubic.dataWindow, bilinear.dataWindow )
+		self.assertTrue( bicubic.arePrimitiveVariablesValid() )
+		self.assertNotEqual( bicubic, bilinear )
+
+if __name__ == "__main__":
+	unittest.main()
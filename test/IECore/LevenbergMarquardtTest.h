@@ -75,6 +75,9 @@ class LevenbergMarquardtTestPolynomialFit
 
 		template<int N>
 		void test();
+
+		template<int N>
+		void testParallel();
 };
 
 template<typename T>
@@ -100,6 +103,7 @@ struct LevenbergMarquardtTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &LevenbergMarquardtTestPolynomialFit<T>::template test<2>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &LevenbergMarquardtTestPolynomialFit<T>::template test<3>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &LevenbergMarquardtTestPolynomialFit<T>::template test<4>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &LevenbergMarquardtTestPolynomialFit<T>::template testParallel<4>, instance ) );
 	}
 };
 
@@ -216,4 +216,36 @@ void LevenbergMarquardtTestPolynomialFit<T>::test()
 	}
 }
 
+template<typename T>
+template<int N>
+void LevenbergMarquardtTestPolynomialFit<T>::testParallel()
+{
+	Imath::Rand32 r( 23 );
+
+	const unsigned numTests = 20;
+	const int numSamples = N * 50;
+
+	for ( unsigned j = 0; j < numTests; j ++ )
+	{
+		Fn<N> fn( numSamples, r );
+
+		typename TypedData< std::vector<T> >::Ptr params = new TypedData< std::vector<T> >();
+		params->writable().resize( N, 1.0 );
+		typename TypedData< std::vector<T> >::Ptr parallelParams = params->copy();
+
+		IECore::LevenbergMarquardt< T, Fn<N> > lm;
+		typename IECore::LevenbergMarquardt< T, Fn<N> >::Status status = lm.solve( params, fn );
+		typename IECore::LevenbergMarquardt< T, Fn<N> >::Status parallelStatus = lm.solveParallel( parallelParams, fn );
+
+		/// The parallel solver performs exactly the same computations
+		BOOST_CHECK_EQUAL( status, parallelStatus );
+		for ( unsigned i = 0; i < N; i ++ )
+		{
+			BOOST_CHECK_EQUAL( params->readable()[i], parallelParams->readable()[i] );
+		}
+
+		fn.check( parallelParams );
+	}
+}
+
 }
@@ -692,6 +692,53 @@ class LinkedSceneTest( unittest.TestCase ) :
 		i2 = l.child( "instance2" )
 		self.assertEqual( i2.childNames(), [] )
 
+	def testLinkCache( self ) :
+
+		import shutil
+		shutil.copyfile( "test/IECore/data/sccFiles/animatedSpheres.scc", "/tmp/toBeRemoved.scc" )
+
+		m = IECore.SceneCache( "/tmp/toBeRemoved.scc", IECore.IndexedIO.OpenMode.Read )
+		l = IECore.LinkedScene( "/tmp/test.lscc", IECore.IndexedIO.OpenMode.Write )
+		l.createChild( "instance0" ).writeLink( m )
+		l.createChild( "instance1" ).writeLink( m )
+		del l, m
+
+		l = IECore.LinkedScene( "/tmp/test.lscc", IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( sorted( l.child( "instance0" ).childNames() ), [ "A", "B" ] )
+
+		# the second link to the same file and root is a cache hit, so
+		# it doesn't need the file any more.
+		os.remove( "/tmp/toBeRemoved.scc" )
+		IECore.SharedSceneInterfaces.clear()
+		self.assertEqual( sorted( l.child( "instance1" ).childNames() ), [ "A", "B" ] )
+
+	def testFailedLinkIsRetried( self ) :
+
+		import shutil
+		shutil.copyfile( "test/IECore/data/sccFiles/animatedSpheres.scc", "/tmp/toBeRemoved.scc" )
+
+		m = IECore.SceneCache( "/tmp/toBeRemoved.scc", IECore.IndexedIO.OpenMode.Read )
+		l = IECore.LinkedScene( "/tmp/test.lscc", IECore.IndexedIO.OpenMode.Write )
+		l.createChild( "instance" ).writeLink( m )
+		del l, m
+
+		os.remove( "/tmp/toBeRemoved.scc" )
+		IECore.SharedSceneInterfaces.clear()
+
+		l = IECore.LinkedScene( "/tmp/test.lscc", IECore.IndexedIO.OpenMode.Read )
+		messageHandler = IECore.CapturingMessageHandler()
+		with messageHandler :
+			self.assertEqual( l.child( "instance" ).childNames(), [] )
+		self.assertTrue( len( messageHandler.messages ) > 0 )
+		self.assertEqual( messageHandler.messages[0].level, IECore.Msg.Level.Error )
+
+		# the failure isn't cached, so the link is expanded
+		# once the file is available again.
+		shutil.copyfile( "test/IECore/data/sccFiles/animatedSpheres.scc", "/tmp/toBeRemoved.scc" )
+		self.assertEqual( sorted( l.child( "instance" ).childNames() ), [ "A", "B" ] )
+
+		os.remove( "/tmp/toBeRemoved.scc" )
+
 	def testLinkBoundTransformMismatch( self ) :
 		
 		scene = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
@@ -904,6 +951,42 @@ class LinkedSceneTest( unittest.TestCase ) :
 		checkHash( IECore.SceneInterface.HashType.HierarchyHash, l )
 	
 	
+	def testBatchReads( self ) :
+
+		m = IECore.LinkedScene( "test/IECore/data/sccFiles/environment.lscc", IECore.IndexedIO.OpenMode.Read )
+		
+		def collectPaths( scene, paths ) :
+			paths.append( scene.path() )
+			for childName in scene.childNames() :
+				collectPaths( scene.child( childName ), paths )
+
+		paths = []
+		collectPaths( m, paths )
+		
+		for time in ( 0.0, 0.5, 1.0 ) :
+		
+			bounds = m.readBounds( paths, time )
+			transforms = m.readTransformsAsMatrices( paths, time )
+			objects = m.readObjects( paths, time )
+			
+			self.assertEqual( len( bounds ), len( paths ) )
+			self.assertEqual( len( transforms ), len( paths ) )
+			self.assertEqual( len( objects ), len( paths ) )
+			
+			for i, path in enumerate( paths ) :
+				s = m.scene( path )
+				self.assertEqual( bounds[i], s.readBound( time ) )
+				self.assertEqual( transforms[i], s.readTransformAsMatrix( time ) )
+				if s.hasObject() :
+					self.assertEqual( objects[i], s.readObject( time ) )
+				else :
+					self.assertEqual( objects[i], None )
+		
+		# string paths are accepted too
+		self.assertEqual( m.readBounds( [ "/" ], 0.0 ), [ m.readBound( 0.0 ) ] )
+		
+		self.assertRaises( RuntimeError, m.readBounds, [ [ "nonexistent" ] ], 0.0 )
+
 	def testReadExtraChildrenAtLink( self ) :
 		
 		# create a base scene
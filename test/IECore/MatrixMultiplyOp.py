@@ -118,5 +118,55 @@ class TestMultiplyMatrixOp( unittest.TestCase ) :
 		for i in range( v.size() ) :
 			self.assertEqual( vt[i], v[i] )
 
+	def testAffineAndProjectivePoints( self ) :
+
+		r = Rand32()
+		v = V3fVectorData( [ r.nextV3f() * 10 for i in range( 0, 1000 ) ], GeometricData.Interpretation.Point )
+
+		affine = M44f.createTranslated( V3f( 1, 2, 3 ) ) * M44f.createRotated( V3f( 0.1, 0.2, 0.3 ) ) * M44f.createScaled( V3f( 2, 3, 4 ) )
+		projective = M44f( affine )
+		projective[(0,3)] = 0.1
+		projective[(3,3)] = 2
+
+		o = MatrixMultiplyOp()
+		for m in ( affine, projective ) :
+			vt = o( object = v.copy(), matrix = M44fData( m ) )
+			for i in range( v.size() ) :
+				self.assertTrue( vt[i].equalWithAbsError( v[i] * m, 1e-4 ) )
+
+	def testLargeArrays( self ) :
+
+		r = Rand32()
+		v = V3fVectorData( [ r.nextV3f() * 10 for i in range( 0, 50000 ) ] )
+
+		m = M44f.createTranslated( V3f( 1, 2, 3 ) ) * M44f.createRotated( V3f( 0.1, 0.2, 0.3 ) ) * M44f.createScaled( V3f( 2, 3, 4 ) )
+		n = m.inverse()
+		n.transpose()
+
+		o = MatrixMultiplyOp()
+
+		v.setInterpretation( GeometricData.Interpretation.Point )
+		vt = o( object = v.copy(), matrix = M44fData( m ) )
+		for i in range( 0, v.size(), 101 ) :
+			self.assertTrue( vt[i].equalWithAbsError( v[i] * m, 1e-4 ) )
+
+		v.setInterpretation( GeometricData.Interpretation.Vector )
+		vt = o( object = v.copy(), matrix = M44fData( m ) )
+		for i in range( 0, v.size(), 101 ) :
+			self.assertTrue( vt[i].equalWithAbsError( m.multDirMatrix( v[i] ), 1e-4 ) )
+
+		v.setInterpretation( GeometricData.Interpretation.Normal )
+		vt = o( object = v.copy(), matrix = M44fData( m ) )
+		for i in range( 0, v.size(), 101 ) :
+			self.assertTrue( vt[i].equalWithAbsError( n.multDirMatrix( v[i] ), 1e-4 ) )
+
+	def testMatrix33Normals( self ) :
+
+		v = V3fVectorData( [ V3f( 1, 0, 0 ), V3f( 0, 1, 0 ), V3f( 0, 0, 1 ) ], GeometricData.Interpretation.Normal )
+		m = M33f( 2, 0, 0, 0, 4, 0, 0, 0, 8 )
+
+		vt = MatrixMultiplyOp()( object = v, matrix = M33fData( m ) )
+		self.assertEqual( vt, V3fVectorData( [ V3f( 0.5, 0, 0 ), V3f( 0, 0.25, 0 ), V3f( 0, 0, 0.125 ) ], GeometricData.Interpretation.Normal ) )
+
 if __name__ == "__main__":
         unittest.main()
@@ -69,6 +69,29 @@ class MedianCutSamplerTest( unittest.TestCase ) :
 
 		self.assertEqual( areaSum, luminanceImage.variableSize( IECore.PrimitiveVariable.Interpolation.Vertex ) )
 
+	def testCachedResults( self ) :
+
+		image = IECore.Reader.create( "test/IECore/data/exrFiles/carPark.exr" ).read()
+		for n in ["R", "G", "B"] :
+			p = image[n]
+			p.data = IECore.DataCastOp()( object=image[n].data, targetType=IECore.FloatVectorData.staticTypeId() )
+			image[n] = p
+
+		luminanceImage = IECore.LuminanceOp()( input=image )
+
+		s1 = IECore.MedianCutSampler()( image=luminanceImage, subdivisionDepth=5, projection=IECore.MedianCutSampler.Projection.LatLong )
+		centroids = s1["centroids"].copy()
+		s1["centroids"].append( IECore.V2f( 0 ) )
+
+		# modifying a result mustn't affect the results cached for later calls
+		s2 = IECore.MedianCutSampler()( image=luminanceImage, subdivisionDepth=5, projection=IECore.MedianCutSampler.Projection.LatLong )
+		self.assertEqual( len( s2["centroids"] ), 32 )
+		self.assertEqual( s2["centroids"], centroids )
+		self.assertEqual( s2["areas"], s1["areas"] )
+
+		s3 = IECore.MedianCutSampler()( image=luminanceImage, subdivisionDepth=5, projection=IECore.MedianCutSampler.Projection.Rectilinear )
+		self.assertNotEqual( s3["areas"], s2["areas"] )
+
 
 if __name__ == "__main__":
 	unittest.main()
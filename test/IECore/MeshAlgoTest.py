@@ -32,6 +32,8 @@
 #
 ##########################################################################
 
+from __future__ import with_statement
+
 import unittest
 from IECore import *
 
@@ -321,6 +323,21 @@ class MeshAlgoPrimitiveVariableTest( unittest.TestCase ) :
 		self.assertEqual( p.interpolation, PrimitiveVariable.Interpolation.Varying )
 		self.assertEqual( p.data, FloatVectorData( [ 0, 2.5, 5, 5.5, 7.5, 9.5, 11, 12.5, 14 ] ) )
 
+	def testMeshIndexedVertexToFaceVarying( self ) :
+		values = FloatVectorData( [ 1, 2 ] )
+		p = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, values, IntVectorData( [ 0, 1, 0, 1, 0, 1, 0, 1, 0 ] ) )
+		MeshAlgo.resamplePrimitiveVariable( self.mesh, p,  PrimitiveVariable.Interpolation.FaceVarying )
+		self.assertEqual( p.interpolation, PrimitiveVariable.Interpolation.FaceVarying )
+		self.failUnless( p.data.isSame( values ) )
+		self.assertEqual( p.indices, IntVectorData( [ x % 2 for x in self.mesh.vertexIds ] ) )
+
+	def testMeshIndexedVertexToUniform( self ) :
+		p = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, FloatVectorData( range( 0, 9 ) ), IntVectorData( range( 0, 9 ) ) )
+		MeshAlgo.resamplePrimitiveVariable( self.mesh, p,  PrimitiveVariable.Interpolation.Uniform )
+		self.assertEqual( p.interpolation, PrimitiveVariable.Interpolation.Uniform )
+		self.assertEqual( p.indices, None )
+		self.assertEqual( p.data, FloatVectorData( [ 2, 3, 5, 6 ] ) )
+
 
 class MeshAlgoDeleteFacesTest( unittest.TestCase ) :
 
@@ -423,5 +440,196 @@ class MeshAlgoDeleteFacesTest( unittest.TestCase ) :
 
 		self.assertEqual( facesDeletedMesh["P"].data, V3fVectorData( [V3f( 0, 0, 0 ), V3f( 1, 1, 0 ), V3f( 0, 1, 0 )] ) )
 		self.assertEqual( facesDeletedMesh["delete"].data, FloatVectorData( [0.0] ) )
+class MeshAlgoTopologyTest( unittest.TestCase ) :
+
+	def testPlane( self ) :
+
+		# 3---4---5
+		# |   |   |
+		# 0---1---2
+		mesh = MeshPrimitive.createPlane( Box2f( V2f( 0 ), V2f( 2, 1 ) ), V2i( 2, 1 ) )
+		t = MeshAlgo.topology( mesh )
+
+		self.assertEqual( t["faceOffsets"], IntVectorData( [ 0, 4 ] ) )
+
+		vertexFaceOffsets = t["vertexFaceOffsets"]
+		vertexFaces = t["vertexFaces"]
+		self.assertEqual( len( vertexFaceOffsets ), 7 )
+		for v, faces in enumerate( [ [ 0 ], [ 0, 1 ], [ 1 ], [ 0 ], [ 0, 1 ], [ 1 ] ] ) :
+			self.assertEqual( list( vertexFaces[vertexFaceOffsets[v]:vertexFaceOffsets[v+1]] ), faces )
+
+		edges = t["edges"]
+		edgeFaceOffsets = t["edgeFaceOffsets"]
+		edgeFaces = t["edgeFaces"]
+		expectedEdges = [
+			( V2i( 0, 1 ), [ 0 ] ),
+			( V2i( 0, 3 ), [ 0 ] ),
+			( V2i( 1, 2 ), [ 1 ] ),
+			( V2i( 1, 4 ), [ 0, 1 ] ),
+			( V2i( 2, 5 ), [ 1 ] ),
+			( V2i( 3, 4 ), [ 0 ] ),
+			( V2i( 4, 5 ), [ 1 ] ),
+		]
+		self.assertEqual( len( edges ), len( expectedEdges ) )
+		self.assertEqual( len( edgeFaceOffsets ), len( expectedEdges ) + 1 )
+		for e, ( edge, faces ) in enumerate( expectedEdges ) :
+			self.assertEqual( edges[e], edge )
+			self.assertEqual( list( edgeFaces[edgeFaceOffsets[e]:edgeFaceOffsets[e+1]] ), faces )
+
+		# the edges leading out of each face-vertex
+		ids = mesh.vertexIds
+		faceVertexEdges = t["faceVertexEdges"]
+		for f in range( 0, 2 ) :
+			for i in range( 0, 4 ) :
+				v0 = ids[f*4+i]
+				v1 = ids[f*4+(i+1)%4]
+				self.assertEqual( edges[faceVertexEdges[f*4+i]], V2i( min( v0, v1 ), max( v0, v1 ) ) )
+
+		vertexNeighbourOffsets = t["vertexNeighbourOffsets"]
+		vertexNeighbours = t["vertexNeighbours"]
+		self.assertEqual( len( vertexNeighbourOffsets ), 7 )
+		for v, neighbours in enumerate( [ [ 1, 3 ], [ 0, 2, 4 ], [ 1, 5 ], [ 0, 4 ], [ 1, 3, 5 ], [ 2, 4 ] ] ) :
+			self.assertEqual( list( vertexNeighbours[vertexNeighbourOffsets[v]:vertexNeighbourOffsets[v+1]] ), neighbours )
+
+	def testSharedByTopology( self ) :
+
+		mesh = MeshPrimitive.createPlane( Box2f( V2f( 0 ), V2f( 1 ) ), V2i( 10 ) )
+		t = MeshAlgo.topology( mesh )
+
+		mesh2 = mesh.copy()
+		mesh2["P"].data[0] = V3f( 10 )
+		self.assertEqual( MeshAlgo.topology( mesh2 ), t )
+
+		mesh3 = MeshPrimitive.createPlane( Box2f( V2f( 0 ), V2f( 1 ) ), V2i( 11 ) )
+		self.assertNotEqual( MeshAlgo.topology( mesh3 ), t )
+
+class MeshAlgoNormalsTest( unittest.TestCase ) :
+
+	def testPlane( self ) :
+
+		mesh = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( 4 ) )
+		self.assertTrue( "N" not in mesh )
+
+		n = MeshAlgo.calculateNormals( mesh )
+		self.assertTrue( "N" not in mesh )
+		self.assertEqual( n.interpolation, PrimitiveVariable.Interpolation.Vertex )
+		self.assertEqual( len( n.data ), mesh.variableSize( PrimitiveVariable.Interpolation.Vertex ) )
+		self.assertEqual( n.data.getInterpretation(), GeometricData.Interpretation.Normal )
+		for v in n.data :
+			self.assertEqual( v, V3f( 0, 0, 1 ) )
+
+		n = MeshAlgo.calculateNormals( mesh, PrimitiveVariable.Interpolation.Uniform )
+		self.assertEqual( n.interpolation, PrimitiveVariable.Interpolation.Uniform )
+		self.assertEqual( len( n.data ), mesh.variableSize( PrimitiveVariable.Interpolation.Uniform ) )
+
+	def testMatchesMeshNormalsOp( self ) :
+
+		mesh = Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+		del mesh["N"]
+
+		for interpolation in ( PrimitiveVariable.Interpolation.Vertex, PrimitiveVariable.Interpolation.Uniform ) :
+			n = MeshAlgo.calculateNormals( mesh, interpolation )
+			m = MeshNormalsOp()( input = mesh, interpolation = interpolation )
+			self.assertEqual( n, m["N"] )
+
+	def testInvalidPositionPrimVarRaisesException( self ) :
+
+		mesh = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ) )
+		self.assertRaises( RuntimeError, MeshAlgo.calculateNormals, mesh, position = "foo" )
+
+class MeshAlgoMergeMeshesTest( unittest.TestCase ) :
+
+	def plane( self, offset ) :
+
+		result = MeshPrimitive.createPlane( Box2f( V2f( offset ), V2f( offset + 1 ) ), V2i( offset + 1 ) )
+		result["a"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Constant, FloatData( offset ) )
+		result["c"] = PrimitiveVariable(
+			PrimitiveVariable.Interpolation.Uniform,
+			Color3fVectorData( [ Color3f( float( offset ) ) ] * result.variableSize( PrimitiveVariable.Interpolation.Uniform ) )
+		)
+
+		return result
+
+	def testMerge( self ) :
+
+		inputs = [ self.plane( i ) for i in range( 0, 4 ) ]
+		merged = MeshAlgo.mergeMeshes( inputs )
+
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged.numFaces(), sum( [ m.numFaces() for m in inputs ] ) )
+		self.assertEqual( merged["a"].data, FloatData( 0 ) )
+
+		# should match merging pairwise with MeshMergeOp
+		expected = inputs[0].copy()
+		for m in inputs[1:] :
+			expected = MeshMergeOp()( input = expected, mesh = m )
+
+		self.assertEqual( merged.verticesPerFace, expected.verticesPerFace )
+		self.assertEqual( merged.vertexIds, expected.vertexIds )
+		for name in ( "P", "s", "t", "c" ) :
+			self.assertEqual( merged[name], expected[name] )
+
+	def testMismatchedInterpolation( self ) :
+
+		m1 = self.plane( 0 )
+		m2 = self.plane( 1 )
+		m2["c"] = PrimitiveVariable(
+			PrimitiveVariable.Interpolation.FaceVarying,
+			Color3fVectorData( [ Color3f( 2 ) ] * m2.variableSize( PrimitiveVariable.Interpolation.FaceVarying ) )
+		)
+
+		merged = MeshAlgo.mergeMeshes( [ m1, m2 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged["c"].interpolation, PrimitiveVariable.Interpolation.FaceVarying )
+
+		c1 = m1["c"]
+		MeshAlgo.resamplePrimitiveVariable( m1, c1, PrimitiveVariable.Interpolation.FaceVarying )
+		self.assertEqual( merged["c"].data, Color3fVectorData( list( c1.data ) + list( m2["c"].data ) ) )
+
+	def testMissingAndMismatchedTypes( self ) :
+
+		m1 = self.plane( 0 )
+		m2 = self.plane( 1 )
+		m1["b"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, V3fVectorData( [ V3f( 1 ) ] * m1.variableSize( PrimitiveVariable.Interpolation.Vertex ) ) )
+		m2["c"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Uniform, IntVectorData( [ 1 ] * m2.numFaces() ) )
+
+		with CapturingMessageHandler() as mh :
+			merged = MeshAlgo.mergeMeshes( [ m1, m2 ] )
+
+		self.assertEqual( len( mh.messages ), 1 )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		numVertices1 = m1.variableSize( PrimitiveVariable.Interpolation.Vertex )
+		self.assertEqual( list( merged["b"].data ), [ V3f( 1 ) ] * numVertices1 + [ V3f( 0 ) ] * m2.variableSize( PrimitiveVariable.Interpolation.Vertex ) )
+		self.assertEqual( list( merged["c"].data ), list( m1["c"].data ) + [ Color3f( 0 ) ] * m2.numFaces() )
+
+	def testIndexedPrimitiveVariables( self ) :
+
+		m1 = self.plane( 0 )
+		m2 = self.plane( 1 )
+		for m in ( m1, m2 ) :
+			m["uv"] = PrimitiveVariable(
+				PrimitiveVariable.Interpolation.Vertex,
+				V2fVectorData( [ V2f( 0 ), V2f( 1 ) ] ),
+				IntVectorData( [ 1 ] * m.variableSize( PrimitiveVariable.Interpolation.Vertex ) )
+			)
+		uv = m2["uv"]
+		MeshAlgo.resamplePrimitiveVariable( m2, uv, PrimitiveVariable.Interpolation.FaceVarying )
+		m2["uv"] = uv
+
+		merged = MeshAlgo.mergeMeshes( [ m1, m2 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged["uv"].interpolation, PrimitiveVariable.Interpolation.FaceVarying )
+		self.assertEqual( merged["uv"].data, V2fVectorData( [ V2f( 0 ), V2f( 1 ), V2f( 0 ), V2f( 1 ) ] ) )
+
+		numFaceVertices1 = m1.variableSize( PrimitiveVariable.Interpolation.FaceVarying )
+		numFaceVertices2 = m2.variableSize( PrimitiveVariable.Interpolation.FaceVarying )
+		self.assertEqual( merged["uv"].indices, IntVectorData( [ 1 ] * numFaceVertices1 + [ 3 ] * numFaceVertices2 ) )
+
+	def testEmpty( self ) :
+
+		merged = MeshAlgo.mergeMeshes( [] )
+		self.assertEqual( merged.numFaces(), 0 )
+
 if __name__ == "__main__":
 	unittest.main()
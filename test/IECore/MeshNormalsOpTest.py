@@ -103,6 +103,36 @@ class MeshNormalsOpTest( unittest.TestCase ) :
 	
 		for n in m2["N"].data :
 			self.assertEqual( n, V3f( 0, 0, 1 ) )
-			
+
+	def testMixedFaceSizes( self ) :
+
+		# a pyramid with a quad base and a pentagon
+		# sharing one of the base vertices.
+		points = V3fVectorData( [
+			V3f( -1, 0, -1 ), V3f( 1, 0, -1 ), V3f( 1, 0, 1 ), V3f( -1, 0, 1 ), V3f( 0, 1, 0 ),
+			V3f( 2, 0, 2 ), V3f( 3, 0.5, 2 ), V3f( 3, 1, 3 ), V3f( 2, 1, 3.5 ),
+		] )
+		verticesPerFace = IntVectorData( [ 4, 3, 3, 3, 3, 5 ] )
+		vertexIds = IntVectorData( [ 0, 1, 2, 3, 1, 0, 4, 2, 1, 4, 3, 2, 4, 0, 3, 4, 2, 5, 6, 7, 8 ] )
+		mesh = MeshPrimitive( verticesPerFace, vertexIds, "linear", points )
+
+		# check against a straightforward accumulation of face normals
+		expected = [ V3f( 0 ) ] * len( points )
+		faceOffset = 0
+		for numVertices in verticesPerFace :
+			ids = vertexIds[faceOffset:faceOffset+numVertices]
+			n = ( points[ids[2]] - points[ids[1]] ).cross( points[ids[0]] - points[ids[1]] ).normalized()
+			for i in ids :
+				expected[i] = expected[i] + n
+			faceOffset += numVertices
+
+		normals = MeshNormalsOp()( input = mesh )["N"].data
+		self.assertEqual( len( normals ), len( points ) )
+		for i in range( 0, len( normals ) ) :
+			self.assertTrue( normals[i].equalWithAbsError( expected[i].normalized(), 0.0001 ) )
+
+		# results must be deterministic
+		self.assertEqual( MeshNormalsOp()( input = mesh )["N"].data, normals )
+
 if __name__ == "__main__":
     unittest.main()
@@ -71,6 +71,34 @@ class TestMeshPrimitiveEvaluator( unittest.TestCase ) :
 
 		self.failIf( foundClosest )
 
+	def testSignedDistance( self ) :
+		""" Testing MeshPrimitiveEvaluator signed distances"""
+
+		m = MeshPrimitive.createBox( Box3f( V3f( -1 ), V3f( 1 ) ) )
+		m = TriangulateOp()( input = m )
+
+		mpe = PrimitiveEvaluator.create( m )
+		r = mpe.createResult()
+
+		inside = mpe.signedDistance( V3f( 0, 0, 0.5 ), r )
+		outside = mpe.signedDistance( V3f( 0, 0, 3 ), r )
+		self.assertAlmostEqual( abs( inside ), 0.5, 5 )
+		self.assertAlmostEqual( abs( outside ), 2, 5 )
+		self.failUnless( inside * outside < 0 )
+
+		# edges and corners are resolved using the averaged normals
+		self.failUnless( mpe.signedDistance( V3f( 2, 2, 0 ), r ) * outside > 0 )
+		self.failUnless( mpe.signedDistance( V3f( 2, 2, 2 ), r ) * outside > 0 )
+		self.failUnless( mpe.signedDistance( V3f( 0.9, 0.9, 0.9 ), r ) * inside > 0 )
+
+		# open meshes can't be used, and must consistently fail
+		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ) )
+		m = TriangulateOp()( input = m )
+		mpe = PrimitiveEvaluator.create( m )
+		r = mpe.createResult()
+		self.assertRaises( RuntimeError, mpe.signedDistance, V3f( 0 ), r )
+		self.assertRaises( RuntimeError, mpe.signedDistance, V3f( 0 ), r )
+
 	def testTangents( self ) :
 
 		reader = Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" )
@@ -374,6 +402,105 @@ class TestMeshPrimitiveEvaluator( unittest.TestCase ) :
 					hits = mpe.intersectionPoints( origin, direction )
 					self.failIf( hits )
 
+	def testBVHAcceleration( self ) :
+		""" Testing that MeshPrimitiveEvaluator gives the same results with either acceleration structure"""
+
+		random.seed( 101 )
+		rand = Rand48( 101 )
+
+		numTriangles = 2000
+
+		P = V3fVectorData()
+		verticesPerFace = IntVectorData()
+		vertexIds = IntVectorData()
+
+		for tri in range( 0, numTriangles ) :
+
+			verticesPerFace.append( 3 )
+			for i in range( 0, 3 ) :
+				P.append( V3f( random.uniform(-10, 10), random.uniform(-10, 10), random.uniform(-10, 10) ) )
+				vertexIds.append( tri * 3 + i )
+
+		m = MeshPrimitive( verticesPerFace, vertexIds )
+		m["P"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, P )
+
+		kd = MeshPrimitiveEvaluator( m )
+		bvh = MeshPrimitiveEvaluator( m, MeshPrimitiveEvaluator.AccelerationStructure.BVHAcceleration )
+
+		r1 = kd.createResult()
+		r2 = bvh.createResult()
+
+		for i in range( 0, 200 ) :
+
+			p = V3f( random.uniform(-15, 15), random.uniform(-15, 15), random.uniform(-15, 15) )
+			self.failUnless( kd.closestPoint( p, r1 ) )
+			self.failUnless( bvh.closestPoint( p, r2 ) )
+			self.assertAlmostEqual( ( r1.point() - p ).length(), ( r2.point() - p ).length(), 4 )
+
+		# include axis aligned rays, which exercise the special
+		# case for rays parallel to the slabs of a box.
+		directions = [ Rand48.hollowSpheref( rand ) for i in range( 0, 200 ) ]
+		directions += [ V3f( 1, 0, 0 ), V3f( 0, -1, 0 ), V3f( 0, 0, 1 ) ]
+
+		for direction in directions :
+
+			origin = V3f( random.uniform(-5, 5), random.uniform(-5, 5), random.uniform(-5, 5) )
+
+			hit1 = kd.intersectionPoint( origin, direction, r1 )
+			hit2 = bvh.intersectionPoint( origin, direction, r2 )
+			self.assertEqual( hit1, hit2 )
+			if hit1 :
+				self.failUnless( r1.point().equalWithAbsError( r2.point(), 0.0001 ) )
+
+			hits1 = kd.intersectionPoints( origin, direction )
+			hits2 = bvh.intersectionPoints( origin, direction )
+			self.assertEqual(
+				sorted( [ h.triangleIndex() for h in hits1 ] ),
+				sorted( [ h.triangleIndex() for h in hits2 ] )
+			)
+
+	def testIndexedFaceVaryingUVs( self ) :
+
+		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( 2, 2 ) )
+
+		# share the uv values between faces using indices
+		for name in ( "s", "t" ) :
+			values = sorted( set( m[name].data ) )
+			m[name] = PrimitiveVariable(
+				PrimitiveVariable.Interpolation.FaceVarying,
+				FloatVectorData( values ),
+				IntVectorData( [ values.index( x ) for x in m[name].data ] )
+			)
+		self.assert_( m.arePrimitiveVariablesValid() )
+
+		indexed = TriangulateOp()( input = m )
+		self.failUnless( indexed["s"].indices is not None )
+		self.failUnless( len( indexed["s"].data ) < len( indexed["s"].indices ) )
+
+		expanded = indexed.copy()
+		for name in ( "s", "t" ) :
+			expanded[name] = PrimitiveVariable( indexed[name].interpolation, indexed[name].expandedData() )
+
+		indexedEvaluator = MeshPrimitiveEvaluator( indexed )
+		expandedEvaluator = MeshPrimitiveEvaluator( expanded )
+		self.assertEqual( indexedEvaluator.uvBound(), expandedEvaluator.uvBound() )
+
+		r1 = indexedEvaluator.createResult()
+		r2 = expandedEvaluator.createResult()
+		for x in ( -0.9, -0.3, 0.2, 0.8 ) :
+			for y in ( -0.7, 0.1, 0.6 ) :
+
+				p = V3f( x, y, 0 )
+				self.failUnless( indexedEvaluator.closestPoint( p, r1 ) )
+				self.failUnless( expandedEvaluator.closestPoint( p, r2 ) )
+
+				self.assertEqual( r1.uv(), r2.uv() )
+				for name in ( "s", "t" ) :
+					self.assertEqual( r1.floatPrimVar( indexed[name] ), r2.floatPrimVar( expanded[name] ) )
+
+				self.failUnless( indexedEvaluator.pointAtUV( r2.uv(), r1 ) )
+				self.failUnless( r1.point().equalWithAbsError( p, 0.0001 ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -315,6 +315,111 @@ class MeshVertexReorderOpTest( unittest.TestCase ) :
 		self.assert_( result.arePrimitiveVariablesValid() )
 
 
+	def __cacheMisses( self, mesh, cacheSize = 16 ) :
+
+		# simulates a FIFO post-transform vertex cache
+		cache = []
+		misses = 0
+		for v in mesh.vertexIds :
+			if v not in cache :
+				misses += 1
+				cache.append( v )
+				if len( cache ) > cacheSize :
+					del cache[0]
+
+		return misses
+
+	def __faces( self, mesh ) :
+
+		result = []
+		offset = 0
+		p = mesh["P"].data
+		s = mesh["s"].data
+		for n in mesh.verticesPerFace :
+			result.append( tuple( [ ( p[mesh.vertexIds[i]].x, p[mesh.vertexIds[i]].y, s[i] ) for i in range( offset, offset + n ) ] ) )
+			offset += n
+
+		return sorted( result )
+
+	def testVertexCache( self ) :
+
+		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( 40 ) )
+		m = TriangulateOp()( input = m )
+		m["s"] = PrimitiveVariable( PrimitiveVariable.Interpolation.FaceVarying, FloatVectorData( [ float( i ) for i in range( 0, m.variableSize( PrimitiveVariable.Interpolation.FaceVarying ) ) ] ) )
+
+		# shuffle the faces so that the original
+		# order is unfriendly to the vertex cache
+
+		reversedIds = IntVectorData()
+		reversedS = FloatVectorData()
+		for f in range( m.numFaces() - 1, -1, -1 ) :
+			for i in range( f * 3, f * 3 + 3 ) :
+				reversedIds.append( m.vertexIds[i] )
+				reversedS.append( m["s"].data[i] )
+		interleavedIds = IntVectorData()
+		interleavedS = FloatVectorData()
+		for f in range( 0, m.numFaces() ) :
+			f = ( f * 37 ) % m.numFaces()
+			for i in range( f * 3, f * 3 + 3 ) :
+				interleavedIds.append( reversedIds[i] )
+				interleavedS.append( reversedS[i] )
+
+		m.setTopology( m.verticesPerFace, interleavedIds )
+		m["s"] = PrimitiveVariable( PrimitiveVariable.Interpolation.FaceVarying, interleavedS )
+		self.assert_( m.arePrimitiveVariablesValid() )
+
+		result = MeshVertexReorderOp()( input = m, mode = MeshVertexReorderOp.Mode.VertexCache )
+
+		self.assert_( result.arePrimitiveVariablesValid() )
+		self.assertEqual( result.numFaces(), m.numFaces() )
+		self.assertEqual( result.variableSize( PrimitiveVariable.Interpolation.Vertex ), m.variableSize( PrimitiveVariable.Interpolation.Vertex ) )
+		self.assertEqual( self.__faces( result ), self.__faces( m ) )
+
+		self.assert_( self.__cacheMisses( result ) < self.__cacheMisses( m ) / 2 )
+
+		# vertices are numbered in order of first use
+
+		seen = set()
+		for v in result.vertexIds :
+			if v not in seen :
+				self.assertEqual( v, len( seen ) )
+				seen.add( v )
+
+	def testVertexCacheUniformAndIndexed( self ) :
+
+		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( 4 ) )
+		m["uni"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Uniform, IntVectorData( range( 0, m.numFaces() ) ) )
+		m["indexed"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, StringVectorData( [ "a", "b" ] ), IntVectorData( [ i % 2 for i in range( 0, m.variableSize( PrimitiveVariable.Interpolation.Vertex ) ) ] ) )
+
+		result = MeshVertexReorderOp()( input = m, mode = MeshVertexReorderOp.Mode.VertexCache )
+		self.assert_( result.arePrimitiveVariablesValid() )
+
+		self.assertEqual( result["indexed"].data, m["indexed"].data )
+
+		def faceCentre( mesh, f ) :
+			offset = sum( mesh.verticesPerFace[:f] )
+			ids = mesh.vertexIds[offset:offset+mesh.verticesPerFace[f]]
+			return sum( [ mesh["P"].data[i] for i in ids ], V3f( 0 ) ) / float( len( ids ) )
+
+		for f in range( 0, result.numFaces() ) :
+			self.assertEqual( faceCentre( result, f ), faceCentre( m, result["uni"].data[f] ) )
+
+		expanded = m["indexed"].expandedData()
+		resultExpanded = result["indexed"].expandedData()
+		for i in range( 0, len( result["P"].data ) ) :
+			self.assertEqual( resultExpanded[i], expanded[ list( m["P"].data ).index( result["P"].data[i] ) ] )
+
+	def testVertexCacheDisconnected( self ) :
+
+		m = MeshPrimitive( IntVectorData( [ 3, 3 ] ), IntVectorData( [ 0, 1, 2, 4, 5, 6 ] ) )
+		m["P"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, V3fVectorData( [ V3f( i ) for i in range( 0, 7 ) ] ) )
+
+		result = MeshVertexReorderOp()( input = m, mode = MeshVertexReorderOp.Mode.VertexCache )
+		self.assert_( result.arePrimitiveVariablesValid() )
+
+		# unused vertices are kept, after the used ones
+		self.assertEqual( result.vertexIds, IntVectorData( [ 0, 1, 2, 3, 4, 5 ] ) )
+		self.assertEqual( result["P"].data[6], V3f( 3 ) )
 
 if __name__ == "__main__":
     unittest.main()
@@ -223,6 +223,77 @@ class TestMessageHandler( unittest.TestCase ) :
 		del m
 		
 		self.assertEqual( w(), None )
-		
+
+	def testAsyncMessageHandler( self ) :
+
+		c = CapturingMessageHandler()
+		h = AsyncMessageHandler( c, maxMessagesPerSecond = 0 )
+
+		with h :
+			for i in range( 0, 10 ) :
+				msg( Msg.Level.Warning, "test", "a" )
+			msg( Msg.Level.Info, "test", "b" )
+
+		h.flush()
+
+		self.assertEqual( len( c.messages ), 3 )
+		self.assertEqual( c.messages[0].level, Msg.Level.Warning )
+		self.assertEqual( c.messages[0].context, "test" )
+		self.assertEqual( c.messages[0].message, "a" )
+		self.assertEqual( c.messages[1].level, Msg.Level.Info )
+		self.assertEqual( c.messages[1].message, "b" )
+		self.assertEqual( c.messages[2].level, Msg.Level.Warning )
+		self.assertEqual( c.messages[2].message, "a (repeated 9 times)" )
+
+		# a flush forgets the messages output so far
+
+		with h :
+			msg( Msg.Level.Warning, "test", "a" )
+			msg( Msg.Level.Warning, "test", "a" )
+
+		h.flush()
+		self.assertEqual( len( c.messages ), 5 )
+		self.assertEqual( c.messages[3].message, "a" )
+		self.assertEqual( c.messages[4].message, "a (repeated 1 times)" )
+
+	def testAsyncMessageHandlerRateLimiting( self ) :
+
+		c = CapturingMessageHandler()
+		h = AsyncMessageHandler( c, maxMessagesPerSecond = 5 )
+
+		with h :
+			for i in range( 0, 20 ) :
+				msg( Msg.Level.Warning, "test", str( i ) )
+
+		h.flush()
+
+		self.assertEqual( [ m.message for m in c.messages[:5] ], [ "0", "1", "2", "3", "4" ] )
+		self.assertEqual( len( c.messages ), 6 )
+		self.assertEqual( c.messages[5].context, "AsyncMessageHandler" )
+		self.assertEqual( c.messages[5].message, "15 messages omitted due to rate limiting" )
+
+	def testAsyncMessageHandlerThreading( self ) :
+
+		c = CapturingMessageHandler()
+		h = AsyncMessageHandler( c, maxMessagesPerSecond = 0 )
+
+		def f() :
+			with h :
+				for i in range( 0, 100 ) :
+					msg( Msg.Level.Info, "test", str( i ) )
+
+		threads = []
+		for i in range( 0, 10 ) :
+			t = threading.Thread( target = f )
+			threads.append( t )
+			t.start()
+
+		for t in threads :
+			t.join()
+
+		h.flush()
+
+		self.assertEqual( sorted( [ m.message for m in c.messages[:100] ] ), sorted( [ str( i ) for i in range( 0, 100 ) ] ) )
+
 if __name__ == "__main__":
     unittest.main()
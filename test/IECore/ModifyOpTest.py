@@ -0,0 +1,85 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+import IECore
+
+class ModifyOpTest( unittest.TestCase ) :
+
+	def testCopyWhenReferenced( self ) :
+
+		mesh = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		if "N" in mesh :
+			del mesh["N"]
+
+		op = IECore.MeshNormalsOp()
+		op.inputParameter().setValue( mesh )
+		result = op.operate()
+
+		# we hold a reference to the input, so it must not be modified
+		self.failIf( result.isSame( mesh ) )
+		self.failIf( "N" in mesh )
+		self.failUnless( "N" in result )
+
+	def testModifyInPlaceWhenUnreferenced( self ) :
+
+		op = IECore.MeshNormalsOp()
+		op.inputParameter().setValue( IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) ) )
+		result = op.operate()
+
+		# only the op referenced the input, so it was modified without a copy
+		self.failUnless( result.isSame( op.inputParameter().getValue() ) )
+		self.failUnless( "N" in result )
+
+		# but now we hold the result, so operating again must copy
+		result2 = op.operate()
+		self.failIf( result2.isSame( result ) )
+
+	def testDisabledCopyParameter( self ) :
+
+		mesh = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		if "N" in mesh :
+			del mesh["N"]
+
+		op = IECore.MeshNormalsOp()
+		op.inputParameter().setValue( mesh )
+		op.copyParameter().setTypedValue( False )
+		result = op.operate()
+
+		self.failUnless( result.isSame( mesh ) )
+		self.failUnless( "N" in mesh )
+
+if __name__ == "__main__":
+	unittest.main()
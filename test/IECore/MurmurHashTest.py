@@ -215,7 +215,45 @@ class MurmurHashTest( unittest.TestCase ) :
 		h2.append( IECore.StringVectorData( [ "", "" ] ) )
 		
 		self.assertNotEqual( h1, h2 )
-		
+
+	def testLargeVectors( self ) :
+
+		# large enough to be hashed using the multi-lane
+		# bulk path, with a tail that isn't a multiple of
+		# the lane stride.
+		d = IECore.FloatVectorData( range( 0, 100003 ) )
+
+		h1 = IECore.MurmurHash()
+		h1.append( d )
+		h2 = IECore.MurmurHash()
+		h2.append( d.copy() )
+		self.assertEqual( h1, h2 )
+
+		# changes in each lane and in the tail must
+		# all affect the result.
+		hashes = set( [ str( h1 ) ] )
+		for i in [ 0, 4, 8, 12, 50001, 100000, 100002 ] :
+			d2 = d.copy()
+			d2[i] = -1
+			h = IECore.MurmurHash()
+			h.append( d2 )
+			hashes.add( str( h ) )
+
+		self.assertEqual( len( hashes ), 8 )
+
+		# as must reordering blocks within a lane.
+		d2 = d.copy()
+		d2[0], d2[16] = d2[16], d2[0]
+		h2 = IECore.MurmurHash()
+		h2.append( d2 )
+		self.assertNotEqual( h1, h2 )
+
+		# and the prior state of the hash.
+		h2 = IECore.MurmurHash()
+		h2.append( 1 )
+		h2.append( d )
+		self.assertNotEqual( h1, h2 )
+
 if __name__ == "__main__":
 	unittest.main()
 
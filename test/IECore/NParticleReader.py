@@ -339,6 +339,29 @@ class TestNParticleReader( unittest.TestCase ) :
 		self.assert_( p.resultParameter().isInstanceOf( "ObjectParameter" ) )
 		self.assertEqual( p.resultParameter().validTypes(), [IECore.TypeId.PointsPrimitive] )
 
+	def testRandomFrameAccess( self ) :
+
+		fileName = "test/IECore/data/iffFiles/nParticleMultipleFrames.mc"
+
+		r = IECore.NParticleReader( fileName )
+		frames = []
+		for i in range( 0, len( r.frameTimes() ) ) :
+			r["frameIndex"].setValue( i )
+			frames.append( r.read() )
+
+		# fresh readers share the already opened file, and should give
+		# identical results regardless of the order frames are accessed in.
+		for i in reversed( range( 0, len( frames ) ) ) :
+			r = IECore.NParticleReader( fileName )
+			r["frameIndex"].setValue( i )
+			self.assertEqual( r.read(), frames[i] )
+
+	def testMissingFile( self ) :
+
+		r = IECore.NParticleReader( "test/IECore/data/iffFiles/doesNotExist.mc" )
+		self.assertRaises( RuntimeError, r.read )
+		self.failIf( IECore.NParticleReader.canRead( "test/IECore/data/iffFiles/doesNotExist.mc" ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -32,6 +32,7 @@
 #
 ##########################################################################
 
+import os
 import unittest
 import sys
 import IECore
@@ -96,6 +97,55 @@ class TestOBJReader( unittest.TestCase ) :
 		self.failUnless( mesh.isInstanceOf( IECore.MeshPrimitive.staticTypeId() ) )
 		self.failUnless( mesh.arePrimitiveVariablesValid() )
 
+	def testIndexedFaceVarying( self ) :
+
+		r = IECore.Reader.create( "test/IECore/data/obj/triangle_normals.obj" )
+		expanded = r.read()
+
+		r["indexedFaceVarying"].setTypedValue( True )
+		indexed = r.read()
+
+		self.failUnless( indexed.arePrimitiveVariablesValid() )
+		self.assertEqual( indexed["N"].data, IECore.V3fVectorData( [ IECore.V3f( 1, 0, 0 ), IECore.V3f( 0, 1, 0 ) ] ) )
+		self.assertEqual( indexed["N"].indices, IECore.IntVectorData( [ 0, 1, 1 ] ) )
+		self.assertEqual( indexed["s"].indices, IECore.IntVectorData( [ 0, 1, 2 ] ) )
+
+		for name in ( "s", "t", "N" ) :
+			self.assertEqual( expanded[name].indices, None )
+			self.assertEqual( indexed[name].expandedData(), expanded[name].data )
+
+	def testRelativeIndicesAcrossChunks( self ) :
+
+		# big enough to be split into several chunks for parallel parsing,
+		# with relative indices which may refer back into a previous chunk.
+		numFaces = 100000
+		f = open( "test/IECore/data/obj/large.obj", "w" )
+		for i in range( 0, numFaces ) :
+			for j in range( 0, 4 ) :
+				f.write( "v %d %d 0.5\n" % ( i, j ) )
+			f.write( "f -4 -3 -2 -1\n" )
+		f.close()
+
+		mesh = IECore.Reader.create( "test/IECore/data/obj/large.obj" ).read()
+		self.failUnless( mesh.arePrimitiveVariablesValid() )
+		self.assertEqual( mesh.verticesPerFace, IECore.IntVectorData( [ 4 ] * numFaces ) )
+		self.assertEqual( mesh.vertexIds, IECore.IntVectorData( range( 0, numFaces * 4 ) ) )
+		self.assertEqual( mesh["P"].data[-1], IECore.V3f( numFaces - 1, 3, 0.5 ) )
+
+	def testInvalidFace( self ) :
+
+		f = open( "test/IECore/data/obj/invalid.obj", "w" )
+		f.write( "v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0 0\nf 1/1 2 3\n" )
+		f.close()
+
+		self.assertRaises( RuntimeError, IECore.Reader.create( "test/IECore/data/obj/invalid.obj" ).read )
+
+	def tearDown( self ) :
+
+		for f in ( "test/IECore/data/obj/large.obj", "test/IECore/data/obj/invalid.obj" ) :
+			if os.path.exists( f ) :
+				os.remove( f )
+
 if __name__ == "__main__":
 	
 	unittest.main()
@@ -261,6 +261,37 @@ class TestObjectIO( unittest.TestCase ) :
 		self.assert_( dd['c']['d'].isSame( dd['links']['v3'] ) )
 		self.assert_( dd['c/d'].isSame( dd['links']['v3'] ) )
 
+	def testParallelLoad( self ) :
+
+		shared = IntVectorData( range( 0, 1000 ) )
+
+		o = CompoundObject()
+		for i in range( 0, 100 ) :
+			c = CompoundData()
+			c["shared"] = shared
+			c["own"] = IntVectorData( [ i ] * 1000 )
+			o[str(i)] = c
+		o["vector"] = ObjectVector( [ shared, IntData( 1 ), shared ] )
+		o["group"] = Group()
+		for i in range( 0, 10 ) :
+			o["group"].addChild( Group() )
+			o["group"].children()[-1].addState( AttributeState( { "name" : StringData( str( i ) ) } ) )
+
+		f = FileIndexedIO( "test/o.fio", [], IndexedIO.OpenMode.Write )
+		o.save( f, "test" )
+		del f
+
+		f = FileIndexedIO( "test/o.fio", [], IndexedIO.OpenMode.Read )
+		for i in range( 0, 10 ) :
+			oo = Object.load( f, "test", parallel = True )
+			self.assertEqual( oo, o )
+			self.assertEqual( oo, Object.load( f, "test" ) )
+			# Shared objects must still be shared after a parallel load.
+			s = oo["vector"][0]
+			self.assertTrue( oo["vector"][2].isSame( s ) )
+			for j in range( 0, 100 ) :
+				self.assertTrue( oo[str(j)]["shared"].isSame( s ) )
+
 	def tearDown( self ) :
 
 		for f in [ "test/o.fio", "test/FileIndexedIOSlashes.fio" ] :
@@ -190,5 +190,24 @@ class TestObjectInterpolation( unittest.TestCase ) :
 		m3 = linearObjectInterpolation( m1, m2, 0.5 )
 		self.assertEqual( m3.blindData()["a"], FloatData( 10 ) )	
 
+	def testLargePrimitiveInterpolation( self ) :
+
+		n = 100000
+		p1 = V3fVectorData( [ V3f( i ) for i in range( 0, n ) ] )
+		p2 = V3fVectorData( [ V3f( i + 2 ) for i in range( 0, n ) ] )
+		w = FloatVectorData( [ i * 0.5 for i in range( 0, n ) ] )
+
+		m1 = PointsPrimitive( p1 )
+		m1["w"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, w )
+		m2 = PointsPrimitive( p2 )
+		m2["w"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, w.copy() )
+
+		m3 = linearObjectInterpolation( m1, m2, 0.5 )
+		self.assertEqual( m3["P"].data, V3fVectorData( [ V3f( i + 1 ) for i in range( 0, n ) ] ) )
+		self.assertEqual( m3["w"].data, w )
+
+		c = cubicObjectInterpolation( FloatVectorData( [ 0 ] * n ), FloatVectorData( [ 1 ] * n ), FloatVectorData( [ 2 ] * n ), FloatVectorData( [ 3 ] * n ), 0.5 )
+		self.assertEqual( c, FloatVectorData( [ 1.5 ] * n ) )
+
 if __name__ == "__main__":
     unittest.main()
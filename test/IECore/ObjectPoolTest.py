@@ -110,6 +110,106 @@ class ObjectPoolTest( unittest.TestCase ) :
 		self.assertEqual( p.memoryUsage(), b.memoryUsage() )
 		self.assertFalse( p.contains(a.hash()) )
 		self.assertTrue( p.contains(b.hash()) )
-		
+
+	def testEvictionPolicies( self ) :
+
+		for policy in ( ObjectPool.EvictionPolicy.ExactLRU, ObjectPool.EvictionPolicy.ShardedLRU, ObjectPool.EvictionPolicy.TwoQueue, ObjectPool.EvictionPolicy.CostWeighted ) :
+
+			p = ObjectPool( 500, policy )
+			self.assertEqual( p.evictionPolicy(), policy )
+
+			objects = [ p.store( IntData( i ), ObjectPool.StoreReference ) for i in range( 0, 100 ) ]
+			self.assertTrue( p.memoryUsage() <= 500 )
+			self.assertTrue( p.contains( objects[-1].hash() ) )
+
+			p.setMaxMemoryUsage( objects[0].memoryUsage() )
+			self.assertTrue( p.memoryUsage() <= objects[0].memoryUsage() )
+
+			p.setMaxMemoryUsage( 0 )
+			self.assertEqual( p.memoryUsage(), 0 )
+
+	def testTwoQueueScanResistance( self ) :
+
+		m = IntData( 0 ).memoryUsage()
+		p = ObjectPool( m * 8, ObjectPool.EvictionPolicy.TwoQueue )
+
+		hot = [ p.store( IntData( i ), ObjectPool.StoreReference ) for i in range( 0, 4 ) ]
+		for h in hot :
+			self.assertTrue( h.isSame( p.retrieve( h.hash(), _copy=False ) ) )
+
+		# a scan of objects which are only seen once shouldn't flush the
+		# objects which are being reused.
+		for i in range( 100, 200 ) :
+			p.store( IntData( i ), ObjectPool.StoreReference )
+
+		for h in hot :
+			self.assertTrue( p.contains( h.hash() ) )
+
+	def testStatistics( self ) :
+
+		a = IntData( 1 )
+		p = ObjectPool( a.memoryUsage() )
+
+		s = p.statistics()
+		self.assertEqual( ( s.hits, s.misses, s.evictions ), ( 0, 0, 0 ) )
+
+		p.store( a, ObjectPool.StoreReference )
+		p.store( a, ObjectPool.StoreReference )
+		p.retrieve( a.hash() )
+
+		s = p.statistics()
+		self.assertEqual( s.hits, 2 )
+		self.assertEqual( s.misses, 1 )
+		self.assertEqual( s.evictions, 0 )
+
+		p.store( IntData( 3 ), ObjectPool.StoreReference )
+		s = p.statistics()
+		self.assertEqual( s.misses, 2 )
+		self.assertEqual( s.evictions, 1 )
+
+		p.retrieve( IntData( 2 ).hash() )
+		self.assertEqual( p.statistics().misses, 3 )
+
+		p.resetStatistics()
+		s = p.statistics()
+		self.assertEqual( ( s.hits, s.misses, s.evictions ), ( 0, 0, 0 ) )
+
+	def testSharedDataCountedOnce( self ) :
+
+		v = IntVectorData( range( 0, 10000 ) )
+		c1 = CompoundObject( { "a" : v } )
+		c2 = CompoundObject( { "b" : v } )
+
+		p = ObjectPool( 1024 * 1024 )
+		p.store( c1, ObjectPool.StoreReference )
+		self.assertEqual( p.memoryUsage(), c1.memoryUsage() )
+
+		p.store( c2, ObjectPool.StoreReference )
+		self.assertTrue( p.memoryUsage() <= c1.memoryUsage() + c2.memoryUsage() - 10000 * 4 )
+
+		p.erase( c1.hash() )
+		self.assertEqual( p.memoryUsage(), c2.memoryUsage() )
+
+		p.erase( c2.hash() )
+		self.assertEqual( p.memoryUsage(), 0 )
+
+	def testSharedDataLimit( self ) :
+
+		v = IntVectorData( range( 0, 10000 ) )
+		c1 = CompoundObject( { "a" : v } )
+		c2 = CompoundObject( { "b" : v } )
+
+		# enough for both objects only if the shared data is counted once
+		p = ObjectPool( c1.memoryUsage() + c2.memoryUsage() - 10000 * 4 )
+		p.store( c1, ObjectPool.StoreReference )
+		p.store( c2, ObjectPool.StoreReference )
+
+		self.assertTrue( p.contains( c1.hash() ) )
+		self.assertTrue( p.contains( c2.hash() ) )
+		self.assertTrue( p.memoryUsage() <= p.getMaxMemoryUsage() )
+
+		p.setMaxMemoryUsage( 0 )
+		self.assertEqual( p.memoryUsage(), 0 )
+
 if __name__ == "__main__":
     unittest.main()
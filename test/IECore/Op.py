@@ -148,6 +148,76 @@ class TestPythonOp( unittest.TestCase ) :
 		# make sure the last call did not affect the contents of the Op's parameters.
 		self.assertEqual( op.parameters()['name'].getTypedValue(), "john" )
 
+	def testResultCaching( self ) :
+
+		class CountingOp( Op ) :
+
+			def __init__( self ) :
+
+				Op.__init__( self, "Counts the operations it performs.", StringParameter( name = "result", description = "", defaultValue = "" ) )
+				self.parameters().addParameter( StringParameter( name = "name", description = "", defaultValue = "john" ) )
+				self.numOperations = 0
+
+			def doOperation( self, operands ) :
+
+				self.numOperations += 1
+				return StringData( operands['name'].value )
+
+		Op.clearResultCache()
+
+		o = CountingOp()
+		self.assertEqual( o.getResultCaching(), False )
+		o( name = "jim" )
+		o( name = "jim" )
+		self.assertEqual( o.numOperations, 2 )
+
+		o.setResultCaching( True )
+		self.assertEqual( o.getResultCaching(), True )
+		self.assertEqual( o( name = "jim" ), StringData( "jim" ) )
+		self.assertEqual( o.numOperations, 3 )
+		r = o( name = "jim" )
+		self.assertEqual( r, StringData( "jim" ) )
+		self.assertEqual( o.numOperations, 3 )
+		self.assertEqual( o.resultParameter().getValue(), r )
+
+		# the result we're given is a copy, so modifying it doesn't affect the cache
+		r.value = "bob"
+		self.assertEqual( o( name = "jim" ), StringData( "jim" ) )
+		self.assertEqual( o.numOperations, 3 )
+
+		self.assertEqual( o( name = "roger" ), StringData( "roger" ) )
+		self.assertEqual( o.numOperations, 4 )
+
+		# results are shared between Ops of the same type
+		o2 = CountingOp()
+		o2.setResultCaching( True )
+		self.assertEqual( o2( name = "roger" ), StringData( "roger" ) )
+		self.assertEqual( o2.numOperations, 0 )
+
+		Op.clearResultCache()
+		o( name = "jim" )
+		self.assertEqual( o.numOperations, 5 )
+
+	def testModifyOpResultCaching( self ) :
+
+		Op.clearResultCache()
+
+		mesh = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ) )
+		op = MeshNormalsOp()
+		op.setResultCaching( True )
+
+		r1 = op( input = mesh )
+		r2 = op( input = mesh )
+		self.assertEqual( r1, r2 )
+		self.failIf( r1.isSame( r2 ) )
+
+		# modifying in place can't use the cache
+		if "N" in mesh :
+			del mesh["N"]
+		r3 = op( input = mesh, copyInput = False )
+		self.failUnless( r3.isSame( mesh ) )
+		self.failUnless( "N" in mesh )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -211,6 +211,86 @@ class TestPDCReader( unittest.TestCase ) :
 		self.assert_( len( a ) < 15 )
 		self.assert_( len( a ) > 8 )
 
+	def testMemoryMapped( self ) :
+
+		for fileName in [
+			"test/IECore/data/pdcFiles/particleShape1.250.pdc",
+			"test/IECore/data/pdcFiles/particleShape1.intId.250.pdc",
+			"test/IECore/data/pdcFiles/particleShape1.noId.250.pdc",
+		] :
+
+			for percentage in [ 100, 50 ] :
+
+				for realType in [ "native", "float" ] :
+
+					r = IECore.PDCParticleReader( fileName )
+					r["percentage"].setTypedValue( percentage )
+					r["realType"].setValue( realType )
+
+					rm = IECore.PDCParticleReader( fileName )
+					rm["percentage"].setTypedValue( percentage )
+					rm["realType"].setValue( realType )
+					rm["memoryMapped"].setTypedValue( True )
+
+					with IECore.CapturingMessageHandler() :
+						for name in r.attributeNames() :
+							self.assertEqual( r.readAttribute( name ), rm.readAttribute( name ) )
+						self.assertEqual( r.read(), rm.read() )
+
+
+	def testReadRange( self ) :
+
+		for fileName in [
+			"test/IECore/data/pdcFiles/particleShape1.250.pdc",
+			"test/IECore/data/pdcFiles/particleShape1.intId.250.pdc",
+			"test/IECore/data/pdcFiles/particleShape1.noId.250.pdc",
+		] :
+
+			for percentage in [ 100, 50 ] :
+
+				r = IECore.PDCParticleReader( fileName )
+				r["percentage"].setTypedValue( percentage )
+				r["realType"].setValue( "float" )
+
+				with IECore.CapturingMessageHandler() :
+
+					for name in r.attributeNames() :
+						a = r.readAttribute( name )
+						chunked = []
+						for begin in range( 0, r.numParticles(), 7 ) :
+							chunked.extend( list( r.readAttributeRange( name, begin, begin + 7 ) ) )
+						self.assertEqual( list( a ), chunked )
+
+					self.assertEqual( r.readAttributeRange( "position", 100, 200 ), IECore.V3fVectorData() )
+
+					p = r.read()
+					numPoints = 0
+					for begin in range( 0, r.numParticles(), 7 ) :
+						c = r.readRange( begin, begin + 7 )
+						self.assertTrue( c.arePrimitiveVariablesValid() )
+						self.assertEqual( list( c["P"].data ), list( p["P"].data )[numPoints:numPoints+c.numPoints] )
+						numPoints += c.numPoints
+
+					self.assertEqual( numPoints, p.numPoints )
+
+	def testStreamToSceneCache( self ) :
+
+		r = IECore.PDCParticleReader( "test/IECore/data/pdcFiles/particleShape1.250.pdc" )
+		p = r.read()
+
+		s = IECore.SceneCache( "test/particleChunks.scc", IECore.IndexedIO.OpenMode.Write )
+		chunkSize = 10
+		for i, begin in enumerate( range( 0, r.numParticles(), chunkSize ) ) :
+			c = s.createChild( "chunk%d" % i )
+			c.writeObject( r.readRange( begin, begin + chunkSize ), 0 )
+		del c, s
+
+		s = IECore.SceneCache( "test/particleChunks.scc", IECore.IndexedIO.OpenMode.Read )
+		positions = []
+		for i in range( 0, len( s.childNames() ) ) :
+			positions.extend( list( s.child( "chunk%d" % i ).readObject( 0 )["P"].data ) )
+
+		self.assertEqual( positions, list( p["P"].data ) )
 
 	def testConversion( self ) :
 
@@ -339,8 +419,9 @@ class TestPDCReader( unittest.TestCase ) :
 		
 	def tearDown( self ) :
 
-		if os.path.isfile( "test/particleShape1.250.pdc" ) :
-			os.remove( "test/particleShape1.250.pdc" )
+		for f in [ "test/particleShape1.250.pdc", "test/particleChunks.scc" ] :
+			if os.path.isfile( f ) :
+				os.remove( f )
 			
 if __name__ == "__main__":
 	unittest.main()
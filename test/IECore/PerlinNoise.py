@@ -331,6 +331,25 @@ class TestPerlinNoise( unittest.TestCase ) :
 				self.failUnless( n( p, 0.5 ) != 0 )		
 				self.failUnless( n( p, 0.6 ) == 0 )			
 
+	def testNoiseVector( self ) :
+
+		r = random.Random( 0 )
+		for n, pointType, dimensions, dataType in [
+			( IECore.PerlinNoiseV3ff( 1 ), IECore.V3f, 3, IECore.V3fVectorData ),
+			( IECore.PerlinNoiseV3fV3f( 2 ), IECore.V3f, 3, IECore.V3fVectorData ),
+			( IECore.PerlinNoiseV3fColor3f( 3 ), IECore.V3f, 3, IECore.V3fVectorData ),
+			( IECore.PerlinNoiseV2ff( 4 ), IECore.V2f, 2, IECore.V2fVectorData ),
+		] :
+
+			points = dataType()
+			for i in range( 0, 10000 ) :
+				points.append( pointType( *[ r.uniform( -100, 100 ) for j in range( 0, dimensions ) ] ) )
+
+			values = n.noiseVector( points )
+			self.assertEqual( len( values ), len( points ) )
+			for p, v in zip( points, values ) :
+				self.assertEqual( v, n.noise( p ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -136,6 +136,24 @@ class PointDistributionTest( unittest.TestCase ) :
 			for n in neighbours :
 				self.failUnless( ( positions[i] - positions[n] ).length() > 0.004 )
 
+	def testRepeatedDistribution( self ) :
+
+		pd = IECore.PointDistribution.defaultInstance()
+
+		bound = IECore.Box2f( IECore.V2f( -1.5 ), IECore.V2f( 1.5 ) )
+
+		# the second distribution reuses the points cached by the first,
+		# but must still apply the new density function.
+		points1 = pd( bound, 5000, None )
+		points2 = pd( bound, 5000, None )
+		self.assertEqual( points1, points2 )
+
+		def density( p ) :
+			return 1 if p.x < 0 else 0
+
+		points3 = pd( bound, 5000, density )
+		self.assertEqual( points3, IECore.V2fVectorData( [ p for p in points1 if p.x < 0 ] ) )
+
 	def setUp( self ) :
 	
 		os.environ["CORTEX_POINTDISTRIBUTION_TILESET"] = "test/IECore/data/pointDistributions/pointDistributionTileSet2048.dat"
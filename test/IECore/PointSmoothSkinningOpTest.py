@@ -33,6 +33,7 @@
 #
 ##########################################################################
 
+import math
 import unittest
 from IECore import *
 
@@ -218,6 +219,44 @@ class PointSmoothSkinningOpTest( unittest.TestCase ) :
 		o(input=pts, positionVar="bob", copyInput=False, deformationPose = self.myDP(), smoothSkinningData = self.mySSD( ))
 		self.assertNotEqual(pts["bob"].data , self.myP())
 
+	def testDualQuaternion( self ) :
+
+		ssd = SmoothSkinningData(
+			StringVectorData( [ "a", "b" ] ),
+			M44fVectorData( [ M44f(), M44f() ] ),
+			IntVectorData( [ 0, 1, 2 ] ),
+			IntVectorData( [ 1, 1, 2 ] ),
+			IntVectorData( [ 0, 1, 0, 1 ] ),
+			FloatVectorData( [ 1, 1, 0.5, 0.5 ] ),
+		)
+
+		pose = M44fVectorData( [
+			M44f().translate( V3f( 1, 0, 0 ) ),
+			M44f().rotate( V3f( 0, 0, math.pi / 2 ) ) * M44f().translate( V3f( 0, 2, 0 ) ),
+		] )
+
+		p = V3fVectorData( [ V3f( 1, 0, 0 ), V3f( 1, 0, 0 ), V3f( 1, 0, 0 ) ] )
+		n = V3fVectorData( [ V3f( 1, 0, 0 ), V3f( 1, 0, 0 ), V3f( 1, 0, 0 ) ] )
+		pts = PointsPrimitive( p.copy() )
+		pts["N"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, n.copy() )
+
+		linear = PointSmoothSkinningOp()( input = pts, deformationPose = pose, smoothSkinningData = ssd, deformNormals = True, blend = int( PointSmoothSkinningOp.Blend.Linear ) )
+		dualQuaternion = PointSmoothSkinningOp()( input = pts, deformationPose = pose, smoothSkinningData = ssd, deformNormals = True, blend = int( PointSmoothSkinningOp.Blend.DualQuaternion ) )
+
+		# with a single rigid influence, both methods should agree
+		for i in range( 0, 2 ) :
+			self.failUnless( dualQuaternion["P"].data[i].equalWithAbsError( linear["P"].data[i], 0.0001 ) )
+			self.failUnless( dualQuaternion["N"].data[i].equalWithAbsError( linear["N"].data[i], 0.0001 ) )
+
+		self.failUnless( dualQuaternion["P"].data[0].equalWithAbsError( V3f( 2, 0, 0 ), 0.0001 ) )
+		self.failUnless( dualQuaternion["P"].data[1].equalWithAbsError( V3f( 0, 3, 0 ), 0.0001 ) )
+
+		# when blending, linear skinning collapses towards the joint, but the
+		# dual quaternion result preserves the length of the normal
+		self.failUnless( linear["N"].data[2].length() < 0.75 )
+		self.assertAlmostEqual( dualQuaternion["N"].data[2].length(), 1, 4 )
+		self.failUnless( dualQuaternion["N"].data[2].equalWithAbsError( V3f( 1, 1, 0 ).normalized(), 0.0001 ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
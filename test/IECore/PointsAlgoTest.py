@@ -283,6 +283,23 @@ class DeletePointsTest( unittest.TestCase ) :
 		self.assertEqual( points["e"].data, IECore.FloatVectorData( range( 0, 10, 2 ) ) )
 		self.assertEqual( points["e"].interpolation, IECore.PrimitiveVariable.Interpolation.FaceVarying)
 
+	def testDeleteManyPoints( self ) :
+
+		# enough points for the deletion to be split across threads
+		n = 100000
+		points = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( i ) for i in range( 0, n ) ] ) )
+		points["delete"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.BoolVectorData( [ i % 3 == 0 for i in range( 0, n ) ] ) )
+		points["i"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Varying, IECore.IntVectorData( range( 0, n ) ) )
+
+		result = IECore.PointsAlgo.deletePoints( points, points["delete"] )
+		self.assertTrue( result.arePrimitiveVariablesValid() )
+
+		kept = [ i for i in range( 0, n ) if i % 3 != 0 ]
+		self.assertEqual( result.numPoints, len( kept ) )
+		self.assertEqual( result["i"].data, IECore.IntVectorData( kept ) )
+		self.assertEqual( result["P"].data, IECore.V3fVectorData( [ IECore.V3f( i ) for i in kept ] ) )
+		self.assertEqual( result["delete"].data, IECore.BoolVectorData( [ False ] * len( kept ) ) )
+
 
 if __name__ == "__main__":
 	unittest.main()
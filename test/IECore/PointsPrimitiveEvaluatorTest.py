@@ -75,6 +75,49 @@ class PointsPrimitiveEvaluatorTest( unittest.TestCase ) :
 		self.assertEqual( r.colorPrimVar( p["Cs"] ), IECore.Color3f( 5, 0, 0 ) )
 		self.assertEqual( r.stringPrimVar( p["names"] ), "a" )		
 
+	def testIntersectionPoint( self ) :
+
+		p = IECore.PointsPrimitive( 5 )
+		p["P"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ IECore.V3f( x * 10, 0, 0 ) for x in range( 0, 5 ) ] ) )
+		p["width"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 2, 2, 4, 2, 2 ] ) )
+
+		e = IECore.PointsPrimitiveEvaluator( p )
+		r = e.createResult()
+
+		self.failUnless( e.intersectionPoint( IECore.V3f( 20, 10, 0 ), IECore.V3f( 0, -1, 0 ), r ) )
+		self.assertEqual( r.pointIndex(), 2 )
+		self.failUnless( r.point().equalWithAbsError( IECore.V3f( 20, 2, 0 ), 1e-5 ) )
+		self.failUnless( r.normal().equalWithAbsError( IECore.V3f( 0, 1, 0 ), 1e-5 ) )
+
+		self.failIf( e.intersectionPoint( IECore.V3f( 20, 10, 0 ), IECore.V3f( 0, -1, 0 ), r, 5 ) )
+		self.failIf( e.intersectionPoint( IECore.V3f( 5, 10, 0 ), IECore.V3f( 0, -1, 0 ), r ) )
+
+		results = e.intersectionPoints( IECore.V3f( -10, 0, 0 ), IECore.V3f( 1, 0, 0 ) )
+		self.assertEqual( [ x.pointIndex() for x in results ], range( 0, 5 ) )
+		self.failUnless( results[0].point().equalWithAbsError( IECore.V3f( -1, 0, 0 ), 1e-5 ) )
+
+		results = e.intersectionPoints( IECore.V3f( -10, 0, 0 ), IECore.V3f( 1, 0, 0 ), 20 )
+		self.assertEqual( [ x.pointIndex() for x in results ], [ 0, 1 ] )
+
+	def testPointsInRadius( self ) :
+
+		p = IECore.PointsPrimitive( 5 )
+		p["P"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ IECore.V3f( x, 0, 0 ) for x in range( 0, 5 ) ] ) )
+
+		e = IECore.PointsPrimitiveEvaluator( p )
+		self.assertEqual( sorted( e.pointsInRadius( IECore.V3f( 2, 0, 0 ), 1.5 ) ), [ 1, 2, 3 ] )
+		self.assertEqual( len( e.pointsInRadius( IECore.V3f( 2, 10, 0 ), 1.5 ) ), 0 )
+
+	def testBatchClosestPoint( self ) :
+
+		p = IECore.PointsPrimitive( 5 )
+		p["P"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ IECore.V3f( x, 0, 0 ) for x in range( 0, 5 ) ] ) )
+
+		e = IECore.PointsPrimitiveEvaluator( p )
+		r = e.batchClosestPoint( IECore.V3fVectorData( [ IECore.V3f( -1, 0, 0 ), IECore.V3f( 2.2, 1, 0 ) ] ) )
+		self.assertEqual( r["P"], IECore.V3fVectorData( [ IECore.V3f( 0 ), IECore.V3f( 2, 0, 0 ) ] ) )
+		self.assertEqual( r["success"], IECore.BoolVectorData( [ True, True ] ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
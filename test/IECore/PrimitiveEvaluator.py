@@ -45,6 +45,50 @@ class TestPrimitiveEvaluator( unittest.TestCase ) :
 	
 		self.assertRaises( ValueError, IECore.PrimitiveEvaluator.create, None )
 
+	def testBatchQueries( self ) :
+
+		m = IECore.MeshPrimitive.createSphere( 1 )
+		e = IECore.PrimitiveEvaluator.create( m )
+		r = e.createResult()
+
+		points = IECore.V3fVectorData( [ IECore.V3f( x * 0.1, 1, 2 ) for x in range( -10, 10 ) ] )
+		results = e.batchClosestPoint( points )
+		for i, p in enumerate( points ) :
+			self.assertEqual( results["success"][i], e.closestPoint( p, r ) )
+			self.assertEqual( results["P"][i], r.point() )
+			self.assertEqual( results["N"][i], r.normal() )
+			self.assertEqual( results["uv"][i], r.uv() )
+
+		# rays alternately hit and miss the sphere
+		origins = IECore.V3fVectorData( [ IECore.V3f( 0.05, 0.03, 5 ) ] * 10 )
+		directions = IECore.V3fVectorData( [ IECore.V3f( 0, x % 2, -1 ) for x in range( 0, 10 ) ] )
+		results = e.batchIntersectionPoint( origins, directions )
+		for i in range( 0, len( origins ) ) :
+			hit = e.intersectionPoint( origins[i], directions[i], r )
+			self.assertEqual( results["success"][i], hit )
+			self.assertEqual( results["success"][i], i % 2 == 0 )
+			if hit :
+				self.assertEqual( results["P"][i], r.point() )
+			else :
+				self.assertEqual( results["P"][i], IECore.V3f( 0 ) )
+
+		results = e.batchIntersectionPoint( origins, directions, maxDistance = 1 )
+		self.failIf( True in results["success"] )
+
+		self.assertRaises( Exception, e.batchIntersectionPoint, origins, IECore.V3fVectorData() )
+
+	def testBatchQueriesOnPoints( self ) :
+
+		# points don't support normals or uvs, so those should be left at zero
+		p = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( x, 0, 0 ) for x in range( 0, 5 ) ] ) )
+		e = IECore.PrimitiveEvaluator.create( p )
+
+		results = e.batchClosestPoint( IECore.V3fVectorData( [ IECore.V3f( x + 0.1, 1, 0 ) for x in range( 0, 5 ) ] ) )
+		self.assertEqual( results["success"], IECore.BoolVectorData( [ True ] * 5 ) )
+		self.assertEqual( results["P"], p["P"].data )
+		self.assertEqual( results["N"], IECore.V3fVectorData( [ IECore.V3f( 0 ) ] * 5 ) )
+		self.assertEqual( results["uv"], IECore.V2fVectorData( [ IECore.V2f( 0 ) ] * 5 ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
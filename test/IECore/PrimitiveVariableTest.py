@@ -97,6 +97,84 @@ class PrimitiveVariableTest( unittest.TestCase ) :
 		
 		self.assertEqual( p, p )
 		self.assertEqual( p2, p2 )
-				
+
+	def testIndices( self ) :
+
+		p = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( [ 1, 2 ] ) )
+		self.assertEqual( p.indices, None )
+		self.failUnless( p.expandedData().isSame( p.data ) )
+
+		p2 = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.IntVectorData( [ 1, 2 ] ),
+			IECore.IntVectorData( [ 1, 0, 0, 1 ] )
+		)
+		self.assertEqual( p2.indices, IECore.IntVectorData( [ 1, 0, 0, 1 ] ) )
+		self.assertEqual( p2.expandedData(), IECore.IntVectorData( [ 2, 1, 1, 2 ] ) )
+		self.assertNotEqual( p, p2 )
+
+		p3 = IECore.PrimitiveVariable( p2 )
+		self.failUnless( p3.indices.isSame( p2.indices ) )
+		self.assertEqual( p3, p2 )
+
+		p4 = IECore.PrimitiveVariable( p2, True ) # deep copy
+		self.failIf( p4.indices.isSame( p2.indices ) )
+		self.assertEqual( p4, p2 )
+
+		p4.indices = IECore.IntVectorData( [ 0, 0, 0, 1 ] )
+		self.assertNotEqual( p4, p2 )
+
+		p4.indices = None
+		self.assertEqual( p4, p )
+
+	def testIndexedValidity( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 2, 1 ) )
+
+		m["uniformIndexed"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Uniform,
+			IECore.FloatVectorData( [ 1 ] ),
+			IECore.IntVectorData( [ 0, 0 ] )
+		)
+		self.failUnless( m.isPrimitiveVariableValid( m["uniformIndexed"] ) )
+
+		m["tooFewIndices"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Uniform,
+			IECore.FloatVectorData( [ 1 ] ),
+			IECore.IntVectorData( [ 0 ] )
+		)
+		self.failIf( m.isPrimitiveVariableValid( m["tooFewIndices"] ) )
+
+		m["outOfRange"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Uniform,
+			IECore.FloatVectorData( [ 1 ] ),
+			IECore.IntVectorData( [ 0, 1 ] )
+		)
+		self.failIf( m.isPrimitiveVariableValid( m["outOfRange"] ) )
+
+	def testIndexedIO( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 2, 1 ) )
+		m["uv"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.FaceVarying,
+			IECore.V2fVectorData( [ IECore.V2f( 0 ), IECore.V2f( 1 ) ] ),
+			IECore.IntVectorData( [ 0, 1, 1, 0, 0, 1, 1, 0 ] )
+		)
+
+		io = IECore.MemoryIndexedIO( IECore.CharVectorData(), [], IECore.IndexedIO.OpenMode.Append )
+		m.save( io, "test" )
+		m2 = IECore.Object.load( io, "test" )
+		self.assertEqual( m2, m )
+		self.assertEqual( m2["uv"].indices, m["uv"].indices )
+
+		m3 = m.copy()
+		self.assertEqual( m3["uv"], m["uv"] )
+		self.assertEqual( m3.hash(), m.hash() )
+
+		uv = m3["uv"]
+		uv.indices = IECore.IntVectorData( [ 1, 1, 1, 0, 0, 1, 1, 0 ] )
+		m3["uv"] = uv
+		self.assertNotEqual( m3.hash(), m.hash() )
+
 if __name__ == "__main__":
     unittest.main()
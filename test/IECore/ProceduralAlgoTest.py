@@ -0,0 +1,107 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import threading
+import unittest
+import IECore
+
+class ProceduralAlgoTest( unittest.TestCase ) :
+
+	class TreeProcedural( IECore.Renderer.Procedural ) :
+
+		def __init__( self, threads, depth = 3 ) :
+
+			IECore.Renderer.Procedural.__init__( self )
+
+			self.__threads = threads
+			self.__depth = depth
+
+		def bound( self ) :
+
+			return IECore.Box3f( IECore.V3f( -1 ), IECore.V3f( 1 ) )
+
+		def render( self, renderer ) :
+
+			self.__threads.append( threading.currentThread().getName() )
+
+			if self.__depth == 0 :
+				renderer.sphere( 1, -1, 1, 360, {} )
+				return
+
+			for i in range( 0, 4 ) :
+				with IECore.AttributeBlock( renderer ) :
+					renderer.concatTransform( IECore.M44f.createTranslated( IECore.V3f( i, 0, 0 ) ) )
+					renderer.procedural( ProceduralAlgoTest.TreeProcedural( self.__threads, self.__depth - 1 ) )
+
+		def hash( self ) :
+
+			return IECore.MurmurHash()
+
+	def __countSpheres( self, group ) :
+
+		result = 0
+		for c in group.children() :
+			if isinstance( c, IECore.SpherePrimitive ) :
+				result += 1
+			else :
+				result += self.__countSpheres( c )
+
+		return result
+
+	def testExpand( self ) :
+
+		# necessary so that the threads expanding procedurals can enter python
+		IECore.initThreads()
+
+		threads = []
+		g = IECore.ProceduralAlgo.expand( self.TreeProcedural( threads ) )
+
+		self.assertTrue( isinstance( g, IECore.Group ) )
+		self.assertEqual( len( threads ), 1 + 4 + 4 ** 2 + 4 ** 3 )
+		self.assertEqual( self.__countSpheres( g ), 4 ** 3 )
+
+	def testRender( self ) :
+
+		IECore.initThreads()
+
+		r = IECore.CapturingRenderer()
+		with IECore.WorldBlock( r ) :
+			r.setAttribute( "cp:procedural:reentrant", IECore.BoolData( False ) )
+			IECore.ProceduralAlgo.render( self.TreeProcedural( [], depth = 2 ), r )
+
+		self.assertEqual( self.__countSpheres( r.world() ), 4 ** 2 )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -0,0 +1,128 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import os
+import json
+import unittest
+import IECore
+
+class ProfilingTest( unittest.TestCase ) :
+
+	__fileName = "/tmp/profilingTest.scc"
+	__traceFileName = "/tmp/profilingTest.json"
+
+	def setUp( self ) :
+
+		IECore.Profiling.setEnabled( False )
+		IECore.Profiling.clear()
+
+	def tearDown( self ) :
+
+		IECore.Profiling.setEnabled( False )
+		IECore.Profiling.clear()
+
+		for f in ( self.__fileName, self.__traceFileName ) :
+			if os.path.exists( f ) :
+				os.remove( f )
+
+	def __readScene( self ) :
+
+		m = IECore.SceneCache( self.__fileName, IECore.IndexedIO.OpenMode.Write )
+		t = m.createChild( "t" )
+		t.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( 1, 0, 0 ) ) ), 0.0 )
+		t.writeObject( IECore.SpherePrimitive( 1 ), 0.0 )
+		del m, t
+
+		m = IECore.SceneCache( self.__fileName, IECore.IndexedIO.OpenMode.Read )
+		t = m.child( "t" )
+		t.readTransformAsMatrix( 0.0 )
+		t.readObject( 0.0 )
+
+	def __events( self ) :
+
+		trace = json.loads( IECore.Profiling.chromeTrace() )
+		return trace["traceEvents"]
+
+	def testEnabled( self ) :
+
+		self.assertFalse( IECore.Profiling.getEnabled() )
+		IECore.Profiling.setEnabled( True )
+		self.assertTrue( IECore.Profiling.getEnabled() )
+		IECore.Profiling.setEnabled( False )
+		self.assertFalse( IECore.Profiling.getEnabled() )
+
+	def testDisabledRecordsNothing( self ) :
+
+		self.__readScene()
+		self.assertEqual( self.__events(), [] )
+
+	def testRecording( self ) :
+
+		IECore.Profiling.setEnabled( True )
+		self.__readScene()
+		IECore.Profiling.setEnabled( False )
+
+		events = self.__events()
+		if not IECore.Profiling.available() :
+			self.assertEqual( events, [] )
+			return
+
+		names = set( e["name"] for e in events )
+		self.failUnless( "SceneCache::readObject" in names )
+		self.failUnless( "SceneCache::readTransformAsMatrix" in names )
+		self.failUnless( "StreamIndexedIO::read" in names )
+
+		for e in events :
+			self.assertEqual( e["ph"], "X" )
+			self.failUnless( e["dur"] >= 0 )
+			self.failUnless( isinstance( e["tid"], int ) )
+
+		IECore.Profiling.clear()
+		self.assertEqual( self.__events(), [] )
+
+	def testWriteChromeTrace( self ) :
+
+		IECore.Profiling.setEnabled( True )
+		self.__readScene()
+		IECore.Profiling.setEnabled( False )
+
+		IECore.Profiling.writeChromeTrace( self.__traceFileName )
+		with open( self.__traceFileName ) as f :
+			trace = json.load( f )
+
+		self.assertEqual( trace, json.loads( IECore.Profiling.chromeTrace() ) )
+
+if __name__ == "__main__":
+	unittest.main()
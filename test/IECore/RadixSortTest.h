@@ -46,6 +46,7 @@
 #include "boost/test/floating_point_comparison.hpp"
 #include "boost/random.hpp"
 
+#include "IECore/Exception.h"
 #include "IECore/RadixSort.h"
 
 using namespace Imath;
@@ -90,6 +91,48 @@ struct RadixSortTest
 			}
 		}
 	}
+
+	void testSortPairs()
+	{
+		boost::mt19937 generator( static_cast<boost::mt19937::result_type>( 43 ) );
+
+		const unsigned numValues = 100000u;
+
+		std::vector<uint64_t> keys;
+		std::vector<unsigned int> values;
+		for ( unsigned n = 0; n < numValues; n++ )
+		{
+			keys.push_back( ( static_cast<uint64_t>( generator() ) << 32 ) | generator() );
+			values.push_back( n );
+		}
+
+		const std::vector<uint64_t> originalKeys = keys;
+
+		RadixSort sorter;
+		for ( unsigned i = 0; i < 2; i++ )
+		{
+			sorter.sortPairs( keys, values );
+
+			BOOST_CHECK_EQUAL( keys.size(), numValues );
+			BOOST_CHECK_EQUAL( values.size(), numValues );
+			for ( unsigned n = 0; n < numValues; n++ )
+			{
+				BOOST_CHECK( keys[n] == originalKeys[values[n]] );
+				if( n )
+				{
+					BOOST_CHECK( keys[n] >= keys[n - 1] );
+				}
+			}
+
+			// Perturb the sorted keys to exercise the
+			// coherence between successive calls.
+			std::swap( keys[0], keys[numValues - 1] );
+			std::swap( values[0], values[numValues - 1] );
+		}
+
+		std::vector<unsigned int> tooFewValues( 1 );
+		BOOST_CHECK_THROW( sorter.sortPairs( keys, tooFewValues ), InvalidArgumentException );
+	}
 };
 
 struct RadixSortTestSuite : public boost::unit_test::test_suite
@@ -102,6 +145,8 @@ struct RadixSortTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<float>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<unsigned int>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<int>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<double>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testSortPairs, instance ) );
 	}
 
 };
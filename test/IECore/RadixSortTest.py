@@ -95,6 +95,84 @@ class RadixSortTest( unittest.TestCase ) :
 
 			self.assert_( d[ idx[ i ] ] >= d[ idx[ i - 1 ] ] )
 
+	def test64BitKeys( self ) :
+
+		random.seed( 15 )
+
+		for d in (
+			DoubleVectorData( [ random.uniform( -1e300, 1e300 ) for i in range( 0, 10000 ) ] ),
+			Int64VectorData( [ random.randint( -2**63, 2**63 - 1 ) for i in range( 0, 10000 ) ] ),
+			UInt64VectorData( [ random.randint( 0, 2**64 - 1 ) for i in range( 0, 10000 ) ] ),
+		) :
+
+			idx = RadixSort().sort( d )
+			self.assertEqual( len( idx ), len( d ) )
+
+			for i in range( 1, len( d ) ) :
+				self.assert_( d[ idx[ i ] ] >= d[ idx[ i - 1 ] ] )
+
+	def testCoherence( self ) :
+
+		random.seed( 16 )
+
+		s = RadixSort()
+
+		# large enough to be sorted in several blocks
+		d = FloatVectorData( [ random.uniform( -1000, 1000 ) for i in range( 0, 200000 ) ] )
+
+		for iteration in range( 0, 3 ) :
+
+			idx = s.sort( d )
+			self.assertEqual( len( idx ), len( d ) )
+			self.assertEqual( len( set( idx ) ), len( d ) )
+
+			for i in range( 1, len( d ) ) :
+				self.assert_( d[ idx[ i ] ] >= d[ idx[ i - 1 ] ] )
+
+			for i in range( 0, len( d ), 100 ) :
+				d[i] += random.uniform( -1, 1 )
+
+	def testStable( self ) :
+
+		d = IntVectorData( [ 3, 1, 2, 1, 3, 2, 1 ] * 10000 )
+		idx = RadixSort().sort( d )
+
+		for i in range( 1, len( d ) ) :
+			self.assert_( d[ idx[ i ] ] >= d[ idx[ i - 1 ] ] )
+			if d[ idx[ i ] ] == d[ idx[ i - 1 ] ] :
+				self.assert_( idx[ i ] > idx[ i - 1 ] )
+
+	def testSortPairs( self ) :
+
+		random.seed( 17 )
+
+		s = RadixSort()
+
+		for keys in (
+			UIntVectorData( [ random.randint( 0, 2**32 - 1 ) for i in range( 0, 100000 ) ] ),
+			UInt64VectorData( [ random.randint( 0, 2**64 - 1 ) for i in range( 0, 100000 ) ] ),
+		) :
+
+			originalKeys = keys.copy()
+			values = UIntVectorData( range( 0, len( keys ) ) )
+
+			for iteration in range( 0, 2 ) :
+
+				s.sortPairs( keys, values )
+
+				self.assertEqual( sorted( originalKeys ), list( keys ) )
+				for i in range( 0, len( keys ) ) :
+					self.assertEqual( keys[i], originalKeys[values[i]] )
+
+			keys[0], keys[len( keys ) - 1] = keys[len( keys ) - 1], keys[0]
+			values[0], values[len( values ) - 1] = values[len( values ) - 1], values[0]
+			s.sortPairs( keys, values )
+
+			self.assertEqual( sorted( originalKeys ), list( keys ) )
+			for i in range( 0, len( keys ) ) :
+				self.assertEqual( keys[i], originalKeys[values[i]] )
+
+			self.assertRaises( Exception, s.sortPairs, keys, UIntVectorData( [ 1 ] ) )
 
 if __name__ == "__main__":
 	unittest.main()
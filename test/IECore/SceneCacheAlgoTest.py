@@ -0,0 +1,105 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import os
+import unittest
+
+import IECore
+
+class SceneCacheAlgoTest( unittest.TestCase ) :
+
+	__fileName = "/tmp/sceneCacheAlgoTest.scc"
+
+	def setUp( self ) :
+
+		m = IECore.SceneCache( self.__fileName, IECore.IndexedIO.OpenMode.Write )
+		sphere = IECore.MeshPrimitive.createSphere( 1 )
+		for name in ( "a", "b" ) :
+			c = m.createChild( name )
+			c.writeBound( IECore.Box3d( IECore.V3d( -1 ), IECore.V3d( 1 ) ), 0.0 )
+			c.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( 1, 0, 0 ) ) ), 0.0 )
+			c.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( 2, 0, 0 ) ) ), 1.0 )
+			c.writeAttribute( "visible", IECore.BoolData( True ), 0.0 )
+			c.writeObject( sphere, 0.0 )
+		del m, c
+
+	def testStorageStatistics( self ) :
+
+		s = IECore.SceneCacheAlgo.storageStatistics( self.__fileName )
+
+		self.assertEqual( s["file"]["fileSize"].value, os.path.getsize( self.__fileName ) )
+		self.assertTrue( s["file"]["indexSize"].value > 0 )
+		self.assertTrue( s["file"]["numStrings"].value > 0 )
+
+		self.assertEqual( s["totals"]["locations"].value, 3 )
+		self.assertEqual( s["totals"]["maxDepth"].value, 1 )
+		self.assertEqual( s["totals"]["transform"]["samples"].value, 4 )
+		self.assertEqual( s["totals"]["attribute:visible"]["samples"].value, 2 )
+
+		# the sphere is shared, so "/b" only stores a reference to it
+		a = s["locations"]["/a"]
+		b = s["locations"]["/b"]
+		self.assertEqual( a["object"]["samples"].value, 1 )
+		self.assertEqual( b["object"]["samples"].value, 1 )
+		self.assertTrue( b["object"]["storedSize"].value < a["object"]["storedSize"].value )
+		self.assertTrue( s["totals"]["uniqueStoredSize"].value <= s["totals"]["storedSize"].value )
+
+		s = IECore.SceneCacheAlgo.storageStatistics( self.__fileName, perLocation = False )
+		self.assertFalse( "locations" in s )
+
+	def testReadStatistics( self ) :
+
+		s = IECore.SceneCacheAlgo.readStatistics( self.__fileName, 0.5, [ 1, 2 ] )
+		self.assertEqual( set( s.keys() ), set( [ "1", "2" ] ) )
+		for r in s.values() :
+			self.assertEqual( r["child"]["calls"].value, 2 )
+			self.assertEqual( r["readBound"]["calls"].value, 3 )
+			self.assertEqual( r["readObject"]["calls"].value, 2 )
+			self.assertEqual( r["readAttribute"]["calls"].value, 2 )
+			self.assertTrue( r["readObject"]["maxTime"].value >= r["readObject"]["medianTime"].value )
+
+	def testInspectOp( self ) :
+
+		report = IECore.SceneCacheInspectOp()( file = self.__fileName, profileReads = True, threadCounts = IECore.IntVectorData( [ 1 ] ) )
+		self.assertTrue( "/a" in report.value )
+		self.assertTrue( "readObject" in report.value )
+
+	def tearDown( self ) :
+
+		if os.path.exists( self.__fileName ) :
+			os.remove( self.__fileName )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -32,6 +32,7 @@
 #
 ##########################################################################
 
+import os
 import gc
 import sys
 import math
@@ -667,6 +668,88 @@ class SceneCacheTest( unittest.TestCase ) :
 		self.assertEqual( b.readObject(1)['P'], b.readObjectPrimitiveVariables(['P','Cs'], 1)['P'] )
 		self.assertEqual( b.readObject(1)['Cs'], b.readObjectPrimitiveVariables(['P','Cs'], 1)['Cs'] )
 
+	def testObjectPrimitiveVariableRangeRead( self ) :
+
+		def points( offset ) :
+
+			p = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( i + offset ) for i in range( 0, 100 ) ] ) )
+			p["width"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ i + offset for i in range( 0, 100 ) ] ) )
+			p["name"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.StringVectorData( [ str( i ) for i in range( 0, 100 ) ] ) )
+			p["id"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( [ 0, 1 ] ), IECore.IntVectorData( [ i % 2 for i in range( 0, 100 ) ] ) )
+			p["Cs"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.Color3fData( IECore.Color3f( offset ) ) )
+			return p
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		b = s.createChild( "b" )
+		b.writeObject( points( 0 ), 0 )
+		b.writeObject( points( 10 ), 1 )
+
+		del s, b
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		b = s.child( "b" )
+
+		names = [ "P", "width", "name", "id", "Cs" ]
+		for t in ( 0, 0.5, 1 ) :
+			whole = b.readObjectPrimitiveVariables( names, t )
+			for begin, end in ( ( 0, 100 ), ( 10, 20 ), ( 90, 200 ), ( 150, 200 ) ) :
+				ranged = b.readObjectPrimitiveVariableRange( names, t, begin, end )
+				self.assertEqual( set( ranged.keys() ), set( names ) )
+				for name in ( "P", "width", "name" ) :
+					self.assertEqual( list( ranged[name].data ), list( whole[name].data )[begin:end] )
+				self.assertEqual( ranged["P"].data.getInterpretation(), whole["P"].data.getInterpretation() )
+				self.assertEqual( ranged["id"].data, whole["id"].data )
+				self.assertEqual( list( ranged["id"].indices ), list( whole["id"].indices )[begin:end] )
+				self.assertEqual( ranged["Cs"], whole["Cs"] )
+
+	def testUninterpolablePrimitiveVariablesRead( self ) :
+
+		def points( offset ) :
+
+			p = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( i + offset ) for i in range( 0, 10 ) ] ) )
+			p["name"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.StringVectorData( [ str( i + offset ) for i in range( 0, 10 ) ] ) )
+			p["flag"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.BoolData( offset == 0 ) )
+			return p
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		b = s.createChild( "b" )
+		b.writeObject( points( 0 ), 0 )
+		b.writeObject( points( 10 ), 1 )
+
+		del s, b
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		b = s.child( "b" )
+
+		# values which can't be interpolated are taken from the first sample
+		primVars = b.readObjectPrimitiveVariables( [ "P", "name", "flag" ], 0.5 )
+		self.assertEqual( primVars["P"].data, points( 5 )["P"].data )
+		self.assertEqual( primVars["name"], points( 0 )["name"] )
+		self.assertEqual( primVars["flag"], points( 0 )["flag"] )
+
+	def testUnchangedObjectSamples( self ) :
+
+		box = IECore.MeshPrimitive.createBox( IECore.Box3f( IECore.V3f( 0 ), IECore.V3f( 1 ) ) )
+		box["Cs"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Uniform, IECore.Color3fVectorData( [ IECore.Color3f( 1, 0, 0 ) ] * box.variableSize( IECore.PrimitiveVariable.Interpolation.Uniform ) ) )
+		box2 = box.copy()
+		box2["Cs"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Uniform, IECore.Color3fVectorData( [ IECore.Color3f( 0, 1, 0 ) ] * box.variableSize( IECore.PrimitiveVariable.Interpolation.Uniform ) ) )
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		b = s.createChild( "b" )
+		b.writeObject( box, 0 )
+		b.writeObject( box.copy(), 1 )
+		b.writeObject( box2, 2 )
+		b.writeObject( box2.copy(), 3 )
+
+		del s, b
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		b = s.child( "b" )
+
+		for t, expected in [ ( 0, box ), ( 1, box ), ( 2, box2 ), ( 3, box2 ) ] :
+			self.assertEqual( b.readObject( t ), expected )
+			self.assertEqual( b.readObjectPrimitiveVariables( [ "P", "Cs" ], t )["Cs"], expected["Cs"] )
+
 	def testTags( self ) :
 
 		sphere = IECore.SpherePrimitive( 1 )
@@ -823,6 +906,99 @@ class SceneCacheTest( unittest.TestCase ) :
 			self.assertAlmostEqual( r[1], 0.1 * i * math.pi * 0.5, 9 )
 			self.assertAlmostEqual( t[0], 5 + 0.5 * i, 9 )
 		
+	def testBatchReads( self ) :
+
+		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+		
+		def collectPaths( scene, paths ) :
+			paths.append( scene.path() )
+			for childName in scene.childNames() :
+				collectPaths( scene.child( childName ), paths )
+
+		paths = []
+		collectPaths( m, paths )
+		
+		for time in ( 0.0, 0.5, 1.0 ) :
+		
+			bounds = m.readBounds( paths, time )
+			transforms = m.readTransformsAsMatrices( paths, time )
+			objects = m.readObjects( paths, time )
+			
+			self.assertEqual( len( bounds ), len( paths ) )
+			self.assertEqual( len( transforms ), len( paths ) )
+			self.assertEqual( len( objects ), len( paths ) )
+			
+			for i, path in enumerate( paths ) :
+				s = m.scene( path )
+				self.assertEqual( bounds[i], s.readBound( time ) )
+				self.assertEqual( transforms[i], s.readTransformAsMatrix( time ) )
+				if s.hasObject() :
+					self.assertEqual( objects[i], s.readObject( time ) )
+				else :
+					self.assertEqual( objects[i], None )
+		
+		# string paths are accepted too
+		self.assertEqual( m.readBounds( [ "/" ], 0.0 ), [ m.readBound( 0.0 ) ] )
+		
+		self.assertRaises( RuntimeError, m.readBounds, [ [ "nonexistent" ] ], 0.0 )
+
+	def testPrefetch( self ) :
+
+		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+		
+		def collectPaths( scene, paths ) :
+			paths.append( scene.path() )
+			for childName in scene.childNames() :
+				collectPaths( scene.child( childName ), paths )
+
+		paths = []
+		collectPaths( m, paths )
+		
+		# prefetching returns immediately and ignores missing locations
+		m.prefetch( paths + [ [ "nonexistent" ] ], 0.0, 1.0 )
+		m.prefetch( [], 0.0, 1.0 )
+		
+		# and should not change what is read back
+		m2 = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+		for path in paths :
+			for time in ( 0.0, 0.25, 1.0 ) :
+				self.assertEqual( m.scene( path ).readTransformAsMatrix( time ), m2.scene( path ).readTransformAsMatrix( time ) )
+				if m2.scene( path ).hasObject() :
+					self.assertEqual( m.scene( path ).readObject( time ), m2.scene( path ).readObject( time ) )
+		
+		# the file can be closed while a prefetch is still running
+		m.prefetch( paths, 0.0, 10.0 )
+		del m
+
+	def testCacheStatistics( self ) :
+
+		IECore.SceneCache.clearCache()
+		stats = IECore.SceneCache.cacheStatistics()
+		self.assertEqual( stats["hits"], 0 )
+		self.assertEqual( stats["misses"], 0 )
+		self.assertEqual( stats["memoryUsage"], 0 )
+		
+		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+		a = m.child( "A" )
+		a.readTransformAsMatrix( 0 )
+		
+		stats = IECore.SceneCache.cacheStatistics()
+		self.assertEqual( stats["hits"], 0 )
+		self.assertEqual( stats["misses"], 1 )
+		self.assertTrue( stats["memoryUsage"] > 0 )
+		self.assertEqual( stats["memoryUsage"], IECore.SceneCache.cacheObjectPool().memoryUsage() )
+		
+		# a second reader of the same file reuses the samples loaded by the first
+		m2 = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( m2.child( "A" ).readTransformAsMatrix( 0 ), a.readTransformAsMatrix( 0 ) )
+		
+		stats = IECore.SceneCache.cacheStatistics()
+		self.assertEqual( stats["hits"], 2 )
+		self.assertEqual( stats["misses"], 1 )
+		
+		IECore.SceneCache.clearCache()
+		self.assertEqual( IECore.SceneCache.cacheStatistics()["memoryUsage"], 0 )
+
 	def testHashes( self ):
 
 		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
@@ -874,8 +1050,298 @@ class SceneCacheTest( unittest.TestCase ) :
 		t0 = checkHash( IECore.SceneInterface.HashType.HierarchyHash, m, 0 )
 		t1 = checkHash( IECore.SceneInterface.HashType.HierarchyHash, m, 1 )
 		self.assertEqual( t0[0] + t1[0], len(t0[1].union(t1[1])) )		# all locations differ
-	
-	
+
+	def testGeometryCompression( self ) :
+
+		mesh = IECore.MeshPrimitive.createSphere( 1, divisions = IECore.V2i( 60, 120 ) )
+		mesh["uv"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V2fVectorData( [ IECore.V2f( s, t ) for s, t in zip( mesh["s"].data, mesh["t"].data ) ] )
+		)
+		mesh["Cs"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.Color3fData( IECore.Color3f( 1, 0, 0 ) ) )
+
+		sizes = {}
+		for compress in ( False, True ) :
+
+			fileName = "/tmp/test%s.scc" % ( "Compressed" if compress else "" )
+			m = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+			self.assertEqual( m.getGeometryCompression(), False )
+			m.setGeometryCompression( compress )
+			self.assertEqual( m.getGeometryCompression(), compress )
+			m.createChild( "sphere" ).writeObject( mesh, 0 )
+			del m
+
+			sizes[compress] = os.path.getsize( fileName )
+
+			m = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Read )
+			self.assertRaises( RuntimeError, m.getGeometryCompression )
+			sphere = m.child( "sphere" )
+			result = sphere.readObject( 0 )
+			self.failUnless( result.arePrimitiveVariablesValid() )
+			self.assertEqual( sorted( result.keys() ), sorted( mesh.keys() ) )
+			self.assertEqual( result["Cs"], mesh["Cs"] )
+			self.assertEqual( result.verticesPerFace, mesh.verticesPerFace )
+			self.assertEqual( result.vertexIds, mesh.vertexIds )
+			self.assertEqual( result["P"].data.getInterpretation(), mesh["P"].data.getInterpretation() )
+			self.assertEqual( result["N"].data.getInterpretation(), mesh["N"].data.getInterpretation() )
+
+			for i in range( 0, len( mesh["P"].data ) ) :
+				self.failUnless( result["P"].data[i].equalWithAbsError( mesh["P"].data[i], 1e-4 ) )
+				self.failUnless( result["N"].data[i].equalWithAbsError( mesh["N"].data[i], 1e-4 ) )
+				self.failUnless( result["uv"].data[i].equalWithAbsError( mesh["uv"].data[i], 1e-4 ) )
+				self.assertAlmostEqual( result["s"].data[i], mesh["s"].data[i], 4 )
+				self.assertAlmostEqual( result["t"].data[i], mesh["t"].data[i], 4 )
+
+			primVars = sphere.readObjectPrimitiveVariables( [ "P", "N" ], 0 )
+			self.assertEqual( primVars["P"].data, result["P"].data )
+			self.assertEqual( primVars["N"].data, result["N"].data )
+
+		self.failUnless( sizes[True] < sizes[False] )
+
+	def testGeometryCompressionPreservesNonUVs( self ) :
+
+		mesh = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 10 ) )
+		mesh["offset"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V2fVectorData( [ IECore.V2f( p.x * 1000.123, p.y * 0.000123 ) for p in mesh["P"].data ] )
+		)
+
+		m = IECore.SceneCache( "/tmp/testCompressed.scc", IECore.IndexedIO.OpenMode.Write )
+		m.setGeometryCompression( True )
+		m.createChild( "plane" ).writeObject( mesh, 0 )
+		del m
+
+		m = IECore.SceneCache( "/tmp/testCompressed.scc", IECore.IndexedIO.OpenMode.Read )
+		result = m.child( "plane" ).readObject( 0 )
+		self.assertEqual( result["offset"], mesh["offset"] )
+
+	def testObjectDeduplication( self ) :
+
+		sphere = IECore.MeshPrimitive.createSphere( 1, divisions = IECore.V2i( 30, 60 ) )
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 30 ) )
+
+		for shared in ( False, True ) :
+
+			fileName = "/tmp/test%s.scc" % ( "Shared" if shared else "" )
+			m = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+			m.createChild( "a" ).writeObject( sphere, 0 )
+			m.createChild( "b" ).writeObject( sphere if shared else plane, 0 )
+			m.createChild( "c" ).writeObject( plane, 0 )
+			del m
+
+			m = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Read )
+			a = m.child( "a" )
+			b = m.child( "b" )
+			c = m.child( "c" )
+
+			self.assertEqual( a.readObject( 0 ), sphere )
+			self.assertEqual( b.readObject( 0 ), sphere if shared else plane )
+			self.assertEqual( c.readObject( 0 ), plane )
+			self.assertEqual( b.readObjectPrimitiveVariables( [ "P" ], 0 )["P"], ( sphere if shared else plane )["P"] )
+
+			objectHash = IECore.SceneInterface.HashType.ObjectHash
+			self.assertEqual( a.hash( objectHash, 0 ) == b.hash( objectHash, 0 ), shared )
+			self.assertEqual( b.hash( objectHash, 0 ) == c.hash( objectHash, 0 ), not shared )
+			self.assertNotEqual( a.hash( objectHash, 0 ), c.hash( objectHash, 0 ) )
+
+	def testLocationIndex( self ) :
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		a = m.createChild( "a" )
+		a.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( 10, 0, 0 ) ) ), 0 )
+		a.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( 20, 0, 0 ) ) ), 1 )
+		a.writeTags( [ "geometry" ] )
+		b = a.createChild( "b" )
+		b.writeObject( IECore.SpherePrimitive( 1 ), 0 )
+		b.writeTags( [ "geometry", "sphere" ] )
+		c = m.createChild( "c" )
+		c.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( -10, 0, 0 ) ) ), 0 )
+		c.createChild( "d" ).writeObject( IECore.SpherePrimitive( 1 ), 0 )
+		del m, a, b, c
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+
+		self.assertEqual( sorted( m.taggedLocations( "geometry" ) ), [ "/a", "/a/b" ] )
+		self.assertEqual( m.taggedLocations( "sphere" ), [ "/a/b" ] )
+		self.assertEqual( m.taggedLocations( "notATag" ), [] )
+		self.assertEqual( m.scene( [ "a", "b" ] ).taggedLocations( "geometry" ), [ "/a/b" ] )
+		self.assertEqual( m.child( "c" ).taggedLocations( "geometry" ), [] )
+		self.assertEqual( m.taggedLocations( "ObjectType:SpherePrimitive" ), [ "/a/b", "/c/d" ] )
+
+		def intersecting( scene, bound ) :
+			return sorted( scene.locationsIntersecting( IECore.Box3d( IECore.V3d( bound[0] ), IECore.V3d( bound[1] ) ) ) )
+
+		self.assertEqual( intersecting( m, ( -1, 1 ) ), [ "/" ] )
+		self.assertEqual( intersecting( m, ( 9, 11 ) ), [ "/", "/a", "/a/b" ] )
+		# the animated location is found at any time
+		self.assertEqual( intersecting( m, ( 14, 16 ) ), [ "/", "/a", "/a/b" ] )
+		self.assertEqual( intersecting( m, ( -11, -9 ) ), [ "/", "/c", "/c/d" ] )
+		self.assertEqual( intersecting( m.child( "a" ), ( -11, -9 ) ), [] )
+		self.assertEqual( intersecting( m, ( 100, 101 ) ), [] )
+
+	def testLocationIndexFallback( self ) :
+
+		# this file was written before the index was introduced, so it must be traversed
+		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+
+		def collect( scene, tag, result ) :
+			if scene.hasTag( tag ) :
+				result.append( IECore.SceneInterface.pathToString( scene.path() ) )
+			for n in scene.childNames() :
+				collect( scene.child( n ), tag, result )
+			return result
+
+		for tag in m.readTags( IECore.SceneInterface.TagFilter.EveryTag ) :
+			self.assertEqual( sorted( m.taggedLocations( tag ) ), sorted( collect( m, tag, [] ) ) )
+
+		everything = IECore.Box3d( IECore.V3d( -1e10 ), IECore.V3d( 1e10 ) )
+		boundedLocations = []
+		def collectBounded( scene ) :
+			if scene.numBoundSamples() :
+				boundedLocations.append( IECore.SceneInterface.pathToString( scene.path() ) )
+			for n in scene.childNames() :
+				collectBounded( scene.child( n ) )
+		collectBounded( m )
+		self.assertEqual( sorted( m.locationsIntersecting( everything ) ), sorted( boundedLocations ) )
+		self.assertEqual( m.locationsIntersecting( IECore.Box3d( IECore.V3d( 1e9 ), IECore.V3d( 1e10 ) ) ), [] )
+
+	def testDenseSampleIntervals( self ) :
+
+		# uniformly sampled, and irregularly sampled after frame 5
+		times = [ i / 10.0 for i in range( 0, 50 ) ] + [ 5, 5.01, 5.5, 7, 7.25, 10 ]
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		t = m.createChild( "t" )
+		for time in times :
+			t.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( time, 0, 0 ) ) ), time )
+			t.writeObject( IECore.IntData( int( round( time * 100 ) ) ), time )
+		del m, t
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		t = m.child( "t" )
+
+		def expectedInterval( time ) :
+			if time <= times[0] :
+				return ( 0, 0, 0 )
+			if time > times[-1] :
+				return ( 0, len( times ) - 1, len( times ) - 1 )
+			ceilIndex = [ i for i in range( 0, len( times ) ) if time <= times[i] ][0]
+			x = ( time - times[ceilIndex-1] ) / ( times[ceilIndex] - times[ceilIndex-1] )
+			x = 0 if x < 1e-4 else ( 1 if x > 1 - 1e-4 else x )
+			return ( x, ceilIndex - 1, ceilIndex )
+
+		for i in range( -10, 1100 ) :
+			time = i / 100.0
+			interval = t.transformSampleInterval( time )
+			expected = expectedInterval( time )
+			self.assertEqual( interval[1:], expected[1:] )
+			self.assertAlmostEqual( interval[0], expected[0] )
+
+		sampleTimes, transforms = t.readTransformSamples( 1.05, 1.35 )
+		self.assertEqual( len( sampleTimes ), 5 )
+		for sampleTime, expectedTime, transform in zip( sampleTimes, [ 1.0, 1.1, 1.2, 1.3, 1.4 ], transforms ) :
+			self.assertAlmostEqual( sampleTime, expectedTime )
+			self.assertAlmostEqual( transform.translation().x, expectedTime )
+
+		sampleTimes, objects = t.readObjectSamples( 5.2, 7 )
+		self.assertEqual( sampleTimes, [ 5.01, 5.5, 7 ] )
+		self.assertEqual( objects, [ IECore.IntData( 501 ), IECore.IntData( 550 ), IECore.IntData( 700 ) ] )
+
+		self.assertEqual( t.readObjectSamples( -10, -5 ), ( [ 0 ], [ IECore.IntData( 0 ) ] ) )
+		self.assertEqual( m.readObjectSamples( 0, 1 ), ( [], [] ) )
+		self.assertRaises( RuntimeError, t.readObjectSamples, 2, 1 )
+
+	def testTraverse( self ) :
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		a = m.createChild( "a" )
+		a.writeObject( IECore.SpherePrimitive( 1 ), 0 )
+		a.createChild( "b" ).createChild( "c" )
+		a.createChild( "d" )
+		m.createChild( "e" )
+		del m, a
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+
+		visited = []
+		def visit( scene, path ) :
+			self.assertEqual( scene.path(), path )
+			visited.append( ( IECore.SceneInterface.pathToString( path ), scene.hasObject() ) )
+
+		m.traverse( visit )
+		self.assertEqual(
+			sorted( visited ),
+			[ ( "/", False ), ( "/a", True ), ( "/a/b", False ), ( "/a/b/c", False ), ( "/a/d", False ), ( "/e", False ) ]
+		)
+
+		# returning False prunes the children of a location
+		visited = []
+		def prune( scene, path ) :
+			visited.append( IECore.SceneInterface.pathToString( path ) )
+			return path != [ "a", "b" ]
+
+		m.traverse( prune )
+		self.assertEqual( sorted( visited ), [ "/", "/a", "/a/b", "/a/d", "/e" ] )
+
+		# traversals may start below the root
+		visited = []
+		m.child( "a" ).traverse( prune )
+		self.assertEqual( sorted( visited ), [ "/a", "/a/b", "/a/d" ] )
+
+	def testBoundsForLargeHierarchy( self ) :
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		for i in range( 0, 20 ) :
+			c = m.createChild( str( i ) )
+			c.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( i, 0, 0 ) ) ), 0.0 )
+			for j in range( 0, 20 ) :
+				g = c.createChild( str( j ) )
+				g.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( 0, j, 0 ) ) ), 0.0 )
+				g.writeObject( IECore.SpherePrimitive( 1 ), 0.0 )
+				g.writeObject( IECore.SpherePrimitive( 2 ), 1.0 )
+
+		del m, c, g
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( m.readBound( 0.0 ), IECore.Box3d( IECore.V3d( -1 ), IECore.V3d( 20, 20, 1 ) ) )
+		self.assertEqual( m.readBound( 1.0 ), IECore.Box3d( IECore.V3d( -2 ), IECore.V3d( 21, 21, 2 ) ) )
+
+		for i in range( 0, 20 ) :
+			c = m.child( str( i ) )
+			self.assertEqual( c.readBound( 0.5 ), IECore.Box3d( IECore.V3d( -1.5 ), IECore.V3d( 1.5, 20.5, 1.5 ) ) )
+
+	def testRewrittenFileIsReloaded( self ) :
+
+		# rewriting a file immediately with contents of the same size
+		# must not leave readers with stale data from the caches.
+		for radius in ( 1, 2, 3 ) :
+
+			m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+			m.createChild( "a" ).writeObject( IECore.SpherePrimitive( radius ), 0.0 )
+			del m
+
+			m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+			self.assertEqual( m.child( "a" ).readObject( 0.0 ).radius(), radius )
+			del m
+
+	def testClose( self ) :
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		a = m.createChild( "a" )
+		a.writeObject( IECore.SpherePrimitive( 1 ), 0.0 )
+
+		self.assertRaises( RuntimeError, a.close )
+		m.close()
+
+		self.assertRaises( RuntimeError, m.close )
+		self.assertRaises( RuntimeError, m.createChild, "b" )
+
+		del m, a
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( m.child( "a" ).readObject( 0.0 ), IECore.SpherePrimitive( 1 ) )
+		self.assertEqual( m.readBound( 0.0 ), IECore.Box3d( IECore.V3d( -1 ), IECore.V3d( 1 ) ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
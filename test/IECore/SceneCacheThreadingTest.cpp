@@ -34,10 +34,16 @@
 
 #include <vector>
 #include <iostream>
+#include <cstdio>
 
 #include "tbb/tbb.h"
 
 #include "IECore/SharedSceneInterfaces.h"
+#include "IECore/SceneCache.h"
+#include "IECore/MeshPrimitive.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/VisibleRenderable.h"
+#include "IECore/NullMessageHandler.h"
 
 #include "SceneCacheThreadingTest.h"
 
@@ -48,6 +54,58 @@ using namespace tbb;
 namespace IECore
 {
 
+/// A VisibleRenderable whose bound can't be computed, used to make
+/// the background tasks saving objects fail.
+class UnboundableRenderable : public VisibleRenderable
+{
+
+	public :
+
+		IE_CORE_DECLAREEXTENSIONOBJECT( UnboundableRenderable, FirstExtensionTypeId + 1000, VisibleRenderable );
+
+		virtual void render( Renderer *renderer ) const
+		{
+		}
+
+		virtual Imath::Box3f bound() const
+		{
+			throw Exception( "Unboundable" );
+		}
+
+};
+
+IE_CORE_DEFINEOBJECTTYPEDESCRIPTION( UnboundableRenderable );
+
+bool UnboundableRenderable::isEqualTo( const Object *other ) const
+{
+	return VisibleRenderable::isEqualTo( other );
+}
+
+void UnboundableRenderable::hash( MurmurHash &h ) const
+{
+	VisibleRenderable::hash( h );
+}
+
+void UnboundableRenderable::copyFrom( const Object *other, CopyContext *context )
+{
+	VisibleRenderable::copyFrom( other, context );
+}
+
+void UnboundableRenderable::save( SaveContext *context ) const
+{
+	VisibleRenderable::save( context );
+}
+
+void UnboundableRenderable::load( LoadContextPtr context )
+{
+	VisibleRenderable::load( context );
+}
+
+void UnboundableRenderable::memoryUsage( MemoryAccumulator &a ) const
+{
+	VisibleRenderable::memoryUsage( a );
+}
+
 struct SceneCacheThreadingTest
 {
 	
@@ -113,6 +171,109 @@ struct SceneCacheThreadingTest
  		BOOST_CHECK( task.errors() == 0 );
 	}
 	
+	struct WriteLocations
+	{
+		public :
+
+			WriteLocations( std::vector<SceneInterfacePtr> &locations ) : m_locations( locations )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				for ( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					for ( size_t t = 0; t < 5; t++ )
+					{
+						Imath::M44d m;
+						m.setTranslation( Imath::V3d( i, t, 0 ) );
+						M44dDataPtr transform = new M44dData( m );
+						m_locations[i]->writeTransform( transform.get(), t );
+						MeshPrimitivePtr mesh = MeshPrimitive::createBox( Imath::Box3f( Imath::V3f( 0 ), Imath::V3f( i + 1 ) ) );
+						m_locations[i]->writeObject( mesh.get(), t );
+					}
+				}
+			}
+
+		private :
+
+			std::vector<SceneInterfacePtr> &m_locations;
+	};
+
+	void testParallelWrite()
+	{
+		task_scheduler_init scheduler( 16 );
+
+		const size_t numLocations = 200;
+		const char *fileName = "test/IECore/parallelWrite.scc";
+
+		{
+			SceneInterfacePtr root = new SceneCache( fileName, IndexedIO::Write );
+			std::vector<SceneInterfacePtr> locations;
+			for ( size_t i = 0; i < numLocations; i++ )
+			{
+				locations.push_back( root->createChild( SceneInterface::Name( (int64_t)i ) ) );
+			}
+
+			parallel_for( blocked_range<size_t>( 0, numLocations ), WriteLocations( locations ) );
+		}
+
+		ConstSceneInterfacePtr root = new SceneCache( fileName, IndexedIO::Read );
+		SceneInterface::NameList childNames;
+		root->childNames( childNames );
+		BOOST_CHECK_EQUAL( childNames.size(), numLocations );
+
+		for ( size_t i = 0; i < numLocations; i++ )
+		{
+			ConstSceneInterfacePtr location = root->child( SceneInterface::Name( (int64_t)i ) );
+			BOOST_CHECK_EQUAL( location->numObjectSamples(), 5u );
+			BOOST_CHECK_EQUAL( location->numTransformSamples(), 5u );
+			for ( size_t t = 0; t < 5; t++ )
+			{
+				ConstMeshPrimitivePtr mesh = runTimeCast<const MeshPrimitive>( location->readObjectAtSample( t ) );
+				BOOST_CHECK( mesh );
+				BOOST_CHECK( mesh->bound() == Imath::Box3f( Imath::V3f( 0 ), Imath::V3f( i + 1 ) ) );
+				BOOST_CHECK( location->readTransformAsMatrixAtSample( t ).translation() == Imath::V3d( i, t, 0 ) );
+				BOOST_CHECK( location->readBoundAtSample( t ) == Imath::Box3d( Imath::V3d( 0 ), Imath::V3d( i + 1 ) ) );
+			}
+		}
+
+		// the last location has the largest box and offset
+		const Imath::Box3d rootBound = root->readBound( 4 );
+		BOOST_CHECK( rootBound.max.x >= 2 * numLocations - 1 - 1e-6 );
+		BOOST_CHECK( rootBound.max.y >= numLocations + 4 - 1e-6 );
+
+		root = 0;
+		SharedSceneInterfaces::clear();
+		std::remove( fileName );
+	}
+
+	void testObjectWriteError()
+	{
+		const char *fileName = "test/IECore/objectWriteError.scc";
+
+		{
+			// the destructor logs the error again, since the file is left unfinished.
+			NullMessageHandlerPtr nullHandler = new NullMessageHandler;
+			MessageHandler::Scope handlerScope( nullHandler.get() );
+
+			SceneCachePtr root = new SceneCache( fileName, IndexedIO::Write );
+			SceneInterfacePtr location = root->createChild( "a" );
+			ObjectPtr object = new UnboundableRenderable;
+			location->writeObject( object.get(), 0 );
+
+			// the error from the background task is thrown by close()
+			BOOST_CHECK_THROW( root->close(), Exception );
+
+			// and by any further writes
+			M44dDataPtr transform = new M44dData;
+			BOOST_CHECK_THROW( location->writeTransform( transform.get(), 0 ), Exception );
+			BOOST_CHECK_THROW( root->createChild( "b" ), Exception );
+		}
+
+		std::remove( fileName );
+	}
+
 	void testFakeAttributeRead()
 	{
 		task_scheduler_init scheduler( 100 );
@@ -134,6 +295,8 @@ struct SceneCacheThreadingTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &SceneCacheThreadingTest::testAttributeRead, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &SceneCacheThreadingTest::testFakeAttributeRead, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SceneCacheThreadingTest::testParallelWrite, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SceneCacheThreadingTest::testObjectWriteError, instance ) );
 	}
 };
 
@@ -53,5 +53,20 @@ class SummedAreaOpTest( unittest.TestCase ) :
 		self.assertEqual( yy[2], 4 )
 		self.assertEqual( yy[3], 10 )
 
+	def testLargeImage( self ) :
+
+		b = IECore.Box2i( IECore.V2i( -10, 5 ), IECore.V2i( 989, 1004 ) )
+		i = IECore.ImagePrimitive( b, b )
+		i["Y"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 1 ] * 1000 * 1000 ) )
+
+		ii = IECore.SummedAreaOp()( input=i, channels=IECore.StringVectorData( ["Y"] ) )
+
+		yy = ii["Y"].data
+		self.assertEqual( yy[0], 1 )
+		self.assertEqual( yy[999], 1000 )
+		self.assertEqual( yy[1000], 2 )
+		self.assertEqual( yy[1000*500+499], 500 * 501 )
+		self.assertEqual( yy[-1], 1000 * 1000 )
+
 if __name__ == "__main__":
     unittest.main()
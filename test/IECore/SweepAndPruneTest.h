@@ -41,6 +41,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <set>
 
 #include "boost/test/unit_test.hpp"
 #include "boost/test/floating_point_comparison.hpp"
@@ -166,6 +167,145 @@ struct SweepAndPruneTest
 			}
 		}
 	}
+
+	template<typename T>
+	std::vector<T> randomBounds( boost::mt19937 &generator, unsigned numBoxes, float worldSize )
+	{
+		typedef typename BoxTraits<T>::BaseType VecType;
+
+		boost::uniform_real<> uni_dist( 0.0f, 1.0f );
+		boost::variate_generator<boost::mt19937&, boost::uniform_real<> > uni( generator, uni_dist );
+
+		std::vector<T> result;
+		for ( unsigned n = 0; n < numBoxes; n++ )
+		{
+			VecType corner( uni() * worldSize, uni() * worldSize * 0.5, uni() * worldSize * 0.25 );
+			VecType size( uni(), uni(), uni() );
+
+			T b;
+			b.extendBy( corner );
+			b.extendBy( corner + size );
+			result.push_back( b );
+		}
+
+		return result;
+	}
+
+	template<typename T>
+	std::set< std::pair< unsigned int, unsigned int > > bruteForceIntersections( const std::vector<T> &bounds )
+	{
+		std::set< std::pair< unsigned int, unsigned int > > result;
+		for ( unsigned i = 0; i < bounds.size(); i++ )
+		{
+			for ( unsigned j = 0; j < bounds.size(); j++ )
+			{
+				if ( i != j && bounds[i].intersects( bounds[j] ) )
+				{
+					result.insert( std::pair< unsigned int, unsigned int >( i, j ) );
+				}
+			}
+		}
+		return result;
+	}
+
+	template<typename T>
+	void testAllPairs()
+	{
+		boost::mt19937 generator( static_cast<boost::mt19937::result_type>( 43 ) );
+
+		typedef typename std::vector<T>::iterator BoundIterator;
+		typedef SweepAndPrune<BoundIterator, TestCallback> SAP;
+
+		std::vector<T> input = randomBounds<T>( generator, 1000, 10.0f );
+		// include some coincident and touching bounds
+		input.push_back( input[0] );
+		input.push_back( T( input[1].max, input[1].max + typename BoxTraits<T>::BaseType( 1 ) ) );
+
+		const typename TestCallback<BoundIterator>::IntersectingBoundIndices expected = bruteForceIntersections( input );
+
+		typename SAP::AxisOrder axisOrders[] = { SAP::XYZ, SAP::XZY, SAP::YXZ, SAP::YZX, SAP::ZXY, SAP::ZYX, SAP::Automatic };
+		for ( unsigned i = 0; i < sizeof( axisOrders ) / sizeof( axisOrders[0] ); i++ )
+		{
+			SAP sap;
+			typename SAP::Callback cb( input.begin(), input.size() );
+			sap.intersectingBounds( input.begin(), input.end(), cb, axisOrders[i] );
+			BOOST_CHECK( cb.m_indices == expected );
+		}
+	}
+
+	template<typename T>
+	void testIncremental()
+	{
+		boost::mt19937 generator( static_cast<boost::mt19937::result_type>( 44 ) );
+
+		boost::uniform_real<> uni_dist( -0.05f, 0.05f );
+		boost::variate_generator<boost::mt19937&, boost::uniform_real<> > uni( generator, uni_dist );
+
+		typedef typename std::vector<T>::iterator BoundIterator;
+		typedef SweepAndPrune<BoundIterator, TestCallback> SAP;
+
+		SAP sap;
+		BOOST_CHECK( !sap.getIncremental() );
+		sap.setIncremental( true );
+		BOOST_CHECK( sap.getIncremental() );
+
+		std::vector<T> input = randomBounds<T>( generator, 1000, 10.0f );
+		for ( unsigned frame = 0; frame < 10; frame++ )
+		{
+			typename SAP::Callback cb( input.begin(), input.size() );
+			sap.intersectingBounds( input.begin(), input.end(), cb, SAP::XZY );
+			BOOST_CHECK( cb.m_indices == bruteForceIntersections( input ) );
+
+			// Move the bounds a little, as if animating. The final frame
+			// is incoherent with the others, to exercise the fallback to
+			// a full sort.
+			if ( frame == 8 )
+			{
+				std::reverse( input.begin(), input.end() );
+				continue;
+			}
+
+			for ( typename std::vector<T>::iterator it = input.begin(); it != input.end(); ++it )
+			{
+				typename BoxTraits<T>::BaseType offset( uni(), uni(), uni() );
+				it->min += offset;
+				it->max += offset;
+			}
+		}
+	}
+
+	template<typename T>
+	void testManyBounds()
+	{
+		// Enough bounds to be swept in several batches. Rather than test
+		// against brute force, we check that all axis orders agree, since
+		// each sweeps the bounds in a completely different order.
+
+		boost::mt19937 generator( static_cast<boost::mt19937::result_type>( 45 ) );
+
+		typedef typename std::vector<T>::iterator BoundIterator;
+		typedef SweepAndPrune<BoundIterator, TestCallback> SAP;
+
+		std::vector<T> input = randomBounds<T>( generator, 150000, 150.0f );
+
+		typename TestCallback<BoundIterator>::IntersectingBoundIndices expected;
+		typename SAP::AxisOrder axisOrders[] = { SAP::XYZ, SAP::YZX, SAP::ZXY, SAP::Automatic };
+		for ( unsigned i = 0; i < sizeof( axisOrders ) / sizeof( axisOrders[0] ); i++ )
+		{
+			SAP sap;
+			typename SAP::Callback cb( input.begin(), input.size() );
+			sap.intersectingBounds( input.begin(), input.end(), cb, axisOrders[i] );
+			BOOST_CHECK( cb.m_indices.size() );
+			if ( i == 0 )
+			{
+				expected = cb.m_indices;
+			}
+			else
+			{
+				BOOST_CHECK( cb.m_indices == expected );
+			}
+		}
+	}
 };
 
 struct SweepAndPruneTestSuite : public boost::unit_test::test_suite
@@ -177,6 +317,10 @@ struct SweepAndPruneTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::test<Imath::Box3f>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::test<Imath::Box3d>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::testAllPairs<Imath::Box3f>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::testAllPairs<Imath::Box3d>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::testIncremental<Imath::Box3f>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::testManyBounds<Imath::Box3f>, instance ) );
 	}
 
 };
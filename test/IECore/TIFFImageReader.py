@@ -406,6 +406,49 @@ class TestTIFFReader(unittest.TestCase):
 
 		self.failIf( res.value )
 		
+	def testTiledDataWindowRead( self ) :
+
+		r = TIFFImageReader( "test/IECore/data/tiff/tilesWithLeftovers.tif" )
+		r['colorSpace'] = 'linear'
+		full = r.read()
+
+		# a window straddling several tiles, including the leftovers at the edge
+		dataWindow = Box2i( V2i( 10, 20 ), full.dataWindow.max - V2i( 1 ) )
+		r['dataWindow'] = Box2iData( dataWindow )
+		window = r.read()
+		self.assertEqual( window.dataWindow, dataWindow )
+
+		fullWidth = full.dataWindow.size().x + 1
+		windowWidth = dataWindow.size().x + 1
+		for c in full.channelNames() :
+			for y in range( dataWindow.min.y, dataWindow.max.y + 1, 7 ) :
+				for x in range( dataWindow.min.x, dataWindow.max.x + 1, 5 ) :
+					self.assertEqual(
+						window[c].data[(y-dataWindow.min.y)*windowWidth + x - dataWindow.min.x],
+						full[c].data[y*fullWidth + x]
+					)
+
+	def testParallelDecoding( self ) :
+
+		# large enough to be decoded in parallel
+		size = 512
+		dataWindow = Box2i( V2i( 0 ), V2i( size - 1 ) )
+		image = ImagePrimitive( dataWindow, dataWindow )
+		for i, c in enumerate( [ "R", "G", "B" ] ) :
+			image[c] = PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, FloatVectorData( [ float( ( x * ( i + 1 ) ) % size ) / size for x in range( 0, size * size ) ] ) )
+
+		w = Writer.create( image, "test/IECore/data/tiff/parallel.tif" )
+		w["colorSpace"] = "linear"
+		w["bitdepth"].setNumericValue( 32 )
+		w.write()
+
+		r = TIFFImageReader( "test/IECore/data/tiff/parallel.tif" )
+		r['colorSpace'] = 'linear'
+		image2 = r.read()
+
+		for c in [ "R", "G", "B" ] :
+			self.assertEqual( image2[c].data, image[c].data )
+
 	def testReadWithIncorrectExtension( self ) :
 	
 		shutil.copyfile( "test/IECore/data/tiff/uvMap.512x256.8bit.tif", "test/IECore/data/tiff/uvMap.512x256.8bit.dpx" )
@@ -456,6 +499,7 @@ class TestTIFFReader(unittest.TestCase):
 	
 		for f in [
 			 "test/IECore/data/tiff/uvMap.512x256.8bit.dpx",
+			 "test/IECore/data/tiff/parallel.tif",
 		] :
 			if os.path.exists( f ) :
 				os.remove( f )
@@ -263,6 +263,88 @@ class ThreadingTest( unittest.TestCase ) :
 		runThread = False
 		newThread.join()
 
+	@unittest.skipIf( "TRAVIS" in os.environ, "Low hardware concurrency on Travis" )
+	def testMeshPrimitiveEvaluatorGains( self ) :
+
+		## Checks that building the acceleration structures for several
+		# MeshPrimitiveEvaluators in parallel gives a speedup.
+
+		meshes = [
+			IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 300 ) )
+			for i in range( 0, 4 )
+		]
+
+		calls = [ lambda m : IECore.MeshPrimitiveEvaluator( m ) ] * len( meshes )
+		args = [ ( m, ) for m in meshes ]
+
+		tStart = time.time()
+		self.callSomeThings( calls, args, threaded=False )
+		nonThreadedTime = time.time() - tStart
+
+		tStart = time.time()
+		self.callSomeThings( calls, args, threaded=True )
+		threadedTime = time.time() - tStart
+
+		self.failUnless( threadedTime < nonThreadedTime ) # may fail on single core machines or machines under varying load
+
+	@unittest.skipIf( "TRAVIS" in os.environ, "Low hardware concurrency on Travis" )
+	def testObjectSaveGains( self ) :
+
+		## Checks that saving several objects in parallel gives a speedup.
+
+		mesh = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 300 ) )
+
+		def save( o ) :
+
+			for i in range( 0, 5 ) :
+				o.save( IECore.MemoryIndexedIO( IECore.CharVectorData(), [], IECore.IndexedIO.OpenMode.Write ), "o" )
+
+		calls = [ save ] * 4
+		args = [ ( mesh.copy(), ) for c in calls ]
+
+		tStart = time.time()
+		self.callSomeThings( calls, args, threaded=False )
+		nonThreadedTime = time.time() - tStart
+
+		tStart = time.time()
+		self.callSomeThings( calls, args, threaded=True )
+		threadedTime = time.time() - tStart
+
+		self.failUnless( threadedTime < nonThreadedTime ) # may fail on single core machines or machines under varying load
+
+	def testSceneCacheConcurrency( self ) :
+
+		## Checks that we can read from a SceneCache from many threads
+		# at once, with the GIL released during the reads.
+
+		fileName = "/tmp/threadingTest.scc"
+
+		mesh = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 10 ) )
+
+		m = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+		for i in range( 0, 20 ) :
+			c = m.createChild( str( i ) )
+			c.writeObject( mesh, 0 )
+			c.writeTransform( IECore.M44dData( IECore.M44d().translate( IECore.V3d( i, 0, 0 ) ) ), 0 )
+		del m, c
+
+		scene = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Read )
+
+		def read( name ) :
+
+			c = scene.child( name )
+			self.assertEqual( c.readObject( 0 ), mesh )
+			self.assertEqual( c.readTransformAsMatrix( 0 ), IECore.M44d().translate( IECore.V3d( int( name ), 0, 0 ) ) )
+			c.readBound( 0 )
+			c.hash( IECore.SceneInterface.HashType.ObjectHash, 0 )
+
+		calls = [ read ] * 20
+		args = [ ( str( i ), ) for i in range( 0, 20 ) ]
+
+		self.callSomeThings( calls, args, threaded=True, iterations=5 )
+
+		os.remove( fileName )
+
 	def tearDown( self ) :
 		
 		for f in [
@@ -264,5 +264,70 @@ class TestTriangulateOp( unittest.TestCase ) :
 	
 		self.assertEqual( m.interpolation, "catmullClark" )
 
+	def testMixedFaceSizes( self ) :
+
+		# a pentagon, a triangle and a quad
+		verticesPerFace = IntVectorData( [ 5, 3, 4 ] )
+		vertexIds = IntVectorData( [ 0, 1, 2, 3, 4, 1, 5, 2, 5, 6, 7, 2 ] )
+		P = V3fVectorData( [
+			V3f( 0, 0, 0 ), V3f( 2, 0, 0 ), V3f( 2, 2, 0 ), V3f( 1, 3, 0 ), V3f( 0, 2, 0 ),
+			V3f( 3, 1, 0 ), V3f( 4, 2, 0 ), V3f( 3, 3, 0 )
+		] )
+
+		m = MeshPrimitive( verticesPerFace, vertexIds, "linear", P )
+		m["fv"] = PrimitiveVariable( PrimitiveVariable.Interpolation.FaceVarying, IntVectorData( range( 0, 12 ) ) )
+		m["uniform"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Uniform, FloatVectorData( [ 1, 2, 3 ] ) )
+		m["flag"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Uniform, BoolVectorData( [ False, True, False ] ) )
+		m["N"] = PrimitiveVariable( PrimitiveVariable.Interpolation.FaceVarying, V3fVectorData( [ V3f( 0, 0, 1 ) ] * 12, GeometricData.Interpretation.Normal ) )
+
+		result = TriangulateOp()( input = m )
+		self.assert_( result.arePrimitiveVariablesValid() )
+
+		self.assertEqual( result.verticesPerFace, IntVectorData( [ 3 ] * 6 ) )
+		self.assertEqual( result.vertexIds, IntVectorData( [ 0, 1, 2, 0, 2, 3, 0, 3, 4, 1, 5, 2, 5, 6, 7, 5, 7, 2 ] ) )
+		self.assertEqual( result["fv"].data, IntVectorData( [ 0, 1, 2, 0, 2, 3, 0, 3, 4, 5, 6, 7, 8, 9, 10, 8, 10, 11 ] ) )
+		self.assertEqual( result["uniform"].data, FloatVectorData( [ 1, 1, 1, 2, 3, 3 ] ) )
+		self.assertEqual( result["flag"].data, BoolVectorData( [ False, False, False, True, False, False ] ) )
+		self.assertEqual( result["N"].data.getInterpretation(), GeometricData.Interpretation.Normal )
+
+	def testQuadsOnly( self ) :
+
+		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( 3, 2 ) )
+		m["uniform"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Uniform, IntVectorData( range( 0, 6 ) ) )
+
+		result = TriangulateOp()( input = m )
+		self.assert_( result.arePrimitiveVariablesValid() )
+
+		self.assertEqual( result.verticesPerFace, IntVectorData( [ 3 ] * 12 ) )
+		for f in range( 0, 6 ) :
+			ids = m.vertexIds[f*4:f*4+4]
+			self.assertEqual( result.vertexIds[f*6:f*6+6], IntVectorData( [ ids[0], ids[1], ids[2], ids[0], ids[2], ids[3] ] ) )
+			self.assertEqual( result["uniform"].data[f*2:f*2+2], IntVectorData( [ f, f ] ) )
+			for name in ( "s", "t" ) :
+				d = m[name].data
+				self.assertEqual( list( result[name].data[f*6:f*6+6] ), [ d[f*4], d[f*4+1], d[f*4+2], d[f*4], d[f*4+2], d[f*4+3] ] )
+
+	def testIndexedPrimVars( self ) :
+
+		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( 2, 1 ) )
+		values = V2fVectorData( [ V2f( 0 ), V2f( 1 ) ] )
+		m["fv"] = PrimitiveVariable( PrimitiveVariable.Interpolation.FaceVarying, values, IntVectorData( [ 0, 1, 1, 0, 1, 0, 0, 1 ] ) )
+		m["uniform"] = PrimitiveVariable( PrimitiveVariable.Interpolation.Uniform, FloatVectorData( [ 5 ] ), IntVectorData( [ 0, 0 ] ) )
+
+		result = TriangulateOp()( input = m )
+		self.assert_( result.arePrimitiveVariablesValid() )
+
+		# the values are shared, and only the indices are remapped
+		self.failUnless( result["fv"].data.isSame( values ) )
+		self.assertEqual( result["fv"].indices, IntVectorData( [ 0, 1, 1, 0, 1, 0, 1, 0, 0, 1, 0, 1 ] ) )
+		self.assertEqual( result["uniform"].indices, IntVectorData( [ 0, 0, 0, 0 ] ) )
+
+		expanded = m.copy()
+		for name in ( "fv", "uniform" ) :
+			expanded[name] = PrimitiveVariable( m[name].interpolation, m[name].expandedData() )
+		expandedResult = TriangulateOp()( input = expanded )
+		for name in ( "fv", "uniform" ) :
+			self.assertEqual( result[name].expandedData(), expandedResult[name].data )
+
 if __name__ == "__main__":
     unittest.main()
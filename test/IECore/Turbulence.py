@@ -101,6 +101,16 @@ class TestTurbulence( unittest.TestCase ) :
 
 		self.failIf( res.value )
 
+	def testTurbulenceVector( self ) :
+
+		t = IECore.TurbulenceV3ff( octaves = 5 )
+
+		points = IECore.V3fVectorData( [ IECore.V3f( i / 13.0, i / 17.0, -i / 7.0 ) for i in range( 0, 10000 ) ] )
+		values = t.turbulenceVector( points )
+		self.assertEqual( len( values ), len( points ) )
+		for p, v in zip( points, values ) :
+			self.assertEqual( v, t.turbulence( p ) )
+
 	def testNaN( self ) :
 
 		t = IECore.TurbulenceV2ff(
@@ -40,6 +40,9 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include "OpenEXR/ImathRandom.h"
 
 #include "IECore/VectorTypedData.h"
@@ -65,6 +68,7 @@ class VectorTypedDataTest
 		void testRead();
 		void testWrite();
 		void testAssign();
+		void testConcurrentHash();
 
 		unsigned int randomElementPos();
 
@@ -120,6 +124,7 @@ struct TypedDataTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &VectorTypedDataTest<T>::testRead, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &VectorTypedDataTest<T>::testWrite, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &VectorTypedDataTest<T>::testAssign, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &VectorTypedDataTest<T>::testConcurrentHash, instance ) );
 	}
 
 	template<typename T>
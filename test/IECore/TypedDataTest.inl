@@ -146,6 +146,47 @@ void VectorTypedDataTest<T>::testAssign()
 	}
 }
 
+template<typename T>
+struct ConcurrentHasher
+{
+
+	ConcurrentHasher( const TypedData<T> *data, std::vector<MurmurHash> &hashes )
+		:	m_data( data ), m_hashes( hashes )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			m_hashes[i] = m_data->Object::hash();
+		}
+	}
+
+	const TypedData<T> *m_data;
+	std::vector<MurmurHash> &m_hashes;
+
+};
+
+template<typename T>
+void VectorTypedDataTest<T>::testConcurrentHash()
+{
+	for( int i = 0; i < 10; ++i )
+	{
+		// calling writable() discards the cached hash, so
+		// the threads below race to compute it again.
+		m_data->writable();
+		std::vector<MurmurHash> hashes( 100 );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, hashes.size(), 1 ), ConcurrentHasher<T>( m_data.get(), hashes ) );
+
+		typename TypedData<T>::Ptr reference = new TypedData<T>( m_data->readable() );
+		const MurmurHash expected = reference->Object::hash();
+		for( size_t j = 0; j < hashes.size(); ++j )
+		{
+			BOOST_CHECK( hashes[j] == expected );
+		}
+	}
+}
 
 template<typename T>
 SimpleTypedDataTest<T>::SimpleTypedDataTest()
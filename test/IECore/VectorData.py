@@ -1279,6 +1279,58 @@ class TestInternedStringVectorData( unittest.TestCase ) :
 		
 		self.assertEqual( d2, d )
 		
+class VectorDataBufferTest( unittest.TestCase ) :
+
+	def testToBuffer( self ) :
+
+		d = FloatVectorData( [ 1, 2, 3 ] )
+		b = d.toBuffer()
+		self.assertFalse( b.isWritable() )
+		self.assertEqual( b.data(), d )
+
+		m = memoryview( b )
+		self.assertTrue( m.readonly )
+		self.assertEqual( m.format, "f" )
+		self.assertEqual( m.itemsize, 4 )
+		self.assertEqual( m.shape, ( 3, ) )
+		self.assertEqual( m.tobytes(), d.toString() )
+
+	def testCompoundToBuffer( self ) :
+
+		d = V3fVectorData( [ V3f( 1, 2, 3 ), V3f( 4, 5, 6 ) ] )
+		m = memoryview( d.toBuffer() )
+		self.assertEqual( m.format, "f" )
+		self.assertEqual( m.shape, ( 2, 3 ) )
+		self.assertEqual( m.tobytes(), d.toString() )
+
+	def testWritableBuffer( self ) :
+
+		d = IntVectorData( [ 1, 2, 3 ] )
+		d2 = d.copy()
+
+		b = d.toBuffer( writable = True )
+		self.assertTrue( b.isWritable() )
+		self.assertFalse( memoryview( b ).readonly )
+
+		self.assertEqual( d, d2 )
+
+	def testConstructFromBuffer( self ) :
+
+		d = V3fVectorData( [ V3f( 1, 2, 3 ), V3f( 4, 5, 6 ) ] )
+		self.assertEqual( V3fVectorData( d.toBuffer() ), d )
+
+		d2 = V3fVectorData( d.toBuffer(), GeometricData.Interpretation.Normal )
+		self.assertEqual( d2.getInterpretation(), GeometricData.Interpretation.Normal )
+		self.assertEqual( list( d2 ), list( d ) )
+
+		# the buffer doesn't need to be of the same shape, so long as
+		# its type matches and it holds a whole number of elements.
+		f = FloatVectorData( d.toBuffer() )
+		self.assertEqual( list( f ), [ 1, 2, 3, 4, 5, 6 ] )
+		self.assertEqual( V3fVectorData( f.toBuffer() ), d )
+
+		self.assertEqual( IntVectorData( IntVectorData().toBuffer() ), IntVectorData() )
+
 if __name__ == "__main__":
     unittest.main()
 	
@@ -34,6 +34,7 @@
 
 import unittest
 import threading
+import time
 
 import IECore
 import IECoreGL
@@ -170,5 +171,26 @@ class CachedConverterTest( unittest.TestCase ) :
 			# do the deferred removals now we're back on the main thread
 			c.clearUnused()
 		
+	def testConvertAsync( self ) :
+
+		c = IECoreGL.CachedConverter( 500 * 1024 * 1024 )
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 100 ) )
+
+		gm = c.convertAsync( m )
+		t = time.time()
+		while gm is None and time.time() - t < 10 :
+			time.sleep( 0.01 )
+			gm = c.convertAsync( m )
+
+		self.assertTrue( isinstance( gm, IECoreGL.MeshPrimitive ) )
+		self.assertTrue( gm.isSame( c.convert( m ) ) )
+		self.assertTrue( gm.isSame( c.convertAsync( m ) ) )
+
+		# textures need the gl context, so are converted immediately
+		dataWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 15 ) )
+		i = IECore.ImagePrimitive.createRGBFloat( IECore.Color3f( 1, 0.5, 0.25 ), dataWindow, dataWindow )
+		self.assertTrue( isinstance( c.convertAsync( i ), IECoreGL.Texture ) )
+
 if __name__ == "__main__":
     unittest.main()
@@ -176,6 +176,10 @@ class CurvesPrimitiveTest( unittest.TestCase ) :
 		r.setAttribute( "gl:curvesPrimitive:ignoreBasis", IECore.BoolData( True ) )
 		self.assertEqual( r.getAttribute( "gl:curvesPrimitive:ignoreBasis" ), IECore.BoolData( True ) )
 
+		self.assertEqual( r.getAttribute( "gl:curvesPrimitive:tessellationSegmentLength" ), IECore.FloatData( 0 ) )
+		r.setAttribute( "gl:curvesPrimitive:tessellationSegmentLength", IECore.FloatData( 4 ) )
+		self.assertEqual( r.getAttribute( "gl:curvesPrimitive:tessellationSegmentLength" ), IECore.FloatData( 4 ) )
+
 		r.worldEnd()
 
 	def testLinearNonPeriodicAsLines( self ) :
@@ -440,6 +444,71 @@ class CurvesPrimitiveTest( unittest.TestCase ) :
 			os.path.dirname( __file__ ) + "/images/bezierHorseShoe.tif"
 		)
 
+	@skipIf( IECoreGL.glslVersion() < 400, "Insufficient GLSL version" )
+	def testTessellatedBezierAsRibbons( self ) :
+
+		c = IECore.CurvesPrimitive(
+
+			IECore.IntVectorData( [ 4 ] ),
+			IECore.CubicBasisf.bezier(),
+			False,
+			IECore.V3fVectorData(
+				[
+					IECore.V3f( 0.8, 0.2, 0 ),
+					IECore.V3f( 0.2, 0.2, 0 ),
+					IECore.V3f( 0.2, 0.8, 0 ),
+					IECore.V3f( 0.8, 0.8, 0 ),
+				]
+			)
+
+		)
+		c["width"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 0.05 ) )
+
+		self.performTest(
+			c,
+			[
+				( "gl:primitive:wireframe", IECore.BoolData( True ) ),
+				( "gl:curvesPrimitive:tessellationSegmentLength", IECore.FloatData( 2 ) ),
+			],
+			[
+			],
+			os.path.dirname( __file__ ) + "/images/bezierHorseShoe.tif"
+		)
+
+	@skipIf( IECoreGL.glslVersion() < 400, "Insufficient GLSL version" )
+	def testTessellatedBezierAsLines( self ) :
+
+		c = IECore.CurvesPrimitive(
+
+			IECore.IntVectorData( [ 4 ] ),
+			IECore.CubicBasisf.bezier(),
+			False,
+			IECore.V3fVectorData(
+				[
+					IECore.V3f( 0.8, 0.2, 0 ),
+					IECore.V3f( 0.2, 0.2, 0 ),
+					IECore.V3f( 0.2, 0.8, 0 ),
+					IECore.V3f( 0.8, 0.8, 0 ),
+				]
+			)
+
+		)
+
+		self.performTest(
+			c,
+			[
+				( "gl:curvesPrimitive:useGLLines", IECore.BoolData( True ) ),
+				( "gl:curvesPrimitive:glLineWidth", IECore.FloatData( 4 ) ),
+				( "gl:curvesPrimitive:tessellationSegmentLength", IECore.FloatData( 2 ) ),
+			],
+			[
+				# the middle of the curve is at x=0.35, well away
+				# from the chord which a linear curve would follow.
+				( IECore.V2f( 0.35, 0.5 ), IECore.Color4f( 0, 0, 1, 1 ) ),
+				( IECore.V2f( 0.8, 0.5 ), IECore.Color4f( 0, 0, 0, 0 ) ),
+			],
+		)
+
 	@skipIf( IECoreGL.glslVersion() < 150, "Insufficient GLSL version" )
 	def testLinearRibbons( self ) :
 
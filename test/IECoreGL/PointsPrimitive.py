@@ -36,6 +36,7 @@ from __future__ import with_statement
 
 import unittest
 import random
+import math
 import os
 import shutil
 
@@ -576,8 +577,73 @@ class TestPointsPrimitive( unittest.TestCase ) :
 		self.assertEqual( result.floatPrimVar( e.G() ), 1 )
 		self.assertEqual( result.floatPrimVar( e.B() ), 0 )
 
+	def testTransparentGLPointsDepthSort( self ) :
+
+		fragmentSource = """
+		#if __VERSION__ <= 120
+		#define in varying
+		#endif
+
+		in vec3 fragmentCs;
+
+		void main()
+		{
+			gl_FragColor = vec4( fragmentCs, 0.5 );
+		}
+		"""
+
+		def render( rotation ) :
+
+			r = IECoreGL.Renderer()
+			r.setOption( "gl:mode", IECore.StringData( "immediate" ) )
+
+			r.camera( "main", {
+					"projection" : IECore.StringData( "orthographic" ),
+					"resolution" : IECore.V2iData( IECore.V2i( 256 ) ),
+					"clippingPlanes" : IECore.V2fData( IECore.V2f( 1, 1000 ) ),
+					"screenWindow" : IECore.Box2fData( IECore.Box2f( IECore.V2f( -3 ), IECore.V2f( 3 ) ) )
+				}
+			)
+			r.display( self.outputFileName, "exr", "rgba", {} )
+
+			with IECore.WorldBlock( r ) :
+
+				r.concatTransform( IECore.M44f.createTranslated( IECore.V3f( 0, 0, -6 ) ) )
+				r.concatTransform( IECore.M44f.createRotated( IECore.V3f( 0, rotation, 0 ) ) )
+
+				r.shader( "surface", "transparent", { "gl:fragmentSource" : IECore.StringData( fragmentSource ) } )
+				r.setAttribute( "gl:shade:transparent", IECore.BoolData( True ) )
+				r.setAttribute( "gl:pointsPrimitive:glPointWidth", IECore.FloatData( 20 ) )
+
+				# The points overlap on screen, and are listed front to back
+				# when unrotated, so only a sort can blend them correctly.
+				r.points( 3, {
+						"P" : IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ IECore.V3f( 0, 0, 1 ), IECore.V3f( 0 ), IECore.V3f( 0, 0, -1 ) ] ) ),
+						"Cs" : IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.Color3fVectorData( [ IECore.Color3f( 0, 0, 1 ), IECore.Color3f( 0, 1, 0 ), IECore.Color3f( 1, 0, 0 ) ] ) ),
+						"type" : IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Uniform, IECore.StringData( "gl:point" ) )
+					}
+				)
+
+			e = IECore.PrimitiveEvaluator.create( IECore.Reader.create( self.outputFileName ).read() )
+			result = e.createResult()
+			e.pointAtUV( IECore.V2f( 0.5 ), result )
+
+			return IECore.Color3f( result.floatPrimVar( e.R() ), result.floatPrimVar( e.G() ), result.floatPrimVar( e.B() ) )
+
+		# Blending each point over the last at 50% opacity leaves
+		# the nearest point with the largest contribution.
+		c = render( 0 )
+		self.assertAlmostEqual( c[0], 0.125, 2 )
+		self.assertAlmostEqual( c[1], 0.25, 2 )
+		self.assertAlmostEqual( c[2], 0.5, 2 )
+
+		c = render( math.pi )
+		self.assertAlmostEqual( c[0], 0.5, 2 )
+		self.assertAlmostEqual( c[1], 0.25, 2 )
+		self.assertAlmostEqual( c[2], 0.125, 2 )
+
 	def setUp( self ) :
-		
+
 		if not os.path.isdir( "test/IECoreGL/output" ) :
 			os.makedirs( "test/IECoreGL/output" )
 	
@@ -844,6 +844,39 @@ class TestRenderer( unittest.TestCase ) :
 
 		self.assertEqual( len( self.RecursiveParameterisedProcedural.threadsUsed ), 1 )
 		
+	def testProceduralStatisticsAndMaxPending( self ):
+
+		for maxPending in ( 0, 1 ) :
+
+			r = Renderer()
+			r.setOption( "gl:mode", StringData( "deferred" ) )
+			r.setOption( "gl:searchPath:shader", StringData( os.path.dirname( __file__ ) + "/shaders" ) )
+			r.setOption( "gl:searchPath:shaderInclude", StringData( os.path.dirname( __file__ ) + "/shaders/include" ) )
+			self.assertEqual( r.getOption( "gl:procedural:maxPending" ), IntData( 0 ) )
+			r.setOption( "gl:procedural:maxPending", IntData( maxPending ) )
+			self.assertEqual( r.getOption( "gl:procedural:maxPending" ), IntData( maxPending ) )
+
+			with WorldBlock( r ) :
+				r.procedural( self.RecursiveProcedural() )
+
+			# the pyramid has 2^0 + 2^1 + ... + 2^maxLevel procedurals,
+			# and all must be expanded regardless of the limit.
+			statistics = r.getOption( "gl:procedural:statistics" )
+			self.assertEqual( sum( s["count"].value for s in statistics.values() ), 2 ** ( self.RecursiveProcedural.maxLevel + 1 ) - 1 )
+			for s in statistics.values() :
+				self.failUnless( s["time"].value >= 0 )
+
+			# and each procedural makes a single sphere.
+			primitives = []
+			def walk( group ) :
+				for c in group.children() :
+					if isinstance( c, Group ) :
+						walk( c )
+					else :
+						primitives.append( c )
+			walk( r.scene().root() )
+			self.assertEqual( len( primitives ), 2 ** ( self.RecursiveProcedural.maxLevel + 1 ) - 1 )
+
 	def testObjectSpaceCulling( self ):
 
 		p = self.RecursiveProcedural()
@@ -989,6 +1022,63 @@ class TestRenderer( unittest.TestCase ) :
 		self.assert_( g.bound().min.equalWithAbsError( V3f( -1, 4, 9 ), 0.001 ) )
 		self.assert_( g.bound().max.equalWithAbsError( V3f( 4, 11, 31 ), 0.001 ) )
 	
+	def testInstancer( self ) :
+
+		r = Renderer()
+		r.instanceBegin( "sphere", {} )
+		r.sphere( 1, -1, 1, 360, {} )
+		r.instanceEnd()
+
+		r.instanceBegin( "box", {} )
+		IECore.MeshPrimitive.createBox( Box3f( V3f( -1 ), V3f( 1 ) ) ).render( r )
+		r.instanceEnd()
+
+		r.setOption( "gl:mode", StringData( "deferred" ) )
+		r.worldBegin()
+		r.geometry(
+			"instancer",
+			{
+				"prototypes" : StringVectorData( [ "sphere", "box" ] ),
+			},
+			{
+				"P" : PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, V3fVectorData( [ V3f( 0 ), V3f( 10, 0, 0 ), V3f( 20, 0, 0 ) ] ) ),
+				"prototypeIndex" : PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, IntVectorData( [ 1, 0, 1 ] ) ),
+				"scale" : PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, FloatVectorData( [ 1, 1, 2 ] ) ),
+			}
+		)
+		r.worldEnd()
+
+		g = r.scene().root()
+
+		self.assertEqual( self.__countChildrenRecursive( g ), 3 )
+		self.assert_( g.bound().min.equalWithAbsError( V3f( -1, -2, -2 ), 0.001 ) )
+		self.assert_( g.bound().max.equalWithAbsError( V3f( 22, 2, 2 ), 0.001 ) )
+
+	def testInstancerWithInvalidPrototypeIndex( self ) :
+
+		r = Renderer()
+		r.instanceBegin( "sphere", {} )
+		r.sphere( 1, -1, 1, 360, {} )
+		r.instanceEnd()
+
+		r.setOption( "gl:mode", StringData( "deferred" ) )
+		with CapturingMessageHandler() as mh :
+			r.worldBegin()
+			r.geometry(
+				"instancer",
+				{
+					"prototypes" : StringVectorData( [ "sphere" ] ),
+				},
+				{
+					"P" : PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, V3fVectorData( [ V3f( 0 ) ] ) ),
+					"prototypeIndex" : PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, IntVectorData( [ 1 ] ) ),
+				}
+			)
+			r.worldEnd()
+
+		self.assertEqual( len( mh.messages ), 1 )
+		self.assertEqual( self.__countChildrenRecursive( r.scene().root() ), 0 )
+
 	def testCuriousCrashOnThreadedProceduralsAndAttribute( self ):
 
 		myMesh = Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob").read()
@@ -34,6 +34,7 @@
 
 import unittest
 import os.path
+import shutil
 
 import IECore
 import IECoreGL
@@ -143,6 +144,35 @@ class ShaderLoaderTest( unittest.TestCase ) :
 		s3 = l.load( "testShader" )
 		self.assert_( not s.isSame( s3 ) )
 
-		
+	def testCacheDirectory( self ) :
+
+		cacheDirectory = "/tmp/ieCoreGLShaderCache"
+		if os.path.exists( cacheDirectory ) :
+			shutil.rmtree( cacheDirectory )
+
+		sp = IECore.SearchPath( os.path.dirname( __file__ ) + "/shaders", ":" )
+		l = IECoreGL.ShaderLoader( sp )
+		self.assertEqual( l.getCacheDirectory(), "" )
+		l.setCacheDirectory( cacheDirectory )
+		self.assertEqual( l.getCacheDirectory(), cacheDirectory )
+
+		s = l.load( "3dLabs/Toon" )
+
+		# a fresh loader should be able to use the cached binary, if
+		# the driver supports them, and get an equivalent shader.
+		l2 = IECoreGL.ShaderLoader( sp )
+		l2.setCacheDirectory( cacheDirectory )
+		s2 = l2.load( "3dLabs/Toon" )
+
+		self.failIf( s.isSame( s2 ) )
+		self.assertEqual( s.fragmentSource(), s2.fragmentSource() )
+		self.assertEqual( sorted( s.uniformParameterNames() ), sorted( s2.uniformParameterNames() ) )
+		self.assertEqual( sorted( s.vertexAttributeNames() ), sorted( s2.vertexAttributeNames() ) )
+
+	def tearDown( self ) :
+
+		if os.path.exists( "/tmp/ieCoreGLShaderCache" ) :
+			shutil.rmtree( "/tmp/ieCoreGLShaderCache" )
+
 if __name__ == "__main__":
     unittest.main()
@@ -120,6 +120,32 @@ class TestState( unittest.TestCase ) :
 			self.assertEqual( state1.get( IECoreGL.NameStateComponent.staticTypeId() ).name(), "jane" )			
 
 		self.assertEqual( state1.get( IECoreGL.NameStateComponent.staticTypeId() ).name(), "billy" )			
-				
+
+	def testCompose( self ) :
+
+		state1 = IECoreGL.State( True )
+		state1.add( IECoreGL.NameStateComponent( "billy" ) )
+
+		state2 = IECoreGL.State( False )
+		state2.add( IECoreGL.NameStateComponent( "bob" ), override = True )
+
+		state3 = IECoreGL.State( False )
+		state3.add( IECoreGL.NameStateComponent( "jane" ) )
+
+		# composing should match the effect of a ScopedBinding
+		composed = IECoreGL.State( state1 )
+		self.assertTrue( composed.compose( state3 ) )
+		self.assertEqual( composed.get( IECoreGL.NameStateComponent.staticTypeId() ).name(), "jane" )
+		self.assertFalse( composed.compose( state3 ) )
+		self.assertFalse( composed.compose( IECoreGL.State( False ) ) )
+
+		composed = IECoreGL.State( state1 )
+		self.assertTrue( composed.compose( state2 ) )
+		self.assertFalse( composed.compose( state3 ) )
+		self.assertEqual( composed.get( IECoreGL.NameStateComponent.staticTypeId() ).name(), "bob" )
+
+		# and shouldn't affect the original
+		self.assertEqual( state1.get( IECoreGL.NameStateComponent.staticTypeId() ).name(), "billy" )
+
 if __name__ == "__main__":
     unittest.main()
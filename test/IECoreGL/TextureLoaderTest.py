@@ -33,6 +33,7 @@
 ##########################################################################
 
 import os
+import shutil
 import unittest
 
 import IECore
@@ -55,7 +56,66 @@ class TextureLoaderTest( unittest.TestCase ) :
 		l = IECoreGL.TextureLoader( IECore.SearchPath( "./", ":" ) )
 		t = l.load( "test/IECore/data/jpg/greyscaleCheckerBoard.jpg" )
 		self.failUnless( isinstance( t, IECoreGL.LuminanceTexture ) )
-	
+
+	def testMaxMemory( self ) :
+
+		l = IECoreGL.TextureLoader( IECore.SearchPath( "./", ":" ) )
+		l.setMaxMemory( 0 )
+		self.assertEqual( l.getMaxMemory(), 0 )
+
+		# with no memory to spare, the loader can't hold onto
+		# anything, but must still return usable textures.
+		t = l.load( "test/IECore/data/exrFiles/carPark.exr" )
+		self.failUnless( isinstance( t, IECoreGL.ColorTexture ) )
+		t2 = l.load( "test/IECore/data/exrFiles/carPark.exr" )
+		self.failUnless( isinstance( t2, IECoreGL.ColorTexture ) )
+		self.failIf( t.isSame( t2 ) )
+
+		l.setMaxMemory( 100 * 1024 * 1024 )
+		t3 = l.load( "test/IECore/data/exrFiles/carPark.exr" )
+		self.failUnless( t3.isSame( l.load( "test/IECore/data/exrFiles/carPark.exr" ) ) )
+
+	def testMaximumResolution( self ) :
+
+		l = IECoreGL.TextureLoader( IECore.SearchPath( "./", ":" ) )
+		self.assertEqual( l.getMaximumResolution(), 0 )
+
+		t = l.load( "test/IECore/data/exrFiles/carPark.exr" )
+		fullSize = t.imagePrimitive().getDataWindow().size() + IECore.V2i( 1 )
+
+		l.setMaximumResolution( 16 )
+		self.assertEqual( l.getMaximumResolution(), 16 )
+
+		t = l.load( "test/IECore/data/exrFiles/carPark.exr" )
+		size = t.imagePrimitive().getDataWindow().size() + IECore.V2i( 1 )
+		self.failUnless( size.x <= 16 and size.y <= 16 )
+		self.failUnless( size.x < fullSize.x )
+
+	def testCacheDirectory( self ) :
+
+		l = IECoreGL.TextureLoader( IECore.SearchPath( "./", ":" ) )
+		self.assertEqual( l.getCacheDirectory(), "" )
+		l.setMaximumResolution( 16 )
+		l.setCacheDirectory( self.__cacheDirectory )
+		self.assertEqual( l.getCacheDirectory(), self.__cacheDirectory )
+
+		t = l.load( "test/IECore/data/exrFiles/carPark.exr" )
+		self.assertEqual( len( os.listdir( self.__cacheDirectory ) ), 1 )
+
+		l2 = IECoreGL.TextureLoader( IECore.SearchPath( "./", ":" ) )
+		l2.setMaximumResolution( 16 )
+		l2.setCacheDirectory( self.__cacheDirectory )
+		t2 = l2.load( "test/IECore/data/exrFiles/carPark.exr" )
+
+		self.assertEqual( t.imagePrimitive().getDataWindow(), t2.imagePrimitive().getDataWindow() )
+
+	__cacheDirectory = "/tmp/ieCoreGLTextureCache"
+
+	def tearDown( self ) :
+
+		if os.path.exists( self.__cacheDirectory ) :
+			shutil.rmtree( self.__cacheDirectory )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -56,9 +56,12 @@ class ToGLStateConverterTest( unittest.TestCase ) :
 			( "gl:primitive:pointColor", IECore.Color4fData( IECore.Color4f( 0.1, 0.25, 0.5, 1 ) ), IECoreGL.PointColorStateComponent( IECore.Color4f( 0.1, 0.25, 0.5, 1 ) ) ),
 			( "gl:pointsPrimitive:useGLPoints", IECore.StringData( "forGLPoints" ), IECoreGL.PointsPrimitive.UseGLPoints( IECoreGL.GLPointsUsage.ForPointsOnly ) ),
 			( "gl:pointsPrimitive:glPointWidth", IECore.FloatData( 1.5 ), IECoreGL.PointsPrimitive.GLPointWidth( 1.5 ) ),
+			( "gl:pointsPrimitive:lodMinimumWidth", IECore.FloatData( 2 ), IECoreGL.PointsPrimitive.LODMinimumWidth( 2 ) ),
+			( "gl:pointsPrimitive:lodDensity", IECore.FloatData( 0.5 ), IECoreGL.PointsPrimitive.LODDensity( 0.5 ) ),
 			( "gl:curvesPrimitive:useGLLines", IECore.BoolData( True ), IECoreGL.CurvesPrimitive.UseGLLines( True ) ),
 			( "gl:curvesPrimitive:glLineWidth", IECore.FloatData( 1.5 ), IECoreGL.CurvesPrimitive.GLLineWidth( 1.5 ) ),
 			( "gl:curvesPrimitive:ignoreBasis", IECore.BoolData( True ), IECoreGL.CurvesPrimitive.IgnoreBasis( True ) ),
+			( "gl:curvesPrimitive:tessellationSegmentLength", IECore.FloatData( 4 ), IECoreGL.CurvesPrimitive.TessellationSegmentLength( 4 ) ),
 			( "gl:smoothing:points", IECore.BoolData( True ), IECoreGL.PointSmoothingStateComponent( True ) ),
 			( "gl:smoothing:lines", IECore.BoolData( True ), IECoreGL.LineSmoothingStateComponent( True ) ),
 			( "gl:smoothing:polygons", IECore.BoolData( True ), IECoreGL.PolygonSmoothingStateComponent( True ) ),
@@ -58,6 +58,7 @@ from RIBWriterTest import *
 from ParameterisedProcedural import *
 from MotionTest import MotionTest
 from PythonProceduralTest import PythonProceduralTest
+from SceneCacheProceduralTest import SceneCacheProceduralTest
 from DetailTest import DetailTest
 from ProceduralThreadingTest import ProceduralThreadingTest
 from StringArrayParameterTest import StringArrayParameterTest
@@ -363,6 +363,29 @@ class InstancingTest( IECoreRI.TestCase ) :
 		self.assertEqual( rib.count( "PointsGeneralPolygons" ), 1 )
 		self.assertEqual( rib.count( "ObjectInstance" ), 2 )
 
+	def testInstancer( self ) :
+
+		r = IECoreRI.Renderer( "test/IECoreRI/output/instancing.rib" )
+
+		r.instanceBegin( "myObject", {} )
+		r.geometry( "teapot", {}, {} )
+		r.instanceEnd()
+
+		with WorldBlock( r ) :
+			r.geometry(
+				"instancer",
+				{
+					"prototypes" : StringVectorData( [ "myObject" ] ),
+				},
+				{
+					"P" : PrimitiveVariable( PrimitiveVariable.Interpolation.Vertex, V3fVectorData( [ V3f( i ) for i in range( 0, 10 ) ] ) ),
+				}
+			)
+
+		rib = "".join( open( "test/IECoreRI/output/instancing.rib" ).readlines() )
+		self.assertEqual( rib.count( "ObjectBegin" ), 1 )
+		self.assertEqual( rib.count( "ObjectInstance" ), 10 )
+
 	def testAutomaticInstancingWithMotionBlur( self ) :
 	
 		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ) )
@@ -386,6 +409,42 @@ class InstancingTest( IECoreRI.TestCase ) :
 		self.assertEqual( rib.count( "ObjectInstance" ), 2 )
 	
 	
+	def testAutomaticInstancingStatistics( self ) :
+
+		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ) )
+		m2 = MeshPrimitive.createPlane( Box2f( V2f( -2 ), V2f( 2 ) ) )
+		r = IECoreRI.Renderer( "test/IECoreRI/output/instancing.rib" )
+
+		with WorldBlock( r ) :
+
+			r.setAttribute( "ri:automaticInstancing", True )
+
+			m.render( r )
+			m.render( r )
+			m.render( r )
+
+			with MotionBlock( r, [ 0, 1 ] ) :
+				m.render( r )
+				m2.render( r )
+			with MotionBlock( r, [ 0, 1 ] ) :
+				m.render( r )
+				m2.render( r )
+			# samples from the reused motion block above
+			# must not leak into this one.
+			with MotionBlock( r, [ 0, 1 ] ) :
+				m2.render( r )
+				m.render( r )
+
+			s = r.getOption( "ri:automaticInstancing:statistics" )
+			self.assertEqual( s["instances"], UInt64Data( 3 ) )
+			self.assertEqual( s["reuses"], UInt64Data( 3 ) )
+			self.assertEqual( s["memorySaved"], UInt64Data( 2 * m.memoryUsage() + m.memoryUsage() + m2.memoryUsage() ) )
+
+		rib = "".join( open( "test/IECoreRI/output/instancing.rib" ).readlines() )
+		self.assertEqual( rib.count( "ObjectBegin" ), 3 )
+		self.assertEqual( rib.count( "PointsGeneralPolygons" ), 5 )
+		self.assertEqual( rib.count( "ObjectInstance" ), 6 )
+
 	def testAutomaticInstancingWithTransformMotionBlur( self ) :
 	
 		m = MeshPrimitive.createPlane( Box2f( V2f( -1 ), V2f( 1 ) ) )
@@ -78,6 +78,57 @@ if hasattr( IECoreRI, "PTCParticleReader" ):
 			self.assertEqual( len( c ), n )
 			self.assert_( c.isInstanceOf( IECore.Color3fVectorData.staticTypeId() ) )
 			
+		def testReadRange( self ) :
+
+			for percentage in [ 100, 50 ] :
+
+				r = IECoreRI.PTCParticleReader( self.testfile )
+				r["percentage"].setTypedValue( percentage )
+
+				attributeNames = r.attributeNames()
+				full = dict( ( name, list( r.readAttribute( name ) ) ) for name in attributeNames )
+
+				# consecutive ranges continue from the current file position
+				for name in attributeNames :
+					chunked = []
+					for begin in range( 0, r.numParticles(), 100 ) :
+						chunked.extend( list( r.readAttributeRange( name, begin, begin + 100 ) ) )
+					self.assertEqual( chunked, full[name] )
+
+				# ranges before the current position reopen the file
+				ranges = [ ( begin, begin + 100 ) for begin in range( 0, r.numParticles(), 100 ) ]
+				ranges.reverse()
+				for name in attributeNames :
+					chunked = []
+					for begin, end in ranges :
+						chunked = list( r.readAttributeRange( name, begin, end ) ) + chunked
+					self.assertEqual( chunked, full[name] )
+
+				p = r.read()
+				numPoints = 0
+				for begin in range( 0, r.numParticles(), 100 ) :
+					c = r.readRange( begin, begin + 100 )
+					self.assertTrue( c.arePrimitiveVariablesValid() )
+					self.assertEqual( list( c["P"].data ), list( p["P"].data )[numPoints:numPoints+c.numPoints] )
+					numPoints += c.numPoints
+
+				self.assertEqual( numPoints, p.numPoints )
+
+		def testReadRangeWithBound( self ) :
+
+			r = IECoreRI.PTCParticleReader( self.testfile )
+			b = r.read().bound()
+			r["bound"].setTypedValue( IECore.Box3f( b.min, b.center() ) )
+
+			p = r.read()
+			self.assertTrue( p.numPoints > 0 )
+			self.assertTrue( p.numPoints < r.numParticles() )
+
+			positions = []
+			for begin in range( 0, r.numParticles(), 100 ) :
+				positions.extend( list( r.readRange( begin, begin + 100 )["P"].data ) )
+			self.assertEqual( positions, list( p["P"].data ) )
+
 		def testCanRead(self) :
 
 			self.assertEqual( IECoreRI.PTCParticleReader.canRead( "test/IECoreRI/data/test.3Dbake" ), True )
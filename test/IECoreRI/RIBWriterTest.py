@@ -70,5 +70,33 @@ class RIBWriterTest( IECoreRI.TestCase ) :
 		self.assert_( "WorldBegin" in l )
 		self.assert_( "WorldEnd" in l )
 
+	def testBinaryAndCompressed( self ) :
+
+		cube = IECore.ObjectReader( "test/IECore/data/cobFiles/pCubeShape1.cob" ).read()
+
+		writer = IECoreRI.RIBWriter( cube, self.outputFileName )
+		writer.write()
+		asciiSize = os.path.getsize( self.outputFileName )
+
+		writer["binary"].setTypedValue( True )
+		writer.write()
+		self.assertTrue( os.path.getsize( self.outputFileName ) < asciiSize )
+
+		writer["binary"].setTypedValue( False )
+		writer["compress"].setTypedValue( True )
+		writer.write()
+		self.assertEqual( open( self.outputFileName, "rb" ).read( 2 ), "\x1f\x8b" )
+
+	def testCompressedFromFileName( self ) :
+
+		cube = IECore.ObjectReader( "test/IECore/data/cobFiles/pCubeShape1.cob" ).read()
+
+		fileName = self.outputFileName + ".gz"
+		writer = IECoreRI.RIBWriter( cube, fileName )
+		writer.write()
+		self.assertEqual( open( fileName, "rb" ).read( 2 ), "\x1f\x8b" )
+
+		os.remove( fileName )
+
 if __name__ == "__main__":
     unittest.main()
@@ -422,6 +422,41 @@ class SXRendererTest( unittest.TestCase ) :
 			r.shade( points, IECore.V2i( 10, 5 ) )
 
 
+	def testBatchedShading( self ) :
+
+		self.assertEqual( os.system( "shaderdl -o test/IECoreRI/shaders/sxGridTest.sdl test/IECoreRI/shaders/sxGridTest.sl" ), 0 )
+
+		r = IECoreRI.SXRenderer()
+		b = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 19, 9 ) )
+		points = self.__rectanglePoints( b )
+
+		with IECore.WorldBlock( r ) :
+
+			r.shader( "surface", "test/IECoreRI/shaders/sxGridTest", {} )
+
+			# batches made of whole grids should match shading all the grids at once
+			expected = r.shade( points, IECore.V2i( 10, 5 ) )
+			result = IECore.CompoundData()
+			r.shade( points, IECore.V2i( 10, 5 ), result, 50 )
+			self.assertEqual( result, expected )
+
+			# and the result should be reusable for subsequent calls
+			ci = result["Ci"]
+			r.shade( points, IECore.V2i( 10, 5 ), result, 100 )
+			self.assertEqual( result, expected )
+			self.assertTrue( result["Ci"].isSame( ci ) )
+
+			# batches without any topology
+			expected = r.shade( points )
+			result = IECore.CompoundData()
+			r.shade( points, IECore.V2i( 0 ), result, 7 )
+			self.assertEqual( result, expected )
+
+			# an automatically chosen batch size
+			result = IECore.CompoundData()
+			r.shade( points, IECore.V2i( 0 ), result )
+			self.assertEqual( result, expected )
+
 	def testPlaneShade( self ) :
 		
 		r = IECoreRI.SXRenderer()
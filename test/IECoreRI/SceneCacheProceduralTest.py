@@ -0,0 +1,108 @@
+##########################################################################
+#
+#  Copyright (c) 2017, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+import os
+
+import IECore
+import IECoreRI
+
+class SceneCacheProceduralTest( IECoreRI.TestCase ) :
+
+	def __writeScene( self, fileName ) :
+
+		m = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+
+		left = m.createChild( "left" )
+		left.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( -2, 0, 0 ) ) ), 0.0 )
+		left.writeObject( IECore.SpherePrimitive( 1 ), 0.0 )
+
+		right = m.createChild( "right" )
+		right.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( 2, 0, 0 ) ) ), 0.0 )
+		right.writeAttribute( "scene:visible", IECore.BoolData( False ), 0.0 )
+		right.writeObject( IECore.SpherePrimitive( 1 ), 0.0 )
+
+	def __render( self, parameters ) :
+
+		rib = """
+		Option "searchpath" "string procedural" "./src/rmanProcedurals/sceneCache"
+
+		Display "test/IECoreRI/output/testSceneCacheProcedural.tif" "tiff" "rgba"
+
+		Projection "perspective" "float fov" [ 40 ]
+
+		WorldBegin
+
+			Translate 0 0 10
+
+			Procedural "DynamicLoad" [ "sceneCache" "%s" ] [ -3 3 -1 1 -1 1 ]
+
+		WorldEnd
+		""" % parameters
+
+		ribFile = open( "test/IECoreRI/output/sceneCacheProcedural.rib", "w" )
+		ribFile.write( rib )
+		ribFile.close()
+
+		os.system( "renderdl test/IECoreRI/output/sceneCacheProcedural.rib" )
+
+		image = IECore.Reader.create( "test/IECoreRI/output/testSceneCacheProcedural.tif" ).read()
+		e = IECore.PrimitiveEvaluator.create( image )
+		result = e.createResult()
+
+		alphas = []
+		for u in ( 0.225, 0.5, 0.775 ) :
+			e.pointAtUV( IECore.V2f( u, 0.5 ), result )
+			alphas.append( result.floatPrimVar( e.A() ) )
+
+		return alphas
+
+	def test( self ) :
+
+		self.__writeScene( "test/IECoreRI/output/sceneCacheProcedural.scc" )
+
+		# only the visible sphere on the left should be rendered
+		self.assertEqual( self.__render( "test/IECoreRI/output/sceneCacheProcedural.scc" ), [ 1, 0, 0 ] )
+
+	def testPath( self ) :
+
+		self.__writeScene( "test/IECoreRI/output/sceneCacheProcedural.scc" )
+
+		# the transform of the location itself isn't applied,
+		# so the sphere should be rendered in the centre
+		self.assertEqual( self.__render( "test/IECoreRI/output/sceneCacheProcedural.scc /left 0" ), [ 0, 1, 0 ] )
+
+if __name__ == "__main__":
+	unittest.main()